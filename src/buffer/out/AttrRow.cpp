@@ -9,10 +9,61 @@
 // Arguments:
 // - cchRowWidth - the length of the default text attribute
 // - attr - the default text attribute
+// - table - the table of the text buffer that interns the attributes of its rows
 // Return Value:
 // - constructed object
-ATTR_ROW::ATTR_ROW(const uint16_t width, const TextAttribute attr) :
-    _data(width, attr) {}
+ATTR_ROW::ATTR_ROW(const uint16_t width, const TextAttribute attr, TextAttributeTable& table) :
+    _data(width, table.Intern(attr)),
+    _table{ &table }
+{
+    _UpdateHyperlinks();
+}
+
+ATTR_ROW::~ATTR_ROW()
+{
+    _ReleaseHyperlinks();
+}
+
+// The hyperlink references are per row, so a copy needs references of its own.
+ATTR_ROW::ATTR_ROW(const ATTR_ROW& other) :
+    _data{ other._data },
+    _table{ other._table },
+    _hyperlinks{ other._hyperlinks }
+{
+    for (const auto id : _hyperlinks)
+    {
+        _table->AddHyperlinkReference(id);
+    }
+}
+
+ATTR_ROW& ATTR_ROW::operator=(const ATTR_ROW& other)
+{
+    if (this != &other)
+    {
+        ATTR_ROW copy{ other };
+        *this = std::move(copy);
+    }
+    return *this;
+}
+
+ATTR_ROW::ATTR_ROW(ATTR_ROW&& other) noexcept :
+    _data{ std::move(other._data) },
+    _table{ other._table },
+    _hyperlinks{ std::exchange(other._hyperlinks, {}) }
+{
+}
+
+ATTR_ROW& ATTR_ROW::operator=(ATTR_ROW&& other) noexcept
+{
+    if (this != &other)
+    {
+        _ReleaseHyperlinks();
+        _data = std::move(other._data);
+        _table = other._table;
+        _hyperlinks = std::exchange(other._hyperlinks, {});
+    }
+    return *this;
+}
 
 // Routine Description:
 // - Sets all properties of the ATTR_ROW to default values
@@ -20,7 +71,36 @@ ATTR_ROW::ATTR_ROW(const uint16_t width, const TextAttribute attr) :
 // - attr - The default text attributes to use on text in this row.
 void ATTR_ROW::Reset(const TextAttribute attr)
 {
-    _data.replace(0, _data.size(), attr);
+    _data.replace(0, _data.size(), _table->Intern(attr));
+    _UpdateHyperlinks();
+}
+
+// Routine Description:
+// - Gives access to the runs of attribute ids that make up the row.
+// Arguments:
+// - <none>
+// Return Value:
+// - The runs, from left to right. Their ids belong to the table of the text buffer.
+gsl::span<const ATTR_ROW::run_type> ATTR_ROW::GetRuns() const noexcept
+{
+    const auto& runs = _data.runs();
+    return { runs.data(), runs.size() };
+}
+
+// Routine Description:
+// - Replaces the attributes of the row with the given runs, as returned by GetRuns.
+// Arguments:
+// - runs - The runs of attribute ids. They have to be interned in the table of the
+//          text buffer already and cover exactly the width of the row.
+// Return Value:
+// - <none>, throws exceptions on failures.
+void ATTR_ROW::SetRuns(const gsl::span<const run_type> runs)
+{
+    rle_vector data{ rle_vector::container{ runs.begin(), runs.end() } };
+    THROW_HR_IF(E_INVALIDARG, data.size() != _data.size());
+
+    _data = std::move(data);
+    _UpdateHyperlinks();
 }
 
 // Routine Description:
@@ -35,6 +115,7 @@ void ATTR_ROW::Reset(const TextAttribute attr)
 void ATTR_ROW::Resize(const uint16_t newWidth)
 {
     _data.resize_trailing_extent(newWidth);
+    _UpdateHyperlinks();
 }
 
 // Routine Description:
@@ -47,24 +128,16 @@ void ATTR_ROW::Resize(const uint16_t newWidth)
 // - will throw on error
 TextAttribute ATTR_ROW::GetAttrByColumn(const uint16_t column) const
 {
-    return _data.at(column);
+    return _table->Get(_data.at(column));
 }
 
 // Routine Description:
-// - Finds the hyperlink IDs present in this row and returns them
+// - Returns the hyperlink IDs present in this row
 // Return value:
-// - The hyperlink IDs present in this row
-std::vector<uint16_t> ATTR_ROW::GetHyperlinks() const
+// - The distinct hyperlink IDs present in this row
+const std::vector<uint16_t>& ATTR_ROW::GetHyperlinks() const noexcept
 {
-    std::vector<uint16_t> ids;
-    for (const auto& run : _data.runs())
-    {
-        if (run.value.IsHyperlink())
-        {
-            ids.emplace_back(run.value.GetHyperlinkId());
-        }
-    }
-    return ids;
+    return _hyperlinks;
 }
 
 // Routine Description:
@@ -76,7 +149,18 @@ std::vector<uint16_t> ATTR_ROW::GetHyperlinks() const
 // - <none>
 bool ATTR_ROW::SetAttrToEnd(const uint16_t beginIndex, const TextAttribute attr)
 {
-    _data.replace(gsl::narrow<uint16_t>(beginIndex), _data.size(), attr);
+    // When text is written left to right with the same attributes (which is
+    // what both the output stream and Reflow do), the last run usually already
+    // covers everything from beginIndex onwards. Don't bother replacing it.
+    const auto id = _table->Intern(attr);
+    const auto& runs = _data.runs();
+    if (!runs.empty() && runs.back().value == id && _data.size() - runs.back().length <= beginIndex)
+    {
+        return true;
+    }
+
+    _data.replace(gsl::narrow<uint16_t>(beginIndex), _data.size(), id);
+    _UpdateHyperlinks();
     return true;
 }
 
@@ -90,7 +174,13 @@ bool ATTR_ROW::SetAttrToEnd(const uint16_t beginIndex, const TextAttribute attr)
 // - <none>
 void ATTR_ROW::ReplaceAttrs(const TextAttribute& toBeReplacedAttr, const TextAttribute& replaceWith)
 {
-    _data.replace_values(toBeReplacedAttr, replaceWith);
+    // The new attribute is interned first, because that may evict unused ones.
+    const auto newId = _table->Intern(replaceWith);
+    if (const auto oldId = _table->Find(toBeReplacedAttr))
+    {
+        _data.replace_values(*oldId, newId);
+        _UpdateHyperlinks();
+    }
 }
 
 // Routine Description:
@@ -105,30 +195,154 @@ void ATTR_ROW::ReplaceAttrs(const TextAttribute& toBeReplacedAttr, const TextAtt
 // - <none>
 void ATTR_ROW::Replace(const uint16_t beginIndex, const uint16_t endIndex, const TextAttribute& newAttr)
 {
-    _data.replace(beginIndex, endIndex, newAttr);
+    _data.replace(beginIndex, endIndex, _table->Intern(newAttr));
+    _UpdateHyperlinks();
+}
+
+// Routine Description:
+// - Replaces the attributes of as many columns as there are cells, starting at
+//   beginIndex, with the legacy attributes of the given cells. Neighboring cells
+//   with the same attributes are merged into a single run while walking them,
+//   so this costs one replacement per run, rather than one per cell.
+// Arguments:
+// - beginIndex - the first column to replace
+// - charInfos - the cells whose attributes to merge into this row
+// Return Value:
+// - <none>
+void ATTR_ROW::ReplaceLegacy(const uint16_t beginIndex, const gsl::span<const CHAR_INFO> charInfos)
+{
+    THROW_HR_IF(E_INVALIDARG, beginIndex > _data.size() || charInfos.size() > gsl::narrow_cast<size_t>(_data.size() - beginIndex));
+
+    auto runStart = beginIndex;
+    auto index = beginIndex;
+    WORD runAttributes = 0;
+
+    for (const auto& charInfo : charInfos)
+    {
+        // The lead and trailing byte flags don't make it into the TextAttribute,
+        // so they mustn't split the run of a wide glyph either.
+        const WORD attributes = charInfo.Attributes & ~COMMON_LVB_SBCSDBCS;
+        if (index != runStart && attributes != runAttributes)
+        {
+            // Interning may evict the ids that no row uses, so every
+            // run is placed right after its attribute was interned.
+            _data.replace(runStart, index, _table->Intern(TextAttribute{ runAttributes }));
+            runStart = index;
+        }
+        runAttributes = attributes;
+        ++index;
+    }
+
+    if (index != runStart)
+    {
+        _data.replace(runStart, index, _table->Intern(TextAttribute{ runAttributes }));
+    }
+
+    _UpdateHyperlinks();
+}
+
+// Routine Description:
+// - Marks the ids of the attributes used by this row, so that
+//   the table of the text buffer doesn't evict them.
+// Arguments:
+// - inUse - one entry per id in the table
+// Return Value:
+// - <none>
+void ATTR_ROW::MarkAttributesInUse(std::vector<bool>& inUse) const
+{
+    for (const auto& run : _data.runs())
+    {
+        inUse.at(run.value) = true;
+    }
+}
+
+// Routine Description:
+// - Brings the hyperlink references of this row up to date after its runs changed.
+// - This only walks the runs of this row, which is what lets the text buffer
+//   find out whether a hyperlink is still in use without scanning every row.
+// Arguments:
+// - <none>
+// Return Value:
+// - <none>
+void ATTR_ROW::_UpdateHyperlinks()
+{
+    // Most rows don't contain any hyperlinks, and then this doesn't allocate.
+    std::vector<uint16_t> hyperlinks;
+    for (const auto& run : _data.runs())
+    {
+        const auto& attr = _table->Get(run.value);
+        if (attr.IsHyperlink())
+        {
+            const auto id = attr.GetHyperlinkId();
+            if (std::find(hyperlinks.begin(), hyperlinks.end(), id) == hyperlinks.end())
+            {
+                hyperlinks.emplace_back(id);
+            }
+        }
+    }
+
+    if (hyperlinks == _hyperlinks)
+    {
+        return;
+    }
+
+    // Acquire the new references before releasing the old ones, so that
+    // the hyperlinks this row keeps never drop to zero references.
+    for (const auto id : hyperlinks)
+    {
+        _table->AddHyperlinkReference(id);
+    }
+    _ReleaseHyperlinks();
+    _hyperlinks = std::move(hyperlinks);
+}
+
+void ATTR_ROW::_ReleaseHyperlinks() noexcept
+{
+    for (const auto id : _hyperlinks)
+    {
+        _table->ReleaseHyperlinkReference(id);
+    }
+    _hyperlinks.clear();
 }
 
 ATTR_ROW::const_iterator ATTR_ROW::begin() const noexcept
 {
-    return _data.begin();
+    return { _data.begin(), _table };
 }
 
 ATTR_ROW::const_iterator ATTR_ROW::end() const noexcept
 {
-    return _data.end();
+    return { _data.end(), _table };
 }
 
 ATTR_ROW::const_iterator ATTR_ROW::cbegin() const noexcept
 {
-    return _data.cbegin();
+    return { _data.cbegin(), _table };
 }
 
 ATTR_ROW::const_iterator ATTR_ROW::cend() const noexcept
 {
-    return _data.cend();
+    return { _data.cend(), _table };
+}
+
+// Routine Description:
+// - Returns an iterator at the given column. Unlike cbegin() + column, this
+//   doesn't walk all the runs before it, if the row has many of them.
+// Arguments:
+// - column - the column to point at
+// Return Value:
+// - the iterator, or cend() if the column is past the end of the row
+ATTR_ROW::const_iterator ATTR_ROW::IteratorAt(const uint16_t column) const noexcept
+{
+    return { _data.iterator_at(column), _table };
 }
 
 bool operator==(const ATTR_ROW& a, const ATTR_ROW& b) noexcept
 {
-    return a._data == b._data;
+    // Ids can only be compared if they come from the same table.
+    if (a._table == b._table)
+    {
+        return a._data == b._data;
+    }
+    return std::equal(a.begin(), a.end(), b.begin(), b.end());
 }
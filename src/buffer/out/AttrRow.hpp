@@ -22,31 +22,109 @@ Revision History:
 
 #include "til/rle.h"
 #include "TextAttribute.hpp"
+#include "TextAttributeTable.hpp"
 
 class ATTR_ROW final
 {
-    using rle_vector = til::small_rle<TextAttribute, uint16_t, 1>;
+    // The runs only hold the ids of their attributes in the _table of the text buffer.
+    using rle_vector = til::small_rle<TextAttributeTable::Id, uint16_t, 1>;
 
 public:
-    using const_iterator = rle_vector::const_iterator;
-
-    ATTR_ROW(uint16_t width, TextAttribute attr);
-
-    ~ATTR_ROW() = default;
-
-    ATTR_ROW(const ATTR_ROW&) = default;
-    ATTR_ROW& operator=(const ATTR_ROW&) = default;
-    ATTR_ROW(ATTR_ROW&&)
-    noexcept = default;
-    ATTR_ROW& operator=(ATTR_ROW&&) noexcept = default;
+    // A run of columns that share the attribute with the given id.
+    using run_type = rle_vector::rle_type;
+
+    // Iterates over the attributes of every column, resolving their ids on the way.
+    class const_iterator
+    {
+    public:
+        using iterator_category = std::random_access_iterator_tag;
+        using value_type = TextAttribute;
+        using pointer = const TextAttribute*;
+        using reference = const TextAttribute&;
+        using difference_type = rle_vector::const_iterator::difference_type;
+
+        const_iterator(rle_vector::const_iterator it, const TextAttributeTable* table) noexcept :
+            _it{ it },
+            _table{ table }
+        {
+        }
+
+        reference operator*() const noexcept { return _table->Get(*_it); }
+        pointer operator->() const noexcept { return &operator*(); }
+
+        // Two columns have the same attribute if and only if their ids are equal.
+        TextAttributeTable::Id GetAttributeId() const noexcept { return *_it; }
+
+        const_iterator& operator++() noexcept
+        {
+            ++_it;
+            return *this;
+        }
+        const_iterator operator++(int) noexcept
+        {
+            auto tmp = *this;
+            ++_it;
+            return tmp;
+        }
+        const_iterator& operator--() noexcept
+        {
+            --_it;
+            return *this;
+        }
+        const_iterator operator--(int) noexcept
+        {
+            auto tmp = *this;
+            --_it;
+            return tmp;
+        }
+        const_iterator& operator+=(const difference_type offset) noexcept
+        {
+            _it += offset;
+            return *this;
+        }
+        const_iterator& operator-=(const difference_type offset) noexcept
+        {
+            _it -= offset;
+            return *this;
+        }
+        const_iterator operator+(const difference_type offset) const noexcept { return { _it + offset, _table }; }
+        const_iterator operator-(const difference_type offset) const noexcept { return { _it - offset, _table }; }
+        difference_type operator-(const const_iterator& right) const noexcept { return _it - right._it; }
+        reference operator[](const difference_type offset) const noexcept { return *operator+(offset); }
+
+        bool operator==(const const_iterator& right) const noexcept { return _it == right._it; }
+        bool operator!=(const const_iterator& right) const noexcept { return _it != right._it; }
+        bool operator<(const const_iterator& right) const noexcept { return _it < right._it; }
+        bool operator>(const const_iterator& right) const noexcept { return _it > right._it; }
+        bool operator<=(const const_iterator& right) const noexcept { return _it <= right._it; }
+        bool operator>=(const const_iterator& right) const noexcept { return _it >= right._it; }
+
+    private:
+        rle_vector::const_iterator _it;
+        const TextAttributeTable* _table;
+    };
+
+    ATTR_ROW(uint16_t width, TextAttribute attr, TextAttributeTable& table);
+
+    ~ATTR_ROW();
+
+    ATTR_ROW(const ATTR_ROW& other);
+    ATTR_ROW& operator=(const ATTR_ROW& other);
+    ATTR_ROW(ATTR_ROW&& other) noexcept;
+    ATTR_ROW& operator=(ATTR_ROW&& other) noexcept;
 
     TextAttribute GetAttrByColumn(uint16_t column) const;
-    std::vector<uint16_t> GetHyperlinks() const;
+    const std::vector<uint16_t>& GetHyperlinks() const noexcept;
 
     bool SetAttrToEnd(uint16_t beginIndex, TextAttribute attr);
     void ReplaceAttrs(const TextAttribute& toBeReplacedAttr, const TextAttribute& replaceWith);
     void Resize(uint16_t newWidth);
     void Replace(uint16_t beginIndex, uint16_t endIndex, const TextAttribute& newAttr);
+    void ReplaceLegacy(uint16_t beginIndex, const gsl::span<const CHAR_INFO> charInfos);
+    void MarkAttributesInUse(std::vector<bool>& inUse) const;
+
+    gsl::span<const run_type> GetRuns() const noexcept;
+    void SetRuns(const gsl::span<const run_type> runs);
 
     const_iterator begin() const noexcept;
     const_iterator end() const noexcept;
@@ -54,13 +132,22 @@ public:
     const_iterator cbegin() const noexcept;
     const_iterator cend() const noexcept;
 
+    const_iterator IteratorAt(uint16_t column) const noexcept;
+
     friend bool operator==(const ATTR_ROW& a, const ATTR_ROW& b) noexcept;
     friend class ROW;
 
 private:
     void Reset(const TextAttribute attr);
+    void _UpdateHyperlinks();
+    void _ReleaseHyperlinks() noexcept;
 
     rle_vector _data;
+    TextAttributeTable* _table; // non ownership pointer
+
+    // The distinct hyperlink ids in this row. Each of them holds
+    // a reference on the hyperlink in the _table.
+    std::vector<uint16_t> _hyperlinks;
 
 #ifdef UNIT_TESTING
     friend class CommonState;
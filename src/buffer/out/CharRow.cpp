@@ -6,19 +6,30 @@
 #include "CharRow.hpp"
 #include "unicode.hpp"
 #include "Row.hpp"
+#include "RowSpillFile.hpp"
+
+#include <til/ticket_lock.h>
+
+// Serializes thawing rows, which readers may do while sharing the buffer's lock.
+// Thawing is rare and short, so one lock for all rows is plenty.
+static til::ticket_lock s_thawLock;
+// Counts the rows thawed under s_thawLock, so that buffers can tell when they have to freeze rows again.
+static std::atomic<size_t> s_thawCount{ 0 };
 
 // Routine Description:
 // - constructor
 // Arguments:
 // - rowWidth - the size (in wchar_t) of the char and attribute rows
 // - pParent - the parent ROW
+// - resource - where to allocate the cells of rows wider than InlineCapacity
 // Return Value:
 // - instantiated object
 // Note: will through if unable to allocate char/attribute buffers
 #pragma warning(push)
 #pragma warning(disable : 26447) // small_vector's constructor says it can throw but it should not given how we use it.  This suppresses this error for the AuditMode build.
-CharRow::CharRow(size_t rowWidth, ROW* const pParent) noexcept :
-    _data(rowWidth, value_type()),
+CharRow::CharRow(size_t rowWidth, ROW* const pParent, std::pmr::memory_resource* const resource) noexcept :
+    _chars(rowWidth, UNICODE_SPACE, std::pmr::polymorphic_allocator<wchar_t>{ resource }),
+    _dbcsAttrs(rowWidth, DbcsAttribute{}, std::pmr::polymorphic_allocator<DbcsAttribute>{ resource }),
     _pParent{ FAIL_FAST_IF_NULL(pParent) }
 {
 }
@@ -32,7 +43,7 @@ CharRow::CharRow(size_t rowWidth, ROW* const pParent) noexcept :
 // - the size of the row
 size_t CharRow::size() const noexcept
 {
-    return _data.size();
+    return _chars.size();
 }
 
 // Routine Description:
@@ -43,10 +54,30 @@ size_t CharRow::size() const noexcept
 // - <none>
 void CharRow::Reset() noexcept
 {
-    for (auto& cell : _data)
+    _unicodeStorage.Clear();
+
+    if (IsFrozen())
     {
-        cell.Reset();
+        // There's no point in inflating the old contents just to erase them.
+        // Readers may reset rows while sharing the buffer's lock (see TextBuffer::_ResetIfCleared)
+        // and other readers may be thawing rows at the same time, which releases their slots, too.
+        {
+            const std::lock_guard guard{ s_thawLock };
+            if (_spillFile)
+            {
+                _spillFile->Release(_spillSlot);
+                _spillFile = nullptr;
+            }
+            _frozenData.clear();
+        }
+        Thaw();
+        return;
     }
+
+    // The unicode storage was just cleared, so there are no stored glyphs
+    // left to unlink and every cell can simply be overwritten with the default.
+    std::fill(_chars.begin(), _chars.end(), UNICODE_SPACE);
+    std::fill(_dbcsAttrs.begin(), _dbcsAttrs.end(), DbcsAttribute{});
 }
 
 // Routine Description:
@@ -57,34 +88,120 @@ void CharRow::Reset() noexcept
 // - S_OK on success, otherwise relevant error code
 [[nodiscard]] HRESULT CharRow::Resize(const size_t newSize) noexcept
 {
+    Thaw();
+
     try
     {
-        const value_type insertVals;
-        _data.resize(newSize, insertVals);
+        _chars.resize(newSize, UNICODE_SPACE);
+        _dbcsAttrs.resize(newSize, DbcsAttribute{});
+        _unicodeStorage.Truncate(newSize);
     }
     CATCH_RETURN();
 
     return S_OK;
 }
 
-typename CharRow::iterator CharRow::begin() noexcept
+#pragma warning(push)
+#pragma warning(disable : 26481) // Don't use pointer arithmetic. Use span instead (bounds.1).
+#pragma warning(disable : 26490) // Don't use reinterpret_cast (type.1).
+
+// Routine Description:
+// - Finds the first wchar_t that isn't a space.
+// Arguments:
+// - data - the characters to scan
+// - size - the number of characters
+// Return Value:
+// - The index of the first character that isn't a space, or size if there isn't any.
+static size_t s_FindFirstNonSpace(const wchar_t* const data, const size_t size) noexcept
 {
-    return _data.begin();
+    static_assert(sizeof(wchar_t) == sizeof(uint16_t), "The vectorized code below assumes UTF-16 code units.");
+
+    size_t offset = 0;
+
+#if _M_AMD64
+    const auto spaces = _mm_set1_epi16(UNICODE_SPACE);
+
+    for (; offset + 8 <= size; offset += 8)
+    {
+        const auto chars = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + offset));
+        const auto mask = static_cast<unsigned long>(~_mm_movemask_epi8(_mm_cmpeq_epi16(chars, spaces)) & 0xffff);
+        unsigned long index;
+        if (_BitScanForward(&index, mask))
+        {
+            // movemask returns 2 bits per 16-bit lane.
+            return offset + index / 2;
+        }
+    }
+#endif
+
+    for (; offset < size; ++offset)
+    {
+        if (data[offset] != UNICODE_SPACE)
+        {
+            break;
+        }
+    }
+    return offset;
 }
 
-typename CharRow::const_iterator CharRow::cbegin() const noexcept
+// Routine Description:
+// - Finds the end of the last wchar_t that isn't a space.
+// Arguments:
+// - data - the characters to scan
+// - size - the number of characters
+// Return Value:
+// - The index past the last character that isn't a space, or 0 if there isn't any.
+static size_t s_FindEndOfLastNonSpace(const wchar_t* const data, const size_t size) noexcept
 {
-    return _data.cbegin();
+    auto end = size;
+
+#if _M_AMD64
+    const auto spaces = _mm_set1_epi16(UNICODE_SPACE);
+
+    for (; end >= 8; end -= 8)
+    {
+        const auto chars = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + end - 8));
+        const auto mask = static_cast<unsigned long>(~_mm_movemask_epi8(_mm_cmpeq_epi16(chars, spaces)) & 0xffff);
+        unsigned long index;
+        if (_BitScanReverse(&index, mask))
+        {
+            return end - 8 + index / 2 + 1;
+        }
+    }
+#endif
+
+    for (; end > 0; --end)
+    {
+        if (data[end - 1] != UNICODE_SPACE)
+        {
+            break;
+        }
+    }
+    return end;
 }
 
-typename CharRow::iterator CharRow::end() noexcept
+#pragma warning(pop)
+
+// Routine Description:
+// - Checks whether the cell at column contains a space glyph.
+// Arguments:
+// - column - the column to check. It must be within the row.
+// Return Value:
+// - true if the cell contains a space glyph, false otherwise
+bool CharRow::_IsSpaceAt(const size_t column) const noexcept
 {
-    return _data.end();
+    return !til::at(_dbcsAttrs, column).IsGlyphStored() && til::at(_chars, column) == UNICODE_SPACE;
 }
 
-typename CharRow::const_iterator CharRow::cend() const noexcept
+// Routine Description:
+// - Combines the wchar_t and the DbcsAttribute of a column into a single cell.
+// Arguments:
+// - column - the column to combine. It must be within the row.
+// Return Value:
+// - The cell
+CharRow::value_type CharRow::_CellAt(const size_t column) const noexcept
 {
-    return _data.cend();
+    return { til::at(_chars, column), til::at(_dbcsAttrs, column) };
 }
 
 // Routine Description:
@@ -95,12 +212,18 @@ typename CharRow::const_iterator CharRow::cend() const noexcept
 // - The calculated left boundary of the internal string.
 size_t CharRow::MeasureLeft() const noexcept
 {
-    const_iterator it = _data.cbegin();
-    while (it != _data.cend() && it->IsSpace())
+    // Without any stored glyphs a cell is blank if and only if its wchar_t is a space.
+    if (_unicodeStorage.empty())
+    {
+        return s_FindFirstNonSpace(_chars.data(), _chars.size());
+    }
+
+    size_t column = 0;
+    while (column < _chars.size() && _IsSpaceAt(column))
     {
-        ++it;
+        ++column;
     }
-    return it - _data.cbegin();
+    return column;
 }
 
 // Routine Description:
@@ -111,17 +234,78 @@ size_t CharRow::MeasureLeft() const noexcept
 // - The calculated right boundary of the internal string.
 size_t CharRow::MeasureRight() const
 {
-    const_reverse_iterator it = _data.crbegin();
-    while (it != _data.crend() && it->IsSpace())
+    if (_unicodeStorage.empty())
     {
-        ++it;
+        return s_FindEndOfLastNonSpace(_chars.data(), _chars.size());
     }
-    return _data.crend() - it;
+
+    auto column = _chars.size();
+    while (column > 0 && _IsSpaceAt(column - 1))
+    {
+        --column;
+    }
+    return column;
 }
 
 void CharRow::ClearCell(const size_t column)
 {
-    _data.at(column).Reset();
+    _chars.at(column) = UNICODE_SPACE;
+    _dbcsAttrs.at(column).Reset();
+}
+
+// Routine Description:
+// - Writes narrow glyphs into consecutive cells, one wchar_t per cell.
+// Arguments:
+// - column - the column to start writing at
+// - text - the glyphs to write. None of them may be wide or a surrogate.
+void CharRow::WriteNarrowGlyphs(const size_t column, const std::wstring_view text)
+{
+    THROW_HR_IF(E_INVALIDARG, column > _chars.size() || text.size() > _chars.size() - column);
+
+    std::copy(text.begin(), text.end(), _chars.begin() + column);
+    std::fill_n(_dbcsAttrs.begin() + column, text.size(), DbcsAttribute{});
+}
+
+// Routine Description:
+// - Fills consecutive cells with the same narrow glyph.
+// Arguments:
+// - column - the column to start filling at
+// - wch - the glyph to fill with. It may not be wide or a surrogate.
+// - count - the number of cells to fill
+void CharRow::FillNarrowGlyph(const size_t column, const wchar_t wch, const size_t count)
+{
+    THROW_HR_IF(E_INVALIDARG, column > _chars.size() || count > _chars.size() - column);
+
+    std::fill_n(_chars.begin() + column, count, wch);
+    std::fill_n(_dbcsAttrs.begin() + column, count, DbcsAttribute{});
+}
+
+// Routine Description:
+// - Writes the text of legacy cells into consecutive cells, along with their
+//   lead and trailing byte flags.
+// Arguments:
+// - column - the column to start writing at
+// - charInfos - the cells to write
+void CharRow::WriteCharInfos(const size_t column, const gsl::span<const CHAR_INFO> charInfos)
+{
+    THROW_HR_IF(E_INVALIDARG, column > _chars.size() || charInfos.size() > _chars.size() - column);
+
+    auto index = column;
+    for (const auto& charInfo : charInfos)
+    {
+        til::at(_chars, index) = charInfo.Char.UnicodeChar;
+        auto& dbcsAttr = til::at(_dbcsAttrs, index);
+        dbcsAttr.Reset();
+        if (WI_IsFlagSet(charInfo.Attributes, COMMON_LVB_LEADING_BYTE))
+        {
+            dbcsAttr.SetLeading();
+        }
+        else if (WI_IsFlagSet(charInfo.Attributes, COMMON_LVB_TRAILING_BYTE))
+        {
+            dbcsAttr.SetTrailing();
+        }
+        ++index;
+    }
 }
 
 // Routine Description:
@@ -132,14 +316,7 @@ void CharRow::ClearCell(const size_t column)
 // - True if there is valid text in this row. False otherwise.
 bool CharRow::ContainsText() const noexcept
 {
-    for (const value_type& cell : _data)
-    {
-        if (!cell.IsSpace())
-        {
-            return true;
-        }
-    }
-    return false;
+    return MeasureLeft() != _chars.size();
 }
 
 // Routine Description:
@@ -151,7 +328,7 @@ bool CharRow::ContainsText() const noexcept
 // Note: will throw exception if column is out of bounds
 const DbcsAttribute& CharRow::DbcsAttrAt(const size_t column) const
 {
-    return _data.at(column).DbcsAttr();
+    return _dbcsAttrs.at(column);
 }
 
 // Routine Description:
@@ -163,7 +340,7 @@ const DbcsAttribute& CharRow::DbcsAttrAt(const size_t column) const
 // Note: will throw exception if column is out of bounds
 DbcsAttribute& CharRow::DbcsAttrAt(const size_t column)
 {
-    return _data.at(column).DbcsAttr();
+    return _dbcsAttrs.at(column);
 }
 
 // Routine Description:
@@ -175,7 +352,8 @@ DbcsAttribute& CharRow::DbcsAttrAt(const size_t column)
 // Note: will throw exception if column is out of bounds
 void CharRow::ClearGlyph(const size_t column)
 {
-    _data.at(column).EraseChars();
+    _chars.at(column) = UNICODE_SPACE;
+    _dbcsAttrs.at(column).SetGlyphStored(false);
 }
 
 // Routine Description:
@@ -187,7 +365,7 @@ void CharRow::ClearGlyph(const size_t column)
 // - Note: will throw exception if column is out of bounds
 const CharRow::reference CharRow::GlyphAt(const size_t column) const
 {
-    THROW_HR_IF(E_INVALIDARG, column >= _data.size());
+    THROW_HR_IF(E_INVALIDARG, column >= _chars.size());
     return { const_cast<CharRow&>(*this), column };
 }
 
@@ -200,16 +378,39 @@ const CharRow::reference CharRow::GlyphAt(const size_t column) const
 // - Note: will throw exception if column is out of bounds
 CharRow::reference CharRow::GlyphAt(const size_t column)
 {
-    THROW_HR_IF(E_INVALIDARG, column >= _data.size());
+    THROW_HR_IF(E_INVALIDARG, column >= _chars.size());
     return { *this, column };
 }
 
 std::wstring CharRow::GetText() const
 {
+    // Without any stored glyphs the text is the row's wchar_t's,
+    // minus those of the trailing halves of wide glyphs.
+    if (_unicodeStorage.empty())
+    {
+        std::wstring wstr{ _chars.data(), _chars.size() };
+
+        const auto isTrailing = [](const DbcsAttribute attr) noexcept { return attr.IsTrailing(); };
+        const auto firstTrailing = std::find_if(_dbcsAttrs.cbegin(), _dbcsAttrs.cend(), isTrailing);
+        if (firstTrailing != _dbcsAttrs.cend())
+        {
+            auto out = gsl::narrow_cast<size_t>(firstTrailing - _dbcsAttrs.cbegin());
+            for (auto i = out + 1; i < _chars.size(); ++i)
+            {
+                if (!til::at(_dbcsAttrs, i).IsTrailing())
+                {
+                    til::at(wstr, out++) = til::at(_chars, i);
+                }
+            }
+            wstr.resize(out);
+        }
+        return wstr;
+    }
+
     std::wstring wstr;
-    wstr.reserve(_data.size());
+    wstr.reserve(_chars.size());
 
-    for (size_t i = 0; i < _data.size(); ++i)
+    for (size_t i = 0; i < _chars.size(); ++i)
     {
         const auto glyph = GlyphAt(i);
         if (!DbcsAttrAt(i).IsTrailing())
@@ -223,41 +424,112 @@ std::wstring CharRow::GetText() const
     return wstr;
 }
 
-// Method Description:
-// - get delimiter class for a position in the char row
-// - used for double click selection and uia word navigation
+// Routine Description:
+// - constructor
 // Arguments:
-// - column: column to get text data for
 // - wordDelimiters: the delimiters defined as a part of the DelimiterClass::DelimiterChar
+DelimiterSet::DelimiterSet(const std::wstring_view wordDelimiters)
+{
+    for (const auto wch : wordDelimiters)
+    {
+        if (wch < _ascii.size())
+        {
+            til::at(_ascii, wch) = true;
+        }
+        else
+        {
+            _other.push_back(wch);
+        }
+    }
+
+    std::sort(_other.begin(), _other.end());
+}
+
+// Method Description:
+// - get delimiter class for the first character of a glyph
+// Arguments:
+// - glyph: the character to classify
 // Return Value:
 // - the delimiter class for the given char
-const DelimiterClass CharRow::DelimiterClassAt(const size_t column, const std::wstring_view wordDelimiters) const
+DelimiterClass DelimiterSet::Classify(const wchar_t glyph) const noexcept
 {
-    THROW_HR_IF(E_INVALIDARG, column >= _data.size());
-
-    const auto glyph = *GlyphAt(column).begin();
     if (glyph <= UNICODE_SPACE)
     {
         return DelimiterClass::ControlChar;
     }
-    else if (wordDelimiters.find(glyph) != std::wstring_view::npos)
-    {
-        return DelimiterClass::DelimiterChar;
-    }
-    else
+
+    const auto isDelimiter = glyph < _ascii.size() ? til::at(_ascii, glyph) : std::binary_search(_other.begin(), _other.end(), glyph);
+    return isDelimiter ? DelimiterClass::DelimiterChar : DelimiterClass::RegularChar;
+}
+
+// Routine Description:
+// - returns the first character of the glyph at column, which is what its delimiter class depends on
+// Arguments:
+// - column: column to get text data for
+// Return Value:
+// - the first character of the glyph
+wchar_t CharRow::_FirstGlyphCharAt(const size_t column) const
+{
+    return til::at(_dbcsAttrs, column).IsGlyphStored() ? *GlyphAt(column).begin() : til::at(_chars, column);
+}
+
+// Method Description:
+// - get delimiter class for a position in the char row
+// - used for double click selection and uia word navigation
+// Arguments:
+// - column: column to get text data for
+// - delimiters: the delimiters defined as a part of the DelimiterClass::DelimiterChar
+// Return Value:
+// - the delimiter class for the given char
+const DelimiterClass CharRow::DelimiterClassAt(const size_t column, const DelimiterSet& delimiters) const
+{
+    THROW_HR_IF(E_INVALIDARG, column >= _chars.size());
+    return delimiters.Classify(_FirstGlyphCharAt(column));
+}
+
+// Method Description:
+// - Walks the row from column until it finds a cell whose delimiter class ends the
+//   run of cells that's being skipped over. Cells are skipped while
+//   (their delimiter class == delimiterClass) == skipEqual.
+// - used to walk over words a row at a time, instead of one cell at a time
+// Arguments:
+// - column: the column to start at. It's checked as well.
+// - delimiterClass: the delimiter class to compare the cells with
+// - skipEqual: whether cells of delimiterClass are skipped, or all other cells are
+// - delimiters: the delimiters defined as a part of the DelimiterClass::DelimiterChar
+// - forward: whether to walk to the right or to the left
+// Return Value:
+// - the column of the first cell that isn't skipped, or
+//   nullopt if all cells up to the edge of the row are
+std::optional<size_t> CharRow::FindDelimiterClassChange(const size_t column,
+                                                        const DelimiterClass delimiterClass,
+                                                        const bool skipEqual,
+                                                        const DelimiterSet& delimiters,
+                                                        const bool forward) const
+{
+    THROW_HR_IF(E_INVALIDARG, column >= _chars.size());
+
+    for (auto i = column;; forward ? ++i : --i)
     {
-        return DelimiterClass::RegularChar;
+        if ((delimiters.Classify(_FirstGlyphCharAt(i)) == delimiterClass) != skipEqual)
+        {
+            return i;
+        }
+        if (forward ? i + 1 == _chars.size() : i == 0)
+        {
+            return std::nullopt;
+        }
     }
 }
 
 UnicodeStorage& CharRow::GetUnicodeStorage() noexcept
 {
-    return _pParent->GetUnicodeStorage();
+    return _unicodeStorage;
 }
 
 const UnicodeStorage& CharRow::GetUnicodeStorage() const noexcept
 {
-    return _pParent->GetUnicodeStorage();
+    return _unicodeStorage;
 }
 
 // Routine Description:
@@ -265,10 +537,203 @@ const UnicodeStorage& CharRow::GetUnicodeStorage() const noexcept
 // Arguments:
 // - column - the column to generate the key for
 // Return Value:
-// - the COORD key for data access from UnicodeStorage for the column
-COORD CharRow::GetStorageKey(const size_t column) const noexcept
+// - the key for data access from UnicodeStorage for the column
+UnicodeStorage::key_type CharRow::GetStorageKey(const size_t column) const noexcept
+{
+    return gsl::narrow_cast<UnicodeStorage::key_type>(column);
+}
+
+// Routine Description:
+// - Moves the contents of the row into a compact copy that only holds the cells
+//   up to the last non-blank one, and releases the full width storage.
+// - Characters that live in UnicodeStorage are kept as they are.
+// Arguments:
+// - <none>
+// Return Value:
+// - <none>
+void CharRow::Freeze()
 {
-    return { gsl::narrow<SHORT>(column), _pParent->GetId() };
+    if (IsFrozen())
+    {
+        return;
+    }
+
+    const auto width = _CompactWidth();
+    _frozenData.clear();
+    _frozenData.reserve(width);
+    for (size_t i = 0; i < width; ++i)
+    {
+        _frozenData.emplace_back(_CellAt(i));
+    }
+
+    _frozenWidth = _chars.size();
+    _chars.clear();
+    _chars.shrink_to_fit();
+    _dbcsAttrs.clear();
+    _dbcsAttrs.shrink_to_fit();
+    _frozen = TRUE;
+}
+
+// Routine Description:
+// - Freezes the row and then moves its compact copy out into the given spill
+//   file, so that it takes up no memory at all until it is thawed again.
+// - If the spill file has no room for the row, it just stays frozen.
+// Arguments:
+// - spillFile - the file to move the row into. It must outlive the row.
+// Return Value:
+// - <none>
+void CharRow::Spill(RowSpillFile& spillFile)
+{
+    Freeze();
+    if (_spillFile)
+    {
+        return;
+    }
+
+    if (const auto slot = spillFile.Store(_frozenData))
+    {
+        _spillFile = &spillFile;
+        _spillSlot = *slot;
+        std::vector<value_type>{}.swap(_frozenData);
+    }
+}
+
+// Routine Description:
+// - Replaces the contents of the row with the ones in the given slot of a store,
+//   without reading them yet. They're loaded once the row is thawed.
+// - Characters that live in UnicodeStorage have to be stored separately.
+// Arguments:
+// - store - the store holding the row. It must outlive the row.
+// - slot - the slot of the row in the store
+// Return Value:
+// - <none>
+void CharRow::FreezeInto(RowStore& store, const size_t slot) noexcept
+{
+    if (!IsFrozen())
+    {
+        _frozenWidth = _chars.size();
+        _chars.clear();
+        _chars.shrink_to_fit();
+        _dbcsAttrs.clear();
+        _dbcsAttrs.shrink_to_fit();
+    }
+    else if (_spillFile)
+    {
+        _spillFile->Release(_spillSlot);
+    }
+
+    std::vector<value_type>{}.swap(_frozenData);
+    _spillFile = &store;
+    _spillSlot = slot;
+    _frozen = TRUE;
+}
+
+// Routine Description:
+// - Restores the full width storage of a row frozen by Freeze() or Spill().
+// Arguments:
+// - <none>
+// Return Value:
+// - <none>
+// Note: will fail fast if unable to allocate the row
+// Note: this may be called concurrently by readers holding a shared lock on the
+//       buffer, which is why the row is only marked as thawed once it's complete.
+#pragma warning(push)
+#pragma warning(disable : 26447) // small_vector's assign and resize say they can throw, but failing to thaw a row isn't recoverable anyway.
+void CharRow::Thaw() noexcept
+{
+    if (!IsFrozen())
+    {
+        return;
+    }
+
+    const std::lock_guard guard{ s_thawLock };
+    if (!_frozen)
+    {
+        return;
+    }
+
+    if (_spillFile)
+    {
+        _spillFile->Load(_spillSlot, _frozenData);
+        _spillFile->Release(_spillSlot);
+        _spillFile = nullptr;
+    }
+
+    _chars.resize(_frozenWidth, UNICODE_SPACE);
+    _dbcsAttrs.resize(_frozenWidth, DbcsAttribute{});
+    const auto count = std::min(_frozenData.size(), _frozenWidth);
+    for (size_t i = 0; i < count; ++i)
+    {
+        const auto& cell = til::at(_frozenData, i);
+        til::at(_chars, i) = cell.Char();
+        til::at(_dbcsAttrs, i) = cell.DbcsAttr();
+    }
+    std::vector<value_type>{}.swap(_frozenData);
+    s_thawCount.fetch_add(1, std::memory_order_relaxed);
+    WriteRelease(&_frozen, FALSE);
+}
+#pragma warning(pop)
+
+// Routine Description:
+// - Gets the number of rows (of any buffer) that were thawed so far.
+// Arguments:
+// - <none>
+// Return Value:
+// - The number of thawed rows. It only ever grows.
+size_t CharRow::ThawCount() noexcept
+{
+    return s_thawCount.load(std::memory_order_relaxed);
+}
+
+// Routine Description:
+// - Copies the cells of the row up to the last non-blank one, the same way
+//   Freeze() would keep them, but without thawing a frozen row.
+// Arguments:
+// - cells - receives the cells
+// Return Value:
+// - <none>
+void CharRow::CopyCompactCells(std::vector<value_type>& cells) const
+{
+    const std::lock_guard guard{ s_thawLock };
+    if (_frozen)
+    {
+        if (_spillFile)
+        {
+            _spillFile->Load(_spillSlot, cells);
+        }
+        else
+        {
+            cells = _frozenData;
+        }
+        return;
+    }
+
+    const auto width = _CompactWidth();
+    cells.clear();
+    cells.reserve(width);
+    for (size_t i = 0; i < width; ++i)
+    {
+        cells.emplace_back(_CellAt(i));
+    }
+}
+
+// Routine Description:
+// - Returns the number of cells up to the last one that isn't blank,
+//   which are all the cells that Freeze() and CopyCompactCells() keep.
+// Arguments:
+// - <none>
+// Return Value:
+// - The number of cells to keep.
+size_t CharRow::_CompactWidth() const noexcept
+{
+    // Just like comparing each cell to a default constructed one, this ignores whether the glyph is stored.
+    const DbcsAttribute blank{};
+    auto width = _chars.size();
+    while (width > 0 && til::at(_chars, width - 1) == UNICODE_SPACE && til::at(_dbcsAttrs, width - 1) == blank)
+    {
+        --width;
+    }
+    return width;
 }
 
 // Routine Description:
@@ -26,6 +26,8 @@ Revision History:
 #include "UnicodeStorage.hpp"
 
 class ROW;
+class RowStore;
+class RowSpillFile;
 
 enum class DelimiterClass
 {
@@ -34,6 +36,21 @@ enum class DelimiterClass
     RegularChar
 };
 
+// The word delimiters used for double click selection and uia word navigation,
+// prepared once so that classifying a glyph doesn't have to search through them.
+// ASCII delimiters are kept in a lookup table and any others in a sorted list.
+class DelimiterSet final
+{
+public:
+    explicit DelimiterSet(const std::wstring_view wordDelimiters);
+
+    DelimiterClass Classify(const wchar_t glyph) const noexcept;
+
+private:
+    std::array<bool, 128> _ascii{};
+    std::vector<wchar_t> _other;
+};
+
 // the characters of one row of screen buffer
 // we keep the following values so that we don't write
 // more pixels to the screen than we have to:
@@ -48,13 +65,19 @@ class CharRow final
 {
 public:
     using glyph_type = typename wchar_t;
+    // The cells of a row are kept as two parallel arrays, one of wchar_t's and one of DbcsAttributes,
+    // so that scanning the text of a row doesn't have to stride over the attributes. value_type is the
+    // combined cell, which is what frozen and spilled rows are stored as.
     using value_type = typename CharRowCell;
-    using iterator = typename boost::container::small_vector_base<value_type>::iterator;
-    using const_iterator = typename boost::container::small_vector_base<value_type>::const_iterator;
-    using const_reverse_iterator = typename boost::container::small_vector_base<value_type>::const_reverse_iterator;
     using reference = typename CharRowCellReference;
 
-    CharRow(size_t rowWidth, ROW* const pParent) noexcept;
+    // Rows up to this many cells wide are stored inline and never touch the memory resource.
+    static constexpr size_t InlineCapacity = 120;
+
+    // How many rows were thawed so far, by all buffers. See TextBuffer::RefreezeColdRows.
+    static size_t ThawCount() noexcept;
+
+    CharRow(size_t rowWidth, ROW* const pParent, std::pmr::memory_resource* const resource = til::pmr::get_default_resource()) noexcept;
 
     size_t size() const noexcept;
     [[nodiscard]] HRESULT Resize(const size_t newSize) noexcept;
@@ -65,24 +88,16 @@ public:
     DbcsAttribute& DbcsAttrAt(const size_t column);
     void ClearGlyph(const size_t column);
 
-    const DelimiterClass DelimiterClassAt(const size_t column, const std::wstring_view wordDelimiters) const;
+    const DelimiterClass DelimiterClassAt(const size_t column, const DelimiterSet& delimiters) const;
+    std::optional<size_t> FindDelimiterClassChange(const size_t column, const DelimiterClass delimiterClass, const bool skipEqual, const DelimiterSet& delimiters, const bool forward) const;
 
     // working with glyphs
     const reference GlyphAt(const size_t column) const;
     reference GlyphAt(const size_t column);
 
-    // iterators
-    iterator begin() noexcept;
-    const_iterator cbegin() const noexcept;
-    const_iterator begin() const noexcept { return cbegin(); }
-
-    iterator end() noexcept;
-    const_iterator cend() const noexcept;
-    const_iterator end() const noexcept { return cend(); }
-
     UnicodeStorage& GetUnicodeStorage() noexcept;
     const UnicodeStorage& GetUnicodeStorage() const noexcept;
-    COORD GetStorageKey(const size_t column) const noexcept;
+    UnicodeStorage::key_type GetStorageKey(const size_t column) const noexcept;
 
     void UpdateParent(ROW* const pParent);
 
@@ -90,26 +105,60 @@ public:
     friend class ROW;
 
 private:
+    wchar_t _FirstGlyphCharAt(const size_t column) const;
+    bool _IsSpaceAt(const size_t column) const noexcept;
+    value_type _CellAt(const size_t column) const noexcept;
+    size_t _CompactWidth() const noexcept;
     void Reset() noexcept;
     void ClearCell(const size_t column);
+    void WriteNarrowGlyphs(const size_t column, const std::wstring_view text);
+    void FillNarrowGlyph(const size_t column, const wchar_t wch, const size_t count);
+    void WriteCharInfos(const size_t column, const gsl::span<const CHAR_INFO> charInfos);
     std::wstring GetText() const;
 
+    void Freeze();
+    void Spill(RowSpillFile& spillFile);
+    void FreezeInto(RowStore& store, const size_t slot) noexcept;
+    void Thaw() noexcept;
+    void CopyCompactCells(std::vector<value_type>& cells) const;
+    bool IsFrozen() const noexcept { return ReadAcquire(&_frozen) != FALSE; }
+    bool IsSpilled() const noexcept { return _spillFile != nullptr; }
+
 protected:
-    // storage for glyph data and dbcs attributes
-    boost::container::small_vector<value_type, 120> _data;
+    // storage for glyph data and dbcs attributes, one of each per column.
+    // A glyph that's stored in _unicodeStorage leaves its wchar_t as it was.
+    boost::container::small_vector<wchar_t, InlineCapacity, std::pmr::polymorphic_allocator<wchar_t>> _chars;
+    boost::container::small_vector<DbcsAttribute, InlineCapacity, std::pmr::polymorphic_allocator<DbcsAttribute>> _dbcsAttrs;
+
+    // While a row is frozen, _chars and _dbcsAttrs are empty and its contents live in _frozenData
+    // with any trailing blank cells trimmed off. _frozenWidth remembers how wide
+    // the row has to be when it is thawed again.
+    // _frozen is a LONG, because readers that share the buffer's lock may
+    // race to thaw the same row. See CharRow::Thaw.
+    std::vector<value_type> _frozenData;
+    size_t _frozenWidth{ 0 };
+    LONG _frozen{ FALSE };
+
+    // A frozen row may additionally have its _frozenData moved out into a
+    // RowStore slot (usually a RowSpillFile), in which case it's read back from there when thawed.
+    RowStore* _spillFile{ nullptr };
+    size_t _spillSlot{ 0 };
+
+    // storage location for the glyphs of this row that can't fit into a single cell
+    UnicodeStorage _unicodeStorage;
 
     // ROW that this CharRow belongs to
     ROW* _pParent;
 };
 
 template<typename InputIt1, typename InputIt2>
-void OverwriteColumns(InputIt1 startChars, InputIt1 endChars, InputIt2 startAttrs, CharRow::iterator outIt)
+void OverwriteColumns(InputIt1 startChars, InputIt1 endChars, InputIt2 startAttrs, CharRow& charRow)
 {
-    std::transform(startChars,
-                   endChars,
-                   startAttrs,
-                   outIt,
-                   [](const wchar_t wch, const DbcsAttribute attr) {
-                       return CharRow::value_type{ wch, attr };
-                   });
+    size_t column = 0;
+    for (auto it = startChars; it != endChars; ++it, ++startAttrs, ++column)
+    {
+        const wchar_t wch = *it;
+        charRow.GlyphAt(column) = { &wch, 1 };
+        charRow.DbcsAttrAt(column) = *startAttrs;
+    }
 }
@@ -53,8 +53,10 @@ private:
     // the index of the cell in the parent char row
     const size_t _index;
 
-    CharRowCell& _cellData();
-    const CharRowCell& _cellData() const;
+    wchar_t& _char();
+    const wchar_t& _char() const;
+    DbcsAttribute& _dbcsAttr();
+    const DbcsAttribute& _dbcsAttr() const;
 
     std::wstring_view _glyphData() const;
 };
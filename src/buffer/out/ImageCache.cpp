@@ -0,0 +1,95 @@
+// Copyright (c) Microsoft Corporation.
+// Licensed under the MIT license.
+
+#include "precomp.h"
+
+#include "ImageCache.hpp"
+
+// Routine Description:
+// - Constructs an empty cache.
+// Arguments:
+// - memoryLimit - the number of bytes the cached images may use in total
+// Return Value:
+// - constructed object
+ImageCache::ImageCache(const size_t memoryLimit) noexcept :
+    _memoryLimit{ memoryLimit }
+{
+}
+
+// Routine Description:
+// - Takes ownership of the given image and assigns it an id. Other images
+//   may be evicted to make room for it, but never the one that was just added.
+// Arguments:
+// - image - the decoded image
+// Return Value:
+// - The id that rows can use to refer to the image.
+uint64_t ImageCache::Add(InlineImage&& image)
+{
+    image.id = _nextId++;
+    const auto id = image.id;
+    const auto usage = _MemoryUsageOf(image);
+
+    _images.emplace_front(std::make_shared<const InlineImage>(std::move(image)));
+    try
+    {
+        _index.emplace(id, _images.begin());
+    }
+    catch (...)
+    {
+        _images.pop_front();
+        throw;
+    }
+    _memoryUsage += usage;
+
+    _EvictToLimit();
+    return id;
+}
+
+// Routine Description:
+// - Looks up an image and marks it as the most recently used one.
+// Arguments:
+// - id - the id returned by Add
+// Return Value:
+// - The image, or nullptr if there's none with the given id (anymore).
+//   The returned reference keeps the image alive even if it's evicted.
+std::shared_ptr<const InlineImage> ImageCache::Get(const uint64_t id) const noexcept
+{
+    const auto it = _index.find(id);
+    if (it == _index.end())
+    {
+        return nullptr;
+    }
+
+    _images.splice(_images.begin(), _images, it->second);
+    return *it->second;
+}
+
+// Routine Description:
+// - Drops all images.
+// Arguments:
+// - <none>
+// Return Value:
+// - <none>
+void ImageCache::Clear() noexcept
+{
+    _index.clear();
+    _images.clear();
+    _memoryUsage = 0;
+}
+
+size_t ImageCache::_MemoryUsageOf(const InlineImage& image) noexcept
+{
+    return image.pixels.size() * sizeof(uint32_t);
+}
+
+void ImageCache::_EvictToLimit() noexcept
+{
+    // The most recently added image always stays, even if it's larger than the limit on its own.
+    while (_memoryUsage > _memoryLimit && _images.size() > 1)
+    {
+        const auto& image = _images.back();
+        _memoryUsage -= _MemoryUsageOf(*image);
+        _index.erase(image->id);
+        _images.pop_back();
+    }
+}
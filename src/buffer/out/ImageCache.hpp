@@ -0,0 +1,79 @@
+/*++
+Copyright (c) Microsoft Corporation
+Licensed under the MIT license.
+
+Module Name:
+- ImageCache.hpp
+
+Abstract:
+- Holds the images that were decoded from inline graphics sequences (Sixel).
+- Rows don't own the images they display. They only refer to them by id,
+  which means that scrolling moves the references around together with the
+  rows, without touching the image data itself.
+- The cache is bounded by the memory its images use. When it's exceeded,
+  the least recently used images are dropped, and rows that still refer
+  to them simply stop displaying anything.
+--*/
+
+#pragma once
+
+// An image decoded from an inline graphics sequence.
+struct InlineImage
+{
+    // Assigned by the ImageCache. 0 is never a valid id.
+    uint64_t id = 0;
+
+    // Dimensions of the image in pixels.
+    size_t width = 0;
+    size_t height = 0;
+
+    // The size of a character cell in image pixels. This determines how
+    // many cells the image spans, regardless of the actual font size.
+    size_t cellWidth = 0;
+    size_t cellHeight = 0;
+
+    // Premultiplied 0xAARRGGBB pixels, one row after another.
+    std::vector<uint32_t> pixels;
+
+    size_t CellColumns() const noexcept { return (width + cellWidth - 1) / cellWidth; }
+    size_t CellRows() const noexcept { return (height + cellHeight - 1) / cellHeight; }
+};
+
+// The part of an image that's displayed in a particular row.
+struct ImageSlice
+{
+    // The id of the image, or 0, if the row doesn't display one.
+    uint64_t imageId = 0;
+    // The buffer column the left edge of the image is in.
+    SHORT column = 0;
+    // The row of image cells, counting from the top of the image.
+    SHORT imageRow = 0;
+};
+
+class ImageCache final
+{
+public:
+    static constexpr size_t DefaultMemoryLimit = 64 * 1024 * 1024;
+
+    explicit ImageCache(const size_t memoryLimit = DefaultMemoryLimit) noexcept;
+
+    uint64_t Add(InlineImage&& image);
+    std::shared_ptr<const InlineImage> Get(const uint64_t id) const noexcept;
+    void Clear() noexcept;
+
+    size_t GetMemoryUsage() const noexcept { return _memoryUsage; }
+
+private:
+    using ImageList = std::list<std::shared_ptr<const InlineImage>>;
+
+    static size_t _MemoryUsageOf(const InlineImage& image) noexcept;
+    void _EvictToLimit() noexcept;
+
+    // The front of the list is the most recently used image. The list is
+    // mutable so that looking up an image can move it to the front.
+    mutable ImageList _images;
+    std::unordered_map<uint64_t, ImageList::iterator> _index;
+    size_t _memoryLimit;
+    size_t _memoryUsage = 0;
+    uint64_t _nextId = 1;
+};
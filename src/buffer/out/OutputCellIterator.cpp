@@ -8,8 +8,12 @@
 #include "../../types/inc/convert.hpp"
 #include "../../types/inc/Utf16Parser.hpp"
 #include "../../types/inc/GlyphWidth.hpp"
+#include "../../types/inc/GraphemeSegmenter.hpp"
+#include "../../types/inc/AllocationAccounting.hpp"
 #include "../../inc/conattrs.hpp"
 
+using namespace Microsoft::Console::Types;
+
 static constexpr TextAttribute InvalidTextAttribute{ INVALID_COLOR, INVALID_COLOR };
 
 // Routine Description:
@@ -83,8 +87,9 @@ OutputCellIterator::OutputCellIterator(const CHAR_INFO& charInfo, const size_t f
 // - utf16Text - UTF-16 text range
 OutputCellIterator::OutputCellIterator(const std::wstring_view utf16Text) :
     _mode(Mode::LooseTextOnly),
-    _currentView(s_GenerateView(utf16Text)),
     _run(utf16Text),
+    _widths(s_ClassifyWidths(utf16Text)),
+    _currentView(s_GenerateView(utf16Text, 0, _widths.get())),
     _attr(InvalidTextAttribute),
     _pos(0),
     _distance(0),
@@ -99,8 +104,9 @@ OutputCellIterator::OutputCellIterator(const std::wstring_view utf16Text) :
 // - attribute - Color to apply over the entire range
 OutputCellIterator::OutputCellIterator(const std::wstring_view utf16Text, const TextAttribute attribute) :
     _mode(Mode::Loose),
-    _currentView(s_GenerateView(utf16Text, attribute)),
     _run(utf16Text),
+    _widths(s_ClassifyWidths(utf16Text)),
+    _currentView(s_GenerateView(utf16Text, 0, _widths.get(), attribute)),
     _attr(attribute),
     _distance(0),
     _pos(0),
@@ -217,7 +223,7 @@ OutputCellIterator& OutputCellIterator::operator++()
             _pos += _currentView.Chars().size();
             if (operator bool())
             {
-                _currentView = s_GenerateView(std::get<std::wstring_view>(_run).substr(_pos), _attr);
+                _currentView = s_GenerateView(std::get<std::wstring_view>(_run), _pos, _widths.get(), _attr);
             }
         }
         break;
@@ -231,7 +237,7 @@ OutputCellIterator& OutputCellIterator::operator++()
             _pos += _currentView.Chars().size();
             if (operator bool())
             {
-                _currentView = s_GenerateView(std::get<std::wstring_view>(_run).substr(_pos));
+                _currentView = s_GenerateView(std::get<std::wstring_view>(_run), _pos, _widths.get());
             }
         }
         break;
@@ -307,6 +313,94 @@ OutputCellIterator OutputCellIterator::operator++(int)
     return temp;
 }
 
+// Routine Description:
+// - Counts how many cells, starting at the current view, hold narrow glyphs that
+//   fit into a single wchar_t each and share the current view's attributes.
+// - Those cells can be written all at once instead of walking them one by one.
+//   For text they're the consecutive wchar_ts of the run starting at the
+//   current view's text. For fills they're the current view repeated.
+// Arguments:
+// - maxCells - The most cells the caller can take
+// Return Value:
+// - The number of cells that can be written in bulk, up to maxCells. 0 if there are none.
+size_t OutputCellIterator::GetNarrowRunLength(const size_t maxCells) const noexcept
+{
+    switch (_mode)
+    {
+    case Mode::Loose:
+    case Mode::LooseTextOnly:
+    {
+        // Text runs are only classified if they contain more than printable ASCII.
+        // Without widths, every remaining wchar_t is a narrow glyph of its own.
+        const auto text = std::get_if<std::wstring_view>(&_run);
+        if (!_widths && text && _pos < text->size())
+        {
+            return std::min(text->size() - _pos, maxCells);
+        }
+        return 0;
+    }
+    case Mode::Fill:
+    {
+        const auto attrOnly = _currentView.TextAttrBehavior() == TextAttributeBehavior::StoredOnly;
+        if (_currentView.DbcsAttr().IsSingle() && (attrOnly || _currentView.Chars().size() == 1))
+        {
+            if (_fillLimit > 0)
+            {
+                return _pos < _fillLimit ? std::min(_fillLimit - _pos, maxCells) : 0;
+            }
+            return maxCells;
+        }
+        return 0;
+    }
+    default:
+        return 0;
+    }
+}
+
+// Routine Description:
+// - Specifies whether this iterator repeats the same view over and over.
+// Return Value:
+// - True if this is a fill iterator.
+bool OutputCellIterator::IsFill() const noexcept
+{
+    return _mode == Mode::Fill;
+}
+
+// Routine Description:
+// - Advances the iterator over cells that were written in bulk.
+// Arguments:
+// - cells - The number of cells to skip. Must not exceed GetNarrowRunLength.
+void OutputCellIterator::AdvanceNarrowRun(const size_t cells)
+{
+    _distance += cells;
+
+    switch (_mode)
+    {
+    case Mode::Loose:
+    case Mode::LooseTextOnly:
+    {
+        _pos += cells;
+        if (operator bool())
+        {
+            const auto& text = std::get<std::wstring_view>(_run);
+            _currentView = _mode == Mode::Loose ? s_GenerateView(text, _pos, _widths.get(), _attr) :
+                                                  s_GenerateView(text, _pos, _widths.get());
+        }
+        break;
+    }
+    case Mode::Fill:
+    {
+        if (_fillLimit > 0)
+        {
+            _pos += cells;
+        }
+        break;
+    }
+    default:
+        FAIL_FAST_HR(E_NOTIMPL);
+    }
+}
+
 // Routine Description:
 // - Reference the view to fully-formed output cell data representing the underlying data source.
 // Return Value:
@@ -353,18 +447,43 @@ bool OutputCellIterator::_TryMoveTrailing() noexcept
     }
 }
 
+// Routine Description:
+// - Classifies the widths of all the glyphs in a text run up front, so that
+//   they don't have to be looked up one at a time as the iterator advances.
+// Arguments:
+// - utf16Text - UTF-16 text range
+// - A new iterator is constructed for every row segment that's written, so
+//   the widths and the shared_ptr holding them come from a pool.
+// Return Value:
+// - The width of each wchar_t in the run, or nullptr if all glyphs are narrow.
+std::shared_ptr<const std::pmr::vector<CodepointWidth>> OutputCellIterator::s_ClassifyWidths(const std::wstring_view utf16Text)
+{
+    static std::pmr::synchronized_pool_resource pool{ AllocationAccounting::GetResource(AllocationAccounting::Subsystem::Buffer) };
+
+    std::pmr::vector<CodepointWidth> widths{ &pool };
+    if (ClassifyGlyphWidths(utf16Text, widths).empty())
+    {
+        return nullptr;
+    }
+    return std::allocate_shared<std::pmr::vector<CodepointWidth>>(std::pmr::polymorphic_allocator<CodepointWidth>{ &pool }, std::move(widths));
+}
+
 // Routine Description:
 // - Static function to create a view.
 // - It's pulled out statically so it can be used during construction with just the given
 //   variables (so OutputCellView doesn't need an empty default constructor)
 // - This will infer the width of the glyph and specify that the attributes shouldn't be changed.
 // Arguments:
-// - view - View representing characters corresponding to a single glyph
+// - text - The entire text run
+// - pos - Position of the glyph within the text run
+// - widths - Widths of the text run, as classified by s_ClassifyWidths
 // Return Value:
 // - Object representing the view into this cell
-OutputCellView OutputCellIterator::s_GenerateView(const std::wstring_view view)
+OutputCellView OutputCellIterator::s_GenerateView(const std::wstring_view text,
+                                                  const size_t pos,
+                                                  const std::pmr::vector<CodepointWidth>* const widths)
 {
-    return s_GenerateView(view, InvalidTextAttribute, TextAttributeBehavior::Current);
+    return s_GenerateView(text, pos, widths, InvalidTextAttribute, TextAttributeBehavior::Current);
 }
 
 // Routine Description:
@@ -373,14 +492,18 @@ OutputCellView OutputCellIterator::s_GenerateView(const std::wstring_view view)
 //   variables (so OutputCellView doesn't need an empty default constructor)
 // - This will infer the width of the glyph and apply the appropriate attributes to the view.
 // Arguments:
-// - view - View representing characters corresponding to a single glyph
+// - text - The entire text run
+// - pos - Position of the glyph within the text run
+// - widths - Widths of the text run, as classified by s_ClassifyWidths
 // - attr - Color attributes to apply to the text
 // Return Value:
 // - Object representing the view into this cell
-OutputCellView OutputCellIterator::s_GenerateView(const std::wstring_view view,
+OutputCellView OutputCellIterator::s_GenerateView(const std::wstring_view text,
+                                                  const size_t pos,
+                                                  const std::pmr::vector<CodepointWidth>* const widths,
                                                   const TextAttribute attr)
 {
-    return s_GenerateView(view, attr, TextAttributeBehavior::Stored);
+    return s_GenerateView(text, pos, widths, attr, TextAttributeBehavior::Stored);
 }
 
 // Routine Description:
@@ -388,19 +511,46 @@ OutputCellView OutputCellIterator::s_GenerateView(const std::wstring_view view,
 // - It's pulled out statically so it can be used during construction with just the given
 //   variables (so OutputCellView doesn't need an empty default constructor)
 // - This will infer the width of the glyph and apply the appropriate attributes to the view.
+// - The glyph is the whole grapheme cluster starting at the given position (a base
+//   character and any combining marks, a flag, an emoji ZWJ sequence, ...), so that
+//   it ends up in a single cell. The cluster is as wide as its first codepoint.
 // Arguments:
-// - view - View representing characters corresponding to a single glyph
+// - text - The entire text run
+// - pos - Position of the glyph within the text run
+// - widths - Widths of the text run, as classified by s_ClassifyWidths
 // - attr - Color attributes to apply to the text
 // - behavior - Behavior of the given text attribute (used when writing)
 // Return Value:
 // - Object representing the view into this cell
-OutputCellView OutputCellIterator::s_GenerateView(const std::wstring_view view,
+OutputCellView OutputCellIterator::s_GenerateView(const std::wstring_view text,
+                                                  const size_t pos,
+                                                  const std::pmr::vector<CodepointWidth>* const widths,
                                                   const TextAttribute attr,
                                                   const TextAttributeBehavior behavior)
 {
-    const auto glyph = Utf16Parser::ParseNext(view);
+    auto glyph = Utf16Parser::ParseNext(text.substr(pos));
+
+    // The classified widths only apply if the glyph starts right at the given
+    // position. Otherwise ParseNext skipped over unpaired surrogates (or there
+    // was no text at all) and we have to ask about the glyph itself.
+    auto isWide = false;
+    if (glyph.data() == text.data() + pos)
+    {
+        // Without widths the run is printable ASCII only, where every wchar_t is a cluster of its own.
+        if (widths)
+        {
+            const auto remaining = text.substr(pos);
+            glyph = remaining.substr(0, GraphemeSegmenter::GetClusterLength(remaining));
+        }
+        isWide = widths && til::at(*widths, pos) == CodepointWidth::Wide;
+    }
+    else
+    {
+        isWide = IsGlyphFullWidth(glyph);
+    }
+
     DbcsAttribute dbcsAttr;
-    if (IsGlyphFullWidth(glyph))
+    if (isWide)
     {
         dbcsAttr.SetLeading();
     }
@@ -24,6 +24,8 @@ Revision History:
 #include "OutputCell.hpp"
 #include "OutputCellView.hpp"
 
+#include "../../types/inc/convert.hpp"
+
 class OutputCellIterator final
 {
 public:
@@ -55,6 +57,10 @@ public:
     OutputCellIterator& operator++();
     OutputCellIterator operator++(int);
 
+    size_t GetNarrowRunLength(const size_t maxCells) const noexcept;
+    bool IsFill() const noexcept;
+    void AdvanceNarrowRun(const size_t cells);
+
     const OutputCellView& operator*() const noexcept;
     const OutputCellView* operator->() const noexcept;
 
@@ -100,12 +106,20 @@ private:
 
     bool _TryMoveTrailing() noexcept;
 
-    static OutputCellView s_GenerateView(const std::wstring_view view);
+    static std::shared_ptr<const std::pmr::vector<CodepointWidth>> s_ClassifyWidths(const std::wstring_view utf16Text);
 
-    static OutputCellView s_GenerateView(const std::wstring_view view,
+    static OutputCellView s_GenerateView(const std::wstring_view text,
+                                         const size_t pos,
+                                         const std::pmr::vector<CodepointWidth>* const widths);
+
+    static OutputCellView s_GenerateView(const std::wstring_view text,
+                                         const size_t pos,
+                                         const std::pmr::vector<CodepointWidth>* const widths,
                                          const TextAttribute attr);
 
-    static OutputCellView s_GenerateView(const std::wstring_view view,
+    static OutputCellView s_GenerateView(const std::wstring_view text,
+                                         const size_t pos,
+                                         const std::pmr::vector<CodepointWidth>* const widths,
                                          const TextAttribute attr,
                                          const TextAttributeBehavior behavior);
 
@@ -117,6 +131,12 @@ private:
 
     static OutputCellView s_GenerateView(const OutputCell& cell);
 
+    // The widths of the glyphs in a text run, classified all at once when the
+    // iterator is constructed. Copies of the iterator share them, since it's
+    // copied for every row that the run is written to. It's null if the run
+    // is nothing but narrow glyphs or if this isn't a text mode.
+    std::shared_ptr<const std::pmr::vector<CodepointWidth>> _widths;
+
     OutputCellView _currentView;
 
     size_t _pos;
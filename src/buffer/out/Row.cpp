@@ -7,6 +7,9 @@
 #include "textBuffer.hpp"
 #include "../types/inc/convert.hpp"
 
+// Starts at 1, so that 0 can be used to mean "no generation".
+std::atomic<uint64_t> ROW::s_nextGeneration{ 1 };
+
 // Routine Description:
 // - constructor
 // Arguments:
@@ -14,17 +17,19 @@
 // - rowWidth - the width of the row, cell elements
 // - fillAttribute - the default text attribute
 // - pParent - the text buffer that this row belongs to
+// - resource - where to allocate the cell storage of the row
 // Return Value:
 // - constructed object
-ROW::ROW(const SHORT rowId, const unsigned short rowWidth, const TextAttribute fillAttribute, TextBuffer* const pParent) :
+ROW::ROW(const size_t rowId, const unsigned short rowWidth, const TextAttribute fillAttribute, TextBuffer* const pParent, std::pmr::memory_resource* const resource) :
     _id{ rowId },
     _rowWidth{ rowWidth },
-    _charRow{ rowWidth, this },
-    _attrRow{ rowWidth, fillAttribute },
+    _charRow{ rowWidth, this, resource },
+    _attrRow{ rowWidth, fillAttribute, pParent->GetAttributeTable() },
     _lineRendition{ LineRendition::SingleWidth },
     _wrapForced{ false },
     _doubleBytePadded{ false },
-    _pParent{ pParent }
+    _pParent{ pParent },
+    _generation{ s_nextGeneration.fetch_add(1, std::memory_order_relaxed) }
 {
 }
 
@@ -36,7 +41,9 @@ ROW::ROW(const SHORT rowId, const unsigned short rowWidth, const TextAttribute f
 // - <none>
 bool ROW::Reset(const TextAttribute Attr)
 {
+    _Touch();
     _lineRendition = LineRendition::SingleWidth;
+    _imageSlice = {};
     _wrapForced = false;
     _doubleBytePadded = false;
     _charRow.Reset();
@@ -60,6 +67,7 @@ bool ROW::Reset(const TextAttribute Attr)
 // - S_OK if successful, otherwise relevant error
 [[nodiscard]] HRESULT ROW::Resize(const unsigned short width)
 {
+    _Touch();
     RETURN_IF_FAILED(_charRow.Resize(width));
     try
     {
@@ -80,18 +88,39 @@ bool ROW::Reset(const TextAttribute Attr)
 // - <none>
 void ROW::ClearColumn(const size_t column)
 {
+    _Touch();
+    _charRow.Thaw();
     THROW_HR_IF(E_INVALIDARG, column >= _charRow.size());
     _charRow.ClearCell(column);
 }
 
+// Routine Description:
+// - Finds the right edge of the text in the row, measuring it only if
+//   the row was modified since it was last measured.
+// Arguments:
+// - <none>
+// Return Value:
+// - One past the last non-space cell in the row.
+size_t ROW::MeasureRight() const
+{
+    auto right = ReadNoFence64(&_measuredRight);
+    if (right < 0)
+    {
+        right = gsl::narrow_cast<LONG64>(GetCharRow().MeasureRight());
+        WriteNoFence64(&_measuredRight, right);
+    }
+    return gsl::narrow_cast<size_t>(right);
+}
+
 UnicodeStorage& ROW::GetUnicodeStorage() noexcept
 {
-    return _pParent->GetUnicodeStorage();
+    _Touch();
+    return _charRow.GetUnicodeStorage();
 }
 
 const UnicodeStorage& ROW::GetUnicodeStorage() const noexcept
 {
-    return _pParent->GetUnicodeStorage();
+    return _charRow.GetUnicodeStorage();
 }
 
 // Routine Description:
@@ -105,6 +134,8 @@ const UnicodeStorage& ROW::GetUnicodeStorage() const noexcept
 // - iterator to first cell that was not written to this row.
 OutputCellIterator ROW::WriteCells(OutputCellIterator it, const size_t index, const std::optional<bool> wrap, std::optional<size_t> limitRight)
 {
+    _Touch();
+    _charRow.Thaw();
     THROW_HR_IF(E_INVALIDARG, index >= _charRow.size());
     THROW_HR_IF(E_INVALIDARG, limitRight.value_or(0) >= _charRow.size());
 
@@ -118,6 +149,47 @@ OutputCellIterator ROW::WriteCells(OutputCellIterator it, const size_t index, co
 
     while (it && currentIndex <= finalColumnInRow)
     {
+        // Runs of narrow text and fills don't have to be walked cell by cell.
+        // They're copied in bulk and take up a single attribute run.
+        if (const auto runLength = it.GetNarrowRunLength(finalColumnInRow - currentIndex + 1); runLength > 1)
+        {
+            if (it->TextAttrBehavior() != TextAttributeBehavior::Current)
+            {
+                if (currentColor == it->TextAttr())
+                {
+                    colorUses += gsl::narrow_cast<uint16_t>(runLength);
+                }
+                else
+                {
+                    _attrRow.Replace(colorStarts, currentIndex, currentColor);
+                    currentColor = it->TextAttr();
+                    colorUses = gsl::narrow_cast<uint16_t>(runLength);
+                    colorStarts = currentIndex;
+                }
+            }
+
+            if (it->TextAttrBehavior() != TextAttributeBehavior::StoredOnly)
+            {
+                if (it.IsFill())
+                {
+                    _charRow.FillNarrowGlyph(currentIndex, it->Chars().front(), runLength);
+                }
+                else
+                {
+                    _charRow.WriteNarrowGlyphs(currentIndex, { it->Chars().data(), runLength });
+                }
+
+                if (wrap.has_value() && currentIndex + runLength - 1 == finalColumnInRow)
+                {
+                    SetWrapForced(*wrap);
+                }
+            }
+
+            it.AdvanceNarrowRun(runLength);
+            currentIndex += gsl::narrow_cast<uint16_t>(runLength);
+            continue;
+        }
+
         // Fill the color if the behavior isn't set to keeping the current color.
         if (it->TextAttrBehavior() != TextAttributeBehavior::Current)
         {
@@ -196,3 +268,38 @@ OutputCellIterator ROW::WriteCells(OutputCellIterator it, const size_t index, co
 
     return it;
 }
+
+// Routine Description:
+// - writes legacy cells, like WriteConsoleOutputW receives them, to the row.
+//   Unlike WriteCells, this walks the cells once for their text and once for
+//   their attributes, which are merged into runs on the way.
+// Arguments:
+// - charInfos - the cells to write. They must fit into the row.
+// - index - column in row to start writing at
+// Return Value:
+// - <none>
+void ROW::WriteCharInfos(const gsl::span<const CHAR_INFO> charInfos, const size_t index)
+{
+    if (charInfos.empty())
+    {
+        return;
+    }
+
+    THROW_HR_IF(E_INVALIDARG, index >= _charRow.size() || charInfos.size() > _charRow.size() - index);
+
+    // A trailing byte in the first column or a leading byte in the last one
+    // is padded out by WriteCells, which shifts the rest of the cells over.
+    // That's rare enough to leave it to WriteCells.
+    const auto trailingInFirstColumn = index == 0 && WI_IsFlagSet(charInfos.front().Attributes, COMMON_LVB_TRAILING_BYTE);
+    const auto leadingInLastColumn = index + charInfos.size() == _charRow.size() && WI_IsFlagSet(charInfos.back().Attributes, COMMON_LVB_LEADING_BYTE);
+    if (trailingInFirstColumn || leadingInLastColumn)
+    {
+        WriteCells(OutputCellIterator{ charInfos }, index);
+        return;
+    }
+
+    _Touch();
+    _charRow.Thaw();
+    _charRow.WriteCharInfos(index, charInfos);
+    _attrRow.ReplaceLegacy(gsl::narrow_cast<uint16_t>(index), charInfos);
+}
@@ -25,6 +25,7 @@ Revision History:
 #include "OutputCell.hpp"
 #include "OutputCellIterator.hpp"
 #include "CharRow.hpp"
+#include "ImageCache.hpp"
 #include "UnicodeStorage.hpp"
 
 class TextBuffer;
@@ -32,7 +33,7 @@ class TextBuffer;
 class ROW final
 {
 public:
-    ROW(const SHORT rowId, const unsigned short rowWidth, const TextAttribute fillAttribute, TextBuffer* const pParent);
+    ROW(const size_t rowId, const unsigned short rowWidth, const TextAttribute fillAttribute, TextBuffer* const pParent, std::pmr::memory_resource* const resource = til::pmr::get_default_resource());
 
     size_t size() const noexcept { return _rowWidth; }
 
@@ -42,28 +43,92 @@ public:
     void SetDoubleBytePadded(const bool doubleBytePadded) noexcept { _doubleBytePadded = doubleBytePadded; }
     bool WasDoubleBytePadded() const noexcept { return _doubleBytePadded; }
 
-    const CharRow& GetCharRow() const noexcept { return _charRow; }
-    CharRow& GetCharRow() noexcept { return _charRow; }
+    const CharRow& GetCharRow() const noexcept
+    {
+        _charRow.Thaw();
+        return _charRow;
+    }
+    CharRow& GetCharRow() noexcept
+    {
+        _Touch();
+        _charRow.Thaw();
+        return _charRow;
+    }
+
+    // The right edge of the text, see CharRow::MeasureRight(). It's remembered until the row
+    // is modified, and frozen rows keep it, so that measuring them doesn't have to thaw them.
+    size_t MeasureRight() const;
+
+    // Frozen rows keep only a compact copy of their text. They're thawed
+    // back into a full width row as soon as anyone asks for their CharRow.
+    void Freeze()
+    {
+        if (!IsFrozen())
+        {
+            (void)MeasureRight();
+            _charRow.Freeze();
+        }
+    }
+    bool IsFrozen() const noexcept { return _charRow.IsFrozen(); }
+
+    // Spilled rows are frozen rows that have moved their text out into a file.
+    void Spill(RowSpillFile& spillFile)
+    {
+        Freeze();
+        _charRow.Spill(spillFile);
+    }
+    bool IsSpilled() const noexcept { return _charRow.IsSpilled(); }
+
+    // Restored rows can point at their text in a RowStore without reading it until they're thawed.
+    void FreezeInto(RowStore& store, const size_t slot) noexcept
+    {
+        _Touch();
+        _charRow.FreezeInto(store, slot);
+    }
+    // The cells up to the last non-blank one, without thawing a frozen row.
+    void CopyCompactCells(std::vector<CharRowCell>& cells) const { _charRow.CopyCompactCells(cells); }
 
     const ATTR_ROW& GetAttrRow() const noexcept { return _attrRow; }
-    ATTR_ROW& GetAttrRow() noexcept { return _attrRow; }
+    ATTR_ROW& GetAttrRow() noexcept
+    {
+        _Touch();
+        return _attrRow;
+    }
 
     LineRendition GetLineRendition() const noexcept { return _lineRendition; }
     void SetLineRendition(const LineRendition lineRendition) noexcept { _lineRendition = lineRendition; }
 
-    SHORT GetId() const noexcept { return _id; }
-    void SetId(const SHORT id) noexcept { _id = id; }
+    // The part of an inline image displayed in this row, if any. The image itself lives in the TextBuffer's ImageCache.
+    const ImageSlice& GetImageSlice() const noexcept { return _imageSlice; }
+    void SetImageSlice(const ImageSlice& imageSlice) noexcept
+    {
+        _Touch();
+        _imageSlice = imageSlice;
+    }
+
+    // Every time the contents of a row may have changed, it's given a new generation.
+    // Generations are unique across all rows, so two rows with the same generation hold the same contents.
+    uint64_t GetGeneration() const noexcept { return _generation; }
+
+    // The number of times the TextBuffer had been cleared as a whole when this row was last reset.
+    // Rows whose count is behind the buffer's are cleared when they're first accessed again.
+    uint64_t GetClearGeneration() const noexcept { return gsl::narrow_cast<uint64_t>(ReadAcquire64(&_clearGeneration)); }
+    void SetClearGeneration(const uint64_t clearGeneration) noexcept { WriteRelease64(&_clearGeneration, gsl::narrow_cast<LONG64>(clearGeneration)); }
+
+    size_t GetId() const noexcept { return _id; }
+    void SetId(const size_t id) noexcept { _id = id; }
 
     bool Reset(const TextAttribute Attr);
     [[nodiscard]] HRESULT Resize(const unsigned short width);
 
     void ClearColumn(const size_t column);
-    std::wstring GetText() const { return _charRow.GetText(); }
+    std::wstring GetText() const { return GetCharRow().GetText(); }
 
     UnicodeStorage& GetUnicodeStorage() noexcept;
     const UnicodeStorage& GetUnicodeStorage() const noexcept;
 
     OutputCellIterator WriteCells(OutputCellIterator it, const size_t index, const std::optional<bool> wrap = std::nullopt, std::optional<size_t> limitRight = std::nullopt);
+    void WriteCharInfos(const gsl::span<const CHAR_INFO> charInfos, const size_t index);
 
 #ifdef UNIT_TESTING
     friend constexpr bool operator==(const ROW& a, const ROW& b) noexcept;
@@ -71,16 +136,32 @@ public:
 #endif
 
 private:
-    CharRow _charRow;
+    void _Touch() noexcept
+    {
+        _generation = s_nextGeneration.fetch_add(1, std::memory_order_relaxed);
+        _measuredRight = -1;
+    }
+
+    static std::atomic<uint64_t> s_nextGeneration;
+
+    // mutable so that const accessors can thaw a frozen row
+    mutable CharRow _charRow;
     ATTR_ROW _attrRow;
     LineRendition _lineRendition;
-    SHORT _id;
+    ImageSlice _imageSlice;
+    size_t _id;
     unsigned short _rowWidth;
     // Occurs when the user runs out of text in a given row and we're forced to wrap the cursor to the next line
     bool _wrapForced;
     // Occurs when the user runs out of text to support a double byte character and we're forced to the next line
     bool _doubleBytePadded;
     TextBuffer* _pParent; // non ownership pointer
+    uint64_t _generation;
+    // The result of MeasureRight(), or -1 if it has to be measured again. It's a LONG64,
+    // because readers that share the buffer's lock may race to fill it in.
+    mutable LONG64 _measuredRight{ -1 };
+    // See GetClearGeneration(). It's a LONG64 for the same reason as _measuredRight.
+    LONG64 _clearGeneration{ 0 };
 };
 
 #ifdef UNIT_TESTING
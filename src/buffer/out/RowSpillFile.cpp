@@ -0,0 +1,111 @@
+// Copyright (c) Microsoft Corporation.
+// Licensed under the MIT license.
+
+#include "precomp.h"
+
+#include "RowSpillFile.hpp"
+
+// Each slot starts with the number of cells stored in it, followed by the cells.
+using SlotLength = uint32_t;
+
+// Routine Description:
+// - Creates (and maps) a temporary file large enough to hold rowCount rows.
+// Arguments:
+// - rowWidth - the maximum number of cells a row stored in this file can have
+// - rowCount - the number of rows this file can hold
+// Return Value:
+// - constructed object
+// Note: will throw if the file can't be created
+RowSpillFile::RowSpillFile(const size_t rowWidth, const size_t rowCount) :
+    _rowWidth{ rowWidth },
+    _slotSize{ (sizeof(SlotLength) + rowWidth * sizeof(CharRowCell) + alignof(SlotLength) - 1) & ~(alignof(SlotLength) - 1) }
+{
+    THROW_HR_IF(E_INVALIDARG, rowWidth == 0 || rowCount == 0);
+
+    wchar_t tempPath[MAX_PATH + 1];
+    THROW_LAST_ERROR_IF(0 == GetTempPathW(ARRAYSIZE(tempPath), tempPath));
+
+    wchar_t tempFile[MAX_PATH + 1];
+    THROW_LAST_ERROR_IF(0 == GetTempFileNameW(tempPath, L"wts", 0, tempFile));
+
+    _file.reset(CreateFileW(tempFile,
+                            GENERIC_READ | GENERIC_WRITE,
+                            0,
+                            nullptr,
+                            CREATE_ALWAYS,
+                            FILE_ATTRIBUTE_TEMPORARY | FILE_FLAG_DELETE_ON_CLOSE,
+                            nullptr));
+    THROW_LAST_ERROR_IF(!_file);
+
+    ULARGE_INTEGER fileSize;
+    fileSize.QuadPart = _slotSize * rowCount;
+    _mapping.reset(CreateFileMappingW(_file.get(), nullptr, PAGE_READWRITE, fileSize.HighPart, fileSize.LowPart, nullptr));
+    THROW_LAST_ERROR_IF(!_mapping);
+
+    _view.reset(static_cast<std::byte*>(MapViewOfFile(_mapping.get(), FILE_MAP_READ | FILE_MAP_WRITE, 0, 0, 0)));
+    THROW_LAST_ERROR_IF(!_view);
+
+    // Hand out the slots from the start of the file first.
+    _freeSlots.reserve(rowCount);
+    for (auto slot = rowCount; slot > 0; --slot)
+    {
+        _freeSlots.push_back(slot - 1);
+    }
+}
+
+// Routine Description:
+// - Copies the given cells into a free slot.
+// Arguments:
+// - cells - the contents of the row
+// Return Value:
+// - The slot holding the cells, or nullopt if they didn't fit or the file is full.
+std::optional<size_t> RowSpillFile::Store(const gsl::span<const CharRowCell> cells) noexcept
+{
+    if (_freeSlots.empty() || gsl::narrow_cast<size_t>(cells.size()) > _rowWidth)
+    {
+        return std::nullopt;
+    }
+
+    const auto slot = _freeSlots.back();
+    _freeSlots.pop_back();
+
+    auto data = _GetSlot(slot);
+    const auto length = gsl::narrow_cast<SlotLength>(cells.size());
+    memcpy(data, &length, sizeof(length));
+    memcpy(data + sizeof(length), cells.data(), cells.size_bytes());
+    return slot;
+}
+
+// Routine Description:
+// - Reads the cells stored in the given slot. The slot stays in use.
+// Arguments:
+// - slot - a slot returned by Store
+// - cells - receives the contents of the row
+// Return Value:
+// - <none>
+void RowSpillFile::Load(const size_t slot, std::vector<CharRowCell>& cells) const
+{
+    const auto data = _GetSlot(slot);
+    SlotLength length;
+    memcpy(&length, data, sizeof(length));
+
+    cells.resize(length);
+    memcpy(cells.data(), data + sizeof(length), length * sizeof(CharRowCell));
+}
+
+// Routine Description:
+// - Marks the given slot as free, so that it can be reused by Store.
+// Arguments:
+// - slot - a slot returned by Store
+// Return Value:
+// - <none>
+void RowSpillFile::Release(const size_t slot) noexcept
+{
+    // _freeSlots was reserved for every slot, so this won't allocate.
+    _freeSlots.push_back(slot);
+}
+
+std::byte* RowSpillFile::_GetSlot(const size_t slot) const noexcept
+{
+    return _view.get() + slot * _slotSize;
+}
@@ -0,0 +1,48 @@
+/*++
+Copyright (c) Microsoft Corporation
+Licensed under the MIT license.
+
+Module Name:
+- RowSpillFile.hpp
+
+Abstract:
+- A memory-mapped temporary file that frozen rows can be moved into, so that
+  the contents of old scrollback don't have to stay resident in memory.
+- The file is split into fixed size slots, one row each. It's created with
+  FILE_FLAG_DELETE_ON_CLOSE, so it goes away together with the text buffer.
+--*/
+
+#pragma once
+
+#include "CharRowCell.hpp"
+
+// Somewhere outside of memory that the text of frozen rows can be read back from.
+// Each row is identified by a slot, whose meaning is up to the store.
+class RowStore
+{
+public:
+    virtual ~RowStore() = default;
+
+    virtual void Load(const size_t slot, std::vector<CharRowCell>& cells) const = 0;
+    virtual void Release(const size_t slot) noexcept = 0;
+};
+
+class RowSpillFile final : public RowStore
+{
+public:
+    RowSpillFile(const size_t rowWidth, const size_t rowCount);
+
+    std::optional<size_t> Store(const gsl::span<const CharRowCell> cells) noexcept;
+    void Load(const size_t slot, std::vector<CharRowCell>& cells) const override;
+    void Release(const size_t slot) noexcept override;
+
+private:
+    std::byte* _GetSlot(const size_t slot) const noexcept;
+
+    size_t _rowWidth;
+    size_t _slotSize;
+    wil::unique_hfile _file;
+    wil::unique_handle _mapping;
+    wil::unique_mapview_ptr<std::byte> _view;
+    std::vector<size_t> _freeSlots;
+};
@@ -0,0 +1,29 @@
+/*++
+Copyright (c) Microsoft Corporation
+Licensed under the MIT license.
+
+Module Name:
+- ScrollMark.hpp
+
+Abstract:
+- The marks that shells place around their prompts, the commands that are
+  entered and their output, with the FinalTerm (OSC 133) sequences.
+- A text buffer keeps them sorted by position, see TextBuffer::AddMark.
+--*/
+
+#pragma once
+
+enum class MarkCategory : uint8_t
+{
+    Prompt, // OSC 133;A - the prompt starts here.
+    Command, // OSC 133;B - the prompt ends, and the command line starts here.
+    Output, // OSC 133;C - the command was entered, and its output starts here.
+    CommandFinished, // OSC 133;D - the command finished here, maybe with an exit code.
+};
+
+struct ScrollMark
+{
+    til::point start;
+    MarkCategory category{ MarkCategory::Prompt };
+    std::optional<uint32_t> exitCode;
+};
@@ -153,6 +153,26 @@ uint16_t TextAttribute::GetHyperlinkId() const noexcept
     return _hyperlinkId;
 }
 
+// Routine Description:
+// - Hashes the same fields that operator== compares, for looking up
+//   attributes in hash tables like the TextAttributeTable.
+// Return Value:
+// - The hash of the attribute.
+size_t TextAttribute::Hash() const noexcept
+{
+    // The fields are combined one by one, because the padding
+    // at the end of the struct may contain anything.
+    static_assert(sizeof(TextColor) == sizeof(uint32_t));
+    uint32_t foreground;
+    uint32_t background;
+    memcpy(&foreground, &_foreground, sizeof(foreground));
+    memcpy(&background, &_background, sizeof(background));
+
+    const auto colors = uint64_t{ foreground } | (uint64_t{ background } << 32);
+    const auto flags = uint64_t{ _wAttrLegacy } | (uint64_t{ _hyperlinkId } << 16) | (uint64_t{ static_cast<uint8_t>(_extendedAttrs) } << 32);
+    return std::hash<uint64_t>{}(colors ^ (flags * 0x9E3779B97F4A7C15));
+}
+
 void TextAttribute::SetForeground(const TextColor foreground) noexcept
 {
     _foreground = foreground;
@@ -139,6 +139,8 @@ public:
 
     void SetStandardErase() noexcept;
 
+    size_t Hash() const noexcept;
+
     // This returns whether this attribute, if printed directly next to another attribute, for the space
     // character, would look identical to the other one.
     bool HasIdenticalVisualRepresentationForBlankSpace(const TextAttribute& other, const bool inverted = false) const noexcept
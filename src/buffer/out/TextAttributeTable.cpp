@@ -0,0 +1,172 @@
+// Copyright (c) Microsoft Corporation.
+// Licensed under the MIT license.
+
+#include "precomp.h"
+
+#include "TextAttributeTable.hpp"
+
+// Routine Description:
+// - Constructs a table that only holds the default attributes.
+// Arguments:
+// - <none>
+// Return Value:
+// - constructed object
+TextAttributeTable::TextAttributeTable()
+{
+    _attributes.emplace_back();
+    _ids.emplace(_attributes.front(), DefaultId);
+}
+
+// Routine Description:
+// - Sets the function that's used to find out which ids are still in use
+//   once the table is full. Without one, no id is ever reused.
+// Arguments:
+// - callback - marks the ids that are in use
+// Return Value:
+// - <none>
+void TextAttributeTable::SetMarkInUseCallback(MarkInUseCallback callback)
+{
+    _markInUse = std::move(callback);
+}
+
+// Routine Description:
+// - Returns the id of the given attribute, adding it to the table if necessary.
+// - If more attributes are in use than there are ids, the ones that don't
+//   fit in anymore fall back to the default attributes.
+// Arguments:
+// - attr - the attribute to look up
+// Return Value:
+// - The id by which the attribute can be retrieved with Get.
+TextAttributeTable::Id TextAttributeTable::Intern(const TextAttribute& attr)
+{
+    if (const auto it = _ids.find(attr); it != _ids.end())
+    {
+        return it->second;
+    }
+
+    if (_freeIds.empty() && _attributes.size() == MaxSize)
+    {
+        _CollectGarbage();
+        if (_freeIds.empty())
+        {
+            return DefaultId;
+        }
+    }
+
+    if (_freeIds.empty())
+    {
+        const auto id = gsl::narrow_cast<Id>(_attributes.size());
+        _attributes.emplace_back(attr);
+        try
+        {
+            _ids.emplace(attr, id);
+        }
+        catch (...)
+        {
+            _attributes.pop_back();
+            throw;
+        }
+        return id;
+    }
+
+    const auto id = _freeIds.back();
+    _ids.emplace(attr, id);
+    _freeIds.pop_back();
+    til::at(_attributes, id) = attr;
+    return id;
+}
+
+// Routine Description:
+// - Returns the id of the given attribute, without adding it to the table.
+// Arguments:
+// - attr - the attribute to look up
+// Return Value:
+// - The id of the attribute, or nullopt if it isn't in the table.
+std::optional<TextAttributeTable::Id> TextAttributeTable::Find(const TextAttribute& attr) const
+{
+    if (const auto it = _ids.find(attr); it != _ids.end())
+    {
+        return it->second;
+    }
+    return std::nullopt;
+}
+
+// Routine Description:
+// - Returns the number of attributes in the table.
+// Arguments:
+// - <none>
+// Return Value:
+// - The number of attributes that currently have an id.
+size_t TextAttributeTable::Size() const noexcept
+{
+    return _ids.size();
+}
+
+// Routine Description:
+// - Records that one more row refers to the given hyperlink.
+// Arguments:
+// - hyperlinkId - the id of the hyperlink
+// Return Value:
+// - <none>
+void TextAttributeTable::AddHyperlinkReference(const uint16_t hyperlinkId)
+{
+    ++_hyperlinkReferences[hyperlinkId];
+}
+
+// Routine Description:
+// - Records that one row less refers to the given hyperlink.
+// Arguments:
+// - hyperlinkId - the id of the hyperlink
+// Return Value:
+// - <none>
+void TextAttributeTable::ReleaseHyperlinkReference(const uint16_t hyperlinkId) noexcept
+{
+    const auto it = _hyperlinkReferences.find(hyperlinkId);
+    if (it != _hyperlinkReferences.end() && --it->second == 0)
+    {
+        _hyperlinkReferences.erase(it);
+    }
+}
+
+// Routine Description:
+// - Returns how many rows refer to the given hyperlink.
+// Arguments:
+// - hyperlinkId - the id of the hyperlink
+// Return Value:
+// - The number of rows with at least one cell that links to it.
+size_t TextAttributeTable::GetHyperlinkReferenceCount(const uint16_t hyperlinkId) const noexcept
+{
+    const auto it = _hyperlinkReferences.find(hyperlinkId);
+    return it != _hyperlinkReferences.end() ? it->second : 0;
+}
+
+// Routine Description:
+// - Returns whether any row refers to a hyperlink.
+// Arguments:
+// - <none>
+// Return Value:
+// - true if any row has at least one cell that links somewhere.
+bool TextAttributeTable::HasHyperlinkReferences() const noexcept
+{
+    return !_hyperlinkReferences.empty();
+}
+
+void TextAttributeTable::_CollectGarbage()
+{
+    if (!_markInUse)
+    {
+        return;
+    }
+
+    std::vector<bool> inUse(_attributes.size());
+    inUse[DefaultId] = true;
+    _markInUse(inUse);
+
+    for (size_t id = 0; id < _attributes.size(); id++)
+    {
+        if (!inUse[id] && _ids.erase(_attributes[id]) != 0)
+        {
+            _freeIds.emplace_back(gsl::narrow_cast<Id>(id));
+        }
+    }
+}
@@ -0,0 +1,74 @@
+/*++
+Copyright (c) Microsoft Corporation
+Licensed under the MIT license.
+
+Module Name:
+- TextAttributeTable.hpp
+
+Abstract:
+- Interns the text attributes used by the rows of a text buffer.
+- Rows only store the 16-bit ids of their attributes, which keeps their
+  runs small and turns comparing two attributes into comparing integers.
+  Since every distinct attribute is stored only once, equal ids always mean
+  equal attributes and vice versa.
+- The table is never larger than its ids can address. When it's full, it
+  asks its owner which ids are still in use and reuses the other ones.
+- It also counts how many rows refer to each hyperlink id, so that the
+  buffer can tell when a hyperlink is unused without scanning every row.
+--*/
+
+#pragma once
+
+#include "TextAttribute.hpp"
+
+class TextAttributeTable final
+{
+public:
+    using Id = uint16_t;
+
+    // Marks the ids that are still in use by setting their entry to true.
+    using MarkInUseCallback = std::function<void(std::vector<bool>& inUse)>;
+
+    static constexpr size_t MaxSize = size_t{ std::numeric_limits<Id>::max() } + 1;
+
+    // The default attributes always have this id and are never evicted.
+    static constexpr Id DefaultId = 0;
+
+    TextAttributeTable();
+
+    TextAttributeTable(const TextAttributeTable&) = delete;
+    TextAttributeTable& operator=(const TextAttributeTable&) = delete;
+
+    void SetMarkInUseCallback(MarkInUseCallback callback);
+
+    Id Intern(const TextAttribute& attr);
+    std::optional<Id> Find(const TextAttribute& attr) const;
+    const TextAttribute& Get(const Id id) const noexcept
+    {
+        return til::at(_attributes, id);
+    }
+
+    size_t Size() const noexcept;
+
+    void AddHyperlinkReference(const uint16_t hyperlinkId);
+    void ReleaseHyperlinkReference(const uint16_t hyperlinkId) noexcept;
+    size_t GetHyperlinkReferenceCount(const uint16_t hyperlinkId) const noexcept;
+    bool HasHyperlinkReferences() const noexcept;
+
+private:
+    struct Hash
+    {
+        size_t operator()(const TextAttribute& attr) const noexcept
+        {
+            return attr.Hash();
+        }
+    };
+
+    void _CollectGarbage();
+
+    std::vector<TextAttribute> _attributes;
+    std::unordered_map<TextAttribute, Id, Hash> _ids;
+    std::vector<Id> _freeIds;
+    MarkInUseCallback _markInUse;
+    std::unordered_map<uint16_t, size_t> _hyperlinkReferences;
+};
@@ -0,0 +1,487 @@
+// Copyright (c) Microsoft Corporation.
+// Licensed under the MIT license.
+
+#include "precomp.h"
+
+#include "TextBufferSnapshot.hpp"
+#include "textBuffer.hpp"
+
+// "WTSB" in the first bytes of the file.
+static constexpr uint32_t s_magic = 0x42535457;
+static constexpr uint16_t s_version = 1;
+
+static constexpr uint8_t s_wrapForcedFlag = 0x01;
+static constexpr uint8_t s_doubleBytePaddedFlag = 0x02;
+
+static constexpr HRESULT s_invalidData = HRESULT_FROM_WIN32(ERROR_INVALID_DATA);
+
+// Everything in the file after the header is aligned to 4 bytes.
+static constexpr uint64_t s_Align(const uint64_t size) noexcept
+{
+    return (size + 3) & ~uint64_t{ 3 };
+}
+
+namespace
+{
+    // Collects small writes, so that writing a row doesn't take a system call
+    // for each of its parts, and keeps track of the offset in the file.
+    class FileWriter
+    {
+    public:
+        explicit FileWriter(const HANDLE file) :
+            _file{ file }
+        {
+            _buffer.reserve(BufferSize);
+        }
+
+        void Write(const void* const data, const size_t size)
+        {
+            const auto bytes = static_cast<const std::byte*>(data);
+            if (_buffer.size() + size > BufferSize)
+            {
+                Flush();
+            }
+
+            if (size >= BufferSize)
+            {
+                _WriteFile(bytes, size);
+            }
+            else
+            {
+                _buffer.insert(_buffer.end(), bytes, bytes + size);
+            }
+            _offset += size;
+        }
+
+        template<typename T>
+        void Write(const T& value)
+        {
+            static_assert(std::is_trivially_copyable_v<T>);
+            Write(&value, sizeof(value));
+        }
+
+        void Pad()
+        {
+            static constexpr std::array<std::byte, 4> zeros{};
+            Write(zeros.data(), gsl::narrow_cast<size_t>(s_Align(_offset) - _offset));
+        }
+
+        void Flush()
+        {
+            if (!_buffer.empty())
+            {
+                _WriteFile(_buffer.data(), _buffer.size());
+                _buffer.clear();
+            }
+        }
+
+        uint64_t Offset() const noexcept
+        {
+            return _offset;
+        }
+
+    private:
+        static constexpr size_t BufferSize = 64 * 1024;
+
+        void _WriteFile(const std::byte* data, size_t size)
+        {
+            while (size != 0)
+            {
+                const auto chunk = gsl::narrow_cast<DWORD>(std::min<size_t>(size, 1 << 30));
+                DWORD written = 0;
+                THROW_IF_WIN32_BOOL_FALSE(WriteFile(_file, data, chunk, &written, nullptr));
+                data += written;
+                size -= written;
+            }
+        }
+
+        HANDLE _file;
+        std::vector<std::byte> _buffer;
+        uint64_t _offset = 0;
+    };
+}
+
+// Routine Description:
+// - Writes a snapshot of the given buffer into a file, one row at a time.
+//   Frozen and spilled rows are written without thawing them.
+// - Only the rows' contents are written. The images displayed in the buffer
+//   and the cursor aren't part of the snapshot.
+// Arguments:
+// - buffer - the buffer to write. It mustn't change while it's being written.
+// - file - an open file with write access. It's overwritten from the start.
+// Return Value:
+// - <none>
+// Note: will throw if the file can't be written
+void TextBufferSnapshot::Write(const TextBuffer& buffer, const HANDLE file)
+{
+    static_assert(std::is_trivially_copyable_v<TextAttribute>);
+    static_assert(std::is_trivially_copyable_v<CharRowCell>);
+
+    THROW_IF_WIN32_BOOL_FALSE(SetFilePointerEx(file, {}, nullptr, FILE_BEGIN));
+
+    FileWriter writer{ file };
+
+    // The header is rewritten with all of the offsets in it once everything else is written.
+    Header header{};
+    writer.Write(header);
+    writer.Pad();
+
+    const auto rowCount = gsl::narrow_cast<size_t>(buffer.TotalRowCount());
+    header.textOffset = writer.Offset();
+
+    std::vector<Row> rows;
+    rows.reserve(rowCount);
+    std::vector<Run> runs;
+    std::vector<Run> rowRuns;
+    std::vector<TextAttribute> attributes;
+    std::unordered_map<TextAttributeTable::Id, uint32_t> attributeIndices;
+    std::vector<CharRowCell> cells;
+
+    for (size_t i = 0; i < rowCount; ++i)
+    {
+        const auto& row = buffer.GetRowByOffset(i);
+
+        Row record{};
+        record.textOffset = writer.Offset() - header.textOffset;
+        record.lineRendition = static_cast<uint8_t>(row.GetLineRendition());
+        record.flags = (row.WasWrapForced() ? s_wrapForcedFlag : 0) | (row.WasDoubleBytePadded() ? s_doubleBytePaddedFlag : 0);
+
+        row.CopyCompactCells(cells);
+        record.cellCount = gsl::narrow<uint16_t>(cells.size());
+        writer.Write(cells.data(), cells.size() * sizeof(CharRowCell));
+        writer.Pad();
+
+        const auto& storage = row.GetUnicodeStorage();
+        for (size_t column = 0; column < cells.size(); ++column)
+        {
+            if (til::at(cells, column).DbcsAttr().IsGlyphStored())
+            {
+                const auto& glyph = storage.GetText(gsl::narrow_cast<UnicodeStorage::key_type>(column));
+                writer.Write(Glyph{ gsl::narrow_cast<uint16_t>(column), gsl::narrow<uint16_t>(glyph.size()) });
+                writer.Write(glyph.data(), glyph.size() * sizeof(wchar_t));
+                writer.Pad();
+                ++record.glyphCount;
+            }
+        }
+
+        rowRuns.clear();
+        for (const auto& run : row.GetAttrRow().GetRuns())
+        {
+            const auto [it, inserted] = attributeIndices.emplace(run.value, gsl::narrow<uint32_t>(attributes.size()));
+            if (inserted)
+            {
+                attributes.emplace_back(buffer._attributeTable.Get(run.value));
+            }
+            rowRuns.push_back({ it->second, run.length });
+        }
+        record.runCount = gsl::narrow<uint16_t>(rowRuns.size());
+
+        // Most rows have the same attributes as the row before them,
+        // so they simply refer to the runs of that row instead.
+        const auto sameRun = [](const Run& a, const Run& b) noexcept {
+            return a.attribute == b.attribute && a.length == b.length;
+        };
+        if (!rows.empty() &&
+            rows.back().runCount == record.runCount &&
+            std::equal(rowRuns.begin(), rowRuns.end(), runs.begin() + rows.back().firstRun, sameRun))
+        {
+            record.firstRun = rows.back().firstRun;
+        }
+        else
+        {
+            record.firstRun = gsl::narrow<uint32_t>(runs.size());
+            runs.insert(runs.end(), rowRuns.begin(), rowRuns.end());
+        }
+
+        rows.push_back(record);
+    }
+
+    header.runsOffset = writer.Offset();
+    writer.Write(runs.data(), runs.size() * sizeof(Run));
+
+    header.rowsOffset = writer.Offset();
+    writer.Write(rows.data(), rows.size() * sizeof(Row));
+
+    header.attributesOffset = writer.Offset();
+    writer.Write(attributes.data(), attributes.size() * sizeof(TextAttribute));
+    writer.Pad();
+
+    const auto writeString = [&](const uint16_t id, const std::wstring_view text) {
+        writer.Write(String{ id, 0, gsl::narrow<uint32_t>(text.size()) });
+        writer.Write(text.data(), text.size() * sizeof(wchar_t));
+        writer.Pad();
+    };
+
+    header.stringsOffset = writer.Offset();
+    for (const auto& [id, uri] : buffer._hyperlinkMap)
+    {
+        writeString(id, uri);
+    }
+    for (const auto& [customId, id] : buffer._hyperlinkCustomIdMap)
+    {
+        writeString(id, customId);
+    }
+
+    writer.Flush();
+    THROW_IF_WIN32_BOOL_FALSE(SetEndOfFile(file));
+
+    header.magic = s_magic;
+    header.version = s_version;
+    header.cellSize = sizeof(CharRowCell);
+    header.attributeSize = sizeof(TextAttribute);
+    header.currentHyperlinkId = buffer._currentHyperlinkId;
+    header.width = gsl::narrow<uint32_t>(buffer.GetSize().Width());
+    header.rowCount = gsl::narrow<uint32_t>(rows.size());
+    header.runCount = gsl::narrow<uint32_t>(runs.size());
+    header.attributeCount = gsl::narrow<uint32_t>(attributes.size());
+    header.hyperlinkCount = gsl::narrow<uint32_t>(buffer._hyperlinkMap.size());
+    header.customIdCount = gsl::narrow<uint32_t>(buffer._hyperlinkCustomIdMap.size());
+    header.fileSize = writer.Offset();
+
+    THROW_IF_WIN32_BOOL_FALSE(SetFilePointerEx(file, {}, nullptr, FILE_BEGIN));
+    FileWriter headerWriter{ file };
+    headerWriter.Write(header);
+    headerWriter.Flush();
+}
+
+// Routine Description:
+// - Opens a snapshot written by Write() and maps it into memory. The whole
+//   file is validated up front, so that rows can be loaded from it lazily.
+// Arguments:
+// - path - the path of the snapshot
+// Return Value:
+// - constructed object
+// Note: will throw if the file can't be read or isn't a valid snapshot
+TextBufferSnapshot::TextBufferSnapshot(const std::wstring_view path)
+{
+    _file.reset(CreateFileW(std::wstring{ path }.c_str(),
+                            GENERIC_READ,
+                            FILE_SHARE_READ,
+                            nullptr,
+                            OPEN_EXISTING,
+                            FILE_ATTRIBUTE_NORMAL,
+                            nullptr));
+    THROW_LAST_ERROR_IF(!_file);
+
+    LARGE_INTEGER fileSize;
+    THROW_IF_WIN32_BOOL_FALSE(GetFileSizeEx(_file.get(), &fileSize));
+    THROW_HR_IF(s_invalidData, gsl::narrow_cast<uint64_t>(fileSize.QuadPart) < sizeof(Header));
+
+    _mapping.reset(CreateFileMappingW(_file.get(), nullptr, PAGE_READONLY, 0, 0, nullptr));
+    THROW_LAST_ERROR_IF(!_mapping);
+
+    _view.reset(static_cast<std::byte*>(MapViewOfFile(_mapping.get(), FILE_MAP_READ, 0, 0, 0)));
+    THROW_LAST_ERROR_IF(!_view);
+
+    _viewSize = gsl::narrow_cast<uint64_t>(fileSize.QuadPart);
+    _header = _Read<Header>(0);
+    _Validate();
+}
+
+// Routine Description:
+// - Gets the size of the buffer the snapshot was taken of.
+// Return Value:
+// - The width of its rows and the number of rows.
+COORD TextBufferSnapshot::GetSize() const noexcept
+{
+    return { gsl::narrow_cast<SHORT>(_header.width), gsl::narrow_cast<SHORT>(_header.rowCount) };
+}
+
+// Routine Description:
+// - Replaces the contents of the buffer with the snapshot. The buffer has to be
+//   as wide as the snapshot. If it has fewer rows, the bottom rows of the
+//   snapshot are restored. The attributes of every row are restored right away,
+//   but the text is only read for the given rows. The other rows read it from
+//   the snapshot once they're thawed, which is why the buffer keeps it alive.
+// Arguments:
+// - snapshot - the snapshot to restore
+// - buffer - the buffer to restore the snapshot into
+// - eagerFirstRow - the first row of the buffer whose text is read right away
+// - eagerLastRow - the row after the last one whose text is read right away
+// Return Value:
+// - <none>
+void TextBufferSnapshot::Restore(const std::shared_ptr<TextBufferSnapshot>& snapshot,
+                                 TextBuffer& buffer,
+                                 const size_t eagerFirstRow,
+                                 const size_t eagerLastRow)
+{
+    const auto& header = snapshot->_header;
+    THROW_HR_IF(E_INVALIDARG, header.width != gsl::narrow_cast<uint32_t>(buffer.GetSize().Width()));
+
+    buffer.Reset();
+    buffer._snapshot = snapshot;
+
+    buffer._hyperlinkMap.clear();
+    buffer._hyperlinkCustomIdMap.clear();
+    auto offset = header.stringsOffset;
+    for (uint32_t i = 0; i < header.hyperlinkCount; ++i)
+    {
+        uint16_t id = 0;
+        const auto uri = snapshot->_ReadString(offset, id);
+        buffer._hyperlinkMap.emplace(id, uri);
+    }
+    for (uint32_t i = 0; i < header.customIdCount; ++i)
+    {
+        uint16_t id = 0;
+        const auto customId = snapshot->_ReadString(offset, id);
+        buffer._hyperlinkCustomIdMap.emplace(customId, id);
+    }
+    buffer._currentHyperlinkId = header.currentHyperlinkId;
+
+    const auto rowCount = std::min<size_t>(header.rowCount, buffer.TotalRowCount());
+    const auto firstSlot = header.rowCount - rowCount;
+
+    std::vector<ATTR_ROW::run_type> runs;
+    std::vector<wchar_t> glyph;
+    for (size_t i = 0; i < rowCount; ++i)
+    {
+        const auto slot = firstSlot + i;
+        const auto record = snapshot->_ReadRow(slot);
+        auto& row = buffer.GetRowByOffset(i);
+
+        row.SetWrapForced(WI_IsFlagSet(record.flags, s_wrapForcedFlag));
+        row.SetDoubleBytePadded(WI_IsFlagSet(record.flags, s_doubleBytePaddedFlag));
+        row.SetLineRendition(static_cast<LineRendition>(record.lineRendition));
+
+        runs.clear();
+        for (size_t run = 0; run < record.runCount; ++run)
+        {
+            const auto snapshotRun = snapshot->_Read<Run>(header.runsOffset + (record.firstRun + run) * sizeof(Run));
+            const auto attr = snapshot->_Read<TextAttribute>(header.attributesOffset + snapshotRun.attribute * sizeof(TextAttribute));
+            runs.emplace_back(buffer._attributeTable.Intern(attr), gsl::narrow_cast<uint16_t>(snapshotRun.length));
+        }
+        row.GetAttrRow().SetRuns(runs);
+
+        // The glyphs in UnicodeStorage are few and far between, so they're restored right away.
+        auto& storage = row.GetUnicodeStorage();
+        storage.Clear();
+        auto glyphOffset = header.textOffset + record.textOffset + s_Align(record.cellCount * sizeof(CharRowCell));
+        for (size_t g = 0; g < record.glyphCount; ++g)
+        {
+            const auto entry = snapshot->_Read<Glyph>(glyphOffset);
+            glyphOffset += sizeof(Glyph);
+            glyph.resize(entry.length);
+            memcpy(glyph.data(), snapshot->_view.get() + glyphOffset, entry.length * sizeof(wchar_t));
+            glyphOffset += s_Align(entry.length * sizeof(wchar_t));
+            storage.StoreGlyph(entry.column, glyph);
+        }
+
+        row.FreezeInto(*snapshot, slot);
+        if (i >= eagerFirstRow && i < eagerLastRow)
+        {
+            // Asking for the CharRow thaws the row.
+            row.GetCharRow();
+        }
+    }
+}
+
+// Routine Description:
+// - Reads the cells of a row, for when it's thawed.
+// Arguments:
+// - slot - the index of the row in the snapshot
+// - cells - receives the cells of the row up to its last non-blank one
+// Return Value:
+// - <none>
+void TextBufferSnapshot::Load(const size_t slot, std::vector<CharRowCell>& cells) const
+{
+    const auto record = _ReadRow(slot);
+    cells.resize(record.cellCount);
+    memcpy(cells.data(), _view.get() + _header.textOffset + record.textOffset, record.cellCount * sizeof(CharRowCell));
+}
+
+// Routine Description:
+// - Nothing needs to happen when a row is done with the snapshot. The snapshot
+//   is read-only and stays mapped for as long as the buffer holds on to it.
+void TextBufferSnapshot::Release(const size_t /*slot*/) noexcept
+{
+}
+
+template<typename T>
+T TextBufferSnapshot::_Read(const uint64_t offset) const
+{
+    THROW_HR_IF(s_invalidData, offset > _viewSize || sizeof(T) > _viewSize - offset);
+
+    T value;
+    memcpy(&value, _view.get() + offset, sizeof(T));
+    return value;
+}
+
+std::wstring_view TextBufferSnapshot::_ReadString(uint64_t& offset, uint16_t& id) const
+{
+    const auto string = _Read<String>(offset);
+    offset += sizeof(String);
+
+    const auto size = uint64_t{ string.length } * sizeof(wchar_t);
+    THROW_HR_IF(s_invalidData, offset > _viewSize || size > _viewSize - offset);
+
+    id = string.id;
+    const std::wstring_view text{ reinterpret_cast<const wchar_t*>(_view.get() + offset), string.length };
+    offset += s_Align(size);
+    return text;
+}
+
+TextBufferSnapshot::Row TextBufferSnapshot::_ReadRow(const size_t row) const
+{
+    return _Read<Row>(_header.rowsOffset + row * sizeof(Row));
+}
+
+// Routine Description:
+// - Checks that all the offsets and counts in the snapshot stay within their
+//   sections, so that rows can be loaded later on without checking anything.
+// Note: will throw if the snapshot isn't valid
+void TextBufferSnapshot::_Validate() const
+{
+    const auto& header = _header;
+    THROW_HR_IF(s_invalidData, header.magic != s_magic || header.version != s_version);
+    THROW_HR_IF(s_invalidData, header.cellSize != sizeof(CharRowCell) || header.attributeSize != sizeof(TextAttribute));
+    THROW_HR_IF(s_invalidData, header.fileSize != _viewSize);
+    THROW_HR_IF(s_invalidData, header.width == 0 || header.width > SHRT_MAX || header.rowCount > SHRT_MAX);
+
+    // The sections follow each other in this order.
+    const auto fits = [](const uint64_t begin, const uint64_t size, const uint64_t end) noexcept {
+        return begin <= end && size <= end - begin;
+    };
+    THROW_HR_IF(s_invalidData, !fits(sizeof(Header), 0, header.textOffset));
+    THROW_HR_IF(s_invalidData, !fits(header.textOffset, 0, header.runsOffset));
+    THROW_HR_IF(s_invalidData, !fits(header.runsOffset, uint64_t{ header.runCount } * sizeof(Run), header.rowsOffset));
+    THROW_HR_IF(s_invalidData, !fits(header.rowsOffset, uint64_t{ header.rowCount } * sizeof(Row), header.attributesOffset));
+    THROW_HR_IF(s_invalidData, !fits(header.attributesOffset, uint64_t{ header.attributeCount } * sizeof(TextAttribute), header.stringsOffset));
+    THROW_HR_IF(s_invalidData, !fits(header.stringsOffset, 0, header.fileSize));
+
+    const auto textSize = header.runsOffset - header.textOffset;
+    for (size_t i = 0; i < header.rowCount; ++i)
+    {
+        const auto record = _ReadRow(i);
+        THROW_HR_IF(s_invalidData, record.cellCount > header.width || record.lineRendition > static_cast<uint8_t>(LineRendition::DoubleHeightBottom));
+
+        THROW_HR_IF(s_invalidData, !fits(record.firstRun, record.runCount, header.runCount));
+        uint64_t width = 0;
+        for (size_t run = 0; run < record.runCount; ++run)
+        {
+            const auto snapshotRun = _Read<Run>(header.runsOffset + (record.firstRun + run) * sizeof(Run));
+            THROW_HR_IF(s_invalidData, snapshotRun.attribute >= header.attributeCount);
+            width += snapshotRun.length;
+        }
+        THROW_HR_IF(s_invalidData, width != header.width);
+
+        auto offset = s_Align(record.cellCount * sizeof(CharRowCell));
+        THROW_HR_IF(s_invalidData, !fits(record.textOffset, offset, textSize));
+        offset += record.textOffset;
+        for (size_t g = 0; g < record.glyphCount; ++g)
+        {
+            THROW_HR_IF(s_invalidData, !fits(offset, sizeof(Glyph), textSize));
+            const auto glyph = _Read<Glyph>(header.textOffset + offset);
+            THROW_HR_IF(s_invalidData, glyph.column >= record.cellCount || glyph.length == 0);
+            offset += sizeof(Glyph);
+            THROW_HR_IF(s_invalidData, !fits(offset, s_Align(glyph.length * sizeof(wchar_t)), textSize));
+            offset += s_Align(glyph.length * sizeof(wchar_t));
+        }
+    }
+
+    auto offset = header.stringsOffset;
+    for (uint64_t i = 0; i < uint64_t{ header.hyperlinkCount } + header.customIdCount; ++i)
+    {
+        uint16_t id = 0;
+        _ReadString(offset, id);
+    }
+}
@@ -0,0 +1,114 @@
+/*++
+Copyright (c) Microsoft Corporation
+Licensed under the MIT license.
+
+Module Name:
+- TextBufferSnapshot.hpp
+
+Abstract:
+- A compact binary image of a text buffer. It holds the text, attributes, wrap
+  flags and line renditions of every row, along with the hyperlinks that the
+  attributes refer to, so that a buffer can be persisted and restored later.
+- Snapshots are written out row by row, without holding a second copy of the
+  buffer in memory. They're read through a read-only mapping of the file. When
+  they're restored, only the attributes of every row are read right away. The
+  text of all but the given range of rows stays in the file until the rows are
+  thawed, the same way RowSpillFile works.
+- Rows with the same attributes as the row before them share its runs in the file.
+--*/
+
+#pragma once
+
+#include "RowSpillFile.hpp"
+
+class TextBuffer;
+
+class TextBufferSnapshot final : public RowStore
+{
+public:
+    static void Write(const TextBuffer& buffer, const HANDLE file);
+
+    explicit TextBufferSnapshot(const std::wstring_view path);
+
+    COORD GetSize() const noexcept;
+
+    static void Restore(const std::shared_ptr<TextBufferSnapshot>& snapshot,
+                        TextBuffer& buffer,
+                        const size_t eagerFirstRow,
+                        const size_t eagerLastRow);
+
+    void Load(const size_t slot, std::vector<CharRowCell>& cells) const override;
+    void Release(const size_t slot) noexcept override;
+
+private:
+    // The file starts with a Header. It's followed by the text of every row,
+    // consisting of the cells of the row up to the last non-blank one and the
+    // Glyphs of those cells that are stored in UnicodeStorage. Then come
+    // the Runs, Rows, attributes and finally the Strings of the hyperlinks.
+    struct Header
+    {
+        uint32_t magic;
+        uint16_t version;
+        uint16_t cellSize;
+        uint16_t attributeSize;
+        uint16_t currentHyperlinkId;
+        uint32_t width;
+        uint32_t rowCount;
+        uint32_t runCount;
+        uint32_t attributeCount;
+        uint32_t hyperlinkCount;
+        uint32_t customIdCount;
+        uint64_t textOffset;
+        uint64_t runsOffset;
+        uint64_t rowsOffset;
+        uint64_t attributesOffset;
+        uint64_t stringsOffset;
+        uint64_t fileSize;
+    };
+
+    struct Row
+    {
+        // Relative to the start of the text.
+        uint64_t textOffset;
+        uint32_t firstRun;
+        uint16_t runCount;
+        uint16_t cellCount;
+        uint16_t glyphCount;
+        uint8_t lineRendition;
+        uint8_t flags;
+        uint32_t reserved;
+    };
+
+    struct Run
+    {
+        uint32_t attribute;
+        uint32_t length;
+    };
+
+    // Followed by length wchar_ts, padded to 4 bytes.
+    struct Glyph
+    {
+        uint16_t column;
+        uint16_t length;
+    };
+
+    // Followed by length wchar_ts, padded to 4 bytes.
+    struct String
+    {
+        uint16_t id;
+        uint16_t reserved;
+        uint32_t length;
+    };
+
+    template<typename T>
+    T _Read(const uint64_t offset) const;
+    std::wstring_view _ReadString(uint64_t& offset, uint16_t& id) const;
+    Row _ReadRow(const size_t row) const;
+    void _Validate() const;
+
+    wil::unique_hfile _file;
+    wil::unique_handle _mapping;
+    wil::unique_mapview_ptr<std::byte> _view;
+    uint64_t _viewSize = 0;
+    Header _header{};
+};
@@ -15,36 +15,15 @@ Author(s):
 #pragma once
 
 #include <vector>
-#include <unordered_map>
-#include <climits>
-
-// std::unordered_map needs help to know how to hash a COORD
-namespace std
-{
-    template<>
-    struct hash<COORD>
-    {
-        // Routine Description:
-        // - hashes a coord. coord will be hashed by storing the x and y values consecutively in the lower
-        // bits of a size_t.
-        // Arguments:
-        // - coord - the coord to hash
-        // Return Value:
-        // - the hashed coord
-        constexpr size_t operator()(const COORD& coord) const noexcept
-        {
-            size_t retVal = coord.Y;
-            const size_t xCoord = coord.X;
-            retVal |= xCoord << (sizeof(coord.Y) * CHAR_BIT);
-            return retVal;
-        }
-    };
-}
 
+// Holds the glyphs of a single row that don't fit into the one wchar_t
+// a CharRow cell has room for (surrogate pairs, longer grapheme clusters).
+// Since every CharRow owns its own storage, the stored glyphs simply move
+// around together with their row and never need to be re-keyed.
 class UnicodeStorage final
 {
 public:
-    using key_type = typename COORD;
+    using key_type = typename uint16_t; // the column of the glyph within the row
     using mapped_type = typename std::vector<wchar_t>;
 
     UnicodeStorage() noexcept;
@@ -55,10 +34,22 @@ public:
 
     void Erase(const key_type key) noexcept;
 
-    void Remap(const std::unordered_map<SHORT, SHORT>& rowMap, const std::optional<SHORT> width);
+    void Clear() noexcept;
+
+    void Truncate(const size_t width) noexcept;
+
+    bool empty() const noexcept { return _glyphs.empty(); }
 
 private:
-    std::unordered_map<key_type, mapped_type> _map;
+    using value_type = typename std::pair<key_type, mapped_type>;
+
+    // Sorted by column. Rows seldom hold more than a handful of these, so a
+    // flat vector is both smaller and faster to search than a hash map.
+    // Note that moving the vector's elements around keeps the glyph buffers
+    // themselves in place, so views of a glyph stay valid until it's overwritten.
+    std::vector<value_type> _glyphs;
+
+    std::vector<value_type>::const_iterator _Find(const key_type key) const noexcept;
 
 #ifdef UNIT_TESTING
     friend class UnicodeStorageTests;
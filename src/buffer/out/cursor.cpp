@@ -252,6 +252,34 @@ void Cursor::DecrementYPosition(const int DeltaY) noexcept
     ResetDelayEOLWrap();
 }
 
+// Routine Description:
+// - Restores all properties to the ones a new cursor has.
+// - This is used when the buffer it belongs to gets recycled.
+// Arguments:
+// - ulSize - The height of the cursor within this buffer
+// Return Value:
+// - <none>
+void Cursor::Reset(const ULONG ulSize) noexcept
+{
+    _cPosition = { 0 };
+    _fHasMoved = false;
+    _fIsVisible = true;
+    _fIsOn = true;
+    _fIsDouble = false;
+    _fBlinkingAllowed = true;
+    _fDelay = false;
+    _fIsConversionArea = false;
+    _fIsPopupShown = false;
+    _fDelayedEolWrap = false;
+    _coordDelayedAt = { 0 };
+    _fDeferCursorRedraw = false;
+    _fHaveDeferredCursorRedraw = false;
+    _ulSize = ulSize;
+    _cursorType = CursorType::Legacy;
+    _fUseColor = false;
+    _color = s_InvertCursorColor;
+}
+
 ///////////////////////////////////////////////////////////////////////////////
 // Routine Description:
 // - Copies properties from another cursor into this one.
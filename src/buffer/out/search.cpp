@@ -93,6 +93,240 @@ bool Search::FindNext()
     return false;
 }
 
+// Routine Description
+// - Locates every instance of the search term within the screen buffer at once.
+// - Rather than comparing cell by cell at every position like FindNext, the text of
+//   each row is flattened into a string and scanned with a Boyer-Moore-Horspool searcher.
+// Arguments:
+// - <none> - Uses internal state from constructor
+// Return Value:
+// - The [start, end] coord positions of every match, sorted by their start position.
+std::vector<Search::Match> Search::FindAll() const
+{
+    std::vector<Match> matches;
+    if (_needle.empty())
+    {
+        return matches;
+    }
+
+    std::wstring needle;
+    for (const auto& needleCell : _needle)
+    {
+        for (const auto wch : needleCell)
+        {
+            needle.push_back(_ApplySensitivity(wch));
+        }
+    }
+    const std::boyer_moore_horspool_searcher searcher{ needle.cbegin(), needle.cend() };
+
+    const auto& textBuffer = _uiaData.GetTextBuffer();
+    const auto width = gsl::narrow_cast<size_t>(textBuffer.GetSize().Width());
+    const auto height = gsl::narrow_cast<size_t>(textBuffer.GetSize().Height());
+    const auto needleCells = _needle.size();
+    const COORD bufferEndPosition = _uiaData.GetTextBufferEndPosition();
+
+    std::wstring haystack;
+    // cellOffsets[i] is where the text of the i-th cell starts in the haystack.
+    std::vector<size_t> cellOffsets;
+
+    for (size_t y = 0; y <= gsl::narrow_cast<size_t>(bufferEndPosition.Y); ++y)
+    {
+        // Matches can continue onto the following rows, so the haystack for this row
+        // includes as many of their cells as a match starting at its end would need.
+        const auto cellCount = std::min(width + needleCells - 1, (height - y) * width);
+
+        haystack.clear();
+        cellOffsets.clear();
+        for (auto rowY = y; cellOffsets.size() < cellCount; ++rowY)
+        {
+            const auto& charRow = textBuffer.GetRowByOffset(rowY).GetCharRow();
+            for (size_t x = 0; x < width && cellOffsets.size() < cellCount; ++x)
+            {
+                cellOffsets.push_back(haystack.size());
+                for (const auto wch : charRow.GlyphAt(x))
+                {
+                    haystack.push_back(_ApplySensitivity(wch));
+                }
+            }
+        }
+        cellOffsets.push_back(haystack.size());
+
+        const auto rowEnd = y == gsl::narrow_cast<size_t>(bufferEndPosition.Y) ? gsl::narrow_cast<size_t>(bufferEndPosition.X) + 1 : width;
+        for (auto it = haystack.cbegin();;)
+        {
+            const auto found = searcher(it, haystack.cend()).first;
+            if (found == haystack.cend())
+            {
+                break;
+            }
+            it = found + 1;
+
+            // Only matches that start on a cell boundary in this row count.
+            // Ones starting in the following rows are found when we get to them.
+            const auto offset = gsl::narrow_cast<size_t>(found - haystack.cbegin());
+            const auto cell = std::lower_bound(cellOffsets.cbegin(), cellOffsets.cend(), offset);
+            const auto startCell = gsl::narrow_cast<size_t>(cell - cellOffsets.cbegin());
+            if (startCell >= rowEnd)
+            {
+                break;
+            }
+            if (*cell != offset ||
+                startCell + needleCells >= cellOffsets.size() ||
+                cellOffsets.at(startCell + needleCells) != offset + needle.size())
+            {
+                continue;
+            }
+
+            const auto endCell = startCell + needleCells - 1;
+            matches.emplace_back(COORD{ gsl::narrow_cast<SHORT>(startCell), gsl::narrow_cast<SHORT>(y) },
+                                 COORD{ gsl::narrow_cast<SHORT>(endCell % width), gsl::narrow_cast<SHORT>(y + endCell / width) });
+        }
+    }
+
+    return matches;
+}
+
+// Routine Description
+// - Picks the next match out of the results of FindAll, the same way FindNext would:
+//   the first one at or after the anchor in the search direction, wrapping around.
+// Arguments:
+// - matches - The matches returned by FindAll.
+// Return Value:
+// - True if we found an item (to Select or Color). False if there are no matches.
+bool Search::FindNextIn(const std::vector<Match>& matches) noexcept
+{
+    if (matches.empty())
+    {
+        return false;
+    }
+
+    const auto startsBefore = [](const Match& match, const COORD pos) noexcept {
+        return match.first.Y < pos.Y || (match.first.Y == pos.Y && match.first.X < pos.X);
+    };
+
+    auto match = std::lower_bound(matches.cbegin(), matches.cend(), _coordAnchor, startsBefore);
+    if (_direction == Direction::Forward)
+    {
+        if (match == matches.cend())
+        {
+            match = matches.cbegin();
+        }
+    }
+    else
+    {
+        // The last match starting at or before the anchor.
+        if (match == matches.cend() || match->first != _coordAnchor)
+        {
+            match = match == matches.cbegin() ? matches.cend() - 1 : match - 1;
+        }
+    }
+
+    _coordSelStart = match->first;
+    _coordSelEnd = match->second;
+    return true;
+}
+
+// Routine Description
+// - Locates every match of a regular expression within the screen buffer.
+// - The text is searched one line at a time, where rows that were wrapped because their text
+//   didn't fit are joined with the following ones, so matches can span those rows (but not others).
+// Arguments:
+// - uiaData - The IUiaData type reference, for the text buffer and where its text ends
+// - pattern - The (ECMAScript) regular expression to search for
+// - sensitivity - Whether or not you care about case
+// - maxMatches - The search stops once this many matches were found
+// - isCancelled - Called before each line is searched. If it returns true, the search stops.
+// Return Value:
+// - The [start, end] coord positions of the matches found, sorted by their start position.
+// - NOTE: Throws std::regex_error if the pattern is invalid (or too complex to match).
+std::vector<Search::Match> Search::s_FindAllRegex(IUiaData& uiaData,
+                                                  const std::wstring_view pattern,
+                                                  const Sensitivity sensitivity,
+                                                  const size_t maxMatches,
+                                                  const std::function<bool()>& isCancelled)
+{
+    std::vector<Match> matches;
+    if (pattern.empty() || maxMatches == 0)
+    {
+        return matches;
+    }
+
+    auto flags = std::regex_constants::ECMAScript | std::regex_constants::optimize;
+    if (sensitivity == Sensitivity::CaseInsensitive)
+    {
+        flags |= std::regex_constants::icase;
+    }
+    const std::wregex regex{ pattern.cbegin(), pattern.cend(), flags };
+
+    const auto& textBuffer = uiaData.GetTextBuffer();
+    const auto width = gsl::narrow_cast<size_t>(textBuffer.GetSize().Width());
+    const auto lastRow = gsl::narrow_cast<size_t>(uiaData.GetTextBufferEndPosition().Y);
+
+    std::wstring line;
+    // cellOffsets[i] is where the text of the i-th cell of the line starts.
+    // The trailing half of a wide glyph has no text of its own and shares
+    // the offset of its leading half.
+    std::vector<size_t> cellOffsets;
+
+    for (size_t y = 0; y <= lastRow;)
+    {
+        if (isCancelled && isCancelled())
+        {
+            break;
+        }
+
+        const auto firstRow = y;
+        line.clear();
+        cellOffsets.clear();
+        for (auto wrapped = true; wrapped && y <= lastRow; ++y)
+        {
+            const auto& row = textBuffer.GetRowByOffset(y);
+            const auto& charRow = row.GetCharRow();
+            for (size_t x = 0; x < width; ++x)
+            {
+                if (charRow.DbcsAttrAt(x).IsTrailing())
+                {
+                    cellOffsets.push_back(cellOffsets.empty() ? line.size() : cellOffsets.back());
+                    continue;
+                }
+
+                cellOffsets.push_back(line.size());
+                for (const auto wch : charRow.GlyphAt(x))
+                {
+                    line.push_back(wch);
+                }
+            }
+            wrapped = row.WasWrapForced();
+        }
+
+        const auto toCoord = [&](const size_t cell) noexcept {
+            return COORD{ gsl::narrow_cast<SHORT>(cell % width), gsl::narrow_cast<SHORT>(firstRow + cell / width) };
+        };
+
+        const std::wcregex_iterator end;
+        for (std::wcregex_iterator it{ line.data(), line.data() + line.size(), regex }; it != end; ++it)
+        {
+            const auto length = gsl::narrow_cast<size_t>(it->length());
+            if (length == 0)
+            {
+                continue;
+            }
+
+            const auto offset = gsl::narrow_cast<size_t>(it->position());
+            const auto startCell = gsl::narrow_cast<size_t>(std::lower_bound(cellOffsets.cbegin(), cellOffsets.cend(), offset) - cellOffsets.cbegin());
+            const auto endCell = gsl::narrow_cast<size_t>(std::lower_bound(cellOffsets.cbegin(), cellOffsets.cend(), offset + length) - cellOffsets.cbegin()) - 1;
+            matches.emplace_back(toCoord(startCell), toCoord(endCell));
+
+            if (matches.size() == maxMatches)
+            {
+                return matches;
+            }
+        }
+    }
+
+    return matches;
+}
+
 // Routine Description:
 // - Takes the found word and selects it in the screen buffer
 void Search::Select() const
@@ -51,7 +51,17 @@ public:
            const Sensitivity sensitivity,
            const COORD anchor);
 
+    using Match = std::pair<COORD, COORD>;
+
     bool FindNext();
+    std::vector<Match> FindAll() const;
+    bool FindNextIn(const std::vector<Match>& matches) noexcept;
+
+    static std::vector<Match> s_FindAllRegex(Microsoft::Console::Types::IUiaData& uiaData,
+                                             const std::wstring_view pattern,
+                                             const Sensitivity sensitivity,
+                                             const size_t maxMatches,
+                                             const std::function<bool()>& isCancelled = nullptr);
     void Select() const;
     void Color(const TextAttribute attr) const;
 
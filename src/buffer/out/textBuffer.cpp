@@ -3,6 +3,8 @@
 
 #include "precomp.h"
 
+#include <execution>
+
 #include "textBuffer.hpp"
 #include "CharRow.hpp"
 
@@ -10,6 +12,8 @@
 #include "../types/inc/convert.hpp"
 #include "../../types/inc/GlyphWidth.hpp"
 
+#include <til/ticket_lock.h>
+
 #pragma hdrstop
 
 using namespace Microsoft::Console;
@@ -24,28 +28,65 @@ using PointTree = interval_tree::IntervalTree<til::point, size_t>;
 // - screenBufferSize - The X by Y dimensions of the new screen buffer
 // - fill - Uses the .Attributes property to decide which default color to apply to all text in this buffer
 // - cursorSize - The height of the cursor within this buffer
+// - useRowArena - If true, rows wider than the inline capacity of a CharRow
+//   allocate their cells from one arena sized for the whole buffer instead of
+//   making a separate heap allocation each. The arena is only ever released
+//   with the buffer, so this is intended for buffers that get replaced (rather
+//   than resized in place) when their width changes, e.g. by Reflow. Cells that
+//   rows give back (when they're frozen) are pooled and reused by other rows.
 // Return Value:
 // - constructed object
 // Note: may throw exception
 TextBuffer::TextBuffer(const COORD screenBufferSize,
                        const TextAttribute defaultAttributes,
                        const UINT cursorSize,
-                       Microsoft::Console::Render::IRenderTarget& renderTarget) :
+                       Microsoft::Console::Render::IRenderTarget& renderTarget,
+                       const bool useRowArena) :
     _firstRow{ 0 },
     _currentAttributes{ defaultAttributes },
     _cursor{ cursorSize, *this },
     _storage{},
-    _unicodeStorage{},
-    _renderTarget{ renderTarget },
+    _renderTarget{ &renderTarget },
     _size{},
     _currentHyperlinkId{ 1 },
-    _currentPatternId{ 0 }
-{
+    _hotRowCount{ 0 },
+    _residentRowCount{ 0 },
+    _currentPatternId{ 0 },
+    _rotatedRowCount{ 0 }
+{
+    const auto width = static_cast<size_t>(std::max<SHORT>(screenBufferSize.X, 0));
+    const auto height = static_cast<size_t>(std::max<SHORT>(screenBufferSize.Y, 0));
+    if (useRowArena && width > CharRow::InlineCapacity)
+    {
+        _rowArena.emplace(width * height * sizeof(CharRow::value_type), til::pmr::get_default_resource());
+
+        // A monotonic arena never reuses what's deallocated, but rows free their cells every
+        // time they're frozen and allocate them again when they're thawed or recycled.
+        // The pool keeps those blocks around for the next row. Every row's cells fit into
+        // a single pool block, so nothing bypasses the pool and goes to the arena directly.
+        std::pmr::pool_options options;
+        options.largest_required_pool_block = width * sizeof(CharRow::value_type);
+        _rowPool.emplace(options, &_rowArena.value());
+    }
+
+    // Once the attribute table is full, it drops the attributes none of our rows use anymore.
+    // Rows that are still waiting to be cleared don't use their attributes anymore.
+    _attributeTable.SetMarkInUseCallback([this](std::vector<bool>& inUse) {
+        inUse.at(_clearAttributesId) = true;
+        for (const auto& row : _storage)
+        {
+            if (row.GetClearGeneration() == _clearGeneration)
+            {
+                row.GetAttrRow().MarkAttributesInUse(inUse);
+            }
+        }
+    });
+
     // initialize ROWs
-    _storage.reserve(static_cast<size_t>(screenBufferSize.Y));
-    for (size_t i = 0; i < static_cast<size_t>(screenBufferSize.Y); ++i)
+    _storage.reserve(height);
+    for (size_t i = 0; i < height; ++i)
     {
-        _storage.emplace_back(static_cast<SHORT>(i), screenBufferSize.X, _currentAttributes, this);
+        _storage.emplace_back(i, screenBufferSize.X, _currentAttributes, this, _GetRowResource());
     }
 
     _UpdateSize();
@@ -87,7 +128,9 @@ const ROW& TextBuffer::GetRowByOffset(const size_t index) const
 
     // Rows are stored circularly, so the index you ask for is offset by the start position and mod the total of rows.
     const size_t offsetIndex = (_firstRow + index) % totalRows;
-    return _storage.at(offsetIndex);
+    auto& row = _storage.at(offsetIndex);
+    _ResetIfCleared(row);
+    return row;
 }
 
 // Routine Description:
@@ -103,7 +146,9 @@ ROW& TextBuffer::GetRowByOffset(const size_t index)
 
     // Rows are stored circularly, so the index you ask for is offset by the start position and mod the total of rows.
     const size_t offsetIndex = (_firstRow + index) % totalRows;
-    return _storage.at(offsetIndex);
+    auto& row = _storage.at(offsetIndex);
+    _ResetIfCleared(row);
+    return row;
 }
 
 // Routine Description:
@@ -555,10 +600,11 @@ bool TextBuffer::IncrementCircularBuffer(const bool inVtMode)
 {
     // FirstRow is at any given point in time the array index in the circular buffer that corresponds
     // to the logical position 0 in the window (cursor coordinates and all other coordinates).
-    _renderTarget.TriggerCircling();
+    _renderTarget->TriggerCircling();
 
-    // Prune hyperlinks to delete obsolete references
-    _PruneHyperlinks();
+    // Remember the hyperlinks of the row we're about to clean out, so that
+    // we can delete the references to the ones that aren't used anymore.
+    const auto hyperlinks = _storage.at(_firstRow).GetAttrRow().GetHyperlinks();
 
     // Second, clean out the old "first row" as it will become the "last row" of the buffer after the circle is performed.
     auto fillAttributes = _currentAttributes;
@@ -571,19 +617,195 @@ bool TextBuffer::IncrementCircularBuffer(const bool inVtMode)
     const bool fSuccess = _storage.at(_firstRow).Reset(fillAttributes);
     if (fSuccess)
     {
+        _storage.at(_firstRow).SetClearGeneration(_clearGeneration);
+
+        // Prune hyperlinks to delete obsolete references
+        _PruneHyperlinks(hyperlinks);
+
         // Now proceed to increment.
         // Incrementing it will cause the next line down to become the new "top" of the window (the new "0" in logical coordinates)
         _firstRow++;
 
         // If we pass up the height of the buffer, loop back to 0.
-        if (_firstRow >= GetSize().Height())
+        if (_firstRow >= _storage.size())
         {
             _firstRow = 0;
         }
+
+        // The marks of the row that was just cleaned out are the first ones, if any.
+        _rotatedRowCount++;
+        while (!_marks.empty() && _marks.front().start.y() < _rotatedRowCount)
+        {
+            _marks.pop_front();
+        }
+
+        // One more row just scrolled out of the hot part of the buffer.
+        if (_hotRowCount != 0 && _hotRowCount < _storage.size())
+        {
+            try
+            {
+                GetRowByOffset(_storage.size() - _hotRowCount - 1).Freeze();
+            }
+            CATCH_LOG();
+        }
+
+        // ...and another one out of the resident part.
+        if (_spillFile && _residentRowCount != 0 && _residentRowCount < _storage.size())
+        {
+            try
+            {
+                GetRowByOffset(_storage.size() - _residentRowCount - 1).Spill(*_spillFile);
+            }
+            CATCH_LOG();
+        }
     }
     return fSuccess;
 }
 
+// Routine Description:
+// - Sets how many rows at the bottom of the buffer are kept "hot".
+// - All rows above them are frozen into a compact form that only holds
+//   their text up to the last non-blank cell (their attributes are already
+//   run length encoded). A frozen row is transparently thawed again the
+//   next time its CharRow is accessed, e.g. by rendering, search or selection.
+// - After this call, IncrementCircularBuffer freezes each row as it crosses
+//   the threshold, so memory use of the scrollback scales with its content.
+// Arguments:
+// - hotRowCount - the number of rows to keep hot, or 0 to stop freezing rows
+//   The rows above them are frozen right away.
+// Return Value:
+// - <none>
+void TextBuffer::SetHotRowCount(const size_t hotRowCount) noexcept
+{
+    _hotRowCount = hotRowCount;
+    if (_hotRowCount == 0 || _hotRowCount >= _storage.size())
+    {
+        return;
+    }
+
+    // Freezing is only an optimization. If we can't, the rows simply stay as they are.
+    try
+    {
+        _FreezeColdRows();
+    }
+    CATCH_LOG();
+}
+
+// Routine Description:
+// - Sets how many rows at the bottom of the buffer are kept in memory.
+// - All rows above them are frozen (see SetHotRowCount) and then moved out
+//   into a memory-mapped temporary file, which is only read back when the row
+//   is accessed again, e.g. by search or when copying text. This keeps the
+//   resident size of very long scrollback roughly constant.
+// - After this call, IncrementCircularBuffer spills each row as it crosses
+//   the threshold.
+// Arguments:
+// - residentRowCount - the number of rows to keep in memory, or 0 to stop spilling rows
+//   The rows above them are spilled right away.
+// Return Value:
+// - <none>
+// Note: will throw if the spill file can't be created
+void TextBuffer::SetResidentRowCount(const size_t residentRowCount)
+{
+    _residentRowCount = residentRowCount;
+    if (_residentRowCount == 0 || _residentRowCount >= _storage.size())
+    {
+        return;
+    }
+
+    if (!_spillFile)
+    {
+        // Rows can't be any wider than the buffer, and we'll never
+        // need more slots than there are rows in the buffer.
+        _spillFile = std::make_unique<RowSpillFile>(GetSize().Width(), _storage.size());
+    }
+
+    _SpillColdRows();
+}
+
+// Routine Description:
+// - Freezes and spills the rows above the hot and resident parts of the buffer
+//   again, which readers like search, copying text or UIA have thawed since.
+//   Otherwise rows are only frozen and spilled once, as they cross into the
+//   cold part of the buffer, and reading all of it would bring all of it back.
+// - Nothing happens unless any row was thawed since the last time.
+// - This has to be called under the buffer's write lock, since readers thaw rows under the read lock.
+// Arguments:
+// - <none>
+// Return Value:
+// - <none>
+void TextBuffer::RefreezeColdRows() noexcept
+{
+    if (CharRow::ThawCount() == _refrozenThawCount)
+    {
+        return;
+    }
+
+    try
+    {
+        if (_hotRowCount != 0 && _hotRowCount < _storage.size())
+        {
+            _FreezeColdRows();
+        }
+        if (_spillFile && _residentRowCount != 0 && _residentRowCount < _storage.size())
+        {
+            _SpillColdRows();
+        }
+    }
+    CATCH_LOG();
+
+    // Resetting rows that were cleared lazily thaws them, too,
+    // which is why this is only looked at once we're done.
+    _refrozenThawCount = CharRow::ThawCount();
+}
+
+// Routine Description:
+// - Freezes all rows above the _hotRowCount bottom rows.
+// Arguments:
+// - <none>
+// Return Value:
+// - <none>
+void TextBuffer::_FreezeColdRows()
+{
+    const auto coldRowCount = _storage.size() - _hotRowCount;
+    for (size_t i = 0; i < coldRowCount; ++i)
+    {
+        GetRowByOffset(i).Freeze();
+    }
+}
+
+// Routine Description:
+// - Spills all rows above the _residentRowCount bottom rows into _spillFile.
+// Arguments:
+// - <none>
+// Return Value:
+// - <none>
+void TextBuffer::_SpillColdRows()
+{
+    const auto spilledRowCount = _storage.size() - _residentRowCount;
+    for (size_t i = 0; i < spilledRowCount; ++i)
+    {
+        GetRowByOffset(i).Spill(*_spillFile);
+    }
+}
+
+// Routine Description:
+// - Gets the number of rows that are kept in memory, as set by SetResidentRowCount.
+//   Rows that were spilled before the count was raised again, and haven't
+//   been accessed since, may still be in the spill file. It's an upper bound.
+// Arguments:
+// - <none>
+// Return Value:
+// - The number of rows that aren't spilled to disk.
+size_t TextBuffer::GetResidentRowCount() const noexcept
+{
+    if (_spillFile && _residentRowCount != 0)
+    {
+        return std::min(_residentRowCount, _storage.size());
+    }
+    return _storage.size();
+}
+
 //Routine Description:
 // - Retrieves the position of the last non-space character in the given
 //   viewport
@@ -606,7 +828,8 @@ COORD TextBuffer::GetLastNonSpaceCharacter(std::optional<const Microsoft::Consol
 
     const auto& currRow = GetRowByOffset(coordEndOfText.Y);
     // The X position of the end of the valid text is the Right draw boundary (which is one beyond the final valid character)
-    coordEndOfText.X = gsl::narrow<short>(currRow.GetCharRow().MeasureRight()) - 1;
+    // Rows remember where it is, so this doesn't thaw or rescan the blank rows we skip over.
+    coordEndOfText.X = gsl::narrow<short>(currRow.MeasureRight()) - 1;
 
     // If the X coordinate turns out to be -1, the row was empty, we need to search backwards for the real end of text.
     const auto viewportTop = viewport.Top();
@@ -617,7 +840,7 @@ COORD TextBuffer::GetLastNonSpaceCharacter(std::optional<const Microsoft::Consol
         const auto& backupRow = GetRowByOffset(coordEndOfText.Y);
         // We need to back up to the previous row if this line is empty, AND there are more rows
 
-        coordEndOfText.X = gsl::narrow<short>(backupRow.GetCharRow().MeasureRight()) - 1;
+        coordEndOfText.X = gsl::narrow<short>(backupRow.MeasureRight()) - 1;
         fDoBackUp = (coordEndOfText.X < 0 && coordEndOfText.Y > viewportTop);
     }
 
@@ -660,7 +883,7 @@ COORD TextBuffer::_GetPreviousFromCursor() const
     return coordPosition;
 }
 
-const SHORT TextBuffer::GetFirstRowIndex() const noexcept
+const size_t TextBuffer::GetFirstRowIndex() const noexcept
 {
     return _firstRow;
 }
@@ -675,12 +898,12 @@ void TextBuffer::_UpdateSize()
     _size = Viewport::FromDimensions({ 0, 0 }, { gsl::narrow<SHORT>(_storage.at(0).size()), gsl::narrow<SHORT>(_storage.size()) });
 }
 
-void TextBuffer::_SetFirstRowIndex(const SHORT FirstRowIndex) noexcept
+void TextBuffer::_SetFirstRowIndex(const size_t FirstRowIndex) noexcept
 {
     _firstRow = FirstRowIndex;
 }
 
-void TextBuffer::ScrollRows(const SHORT firstRow, const SHORT size, const SHORT delta)
+void TextBuffer::ScrollRows(const ptrdiff_t firstRow, const ptrdiff_t size, const ptrdiff_t delta)
 {
     // If we don't have to move anything, leave early.
     if (delta == 0)
@@ -688,17 +911,14 @@ void TextBuffer::ScrollRows(const SHORT firstRow, const SHORT size, const SHORT
         return;
     }
 
-    // OK. We're about to play games by moving rows around within the deque to
+    // OK. We're about to play games by moving rows around within the storage to
     // scroll a massive region in a faster way than copying things.
-    // To make this easier, first correct the circular buffer to have the first row be 0 again.
-    if (_firstRow != 0)
-    {
-        // Rotate the buffer to put the first row at the front.
-        std::rotate(_storage.begin(), _storage.begin() + _firstRow, _storage.end());
-
-        // The first row is now at the top.
-        _firstRow = 0;
-    }
+    // The rows are addressed by their offset from the circular buffer's first row,
+    // so only the rows within the region are moved, no matter where _firstRow is.
+    // The diagrams below show the rows in that logical order.
+    size_t first;
+    size_t middle;
+    size_t last;
 
     // Rotate just the subsection specified
     if (delta < 0)
@@ -706,7 +926,7 @@ void TextBuffer::ScrollRows(const SHORT firstRow, const SHORT size, const SHORT
         // The layout is like this:
         // delta is -2, size is 3, firstRow is 5
         // We want 3 rows from 5 (5, 6, and 7) to move up 2 spots.
-        // --- (storage) ----
+        // --- (rows) ----
         // | 0 begin
         // | 1
         // | 2
@@ -722,7 +942,7 @@ void TextBuffer::ScrollRows(const SHORT firstRow, const SHORT size, const SHORT
         // - end
         // We want B to slide up to A (the negative delta) and everything from [B,C) to slide up with it.
         // So the final layout will be
-        // --- (storage) ----
+        // --- (rows) ----
         // | 0 begin
         // | 1
         // | 2
@@ -736,14 +956,16 @@ void TextBuffer::ScrollRows(const SHORT firstRow, const SHORT size, const SHORT
         // | 10
         // | 11
         // - end
-        std::rotate(_storage.begin() + firstRow + delta, _storage.begin() + firstRow, _storage.begin() + firstRow + size);
+        first = firstRow + delta;
+        middle = firstRow;
+        last = firstRow + size;
     }
     else
     {
         // The layout is like this:
         // delta is 2, size is 3, firstRow is 5
         // We want 3 rows from 5 (5, 6, and 7) to move down 2 spots.
-        // --- (storage) ----
+        // --- (rows) ----
         // | 0 begin
         // | 1
         // | 2
@@ -759,7 +981,7 @@ void TextBuffer::ScrollRows(const SHORT firstRow, const SHORT size, const SHORT
         // - end
         // We want B-1 to slide down to C-1 (the positive delta) and everything from [A, B) to slide down with it.
         // So the final layout will be
-        // --- (storage) ----
+        // --- (rows) ----
         // | 0 begin
         // | 1
         // | 2
@@ -773,12 +995,275 @@ void TextBuffer::ScrollRows(const SHORT firstRow, const SHORT size, const SHORT
         // | 10
         // | 11
         // - end
-        std::rotate(_storage.begin() + firstRow, _storage.begin() + firstRow + size, _storage.begin() + firstRow + size + delta);
+        first = firstRow;
+        middle = firstRow + size;
+        last = firstRow + size + delta;
+    }
+
+    // The region may wrap around the end of the storage, so std::rotate can't be used here.
+    // Rotating by three reversals works just as well with offsets and only swaps the rows in [first, last).
+    _ReverseRows(first, middle);
+    _ReverseRows(middle, last);
+    _ReverseRows(first, last);
+
+    // Renumber the IDs of the rows we've rearranged. The rest of the buffer is untouched.
+    // The rows' UnicodeStorage moved along with them, so there's nothing to re-key.
+    for (auto offset = first; offset < last; ++offset)
+    {
+        auto& row = GetRowByOffset(offset);
+        row.SetId((_firstRow + offset) % _storage.size());
+        row.GetCharRow().UpdateParent(&row);
+    }
+
+    // The marks move along with their rows, which keeps them sorted within each of
+    // the two moved ranges, but not necessarily relative to one another.
+    const auto markFirst = _rotatedRowCount + gsl::narrow_cast<ptrdiff_t>(first);
+    const auto markMiddle = _rotatedRowCount + gsl::narrow_cast<ptrdiff_t>(middle);
+    const auto markLast = _rotatedRowCount + gsl::narrow_cast<ptrdiff_t>(last);
+    auto moved = false;
+    for (auto& mark : _marks)
+    {
+        const auto y = mark.start.y();
+        if (y >= markFirst && y < markMiddle)
+        {
+            mark.start = { mark.start.x(), y + markLast - markMiddle };
+            moved = true;
+        }
+        else if (y >= markMiddle && y < markLast)
+        {
+            mark.start = { mark.start.x(), y - (markMiddle - markFirst) };
+            moved = true;
+        }
+    }
+    if (moved)
+    {
+        std::stable_sort(_marks.begin(), _marks.end(), [](const ScrollMark& lhs, const ScrollMark& rhs) noexcept {
+            return lhs.start < rhs.start;
+        });
+    }
+}
+
+// Routine Description:
+// - Erases whole rows of the buffer. Each row is reset in place, which fills its
+//   text with spaces and replaces its attributes with a single run, instead of
+//   writing every cell. The line rendition and wrap status are reset as well.
+// - If the rows are most of the buffer, like when the scrollback is cleared
+//   (ED 3), the buffer is cleared lazily instead: the rows that are kept are
+//   reset right away, and all others once they're accessed the next time.
+// Arguments:
+// - startRow - the first row to erase
+// - endRow - the row after the last row to erase. It's clamped to the buffer height.
+// - attrs - the attributes to fill the rows with
+// Return Value:
+// - <none>
+// Note:
+// - will throw exception on error.
+void TextBuffer::EraseRows(const size_t startRow, const size_t endRow, const TextAttribute& attrs)
+{
+    const auto clampedEnd = std::min(endRow, _storage.size());
+    if (startRow >= clampedEnd)
+    {
+        return;
+    }
+
+    const auto totalRows = _storage.size();
+    if ((clampedEnd - startRow) * 2 > totalRows && _CanClearLazily(attrs))
+    {
+        // The rows we keep have to be up to date with the current clear generation,
+        // before we move on to the next one, or they'd be cleared along with the rest.
+        std::vector<size_t> keptRows;
+        keptRows.reserve(totalRows - (clampedEnd - startRow));
+        for (size_t row = 0; row < totalRows; ++row)
+        {
+            if (row < startRow || row >= clampedEnd)
+            {
+                keptRows.emplace_back((_firstRow + row) % totalRows);
+                _ResetIfCleared(til::at(_storage, keptRows.back()));
+            }
+        }
+
+        _ClearLazily(attrs);
+
+        for (const auto index : keptRows)
+        {
+            til::at(_storage, index).SetClearGeneration(_clearGeneration);
+        }
+    }
+    else
+    {
+        for (auto row = startRow; row < clampedEnd; ++row)
+        {
+            // Resetting the row makes it current, so there's no need to bring it up to date first.
+            auto& storageRow = _storage.at((_firstRow + row) % totalRows);
+            THROW_HR_IF(E_OUTOFMEMORY, !storageRow.Reset(attrs));
+            storageRow.SetClearGeneration(_clearGeneration);
+        }
+    }
+
+    _EraseMarks(gsl::narrow_cast<ptrdiff_t>(startRow), gsl::narrow_cast<ptrdiff_t>(clampedEnd));
+
+    const auto width = GetSize().Width();
+    _NotifyPaint(Viewport::FromExclusive({ 0,
+                                           gsl::narrow_cast<SHORT>(startRow),
+                                           width,
+                                           gsl::narrow_cast<SHORT>(clampedEnd) }));
+}
+
+// Routine Description:
+// - Fills a rectangle of the buffer with the given character and attributes.
+//   Each row is filled with a single write, so the attributes are applied as one run per row.
+// Arguments:
+// - rect - the area to fill. Must be within the buffer.
+// - fillChar - the character to fill the area with
+// - attrs - the attributes to fill the area with
+// Return Value:
+// - <none>
+// Note:
+// - will throw exception on error.
+void TextBuffer::FillRect(const Viewport& rect, const wchar_t fillChar, const TextAttribute& attrs)
+{
+    THROW_HR_IF(E_INVALIDARG, !GetSize().IsInBounds(rect));
+    if (rect.Width() <= 0 || rect.Height() <= 0)
+    {
+        return;
+    }
+
+    for (auto y = rect.Top(); y < rect.BottomExclusive(); ++y)
+    {
+        auto& row = GetRowByOffset(y);
+        _ClearSplitGlyphs(row, rect.Left(), rect.RightInclusive());
+        row.WriteCells(OutputCellIterator{ fillChar, attrs, gsl::narrow_cast<size_t>(rect.Width()) }, rect.Left(), std::nullopt, rect.RightInclusive());
+    }
+
+    _NotifyPaint(rect);
+}
+
+// Routine Description:
+// - Copies a rectangle of the buffer, including its attributes, to another position.
+//   The source and the target may overlap. The source is left as it was, except where it's overwritten.
+// Arguments:
+// - source - the area to copy. Must be within the buffer.
+// - targetOrigin - the top left corner of the area to copy to. The whole target area must be within the buffer.
+// Return Value:
+// - <none>
+// Note:
+// - will throw exception on error.
+void TextBuffer::CopyRect(const Viewport& source, const COORD targetOrigin)
+{
+    const auto target = Viewport::FromDimensions(targetOrigin, source.Dimensions());
+    THROW_HR_IF(E_INVALIDARG, !GetSize().IsInBounds(source) || !GetSize().IsInBounds(target));
+    if (source.Width() <= 0 || source.Height() <= 0 || source.Origin() == targetOrigin)
+    {
+        return;
+    }
+
+    // Each row is read out in full before it's written, so overlapping horizontally is fine.
+    // Vertically we have to walk away from the target, lest we overwrite source rows we haven't copied yet.
+    const auto movingDown = target.Top() > source.Top();
+    const auto distance = target.Top() - source.Top();
+
+    std::vector<OutputCell> cells;
+    cells.reserve(source.Width());
+
+    for (SHORT i = 0; i < source.Height(); ++i)
+    {
+        const auto sourceY = gsl::narrow_cast<SHORT>(movingDown ? source.BottomInclusive() - i : source.Top() + i);
+        const auto targetY = gsl::narrow_cast<SHORT>(sourceY + distance);
+
+        cells.clear();
+        const auto sourceLine = Viewport::FromDimensions({ source.Left(), sourceY }, source.Width(), 1);
+        for (auto it = GetCellDataAt(sourceLine.Origin(), sourceLine); it; ++it)
+        {
+            cells.emplace_back(*it);
+        }
+
+        // Halves of wide glyphs that were cut off by the edges of the source can't be copied on their own.
+        if (cells.front().DbcsAttr().IsTrailing())
+        {
+            cells.front() = OutputCell{ L" ", {}, cells.front().TextAttr() };
+        }
+        if (cells.back().DbcsAttr().IsLeading())
+        {
+            cells.back() = OutputCell{ L" ", {}, cells.back().TextAttr() };
+        }
+
+        auto& row = GetRowByOffset(targetY);
+        _ClearSplitGlyphs(row, target.Left(), target.RightInclusive());
+        row.WriteCells(OutputCellIterator{ gsl::make_span(cells) }, target.Left(), std::nullopt, target.RightInclusive());
+    }
+
+    _NotifyPaint(target);
+}
+
+// Routine Description:
+// - Writes a rectangle of legacy cells, like WriteConsoleOutputW receives them.
+//   Each row is written in one go, instead of cell by cell through an iterator,
+//   and the whole rectangle is invalidated at once.
+// Arguments:
+// - charInfos - the cells to write, starting with the top left one of the rectangle
+// - stride - the distance between two rows of the rectangle within charInfos
+// - target - the area to write to. Must be within the buffer.
+// Return Value:
+// - <none>
+// Note:
+// - will throw exception on error.
+void TextBuffer::WriteCharInfoRect(const gsl::span<const CHAR_INFO> charInfos, const size_t stride, const Viewport& target)
+{
+    THROW_HR_IF(E_INVALIDARG, !GetSize().IsInBounds(target));
+    if (target.Width() <= 0 || target.Height() <= 0)
+    {
+        return;
+    }
+
+    const auto width = gsl::narrow_cast<size_t>(target.Width());
+    THROW_HR_IF(E_INVALIDARG, stride < width);
+
+    for (auto y = target.Top(); y < target.BottomExclusive(); ++y)
+    {
+        const auto offset = gsl::narrow_cast<size_t>(y - target.Top()) * stride;
+        GetRowByOffset(y).WriteCharInfos(charInfos.subspan(offset, width), target.Left());
+    }
+
+    _NotifyPaint(target);
+}
+
+// Routine Description:
+// - Clears the halves of wide glyphs right outside the given columns,
+//   whose other halves are about to be overwritten.
+// Arguments:
+// - row - the row that's about to be written
+// - left - the first column to be written
+// - right - the last column to be written (inclusive)
+// Return Value:
+// - <none>
+void TextBuffer::_ClearSplitGlyphs(ROW& row, const SHORT left, const SHORT right)
+{
+    const auto& charRow = row.GetCharRow();
+    if (left > 0 && charRow.DbcsAttrAt(left).IsTrailing())
+    {
+        row.ClearColumn(left - 1);
+    }
+    if (gsl::narrow_cast<size_t>(right) + 1 < charRow.size() && charRow.DbcsAttrAt(right).IsLeading())
+    {
+        row.ClearColumn(right + 1);
     }
+}
 
-    // Renumber the IDs now that we've rearranged where the rows sit within the buffer.
-    // Refreshing should also delegate to the UnicodeStorage to re-key all the stored unicode sequences (where applicable).
-    _RefreshRowIDs(std::nullopt);
+// Routine Description:
+// - Reverses the order of the rows within the given range of offsets from the first row.
+// Arguments:
+// - first - offset of the first row in the range
+// - last - offset one past the last row in the range
+// Return Value:
+// - <none>
+void TextBuffer::_ReverseRows(size_t first, size_t last)
+{
+    while (last - first > 1)
+    {
+        --last;
+        std::swap(GetRowByOffset(first), GetRowByOffset(last));
+        ++first;
+    }
 }
 
 Cursor& TextBuffer::GetCursor() noexcept
@@ -873,6 +1358,19 @@ COORD TextBuffer::BufferToScreenPosition(const COORD position) const
     return { position.X << scale, position.Y };
 }
 
+// Routine Description:
+// - Sets the part of an inline image that the given row displays.
+// Arguments:
+// - row - the row to display the image in
+// - imageSlice - refers to the image, which must be in the image cache
+// Return Value:
+// - <none>
+void TextBuffer::SetImageSlice(const SHORT row, const ImageSlice& imageSlice)
+{
+    GetRowByOffset(row).SetImageSlice(imageSlice);
+    _NotifyPaint(Viewport::FromDimensions({ 0, row }, { GetSize().Width(), 1 }));
+}
+
 // Routine Description:
 // - Resets the text contents of this buffer with the default character
 //   and the default current color attributes
@@ -880,10 +1378,47 @@ void TextBuffer::Reset()
 {
     const auto attr = GetCurrentAttributes();
 
-    for (auto& row : _storage)
+    if (_CanClearLazily(attr))
+    {
+        _ClearLazily(attr);
+    }
+    else
     {
-        row.Reset(attr);
+        for (auto& row : _storage)
+        {
+            row.Reset(attr);
+            row.SetClearGeneration(_clearGeneration);
+        }
     }
+
+    // No row refers to any of the images anymore.
+    _imageCache.Clear();
+
+    ClearMarks();
+}
+
+// Routine Description:
+// - Prepares a buffer that isn't used anymore to be used by another screen
+//   buffer of the same size, as if it had just been constructed. This is
+//   much cheaper than constructing a new buffer, since the rows are cleared
+//   in place and keep the memory they've already allocated.
+// Arguments:
+// - renderTarget - the render target of the buffer's new owner.
+// - defaultAttributes - the attributes to clear the buffer with.
+// - cursorSize - the initial size of the cursor.
+void TextBuffer::Recycle(Microsoft::Console::Render::IRenderTarget& renderTarget,
+                         const TextAttribute defaultAttributes,
+                         const UINT cursorSize)
+{
+    _renderTarget = &renderTarget;
+    _currentAttributes = defaultAttributes;
+    _cursor.Reset(cursorSize);
+
+    Reset();
+
+    _hyperlinkMap.clear();
+    _hyperlinkCustomIdMap.clear();
+    _currentHyperlinkId = 1;
 }
 
 // Routine Description:
@@ -906,10 +1441,10 @@ void TextBuffer::Reset()
         {
             TopRow = GetCursor().GetPosition().Y - newSize.Y + 1;
         }
-        const SHORT TopRowIndex = (GetFirstRowIndex() + TopRow) % currentSize.Y;
+        const auto TopRowIndex = (GetFirstRowIndex() + TopRow) % _storage.size();
 
         // rotate rows until the top row is at index 0
-        for (int i = 0; i < TopRowIndex; i++)
+        for (size_t i = 0; i < TopRowIndex; i++)
         {
             _storage.emplace_back(std::move(_storage.front()));
             _storage.erase(_storage.begin());
@@ -926,7 +1461,8 @@ void TextBuffer::Reset()
         // add rows if we're growing
         while (_storage.size() < static_cast<size_t>(newSize.Y))
         {
-            _storage.emplace_back(static_cast<short>(_storage.size()), newSize.X, attributes, this);
+            _storage.emplace_back(_storage.size(), newSize.X, attributes, this, _GetRowResource());
+            _storage.back().SetClearGeneration(_clearGeneration);
         }
 
         // Now that we've tampered with the row placement, refresh all the row IDs.
@@ -934,6 +1470,11 @@ void TextBuffer::Reset()
         // and cleanup the UnicodeStorage characters that might fall outside the resized buffer.
         _RefreshRowIDs(newSize.X);
 
+        // The rows above the new top row are gone, just as if they had been rotated out.
+        _rotatedRowCount += TopRow;
+        _marks.erase(_marks.cbegin(), _FirstMarkOnOrAfterRow(0));
+        _marks.erase(_FirstMarkOnOrAfterRow(newSize.Y), _marks.cend());
+
         // Update the cached size value
         _UpdateSize();
     }
@@ -942,14 +1483,19 @@ void TextBuffer::Reset()
     return S_OK;
 }
 
-const UnicodeStorage& TextBuffer::GetUnicodeStorage() const noexcept
-{
-    return _unicodeStorage;
-}
-
-UnicodeStorage& TextBuffer::GetUnicodeStorage() noexcept
+// Routine Description:
+// - Gets the memory resource that new rows should allocate their cells from.
+// Arguments:
+// - <none>
+// Return Value:
+// - The pool over the row arena if this buffer has one, otherwise the default resource.
+std::pmr::memory_resource* TextBuffer::_GetRowResource() noexcept
 {
-    return _unicodeStorage;
+    if (_rowPool.has_value())
+    {
+        return &_rowPool.value();
+    }
+    return til::pmr::get_default_resource();
 }
 
 // Routine Description:
@@ -957,19 +1503,16 @@ UnicodeStorage& TextBuffer::GetUnicodeStorage() noexcept
 //   by shuffling pointers around.
 // - This will also update parent pointers that are stored in depth within the buffer
 //   (e.g. it will update CharRow parents pointing at Rows that might have been moved around)
-// - Optionally takes a new row width if we're resizing to perform a resize operation and cleanup
-//   any high unicode (UnicodeStorage) runs while we're already looping through the rows.
+// - Optionally takes a new row width if we're resizing to perform a resize operation
+//   while we're already looping through the rows. Resizing a row also drops any of
+//   its high unicode (UnicodeStorage) glyphs that fall outside the new width.
 // Arguments:
 // - newRowWidth - Optional new value for the row width.
 void TextBuffer::_RefreshRowIDs(std::optional<SHORT> newRowWidth)
 {
-    std::unordered_map<SHORT, SHORT> rowMap;
-    SHORT i = 0;
+    size_t i = 0;
     for (auto& it : _storage)
     {
-        // Build a map so we can update Unicode Storage
-        rowMap.emplace(it.GetId(), i);
-
         // Update the IDs
         it.SetId(i++);
 
@@ -983,14 +1526,11 @@ void TextBuffer::_RefreshRowIDs(std::optional<SHORT> newRowWidth)
             THROW_IF_FAILED(it.Resize(newRowWidth.value()));
         }
     }
-
-    // Give the new mapping to Unicode Storage
-    _unicodeStorage.Remap(rowMap, newRowWidth);
 }
 
 void TextBuffer::_NotifyPaint(const Viewport& viewport) const
 {
-    _renderTarget.TriggerRedraw(viewport);
+    _renderTarget->TriggerRedraw(viewport);
 }
 
 // Routine Description:
@@ -1015,14 +1555,68 @@ ROW& TextBuffer::_GetFirstRow()
 // - will throw exception if called with the first row of the text buffer
 ROW& TextBuffer::_GetPrevRowNoWrap(const ROW& Row)
 {
-    int prevRowIndex = Row.GetId() - 1;
-    if (prevRowIndex < 0)
+    THROW_HR_IF(E_FAIL, Row.GetId() == _firstRow);
+
+    const auto prevRowIndex = Row.GetId() == 0 ? _storage.size() - 1 : Row.GetId() - 1;
+    auto& prevRow = _storage.at(prevRowIndex);
+    _ResetIfCleared(prevRow);
+    return prevRow;
+}
+
+// Routine Description:
+// - Returns whether the rows can be cleared with the given attributes lazily.
+// - Readers may reset cleared rows while they share the buffer's lock, so doing
+//   that mustn't touch anything but the row. That's only true if neither the row
+//   nor its new attributes refer to a hyperlink, whose references are counted.
+// Arguments:
+// - attrs - the attributes to clear the rows with
+// Return Value:
+// - true if _ClearLazily may be used.
+bool TextBuffer::_CanClearLazily(const TextAttribute& attrs) const noexcept
+{
+    return !attrs.IsHyperlink() && !_attributeTable.HasHyperlinkReferences();
+}
+
+// Routine Description:
+// - Clears all rows of the buffer in O(1), by starting a new clear generation.
+//   Each row is reset once it's accessed the next time. See _ResetIfCleared.
+// Arguments:
+// - attrs - the attributes to clear the rows with
+// Return Value:
+// - <none>
+void TextBuffer::_ClearLazily(const TextAttribute& attrs)
+{
+    // Interning the attributes now means that resetting a row later only finds them in
+    // the table. If the table is full, Intern falls back to the default attributes.
+    _clearAttributesId = _attributeTable.Intern(attrs);
+    _clearAttributes = _attributeTable.Get(_clearAttributesId);
+    ++_clearGeneration;
+}
+
+// Routine Description:
+// - Resets the given row, if the buffer was cleared since it was reset the last time.
+// - Readers may race to do so while they share the buffer's lock.
+// Arguments:
+// - row - a row of this buffer
+// Return Value:
+// - <none>
+void TextBuffer::_ResetIfCleared(const ROW& row) const
+{
+    if (row.GetClearGeneration() == _clearGeneration)
     {
-        prevRowIndex = TotalRowCount() - 1;
+        return;
     }
 
-    THROW_HR_IF(E_FAIL, Row.GetId() == _firstRow);
-    return _storage.at(prevRowIndex);
+    // Clearing is rare, and every row is reset at most once for it, so one lock for all rows is plenty.
+    static til::ticket_lock lock;
+    const std::lock_guard guard{ lock };
+    if (row.GetClearGeneration() != _clearGeneration)
+    {
+        // The rows are only const for our callers. They're all ours to change.
+        auto& mutableRow = const_cast<ROW&>(row);
+        THROW_HR_IF(E_OUTOFMEMORY, !mutableRow.Reset(_clearAttributes));
+        mutableRow.SetClearGeneration(_clearGeneration);
+    }
 }
 
 // Method Description:
@@ -1033,7 +1627,7 @@ ROW& TextBuffer::_GetPrevRowNoWrap(const ROW& Row)
 // - This buffer's current render target.
 Microsoft::Console::Render::IRenderTarget& TextBuffer::GetRenderTarget() noexcept
 {
-    return _renderTarget;
+    return *_renderTarget;
 }
 
 // Method Description:
@@ -1041,12 +1635,62 @@ Microsoft::Console::Render::IRenderTarget& TextBuffer::GetRenderTarget() noexcep
 // - used for double click selection and uia word navigation
 // Arguments:
 // - pos: the buffer cell under observation
-// - wordDelimiters: the delimiters defined as a part of the DelimiterClass::DelimiterChar
+// - delimiters: the delimiters defined as a part of the DelimiterClass::DelimiterChar
 // Return Value:
 // - the delimiter class for the given char
-const DelimiterClass TextBuffer::_GetDelimiterClassAt(const COORD pos, const std::wstring_view wordDelimiters) const
+const DelimiterClass TextBuffer::_GetDelimiterClassAt(const COORD pos, const DelimiterSet& delimiters) const
 {
-    return GetRowByOffset(pos.Y).GetCharRow().DelimiterClassAt(pos.X, wordDelimiters);
+    return GetRowByOffset(pos.Y).GetCharRow().DelimiterClassAt(pos.X, delimiters);
+}
+
+// Method Description:
+// - Moves pos across the buffer, over all cells for which
+//   (their delimiter class == delimiterClass) == skipEqual.
+// - The cells are scanned a row at a time, which is what makes this faster
+//   than moving pos cell by cell with IncrementInBounds/DecrementInBounds.
+// Arguments:
+// - pos: the position to start at. It's updated to the first cell that isn't skipped.
+// - delimiterClass: the delimiter class to compare the cells with
+// - skipEqual: whether cells of delimiterClass are skipped, or all other cells are
+// - delimiters: the delimiters defined as a part of the DelimiterClass::DelimiterChar
+// - forward: whether to move towards the end of the buffer or its origin
+// Return Value:
+// - false, if every cell up to the edge of the buffer was skipped. pos is left at the
+//   origin when moving backwards and at EndExclusive when moving forward, just like
+//   DecrementInBounds and IncrementInBounds(pos, true) would leave it.
+bool TextBuffer::_SkipDelimiterClass(COORD& pos, const DelimiterClass delimiterClass, const bool skipEqual, const DelimiterSet& delimiters, const bool forward) const
+{
+    const auto bufferSize = GetSize();
+    for (;;)
+    {
+        const auto& charRow = GetRowByOffset(pos.Y).GetCharRow();
+        if (const auto column = charRow.FindDelimiterClassChange(pos.X, delimiterClass, skipEqual, delimiters, forward))
+        {
+            pos.X = gsl::narrow<SHORT>(*column);
+            return true;
+        }
+
+        if (forward)
+        {
+            if (pos.Y == bufferSize.BottomInclusive())
+            {
+                pos = bufferSize.EndExclusive();
+                return false;
+            }
+            pos.X = bufferSize.Left();
+            pos.Y++;
+        }
+        else
+        {
+            if (pos.Y == bufferSize.Top())
+            {
+                pos = bufferSize.Origin();
+                return false;
+            }
+            pos.X = bufferSize.RightInclusive();
+            pos.Y--;
+        }
+    }
 }
 
 // Method Description:
@@ -1087,13 +1731,14 @@ const COORD TextBuffer::GetWordStart(const COORD target, const std::wstring_view
         copy = { bufferSize.RightInclusive(), bufferSize.BottomInclusive() };
     }
 
+    const DelimiterSet delimiters{ wordDelimiters };
     if (accessibilityMode)
     {
-        return _GetWordStartForAccessibility(copy, wordDelimiters);
+        return _GetWordStartForAccessibility(copy, delimiters);
     }
     else
     {
-        return _GetWordStartForSelection(copy, wordDelimiters);
+        return _GetWordStartForSelection(copy, delimiters);
     }
 }
 
@@ -1101,40 +1746,24 @@ const COORD TextBuffer::GetWordStart(const COORD target, const std::wstring_view
 // - Helper method for GetWordStart(). Get the COORD for the beginning of the word (accessibility definition) you are on
 // Arguments:
 // - target - a COORD on the word you are currently on
-// - wordDelimiters - what characters are we considering for the separation of words
+// - delimiters - what characters are we considering for the separation of words
 // Return Value:
 // - The COORD for the first character on the current/previous READABLE "word" (inclusive)
-const COORD TextBuffer::_GetWordStartForAccessibility(const COORD target, const std::wstring_view wordDelimiters) const
+const COORD TextBuffer::_GetWordStartForAccessibility(const COORD target, const DelimiterSet& delimiters) const
 {
     COORD result = target;
     const auto bufferSize = GetSize();
-    bool stayAtOrigin = false;
 
-    // ignore left boundary. Continue until readable text found
-    while (_GetDelimiterClassAt(result, wordDelimiters) != DelimiterClass::RegularChar)
-    {
-        if (!bufferSize.DecrementInBounds(result))
-        {
-            // first char in buffer is a DelimiterChar or ControlChar
-            // we can't move any further back
-            stayAtOrigin = true;
-            break;
-        }
-    }
+    // ignore left boundary. Continue until readable text found.
+    // If the first char in buffer is a DelimiterChar or ControlChar
+    // we can't move any further back.
+    const auto stayAtOrigin = !_SkipDelimiterClass(result, DelimiterClass::RegularChar, false, delimiters, false);
 
     // make sure we expand to the left boundary or the beginning of the word
-    while (_GetDelimiterClassAt(result, wordDelimiters) == DelimiterClass::RegularChar)
-    {
-        if (!bufferSize.DecrementInBounds(result))
-        {
-            // first char in buffer is a RegularChar
-            // we can't move any further back
-            break;
-        }
-    }
+    _SkipDelimiterClass(result, DelimiterClass::RegularChar, true, delimiters, false);
 
     // move off of delimiter and onto word start
-    if (!stayAtOrigin && _GetDelimiterClassAt(result, wordDelimiters) != DelimiterClass::RegularChar)
+    if (!stayAtOrigin && _GetDelimiterClassAt(result, delimiters) != DelimiterClass::RegularChar)
     {
         bufferSize.IncrementInBounds(result);
     }
@@ -1146,28 +1775,22 @@ const COORD TextBuffer::_GetWordStartForAccessibility(const COORD target, const
 // - Helper method for GetWordStart(). Get the COORD for the beginning of the word (selection definition) you are on
 // Arguments:
 // - target - a COORD on the word you are currently on
-// - wordDelimiters - what characters are we considering for the separation of words
+// - delimiters - what characters are we considering for the separation of words
 // Return Value:
 // - The COORD for the first character on the current word or delimiter run (stopped by the left margin)
-const COORD TextBuffer::_GetWordStartForSelection(const COORD target, const std::wstring_view wordDelimiters) const
+const COORD TextBuffer::_GetWordStartForSelection(const COORD target, const DelimiterSet& delimiters) const
 {
     COORD result = target;
     const auto bufferSize = GetSize();
+    const auto& charRow = GetRowByOffset(result.Y).GetCharRow();
 
-    const auto initialDelimiter = _GetDelimiterClassAt(result, wordDelimiters);
+    const auto initialDelimiter = charRow.DelimiterClassAt(result.X, delimiters);
 
     // expand left until we hit the left boundary or a different delimiter class
-    while (result.X > bufferSize.Left() && (_GetDelimiterClassAt(result, wordDelimiters) == initialDelimiter))
-    {
-        bufferSize.DecrementInBounds(result);
-    }
-
-    if (_GetDelimiterClassAt(result, wordDelimiters) != initialDelimiter)
-    {
-        // move off of delimiter
-        bufferSize.IncrementInBounds(result);
-    }
+    const auto delimiter = charRow.FindDelimiterClassChange(result.X, initialDelimiter, true, delimiters, false);
 
+    // move off of delimiter
+    result.X = delimiter ? gsl::narrow<SHORT>(*delimiter + 1) : bufferSize.Left();
     return result;
 }
 
@@ -1199,14 +1822,15 @@ const COORD TextBuffer::GetWordEnd(const COORD target, const std::wstring_view w
         return target;
     }
 
+    const DelimiterSet delimiters{ wordDelimiters };
     if (accessibilityMode)
     {
         const auto lastCharPos{ GetLastNonSpaceCharacter() };
-        return _GetWordEndForAccessibility(target, wordDelimiters, lastCharPos);
+        return _GetWordEndForAccessibility(target, delimiters, lastCharPos);
     }
     else
     {
-        return _GetWordEndForSelection(target, wordDelimiters);
+        return _GetWordEndForSelection(target, delimiters);
     }
 }
 
@@ -1214,11 +1838,11 @@ const COORD TextBuffer::GetWordEnd(const COORD target, const std::wstring_view w
 // - Helper method for GetWordEnd(). Get the COORD for the beginning of the next READABLE word
 // Arguments:
 // - target - a COORD on the word you are currently on
-// - wordDelimiters - what characters are we considering for the separation of words
+// - delimiters - what characters are we considering for the separation of words
 // - lastCharPos - the position of the last nonspace character in the text buffer (to improve performance)
 // Return Value:
 // - The COORD for the first character of the next readable "word". If no next word, return one past the end of the buffer
-const COORD TextBuffer::_GetWordEndForAccessibility(const COORD target, const std::wstring_view wordDelimiters, const COORD lastCharPos) const
+const COORD TextBuffer::_GetWordEndForAccessibility(const COORD target, const DelimiterSet& delimiters, const COORD lastCharPos) const
 {
     const auto bufferSize = GetSize();
     COORD result = target;
@@ -1230,13 +1854,7 @@ const COORD TextBuffer::_GetWordEndForAccessibility(const COORD target, const st
     }
 
     // ignore right boundary. Continue through readable text found
-    while (_GetDelimiterClassAt(result, wordDelimiters) == DelimiterClass::RegularChar)
-    {
-        if (!bufferSize.IncrementInBounds(result, true))
-        {
-            break;
-        }
-    }
+    _SkipDelimiterClass(result, DelimiterClass::RegularChar, true, delimiters, true);
 
     // we are already on/past the last RegularChar
     if (bufferSize.CompareInBounds(result, lastCharPos, true) >= 0)
@@ -1244,17 +1862,11 @@ const COORD TextBuffer::_GetWordEndForAccessibility(const COORD target, const st
         return bufferSize.EndExclusive();
     }
 
-    // make sure we expand to the beginning of the NEXT word
-    while (_GetDelimiterClassAt(result, wordDelimiters) != DelimiterClass::RegularChar)
-    {
-        if (!bufferSize.IncrementInBounds(result, true))
-        {
-            // we are at the EndInclusive COORD
-            // this signifies that we must include the last char in the buffer
-            // but the position of the COORD points to nothing
-            break;
-        }
-    }
+    // make sure we expand to the beginning of the NEXT word.
+    // If we run out of buffer we're left at the EndExclusive COORD.
+    // This signifies that we must include the last char in the buffer
+    // but the position of the COORD points to nothing.
+    _SkipDelimiterClass(result, DelimiterClass::RegularChar, false, delimiters, true);
 
     return result;
 }
@@ -1263,10 +1875,10 @@ const COORD TextBuffer::_GetWordEndForAccessibility(const COORD target, const st
 // - Helper method for GetWordEnd(). Get the COORD for the beginning of the NEXT word
 // Arguments:
 // - target - a COORD on the word you are currently on
-// - wordDelimiters - what characters are we considering for the separation of words
+// - delimiters - what characters are we considering for the separation of words
 // Return Value:
 // - The COORD for the last character of the current word or delimiter run (stopped by right margin)
-const COORD TextBuffer::_GetWordEndForSelection(const COORD target, const std::wstring_view wordDelimiters) const
+const COORD TextBuffer::_GetWordEndForSelection(const COORD target, const DelimiterSet& delimiters) const
 {
     const auto bufferSize = GetSize();
 
@@ -1277,65 +1889,32 @@ const COORD TextBuffer::_GetWordEndForSelection(const COORD target, const std::w
     }
 
     COORD result = target;
-    const auto initialDelimiter = _GetDelimiterClassAt(result, wordDelimiters);
+    const auto& charRow = GetRowByOffset(result.Y).GetCharRow();
+    const auto initialDelimiter = charRow.DelimiterClassAt(result.X, delimiters);
 
     // expand right until we hit the right boundary or a different delimiter class
-    while (result.X < bufferSize.RightInclusive() && (_GetDelimiterClassAt(result, wordDelimiters) == initialDelimiter))
-    {
-        bufferSize.IncrementInBounds(result);
-    }
-
-    if (_GetDelimiterClassAt(result, wordDelimiters) != initialDelimiter)
-    {
-        // move off of delimiter
-        bufferSize.DecrementInBounds(result);
-    }
+    const auto delimiter = charRow.FindDelimiterClassChange(result.X, initialDelimiter, true, delimiters, true);
 
+    // move off of delimiter
+    result.X = delimiter ? gsl::narrow<SHORT>(*delimiter - 1) : bufferSize.RightInclusive();
     return result;
 }
 
-void TextBuffer::_PruneHyperlinks()
+// Routine Description:
+// - Deletes the given hyperlinks from our maps if no row refers to them anymore.
+// - The rows keep count of their references, so this doesn't have to search the buffer.
+// Arguments:
+// - hyperlinks - the hyperlink ids of a row that was just cleaned out
+// Return Value:
+// - <none>
+void TextBuffer::_PruneHyperlinks(const std::vector<uint16_t>& hyperlinks) noexcept
 {
-    // Check the old first row for hyperlink references
-    // If there are any, search the entire buffer for the same reference
-    // If the buffer does not contain the same reference, we can remove that hyperlink from our map
-    // This way, obsolete hyperlink references are cleared from our hyperlink map instead of hanging around
-    // Get all the hyperlink references in the row we're erasing
-    const auto hyperlinks = _storage.at(_firstRow).GetAttrRow().GetHyperlinks();
-
-    if (!hyperlinks.empty())
+    for (const auto id : hyperlinks)
     {
-        // Move to unordered set so we can use hashed lookup of IDs instead of linear search.
-        // Only make it an unordered set now because set always heap allocates but vector
-        // doesn't when the set is empty (saving an allocation in the common case of no links.)
-        std::unordered_set<uint16_t> firstRowRefs{ hyperlinks.cbegin(), hyperlinks.cend() };
-
-        const auto total = TotalRowCount();
-        // Loop through all the rows in the buffer except the first row -
-        // we have found all hyperlink references in the first row and put them in refs,
-        // now we need to search the rest of the buffer (i.e. all the rows except the first)
-        // to see if those references are anywhere else
-        for (size_t i = 1; i != total; ++i)
-        {
-            const auto nextRowRefs = GetRowByOffset(i).GetAttrRow().GetHyperlinks();
-            for (auto id : nextRowRefs)
-            {
-                if (firstRowRefs.find(id) != firstRowRefs.end())
-                {
-                    firstRowRefs.erase(id);
-                }
-            }
-            if (firstRowRefs.empty())
-            {
-                // No more hyperlink references left to search for, terminate early
-                break;
-            }
-        }
-
-        // Now delete obsolete references from our map
-        for (auto hyperlinkReference : firstRowRefs)
+        // The current attributes will be used for new text, so their hyperlink must stay.
+        if (_attributeTable.GetHyperlinkReferenceCount(id) == 0 && id != _currentAttributes.GetHyperlinkId())
         {
-            RemoveHyperlinkFromMap(hyperlinkReference);
+            RemoveHyperlinkFromMap(id);
         }
     }
 }
@@ -1354,7 +1933,7 @@ bool TextBuffer::MoveToNextWord(COORD& pos, const std::wstring_view wordDelimite
     // move to the beginning of the next word
     // NOTE: _GetWordEnd...() returns the exclusive position of the "end of the word"
     //       This is also the inclusive start of the next word.
-    auto copy{ _GetWordEndForAccessibility(pos, wordDelimiters, lastCharPos) };
+    auto copy{ _GetWordEndForAccessibility(pos, DelimiterSet{ wordDelimiters }, lastCharPos) };
 
     if (copy == GetSize().EndExclusive())
     {
@@ -1593,6 +2172,8 @@ void TextBuffer::_ExpandTextRow(SMALL_RECT& textRow) const
 
 // Routine Description:
 // - Retrieves the text data from the selected region and presents it in a clipboard-ready format (given little post-processing).
+// - Large selections are split up into chunks of rows that are extracted concurrently.
+//   That's why GetAttributeColors has to be safe to call from multiple threads at once.
 // Arguments:
 // - includeCRLF - inject CRLF pairs to the end of each line
 // - trimTrailingWhitespace - remove the trailing whitespace at the end of each line
@@ -1607,118 +2188,264 @@ const TextBuffer::TextAndColor TextBuffer::GetText(const bool includeCRLF,
                                                    std::function<std::pair<COLORREF, COLORREF>(const TextAttribute&)> GetAttributeColors,
                                                    const bool formatWrappedRows) const
 {
+    // Rows are extracted in chunks of this many. Selections that fit into a single chunk are
+    // extracted on the calling thread, since going parallel costs more than it saves for them.
+    static constexpr size_t rowsPerChunk = 128;
+
     TextAndColor data;
     const bool copyTextColor = GetAttributeColors != nullptr;
 
-    // preallocate our vectors to reduce reallocs
+    // Every row is written into its own preallocated slot, so that
+    // the rows can be extracted independently of each other.
     size_t const rows = selectionRects.size();
-    data.text.reserve(rows);
+    data.text.resize(rows);
     if (copyTextColor)
     {
-        data.FgAttr.reserve(rows);
-        data.BkAttr.reserve(rows);
+        data.colorRuns.resize(rows);
     }
 
-    // for each row in the selection
-    for (UINT i = 0; i < rows; i++)
-    {
-        const UINT iRow = selectionRects.at(i).Top;
+    const auto getRows = [&](const size_t begin, const size_t end) {
+        for (auto i = begin; i < end; i++)
+        {
+            // apply CR/LF to the end of the final string, unless we're the last line.
+            _GetRowText(selectionRects.at(i),
+                        includeCRLF && i < rows - 1,
+                        trimTrailingWhitespace,
+                        GetAttributeColors,
+                        formatWrappedRows,
+                        data.text.at(i),
+                        copyTextColor ? &data.colorRuns.at(i) : nullptr);
+        }
+    };
 
-        const Viewport highlight = Viewport::FromInclusive(selectionRects.at(i));
+    if (rows <= rowsPerChunk)
+    {
+        getRows(0, rows);
+        return data;
+    }
 
-        // retrieve the data from the screen buffer
-        auto it = GetCellDataAt(highlight.Origin(), highlight);
+    // Parallel algorithms terminate if an exception escapes them,
+    // so they're carried out of each chunk and rethrown afterwards.
+    const auto chunks = (rows + rowsPerChunk - 1) / rowsPerChunk;
+    std::vector<std::exception_ptr> errors(chunks);
+    std::vector<size_t> chunkIndices(chunks);
+    std::iota(chunkIndices.begin(), chunkIndices.end(), size_t{ 0 });
 
-        // allocate a string buffer
-        std::wstring selectionText;
-        std::vector<COLORREF> selectionFgAttr;
-        std::vector<COLORREF> selectionBkAttr;
+    std::for_each(std::execution::par, chunkIndices.begin(), chunkIndices.end(), [&](const size_t chunk) noexcept {
+        try
+        {
+            const auto begin = chunk * rowsPerChunk;
+            getRows(begin, std::min(begin + rowsPerChunk, rows));
+        }
+        catch (...)
+        {
+            til::at(errors, chunk) = std::current_exception();
+        }
+    });
 
-        // preallocate to avoid reallocs
-        selectionText.reserve(gsl::narrow<size_t>(highlight.Width()) + 2); // + 2 for \r\n if we munged it
-        if (copyTextColor)
+    for (const auto& error : errors)
+    {
+        if (error)
         {
-            selectionFgAttr.reserve(gsl::narrow<size_t>(highlight.Width()) + 2);
-            selectionBkAttr.reserve(gsl::narrow<size_t>(highlight.Width()) + 2);
+            std::rethrow_exception(error);
         }
+    }
 
-        // copy char data into the string buffer, skipping trailing bytes
-        while (it)
+    return data;
+}
+
+// Routine Description:
+// - Retrieves the text data of a single row of a selection for GetText.
+// Arguments:
+// - selectionRect - the region of the row to extract
+// - appendCRLF - whether CR/LF should end the row, if it gets formatted
+// - trimTrailingWhitespace - remove the trailing whitespace at the end of the row
+// - GetAttributeColors - function used to map TextAttribute to RGB COLORREFs.
+// - formatWrappedRows - if set we will apply formatting (CRLF inclusion and whitespace trimming) if the row is wrapped
+// - selectionText - receives the text of the row
+// - selectionRuns - receives the colors of the text, unless it's null
+// Return Value:
+// - <none>
+void TextBuffer::_GetRowText(const SMALL_RECT& selectionRect,
+                             const bool appendCRLF,
+                             const bool trimTrailingWhitespace,
+                             const std::function<std::pair<COLORREF, COLORREF>(const TextAttribute&)>& GetAttributeColors,
+                             const bool formatWrappedRows,
+                             std::wstring& selectionText,
+                             std::vector<TextAndColor::ColorRun>* const selectionRuns) const
+{
+    const UINT iRow = selectionRect.Top;
+
+    const Viewport highlight = Viewport::FromInclusive(selectionRect);
+
+    // retrieve the data from the screen buffer
+    auto it = GetCellDataAt(highlight.Origin(), highlight);
+
+    // preallocate to avoid reallocs
+    selectionText.reserve(gsl::narrow<size_t>(highlight.Width()) + 2); // + 2 for \r\n if we munged it
+
+    // The colors are only looked up when the attributes change,
+    // which for most text is far less often than every cell.
+    std::optional<TextAttribute> lastAttr;
+    std::pair<COLORREF, COLORREF> lastColors{};
+
+    // copy char data into the string buffer, skipping trailing bytes
+    while (it)
+    {
+        const auto& cell = *it;
+
+        if (!cell.DbcsAttr().IsTrailing())
         {
-            const auto& cell = *it;
+            const auto chars = cell.Chars();
+            selectionText.append(chars);
 
-            if (!cell.DbcsAttr().IsTrailing())
+            if (selectionRuns)
             {
-                const auto chars = cell.Chars();
-                selectionText.append(chars);
+                const auto& cellAttr = cell.TextAttr();
+                if (!lastAttr || *lastAttr != cellAttr)
+                {
+                    lastAttr = cellAttr;
+                    lastColors = GetAttributeColors(cellAttr);
+                }
 
-                if (copyTextColor)
+                const auto [CellFgAttr, CellBkAttr] = lastColors;
+                if (!selectionRuns->empty() && selectionRuns->back().foreground == CellFgAttr && selectionRuns->back().background == CellBkAttr)
                 {
-                    const auto cellData = cell.TextAttr();
-                    const auto [CellFgAttr, CellBkAttr] = GetAttributeColors(cellData);
-                    for (size_t j = 0; j < chars.size(); ++j)
-                    {
-                        selectionFgAttr.push_back(CellFgAttr);
-                        selectionBkAttr.push_back(CellBkAttr);
-                    }
+                    selectionRuns->back().length += chars.size();
+                }
+                else
+                {
+                    selectionRuns->push_back({ chars.size(), CellFgAttr, CellBkAttr });
                 }
             }
-#pragma warning(suppress : 26444)
-            // TODO GH 2675: figure out why there's custom construction/destruction happening here
-            it++;
         }
+#pragma warning(suppress : 26444)
+        // TODO GH 2675: figure out why there's custom construction/destruction happening here
+        it++;
+    }
 
-        // We apply formatting to rows if the row was NOT wrapped or formatting of wrapped rows is allowed
-        const bool shouldFormatRow = formatWrappedRows || !GetRowByOffset(iRow).WasWrapForced();
+    // We apply formatting to rows if the row was NOT wrapped or formatting of wrapped rows is allowed
+    const bool shouldFormatRow = formatWrappedRows || !GetRowByOffset(iRow).WasWrapForced();
 
-        if (trimTrailingWhitespace)
+    if (trimTrailingWhitespace)
+    {
+        if (shouldFormatRow)
         {
-            if (shouldFormatRow)
+            // remove the spaces at the end (aka trim the trailing whitespace)
+            while (!selectionText.empty() && selectionText.back() == UNICODE_SPACE)
             {
-                // remove the spaces at the end (aka trim the trailing whitespace)
-                while (!selectionText.empty() && selectionText.back() == UNICODE_SPACE)
+                selectionText.pop_back();
+                if (selectionRuns && --selectionRuns->back().length == 0)
                 {
-                    selectionText.pop_back();
-                    if (copyTextColor)
-                    {
-                        selectionFgAttr.pop_back();
-                        selectionBkAttr.pop_back();
-                    }
+                    selectionRuns->pop_back();
                 }
             }
         }
+    }
 
-        // apply CR/LF to the end of the final string, unless we're the last line.
-        // a.k.a if we're earlier than the bottom, then apply CR/LF.
-        if (includeCRLF && i < selectionRects.size() - 1)
+    if (appendCRLF)
+    {
+        if (shouldFormatRow)
         {
-            if (shouldFormatRow)
+            // then we can assume a CR/LF is proper
+            selectionText.push_back(UNICODE_CARRIAGERETURN);
+            selectionText.push_back(UNICODE_LINEFEED);
+
+            if (selectionRuns)
             {
-                // then we can assume a CR/LF is proper
-                selectionText.push_back(UNICODE_CARRIAGERETURN);
-                selectionText.push_back(UNICODE_LINEFEED);
+                // cant see CR/LF so just use black FG & BK
+                COLORREF const Blackness = RGB(0x00, 0x00, 0x00);
+                selectionRuns->push_back({ 2, Blackness, Blackness });
+            }
+        }
+    }
+}
 
-                if (copyTextColor)
-                {
-                    // cant see CR/LF so just use black FG & BK
-                    COLORREF const Blackness = RGB(0x00, 0x00, 0x00);
-                    selectionFgAttr.push_back(Blackness);
-                    selectionFgAttr.push_back(Blackness);
-                    selectionBkAttr.push_back(Blackness);
-                    selectionBkAttr.push_back(Blackness);
-                }
+// Routine Description:
+// - Calls the given function for each run of colored text that should be
+//   placed on the clipboard, followed by a call with an empty run of text
+//   at the end of every row. CR and LF end a row, as they have no colors.
+// Arguments:
+// - rows - the text and color data to iterate over
+// - func - called with the row, the text and the colors of the run
+// Return Value:
+// - <none>
+template<typename T>
+static void s_ForEachColorRun(const TextBuffer::TextAndColor& rows, T&& func)
+{
+    for (size_t row = 0; row < rows.text.size(); row++)
+    {
+        const std::wstring_view rowText{ rows.text.at(row) };
+        size_t offset = 0;
+
+        for (const auto& run : rows.colorRuns.at(row))
+        {
+            const auto runText = rowText.substr(std::min(offset, rowText.size()), run.length);
+            offset += run.length;
+
+            const auto lineBreak = runText.find_first_of(L"\r\n");
+            const auto visibleText = runText.substr(0, lineBreak);
+            if (!visibleText.empty())
+            {
+                func(row, visibleText, run.foreground, run.background);
+            }
+            if (lineBreak != std::wstring_view::npos)
+            {
+                break;
             }
         }
+        func(row, std::wstring_view{}, COLORREF{}, COLORREF{});
+    }
+}
 
-        data.text.emplace_back(std::move(selectionText));
-        if (copyTextColor)
+// Routine Description:
+// - Appends the given text to a string in UTF-8, with some of the characters
+//   replaced by escape sequences.
+// Arguments:
+// - out - the string to append to
+// - text - the text to append
+// - scratch - a buffer for the UTF-8 conversion, reused across calls
+// - escape - returns the replacement for a character, or an empty string if it's to be kept
+// Return Value:
+// - <none>
+template<typename T>
+static void s_AppendEscapedUtf8(std::string& out, const std::wstring_view text, std::string& scratch, T&& escape)
+{
+    THROW_IF_FAILED(til::u16u8(text, scratch));
+    for (const auto c : scratch)
+    {
+        const std::string_view replacement = escape(c);
+        if (replacement.empty())
+        {
+            out.push_back(c);
+        }
+        else
         {
-            data.FgAttr.emplace_back(std::move(selectionFgAttr));
-            data.BkAttr.emplace_back(std::move(selectionBkAttr));
+            out.append(replacement);
         }
     }
+}
 
-    return data;
+// Routine Description:
+// - Estimates the size of the content that GenHTML and GenRTF generate,
+//   so that it can be reserved up front.
+// Arguments:
+// - rows - the text and color data that will be formatted
+// - bytesPerRun - the approximate number of bytes of markup for each color run
+// Return Value:
+// - The number of bytes to reserve
+static size_t s_EstimateFormattedSize(const TextBuffer::TextAndColor& rows, const size_t bytesPerRun) noexcept
+{
+    size_t size = 512;
+    for (size_t row = 0; row < rows.text.size(); row++)
+    {
+        size += til::at(rows.text, row).size() + 8;
+        if (row < rows.colorRuns.size())
+        {
+            size += til::at(rows.colorRuns, row).size() * bytesPerRun;
+        }
+    }
+    return size;
 }
 
 // Routine Description:
@@ -1737,157 +2464,124 @@ std::string TextBuffer::GenHTML(const TextAndColor& rows,
 {
     try
     {
-        std::ostringstream htmlBuilder;
+        // once filled with values, there will be exactly 157 bytes in the clipboard header
+        constexpr size_t ClipboardHeaderSize = 157;
+
+        // The header contains the byte offsets of the HTML that follows it. All
+        // of them are padded to the same number of digits, so the space for the
+        // header can be set aside up front and filled in once the HTML is done.
+        std::string html(ClipboardHeaderSize, '\0');
+        html.reserve(s_EstimateFormattedSize(rows, 64));
 
         // First we have to add some standard
         // HTML boiler plate required for CF_HTML
         // as part of the HTML Clipboard format
-        const std::string htmlHeader =
-            "<!DOCTYPE><HTML><HEAD></HEAD><BODY>";
-        htmlBuilder << htmlHeader;
+        constexpr std::string_view HtmlHeader = "<!DOCTYPE><HTML><HEAD></HEAD><BODY>";
+        html.append(HtmlHeader);
 
-        htmlBuilder << "<!--StartFragment -->";
+        html.append("<!--StartFragment -->");
 
         // apply global style in div element
         {
-            htmlBuilder << "<DIV STYLE=\"";
-            htmlBuilder << "display:inline-block;";
-            htmlBuilder << "white-space:pre;";
-
-            htmlBuilder << "background-color:";
-            htmlBuilder << Utils::ColorToHexString(backgroundColor);
-            htmlBuilder << ";";
-
-            htmlBuilder << "font-family:";
-            htmlBuilder << "'";
-            htmlBuilder << ConvertToA(CP_UTF8, fontFaceName);
-            htmlBuilder << "',";
+            html.append("<DIV STYLE=\"");
+            html.append("display:inline-block;");
+            html.append("white-space:pre;");
+
+            html.append("background-color:");
+            html.append(Utils::ColorToHexString(backgroundColor));
+            html.append(";");
+
+            html.append("font-family:");
+            html.append("'");
+            html.append(ConvertToA(CP_UTF8, fontFaceName));
+            html.append("',");
             // even with different font, add monospace as fallback
-            htmlBuilder << "monospace;";
+            html.append("monospace;");
 
-            htmlBuilder << "font-size:";
-            htmlBuilder << fontHeightPoints;
-            htmlBuilder << "pt;";
+            html.append("font-size:");
+            html.append(std::to_string(fontHeightPoints));
+            html.append("pt;");
 
             // note: MS Word doesn't support padding (in this way at least)
-            htmlBuilder << "padding:";
-            htmlBuilder << 4; // todo: customizable padding
-            htmlBuilder << "px;";
+            html.append("padding:");
+            html.append(std::to_string(4)); // todo: customizable padding
+            html.append("px;");
 
-            htmlBuilder << "\">";
+            html.append("\">");
         }
 
+        const auto escape = [](const char c) noexcept -> std::string_view {
+            switch (c)
+            {
+            case '<':
+                return "&lt;";
+            case '>':
+                return "&gt;";
+            case '&':
+                return "&amp;";
+            default:
+                return {};
+            }
+        };
+
         // copy text and info color from buffer
         bool hasWrittenAnyText = false;
         std::optional<COLORREF> fgColor = std::nullopt;
         std::optional<COLORREF> bkColor = std::nullopt;
-        for (size_t row = 0; row < rows.text.size(); row++)
-        {
-            size_t startOffset = 0;
-
-            if (row != 0)
-            {
-                htmlBuilder << "<BR>";
-            }
-
-            for (size_t col = 0; col < rows.text.at(row).length(); col++)
+        std::string scratch;
+        s_ForEachColorRun(rows, [&](const size_t row, const std::wstring_view text, const COLORREF fg, const COLORREF bk) {
+            if (text.empty())
             {
-                const auto writeAccumulatedChars = [&](bool includeCurrent) {
-                    if (col >= startOffset)
-                    {
-                        const auto unescapedText = ConvertToA(CP_UTF8, std::wstring_view(rows.text.at(row)).substr(startOffset, col - startOffset + includeCurrent));
-                        for (const auto c : unescapedText)
-                        {
-                            switch (c)
-                            {
-                            case '<':
-                                htmlBuilder << "&lt;";
-                                break;
-                            case '>':
-                                htmlBuilder << "&gt;";
-                                break;
-                            case '&':
-                                htmlBuilder << "&amp;";
-                                break;
-                            default:
-                                htmlBuilder << c;
-                            }
-                        }
-
-                        startOffset = col;
-                    }
-                };
-
-                if (rows.text.at(row).at(col) == '\r' || rows.text.at(row).at(col) == '\n')
+                // This is the end of the row. For line breaks use '<BR>', since
+                // \r and \n have no color attributes and aren't HTML friendly.
+                if (row + 1 < rows.text.size())
                 {
-                    // do not include \r nor \n as they don't have color attributes
-                    // and are not HTML friendly. For line break use '<BR>' instead.
-                    writeAccumulatedChars(false);
-                    break;
-                }
-
-                bool colorChanged = false;
-                if (!fgColor.has_value() || rows.FgAttr.at(row).at(col) != fgColor.value())
-                {
-                    fgColor = rows.FgAttr.at(row).at(col);
-                    colorChanged = true;
+                    html.append("<BR>");
                 }
+                return;
+            }
 
-                if (!bkColor.has_value() || rows.BkAttr.at(row).at(col) != bkColor.value())
-                {
-                    bkColor = rows.BkAttr.at(row).at(col);
-                    colorChanged = true;
-                }
+            if (fgColor != fg || bkColor != bk)
+            {
+                fgColor = fg;
+                bkColor = bk;
 
-                if (colorChanged)
+                if (hasWrittenAnyText)
                 {
-                    writeAccumulatedChars(false);
-
-                    if (hasWrittenAnyText)
-                    {
-                        htmlBuilder << "</SPAN>";
-                    }
-
-                    htmlBuilder << "<SPAN STYLE=\"";
-                    htmlBuilder << "color:";
-                    htmlBuilder << Utils::ColorToHexString(fgColor.value());
-                    htmlBuilder << ";";
-                    htmlBuilder << "background-color:";
-                    htmlBuilder << Utils::ColorToHexString(bkColor.value());
-                    htmlBuilder << ";";
-                    htmlBuilder << "\">";
+                    html.append("</SPAN>");
                 }
 
-                hasWrittenAnyText = true;
-
-                // if this is the last character in the row, flush the whole row
-                if (col == rows.text.at(row).length() - 1)
-                {
-                    writeAccumulatedChars(true);
-                }
+                html.append("<SPAN STYLE=\"");
+                html.append("color:");
+                html.append(Utils::ColorToHexString(fg));
+                html.append(";");
+                html.append("background-color:");
+                html.append(Utils::ColorToHexString(bk));
+                html.append(";");
+                html.append("\">");
             }
-        }
+
+            hasWrittenAnyText = true;
+            s_AppendEscapedUtf8(html, text, scratch, escape);
+        });
 
         if (hasWrittenAnyText)
         {
             // last opened span wasn't closed in loop above, so close it now
-            htmlBuilder << "</SPAN>";
+            html.append("</SPAN>");
         }
 
-        htmlBuilder << "</DIV>";
+        html.append("</DIV>");
 
-        htmlBuilder << "<!--EndFragment -->";
+        html.append("<!--EndFragment -->");
 
         constexpr std::string_view HtmlFooter = "</BODY></HTML>";
-        htmlBuilder << HtmlFooter;
-
-        // once filled with values, there will be exactly 157 bytes in the clipboard header
-        constexpr size_t ClipboardHeaderSize = 157;
+        html.append(HtmlFooter);
 
         // these values are byte offsets from start of clipboard
         const size_t htmlStartPos = ClipboardHeaderSize;
-        const size_t htmlEndPos = ClipboardHeaderSize + gsl::narrow<size_t>(htmlBuilder.tellp());
-        const size_t fragStartPos = ClipboardHeaderSize + gsl::narrow<size_t>(htmlHeader.length());
+        const size_t htmlEndPos = html.size();
+        const size_t fragStartPos = ClipboardHeaderSize + HtmlHeader.length();
         const size_t fragEndPos = htmlEndPos - HtmlFooter.length();
 
         // header required by HTML 0.9 format
@@ -1901,7 +2595,11 @@ std::string TextBuffer::GenHTML(const TextAndColor& rows,
         clipHeaderBuilder << "StartSelection:" << std::setw(10) << fragStartPos << "\r\n";
         clipHeaderBuilder << "EndSelection:" << std::setw(10) << fragEndPos << "\r\n";
 
-        return clipHeaderBuilder.str() + htmlBuilder.str();
+        const auto clipHeader = clipHeaderBuilder.str();
+        THROW_HR_IF(E_UNEXPECTED, clipHeader.size() != ClipboardHeaderSize);
+        std::copy(clipHeader.begin(), clipHeader.end(), html.begin());
+
+        return html;
     }
     catch (...)
     {
@@ -1925,22 +2623,6 @@ std::string TextBuffer::GenRTF(const TextAndColor& rows, const int fontHeightPoi
 {
     try
     {
-        std::ostringstream rtfBuilder;
-
-        // start rtf
-        rtfBuilder << "{";
-
-        // Standard RTF header.
-        // This is similar to the header generated by WordPad.
-        // \ansi - specifies that the ANSI char set is used in the current doc
-        // \ansicpg1252 - represents the ANSI code page which is used to perform the Unicode to ANSI conversion when writing RTF text
-        // \deff0 - specifies that the default font for the document is the one at index 0 in the font table
-        // \nouicompat - ?
-        rtfBuilder << "\\rtf1\\ansi\\ansicpg1252\\deff0\\nouicompat";
-
-        // font table
-        rtfBuilder << "{\\fonttbl{\\f0\\fmodern\\fcharset0 " << ConvertToA(CP_UTF8, fontFaceName) << ";}}";
-
         // map to keep track of colors:
         // keys are colors represented by COLORREF
         // values are indices of the corresponding colors in the color table
@@ -1948,145 +2630,109 @@ std::string TextBuffer::GenRTF(const TextAndColor& rows, const int fontHeightPoi
         int nextColorIndex = 1; // leave 0 for the default color and start from 1.
 
         // RTF color table
-        std::ostringstream colorTableBuilder;
-        colorTableBuilder << "{\\colortbl ;";
-        colorTableBuilder << "\\red" << static_cast<int>(GetRValue(backgroundColor))
-                          << "\\green" << static_cast<int>(GetGValue(backgroundColor))
-                          << "\\blue" << static_cast<int>(GetBValue(backgroundColor))
-                          << ";";
-        colorMap[backgroundColor] = nextColorIndex++;
+        std::string colorTable;
+        colorTable.append("{\\colortbl ;");
+        const auto getColorIndex = [&](const COLORREF color) {
+            const auto [it, inserted] = colorMap.emplace(color, nextColorIndex);
+            if (inserted)
+            {
+                // color not present in the map, so add it
+                colorTable.append("\\red").append(std::to_string(GetRValue(color)));
+                colorTable.append("\\green").append(std::to_string(GetGValue(color)));
+                colorTable.append("\\blue").append(std::to_string(GetBValue(color)));
+                colorTable.append(";");
+                nextColorIndex++;
+            }
+            return it->second;
+        };
+        getColorIndex(backgroundColor);
 
         // content
-        std::ostringstream contentBuilder;
-        contentBuilder << "\\viewkind4\\uc4";
+        std::string content;
+        content.reserve(s_EstimateFormattedSize(rows, 24));
+        content.append("\\viewkind4\\uc4");
 
         // paragraph styles
         // \fs specifies font size in half-points i.e. \fs20 results in a font size
         // of 10 pts. That's why, font size is multiplied by 2 here.
-        contentBuilder << "\\pard\\slmult1\\f0\\fs" << std::to_string(2 * fontHeightPoints)
-                       << "\\highlight1"
-                       << " ";
+        content.append("\\pard\\slmult1\\f0\\fs").append(std::to_string(2 * fontHeightPoints));
+        content.append("\\highlight1");
+        content.append(" ");
 
-        std::optional<COLORREF> fgColor = std::nullopt;
-        std::optional<COLORREF> bkColor = std::nullopt;
-        for (size_t row = 0; row < rows.text.size(); ++row)
-        {
-            size_t startOffset = 0;
-
-            if (row != 0)
+        const auto escape = [](const char c) noexcept -> std::string_view {
+            switch (c)
             {
-                contentBuilder << "\\line "; // new line
+            case '\\':
+                return "\\\\";
+            case '{':
+                return "\\{";
+            case '}':
+                return "\\}";
+            default:
+                return {};
             }
+        };
 
-            for (size_t col = 0; col < rows.text.at(row).length(); ++col)
+        std::optional<COLORREF> fgColor = std::nullopt;
+        std::optional<COLORREF> bkColor = std::nullopt;
+        std::string scratch;
+        s_ForEachColorRun(rows, [&](const size_t row, const std::wstring_view text, const COLORREF fg, const COLORREF bk) {
+            if (text.empty())
             {
-                const auto writeAccumulatedChars = [&](bool includeCurrent) {
-                    if (col >= startOffset)
-                    {
-                        const auto unescapedText = ConvertToA(CP_UTF8, std::wstring_view(rows.text.at(row)).substr(startOffset, col - startOffset + includeCurrent));
-                        for (const auto c : unescapedText)
-                        {
-                            switch (c)
-                            {
-                            case '\\':
-                            case '{':
-                            case '}':
-                                contentBuilder << "\\" << c;
-                                break;
-                            default:
-                                contentBuilder << c;
-                            }
-                        }
-
-                        startOffset = col;
-                    }
-                };
-
-                if (rows.text.at(row).at(col) == '\r' || rows.text.at(row).at(col) == '\n')
+                // This is the end of the row. For line breaks use \line,
+                // since \r and \n have no color attributes.
+                if (row + 1 < rows.text.size())
                 {
-                    // do not include \r nor \n as they don't have color attributes.
-                    // For line break use \line instead.
-                    writeAccumulatedChars(false);
-                    break;
-                }
-
-                bool colorChanged = false;
-                if (!fgColor.has_value() || rows.FgAttr.at(row).at(col) != fgColor.value())
-                {
-                    fgColor = rows.FgAttr.at(row).at(col);
-                    colorChanged = true;
+                    content.append("\\line "); // new line
                 }
+                return;
+            }
 
-                if (!bkColor.has_value() || rows.BkAttr.at(row).at(col) != bkColor.value())
-                {
-                    bkColor = rows.BkAttr.at(row).at(col);
-                    colorChanged = true;
-                }
+            if (fgColor != fg || bkColor != bk)
+            {
+                fgColor = fg;
+                bkColor = bk;
+
+                const auto bkColorIndex = getColorIndex(bk);
+                const auto fgColorIndex = getColorIndex(fg);
+                content.append("\\highlight").append(std::to_string(bkColorIndex));
+                content.append("\\cf").append(std::to_string(fgColorIndex));
+                content.append(" ");
+            }
 
-                if (colorChanged)
-                {
-                    writeAccumulatedChars(false);
+            s_AppendEscapedUtf8(content, text, scratch, escape);
+        });
 
-                    int bkColorIndex = 0;
-                    if (colorMap.find(bkColor.value()) != colorMap.end())
-                    {
-                        // color already exists in the map, just retrieve the index
-                        bkColorIndex = colorMap[bkColor.value()];
-                    }
-                    else
-                    {
-                        // color not present in the map, so add it
-                        colorTableBuilder << "\\red" << static_cast<int>(GetRValue(bkColor.value()))
-                                          << "\\green" << static_cast<int>(GetGValue(bkColor.value()))
-                                          << "\\blue" << static_cast<int>(GetBValue(bkColor.value()))
-                                          << ";";
-                        colorMap[bkColor.value()] = nextColorIndex;
-                        bkColorIndex = nextColorIndex++;
-                    }
+        // end colortbl
+        colorTable.append("}");
 
-                    int fgColorIndex = 0;
-                    if (colorMap.find(fgColor.value()) != colorMap.end())
-                    {
-                        // color already exists in the map, just retrieve the index
-                        fgColorIndex = colorMap[fgColor.value()];
-                    }
-                    else
-                    {
-                        // color not present in the map, so add it
-                        colorTableBuilder << "\\red" << static_cast<int>(GetRValue(fgColor.value()))
-                                          << "\\green" << static_cast<int>(GetGValue(fgColor.value()))
-                                          << "\\blue" << static_cast<int>(GetBValue(fgColor.value()))
-                                          << ";";
-                        colorMap[fgColor.value()] = nextColorIndex;
-                        fgColorIndex = nextColorIndex++;
-                    }
+        std::string rtf;
+        rtf.reserve(content.size() + colorTable.size() + 256);
 
-                    contentBuilder << "\\highlight" << bkColorIndex
-                                   << "\\cf" << fgColorIndex
-                                   << " ";
-                }
+        // start rtf
+        rtf.append("{");
 
-                // if this is the last character in the row, flush the whole row
-                if (col == rows.text.at(row).length() - 1)
-                {
-                    writeAccumulatedChars(true);
-                }
-            }
-        }
+        // Standard RTF header.
+        // This is similar to the header generated by WordPad.
+        // \ansi - specifies that the ANSI char set is used in the current doc
+        // \ansicpg1252 - represents the ANSI code page which is used to perform the Unicode to ANSI conversion when writing RTF text
+        // \deff0 - specifies that the default font for the document is the one at index 0 in the font table
+        // \nouicompat - ?
+        rtf.append("\\rtf1\\ansi\\ansicpg1252\\deff0\\nouicompat");
 
-        // end colortbl
-        colorTableBuilder << "}";
+        // font table
+        rtf.append("{\\fonttbl{\\f0\\fmodern\\fcharset0 ").append(ConvertToA(CP_UTF8, fontFaceName)).append(";}}");
 
         // add color table to the final RTF
-        rtfBuilder << colorTableBuilder.str();
+        rtf.append(colorTable);
 
         // add the text content to the final RTF
-        rtfBuilder << contentBuilder.str();
+        rtf.append(content);
 
         // end rtf
-        rtfBuilder << "}";
+        rtf.append("}");
 
-        return rtfBuilder.str();
+        return rtf;
     }
     catch (...)
     {
@@ -2095,6 +2741,152 @@ std::string TextBuffer::GenRTF(const TextAndColor& rows, const int fontHeightPoi
     }
 }
 
+// Routine Description:
+// - Generates what an export starts with, before any of the rows.
+// Arguments:
+// - format - the format of the export
+// - fontHeightPoints - the unscaled font height
+// - fontFaceName - the name of the font used
+// - backgroundColor - default background color for characters
+// Return Value:
+// - The beginning of the file, in UTF-8.
+std::string TextBuffer::GenExportPrologue(const ExportFormat format,
+                                          const int fontHeightPoints,
+                                          const std::wstring_view fontFaceName,
+                                          const COLORREF backgroundColor)
+{
+    if (format != ExportFormat::Html)
+    {
+        return {};
+    }
+
+    std::string html;
+    html.append("<!DOCTYPE html><html><head><meta charset=\"utf-8\"></head><body>");
+    html.append("<pre style=\"background-color:");
+    html.append(Utils::ColorToHexString(backgroundColor));
+    html.append(";font-family:'");
+    html.append(ConvertToA(CP_UTF8, fontFaceName));
+    html.append("',monospace;font-size:");
+    html.append(std::to_string(fontHeightPoints));
+    html.append("pt;padding:4px;\">");
+    return html;
+}
+
+// Routine Description:
+// - Appends a chunk of rows to an export. The rows are expected to have been
+//   retrieved with GetText, including CRLFs, which are left out after the rows
+//   that wrap. For the formats other than ExportFormat::Text, they need to have
+//   been retrieved with their colors. The runs of every chunk stand on their
+//   own, so that the chunks can be generated independently of each other.
+// Arguments:
+// - out - the string to append to
+// - rows - the text and color data of the rows
+// - format - the format of the export
+// Return Value:
+// - <none>
+void TextBuffer::AppendExportRows(std::string& out, const TextAndColor& rows, const ExportFormat format)
+{
+    std::string scratch;
+
+    if (format == ExportFormat::Text)
+    {
+        for (const auto& text : rows.text)
+        {
+            THROW_IF_FAILED(til::u16u8(text, scratch));
+            out.append(scratch);
+        }
+        return;
+    }
+
+    const auto escape = [format](const char c) noexcept -> std::string_view {
+        if (format == ExportFormat::Html)
+        {
+            switch (c)
+            {
+            case '<':
+                return "&lt;";
+            case '>':
+                return "&gt;";
+            case '&':
+                return "&amp;";
+            default:
+                break;
+            }
+        }
+        return {};
+    };
+
+    std::optional<COLORREF> fgColor;
+    std::optional<COLORREF> bkColor;
+    s_ForEachColorRun(rows, [&](const size_t row, const std::wstring_view text, const COLORREF fg, const COLORREF bk) {
+        if (text.empty())
+        {
+            // The rows that wrap continue in the next one, without a line break.
+            const std::wstring_view rowText{ til::at(rows.text, row) };
+            if (rowText.empty() || rowText.back() != L'\n')
+            {
+                return;
+            }
+
+            if (format == ExportFormat::Vt)
+            {
+                out.append(fgColor ? "\x1b[m\r\n" : "\r\n");
+            }
+            else
+            {
+                out.push_back('\n');
+            }
+            fgColor.reset();
+            bkColor.reset();
+            return;
+        }
+
+        if (format == ExportFormat::Vt)
+        {
+            if (fgColor != fg || bkColor != bk)
+            {
+                fgColor = fg;
+                bkColor = bk;
+                fmt::format_to(std::back_inserter(out),
+                               "\x1b[38;2;{};{};{};48;2;{};{};{}m",
+                               GetRValue(fg),
+                               GetGValue(fg),
+                               GetBValue(fg),
+                               GetRValue(bk),
+                               GetGValue(bk),
+                               GetBValue(bk));
+            }
+            s_AppendEscapedUtf8(out, text, scratch, escape);
+        }
+        else
+        {
+            out.append("<span style=\"color:");
+            out.append(Utils::ColorToHexString(fg));
+            out.append(";background-color:");
+            out.append(Utils::ColorToHexString(bk));
+            out.append(";\">");
+            s_AppendEscapedUtf8(out, text, scratch, escape);
+            out.append("</span>");
+        }
+    });
+
+    if (format == ExportFormat::Vt && fgColor)
+    {
+        out.append("\x1b[m");
+    }
+}
+
+// Routine Description:
+// - Generates what an export ends with, after all of the rows.
+// Arguments:
+// - format - the format of the export
+// Return Value:
+// - The end of the file, in UTF-8.
+std::string_view TextBuffer::GenExportEpilogue(const ExportFormat format) noexcept
+{
+    return format == ExportFormat::Html ? "</pre></body></html>" : "";
+}
+
 // Function Description:
 // - Reflow the contents from the old buffer into the new buffer. The new buffer
 //   can have different dimensions than the old buffer. If it does, then this
@@ -2127,6 +2919,17 @@ HRESULT TextBuffer::Reflow(TextBuffer& oldBuffer,
 
     const short cOldRowsTotal = cOldLastChar.Y + 1;
 
+    // The marks are sorted, so they're placed into the new buffer as we come across their positions.
+    const auto oldMarks = oldBuffer.GetMarks();
+    auto nextMark = oldMarks.cbegin();
+    const auto addMarksBefore = [&](const til::point oldPosition) {
+        const auto position = til::point{ newCursor.GetPosition() };
+        for (; nextMark != oldMarks.cend() && nextMark->start < oldPosition; ++nextMark)
+        {
+            newBuffer.AddMark(nextMark->category, position, nextMark->exitCode);
+        }
+    };
+
     COORD cNewCursorPos = { 0 };
     bool fFoundCursorPos = false;
     bool foundOldMutable = false;
@@ -2139,7 +2942,8 @@ HRESULT TextBuffer::Reflow(TextBuffer& oldBuffer,
         const ROW& row = oldBuffer.GetRowByOffset(iOldRow);
         const short cOldColsTotal = oldBuffer.GetLineWidth(iOldRow);
         const CharRow& charRow = row.GetCharRow();
-        short iRight = gsl::narrow_cast<short>(charRow.MeasureRight());
+        const ATTR_ROW& attrRow = row.GetAttrRow();
+        short iRight = gsl::narrow_cast<short>(row.MeasureRight());
 
         // If we're starting a new row, try and preserve the line rendition
         // from the row in the original buffer.
@@ -2177,7 +2981,10 @@ HRESULT TextBuffer::Reflow(TextBuffer& oldBuffer,
         // Loop through every character in the current row (up to
         // the "right" boundary, which is one past the final valid
         // character)
-        for (short iOldCol = 0; iOldCol < iRight; iOldCol++)
+        // The attributes are walked with an iterator alongside the columns,
+        // since looking each of them up by column would scan the runs every time.
+        auto attrIt = attrRow.cbegin();
+        for (short iOldCol = 0; iOldCol < iRight; iOldCol++, ++attrIt)
         {
             if (iOldCol == cOldCursorPos.X && iOldRow == cOldCursorPos.Y)
             {
@@ -2185,12 +2992,14 @@ HRESULT TextBuffer::Reflow(TextBuffer& oldBuffer,
                 fFoundCursorPos = true;
             }
 
+            addMarksBefore({ iOldCol + 1, iOldRow });
+
             try
             {
                 // TODO: MSFT: 19446208 - this should just use an iterator and the inserter...
-                const auto glyph = row.GetCharRow().GlyphAt(iOldCol);
-                const auto dbcsAttr = row.GetCharRow().DbcsAttrAt(iOldCol);
-                const auto textAttr = row.GetAttrRow().GetAttrByColumn(iOldCol);
+                const auto glyph = charRow.GlyphAt(iOldCol);
+                const auto dbcsAttr = charRow.DbcsAttrAt(iOldCol);
+                const auto textAttr = *attrIt;
 
                 if (!newBuffer.InsertCharacter(glyph, dbcsAttr, textAttr))
                 {
@@ -2225,6 +3034,9 @@ HRESULT TextBuffer::Reflow(TextBuffer& oldBuffer,
             }
         }
 
+        // The marks past the end of the row's text end up right after it.
+        addMarksBefore({ 0, iOldRow + 1 });
+
         if (SUCCEEDED(hr))
         {
             // If we didn't have a full row to copy, insert a new
@@ -2347,6 +3159,20 @@ HRESULT TextBuffer::Reflow(TextBuffer& oldBuffer,
 
     if (SUCCEEDED(hr))
     {
+        // The marks below the old text keep their distance to the cursor.
+        const auto newCursorPos = til::point{ newCursor.GetPosition() };
+        const auto newHeight = newBuffer.GetSize().Height();
+        const auto newWidth = newBuffer.GetSize().Width();
+        for (; nextMark != oldMarks.cend(); ++nextMark)
+        {
+            const auto y = newCursorPos.y() + nextMark->start.y() - cOldCursorPos.Y;
+            if (y >= 0 && y < newHeight)
+            {
+                const auto x = std::min<ptrdiff_t>(nextMark->start.x(), newWidth - 1);
+                newBuffer.AddMark(nextMark->category, { x, y }, nextMark->exitCode);
+            }
+        }
+
         // Save old cursor size before we delete it
         ULONG const ulSize = oldCursor.GetSize();
 
@@ -2473,7 +3299,8 @@ void TextBuffer::CopyHyperlinkMaps(const TextBuffer& other)
 const size_t TextBuffer::AddPatternRecognizer(const std::wstring_view regexString)
 {
     ++_currentPatternId;
-    _idsAndPatterns.emplace(std::make_pair(_currentPatternId, regexString));
+    _idsAndPatterns.emplace(std::make_pair(_currentPatternId, std::wregex{ regexString.cbegin(), regexString.cend() }));
+    _patternCacheGenerations.clear();
     return _currentPatternId;
 }
 
@@ -2483,6 +3310,7 @@ void TextBuffer::ClearPatternRecognizers() noexcept
 {
     _idsAndPatterns.clear();
     _currentPatternId = 0;
+    _patternCacheGenerations.clear();
 }
 
 // Method Description:
@@ -2493,6 +3321,7 @@ void TextBuffer::CopyPatterns(const TextBuffer& OtherBuffer)
 {
     _idsAndPatterns = OtherBuffer._idsAndPatterns;
     _currentPatternId = OtherBuffer._currentPatternId;
+    _patternCacheGenerations.clear();
 }
 
 // Method Description:
@@ -2504,6 +3333,21 @@ void TextBuffer::CopyPatterns(const TextBuffer& OtherBuffer)
 // - An interval tree containing the patterns found
 PointTree TextBuffer::GetPatterns(const size_t firstRow, const size_t lastRow) const
 {
+    // Every change to a row gives it a new generation, so if the rows we're
+    // asked about have the same generations as last time, so do the results.
+    // This also covers the row width, as resizing a row changes it as well.
+    std::vector<uint64_t> generations;
+    generations.reserve(lastRow - firstRow + 1);
+    for (auto i = firstRow; i <= lastRow; ++i)
+    {
+        generations.push_back(GetRowByOffset(i).GetGeneration());
+    }
+
+    if (generations == _patternCacheGenerations)
+    {
+        return PointTree{ PointTree::interval_vector{ _patternCacheIntervals } };
+    }
+
     PointTree::interval_vector intervals;
 
     std::wstring concatAll;
@@ -2521,10 +3365,8 @@ PointTree TextBuffer::GetPatterns(const size_t firstRow, const size_t lastRow) c
     // for each pattern we know of, iterate through the string
     for (const auto& idAndPattern : _idsAndPatterns)
     {
-        std::wregex regexObj{ idAndPattern.second };
-
         // search through the run with our regex object
-        auto words_begin = std::wsregex_iterator(concatAll.begin(), concatAll.end(), regexObj);
+        auto words_begin = std::wsregex_iterator(concatAll.begin(), concatAll.end(), idAndPattern.second);
         auto words_end = std::wsregex_iterator();
 
         size_t lenUpToThis = 0;
@@ -2560,6 +3402,143 @@ PointTree TextBuffer::GetPatterns(const size_t firstRow, const size_t lastRow) c
             intervals.push_back(PointTree::interval(startCoord, endCoord, idAndPattern.first));
         }
     }
+    _patternCacheIntervals = intervals;
+    _patternCacheGenerations = std::move(generations);
+
     PointTree result(std::move(intervals));
     return result;
 }
+
+// Method Description:
+// - Adds a shell integration mark. The marks are kept sorted by position, and
+//   they're normally added in order, at the cursor, so this is usually just an
+//   append. They move along with their rows when the buffer scrolls, rotates
+//   or is reflowed, and they're dropped along with them.
+// Arguments:
+// - category: what the mark tells about the text that follows it.
+// - position: where the mark is, in buffer coordinates.
+// - exitCode: the exit code of the command, for a CommandFinished mark.
+// Return Value:
+// - <none>
+void TextBuffer::AddMark(const MarkCategory category, const til::point position, const std::optional<uint32_t> exitCode)
+{
+    ScrollMark mark{ { position.x(), position.y() + _rotatedRowCount }, category, exitCode };
+    if (_marks.empty() || !(mark.start < _marks.back().start))
+    {
+        _marks.emplace_back(std::move(mark));
+        return;
+    }
+
+    const auto it = std::upper_bound(_marks.cbegin(), _marks.cend(), mark.start, [](const til::point& start, const ScrollMark& other) noexcept {
+        return start < other.start;
+    });
+    _marks.emplace(it, std::move(mark));
+}
+
+void TextBuffer::ClearMarks() noexcept
+{
+    _marks.clear();
+}
+
+// Method Description:
+// - Gets all the marks, sorted by position.
+// Arguments:
+// - <none>
+// Return Value:
+// - The marks, in buffer coordinates.
+std::vector<ScrollMark> TextBuffer::GetMarks() const
+{
+    std::vector<ScrollMark> marks;
+    marks.reserve(_marks.size());
+    for (const auto& mark : _marks)
+    {
+        marks.emplace_back(_ToBufferMark(mark));
+    }
+    return marks;
+}
+
+// Method Description:
+// - Finds the closest mark of the given category above the given row.
+// Arguments:
+// - row: the row to start looking from, in buffer coordinates.
+// - category: the category of the mark to look for.
+// Return Value:
+// - The mark, in buffer coordinates, if there is one.
+std::optional<ScrollMark> TextBuffer::GetPreviousMark(const ptrdiff_t row, const MarkCategory category) const
+{
+    const auto it = std::find_if(std::make_reverse_iterator(_FirstMarkOnOrAfterRow(row)), _marks.crend(), [=](const ScrollMark& mark) noexcept {
+        return mark.category == category;
+    });
+    if (it == _marks.crend())
+    {
+        return std::nullopt;
+    }
+    return _ToBufferMark(*it);
+}
+
+// Method Description:
+// - Finds the closest mark of the given category below the given row.
+// Arguments:
+// - row: the row to start looking from, in buffer coordinates.
+// - category: the category of the mark to look for.
+// Return Value:
+// - The mark, in buffer coordinates, if there is one.
+std::optional<ScrollMark> TextBuffer::GetNextMark(const ptrdiff_t row, const MarkCategory category) const
+{
+    const auto it = std::find_if(_FirstMarkOnOrAfterRow(row + 1), _marks.cend(), [=](const ScrollMark& mark) noexcept {
+        return mark.category == category;
+    });
+    if (it == _marks.cend())
+    {
+        return std::nullopt;
+    }
+    return _ToBufferMark(*it);
+}
+
+// Method Description:
+// - Finds where the text that follows a mark ends, which is at the next prompt
+//   or the end of the command, whichever comes first. For an Output mark
+//   that's the end of the command's output.
+// Arguments:
+// - mark: the mark, in buffer coordinates.
+// Return Value:
+// - The position of the next Prompt or CommandFinished mark in buffer
+//   coordinates, or the cursor position if there isn't one.
+til::point TextBuffer::GetMarkEnd(const ScrollMark& mark) const
+{
+    const til::point start{ mark.start.x(), mark.start.y() + _rotatedRowCount };
+    auto it = std::upper_bound(_marks.cbegin(), _marks.cend(), start, [](const til::point& position, const ScrollMark& other) noexcept {
+        return position < other.start;
+    });
+    it = std::find_if(it, _marks.cend(), [](const ScrollMark& other) noexcept {
+        return other.category == MarkCategory::Prompt || other.category == MarkCategory::CommandFinished;
+    });
+    if (it == _marks.cend())
+    {
+        return til::point{ GetCursor().GetPosition() };
+    }
+    return _ToBufferMark(*it).start;
+}
+
+ScrollMark TextBuffer::_ToBufferMark(const ScrollMark& mark) const noexcept
+{
+    return { { mark.start.x(), mark.start.y() - _rotatedRowCount }, mark.category, mark.exitCode };
+}
+
+// Binary searches for the first mark on the given row (in buffer coordinates) or below it.
+std::deque<ScrollMark>::const_iterator TextBuffer::_FirstMarkOnOrAfterRow(const ptrdiff_t row) const
+{
+    const auto y = row + _rotatedRowCount;
+    return std::lower_bound(_marks.cbegin(), _marks.cend(), y, [](const ScrollMark& mark, const ptrdiff_t value) noexcept {
+        return mark.start.y() < value;
+    });
+}
+
+// Drops the marks on the rows [firstRow, lastRow), in buffer coordinates.
+void TextBuffer::_EraseMarks(const ptrdiff_t firstRow, const ptrdiff_t lastRow)
+{
+    if (firstRow < lastRow)
+    {
+        _marks.erase(_FirstMarkOnOrAfterRow(firstRow), _FirstMarkOnOrAfterRow(lastRow));
+    }
+}
@@ -53,6 +53,10 @@ filling in the last row, and updating the screen.
 
 #include "cursor.h"
 #include "Row.hpp"
+#include "ImageCache.hpp"
+#include "RowSpillFile.hpp"
+#include "ScrollMark.hpp"
+#include "TextBufferSnapshot.hpp"
 #include "TextAttribute.hpp"
 #include "UnicodeStorage.hpp"
 #include "../types/inc/Viewport.hpp"
@@ -68,7 +72,8 @@ public:
     TextBuffer(const COORD screenBufferSize,
                const TextAttribute defaultAttributes,
                const UINT cursorSize,
-               Microsoft::Console::Render::IRenderTarget& renderTarget);
+               Microsoft::Console::Render::IRenderTarget& renderTarget,
+               const bool useRowArena = false);
     TextBuffer(const TextBuffer& a) = delete;
 
     // Used for duplicating properties to another text buffer
@@ -105,16 +110,26 @@ public:
     // Scroll needs access to this to quickly rotate around the buffer.
     bool IncrementCircularBuffer(const bool inVtMode = false);
 
+    void SetHotRowCount(const size_t hotRowCount) noexcept;
+    void SetResidentRowCount(const size_t residentRowCount);
+    size_t GetResidentRowCount() const noexcept;
+    void RefreezeColdRows() noexcept;
+
     COORD GetLastNonSpaceCharacter(std::optional<const Microsoft::Console::Types::Viewport> viewOptional = std::nullopt) const;
 
     Cursor& GetCursor() noexcept;
     const Cursor& GetCursor() const noexcept;
 
-    const SHORT GetFirstRowIndex() const noexcept;
+    const size_t GetFirstRowIndex() const noexcept;
 
     const Microsoft::Console::Types::Viewport GetSize() const noexcept;
 
-    void ScrollRows(const SHORT firstRow, const SHORT size, const SHORT delta);
+    void ScrollRows(const ptrdiff_t firstRow, const ptrdiff_t size, const ptrdiff_t delta);
+
+    void EraseRows(const size_t startRow, const size_t endRow, const TextAttribute& attrs);
+    void FillRect(const Microsoft::Console::Types::Viewport& rect, const wchar_t fillChar, const TextAttribute& attrs);
+    void CopyRect(const Microsoft::Console::Types::Viewport& source, const COORD targetOrigin);
+    void WriteCharInfoRect(const gsl::span<const CHAR_INFO> charInfos, const size_t stride, const Microsoft::Console::Types::Viewport& target);
 
     UINT TotalRowCount() const noexcept;
 
@@ -133,12 +148,12 @@ public:
     COORD BufferToScreenPosition(const COORD position) const;
 
     void Reset();
+    void Recycle(Microsoft::Console::Render::IRenderTarget& renderTarget,
+                 const TextAttribute defaultAttributes,
+                 const UINT cursorSize);
 
     [[nodiscard]] HRESULT ResizeTraditional(const COORD newSize) noexcept;
 
-    const UnicodeStorage& GetUnicodeStorage() const noexcept;
-    UnicodeStorage& GetUnicodeStorage() noexcept;
-
     Microsoft::Console::Render::IRenderTarget& GetRenderTarget() noexcept;
 
     const COORD GetWordStart(const COORD target, const std::wstring_view wordDelimiters, bool accessibilityMode = false) const;
@@ -163,9 +178,17 @@ public:
     class TextAndColor
     {
     public:
+        // A run of consecutive characters in a row of text that share the same colors.
+        struct ColorRun
+        {
+            size_t length;
+            COLORREF foreground;
+            COLORREF background;
+        };
+
         std::vector<std::wstring> text;
-        std::vector<std::vector<COLORREF>> FgAttr;
-        std::vector<std::vector<COLORREF>> BkAttr;
+        // One vector of runs for each row of text. Empty if no colors were requested.
+        std::vector<std::vector<ColorRun>> colorRuns;
     };
 
     const TextAndColor GetText(const bool includeCRLF,
@@ -184,6 +207,23 @@ public:
                               const std::wstring_view fontFaceName,
                               const COLORREF backgroundColor);
 
+    // The formats a buffer can be exported to a file in. Unlike GenHTML and
+    // GenRTF, exports are generated a chunk of rows at a time, so that they
+    // don't need to hold the text of the entire buffer in memory.
+    enum class ExportFormat
+    {
+        Text,
+        Vt,
+        Html
+    };
+
+    static std::string GenExportPrologue(const ExportFormat format,
+                                         const int fontHeightPoints,
+                                         const std::wstring_view fontFaceName,
+                                         const COLORREF backgroundColor);
+    static void AppendExportRows(std::string& out, const TextAndColor& rows, const ExportFormat format);
+    static std::string_view GenExportEpilogue(const ExportFormat format) noexcept;
+
     struct PositionInformation
     {
         short mutableViewportTop{ 0 };
@@ -200,28 +240,81 @@ public:
     void CopyPatterns(const TextBuffer& OtherBuffer);
     interval_tree::IntervalTree<til::point, size_t> GetPatterns(const size_t firstRow, const size_t lastRow) const;
 
+    TextAttributeTable& GetAttributeTable() noexcept { return _attributeTable; }
+
+    ImageCache& GetImageCache() noexcept { return _imageCache; }
+    void SetImageSlice(const SHORT row, const ImageSlice& imageSlice);
+    const ImageCache& GetImageCache() const noexcept { return _imageCache; }
+
+    void AddMark(const MarkCategory category, const til::point position, const std::optional<uint32_t> exitCode = std::nullopt);
+    void ClearMarks() noexcept;
+    std::vector<ScrollMark> GetMarks() const;
+    std::optional<ScrollMark> GetPreviousMark(const ptrdiff_t row, const MarkCategory category) const;
+    std::optional<ScrollMark> GetNextMark(const ptrdiff_t row, const MarkCategory category) const;
+    til::point GetMarkEnd(const ScrollMark& mark) const;
+
+    // The number of rows that have been rotated out of the buffer since it was created.
+    // Adding it to a row gives a position that doesn't change as the buffer circles.
+    ptrdiff_t GetRotatedRowCount() const noexcept { return _rotatedRowCount; }
+
+    // Snapshots are written from and restored into the rows, attributes and hyperlinks directly.
+    friend class TextBufferSnapshot;
+
 private:
     void _UpdateSize();
     Microsoft::Console::Types::Viewport _size;
+
+    // Optional contiguous backing store for the cells of rows that are too wide
+    // to fit into CharRow's inline storage. It must be declared before _storage
+    // so that it outlives the rows allocated from it.
+    std::optional<std::pmr::monotonic_buffer_resource> _rowArena;
+    // Hands out the arena's memory to the rows and reuses the cells they free.
+    // It's only used under the buffer's write lock or the thaw lock (see CharRow::Thaw).
+    std::optional<std::pmr::unsynchronized_pool_resource> _rowPool;
+    std::pmr::memory_resource* _GetRowResource() noexcept;
+
+    // Where rows further than _residentRowCount from the bottom of the buffer
+    // are moved to. Just like the arena, it has to outlive _storage.
+    std::unique_ptr<RowSpillFile> _spillFile;
+
+    // Rows restored from a snapshot read their text from it once they're
+    // thawed, so the snapshot has to outlive _storage as well.
+    std::shared_ptr<TextBufferSnapshot> _snapshot;
+
+    // Interns the attributes of all rows, which only store their ids. It has
+    // to outlive _storage as well, since the rows point to it.
+    TextAttributeTable _attributeTable;
+
     std::vector<ROW> _storage;
     Cursor _cursor;
 
-    SHORT _firstRow; // indexes top row (not necessarily 0)
+    size_t _firstRow; // indexes top row (not necessarily 0)
 
     TextAttribute _currentAttributes;
 
-    // storage location for glyphs that can't fit into the buffer normally
-    UnicodeStorage _unicodeStorage;
+    ImageCache _imageCache;
 
     std::unordered_map<uint16_t, std::wstring> _hyperlinkMap;
     std::unordered_map<std::wstring, uint16_t> _hyperlinkCustomIdMap;
     uint16_t _currentHyperlinkId;
 
+    // Rows further than this from the bottom of the buffer get frozen. 0 disables freezing.
+    size_t _hotRowCount;
+    // Rows further than this from the bottom of the buffer get spilled to disk. 0 disables spilling.
+    size_t _residentRowCount;
+    // CharRow::ThawCount() as of the last RefreezeColdRows().
+    size_t _refrozenThawCount{ 0 };
+    void _FreezeColdRows();
+    void _SpillColdRows();
+
     void _RefreshRowIDs(std::optional<SHORT> newRowWidth);
+    void _ReverseRows(size_t first, size_t last);
+    void _ClearSplitGlyphs(ROW& row, const SHORT left, const SHORT right);
 
-    Microsoft::Console::Render::IRenderTarget& _renderTarget;
+    // A pointer rather than a reference, since recycled buffers get a new one.
+    Microsoft::Console::Render::IRenderTarget* _renderTarget;
 
-    void _SetFirstRowIndex(const SHORT FirstRowIndex) noexcept;
+    void _SetFirstRowIndex(const size_t FirstRowIndex) noexcept;
 
     COORD _GetPreviousFromCursor() const;
 
@@ -238,18 +331,57 @@ private:
     ROW& _GetPrevRowNoWrap(const ROW& row);
 
     void _ExpandTextRow(SMALL_RECT& selectionRow) const;
-
-    const DelimiterClass _GetDelimiterClassAt(const COORD pos, const std::wstring_view wordDelimiters) const;
-    const COORD _GetWordStartForAccessibility(const COORD target, const std::wstring_view wordDelimiters) const;
-    const COORD _GetWordStartForSelection(const COORD target, const std::wstring_view wordDelimiters) const;
-    const COORD _GetWordEndForAccessibility(const COORD target, const std::wstring_view wordDelimiters, const COORD lastCharPos) const;
-    const COORD _GetWordEndForSelection(const COORD target, const std::wstring_view wordDelimiters) const;
-
-    void _PruneHyperlinks();
-
-    std::unordered_map<size_t, std::wstring> _idsAndPatterns;
+    void _GetRowText(const SMALL_RECT& selectionRect,
+                     const bool appendCRLF,
+                     const bool trimTrailingWhitespace,
+                     const std::function<std::pair<COLORREF, COLORREF>(const TextAttribute&)>& GetAttributeColors,
+                     const bool formatWrappedRows,
+                     std::wstring& selectionText,
+                     std::vector<TextAndColor::ColorRun>* const selectionRuns) const;
+
+    const DelimiterClass _GetDelimiterClassAt(const COORD pos, const DelimiterSet& delimiters) const;
+    bool _SkipDelimiterClass(COORD& pos, const DelimiterClass delimiterClass, const bool skipEqual, const DelimiterSet& delimiters, const bool forward) const;
+    const COORD _GetWordStartForAccessibility(const COORD target, const DelimiterSet& delimiters) const;
+    const COORD _GetWordStartForSelection(const COORD target, const DelimiterSet& delimiters) const;
+    const COORD _GetWordEndForAccessibility(const COORD target, const DelimiterSet& delimiters, const COORD lastCharPos) const;
+    const COORD _GetWordEndForSelection(const COORD target, const DelimiterSet& delimiters) const;
+
+    void _PruneHyperlinks(const std::vector<uint16_t>& hyperlinks) noexcept;
+
+    // The patterns are compiled once, when they're added, since GetPatterns
+    // runs whenever the viewport's contents change.
+    std::unordered_map<size_t, std::wregex> _idsAndPatterns;
     size_t _currentPatternId;
 
+    // The result of the last GetPatterns call, along with the generation of
+    // every row it scanned. If none of those rows have changed since then,
+    // the result is returned as is instead of searching the rows again.
+    mutable std::vector<uint64_t> _patternCacheGenerations;
+    mutable interval_tree::IntervalTree<til::point, size_t>::interval_vector _patternCacheIntervals;
+
+    // The shell integration marks, sorted by position. Their rows count from
+    // the first row this buffer ever had, so that rotating the buffer doesn't
+    // have to touch them: _rotatedRowCount is the number of rows that have
+    // been rotated out since, and the row of a mark in the buffer is its row
+    // minus that. Marks on rows that are rotated out or erased are dropped.
+    std::deque<ScrollMark> _marks;
+    ptrdiff_t _rotatedRowCount;
+
+    // Clearing the whole buffer (or most of it) only counts up _clearGeneration.
+    // Any row whose clear generation is behind it is reset with _clearAttributes
+    // when it's accessed the next time. See EraseRows.
+    uint64_t _clearGeneration{ 0 };
+    TextAttribute _clearAttributes;
+    TextAttributeTable::Id _clearAttributesId{ TextAttributeTable::DefaultId };
+
+    bool _CanClearLazily(const TextAttribute& attrs) const noexcept;
+    void _ClearLazily(const TextAttribute& attrs);
+    void _ResetIfCleared(const ROW& row) const;
+
+    ScrollMark _ToBufferMark(const ScrollMark& mark) const noexcept;
+    std::deque<ScrollMark>::const_iterator _FirstMarkOnOrAfterRow(const ptrdiff_t row) const;
+    void _EraseMarks(const ptrdiff_t firstRow, const ptrdiff_t lastRow);
+
 #ifdef UNIT_TESTING
     friend class TextBufferTests;
     friend class UiaTextRangeTests;
@@ -45,7 +45,7 @@ TextBufferCellIterator::TextBufferCellIterator(const TextBuffer& buffer, COORD p
     // Throw if the coordinate is not limited to the inside of the given buffer.
     THROW_HR_IF(E_INVALIDARG, !limits.IsInBounds(pos));
 
-    _attrIter += pos.X;
+    _attrIter = _pRow->GetAttrRow().IteratorAt(gsl::narrow_cast<uint16_t>(pos.X));
 
     _GenerateView();
 }
@@ -174,7 +174,7 @@ TextBufferCellIterator& TextBufferCellIterator::operator+=(const ptrdiff_t& move
     {
         // cold path (_GenerateView is slow)
         _pRow = s_GetRow(_buffer, { newX, newY });
-        _attrIter = _pRow->GetAttrRow().cbegin() + newX;
+        _attrIter = _pRow->GetAttrRow().IteratorAt(gsl::narrow_cast<uint16_t>(newX));
         _pos.X = newX;
         _pos.Y = newY;
         _GenerateView();
@@ -294,11 +294,9 @@ void TextBufferCellIterator::_SetPos(const COORD newPos)
     if (newPos.Y != _pos.Y)
     {
         _pRow = s_GetRow(_buffer, newPos);
-        _attrIter = _pRow->GetAttrRow().cbegin();
-        _pos.X = 0;
+        _attrIter = _pRow->GetAttrRow().IteratorAt(gsl::narrow_cast<uint16_t>(newPos.X));
     }
-
-    if (newPos.X != _pos.X)
+    else if (newPos.X != _pos.X)
     {
         const auto diff = gsl::narrow_cast<ptrdiff_t>(newPos.X) - gsl::narrow_cast<ptrdiff_t>(_pos.X);
         _attrIter += diff;
@@ -358,3 +356,15 @@ COORD TextBufferCellIterator::Pos() const noexcept
 {
     return _pos;
 }
+
+// Routine Description:
+// - Returns the id under which the buffer stores the attribute of the current cell.
+//   Comparing ids is a lot cheaper than comparing the attributes themselves.
+// Arguments:
+// - <none> - Uses current position
+// Return Value:
+// - The id of the attribute. Two cells of the same buffer have equal ids if and only if their attributes are equal.
+TextAttributeTable::Id TextBufferCellIterator::GetAttributeId() const noexcept
+{
+    return _attrIter.GetAttributeId();
+}
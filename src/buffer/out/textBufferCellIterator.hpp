@@ -48,6 +48,7 @@ public:
     const OutputCellView* operator->() const noexcept;
 
     COORD Pos() const noexcept;
+    TextAttributeTable::Id GetAttributeId() const noexcept;
 
 protected:
     void _SetPos(const COORD newPos);
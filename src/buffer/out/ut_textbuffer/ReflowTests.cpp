@@ -746,21 +746,21 @@ class ReflowTests
             row.SetWrapForced(testRow.wrap);
 
             size_t j{};
-            for (auto it{ charRow.begin() }; it != charRow.end(); ++it)
+            for (size_t column{}; column < charRow.size(); ++column)
             {
                 // Yes, we're about to manually create a buffer. It is unpleasant.
                 const auto ch{ til::at(testRow.text, j) };
-                it->Char() = ch;
+                charRow.GlyphAt(column) = { &ch, 1 };
                 if (IsGlyphFullWidth(ch))
                 {
-                    it->DbcsAttr().SetLeading();
-                    it++;
-                    it->Char() = ch;
-                    it->DbcsAttr().SetTrailing();
+                    charRow.DbcsAttrAt(column).SetLeading();
+                    column++;
+                    charRow.GlyphAt(column) = { &ch, 1 };
+                    charRow.DbcsAttrAt(column).SetTrailing();
                 }
                 else
                 {
-                    it->DbcsAttr().SetSingle();
+                    charRow.DbcsAttrAt(column).SetSingle();
                 }
                 j++;
             }
@@ -795,27 +795,27 @@ class ReflowTests
             VERIFY_ARE_EQUAL(testRow.wrap, row.WasWrapForced(), indexString);
 
             size_t j{};
-            for (auto it{ charRow.begin() }; it != charRow.end(); ++it)
+            for (size_t column{}; column < charRow.size(); ++column)
             {
-                indexString.Format(L"[Cell %d, %d; Text line index %d]", it - charRow.begin(), i, j);
+                indexString.Format(L"[Cell %d, %d; Text line index %d]", column, i, j);
                 // Yes, we're about to manually create a buffer. It is unpleasant.
                 const auto ch{ til::at(testRow.text, j) };
                 if (IsGlyphFullWidth(ch))
                 {
                     // Char is full width in test buffer, so
                     // ensure that real buffer is LEAD, TRAIL (ch)
-                    VERIFY_IS_TRUE(it->DbcsAttr().IsLeading(), indexString);
-                    VERIFY_ARE_EQUAL(ch, it->Char(), indexString);
+                    VERIFY_IS_TRUE(charRow.DbcsAttrAt(column).IsLeading(), indexString);
+                    VERIFY_ARE_EQUAL(ch, *charRow.GlyphAt(column).begin(), indexString);
 
-                    it++;
-                    VERIFY_IS_TRUE(it->DbcsAttr().IsTrailing(), indexString);
+                    column++;
+                    VERIFY_IS_TRUE(charRow.DbcsAttrAt(column).IsTrailing(), indexString);
                 }
                 else
                 {
-                    VERIFY_IS_TRUE(it->DbcsAttr().IsSingle(), indexString);
+                    VERIFY_IS_TRUE(charRow.DbcsAttrAt(column).IsSingle(), indexString);
                 }
 
-                VERIFY_ARE_EQUAL(ch, it->Char(), indexString);
+                VERIFY_ARE_EQUAL(ch, *charRow.GlyphAt(column).begin(), indexString);
                 j++;
             }
             i++;
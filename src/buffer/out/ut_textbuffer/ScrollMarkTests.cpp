@@ -0,0 +1,103 @@
+// Copyright (c) Microsoft Corporation.
+// Licensed under the MIT license.
+
+#include "precomp.h"
+#include "WexTestClass.h"
+#include "../../inc/consoletaeftemplates.hpp"
+
+#include "../textBuffer.hpp"
+#include "../../renderer/inc/DummyRenderTarget.hpp"
+
+using namespace WEX::Common;
+using namespace WEX::Logging;
+using namespace WEX::TestExecution;
+
+class ScrollMarkTests
+{
+    TEST_CLASS(ScrollMarkTests);
+
+    TEST_METHOD(FindsMarksAroundRow);
+    TEST_METHOD(KeepsMarksSortedWhenAddedOutOfOrder);
+    TEST_METHOD(MovesMarksWithRotation);
+    TEST_METHOD(MovesMarksWithScrolledRows);
+    TEST_METHOD(EndsOutputAtNextPrompt);
+
+    DummyRenderTarget _target;
+};
+
+void ScrollMarkTests::FindsMarksAroundRow()
+{
+    TextBuffer buffer{ { 20, 10 }, TextAttribute{ 0x7 }, 0, _target };
+    buffer.AddMark(MarkCategory::Prompt, { 0, 1 });
+    buffer.AddMark(MarkCategory::Output, { 0, 2 });
+    buffer.AddMark(MarkCategory::Prompt, { 0, 5 });
+
+    VERIFY_IS_FALSE(buffer.GetPreviousMark(1, MarkCategory::Prompt).has_value());
+    VERIFY_ARE_EQUAL(til::point(0, 1), buffer.GetPreviousMark(5, MarkCategory::Prompt)->start);
+    VERIFY_ARE_EQUAL(til::point(0, 5), buffer.GetNextMark(1, MarkCategory::Prompt)->start);
+    VERIFY_IS_FALSE(buffer.GetNextMark(5, MarkCategory::Prompt).has_value());
+    VERIFY_ARE_EQUAL(til::point(0, 2), buffer.GetNextMark(0, MarkCategory::Output)->start);
+}
+
+void ScrollMarkTests::KeepsMarksSortedWhenAddedOutOfOrder()
+{
+    TextBuffer buffer{ { 20, 10 }, TextAttribute{ 0x7 }, 0, _target };
+    buffer.AddMark(MarkCategory::Prompt, { 0, 4 });
+    buffer.AddMark(MarkCategory::Prompt, { 0, 1 });
+    buffer.AddMark(MarkCategory::Prompt, { 3, 1 });
+
+    const auto marks = buffer.GetMarks();
+    VERIFY_ARE_EQUAL(3u, marks.size());
+    VERIFY_ARE_EQUAL(til::point(0, 1), marks.at(0).start);
+    VERIFY_ARE_EQUAL(til::point(3, 1), marks.at(1).start);
+    VERIFY_ARE_EQUAL(til::point(0, 4), marks.at(2).start);
+}
+
+void ScrollMarkTests::MovesMarksWithRotation()
+{
+    TextBuffer buffer{ { 20, 10 }, TextAttribute{ 0x7 }, 0, _target };
+    buffer.AddMark(MarkCategory::Prompt, { 0, 0 });
+    buffer.AddMark(MarkCategory::Prompt, { 0, 3 });
+
+    // The mark on the first row is rotated out along with it.
+    VERIFY_IS_TRUE(buffer.IncrementCircularBuffer());
+    VERIFY_IS_TRUE(buffer.IncrementCircularBuffer());
+
+    const auto marks = buffer.GetMarks();
+    VERIFY_ARE_EQUAL(1u, marks.size());
+    VERIFY_ARE_EQUAL(til::point(0, 1), marks.at(0).start);
+}
+
+void ScrollMarkTests::MovesMarksWithScrolledRows()
+{
+    TextBuffer buffer{ { 20, 10 }, TextAttribute{ 0x7 }, 0, _target };
+    buffer.AddMark(MarkCategory::Prompt, { 0, 2 });
+    buffer.AddMark(MarkCategory::Prompt, { 0, 6 });
+
+    // Rows 5 to 7 move up to row 3, and rows 3 and 4 end up below them.
+    buffer.ScrollRows(5, 3, -2);
+
+    const auto marks = buffer.GetMarks();
+    VERIFY_ARE_EQUAL(2u, marks.size());
+    VERIFY_ARE_EQUAL(til::point(0, 2), marks.at(0).start);
+    VERIFY_ARE_EQUAL(til::point(0, 4), marks.at(1).start);
+}
+
+void ScrollMarkTests::EndsOutputAtNextPrompt()
+{
+    TextBuffer buffer{ { 20, 10 }, TextAttribute{ 0x7 }, 0, _target };
+    buffer.AddMark(MarkCategory::Prompt, { 0, 0 });
+    buffer.AddMark(MarkCategory::Output, { 0, 1 });
+    buffer.AddMark(MarkCategory::CommandFinished, { 0, 4 }, 1u);
+    buffer.AddMark(MarkCategory::Prompt, { 0, 4 });
+    buffer.AddMark(MarkCategory::Output, { 0, 5 });
+    buffer.GetCursor().SetPosition({ 0, 8 });
+
+    const auto first = buffer.GetNextMark(0, MarkCategory::Output);
+    VERIFY_ARE_EQUAL(til::point(0, 4), buffer.GetMarkEnd(*first));
+    VERIFY_ARE_EQUAL(1u, buffer.GetPreviousMark(5, MarkCategory::CommandFinished)->exitCode.value());
+
+    // The output of the last command ends at the cursor.
+    const auto last = buffer.GetNextMark(4, MarkCategory::Output);
+    VERIFY_ARE_EQUAL(til::point(0, 8), buffer.GetMarkEnd(*last));
+}
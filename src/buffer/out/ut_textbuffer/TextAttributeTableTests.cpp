@@ -0,0 +1,100 @@
+// Copyright (c) Microsoft Corporation.
+// Licensed under the MIT license.
+
+#include "precomp.h"
+#include "WexTestClass.h"
+#include "../../inc/consoletaeftemplates.hpp"
+
+#include "../TextAttributeTable.hpp"
+
+using namespace WEX::Common;
+using namespace WEX::Logging;
+using namespace WEX::TestExecution;
+
+class TextAttributeTableTests
+{
+    TEST_CLASS(TextAttributeTableTests);
+
+    TEST_METHOD(InternsEqualAttributesOnce);
+    TEST_METHOD(ReusesIdsThatAreNotInUse);
+    TEST_METHOD(FallsBackToDefaultWhenFull);
+
+    static TextAttribute s_MakeAttribute(const size_t index)
+    {
+        TextAttribute attr;
+        attr.SetForeground(RGB(index & 0xFF, (index >> 8) & 0xFF, (index >> 16) & 0xFF));
+        return attr;
+    }
+};
+
+void TextAttributeTableTests::InternsEqualAttributesOnce()
+{
+    TextAttributeTable table;
+    VERIFY_ARE_EQUAL(1u, table.Size());
+    VERIFY_ARE_EQUAL(TextAttributeTable::DefaultId, table.Intern(TextAttribute{}));
+
+    const auto red = s_MakeAttribute(0xFF);
+    const auto green = s_MakeAttribute(0xFF00);
+
+    const auto redId = table.Intern(red);
+    const auto greenId = table.Intern(green);
+    VERIFY_ARE_NOT_EQUAL(redId, greenId);
+    VERIFY_ARE_NOT_EQUAL(TextAttributeTable::DefaultId, redId);
+    VERIFY_ARE_EQUAL(3u, table.Size());
+
+    Log::Comment(L"Interning an attribute again must return the same id.");
+    VERIFY_ARE_EQUAL(redId, table.Intern(s_MakeAttribute(0xFF)));
+    VERIFY_ARE_EQUAL(3u, table.Size());
+
+    VERIFY_ARE_EQUAL(red, table.Get(redId));
+    VERIFY_ARE_EQUAL(green, table.Get(greenId));
+    VERIFY_ARE_EQUAL(greenId, table.Find(green).value());
+    VERIFY_IS_FALSE(table.Find(s_MakeAttribute(0xFF0000)).has_value());
+}
+
+void TextAttributeTableTests::ReusesIdsThatAreNotInUse()
+{
+    TextAttributeTable table;
+
+    std::vector<TextAttributeTable::Id> ids;
+    for (size_t i = 1; i < TextAttributeTable::MaxSize; i++)
+    {
+        ids.emplace_back(table.Intern(s_MakeAttribute(i)));
+    }
+    VERIFY_ARE_EQUAL(TextAttributeTable::MaxSize, table.Size());
+
+    // Only the first of the attributes we interned is still in use.
+    size_t collections = 0;
+    table.SetMarkInUseCallback([&](std::vector<bool>& inUse) {
+        collections++;
+        inUse.at(ids.front()) = true;
+    });
+
+    Log::Comment(L"A full table has to drop the attributes that aren't in use anymore.");
+    const auto attr = s_MakeAttribute(TextAttributeTable::MaxSize);
+    const auto id = table.Intern(attr);
+    VERIFY_ARE_EQUAL(1u, collections);
+    VERIFY_ARE_EQUAL(3u, table.Size());
+    VERIFY_ARE_EQUAL(attr, table.Get(id));
+
+    Log::Comment(L"The attributes that were in use keep their ids.");
+    VERIFY_ARE_EQUAL(ids.front(), table.Find(s_MakeAttribute(1)).value());
+    VERIFY_IS_FALSE(table.Find(s_MakeAttribute(2)).has_value());
+
+    Log::Comment(L"There's room again, so no more collections are necessary.");
+    table.Intern(s_MakeAttribute(2));
+    VERIFY_ARE_EQUAL(1u, collections);
+}
+
+void TextAttributeTableTests::FallsBackToDefaultWhenFull()
+{
+    TextAttributeTable table;
+    for (size_t i = 1; i < TextAttributeTable::MaxSize; i++)
+    {
+        table.Intern(s_MakeAttribute(i));
+    }
+
+    // Without a callback, nothing can be evicted.
+    VERIFY_ARE_EQUAL(TextAttributeTable::DefaultId, table.Intern(s_MakeAttribute(TextAttributeTable::MaxSize)));
+    VERIFY_ARE_EQUAL(TextAttributeTable::MaxSize, table.Size());
+}
@@ -0,0 +1,132 @@
+// Copyright (c) Microsoft Corporation.
+// Licensed under the MIT license.
+
+#include "precomp.h"
+#include "WexTestClass.h"
+#include "../../inc/consoletaeftemplates.hpp"
+
+#include "../textBuffer.hpp"
+#include "../TextBufferSnapshot.hpp"
+#include "../../renderer/inc/DummyRenderTarget.hpp"
+
+using namespace WEX::Common;
+using namespace WEX::Logging;
+using namespace WEX::TestExecution;
+
+class TextBufferSnapshotTests
+{
+    TEST_CLASS(TextBufferSnapshotTests);
+
+    TEST_METHOD(RoundTripsRows);
+    TEST_METHOD(RejectsCorruptSnapshots);
+
+    static std::wstring s_GetTempFileName()
+    {
+        wchar_t tempPath[MAX_PATH + 1];
+        VERIFY_ARE_NOT_EQUAL(0u, GetTempPathW(ARRAYSIZE(tempPath), tempPath));
+        wchar_t tempFile[MAX_PATH + 1];
+        VERIFY_ARE_NOT_EQUAL(0u, GetTempFileNameW(tempPath, L"wts", 0, tempFile));
+        return tempFile;
+    }
+
+    static void s_WriteSnapshot(const TextBuffer& buffer, const std::wstring& path)
+    {
+        wil::unique_hfile file{ CreateFileW(path.c_str(), GENERIC_WRITE, 0, nullptr, CREATE_ALWAYS, FILE_ATTRIBUTE_NORMAL, nullptr) };
+        VERIFY_IS_TRUE(file.is_valid());
+        TextBufferSnapshot::Write(buffer, file.get());
+    }
+
+    static std::wstring s_GetRowText(const TextBuffer& buffer, const size_t row)
+    {
+        std::wstring text;
+        for (const auto& cell : buffer.GetRowByOffset(row).GetCharRow())
+        {
+            text.push_back(cell.Char());
+        }
+        return text;
+    }
+
+    DummyRenderTarget _target;
+};
+
+void TextBufferSnapshotTests::RoundTripsRows()
+{
+    const COORD size{ 20, 10 };
+    TextBuffer original{ size, TextAttribute{ 0x7 }, 0, _target };
+
+    TextAttribute red{ 0x7 };
+    red.SetForeground(RGB(255, 0, 0));
+    TextAttribute link{ 0x7 };
+    link.SetHyperlinkId(original.GetHyperlinkId(L"https://example.com", L"custom"));
+    original.AddHyperlinkToMap(L"https://example.com", link.GetHyperlinkId());
+
+    original.WriteLine(OutputCellIterator{ L"plain" }, { 0, 0 });
+    original.WriteLine(OutputCellIterator{ L"red", red }, { 2, 1 });
+    original.WriteLine(OutputCellIterator{ L"wrapped row wrapped!" }, { 0, 2 }, true);
+    original.WriteLine(OutputCellIterator{ L"link", link }, { 0, 3 });
+    original.WriteLine(OutputCellIterator{ L"\U0001F600" }, { 0, 4 });
+    original.GetRowByOffset(5).SetLineRendition(LineRendition::DoubleWidth);
+    original.WriteLine(OutputCellIterator{ L"bottom" }, { 0, 9 });
+
+    const auto path = s_GetTempFileName();
+    const auto cleanup = wil::scope_exit([&]() { DeleteFileW(path.c_str()); });
+    s_WriteSnapshot(original, path);
+
+    auto snapshot = std::make_shared<TextBufferSnapshot>(path);
+    VERIFY_ARE_EQUAL(size, snapshot->GetSize());
+
+    TextBuffer restored{ size, TextAttribute{ 0x7 }, 0, _target };
+    TextBufferSnapshot::Restore(snapshot, restored, 8, 10);
+    snapshot.reset();
+
+    Log::Comment(L"Only the rows in the given range are inflated right away.");
+    for (size_t row = 0; row < 8; row++)
+    {
+        VERIFY_IS_TRUE(restored.GetRowByOffset(row).IsFrozen());
+    }
+    VERIFY_IS_FALSE(restored.GetRowByOffset(8).IsFrozen());
+    VERIFY_IS_FALSE(restored.GetRowByOffset(9).IsFrozen());
+
+    for (size_t row = 0; row < gsl::narrow_cast<size_t>(size.Y); row++)
+    {
+        const auto& expected = original.GetRowByOffset(row);
+        const auto& actual = restored.GetRowByOffset(row);
+        VERIFY_ARE_EQUAL(s_GetRowText(original, row), s_GetRowText(restored, row));
+        VERIFY_ARE_EQUAL(expected.WasWrapForced(), actual.WasWrapForced());
+        VERIFY_ARE_EQUAL(expected.GetLineRendition(), actual.GetLineRendition());
+        VERIFY_IS_TRUE(std::equal(expected.GetAttrRow().begin(), expected.GetAttrRow().end(), actual.GetAttrRow().begin(), actual.GetAttrRow().end()));
+    }
+
+    Log::Comment(L"Glyphs that don't fit into a cell and hyperlinks are restored too.");
+    VERIFY_ARE_EQUAL(L"\U0001F600", std::wstring{ restored.GetCellDataAt({ 0, 4 })->Chars() });
+    VERIFY_ARE_EQUAL(L"https://example.com", restored.GetHyperlinkUriFromId(link.GetHyperlinkId()));
+    VERIFY_ARE_EQUAL(link.GetHyperlinkId(), restored.GetHyperlinkId(L"https://example.com", L"custom"));
+}
+
+void TextBufferSnapshotTests::RejectsCorruptSnapshots()
+{
+    TextBuffer buffer{ { 20, 10 }, TextAttribute{ 0x7 }, 0, _target };
+    buffer.WriteLine(OutputCellIterator{ L"text" }, { 0, 0 });
+
+    const auto path = s_GetTempFileName();
+    const auto cleanup = wil::scope_exit([&]() { DeleteFileW(path.c_str()); });
+    s_WriteSnapshot(buffer, path);
+
+    Log::Comment(L"Cutting the file short must be detected when it's opened.");
+    {
+        wil::unique_hfile file{ CreateFileW(path.c_str(), GENERIC_WRITE, 0, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr) };
+        VERIFY_IS_TRUE(file.is_valid());
+        LARGE_INTEGER size{};
+        VERIFY_WIN32_BOOL_SUCCEEDED(GetFileSizeEx(file.get(), &size));
+        size.QuadPart -= 4;
+        VERIFY_WIN32_BOOL_SUCCEEDED(SetFilePointerEx(file.get(), size, nullptr, FILE_BEGIN));
+        VERIFY_WIN32_BOOL_SUCCEEDED(SetEndOfFile(file.get()));
+    }
+    VERIFY_THROWS(TextBufferSnapshot{ path }, wil::ResultException);
+
+    Log::Comment(L"Snapshots can't be restored into buffers of a different width.");
+    s_WriteSnapshot(buffer, path);
+    const auto snapshot = std::make_shared<TextBufferSnapshot>(path);
+    TextBuffer narrower{ { 10, 10 }, TextAttribute{ 0x7 }, 0, _target };
+    VERIFY_THROWS(TextBufferSnapshot::Restore(snapshot, narrower, 0, 10), wil::ResultException);
+}
@@ -18,17 +18,16 @@ class UnicodeStorageTests
     TEST_METHOD(CanOverwriteEmoji)
     {
         UnicodeStorage storage;
-        const COORD coord{ 1, 3 };
+        const UnicodeStorage::key_type column{ 1 };
         const std::vector<wchar_t> newMoon{ 0xD83C, 0xDF11 };
         const std::vector<wchar_t> fullMoon{ 0xD83C, 0xDF15 };
 
         // store initial glyph
-        storage.StoreGlyph(coord, newMoon);
+        storage.StoreGlyph(column, newMoon);
 
         // verify it was stored
-        auto findIt = storage._map.find(coord);
-        VERIFY_ARE_NOT_EQUAL(findIt, storage._map.end());
-        const std::vector<wchar_t>& newMoonGlyph = findIt->second;
+        VERIFY_ARE_EQUAL(1u, storage._glyphs.size());
+        const std::vector<wchar_t>& newMoonGlyph = storage.GetText(column);
         VERIFY_ARE_EQUAL(newMoonGlyph.size(), newMoon.size());
         for (size_t i = 0; i < newMoon.size(); ++i)
         {
@@ -36,16 +35,55 @@ class UnicodeStorageTests
         }
 
         // overwrite it
-        storage.StoreGlyph(coord, fullMoon);
+        storage.StoreGlyph(column, fullMoon);
 
         // verify the glyph was overwritten
-        findIt = storage._map.find(coord);
-        VERIFY_ARE_NOT_EQUAL(findIt, storage._map.end());
-        const std::vector<wchar_t>& fullMoonGlyph = findIt->second;
+        VERIFY_ARE_EQUAL(1u, storage._glyphs.size());
+        const std::vector<wchar_t>& fullMoonGlyph = storage.GetText(column);
         VERIFY_ARE_EQUAL(fullMoonGlyph.size(), fullMoon.size());
         for (size_t i = 0; i < fullMoon.size(); ++i)
         {
             VERIFY_ARE_EQUAL(fullMoonGlyph.at(i), fullMoon.at(i));
         }
     }
+
+    TEST_METHOD(KeepsGlyphsSortedByColumn)
+    {
+        UnicodeStorage storage;
+        const std::vector<wchar_t> newMoon{ 0xD83C, 0xDF11 };
+        const std::vector<wchar_t> fullMoon{ 0xD83C, 0xDF15 };
+        const std::vector<wchar_t> crescentMoon{ 0xD83C, 0xDF19 };
+
+        // store them out of order
+        storage.StoreGlyph(7, fullMoon);
+        storage.StoreGlyph(2, newMoon);
+        storage.StoreGlyph(12, crescentMoon);
+
+        // a view of a glyph should survive other glyphs being stored around it
+        const auto fullMoonData = storage.GetText(7).data();
+        storage.StoreGlyph(5, newMoon);
+        VERIFY_ARE_EQUAL(fullMoonData, storage.GetText(7).data());
+
+        VERIFY_ARE_EQUAL(4u, storage._glyphs.size());
+        VERIFY_IS_TRUE(std::is_sorted(storage._glyphs.cbegin(), storage._glyphs.cend(), [](const auto& a, const auto& b) {
+            return a.first < b.first;
+        }));
+        VERIFY_IS_TRUE(storage.GetText(2) == newMoon);
+        VERIFY_IS_TRUE(storage.GetText(12) == crescentMoon);
+        VERIFY_THROWS(storage.GetText(3), std::out_of_range);
+
+        // erasing an unstored column does nothing
+        storage.Erase(3);
+        VERIFY_ARE_EQUAL(4u, storage._glyphs.size());
+        storage.Erase(5);
+        VERIFY_ARE_EQUAL(3u, storage._glyphs.size());
+
+        // truncating drops everything at or beyond the width
+        storage.Truncate(7);
+        VERIFY_ARE_EQUAL(1u, storage._glyphs.size());
+        VERIFY_IS_TRUE(storage.GetText(2) == newMoon);
+
+        storage.Clear();
+        VERIFY_IS_TRUE(storage.empty());
+    }
 };
@@ -44,6 +44,7 @@ namespace SettingsModelLocalTests
         TEST_METHOD(LayerScancodeKeybindings);
 
         TEST_METHOD(TestExplicitUnbind);
+        TEST_METHOD(TestInheritedKeyChords);
 
         TEST_METHOD(TestArbitraryArgs);
         TEST_METHOD(TestSplitPaneArgs);
@@ -272,6 +273,39 @@ namespace SettingsModelLocalTests
         VERIFY_IS_FALSE(actionMap->IsKeyChordExplicitlyUnbound(keyChord));
     }
 
+    void KeyBindingsTests::TestInheritedKeyChords()
+    {
+        const std::string parentString{ R"([ { "command": "copy", "keys": ["ctrl+c"] }, { "command": "paste", "keys": ["ctrl+v"] } ])" };
+        const std::string childString{ R"([ { "command": "unbound", "keys": ["ctrl+c"] }, { "command": "newTab", "keys": ["ctrl+t"] } ])" };
+
+        const KeyChord ctrlC{ VirtualKeyModifiers::Control, static_cast<int32_t>('C'), 0 };
+        const KeyChord ctrlV{ VirtualKeyModifiers::Control, static_cast<int32_t>('V'), 0 };
+        const KeyChord ctrlT{ VirtualKeyModifiers::Control, static_cast<int32_t>('T'), 0 };
+        const KeyChord ctrlX{ VirtualKeyModifiers::Control, static_cast<int32_t>('X'), 0 };
+
+        auto parent = winrt::make_self<implementation::ActionMap>();
+        parent->LayerJson(VerifyParseSucceeded(parentString));
+
+        auto child = winrt::make_self<implementation::ActionMap>();
+        child->InsertParent(parent);
+        child->LayerJson(VerifyParseSucceeded(childString));
+
+        Log::Comment(L"The innermost layer binding a key chord wins.");
+        VERIFY_IS_TRUE(child->IsKeyChordExplicitlyUnbound(ctrlC));
+        VERIFY_IS_NULL(child->GetActionByKeyChord(ctrlC));
+        VERIFY_ARE_EQUAL(ShortcutAction::PasteText, child->GetActionByKeyChord(ctrlV).ActionAndArgs().Action());
+        VERIFY_ARE_EQUAL(ShortcutAction::NewTab, child->GetActionByKeyChord(ctrlT).ActionAndArgs().Action());
+        VERIFY_IS_NULL(child->GetActionByKeyChord(ctrlX));
+        VERIFY_IS_FALSE(child->IsKeyChordExplicitlyUnbound(ctrlX));
+
+        Log::Comment(L"Changing the bindings after a lookup updates the lookups.");
+        child->RegisterKeyBinding(ctrlX, child->GetActionByKeyChord(ctrlV).ActionAndArgs());
+        child->DeleteKeyBinding(ctrlV);
+        VERIFY_ARE_EQUAL(ShortcutAction::PasteText, child->GetActionByKeyChord(ctrlX).ActionAndArgs().Action());
+        VERIFY_IS_TRUE(child->IsKeyChordExplicitlyUnbound(ctrlV));
+        VERIFY_ARE_EQUAL(ShortcutAction::PasteText, parent->GetActionByKeyChord(ctrlV).ActionAndArgs().Action());
+    }
+
     void KeyBindingsTests::TestArbitraryArgs()
     {
         const std::string bindings0String{ R"([
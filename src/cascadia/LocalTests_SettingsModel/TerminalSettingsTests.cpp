@@ -42,6 +42,8 @@ namespace SettingsModelLocalTests
 
         TEST_METHOD(TestLayerProfileOnColorScheme);
 
+        TEST_METHOD(TestIsEquivalentTo);
+
         TEST_CLASS_SETUP(ClassSetup)
         {
             return true;
@@ -554,4 +556,46 @@ namespace SettingsModelLocalTests
         VERIFY_ARE_EQUAL(ARGB(0, 0x45, 0x67, 0x89), terminalSettings4->CursorColor()); // from profile (no color scheme)
         VERIFY_ARE_EQUAL(DEFAULT_CURSOR_COLOR, terminalSettings5->CursorColor()); // default
     }
+
+    void TerminalSettingsTests::TestIsEquivalentTo()
+    {
+        const auto makeSettings = [](std::string_view profile) {
+            const auto settingsString = fmt::format(R"(
+            {{
+                "defaultProfile": "{{6239a42c-1111-49a3-80bd-e8fdd045185c}}",
+                "profiles": [
+                    {{
+                        "name" : "profile0",
+                        "guid": "{{6239a42c-1111-49a3-80bd-e8fdd045185c}}",
+                        {}
+                    }}
+                ]
+            }})",
+                                                    profile);
+            return CascadiaSettings{ til::u8u16(settingsString) };
+        };
+        const auto guid = ::Microsoft::Console::Utils::GuidFromString(L"{6239a42c-1111-49a3-80bd-e8fdd045185c}");
+
+        const auto settings0 = makeSettings(R"("font": { "face": "Cascadia Mono", "axes": { "wght": 400 } }, "tabColor": "#123456")");
+        const auto settings1 = makeSettings(R"("font": { "face": "Cascadia Mono", "axes": { "wght": 400 } }, "tabColor": "#123456")");
+        const auto settings2 = makeSettings(R"("font": { "face": "Cascadia Mono", "axes": { "wght": 500 } }, "tabColor": "#123456")");
+        const auto settings3 = makeSettings(R"("font": { "face": "Cascadia Mono", "axes": { "wght": 400 } }, "tabColor": "#654321")");
+
+        const auto terminalSettings0 = TerminalSettings::CreateWithProfileByID(settings0, guid, nullptr).DefaultSettings();
+        const auto terminalSettings1 = TerminalSettings::CreateWithProfileByID(settings1, guid, nullptr).DefaultSettings();
+        const auto terminalSettings2 = TerminalSettings::CreateWithProfileByID(settings2, guid, nullptr).DefaultSettings();
+        const auto terminalSettings3 = TerminalSettings::CreateWithProfileByID(settings3, guid, nullptr).DefaultSettings();
+
+        // Identical settings from different files are equivalent,
+        // even though their maps and references are different objects.
+        VERIFY_IS_TRUE(terminalSettings0.IsEquivalentTo(terminalSettings1));
+        VERIFY_IS_FALSE(terminalSettings0.IsEquivalentTo(terminalSettings2));
+        VERIFY_IS_FALSE(terminalSettings0.IsEquivalentTo(terminalSettings3));
+
+        // Values inherited from a parent count as well.
+        const auto child = TerminalSettings::CreateWithParent(TerminalSettings::CreateWithProfileByID(settings0, guid, nullptr)).DefaultSettings();
+        VERIFY_IS_TRUE(child.IsEquivalentTo(terminalSettings1));
+        child.HistorySize(1);
+        VERIFY_IS_FALSE(child.IsEquivalentTo(terminalSettings1));
+    }
 }
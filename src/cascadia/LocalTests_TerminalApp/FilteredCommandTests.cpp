@@ -24,6 +24,7 @@ namespace TerminalAppLocalTests
 
         TEST_METHOD(VerifyHighlighting);
         TEST_METHOD(VerifyWeight);
+        TEST_METHOD(VerifyUpdateFilter);
         TEST_METHOD(VerifyCompare);
         TEST_METHOD(VerifyCompareIgnoreCase);
     };
@@ -165,6 +166,48 @@ namespace TerminalAppLocalTests
         VERIFY_SUCCEEDED(result);
     }
 
+    void FilteredCommandTests::VerifyUpdateFilter()
+    {
+        auto result = RunOnUIThread([]() {
+            const auto paletteItem{ winrt::make<winrt::TerminalApp::implementation::CommandLinePaletteItem>(L"Split Pane") };
+            const auto filteredCommand = winrt::make_self<winrt::TerminalApp::implementation::FilteredCommand>(paletteItem);
+            {
+                Log::Comment(L"Testing a filter that matches");
+                filteredCommand->UpdateFilter(L"sp");
+                VERIFY_IS_GREATER_THAN(filteredCommand->Weight(), 0);
+                VERIFY_ARE_EQUAL(filteredCommand->HighlightedName().Segments().GetAt(0).TextSegment(), L"Sp");
+                VERIFY_IS_TRUE(filteredCommand->HighlightedName().Segments().GetAt(0).IsHighlighted());
+            }
+            {
+                Log::Comment(L"Testing a filter with a character that's not in the name");
+                filteredCommand->UpdateFilter(L"spx");
+                VERIFY_ARE_EQUAL(filteredCommand->Weight(), 0);
+                VERIFY_ARE_EQUAL(filteredCommand->HighlightedName().Segments().Size(), 1u);
+                VERIFY_ARE_EQUAL(filteredCommand->HighlightedName().Segments().GetAt(0).TextSegment(), L"Split Pane");
+                VERIFY_IS_FALSE(filteredCommand->HighlightedName().Segments().GetAt(0).IsHighlighted());
+            }
+            {
+                Log::Comment(L"Testing a filter that extends a filter that didn't match");
+                filteredCommand->UpdateFilter(L"spxp");
+                VERIFY_ARE_EQUAL(filteredCommand->Filter(), L"spxp");
+                VERIFY_ARE_EQUAL(filteredCommand->Weight(), 0);
+                VERIFY_IS_FALSE(filteredCommand->HighlightedName().Segments().GetAt(0).IsHighlighted());
+            }
+            {
+                Log::Comment(L"Testing a filter whose characters are all in the name, but out of order");
+                filteredCommand->UpdateFilter(L"ps");
+                VERIFY_ARE_EQUAL(filteredCommand->Weight(), 0);
+            }
+            {
+                Log::Comment(L"Testing that a shorter filter matches again");
+                filteredCommand->UpdateFilter(L"p");
+                VERIFY_IS_GREATER_THAN(filteredCommand->Weight(), 0);
+            }
+        });
+
+        VERIFY_SUCCEEDED(result);
+    }
+
     void FilteredCommandTests::VerifyCompare()
     {
         auto result = RunOnUIThread([]() {
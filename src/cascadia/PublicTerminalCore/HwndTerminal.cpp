@@ -380,6 +380,18 @@ void HwndTerminal::SendOutput(std::wstring_view data)
     _terminal->Write(data);
 }
 
+void HwndTerminal::SendOutputUtf8(std::string_view data)
+{
+    std::lock_guard guard{ _u8OutputLock };
+
+    // Like ConptyConnection, convert the output in one go and hand the
+    // whole chunk to the state machine, using the same buffer every time.
+    if (SUCCEEDED_LOG(til::u8u16(data, _u16Str, _u8State)) && !_u16Str.empty())
+    {
+        _terminal->Write(_u16Str);
+    }
+}
+
 HRESULT _stdcall CreateTerminal(HWND parentHwnd, _Out_ void** hwnd, _Out_ void** terminal)
 {
     // In order for UIA to hook up properly there needs to be a "static" window hosting the
@@ -428,6 +440,33 @@ void _stdcall TerminalSendOutput(void* terminal, LPCWSTR data)
     publicTerminal->SendOutput(data);
 }
 
+/// <summary>
+/// Writes output of the given length to the terminal. Unlike TerminalSendOutput,
+/// the data doesn't need to be NUL-terminated. This may be called from any thread.
+/// </summary>
+/// <param name="terminal">Terminal pointer.</param>
+/// <param name="data">The UTF-16 output.</param>
+/// <param name="length">The number of code units in data.</param>
+void _stdcall TerminalSendOutputUtf16(void* terminal, const wchar_t* data, uint32_t length)
+{
+    const auto publicTerminal = static_cast<HwndTerminal*>(terminal);
+    publicTerminal->SendOutput({ data, length });
+}
+
+/// <summary>
+/// Writes UTF-8 output of the given length to the terminal. Code points may
+/// be split across calls. This may be called from any thread, but the calls
+/// for one terminal must not overlap if their order matters.
+/// </summary>
+/// <param name="terminal">Terminal pointer.</param>
+/// <param name="data">The UTF-8 output.</param>
+/// <param name="length">The number of bytes in data.</param>
+void _stdcall TerminalSendOutputUtf8(void* terminal, const char* data, uint32_t length)
+{
+    const auto publicTerminal = static_cast<HwndTerminal*>(terminal);
+    publicTerminal->SendOutputUtf8({ data, length });
+}
+
 /// <summary>
 /// Triggers a terminal resize using the new width and height in pixel.
 /// </summary>
@@ -33,7 +33,8 @@ namespace winrt::Microsoft::Terminal::Remoting::implementation
     // in the tests. It's not exposed through the idl though
     // so it's not _truly_ fully public which should be acceptable.
     Monarch::Monarch(const uint64_t testPID) :
-        _ourPID{ testPID }
+        _ourPID{ testPID },
+        _watchPeasantProcesses{ false }
     {
     }
 
@@ -80,6 +81,15 @@ namespace winrt::Microsoft::Terminal::Remoting::implementation
             peasant.IdentifyWindowsRequested({ this, &Monarch::_identifyWindows });
             peasant.RenameRequested({ this, &Monarch::_renameRequested });
 
+            // Ask the peasant for its name once, and then let it tell us
+            // whenever that changes. Looking up windows by name thus never
+            // has to call out to any of the peasants.
+            peasant.WindowNameChanged([this, newPeasantsId](auto&&, const winrt::Windows::Foundation::IInspectable& args) {
+                _setPeasantName(newPeasantsId, winrt::unbox_value<winrt::hstring>(args));
+            });
+            _setPeasantName(newPeasantsId, peasant.WindowName());
+            _watchPeasantProcess(newPeasantsId, peasant.GetPID());
+
             peasant.ShowTrayIconRequested([this](auto&&, auto&&) { _ShowTrayIconRequestedHandlers(*this, nullptr); });
             peasant.HideTrayIconRequested([this](auto&&, auto&&) { _HideTrayIconRequestedHandlers(*this, nullptr); });
 
@@ -146,20 +156,158 @@ namespace winrt::Microsoft::Terminal::Remoting::implementation
         catch (...)
         {
             LOG_CAUGHT_EXCEPTION();
-            // Remove the peasant from the list of peasants
-            _peasants.erase(peasantID);
-
-            // Remove the peasant from the list of MRU windows. They're dead.
-            // They can't be the MRU anymore.
-            _clearOldMruEntries(peasantID);
+            // The peasant died without us getting notified about it. Forget about it.
+            _removePeasant(peasantID);
             return nullptr;
         }
     }
 
+    // Method Description:
+    // - Forget everything we know about the given peasant. It's removed from the
+    //   list of peasants, its name is free to be used by other windows again, and
+    //   it's removed from the list of MRU windows. They're dead. They can't be the
+    //   MRU anymore.
+    // Arguments:
+    // - peasantID: The ID of the peasant to remove
+    // Return Value:
+    // - <none>
+    void Monarch::_removePeasant(const uint64_t peasantID)
+    {
+        _peasants.erase(peasantID);
+        _setPeasantName(peasantID, {});
+        _peasantProcessWatches.erase(peasantID);
+        _clearOldMruEntries(peasantID);
+    }
+
+    // Method Description:
+    // - Update the name we've got on record for the given peasant. This is called
+    //   when the peasant is added, and whenever it tells us its name changed.
+    // Arguments:
+    // - peasantID: The ID of the peasant that was (re)named
+    // - name: The new name of the peasant. An empty name removes the old one.
+    // Return Value:
+    // - <none>
+    void Monarch::_setPeasantName(const uint64_t peasantID, const winrt::hstring& name)
+    {
+        if (const auto oldName = _peasantNames.find(peasantID); oldName != _peasantNames.end())
+        {
+            // Only forget about the old name if it still belongs to this peasant.
+            if (const auto owner = _peasantIdsByName.find(oldName->second); owner != _peasantIdsByName.end() && owner->second == peasantID)
+            {
+                _peasantIdsByName.erase(owner);
+            }
+            _peasantNames.erase(oldName);
+        }
+
+        if (!name.empty())
+        {
+            _peasantNames.emplace(peasantID, name);
+            _peasantIdsByName.insert_or_assign(name, peasantID);
+        }
+    }
+
+    // Method Description:
+    // - Get the name we've got on record for the given peasant.
+    // Arguments:
+    // - peasantID: The ID of the peasant
+    // Return Value:
+    // - the name of the peasant, or an empty string if it doesn't have one.
+    winrt::hstring Monarch::_getPeasantName(const uint64_t peasantID) const
+    {
+        const auto name = _peasantNames.find(peasantID);
+        return name == _peasantNames.end() ? winrt::hstring{} : name->second;
+    }
+
+    // Method Description:
+    // - Start waiting for the process of the given peasant to exit, so that we
+    //   learn about dead peasants when they die, rather than when we next fail
+    //   to call them. The wait callback only queues up the peasant ID, and
+    //   _removeExitedPeasants removes them the next time we go looking for
+    //   a window.
+    // - If we can't open the peasant's process, we'll still find out that it's
+    //   dead the hard way.
+    // Arguments:
+    // - peasantID: The ID of the peasant
+    // - pid: The ID of the peasant's process
+    // Return Value:
+    // - <none>
+    void Monarch::_watchPeasantProcess(const uint64_t peasantID, const uint64_t pid) noexcept
+    try
+    {
+        // When our own process exits, there's nobody left to tell about it.
+        if (!_watchPeasantProcesses || pid == _ourPID)
+        {
+            return;
+        }
+
+        auto watch = std::make_unique<PeasantProcessWatch>();
+        watch->monarch = this;
+        watch->peasantID = peasantID;
+
+        watch->process.reset(OpenProcess(SYNCHRONIZE, FALSE, gsl::narrow<DWORD>(pid)));
+        THROW_LAST_ERROR_IF(!watch->process);
+
+        watch->exitWait.reset(CreateThreadpoolWait(
+            [](PTP_CALLBACK_INSTANCE /*callbackInstance*/, PVOID context, PTP_WAIT /*wait*/, TP_WAIT_RESULT /*waitResult*/) noexcept {
+                const auto watch = static_cast<const PeasantProcessWatch*>(context);
+                watch->monarch->_peasantExited(watch->peasantID);
+            },
+            watch.get(),
+            nullptr));
+        THROW_LAST_ERROR_IF(!watch->exitWait);
+
+        SetThreadpoolWait(watch->exitWait.get(), watch->process.get(), nullptr);
+        _peasantProcessWatches.insert_or_assign(peasantID, std::move(watch));
+    }
+    CATCH_LOG()
+
+    // Method Description:
+    // - Called on a threadpool thread when the process of a peasant exited.
+    //   Queues up the peasant to be removed by _removeExitedPeasants.
+    // Arguments:
+    // - peasantID: The ID of the peasant whose process exited
+    // Return Value:
+    // - <none>
+    void Monarch::_peasantExited(const uint64_t peasantID) noexcept
+    try
+    {
+        const std::lock_guard guard{ _exitedPeasantsLock };
+        _exitedPeasants.emplace_back(peasantID);
+    }
+    CATCH_LOG()
+
+    // Method Description:
+    // - Remove all the peasants whose processes exited since we last checked.
+    // Arguments:
+    // - <none>
+    // Return Value:
+    // - <none>
+    void Monarch::_removeExitedPeasants()
+    {
+        std::vector<uint64_t> exitedPeasants;
+        {
+            const std::lock_guard guard{ _exitedPeasantsLock };
+            exitedPeasants.swap(_exitedPeasants);
+        }
+
+        // This has to happen outside of the lock: destroying a PeasantProcessWatch
+        // waits for its callback, which might be waiting for the lock itself.
+        for (const auto id : exitedPeasants)
+        {
+            TraceLoggingWrite(g_hRemotingProvider,
+                              "Monarch_PeasantExited",
+                              TraceLoggingUInt64(id, "peasantID", "The ID of the peasant whose process exited"),
+                              TraceLoggingLevel(WINEVENT_LEVEL_VERBOSE),
+                              TraceLoggingKeyword(TIL_KEYWORD_TRACE));
+            _removePeasant(id);
+        }
+    }
+
     // Method Description:
     // - Find the ID of the peasant with the given name. If no such peasant
-    //   exists, then we'll return 0. If we encounter any peasants who have died
-    //   during this process, then we'll remove them from the set of _peasants
+    //   exists, then we'll return 0. This only looks at the names the peasants
+    //   told us about, so it doesn't call out to any of them. The peasant might
+    //   still have died without us knowing yet, which _getPeasant will find out.
     // Arguments:
     // - name: The window name to look for
     // Return Value:
@@ -172,39 +320,10 @@ namespace winrt::Microsoft::Terminal::Remoting::implementation
             return 0;
         }
 
-        std::vector<uint64_t> peasantsToErase{};
-        uint64_t result = 0;
-        for (const auto& [id, p] : _peasants)
-        {
-            try
-            {
-                auto otherName = p.WindowName();
-                if (otherName == name)
-                {
-                    result = id;
-                    break;
-                }
-            }
-            catch (...)
-            {
-                LOG_CAUGHT_EXCEPTION();
-                // Normally, we'd just erase the peasant here. However, we can't
-                // erase from the map while we're iterating over it like this.
-                // Instead, pull a good ole Java and collect this id for removal
-                // later.
-                peasantsToErase.push_back(id);
-            }
-        }
+        _removeExitedPeasants();
 
-        // Remove the dead peasants we came across while iterating.
-        for (const auto& id : peasantsToErase)
-        {
-            // Remove the peasant from the list of peasants
-            _peasants.erase(id);
-            // Remove the peasant from the list of MRU windows. They're dead.
-            // They can't be the MRU anymore.
-            _clearOldMruEntries(id);
-        }
+        const auto found = _peasantIdsByName.find(winrt::hstring{ name });
+        const uint64_t result = found == _peasantIdsByName.end() ? 0 : found->second;
 
         TraceLoggingWrite(g_hRemotingProvider,
                           "Monarch_lookupPeasantIdForName",
@@ -331,6 +450,8 @@ namespace winrt::Microsoft::Terminal::Remoting::implementation
     // - the ID of the most recent peasant, otherwise 0 if we could not find one.
     uint64_t Monarch::_getMostRecentPeasantID(const bool limitToCurrentDesktop, const bool ignoreQuakeWindow)
     {
+        _removeExitedPeasants();
+
         if (_mruPeasants.empty())
         {
             // We haven't yet been told the MRU peasant. Just use the first one.
@@ -398,7 +519,7 @@ namespace winrt::Microsoft::Terminal::Remoting::implementation
                 continue;
             }
 
-            if (ignoreQuakeWindow && peasant.WindowName() == QuakeWindowName)
+            if (ignoreQuakeWindow && _getPeasantName(mruWindowArgs.PeasantID()) == QuakeWindowName)
             {
                 // The _quake window should never be treated as the MRU window.
                 // Skip it if we see it. Users can still target it with `wt -w
@@ -578,11 +699,14 @@ namespace winrt::Microsoft::Terminal::Remoting::implementation
                                   TraceLoggingKeyword(TIL_KEYWORD_TRACE));
                 return *result;
             }
-            else if (windowID > 0)
+            else if (windowID > 0 && targetWindow != WindowingBehaviorUseName)
             {
                 // In this case, an ID was provided, but there's no
                 // peasant with that ID. Instead, we should tell the caller that
                 // they should make a new window, but _with that ID_.
+                //
+                // This doesn't apply to names: if the window with that name
+                // just died, the new window only gets its name, not its ID.
 
                 TraceLoggingWrite(g_hRemotingProvider,
                                   "Monarch_ProposeCommandline_Existing",
@@ -806,37 +930,21 @@ namespace winrt::Microsoft::Terminal::Remoting::implementation
     }
 
     // Method Description:
-    // - This method creates a map of peasant IDs to peasant names
-    //   while removing dead peasants.
+    // - This method creates a map of peasant IDs to peasant names, from the
+    //   names the peasants told us about.
     // Arguments:
     // - <none>
     // Return Value:
     // - A map of peasant IDs to their names.
     Windows::Foundation::Collections::IMapView<uint64_t, winrt::hstring> Monarch::GetPeasantNames()
     {
-        auto names = winrt::single_threaded_map<uint64_t, winrt::hstring>();
+        _removeExitedPeasants();
 
-        std::vector<uint64_t> peasantsToErase{};
+        auto names = winrt::single_threaded_map<uint64_t, winrt::hstring>();
         for (const auto& [id, p] : _peasants)
         {
-            try
-            {
-                names.Insert(id, p.WindowName());
-            }
-            catch (...)
-            {
-                LOG_CAUGHT_EXCEPTION();
-                peasantsToErase.push_back(id);
-            }
+            names.Insert(id, _getPeasantName(id));
         }
-
-        // Remove the dead peasants we came across while iterating.
-        for (const auto& id : peasantsToErase)
-        {
-            _peasants.erase(id);
-            _clearOldMruEntries(id);
-        }
-
         return names.GetView();
     }
 
@@ -60,7 +60,18 @@ namespace winrt::Microsoft::Terminal::Remoting::implementation
         TYPED_EVENT(HideTrayIconRequested, winrt::Windows::Foundation::IInspectable, winrt::Windows::Foundation::IInspectable);
 
     private:
+        // Waits for the process of a peasant to exit. See _watchPeasantProcess.
+        struct PeasantProcessWatch
+        {
+            Monarch* monarch{ nullptr };
+            uint64_t peasantID{ 0 };
+            wil::unique_handle process;
+            wil::unique_threadpool_wait exitWait;
+        };
+
         uint64_t _ourPID;
+        // The unit tests make up the PIDs of their peasants.
+        bool _watchPeasantProcesses{ true };
 
         uint64_t _nextPeasantID{ 1 };
         uint64_t _thisPeasantID{ 0 };
@@ -68,12 +79,26 @@ namespace winrt::Microsoft::Terminal::Remoting::implementation
         winrt::com_ptr<IVirtualDesktopManager> _desktopManager{ nullptr };
 
         std::unordered_map<uint64_t, winrt::Microsoft::Terminal::Remoting::IPeasant> _peasants;
+        std::unordered_map<uint64_t, winrt::hstring> _peasantNames;
+        std::unordered_map<winrt::hstring, uint64_t> _peasantIdsByName;
+
+        std::mutex _exitedPeasantsLock;
+        std::vector<uint64_t> _exitedPeasants;
+        // Destroyed before the lock above, since their callbacks take it.
+        std::unordered_map<uint64_t, std::unique_ptr<PeasantProcessWatch>> _peasantProcessWatches;
 
         std::vector<Remoting::WindowActivatedArgs> _mruPeasants;
 
         winrt::Microsoft::Terminal::Remoting::IPeasant _getPeasant(uint64_t peasantID);
         uint64_t _getMostRecentPeasantID(bool limitToCurrentDesktop, const bool ignoreQuakeWindow);
         uint64_t _lookupPeasantIdForName(std::wstring_view name);
+        void _removePeasant(const uint64_t peasantID);
+        void _setPeasantName(const uint64_t peasantID, const winrt::hstring& name);
+        winrt::hstring _getPeasantName(const uint64_t peasantID) const;
+
+        void _watchPeasantProcess(const uint64_t peasantID, const uint64_t pid) noexcept;
+        void _peasantExited(const uint64_t peasantID) noexcept;
+        void _removeExitedPeasants();
 
         void _peasantWindowActivated(const winrt::Windows::Foundation::IInspectable& sender,
                                      const winrt::Microsoft::Terminal::Remoting::WindowActivatedArgs& args);
@@ -74,6 +74,36 @@ namespace winrt::Microsoft::Terminal::Remoting::implementation
         return _initialArgs;
     }
 
+    winrt::hstring Peasant::WindowName() const noexcept
+    {
+        return _windowName;
+    }
+
+    // Method Description:
+    // - Set our name, and let the monarch know about it. The monarch keeps
+    //   track of all the names, so that it doesn't have to ask every single
+    //   peasant for theirs when it looks for a window by name.
+    // Arguments:
+    // - name: our new name
+    // Return Value:
+    // - <none>
+    void Peasant::WindowName(const winrt::hstring& name)
+    {
+        _windowName = name;
+        try
+        {
+            // Try/catch this, because the other side of this event is handled
+            // by the monarch. The monarch might have died. If they have, this
+            // will throw an exception. Just eat it, the next monarch will ask
+            // us for our name when we're added to it.
+            _WindowNameChangedHandlers(*this, winrt::box_value(name));
+        }
+        catch (...)
+        {
+            LOG_CAUGHT_EXCEPTION();
+        }
+    }
+
     void Peasant::ActivateWindow(const Remoting::WindowActivatedArgs& args)
     {
         // TODO: projects/5 - somehow, pass an identifier for the current
@@ -197,7 +227,7 @@ namespace winrt::Microsoft::Terminal::Remoting::implementation
     void Peasant::RequestRename(const winrt::Microsoft::Terminal::Remoting::RenameRequestArgs& args)
     {
         bool successfullyNotified = false;
-        const auto oldName{ _WindowName };
+        const auto oldName{ _windowName };
         try
         {
             // Try/catch this, because the other side of this event is handled
@@ -207,7 +237,7 @@ namespace winrt::Microsoft::Terminal::Remoting::implementation
             _RenameRequestedHandlers(*this, args);
             if (args.Succeeded())
             {
-                _WindowName = args.NewName();
+                WindowName(args.NewName());
             }
             successfullyNotified = true;
         }
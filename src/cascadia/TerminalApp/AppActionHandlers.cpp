@@ -216,6 +216,17 @@ namespace winrt::TerminalApp::implementation
         args.Handled(true);
     }
 
+    void TerminalPage::_HandleToggleBroadcastInput(const IInspectable& /*sender*/,
+                                                   const ActionEventArgs& args)
+    {
+        if (const auto activeTab{ _GetFocusedTabImpl() })
+        {
+            activeTab->ToggleBroadcastInput();
+        }
+
+        args.Handled(true);
+    }
+
     void TerminalPage::_HandleScrollUpPage(const IInspectable& /*sender*/,
                                            const ActionEventArgs& args)
     {
@@ -256,6 +267,45 @@ namespace winrt::TerminalApp::implementation
             }
         }
     }
+
+    void TerminalPage::_HandleScrollToMark(const IInspectable& /*sender*/,
+                                           const ActionEventArgs& args)
+    {
+        if (const auto& realArgs = args.ActionArgs().try_as<ScrollToMarkArgs>())
+        {
+            if (const auto& control{ _GetActiveControl() })
+            {
+                control.ScrollToMark(realArgs.Direction() == ScrollToMarkDirection::Next);
+                args.Handled(true);
+            }
+        }
+    }
+
+    void TerminalPage::_HandleSelectOutput(const IInspectable& /*sender*/,
+                                           const ActionEventArgs& args)
+    {
+        if (const auto& realArgs = args.ActionArgs().try_as<SelectOutputArgs>())
+        {
+            if (const auto& control{ _GetActiveControl() })
+            {
+                control.SelectOutput(realArgs.Direction() == ScrollToMarkDirection::Next);
+                args.Handled(true);
+            }
+        }
+    }
+
+    void TerminalPage::_HandleExportBuffer(const IInspectable& /*sender*/,
+                                           const ActionEventArgs& args)
+    {
+        if (const auto& realArgs = args.ActionArgs().try_as<ExportBufferArgs>())
+        {
+            if (const auto& control{ _GetActiveControl() })
+            {
+                control.ExportBuffer(realArgs.Path(), realArgs.Format());
+                args.Handled(true);
+            }
+        }
+    }
     void TerminalPage::_HandleOpenSettings(const IInspectable& /*sender*/,
                                            const ActionEventArgs& args)
     {
@@ -405,6 +455,16 @@ namespace winrt::TerminalApp::implementation
         }
     }
 
+    void TerminalPage::_HandleToggleFrameStatistics(const IInspectable& /*sender*/,
+                                                    const ActionEventArgs& args)
+    {
+        if (const auto& termControl{ _GetActiveControl() })
+        {
+            termControl.ToggleFrameStatistics();
+            args.Handled(true);
+        }
+    }
+
     void TerminalPage::_HandleToggleFocusMode(const IInspectable& /*sender*/,
                                               const ActionEventArgs& args)
     {
@@ -649,6 +709,15 @@ namespace winrt::TerminalApp::implementation
         args.Handled(true);
     }
 
+    void TerminalPage::_HandleFindInAllTabs(const IInspectable& /*sender*/,
+                                            const ActionEventArgs& args)
+    {
+        CommandPalette().EnableBufferSearchMode();
+        CommandPalette().Visibility(Visibility::Visible);
+
+        args.Handled(true);
+    }
+
     void TerminalPage::_HandleMoveTab(const IInspectable& /*sender*/,
                                       const ActionEventArgs& actionArgs)
     {
@@ -1070,6 +1070,14 @@ namespace winrt::TerminalApp::implementation
         }
     }
 
+    void AppLogic::LiveResizeChanged(const bool liveResize)
+    {
+        if (_root)
+        {
+            _root->LiveResizeChanged(liveResize);
+        }
+    }
+
     // Method Description:
     // - Implements the F7 handler (per GH#638)
     // - Implements the Alt handler (per GH#6421)
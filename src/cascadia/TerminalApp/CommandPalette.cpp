@@ -5,6 +5,7 @@
 #include "ActionPaletteItem.h"
 #include "TabPaletteItem.h"
 #include "CommandLinePaletteItem.h"
+#include "SearchResultPaletteItem.h"
 #include "CommandPalette.h"
 #include <LibraryResources.h>
 
@@ -37,6 +38,7 @@ namespace winrt::TerminalApp::implementation
         _tabActions = winrt::single_threaded_vector<winrt::TerminalApp::FilteredCommand>();
         _mruTabActions = winrt::single_threaded_vector<winrt::TerminalApp::FilteredCommand>();
         _commandLineHistory = winrt::single_threaded_vector<winrt::TerminalApp::FilteredCommand>();
+        _bufferSearchResults = winrt::single_threaded_vector<winrt::TerminalApp::FilteredCommand>();
 
         _switchToMode(CommandPaletteMode::ActionMode);
 
@@ -588,6 +590,8 @@ namespace winrt::TerminalApp::implementation
             return _tabSwitcherMode == TabSwitcherMode::MostRecentlyUsed ? _mruTabActions : _tabActions;
         case CommandPaletteMode::CommandlineMode:
             return _commandLineHistory;
+        case CommandPaletteMode::BufferSearchMode:
+            return _bufferSearchResults;
         default:
             return _allCommands;
         }
@@ -613,6 +617,18 @@ namespace winrt::TerminalApp::implementation
             _switchToTab(filteredCommand);
             _close();
         }
+        else if (_currentMode == CommandPaletteMode::BufferSearchMode)
+        {
+            if (filteredCommand)
+            {
+                if (const auto searchResultPaletteItem{ filteredCommand.Item().try_as<winrt::TerminalApp::SearchResultPaletteItem>() })
+                {
+                    // Close first, so that the page can move the focus to the pane of the result.
+                    _close();
+                    _BufferSearchResultChosenHandlers(*this, searchResultPaletteItem);
+                }
+            }
+        }
         else if (filteredCommand)
         {
             if (const auto actionPaletteItem{ filteredCommand.Item().try_as<winrt::TerminalApp::ActionPaletteItem>() })
@@ -823,6 +839,12 @@ namespace winrt::TerminalApp::implementation
             _noMatchesText().Visibility(Visibility::Collapsed);
         }
 
+        // The results come back asynchronously, through SetBufferSearchResults.
+        if (_currentMode == CommandPaletteMode::BufferSearchMode)
+        {
+            _BufferSearchRequestedHandlers(*this, winrt::hstring{ _getTrimmedInput() });
+        }
+
         if (_currentMode == CommandPaletteMode::CommandlineMode)
         {
             ParsedCommandLineText(L"");
@@ -903,33 +925,66 @@ namespace winrt::TerminalApp::implementation
     }
 
     // Method Description:
-    // - Replaces a list of filtered commands in the target collection with new
+    // - Replaces a list of filtered commands in the target collection with
     //   commands based on the tabs in the source collection.
     // Although the source observable we still don't register on it,
     // so the palette user will need to reset the binding manually every time
     // the source collection changes
+    // - Commands for tabs that are already in the cache are reused instead of
+    //   creating a new palette item for every tab, every time the palette opens.
     // Arguments:
     // - source: the tabs to use for creation filtered commands
-    // - target: the collection to store newly created filtered commands
+    // - target: the collection to store the filtered commands
+    // - cache: the existing filtered commands, by tab. New commands are added to it.
     // Return Value:
     // - <none>
     void CommandPalette::_bindTabs(
         Windows::Foundation::Collections::IObservableVector<winrt::TerminalApp::TabBase> const& source,
-        Windows::Foundation::Collections::IVector<winrt::TerminalApp::FilteredCommand> const& target)
+        Windows::Foundation::Collections::IVector<winrt::TerminalApp::FilteredCommand> const& target,
+        TabCommandCache& cache)
     {
-        target.Clear();
+        std::vector<winrt::TerminalApp::FilteredCommand> commands;
+        commands.reserve(source.Size());
+
         for (const auto& tab : source)
         {
-            auto tabPaletteItem{ winrt::make<winrt::TerminalApp::implementation::TabPaletteItem>(tab) };
-            auto filteredCommand{ winrt::make<FilteredCommand>(tabPaletteItem) };
-            target.Append(filteredCommand);
+            if (const auto it = cache.find(tab); it != cache.end())
+            {
+                // Drop the highlighting of the last tab search.
+                it->second.UpdateFilter(L"");
+                commands.push_back(it->second);
+            }
+            else
+            {
+                auto tabPaletteItem{ winrt::make<winrt::TerminalApp::implementation::TabPaletteItem>(tab) };
+                auto filteredCommand{ winrt::make<FilteredCommand>(tabPaletteItem) };
+                cache.emplace(tab, filteredCommand);
+                commands.push_back(std::move(filteredCommand));
+            }
         }
+
+        target.ReplaceAll(commands);
     }
 
     void CommandPalette::SetTabs(Collections::IObservableVector<TabBase> const& tabs, Collections::IObservableVector<TabBase> const& mruTabs)
     {
-        _bindTabs(tabs, _tabActions);
-        _bindTabs(mruTabs, _mruTabActions);
+        // Both lists contain the same tabs, just in a different order,
+        // so they can share one filtered command per tab.
+        TabCommandCache cache;
+        for (const auto& filteredCommand : _tabActions)
+        {
+            if (const auto tabPaletteItem{ filteredCommand.Item().try_as<winrt::TerminalApp::TabPaletteItem>() })
+            {
+                // Tab() is null for tabs that were closed in the meantime.
+                if (const auto tab{ tabPaletteItem.Tab() })
+                {
+                    cache.emplace(tab, filteredCommand);
+                }
+            }
+        }
+
+        _bindTabs(tabs, _tabActions, cache);
+        _bindTabs(mruTabs, _mruTabActions, cache);
     }
 
     void CommandPalette::EnableCommandPaletteMode(CommandPaletteLaunchMode const launchMode)
@@ -955,6 +1010,7 @@ namespace winrt::TerminalApp::implementation
         _nestedActionStack.Clear();
         ParentCommandName(L"");
         _currentNestedCommands.Clear();
+        _bufferSearchResults.Clear();
         // Leaving this block of code outside the above if-statement
         // guarantees that the correct text is shown for the mode
         // whenever _switchToMode is called.
@@ -977,6 +1033,13 @@ namespace winrt::TerminalApp::implementation
             PrefixCharacter(L"");
             modeAnnouncementResourceKey = USES_RESOURCE(L"CommandPaletteModeAnnouncement_CommandlineMode");
             break;
+        case CommandPaletteMode::BufferSearchMode:
+            SearchBoxPlaceholderText(RS_(L"BufferSearch_SearchBoxText"));
+            NoMatchesText(RS_(L"BufferSearch_NoMatchesText"));
+            ControlName(RS_(L"BufferSearchControlName"));
+            PrefixCharacter(L"");
+            modeAnnouncementResourceKey = USES_RESOURCE(L"CommandPaletteModeAnnouncement_BufferSearchMode");
+            break;
         case CommandPaletteMode::ActionMode:
         default:
             SearchBoxPlaceholderText(RS_(L"CommandPalette_SearchBox/PlaceholderText"));
@@ -1023,7 +1086,7 @@ namespace winrt::TerminalApp::implementation
 
         auto commandsToFilter = _commandsToFilter();
 
-        if (_currentMode == CommandPaletteMode::TabSwitchMode)
+        if (_currentMode == CommandPaletteMode::TabSwitchMode || _currentMode == CommandPaletteMode::BufferSearchMode)
         {
             std::copy(begin(commandsToFilter), end(commandsToFilter), std::back_inserter(actions));
         }
@@ -1141,6 +1204,40 @@ namespace winrt::TerminalApp::implementation
         _switchToMode(CommandPaletteMode::TabSearchMode);
     }
 
+    void CommandPalette::EnableBufferSearchMode()
+    {
+        _switchToMode(CommandPaletteMode::BufferSearchMode);
+    }
+
+    // Method Description:
+    // - Replaces the results shown in buffer search mode, and selects the first
+    //   one. Results that arrive after we left that mode are ignored.
+    // Arguments:
+    // - results: the results to show, in the order they should be shown in.
+    // Return Value:
+    // - <none>
+    void CommandPalette::SetBufferSearchResults(Collections::IVector<winrt::TerminalApp::SearchResultPaletteItem> const& results)
+    {
+        if (_currentMode != CommandPaletteMode::BufferSearchMode)
+        {
+            return;
+        }
+
+        std::vector<winrt::TerminalApp::FilteredCommand> commands;
+        commands.reserve(results.Size());
+        for (const auto& result : results)
+        {
+            commands.emplace_back(winrt::make<FilteredCommand>(result));
+        }
+        _bufferSearchResults.ReplaceAll(commands);
+
+        _updateFilteredActions();
+        _filteredActionsView().SelectedIndex(0);
+
+        const auto hasResults{ _filteredActions.Size() > 0 };
+        _noMatchesText().Visibility(hasResults || _searchBox().Text().empty() ? Visibility::Collapsed : Visibility::Visible);
+    }
+
     // Method Description:
     // - This event is triggered when filteredActionView is looking for item container (ListViewItem)
     // to use to present the filtered actions.
@@ -21,7 +21,8 @@ namespace winrt::TerminalApp::implementation
         ActionMode = 0,
         TabSearchMode,
         TabSwitchMode,
-        CommandlineMode
+        CommandlineMode,
+        BufferSearchMode
     };
 
     struct CommandPalette : CommandPaletteT<CommandPalette>
@@ -46,6 +47,8 @@ namespace winrt::TerminalApp::implementation
         void EnableCommandPaletteMode(Microsoft::Terminal::Settings::Model::CommandPaletteLaunchMode const launchMode);
         void EnableTabSwitcherMode(const uint32_t startIdx, Microsoft::Terminal::Settings::Model::TabSwitcherMode tabSwitcherMode);
         void EnableTabSearchMode();
+        void EnableBufferSearchMode();
+        void SetBufferSearchResults(Windows::Foundation::Collections::IVector<winrt::TerminalApp::SearchResultPaletteItem> const& results);
 
         WINRT_CALLBACK(PropertyChanged, Windows::UI::Xaml::Data::PropertyChangedEventHandler);
         WINRT_OBSERVABLE_PROPERTY(winrt::hstring, NoMatchesText, _PropertyChangedHandlers);
@@ -59,6 +62,8 @@ namespace winrt::TerminalApp::implementation
         TYPED_EVENT(CommandLineExecutionRequested, winrt::TerminalApp::CommandPalette, winrt::hstring);
         TYPED_EVENT(DispatchCommandRequested, winrt::TerminalApp::CommandPalette, Microsoft::Terminal::Settings::Model::Command);
         TYPED_EVENT(PreviewAction, Windows::Foundation::IInspectable, Microsoft::Terminal::Settings::Model::Command);
+        TYPED_EVENT(BufferSearchRequested, winrt::TerminalApp::CommandPalette, winrt::hstring);
+        TYPED_EVENT(BufferSearchResultChosen, winrt::TerminalApp::CommandPalette, winrt::TerminalApp::SearchResultPaletteItem);
 
     private:
         friend struct CommandPaletteT<CommandPalette>; // for Xaml to bind events
@@ -115,7 +120,12 @@ namespace winrt::TerminalApp::implementation
         Microsoft::Terminal::Settings::Model::TabSwitcherMode _tabSwitcherMode;
         uint32_t _switcherStartIdx;
 
-        void _bindTabs(Windows::Foundation::Collections::IObservableVector<winrt::TerminalApp::TabBase> const& source, Windows::Foundation::Collections::IVector<winrt::TerminalApp::FilteredCommand> const& target);
+        // Find in all tabs. The results are searched for by the page, and
+        // are shown in the order they were given, without being filtered.
+        Windows::Foundation::Collections::IVector<winrt::TerminalApp::FilteredCommand> _bufferSearchResults{ nullptr };
+
+        using TabCommandCache = std::unordered_map<winrt::TerminalApp::TabBase, winrt::TerminalApp::FilteredCommand>;
+        void _bindTabs(Windows::Foundation::Collections::IObservableVector<winrt::TerminalApp::TabBase> const& source, Windows::Foundation::Collections::IVector<winrt::TerminalApp::FilteredCommand> const& target, TabCommandCache& cache);
         void _anchorKeyUpHandler();
 
         winrt::Windows::UI::Xaml::Controls::ListView::SizeChanged_revoker _sizeChangedRevoker;
@@ -26,13 +26,15 @@ namespace winrt::TerminalApp::implementation
         _Filter(L""),
         _Weight(0)
     {
-        _HighlightedName = _computeHighlightedName();
+        _updateNameCache();
+        _HighlightedName = _unmatchedName;
 
         // Recompute the highlighted name if the item name changes
         _itemChangedRevoker = _Item.PropertyChanged(winrt::auto_revoke, [weakThis{ get_weak() }](auto& /*sender*/, auto& e) {
             auto filteredCommand{ weakThis.get() };
             if (filteredCommand && e.PropertyName() == L"Name")
             {
+                filteredCommand->_updateNameCache();
                 filteredCommand->HighlightedName(filteredCommand->_computeHighlightedName());
                 filteredCommand->Weight(filteredCommand->_computeWeight());
             }
@@ -45,10 +47,79 @@ namespace winrt::TerminalApp::implementation
         // that might result in triggering a notification event
         if (filter != _Filter)
         {
+            // If the previous filter didn't match, then neither will a filter that extends it.
+            // This is the common case while typing, so skip matching for those items entirely.
+            const auto extendsMismatch = _Weight == 0 && !_Filter.empty() && til::starts_with(std::wstring_view{ filter }, std::wstring_view{ _Filter });
+
             Filter(filter);
-            HighlightedName(_computeHighlightedName());
-            Weight(_computeWeight());
+
+            // An empty filter doesn't highlight anything, which is what _unmatchedName looks like as well.
+            if (filter.empty() || extendsMismatch || (_computeCharMask(filter, 0) & ~_nameCharMask) != 0)
+            {
+                HighlightedName(_unmatchedName);
+                Weight(0);
+            }
+            else
+            {
+                HighlightedName(_computeHighlightedName());
+                Weight(_computeWeight());
+            }
+        }
+    }
+
+    // Function Description:
+    // - Computes a bitmask of the ASCII letters and digits in the given text, ignoring case.
+    //   The mask of a filter must be a subset of the mask of a name for the filter to match it.
+    // - We compare characters with lstrcmpi, which is locale-aware, so a non-ASCII character
+    //   might match an ASCII one. To stay conservative, a non-ASCII character in a name sets
+    //   all bits, while a non-ASCII character in a filter doesn't contribute to its mask.
+    // Arguments:
+    // - text: the text to summarize
+    // - nonAsciiMask: the bits to set for non-ASCII characters
+    // Return Value:
+    // - the bitmask for the text
+    uint64_t FilteredCommand::_computeCharMask(std::wstring_view text, const uint64_t nonAsciiMask) noexcept
+    {
+        uint64_t mask = 0;
+
+        for (const auto ch : text)
+        {
+            if (ch >= L'a' && ch <= L'z')
+            {
+                mask |= uint64_t{ 1 } << (ch - L'a');
+            }
+            else if (ch >= L'A' && ch <= L'Z')
+            {
+                mask |= uint64_t{ 1 } << (ch - L'A');
+            }
+            else if (ch >= L'0' && ch <= L'9')
+            {
+                mask |= uint64_t{ 1 } << (26 + ch - L'0');
+            }
+            else if (ch >= 0x80)
+            {
+                mask |= nonAsciiMask;
+            }
         }
+
+        return mask;
+    }
+
+    // Method Description:
+    // - Recomputes everything we derive from the item name alone,
+    //   so that it doesn't have to be redone for every filter.
+    // Arguments:
+    // - <none>
+    // Return Value:
+    // - <none>
+    void FilteredCommand::_updateNameCache()
+    {
+        const auto name = _Item.Name();
+        _nameCharMask = _computeCharMask(name, UINT64_MAX);
+
+        const auto segments = winrt::single_threaded_observable_vector<winrt::TerminalApp::HighlightedTextSegment>();
+        segments.Append(winrt::make<HighlightedTextSegment>(name, false));
+        _unmatchedName = winrt::make<HighlightedText>(segments);
     }
 
     // Method Description:
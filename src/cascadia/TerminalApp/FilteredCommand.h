@@ -31,8 +31,17 @@ namespace winrt::TerminalApp::implementation
         WINRT_OBSERVABLE_PROPERTY(int, Weight, _PropertyChangedHandlers);
 
     private:
+        static uint64_t _computeCharMask(std::wstring_view text, const uint64_t nonAsciiMask) noexcept;
+        void _updateNameCache();
         winrt::TerminalApp::HighlightedText _computeHighlightedName();
         int _computeWeight();
+
+        // A cheap, conservative summary of the characters in the item name.
+        // If a filter has a character whose bit isn't set here, it can't match.
+        uint64_t _nameCharMask{ 0 };
+        // The highlighted name for filters that don't match. It's the same for all of them,
+        // so we can hand out the same instance instead of building new segments on every keystroke.
+        winrt::TerminalApp::HighlightedText _unmatchedName{ nullptr };
         Windows::UI::Xaml::Data::INotifyPropertyChanged::PropertyChanged_revoker _itemChangedRevoker;
 
         friend class TerminalAppLocalTests::FilteredCommandTests;
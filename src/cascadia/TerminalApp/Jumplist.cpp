@@ -56,6 +56,10 @@ static std::wstring _normalizeIconPath(std::wstring_view path)
 
 // Method Description:
 // - Updates the items of the Jumplist based on the given settings.
+// - Publishing the jumplist takes a lot of calls into the shell, but the
+//   profiles rarely change between two settings loads, or two launches. We
+//   remember which jumplist we published last in the application state, and
+//   leave it alone if it'd come out the same.
 // Arguments:
 // - settings - The settings object to update the jumplist with.
 // Return Value:
@@ -69,6 +73,15 @@ winrt::fire_and_forget Jumplist::UpdateJumplist(const CascadiaSettings& settings
 
     try
     {
+        const auto entries = _collectEntries(strongSettings.ActiveProfiles().GetView());
+        const auto key = _computeKey(entries);
+
+        auto state = ApplicationState::SharedInstance();
+        if (state.JumplistKey() == key)
+        {
+            co_return;
+        }
+
         auto jumplistInstance = winrt::create_instance<ICustomDestinationList>(CLSID_DestinationList, CLSCTX_ALL);
 
         // Start the Jumplist edit transaction
@@ -81,7 +94,7 @@ winrt::fire_and_forget Jumplist::UpdateJumplist(const CascadiaSettings& settings
         THROW_IF_FAILED(jumplistItems->Clear());
 
         // Update the list of profiles.
-        THROW_IF_FAILED(_updateProfiles(jumplistItems.get(), strongSettings.ActiveProfiles().GetView()));
+        THROW_IF_FAILED(_updateProfiles(jumplistItems.get(), entries));
 
         // TODO GH#1571: Add items from the future customizable new tab dropdown as well.
         // This could either replace the default profiles, or be added alongside them.
@@ -92,30 +105,74 @@ winrt::fire_and_forget Jumplist::UpdateJumplist(const CascadiaSettings& settings
         THROW_IF_FAILED(jumplistInstance->AddUserTasks(jumplistItems.get()));
 
         THROW_IF_FAILED(jumplistInstance->CommitList());
+
+        state.JumplistKey(key);
     }
     CATCH_LOG();
 }
 
+// Method Description:
+// - Collects what goes into the jumplist item of each profile.
+// Arguments:
+// - profiles - The profiles to add to the jumplist
+// Return Value:
+// - The name, icon and arguments of the jumplist item of each profile.
+std::vector<Jumplist::Entry> Jumplist::_collectEntries(winrt::Windows::Foundation::Collections::IVectorView<Profile> profiles)
+{
+    std::vector<Entry> entries;
+    entries.reserve(profiles.Size());
+
+    for (const auto& profile : profiles)
+    {
+        // Craft the arguments following "wt.exe"
+        auto args = fmt::format(L"-p {}", to_hstring(profile.Guid()));
+        entries.push_back({ std::wstring{ profile.Name() }, _normalizeIconPath(profile.Icon()), std::move(args) });
+    }
+
+    return entries;
+}
+
+// Method Description:
+// - Computes a key that identifies the jumplist we'd publish for the given
+//   entries. The path to wt.exe is part of it, since it changes with every
+//   update of the package.
+// Arguments:
+// - entries - The jumplist entries
+// Return Value:
+// - The key of the jumplist.
+winrt::hstring Jumplist::_computeKey(const std::vector<Entry>& entries)
+{
+    std::wstring description{ GetWtExePath() };
+    for (const auto& entry : entries)
+    {
+        description.push_back(L'\0');
+        description.append(entry.name);
+        description.push_back(L'\0');
+        description.append(entry.iconPath);
+        description.push_back(L'\0');
+        description.append(entry.args);
+    }
+
+    // The hash might differ between builds. That only costs us one update.
+    return winrt::hstring{ fmt::format(L"{:016x}", std::hash<std::wstring>{}(description)) };
+}
+
 // Method Description:
 // - Creates and adds a ShellLink object to the Jumplist for each profile.
 // Arguments:
 // - jumplistItems - The jumplist item list
-// - profiles - The profiles to add to the jumplist
+// - entries - The jumplist entries of the profiles to add
 // Return Value:
 // - S_OK or HRESULT failure code.
-[[nodiscard]] HRESULT Jumplist::_updateProfiles(IObjectCollection* jumplistItems, winrt::Windows::Foundation::Collections::IVectorView<Profile> profiles) noexcept
+[[nodiscard]] HRESULT Jumplist::_updateProfiles(IObjectCollection* jumplistItems, const std::vector<Entry>& entries) noexcept
 {
     try
     {
-        for (const auto& profile : profiles)
+        for (const auto& entry : entries)
         {
-            // Craft the arguments following "wt.exe"
-            auto args = fmt::format(L"-p {}", to_hstring(profile.Guid()));
-
             // Create the shell link object for the profile
             winrt::com_ptr<IShellLinkW> shLink;
-            const auto normalizedIconPath{ _normalizeIconPath(profile.Icon()) };
-            RETURN_IF_FAILED(_createShellLink(profile.Name(), normalizedIconPath, args, shLink.put()));
+            RETURN_IF_FAILED(_createShellLink(entry.name, entry.iconPath, entry.args, shLink.put()));
 
             RETURN_IF_FAILED(jumplistItems->AddObject(shLink.get()));
         }
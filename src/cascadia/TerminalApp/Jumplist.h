@@ -21,6 +21,15 @@ public:
     static winrt::fire_and_forget UpdateJumplist(const winrt::Microsoft::Terminal::Settings::Model::CascadiaSettings& settings) noexcept;
 
 private:
-    [[nodiscard]] static HRESULT _updateProfiles(IObjectCollection* jumplistItems, winrt::Windows::Foundation::Collections::IVectorView<winrt::Microsoft::Terminal::Settings::Model::Profile> profiles) noexcept;
+    struct Entry
+    {
+        std::wstring name;
+        std::wstring iconPath;
+        std::wstring args;
+    };
+
+    static std::vector<Entry> _collectEntries(winrt::Windows::Foundation::Collections::IVectorView<winrt::Microsoft::Terminal::Settings::Model::Profile> profiles);
+    static winrt::hstring _computeKey(const std::vector<Entry>& entries);
+    [[nodiscard]] static HRESULT _updateProfiles(IObjectCollection* jumplistItems, const std::vector<Entry>& entries) noexcept;
     [[nodiscard]] static HRESULT _createShellLink(const std::wstring_view name, const std::wstring_view path, const std::wstring_view args, IShellLinkW** shLink) noexcept;
 };
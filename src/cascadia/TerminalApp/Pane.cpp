@@ -32,6 +32,7 @@ static const int AnimationDurationInMilliseconds = 200;
 static const Duration AnimationDuration = DurationHelper::FromTimeSpan(winrt::Windows::Foundation::TimeSpan(std::chrono::milliseconds(AnimationDurationInMilliseconds)));
 
 winrt::Windows::UI::Xaml::Media::SolidColorBrush Pane::s_focusedBorderBrush = { nullptr };
+uint64_t Pane::s_layoutGeneration = 1;
 winrt::Windows::UI::Xaml::Media::SolidColorBrush Pane::s_unfocusedBorderBrush = { nullptr };
 
 Pane::Pane(const GUID& profile, const TermControl& control, const bool lastFocused) :
@@ -153,6 +154,7 @@ bool Pane::_Resize(const ResizeDirection& direction)
     const auto actualDimension = changeWidth ? actualSize.Width : actualSize.Height;
 
     _desiredSplitPosition = _ClampSplitPosition(changeWidth, _desiredSplitPosition - amount, actualDimension);
+    _InvalidateLayoutCache();
 
     // Resize our columns to match the new percentages.
     ResizeContent(actualSize);
@@ -1074,9 +1076,6 @@ void Pane::UpdateSettings(const TerminalSettingsCreateResult& settings, const GU
         if (profile == _profile)
         {
             auto controlSettings = _control.Settings().as<TerminalSettings>();
-            // Update the parent of the control's settings object (and not the object itself) so
-            // that any overrides made by the control don't get affected by the reload
-            controlSettings.SetParent(settings.DefaultSettings());
             auto unfocusedSettings{ settings.UnfocusedSettings() };
             if (unfocusedSettings)
             {
@@ -1086,8 +1085,26 @@ void Pane::UpdateSettings(const TerminalSettingsCreateResult& settings, const GU
                 // sure the unfocused settings inherit from that.
                 unfocusedSettings.SetParent(controlSettings);
             }
+
+            // Most reloads only touch a few profiles (or just the keybindings). Updating a
+            // control means reloading its fonts and repainting it, so we skip the ones whose
+            // settings resolve to exactly the same values as before.
+            const auto previousSettings = controlSettings.GetParent();
+            const auto previousUnfocusedSettings = _control.UnfocusedAppearance().try_as<TerminalSettings>();
+            const bool unfocusedUnchanged = unfocusedSettings ? previousUnfocusedSettings && unfocusedSettings.IsEquivalentTo(previousUnfocusedSettings) : !previousUnfocusedSettings;
+            if (previousSettings && unfocusedUnchanged && settings.DefaultSettings().IsEquivalentTo(previousSettings))
+            {
+                return;
+            }
+
+            // Update the parent of the control's settings object (and not the object itself) so
+            // that any overrides made by the control don't get affected by the reload
+            controlSettings.SetParent(settings.DefaultSettings());
             _control.UnfocusedAppearance(unfocusedSettings);
             _control.UpdateSettings();
+
+            // The padding and scrollbar of the control are part of its minimum size.
+            _InvalidateLayoutCache();
         }
     }
 }
@@ -1564,6 +1581,10 @@ void Pane::_CreateRowColDefinitions()
 // - <none>
 void Pane::_UpdateBorders()
 {
+    // Our borders are part of our minimum and snapped sizes. Every change to
+    // the tree, be it a split, a close, a swap or a zoom, ends up here too.
+    _InvalidateLayoutCache();
+
     double top = 0, bottom = 0, left = 0, right = 0;
 
     Thickness newBorders{ 0 };
@@ -1610,6 +1631,21 @@ Borders Pane::_GetCommonBorders()
     return _firstChild->_GetCommonBorders() & _secondChild->_GetCommonBorders();
 }
 
+// Method Description:
+// - Invalidates the minimum and snapped sizes that the panes cached. This needs to
+//   be called whenever something affects them: the borders, splits and split
+//   positions of panes, or the font, padding and scrollbar of their controls.
+// - This invalidates the caches of all the panes at once, which is fine because
+//   such changes happen far less often than layout passes.
+// Arguments:
+// - <none>
+// Return Value:
+// - <none>
+void Pane::_InvalidateLayoutCache() noexcept
+{
+    s_layoutGeneration++;
+}
+
 // Method Description:
 // - Sets the row/column of our child UI elements, to match our current split type.
 // - In case the split definition or parent borders were changed, this recursively
@@ -2278,28 +2314,43 @@ Pane::SnapChildrenSizeResult Pane::_CalcSnappedChildrenSizes(const bool widthOrH
     // be optimized for simple cases like when both children are both leaves with the same character
     // size, but it doesn't seem to be beneficial.
 
-    auto sizeTree = _CreateMinSizeTree(widthOrHeight);
-    LayoutSizeNode lastSizeTree{ sizeTree };
+    //   Since that sequence is the same for every call, we remember the steps we've
+    // made in _snapSequences and only ever advance past the last one. Resizing the
+    // window or a parent pane thus doesn't need to start over from the minimum size.
+
+    auto& sequence = _snapSequences.at(widthOrHeight ? 1 : 0);
+    if (sequence.generation != s_layoutGeneration)
+    {
+        sequence.generation = s_layoutGeneration;
+        sequence.sizeTree = std::make_unique<LayoutSizeNode>(_CreateMinSizeTree(widthOrHeight));
+        sequence.steps.clear();
+        sequence.steps.push_back({ sequence.sizeTree->size, { sequence.sizeTree->firstChild->size, sequence.sizeTree->secondChild->size } });
+    }
 
-    while (sizeTree.size < fullSize)
+    auto& sizeTree = *sequence.sizeTree;
+    while (sequence.steps.back().size < fullSize)
     {
-        lastSizeTree = sizeTree;
         _AdvanceSnappedDimension(widthOrHeight, sizeTree);
+        sequence.steps.push_back({ sizeTree.size, { sizeTree.firstChild->size, sizeTree.secondChild->size } });
+    }
 
-        if (sizeTree.size == fullSize)
-        {
-            // If we just hit exactly the requested value, then just return the
-            // current state of children.
-            return { { sizeTree.firstChild->size, sizeTree.secondChild->size },
-                     { sizeTree.firstChild->size, sizeTree.secondChild->size } };
-        }
+    // Each step grows the size, so the steps are sorted by it. Find the
+    // first one that's at least as large as the requested size.
+    const auto it = std::lower_bound(sequence.steps.begin(), sequence.steps.end(), fullSize, [](const auto& step, const float size) {
+        return step.size < size;
+    });
+
+    if (it == sequence.steps.begin() || it->size == fullSize)
+    {
+        // If we just hit exactly the requested value (or are at our minimum
+        // size already), then just return the this state of children.
+        return { it->childSizes, it->childSizes };
     }
 
-    // We exceeded the requested size in the loop above, so lastSizeTree will have
-    // the last good sizes (so that children fit in) and sizeTree has the next possible
+    // This step exceeds the requested size, so the step before it has the
+    // last good sizes (so that children fit in) and this one has the next possible
     // snapped sizes. Return them as lower and higher snap possibilities.
-    return { { lastSizeTree.firstChild->size, lastSizeTree.secondChild->size },
-             { sizeTree.firstChild->size, sizeTree.secondChild->size } };
+    return { std::prev(it)->childSizes, it->childSizes };
 }
 
 // Method Description:
@@ -2521,11 +2572,17 @@ void Pane::_AdvanceSnappedDimension(const bool widthOrHeight, LayoutSizeNode& si
 //   include the space needed for borders _within_ us.
 // Arguments:
 // - <none>
+// - The result is cached until the layout cache is invalidated.
 // Return Value:
 // - The minimum size that this pane can be resized to and still have a visible
 //   character.
 Size Pane::_GetMinSize() const
 {
+    if (_minSizeGeneration == s_layoutGeneration)
+    {
+        return _minSize;
+    }
+
     if (_IsLeaf())
     {
         auto controlSize = _control.MinimumSize();
@@ -2537,7 +2594,7 @@ Size Pane::_GetMinSize() const
         newHeight += WI_IsFlagSet(_borders, Borders::Top) ? PaneBorderSize : 0;
         newHeight += WI_IsFlagSet(_borders, Borders::Bottom) ? PaneBorderSize : 0;
 
-        return { newWidth, newHeight };
+        _minSize = { newWidth, newHeight };
     }
     else
     {
@@ -2551,8 +2608,11 @@ Size Pane::_GetMinSize() const
                                    firstSize.Height + secondSize.Height :
                                    std::max(firstSize.Height, secondSize.Height);
 
-        return { minWidth, minHeight };
+        _minSize = { minWidth, minHeight };
     }
+
+    _minSizeGeneration = s_layoutGeneration;
+    return _minSize;
 }
 
 // Method Description:
@@ -151,6 +151,7 @@ private:
     winrt::Microsoft::Terminal::TerminalConnection::ConnectionState _connectionState{ winrt::Microsoft::Terminal::TerminalConnection::ConnectionState::NotConnected };
     static winrt::Windows::UI::Xaml::Media::SolidColorBrush s_focusedBorderBrush;
     static winrt::Windows::UI::Xaml::Media::SolidColorBrush s_unfocusedBorderBrush;
+    static uint64_t s_layoutGeneration;
 
     std::shared_ptr<Pane> _firstChild{ nullptr };
     std::shared_ptr<Pane> _secondChild{ nullptr };
@@ -188,6 +189,7 @@ private:
     void _SetupEntranceAnimation();
     void _UpdateBorders();
     Borders _GetCommonBorders();
+    static void _InvalidateLayoutCache() noexcept;
 
     bool _Resize(const winrt::Microsoft::Terminal::Settings::Model::ResizeDirection& direction);
 
@@ -312,6 +314,28 @@ private:
         void _AssignChildNode(std::unique_ptr<LayoutSizeNode>& nodeField, const LayoutSizeNode* const newNode);
     };
 
+    // The sizes that _CalcSnappedChildrenSizes() went through so far. Since
+    // every layout pass of a subtree goes through the same sequence of sizes,
+    // we only ever need to compute each of them once, until the cache is
+    // invalidated by _InvalidateLayoutCache().
+    struct SnapSequence
+    {
+        struct Step
+        {
+            float size;
+            std::pair<float, float> childSizes;
+        };
+
+        uint64_t generation{ 0 };
+        std::unique_ptr<LayoutSizeNode> sizeTree;
+        std::vector<Step> steps;
+    };
+
+    // Indexed by the widthOrHeight argument of _CalcSnappedChildrenSizes.
+    mutable std::array<SnapSequence, 2> _snapSequences;
+    mutable uint64_t _minSizeGeneration{ 0 };
+    mutable winrt::Windows::Foundation::Size _minSize{};
+
     friend struct winrt::TerminalApp::implementation::TerminalTab;
     friend class ::TerminalAppLocalTests::TabTests;
 };
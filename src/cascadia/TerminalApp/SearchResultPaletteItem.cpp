@@ -0,0 +1,27 @@
+// Copyright (c) Microsoft Corporation.
+// Licensed under the MIT license.
+
+#include "pch.h"
+#include "SearchResultPaletteItem.h"
+
+#include "SearchResultPaletteItem.g.cpp"
+
+using namespace winrt;
+using namespace winrt::TerminalApp;
+using namespace winrt::Microsoft::Terminal::Control;
+
+namespace winrt::TerminalApp::implementation
+{
+    SearchResultPaletteItem::SearchResultPaletteItem(winrt::TerminalApp::TabBase const& tab,
+                                                     TermControl const& control,
+                                                     BufferSearchResult const& result,
+                                                     winrt::hstring const& location) :
+        _tab(tab),
+        _control(control),
+        _Result(result)
+    {
+        Name(result.Preview());
+        KeyChordText(location);
+        Icon(tab.Icon());
+    }
+}
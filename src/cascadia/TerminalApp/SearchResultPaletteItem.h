@@ -0,0 +1,42 @@
+// Copyright (c) Microsoft Corporation.
+// Licensed under the MIT license.
+
+#pragma once
+
+#include "PaletteItem.h"
+#include "SearchResultPaletteItem.g.h"
+#include "inc/cppwinrt_utils.h"
+
+namespace winrt::TerminalApp::implementation
+{
+    struct SearchResultPaletteItem : SearchResultPaletteItemT<SearchResultPaletteItem, PaletteItem>
+    {
+        SearchResultPaletteItem() = default;
+        SearchResultPaletteItem(winrt::TerminalApp::TabBase const& tab,
+                                winrt::Microsoft::Terminal::Control::TermControl const& control,
+                                winrt::Microsoft::Terminal::Control::BufferSearchResult const& result,
+                                winrt::hstring const& location);
+
+        winrt::TerminalApp::TabBase Tab() const noexcept
+        {
+            return _tab.get();
+        }
+
+        winrt::Microsoft::Terminal::Control::TermControl Control() const noexcept
+        {
+            return _control.get();
+        }
+
+        WINRT_PROPERTY(winrt::Microsoft::Terminal::Control::BufferSearchResult, Result, nullptr);
+
+    private:
+        // The results may outlive the tabs and panes they were found in.
+        winrt::weak_ref<winrt::TerminalApp::TabBase> _tab;
+        winrt::weak_ref<winrt::Microsoft::Terminal::Control::TermControl> _control;
+    };
+}
+
+namespace winrt::TerminalApp::factory_implementation
+{
+    BASIC_FACTORY(SearchResultPaletteItem);
+}
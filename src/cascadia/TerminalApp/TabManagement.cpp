@@ -19,6 +19,7 @@
 #include "ColorHelper.h"
 #include "DebugTapConnection.h"
 #include "SettingsTab.h"
+#include "SearchResultPaletteItem.h"
 
 using namespace winrt;
 using namespace winrt::Windows::Foundation::Collections;
@@ -108,6 +109,7 @@ namespace winrt::TerminalApp::implementation
 
         newTabImpl->SetDispatch(*_actionDispatch);
         newTabImpl->SetActionMap(_settings.ActionMap());
+        newTabImpl->SilenceTimeout(std::chrono::seconds{ std::max(0, _settings.GlobalSettings().TabSilenceTimeout()) });
 
         // Give the tab its index in the _tabs vector so it can manage its own SwitchToTab command.
         _UpdateTabIndices();
@@ -592,6 +594,141 @@ namespace winrt::TerminalApp::implementation
         }
     }
 
+    // Method Description:
+    // - Searches the buffers of all the panes of all the tabs for the text typed
+    //   into the command palette. The panes are all searched at the same time,
+    //   in the background, and the palette is updated as each of them finishes.
+    // - The lines that match the case of the query come first, and of those,
+    //   the ones closest to the end of their buffer. Panes that are closed or
+    //   any older query that's still running are left behind.
+    // Arguments:
+    // - query: the text to find. An empty one clears the results.
+    // Return Value:
+    // - <none>
+    winrt::fire_and_forget TerminalPage::_OnBufferSearchRequested(const IInspectable /*sender*/, const winrt::hstring query)
+    {
+        static constexpr size_t MaxResults{ 1000 };
+
+        const auto generation = ++_bufferSearchGeneration;
+        for (const auto& operation : _bufferSearchOperations)
+        {
+            operation.Cancel();
+        }
+        _bufferSearchOperations.clear();
+
+        if (query.empty())
+        {
+            CommandPalette().SetBufferSearchResults(winrt::single_threaded_vector<winrt::TerminalApp::SearchResultPaletteItem>());
+            co_return;
+        }
+
+        struct PaneSearch
+        {
+            TerminalApp::TabBase tab;
+            TermControl control;
+            winrt::hstring location;
+            uint32_t order;
+        };
+        struct Match
+        {
+            BufferSearchResult result;
+            size_t pane;
+        };
+
+        std::vector<PaneSearch> searches;
+        for (uint32_t tabIndex = 0; tabIndex < _tabs.Size(); ++tabIndex)
+        {
+            const auto tab = _tabs.GetAt(tabIndex);
+            if (const auto terminalTab{ _GetTerminalTabImpl(tab) })
+            {
+                uint32_t paneIndex = 0;
+                for (const auto& control : terminalTab->GetTerminalControls())
+                {
+                    const auto location = fmt::format(std::wstring_view{ RS_(L"BufferSearch_ResultLocation") }, tabIndex + 1, ++paneIndex);
+                    searches.emplace_back(PaneSearch{ tab, control, winrt::hstring{ location }, gsl::narrow_cast<uint32_t>(searches.size()) });
+                    _bufferSearchOperations.emplace_back(control.FindAllAsync(query, false));
+                }
+            }
+        }
+
+        // Hold on to the operations ourselves: _bufferSearchOperations is cleared by the next query.
+        const auto operations = _bufferSearchOperations;
+        const auto weakThis{ get_weak() };
+        std::vector<Match> matches;
+
+        for (size_t i = 0; i < operations.size(); ++i)
+        {
+            IVector<BufferSearchResult> found{ nullptr };
+            try
+            {
+                found = co_await operations[i];
+            }
+            catch (const winrt::hresult_canceled&)
+            {
+            }
+            catch (...)
+            {
+                LOG_CAUGHT_EXCEPTION();
+            }
+
+            const auto page{ weakThis.get() };
+            if (!page || page->_bufferSearchGeneration != generation)
+            {
+                co_return;
+            }
+            if (!found)
+            {
+                continue;
+            }
+
+            for (const auto& result : found)
+            {
+                matches.emplace_back(Match{ result, i });
+            }
+            std::stable_sort(matches.begin(), matches.end(), [&](const Match& lhs, const Match& rhs) {
+                return std::tuple{ !lhs.result.MatchesCase(), lhs.result.RowsFromEnd(), searches[lhs.pane].order } <
+                       std::tuple{ !rhs.result.MatchesCase(), rhs.result.RowsFromEnd(), searches[rhs.pane].order };
+            });
+            if (matches.size() > MaxResults)
+            {
+                matches.resize(MaxResults);
+            }
+
+            std::vector<winrt::TerminalApp::SearchResultPaletteItem> items;
+            items.reserve(matches.size());
+            for (const auto& match : matches)
+            {
+                const auto& search = searches[match.pane];
+                items.emplace_back(winrt::make<winrt::TerminalApp::implementation::SearchResultPaletteItem>(search.tab, search.control, match.result, search.location));
+            }
+            page->CommandPalette().SetBufferSearchResults(winrt::single_threaded_vector(std::move(items)));
+        }
+    }
+
+    // Method Description:
+    // - Switches to the tab and pane a line was found in, and scrolls it into view.
+    // Arguments:
+    // - item: the result that was chosen in the command palette.
+    // Return Value:
+    // - <none>
+    void TerminalPage::_OnBufferSearchResultChosen(const IInspectable& /*sender*/, const winrt::TerminalApp::SearchResultPaletteItem& item)
+    {
+        const auto tab{ item.Tab() };
+        const auto control{ item.Control() };
+        uint32_t index{};
+        if (!tab || !control || !_tabs.IndexOf(tab, index))
+        {
+            return;
+        }
+
+        _SelectTab(index);
+        if (const auto terminalTab{ _GetTerminalTabImpl(tab) })
+        {
+            terminalTab->FocusControl(control);
+        }
+        control.ScrollToSearchResult(item.Result());
+    }
+
     // Method Description:
     // - Returns the index in our list of tabs of the currently focused tab. If
     //      no tab is currently selected, returns nullopt.
@@ -116,6 +116,13 @@ namespace winrt::TerminalApp::implementation
         // Upon settings update we reload the system settings for scrolling as well.
         // TODO: consider reloading this value periodically.
         _systemRowsToScroll = _ReadSystemRowsToScroll();
+
+        // Before our first layout, _OnFirstLayout will do this
+        // once the startup actions have created their connections.
+        if (_startupState != StartupState::NotInitialized)
+        {
+            _PreparePseudoConsoles();
+        }
     }
 
     void TerminalPage::Create()
@@ -244,6 +251,8 @@ namespace winrt::TerminalApp::implementation
         CommandPalette().DispatchCommandRequested({ this, &TerminalPage::_OnDispatchCommandRequested });
         CommandPalette().CommandLineExecutionRequested({ this, &TerminalPage::_OnCommandLineExecutionRequested });
         CommandPalette().SwitchToTabRequested({ this, &TerminalPage::_OnSwitchToTabRequested });
+        CommandPalette().BufferSearchRequested({ this, &TerminalPage::_OnBufferSearchRequested });
+        CommandPalette().BufferSearchResultChosen({ this, &TerminalPage::_OnBufferSearchResultChosen });
         CommandPalette().PreviewAction({ this, &TerminalPage::_PreviewActionHandler });
 
         // Settings AllowDependentAnimations will affect whether animations are
@@ -366,6 +375,8 @@ namespace winrt::TerminalApp::implementation
             // or the COM server might start receiving requests on another thread and dispatch
             // them to nowhere.
             _StartInboundListener();
+
+            _PreparePseudoConsoles();
         }
     }
 
@@ -398,6 +409,27 @@ namespace winrt::TerminalApp::implementation
         }
     }
 
+    // Routine Description:
+    // - Has the connection start as many console hosts ahead of time as the
+    //   settings ask for, so that new tabs and panes don't wait for one to launch.
+    //   The pool is shared by all of our windows, which all ask for the same.
+    // Arguments:
+    // - <none>
+    // Return Value:
+    // - <none>
+    void TerminalPage::_PreparePseudoConsoles()
+    {
+        try
+        {
+            const auto globals = _settings.GlobalSettings();
+            winrt::Microsoft::Terminal::TerminalConnection::ConptyConnection::PreparePseudoConsoles(
+                ::base::saturated_cast<uint32_t>(std::clamp(globals.PreparedConsoles(), 0, 8)),
+                ::base::saturated_cast<uint32_t>(globals.InitialRows()),
+                ::base::saturated_cast<uint32_t>(globals.InitialCols()));
+        }
+        CATCH_LOG();
+    }
+
     // Method Description:
     // - Process all the startup actions in the provided list of startup
     //   actions. We'll do this all at once here.
@@ -857,14 +889,24 @@ namespace winrt::TerminalApp::implementation
                 newWorkingDirectory = winrt::hstring{ cwd.wstring() };
             }
 
+            auto conptySettings = TerminalConnection::ConptyConnection::CreateSettings(settings.Commandline(),
+                                                                                       newWorkingDirectory,
+                                                                                       settings.StartingTitle(),
+                                                                                       envMap.GetView(),
+                                                                                       ::base::saturated_cast<uint32_t>(settings.InitialRows()),
+                                                                                       ::base::saturated_cast<uint32_t>(settings.InitialCols()),
+                                                                                       winrt::guid());
+            if (const auto sessionLogDirectory = profile.SessionLogDirectory(); !sessionLogDirectory.empty())
+            {
+                conptySettings.Insert(L"sessionLogDirectory", Windows::Foundation::PropertyValue::CreateString(sessionLogDirectory));
+            }
+            if (_settings.GlobalSettings().ThreadScheduling() == ThreadSchedulingPolicy::Responsive)
+            {
+                conptySettings.Insert(L"interactiveThreads", Windows::Foundation::PropertyValue::CreateBoolean(true));
+            }
+
             auto conhostConn = TerminalConnection::ConptyConnection();
-            conhostConn.Initialize(TerminalConnection::ConptyConnection::CreateSettings(settings.Commandline(),
-                                                                                        newWorkingDirectory,
-                                                                                        settings.StartingTitle(),
-                                                                                        envMap.GetView(),
-                                                                                        ::base::saturated_cast<uint32_t>(settings.InitialRows()),
-                                                                                        ::base::saturated_cast<uint32_t>(settings.InitialCols()),
-                                                                                        winrt::guid()));
+            conhostConn.Initialize(conptySettings);
 
             sessionGuid = conhostConn.Guid();
             connection = conhostConn;
@@ -1974,6 +2016,11 @@ namespace winrt::TerminalApp::implementation
 
         term.UnfocusedAppearance(child.UnfocusedSettings()); // It is okay for the unfocused settings to be null
 
+        // The quake window is summoned with a hotkey, and has to be up to date
+        // the moment it's shown. Its controls keep rendering, slowly, while
+        // it's hidden.
+        term.KeepRenderingWhileHidden(IsQuakeWindow());
+
         return term;
     }
 
@@ -2027,6 +2074,8 @@ namespace winrt::TerminalApp::implementation
 
                 // Force the TerminalTab to re-grab its currently active control's title.
                 terminalTab->UpdateTitle();
+
+                terminalTab->SilenceTimeout(std::chrono::seconds{ std::max(0, _settings.GlobalSettings().TabSilenceTimeout()) });
             }
             else if (auto settingsTab = tab.try_as<TerminalApp::SettingsTab>())
             {
@@ -2220,6 +2269,25 @@ namespace winrt::TerminalApp::implementation
         _DismissTabContextMenus();
     }
 
+    // Method Description:
+    // - This is the method that App will call when the user starts or stops
+    //   resizing the window interactively. The controls in all our tabs defer
+    //   resizing their buffers until the resize is over.
+    // Arguments:
+    // - liveResize: true if the window is being resized interactively now.
+    // Return Value:
+    // - <none>
+    void TerminalPage::LiveResizeChanged(const bool liveResize)
+    {
+        for (const auto& tab : _tabs)
+        {
+            if (auto terminalTab{ _GetTerminalTabImpl(tab) })
+            {
+                terminalTab->LiveResizeChanged(liveResize);
+            }
+        }
+    }
+
     // Method Description:
     // - Called when the user tries to do a search using keybindings.
     //   This will tell the current focused terminal control to create
@@ -2861,6 +2929,13 @@ namespace winrt::TerminalApp::implementation
                         // If we're entering Quake Mode from Focus Mode, then this will do nothing
                         // If we're leaving Quake Mode (we're already in Focus Mode), then this will do nothing
                         _SetFocusMode(true);
+                        for (const auto& tab : _tabs)
+                        {
+                            if (auto terminalTab{ _GetTerminalTabImpl(tab) })
+                            {
+                                terminalTab->KeepRenderingWhileHidden(IsQuakeWindow());
+                            }
+                        }
                         _IsQuakeWindowChangedHandlers(*this, nullptr);
                     }
                 }
@@ -63,6 +63,7 @@ namespace winrt::TerminalApp::implementation
         hstring Title();
 
         void TitlebarClicked();
+        void LiveResizeChanged(const bool liveResize);
 
         float CalcSnappedDimension(const bool widthOrHeight, const float dimension) const;
 
@@ -179,6 +180,10 @@ namespace winrt::TerminalApp::implementation
         std::shared_ptr<Toast> _windowIdToast{ nullptr };
         std::shared_ptr<Toast> _windowRenameFailedToast{ nullptr };
 
+        // Find in all tabs. A new query cancels the searches of the previous one.
+        uint64_t _bufferSearchGeneration{ 0 };
+        std::vector<winrt::Windows::Foundation::IAsyncOperation<winrt::Windows::Foundation::Collections::IVector<winrt::Microsoft::Terminal::Control::BufferSearchResult>>> _bufferSearchOperations;
+
         void _ShowAboutDialog();
         winrt::Windows::Foundation::IAsyncOperation<winrt::Windows::UI::Xaml::Controls::ContentDialogResult> _ShowCloseWarningDialog();
         winrt::Windows::Foundation::IAsyncOperation<winrt::Windows::UI::Xaml::Controls::ContentDialogResult> _ShowCloseReadOnlyDialog();
@@ -304,6 +309,8 @@ namespace winrt::TerminalApp::implementation
         void _OnDispatchCommandRequested(const IInspectable& sender, const Microsoft::Terminal::Settings::Model::Command& command);
         void _OnCommandLineExecutionRequested(const IInspectable& sender, const winrt::hstring& commandLine);
         void _OnSwitchToTabRequested(const IInspectable& sender, const winrt::TerminalApp::TabBase& tab);
+        winrt::fire_and_forget _OnBufferSearchRequested(const IInspectable sender, const winrt::hstring query);
+        void _OnBufferSearchResultChosen(const IInspectable& sender, const winrt::TerminalApp::SearchResultPaletteItem& item);
 
         void _Find();
 
@@ -318,6 +325,7 @@ namespace winrt::TerminalApp::implementation
         void _ClearNewTabButtonColor();
 
         void _StartInboundListener();
+        void _PreparePseudoConsoles();
 
         void _CompleteInitialization();
 
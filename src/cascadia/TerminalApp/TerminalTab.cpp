@@ -245,7 +245,108 @@ namespace winrt::TerminalApp::implementation
             {
                 ShowBellIndicator(false);
             }
+
+            _StopActivityMonitor();
+        }
+        else
+        {
+            _StartActivityMonitor();
+        }
+    }
+
+    // Method Description:
+    // - Sets after how long without output a tab in the background is marked as silent.
+    // Arguments:
+    // - timeout: the time without output, or 0 to never mark the tab as silent.
+    void TerminalTab::SilenceTimeout(const std::chrono::seconds timeout) noexcept
+    {
+        _silenceTimeout = timeout;
+    }
+
+    // Method Description:
+    // - Starts polling for output, once the tab went into the background.
+    //   Does nothing if the tab is already being polled. This only reads the
+    //   counters that the controls keep anyway, so that a tab in the background
+    //   doesn't make its controls render or raise events.
+    void TerminalTab::_StartActivityMonitor()
+    {
+        if (_activityTimer.has_value())
+        {
+            return;
+        }
+
+        _backgroundOutputLength = _GetOutputLength();
+
+        DispatcherTimer activityTimer;
+        activityTimer.Interval(ActivityPollInterval);
+        activityTimer.Tick({ get_weak(), &TerminalTab::_ActivityTimerTick });
+        activityTimer.Start();
+        _activityTimer.emplace(std::move(activityTimer));
+    }
+
+    // Method Description:
+    // - Stops polling for output and removes the activity indicators from the
+    //   tab header, once the tab is in the foreground again.
+    void TerminalTab::_StopActivityMonitor()
+    {
+        if (_activityTimer.has_value())
+        {
+            _activityTimer->Stop();
+            _activityTimer = std::nullopt;
+        }
+
+        _tabStatus.HasNewOutput(false);
+        _tabStatus.IsSilent(false);
+    }
+
+    // Method Description:
+    // - Called by _activityTimer while the tab is in the background. Marks the
+    //   tab if any of its panes received output since the tab went into the
+    //   background, or if none of them received any within _silenceTimeout.
+    // Arguments:
+    // - sender, e: not used
+    void TerminalTab::_ActivityTimerTick(Windows::Foundation::IInspectable const& /*sender*/, Windows::Foundation::IInspectable const& /*e*/)
+    {
+        if (!_rootPane)
+        {
+            return;
+        }
+
+        if (_GetOutputLength() != _backgroundOutputLength)
+        {
+            _tabStatus.HasNewOutput(true);
+        }
+
+        if (_silenceTimeout.count() > 0)
+        {
+            auto silent = true;
+            _rootPane->WalkTree([&](std::shared_ptr<Pane> pane) {
+                if (const auto control = pane->GetTerminalControl())
+                {
+                    silent = control.TimeSinceOutput() >= _silenceTimeout;
+                }
+                return !silent;
+            });
+            _tabStatus.IsSilent(silent);
+        }
+    }
+
+    // Method Description:
+    // - Returns the total amount of output the controls of this tab received.
+    uint64_t TerminalTab::_GetOutputLength() const
+    {
+        uint64_t length = 0;
+        if (_rootPane)
+        {
+            _rootPane->WalkTree([&](std::shared_ptr<Pane> pane) {
+                if (const auto control = pane->GetTerminalControl())
+                {
+                    length += control.OutputLength();
+                }
+                return false;
+            });
         }
+        return length;
     }
 
     // Method Description:
@@ -627,6 +728,42 @@ namespace winrt::TerminalApp::implementation
         _rootPane->ResizeContent(newSize);
     }
 
+    // Method Description:
+    // - Tells the controls of all our panes that the window started or stopped
+    //   being resized interactively. See ControlCore::LiveResizeChanged.
+    // Arguments:
+    // - liveResize: true if the window is being resized interactively now.
+    // Return Value:
+    // - <none>
+    void TerminalTab::LiveResizeChanged(const bool liveResize)
+    {
+        _rootPane->WalkTree([liveResize](auto pane) {
+            if (const auto control{ pane->GetTerminalControl() })
+            {
+                control.LiveResizeChanged(liveResize);
+            }
+            return false;
+        });
+    }
+
+    // Method Description:
+    // - Tells the controls of all our panes whether to keep rendering while
+    //   the window is hidden. See TermControl::KeepRenderingWhileHidden.
+    // Arguments:
+    // - keepRendering: true to keep rendering while hidden.
+    // Return Value:
+    // - <none>
+    void TerminalTab::KeepRenderingWhileHidden(const bool keepRendering)
+    {
+        _rootPane->WalkTree([keepRendering](auto pane) {
+            if (const auto control{ pane->GetTerminalControl() })
+            {
+                control.KeepRenderingWhileHidden(keepRendering);
+            }
+            return false;
+        });
+    }
+
     // Method Description:
     // - Attempt to move a separator between panes, as to resize each child on
     //   either size of the separator. See Pane::ResizePane for details.
@@ -714,6 +851,26 @@ namespace winrt::TerminalApp::implementation
         return _rootPane->FocusPane(id);
     }
 
+    // Method Description:
+    // - Attempts to focus the pane that hosts the given control.
+    // Arguments:
+    // - control: the control whose pane should be focused.
+    // Return Value:
+    // - true if a pane in this tab hosts that control.
+    bool TerminalTab::FocusControl(const winrt::Microsoft::Terminal::Control::TermControl& control)
+    {
+        std::optional<uint32_t> id;
+        _rootPane->WalkTree([&](std::shared_ptr<Pane> pane) {
+            if (pane->GetTerminalControl() == control)
+            {
+                id = pane->Id();
+                return true;
+            }
+            return false;
+        });
+        return id && FocusPane(*id);
+    }
+
     // Method Description:
     // - Prepares this tab for being removed from the UI hierarchy by shutting down all active connections.
     void TerminalTab::Shutdown()
@@ -790,6 +947,9 @@ namespace winrt::TerminalApp::implementation
             control.ReadOnlyChanged(events.readOnlyToken);
             control.FocusFollowMouseRequested(events.focusToken);
 
+            // The control might be moved to another tab, which doesn't broadcast.
+            control.BroadcastInputTo(nullptr);
+
             _controlEvents.erase(paneId);
         }
     }
@@ -825,10 +985,12 @@ namespace winrt::TerminalApp::implementation
         // time (because when we just create terminal via its ctor it has invalid font size).
         // On the latter event, we tell the root pane to resize itself so that its descendants
         // (including ourself) can properly snap to character grids. In future, we may also
-        // want to do that on regular font changes.
+        // want to do that on regular font changes. Either way, the sizes the panes cached
+        // for their layout no longer apply.
         events.fontToken = control.FontSizeChanged([this](const int /* fontWidth */,
                                                           const int /* fontHeight */,
                                                           const bool isInitialChange) {
+            Pane::_InvalidateLayoutCache();
             if (isInitialChange)
             {
                 _rootPane->Relayout();
@@ -858,6 +1020,7 @@ namespace winrt::TerminalApp::implementation
             if (auto tab{ weakThis.get() })
             {
                 tab->_RecalculateAndApplyReadOnly();
+                tab->_UpdateBroadcastTargets();
             }
         });
 
@@ -985,6 +1148,7 @@ namespace winrt::TerminalApp::implementation
         }
 
         _RecalculateAndApplyReadOnly();
+        _UpdateBroadcastTargets();
 
         // Raise our own ActivePaneChanged event.
         _ActivePaneChangedHandlers();
@@ -1546,6 +1710,58 @@ namespace winrt::TerminalApp::implementation
         }
     }
 
+    // Method Description:
+    // - Toggles broadcasting what's typed into the active pane to all the other panes of the tab.
+    void TerminalTab::ToggleBroadcastInput()
+    {
+        _broadcastInput = !_broadcastInput;
+        _tabStatus.IsInputBroadcastActive(_broadcastInput);
+        _UpdateBroadcastTargets();
+    }
+
+    // Method Description:
+    // - Hands the connections of all the other panes that aren't read-only to
+    //   the active control, if input is being broadcast. The active control
+    //   encodes the keys once and writes the result to each of them. All the
+    //   other controls don't broadcast. Called whenever the active pane, the
+    //   panes of the tab or their read-only state change.
+    void TerminalTab::_UpdateBroadcastTargets()
+    {
+        if (!_rootPane)
+        {
+            return;
+        }
+
+        const auto activeControl = GetActiveTerminalControl();
+        std::vector<winrt::Microsoft::Terminal::TerminalConnection::ITerminalConnection> targets;
+        _rootPane->WalkTree([&](std::shared_ptr<Pane> pane) {
+            if (const auto control = pane->GetTerminalControl())
+            {
+                if (control != activeControl)
+                {
+                    control.BroadcastInputTo(nullptr);
+                    if (_broadcastInput && !control.ReadOnly())
+                    {
+                        targets.emplace_back(control.Connection());
+                    }
+                }
+            }
+            return false;
+        });
+
+        if (activeControl)
+        {
+            if (_broadcastInput)
+            {
+                activeControl.BroadcastInputTo(winrt::single_threaded_vector(std::move(targets)));
+            }
+            else
+            {
+                activeControl.BroadcastInputTo(nullptr);
+            }
+        }
+    }
+
     // Method Description:
     // - Calculates if the tab is read-only.
     // The tab is considered read-only if one of the panes is read-only.
@@ -1568,6 +1784,22 @@ namespace winrt::TerminalApp::implementation
         return _activePane;
     }
 
+    // Method Description:
+    // - Returns the controls of all the leaf panes of this tab, in the
+    //   order they're laid out in (depth first).
+    std::vector<winrt::Microsoft::Terminal::Control::TermControl> TerminalTab::GetTerminalControls() const
+    {
+        std::vector<winrt::Microsoft::Terminal::Control::TermControl> controls;
+        _rootPane->WalkTree([&](std::shared_ptr<Pane> pane) {
+            if (auto control = pane->GetTerminalControl())
+            {
+                controls.emplace_back(std::move(control));
+            }
+            return false;
+        });
+        return controls;
+    }
+
     // Method Description:
     // - Creates a text for the title run in the tool tip by returning tab title
     // or <profile name>: <tab title> in the case the profile name differs from the title
@@ -57,10 +57,13 @@ namespace winrt::TerminalApp::implementation
                                   winrt::Windows::Foundation::Size availableSpace) const;
 
         void ResizeContent(const winrt::Windows::Foundation::Size& newSize);
+        void LiveResizeChanged(const bool liveResize);
+        void KeepRenderingWhileHidden(const bool keepRendering);
         void ResizePane(const winrt::Microsoft::Terminal::Settings::Model::ResizeDirection& direction);
         bool NavigateFocus(const winrt::Microsoft::Terminal::Settings::Model::FocusDirection& direction);
         bool SwapPane(const winrt::Microsoft::Terminal::Settings::Model::FocusDirection& direction);
         bool FocusPane(const uint32_t id);
+        bool FocusControl(const winrt::Microsoft::Terminal::Control::TermControl& control);
 
         void UpdateSettings(const Microsoft::Terminal::Settings::Model::TerminalSettingsCreateResult& settings, const GUID& profile);
         winrt::fire_and_forget UpdateTitle();
@@ -87,7 +90,10 @@ namespace winrt::TerminalApp::implementation
         int GetLeafPaneCount() const noexcept;
 
         void TogglePaneReadOnly();
+        void ToggleBroadcastInput();
+        void SilenceTimeout(const std::chrono::seconds timeout) noexcept;
         std::shared_ptr<Pane> GetActivePane() const;
+        std::vector<winrt::Microsoft::Terminal::Control::TermControl> GetTerminalControls() const;
         winrt::TerminalApp::TaskbarState GetCombinedTaskbarState() const;
 
         winrt::TerminalApp::TerminalTabStatus TabStatus()
@@ -133,6 +139,7 @@ namespace winrt::TerminalApp::implementation
 
         bool _receivedKeyDown{ false };
         bool _iconHidden{ false };
+        bool _broadcastInput{ false };
 
         winrt::hstring _runtimeTabText{};
         bool _inRename{ false };
@@ -145,6 +152,18 @@ namespace winrt::TerminalApp::implementation
         std::optional<Windows::UI::Xaml::DispatcherTimer> _bellIndicatorTimer;
         void _BellIndicatorTimerTick(Windows::Foundation::IInspectable const& sender, Windows::Foundation::IInspectable const& e);
 
+        // While the tab is in the background, the output counters of its
+        // controls are polled at ActivityPollInterval, to mark the tab once it
+        // receives new output or has been silent for _silenceTimeout.
+        static constexpr auto ActivityPollInterval = std::chrono::seconds(1);
+        std::optional<Windows::UI::Xaml::DispatcherTimer> _activityTimer;
+        uint64_t _backgroundOutputLength{ 0 };
+        std::chrono::seconds _silenceTimeout{ 0 };
+        void _StartActivityMonitor();
+        void _StopActivityMonitor();
+        void _ActivityTimerTick(Windows::Foundation::IInspectable const& sender, Windows::Foundation::IInspectable const& e);
+        uint64_t _GetOutputLength() const;
+
         void _MakeTabViewItem() override;
 
         winrt::fire_and_forget _UpdateHeaderControlMaxWidth();
@@ -168,6 +187,8 @@ namespace winrt::TerminalApp::implementation
 
         void _RecalculateAndApplyReadOnly();
 
+        void _UpdateBroadcastTargets();
+
         void _UpdateProgressState();
 
         void _DuplicateTab();
@@ -184,11 +184,7 @@ namespace winrt::Microsoft::Terminal::TerminalConnection::implementation
         if (_state == AzureState::TermConnected)
         {
             // If we're connected, we don't need to do any fun input shenanigans.
-            websocket_outgoing_message msg;
-            const auto str = winrt::to_string(data);
-            msg.set_utf8_message(str);
-
-            _cloudShellSocket.send(msg).get();
+            _SendInput(winrt::to_string(data));
             return;
         }
 
@@ -382,13 +378,12 @@ namespace winrt::Microsoft::Terminal::TerminalConnection::implementation
                 case AzureState::TermConnected:
                 {
                     _transitionToState(ConnectionState::Connected);
+                    auto msgT = _cloudShellSocket.receive();
                     while (true)
                     {
                         // Read from websocket
-                        pplx::task<websocket_incoming_message> msgT;
                         try
                         {
-                            msgT = _cloudShellSocket.receive();
                             msgT.wait();
                         }
                         catch (...)
@@ -402,15 +397,36 @@ namespace winrt::Microsoft::Terminal::TerminalConnection::implementation
                             }
                         }
 
-                        auto msg = msgT.get();
-                        auto msgStringTask = msg.extract_string();
-                        auto msgString = msgStringTask.get();
+                        // The next message is already being received while this batch is
+                        // parsed. Every message that arrived in the meantime joins the batch.
+                        // If receiving one of them failed, the wait above reports it next.
+                        _receiveBuffer.clear();
+                        while (true)
+                        {
+                            _AppendReceivedMessage(msgT.get());
+                            msgT = _cloudShellSocket.receive();
+                            if (_receiveBuffer.size() >= MaxReceiveBatchSize || !msgT.is_done())
+                            {
+                                break;
+                            }
+                            try
+                            {
+                                msgT.wait();
+                            }
+                            catch (...)
+                            {
+                                break;
+                            }
+                        }
 
-                        // Convert to hstring
-                        const auto hstr = winrt::to_hstring(msgString);
+                        // Convert to UTF-16, the same way the conpty connection does
+                        THROW_IF_FAILED(til::u8u16(_receiveBuffer, _u16Str, _u8State));
 
                         // Pass the output to our registered event handlers
-                        _TerminalOutputHandlers(hstr);
+                        if (!_u16Str.empty())
+                        {
+                            _TerminalOutputHandlers(_u16Str);
+                        }
                     }
                     return S_OK;
                 }
@@ -425,6 +441,75 @@ namespace winrt::Microsoft::Terminal::TerminalConnection::implementation
         }
     }
 
+    // Method description:
+    // - helper function to append the contents of a received message to _receiveBuffer,
+    //   without allocating a string for every message
+    // Arguments:
+    // - msg: the message received from the websocket
+    void AzureConnection::_AppendReceivedMessage(const websocket_incoming_message& msg)
+    {
+        const auto offset = _receiveBuffer.size();
+        const auto length = msg.length();
+        _receiveBuffer.resize(offset + length);
+
+        auto body = msg.body().streambuf();
+        const auto read = body.getn(reinterpret_cast<uint8_t*>(_receiveBuffer.data() + offset), length).get();
+        _receiveBuffer.resize(offset + read);
+    }
+
+    // Method description:
+    // - helper function to send the user's input to the websocket. If a message
+    //   is still being sent, the input is queued up and sent along with any
+    //   other input that arrives until that send completes.
+    // Arguments:
+    // - data: the input, encoded as UTF-8
+    void AzureConnection::_SendInput(const std::string_view data)
+    {
+        std::unique_lock<std::mutex> lock{ _outgoingMutex };
+        _outgoingInput.append(data);
+        if (!_outgoingInFlight)
+        {
+            _outgoingInFlight = true;
+            _SendOutgoingInput(lock);
+        }
+    }
+
+    // Method description:
+    // - helper function to send all of the queued up input in one message.
+    //   Once it's sent, whatever input was queued up meanwhile is sent next.
+    // Arguments:
+    // - lock: the held lock on _outgoingMutex, which is released while sending
+    void AzureConnection::_SendOutgoingInput(std::unique_lock<std::mutex>& lock)
+    {
+        websocket_outgoing_message msg;
+        msg.set_utf8_message(std::move(_outgoingInput));
+        _outgoingInput.clear();
+        lock.unlock();
+
+        _cloudShellSocket.send(msg).then([weakThis = get_weak()](const pplx::task<void>& sendTask) {
+            try
+            {
+                sendTask.get();
+            }
+            catch (...)
+            {
+                // The output thread notices when the websocket is closed.
+                LOG_CAUGHT_EXCEPTION();
+            }
+
+            if (const auto self = weakThis.get())
+            {
+                std::unique_lock<std::mutex> lock{ self->_outgoingMutex };
+                if (self->_outgoingInput.empty())
+                {
+                    self->_outgoingInFlight = false;
+                    return;
+                }
+                self->_SendOutgoingInput(lock);
+            }
+        });
+    }
+
     // Method description:
     // - helper function to get the stored credentials (if any) and let the user choose what to do next
     void AzureConnection::_RunAccessState()
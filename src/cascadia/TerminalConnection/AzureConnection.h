@@ -98,6 +98,26 @@ namespace winrt::Microsoft::Terminal::TerminalConnection::implementation
 
         web::websockets::client::websocket_client _cloudShellSocket;
 
+        // All the messages that arrived by the time one of them has been received
+        // are passed on in a single TerminalOutput event, up to MaxReceiveBatchSize.
+        // _receiveBuffer and _u16Str are reused across batches, and _u8State keeps
+        // UTF-8 sequences that were split between two batches intact.
+        static constexpr size_t MaxReceiveBatchSize{ 1024 * 1024 };
+        std::string _receiveBuffer;
+        til::u8state _u8State{};
+        std::wstring _u16Str;
+        void _AppendReceivedMessage(const web::websockets::client::websocket_incoming_message& msg);
+
+        // Input is sent right away, unless a send is still in flight. The input
+        // that arrives meanwhile is collected in _outgoingInput and sent in a
+        // single message once the previous send completes, the way Nagle's
+        // algorithm does. The latency this adds is bounded by one send.
+        std::string _outgoingInput;
+        bool _outgoingInFlight{ false };
+        std::mutex _outgoingMutex;
+        void _SendInput(const std::string_view data);
+        void _SendOutgoingInput(std::unique_lock<std::mutex>& lock);
+
         static std::optional<utility::string_t> _ParsePreferredShellType(const web::json::value& settingsResponse);
     };
 }
@@ -13,6 +13,7 @@
 
 #include "../../types/inc/utils.hpp"
 #include "../../types/inc/Environment.hpp"
+#include "../../types/inc/ThreadScheduling.hpp"
 #include "LibraryResources.h"
 
 using namespace ::Microsoft::Console;
@@ -34,12 +35,48 @@ using namespace ::Microsoft::Console;
 
 namespace winrt::Microsoft::Terminal::TerminalConnection::implementation
 {
+    // The size of the buffers of the pipes we create. While we're busy with the
+    // last output we read, conpty can write this much more before it blocks.
+    static constexpr DWORD PipeBufferSize{ 128 * 1024 };
+
+    // The flags we create all of our pseudoconsoles with, including the prepared ones.
+    static constexpr DWORD PseudoConsoleFlags{ PSEUDOCONSOLE_RESIZE_QUIRK | PSEUDOCONSOLE_WIN32_INPUT_MODE | PSEUDOCONSOLE_COORDINATED_RESIZE };
+
+    // Function Description:
+    // - Creates a pipe whose end on our side is opened for overlapped I/O, which
+    //   anonymous pipes don't support. The other end, which is handed to conpty,
+    //   is a regular, synchronous one.
+    // Arguments:
+    // - inbound: true if we read from the pipe, false if we write to it.
+    // - ourSide: Receives the handle to our end of the pipe.
+    // - theirSide: Receives the handle to the other end of the pipe.
+    static HRESULT _CreateOverlappedPipe(const bool inbound, wil::unique_hfile& ourSide, wil::unique_hfile& theirSide) noexcept
+    try
+    {
+        const auto name = fmt::format(L"\\\\.\\pipe\\WindowsTerminal-Conpty-{}-{}", GetCurrentProcessId(), Utils::GuidToString(Utils::CreateGuid()));
+
+        ourSide.reset(CreateNamedPipeW(name.c_str(),
+                                       (inbound ? PIPE_ACCESS_INBOUND : PIPE_ACCESS_OUTBOUND) | FILE_FLAG_OVERLAPPED | FILE_FLAG_FIRST_PIPE_INSTANCE,
+                                       PIPE_TYPE_BYTE | PIPE_READMODE_BYTE | PIPE_WAIT | PIPE_REJECT_REMOTE_CLIENTS,
+                                       1,
+                                       PipeBufferSize,
+                                       PipeBufferSize,
+                                       0,
+                                       nullptr));
+        RETURN_LAST_ERROR_IF(!ourSide);
+
+        theirSide.reset(CreateFileW(name.c_str(), inbound ? GENERIC_WRITE : GENERIC_READ, 0, nullptr, OPEN_EXISTING, 0, nullptr));
+        RETURN_LAST_ERROR_IF(!theirSide);
+        return S_OK;
+    }
+    CATCH_RETURN()
+
     // Function Description:
-    // - creates some basic anonymous pipes and passes them to CreatePseudoConsole
+    // - creates a pair of overlapped pipes and passes them to CreatePseudoConsole
     // Arguments:
     // - size: The size of the conpty to create, in characters.
-    // - phInput: Receives the handle to the newly-created anonymous pipe for writing input to the conpty.
-    // - phOutput: Receives the handle to the newly-created anonymous pipe for reading the output of the conpty.
+    // - phInput: Receives the handle to the newly-created pipe for writing input to the conpty.
+    // - phOutput: Receives the handle to the newly-created pipe for reading the output of the conpty.
     // - phPc: Receives a token value to identify this conpty
 #pragma warning(suppress : 26430) // This statement sufficiently checks the out parameters. Analyzer cannot find this.
     static HRESULT _CreatePseudoConsoleAndPipes(const COORD size, const DWORD dwFlags, HANDLE* phInput, HANDLE* phOutput, HPCON* phPC) noexcept
@@ -49,8 +86,8 @@ namespace winrt::Microsoft::Terminal::TerminalConnection::implementation
         wil::unique_hfile outPipeOurSide, outPipePseudoConsoleSide;
         wil::unique_hfile inPipeOurSide, inPipePseudoConsoleSide;
 
-        RETURN_IF_WIN32_BOOL_FALSE(CreatePipe(&inPipePseudoConsoleSide, &inPipeOurSide, nullptr, 0));
-        RETURN_IF_WIN32_BOOL_FALSE(CreatePipe(&outPipeOurSide, &outPipePseudoConsoleSide, nullptr, 0));
+        RETURN_IF_FAILED(_CreateOverlappedPipe(false, inPipeOurSide, inPipePseudoConsoleSide));
+        RETURN_IF_FAILED(_CreateOverlappedPipe(true, outPipeOurSide, outPipePseudoConsoleSide));
         RETURN_IF_FAILED(ConptyCreatePseudoConsole(size, inPipePseudoConsoleSide.get(), outPipePseudoConsoleSide.get(), dwFlags, phPC));
         *phInput = inPipeOurSide.release();
         *phOutput = outPipeOurSide.release();
@@ -279,7 +316,6 @@ namespace winrt::Microsoft::Terminal::TerminalConnection::implementation
         _guid{},
         _u8State{},
         _u16Str{},
-        _buffer{},
         _inPipe{ hIn },
         _outPipe{ hOut }
     {
@@ -338,6 +374,8 @@ namespace winrt::Microsoft::Terminal::TerminalConnection::implementation
             _initialCols = winrt::unbox_value_or<uint32_t>(settings.TryLookup(L"initialCols").try_as<Windows::Foundation::IPropertyValue>(), _initialCols);
             _guid = winrt::unbox_value_or<winrt::guid>(settings.TryLookup(L"guid").try_as<Windows::Foundation::IPropertyValue>(), _guid);
             _environment = settings.TryLookup(L"environment").try_as<Windows::Foundation::Collections::ValueSet>();
+            _sessionLogDirectory = winrt::unbox_value_or<winrt::hstring>(settings.TryLookup(L"sessionLogDirectory").try_as<Windows::Foundation::IPropertyValue>(), _sessionLogDirectory);
+            _interactiveThreads = winrt::unbox_value_or<bool>(settings.TryLookup(L"interactiveThreads").try_as<Windows::Foundation::IPropertyValue>(), _interactiveThreads);
         }
 
         if (_guid == guid{})
@@ -362,8 +400,12 @@ namespace winrt::Microsoft::Terminal::TerminalConnection::implementation
         // handoff from an already-started PTY process.
         if (!_inPipe)
         {
-            THROW_IF_FAILED(_CreatePseudoConsoleAndPipes(dimensions, PSEUDOCONSOLE_RESIZE_QUIRK | PSEUDOCONSOLE_WIN32_INPUT_MODE, &_inPipe, &_outPipe, &_hPC));
+            if (!_takePreparedPseudoConsole(dimensions))
+            {
+                THROW_IF_FAILED(_CreatePseudoConsoleAndPipes(dimensions, PseudoConsoleFlags, &_inPipe, &_outPipe, &_hPC));
+            }
             THROW_IF_FAILED(_LaunchAttachedClient());
+            _overlappedIo = true;
         }
         // But if it was an inbound handoff... attempt to synchronize the size of it with what our connection
         // window is expecting it to be on the first layout.
@@ -374,27 +416,16 @@ namespace winrt::Microsoft::Terminal::TerminalConnection::implementation
 
         _startTime = std::chrono::high_resolution_clock::now();
 
-        // Create our own output handling thread
-        // This must be done after the pipes are populated.
-        // Each connection needs to make sure to drain the output from its backing host.
-        _hOutputThread.reset(CreateThread(
-            nullptr,
-            0,
-            [](LPVOID lpParameter) noexcept {
-                ConptyConnection* const pInstance = static_cast<ConptyConnection*>(lpParameter);
-                if (pInstance)
-                {
-                    return pInstance->_OutputThread();
-                }
-                return gsl::narrow_cast<DWORD>(E_INVALIDARG);
-            },
-            this,
-            0,
-            nullptr));
+        _startSessionLog();
 
-        THROW_LAST_ERROR_IF_NULL(_hOutputThread);
-
-        LOG_IF_FAILED(SetThreadDescription(_hOutputThread.get(), L"ConptyConnection Output Thread"));
+        if (_overlappedIo)
+        {
+            _startOverlappedIo();
+        }
+        else
+        {
+            _startOutputThreads();
+        }
 
         _clientExitWait.reset(CreateThreadpoolWait(
             [](PTP_CALLBACK_INSTANCE /*callbackInstance*/, PVOID context, PTP_WAIT /*wait*/, TP_WAIT_RESULT /*waitResult*/) noexcept {
@@ -419,21 +450,27 @@ namespace winrt::Microsoft::Terminal::TerminalConnection::implementation
         winrt::hstring failureText{ fmt::format(std::wstring_view{ RS_(L"ProcessFailedToLaunch") },
                                                 gsl::narrow_cast<unsigned long>(hr),
                                                 _commandline) };
-        _TerminalOutputHandlers(failureText);
+        _raiseOutput(failureText);
 
         // If the path was invalid, let's present an informative message to the user
         if (hr == HRESULT_FROM_WIN32(ERROR_DIRECTORY))
         {
             winrt::hstring badPathText{ fmt::format(std::wstring_view{ RS_(L"BadPathText") },
                                                     _startingDirectory) };
-            _TerminalOutputHandlers(L"\r\n");
-            _TerminalOutputHandlers(badPathText);
+            _raiseOutput(L"\r\n");
+            _raiseOutput(badPathText);
         }
 
         _transitionToState(ConnectionState::Failed);
 
         // Tear down any state we may have accumulated.
         _hPC.reset();
+
+        // Without an output thread, nothing would ever tell the parse thread to stop.
+        if (!_hOutputThread)
+        {
+            _outputChunkProducer.reset();
+        }
     }
 
     // Method Description:
@@ -445,8 +482,8 @@ namespace winrt::Microsoft::Terminal::TerminalConnection::implementation
         try
         {
             winrt::hstring exitText{ fmt::format(std::wstring_view{ RS_(L"ProcessExited") }, status) };
-            _TerminalOutputHandlers(L"\r\n");
-            _TerminalOutputHandlers(exitText);
+            _raiseOutput(L"\r\n");
+            _raiseOutput(exitText);
         }
         CATCH_LOG();
     }
@@ -473,10 +510,18 @@ namespace winrt::Microsoft::Terminal::TerminalConnection::implementation
 
         // Close the pseudoconsole and wait for all output to drain.
         _hPC.reset();
+        if (_outputDrained)
+        {
+            LOG_LAST_ERROR_IF(WAIT_FAILED == WaitForSingleObject(_outputDrained.get(), INFINITE));
+        }
         if (auto localOutputThreadHandle = std::move(_hOutputThread))
         {
             LOG_LAST_ERROR_IF(WAIT_FAILED == WaitForSingleObject(localOutputThreadHandle.get(), INFINITE));
         }
+        if (auto localParseThreadHandle = std::move(_hParseThread))
+        {
+            LOG_LAST_ERROR_IF(WAIT_FAILED == WaitForSingleObject(localParseThreadHandle.get(), INFINITE));
+        }
 
         _indicateExitWithStatus(exitCode);
 
@@ -494,9 +539,70 @@ namespace winrt::Microsoft::Terminal::TerminalConnection::implementation
         // convert from UTF-16LE to UTF-8 as ConPty expects UTF-8
         // TODO GH#3378 reconcile and unify UTF-8 converters
         std::string str = winrt::to_string(data);
+        if (_overlappedIo)
+        {
+            // This doesn't block the caller when the client isn't reading its input.
+            _writeInputOverlapped(std::move(str));
+            return;
+        }
         LOG_IF_WIN32_BOOL_FALSE(WriteFile(_inPipe.get(), str.c_str(), (DWORD)str.length(), nullptr, nullptr));
     }
 
+    // Method Description:
+    // - Writes input that's UTF-8 already, like ConPty expects it, without converting it.
+    // Arguments:
+    // - data: the input.
+    void ConptyConnection::WriteInputBytes(winrt::array_view<const uint8_t> data)
+    {
+        if (!_isConnected() || data.empty())
+        {
+            return;
+        }
+
+#pragma warning(suppress : 26490) // Don't use reinterpret_cast (type.1). The pipe takes bytes either way.
+        const std::string_view str{ reinterpret_cast<const char*>(data.data()), data.size() };
+        if (_overlappedIo)
+        {
+            // This doesn't block the caller when the client isn't reading its input.
+            _writeInputOverlapped(std::string{ str });
+            return;
+        }
+        LOG_IF_WIN32_BOOL_FALSE(WriteFile(_inPipe.get(), str.data(), gsl::narrow_cast<DWORD>(str.size()), nullptr, nullptr));
+    }
+
+    // Method Description:
+    // - Passes output that didn't come from the client, like our own messages, to our
+    //   registered event handlers. TerminalOutputBuffer handlers get a copy of it.
+    // Arguments:
+    // - text: the output.
+    void ConptyConnection::_raiseOutput(const std::wstring_view text)
+    {
+        _TerminalOutputHandlers(text);
+        if (_TerminalOutputBufferHandlers)
+        {
+            auto buffer = _outputPool->Take();
+            buffer.assign(text);
+            _TerminalOutputBufferHandlers(winrt::make<TerminalOutputBuffer>(_outputPool, std::move(buffer)));
+        }
+    }
+
+    // Method Description:
+    // - Passes the output of the client, which was just decoded into _u16Str, to our
+    //   registered event handlers. TerminalOutputBuffer handlers get _u16Str itself,
+    //   which is replaced with storage from the pool, so that it isn't copied.
+    void ConptyConnection::_raiseDecodedOutput()
+    {
+        if (_TerminalOutputHandlers)
+        {
+            _TerminalOutputHandlers(_u16Str);
+        }
+        if (_TerminalOutputBufferHandlers)
+        {
+            auto text = std::exchange(_u16Str, _outputPool->Take());
+            _TerminalOutputBufferHandlers(winrt::make<TerminalOutputBuffer>(_outputPool, std::move(text)));
+        }
+    }
+
     void ConptyConnection::Resize(uint32_t rows, uint32_t columns)
     {
         // If we haven't started connecting at all, it's still fair to update
@@ -523,6 +629,24 @@ namespace winrt::Microsoft::Terminal::TerminalConnection::implementation
 
             _hPC.reset(); // tear down the pseudoconsole (this is like clicking X on a console window)
 
+            if (_overlappedIo)
+            {
+                // Cancel whatever I/O is in flight and wait for it to run down, before its pipes go away.
+                if (_inputIo)
+                {
+                    {
+                        std::lock_guard guard{ _inputLock };
+                        CancelIoEx(_inPipe.get(), nullptr);
+                    }
+                    WaitForThreadpoolIoCallbacks(_inputIo.get(), FALSE);
+                }
+                if (_outputDrained)
+                {
+                    CancelIoEx(_outPipe.get(), nullptr);
+                    LOG_LAST_ERROR_IF(WAIT_FAILED == WaitForSingleObject(_outputDrained.get(), INFINITE));
+                }
+            }
+
             _inPipe.reset(); // break the pipes
             _outPipe.reset();
 
@@ -534,6 +658,13 @@ namespace winrt::Microsoft::Terminal::TerminalConnection::implementation
                 _hOutputThread.reset();
             }
 
+            if (_hParseThread)
+            {
+                // The parse thread exits once it has consumed everything the output thread read.
+                LOG_LAST_ERROR_IF(WAIT_FAILED == WaitForSingleObject(_hParseThread.get(), INFINITE));
+                _hParseThread.reset();
+            }
+
             if (_piClient.hProcess)
             {
                 // Wait for the client to terminate (which it should do successfully)
@@ -546,13 +677,93 @@ namespace winrt::Microsoft::Terminal::TerminalConnection::implementation
     }
     CATCH_LOG()
 
+    // Method Description:
+    // - Starts logging the output to <session GUID>.log in _sessionLogDirectory,
+    //   if there is one. Failing to do so doesn't fail the connection.
+    void ConptyConnection::_startSessionLog() noexcept
+    try
+    {
+        if (_sessionLogDirectory.empty())
+        {
+            return;
+        }
+
+        std::filesystem::path path{ wil::ExpandEnvironmentStringsW<std::wstring>(_sessionLogDirectory.c_str()) };
+        std::filesystem::create_directories(path);
+        path /= Utils::GuidToString(_guid) + L".log";
+        _sessionLog = std::make_unique<SessionLog>(path.wstring());
+    }
+    CATCH_LOG()
+
+    // Method Description:
+    // - Starts the output and parse threads, for pipes that don't support overlapped I/O.
+    void ConptyConnection::_startOutputThreads()
+    {
+        _buffer.resize(InitialOutputBufferSize);
+
+        auto [outputChunkProducer, outputChunkConsumer] = til::spsc::channel<OutputChunk>(OutputChunkCapacity);
+        _outputChunkProducer.emplace(std::move(outputChunkProducer));
+        _outputChunkConsumer.emplace(std::move(outputChunkConsumer));
+
+        // Create our own output handling threads
+        // This must be done after the pipes are populated.
+        // Each connection needs to make sure to drain the output from its backing host.
+        _hParseThread.reset(CreateThread(
+            nullptr,
+            0,
+            [](LPVOID lpParameter) noexcept {
+                ConptyConnection* const pInstance = static_cast<ConptyConnection*>(lpParameter);
+                if (pInstance)
+                {
+                    return pInstance->_ParseThread();
+                }
+                return gsl::narrow_cast<DWORD>(E_INVALIDARG);
+            },
+            this,
+            0,
+            nullptr));
+
+        THROW_LAST_ERROR_IF_NULL(_hParseThread);
+
+        LOG_IF_FAILED(SetThreadDescription(_hParseThread.get(), L"ConptyConnection Parse Thread"));
+
+        _hOutputThread.reset(CreateThread(
+            nullptr,
+            0,
+            [](LPVOID lpParameter) noexcept {
+                ConptyConnection* const pInstance = static_cast<ConptyConnection*>(lpParameter);
+                if (pInstance)
+                {
+                    return pInstance->_OutputThread();
+                }
+                return gsl::narrow_cast<DWORD>(E_INVALIDARG);
+            },
+            this,
+            0,
+            nullptr));
+
+        THROW_LAST_ERROR_IF_NULL(_hOutputThread);
+
+        LOG_IF_FAILED(SetThreadDescription(_hOutputThread.get(), L"ConptyConnection Output Thread"));
+    }
+
     DWORD ConptyConnection::_OutputThread()
     {
         // Keep us alive until the output thread terminates; the destructor
         // won't wait for us, and the known exit points _do_.
         auto strongThis{ get_strong() };
 
-        // process the data of the output pipe in a loop
+        ::Microsoft::Console::Types::ThreadScheduling::CurrentThread scheduling;
+        if (_interactiveThreads)
+        {
+            scheduling.Apply(::Microsoft::Console::Types::ThreadScheduling::Class::Interactive);
+        }
+
+        // Dropping the producer tells the parse thread that no more output is coming.
+        const auto dropProducer = wil::scope_exit([&]() noexcept { _outputChunkProducer.reset(); });
+        const auto& producer = *_outputChunkProducer;
+
+        // read the data of the output pipe in a loop
         while (true)
         {
             DWORD read{};
@@ -563,15 +774,68 @@ namespace winrt::Microsoft::Terminal::TerminalConnection::implementation
                 const auto lastError = GetLastError();
                 if (lastError != ERROR_BROKEN_PIPE && !_isStateAtOrBeyond(ConnectionState::Closing))
                 {
-                    // EXIT POINT
-                    _indicateExitWithStatus(HRESULT_FROM_WIN32(lastError)); // print a message
-                    _transitionToState(ConnectionState::Failed);
-                    return gsl::narrow_cast<DWORD>(HRESULT_FROM_WIN32(lastError));
+                    // Let the parse thread report the failure after the output that preceded it.
+                    const auto result = HRESULT_FROM_WIN32(lastError);
+                    producer.emplace(OutputChunk{ {}, result });
+                    return gsl::narrow_cast<DWORD>(result);
                 }
-                // else we call convertUTF8ChunkToUTF16 with an empty string_view to convert possible remaining partials to U+FFFD
+                return 0;
+            }
+
+            if (read == 0)
+            {
+                return 0;
+            }
+
+            _receivedOutput();
+
+            const auto length = _coalesceOutput(read);
+            if (_sessionLog)
+            {
+                _sessionLog->Append({ _buffer.data(), length });
+            }
+
+            // This only blocks if the parse thread fell OutputChunkCapacity chunks behind,
+            // and only fails if the parse thread is gone, because it failed itself.
+            if (!producer.emplace(OutputChunk{ std::string{ _buffer.data(), length } }))
+            {
+                return 0;
+            }
+        }
+    }
+
+    DWORD ConptyConnection::_ParseThread()
+    {
+        // Keep us alive until the parse thread terminates; the destructor
+        // won't wait for us, and the known exit points _do_.
+        auto strongThis{ get_strong() };
+
+        // The output is only echoed once we parsed it, so we're just as interactive as the output thread.
+        ::Microsoft::Console::Types::ThreadScheduling::CurrentThread scheduling;
+        if (_interactiveThreads)
+        {
+            scheduling.Apply(::Microsoft::Console::Types::ThreadScheduling::Class::Interactive);
+        }
+
+        // Dropping the consumer makes the output thread stop, in case we fail first.
+        const auto dropConsumer = wil::scope_exit([&]() noexcept { _outputChunkConsumer.reset(); });
+        const auto& consumer = *_outputChunkConsumer;
+
+        // process the output read by the output thread in a loop
+        while (true)
+        {
+            const auto chunk = consumer.pop();
+            if (chunk && FAILED(chunk->result))
+            {
+                // EXIT POINT
+                _indicateExitWithStatus(chunk->result); // print a message
+                _transitionToState(ConnectionState::Failed);
+                return gsl::narrow_cast<DWORD>(chunk->result);
             }
 
-            const HRESULT result{ til::u8u16(std::string_view{ _buffer.data(), read }, _u16Str, _u8State) };
+            // Once the output thread is done, we call u8u16 with an empty string_view to convert possible remaining partials to U+FFFD
+            const auto text = chunk ? std::string_view{ chunk->text } : std::string_view{};
+            const HRESULT result{ til::u8u16(text, _u16Str, _u8State) };
             if (FAILED(result))
             {
                 if (_isStateAtOrBeyond(ConnectionState::Closing))
@@ -586,32 +850,306 @@ namespace winrt::Microsoft::Terminal::TerminalConnection::implementation
                 return gsl::narrow_cast<DWORD>(result);
             }
 
-            if (_u16Str.empty())
+            if (!_u16Str.empty())
+            {
+                // Pass the output to our registered event handlers
+                _raiseDecodedOutput();
+            }
+
+            if (!chunk)
             {
                 return 0;
             }
+        }
+    }
+
+    // Method Description:
+    // - Reads the output that's already waiting in the pipe, after a read put the
+    //   first `length` bytes into _buffer, so that it can all be passed on at once.
+    //   Grows _buffer if needed. Reading stops once the pipe is empty, _buffer
+    //   can't grow any further, or OutputCoalesceBudget has passed.
+    // - If reading the pipe fails here, the next regular read will fail the same way.
+    // Arguments:
+    // - length: the number of bytes in _buffer already.
+    // Return Value:
+    // - The number of bytes in _buffer now.
+    size_t ConptyConnection::_coalesceOutput(size_t length) noexcept
+    {
+        const auto deadline = std::chrono::steady_clock::now() + OutputCoalesceBudget;
+
+        while (length < MaxOutputBufferSize && std::chrono::steady_clock::now() < deadline)
+        {
+            DWORD available{};
+            if (!PeekNamedPipe(_outPipe.get(), nullptr, 0, nullptr, &available, nullptr) || available == 0)
+            {
+                break;
+            }
 
-            if (!_receivedFirstByte)
+            if (length == _buffer.size())
             {
-                const auto now = std::chrono::high_resolution_clock::now();
-                const std::chrono::duration<double> delta = now - _startTime;
+                try
+                {
+                    _buffer.resize(std::min(_buffer.size() * 2, MaxOutputBufferSize));
+                }
+                catch (...)
+                {
+                    LOG_CAUGHT_EXCEPTION();
+                    break;
+                }
+            }
+
+            const auto toRead = gsl::narrow_cast<DWORD>(std::min<size_t>(available, _buffer.size() - length));
+            DWORD read{};
+
+            if (_overlappedIo)
+            {
+                // Setting the low-order bit of the event keeps the completion of this read from
+                // being queued to the threadpool. The data is already there, so waiting is cheap.
+                OVERLAPPED overlapped{};
+                overlapped.hEvent = reinterpret_cast<HANDLE>(reinterpret_cast<uintptr_t>(_coalesceEvent.get()) | 1);
+                if (!ReadFile(_outPipe.get(), _buffer.data() + length, toRead, nullptr, &overlapped) && GetLastError() != ERROR_IO_PENDING)
+                {
+                    break;
+                }
+                if (!GetOverlappedResult(_outPipe.get(), &overlapped, &read, TRUE))
+                {
+                    break;
+                }
+            }
+            else if (!ReadFile(_outPipe.get(), _buffer.data() + length, toRead, &read, nullptr))
+            {
+                break;
+            }
+
+            if (read == 0)
+            {
+                break;
+            }
+
+            length += read;
+        }
+
+        return length;
+    }
+
+    // Method Description:
+    // - Emits the ReceivedFirstByte event the first time the connection receives output.
+    void ConptyConnection::_receivedOutput() noexcept
+    {
+        if (!_receivedFirstByte)
+        {
+            const auto now = std::chrono::high_resolution_clock::now();
+            const std::chrono::duration<double> delta = now - _startTime;
 
 #pragma warning(suppress : 26477 26485 26494 26482 26446) // We don't control TraceLoggingWrite
-                TraceLoggingWrite(g_hTerminalConnectionProvider,
-                                  "ReceivedFirstByte",
-                                  TraceLoggingDescription("An event emitted when the connection receives the first byte"),
-                                  TraceLoggingGuid(_guid, "SessionGuid", "The WT_SESSION's GUID"),
-                                  TraceLoggingFloat64(delta.count(), "Duration"),
-                                  TraceLoggingKeyword(MICROSOFT_KEYWORD_MEASURES),
-                                  TelemetryPrivacyDataTag(PDT_ProductAndServicePerformance));
-                _receivedFirstByte = true;
+            TraceLoggingWrite(g_hTerminalConnectionProvider,
+                              "ReceivedFirstByte",
+                              TraceLoggingDescription("An event emitted when the connection receives the first byte"),
+                              TraceLoggingGuid(_guid, "SessionGuid", "The WT_SESSION's GUID"),
+                              TraceLoggingFloat64(delta.count(), "Duration"),
+                              TraceLoggingKeyword(MICROSOFT_KEYWORD_MEASURES),
+                              TelemetryPrivacyDataTag(PDT_ProductAndServicePerformance));
+            _receivedFirstByte = true;
+        }
+    }
+
+    // Method Description:
+    // - Sets up the threadpool I/O for our overlapped pipes and starts reading the output.
+    //   Until the reads run out, they keep the connection alive in _outputStrongThis,
+    //   like the output thread does.
+    void ConptyConnection::_startOverlappedIo()
+    {
+        _outputIo.reset(CreateThreadpoolIo(
+            _outPipe.get(),
+            [](PTP_CALLBACK_INSTANCE callbackInstance, PVOID context, PVOID /*overlapped*/, ULONG ioResult, ULONG_PTR bytesTransferred, PTP_IO /*io*/) noexcept {
+                // Raising TerminalOutput may take a while. Let the threadpool
+                // know, so that the output of other connections doesn't wait.
+                CallbackMayRunLong(callbackInstance);
+                static_cast<ConptyConnection*>(context)->_outputIoCompleted(callbackInstance, ioResult, bytesTransferred);
+            },
+            this,
+            nullptr));
+        THROW_LAST_ERROR_IF_NULL(_outputIo);
+
+        _inputIo.reset(CreateThreadpoolIo(
+            _inPipe.get(),
+            [](PTP_CALLBACK_INSTANCE /*callbackInstance*/, PVOID context, PVOID /*overlapped*/, ULONG ioResult, ULONG_PTR /*bytesTransferred*/, PTP_IO /*io*/) noexcept {
+                static_cast<ConptyConnection*>(context)->_inputIoCompleted(ioResult);
+            },
+            this,
+            nullptr));
+        THROW_LAST_ERROR_IF_NULL(_inputIo);
+
+        _buffer.resize(InitialOutputBufferSize);
+        _coalesceEvent.create(wil::EventOptions::ManualReset);
+
+        // Once this exists, the reads are running and will set it eventually.
+        _outputDrained.create(wil::EventOptions::ManualReset);
+        _outputStrongThis = get_strong();
+        _readOutputOverlapped(nullptr);
+    }
+
+    void ConptyConnection::_readOutputOverlapped(const PTP_CALLBACK_INSTANCE callbackInstance) noexcept
+    {
+        StartThreadpoolIo(_outputIo.get());
+        _outputOverlapped = {};
+        if (!ReadFile(_outPipe.get(), _buffer.data(), gsl::narrow_cast<DWORD>(_buffer.size()), nullptr, &_outputOverlapped))
+        {
+            const auto lastError = GetLastError();
+            if (lastError != ERROR_IO_PENDING)
+            {
+                CancelThreadpoolIo(_outputIo.get());
+                _outputEnded(callbackInstance, lastError);
             }
+        }
+    }
 
-            // Pass the output to our registered event handlers
-            _TerminalOutputHandlers(_u16Str);
+    void ConptyConnection::_outputIoCompleted(const PTP_CALLBACK_INSTANCE callbackInstance, const ULONG ioResult, const ULONG_PTR bytesTransferred) noexcept
+    {
+        if (ioResult != NO_ERROR || bytesTransferred == 0)
+        {
+            _outputEnded(callbackInstance, ioResult);
+            return;
+        }
+
+        _receivedOutput();
+
+        const auto length = _coalesceOutput(bytesTransferred);
+        if (_sessionLog)
+        {
+            _sessionLog->Append({ _buffer.data(), length });
+        }
+        const HRESULT result{ til::u8u16({ _buffer.data(), length }, _u16Str, _u8State) };
+        if (FAILED(result))
+        {
+            if (!_isStateAtOrBeyond(ConnectionState::Closing))
+            {
+                // EXIT POINT
+                _indicateExitWithStatus(result); // print a message
+                _transitionToState(ConnectionState::Failed);
+            }
+            _outputEnded(callbackInstance, ERROR_OPERATION_ABORTED);
+            return;
+        }
+
+        if (!_u16Str.empty())
+        {
+            try
+            {
+                // Pass the output to our registered event handlers
+                _raiseDecodedOutput();
+            }
+            CATCH_LOG();
+        }
+
+        _readOutputOverlapped(callbackInstance);
+    }
+
+    // Method Description:
+    // - Called once reading the output stopped, be it because the pipe was closed
+    //   or because reading it failed. Wakes up whoever waits for the output to drain.
+    // Arguments:
+    // - callbackInstance: the threadpool callback we're called from, if any.
+    // - ioResult: the error that made the last read fail, if any.
+    void ConptyConnection::_outputEnded(const PTP_CALLBACK_INSTANCE callbackInstance, const ULONG ioResult) noexcept
+    {
+        // This may be the last reference to us. It's released when we return.
+        const auto strongThis = std::move(_outputStrongThis);
+
+        if (ioResult != NO_ERROR && ioResult != ERROR_BROKEN_PIPE && ioResult != ERROR_OPERATION_ABORTED && !_isStateAtOrBeyond(ConnectionState::Closing))
+        {
+            // EXIT POINT
+            _indicateExitWithStatus(HRESULT_FROM_WIN32(ioResult)); // print a message
+            _transitionToState(ConnectionState::Failed);
+        }
+        else
+        {
+            try
+            {
+                // Convert possible remaining partials to U+FFFD
+                if (SUCCEEDED(til::u8u16({}, _u16Str, _u8State)) && !_u16Str.empty())
+                {
+                    _raiseDecodedOutput();
+                }
+            }
+            CATCH_LOG();
         }
 
-        return 0;
+        // Once this is set, Close() returns and our owner may let go of us.
+        // Nothing but strongThis may be touched after this point.
+        _outputDrained.SetEvent();
+
+        // Our destructor waits for the callbacks of _outputIo to finish. If it ends
+        // up running when strongThis is released, it mustn't wait for this one.
+        if (callbackInstance)
+        {
+            DisassociateCurrentThreadFromCallback(callbackInstance);
+        }
+    }
+
+    void ConptyConnection::_writeInputOverlapped(std::string&& str)
+    {
+        std::lock_guard guard{ _inputLock };
+
+        // Close() cancels the write in flight under this lock. Don't start another one after it.
+        if (_isStateAtOrBeyond(ConnectionState::Closing))
+        {
+            return;
+        }
+
+        if (_inputWriteActive)
+        {
+            _inputQueued.append(str);
+            return;
+        }
+
+        _inputWriting = std::move(str);
+        _startInputWrite();
+    }
+
+    // Method Description:
+    // - Starts writing _inputWriting. _inputLock must be held.
+    void ConptyConnection::_startInputWrite() noexcept
+    {
+        _inputWriteActive = true;
+
+        StartThreadpoolIo(_inputIo.get());
+        _inputOverlapped = {};
+        if (!WriteFile(_inPipe.get(), _inputWriting.data(), gsl::narrow_cast<DWORD>(_inputWriting.size()), nullptr, &_inputOverlapped))
+        {
+            const auto lastError = GetLastError();
+            if (lastError != ERROR_IO_PENDING)
+            {
+                CancelThreadpoolIo(_inputIo.get());
+                LOG_WIN32(lastError);
+                _inputWriteActive = false;
+                _inputQueued.clear();
+            }
+        }
+    }
+
+    void ConptyConnection::_inputIoCompleted(const ULONG ioResult) noexcept
+    {
+        std::lock_guard guard{ _inputLock };
+        _inputWriteActive = false;
+
+        if (ioResult != NO_ERROR)
+        {
+            if (ioResult != ERROR_OPERATION_ABORTED && ioResult != ERROR_BROKEN_PIPE)
+            {
+                LOG_WIN32(ioResult);
+            }
+            _inputQueued.clear();
+            return;
+        }
+
+        if (!_inputQueued.empty() && !_isStateAtOrBeyond(ConnectionState::Closing))
+        {
+            // Swapping the strings reuses their buffers for the next writes.
+            std::swap(_inputWriting, _inputQueued);
+            _inputQueued.clear();
+            _startInputWrite();
+        }
     }
 
     static winrt::event<NewConnectionHandler> _newConnectionHandlers;
@@ -639,6 +1177,143 @@ namespace winrt::Microsoft::Terminal::TerminalConnection::implementation
         THROW_IF_FAILED(CTerminalHandoff::s_StopListening());
     }
 
+    // Pseudoconsoles that were created ahead of time, so that starting a
+    // connection doesn't have to wait for conhost to launch. The pipes a
+    // conhost talks through can't be replaced once it's running, so they're
+    // created along with it and kept here too. None of them has a client yet.
+    struct PreparedPseudoConsole
+    {
+        // Declared first so that it's closed last: ConptyClosePseudoConsole
+        // waits for conhost to exit, which it can't while it's blocked on
+        // writing to an output pipe that nobody reads.
+        wil::unique_static_pseudoconsole_handle hPC;
+        wil::unique_hfile inPipe;
+        wil::unique_hfile outPipe;
+    };
+
+    static struct
+    {
+        std::mutex lock;
+        std::vector<PreparedPseudoConsole> consoles;
+        size_t count{ 0 };
+        COORD size{};
+        bool maintaining{ false };
+    } _preparedPseudoConsoles;
+
+    // Function Description:
+    // - Keeps the given number of pseudoconsoles around, which connections
+    //   started from now on take instead of creating their own. They're
+    //   created and closed in the background.
+    // Arguments:
+    // - count: The number of pseudoconsoles to keep around. 0 closes all of them.
+    // - rows, columns: The size to create them with. Connections of a different
+    //   size resize the one they take.
+    void ConptyConnection::PreparePseudoConsoles(uint32_t count, uint32_t rows, uint32_t columns)
+    {
+        {
+            std::lock_guard guard{ _preparedPseudoConsoles.lock };
+            _preparedPseudoConsoles.count = count;
+            _preparedPseudoConsoles.size = { Utils::ClampToShortMax(columns, 1), Utils::ClampToShortMax(rows, 1) };
+            if (_preparedPseudoConsoles.maintaining || _preparedPseudoConsoles.consoles.size() == count)
+            {
+                return;
+            }
+            _preparedPseudoConsoles.maintaining = true;
+        }
+        _maintainPreparedPseudoConsoles();
+    }
+
+    // Method Description:
+    // - Creates or closes prepared pseudoconsoles, one at a time, until there
+    //   are as many as PreparePseudoConsoles asked for.
+    winrt::fire_and_forget ConptyConnection::_maintainPreparedPseudoConsoles()
+    {
+        co_await winrt::resume_background();
+
+        for (;;)
+        {
+            PreparedPseudoConsole console;
+            COORD size{};
+            {
+                std::lock_guard guard{ _preparedPseudoConsoles.lock };
+                auto& consoles = _preparedPseudoConsoles.consoles;
+                if (consoles.size() == _preparedPseudoConsoles.count)
+                {
+                    _preparedPseudoConsoles.maintaining = false;
+                    co_return;
+                }
+                if (consoles.size() > _preparedPseudoConsoles.count)
+                {
+                    // Closed outside of the lock, once it goes out of scope.
+                    console = std::move(consoles.back());
+                    consoles.pop_back();
+                    continue;
+                }
+                size = _preparedPseudoConsoles.size;
+            }
+
+            const auto hr = _CreatePseudoConsoleAndPipes(size, PseudoConsoleFlags, &console.inPipe, &console.outPipe, &console.hPC);
+
+            std::lock_guard guard{ _preparedPseudoConsoles.lock };
+            if (FAILED(hr))
+            {
+                // We'll try again the next time a connection takes one.
+                LOG_HR(hr);
+                _preparedPseudoConsoles.maintaining = false;
+                co_return;
+            }
+            _preparedPseudoConsoles.consoles.emplace_back(std::move(console));
+        }
+    }
+
+    // Method Description:
+    // - Takes one of the pseudoconsoles created by PreparePseudoConsoles, if
+    //   there is one, and resizes it to the size of this connection. Another
+    //   one is created in its place in the background.
+    // Arguments:
+    // - size: The size of this connection, in characters.
+    // Return Value:
+    // - true if _hPC and our pipes now belong to a prepared pseudoconsole.
+    bool ConptyConnection::_takePreparedPseudoConsole(const COORD size) noexcept
+    try
+    {
+        PreparedPseudoConsole console;
+        auto maintain = false;
+        {
+            std::lock_guard guard{ _preparedPseudoConsoles.lock };
+            auto& consoles = _preparedPseudoConsoles.consoles;
+            if (consoles.empty())
+            {
+                return false;
+            }
+            console = std::move(consoles.back());
+            consoles.pop_back();
+            maintain = !_preparedPseudoConsoles.maintaining;
+            _preparedPseudoConsoles.maintaining = true;
+        }
+
+        if (maintain)
+        {
+            _maintainPreparedPseudoConsoles();
+        }
+
+        // This only fails if the conhost went away in the meantime.
+        if (FAILED(LOG_IF_FAILED(ConptyResizePseudoConsole(console.hPC.get(), size))))
+        {
+            return false;
+        }
+
+        _hPC = std::move(console.hPC);
+        _inPipe = std::move(console.inPipe);
+        _outPipe = std::move(console.outPipe);
+        return true;
+    }
+    catch (...)
+    {
+        LOG_CAUGHT_EXCEPTION();
+        return false;
+    }
+
     // Function Description:
     // - This function will be called (by C++/WinRT) after the final outstanding reference to
     //   any given connection instance is released.
@@ -5,6 +5,8 @@
 
 #include "ConptyConnection.g.h"
 #include "ConnectionStateHolder.h"
+#include "SessionLog.h"
+#include "TerminalOutputBuffer.h"
 #include "../inc/cppwinrt_utils.h"
 
 #include <conpty-static.h>
@@ -33,6 +35,7 @@ namespace winrt::Microsoft::Terminal::TerminalConnection::implementation
 
         void Start();
         void WriteInput(hstring const& data);
+        void WriteInputBytes(winrt::array_view<const uint8_t> data);
         void Resize(uint32_t rows, uint32_t columns);
         void Close() noexcept;
 
@@ -41,6 +44,8 @@ namespace winrt::Microsoft::Terminal::TerminalConnection::implementation
         static void StartInboundListener();
         static void StopInboundListener();
 
+        static void PreparePseudoConsoles(uint32_t count, uint32_t rows, uint32_t columns);
+
         static winrt::event_token NewConnection(NewConnectionHandler const& handler);
         static void NewConnection(winrt::event_token const& token);
 
@@ -53,6 +58,7 @@ namespace winrt::Microsoft::Terminal::TerminalConnection::implementation
                                                                          winrt::guid const& guid);
 
         WINRT_CALLBACK(TerminalOutput, TerminalOutputHandler);
+        WINRT_CALLBACK(TerminalOutputBuffer, TerminalOutputBufferHandler);
 
     private:
         HRESULT _LaunchAttachedClient() noexcept;
@@ -61,12 +67,19 @@ namespace winrt::Microsoft::Terminal::TerminalConnection::implementation
 
         static HRESULT NewHandoff(HANDLE in, HANDLE out, HANDLE signal, HANDLE ref, HANDLE server, HANDLE client) noexcept;
 
+        bool _takePreparedPseudoConsole(const COORD size) noexcept;
+        static winrt::fire_and_forget _maintainPreparedPseudoConsoles();
+
+        void _receivedOutput() noexcept;
+
         uint32_t _initialRows{};
         uint32_t _initialCols{};
         hstring _commandline{};
         hstring _startingDirectory{};
         hstring _startingTitle{};
         Windows::Foundation::Collections::ValueSet _environment{ nullptr };
+        hstring _sessionLogDirectory{};
+        bool _interactiveThreads{ false };
         guid _guid{}; // A unique session identifier for connected client
         hstring _clientName{}; // The name of the process hosted by this ConPTY connection (as of launch).
 
@@ -76,15 +89,85 @@ namespace winrt::Microsoft::Terminal::TerminalConnection::implementation
         wil::unique_hfile _inPipe; // The pipe for writing input to
         wil::unique_hfile _outPipe; // The pipe for reading output from
         wil::unique_handle _hOutputThread;
+        wil::unique_handle _hParseThread;
         wil::unique_process_information _piClient;
         wil::unique_static_pseudoconsole_handle _hPC;
         wil::unique_threadpool_wait _clientExitWait;
 
         til::u8state _u8State{};
         std::wstring _u16Str{};
-        std::array<char, 4096> _buffer{};
 
+        // The output is decoded into _u16Str. TerminalOutputBuffer handlers get
+        // handed that string itself, and it's replaced with one from the pool.
+        std::shared_ptr<TerminalOutputBufferPool> _outputPool{ std::make_shared<TerminalOutputBufferPool>() };
+
+        void _raiseOutput(const std::wstring_view text);
+        void _raiseDecodedOutput();
+
+        // After every read, whatever else is already waiting in the pipe is read
+        // right away as well, so that TerminalOutput is raised with as much of the
+        // output as possible at once. _buffer starts out at InitialOutputBufferSize
+        // and doubles whenever that isn't enough, up to MaxOutputBufferSize. Reading
+        // stops early once OutputCoalesceBudget has passed, so that a client that
+        // never stops writing doesn't hold back its output indefinitely.
+        static constexpr size_t InitialOutputBufferSize{ 4 * 1024 };
+        static constexpr size_t MaxOutputBufferSize{ 1024 * 1024 };
+        static constexpr auto OutputCoalesceBudget{ std::chrono::milliseconds(8) };
+        std::string _buffer;
+        wil::unique_event _coalesceEvent; // Only used for the reads of overlapped pipes.
+
+        size_t _coalesceOutput(size_t length) noexcept;
+
+        // If the profile asked for it, the output is logged as it was read from
+        // the pipe, before it's decoded. See SessionLog.
+        std::unique_ptr<SessionLog> _sessionLog;
+
+        void _startSessionLog() noexcept;
+
+        // The output thread only drains _outPipe and hands what it read to the
+        // parse thread, which decodes it and raises TerminalOutput. This way a slow
+        // consumer of TerminalOutput doesn't keep the pipe from being drained,
+        // unless it falls more than OutputChunkCapacity chunks behind.
+        struct OutputChunk
+        {
+            std::string text;
+            HRESULT result{ S_OK }; // The last chunk carries the error if reading the pipe failed.
+        };
+        static constexpr uint32_t OutputChunkCapacity{ 256 };
+        std::optional<til::spsc::producer<OutputChunk>> _outputChunkProducer;
+        std::optional<til::spsc::consumer<OutputChunk>> _outputChunkConsumer;
+
+        void _startOutputThreads();
         DWORD _OutputThread();
+        DWORD _ParseThread();
+
+        // If we created the pipes ourselves, they're opened for overlapped I/O.
+        // Instead of the two threads above, the reads and writes of all such
+        // connections then complete on the process' shared threadpool. Only one
+        // read and one write is in flight at a time. The read decodes the output
+        // and raises TerminalOutput right in its completion callback, while the
+        // pipe's buffer keeps conpty from blocking in the meantime. Input written
+        // while a write is in flight is queued up and written in one go after it.
+        bool _overlappedIo{ false };
+        wil::unique_threadpool_io _outputIo;
+        OVERLAPPED _outputOverlapped{};
+        winrt::com_ptr<ConptyConnection> _outputStrongThis;
+        wil::unique_event _outputDrained;
+
+        wil::unique_threadpool_io _inputIo;
+        OVERLAPPED _inputOverlapped{};
+        std::mutex _inputLock;
+        std::string _inputWriting;
+        std::string _inputQueued;
+        bool _inputWriteActive{ false };
+
+        void _startOverlappedIo();
+        void _readOutputOverlapped(const PTP_CALLBACK_INSTANCE callbackInstance) noexcept;
+        void _outputIoCompleted(const PTP_CALLBACK_INSTANCE callbackInstance, const ULONG ioResult, const ULONG_PTR bytesTransferred) noexcept;
+        void _outputEnded(const PTP_CALLBACK_INSTANCE callbackInstance, const ULONG ioResult) noexcept;
+        void _writeInputOverlapped(std::string&& str);
+        void _startInputWrite() noexcept;
+        void _inputIoCompleted(const ULONG ioResult) noexcept;
     };
 }
 
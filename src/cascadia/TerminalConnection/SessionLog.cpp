@@ -0,0 +1,88 @@
+// Copyright (c) Microsoft Corporation.
+// Licensed under the MIT license.
+
+#include "pch.h"
+#include "SessionLog.h"
+
+// Routine Description:
+// - Opens (or creates) the file at the given path and starts the writer thread.
+//   Output is appended to whatever the file already contains.
+// Arguments:
+// - path: the file to log to.
+SessionLog::SessionLog(const std::wstring& path)
+{
+    _file.reset(CreateFileW(path.c_str(), FILE_APPEND_DATA, FILE_SHARE_READ, nullptr, OPEN_ALWAYS, FILE_ATTRIBUTE_NORMAL | FILE_FLAG_SEQUENTIAL_SCAN, nullptr));
+    THROW_LAST_ERROR_IF(!_file);
+
+    auto [producer, consumer] = til::spsc::channel<char>(RingCapacity);
+    _producer.emplace(std::move(producer));
+    _consumer.emplace(std::move(consumer));
+
+    _hWriterThread.reset(CreateThread(
+        nullptr,
+        0,
+        [](LPVOID lpParameter) noexcept {
+            return static_cast<SessionLog*>(lpParameter)->_WriterThread();
+        },
+        this,
+        0,
+        nullptr));
+    THROW_LAST_ERROR_IF_NULL(_hWriterThread);
+
+    LOG_IF_FAILED(SetThreadDescription(_hWriterThread.get(), L"SessionLog Writer Thread"));
+}
+
+SessionLog::~SessionLog()
+{
+    // Dropping the producer lets the writer thread exit, once it wrote whatever's left in the ring.
+    _producer.reset();
+    LOG_LAST_ERROR_IF(WAIT_FAILED == WaitForSingleObject(_hWriterThread.get(), INFINITE));
+
+    if (_droppedBytes)
+    {
+#pragma warning(suppress : 26477 26485 26494 26482 26446) // We don't control TraceLoggingWrite
+        TraceLoggingWrite(g_hTerminalConnectionProvider,
+                          "SessionLogDroppedOutput",
+                          TraceLoggingDescription("Event emitted when a session log couldn't keep up with the output"),
+                          TraceLoggingUInt64(_droppedBytes, "DroppedBytes"));
+    }
+}
+
+// Routine Description:
+// - Queues up output to be written to the log. Never blocks. Whatever doesn't
+//   fit into the ring, because the writer thread fell behind, is left out.
+//   Must only be called from one thread at a time.
+// Arguments:
+// - text: the output, as it was received.
+void SessionLog::Append(const std::string_view text) noexcept
+try
+{
+    const auto written = _producer->push_n(til::spsc::block_never, text.data(), text.size()).first;
+    _droppedBytes += text.size() - written;
+}
+CATCH_LOG()
+
+DWORD SessionLog::_WriterThread() noexcept
+{
+    const auto& consumer = *_consumer;
+    const auto buffer = std::make_unique<char[]>(MaxWriteSize);
+    auto failed = false;
+
+    while (true)
+    {
+        // This blocks until at least one byte is there, and then takes everything else that accumulated meanwhile.
+        const auto [read, ok] = consumer.pop_n(til::spsc::block_initially, buffer.get(), MaxWriteSize);
+        if (read && !failed)
+        {
+            DWORD written{};
+            // Once writing failed, we keep draining the ring, so that Append() doesn't
+            // have to know about it, but we don't try to write anymore.
+            failed = !WriteFile(_file.get(), buffer.get(), gsl::narrow_cast<DWORD>(read), &written, nullptr);
+            LOG_LAST_ERROR_IF(failed);
+        }
+        if (!ok)
+        {
+            return 0;
+        }
+    }
+}
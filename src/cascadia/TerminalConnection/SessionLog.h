@@ -0,0 +1,45 @@
+/*++
+Copyright (c) Microsoft Corporation
+Licensed under the MIT license.
+
+Module Name:
+- SessionLog.h
+
+Abstract:
+- Logs the raw output of a connection to a file, as it was received.
+- The thread that reads the connection only ever copies the output into a
+  lock-free ring buffer. A writer thread of its own drains the ring and
+  writes to the file in as large pieces as have accumulated in the meantime.
+  Writing the file thus never holds up reading the connection: if the disk
+  can't keep up and the ring is full, the output that doesn't fit is left out
+  of the log, and the number of bytes that were left out is traced.
+
+--*/
+
+#pragma once
+
+class SessionLog
+{
+public:
+    explicit SessionLog(const std::wstring& path);
+    ~SessionLog();
+
+    SessionLog(const SessionLog&) = delete;
+    SessionLog& operator=(const SessionLog&) = delete;
+    SessionLog(SessionLog&&) = delete;
+    SessionLog& operator=(SessionLog&&) = delete;
+
+    void Append(const std::string_view text) noexcept;
+
+private:
+    static constexpr uint32_t RingCapacity{ 4 * 1024 * 1024 };
+    static constexpr size_t MaxWriteSize{ 1024 * 1024 };
+
+    DWORD _WriterThread() noexcept;
+
+    wil::unique_hfile _file;
+    std::optional<til::spsc::producer<char>> _producer;
+    std::optional<til::spsc::consumer<char>> _consumer;
+    wil::unique_handle _hWriterThread;
+    uint64_t _droppedBytes{ 0 };
+};
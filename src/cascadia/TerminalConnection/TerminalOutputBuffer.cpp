@@ -0,0 +1,102 @@
+// Copyright (c) Microsoft Corporation.
+// Licensed under the MIT license.
+
+#include "pch.h"
+#include "TerminalOutputBuffer.h"
+
+namespace winrt::Microsoft::Terminal::TerminalConnection::implementation
+{
+    // Method Description:
+    // - Gets storage to decode output into, preferably one that was used before.
+    // Return Value:
+    // - An empty string, which may have some capacity already.
+    std::wstring TerminalOutputBufferPool::Take()
+    {
+        std::lock_guard guard{ _lock };
+        if (_buffers.empty())
+        {
+            return {};
+        }
+
+        auto text = std::move(_buffers.back());
+        _buffers.pop_back();
+        return text;
+    }
+
+    // Method Description:
+    // - Takes back the storage of a buffer that's no longer used.
+    // Arguments:
+    // - text: the storage, whose contents are discarded.
+    void TerminalOutputBufferPool::Recycle(std::wstring&& text) noexcept
+    try
+    {
+        if (text.capacity() > MaxPooledCapacity)
+        {
+            return;
+        }
+
+        text.clear();
+
+        std::lock_guard guard{ _lock };
+        if (_buffers.size() < MaxPooledBuffers)
+        {
+            _buffers.emplace_back(std::move(text));
+        }
+    }
+    CATCH_LOG()
+
+    TerminalOutputBuffer::TerminalOutputBuffer(std::shared_ptr<TerminalOutputBufferPool> pool, std::wstring&& text) noexcept :
+        _pool{ std::move(pool) },
+        _text{ std::move(text) }
+    {
+    }
+
+    TerminalOutputBuffer::~TerminalOutputBuffer()
+    {
+        if (!_closed)
+        {
+            _pool->Recycle(std::move(_text));
+        }
+    }
+
+    // Method Description:
+    // - The size of the output in bytes, or 0 once the buffer was closed.
+    uint32_t TerminalOutputBuffer::Capacity() const noexcept
+    {
+        return _closed ? 0 : gsl::narrow_cast<uint32_t>(_text.size() * sizeof(wchar_t));
+    }
+
+    // Method Description:
+    // - Returns the storage of the buffer to its pool right away, instead of
+    //   when the last reference to it is released.
+    void TerminalOutputBuffer::Close()
+    {
+        if (!_closed)
+        {
+            _closed = true;
+            _pool->Recycle(std::move(_text));
+            _ClosedHandlers(*this, nullptr);
+        }
+    }
+
+    // Method Description:
+    // - Gives access to the output, which stays valid until the buffer is closed or released.
+    // Arguments:
+    // - value: receives a pointer to the UTF-16 text.
+    // - capacity: receives its size in bytes.
+    // Return Value:
+    // - S_OK, or RO_E_CLOSED if the buffer was closed.
+    HRESULT __stdcall TerminalOutputBuffer::GetBuffer(BYTE** value, UINT32* capacity) noexcept
+    {
+        RETURN_HR_IF_NULL(E_POINTER, value);
+        RETURN_HR_IF_NULL(E_POINTER, capacity);
+        *value = nullptr;
+        *capacity = 0;
+        RETURN_HR_IF(RO_E_CLOSED, _closed);
+
+#pragma warning(suppress : 26490) // Don't use reinterpret_cast (type.1). That's what the interface is made for.
+        *value = reinterpret_cast<BYTE*>(_text.data());
+        *capacity = Capacity();
+        return S_OK;
+    }
+}
@@ -0,0 +1,66 @@
+/*++
+Copyright (c) Microsoft Corporation
+Licensed under the MIT license.
+
+Module Name:
+- TerminalOutputBuffer.h
+
+Abstract:
+- The output of a connection as it's handed to TerminalOutputBuffer handlers:
+  UTF-16 text which the handlers read in place through IMemoryBufferByteAccess,
+  instead of getting a copy of it in a String.
+- Once the last reference to a buffer is released, or it's closed, its storage
+  goes back to the pool it came from. The connection then decodes its next
+  output right into that storage, so that after the first few chunks of output
+  no memory needs to be allocated for them anymore.
+
+--*/
+
+#pragma once
+
+#include <MemoryBuffer.h>
+
+#include "../inc/cppwinrt_utils.h"
+
+namespace winrt::Microsoft::Terminal::TerminalConnection::implementation
+{
+    class TerminalOutputBufferPool
+    {
+    public:
+        std::wstring Take();
+        void Recycle(std::wstring&& text) noexcept;
+
+    private:
+        // Handlers usually release a buffer before the next one is raised, so a
+        // few are plenty. Huge ones aren't kept, so that a burst of output doesn't
+        // hold on to its memory long after it's gone.
+        static constexpr size_t MaxPooledBuffers{ 4 };
+        static constexpr size_t MaxPooledCapacity{ 1024 * 1024 };
+
+        std::mutex _lock;
+        std::vector<std::wstring> _buffers;
+    };
+
+    struct TerminalOutputBuffer : winrt::implements<TerminalOutputBuffer, Windows::Foundation::IMemoryBufferReference, Windows::Foundation::IClosable, ::Windows::Foundation::IMemoryBufferByteAccess>
+    {
+        TerminalOutputBuffer(std::shared_ptr<TerminalOutputBufferPool> pool, std::wstring&& text) noexcept;
+        ~TerminalOutputBuffer();
+
+        TerminalOutputBuffer(const TerminalOutputBuffer&) = delete;
+        TerminalOutputBuffer& operator=(const TerminalOutputBuffer&) = delete;
+        TerminalOutputBuffer(TerminalOutputBuffer&&) = delete;
+        TerminalOutputBuffer& operator=(TerminalOutputBuffer&&) = delete;
+
+        uint32_t Capacity() const noexcept;
+        void Close();
+
+        HRESULT __stdcall GetBuffer(BYTE** value, UINT32* capacity) noexcept override;
+
+        TYPED_EVENT(Closed, Windows::Foundation::IMemoryBufferReference, Windows::Foundation::IInspectable);
+
+    private:
+        std::shared_ptr<TerminalOutputBufferPool> _pool;
+        std::wstring _text;
+        bool _closed{ false };
+    };
+}
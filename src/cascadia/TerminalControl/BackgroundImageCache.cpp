@@ -0,0 +1,83 @@
+// Copyright (c) Microsoft Corporation.
+// Licensed under the MIT license.
+
+#include "pch.h"
+#include "BackgroundImageCache.h"
+
+using namespace winrt::Windows::UI::Xaml::Media::Imaging;
+
+namespace winrt::Microsoft::Terminal::Control::implementation
+{
+    BackgroundImageCache& BackgroundImageCache::Instance()
+    {
+        thread_local BackgroundImageCache cache;
+        return cache;
+    }
+
+    // Method Description:
+    // - Returns the image for the given path, decoded to the given size. If
+    //   another control already uses that image, and the file wasn't modified
+    //   since it was decoded, that control's image is returned.
+    // - Note that BitmapImage loads the image asynchronously, which is
+    //   especially important since the image may well be both large and
+    //   somewhere out on the internet.
+    // Arguments:
+    // - path: the path or URI of the image.
+    // - decodeWidth, decodeHeight: the size to decode the image to, in pixels.
+    //   0 keeps the image's own size in that dimension.
+    // Return Value:
+    // - The image.
+    BitmapImage BackgroundImageCache::Get(const winrt::hstring& path, const int32_t decodeWidth, const int32_t decodeHeight)
+    {
+        Windows::Foundation::Uri uri{ path };
+        Key key{ std::wstring{ uri.RawUri() }, decodeWidth, decodeHeight };
+        const auto lastWriteTime = _LastWriteTime(path);
+
+        // Drop the images no control uses anymore.
+        for (auto it = _entries.begin(); it != _entries.end();)
+        {
+            it = it->second.image.get() ? std::next(it) : _entries.erase(it);
+        }
+
+        auto reload = false;
+        if (const auto it = _entries.find(key); it != _entries.end())
+        {
+            if (it->second.lastWriteTime == lastWriteTime)
+            {
+                if (auto image = it->second.image.get())
+                {
+                    return image;
+                }
+            }
+            reload = true;
+        }
+
+        BitmapImage image;
+        // XAML keeps its own cache of images by URI, which would hand us the
+        // image that was decoded before the file was modified.
+        if (reload)
+        {
+            image.CreateOptions(BitmapCreateOptions::IgnoreImageCache);
+        }
+        if (decodeWidth > 0)
+        {
+            image.DecodePixelWidth(decodeWidth);
+        }
+        if (decodeHeight > 0)
+        {
+            image.DecodePixelHeight(decodeHeight);
+        }
+        image.UriSource(uri);
+
+        _entries.insert_or_assign(std::move(key), Entry{ winrt::make_weak(image), lastWriteTime });
+        return image;
+    }
+
+    // Images that aren't local files (or that can't be found) never count as modified.
+    std::filesystem::file_time_type BackgroundImageCache::_LastWriteTime(const winrt::hstring& path) noexcept
+    {
+        std::error_code ec;
+        const auto lastWriteTime = std::filesystem::last_write_time(std::filesystem::path{ std::wstring_view{ path } }, ec);
+        return ec ? std::filesystem::file_time_type{} : lastWriteTime;
+    }
+}
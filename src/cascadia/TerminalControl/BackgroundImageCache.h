@@ -0,0 +1,43 @@
+/*++
+Copyright (c) Microsoft Corporation
+Licensed under the MIT license.
+
+Module Name:
+- BackgroundImageCache.h
+
+Abstract:
+- Shares the decoded background images between all the controls of a window.
+  Many panes usually use the same image from their profile, and decoding it
+  for each of them holds just as many copies of it in memory.
+- Images are keyed by their URI and the size they're decoded to. They're only
+  decoded again once the file they were loaded from was modified, and are
+  released once no control uses them anymore.
+- XAML objects belong to the thread that created them, so each UI thread
+  (i.e. each window) has a cache of its own.
+--*/
+
+#pragma once
+
+namespace winrt::Microsoft::Terminal::Control::implementation
+{
+    class BackgroundImageCache
+    {
+    public:
+        static BackgroundImageCache& Instance();
+
+        Windows::UI::Xaml::Media::Imaging::BitmapImage Get(const winrt::hstring& path, const int32_t decodeWidth, const int32_t decodeHeight);
+
+    private:
+        using Key = std::tuple<std::wstring, int32_t, int32_t>;
+
+        struct Entry
+        {
+            winrt::weak_ref<Windows::UI::Xaml::Media::Imaging::BitmapImage> image;
+            std::filesystem::file_time_type lastWriteTime;
+        };
+
+        static std::filesystem::file_time_type _LastWriteTime(const winrt::hstring& path) noexcept;
+
+        std::map<Key, Entry> _entries;
+    };
+}
@@ -27,12 +27,37 @@ using namespace winrt::Windows::ApplicationModel::DataTransfer;
 // The updates are throttled to limit power usage.
 constexpr const auto ScrollBarUpdateInterval = std::chrono::milliseconds(8);
 
+// The minimum delay between raising TitleChanged and TaskbarProgressChanged.
+// Shells may set the title on every prompt, and builds may report their
+// progress thousands of times a second. The UI only needs the latest value once a frame.
+constexpr const auto TitleAndProgressUpdateInterval = std::chrono::milliseconds(8);
+
 // The minimum delay between updating the TSF input control.
 constexpr const auto TsfRedrawInterval = std::chrono::milliseconds(100);
 
 // The minimum delay between updating the locations of regex patterns
 constexpr const auto UpdatePatternLocationsInterval = std::chrono::milliseconds(500);
 
+// The minimum delay between resizing the buffer while the panel is being resized.
+// Every resize reflows the buffer and ConPTY, so while the user is dragging a
+// window border or pane separator, we only do that once every few frames.
+constexpr const auto ResizeInterval = std::chrono::milliseconds(50);
+
+// While the window is being resized interactively, the buffer is only
+// resized once the panel size hasn't changed for this long, or the drag ended.
+constexpr const auto LiveResizeIdleInterval = std::chrono::milliseconds(200);
+
+// The minimum delay between frames while we're occluded, but asked to keep
+// rendering anyways, like in the hidden quake window.
+constexpr const auto OccludedPaintInterval = std::chrono::milliseconds(250);
+
+// The minimum delay between freezing the scrollback that was read (and thus thawed) again.
+constexpr const auto RefreezeScrollbackInterval = std::chrono::seconds(5);
+
+// How long a control has to be occluded before it hibernates, see _hibernate().
+// When the system runs low on memory, occluded controls hibernate right away.
+constexpr const auto HibernateDelay = std::chrono::minutes(10);
+
 namespace winrt::Microsoft::Terminal::Control::implementation
 {
     // Helper static function to ensure that all ambiguous-width glyphs are reported as narrow.
@@ -54,6 +79,26 @@ namespace winrt::Microsoft::Terminal::Control::implementation
         return initialized;
     }
 
+    // Most of the time it takes to initialize the render engine of a new control is spent
+    // resolving its font. To make new tabs and panes show up faster, we keep one engine
+    // around whose font was already resolved in the background, using the settings of the
+    // last control that got initialized. Its DxFontRenderData will then skip the work when
+    // the new control asks for the same font again.
+    struct WarmRenderEngine
+    {
+        std::mutex lock;
+        std::unique_ptr<::Microsoft::Console::Render::DxEngine> engine;
+        bool pending = false;
+    };
+
+    static WarmRenderEngine& _getWarmRenderEngine()
+    {
+        // This is intentionally leaked, because releasing DirectX objects
+        // while our DLL is being unloaded isn't safe.
+        static auto warm = new WarmRenderEngine{};
+        return *warm;
+    }
+
     ControlCore::ControlCore(IControlSettings settings,
                              TerminalConnection::ITerminalConnection connection) :
         _connection{ connection },
@@ -71,7 +116,16 @@ namespace winrt::Microsoft::Terminal::Control::implementation
         });
 
         // This event is explicitly revoked in the destructor: does not need weak_ref
-        _connectionOutputEventToken = _connection.TerminalOutput({ this, &ControlCore::_connectionOutputHandler });
+        // If the connection can hand over its output without copying it into a String, let it.
+        _bufferedConnection = _connection.try_as<TerminalConnection::ITerminalConnectionBuffered>();
+        if (_bufferedConnection)
+        {
+            _connectionOutputEventToken = _bufferedConnection.TerminalOutputBuffer({ this, &ControlCore::_connectionOutputBufferHandler });
+        }
+        else
+        {
+            _connectionOutputEventToken = _connection.TerminalOutput({ this, &ControlCore::_connectionOutputHandler });
+        }
 
         _terminal->SetWriteInputCallback([this](std::wstring& wstr) {
             _sendInputToConnection(wstr);
@@ -104,6 +158,22 @@ namespace winrt::Microsoft::Terminal::Control::implementation
         auto pfnTerminalTaskbarProgressChanged = std::bind(&ControlCore::_terminalTaskbarProgressChanged, this);
         _terminal->TaskbarProgressChangedCallback(pfnTerminalTaskbarProgressChanged);
 
+        // The renderer is created below, and lives as long as the terminal does.
+        _terminal->SetSynchronizedOutputCallback([this](const bool enabled) {
+            if (!_renderer)
+            {
+                return;
+            }
+            if (enabled)
+            {
+                _renderer->SynchronizedOutputBegin();
+            }
+            else
+            {
+                _renderer->SynchronizedOutputEnd();
+            }
+        });
+
         // MSFT 33353327: Initialize the renderer in the ctor instead of Initialize().
         // We need the renderer to be ready to accept new engines before the SwapChainPanel is ready to go.
         // If we wait, a screen reader may try to get the AutomationPeer (aka the UIA Engine), and we won't be able to attach
@@ -127,7 +197,28 @@ namespace winrt::Microsoft::Terminal::Control::implementation
                 }
             });
 
+            // The renderer is destroyed (and its thread joined) before we are.
+            _renderer->SetFramePresentedCallback([this](const auto frameStart) {
+                _rendererFramePresented(frameStart);
+            });
+
             THROW_IF_FAILED(localPointerToThread->Initialize(_renderer.get()));
+            _updateThreadScheduling();
+        }
+
+        {
+            using winrt::Windows::System::Power::PowerManager;
+
+            const auto onPowerStatusChanged = [weakThis = get_weak()](auto&&, auto&&) {
+                if (auto core{ weakThis.get() })
+                {
+                    core->_updatePowerSaving();
+                }
+            };
+            _powerSupplyStatusChangedRevoker = PowerManager::PowerSupplyStatusChanged(winrt::auto_revoke, onPowerStatusChanged);
+            _energySaverStatusChangedRevoker = PowerManager::EnergySaverStatusChanged(winrt::auto_revoke, onPowerStatusChanged);
+            _powerSavingAllowed.store(_settings.PowerSavingRendering(), std::memory_order_relaxed);
+            _updatePowerSaving();
         }
 
         // Get our dispatcher. If we're hosted in-proc with XAML, this will get
@@ -155,6 +246,19 @@ namespace winrt::Microsoft::Terminal::Control::implementation
         //   need to hop across the process boundary every time text is output.
         //   We can throttle this to once every 8ms, which will get us out of
         //   the way of the main output & rendering threads.
+        // * _updateTitle, _updateTaskbarProgress: Every title or progress
+        //   change updates the tab, the window and the taskbar on the UI
+        //   thread. We only pass the latest one on, once every frame.
+        // * _resizeToPanel: Resizing reflows the buffer, which gets expensive
+        //   for large buffers. While the panel is being dragged to a new size,
+        //   we keep presenting the last frame and resize only once in a while.
+        //   During a live resize of the window, we even wait until the user
+        //   stops dragging for a moment, see LiveResizeChanged().
+        // * _hibernateWhenIdle: Once we've been occluded for HibernateDelay,
+        //   we let go of most of our memory, see _hibernate().
+        // * _refreezeScrollback: Searching or copying text thaws the rows of the
+        //   scrollback it reads. Once in a while, we freeze them again, see
+        //   TextBuffer::RefreezeColdRows().
         _tsfTryRedrawCanvas = std::make_shared<ThrottledFuncTrailing<>>(
             _dispatcher,
             TsfRedrawInterval,
@@ -185,6 +289,85 @@ namespace winrt::Microsoft::Terminal::Control::implementation
                 }
             });
 
+        _updateTitle = std::make_shared<ThrottledFuncTrailing<winrt::hstring>>(
+            _dispatcher,
+            TitleAndProgressUpdateInterval,
+            [weakThis = get_weak()](const auto& title) {
+                if (auto core{ weakThis.get() }; !core->_IsClosing())
+                {
+                    core->_TitleChangedHandlers(*core, winrt::make<TitleChangedEventArgs>(title));
+                }
+            });
+
+        _updateTaskbarProgress = std::make_shared<ThrottledFuncTrailing<>>(
+            _dispatcher,
+            TitleAndProgressUpdateInterval,
+            [weakThis = get_weak()]() {
+                if (auto core{ weakThis.get() }; !core->_IsClosing())
+                {
+                    core->_TaskbarProgressChangedHandlers(*core, nullptr);
+                }
+            });
+
+        // The budget may ask us to spill rows on any thread, including while
+        // another control holds its lock, so we only ever do that on ours.
+        _scrollbackBudget = ScrollbackBudget::Instance().Register([weakThis = get_weak(), dispatcher = _dispatcher](const size_t rows) {
+            dispatcher.TryEnqueue(DispatcherQueuePriority::Low, [weakThis, rows]() {
+                if (auto core{ weakThis.get() }; !core->_IsClosing())
+                {
+                    core->_limitResidentRows(rows);
+                }
+            });
+        });
+
+        _hibernateWhenIdle = std::make_shared<ThrottledFuncTrailing<>>(
+            _dispatcher,
+            HibernateDelay,
+            [weakThis = get_weak()]() {
+                if (auto core{ weakThis.get() }; !core->_IsClosing() && core->_canHibernate())
+                {
+                    // We might have been visible in the meantime.
+                    if (std::chrono::steady_clock::now() - core->_occludedSince < HibernateDelay)
+                    {
+                        core->_hibernateWhenIdle->Run();
+                        return;
+                    }
+                    core->_hibernate();
+                }
+            });
+
+        _refreezeScrollback = std::make_shared<ThrottledFuncTrailing<>>(
+            _dispatcher,
+            RefreezeScrollbackInterval,
+            [weakThis = get_weak()]() {
+                if (auto core{ weakThis.get() }; !core->_IsClosing())
+                {
+                    auto lock = core->_terminal->LockForWriting();
+                    core->_terminal->RefreezeScrollback();
+                }
+            });
+
+        _resizeToPanel = std::make_shared<ThrottledFuncTrailing<>>(
+            _dispatcher,
+            ResizeInterval,
+            [weakThis = get_weak()]() {
+                if (auto core{ weakThis.get() }; !core->_IsClosing())
+                {
+                    // The swap chain just stays at its old size in the meantime,
+                    // cropped by (or not quite filling) the panel.
+                    if (core->_liveResize && std::chrono::steady_clock::now() - core->_lastPanelSizeChange < LiveResizeIdleInterval)
+                    {
+                        core->_resizeToPanel->Run();
+                        return;
+                    }
+
+                    auto lock = core->_terminal->LockForWriting();
+                    const auto currentEngineScale = core->_renderEngine->GetScaling();
+                    core->_doResizeUnderLock(core->_panelWidth * currentEngineScale,
+                                             core->_panelHeight * currentEngineScale);
+                }
+            });
+
         UpdateSettings(settings);
     }
 
@@ -222,8 +405,8 @@ namespace winrt::Microsoft::Terminal::Control::implementation
                 return false;
             }
 
-            // Set up the DX Engine
-            auto dxEngine = std::make_unique<::Microsoft::Console::Render::DxEngine>();
+            // Set up the DX Engine. Adopt the pre-warmed one, if there is any.
+            auto dxEngine = _takeWarmRenderEngine();
             _renderer->AddRenderEngine(dxEngine.get());
             _renderEngine = std::move(dxEngine);
 
@@ -254,6 +437,7 @@ namespace winrt::Microsoft::Terminal::Control::implementation
             _settings.InitialRows(height);
 
             _terminal->CreateFromSettings(_settings, *_renderer);
+            _reportScrollbackUnderLock();
 
             // IMPORTANT! Set this callback up sooner than later. If we do it
             // after Enable, then it'll be possible to paint the frame once
@@ -269,6 +453,10 @@ namespace winrt::Microsoft::Terminal::Control::implementation
             _renderEngine->SetPixelShaderPath(_settings.PixelShaderPath());
             _renderEngine->SetForceFullRepaintRendering(_settings.ForceFullRepaintRendering());
             _renderEngine->SetSoftwareRendering(_settings.SoftwareRendering());
+            _renderEngine->SetGlyphAtlasEnabled(_settings.GlyphAtlasRendering());
+            _renderEngine->SetBuiltinGlyphsEnabled(_settings.BuiltinGlyphRendering());
+            _renderEngine->SetSmoothScrolling(_settings.SmoothScrolling());
+            _renderer->SetOverscanRows(_settings.SmoothScrolling() ? 1 : 0);
             _renderEngine->SetIntenseIsBold(_settings.IntenseIsBold());
 
             _updateAntiAliasingMode(_renderEngine.get());
@@ -288,9 +476,102 @@ namespace winrt::Microsoft::Terminal::Control::implementation
         // start writing output immediately.
         _connection.Start();
 
+        // Get an engine ready for the next control.
+        _prewarmRenderEngine();
+
         return true;
     }
 
+    // Function Description:
+    // - Returns the pre-warmed render engine, or a new one if there's none.
+    // Arguments:
+    // - <none>
+    // Return Value:
+    // - a render engine that isn't attached to any renderer yet
+    std::unique_ptr<::Microsoft::Console::Render::DxEngine> ControlCore::_takeWarmRenderEngine()
+    {
+        auto& warm = _getWarmRenderEngine();
+        {
+            const std::lock_guard guard{ warm.lock };
+            if (warm.engine)
+            {
+                return std::move(warm.engine);
+            }
+        }
+        return std::make_unique<::Microsoft::Console::Render::DxEngine>();
+    }
+
+    // Method Description:
+    // - Creates a render engine in the background and resolves our current font
+    //   with it, unless there's already one waiting for the next control.
+    // Arguments:
+    // - <none>
+    // Return Value:
+    // - <none>
+    void ControlCore::_prewarmRenderEngine()
+    {
+        auto& warm = _getWarmRenderEngine();
+        {
+            const std::lock_guard guard{ warm.lock };
+            if (warm.engine || warm.pending)
+            {
+                return;
+            }
+            warm.pending = true;
+        }
+
+        // The engine only holds on to views of these, so we need our own copies.
+        std::unordered_map<winrt::hstring, uint32_t> features;
+        if (const auto fontFeatures = _settings.FontFeatures())
+        {
+            for (const auto& [tag, param] : fontFeatures)
+            {
+                features.emplace(tag, param);
+            }
+        }
+        std::unordered_map<winrt::hstring, float> axes;
+        if (const auto fontAxes = _settings.FontAxes())
+        {
+            for (const auto& [axis, value] : fontAxes)
+            {
+                axes.emplace(axis, value);
+            }
+        }
+
+        const int dpi = static_cast<int>(static_cast<double>(USER_DEFAULT_SCREEN_DPI) * _compositionScale);
+        _prewarmRenderEngineAsync(_desiredFont, dpi, std::move(features), std::move(axes));
+    }
+
+    winrt::fire_and_forget ControlCore::_prewarmRenderEngineAsync(FontInfoDesired desiredFont,
+                                                                  const int dpi,
+                                                                  std::unordered_map<winrt::hstring, uint32_t> features,
+                                                                  std::unordered_map<winrt::hstring, float> axes)
+    {
+        co_await winrt::resume_background();
+
+        std::unique_ptr<::Microsoft::Console::Render::DxEngine> engine;
+        try
+        {
+            const std::unordered_map<std::wstring_view, uint32_t> featureMap{ features.begin(), features.end() };
+            const std::unordered_map<std::wstring_view, float> axesMap{ axes.begin(), axes.end() };
+            FontInfo actualFont{ DEFAULT_FONT_FACE, 0, DEFAULT_FONT_WEIGHT, { 0, DEFAULT_FONT_SIZE }, CP_UTF8, false };
+
+            engine = std::make_unique<::Microsoft::Console::Render::DxEngine>();
+            THROW_IF_FAILED(engine->UpdateDpi(dpi));
+            THROW_IF_FAILED(engine->UpdateFont(desiredFont, actualFont, featureMap, axesMap));
+        }
+        catch (...)
+        {
+            LOG_CAUGHT_EXCEPTION();
+            engine.reset();
+        }
+
+        auto& warm = _getWarmRenderEngine();
+        const std::lock_guard guard{ warm.lock };
+        warm.engine = std::move(engine);
+        warm.pending = false;
+    }
+
     // Method Description:
     // - Tell the renderer to start painting.
     // - !! IMPORTANT !! Make sure that we've attached our swap chain to an
@@ -307,6 +588,178 @@ namespace winrt::Microsoft::Terminal::Control::implementation
         }
     }
 
+    // Method Description:
+    // - Tell the renderer whether we can be seen. While we're occluded, output
+    //   is only accumulated as invalidation, and we'll repaint once when we're
+    //   visible again.
+    // Arguments:
+    // - occluded: true if the control is hidden, unloaded, or minimized.
+    // Return Value:
+    // - <none>
+    void ControlCore::SetOccluded(const bool occluded)
+    {
+        _occluded = occluded;
+        _scrollbackBudget->SetVisible(!occluded);
+        if (_renderer)
+        {
+            if (!occluded)
+            {
+                _wake();
+            }
+            _renderer->SetOccluded(occluded);
+            _updateThreadScheduling();
+        }
+
+        if (occluded)
+        {
+            _occludedSince = std::chrono::steady_clock::now();
+            _hibernateWhenIdle->Run();
+        }
+        _watchLowMemory(_canHibernate());
+    }
+
+    // Method Description:
+    // - Keep rendering at a low frame rate while we're occluded, so that we
+    //   only have a little to catch up with once we're visible again. See
+    //   Renderer::SetOccludedPaintInterval.
+    // Arguments:
+    // - keepRendering: true to keep rendering while occluded.
+    // Return Value:
+    // - <none>
+    void ControlCore::KeepRenderingWhileOccluded(const bool keepRendering)
+    {
+        _keepRenderingWhileOccluded = keepRendering;
+        if (_renderer)
+        {
+            if (keepRendering)
+            {
+                _wake();
+            }
+            _renderer->SetOccludedPaintInterval(keepRendering ? OccludedPaintInterval : std::chrono::milliseconds::zero());
+        }
+
+        if (_occluded && !keepRendering)
+        {
+            _occludedSince = std::chrono::steady_clock::now();
+            _hibernateWhenIdle->Run();
+        }
+        _watchLowMemory(_canHibernate());
+    }
+
+    // Method Description:
+    // - Whether we're occluded and allowed to hibernate, but haven't yet.
+    //   Controls that keep rendering while occluded never hibernate, since
+    //   they need to be up to date the moment they're shown.
+    bool ControlCore::_canHibernate() const noexcept
+    {
+        return _occluded && !_keepRenderingWhileOccluded && !_hibernated && _initializedTerminal;
+    }
+
+    // Method Description:
+    // - Lets go of most of the memory that an occluded control holds on to,
+    //   once nobody looked at it in a while, or the system runs low on memory:
+    //   * The render thread is parked, and the engine gives back its swap
+    //     chain, glyph caches and device.
+    //   * All of the scrollback is moved out into the buffer's spill file.
+    // - Output keeps being processed as usual. _wake() undoes this, once we're
+    //   visible again. The scrollback stays in the spill file until it's accessed.
+    // Arguments:
+    // - <none>
+    // Return Value:
+    // - <none>
+    void ControlCore::_hibernate()
+    {
+        if (!_canHibernate())
+        {
+            return;
+        }
+
+        _hibernated = true;
+        _watchLowMemory(false);
+
+        // The engine may only let go of its resources while it's neither painting nor presenting.
+        // This has to happen outside of the lock, which the render thread may be waiting for.
+        _renderer->WaitForPaintCompletionAndDisable(INFINITE);
+
+        auto lock = _terminal->LockForWriting();
+        try
+        {
+            _terminal->Hibernate();
+        }
+        CATCH_LOG();
+        _renderEngine->Hibernate();
+    }
+
+    // Method Description:
+    // - Undoes _hibernate(). The engine recreates its resources during the
+    //   next frame, which repaints everything.
+    // Arguments:
+    // - <none>
+    // Return Value:
+    // - <none>
+    void ControlCore::_wake()
+    {
+        if (!_hibernated)
+        {
+            return;
+        }
+
+        _hibernated = false;
+        {
+            auto lock = _terminal->LockForWriting();
+            _terminal->Wake();
+        }
+        _renderer->EnablePainting();
+        _renderer->TriggerRedrawAll();
+    }
+
+    // Method Description:
+    // - Starts or stops waiting for the system to run low on memory, which
+    //   makes us hibernate right away, instead of after HibernateDelay.
+    // Arguments:
+    // - watch: true to start waiting, false to stop.
+    // Return Value:
+    // - <none>
+    void ControlCore::_watchLowMemory(const bool watch)
+    {
+        // The notification is shared by all of the controls in the process.
+        static const wil::unique_handle lowMemory{ CreateMemoryResourceNotification(LowMemoryResourceNotification) };
+        if (!lowMemory)
+        {
+            return;
+        }
+
+        if (!_lowMemoryWait)
+        {
+            if (!watch)
+            {
+                return;
+            }
+
+            _lowMemoryWait.reset(CreateThreadpoolWait(
+                [](PTP_CALLBACK_INSTANCE, PVOID context, PTP_WAIT, TP_WAIT_RESULT) noexcept {
+                    const auto core = static_cast<ControlCore*>(context);
+                    core->_dispatcher.TryEnqueue(DispatcherQueuePriority::Low, [weakThis = core->get_weak()]() {
+                        if (auto core{ weakThis.get() }; !core->_IsClosing())
+                        {
+                            core->_hibernate();
+                        }
+                    });
+                },
+                this,
+                nullptr));
+            if (!_lowMemoryWait)
+            {
+                LOG_LAST_ERROR();
+                return;
+            }
+        }
+
+        // The notification stays signaled for as long as memory is low, so we only
+        // wait for it while we can hibernate. Otherwise we'd be called back right away.
+        SetThreadpoolWait(_lowMemoryWait.get(), watch ? lowMemory.get() : nullptr, nullptr);
+    }
+
     // Method Description:
     // - Writes the given sequence as input to the active terminal connection.
     // - This method has been overloaded to allow zero-copy winrt::param::hstring optimizations.
@@ -322,7 +775,23 @@ namespace winrt::Microsoft::Terminal::Control::implementation
         }
         else
         {
+            _inputLatency.Mark(InputLatencyTracker::Stage::InputWritten);
             _connection.WriteInput(wstr);
+
+            if (_broadcastThreadId.load(std::memory_order_relaxed) == GetCurrentThreadId())
+            {
+                // Connections write their input asynchronously, so a
+                // pane that doesn't read its input doesn't hold up the others.
+                const winrt::hstring input{ wstr };
+                for (const auto& target : _broadcastTargets)
+                {
+                    try
+                    {
+                        target.WriteInput(input);
+                    }
+                    CATCH_LOG();
+                }
+            }
         }
     }
 
@@ -334,13 +803,35 @@ namespace winrt::Microsoft::Terminal::Control::implementation
     // - <none>
     void ControlCore::SendInput(const winrt::hstring& wstr)
     {
+        const auto broadcast = _broadcastScope();
         _sendInputToConnection(wstr);
     }
 
+    TerminalConnection::ITerminalConnection ControlCore::Connection() const noexcept
+    {
+        return _connection;
+    }
+
+    // Method Description:
+    // - Sets the connections that the keys, text and pastes sent to this
+    //   control are broadcast to, in addition to its own connection.
+    // Arguments:
+    // - connections: the connections to broadcast to, or null to stop broadcasting.
+    void ControlCore::BroadcastInputTo(const Windows::Foundation::Collections::IVector<TerminalConnection::ITerminalConnection>& connections)
+    {
+        _broadcastTargets.clear();
+        if (connections)
+        {
+            _broadcastTargets.assign(begin(connections), end(connections));
+        }
+    }
+
     bool ControlCore::SendCharEvent(const wchar_t ch,
                                     const WORD scanCode,
                                     const ::Microsoft::Terminal::Core::ControlKeyStates modifiers)
     {
+        _inputLatency.Mark(InputLatencyTracker::Stage::InputTranslated);
+        const auto broadcast = _broadcastScope();
         return _terminal->SendCharEvent(ch, scanCode, modifiers);
     }
 
@@ -387,9 +878,15 @@ namespace winrt::Microsoft::Terminal::Control::implementation
             }
         }
 
+        if (vkey)
+        {
+            _inputLatency.Mark(InputLatencyTracker::Stage::InputTranslated);
+        }
+
         // If the terminal translated the key, mark the event as handled.
         // This will prevent the system from trying to get the character out
         // of it and sending us a CharacterReceived event.
+        const auto broadcast = _broadcastScope();
         return vkey ? _terminal->SendKeyEvent(vkey,
                                               scanCode,
                                               modifiers,
@@ -483,6 +980,127 @@ namespace winrt::Microsoft::Terminal::Control::implementation
         }
     }
 
+    // Method Description:
+    // - Shows or hides the overlay with a histogram of the recent frame times
+    //   and the statistics of this pane.
+    // Arguments:
+    // - <none>
+    // Return Value:
+    // - <none>
+    void ControlCore::ToggleFrameStatistics()
+    {
+        auto lock = _terminal->LockForWriting();
+        _renderEngine->ToggleFrameStatisticsOverlay();
+        const auto shown = !_frameStatisticsShown.load(std::memory_order_relaxed);
+        if (shown)
+        {
+            // Start the rates over, instead of averaging them over the time the overlay was hidden.
+            _statistics.TakeSnapshot(_renderer->GetFrameStatistics(), 0, 0);
+        }
+        _frameStatisticsShown.store(shown, std::memory_order_relaxed);
+    }
+
+    // Method Description:
+    // - Starts measuring the latency of the key that TermControl is about to
+    //   handle, if someone's interested in it: either the statistics overlay
+    //   or a trace session listening for the InputLatency events.
+    // Arguments:
+    // - <none>
+    // Return Value:
+    // - <none>
+    void ControlCore::StartInputLatencySample()
+    {
+        if (_frameStatisticsShown.load(std::memory_order_relaxed) || TraceLoggingProviderEnabled(g_hTerminalControlProvider, WINEVENT_LEVEL_VERBOSE, TIL_KEYWORD_TRACE))
+        {
+            _inputLatency.Start();
+        }
+    }
+
+    // Method Description:
+    // - Called by the render thread after it presented a frame. If the frame
+    //   contains the echo of the key being measured, the latency is traced
+    //   and handed to the statistics overlay. While the overlay is shown, it
+    //   also gets the statistics of this pane, once per SnapshotInterval.
+    // Arguments:
+    // - frameStart: the time the frame started painting.
+    // Return Value:
+    // - <none>
+    void ControlCore::_rendererFramePresented(const InputLatencyTracker::clock::time_point frameStart)
+    {
+        if (_frameStatisticsShown.load(std::memory_order_relaxed) && _statistics.IsSnapshotDue())
+        {
+            _updatePaneStatistics();
+        }
+
+        const auto sample = _inputLatency.FramePresented(frameStart);
+        if (!sample)
+        {
+            return;
+        }
+
+        const auto percentiles = _inputLatency.GetPercentiles();
+        const auto microseconds = [](const InputLatencyTracker::clock::duration duration) noexcept {
+            return gsl::narrow_cast<uint64_t>(std::chrono::duration_cast<std::chrono::microseconds>(duration).count());
+        };
+        const auto stage = [&](const InputLatencyTracker::Stage from) noexcept {
+            const auto index = static_cast<size_t>(from);
+            return microseconds(til::at(*sample, index + 1) - til::at(*sample, index));
+        };
+
+#pragma warning(suppress : 26477 26485 26494 26482 26446 26447) // We don't control TraceLoggingWrite
+        TraceLoggingWrite(g_hTerminalControlProvider,
+                          "InputLatency",
+                          TraceLoggingDescription("The time from a key press to the frame containing its echo"),
+                          TraceLoggingPointer(this, "session"),
+                          TraceLoggingUInt64(stage(InputLatencyTracker::Stage::KeyHandled), "keyHandlingUs"),
+                          TraceLoggingUInt64(stage(InputLatencyTracker::Stage::InputTranslated), "handleKeyUs"),
+                          TraceLoggingUInt64(stage(InputLatencyTracker::Stage::InputWritten), "connectionRoundTripUs"),
+                          TraceLoggingUInt64(stage(InputLatencyTracker::Stage::OutputRead), "terminalWriteUs"),
+                          TraceLoggingUInt64(stage(InputLatencyTracker::Stage::OutputWritten), "paintAndPresentUs"),
+                          TraceLoggingUInt64(microseconds(sample->back() - sample->front()), "totalUs"),
+                          TraceLoggingUInt64(microseconds(percentiles.p50), "sessionP50Us"),
+                          TraceLoggingUInt64(microseconds(percentiles.p99), "sessionP99Us"),
+                          TraceLoggingUInt64(percentiles.count, "sessionSamples"),
+                          TraceLoggingLevel(WINEVENT_LEVEL_VERBOSE),
+                          TraceLoggingKeyword(TIL_KEYWORD_TRACE));
+
+        if (_renderEngine)
+        {
+            const std::chrono::duration<float, std::milli> p50 = percentiles.p50;
+            const std::chrono::duration<float, std::milli> p99 = percentiles.p99;
+            _renderEngine->SetInputLatencyStatistics(p50.count(), p99.count(), percentiles.count);
+        }
+    }
+
+    // Method Description:
+    // - Takes a snapshot of the statistics of this pane and hands it to the
+    //   statistics overlay. Must be called on the render thread.
+    // - The buffer memory is that of the rows' cells at full width, except for
+    //   the ones spilled to disk. Rows that were frozen take less, so it's an upper bound.
+    // Arguments:
+    // - <none>
+    // Return Value:
+    // - <none>
+    void ControlCore::_updatePaneStatistics()
+    {
+        size_t rows = 0;
+        size_t bytes = 0;
+        {
+            auto lock = _terminal->LockForReading();
+            const auto& buffer = _terminal->GetTextBuffer();
+            rows = buffer.TotalRowCount();
+            bytes = buffer.GetResidentRowCount() * (sizeof(ROW) + gsl::narrow_cast<size_t>(buffer.GetSize().Width()) * sizeof(CharRowCell));
+        }
+
+        auto snapshot = _statistics.TakeSnapshot(_renderer->GetFrameStatistics(), rows, bytes);
+        snapshot.scrollbackBudgetUsageBytes = ScrollbackBudget::Instance().UsageBytes();
+        snapshot.scrollbackBudgetBytes = ScrollbackBudget::Instance().BudgetBytes();
+        if (_renderEngine)
+        {
+            _renderEngine->SetPaneStatistics(snapshot.Format());
+        }
+    }
+
     // Method Description:
     // - Tell TerminalCore to update its knowledge about the locations of visible regex patterns
     // - We should call this (through the throttled function) when something causes the visible
@@ -527,7 +1145,7 @@ namespace winrt::Microsoft::Terminal::Control::implementation
             newInterval = _terminal->GetHyperlinkIntervalFromPosition(*terminalPosition);
         }
 
-        // If the hyperlink ID changed or the interval changed, trigger a redraw all
+        // If the hyperlink ID changed or the interval changed, trigger a redraw
         // (so this will happen both when we move onto a link and when we move off a link)
         if (newId != _lastHoveredId ||
             (newInterval != _lastHoveredInterval))
@@ -539,11 +1157,28 @@ namespace winrt::Microsoft::Terminal::Control::implementation
             {
                 auto lock = _terminal->LockForWriting();
 
+                // The cells of a hyperlink can be anywhere in the viewport, but a
+                // hovered pattern only changes the cells of the old and new interval.
+                if (newId != _lastHoveredId)
+                {
+                    _renderer->TriggerRedrawAll();
+                }
+                else
+                {
+                    if (_lastHoveredInterval)
+                    {
+                        _terminal->InvalidatePatternInterval(*_lastHoveredInterval);
+                    }
+                    if (newInterval)
+                    {
+                        _terminal->InvalidatePatternInterval(*newInterval);
+                    }
+                }
+
                 _lastHoveredId = newId;
                 _lastHoveredInterval = newInterval;
                 _renderEngine->UpdateHyperlinkHoveredId(newId);
                 _renderer->UpdateLastHoveredInterval(newInterval);
-                _renderer->TriggerRedrawAll();
             }
 
             _HoveredHyperlinkChangedHandlers(*this, nullptr);
@@ -606,6 +1241,17 @@ namespace winrt::Microsoft::Terminal::Control::implementation
 
         _renderEngine->SetForceFullRepaintRendering(_settings.ForceFullRepaintRendering());
         _renderEngine->SetSoftwareRendering(_settings.SoftwareRendering());
+        _renderEngine->SetGlyphAtlasEnabled(_settings.GlyphAtlasRendering());
+        _renderEngine->SetBuiltinGlyphsEnabled(_settings.BuiltinGlyphRendering());
+        _renderEngine->SetSmoothScrolling(_settings.SmoothScrolling());
+        _renderer->SetOverscanRows(_settings.SmoothScrolling() ? 1 : 0);
+        _updateThreadScheduling();
+        _powerSavingAllowed.store(_settings.PowerSavingRendering(), std::memory_order_relaxed);
+        _updatePowerSaving();
+        if (!_settings.SmoothScrolling())
+        {
+            _subRowScrollOffset = 0.0f;
+        }
 
         _updateAntiAliasingMode(_renderEngine.get());
 
@@ -641,6 +1287,55 @@ namespace winrt::Microsoft::Terminal::Control::implementation
         }
     }
 
+    // Method Description:
+    // - Tells the OS how to schedule our render thread: as an interactive
+    //   thread while we can be seen, and as a background one while we're
+    //   occluded, as far as the ThreadScheduling setting allows.
+    // Arguments:
+    // - <none>
+    // Return Value:
+    // - <none>
+    void ControlCore::_updateThreadScheduling()
+    {
+        using ::Microsoft::Console::Types::ThreadScheduling::Class;
+
+        auto schedulingClass = Class::Default;
+        switch (_settings.ThreadScheduling())
+        {
+        case ThreadSchedulingPolicy::Responsive:
+            schedulingClass = _occluded ? Class::Background : Class::Interactive;
+            break;
+        case ThreadSchedulingPolicy::Efficient:
+            schedulingClass = _occluded ? Class::Background : Class::Default;
+            break;
+        case ThreadSchedulingPolicy::None:
+        default:
+            break;
+        }
+        _renderer->SetThreadSchedulingClass(schedulingClass);
+    }
+
+    // Method Description:
+    // - Saves power while the device runs on battery or battery saver is on,
+    //   if the PowerSavingRendering setting allows it. See Renderer::SetPowerSaving.
+    // - Called whenever the power status changed, on a background thread.
+    // Arguments:
+    // - <none>
+    // Return Value:
+    // - <none>
+    void ControlCore::_updatePowerSaving() noexcept
+    try
+    {
+        using namespace winrt::Windows::System::Power;
+
+        const auto powerSaving = _powerSavingAllowed.load(std::memory_order_relaxed) &&
+                                 (PowerManager::EnergySaverStatus() == EnergySaverStatus::On ||
+                                  PowerManager::PowerSupplyStatus() == PowerSupplyStatus::NotPresent);
+        _powerSaving.store(powerSaving, std::memory_order_relaxed);
+        _renderer->SetPowerSaving(powerSaving);
+    }
+    CATCH_LOG()
+
     void ControlCore::_updateAntiAliasingMode(::Microsoft::Console::Render::DxEngine* const dxEngine)
     {
         // Update DxEngine's AntialiasingMode
@@ -838,7 +1533,44 @@ namespace winrt::Microsoft::Terminal::Control::implementation
         if (SUCCEEDED(hr) && hr != S_FALSE)
         {
             _connection.Resize(vp.Height(), vp.Width());
+            _reportScrollbackUnderLock();
+            _cursorPosition.store(til::point{ _terminal->GetCursorPosition() }, std::memory_order_relaxed);
+        }
+    }
+
+    // Method Description:
+    // - Tells the scrollback budget how much memory our buffer takes. Buffers
+    //   are allocated for their full size, so this only changes when the buffer
+    //   is created or resized, or when the budget limited it.
+    // - Like the pane statistics, this counts the cells of every row that's
+    //   kept in memory at full width, so it's an upper bound.
+    // Arguments:
+    // - <none>
+    // Return Value:
+    // - <none>
+    void ControlCore::_reportScrollbackUnderLock()
+    {
+        const auto& buffer = _terminal->GetTextBuffer();
+        const auto bytesPerRow = sizeof(ROW) + gsl::narrow_cast<size_t>(buffer.GetSize().Width()) * sizeof(CharRowCell);
+        _scrollbackBudget->Update(buffer.GetResidentRowCount(), bytesPerRow, gsl::narrow_cast<size_t>(_terminal->GetViewport().Height()));
+    }
+
+    // Method Description:
+    // - Called when the scrollback budget wants us to keep fewer rows in memory.
+    //   The rest are spilled into the buffer's spill file, and read back from
+    //   there when they're accessed.
+    // Arguments:
+    // - rows: the number of rows to keep in memory.
+    // Return Value:
+    // - <none>
+    void ControlCore::_limitResidentRows(const size_t rows)
+    {
+        auto lock = _terminal->LockForWriting();
+        try
+        {
+            _terminal->SetResidentRowLimit(rows);
         }
+        CATCH_LOG();
     }
 
     void ControlCore::SizeChanged(const double width,
@@ -846,13 +1578,32 @@ namespace winrt::Microsoft::Terminal::Control::implementation
     {
         _panelWidth = width;
         _panelHeight = height;
+        _lastPanelSizeChange = std::chrono::steady_clock::now();
 
-        auto lock = _terminal->LockForWriting();
-        const auto currentEngineScale = _renderEngine->GetScaling();
+        // The actual resize happens in _resizeToPanel, with whatever the
+        // size of the panel is by then.
+        _resizeToPanel->Run();
+    }
 
-        auto scaledWidth = width * currentEngineScale;
-        auto scaledHeight = height * currentEngineScale;
-        _doResizeUnderLock(scaledWidth, scaledHeight);
+    // Method Description:
+    // - Called when the user starts or stops resizing the window interactively.
+    //   Every resize of the buffer reflows it and makes ConPTY resize and
+    //   repaint as well. During a live resize we thus only resize the buffer
+    //   once the user stops dragging for a moment, and when they let go.
+    // Arguments:
+    // - liveResize: true if the window is being resized interactively now.
+    // Return Value:
+    // - <none>
+    void ControlCore::LiveResizeChanged(const bool liveResize)
+    {
+        _liveResize = liveResize;
+        if (!liveResize && _initializedTerminal)
+        {
+            // Apply the size the panel ended up with right away. This is a
+            // no-op if the panel size didn't change during the drag.
+            auto lock = _terminal->LockForWriting();
+            _refreshSizeUnderLock();
+        }
     }
 
     void ControlCore::ScaleChanged(const double scale)
@@ -955,6 +1706,9 @@ namespace winrt::Microsoft::Terminal::Control::implementation
 
         // convert text: vector<string> --> string
         std::wstring textData;
+        textData.reserve(std::accumulate(bufferData.text.begin(), bufferData.text.end(), size_t{ 0 }, [](const size_t sum, const auto& text) {
+            return sum + text.size();
+        }));
         for (const auto& text : bufferData.text)
         {
             textData += text;
@@ -991,6 +1745,7 @@ namespace winrt::Microsoft::Terminal::Control::implementation
                                                                        winrt::to_hstring(htmlData),
                                                                        winrt::to_hstring(rtfData),
                                                                        formats));
+        _refreezeScrollback->Run();
         return true;
     }
 
@@ -999,6 +1754,7 @@ namespace winrt::Microsoft::Terminal::Control::implementation
     //   before sending it over the terminal's connection.
     void ControlCore::PasteText(const winrt::hstring& hstr)
     {
+        const auto broadcast = _broadcastScope();
         _terminal->WritePastedText(hstr);
         _terminal->ClearSelection();
         _terminal->TrySnapOnInput();
@@ -1038,6 +1794,16 @@ namespace winrt::Microsoft::Terminal::Control::implementation
         return _connection.State();
     }
 
+    uint64_t ControlCore::OutputLength() const noexcept
+    {
+        return _statistics.OutputLength();
+    }
+
+    Windows::Foundation::TimeSpan ControlCore::TimeSinceOutput() const noexcept
+    {
+        return std::chrono::duration_cast<Windows::Foundation::TimeSpan>(std::chrono::steady_clock::now() - _statistics.LastOutputTime());
+    }
+
     hstring ControlCore::Title()
     {
         return hstring{ _terminal->GetConsoleTitle() };
@@ -1130,7 +1896,16 @@ namespace winrt::Microsoft::Terminal::Control::implementation
         // Since this can only ever be triggered by output from the connection,
         // then the Terminal already has the write lock when calling this
         // callback.
-        _TitleChangedHandlers(*this, winrt::make<TitleChangedEventArgs>(winrt::hstring{ wstr }));
+        winrt::hstring title{ wstr };
+        if (!_inUnitTests)
+        {
+            // Only the latest title is passed on, once the throttled func runs.
+            _updateTitle->Run(std::move(title));
+        }
+        else
+        {
+            _TitleChangedHandlers(*this, winrt::make<TitleChangedEventArgs>(title));
+        }
     }
 
     // Method Description:
@@ -1183,6 +1958,13 @@ namespace winrt::Microsoft::Terminal::Control::implementation
         // TODO GH#9617: refine locking around pattern tree
         _terminal->ClearPatternTree();
 
+        // When the terminal scrolls by itself, it does so by whole rows.
+        if (_subRowScrollOffset != 0.0f)
+        {
+            _subRowScrollOffset = 0.0f;
+            _renderEngine->SetSubRowScrollOffset(0.0f);
+        }
+
         // Start the throttled update of our scrollbar.
         auto update{ winrt::make<ScrollPositionChangedArgs>(viewTop,
                                                             viewHeight,
@@ -1198,10 +1980,15 @@ namespace winrt::Microsoft::Terminal::Control::implementation
 
         // Additionally, start the throttled update of where our links are.
         _updatePatternLocations->Run();
+        // The renderer thaws the rows of the scrollback that it's scrolled to.
+        _refreezeScrollback->Run();
     }
 
     void ControlCore::_terminalCursorPositionChanged()
     {
+        // We're called with the terminal locked, while it handles output.
+        _cursorPosition.store(til::point{ _terminal->GetCursorPosition() }, std::memory_order_relaxed);
+
         // When the buffer's cursor moves, start the throttled func to
         // eventually dispatch a CursorPositionChanged event.
         _tsfTryRedrawCanvas->Run();
@@ -1209,7 +1996,16 @@ namespace winrt::Microsoft::Terminal::Control::implementation
 
     void ControlCore::_terminalTaskbarProgressChanged()
     {
-        _TaskbarProgressChangedHandlers(*this, nullptr);
+        // The listeners query TaskbarState() and TaskbarProgress()
+        // themselves, so they'll get the latest values either way.
+        if (!_inUnitTests)
+        {
+            _updateTaskbarProgress->Run();
+        }
+        else
+        {
+            _TaskbarProgressChangedHandlers(*this, nullptr);
+        }
     }
 
     bool ControlCore::HasSelection() const
@@ -1269,12 +2065,316 @@ namespace winrt::Microsoft::Terminal::Control::implementation
 
         ::Search search(*GetUiaData(), text.c_str(), direction, sensitivity);
         auto lock = _terminal->LockForWriting();
-        if (search.FindNext())
+        // Scanning the flattened text of every row at once is much faster than
+        // FindNext's cell by cell comparison when the match is far from the anchor.
+        if (search.FindNextIn(search.FindAll()))
         {
             _terminal->SetBlockSelection(false);
             search.Select();
             _renderer->TriggerSelection();
         }
+        _refreezeScrollback->Run();
+    }
+
+    // Method Description:
+    // - Finds every line of the buffer that contains the given text, on a
+    //   background thread. Just like ExportBuffer, the rows are copied out a
+    //   chunk at a time, so that the terminal is never locked for longer than
+    //   it takes to copy one chunk, and output keeps being processed while
+    //   we search. A line that wraps over several rows is searched as a whole.
+    // Arguments:
+    // - text: the text to search for
+    // - caseSensitive: whether the case of the text has to match
+    // Return Value:
+    // - The lines that contain the text, the last one first. Only the last
+    //   MaxBufferSearchResults of them are returned.
+    Windows::Foundation::IAsyncOperation<Windows::Foundation::Collections::IVector<Control::BufferSearchResult>> ControlCore::FindAllAsync(const winrt::hstring text, const bool caseSensitive)
+    {
+        static constexpr size_t chunkRows = 256;
+        static constexpr size_t maxResults = 500;
+        static constexpr size_t previewContext = 40;
+        static constexpr size_t previewLength = 160;
+
+        auto cancellation = co_await winrt::get_cancellation_token();
+        auto weakThis{ get_weak() };
+        co_await winrt::resume_background();
+
+        std::deque<Control::BufferSearchResult> results;
+        if (text.empty())
+        {
+            co_return winrt::single_threaded_vector<Control::BufferSearchResult>();
+        }
+
+        const auto fold = [&](std::wstring str) {
+            if (!caseSensitive)
+            {
+                std::transform(str.begin(), str.end(), str.begin(), ::towlower);
+            }
+            return str;
+        };
+        const std::wstring exactNeedle{ text };
+        const auto needle = fold(exactNeedle);
+
+        std::pair<ptrdiff_t, ptrdiff_t> range;
+        if (const auto core{ weakThis.get() })
+        {
+            range = core->_terminal->GetExportRange();
+        }
+        auto [row, endRow] = range;
+
+        std::wstring line;
+        ptrdiff_t lineRow = 0;
+        const auto searchLine = [&]() {
+            const auto pos = fold(line).find(needle);
+            if (pos == std::wstring::npos)
+            {
+                return;
+            }
+
+            const auto start = pos > previewContext ? pos - previewContext : 0;
+            std::wstring preview{ start > 0 ? L"\x2026" : L"" };
+            const auto excerpt = std::wstring_view{ line }.substr(start, previewLength);
+            const auto firstNonSpace = start > 0 ? 0 : excerpt.find_first_not_of(L' ');
+            preview.append(excerpt.substr(std::min(firstNonSpace, excerpt.size())));
+
+            results.emplace_back(winrt::make<implementation::BufferSearchResult>(lineRow,
+                                                                                 endRow - lineRow,
+                                                                                 winrt::hstring{ preview },
+                                                                                 caseSensitive || line.find(exactNeedle) != std::wstring::npos));
+            if (results.size() > maxResults)
+            {
+                results.pop_front();
+            }
+        };
+
+        while (row < endRow)
+        {
+            // Once the control is closed, or the search isn't wanted anymore, stop.
+            const auto core{ weakThis.get() };
+            if (!core || core->_IsClosing() || cancellation())
+            {
+                co_return winrt::single_threaded_vector<Control::BufferSearchResult>();
+            }
+
+            const auto rows = core->_terminal->RetrieveRowsForExport(row, endRow, chunkRows, false);
+            auto rowOfText = row - gsl::narrow_cast<ptrdiff_t>(rows.text.size());
+            for (const auto& rowText : rows.text)
+            {
+                if (line.empty())
+                {
+                    lineRow = rowOfText;
+                }
+
+                std::wstring_view view{ rowText };
+                const auto lineEnds = til::ends_with(view, std::wstring_view{ L"\r\n" });
+                if (lineEnds)
+                {
+                    view.remove_suffix(2);
+                }
+                line.append(view);
+
+                if (lineEnds)
+                {
+                    searchLine();
+                    line.clear();
+                }
+                ++rowOfText;
+            }
+        }
+
+        if (!line.empty())
+        {
+            searchLine();
+        }
+
+        if (const auto core{ weakThis.get() })
+        {
+            core->_refreezeScrollback->Run();
+        }
+
+        std::vector<Control::BufferSearchResult> lastFirst{ results.rbegin(), results.rend() };
+        co_return winrt::single_threaded_vector(std::move(lastFirst));
+    }
+
+    // Method Description:
+    // - Scrolls a line that FindAllAsync found to the top of the viewport.
+    //   If it scrolled out of the buffer since, nothing happens.
+    // Arguments:
+    // - result: the line to scroll to.
+    // Return Value:
+    // - <none>
+    void ControlCore::ScrollToSearchResult(const Control::BufferSearchResult& result)
+    {
+        _terminal->ClearPatternTree();
+
+        auto lock = _terminal->LockForWriting();
+        _terminal->ScrollToExportRow(gsl::narrow_cast<ptrdiff_t>(result.Row()));
+    }
+
+    // Method Description:
+    // - Scrolls the previous or next prompt that the shell marked to the top
+    //   of the viewport. The marks are looked up with a binary search, no
+    //   matter how much scrollback there is.
+    // Arguments:
+    // - next: whether to scroll down to the next prompt, rather than up to the previous one.
+    // Return Value:
+    // - <none>
+    void ControlCore::ScrollToMark(const bool next)
+    {
+        _terminal->ClearPatternTree();
+
+        auto lock = _terminal->LockForWriting();
+        _terminal->ScrollToMark(next);
+    }
+
+    // Method Description:
+    // - Selects the output of the previous or next command, as the shell marked it.
+    // Arguments:
+    // - next: whether to select the output of the next command, rather than the previous one.
+    // Return Value:
+    // - <none>
+    void ControlCore::SelectOutput(const bool next)
+    {
+        auto lock = _terminal->LockForWriting();
+        if (_terminal->SelectOutput(next))
+        {
+            _renderer->TriggerSelection();
+        }
+    }
+
+    // Method Description:
+    // - Gets the rows of the prompts that the shell marked, for the scroll bar.
+    // Arguments:
+    // - <none>
+    // Return Value:
+    // - The rows, in ascending order.
+    Windows::Foundation::Collections::IVector<int32_t> ControlCore::ScrollMarkRows() const
+    {
+        std::vector<int32_t> rows;
+        {
+            auto lock = _terminal->LockForReading();
+            for (const auto& mark : _terminal->GetScrollMarks())
+            {
+                if (mark.category == MarkCategory::Prompt)
+                {
+                    rows.emplace_back(gsl::narrow_cast<int32_t>(mark.start.y()));
+                }
+            }
+        }
+        return winrt::single_threaded_vector<int32_t>(std::move(rows));
+    }
+
+    // Method Description:
+    // - Writes the contents of the buffer to a file, on a background thread.
+    //   The rows are retrieved a chunk at a time, so that the terminal is never
+    //   locked for longer than it takes to copy out one chunk. They're formatted
+    //   and written while it isn't locked, and the whole text is never held in
+    //   memory. Rows that scroll out of the buffer until they're written are
+    //   left out, and output that arrives meanwhile may be written in part.
+    // Arguments:
+    // - path: the file to write to. It's replaced if it exists. Environment
+    //   variables in it are expanded. If it's empty, a file named after the
+    //   current time is created in the user's profile directory.
+    // - format: whether to write plain text, or the colors as well, as VT
+    //   sequences or HTML.
+    // Return Value:
+    // - <none>
+    winrt::fire_and_forget ControlCore::ExportBuffer(const winrt::hstring path, const ExportFormat format)
+    {
+        static constexpr size_t chunkRows = 256;
+
+        auto bufferFormat = TextBuffer::ExportFormat::Text;
+        std::wstring_view extension{ L".txt" };
+        switch (format)
+        {
+        case ExportFormat::Vt:
+            bufferFormat = TextBuffer::ExportFormat::Vt;
+            extension = L".ans";
+            break;
+        case ExportFormat::Html:
+            bufferFormat = TextBuffer::ExportFormat::Html;
+            extension = L".html";
+            break;
+        default:
+            break;
+        }
+
+        std::wstring filePath{ path };
+        if (filePath.empty())
+        {
+            SYSTEMTIME time{};
+            GetLocalTime(&time);
+            filePath = fmt::format(L"%USERPROFILE%\\terminal-{:04}{:02}{:02}-{:02}{:02}{:02}{}",
+                                   time.wYear,
+                                   time.wMonth,
+                                   time.wDay,
+                                   time.wHour,
+                                   time.wMinute,
+                                   time.wSecond,
+                                   extension);
+        }
+
+        // The font and the settings are only ours to read on this thread.
+        const auto prologue = TextBuffer::GenExportPrologue(bufferFormat,
+                                                            _actualFont.GetUnscaledSize().Y,
+                                                            _actualFont.GetFaceName(),
+                                                            til::color{ _settings.DefaultBackground() });
+
+        auto weakThis{ get_weak() };
+        co_await winrt::resume_background();
+
+        try
+        {
+            wil::unique_hfile file{ CreateFileW(wil::ExpandEnvironmentStringsW<std::wstring>(filePath.c_str()).c_str(),
+                                                GENERIC_WRITE,
+                                                FILE_SHARE_READ,
+                                                nullptr,
+                                                CREATE_ALWAYS,
+                                                FILE_ATTRIBUTE_NORMAL | FILE_FLAG_SEQUENTIAL_SCAN,
+                                                nullptr) };
+            THROW_LAST_ERROR_IF(!file);
+
+            const auto write = [&](const std::string_view data) {
+                DWORD written{};
+                THROW_IF_WIN32_BOOL_FALSE(WriteFile(file.get(), data.data(), gsl::narrow<DWORD>(data.size()), &written, nullptr));
+            };
+
+            write(prologue);
+
+            std::pair<ptrdiff_t, ptrdiff_t> range;
+            if (const auto core{ weakThis.get() })
+            {
+                range = core->_terminal->GetExportRange();
+            }
+            auto [row, endRow] = range;
+
+            std::string chunk;
+            while (row < endRow)
+            {
+                // Once the control is closed, there's nothing left to export.
+                const auto core{ weakThis.get() };
+                if (!core || core->_IsClosing())
+                {
+                    co_return;
+                }
+
+                const auto rows = core->_terminal->RetrieveRowsForExport(row, endRow, chunkRows, bufferFormat != TextBuffer::ExportFormat::Text);
+                chunk.clear();
+                TextBuffer::AppendExportRows(chunk, rows, bufferFormat);
+                write(chunk);
+            }
+
+            write(TextBuffer::GenExportEpilogue(bufferFormat));
+        }
+        catch (...)
+        {
+            LOG_CAUGHT_EXCEPTION();
+            if (const auto core{ weakThis.get() })
+            {
+                const winrt::hstring message{ fmt::format(std::wstring_view{ RS_(L"NoticeExportFailed") }, filePath) };
+                core->_RaiseNoticeHandlers(*core, winrt::make<NoticeEventArgs>(NoticeLevel::Warning, message));
+            }
+        }
     }
 
     void ControlCore::SetBackgroundOpacity(const double opacity)
@@ -1319,8 +2419,18 @@ namespace winrt::Microsoft::Terminal::Control::implementation
             _closing = true;
 
             // Stop accepting new output and state changes before we disconnect everything.
-            _connection.TerminalOutput(_connectionOutputEventToken);
+            if (_bufferedConnection)
+            {
+                _bufferedConnection.TerminalOutputBuffer(_connectionOutputEventToken);
+            }
+            else
+            {
+                _connection.TerminalOutput(_connectionOutputEventToken);
+            }
             _connectionStateChangedRevoker.revoke();
+            _powerSupplyStatusChangedRevoker.revoke();
+            _energySaverStatusChangedRevoker.revoke();
+            _broadcastTargets.clear();
 
             // GH#1996 - Close the connection asynchronously on a background
             // thread.
@@ -1372,6 +2482,11 @@ namespace winrt::Microsoft::Terminal::Control::implementation
         _terminal->SetCursorOn(!_terminal->IsCursorOn());
     }
 
+    bool ControlCore::PowerSaving() const noexcept
+    {
+        return _powerSaving.load(std::memory_order_relaxed);
+    }
+
     bool ControlCore::CursorOn() const
     {
         return _terminal->IsCursorOn();
@@ -1392,16 +2507,18 @@ namespace winrt::Microsoft::Terminal::Control::implementation
         return _terminal != nullptr && _terminal->IsTrackingMouseInput();
     }
 
-    til::point ControlCore::CursorPosition() const
+    // Method Description:
+    // - Gets the position of the cursor within the viewport, as of the last
+    //   time the cursor moved or the terminal was resized. The TSF input control
+    //   asks for it on every IME layout request, so it doesn't take the lock,
+    //   which the connection might be holding on to while it writes output.
+    // Arguments:
+    // - <none>
+    // Return Value:
+    // - the cursor position in cells, relative to the viewport.
+    til::point ControlCore::CursorPosition() const noexcept
     {
-        // If we haven't been initialized yet, then fake it.
-        if (!_initializedTerminal)
-        {
-            return { 0, 0 };
-        }
-
-        auto lock = _terminal->LockForReading();
-        return _terminal->GetCursorPosition();
+        return _cursorPosition.load(std::memory_order_relaxed);
     }
 
     // This one's really pushing the boundary of what counts as "encapsulation".
@@ -1474,6 +2591,56 @@ namespace winrt::Microsoft::Terminal::Control::implementation
         _renderer->AddRenderEngine(pEngine);
     }
 
+    // Method Description:
+    // - Returns the dispatcher that the core's throttled functions run on.
+    winrt::Windows::System::DispatcherQueue ControlCore::Dispatcher() const noexcept
+    {
+        return _dispatcher;
+    }
+
+    bool ControlCore::SmoothScrolling() const
+    {
+        return _settings.SmoothScrolling();
+    }
+
+    // Method Description:
+    // - Gets the fraction of a row that the text is scrolled down by, on top
+    //   of the ScrollOffset(). This is always 0 unless smooth scrolling is enabled.
+    float ControlCore::SubRowScrollOffset() const noexcept
+    {
+        return _subRowScrollOffset;
+    }
+
+    // Method Description:
+    // - In smooth scrolling mode, scrolls the text down by the given fraction
+    //   of a row, on top of the ScrollOffset(). The renderer moves what it
+    //   already drew instead of repainting it, and only paints the row below
+    //   the viewport that this reveals. At the bottom of the buffer there's
+    //   no such row, so the offset is always 0 there.
+    // Arguments:
+    // - offset: the fraction of a row, between 0 and 1
+    void ControlCore::SetSubRowScrollOffset(const double offset)
+    {
+        if (!_initializedTerminal || !_settings.SmoothScrolling())
+        {
+            return;
+        }
+
+        auto lock = _terminal->LockForWriting();
+
+        const auto viewport = _terminal->GetViewport();
+        const auto atBottom = viewport.BottomExclusive() >= _terminal->GetBufferHeight();
+        const auto newOffset = atBottom ? 0.0f : std::clamp(::base::saturated_cast<float>(offset), 0.0f, 1.0f);
+        if (newOffset == _subRowScrollOffset)
+        {
+            return;
+        }
+
+        _subRowScrollOffset = newOffset;
+        _renderEngine->SetSubRowScrollOffset(newOffset);
+        _renderer->TriggerRedraw(Viewport::FromDimensions({ viewport.Left(), viewport.BottomExclusive() }, viewport.Width(), 1));
+    }
+
     bool ControlCore::IsInReadOnlyMode() const
     {
         return _isReadOnly;
@@ -1491,7 +2658,32 @@ namespace winrt::Microsoft::Terminal::Control::implementation
     }
     void ControlCore::_connectionOutputHandler(const hstring& hstr)
     {
-        _terminal->Write(hstr);
+        _connectionOutput(hstr);
+    }
+
+    // Method Description:
+    // - Handles the output of a connection that hands it over in a buffer of its
+    //   own, which we read in place. The connection reuses the buffer once we
+    //   release it, which we do as soon as the output was written.
+    // Arguments:
+    // - buffer: the output in UTF-16.
+    void ControlCore::_connectionOutputBufferHandler(const Windows::Foundation::IMemoryBufferReference& buffer)
+    {
+        BYTE* data{};
+        UINT32 capacity{};
+        THROW_IF_FAILED(buffer.as<::Windows::Foundation::IMemoryBufferByteAccess>()->GetBuffer(&data, &capacity));
+#pragma warning(suppress : 26490) // Don't use reinterpret_cast (type.1). The buffer holds UTF-16.
+        _connectionOutput({ reinterpret_cast<const wchar_t*>(data), capacity / sizeof(wchar_t) });
+    }
+
+    void ControlCore::_connectionOutput(const std::wstring_view text)
+    {
+        const auto writeStart = std::chrono::steady_clock::now();
+        _inputLatency.Mark(InputLatencyTracker::Stage::OutputRead, writeStart);
+        const auto lockWait = _terminal->Write(text);
+        const auto writeEnd = std::chrono::steady_clock::now();
+        _inputLatency.Mark(InputLatencyTracker::Stage::OutputWritten, writeEnd);
+        _statistics.OutputWritten(text.size(), writeEnd - writeStart, lockWait, writeEnd);
 
         // Start the throttled update of where our hyperlinks are.
         _updatePatternLocations->Run();
@@ -23,6 +23,9 @@
 #include "../../cascadia/TerminalCore/Terminal.hpp"
 #include "../buffer/out/search.h"
 #include "cppwinrt_utils.h"
+#include "InputLatencyTracker.h"
+#include "ControlStatistics.h"
+#include "ScrollbackBudget.h"
 
 namespace ControlUnitTests
 {
@@ -43,11 +46,14 @@ namespace winrt::Microsoft::Terminal::Control::implementation
                         const double actualHeight,
                         const double compositionScale);
         void EnablePainting();
+        void SetOccluded(const bool occluded);
+        void KeepRenderingWhileOccluded(const bool keepRendering);
 
         void UpdateSettings(const IControlSettings& settings);
         void UpdateAppearance(const IControlAppearance& newAppearance);
         void SizeChanged(const double width, const double height);
         void ScaleChanged(const double scale);
+        void LiveResizeChanged(const bool liveResize);
         uint64_t SwapChainHandle() const;
 
         void AdjustFontSize(int fontSizeDelta);
@@ -64,9 +70,14 @@ namespace winrt::Microsoft::Terminal::Control::implementation
 
         void SendInput(const winrt::hstring& wstr);
         void PasteText(const winrt::hstring& hstr);
+
+        TerminalConnection::ITerminalConnection Connection() const noexcept;
+        void BroadcastInputTo(const Windows::Foundation::Collections::IVector<TerminalConnection::ITerminalConnection>& connections);
         bool CopySelectionToClipboard(bool singleLine, const Windows::Foundation::IReference<CopyFormat>& formats);
 
         void ToggleShaderEffects();
+        void ToggleFrameStatistics();
+        void StartInputLatencySample();
         void AdjustOpacity(const double adjustment);
         void ResumeRendering();
 
@@ -91,6 +102,9 @@ namespace winrt::Microsoft::Terminal::Control::implementation
 
         TerminalConnection::ConnectionState ConnectionState() const;
 
+        uint64_t OutputLength() const noexcept;
+        Windows::Foundation::TimeSpan TimeSinceOutput() const noexcept;
+
         int ScrollOffset();
         int ViewHeight() const;
         int BufferHeight() const;
@@ -117,10 +131,11 @@ namespace winrt::Microsoft::Terminal::Control::implementation
         void BlinkAttributeTick();
         void BlinkCursor();
         bool CursorOn() const;
+        bool PowerSaving() const noexcept;
         void CursorOn(const bool isCursorOn);
 
         bool IsVtMouseModeEnabled() const;
-        til::point CursorPosition() const;
+        til::point CursorPosition() const noexcept;
 
         bool HasSelection() const;
         bool CopyOnSelect() const;
@@ -132,6 +147,13 @@ namespace winrt::Microsoft::Terminal::Control::implementation
                     const bool goForward,
                     const bool caseSensitive);
 
+        Windows::Foundation::IAsyncOperation<Windows::Foundation::Collections::IVector<Control::BufferSearchResult>> FindAllAsync(const winrt::hstring text, const bool caseSensitive);
+        void ScrollToSearchResult(const Control::BufferSearchResult& result);
+        void ScrollToMark(const bool next);
+        void SelectOutput(const bool next);
+        Windows::Foundation::Collections::IVector<int32_t> ScrollMarkRows() const;
+        winrt::fire_and_forget ExportBuffer(const winrt::hstring path, const ExportFormat format);
+
         void LeftClickOnTerminal(const til::point terminalPosition,
                                  const int numberOfClicks,
                                  const bool altEnabled,
@@ -144,6 +166,12 @@ namespace winrt::Microsoft::Terminal::Control::implementation
         bool IsInReadOnlyMode() const;
         void ToggleReadOnlyMode();
 
+        winrt::Windows::System::DispatcherQueue Dispatcher() const noexcept;
+
+        bool SmoothScrolling() const;
+        float SubRowScrollOffset() const noexcept;
+        void SetSubRowScrollOffset(const double offset);
+
         // -------------------------------- WinRT Events ---------------------------------
         // clang-format off
         WINRT_CALLBACK(FontSizeChanged, Control::FontSizeChangedEventArgs);
@@ -172,10 +200,58 @@ namespace winrt::Microsoft::Terminal::Control::implementation
 
         TerminalConnection::ITerminalConnection _connection{ nullptr };
         event_token _connectionOutputEventToken;
+        TerminalConnection::ITerminalConnectionBuffered _bufferedConnection{ nullptr };
         TerminalConnection::ITerminalConnection::StateChanged_revoker _connectionStateChangedRevoker;
 
+        // The input that the user sends while a _broadcastScope() is alive is
+        // written to these connections as well, once it's been encoded for ours.
+        // The scope is tied to the thread it was entered on, so that the replies to
+        // VT queries, that the output thread sends, stay with our connection.
+        std::vector<TerminalConnection::ITerminalConnection> _broadcastTargets;
+        std::atomic<DWORD> _broadcastThreadId{ 0 };
+
+        // Updated for every piece of output, on the thread that receives it. The
+        // tab polls the output length and time to tell whether it's busy while
+        // it's in the background, without the control of a hidden tab having to
+        // raise events for it. The statistics overlay shows the rest.
+        ControlStatistics _statistics;
+
+        // Our share of the process-wide scrollback memory budget.
+        std::unique_ptr<ScrollbackBudget::Pane> _scrollbackBudget;
+
+        // While the device runs on battery or battery saver is on, and the
+        // PowerSavingRendering setting allows it, the renderer saves power and
+        // the cursor stops blinking once the user stopped typing for a while.
+        // The power status events arrive on a background thread.
+        std::atomic<bool> _powerSavingAllowed{ false };
+        std::atomic<bool> _powerSaving{ false };
+        winrt::Windows::System::Power::PowerManager::PowerSupplyStatusChanged_revoker _powerSupplyStatusChangedRevoker;
+        winrt::Windows::System::Power::PowerManager::EnergySaverStatusChanged_revoker _energySaverStatusChangedRevoker;
+        void _updatePowerSaving() noexcept;
+        void _reportScrollbackUnderLock();
+        void _limitResidentRows(const size_t rows);
+
+        auto _broadcastScope() noexcept
+        {
+            if (!_broadcastTargets.empty())
+            {
+                _broadcastThreadId.store(GetCurrentThreadId(), std::memory_order_relaxed);
+            }
+            return wil::scope_exit([this]() noexcept { _broadcastThreadId.store(0, std::memory_order_relaxed); });
+        }
+
         std::unique_ptr<::Microsoft::Terminal::Core::Terminal> _terminal{ nullptr };
 
+        // The renderer reports presented frames to this from its thread,
+        // so it has to outlive the _renderer below.
+        InputLatencyTracker _inputLatency;
+        std::atomic<bool> _frameStatisticsShown{ false };
+
+        // Published whenever the cursor moves, while the terminal is locked.
+        std::atomic<til::point> _cursorPosition{};
+
+        float _subRowScrollOffset{ 0.0f };
+
         // NOTE: _renderEngine must be ordered before _renderer.
         //
         // As _renderer has a dependency on _renderEngine (through a raw pointer)
@@ -206,13 +282,36 @@ namespace winrt::Microsoft::Terminal::Control::implementation
         double _panelHeight{ 0 };
         double _compositionScale{ 0 };
 
+        // While the window is being resized interactively, the buffer is
+        // only resized once the panel size has settled for a moment.
+        bool _liveResize{ false };
+        std::chrono::steady_clock::time_point _lastPanelSizeChange{};
+
+        // Occluded controls hibernate after a while, see _hibernate().
+        bool _occluded{ false };
+        bool _keepRenderingWhileOccluded{ false };
+        bool _hibernated{ false };
+        std::chrono::steady_clock::time_point _occludedSince{};
+
         winrt::Windows::System::DispatcherQueue _dispatcher{ nullptr };
         std::shared_ptr<ThrottledFuncTrailing<>> _tsfTryRedrawCanvas;
         std::shared_ptr<ThrottledFuncTrailing<>> _updatePatternLocations;
         std::shared_ptr<ThrottledFuncTrailing<Control::ScrollPositionChangedArgs>> _updateScrollBar;
+        std::shared_ptr<ThrottledFuncTrailing<winrt::hstring>> _updateTitle;
+        std::shared_ptr<ThrottledFuncTrailing<>> _updateTaskbarProgress;
+        std::shared_ptr<ThrottledFuncTrailing<>> _resizeToPanel;
+        std::shared_ptr<ThrottledFuncTrailing<>> _hibernateWhenIdle;
+        std::shared_ptr<ThrottledFuncTrailing<>> _refreezeScrollback;
 
         winrt::fire_and_forget _asyncCloseConnection();
 
+        static std::unique_ptr<::Microsoft::Console::Render::DxEngine> _takeWarmRenderEngine();
+        void _prewarmRenderEngine();
+        static winrt::fire_and_forget _prewarmRenderEngineAsync(FontInfoDesired desiredFont,
+                                                                const int dpi,
+                                                                std::unordered_map<winrt::hstring, uint32_t> features,
+                                                                std::unordered_map<winrt::hstring, float> axes);
+
         void _setFontSize(int fontSize);
         void _updateFont(const bool initialUpdate = false);
         void _refreshSizeUnderLock();
@@ -237,13 +336,23 @@ namespace winrt::Microsoft::Terminal::Control::implementation
 #pragma region RendererCallbacks
         void _rendererWarning(const HRESULT hr);
         void _renderEngineSwapChainChanged();
+        void _rendererFramePresented(const InputLatencyTracker::clock::time_point frameStart);
+        void _updatePaneStatistics();
 #pragma endregion
 
         void _raiseReadOnlyWarning();
         void _updateAntiAliasingMode(::Microsoft::Console::Render::DxEngine* const dxEngine);
+        void _updateThreadScheduling();
         void _connectionOutputHandler(const hstring& hstr);
+        void _connectionOutputBufferHandler(const Windows::Foundation::IMemoryBufferReference& buffer);
+        void _connectionOutput(const std::wstring_view text);
         void _updateHoveredCell(const std::optional<til::point> terminalPosition);
 
+        bool _canHibernate() const noexcept;
+        void _hibernate();
+        void _wake();
+        void _watchLowMemory(const bool watch);
+
         inline bool _IsClosing() const noexcept
         {
 #ifndef NDEBUG
@@ -262,6 +371,9 @@ namespace winrt::Microsoft::Terminal::Control::implementation
         friend class ControlUnitTests::ControlCoreTests;
         friend class ControlUnitTests::ControlInteractivityTests;
         bool _inUnitTests{ false };
+
+        // Destroyed first, since its callback uses `this`.
+        wil::unique_threadpool_wait _lowMemoryWait;
     };
 }
 
@@ -27,6 +27,10 @@ using namespace winrt::Windows::ApplicationModel::DataTransfer;
 
 static constexpr unsigned int MAX_CLICK_COUNT = 3;
 
+// Mouse moves and touch panning are sent at most this often. That's about a
+// frame at 120Hz, the same as the interval of the scrollbar updates.
+static constexpr auto PointerUpdateInterval = std::chrono::milliseconds(8);
+
 namespace winrt::Microsoft::Terminal::Control::implementation
 {
     static constexpr TerminalInput::MouseButtonState toInternalMouseState(const Control::MouseButtonState& state)
@@ -46,6 +50,16 @@ namespace winrt::Microsoft::Terminal::Control::implementation
         _selectionNeedsToBeCopied{ false }
     {
         _core = winrt::make_self<ControlCore>(settings, connection);
+
+        _flushPointerUpdates = std::make_shared<ThrottledFuncTrailing<>>(
+            _core->Dispatcher(),
+            PointerUpdateInterval,
+            [weakThis = get_weak()]() {
+                if (auto interactivity{ weakThis.get() })
+                {
+                    interactivity->_sendPendingPointerUpdates();
+                }
+            });
     }
 
     // Method Description:
@@ -218,6 +232,7 @@ namespace winrt::Microsoft::Terminal::Control::implementation
             // If the click happened outside the active region, just don't send any mouse event
             if (const auto adjustedY = terminalPosition.y() - adjustment; adjustedY >= 0)
             {
+                _sendPointerUpdatesBeforeButton();
                 _core->SendMouseEvent({ terminalPosition.x(), adjustedY }, pointerUpdateKind, modifiers, 0, toInternalMouseState(buttonState));
             }
         }
@@ -287,7 +302,22 @@ namespace winrt::Microsoft::Terminal::Control::implementation
         // Short-circuit isReadOnly check to avoid warning dialog
         if (focused && !_core->IsInReadOnlyMode() && _canSendVTMouseInput(modifiers))
         {
-            _core->SendMouseEvent(terminalPosition, pointerUpdateKind, modifiers, 0, toInternalMouseState(buttonState));
+            const MouseMove move{ terminalPosition, pointerUpdateKind, modifiers, buttonState };
+            {
+                const std::scoped_lock lock{ _pointerUpdateLock };
+                // If the pointer only moved within the cell we last reported,
+                // there's nothing new to tell the application. That's also
+                // true if it came back there before the frame was over.
+                if (move == _lastMouseMove)
+                {
+                    _pendingMouseMove.reset();
+                }
+                else
+                {
+                    _pendingMouseMove = move;
+                }
+            }
+            _schedulePointerUpdates();
         }
         // GH#4603 - don't modify the selection if the pointer press didn't
         // actually start _in_ the control bounds. Case in point - someone drags
@@ -329,6 +359,21 @@ namespace winrt::Microsoft::Terminal::Control::implementation
     {
         if (focused &&
             _touchAnchor)
+        {
+            {
+                const std::scoped_lock lock{ _pointerUpdateLock };
+                _pendingTouchPoint = newTouchPoint;
+            }
+            _schedulePointerUpdates();
+        }
+    }
+
+    // Method Description:
+    // - Pans the viewport by the distance between the touch anchor and the
+    //   given point, once that's more than half a row.
+    void ControlInteractivity::_panToTouchPoint(const til::point newTouchPoint)
+    {
+        if (_touchAnchor)
         {
             const auto anchor = _touchAnchor.value();
 
@@ -370,6 +415,7 @@ namespace winrt::Microsoft::Terminal::Control::implementation
         // Short-circuit isReadOnly check to avoid warning dialog
         if (!_core->IsInReadOnlyMode() && _canSendVTMouseInput(modifiers))
         {
+            _sendPointerUpdatesBeforeButton();
             _core->SendMouseEvent(terminalPosition, pointerUpdateKind, modifiers, 0, toInternalMouseState(buttonState));
             return;
         }
@@ -390,9 +436,76 @@ namespace winrt::Microsoft::Terminal::Control::implementation
 
     void ControlInteractivity::TouchReleased()
     {
+        // The last bit of panning still has to happen before we let go.
+        _sendPendingPointerUpdates();
         _touchAnchor = std::nullopt;
     }
 
+    // Method Description:
+    // - Sends the pending mouse move and touch panning right away, if the last
+    //   ones were sent more than a frame ago. Otherwise they're sent once the
+    //   frame is over, along with anything else that arrives until then.
+    void ControlInteractivity::_schedulePointerUpdates()
+    {
+        bool sendNow;
+        {
+            const std::scoped_lock lock{ _pointerUpdateLock };
+            sendNow = std::chrono::steady_clock::now() - _lastPointerUpdate >= PointerUpdateInterval;
+        }
+
+        if (sendNow)
+        {
+            _sendPendingPointerUpdates();
+        }
+        else
+        {
+            _flushPointerUpdates->Run();
+        }
+    }
+
+    void ControlInteractivity::_sendPendingPointerUpdates()
+    {
+        std::optional<MouseMove> move;
+        std::optional<til::point> touchPoint;
+        {
+            const std::scoped_lock lock{ _pointerUpdateLock };
+            if (!_pendingMouseMove && !_pendingTouchPoint)
+            {
+                return;
+            }
+
+            move = std::exchange(_pendingMouseMove, std::nullopt);
+            touchPoint = std::exchange(_pendingTouchPoint, std::nullopt);
+            if (move)
+            {
+                _lastMouseMove = move;
+            }
+            _lastPointerUpdate = std::chrono::steady_clock::now();
+        }
+
+        if (move)
+        {
+            _core->SendMouseEvent(move->terminalPosition, move->pointerUpdateKind, move->modifiers, 0, toInternalMouseState(move->buttonState));
+        }
+        if (touchPoint)
+        {
+            _panToTouchPoint(*touchPoint);
+        }
+    }
+
+    // Method Description:
+    // - Presses, releases and wheel events aren't coalesced. The moves held
+    //   back until the end of the frame are sent before them, so that the
+    //   application still sees everything in the order it happened.
+    void ControlInteractivity::_sendPointerUpdatesBeforeButton()
+    {
+        _sendPendingPointerUpdates();
+
+        const std::scoped_lock lock{ _pointerUpdateLock };
+        // A move to the cell we last reported is news again after a button.
+        _lastMouseMove.reset();
+    }
+
     // Method Description:
     // - Actually handle a scrolling event, whether from a mouse wheel or a
     //   touchpad scroll. Depending upon what modifier keys are pressed,
@@ -415,6 +528,8 @@ namespace winrt::Microsoft::Terminal::Control::implementation
         // Short-circuit isReadOnly check to avoid warning dialog
         if (!_core->IsInReadOnlyMode() && _canSendVTMouseInput(modifiers))
         {
+            _sendPointerUpdatesBeforeButton();
+
             // Most mouse event handlers call
             //      _trySendMouseEvent(point);
             // here with a PointerPoint. However, as of #979, we don't have a
@@ -489,7 +604,7 @@ namespace winrt::Microsoft::Terminal::Control::implementation
         // underneath us. We wouldn't know - we don't want the overhead of
         // another ScrollPositionChanged handler. If the scrollbar should be
         // somewhere other than where it is currently, then start from that row.
-        const int currentInternalRow = ::base::saturated_cast<int>(::std::round(_internalScrollbarPosition));
+        const int currentInternalRow = _scrollbarPositionToRow(_internalScrollbarPosition);
         const int currentCoreRow = _core->ScrollOffset();
         const double currentOffset = currentInternalRow == currentCoreRow ?
                                          _internalScrollbarPosition :
@@ -545,7 +660,7 @@ namespace winrt::Microsoft::Terminal::Control::implementation
         // If the new scrollbar position, rounded to an int, is at a different
         // row, then actually update the scroll position in the core, and raise
         // a ScrollPositionChanged to inform the control.
-        int viewTop = ::base::saturated_cast<int>(::std::round(_internalScrollbarPosition));
+        int viewTop = _scrollbarPositionToRow(_internalScrollbarPosition);
         if (viewTop != _core->ScrollOffset())
         {
             _core->UserScrollViewport(viewTop);
@@ -556,6 +671,20 @@ namespace winrt::Microsoft::Terminal::Control::implementation
                                                                                   _core->ViewHeight(),
                                                                                   _core->BufferHeight()));
         }
+
+        // In smooth scrolling mode, the rest is scrolled by moving the text
+        // by a fraction of a row.
+        _core->SetSubRowScrollOffset(_internalScrollbarPosition - viewTop);
+    }
+
+    // Method Description:
+    // - Gets the row that the top of the viewport is at, for the given
+    //   position of our internal scrollbar. In smooth scrolling mode, the
+    //   viewport only moves on to the next row once it's shown entirely.
+    int ControlInteractivity::_scrollbarPositionToRow(const double position) const
+    {
+        const auto row = _core->SmoothScrolling() ? ::std::floor(position) : ::std::round(position);
+        return ::base::saturated_cast<int>(row);
     }
 
     void ControlInteractivity::_hyperlinkHandler(const std::wstring_view uri)
@@ -596,8 +725,10 @@ namespace winrt::Microsoft::Terminal::Control::implementation
     {
         // Get the size of the font, which is in pixels
         const til::size fontSize{ _core->GetFont().GetSize() };
+        // In smooth scrolling mode, the text may be moved up by a fraction of a row.
+        const auto subRowOffset = ::base::saturated_cast<ptrdiff_t>(_core->SubRowScrollOffset() * fontSize.height());
         // Convert the location in pixels to characters within the current viewport.
-        return til::point{ pixelPosition / fontSize };
+        return til::point{ (pixelPosition + til::point{ 0, subRowOffset }) / fontSize };
     }
 
     // Method Description:
@@ -127,6 +127,35 @@ namespace winrt::Microsoft::Terminal::Control::implementation
 
         std::optional<interval_tree::IntervalTree<til::point, size_t>::interval> _lastHoveredInterval{ std::nullopt };
 
+        // Pointers can report motion far more often than we can draw frames.
+        // Mouse moves are only sent to the connection when the cell they're
+        // in (or the buttons or modifiers) changed, and like touch panning
+        // they're sent at most once per frame. Whatever arrives in between is
+        // held here, and the latest state wins when the frame is over.
+        struct MouseMove
+        {
+            til::point terminalPosition;
+            unsigned int pointerUpdateKind;
+            ::Microsoft::Terminal::Core::ControlKeyStates modifiers;
+            Control::MouseButtonState buttonState;
+
+            bool operator==(const MouseMove& other) const noexcept
+            {
+                return terminalPosition == other.terminalPosition &&
+                       pointerUpdateKind == other.pointerUpdateKind &&
+                       modifiers == other.modifiers &&
+                       buttonState == other.buttonState;
+            }
+        };
+        std::optional<MouseMove> _lastMouseMove;
+        std::optional<MouseMove> _pendingMouseMove;
+        std::optional<til::point> _pendingTouchPoint;
+        std::chrono::steady_clock::time_point _lastPointerUpdate{};
+        std::shared_ptr<ThrottledFuncTrailing<>> _flushPointerUpdates;
+        // The flush runs on the core's dispatcher, which isn't our thread when
+        // we're hosted out of proc.
+        std::mutex _pointerUpdateLock;
+
         unsigned int _numberOfClicks(til::point clickPos, Timestamp clickTime);
         void _updateSystemParameterSettings() noexcept;
 
@@ -140,7 +169,13 @@ namespace winrt::Microsoft::Terminal::Control::implementation
         bool _canSendVTMouseInput(const ::Microsoft::Terminal::Core::ControlKeyStates modifiers);
 
         void _sendPastedTextToConnection(std::wstring_view wstr);
+        void _schedulePointerUpdates();
+        void _sendPendingPointerUpdates();
+        void _sendPointerUpdatesBeforeButton();
+        void _sendMouseMove(const MouseMove& move);
+        void _panToTouchPoint(const til::point newTouchPoint);
         til::point _getTerminalPosition(const til::point& pixelPosition);
+        int _scrollbarPositionToRow(const double position) const;
 
         friend class ControlUnitTests::ControlCoreTests;
         friend class ControlUnitTests::ControlInteractivityTests;
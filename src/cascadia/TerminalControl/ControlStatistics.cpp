@@ -0,0 +1,135 @@
+// Copyright (c) Microsoft Corporation.
+// Licensed under the MIT license.
+
+#include "pch.h"
+#include "ControlStatistics.h"
+
+static uint64_t s_Microseconds(const std::chrono::steady_clock::duration duration) noexcept
+{
+    return gsl::narrow_cast<uint64_t>(std::chrono::duration_cast<std::chrono::microseconds>(duration).count());
+}
+
+// Formats a value with the largest unit that keeps it above 1.
+static std::wstring s_FormatWithUnit(const float value, const float base, const std::array<std::wstring_view, 4>& units)
+{
+    auto scaled = value;
+    size_t unit = 0;
+    while (scaled >= base && unit < units.size() - 1)
+    {
+        scaled /= base;
+        ++unit;
+    }
+    return fmt::format(L"{:.1f}{}", scaled, til::at(units, unit));
+}
+
+namespace winrt::Microsoft::Terminal::Control::implementation
+{
+    // Method Description:
+    // - Accounts for a piece of output that was just written into the terminal.
+    //   Called on the thread that receives the output.
+    // Arguments:
+    // - length: the number of characters that were written.
+    // - writeTime: how long Terminal::Write took, including the lock wait.
+    // - lockWait: how long Terminal::Write waited for the lock.
+    // - now: the time the write finished.
+    // Return Value:
+    // - <none>
+    void ControlStatistics::OutputWritten(const size_t length, const clock::duration writeTime, const clock::duration lockWait, const clock::time_point now) noexcept
+    {
+        _outputLength.fetch_add(length, std::memory_order_relaxed);
+        _writeMicroseconds.fetch_add(s_Microseconds(writeTime), std::memory_order_relaxed);
+        _outputLockWaitMicroseconds.fetch_add(s_Microseconds(lockWait), std::memory_order_relaxed);
+        _lastOutputTime.store(now.time_since_epoch().count(), std::memory_order_relaxed);
+    }
+
+    uint64_t ControlStatistics::OutputLength() const noexcept
+    {
+        return _outputLength.load(std::memory_order_relaxed);
+    }
+
+    ControlStatistics::clock::time_point ControlStatistics::LastOutputTime() const noexcept
+    {
+        return clock::time_point{ clock::duration{ _lastOutputTime.load(std::memory_order_relaxed) } };
+    }
+
+    bool ControlStatistics::IsSnapshotDue(const clock::time_point now) const noexcept
+    {
+        const clock::time_point previous{ clock::duration{ _previousTime.load(std::memory_order_relaxed) } };
+        return now - previous >= SnapshotInterval;
+    }
+
+    // Method Description:
+    // - Computes the rates since the previous snapshot from the output totals
+    //   and the given frame statistics of the renderer.
+    // Arguments:
+    // - frames: the renderer's frame statistics.
+    // - scrollbackRows: the number of rows in the buffer.
+    // - bufferBytes: the size of the buffer's cells.
+    // - now: the time the snapshot is taken.
+    // Return Value:
+    // - The snapshot.
+    ControlStatistics::Snapshot ControlStatistics::TakeSnapshot(const ::Microsoft::Console::Render::FrameStatistics& frames,
+                                                                const size_t scrollbackRows,
+                                                                const size_t bufferBytes,
+                                                                const clock::time_point now)
+    {
+        const Totals totals{
+            _outputLength.load(std::memory_order_relaxed),
+            _writeMicroseconds.load(std::memory_order_relaxed),
+            _outputLockWaitMicroseconds.load(std::memory_order_relaxed),
+            frames.framesPainted,
+            frames.paintMicroseconds,
+            frames.lockWaitMicroseconds,
+        };
+
+        Totals delta{};
+        clock::time_point previousTime;
+        {
+            std::lock_guard guard{ _lock };
+            delta = {
+                totals.outputLength - _previous.outputLength,
+                totals.writeMicroseconds - _previous.writeMicroseconds,
+                totals.outputLockWaitMicroseconds - _previous.outputLockWaitMicroseconds,
+                totals.framesPainted - _previous.framesPainted,
+                totals.paintMicroseconds - _previous.paintMicroseconds,
+                totals.renderLockWaitMicroseconds - _previous.renderLockWaitMicroseconds,
+            };
+            previousTime = clock::time_point{ clock::duration{ _previousTime.load(std::memory_order_relaxed) } };
+            _previous = totals;
+            _previousTime.store(now.time_since_epoch().count(), std::memory_order_relaxed);
+        }
+
+        const auto seconds = std::max(std::chrono::duration<float>(now - previousTime).count(), 0.001f);
+        const auto perSecond = [&](const uint64_t value) noexcept {
+            return gsl::narrow_cast<float>(value) / seconds;
+        };
+
+        Snapshot snapshot{};
+        snapshot.outputCharactersPerSecond = perSecond(delta.outputLength);
+        snapshot.writeMillisecondsPerSecond = perSecond(delta.writeMicroseconds) / 1000.0f;
+        snapshot.framesPerSecond = perSecond(delta.framesPainted);
+        snapshot.paintMillisecondsPerFrame = delta.framesPainted ? gsl::narrow_cast<float>(delta.paintMicroseconds) / delta.framesPainted / 1000.0f : 0.0f;
+        snapshot.outputLockWaitMillisecondsPerSecond = perSecond(delta.outputLockWaitMicroseconds) / 1000.0f;
+        snapshot.renderLockWaitMillisecondsPerSecond = perSecond(delta.renderLockWaitMicroseconds) / 1000.0f;
+        snapshot.scrollbackRows = scrollbackRows;
+        snapshot.bufferBytes = bufferBytes;
+        return snapshot;
+    }
+
+    // Method Description:
+    // - Formats the snapshot as short lines, for the statistics overlay.
+    // Arguments:
+    // - <none>
+    // Return Value:
+    // - The lines.
+    std::vector<std::wstring> ControlStatistics::Snapshot::Format() const
+    {
+        return {
+            fmt::format(L"out {}ch/s write {:.0f}ms/s", s_FormatWithUnit(outputCharactersPerSecond, 1000.0f, { L"", L"K", L"M", L"G" }), writeMillisecondsPerSecond),
+            fmt::format(L"{:.0f} fps paint {:.1f}ms", framesPerSecond, paintMillisecondsPerFrame),
+            fmt::format(L"lock wait out {:.0f} paint {:.0f}ms/s", outputLockWaitMillisecondsPerSecond, renderLockWaitMillisecondsPerSecond),
+            fmt::format(L"rows {} mem {}", scrollbackRows, s_FormatWithUnit(gsl::narrow_cast<float>(bufferBytes), 1024.0f, { L"B", L"KB", L"MB", L"GB" })),
+            fmt::format(L"all panes {} of {}", s_FormatWithUnit(gsl::narrow_cast<float>(scrollbackBudgetUsageBytes), 1024.0f, { L"B", L"KB", L"MB", L"GB" }), s_FormatWithUnit(gsl::narrow_cast<float>(scrollbackBudgetBytes), 1024.0f, { L"B", L"KB", L"MB", L"GB" })),
+        };
+    }
+}
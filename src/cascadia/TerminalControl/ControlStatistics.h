@@ -0,0 +1,81 @@
+/*++
+Copyright (c) Microsoft Corporation
+Licensed under the MIT license.
+
+Module Name:
+- ControlStatistics.h
+
+Abstract:
+- Collects what a control spends its time and memory on, so that a pane that
+  hogs the CPU can be told apart from the others.
+- The thread that receives the output adds to running totals for every piece
+  of it, with relaxed atomics only. The renderer keeps totals of its own.
+- Nothing is computed until someone asks for a snapshot. A snapshot turns the
+  growth of the totals since the previous one into rates, so it's taken at a
+  steady interval, and only while someone looks at it.
+--*/
+
+#pragma once
+
+#include "../../renderer/inc/IRenderThread.hpp"
+
+namespace winrt::Microsoft::Terminal::Control::implementation
+{
+    class ControlStatistics
+    {
+    public:
+        using clock = std::chrono::steady_clock;
+
+        static constexpr auto SnapshotInterval = std::chrono::seconds(1);
+
+        struct Snapshot
+        {
+            float outputCharactersPerSecond;
+            // The time spent in Terminal::Write, per second.
+            float writeMillisecondsPerSecond;
+            float framesPerSecond;
+            float paintMillisecondsPerFrame;
+            // The time the output thread and the renderer waited for the terminal lock, per second.
+            float outputLockWaitMillisecondsPerSecond;
+            float renderLockWaitMillisecondsPerSecond;
+            size_t scrollbackRows;
+            size_t bufferBytes;
+            // The scrollback of all controls in the process, see ScrollbackBudget.
+            size_t scrollbackBudgetUsageBytes;
+            size_t scrollbackBudgetBytes;
+
+            std::vector<std::wstring> Format() const;
+        };
+
+        void OutputWritten(const size_t length, const clock::duration writeTime, const clock::duration lockWait, const clock::time_point now = clock::now()) noexcept;
+        uint64_t OutputLength() const noexcept;
+        clock::time_point LastOutputTime() const noexcept;
+
+        bool IsSnapshotDue(const clock::time_point now = clock::now()) const noexcept;
+        Snapshot TakeSnapshot(const ::Microsoft::Console::Render::FrameStatistics& frames,
+                              const size_t scrollbackRows,
+                              const size_t bufferBytes,
+                              const clock::time_point now = clock::now());
+
+    private:
+        struct Totals
+        {
+            uint64_t outputLength;
+            uint64_t writeMicroseconds;
+            uint64_t outputLockWaitMicroseconds;
+            uint64_t framesPainted;
+            uint64_t paintMicroseconds;
+            uint64_t renderLockWaitMicroseconds;
+        };
+
+        std::atomic<uint64_t> _outputLength{ 0 };
+        std::atomic<uint64_t> _writeMicroseconds{ 0 };
+        std::atomic<uint64_t> _outputLockWaitMicroseconds{ 0 };
+        std::atomic<clock::rep> _lastOutputTime{ clock::now().time_since_epoch().count() };
+
+        // The totals as of the previous snapshot.
+        mutable std::mutex _lock;
+        Totals _previous{};
+        std::atomic<clock::rep> _previousTime{ clock::now().time_since_epoch().count() };
+    };
+}
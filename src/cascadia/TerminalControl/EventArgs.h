@@ -11,6 +11,7 @@
 #include "ScrollPositionChangedArgs.g.h"
 #include "RendererWarningArgs.g.h"
 #include "TransparencyChangedEventArgs.g.h"
+#include "BufferSearchResult.g.h"
 #include "cppwinrt_utils.h"
 
 namespace winrt::Microsoft::Terminal::Control::implementation
@@ -131,4 +132,24 @@ namespace winrt::Microsoft::Terminal::Control::implementation
 
         WINRT_PROPERTY(double, Opacity);
     };
+
+    struct BufferSearchResult : public BufferSearchResultT<BufferSearchResult>
+    {
+    public:
+        BufferSearchResult(const int64_t row,
+                           const int64_t rowsFromEnd,
+                           const hstring& preview,
+                           const bool matchesCase) :
+            _Row(row),
+            _RowsFromEnd(rowsFromEnd),
+            _Preview(preview),
+            _MatchesCase(matchesCase)
+        {
+        }
+
+        WINRT_PROPERTY(int64_t, Row);
+        WINRT_PROPERTY(int64_t, RowsFromEnd);
+        WINRT_PROPERTY(hstring, Preview);
+        WINRT_PROPERTY(bool, MatchesCase);
+    };
 }
@@ -0,0 +1,119 @@
+// Copyright (c) Microsoft Corporation.
+// Licensed under the MIT license.
+
+#include "pch.h"
+#include "InputLatencyTracker.h"
+
+namespace winrt::Microsoft::Terminal::Control::implementation
+{
+    // Method Description:
+    // - Starts a new sample for a key that was just pressed. A sample that
+    //   didn't make it to the screen yet is dropped, since it can't be told
+    //   apart from the new one anymore.
+    // Arguments:
+    // - now: the time the key started to be handled.
+    // Return Value:
+    // - <none>
+    void InputLatencyTracker::Start(const clock::time_point now) noexcept
+    {
+        std::lock_guard guard{ _lock };
+        _sample = {};
+        _sample.front() = now;
+        _pending.store(true, std::memory_order_relaxed);
+    }
+
+    // Method Description:
+    // - Stamps the given stage of the current sample, if the stage before it
+    //   was reached already and this one wasn't yet.
+    // Arguments:
+    // - stage: the stage that was reached. Use FramePresented for Stage::Presented.
+    // - now: the time the stage was reached.
+    // Return Value:
+    // - <none>
+    void InputLatencyTracker::Mark(const Stage stage, const clock::time_point now) noexcept
+    {
+        if (!_pending.load(std::memory_order_relaxed))
+        {
+            return;
+        }
+
+        const auto index = static_cast<size_t>(stage);
+        std::lock_guard guard{ _lock };
+        if (index > 0 && index < _sample.size() - 1 &&
+            til::at(_sample, index - 1) != clock::time_point{} &&
+            til::at(_sample, index) == clock::time_point{})
+        {
+            til::at(_sample, index) = now;
+        }
+    }
+
+    // Method Description:
+    // - Completes the current sample if the frame that was just presented
+    //   contains the echo, which is the case if it started painting after
+    //   the output was written into the terminal.
+    // Arguments:
+    // - frameStart: the time the painting of the frame started, with the terminal locked.
+    // - now: the time the frame was presented.
+    // Return Value:
+    // - The completed sample, if this frame completed one.
+    std::optional<InputLatencyTracker::Sample> InputLatencyTracker::FramePresented(const clock::time_point frameStart, const clock::time_point now) noexcept
+    {
+        if (!_pending.load(std::memory_order_relaxed))
+        {
+            return std::nullopt;
+        }
+
+        std::lock_guard guard{ _lock };
+        const auto written = til::at(_sample, static_cast<size_t>(Stage::OutputWritten));
+        if (written == clock::time_point{} || frameStart < written)
+        {
+            return std::nullopt;
+        }
+
+        _sample.back() = now;
+        _pending.store(false, std::memory_order_relaxed);
+
+        til::at(_latencies, _latenciesNext) = now - _sample.front();
+        _latenciesNext = (_latenciesNext + 1) % _latencies.size();
+        _latenciesCount = std::min(_latenciesCount + 1, _latencies.size());
+        return _sample;
+    }
+
+    bool InputLatencyTracker::IsPending() const noexcept
+    {
+        return _pending.load(std::memory_order_relaxed);
+    }
+
+    // Method Description:
+    // - Gets the median and the 99th percentile of the latencies of the recently completed samples.
+    // Arguments:
+    // - <none>
+    // Return Value:
+    // - The percentiles and the number of samples they're computed from.
+    InputLatencyTracker::Percentiles InputLatencyTracker::GetPercentiles() const
+    {
+        std::array<clock::duration, LatenciesCapacity> latencies;
+        size_t count = 0;
+        {
+            std::lock_guard guard{ _lock };
+            count = _latenciesCount;
+            std::copy_n(_latencies.begin(), count, latencies.begin());
+        }
+
+        if (count == 0)
+        {
+            return {};
+        }
+
+        const auto begin = latencies.begin();
+        const auto end = begin + count;
+        const auto percentile = [&](const size_t percent) {
+            const auto nth = begin + (count - 1) * percent / 100;
+            std::nth_element(begin, nth, end);
+            return *nth;
+        };
+        const auto p50 = percentile(50);
+        const auto p99 = percentile(99);
+        return { p50, p99, count };
+    }
+}
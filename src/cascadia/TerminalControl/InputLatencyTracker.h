@@ -0,0 +1,65 @@
+/*++
+Copyright (c) Microsoft Corporation
+Licensed under the MIT license.
+
+Module Name:
+- InputLatencyTracker.h
+
+Abstract:
+- Measures how long it takes from a key press until the frame containing its
+  echo is on the screen, split up into the stages the input passes through.
+- A sample starts when TermControl handles a key. Every following stage is
+  stamped the first time it's reached after the stage before it. The sample
+  is complete once a frame that started painting after the echo was written
+  into the terminal has been presented.
+- The latencies of the recent key presses are kept, so that their median and
+  99th percentile can be reported for the session.
+--*/
+
+#pragma once
+
+namespace winrt::Microsoft::Terminal::Control::implementation
+{
+    class InputLatencyTracker
+    {
+    public:
+        using clock = std::chrono::steady_clock;
+
+        enum class Stage : size_t
+        {
+            KeyHandled, // TermControl started handling the key.
+            InputTranslated, // TerminalInput::HandleKey was called for it.
+            InputWritten, // Its translation was handed to ConptyConnection::WriteInput.
+            OutputRead, // The output thread of the connection read something after that.
+            OutputWritten, // Terminal::Write finished processing that output.
+            Presented, // A frame that was painted after that was presented.
+            Count
+        };
+
+        using Sample = std::array<clock::time_point, static_cast<size_t>(Stage::Count)>;
+
+        struct Percentiles
+        {
+            clock::duration p50;
+            clock::duration p99;
+            size_t count;
+        };
+
+        void Start(const clock::time_point now = clock::now()) noexcept;
+        void Mark(const Stage stage, const clock::time_point now = clock::now()) noexcept;
+        std::optional<Sample> FramePresented(const clock::time_point frameStart, const clock::time_point now = clock::now()) noexcept;
+        bool IsPending() const noexcept;
+
+        Percentiles GetPercentiles() const;
+
+    private:
+        static constexpr size_t LatenciesCapacity = 256;
+
+        std::atomic<bool> _pending{ false };
+        mutable std::mutex _lock;
+        Sample _sample{};
+        std::array<clock::duration, LatenciesCapacity> _latencies{};
+        size_t _latenciesCount = 0;
+        size_t _latenciesNext = 0;
+    };
+}
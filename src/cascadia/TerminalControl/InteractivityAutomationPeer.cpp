@@ -89,6 +89,18 @@ namespace winrt::Microsoft::Terminal::Control::implementation
         _CursorChangedHandlers(*this, nullptr);
     }
 
+    // Method Description:
+    // - Hands the text that was written since the last time to our embedding
+    //   control, for it to notify the ui automation client about it.
+    // Arguments:
+    // - text: the new output.
+    // Return Value:
+    // - <none>
+    void InteractivityAutomationPeer::SignalNewOutput(const std::wstring_view text)
+    {
+        _NewOutputHandlers(*this, winrt::hstring{ text });
+    }
+
 #pragma region ITextProvider
     com_array<XamlAutomation::ITextRangeProvider> InteractivityAutomationPeer::GetSelection()
     {
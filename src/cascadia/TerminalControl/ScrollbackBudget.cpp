@@ -0,0 +1,157 @@
+// Copyright (c) Microsoft Corporation.
+// Licensed under the MIT license.
+
+#include "pch.h"
+#include "ScrollbackBudget.h"
+
+namespace winrt::Microsoft::Terminal::Control::implementation
+{
+    ScrollbackBudget::Pane::Pane(ScrollbackBudget& budget, TrimCallback trim, const uint64_t sequence) :
+        _budget{ budget },
+        _trim{ std::move(trim) },
+        _sequence{ sequence },
+        _lastVisible{ std::chrono::steady_clock::now() }
+    {
+    }
+
+    ScrollbackBudget::Pane::~Pane()
+    {
+        _budget._Unregister(*this);
+    }
+
+    // Method Description:
+    // - Reports the rows of a control's buffer. If that makes the total exceed
+    //   the budget, some controls (possibly this one) are told to spill rows.
+    // Arguments:
+    // - residentRows: the number of rows the buffer keeps in memory.
+    // - bytesPerRow: the memory each of those rows takes.
+    // - minimumRows: the least number of rows the buffer should keep in memory.
+    // Return Value:
+    // - <none>
+    void ScrollbackBudget::Pane::Update(const size_t residentRows, const size_t bytesPerRow, const size_t minimumRows)
+    {
+        _budget._Update(*this, residentRows, bytesPerRow, minimumRows);
+    }
+
+    // Method Description:
+    // - Controls that can be seen are the last ones that are told to spill rows.
+    //   Of the others, the ones that were seen the longest time ago go first.
+    // Arguments:
+    // - visible: whether the control can be seen right now.
+    // Return Value:
+    // - <none>
+    void ScrollbackBudget::Pane::SetVisible(const bool visible) noexcept
+    {
+        _budget._SetVisible(*this, visible);
+    }
+
+    ScrollbackBudget& ScrollbackBudget::Instance()
+    {
+        static ScrollbackBudget budget{ DefaultBudgetBytes };
+        return budget;
+    }
+
+    ScrollbackBudget::ScrollbackBudget(const size_t budgetBytes) noexcept :
+        _budgetBytes{ budgetBytes }
+    {
+    }
+
+    // Method Description:
+    // - Registers a control. It doesn't count towards the budget until it reports its rows.
+    // Arguments:
+    // - trim: called when the control should keep fewer rows in memory.
+    // Return Value:
+    // - The registration, which unregisters the control when it's destroyed.
+    std::unique_ptr<ScrollbackBudget::Pane> ScrollbackBudget::Register(TrimCallback trim)
+    {
+        std::lock_guard guard{ _lock };
+        std::unique_ptr<Pane> pane{ new Pane{ *this, std::move(trim), _nextSequence++ } };
+        _panes.emplace_back(pane.get());
+        return pane;
+    }
+
+    size_t ScrollbackBudget::BudgetBytes() const noexcept
+    {
+        return _budgetBytes;
+    }
+
+    size_t ScrollbackBudget::UsageBytes() const noexcept
+    {
+        std::lock_guard guard{ _lock };
+        return _usageBytes;
+    }
+
+    void ScrollbackBudget::_Update(Pane& pane, const size_t residentRows, const size_t bytesPerRow, const size_t minimumRows)
+    {
+        std::vector<std::pair<TrimCallback, size_t>> trims;
+        {
+            std::lock_guard guard{ _lock };
+            _usageBytes -= pane._residentRows * pane._bytesPerRow;
+            pane._residentRows = residentRows;
+            pane._bytesPerRow = bytesPerRow;
+            pane._minimumRows = minimumRows;
+            _usageBytes += pane._residentRows * pane._bytesPerRow;
+
+            if (_usageBytes <= _budgetBytes)
+            {
+                return;
+            }
+
+            auto candidates = _panes;
+            std::sort(candidates.begin(), candidates.end(), [](const Pane* lhs, const Pane* rhs) {
+                return std::tie(lhs->_visible, lhs->_lastVisible, lhs->_sequence) < std::tie(rhs->_visible, rhs->_lastVisible, rhs->_sequence);
+            });
+
+            auto excess = _usageBytes - _budgetBytes;
+            for (const auto candidate : candidates)
+            {
+                if (candidate->_residentRows <= candidate->_minimumRows || candidate->_bytesPerRow == 0)
+                {
+                    continue;
+                }
+
+                const auto neededRows = (excess + candidate->_bytesPerRow - 1) / candidate->_bytesPerRow;
+                const auto spilledRows = std::min(candidate->_residentRows - candidate->_minimumRows, neededRows);
+                const auto spilledBytes = spilledRows * candidate->_bytesPerRow;
+
+                candidate->_residentRows -= spilledRows;
+                _usageBytes -= spilledBytes;
+                trims.emplace_back(candidate->_trim, candidate->_residentRows);
+
+                if (spilledBytes >= excess)
+                {
+                    break;
+                }
+                excess -= spilledBytes;
+            }
+        }
+
+        // The callbacks take the lock of their terminal. The terminals
+        // may report to us while holding it, so we can't hold ours.
+        for (const auto& [trim, rows] : trims)
+        {
+            try
+            {
+                trim(rows);
+            }
+            CATCH_LOG();
+        }
+    }
+
+    void ScrollbackBudget::_SetVisible(Pane& pane, const bool visible) noexcept
+    {
+        std::lock_guard guard{ _lock };
+        if (pane._visible != visible)
+        {
+            pane._visible = visible;
+            pane._lastVisible = std::chrono::steady_clock::now();
+        }
+    }
+
+    void ScrollbackBudget::_Unregister(Pane& pane) noexcept
+    {
+        std::lock_guard guard{ _lock };
+        _usageBytes -= pane._residentRows * pane._bytesPerRow;
+        _panes.erase(std::remove(_panes.begin(), _panes.end(), &pane), _panes.end());
+    }
+}
@@ -0,0 +1,85 @@
+/*++
+Copyright (c) Microsoft Corporation
+Licensed under the MIT license.
+
+Module Name:
+- ScrollbackBudget.h
+
+Abstract:
+- Keeps the scrollback of all the controls in the process within one memory
+  budget. Every control registers its buffer, and reports how many rows it
+  keeps in memory whenever that changes, which is only when a buffer is
+  created or resized, since buffers are allocated for their full size.
+- When the total exceeds the budget, the controls that were seen the longest
+  time ago (and of those, the oldest ones) are told to spill rows into their
+  buffer's spill file first, until the total is back within the budget. Each
+  of them keeps at least its viewport in memory.
+- The controls are called back outside of the budget's lock, on whichever
+  thread reported the change that exceeded the budget.
+--*/
+
+#pragma once
+
+namespace winrt::Microsoft::Terminal::Control::implementation
+{
+    class ScrollbackBudget
+    {
+    public:
+        static constexpr size_t DefaultBudgetBytes{ size_t{ 1 } << 30 };
+
+        // Called with the number of rows the control should keep in memory from now on.
+        using TrimCallback = std::function<void(const size_t residentRows)>;
+
+        // The registration of a control. Unregisters it when it's destroyed.
+        class Pane
+        {
+        public:
+            ~Pane();
+
+            Pane(const Pane&) = delete;
+            Pane& operator=(const Pane&) = delete;
+            Pane(Pane&&) = delete;
+            Pane& operator=(Pane&&) = delete;
+
+            void Update(const size_t residentRows, const size_t bytesPerRow, const size_t minimumRows);
+            void SetVisible(const bool visible) noexcept;
+
+        private:
+            friend class ScrollbackBudget;
+
+            Pane(ScrollbackBudget& budget, TrimCallback trim, const uint64_t sequence);
+
+            ScrollbackBudget& _budget;
+            TrimCallback _trim;
+            uint64_t _sequence;
+
+            // These are guarded by the budget's lock.
+            size_t _residentRows{ 0 };
+            size_t _bytesPerRow{ 0 };
+            size_t _minimumRows{ 0 };
+            bool _visible{ false };
+            std::chrono::steady_clock::time_point _lastVisible{};
+        };
+
+        static ScrollbackBudget& Instance();
+
+        explicit ScrollbackBudget(const size_t budgetBytes) noexcept;
+
+        std::unique_ptr<Pane> Register(TrimCallback trim);
+
+        size_t BudgetBytes() const noexcept;
+        size_t UsageBytes() const noexcept;
+
+    private:
+        void _Update(Pane& pane, const size_t residentRows, const size_t bytesPerRow, const size_t minimumRows);
+        void _SetVisible(Pane& pane, const bool visible) noexcept;
+        void _Unregister(Pane& pane) noexcept;
+
+        size_t _budgetBytes;
+
+        mutable std::mutex _lock;
+        std::vector<Pane*> _panes;
+        size_t _usageBytes{ 0 };
+        uint64_t _nextSequence{ 0 };
+    };
+}
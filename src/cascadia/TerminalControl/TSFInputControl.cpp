@@ -21,12 +21,15 @@ namespace winrt::Microsoft::Terminal::Control::implementation
         _inComposition{ false },
         _activeTextStart{ 0 },
         _focused{ false },
+        _canvasVisible{ false },
         _currentTerminalCursorPos{ 0, 0 },
         _currentCanvasWidth{ 0.0 },
         _currentTextBlockHeight{ 0.0 },
         _currentTextBounds{ 0, 0, 0, 0 },
         _currentControlBounds{ 0, 0, 0, 0 },
-        _currentWindowBounds{ 0, 0, 0, 0 }
+        _currentWindowBounds{ 0, 0, 0, 0 },
+        _currentFontSizePx{ 0.0 },
+        _currentFontWeight{ 0 }
     {
         InitializeComponent();
 
@@ -199,17 +202,33 @@ namespace winrt::Microsoft::Terminal::Control::implementation
         const double fontSizePx = (fontSize.height<double>() * 72) / USER_DEFAULT_SCREEN_DPI;
         const double unscaledFontSizePx = fontSizePx / scaleFactor;
 
-        // Make sure to unscale the font size to correct for DPI! XAML needs
-        // things in DIPs, and the fontSize is in pixels.
-        TextBlock().FontSize(unscaledFontSizePx);
-        TextBlock().FontFamily(Media::FontFamily(fontArgs->FontFace()));
-        TextBlock().FontWeight(fontArgs->FontWeight());
-
-        // TextBlock's actual dimensions right after initialization is 0w x 0h. So,
-        // if an IME is displayed before TextBlock has text (like showing the emoji picker
-        // using Win+.), it'll be placed higher than intended.
-        TextBlock().MinWidth(unscaledFontSizePx);
-        TextBlock().MinHeight(unscaledFontSizePx);
+        // Setting any of the font properties makes the TextBlock measure its
+        // text again, so we only do that when the font actually changed, and
+        // not every time the cursor moved.
+        if (_currentFontSizePx != unscaledFontSizePx)
+        {
+            _currentFontSizePx = unscaledFontSizePx;
+
+            // Make sure to unscale the font size to correct for DPI! XAML needs
+            // things in DIPs, and the fontSize is in pixels.
+            TextBlock().FontSize(unscaledFontSizePx);
+
+            // TextBlock's actual dimensions right after initialization is 0w x 0h. So,
+            // if an IME is displayed before TextBlock has text (like showing the emoji picker
+            // using Win+.), it'll be placed higher than intended.
+            TextBlock().MinWidth(unscaledFontSizePx);
+            TextBlock().MinHeight(unscaledFontSizePx);
+        }
+        if (_currentFontFace != fontArgs->FontFace())
+        {
+            _currentFontFace = fontArgs->FontFace();
+            TextBlock().FontFamily(Media::FontFamily(_currentFontFace));
+        }
+        if (_currentFontWeight != fontArgs->FontWeight().Weight)
+        {
+            _currentFontWeight = fontArgs->FontWeight().Weight;
+            TextBlock().FontWeight(fontArgs->FontWeight());
+        }
         _currentTextBlockHeight = std::max(unscaledFontSizePx, _currentTextBlockHeight);
 
         const auto widthToTerminalEnd = _currentCanvasWidth - clientCursorInDips.x<double>();
@@ -413,9 +432,19 @@ namespace winrt::Microsoft::Terminal::Control::implementation
             }
             else
             {
-                Canvas().Visibility(Visibility::Visible);
-                const auto text = _inputBuffer.substr(_activeTextStart);
-                TextBlock().Text(text);
+                // Only touch the XAML tree if something changed, because
+                // every change schedules a layout pass, and the TSF may
+                // send us the same composition text more than once.
+                if (!_canvasVisible)
+                {
+                    _canvasVisible = true;
+                    Canvas().Visibility(Visibility::Visible);
+                }
+                const std::wstring_view text{ std::wstring_view{ _inputBuffer }.substr(_activeTextStart) };
+                if (std::wstring_view{ TextBlock().Text() } != text)
+                {
+                    TextBlock().Text(winrt::hstring{ text });
+                }
             }
 
             // Notify the TSF that the update succeeded
@@ -455,6 +484,7 @@ namespace winrt::Microsoft::Terminal::Control::implementation
         TextBlock().UpdateLayout();
 
         // hide the controls until text input starts again
+        _canvasVisible = false;
         Canvas().Visibility(Visibility::Collapsed);
     }
 
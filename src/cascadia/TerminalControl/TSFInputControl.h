@@ -78,6 +78,7 @@ namespace winrt::Microsoft::Terminal::Control::implementation
         void _SendAndClearText();
         void _RedrawCanvas();
         bool _focused;
+        bool _canvasVisible;
 
         til::point _currentTerminalCursorPos;
         double _currentCanvasWidth;
@@ -85,6 +86,11 @@ namespace winrt::Microsoft::Terminal::Control::implementation
         winrt::Windows::Foundation::Rect _currentControlBounds;
         winrt::Windows::Foundation::Rect _currentTextBounds;
         winrt::Windows::Foundation::Rect _currentWindowBounds;
+
+        // What the TextBlock was last set to, so we set it only when it changed.
+        double _currentFontSizePx;
+        winrt::hstring _currentFontFace;
+        uint16_t _currentFontWeight;
     };
 }
 namespace winrt::Microsoft::Terminal::Control::factory_implementation
@@ -14,6 +14,7 @@
 
 #include "TermControl.g.cpp"
 #include "TermControlAutomationPeer.h"
+#include "BackgroundImageCache.h"
 
 using namespace ::Microsoft::Console::Types;
 using namespace ::Microsoft::Console::VirtualTerminal;
@@ -28,14 +29,6 @@ using namespace winrt::Windows::UI::Input;
 using namespace winrt::Windows::System;
 using namespace winrt::Windows::ApplicationModel::DataTransfer;
 
-// The minimum delay between updates to the scroll bar's values.
-// The updates are throttled to limit power usage.
-constexpr const auto ScrollBarUpdateInterval = std::chrono::milliseconds(8);
-
-// The minimum delay between updating the TSF input control.
-// This is already throttled primarily in the ControlCore, with a timeout of 100ms. We're adding another smaller one here, as the (potentially x-proc) call will come in off the UI thread
-constexpr const auto TsfRedrawInterval = std::chrono::milliseconds(8);
-
 // The minimum delay between updating the locations of regex patterns
 constexpr const auto UpdatePatternLocationsInterval = std::chrono::milliseconds(500);
 
@@ -56,8 +49,6 @@ namespace winrt::Microsoft::Terminal::Control::implementation
         _autoScrollingPointerPoint{ std::nullopt },
         _autoScrollTimer{},
         _lastAutoScrollUpdateTime{ std::nullopt },
-        _cursorTimer{},
-        _blinkTimer{},
         _searchBox{ nullptr }
     {
         InitializeComponent();
@@ -101,11 +92,16 @@ namespace winrt::Microsoft::Terminal::Control::implementation
             }
         });
 
+        // Don't render while we can't be seen, like when we're in a background
+        // tab (which unloads us) or our window is minimized.
+        Loaded({ this, &TermControl::_LoadedHandler });
+        Unloaded({ this, &TermControl::_UnloadedHandler });
+
         // Get our dispatcher. This will get us the same dispatcher as
         // TermControl::Dispatcher().
         auto dispatcher = winrt::Windows::System::DispatcherQueue::GetForCurrentThread();
 
-        // These three throttled functions are triggered by terminal output and interact with the UI.
+        // These functions are triggered by terminal output and interact with the UI.
         // Since Close() is the point after which we are removed from the UI, but before the
         // destructor has run, we MUST check control->_IsClosing() before actually doing anything.
         _playWarningBell = std::make_shared<ThrottledFuncLeading>(
@@ -118,26 +114,26 @@ namespace winrt::Microsoft::Terminal::Control::implementation
                 }
             });
 
-        _updateScrollBar = std::make_shared<ThrottledFuncTrailing<ScrollBarUpdate>>(
-            dispatcher,
-            ScrollBarUpdateInterval,
+        // The scroll bar and TSF updates of all the controls in a window are
+        // batched into one dispatcher callback per frame. While we're hidden,
+        // they're suspended, see _UpdateOcclusion().
+        const auto uiUpdateScheduler = UiUpdateScheduler::GetForCurrentThread();
+
+        _updateScrollBar = std::make_shared<UiUpdate<ScrollBarUpdate>>(
+            uiUpdateScheduler,
             [weakThis = get_weak()](const auto& update) {
                 if (auto control{ weakThis.get() }; !control->_IsClosing())
                 {
-                    control->_isInternalScrollBarUpdate = true;
-
-                    auto scrollBar = control->ScrollBar();
-                    if (update.newValue)
-                    {
-                        scrollBar.Value(*update.newValue);
-                    }
-                    scrollBar.Maximum(update.newMaximum);
-                    scrollBar.Minimum(update.newMinimum);
-                    scrollBar.ViewportSize(update.newViewportSize);
-                    // scroll one full screen worth at a time when the scroll bar is clicked
-                    scrollBar.LargeChange(std::max(update.newViewportSize - 1, 0.));
+                    control->_ApplyScrollBarUpdate(update);
+                }
+            });
 
-                    control->_isInternalScrollBarUpdate = false;
+        _tsfTryRedrawCanvas = std::make_shared<UiUpdate<>>(
+            uiUpdateScheduler,
+            [weakThis = get_weak()]() {
+                if (auto control{ weakThis.get() }; !control->_IsClosing())
+                {
+                    control->TSFInputControl().TryRedrawCanvas();
                 }
             });
 
@@ -197,6 +193,44 @@ namespace winrt::Microsoft::Terminal::Control::implementation
         }
     }
 
+    void TermControl::ScrollToMark(const bool next)
+    {
+        if (!_IsClosing())
+        {
+            _core.ScrollToMark(next);
+        }
+    }
+
+    void TermControl::SelectOutput(const bool next)
+    {
+        if (!_IsClosing())
+        {
+            _core.SelectOutput(next);
+        }
+    }
+
+    void TermControl::ExportBuffer(const winrt::hstring& path, const ExportFormat format)
+    {
+        if (!_IsClosing())
+        {
+            _core.ExportBuffer(path, format);
+        }
+    }
+
+    // The core stops searching by itself once it's closed.
+    Windows::Foundation::IAsyncOperation<Windows::Foundation::Collections::IVector<Control::BufferSearchResult>> TermControl::FindAllAsync(const winrt::hstring& text, const bool caseSensitive)
+    {
+        return _core.FindAllAsync(text, caseSensitive);
+    }
+
+    void TermControl::ScrollToSearchResult(const Control::BufferSearchResult& result)
+    {
+        if (!_IsClosing())
+        {
+            _core.ScrollToSearchResult(result);
+        }
+    }
+
     // Method Description:
     // - Search text in text buffer. This is triggered if the user click
     //   search button or press enter.
@@ -299,22 +333,11 @@ namespace winrt::Microsoft::Terminal::Control::implementation
 
         if (!newAppearance.BackgroundImage().empty())
         {
-            Windows::Foundation::Uri imageUri{ newAppearance.BackgroundImage() };
-
-            // Check if the image brush is already pointing to the image
-            // in the modified settings; if it isn't (or isn't there),
-            // set a new image source for the brush
-            auto imageSource = BackgroundImage().Source().try_as<Media::Imaging::BitmapImage>();
-
-            if (imageSource == nullptr ||
-                imageSource.UriSource() == nullptr ||
-                imageSource.UriSource().RawUri() != imageUri.RawUri())
+            // The image is shared with all the other controls of this window
+            // that use it, and is only decoded again if the file was modified.
+            const auto image = BackgroundImageCache::Instance().Get(newAppearance.BackgroundImage(), 0, 0);
+            if (BackgroundImage().Source().try_as<Media::Imaging::BitmapImage>() != image)
             {
-                // Note that BitmapImage handles the image load asynchronously,
-                // which is especially important since the image
-                // may well be both large and somewhere out on the
-                // internet.
-                Media::Imaging::BitmapImage image(imageUri);
                 BackgroundImage().Source(image);
             }
 
@@ -352,11 +375,45 @@ namespace winrt::Microsoft::Terminal::Control::implementation
         _core.SendInput(wstr);
     }
 
+    TerminalConnection::ITerminalConnection TermControl::Connection() const
+    {
+        return _core.Connection();
+    }
+
+    // Method Description:
+    // - Broadcasts what the user types or pastes into this control to the given
+    //   connections as well. See ControlCore::BroadcastInputTo.
+    void TermControl::BroadcastInputTo(const Windows::Foundation::Collections::IVector<TerminalConnection::ITerminalConnection>& connections)
+    {
+        _core.BroadcastInputTo(connections);
+    }
+
     void TermControl::ToggleShaderEffects()
     {
         _core.ToggleShaderEffects();
     }
 
+    void TermControl::ToggleFrameStatistics()
+    {
+        _core.ToggleFrameStatistics();
+    }
+
+    void TermControl::LiveResizeChanged(const bool liveResize)
+    {
+        _core.LiveResizeChanged(liveResize);
+    }
+
+    // Method Description:
+    // - Keep rendering at a low frame rate while our window is hidden, so that
+    //   we're up to date as soon as it's shown again. Used for the quake window.
+    // Arguments:
+    // - keepRendering: true to keep rendering while hidden.
+    void TermControl::KeepRenderingWhileHidden(const bool keepRendering)
+    {
+        // This takes effect the next time our window is hidden or shown.
+        _keepRenderingWhileHidden = keepRendering;
+    }
+
     // Method Description:
     // - Style our UI elements based on the values in our _settings, and set up
     //   other control-specific settings. This method will be called whenever
@@ -549,6 +606,16 @@ namespace winrt::Microsoft::Terminal::Control::implementation
         return _core.ConnectionState();
     }
 
+    uint64_t TermControl::OutputLength() const noexcept
+    {
+        return _core.OutputLength();
+    }
+
+    Windows::Foundation::TimeSpan TermControl::TimeSinceOutput() const noexcept
+    {
+        return _core.TimeSinceOutput();
+    }
+
     winrt::fire_and_forget TermControl::RenderEngineSwapChainChanged(IInspectable /*sender*/, IInspectable /*args*/)
     {
         // This event is only registered during terminal initialization,
@@ -613,6 +680,66 @@ namespace winrt::Microsoft::Terminal::Control::implementation
         nativePanel->SetSwapChainHandle(swapChainHandle);
     }
 
+    // Method Description:
+    // - Called when we're added to the visual tree. Starts listening for our
+    //   host window being hidden and shown, and resumes rendering if we were
+    //   occluded.
+    void TermControl::_LoadedHandler(const IInspectable& /*sender*/, const RoutedEventArgs& /*args*/)
+    {
+        if (const auto xamlRoot = XamlRoot())
+        {
+            _xamlRootChangedRevoker = xamlRoot.Changed(winrt::auto_revoke, [weakThis = get_weak()](auto&&, auto&&) {
+                if (auto control{ weakThis.get() })
+                {
+                    control->_UpdateOcclusion(true);
+                }
+            });
+        }
+        _UpdateOcclusion(true);
+    }
+
+    // Method Description:
+    // - Called when we're removed from the visual tree, like when another tab
+    //   is selected. We can't be seen anymore, so stop rendering.
+    void TermControl::_UnloadedHandler(const IInspectable& /*sender*/, const RoutedEventArgs& /*args*/)
+    {
+        _xamlRootChangedRevoker.revoke();
+        _UpdateOcclusion(false);
+    }
+
+    // Method Description:
+    // - Tells the core whether it's worth rendering: only while we're loaded
+    //   and our host window is visible.
+    // Arguments:
+    // - loaded: whether we're currently part of the visual tree
+    void TermControl::_UpdateOcclusion(const bool loaded)
+    {
+        if (_IsClosing())
+        {
+            return;
+        }
+
+        const auto xamlRoot = loaded ? XamlRoot() : nullptr;
+        const auto occluded = !xamlRoot || !xamlRoot.IsHostVisible();
+        // Only a hidden window is worth rendering for. Background tabs aren't
+        // switched to in an instant anyways.
+        _core.KeepRenderingWhileOccluded(_keepRenderingWhileHidden && xamlRoot);
+        _core.SetOccluded(occluded);
+
+        // There's no point in updating what can't be seen. The latest
+        // updates are applied once we're visible again.
+        _updateScrollBar->SetSuspended(occluded);
+        _tsfTryRedrawCanvas->SetSuspended(occluded);
+        if (_cursorTimer)
+        {
+            _cursorTimer->SetSuspended(occluded);
+        }
+        if (_blinkTimer)
+        {
+            _blinkTimer->SetSuspended(occluded);
+        }
+    }
+
     bool TermControl::_InitializeTerminal()
     {
         if (_initializedTerminal)
@@ -677,17 +804,20 @@ namespace winrt::Microsoft::Terminal::Control::implementation
         int blinkTime = GetCaretBlinkTime();
         if (blinkTime != INFINITE)
         {
-            // Create a timer
-            DispatcherTimer cursorTimer;
-            cursorTimer.Interval(std::chrono::milliseconds(blinkTime));
-            cursorTimer.Tick({ get_weak(), &TermControl::_CursorTimerTick });
-            cursorTimer.Start();
-            _cursorTimer.emplace(std::move(cursorTimer));
+            _cursorTimer = std::make_unique<SharedUiTimer::Client>(
+                SharedUiTimer::GetForCurrentThread(std::chrono::milliseconds(blinkTime)),
+                [weakThis = get_weak()]() {
+                    if (auto control{ weakThis.get() })
+                    {
+                        control->_CursorTimerTick();
+                    }
+                });
+            _cursorTimer->Start();
         }
         else
         {
             // The user has disabled cursor blinking
-            _cursorTimer = std::nullopt;
+            _cursorTimer.reset();
         }
 
         // Set up blinking attributes
@@ -695,17 +825,20 @@ namespace winrt::Microsoft::Terminal::Control::implementation
         SystemParametersInfoW(SPI_GETCLIENTAREAANIMATION, 0, &animationsEnabled, 0);
         if (animationsEnabled && blinkTime != INFINITE)
         {
-            // Create a timer
-            DispatcherTimer blinkTimer;
-            blinkTimer.Interval(std::chrono::milliseconds(blinkTime));
-            blinkTimer.Tick({ get_weak(), &TermControl::_BlinkTimerTick });
-            blinkTimer.Start();
-            _blinkTimer.emplace(std::move(blinkTimer));
+            _blinkTimer = std::make_unique<SharedUiTimer::Client>(
+                SharedUiTimer::GetForCurrentThread(std::chrono::milliseconds(blinkTime)),
+                [weakThis = get_weak()]() {
+                    if (auto control{ weakThis.get() })
+                    {
+                        control->_BlinkTimerTick();
+                    }
+                });
+            _blinkTimer->Start();
         }
         else
         {
             // The user has disabled blinking
-            _blinkTimer = std::nullopt;
+            _blinkTimer.reset();
         }
 
         // Now that the renderer is set up, update the appearance for initialization
@@ -843,6 +976,11 @@ namespace winrt::Microsoft::Terminal::Control::implementation
             return;
         }
 
+        if (keyDown)
+        {
+            _core.StartInputLatencySample();
+        }
+
         // Mark the event as handled and do nothing if we're closing, or the key
         // was the Windows key.
         //
@@ -1010,6 +1148,7 @@ namespace winrt::Microsoft::Terminal::Control::implementation
             // the timer prevents flickering.
             _core.CursorOn(true);
             _cursorTimer->Start();
+            _lastCursorActivity = std::chrono::steady_clock::now();
         }
 
         return handled;
@@ -1325,6 +1464,8 @@ namespace winrt::Microsoft::Terminal::Control::implementation
         _updateScrollBar->ModifyPending([](auto& update) {
             update.newValue.reset();
         });
+        // The scroll bar isn't where we last put it anymore.
+        _lastScrollBarUpdate.reset();
     }
 
     // Method Description:
@@ -1483,6 +1624,7 @@ namespace winrt::Microsoft::Terminal::Control::implementation
             // When the terminal focuses, show the cursor immediately
             _core.CursorOn(true);
             _cursorTimer->Start();
+            _lastCursorActivity = std::chrono::steady_clock::now();
         }
 
         if (_blinkTimer)
@@ -1559,6 +1701,12 @@ namespace winrt::Microsoft::Terminal::Control::implementation
         const auto newSize = e.NewSize();
         _core.SizeChanged(newSize.Width, newSize.Height);
 
+        // In smooth scrolling mode, the swap chain is a row taller than the
+        // panel. Whatever part of that row isn't scrolled into view is cut off.
+        Media::RectangleGeometry clip;
+        clip.Rect({ 0, 0, newSize.Width, newSize.Height });
+        SwapChainPanel().Clip(clip);
+
         if (_automationPeer)
         {
             _automationPeer.UpdateControlBounds();
@@ -1602,25 +1750,25 @@ namespace winrt::Microsoft::Terminal::Control::implementation
 
     // Method Description:
     // - Toggle the cursor on and off when called by the cursor blink timer.
-    // Arguments:
-    // - sender: not used
-    // - e: not used
-    void TermControl::_CursorTimerTick(Windows::Foundation::IInspectable const& /* sender */,
-                                       Windows::Foundation::IInspectable const& /* e */)
+    void TermControl::_CursorTimerTick()
     {
         if (!_IsClosing())
         {
+            // While saving power, we stop blinking (with the cursor shown) once the
+            // user stopped typing for a while, until the next key press or focus.
+            if (std::chrono::steady_clock::now() - _lastCursorActivity >= PowerSavingCursorBlinkTimeout && _core.PowerSaving())
+            {
+                _core.CursorOn(true);
+                _cursorTimer->Stop();
+                return;
+            }
             _core.BlinkCursor();
         }
     }
 
     // Method Description:
     // - Toggle the blinking rendition state when called by the blink timer.
-    // Arguments:
-    // - sender: not used
-    // - e: not used
-    void TermControl::_BlinkTimerTick(Windows::Foundation::IInspectable const& /* sender */,
-                                      Windows::Foundation::IInspectable const& /* e */)
+    void TermControl::_BlinkTimerTick()
     {
         if (!_IsClosing())
         {
@@ -1656,29 +1804,109 @@ namespace winrt::Microsoft::Terminal::Control::implementation
         update.newMinimum = 0;
         update.newViewportSize = args.ViewHeight();
         update.newValue = args.ViewTop();
+        const auto markRows = _core.ScrollMarkRows();
+        update.markRows.resize(markRows.Size());
+        markRows.GetMany(0, update.markRows);
 
         _updateScrollBar->Run(update);
     }
 
+    // Method Description:
+    // - Sets the properties of the scroll bar to the given update. Only the ones
+    //   that changed since the last update are set, because every one of them
+    //   makes XAML do another layout of the scroll bar.
+    // Arguments:
+    // - update: the new values of the scroll bar
+    void TermControl::_ApplyScrollBarUpdate(const ScrollBarUpdate& update)
+    {
+        const auto last = std::exchange(_lastScrollBarUpdate, update);
+        const auto changed = [&](auto member) {
+            return !last || (*last).*member != update.*member;
+        };
+
+        _isInternalScrollBarUpdate = true;
+
+        auto scrollBar = ScrollBar();
+        if (update.newValue && changed(&ScrollBarUpdate::newValue))
+        {
+            scrollBar.Value(*update.newValue);
+        }
+        if (changed(&ScrollBarUpdate::newMaximum))
+        {
+            scrollBar.Maximum(update.newMaximum);
+        }
+        if (changed(&ScrollBarUpdate::newMinimum))
+        {
+            scrollBar.Minimum(update.newMinimum);
+        }
+        if (changed(&ScrollBarUpdate::newViewportSize))
+        {
+            scrollBar.ViewportSize(update.newViewportSize);
+            // scroll one full screen worth at a time when the scroll bar is clicked
+            scrollBar.LargeChange(std::max(update.newViewportSize - 1, 0.));
+        }
+        if (changed(&ScrollBarUpdate::markRows) || changed(&ScrollBarUpdate::newMaximum) || changed(&ScrollBarUpdate::newViewportSize))
+        {
+            _DrawScrollMarks(update);
+        }
+
+        _isInternalScrollBarUpdate = false;
+    }
+
+    // Method Description:
+    // - Draws a tick over the scroll bar's track for every prompt that the
+    //   shell marked, where the scroll bar's thumb would be if that prompt
+    //   was at the top of the viewport.
+    // Arguments:
+    // - update: the new values of the scroll bar
+    void TermControl::_DrawScrollMarks(const ScrollBarUpdate& update)
+    {
+        auto canvas = ScrollMarksCanvas();
+        auto children = canvas.Children();
+        children.Clear();
+
+        const auto totalRows = update.newMaximum + update.newViewportSize;
+        const auto height = ScrollBar().ActualHeight();
+        if (update.markRows.empty() || totalRows <= 0 || height <= 0)
+        {
+            return;
+        }
+
+        const Media::SolidColorBrush brush{ Windows::UI::Colors::Gray() };
+        auto lastTop = -1.0;
+        for (const auto row : update.markRows)
+        {
+            // Marks that end up on the same pixel are drawn only once.
+            const auto top = std::floor(row * height / totalRows);
+            if (top == lastTop)
+            {
+                continue;
+            }
+            lastTop = top;
+
+            Shapes::Rectangle tick;
+            tick.Width(canvas.Width());
+            tick.Height(2);
+            tick.Fill(brush);
+            Controls::Canvas::SetTop(tick, top);
+            children.Append(tick);
+        }
+    }
+
     // Method Description:
     // - Tells TSFInputControl to redraw the Canvas/TextBlock so it'll update
     //   to be where the current cursor position is.
     // Arguments:
     // - N/A
-    winrt::fire_and_forget TermControl::_CursorPositionChanged(const IInspectable& /*sender*/,
-                                                               const IInspectable& /*args*/)
+    void TermControl::_CursorPositionChanged(const IInspectable& /*sender*/,
+                                             const IInspectable& /*args*/)
     {
         // Prior to GH#10187, this fired a trailing throttled func to update the
         // TSF canvas only every 100ms. Now, the throttling occurs on the
-        // ControlCore side. If we're told to update the cursor position, we can
-        // just go ahead and do it.
-        // This can come in off the COM thread - hop back to the UI thread.
-        auto weakThis{ get_weak() };
-        co_await resume_foreground(Dispatcher());
-        if (auto control{ weakThis.get() }; !control->_IsClosing())
-        {
-            control->TSFInputControl().TryRedrawCanvas();
-        }
+        // ControlCore side. If we're told to update the cursor position, we
+        // only have to wait for the end of the frame.
+        // This can come in off the COM thread - the update runs on the UI thread.
+        _tsfTryRedrawCanvas->Run();
     }
 
     hstring TermControl::Title()
@@ -49,6 +49,9 @@ namespace winrt::Microsoft::Terminal::Control::implementation
 
         TerminalConnection::ConnectionState ConnectionState() const;
 
+        uint64_t OutputLength() const noexcept;
+        Windows::Foundation::TimeSpan TimeSinceOutput() const noexcept;
+
         int ScrollOffset() const;
         int ViewHeight() const;
         int BufferHeight() const;
@@ -63,7 +66,12 @@ namespace winrt::Microsoft::Terminal::Control::implementation
         til::point GetFontSize() const;
 
         void SendInput(const winrt::hstring& input);
+        TerminalConnection::ITerminalConnection Connection() const;
+        void BroadcastInputTo(const Windows::Foundation::Collections::IVector<TerminalConnection::ITerminalConnection>& connections);
         void ToggleShaderEffects();
+        void ToggleFrameStatistics();
+        void LiveResizeChanged(const bool liveResize);
+        void KeepRenderingWhileHidden(const bool keepRendering);
 
         winrt::fire_and_forget RenderEngineSwapChainChanged(IInspectable sender, IInspectable args);
         void _AttachDxgiSwapChainToXaml(HANDLE swapChainHandle);
@@ -77,6 +85,12 @@ namespace winrt::Microsoft::Terminal::Control::implementation
 
         void SearchMatch(const bool goForward);
 
+        void ScrollToMark(const bool next);
+        void SelectOutput(const bool next);
+        void ExportBuffer(const winrt::hstring& path, const ExportFormat format);
+        Windows::Foundation::IAsyncOperation<Windows::Foundation::Collections::IVector<Control::BufferSearchResult>> FindAllAsync(const winrt::hstring& text, const bool caseSensitive);
+        void ScrollToSearchResult(const Control::BufferSearchResult& result);
+
         bool OnDirectKeyEvent(const uint32_t vkey, const uint8_t scanCode, const bool down);
 
         bool OnMouseWheel(const Windows::Foundation::Point location, const int32_t delta, const bool leftButtonDown, const bool midButtonDown, const bool rightButtonDown);
@@ -152,6 +166,7 @@ namespace winrt::Microsoft::Terminal::Control::implementation
         bool _closing{ false };
         bool _focused{ false };
         bool _initializedTerminal{ false };
+        bool _keepRenderingWhileHidden{ false };
 
         std::shared_ptr<ThrottledFuncLeading> _playWarningBell;
 
@@ -161,9 +176,14 @@ namespace winrt::Microsoft::Terminal::Control::implementation
             double newMaximum;
             double newMinimum;
             double newViewportSize;
+            std::vector<int32_t> markRows;
         };
 
-        std::shared_ptr<ThrottledFuncTrailing<ScrollBarUpdate>> _updateScrollBar;
+        // These are batched with the updates of all the other controls in the window.
+        std::shared_ptr<UiUpdate<ScrollBarUpdate>> _updateScrollBar;
+        std::shared_ptr<UiUpdate<>> _tsfTryRedrawCanvas;
+        // The scroll bar properties are only set when they changed since the last update.
+        std::optional<ScrollBarUpdate> _lastScrollBarUpdate;
 
         bool _isInternalScrollBarUpdate;
 
@@ -178,10 +198,16 @@ namespace winrt::Microsoft::Terminal::Control::implementation
         winrt::Windows::UI::Composition::ScalarKeyFrameAnimation _bellLightAnimation{ nullptr };
         Windows::UI::Xaml::DispatcherTimer _bellLightTimer{ nullptr };
 
-        std::optional<Windows::UI::Xaml::DispatcherTimer> _cursorTimer;
-        std::optional<Windows::UI::Xaml::DispatcherTimer> _blinkTimer;
+        // The blink timers of all controls on this thread with the same blink time share a timer.
+        std::unique_ptr<SharedUiTimer::Client> _cursorTimer;
+        std::unique_ptr<SharedUiTimer::Client> _blinkTimer;
+
+        // While saving power, the cursor stops blinking this long after the last key press.
+        static constexpr std::chrono::seconds PowerSavingCursorBlinkTimeout{ 10 };
+        std::chrono::steady_clock::time_point _lastCursorActivity{ std::chrono::steady_clock::now() };
 
         winrt::Windows::UI::Xaml::Controls::SwapChainPanel::LayoutUpdated_revoker _layoutUpdatedRevoker;
+        winrt::Windows::UI::Xaml::XamlRoot::Changed_revoker _xamlRootChangedRevoker;
 
         inline bool _IsClosing() const noexcept
         {
@@ -204,6 +230,11 @@ namespace winrt::Microsoft::Terminal::Control::implementation
         winrt::fire_and_forget _changeBackgroundColor(const til::color bg);
 
         bool _InitializeTerminal();
+        void _LoadedHandler(const IInspectable& sender, const Windows::UI::Xaml::RoutedEventArgs& args);
+        void _UnloadedHandler(const IInspectable& sender, const Windows::UI::Xaml::RoutedEventArgs& args);
+        void _UpdateOcclusion(const bool loaded);
+        void _ApplyScrollBarUpdate(const ScrollBarUpdate& update);
+        void _DrawScrollMarks(const ScrollBarUpdate& update);
         void _SetFontSize(int fontSize);
         void _TappedHandler(Windows::Foundation::IInspectable const& sender, Windows::UI::Xaml::Input::TappedRoutedEventArgs const& e);
         void _KeyDownHandler(Windows::Foundation::IInspectable const& sender, Windows::UI::Xaml::Input::KeyRoutedEventArgs const& e);
@@ -224,8 +255,8 @@ namespace winrt::Microsoft::Terminal::Control::implementation
 
         winrt::fire_and_forget _HyperlinkHandler(Windows::Foundation::IInspectable sender, Control::OpenHyperlinkEventArgs e);
 
-        void _CursorTimerTick(Windows::Foundation::IInspectable const& sender, Windows::Foundation::IInspectable const& e);
-        void _BlinkTimerTick(Windows::Foundation::IInspectable const& sender, Windows::Foundation::IInspectable const& e);
+        void _CursorTimerTick();
+        void _BlinkTimerTick();
         void _BellLightOff(Windows::Foundation::IInspectable const& sender, Windows::Foundation::IInspectable const& e);
 
         void _SetEndSelectionPointAtCursor(Windows::Foundation::Point const& cursorPosition);
@@ -236,7 +267,7 @@ namespace winrt::Microsoft::Terminal::Control::implementation
         void _TerminalTabColorChanged(const std::optional<til::color> color);
 
         void _ScrollPositionChanged(const IInspectable& sender, const Control::ScrollPositionChangedArgs& args);
-        winrt::fire_and_forget _CursorPositionChanged(const IInspectable& sender, const IInspectable& args);
+        void _CursorPositionChanged(const IInspectable& sender, const IInspectable& args);
 
         bool _CapturePointer(Windows::Foundation::IInspectable const& sender, Windows::UI::Xaml::Input::PointerRoutedEventArgs const& e);
         bool _ReleasePointerCapture(Windows::Foundation::IInspectable const& sender, Windows::UI::Xaml::Input::PointerRoutedEventArgs const& e);
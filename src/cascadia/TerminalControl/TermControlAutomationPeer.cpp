@@ -45,6 +45,7 @@ namespace winrt::Microsoft::Terminal::Control::implementation
         _contentAutomationPeer.SelectionChanged([this](auto&&, auto&&) { SignalSelectionChanged(); });
         _contentAutomationPeer.TextChanged([this](auto&&, auto&&) { SignalTextChanged(); });
         _contentAutomationPeer.CursorChanged([this](auto&&, auto&&) { SignalCursorChanged(); });
+        _contentAutomationPeer.NewOutput([this](auto&&, const winrt::hstring& text) { SignalNewOutput(text); });
     };
 
     // Method Description:
@@ -141,6 +142,34 @@ namespace winrt::Microsoft::Terminal::Control::implementation
         });
     }
 
+    // Method Description:
+    // - Notifies the ui automation client of the text that was written since
+    //   the last time. A TextChanged event can't tell what changed, so without
+    //   this, clients would have to re-read and diff the entire text to find out.
+    // Arguments:
+    // - text: the new output.
+    // Return Value:
+    // - <none>
+    void TermControlAutomationPeer::SignalNewOutput(const std::wstring_view text)
+    {
+        auto dispatcher{ Dispatcher() };
+        if (!dispatcher)
+        {
+            return;
+        }
+        dispatcher.RunAsync(Windows::UI::Core::CoreDispatcherPriority::Normal, [weakThis{ get_weak() }, text{ winrt::hstring{ text } }]() {
+            if (auto strongThis{ weakThis.get() })
+            {
+                // Output is read in order and none of it is to be dropped,
+                // but newer output doesn't interrupt what's being read.
+                strongThis->RaiseNotificationEvent(AutomationNotificationKind::Other,
+                                                   AutomationNotificationProcessing::All,
+                                                   text,
+                                                   L"TerminalTextOutput");
+            }
+        });
+    }
+
     hstring TermControlAutomationPeer::GetClassNameCore() const
     {
         return L"TermControl";
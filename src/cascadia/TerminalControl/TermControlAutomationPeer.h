@@ -64,6 +64,7 @@ namespace winrt::Microsoft::Terminal::Control::implementation
         void SignalSelectionChanged() override;
         void SignalTextChanged() override;
         void SignalCursorChanged() override;
+        void SignalNewOutput(const std::wstring_view text) override;
 #pragma endregion
 
 #pragma region ITextProvider Pattern
@@ -29,6 +29,7 @@
 #include <winrt/Windows.Foundation.h>
 #include <winrt/Windows.Foundation.Collections.h>
 #include <winrt/Windows.system.h>
+#include <winrt/Windows.System.Power.h>
 #include <winrt/Windows.Graphics.Display.h>
 #include <winrt/windows.ui.core.h>
 #include <winrt/Windows.ui.input.h>
@@ -42,6 +43,7 @@
 #include <winrt/Windows.Ui.Xaml.Documents.h>
 #include <winrt/Windows.UI.Xaml.Media.h>
 #include <winrt/Windows.UI.Xaml.Media.Imaging.h>
+#include <winrt/Windows.UI.Xaml.Shapes.h>
 #include <winrt/Windows.UI.Xaml.Input.h>
 #include <winrt/Windows.UI.Xaml.Interop.h>
 #include <winrt/Windows.ui.xaml.markup.h>
@@ -52,6 +54,7 @@
 #include <winrt/Microsoft.Terminal.Core.h>
 
 #include <windows.ui.xaml.media.dxinterop.h>
+#include <MemoryBuffer.h>
 
 #include <TraceLoggingProvider.h>
 TRACELOGGING_DECLARE_PROVIDER(g_hTerminalControlProvider);
@@ -62,3 +65,5 @@ TRACELOGGING_DECLARE_PROVIDER(g_hTerminalControlProvider);
 #include "til.h"
 
 #include "ThrottledFunc.h"
+#include "UiUpdateScheduler.h"
+#include "SharedUiTimer.h"
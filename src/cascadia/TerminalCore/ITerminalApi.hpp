@@ -4,6 +4,7 @@
 
 #include "../../terminal/adapter/DispatchTypes.hpp"
 #include "../../buffer/out/TextAttribute.hpp"
+#include "../../buffer/out/ScrollMark.hpp"
 #include "../../types/inc/Viewport.hpp"
 
 namespace Microsoft::Terminal::Core
@@ -59,6 +60,10 @@ namespace Microsoft::Terminal::Core
         virtual bool EnableAlternateScrollMode(const bool enabled) noexcept = 0;
         virtual bool EnableXtermBracketedPasteMode(const bool enabled) noexcept = 0;
         virtual bool IsXtermBracketedPasteModeEnabled() const = 0;
+        virtual bool EnableSynchronizedOutput(const bool enabled) noexcept = 0;
+
+        virtual bool UseAlternateScreenBuffer() noexcept = 0;
+        virtual bool UseMainScreenBuffer() noexcept = 0;
 
         virtual bool IsVtInputEnabled() const = 0;
 
@@ -72,6 +77,8 @@ namespace Microsoft::Terminal::Core
         virtual bool SetWorkingDirectory(std::wstring_view uri) noexcept = 0;
         virtual std::wstring_view GetWorkingDirectory() noexcept = 0;
 
+        virtual bool AddMark(const MarkCategory category, const std::optional<uint32_t> exitCode) noexcept = 0;
+
         virtual bool PushGraphicsRendition(const ::Microsoft::Console::VirtualTerminal::VTParameters options) noexcept = 0;
         virtual bool PopGraphicsRendition() noexcept = 0;
 
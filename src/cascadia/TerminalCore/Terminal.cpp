@@ -21,9 +21,13 @@ using namespace Microsoft::Console::VirtualTerminal;
 
 using PointTree = interval_tree::IntervalTree<til::point, size_t>;
 
-static std::wstring _KeyEventsToText(std::deque<std::unique_ptr<IInputEvent>>& inEventsToWrite)
+// How many rows of scrollback above the viewport are kept ready for
+// rendering. Anything older is frozen into a compact form by the buffer.
+static constexpr size_t HotScrollbackRows = 1000;
+
+static void _AppendKeyEventsText(std::deque<std::unique_ptr<IInputEvent>>& inEventsToWrite, std::wstring& wstr)
 {
-    std::wstring wstr = L"";
+    wstr.reserve(wstr.size() + inEventsToWrite.size());
     for (const auto& ev : inEventsToWrite)
     {
         if (ev->EventType() == InputEventType::KeyEvent)
@@ -33,7 +37,6 @@ static std::wstring _KeyEventsToText(std::deque<std::unique_ptr<IInputEvent>>& i
             wstr += wch;
         }
     }
-    return wstr;
 }
 
 #pragma warning(suppress : 26455) // default constructor is throwing, too much effort to rearrange at this time.
@@ -61,11 +64,17 @@ Terminal::Terminal() :
     _stateMachine = std::make_unique<StateMachine>(std::move(engine));
 
     auto passAlongInput = [&](std::deque<std::unique_ptr<IInputEvent>>& inEventsToWrite) {
+        if (_batchedInput)
+        {
+            _AppendKeyEventsText(inEventsToWrite, *_batchedInput);
+            return;
+        }
         if (!_pfnWriteInput)
         {
             return;
         }
-        std::wstring wstr = _KeyEventsToText(inEventsToWrite);
+        std::wstring wstr;
+        _AppendKeyEventsText(inEventsToWrite, wstr);
         _pfnWriteInput(wstr);
     };
 
@@ -82,7 +91,10 @@ void Terminal::Create(COORD viewportSize, SHORT scrollbackLines, IRenderTarget&
                             Utils::ClampToShortMax(viewportSize.Y + scrollbackLines, 1) };
     const TextAttribute attr{};
     const UINT cursorSize = 12;
-    _buffer = std::make_unique<TextBuffer>(bufferSize, attr, cursorSize, renderTarget);
+    // The terminal only ever replaces its buffer on resize (see UserResize),
+    // so it can keep all of its rows in a single arena.
+    _buffer = std::make_unique<TextBuffer>(bufferSize, attr, cursorSize, renderTarget, true);
+    _buffer->SetHotRowCount(viewportSize.Y + HotScrollbackRows);
 }
 
 // Method Description:
@@ -159,6 +171,11 @@ void Terminal::UpdateSettings(ICoreSettings settings)
         {
             ClearPatternTree();
         }
+
+        if (_mainBuffer)
+        {
+            _mainBuffer->CopyPatterns(*_buffer);
+        }
     }
 }
 
@@ -231,6 +248,37 @@ void Terminal::UpdateAppearance(const ICoreAppearance& appearance)
         return S_FALSE;
     }
 
+    if (_InAltBuffer())
+    {
+        // Like conpty's, the alternate buffer is only ever as large as the
+        // viewport and doesn't reflow. The main buffer is reflowed as usual,
+        // while it's swapped in for a moment, so that it's ready to be
+        // switched back to.
+        RETURN_IF_FAILED(_buffer->ResizeTraditional(viewportSize));
+        _mutableViewport = Viewport::FromDimensions({ 0, 0 }, viewportSize);
+
+        _SwapMainBuffer();
+        const auto hr = _ResizeWithReflow(viewportSize);
+        _SwapMainBuffer();
+
+        _ScreenBufferChanged();
+        return hr;
+    }
+
+    return _ResizeWithReflow(viewportSize);
+}
+
+// Method Description:
+// - Reflows the contents of the buffer into a new buffer of the given size,
+//   keeping the viewport and the scroll position where they belong.
+// Arguments:
+// - viewportSize: the new size of the viewport, in chars
+// Return Value:
+// - S_OK if we successfully resized the terminal, or an appropriate HRESULT
+//      for failing to resize.
+[[nodiscard]] HRESULT Terminal::_ResizeWithReflow(const COORD viewportSize) noexcept
+{
+    const auto oldDimensions = _mutableViewport.Dimensions();
     const auto dx = ::base::ClampSub(viewportSize.X, oldDimensions.X);
     const short newBufferHeight = ::base::ClampAdd(viewportSize.Y, _scrollbackLines);
 
@@ -263,7 +311,8 @@ void Terminal::UpdateAppearance(const ICoreAppearance& appearance)
         newTextBuffer = std::make_unique<TextBuffer>(bufferSize,
                                                      TextAttribute{},
                                                      0, // temporarily set size to 0 so it won't render.
-                                                     _buffer->GetRenderTarget());
+                                                     _buffer->GetRenderTarget(),
+                                                     true);
 
         newTextBuffer->GetCursor().StartDeferDrawing();
 
@@ -399,6 +448,12 @@ void Terminal::UpdateAppearance(const ICoreAppearance& appearance)
     _mutableViewport = Viewport::FromDimensions({ 0, proposedTop }, viewportSize);
 
     _buffer.swap(newTextBuffer);
+    _buffer->SetHotRowCount(viewportSize.Y + HotScrollbackRows);
+    try
+    {
+        _ApplyResidentRowCount(*_buffer);
+    }
+    CATCH_LOG();
 
     // GH#3494: Maintain scrollbar position during resize
     // Make sure that we don't scroll past the mutableViewport at the bottom of the buffer
@@ -421,11 +476,26 @@ void Terminal::UpdateAppearance(const ICoreAppearance& appearance)
     return S_OK;
 }
 
-void Terminal::Write(std::wstring_view stringView)
+std::chrono::steady_clock::duration Terminal::Write(std::wstring_view stringView)
 {
+    const auto lockStart = std::chrono::steady_clock::now();
     auto lock = LockForWriting();
+    const auto lockWait = std::chrono::steady_clock::now() - lockStart;
+
+    // Output that scrolls the buffer would otherwise notify the control for
+    // every single new line. Since the notification only carries the scroll
+    // position, it's enough to send the one we ended up at.
+    _deferScrollEvents = true;
+    auto endDefer = wil::scope_exit([&]() noexcept {
+        _deferScrollEvents = false;
+        if (std::exchange(_scrollEventPending, false))
+        {
+            _NotifyScrollEvent();
+        }
+    });
 
     _stateMachine->ProcessString(stringView);
+    return lockWait;
 }
 
 void Terminal::WritePastedText(std::wstring_view stringView)
@@ -679,11 +749,22 @@ bool Terminal::SendCharEvent(const wchar_t ch, const WORD scanCode, const Contro
     // Unfortunately, the UI doesn't give us both a character down and a
     // character up event, only a character received event. So fake sending both
     // to the terminal input translator. Unless it's in win32-input-mode, it'll
-    // ignore the keyup.
+    // ignore the keyup. In win32-input-mode, both produce a sequence, and
+    // they're written to the connection together, instead of one at a time.
     KeyEvent keyDown{ true, 1, vkey, scanCode, ch, states.Value() };
     KeyEvent keyUp{ false, 1, vkey, scanCode, ch, states.Value() };
+
+    _batchedInput.emplace();
+    auto endBatch = wil::scope_exit([&]() noexcept { _batchedInput.reset(); });
     const auto handledDown = _terminalInput->HandleKey(&keyDown);
     const auto handledUp = _terminalInput->HandleKey(&keyUp);
+    auto input = std::move(*_batchedInput);
+    endBatch.reset();
+
+    if (!input.empty() && _pfnWriteInput)
+    {
+        _pfnWriteInput(input);
+    }
     return handledDown || handledUp;
 }
 
@@ -692,14 +773,23 @@ bool Terminal::SendCharEvent(const wchar_t ch, const WORD scanCode, const Contro
 // Arguments:
 // - The interval tree containing regions that need to be invalidated
 void Terminal::_InvalidatePatternTree(interval_tree::IntervalTree<til::point, size_t>& tree)
+{
+    tree.visit_all([&](const PointTree::interval& interval) {
+        InvalidatePatternInterval(interval);
+    });
+}
+
+// Method Description:
+// - Invalidates the cells covered by a single pattern interval, like the one
+//   that's currently hovered, for the rendering purposes
+// Arguments:
+// - interval - The interval, relative to the viewport
+void Terminal::InvalidatePatternInterval(const PointTree::interval& interval)
 {
     const auto vis = _VisibleStartIndex();
-    auto invalidate = [=](const PointTree::interval& interval) {
-        COORD startCoord{ gsl::narrow<SHORT>(interval.start.x()), gsl::narrow<SHORT>(interval.start.y() + vis) };
-        COORD endCoord{ gsl::narrow<SHORT>(interval.stop.x()), gsl::narrow<SHORT>(interval.stop.y() + vis) };
-        _InvalidateFromCoords(startCoord, endCoord);
-    };
-    tree.visit_all(invalidate);
+    COORD startCoord{ gsl::narrow<SHORT>(interval.start.x()), gsl::narrow<SHORT>(interval.start.y() + vis) };
+    COORD endCoord{ gsl::narrow<SHORT>(interval.stop.x()), gsl::narrow<SHORT>(interval.stop.y() + vis) };
+    _InvalidateFromCoords(startCoord, endCoord);
 }
 
 // Method Description:
@@ -843,13 +933,15 @@ WORD Terminal::_TakeVirtualKeyFromLastKeyEvent(const WORD scanCode) noexcept
 }
 
 // Method Description:
-// - Acquire a read lock on the terminal.
+// - Acquire a read lock on the terminal. Any number of readers may hold it at
+//      the same time, but they exclude writers (including the renderer and
+//      UIA, which go through LockConsole).
 // Return Value:
 // - a shared_lock which can be used to unlock the terminal. The shared_lock
 //      will release this lock when it's destructed.
-[[nodiscard]] std::unique_lock<til::ticket_lock> Terminal::LockForReading()
+[[nodiscard]] std::shared_lock<til::shared_ticket_lock> Terminal::LockForReading()
 {
-    return std::unique_lock{ _readWriteLock };
+    return std::shared_lock{ _readWriteLock };
 }
 
 // Method Description:
@@ -857,11 +949,44 @@ WORD Terminal::_TakeVirtualKeyFromLastKeyEvent(const WORD scanCode) noexcept
 // Return Value:
 // - a unique_lock which can be used to unlock the terminal. The unique_lock
 //      will release this lock when it's destructed.
-[[nodiscard]] std::unique_lock<til::ticket_lock> Terminal::LockForWriting()
+[[nodiscard]] std::unique_lock<til::shared_ticket_lock> Terminal::LockForWriting()
 {
     return std::unique_lock{ _readWriteLock };
 }
 
+bool Terminal::_InAltBuffer() const noexcept
+{
+    return _mainBuffer != nullptr;
+}
+
+// Method Description:
+// - Exchanges the active buffer, its viewport and scroll offset with the ones
+//   stashed away in _mainBuffer, _mainMutableViewport and _mainScrollOffset.
+void Terminal::_SwapMainBuffer() noexcept
+{
+    _buffer.swap(_mainBuffer);
+    std::swap(_mutableViewport, _mainMutableViewport);
+    std::swap(_scrollOffset, _mainScrollOffset);
+}
+
+// Method Description:
+// - Called after a different buffer became the active one, or the active buffer
+//   was resized. Everything that refers to cells of the previous one is
+//   discarded, the entire viewport is repainted and the scroll bar updated.
+void Terminal::_ScreenBufferChanged() noexcept
+{
+    _selection.reset();
+    _patternIntervalTree = {};
+    _UpdatePatternSpans();
+
+    try
+    {
+        _buffer->GetRenderTarget().TriggerRedrawAll();
+    }
+    CATCH_LOG();
+    _NotifyScrollEvent();
+}
+
 Viewport Terminal::_GetMutableViewport() const noexcept
 {
     return _mutableViewport;
@@ -917,45 +1042,34 @@ void Terminal::_WriteBuffer(const std::wstring_view& stringView)
     // We can not waste time displaying a cursor event when we know more text is coming right behind it.
     cursor.StartDeferDrawing();
 
-    for (size_t i = 0; i < stringView.size(); i++)
+    // We write the string one row segment at a time: WriteLine() fills as much of the
+    // cursor's row as fits (surrogate pairs and wide glyphs included) in a single call,
+    // and we only move the cursor once per segment instead of once per character.
+    auto remaining = stringView;
+    while (!remaining.empty())
     {
-        const auto wch = stringView.at(i);
         const COORD cursorPosBefore = cursor.GetPosition();
         COORD proposedCursorPosition = cursorPosBefore;
 
-        // TODO: MSFT 21006766
-        // This is not great but I need it demoable. Fix by making a buffer stream writer.
-        //
-        // If wch is a surrogate character we need to read 2 code units
-        // from the stringView to form a single code point.
-        const auto isSurrogate = wch >= 0xD800 && wch <= 0xDFFF;
-        const auto view = stringView.substr(i, isSurrogate ? 2 : 1);
-        const OutputCellIterator it{ view, _buffer->GetCurrentAttributes() };
-        const auto end = _buffer->Write(it);
+        const OutputCellIterator it{ remaining, _buffer->GetCurrentAttributes() };
+        const auto end = _buffer->WriteLine(it, cursorPosBefore);
         const auto cellDistance = end.GetCellDistance(it);
         const auto inputDistance = end.GetInputDistance(it);
 
         if (inputDistance > 0)
         {
-            // If "wch" was a surrogate character, we just consumed 2 code units above.
-            // -> Increment "i" by 1 in that case and thus by 2 in total in this iteration.
             proposedCursorPosition.X += gsl::narrow<SHORT>(cellDistance);
-            i += inputDistance - 1;
+            remaining = remaining.substr(inputDistance);
         }
         else
         {
-            // If _WriteBuffer() is called with a consecutive string longer than the viewport/buffer width
-            // the call to _buffer->Write() will refuse to write anything on the current line.
-            // GetInputDistance() thus returns 0, which would in turn cause i to be
-            // decremented by 1 below and force the outer loop to loop forever.
-            // This if() basically behaves as if "\r\n" had been encountered above and retries the write.
+            // If the cursor is already past the end of the row, or the next glyph is wide and only
+            // one cell is left on it, WriteLine() will refuse to write anything on the current line.
+            // This basically behaves as if "\r\n" had been encountered and retries the write on the next row.
             // With well behaving shells during normal operation this safeguard should normally not be encountered.
             proposedCursorPosition.X = 0;
             proposedCursorPosition.Y++;
 
-            // Try the character again.
-            i--;
-
             // If we write the last cell of the row here, TextBuffer::Write will
             // mark this line as wrapped for us. If the next character we
             // process is a newline, the Terminal::CursorLineFeed will unmark
@@ -1020,6 +1134,7 @@ void Terminal::_AdjustCursorPosition(const COORD proposedPosition)
 
         // manually erase our pattern intervals since the locations have changed now
         _patternIntervalTree = {};
+        _UpdatePatternSpans();
     }
 
     // Update Cursor Position
@@ -1107,9 +1222,189 @@ int Terminal::GetScrollOffset() noexcept
     return _VisibleStartIndex();
 }
 
+// Method Description:
+// - Scrolls the closest prompt above or below the top of the viewport to the
+//   top of the viewport. Scrolling down past the last prompt scrolls to the
+//   bottom. The caller must hold the write lock.
+// Arguments:
+// - next: whether to scroll down to the next prompt, rather than up to the previous one.
+// Return Value:
+// - true if the viewport was scrolled.
+bool Terminal::ScrollToMark(const bool next)
+{
+    const auto top = _VisibleStartIndex();
+    const auto mark = next ? _buffer->GetNextMark(top, MarkCategory::Prompt) :
+                             _buffer->GetPreviousMark(top, MarkCategory::Prompt);
+    if (!mark && !next)
+    {
+        return false;
+    }
+
+    const auto scrollOffset = mark ? std::max(0, ViewStartIndex() - gsl::narrow_cast<int>(mark->start.y())) : 0;
+    if (scrollOffset == _scrollOffset)
+    {
+        return false;
+    }
+
+    _scrollOffset = scrollOffset;
+    _buffer->GetRenderTarget().TriggerScroll();
+    _NotifyScrollEvent();
+    return true;
+}
+
+// Method Description:
+// - Scrolls the given row to the top of the viewport, or as close to it as
+//   the viewport can be scrolled. The caller must hold the write lock.
+// Arguments:
+// - row: the row, counted like GetExportRange counts it, so that it stays
+//   the same while the buffer circles.
+// Return Value:
+// - true if the viewport was scrolled.
+bool Terminal::ScrollToExportRow(const ptrdiff_t row)
+{
+    const auto bufferRow = row - _buffer->GetRotatedRowCount();
+    if (bufferRow < 0 || bufferRow >= _buffer->GetSize().Height())
+    {
+        return false;
+    }
+
+    const auto scrollOffset = std::max(0, ViewStartIndex() - gsl::narrow_cast<int>(bufferRow));
+    if (scrollOffset == _scrollOffset)
+    {
+        return false;
+    }
+
+    _scrollOffset = scrollOffset;
+    _buffer->GetRenderTarget().TriggerScroll();
+    _NotifyScrollEvent();
+    return true;
+}
+
+// Method Description:
+// - Selects the output of the command before or after the selection. Without
+//   a selection, that's the output of the last command, or of the first one
+//   below the top of the viewport. The caller must hold the write lock.
+// Arguments:
+// - next: whether to select the output of the next command, rather than the previous one.
+// Return Value:
+// - true if some output was selected.
+bool Terminal::SelectOutput(const bool next)
+{
+    ptrdiff_t row;
+    if (_selection)
+    {
+        row = _selection->start.Y;
+    }
+    else
+    {
+        row = next ? _VisibleStartIndex() - 1 : _buffer->GetCursor().GetPosition().Y + 1;
+    }
+
+    const auto mark = next ? _buffer->GetNextMark(row, MarkCategory::Output) :
+                             _buffer->GetPreviousMark(row, MarkCategory::Output);
+    if (!mark)
+    {
+        return false;
+    }
+
+    const COORD start = mark->start;
+    COORD end = _buffer->GetMarkEnd(*mark);
+    // The end is exclusive, but SelectNewRegion wants the last cell of the selection.
+    if (!_buffer->GetSize().DecrementInBounds(end) || _buffer->GetSize().CompareInBounds(end, start) < 0)
+    {
+        return false;
+    }
+
+    SetBlockSelection(false);
+    SelectNewRegion(start, end);
+    return true;
+}
+
+// Method Description:
+// - Gets the shell integration marks, for the scrollbar.
+// Arguments:
+// - <none>
+// Return Value:
+// - The marks, sorted by position, in buffer coordinates.
+std::vector<ScrollMark> Terminal::GetScrollMarks() const
+{
+    return _buffer->GetMarks();
+}
+
+// Method Description:
+// - Gets the rows that an export of the buffer consists of: all of them
+//   up to the last one with any text in it. They're counted from the first
+//   row the buffer ever had, so that they stay put as the buffer circles.
+// Arguments:
+// - <none>
+// Return Value:
+// - The first row and the row after the last one to export.
+std::pair<ptrdiff_t, ptrdiff_t> Terminal::GetExportRange()
+{
+    auto lock = LockForReading();
+    const auto rotated = _buffer->GetRotatedRowCount();
+    return { rotated, rotated + _buffer->GetLastNonSpaceCharacter().Y + 1 };
+}
+
+// Method Description:
+// - Retrieves the next chunk of rows of an export of the buffer. It only
+//   holds the lock while it copies out these rows. Rows that were rotated out
+//   of the buffer since the export started are skipped.
+// Arguments:
+// - row: the next row to export, as returned by GetExportRange. It's moved past
+//   the rows that were retrieved.
+// - endRow: the row after the last one to export, as returned by GetExportRange.
+// - maxRows: the largest number of rows to retrieve.
+// - withColors: whether to retrieve the colors of the rows as well.
+// Return Value:
+// - The text of the rows, with a CRLF after every row that doesn't wrap.
+TextBuffer::TextAndColor Terminal::RetrieveRowsForExport(ptrdiff_t& row, const ptrdiff_t endRow, const size_t maxRows, const bool withColors)
+{
+    auto lock = LockForReading();
+
+    const auto rotated = _buffer->GetRotatedRowCount();
+    const auto bufferSize = _buffer->GetSize();
+    const auto first = std::max<ptrdiff_t>(row - rotated, 0);
+    const auto last = std::min<ptrdiff_t>({ first + gsl::narrow_cast<ptrdiff_t>(maxRows), endRow - rotated, bufferSize.Height() });
+    if (first >= last)
+    {
+        row = endRow;
+        return {};
+    }
+    row = last + rotated;
+
+    std::vector<SMALL_RECT> rects;
+    rects.reserve(gsl::narrow_cast<size_t>(last - first));
+    for (auto i = first; i < last; ++i)
+    {
+        const auto y = gsl::narrow_cast<SHORT>(i);
+        rects.emplace_back(SMALL_RECT{ 0, y, bufferSize.RightInclusive(), y });
+    }
+
+    std::function<std::pair<COLORREF, COLORREF>(const TextAttribute&)> GetAttributeColors;
+    if (withColors)
+    {
+        GetAttributeColors = std::bind(&Terminal::GetAttributeColors, this, std::placeholders::_1);
+    }
+    auto rows = _buffer->GetText(true, true, rects, GetAttributeColors);
+
+    // GetText doesn't end the last row with a CRLF, but it isn't the last row of the export.
+    if (!_buffer->GetRowByOffset(gsl::narrow_cast<size_t>(last - 1)).WasWrapForced())
+    {
+        rows.text.back().append(L"\r\n");
+    }
+    return rows;
+}
+
 void Terminal::_NotifyScrollEvent() noexcept
 try
 {
+    if (_deferScrollEvents)
+    {
+        _scrollEventPending = true;
+        return;
+    }
+
     if (_pfnScrollPositionChanged)
     {
         const auto visible = _GetVisibleViewport();
@@ -1187,6 +1482,11 @@ void Microsoft::Terminal::Core::Terminal::TaskbarProgressChangedCallback(std::fu
     _pfnTaskbarProgressChanged.swap(pfn);
 }
 
+void Terminal::SetSynchronizedOutputCallback(std::function<void(const bool)> pfn) noexcept
+{
+    _pfnSynchronizedOutput.swap(pfn);
+}
+
 void Terminal::_InitializeColorTable()
 try
 {
@@ -1229,6 +1529,7 @@ void Terminal::UpdatePatternsUnderLock() noexcept
 {
     auto oldTree = _patternIntervalTree;
     _patternIntervalTree = _buffer->GetPatterns(_VisibleStartIndex(), _VisibleEndIndex());
+    _UpdatePatternSpans();
     _InvalidatePatternTree(oldTree);
     _InvalidatePatternTree(_patternIntervalTree);
 }
@@ -1241,9 +1542,152 @@ void Terminal::ClearPatternTree() noexcept
 {
     auto oldTree = _patternIntervalTree;
     _patternIntervalTree = {};
+    _UpdatePatternSpans();
     _InvalidatePatternTree(oldTree);
 }
 
+// Method Description:
+// - Moves everything but the viewport out of memory, for terminals that
+//   nobody looked at in a while: all of the scrollback is frozen and spilled
+//   into the buffer's spill file. Rows that scroll out of the viewport from
+//   now on are spilled right away. As usual, rows are transparently read back
+//   in as soon as someone accesses them.
+// - This applies to the main buffer, too, if we're in the alt buffer.
+// Arguments:
+// - <none>
+// Return Value:
+// - <none>
+// Note: will throw if the spill file can't be created
+void Terminal::Hibernate()
+{
+    _hibernated = true;
+    const auto viewportRows = gsl::narrow_cast<size_t>(_mutableViewport.Height());
+    for (const auto buffer : { _buffer.get(), _mainBuffer.get() })
+    {
+        if (buffer)
+        {
+            buffer->SetHotRowCount(viewportRows);
+            _ApplyResidentRowCount(*buffer);
+        }
+    }
+}
+
+// Method Description:
+// - Undoes Hibernate(): new scrollback is kept in memory again, up to the
+//   limit set by SetResidentRowLimit. Rows that were spilled stay in the
+//   spill file until they're accessed.
+// Arguments:
+// - <none>
+// Return Value:
+// - <none>
+void Terminal::Wake() noexcept
+try
+{
+    _hibernated = false;
+    const auto hotRows = gsl::narrow_cast<size_t>(_mutableViewport.Height()) + HotScrollbackRows;
+    for (const auto buffer : { _buffer.get(), _mainBuffer.get() })
+    {
+        if (buffer)
+        {
+            buffer->SetHotRowCount(hotRows);
+            _ApplyResidentRowCount(*buffer);
+        }
+    }
+}
+CATCH_LOG()
+
+// Method Description:
+// - Limits how many rows of the buffer are kept in memory. The rows above
+//   them are spilled into the buffer's spill file, see TextBuffer::SetResidentRowCount.
+//   The limit is kept across resizes.
+// Arguments:
+// - rows: the number of rows to keep in memory, or 0 for no limit.
+// Return Value:
+// - <none>
+// Note: will throw if the spill file can't be created
+void Terminal::SetResidentRowLimit(const size_t rows)
+{
+    _residentRowLimit = rows;
+    for (const auto buffer : { _buffer.get(), _mainBuffer.get() })
+    {
+        if (buffer)
+        {
+            _ApplyResidentRowCount(*buffer);
+        }
+    }
+}
+
+// Method Description:
+// - Freezes and spills the rows of the scrollback again that were read since
+//   they were first frozen or spilled, see TextBuffer::RefreezeColdRows.
+//   The terminal has to be locked for writing.
+// Arguments:
+// - <none>
+// Return Value:
+// - <none>
+void Terminal::RefreezeScrollback() noexcept
+{
+    for (const auto buffer : { _buffer.get(), _mainBuffer.get() })
+    {
+        if (buffer)
+        {
+            buffer->RefreezeColdRows();
+        }
+    }
+}
+
+void Terminal::_ApplyResidentRowCount(TextBuffer& buffer)
+{
+    if (_hibernated)
+    {
+        buffer.SetResidentRowCount(gsl::narrow_cast<size_t>(_mutableViewport.Height()));
+    }
+    else
+    {
+        buffer.SetResidentRowCount(_residentRowLimit);
+    }
+}
+
+// Method Description:
+// - Splits the intervals of the pattern tree up into spans per viewport row.
+//   The renderer walks them alongside the cells of a row, instead of querying
+//   the tree for every cell. The storage of the rows is kept between updates.
+void Terminal::_UpdatePatternSpans() noexcept
+try
+{
+    for (auto& spans : _patternSpans)
+    {
+        spans.clear();
+    }
+
+    const auto width = _buffer->GetSize().Width();
+    _patternIntervalTree.visit_all([&](const auto& interval) {
+        // The stop of an interval is exclusive and may be the start of the next row.
+        for (auto y = interval.start.y(); y <= interval.stop.y(); ++y)
+        {
+            const auto start = y == interval.start.y() ? interval.start.x() : 0;
+            const auto end = y == interval.stop.y() ? interval.stop.x() : width;
+            if (start >= end)
+            {
+                continue;
+            }
+
+            const auto row = gsl::narrow<size_t>(y);
+            if (row >= _patternSpans.size())
+            {
+                _patternSpans.resize(row + 1);
+            }
+            til::at(_patternSpans, row).push_back({ gsl::narrow<SHORT>(start), gsl::narrow<SHORT>(end), interval.value });
+        }
+    });
+
+    for (auto& spans : _patternSpans)
+    {
+        std::sort(spans.begin(), spans.end(), [](const auto& lhs, const auto& rhs) { return lhs.start < rhs.start; });
+    }
+}
+CATCH_LOG()
+
 // Method Description:
 // - Returns the tab color
 // If the starting color exits, it's value is preferred
@@ -73,14 +73,14 @@ public:
     void UpdateAppearance(const winrt::Microsoft::Terminal::Core::ICoreAppearance& appearance);
     void SetFontInfo(const FontInfo& fontInfo);
 
-    // Write goes through the parser
-    void Write(std::wstring_view stringView);
+    // Write goes through the parser. It returns how long it waited for the lock.
+    std::chrono::steady_clock::duration Write(std::wstring_view stringView);
 
     // WritePastedText goes directly to the connection
     void WritePastedText(std::wstring_view stringView);
 
-    [[nodiscard]] std::unique_lock<til::ticket_lock> LockForReading();
-    [[nodiscard]] std::unique_lock<til::ticket_lock> LockForWriting();
+    [[nodiscard]] std::shared_lock<til::shared_ticket_lock> LockForReading();
+    [[nodiscard]] std::unique_lock<til::shared_ticket_lock> LockForWriting();
 
     short GetBufferHeight() const noexcept;
 
@@ -124,6 +124,10 @@ public:
     bool EnableAlternateScrollMode(const bool enabled) noexcept override;
     bool EnableXtermBracketedPasteMode(const bool enabled) noexcept override;
     bool IsXtermBracketedPasteModeEnabled() const noexcept override;
+    bool EnableSynchronizedOutput(const bool enabled) noexcept override;
+
+    bool UseAlternateScreenBuffer() noexcept override;
+    bool UseMainScreenBuffer() noexcept override;
 
     bool IsVtInputEnabled() const noexcept override;
 
@@ -136,6 +140,8 @@ public:
     bool SetWorkingDirectory(std::wstring_view uri) noexcept override;
     std::wstring_view GetWorkingDirectory() noexcept override;
 
+    bool AddMark(const MarkCategory category, const std::optional<uint32_t> exitCode) noexcept override;
+
     bool PushGraphicsRendition(const ::Microsoft::Console::VirtualTerminal::VTParameters options) noexcept override;
     bool PopGraphicsRendition() noexcept override;
 
@@ -151,12 +157,21 @@ public:
     void UserScrollViewport(const int viewTop) override;
     int GetScrollOffset() noexcept override;
 
+    bool ScrollToMark(const bool next);
+    bool ScrollToExportRow(const ptrdiff_t row);
+    bool SelectOutput(const bool next);
+    std::vector<ScrollMark> GetScrollMarks() const;
+
+    std::pair<ptrdiff_t, ptrdiff_t> GetExportRange();
+    TextBuffer::TextAndColor RetrieveRowsForExport(ptrdiff_t& row, const ptrdiff_t endRow, const size_t maxRows, const bool withColors);
+
     void TrySnapOnInput() override;
     bool IsTrackingMouseInput() const noexcept;
 
     std::wstring GetHyperlinkAtPosition(const COORD position);
     uint16_t GetHyperlinkIdAtPosition(const COORD position);
     std::optional<interval_tree::IntervalTree<til::point, size_t>::interval> GetHyperlinkIntervalFromPosition(const COORD position);
+    void InvalidatePatternInterval(const interval_tree::IntervalTree<til::point, size_t>::interval& interval);
 #pragma endregion
 
 #pragma region IBaseData(base to IRenderData and IUiaData)
@@ -186,7 +201,7 @@ public:
     const bool IsGridLineDrawingAllowed() noexcept override;
     const std::wstring GetHyperlinkUri(uint16_t id) const noexcept override;
     const std::wstring GetHyperlinkCustomId(uint16_t id) const noexcept override;
-    const std::vector<size_t> GetPatternId(const COORD location) const noexcept override;
+    gsl::span<const Microsoft::Console::Render::PatternSpan> GetPatternSpans(const SHORT row) const noexcept override;
 #pragma endregion
 
 #pragma region IUiaData
@@ -210,6 +225,7 @@ public:
     void SetCursorPositionChangedCallback(std::function<void()> pfn) noexcept;
     void SetBackgroundCallback(std::function<void(const til::color)> pfn) noexcept;
     void TaskbarProgressChangedCallback(std::function<void()> pfn) noexcept;
+    void SetSynchronizedOutputCallback(std::function<void(const bool)> pfn) noexcept;
 
     void SetCursorOn(const bool isOn);
     bool IsCursorBlinkingAllowed() const noexcept;
@@ -217,6 +233,12 @@ public:
     void UpdatePatternsUnderLock() noexcept;
     void ClearPatternTree() noexcept;
 
+    void Hibernate();
+    void Wake() noexcept;
+    void SetResidentRowLimit(const size_t rows);
+    void RefreezeScrollback() noexcept;
+    void GetPatternId(const COORD location, std::vector<size_t>& patternIds) const noexcept;
+
     const std::optional<til::color> GetTabColor() const noexcept;
     til::color GetDefaultBackground() const noexcept;
 
@@ -253,16 +275,19 @@ private:
     //
     // But we can abuse the fact that the surrounding members rarely change and are huge
     // (std::function is like 64 bytes) to create some natural padding without wasting space.
-    til::ticket_lock _readWriteLock;
+    til::shared_ticket_lock _readWriteLock;
 
     std::function<void(const int, const int, const int)> _pfnScrollPositionChanged;
     std::function<void(const til::color)> _pfnBackgroundColorChanged;
     std::function<void()> _pfnCursorPositionChanged;
     std::function<void(const std::optional<til::color>)> _pfnTabColorChanged;
     std::function<void()> _pfnTaskbarProgressChanged;
+    std::function<void(const bool)> _pfnSynchronizedOutput;
 
     std::unique_ptr<::Microsoft::Console::VirtualTerminal::StateMachine> _stateMachine;
     std::unique_ptr<::Microsoft::Console::VirtualTerminal::TerminalInput> _terminalInput;
+    // The input of key events that are translated together, see SendCharEvent.
+    std::optional<std::wstring> _batchedInput;
 
     std::optional<std::wstring> _title;
     std::wstring _startingTitle;
@@ -311,12 +336,23 @@ private:
     SelectionExpansionMode _multiClickSelectionMode;
 #pragma endregion
 
-    // TODO: These members are not shared by an alt-buffer. They should be
-    //      encapsulated, such that a Terminal can have both a main and alt buffer.
+    // _buffer is the active buffer. While the alternate buffer is active, the main
+    // buffer is kept in _mainBuffer, along with its viewport and scroll offset.
+    // The alternate buffer has no scrollback, so its viewport is the whole buffer.
     std::unique_ptr<TextBuffer> _buffer;
     Microsoft::Console::Types::Viewport _mutableViewport;
     SHORT _scrollbackLines;
 
+    std::unique_ptr<TextBuffer> _mainBuffer;
+    Microsoft::Console::Types::Viewport _mainMutableViewport;
+    int _mainScrollOffset{ 0 };
+    // The last alternate buffer, so that entering the alternate buffer again only has to clear it.
+    std::unique_ptr<TextBuffer> _recycledAltBuffer;
+
+    bool _InAltBuffer() const noexcept;
+    void _SwapMainBuffer() noexcept;
+    void _ScreenBufferChanged() noexcept;
+
     // _scrollOffset is the number of lines above the viewport that are currently visible
     // If _scrollOffset is 0, then the visible region of the buffer is the viewport.
     int _scrollOffset;
@@ -333,7 +369,20 @@ private:
     //      underneath them, while others would prefer to anchor it in place.
     //      Either way, we should make this behavior controlled by a setting.
 
+    // While Write() processes output, scroll notifications are only recorded
+    // here, and sent once at the end with the final scroll position.
+    bool _deferScrollEvents{ false };
+    bool _scrollEventPending{ false };
+
+    // See Hibernate() and SetResidentRowLimit().
+    bool _hibernated{ false };
+    size_t _residentRowLimit{ 0 };
+    void _ApplyResidentRowCount(TextBuffer& buffer);
+
     interval_tree::IntervalTree<til::point, size_t> _patternIntervalTree;
+    // The intervals of _patternIntervalTree split up by viewport row, for the renderer.
+    std::vector<std::vector<Microsoft::Console::Render::PatternSpan>> _patternSpans;
+    void _UpdatePatternSpans() noexcept;
     void _InvalidatePatternTree(interval_tree::IntervalTree<til::point, size_t>& tree);
     void _InvalidateFromCoords(const COORD start, const COORD end);
 
@@ -365,6 +414,8 @@ private:
 
     void _AdjustCursorPosition(const COORD proposedPosition);
 
+    [[nodiscard]] HRESULT _ResizeWithReflow(const COORD viewportSize) noexcept;
+
     void _NotifyScrollEvent() noexcept;
 
     void _NotifyTerminalCursorPositionChanged() noexcept;
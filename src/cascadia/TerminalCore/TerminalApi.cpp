@@ -325,9 +325,9 @@ try
         // and we have to make sure we erase that text
         const auto eraseStart = _mutableViewport.Height();
         const auto eraseEnd = _buffer->GetLastNonSpaceCharacter(_mutableViewport).Y;
-        for (SHORT i = eraseStart; i <= eraseEnd; i++)
+        if (eraseStart <= eraseEnd)
         {
-            _buffer->GetRowByOffset(i).Reset(_buffer->GetCurrentAttributes());
+            _buffer->EraseRows(gsl::narrow_cast<size_t>(eraseStart), gsl::narrow_cast<size_t>(eraseEnd) + 1, _buffer->GetCurrentAttributes());
         }
 
         // Reset the scroll offset now because there's nothing for the user to 'scroll' to
@@ -558,6 +558,115 @@ bool Terminal::IsXtermBracketedPasteModeEnabled() const noexcept
     return _bracketedPasteMode;
 }
 
+bool Terminal::EnableSynchronizedOutput(const bool enabled) noexcept
+try
+{
+    if (_pfnSynchronizedOutput)
+    {
+        _pfnSynchronizedOutput(enabled);
+    }
+    return true;
+}
+CATCH_RETURN_FALSE()
+
+// Method Description:
+// - ASBSET - Switches to the alternate buffer, which is cleared first. It's as
+//   large as the viewport and has no scrollback. The main buffer keeps its
+//   contents and scroll position until we switch back to it. If the alternate
+//   buffer is already active, it's only cleared.
+// - The buffer of the last alternate buffer is reused if its size still fits,
+//   since applications like vim and less switch back and forth all the time.
+// Arguments:
+// - <none>
+// Return value:
+// - true if succeeded, false otherwise
+bool Terminal::UseAlternateScreenBuffer() noexcept
+try
+{
+    const auto viewportSize = _mutableViewport.Dimensions();
+    auto& mainBuffer = _InAltBuffer() ? *_mainBuffer : *_buffer;
+
+    // The cursor keeps its style, and its position relative to the viewport.
+    const auto& cursor = _buffer->GetCursor();
+    const auto cursorSize = cursor.GetSize();
+    const auto cursorColor = cursor.GetColor();
+    const auto cursorType = cursor.GetType();
+    const auto cursorVisible = cursor.IsVisible();
+    const auto cursorBlinkingAllowed = cursor.IsBlinkingAllowed();
+    const auto cursorPosition = GetCursorPosition();
+    const auto attributes = _buffer->GetCurrentAttributes();
+
+    // Just like conhost, clear the alternate buffer with the current
+    // background color, but with no meta attributes set.
+    auto eraseAttributes = attributes;
+    eraseAttributes.SetStandardErase();
+
+    auto altBuffer = _InAltBuffer() ? std::move(_buffer) : std::move(_recycledAltBuffer);
+    if (altBuffer && altBuffer->GetSize().Dimensions() == viewportSize)
+    {
+        altBuffer->Recycle(mainBuffer.GetRenderTarget(), eraseAttributes, cursorSize);
+    }
+    else
+    {
+        altBuffer = std::make_unique<TextBuffer>(viewportSize, eraseAttributes, cursorSize, mainBuffer.GetRenderTarget());
+    }
+    altBuffer->CopyPatterns(mainBuffer);
+    altBuffer->SetCurrentAttributes(attributes);
+
+    auto& altCursor = altBuffer->GetCursor();
+    altCursor.SetStyle(cursorSize, cursorColor, cursorType);
+    altCursor.SetIsVisible(cursorVisible);
+    altCursor.SetBlinkingAllowed(cursorBlinkingAllowed);
+
+    if (_buffer)
+    {
+        _mainBuffer = std::move(_buffer);
+        _mainMutableViewport = _mutableViewport;
+        _mainScrollOffset = _scrollOffset;
+    }
+    _buffer = std::move(altBuffer);
+    _mutableViewport = Viewport::FromDimensions({ 0, 0 }, viewportSize);
+    _scrollOffset = 0;
+    _buffer->GetCursor().SetPosition(cursorPosition);
+
+    _terminalInput->UseAlternateScreenBuffer();
+    _ScreenBufferChanged();
+    return true;
+}
+CATCH_RETURN_FALSE()
+
+// Method Description:
+// - ASBRST - Switches back to the main buffer, if the alternate buffer is active.
+//   The cursor position of the main buffer is left as it was, but it takes on
+//   the cursor style of the alternate buffer.
+// Arguments:
+// - <none>
+// Return value:
+// - true if succeeded, false otherwise
+bool Terminal::UseMainScreenBuffer() noexcept
+try
+{
+    if (!_InAltBuffer())
+    {
+        return true;
+    }
+
+    const auto& altCursor = _buffer->GetCursor();
+    auto& mainCursor = _mainBuffer->GetCursor();
+    mainCursor.SetStyle(altCursor.GetSize(), altCursor.GetColor(), altCursor.GetType());
+    mainCursor.SetIsVisible(altCursor.IsVisible());
+    mainCursor.SetBlinkingAllowed(altCursor.IsBlinkingAllowed());
+    _mainBuffer->SetCurrentAttributes(_buffer->GetCurrentAttributes());
+
+    _SwapMainBuffer();
+    _recycledAltBuffer = std::move(_mainBuffer);
+
+    _terminalInput->UseMainScreenBuffer();
+    _ScreenBufferChanged();
+    return true;
+}
+CATCH_RETURN_FALSE()
+
 bool Terminal::IsVtInputEnabled() const noexcept
 {
     // We should never be getting this call in Terminal.
@@ -684,6 +793,24 @@ std::wstring_view Terminal::GetWorkingDirectory() noexcept
     return _workingDirectory;
 }
 
+// Method Description:
+// - Places a shell integration mark at the cursor.
+// Arguments:
+// - category: what the mark tells about the text that follows it.
+// - exitCode: the exit code of the command, for a CommandFinished mark.
+// Return Value:
+// - true
+bool Terminal::AddMark(const MarkCategory category, const std::optional<uint32_t> exitCode) noexcept
+try
+{
+    _buffer->AddMark(category, til::point{ _buffer->GetCursor().GetPosition() }, exitCode);
+
+    // The scrollbar shows the marks, and it's updated along with the scroll position.
+    _NotifyScrollEvent();
+    return true;
+}
+CATCH_RETURN_FALSE()
+
 // Method Description:
 // - Saves the current text attributes to an internal stack.
 // Arguments:
@@ -452,6 +452,43 @@ bool TerminalDispatch::EnableXtermBracketedPasteMode(const bool enabled) noexcep
     return true;
 }
 
+//Routine Description:
+// Enable Synchronized Output - the renderer won't paint the application's
+//      redraw until it's complete, so that it's presented as a single frame.
+//Arguments:
+// - enabled - true to begin a synchronized update, false to end it.
+// Return value:
+// True if handled successfully. False otherwise.
+bool TerminalDispatch::EnableSynchronizedOutput(const bool enabled) noexcept
+{
+    _terminalApi.EnableSynchronizedOutput(enabled);
+    return true;
+}
+
+// Method Description:
+// - ASBSET - Switches to the alternate screen buffer. Conpty passes this
+//   through instead of repainting the whole viewport, once it switched to
+//   its own alternate buffer.
+// Arguments:
+// - <none>
+// Return value:
+// True if handled successfully. False otherwise.
+bool TerminalDispatch::UseAlternateScreenBuffer() noexcept
+{
+    return _terminalApi.UseAlternateScreenBuffer();
+}
+
+// Method Description:
+// - ASBRST - Switches back to the main screen buffer.
+// Arguments:
+// - <none>
+// Return value:
+// True if handled successfully. False otherwise.
+bool TerminalDispatch::UseMainScreenBuffer() noexcept
+{
+    return _terminalApi.UseMainScreenBuffer();
+}
+
 bool TerminalDispatch::SetMode(const DispatchTypes::ModeParams param) noexcept
 {
     return _ModeParamsHelper(param, true);
@@ -561,6 +598,47 @@ bool TerminalDispatch::DoConEmuAction(const std::wstring_view string) noexcept
     return false;
 }
 
+// Method Description:
+// - Performs a FinalTerm action, which is how shells tell us where their
+//   prompts, the commands that were entered and their output are.
+// - A marks the start of the prompt, B the start of the command line, C the
+//   start of the output, and D the end of the command, optionally followed by
+//   its exit code: "D;1".
+// Arguments:
+// - string: contains the parameters that define which action we do
+// Return Value:
+// - true if the action was understood.
+bool TerminalDispatch::DoFinalTermAction(const std::wstring_view string) noexcept
+{
+    const auto parts = Utils::SplitString(string, L';');
+    if (parts.size() < 1 || til::at(parts, 0).size() != 1)
+    {
+        return false;
+    }
+
+    switch (til::at(parts, 0).front())
+    {
+    case L'A':
+        return _terminalApi.AddMark(MarkCategory::Prompt, std::nullopt);
+    case L'B':
+        return _terminalApi.AddMark(MarkCategory::Command, std::nullopt);
+    case L'C':
+        return _terminalApi.AddMark(MarkCategory::Output, std::nullopt);
+    case L'D':
+    {
+        std::optional<uint32_t> exitCode;
+        unsigned int value = 0;
+        if (parts.size() >= 2 && Utils::StringToUint(til::at(parts, 1), value))
+        {
+            exitCode = value;
+        }
+        return _terminalApi.AddMark(MarkCategory::CommandFinished, exitCode);
+    }
+    default:
+        return false;
+    }
+}
+
 // Routine Description:
 // - Support routine for routing private mode parameters to be set/reset as flags
 // Arguments:
@@ -607,6 +685,12 @@ bool TerminalDispatch::_ModeParamsHelper(const DispatchTypes::ModeParams param,
     case DispatchTypes::ModeParams::XTERM_BracketedPasteMode:
         success = EnableXtermBracketedPasteMode(enable);
         break;
+    case DispatchTypes::ModeParams::SO_SynchronizedOutput:
+        success = EnableSynchronizedOutput(enable);
+        break;
+    case DispatchTypes::ModeParams::ASB_AlternateScreenBuffer:
+        success = enable ? UseAlternateScreenBuffer() : UseMainScreenBuffer();
+        break;
     case DispatchTypes::ModeParams::W32IM_Win32InputMode:
         success = EnableWin32InputMode(enable);
         break;
@@ -712,12 +796,8 @@ bool TerminalDispatch::HardReset() noexcept
 
     bool success = true;
 
-    // // If in the alt buffer, switch back to main before doing anything else.
-    // if (_usingAltBuffer)
-    // {
-    //     success = _pConApi->PrivateUseMainScreenBuffer();
-    //     _usingAltBuffer = !success;
-    // }
+    // If in the alt buffer, switch back to main before doing anything else.
+    success = UseMainScreenBuffer();
 
     // Sets the SGR state to normal - this must be done before EraseInDisplay
     //      to ensure that it clears with the default background color.
@@ -737,6 +817,9 @@ bool TerminalDispatch::HardReset() noexcept
     success = EnableSGRExtendedMouseMode(false) && success;
     success = EnableAnyEventMouseMode(false) && success;
 
+    // Don't leave the renderer waiting on an update that will never finish.
+    success = EnableSynchronizedOutput(false) && success;
+
     // Delete all current tab stops and reapply
     _ResetTabStops();
 
@@ -72,6 +72,10 @@ public:
     bool EnableAnyEventMouseMode(const bool enabled) noexcept override; // ?1003
     bool EnableAlternateScroll(const bool enabled) noexcept override; // ?1007
     bool EnableXtermBracketedPasteMode(const bool enabled) noexcept override; // ?2004
+    bool EnableSynchronizedOutput(const bool enabled) noexcept override; // ?2026
+
+    bool UseAlternateScreenBuffer() noexcept override; // ASBSET
+    bool UseMainScreenBuffer() noexcept override; // ASBRST
 
     bool SetMode(const ::Microsoft::Console::VirtualTerminal::DispatchTypes::ModeParams /*param*/) noexcept override; // DECSET
     bool ResetMode(const ::Microsoft::Console::VirtualTerminal::DispatchTypes::ModeParams /*param*/) noexcept override; // DECRST
@@ -80,6 +84,7 @@ public:
     bool EndHyperlink() noexcept override;
 
     bool DoConEmuAction(const std::wstring_view string) noexcept override;
+    bool DoFinalTermAction(const std::wstring_view string) noexcept override;
 
 private:
     ::Microsoft::Terminal::Core::ITerminalApi& _terminalApi;
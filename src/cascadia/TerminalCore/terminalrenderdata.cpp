@@ -131,26 +131,33 @@ const std::wstring Microsoft::Terminal::Core::Terminal::GetHyperlinkCustomId(uin
 // - Gets the regex pattern ids of a location
 // Arguments:
 // - The location
+// - patternIds - receives the pattern IDs of the location. Its storage is reused,
+//   so a caller querying cell after cell doesn't allocate once it has grown.
 // Return value:
-// - The pattern IDs of the location
-const std::vector<size_t> Terminal::GetPatternId(const COORD location) const noexcept
+// - <none>
+void Terminal::GetPatternId(const COORD location, std::vector<size_t>& patternIds) const noexcept
 {
+    patternIds.clear();
+
     // Look through our interval tree for this location
-    const auto intervals = _patternIntervalTree.findOverlapping(COORD{ location.X + 1, location.Y }, location);
-    if (intervals.size() == 0)
+    _patternIntervalTree.visit_overlapping(COORD{ location.X + 1, location.Y }, location, [&](const auto& interval) {
+        patternIds.emplace_back(interval.value);
+    });
+}
+
+// Method Description:
+// - Gets the regex patterns found in a row of the viewport
+// Arguments:
+// - row - The row, relative to the viewport
+// Return value:
+// - The spans of the patterns, sorted by their start column
+gsl::span<const PatternSpan> Terminal::GetPatternSpans(const SHORT row) const noexcept
+{
+    if (row < 0 || gsl::narrow_cast<size_t>(row) >= _patternSpans.size())
     {
         return {};
     }
-    else
-    {
-        std::vector<size_t> result{};
-        for (const auto& interval : intervals)
-        {
-            result.emplace_back(interval.value);
-        }
-        return result;
-    }
-    return {};
+    return til::at(_patternSpans, gsl::narrow_cast<size_t>(row));
 }
 
 std::vector<Microsoft::Console::Types::Viewport> Terminal::GetSelectionRects() noexcept
@@ -228,6 +235,9 @@ catch (...)
 // - Lock the terminal for reading the contents of the buffer. Ensures that the
 //      contents of the terminal won't be changed in the middle of a paint
 //      operation.
+//   This takes the lock exclusively: painting updates renderer state that
+//      writers touch as well (through the invalidation callbacks), and UIA
+//      uses this lock to change the selection.
 //   Callers should make sure to also call Terminal::UnlockConsole once
 //      they're done with any querying they need to do.
 void Terminal::LockConsole() noexcept
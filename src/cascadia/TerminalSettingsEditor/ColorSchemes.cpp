@@ -206,11 +206,16 @@ namespace winrt::Microsoft::Terminal::Settings::Editor::implementation
     {
         // Surprisingly, though this is called every time we navigate to the page,
         // the list does not keep growing on each navigation.
+        // The list is bound to the ComboBox already, so we replace
+        // its contents at once, instead of notifying it per scheme.
         const auto& colorSchemeMap{ _State.Settings().GlobalSettings().ColorSchemes() };
+        std::vector<Model::ColorScheme> colorSchemes;
+        colorSchemes.reserve(colorSchemeMap.Size());
         for (const auto& pair : colorSchemeMap)
         {
-            _ColorSchemeList.Append(pair.Value());
+            colorSchemes.emplace_back(pair.Value());
         }
+        _ColorSchemeList.ReplaceAll(colorSchemes);
     }
 
     // Function Description:
@@ -41,11 +41,6 @@ static const std::wstring_view globalAppearanceTag{ L"GlobalAppearance_Nav" };
 
 namespace winrt::Microsoft::Terminal::Settings::Editor::implementation
 {
-    static Editor::ProfileViewModel _viewModelForProfile(const Model::Profile& profile, const Model::CascadiaSettings& appSettings)
-    {
-        return winrt::make<implementation::ProfileViewModel>(profile, appSettings);
-    }
-
     MainPage::MainPage(const CascadiaSettings& settings) :
         _settingsSource{ settings },
         _settingsClone{ settings.Copy() }
@@ -72,6 +67,10 @@ namespace winrt::Microsoft::Terminal::Settings::Editor::implementation
         _settingsSource = settings;
         _settingsClone = settings.Copy();
 
+        // The view models point at the profiles of the old clone.
+        _profileViewModels.clear();
+        _profileDefaultsViewModel = nullptr;
+
         // Deduce information about the currently selected item
         IInspectable selectedItemTag;
         auto menuItems{ SettingsNav().MenuItems() };
@@ -101,7 +100,7 @@ namespace winrt::Microsoft::Terminal::Settings::Editor::implementation
                     {
                         if (const auto& tag{ navViewItem.Tag() })
                         {
-                            if (tag.try_as<Editor::ProfileViewModel>())
+                            if (tag.try_as<Model::Profile>())
                             {
                                 // remove NavViewItem pointing to a Profile
                                 return true;
@@ -151,15 +150,15 @@ namespace winrt::Microsoft::Terminal::Settings::Editor::implementation
                                 }
                             }
                         }
-                        else if (const auto& profileTag{ tag.try_as<ProfileViewModel>() })
+                        else if (const auto& profileTag{ tag.try_as<Model::Profile>() })
                         {
-                            if (const auto& selectedItemProfileTag{ selectedItemTag.try_as<ProfileViewModel>() })
+                            if (const auto& selectedItemProfileTag{ selectedItemTag.try_as<Model::Profile>() })
                             {
-                                if (profileTag->OriginalProfileGuid() == selectedItemProfileTag->OriginalProfileGuid())
+                                if (profileTag.Guid() == selectedItemProfileTag.Guid())
                                 {
                                     // found the one that was selected before the refresh
                                     SettingsNav().SelectedItem(item);
-                                    _Navigate(*profileTag);
+                                    _Navigate(_ViewModelForNavItem(menuItem));
                                     return;
                                 }
                             }
@@ -269,10 +268,10 @@ namespace winrt::Microsoft::Terminal::Settings::Editor::implementation
             {
                 _Navigate(*navString);
             }
-            else if (const auto profile = clickedItemContainer.Tag().try_as<Editor::ProfileViewModel>())
+            else if (clickedItemContainer.Tag().try_as<Model::Profile>())
             {
                 // Navigate to a page with the given profile
-                _Navigate(profile);
+                _Navigate(_ViewModelForNavItem(clickedItemContainer.as<MUX::Controls::NavigationViewItem>()));
             }
         }
     }
@@ -311,9 +310,12 @@ namespace winrt::Microsoft::Terminal::Settings::Editor::implementation
         }
         else if (clickedItemTag == globalProfileTag)
         {
-            auto profileVM{ _viewModelForProfile(_settingsClone.ProfileDefaults(), _settingsClone) };
-            profileVM.IsBaseLayer(true);
-            _lastProfilesNavState = winrt::make<ProfilePageNavigationState>(profileVM,
+            if (!_profileDefaultsViewModel)
+            {
+                _profileDefaultsViewModel = winrt::make<ProfileViewModel>(_settingsClone.ProfileDefaults(), _settingsClone);
+                _profileDefaultsViewModel.IsBaseLayer(true);
+            }
+            _lastProfilesNavState = winrt::make<ProfilePageNavigationState>(_profileDefaultsViewModel,
                                                                             _settingsClone.GlobalSettings().ColorSchemes(),
                                                                             _lastProfilesNavState,
                                                                             *this);
@@ -387,13 +389,12 @@ namespace winrt::Microsoft::Terminal::Settings::Editor::implementation
 
     void MainPage::_InitializeProfilesList()
     {
-        // Manually create a NavigationViewItem for each profile
-        // and keep a reference to them in a map so that we
-        // can easily modify the correct one when the associated
-        // profile changes.
+        // Manually create a NavigationViewItem for each profile.
+        // Their view models are only created once they're navigated to,
+        // because there may be a lot of (generated) profiles.
         for (const auto& profile : _settingsClone.AllProfiles())
         {
-            auto navItem = _CreateProfileNavViewItem(_viewModelForProfile(profile, _settingsClone));
+            auto navItem = _CreateProfileNavViewItem(profile);
             SettingsNav().MenuItems().Append(navItem);
         }
 
@@ -413,46 +414,69 @@ namespace winrt::Microsoft::Terminal::Settings::Editor::implementation
     void MainPage::_CreateAndNavigateToNewProfile(const uint32_t index, const Model::Profile& profile)
     {
         const auto newProfile{ profile ? profile : _settingsClone.CreateNewProfile() };
-        const auto profileViewModel{ _viewModelForProfile(newProfile, _settingsClone) };
-        const auto navItem{ _CreateProfileNavViewItem(profileViewModel) };
+        const auto navItem{ _CreateProfileNavViewItem(newProfile) };
         SettingsNav().MenuItems().InsertAt(index, navItem);
 
         // Select and navigate to the new profile
         SettingsNav().SelectedItem(navItem);
-        _Navigate(profileViewModel);
+        _Navigate(_ViewModelForNavItem(navItem));
     }
 
-    MUX::Controls::NavigationViewItem MainPage::_CreateProfileNavViewItem(const Editor::ProfileViewModel& profile)
+    MUX::Controls::NavigationViewItem MainPage::_CreateProfileNavViewItem(const Model::Profile& profile)
     {
         MUX::Controls::NavigationViewItem profileNavItem;
         profileNavItem.Content(box_value(profile.Name()));
-        profileNavItem.Tag(box_value<Editor::ProfileViewModel>(profile));
+        profileNavItem.Tag(box_value<Model::Profile>(profile));
 
         const auto iconSource{ IconPathConverter::IconSourceWUX(profile.Icon()) };
         WUX::Controls::IconSourceElement icon;
         icon.IconSource(iconSource);
         profileNavItem.Icon(icon);
 
+        return profileNavItem;
+    }
+
+    // Method Description:
+    // - Gets the view model of the profile of the given NavigationViewItem.
+    //   It's created the first time the profile is navigated to, and reused
+    //   afterwards, until the settings are reloaded.
+    // Arguments:
+    // - navItem: a NavigationViewItem created by _CreateProfileNavViewItem
+    // Return Value:
+    // - the view model of its profile
+    Editor::ProfileViewModel MainPage::_ViewModelForNavItem(const MUX::Controls::NavigationViewItem& navItem)
+    {
+        const auto profile{ navItem.Tag().as<Model::Profile>() };
+        const auto [it, inserted]{ _profileViewModels.try_emplace(profile.Guid(), nullptr) };
+        if (!inserted)
+        {
+            return it->second;
+        }
+
+        const auto profileViewModel{ winrt::make<ProfileViewModel>(profile, _settingsClone) };
+        it->second = profileViewModel;
+
         // Update the menu item when the icon/name changes
-        auto weakMenuItem{ make_weak(profileNavItem) };
-        profile.PropertyChanged([weakMenuItem](const auto&, const WUX::Data::PropertyChangedEventArgs& args) {
-            if (auto menuItem{ weakMenuItem.get() })
+        auto weakMenuItem{ make_weak(navItem) };
+        profileViewModel.PropertyChanged([weakMenuItem, weakViewModel{ make_weak(profileViewModel) }](const auto&, const WUX::Data::PropertyChangedEventArgs& args) {
+            const auto menuItem{ weakMenuItem.get() };
+            const auto viewModel{ weakViewModel.get() };
+            if (menuItem && viewModel)
             {
-                const auto& tag{ menuItem.Tag().as<Editor::ProfileViewModel>() };
                 if (args.PropertyName() == L"Icon")
                 {
-                    const auto iconSource{ IconPathConverter::IconSourceWUX(tag.Icon()) };
+                    const auto iconSource{ IconPathConverter::IconSourceWUX(viewModel.Icon()) };
                     WUX::Controls::IconSourceElement icon;
                     icon.IconSource(iconSource);
                     menuItem.Icon(icon);
                 }
                 else if (args.PropertyName() == L"Name")
                 {
-                    menuItem.Content(box_value(tag.Name()));
+                    menuItem.Content(box_value(viewModel.Name()));
                 }
             }
         });
-        return profileNavItem;
+        return profileViewModel;
     }
 
     void MainPage::_DeleteProfile(const IInspectable /*sender*/, const Editor::DeleteProfileEventArgs& args)
@@ -468,6 +492,7 @@ namespace winrt::Microsoft::Terminal::Settings::Editor::implementation
                 break;
             }
         }
+        _profileViewModels.erase(guid);
 
         // remove selected item
         uint32_t index;
@@ -479,7 +504,7 @@ namespace winrt::Microsoft::Terminal::Settings::Editor::implementation
         // navigate to the profile next to this one
         const auto newSelectedItem{ menuItems.GetAt(index < menuItems.Size() - 1 ? index : index - 1) };
         SettingsNav().SelectedItem(newSelectedItem);
-        _Navigate(newSelectedItem.try_as<MUX::Controls::NavigationViewItem>().Tag().try_as<Editor::ProfileViewModel>());
+        _Navigate(_ViewModelForNavItem(newSelectedItem.as<MUX::Controls::NavigationViewItem>()));
     }
 
     bool MainPage::ShowBaseLayerMenuItem() const noexcept
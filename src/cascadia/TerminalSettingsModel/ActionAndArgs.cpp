@@ -53,10 +53,16 @@ static constexpr std::string_view TogglePaneZoomKey{ "togglePaneZoom" };
 static constexpr std::string_view ToggleSplitOrientationKey{ "toggleSplitOrientation" };
 static constexpr std::string_view LegacyToggleRetroEffectKey{ "toggleRetroEffect" };
 static constexpr std::string_view ToggleShaderEffectsKey{ "toggleShaderEffects" };
+static constexpr std::string_view ToggleFrameStatisticsKey{ "toggleFrameStatistics" };
 static constexpr std::string_view MoveTabKey{ "moveTab" };
 static constexpr std::string_view BreakIntoDebuggerKey{ "breakIntoDebugger" };
 static constexpr std::string_view FindMatchKey{ "findMatch" };
+static constexpr std::string_view FindInAllTabsKey{ "findInAllTabs" };
+static constexpr std::string_view ScrollToMarkKey{ "scrollToMark" };
+static constexpr std::string_view SelectOutputKey{ "selectOutput" };
+static constexpr std::string_view ExportBufferKey{ "exportBuffer" };
 static constexpr std::string_view TogglePaneReadOnlyKey{ "toggleReadOnlyMode" };
+static constexpr std::string_view ToggleBroadcastInputKey{ "toggleBroadcastInput" };
 static constexpr std::string_view NewWindowKey{ "newWindow" };
 static constexpr std::string_view IdentifyWindowKey{ "identifyWindow" };
 static constexpr std::string_view IdentifyWindowsKey{ "identifyWindows" };
@@ -203,7 +209,8 @@ namespace winrt::Microsoft::Terminal::Settings::Model::implementation
         //    "action" in that object as the action name. We'll then pass
         //    the json object to the arg parser, for further parsing.
 
-        auto argsVal = Json::Value::null;
+        // This points into json instead of copying it, as there can be thousands of actions.
+        const Json::Value* argsVal = &Json::Value::nullSingleton();
 
         // Only try to parse the action if it's actually a string value.
         // `null` will not pass this check.
@@ -217,7 +224,7 @@ namespace winrt::Microsoft::Terminal::Settings::Model::implementation
             if (const auto actionString{ JsonUtils::GetValueForKey<std::optional<std::string>>(json, ActionKey) })
             {
                 action = GetActionFromString(*actionString);
-                argsVal = json;
+                argsVal = &json;
             }
         }
 
@@ -232,7 +239,7 @@ namespace winrt::Microsoft::Terminal::Settings::Model::implementation
             auto pfn = deserializersIter->second.first;
             if (pfn)
             {
-                std::tie(args, parseWarnings) = pfn(argsVal);
+                std::tie(args, parseWarnings) = pfn(*argsVal);
             }
             warnings.insert(warnings.end(), parseWarnings.begin(), parseWarnings.end());
 
@@ -354,10 +361,16 @@ namespace winrt::Microsoft::Terminal::Settings::Model::implementation
                 { ShortcutAction::TogglePaneZoom, RS_(L"TogglePaneZoomCommandKey") },
                 { ShortcutAction::ToggleSplitOrientation, RS_(L"ToggleSplitOrientationCommandKey") },
                 { ShortcutAction::ToggleShaderEffects, RS_(L"ToggleShaderEffectsCommandKey") },
+                { ShortcutAction::ToggleFrameStatistics, RS_(L"ToggleFrameStatisticsCommandKey") },
                 { ShortcutAction::MoveTab, L"" }, // Intentionally omitted, must be generated by GenerateName
                 { ShortcutAction::BreakIntoDebugger, RS_(L"BreakIntoDebuggerCommandKey") },
                 { ShortcutAction::FindMatch, L"" }, // Intentionally omitted, must be generated by GenerateName
+                { ShortcutAction::FindInAllTabs, RS_(L"FindInAllTabsCommandKey") },
+                { ShortcutAction::ScrollToMark, L"" }, // Intentionally omitted, must be generated by GenerateName
+                { ShortcutAction::SelectOutput, L"" }, // Intentionally omitted, must be generated by GenerateName
+                { ShortcutAction::ExportBuffer, L"" }, // Intentionally omitted, must be generated by GenerateName
                 { ShortcutAction::TogglePaneReadOnly, RS_(L"TogglePaneReadOnlyCommandKey") },
+                { ShortcutAction::ToggleBroadcastInput, RS_(L"ToggleBroadcastInputCommandKey") },
                 { ShortcutAction::NewWindow, RS_(L"NewWindowCommandKey") },
                 { ShortcutAction::IdentifyWindow, RS_(L"IdentifyWindowCommandKey") },
                 { ShortcutAction::IdentifyWindows, RS_(L"IdentifyWindowsCommandKey") },
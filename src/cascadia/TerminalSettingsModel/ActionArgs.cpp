@@ -27,6 +27,9 @@
 #include "CloseTabArgs.g.cpp"
 #include "MoveTabArgs.g.cpp"
 #include "FindMatchArgs.g.cpp"
+#include "ScrollToMarkArgs.g.cpp"
+#include "SelectOutputArgs.g.cpp"
+#include "ExportBufferArgs.g.cpp"
 #include "ToggleCommandPaletteArgs.g.cpp"
 #include "NewWindowArgs.g.cpp"
 #include "PrevTabArgs.g.cpp"
@@ -597,6 +600,44 @@ namespace winrt::Microsoft::Terminal::Settings::Model::implementation
         return L"";
     }
 
+    winrt::hstring ScrollToMarkArgs::GenerateName() const
+    {
+        switch (Direction())
+        {
+        case ScrollToMarkDirection::Next:
+            return winrt::hstring{ RS_(L"ScrollToNextMarkCommandKey") };
+        case ScrollToMarkDirection::Previous:
+            return winrt::hstring{ RS_(L"ScrollToPreviousMarkCommandKey") };
+        }
+        return L"";
+    }
+
+    winrt::hstring SelectOutputArgs::GenerateName() const
+    {
+        switch (Direction())
+        {
+        case ScrollToMarkDirection::Next:
+            return winrt::hstring{ RS_(L"SelectNextOutputCommandKey") };
+        case ScrollToMarkDirection::Previous:
+            return winrt::hstring{ RS_(L"SelectPreviousOutputCommandKey") };
+        }
+        return L"";
+    }
+
+    winrt::hstring ExportBufferArgs::GenerateName() const
+    {
+        // "Export the buffer"
+        // "Export the buffer to "{_Path}""
+        if (Path().empty())
+        {
+            return winrt::hstring{ RS_(L"ExportBufferCommandKey") };
+        }
+        return winrt::hstring{
+            fmt::format(std::wstring_view(RS_(L"ExportBufferToPathCommandKey")),
+                        Path().c_str())
+        };
+    }
+
     winrt::hstring NewWindowArgs::GenerateName() const
     {
         winrt::hstring newTerminalArgsStr;
@@ -30,6 +30,9 @@
 #include "MoveTabArgs.g.h"
 #include "ToggleCommandPaletteArgs.g.h"
 #include "FindMatchArgs.g.h"
+#include "ScrollToMarkArgs.g.h"
+#include "SelectOutputArgs.g.h"
+#include "ExportBufferArgs.g.h"
 #include "NewWindowArgs.g.h"
 #include "PrevTabArgs.g.h"
 #include "NextTabArgs.g.h"
@@ -1425,6 +1428,180 @@ namespace winrt::Microsoft::Terminal::Settings::Model::implementation
         }
     };
 
+    struct ScrollToMarkArgs : public ScrollToMarkArgsT<ScrollToMarkArgs>
+    {
+        ScrollToMarkArgs() = default;
+        ScrollToMarkArgs(ScrollToMarkDirection direction) :
+            _Direction{ direction } {};
+        ACTION_ARG(ScrollToMarkDirection, Direction, ScrollToMarkDirection::None);
+
+        static constexpr std::string_view DirectionKey{ "direction" };
+
+    public:
+        hstring GenerateName() const;
+
+        bool Equals(const IActionArgs& other)
+        {
+            auto otherAsUs = other.try_as<ScrollToMarkArgs>();
+            if (otherAsUs)
+            {
+                return otherAsUs->_Direction == _Direction;
+            }
+            return false;
+        };
+        static FromJsonResult FromJson(const Json::Value& json)
+        {
+            // LOAD BEARING: Not using make_self here _will_ break you in the future!
+            auto args = winrt::make_self<ScrollToMarkArgs>();
+            JsonUtils::GetValueForKey(json, DirectionKey, args->_Direction);
+            if (args->Direction() == ScrollToMarkDirection::None)
+            {
+                return { nullptr, { SettingsLoadWarnings::MissingRequiredParameter } };
+            }
+            else
+            {
+                return { *args, {} };
+            }
+        }
+        static Json::Value ToJson(const IActionArgs& val)
+        {
+            if (!val)
+            {
+                return {};
+            }
+            Json::Value json{ Json::ValueType::objectValue };
+            const auto args{ get_self<ScrollToMarkArgs>(val) };
+            JsonUtils::SetValueForKey(json, DirectionKey, args->_Direction);
+            return json;
+        }
+        IActionArgs Copy() const
+        {
+            auto copy{ winrt::make_self<ScrollToMarkArgs>() };
+            copy->_Direction = _Direction;
+            return *copy;
+        }
+        size_t Hash() const
+        {
+            return ::Microsoft::Terminal::Settings::Model::HashUtils::HashProperty(Direction());
+        }
+    };
+
+    struct SelectOutputArgs : public SelectOutputArgsT<SelectOutputArgs>
+    {
+        SelectOutputArgs() = default;
+        SelectOutputArgs(ScrollToMarkDirection direction) :
+            _Direction{ direction } {};
+        ACTION_ARG(ScrollToMarkDirection, Direction, ScrollToMarkDirection::None);
+
+        static constexpr std::string_view DirectionKey{ "direction" };
+
+    public:
+        hstring GenerateName() const;
+
+        bool Equals(const IActionArgs& other)
+        {
+            auto otherAsUs = other.try_as<SelectOutputArgs>();
+            if (otherAsUs)
+            {
+                return otherAsUs->_Direction == _Direction;
+            }
+            return false;
+        };
+        static FromJsonResult FromJson(const Json::Value& json)
+        {
+            // LOAD BEARING: Not using make_self here _will_ break you in the future!
+            auto args = winrt::make_self<SelectOutputArgs>();
+            JsonUtils::GetValueForKey(json, DirectionKey, args->_Direction);
+            if (args->Direction() == ScrollToMarkDirection::None)
+            {
+                return { nullptr, { SettingsLoadWarnings::MissingRequiredParameter } };
+            }
+            else
+            {
+                return { *args, {} };
+            }
+        }
+        static Json::Value ToJson(const IActionArgs& val)
+        {
+            if (!val)
+            {
+                return {};
+            }
+            Json::Value json{ Json::ValueType::objectValue };
+            const auto args{ get_self<SelectOutputArgs>(val) };
+            JsonUtils::SetValueForKey(json, DirectionKey, args->_Direction);
+            return json;
+        }
+        IActionArgs Copy() const
+        {
+            auto copy{ winrt::make_self<SelectOutputArgs>() };
+            copy->_Direction = _Direction;
+            return *copy;
+        }
+        size_t Hash() const
+        {
+            return ::Microsoft::Terminal::Settings::Model::HashUtils::HashProperty(Direction());
+        }
+    };
+
+    struct ExportBufferArgs : public ExportBufferArgsT<ExportBufferArgs>
+    {
+        ExportBufferArgs() = default;
+        ExportBufferArgs(winrt::hstring path, Microsoft::Terminal::Control::ExportFormat format) :
+            _Path{ path },
+            _Format{ format } {};
+        ACTION_ARG(winrt::hstring, Path, L"");
+        ACTION_ARG(Microsoft::Terminal::Control::ExportFormat, Format, Microsoft::Terminal::Control::ExportFormat::Text);
+
+        static constexpr std::string_view PathKey{ "path" };
+        static constexpr std::string_view FormatKey{ "format" };
+
+    public:
+        hstring GenerateName() const;
+
+        bool Equals(const IActionArgs& other)
+        {
+            auto otherAsUs = other.try_as<ExportBufferArgs>();
+            if (otherAsUs)
+            {
+                return otherAsUs->_Path == _Path &&
+                       otherAsUs->_Format == _Format;
+            }
+            return false;
+        };
+        static FromJsonResult FromJson(const Json::Value& json)
+        {
+            // LOAD BEARING: Not using make_self here _will_ break you in the future!
+            auto args = winrt::make_self<ExportBufferArgs>();
+            JsonUtils::GetValueForKey(json, PathKey, args->_Path);
+            JsonUtils::GetValueForKey(json, FormatKey, args->_Format);
+            return { *args, {} };
+        }
+        static Json::Value ToJson(const IActionArgs& val)
+        {
+            if (!val)
+            {
+                return {};
+            }
+            Json::Value json{ Json::ValueType::objectValue };
+            const auto args{ get_self<ExportBufferArgs>(val) };
+            JsonUtils::SetValueForKey(json, PathKey, args->_Path);
+            JsonUtils::SetValueForKey(json, FormatKey, args->_Format);
+            return json;
+        }
+        IActionArgs Copy() const
+        {
+            auto copy{ winrt::make_self<ExportBufferArgs>() };
+            copy->_Path = _Path;
+            copy->_Format = _Format;
+            return *copy;
+        }
+        size_t Hash() const
+        {
+            return ::Microsoft::Terminal::Settings::Model::HashUtils::HashProperty(Path(), Format());
+        }
+    };
+
     struct NewWindowArgs : public NewWindowArgsT<NewWindowArgs>
     {
         NewWindowArgs() = default;
@@ -1774,6 +1951,9 @@ namespace winrt::Microsoft::Terminal::Settings::Model::factory_implementation
     BASIC_FACTORY(MoveTabArgs);
     BASIC_FACTORY(OpenSettingsArgs);
     BASIC_FACTORY(FindMatchArgs);
+    BASIC_FACTORY(ScrollToMarkArgs);
+    BASIC_FACTORY(SelectOutputArgs);
+    BASIC_FACTORY(ExportBufferArgs);
     BASIC_FACTORY(NewWindowArgs);
     BASIC_FACTORY(FocusPaneArgs);
     BASIC_FACTORY(PrevTabArgs);
@@ -315,6 +315,13 @@ namespace winrt::Microsoft::Terminal::Settings::Model::implementation
 
         _KeyBindingMapCache = single_threaded_map(std::move(keyBindingsMap));
         _GlobalHotkeysCache = single_threaded_map(std::move(globalHotkeys));
+
+        // The key bindings are refreshed once the settings are loaded,
+        // so this is a good time to build the key chord lookup table too.
+        if (!_ResolvedKeyMapCache)
+        {
+            _PopulateResolvedKeyMap(_ResolvedKeyMapCache.emplace());
+        }
     }
 
     // Method Description:
@@ -366,6 +373,28 @@ namespace winrt::Microsoft::Terminal::Settings::Model::implementation
         }
     }
 
+    // Method Description:
+    // - Populates the provided resolvedKeyMap with the command that every key chord in
+    //    our layer and our parents' layers resolves to, the same way _GetActionByKeyChordInternal does.
+    // - This needs to be a bottom up approach, as the innermost layer binding a key chord wins.
+    // Arguments:
+    // - resolvedKeyMap: the map we're populating. Explicitly unbound key chords map to nullptr.
+    void ActionMap::_PopulateResolvedKeyMap(std::unordered_map<Control::KeyChord, Model::Command, KeyChordHash, KeyChordEquality>& resolvedKeyMap) const
+    {
+        for (const auto& [keys, actionID] : _KeyMap)
+        {
+            // This _cannot_ be nullopt because KeyMap can only map to
+            //   actions in this layer.
+            resolvedKeyMap.try_emplace(keys, _GetActionByID(actionID).value());
+        }
+
+        assert(_parents.size() <= 1);
+        for (const auto& parent : _parents)
+        {
+            parent->_PopulateResolvedKeyMap(resolvedKeyMap);
+        }
+    }
+
     com_ptr<ActionMap> ActionMap::Copy() const
     {
         auto actionMap{ make_self<ActionMap>() };
@@ -426,6 +455,7 @@ namespace winrt::Microsoft::Terminal::Settings::Model::implementation
         _NameMapCache = nullptr;
         _GlobalHotkeysCache = nullptr;
         _KeyBindingMapCache = nullptr;
+        _ResolvedKeyMapCache.reset();
 
         // Handle nested commands
         const auto cmdImpl{ get_self<Command>(cmd) };
@@ -623,7 +653,7 @@ namespace winrt::Microsoft::Terminal::Settings::Model::implementation
             const auto conflictingCmdImpl{ get_self<implementation::Command>(conflictingCmd) };
             conflictingCmdImpl->EraseKey(keys);
         }
-        else if (const auto& conflictingCmd{ GetActionByKeyChord(keys) })
+        else if (const auto& conflictingCmd{ _GetActionByKeyChordInternal(keys).value_or(nullptr) })
         {
             // Collision with ancestor: The key chord was already in use, but by an action in another layer
             //
@@ -688,12 +718,12 @@ namespace winrt::Microsoft::Terminal::Settings::Model::implementation
     // Return value:
     // - true if the keychord is explicitly unbound
     // - false if either the keychord is bound, or not bound at all
-    bool ActionMap::IsKeyChordExplicitlyUnbound(Control::KeyChord const& keys) const
+    bool ActionMap::IsKeyChordExplicitlyUnbound(Control::KeyChord const& keys)
     {
-        // We use the fact that the ..Internal call returns nullptr for explicitly unbound
+        // We use the fact that the lookup returns nullptr for explicitly unbound
         // key chords, and nullopt for keychord that are not bound - it allows us to distinguish
         // between unbound and lack of binding.
-        return _GetActionByKeyChordInternal(keys) == nullptr;
+        return _GetResolvedActionByKeyChord(keys) == nullptr;
     }
 
     // Method Description:
@@ -703,9 +733,32 @@ namespace winrt::Microsoft::Terminal::Settings::Model::implementation
     // Return Value:
     // - the command with the given key chord
     // - nullptr if the key chord doesn't exist
-    Model::Command ActionMap::GetActionByKeyChord(Control::KeyChord const& keys) const
+    Model::Command ActionMap::GetActionByKeyChord(Control::KeyChord const& keys)
+    {
+        return _GetResolvedActionByKeyChord(keys).value_or(nullptr);
+    }
+
+    // Method Description:
+    // - Retrieves the assigned command with the given key chord from _ResolvedKeyMapCache,
+    //   building it first if needed. This is called for every key the user presses.
+    // Arguments:
+    // - keys: the key chord of the command to search for
+    // Return Value:
+    // - the command with the given key chord
+    // - nullptr if the key chord is explicitly unbound
+    // - nullopt if it isn't bound in any layer
+    std::optional<Model::Command> ActionMap::_GetResolvedActionByKeyChord(const Control::KeyChord& keys)
     {
-        return _GetActionByKeyChordInternal(keys).value_or(nullptr);
+        if (!_ResolvedKeyMapCache)
+        {
+            _PopulateResolvedKeyMap(_ResolvedKeyMapCache.emplace());
+        }
+
+        if (const auto it = _ResolvedKeyMapCache->find(keys); it != _ResolvedKeyMapCache->end())
+        {
+            return it->second;
+        }
+        return std::nullopt;
     }
 
     // Method Description:
@@ -58,8 +58,8 @@ namespace winrt::Microsoft::Terminal::Settings::Model::implementation
         com_ptr<ActionMap> Copy() const;
 
         // queries
-        Model::Command GetActionByKeyChord(Control::KeyChord const& keys) const;
-        bool IsKeyChordExplicitlyUnbound(Control::KeyChord const& keys) const;
+        Model::Command GetActionByKeyChord(Control::KeyChord const& keys);
+        bool IsKeyChordExplicitlyUnbound(Control::KeyChord const& keys);
         Control::KeyChord GetKeyBindingForAction(ShortcutAction const& action) const;
         Control::KeyChord GetKeyBindingForAction(ShortcutAction const& action, IActionArgs const& actionArgs) const;
 
@@ -79,12 +79,14 @@ namespace winrt::Microsoft::Terminal::Settings::Model::implementation
     private:
         std::optional<Model::Command> _GetActionByID(const InternalActionID actionID) const;
         std::optional<Model::Command> _GetActionByKeyChordInternal(const Control::KeyChord& keys) const;
+        std::optional<Model::Command> _GetResolvedActionByKeyChord(const Control::KeyChord& keys);
 
         void _RefreshKeyBindingCaches();
         void _PopulateAvailableActionsWithStandardCommands(std::unordered_map<hstring, Model::ActionAndArgs>& availableActions, std::unordered_set<InternalActionID>& visitedActionIDs) const;
         void _PopulateNameMapWithSpecialCommands(std::unordered_map<hstring, Model::Command>& nameMap) const;
         void _PopulateNameMapWithStandardCommands(std::unordered_map<hstring, Model::Command>& nameMap) const;
         void _PopulateKeyBindingMapWithStandardCommands(std::unordered_map<Control::KeyChord, Model::Command, KeyChordHash, KeyChordEquality>& keyBindingsMap, std::unordered_set<Control::KeyChord, KeyChordHash, KeyChordEquality>& unboundKeys) const;
+        void _PopulateResolvedKeyMap(std::unordered_map<Control::KeyChord, Model::Command, KeyChordHash, KeyChordEquality>& resolvedKeyMap) const;
         std::vector<Model::Command> _GetCumulativeActions() const noexcept;
 
         void _TryUpdateActionMap(const Model::Command& cmd, Model::Command& oldCmd, Model::Command& consolidatedCmd);
@@ -96,6 +98,11 @@ namespace winrt::Microsoft::Terminal::Settings::Model::implementation
         Windows::Foundation::Collections::IMap<Control::KeyChord, Model::Command> _GlobalHotkeysCache{ nullptr };
         Windows::Foundation::Collections::IMap<Control::KeyChord, Model::Command> _KeyBindingMapCache{ nullptr };
 
+        // The effective command of every key chord bound in this layer or its parents,
+        // with explicitly unbound key chords mapping to nullptr. Looking up a key
+        // chord is a single probe, however many layers there are.
+        std::optional<std::unordered_map<Control::KeyChord, Model::Command, KeyChordHash, KeyChordEquality>> _ResolvedKeyMapCache;
+
         std::unordered_map<winrt::hstring, Model::Command> _NestedCommands;
         std::vector<Model::Command> _IterableCommands;
         std::unordered_map<Control::KeyChord, InternalActionID, KeyChordHash, KeyChordEquality> _KeyMap;
@@ -53,6 +53,7 @@
     ON_ALL_ACTIONS(SwapPane)               \
     ON_ALL_ACTIONS(Find)                   \
     ON_ALL_ACTIONS(ToggleShaderEffects)    \
+    ON_ALL_ACTIONS(ToggleFrameStatistics)  \
     ON_ALL_ACTIONS(ToggleFocusMode)        \
     ON_ALL_ACTIONS(ToggleFullscreen)       \
     ON_ALL_ACTIONS(ToggleAlwaysOnTop)      \
@@ -70,7 +71,12 @@
     ON_ALL_ACTIONS(MoveTab)                \
     ON_ALL_ACTIONS(BreakIntoDebugger)      \
     ON_ALL_ACTIONS(TogglePaneReadOnly)     \
+    ON_ALL_ACTIONS(ToggleBroadcastInput)   \
     ON_ALL_ACTIONS(FindMatch)              \
+    ON_ALL_ACTIONS(FindInAllTabs)          \
+    ON_ALL_ACTIONS(ScrollToMark)           \
+    ON_ALL_ACTIONS(SelectOutput)           \
+    ON_ALL_ACTIONS(ExportBuffer)           \
     ON_ALL_ACTIONS(NewWindow)              \
     ON_ALL_ACTIONS(IdentifyWindow)         \
     ON_ALL_ACTIONS(IdentifyWindows)        \
@@ -87,6 +93,7 @@
     ON_ALL_ACTIONS_WITH_ARGS(CloseTab)             \
     ON_ALL_ACTIONS_WITH_ARGS(CopyText)             \
     ON_ALL_ACTIONS_WITH_ARGS(ExecuteCommandline)   \
+    ON_ALL_ACTIONS_WITH_ARGS(ExportBuffer)         \
     ON_ALL_ACTIONS_WITH_ARGS(FindMatch)            \
     ON_ALL_ACTIONS_WITH_ARGS(GlobalSummon)         \
     ON_ALL_ACTIONS_WITH_ARGS(MoveFocus)            \
@@ -102,7 +109,9 @@
     ON_ALL_ACTIONS_WITH_ARGS(RenameWindow)         \
     ON_ALL_ACTIONS_WITH_ARGS(ResizePane)           \
     ON_ALL_ACTIONS_WITH_ARGS(ScrollDown)           \
+    ON_ALL_ACTIONS_WITH_ARGS(ScrollToMark)         \
     ON_ALL_ACTIONS_WITH_ARGS(ScrollUp)             \
+    ON_ALL_ACTIONS_WITH_ARGS(SelectOutput)         \
     ON_ALL_ACTIONS_WITH_ARGS(SendInput)            \
     ON_ALL_ACTIONS_WITH_ARGS(SetColorScheme)       \
     ON_ALL_ACTIONS_WITH_ARGS(SetTabColor)          \
@@ -55,6 +55,49 @@ namespace Microsoft::Terminal::Settings::Model::JsonUtils
             return fmt::format("{}[]", ConversionTrait<GUID>{}.TypeDescription());
         }
     };
+
+    // This trait exists in order to serialize the std::vector for WslDistributions.
+    template<typename T>
+    struct ConversionTrait<std::vector<T>>
+    {
+        std::vector<T> FromJson(const Json::Value& json) const
+        {
+            ConversionTrait<T> trait;
+            std::vector<T> val;
+            val.reserve(json.size());
+
+            for (const auto& element : json)
+            {
+                val.emplace_back(trait.FromJson(element));
+            }
+
+            return val;
+        }
+
+        bool CanConvert(const Json::Value& json) const
+        {
+            ConversionTrait<T> trait;
+            return json.isArray() && std::all_of(json.begin(), json.end(), [trait](const auto& json) -> bool { return trait.CanConvert(json); });
+        }
+
+        Json::Value ToJson(const std::vector<T>& val)
+        {
+            ConversionTrait<T> trait;
+            Json::Value json{ Json::arrayValue };
+
+            for (const auto& element : val)
+            {
+                json.append(trait.ToJson(element));
+            }
+
+            return json;
+        }
+
+        std::string TypeDescription() const
+        {
+            return fmt::format("{}[]", ConversionTrait<T>{}.TypeDescription());
+        }
+    };
 }
 
 using namespace ::Microsoft::Terminal::Settings::Model;
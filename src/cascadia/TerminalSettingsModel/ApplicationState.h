@@ -21,8 +21,11 @@ Abstract:
 // This macro generates all getters and setters for ApplicationState.
 // It provides X with the following arguments:
 //   (type, function name, JSON key, ...variadic construction arguments)
-#define MTSM_APPLICATION_STATE_FIELDS(X) \
-    X(std::unordered_set<winrt::guid>, GeneratedProfiles, "generatedProfiles")
+#define MTSM_APPLICATION_STATE_FIELDS(X)                                              \
+    X(std::unordered_set<winrt::guid>, GeneratedProfiles, "generatedProfiles")        \
+    X(std::wstring, WslDistributionsCacheKey, "wslDistributionsCacheKey")             \
+    X(std::vector<std::wstring>, WslDistributions, "wslDistributions")                \
+    X(winrt::hstring, JumplistKey, "jumplistKey")
 
 namespace winrt::Microsoft::Terminal::Settings::Model::implementation
 {
@@ -82,6 +82,7 @@ winrt::Microsoft::Terminal::Settings::Model::CascadiaSettings CascadiaSettings::
     settings->_currentDefaultTerminal = _currentDefaultTerminal;
 
     _CopyProfileInheritanceTree(settings);
+    settings->_ResolveInheritance();
 
     return *settings;
 }
@@ -132,6 +133,41 @@ void CascadiaSettings::_CopyProfileInheritanceTree(winrt::com_ptr<CascadiaSettin
     }
 }
 
+// Method Description:
+// - Flattens the inheritance graphs of the globals and of every profile, along
+//   with the font and appearance objects the profiles own. Getting a setting
+//   then walks a flat list of ancestors, instead of recursing through the
+//   parents of each of them. This needs to happen once the inheritance graphs
+//   are complete. Should any of them be changed later, the getters fall back
+//   to recursing through the parents again.
+// Arguments:
+// - <none>
+// Return Value:
+// - <none>
+void CascadiaSettings::_ResolveInheritance()
+{
+    _globals->ResolveInheritance();
+
+    const auto resolveProfile = [](Profile& profile) {
+        profile.ResolveInheritance();
+        winrt::get_self<FontConfig>(profile.FontInfo())->ResolveInheritance();
+        winrt::get_self<AppearanceConfig>(profile.DefaultAppearance())->ResolveInheritance();
+        if (const auto unfocusedAppearance{ profile.UnfocusedAppearance() })
+        {
+            winrt::get_self<AppearanceConfig>(unfocusedAppearance)->ResolveInheritance();
+        }
+    };
+
+    if (_userDefaultProfileSettings)
+    {
+        resolveProfile(*_userDefaultProfileSettings);
+    }
+    for (const auto& profile : _allProfiles)
+    {
+        resolveProfile(*winrt::get_self<Profile>(profile));
+    }
+}
+
 // Method Description:
 // - Finds a profile that matches the given GUID. If there is no profile in this
 //      settings object that matches, returns nullptr.
@@ -321,6 +357,7 @@ winrt::Microsoft::Terminal::Settings::Model::Profile CascadiaSettings::Duplicate
     DUPLICATE_SETTING_MACRO(Padding);
     DUPLICATE_SETTING_MACRO(Commandline);
     DUPLICATE_SETTING_MACRO(StartingDirectory);
+    DUPLICATE_SETTING_MACRO(SessionLogDirectory);
     DUPLICATE_SETTING_MACRO(AntialiasingMode);
     DUPLICATE_SETTING_MACRO(ForceFullRepaintRendering);
     DUPLICATE_SETTING_MACRO(SoftwareRendering);
@@ -475,6 +512,10 @@ void CascadiaSettings::_ValidateSettings()
     _ValidateColorSchemesInCommands();
 
     _ValidateNoGlobalsKey();
+
+    // The inheritance graphs are complete now, so
+    // they can be flattened for the getters.
+    _ResolveInheritance();
 }
 
 // Method Description:
@@ -594,7 +635,7 @@ void CascadiaSettings::_ReorderProfilesToMatchUserSettingsOrder()
     std::deque<winrt::guid> guidOrder;
 
     auto collectGuids = [&](const auto& json) {
-        for (auto profileJson : _GetProfilesJsonObject(json))
+        for (const auto& profileJson : _GetProfilesJsonObject(json))
         {
             if (profileJson.isObject())
             {
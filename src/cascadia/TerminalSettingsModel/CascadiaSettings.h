@@ -128,7 +128,7 @@ namespace winrt::Microsoft::Terminal::Settings::Model::implementation
         winrt::com_ptr<implementation::Profile> _FindMatchingProfile(const Json::Value& profileJson);
         std::optional<uint32_t> _FindMatchingProfileIndex(const Json::Value& profileJson);
         void _LayerOrCreateColorScheme(const Json::Value& schemeJson);
-        Json::Value _ParseUtf8JsonString(std::string_view fileData);
+        static Json::Value _ParseUtf8JsonString(std::string_view fileData);
 
         winrt::com_ptr<implementation::ColorScheme> _FindMatchingColorScheme(const Json::Value& schemeJson);
         void _ParseJsonString(std::string_view fileData, const bool isDefaultSettings);
@@ -138,14 +138,24 @@ namespace winrt::Microsoft::Terminal::Settings::Model::implementation
         bool _AppendDynamicProfilesToUserSettings();
         std::string _ApplyFirstRunChangesToSettingsTemplate(std::string_view settingsTemplate) const;
         void _CopyProfileInheritanceTree(com_ptr<CascadiaSettings>& cloneSettings) const;
+        void _ResolveInheritance();
 
         void _ApplyDefaultsFromUserSettings();
 
         void _LoadDynamicProfiles();
         void _LoadFragmentExtensions();
-        void _ApplyJsonStubsHelper(const std::wstring_view directory, const std::unordered_set<std::wstring>& ignoredNamespaces);
-        std::unordered_set<std::string> _AccumulateJsonFilesInDirectory(const std::wstring_view directory);
-        void _ParseAndLayerFragmentFiles(const std::unordered_set<std::string> files, const winrt::hstring source);
+
+        // A fragment file gets collected first, then parsed (in parallel with the others) and finally layered.
+        struct FragmentFile
+        {
+            winrt::hstring source;
+            std::filesystem::path path;
+            Json::Value json;
+        };
+        static void _ApplyJsonStubsHelper(const std::wstring_view directory, const std::unordered_set<std::wstring>& ignoredNamespaces, std::vector<FragmentFile>& files);
+        static void _AccumulateJsonFilesInDirectory(const std::wstring_view directory, const winrt::hstring& source, std::vector<FragmentFile>& files);
+        static void _ParseFragmentFiles(std::vector<FragmentFile>& files);
+        void _LayerFragmentFiles(std::vector<FragmentFile>& files);
 
         static const std::filesystem::path& _SettingsPath();
         static std::optional<std::string> _ReadUserSettings();
@@ -4,6 +4,7 @@
 #include "pch.h"
 #include "CascadiaSettings.h"
 
+#include <execution>
 #include <fmt/chrono.h>
 #include <shlobj.h>
 
@@ -364,6 +365,9 @@ winrt::Microsoft::Terminal::Settings::Model::CascadiaSettings CascadiaSettings::
 // - Uses the Json::Value _userSettings to check which DPGs should not be run.
 //   If the user settings has any namespaces in the "disabledProfileSources"
 //   property, we'll ensure that any DPGs with a matching namespace _don't_ run.
+// - The generators spend most of their time waiting on something outside of our
+//   process (wsl.exe, the package manager, the file system), so they all run
+//   concurrently. Their profiles are still appended in the order of _profileGenerators.
 // Arguments:
 // - <none>
 // Return Value:
@@ -380,8 +384,32 @@ void CascadiaSettings::_LoadDynamicProfiles()
         }
     }
 
-    for (auto& generator : _profileGenerators)
+    // Activation contexts don't carry over to new threads, but our WinRT classes
+    // might be registered in ours (like they are in our unit tests).
+    HANDLE actCtx = nullptr;
+    if (!GetCurrentActCtx(&actCtx))
     {
+        actCtx = nullptr;
+    }
+    auto releaseActCtx = wil::scope_exit([&]() {
+        if (actCtx)
+        {
+            ReleaseActCtx(actCtx);
+        }
+    });
+
+    std::vector<std::vector<Model::Profile>> results(_profileGenerators.size());
+    std::vector<std::thread> threads;
+    auto joinThreads = wil::scope_exit([&]() {
+        for (auto& thread : threads)
+        {
+            thread.join();
+        }
+    });
+
+    for (size_t i = 0; i < _profileGenerators.size(); ++i)
+    {
+        const auto generator = _profileGenerators[i].get();
         const std::wstring generatorNamespace{ generator->GetNamespace() };
 
         if (ignoredNamespaces.find(generatorNamespace) != ignoredNamespaces.end())
@@ -390,17 +418,39 @@ void CascadiaSettings::_LoadDynamicProfiles()
         }
         else
         {
-            try
-            {
-                auto profiles = generator->GenerateProfiles();
-                for (auto& profile : profiles)
-                {
-                    profile.Source(generatorNamespace);
+            threads.emplace_back([generator, generatorNamespace, actCtx, &result = results[i]]() {
+                ULONG_PTR cookie = 0;
+                const auto activated = actCtx && ActivateActCtx(actCtx, &cookie);
+                auto deactivate = wil::scope_exit([&]() {
+                    if (activated)
+                    {
+                        DeactivateActCtx(0, cookie);
+                    }
+                });
+
+                // Generators may use WinRT APIs (like the PackageManager), which need an apartment.
+                winrt::init_apartment(winrt::apartment_type::multi_threaded);
+                auto uninit = wil::scope_exit([]() { winrt::uninit_apartment(); });
 
-                    _allProfiles.Append(profile);
+                try
+                {
+                    result = generator->GenerateProfiles();
                 }
-            }
-            CATCH_LOG_MSG("Dynamic Profile Namespace: \"%ls\"", generatorNamespace.data());
+                CATCH_LOG_MSG("Dynamic Profile Namespace: \"%ls\"", generatorNamespace.data());
+            });
+        }
+    }
+
+    joinThreads.reset();
+
+    for (size_t i = 0; i < _profileGenerators.size(); ++i)
+    {
+        const std::wstring generatorNamespace{ _profileGenerators[i]->GetNamespace() };
+        for (auto& profile : results[i])
+        {
+            profile.Source(generatorNamespace);
+
+            _allProfiles.Append(profile);
         }
     }
 }
@@ -411,6 +461,8 @@ void CascadiaSettings::_LoadDynamicProfiles()
 //   modify existing profiles or add new color schemes
 // - If the user settings has any namespaces in the "disabledProfileSources"
 //   property, we'll ensure that the corresponding folders do not get searched
+// - All files are collected first and parsed in parallel. They're layered
+//   afterwards, in the order in which they were found.
 void CascadiaSettings::_LoadFragmentExtensions()
 {
     // First, accumulate the namespaces the user wants to ignore
@@ -429,9 +481,10 @@ void CascadiaSettings::_LoadFragmentExtensions()
     THROW_IF_FAILED(SHGetKnownFolderPath(FOLDERID_LocalAppData, 0, nullptr, &localAppDataFolder));
     auto localAppDataFragments = std::wstring(localAppDataFolder.get()) + FragmentsPath.data();
 
+    std::vector<FragmentFile> files;
     if (std::filesystem::exists(localAppDataFragments))
     {
-        _ApplyJsonStubsHelper(localAppDataFragments, ignoredNamespaces);
+        _ApplyJsonStubsHelper(localAppDataFragments, ignoredNamespaces, files);
     }
 
     // Search through the program data folder
@@ -440,7 +493,7 @@ void CascadiaSettings::_LoadFragmentExtensions()
     auto programDataFragments = std::wstring(programDataFolder.get()) + FragmentsPath.data();
     if (std::filesystem::exists(programDataFragments))
     {
-        _ApplyJsonStubsHelper(programDataFragments, ignoredNamespaces);
+        _ApplyJsonStubsHelper(programDataFragments, ignoredNamespaces, files);
     }
 
     // Search through app extensions
@@ -471,22 +524,24 @@ void CascadiaSettings::_LoadFragmentExtensions()
                 // If the directory exists, use the fragments in it
                 if (std::filesystem::exists(path))
                 {
-                    const auto jsonFiles = _AccumulateJsonFilesInDirectory(til::u8u16(path));
-
                     // Provide the package name as the source
-                    _ParseAndLayerFragmentFiles(jsonFiles, ext.Package().Id().FamilyName().c_str());
+                    _AccumulateJsonFilesInDirectory(til::u8u16(path), ext.Package().Id().FamilyName(), files);
                 }
             }
         }
     }
+
+    _ParseFragmentFiles(files);
+    _LayerFragmentFiles(files);
 }
 
 // Method Description:
-// - Helper function to apply json stubs in the local app data folder and the global program data folder
+// - Helper function to collect json stubs in the local app data folder and the global program data folder
 // Arguments:
 // - The directory to find json files in
 // - The set of ignored namespaces
-void CascadiaSettings::_ApplyJsonStubsHelper(const std::wstring_view directory, const std::unordered_set<std::wstring>& ignoredNamespaces)
+// - files: receives the found files
+void CascadiaSettings::_ApplyJsonStubsHelper(const std::wstring_view directory, const std::unordered_set<std::wstring>& ignoredNamespaces, std::vector<FragmentFile>& files)
 {
     // The json files should be within subdirectories where the subdirectory name is the app name
     for (const auto& fragmentExtFolder : std::filesystem::directory_iterator(directory))
@@ -498,8 +553,7 @@ void CascadiaSettings::_ApplyJsonStubsHelper(const std::wstring_view directory,
         // (also make sure this is a directory for sanity)
         if (std::filesystem::is_directory(fragmentExtFolder) && ignoredNamespaces.find(source) == ignoredNamespaces.end())
         {
-            const auto jsonFiles = _AccumulateJsonFilesInDirectory(fragmentExtFolder.path().c_str());
-            _ParseAndLayerFragmentFiles(jsonFiles, winrt::hstring{ source });
+            _AccumulateJsonFilesInDirectory(fragmentExtFolder.path().c_str(), winrt::hstring{ source }, files);
         }
     }
 }
@@ -508,39 +562,63 @@ void CascadiaSettings::_ApplyJsonStubsHelper(const std::wstring_view directory,
 // - Finds all the json files within the given directory
 // Arguments:
 // - directory: the directory to search
-// Return Value:
-// - A set containing all the found file data
-std::unordered_set<std::string> CascadiaSettings::_AccumulateJsonFilesInDirectory(const std::wstring_view directory)
+// - source: the location the files came from
+// - files: receives the found files, sorted by their path
+void CascadiaSettings::_AccumulateJsonFilesInDirectory(const std::wstring_view directory, const winrt::hstring& source, std::vector<FragmentFile>& files)
 {
-    std::unordered_set<std::string> jsonFiles;
+    const auto first = files.size();
 
     for (const auto& fragmentExt : std::filesystem::directory_iterator(directory))
     {
         if (fragmentExt.path().extension() == jsonExtension)
         {
-            try
-            {
-                jsonFiles.emplace(ReadUTF8File(fragmentExt.path()));
-            }
-            CATCH_LOG();
+            files.push_back({ source, fragmentExt.path() });
         }
     }
-    return jsonFiles;
+
+    // The iteration order of a directory is up to the file system. Sort the files
+    // so that they're always layered in the same order, on all file systems.
+    std::sort(files.begin() + first, files.end(), [](const auto& lhs, const auto& rhs) {
+        return lhs.path < rhs.path;
+    });
 }
 
 // Method Description:
-// - Given a set of json files, uses them to modify existing profiles,
+// - Reads and parses all the given files in parallel.
+// - Files that fail to be read or parsed are left with a null json value.
+// Arguments:
+// - files: the files to parse
+void CascadiaSettings::_ParseFragmentFiles(std::vector<FragmentFile>& files)
+{
+    // Any exception escaping a parallel algorithm calls std::terminate(),
+    // so each file has to catch its own.
+    std::for_each(std::execution::par, files.begin(), files.end(), [](FragmentFile& file) {
+        try
+        {
+            // A file could have many new profiles/many profiles it wants to modify/many new color schemes
+            // so we first parse the entire file into one json object
+            file.json = _ParseUtf8JsonString(ReadUTF8File(file.path));
+        }
+        CATCH_LOG();
+    });
+}
+
+// Method Description:
+// - Given a list of parsed json files, uses them to modify existing profiles,
 //   create new profiles, and create new color schemes
 // Arguments:
-// - files: the set of json files (each item in the set is the file data)
-// - source: the location the files came from
-void CascadiaSettings::_ParseAndLayerFragmentFiles(const std::unordered_set<std::string> files, const winrt::hstring source)
+// - files: the json files, as produced by _ParseFragmentFiles
+void CascadiaSettings::_LayerFragmentFiles(std::vector<FragmentFile>& files)
 {
-    for (const auto& file : files)
+    for (auto& file : files)
     {
-        // A file could have many new profiles/many profiles it wants to modify/many new color schemes
-        // so we first parse the entire file into one json object
-        auto fullFile = _ParseUtf8JsonString(file.data());
+        auto& fullFile = file.json;
+        const auto& source = file.source;
+
+        if (!fullFile.isObject())
+        {
+            continue;
+        }
 
         if (fullFile.isMember(JsonKey(ProfilesKey)))
         {
@@ -668,7 +746,12 @@ Json::Value CascadiaSettings::_ParseUtf8JsonString(std::string_view fileData)
     const auto actualDataEnd = fileData.data() + fileData.size();
 
     std::string errs; // This string will receive any error text from failing to parse.
-    std::unique_ptr<Json::CharReader> reader{ Json::CharReaderBuilder::CharReaderBuilder().newCharReader() };
+
+    // Comments are allowed, but we never write them back out, so we don't
+    // need jsoncpp to allocate and attach a copy of each of them to its value.
+    Json::CharReaderBuilder builder;
+    builder.settings_["collectComments"] = false;
+    std::unique_ptr<Json::CharReader> reader{ builder.newCharReader() };
 
     // `parse` will return false if it fails.
     if (!reader->parse(actualDataStart, actualDataEnd, &result, &errs))
@@ -739,7 +822,7 @@ bool CascadiaSettings::_AppendDynamicProfilesToUserSettings()
     wbuilder.settings_["enableYAMLCompatibility"] = true; // suppress spaces around colons
 
     static const auto isInJsonObj = [](const auto& profile, const auto& json) {
-        for (auto profileJson : _GetProfilesJsonObject(json))
+        for (const auto& profileJson : _GetProfilesJsonObject(json))
         {
             if (profileJson.isObject())
             {
@@ -862,9 +945,9 @@ void CascadiaSettings::LayerJson(const Json::Value& json)
     _globals = _globals->CreateChild();
     _globals->LayerJson(json);
 
-    if (auto schemes{ json[SchemesKey.data()] })
+    if (const auto& schemes{ json[SchemesKey.data()] })
     {
-        for (auto schemeJson : schemes)
+        for (const auto& schemeJson : schemes)
         {
             if (schemeJson.isObject())
             {
@@ -873,7 +956,7 @@ void CascadiaSettings::LayerJson(const Json::Value& json)
         }
     }
 
-    for (auto profileJson : _GetProfilesJsonObject(json))
+    for (const auto& profileJson : _GetProfilesJsonObject(json))
     {
         if (profileJson.isObject() && _IsValidProfileObject(profileJson))
         {
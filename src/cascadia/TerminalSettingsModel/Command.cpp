@@ -207,7 +207,7 @@ namespace winrt::Microsoft::Terminal::Settings::Model::implementation
     // - the empty string if we couldn't find a name, otherwise the command's name.
     static std::optional<std::wstring> _nameFromJson(const Json::Value& json)
     {
-        if (const auto name{ json[JsonKey(NameKey)] })
+        if (const auto& name{ json[JsonKey(NameKey)] })
         {
             if (name.isObject())
             {
@@ -260,7 +260,7 @@ namespace winrt::Microsoft::Terminal::Settings::Model::implementation
         // For iterable commands, we'll make another pass at parsing them once
         // the json is patched. So ignore parsing sub-commands for now. Commands
         // will only be marked iterable on the first pass.
-        if (const auto nestedCommandsJson{ json[JsonKey(CommandsKey)] })
+        if (const auto& nestedCommandsJson{ json[JsonKey(CommandsKey)] })
         {
             // Initialize our list of subcommands.
             result->_subcommands = winrt::single_threaded_map<winrt::hstring, Model::Command>();
@@ -292,7 +292,7 @@ namespace winrt::Microsoft::Terminal::Settings::Model::implementation
         // If we're a nested command, we can ignore the current action.
         if (!nested)
         {
-            if (const auto actionJson{ json[JsonKey(ActionKey)] })
+            if (const auto& actionJson{ json[JsonKey(ActionKey)] })
             {
                 result->_ActionAndArgs = *ActionAndArgs::FromJson(actionJson, warnings);
             }
@@ -308,7 +308,7 @@ namespace winrt::Microsoft::Terminal::Settings::Model::implementation
             // GH#4239 - If the user provided more than one key
             // chord to a "keys" array, warn the user here.
             // TODO: GH#1334 - remove this check.
-            const auto keysJson{ json[JsonKey(KeysKey)] };
+            const auto& keysJson{ json[JsonKey(KeysKey)] };
             if (keysJson.isArray() && keysJson.size() > 1)
             {
                 warnings.push_back(SettingsLoadWarnings::TooManyKeysForChord);
@@ -67,7 +67,7 @@ void FontConfig::LayerJson(const Json::Value& json)
     if (json.isMember(JsonKey(FontInfoKey)))
     {
         // A font object is defined, use that
-        const auto fontInfoJson = json[JsonKey(FontInfoKey)];
+        const auto& fontInfoJson = json[JsonKey(FontInfoKey)];
         JsonUtils::GetValueForKey(fontInfoJson, FontFaceKey, _FontFace);
         JsonUtils::GetValueForKey(fontInfoJson, FontSizeKey, _FontSize);
         JsonUtils::GetValueForKey(fontInfoJson, FontWeightKey, _FontWeight);
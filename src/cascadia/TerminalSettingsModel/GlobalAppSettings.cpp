@@ -56,7 +56,14 @@ static constexpr std::string_view DebugFeaturesKey{ "debugFeatures" };
 
 static constexpr std::string_view ForceFullRepaintRenderingKey{ "experimental.rendering.forceFullRepaint" };
 static constexpr std::string_view SoftwareRenderingKey{ "experimental.rendering.software" };
+static constexpr std::string_view GlyphAtlasRenderingKey{ "experimental.rendering.glyphAtlas" };
+static constexpr std::string_view BuiltinGlyphRenderingKey{ "experimental.rendering.builtinGlyphs" };
+static constexpr std::string_view SmoothScrollingKey{ "experimental.rendering.smoothScrolling" };
+static constexpr std::string_view PowerSavingRenderingKey{ "experimental.rendering.powerSaving" };
 static constexpr std::string_view ForceVTInputKey{ "experimental.input.forceVT" };
+static constexpr std::string_view ThreadSchedulingKey{ "experimental.threadScheduling" };
+static constexpr std::string_view PreparedConsolesKey{ "experimental.connection.preparedConsoles" };
+static constexpr std::string_view TabSilenceTimeoutKey{ "experimental.tabSilenceTimeout" };
 static constexpr std::string_view DetectURLsKey{ "experimental.detectURLs" };
 
 #ifdef _DEBUG
@@ -122,7 +129,14 @@ winrt::com_ptr<GlobalAppSettings> GlobalAppSettings::Copy() const
     globals->_SnapToGridOnResize = _SnapToGridOnResize;
     globals->_ForceFullRepaintRendering = _ForceFullRepaintRendering;
     globals->_SoftwareRendering = _SoftwareRendering;
+    globals->_GlyphAtlasRendering = _GlyphAtlasRendering;
+    globals->_BuiltinGlyphRendering = _BuiltinGlyphRendering;
+    globals->_SmoothScrolling = _SmoothScrolling;
+    globals->_PowerSavingRendering = _PowerSavingRendering;
+    globals->_ThreadScheduling = _ThreadScheduling;
     globals->_ForceVTInput = _ForceVTInput;
+    globals->_PreparedConsoles = _PreparedConsoles;
+    globals->_TabSilenceTimeout = _TabSilenceTimeout;
     globals->_DebugFeaturesEnabled = _DebugFeaturesEnabled;
     globals->_StartOnUserLogin = _StartOnUserLogin;
     globals->_AlwaysOnTop = _AlwaysOnTop;
@@ -303,7 +317,14 @@ void GlobalAppSettings::LayerJson(const Json::Value& json)
     JsonUtils::GetValueForKey(json, ForceFullRepaintRenderingKey, _ForceFullRepaintRendering);
 
     JsonUtils::GetValueForKey(json, SoftwareRenderingKey, _SoftwareRendering);
+    JsonUtils::GetValueForKey(json, GlyphAtlasRenderingKey, _GlyphAtlasRendering);
+    JsonUtils::GetValueForKey(json, BuiltinGlyphRenderingKey, _BuiltinGlyphRendering);
+    JsonUtils::GetValueForKey(json, SmoothScrollingKey, _SmoothScrolling);
+    JsonUtils::GetValueForKey(json, PowerSavingRenderingKey, _PowerSavingRendering);
+    JsonUtils::GetValueForKey(json, ThreadSchedulingKey, _ThreadScheduling);
     JsonUtils::GetValueForKey(json, ForceVTInputKey, _ForceVTInput);
+    JsonUtils::GetValueForKey(json, PreparedConsolesKey, _PreparedConsoles);
+    JsonUtils::GetValueForKey(json, TabSilenceTimeoutKey, _TabSilenceTimeout);
 
     JsonUtils::GetValueForKey(json, EnableStartupTaskKey, _StartOnUserLogin);
 
@@ -335,7 +356,7 @@ void GlobalAppSettings::LayerJson(const Json::Value& json)
     // and array of objects. We'll use this twice, once on the legacy
     // `keybindings` key, and again on the newer `bindings` key.
     auto parseBindings = [this, &json](auto jsonKey) {
-        if (auto bindings{ json[JsonKey(jsonKey)] })
+        if (const auto& bindings{ json[JsonKey(jsonKey)] })
         {
             auto warnings = _actionMap->LayerJson(bindings);
 
@@ -417,7 +438,14 @@ Json::Value GlobalAppSettings::ToJson() const
     JsonUtils::SetValueForKey(json, DebugFeaturesKey,               _DebugFeaturesEnabled);
     JsonUtils::SetValueForKey(json, ForceFullRepaintRenderingKey,   _ForceFullRepaintRendering);
     JsonUtils::SetValueForKey(json, SoftwareRenderingKey,           _SoftwareRendering);
+    JsonUtils::SetValueForKey(json, GlyphAtlasRenderingKey,         _GlyphAtlasRendering);
+    JsonUtils::SetValueForKey(json, BuiltinGlyphRenderingKey,       _BuiltinGlyphRendering);
+    JsonUtils::SetValueForKey(json, SmoothScrollingKey,             _SmoothScrolling);
+    JsonUtils::SetValueForKey(json, PowerSavingRenderingKey,        _PowerSavingRendering);
+    JsonUtils::SetValueForKey(json, ThreadSchedulingKey,            _ThreadScheduling);
     JsonUtils::SetValueForKey(json, ForceVTInputKey,                _ForceVTInput);
+    JsonUtils::SetValueForKey(json, PreparedConsolesKey,            _PreparedConsoles);
+    JsonUtils::SetValueForKey(json, TabSilenceTimeoutKey,           _TabSilenceTimeout);
     JsonUtils::SetValueForKey(json, EnableStartupTaskKey,           _StartOnUserLogin);
     JsonUtils::SetValueForKey(json, AlwaysOnTopKey,                 _AlwaysOnTop);
     JsonUtils::SetValueForKey(json, TabSwitcherModeKey,             _TabSwitcherMode);
@@ -88,7 +88,14 @@ namespace winrt::Microsoft::Terminal::Settings::Model::implementation
         INHERITABLE_SETTING(Model::GlobalAppSettings, bool, SnapToGridOnResize, true);
         INHERITABLE_SETTING(Model::GlobalAppSettings, bool, ForceFullRepaintRendering, false);
         INHERITABLE_SETTING(Model::GlobalAppSettings, bool, SoftwareRendering, false);
+        INHERITABLE_SETTING(Model::GlobalAppSettings, bool, GlyphAtlasRendering, false);
+        INHERITABLE_SETTING(Model::GlobalAppSettings, bool, BuiltinGlyphRendering, false);
+        INHERITABLE_SETTING(Model::GlobalAppSettings, bool, SmoothScrolling, false);
+        INHERITABLE_SETTING(Model::GlobalAppSettings, bool, PowerSavingRendering, true);
+        INHERITABLE_SETTING(Model::GlobalAppSettings, winrt::Microsoft::Terminal::Control::ThreadSchedulingPolicy, ThreadScheduling, winrt::Microsoft::Terminal::Control::ThreadSchedulingPolicy::Responsive);
         INHERITABLE_SETTING(Model::GlobalAppSettings, bool, ForceVTInput, false);
+        INHERITABLE_SETTING(Model::GlobalAppSettings, int32_t, PreparedConsoles, 0);
+        INHERITABLE_SETTING(Model::GlobalAppSettings, int32_t, TabSilenceTimeout, 0);
         INHERITABLE_SETTING(Model::GlobalAppSettings, bool, DebugFeaturesEnabled, _getDefaultDebugFeaturesValue());
         INHERITABLE_SETTING(Model::GlobalAppSettings, bool, StartOnUserLogin, false);
         INHERITABLE_SETTING(Model::GlobalAppSettings, bool, AlwaysOnTop, false);
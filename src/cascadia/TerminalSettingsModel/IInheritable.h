@@ -44,17 +44,20 @@ namespace winrt::Microsoft::Terminal::Settings::Model::implementation
         void ClearParents()
         {
             _parents.clear();
+            _InvalidateLineages();
         }
 
         void InsertParent(com_ptr<T> parent)
         {
             _parents.push_back(parent);
+            _InvalidateLineages();
         }
 
         void InsertParent(size_t index, com_ptr<T> parent)
         {
             auto pos{ _parents.begin() + index };
             _parents.insert(pos, parent);
+            _InvalidateLineages();
         }
 
         const std::vector<com_ptr<T>>& Parents()
@@ -62,9 +65,35 @@ namespace winrt::Microsoft::Terminal::Settings::Model::implementation
             return _parents;
         }
 
+        // Method Description:
+        // - Flattens the inheritance graph above this instance into a list of all
+        //   of its ancestors, in the order in which the getters look for a value.
+        //   From then on, the getters walk that list instead of recursing through
+        //   the parents of every ancestor for every value they return.
+        // - Any later change to any inheritance graph invalidates the list, and the
+        //   getters go back to walking the parents, until this is called again.
+        // Arguments:
+        // - <none>
+        // Return Value:
+        // - <none>
+        void ResolveInheritance()
+        {
+            std::vector<const T*> lineage;
+            _AppendLineage(lineage);
+            _lineage = std::move(lineage);
+            _lineageGeneration = s_generation.load(std::memory_order_relaxed);
+        }
+
     protected:
         std::vector<com_ptr<T>> _parents{};
 
+        // Returns the ancestors that ResolveInheritance() found,
+        // or nullptr if the inheritance graph changed since it was called.
+        const std::vector<const T*>* _ResolvedLineage() const noexcept
+        {
+            return _lineageGeneration == s_generation.load(std::memory_order_relaxed) ? &_lineage : nullptr;
+        }
+
         // Method Description:
         // - Actions to be performed after a child was created. Generally used to set
         //   any extraneous data from the parent into the child.
@@ -73,6 +102,36 @@ namespace winrt::Microsoft::Terminal::Settings::Model::implementation
         // Return Value:
         // - <none>
         virtual void _FinalizeInheritance() {}
+
+    private:
+        // This is the same order in which the getters recurse through the parents:
+        // depth first, parents before grandparents. An ancestor that's reachable
+        // through more than one parent is only listed the first time it's found,
+        // since it had no value to offer the first time around either.
+        void _AppendLineage(std::vector<const T*>& lineage) const
+        {
+            for (const auto& parent : _parents)
+            {
+                const T* ancestor{ parent.get() };
+                if (std::find(lineage.begin(), lineage.end(), ancestor) == lineage.end())
+                {
+                    lineage.emplace_back(ancestor);
+                    parent->_AppendLineage(lineage);
+                }
+            }
+        }
+
+        static void _InvalidateLineages() noexcept
+        {
+            s_generation.fetch_add(1, std::memory_order_relaxed);
+        }
+
+        // Bumped whenever any instance of T changes its parents. A lineage is only
+        // valid as long as the generation it was resolved in is the current one.
+        static inline std::atomic<uint64_t> s_generation{ 1 };
+
+        std::vector<const T*> _lineage;
+        uint64_t _lineageGeneration{ 0 };
     };
 
     // This is like std::optional, but we can use it in inheritance to determine whether the user explicitly cleared it
@@ -101,6 +160,17 @@ public:                                                                     \
     {                                                                       \
         /*user set value was not set*/                                      \
         /*iterate through parents to find one with a value*/                \
+        if (const auto lineage{ _ResolvedLineage() })                       \
+        {                                                                   \
+            for (const auto ancestor : *lineage)                            \
+            {                                                               \
+                if (ancestor->_##name)                                      \
+                {                                                           \
+                    return *ancestor;                                       \
+                }                                                           \
+            }                                                               \
+            return nullptr;                                                 \
+        }                                                                   \
         for (auto& parent : _parents)                                       \
         {                                                                   \
             if (auto source{ parent->_get##name##OverrideSourceImpl() })    \
@@ -145,6 +215,17 @@ private:                                                                    \
                                                                             \
         /*user set value was not set*/                                      \
         /*iterate through parents to find a value*/                         \
+        if (const auto lineage{ _ResolvedLineage() })                       \
+        {                                                                   \
+            for (const auto ancestor : *lineage)                            \
+            {                                                               \
+                if (ancestor->_##name)                                      \
+                {                                                           \
+                    return ancestor->_##name;                               \
+                }                                                           \
+            }                                                               \
+            return std::nullopt;                                            \
+        }                                                                   \
         for (const auto& parent : _parents)                                 \
         {                                                                   \
             if (auto val{ parent->_get##name##Impl() })                     \
@@ -166,6 +247,17 @@ private:                                                                    \
                                                                             \
         /*user set value was not set*/                                      \
         /*iterate through parents to find one with a value*/                \
+        if (const auto lineage{ _ResolvedLineage() })                       \
+        {                                                                   \
+            for (const auto ancestor : *lineage)                            \
+            {                                                               \
+                if (ancestor->_##name)                                      \
+                {                                                           \
+                    return *ancestor;                                       \
+                }                                                           \
+            }                                                               \
+            return nullptr;                                                 \
+        }                                                                   \
         for (const auto& parent : _parents)                                 \
         {                                                                   \
             if (auto source{ parent->_get##name##OverrideSourceImpl() })    \
@@ -194,6 +286,17 @@ public:                                                                     \
     {                                                                       \
         /*user set value was not set*/                                      \
         /*iterate through parents to find one with a value*/                \
+        if (const auto lineage{ _ResolvedLineage() })                       \
+        {                                                                   \
+            for (const auto ancestor : *lineage)                            \
+            {                                                               \
+                if (ancestor->_##name)                                      \
+                {                                                           \
+                    return *ancestor;                                       \
+                }                                                           \
+            }                                                               \
+            return nullptr;                                                 \
+        }                                                                   \
         for (const auto& parent : _parents)                                 \
         {                                                                   \
             if (auto source{ parent->_get##name##OverrideSourceImpl() })    \
@@ -254,6 +357,17 @@ private:                                                                    \
                                                                             \
         /*user set value was not set*/                                      \
         /*iterate through parents to find a value*/                         \
+        if (const auto lineage{ _ResolvedLineage() })                       \
+        {                                                                   \
+            for (const auto ancestor : *lineage)                            \
+            {                                                               \
+                if (ancestor->_##name)                                      \
+                {                                                           \
+                    return ancestor->_##name;                               \
+                }                                                           \
+            }                                                               \
+            return std::nullopt;                                            \
+        }                                                                   \
         for (const auto& parent : _parents)                                 \
         {                                                                   \
             if (auto val{ parent->_get##name##Impl() })                     \
@@ -275,6 +389,17 @@ private:                                                                    \
                                                                             \
         /*user set value was not set*/                                      \
         /*iterate through parents to find one with a value*/                \
+        if (const auto lineage{ _ResolvedLineage() })                       \
+        {                                                                   \
+            for (const auto ancestor : *lineage)                            \
+            {                                                               \
+                if (ancestor->_##name)                                      \
+                {                                                           \
+                    return *ancestor;                                       \
+                }                                                           \
+            }                                                               \
+            return nullptr;                                                 \
+        }                                                                   \
         for (const auto& parent : _parents)                                 \
         {                                                                   \
             if (auto source{ parent->_get##name##OverrideSourceImpl() })    \
@@ -42,6 +42,7 @@ static constexpr std::string_view ScrollbarStateKey{ "scrollbarState" };
 static constexpr std::string_view CloseOnExitKey{ "closeOnExit" };
 static constexpr std::string_view PaddingKey{ "padding" };
 static constexpr std::string_view StartingDirectoryKey{ "startingDirectory" };
+static constexpr std::string_view SessionLogDirectoryKey{ "experimental.connection.sessionLogDirectory" };
 static constexpr std::string_view IconKey{ "icon" };
 static constexpr std::string_view AntialiasingModeKey{ "antialiasingMode" };
 static constexpr std::string_view TabColorKey{ "tabColor" };
@@ -99,6 +100,7 @@ winrt::com_ptr<Profile> Profile::CopySettings(winrt::com_ptr<Profile> source)
     profile->_Padding = source->_Padding;
     profile->_Commandline = source->_Commandline;
     profile->_StartingDirectory = source->_StartingDirectory;
+    profile->_SessionLogDirectory = source->_SessionLogDirectory;
     profile->_AntialiasingMode = source->_AntialiasingMode;
     profile->_ForceFullRepaintRendering = source->_ForceFullRepaintRendering;
     profile->_SoftwareRendering = source->_SoftwareRendering;
@@ -367,6 +369,7 @@ void Profile::LayerJson(const Json::Value& json)
     JsonUtils::GetValueForKey(json, ScrollbarStateKey, _ScrollState);
 
     JsonUtils::GetValueForKey(json, StartingDirectoryKey, _StartingDirectory);
+    JsonUtils::GetValueForKey(json, SessionLogDirectoryKey, _SessionLogDirectory);
 
     JsonUtils::GetValueForKey(json, IconKey, _Icon);
     JsonUtils::GetValueForKey(json, AntialiasingModeKey, _AntialiasingMode);
@@ -557,6 +560,7 @@ Json::Value Profile::ToJson() const
 
     JsonUtils::SetValueForKey(json, ScrollbarStateKey, _ScrollState);
     JsonUtils::SetValueForKey(json, StartingDirectoryKey, _StartingDirectory);
+    JsonUtils::SetValueForKey(json, SessionLogDirectoryKey, _SessionLogDirectory);
     JsonUtils::SetValueForKey(json, IconKey, _Icon);
     JsonUtils::SetValueForKey(json, AntialiasingModeKey, _AntialiasingMode);
     JsonUtils::SetValueForKey(json, TabColorKey, _TabColor);
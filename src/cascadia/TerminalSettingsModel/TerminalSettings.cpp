@@ -326,6 +326,11 @@ namespace winrt::Microsoft::Terminal::Settings::Model::implementation
         _FocusFollowMouse = globalSettings.FocusFollowMouse();
         _ForceFullRepaintRendering = globalSettings.ForceFullRepaintRendering();
         _SoftwareRendering = globalSettings.SoftwareRendering();
+        _GlyphAtlasRendering = globalSettings.GlyphAtlasRendering();
+        _BuiltinGlyphRendering = globalSettings.BuiltinGlyphRendering();
+        _SmoothScrolling = globalSettings.SmoothScrolling();
+        _PowerSavingRendering = globalSettings.PowerSavingRendering();
+        _ThreadScheduling = globalSettings.ThreadScheduling();
         _ForceVTInput = globalSettings.ForceVTInput();
         _TrimBlockSelection = globalSettings.TrimBlockSelection();
         _DetectURLs = globalSettings.DetectURLs();
@@ -366,6 +371,67 @@ namespace winrt::Microsoft::Terminal::Settings::Model::implementation
         }
     }
 
+    template<typename T>
+    static bool _settingEquals(const T& lhs, const T& rhs)
+    {
+        return lhs == rhs;
+    }
+
+    // IReferences and maps are created anew for every TerminalSettings, so we compare their contents.
+    template<typename T>
+    static bool _settingEquals(const Windows::Foundation::IReference<T>& lhs, const Windows::Foundation::IReference<T>& rhs)
+    {
+        if (!lhs || !rhs)
+        {
+            return !lhs && !rhs;
+        }
+        return lhs.Value() == rhs.Value();
+    }
+
+    template<typename K, typename V>
+    static bool _settingEquals(const Windows::Foundation::Collections::IMap<K, V>& lhs, const Windows::Foundation::Collections::IMap<K, V>& rhs)
+    {
+        if (!lhs || !rhs)
+        {
+            return !lhs && !rhs;
+        }
+        if (lhs.Size() != rhs.Size())
+        {
+            return false;
+        }
+        for (const auto& kv : lhs)
+        {
+            if (!rhs.HasKey(kv.Key()) || rhs.Lookup(kv.Key()) != kv.Value())
+            {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    // Method Description:
+    // - Compares the resolved value of every setting (including the inherited
+    //   ones) with the one in the given TerminalSettings.
+    // - This allows a settings reload to skip the controls whose settings didn't change.
+    // Arguments:
+    // - other: the TerminalSettings to compare with
+    // Return Value:
+    // - true if a control would behave the same with either of them
+    bool TerminalSettings::IsEquivalentTo(const Model::TerminalSettings& other)
+    {
+        const auto otherImpl = get_self<TerminalSettings>(other);
+
+#define MTSM_TERMINAL_SETTINGS_GEN(type, name, ...)     \
+    if (!_settingEquals(name(), otherImpl->name())) \
+    {                                               \
+        return false;                               \
+    }
+        MTSM_TERMINAL_SETTINGS_FIELDS(MTSM_TERMINAL_SETTINGS_GEN)
+#undef MTSM_TERMINAL_SETTINGS_GEN
+
+        return ColorTable() == otherImpl->ColorTable();
+    }
+
     winrt::Microsoft::Terminal::Core::Color TerminalSettings::GetColorTableEntry(int32_t index) noexcept
     {
         return ColorTable().at(index);
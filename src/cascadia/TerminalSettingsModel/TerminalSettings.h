@@ -24,6 +24,76 @@ Author(s):
 using IFontAxesMap = winrt::Windows::Foundation::Collections::IMap<winrt::hstring, float>;
 using IFontFeatureMap = winrt::Windows::Foundation::Collections::IMap<winrt::hstring, uint32_t>;
 
+// This macro generates all the inheritable settings of TerminalSettings.
+// It provides X with the following arguments:
+//   (type, function name, ...variadic default value)
+//
+// The Core settings (defined in ICoreSettings) come first, up to IntenseIsBright.
+// The remaining ones are defined in IControlSettings.
+//
+// StartingTabColor allows to create a terminal with a "sticky" tab color.
+// This color is prioritized above the TabColor (that is usually initialized based on profile settings).
+// Due to this prioritization, the tab color will be preserved upon settings reload
+// (even if the profile's tab color gets altered or removed).
+// This property is expected to be passed only once upon terminal creation.
+// TODO: to ensure that this property is not populated during settings reload,
+// we should consider moving this property to a separate interface,
+// passed to the terminal only upon creation.
+#define MTSM_TERMINAL_SETTINGS_FIELDS(X)                                                                                                         \
+    X(til::color, DefaultForeground, DEFAULT_FOREGROUND)                                                                                         \
+    X(til::color, DefaultBackground, DEFAULT_BACKGROUND)                                                                                         \
+    X(til::color, SelectionBackground, DEFAULT_FOREGROUND)                                                                                       \
+    X(int32_t, HistorySize, DEFAULT_HISTORY_SIZE)                                                                                                \
+    X(int32_t, InitialRows, 30)                                                                                                                  \
+    X(int32_t, InitialCols, 80)                                                                                                                  \
+    X(bool, SnapOnInput, true)                                                                                                                   \
+    X(bool, AltGrAliasing, true)                                                                                                                 \
+    X(til::color, CursorColor, DEFAULT_CURSOR_COLOR)                                                                                             \
+    X(Microsoft::Terminal::Core::CursorStyle, CursorShape, Core::CursorStyle::Vintage)                                                           \
+    X(uint32_t, CursorHeight, DEFAULT_CURSOR_HEIGHT)                                                                                             \
+    X(hstring, WordDelimiters, DEFAULT_WORD_DELIMITERS)                                                                                          \
+    X(bool, CopyOnSelect, false)                                                                                                                 \
+    X(bool, InputServiceWarning, true)                                                                                                           \
+    X(bool, FocusFollowMouse, false)                                                                                                             \
+    X(bool, TrimBlockSelection, false)                                                                                                           \
+    X(bool, DetectURLs, true)                                                                                                                    \
+    X(Windows::Foundation::IReference<Microsoft::Terminal::Core::Color>, TabColor, nullptr)                                                      \
+    X(Windows::Foundation::IReference<Microsoft::Terminal::Core::Color>, StartingTabColor, nullptr)                                              \
+    X(bool, IntenseIsBright)                                                                                                                     \
+    X(hstring, ProfileName)                                                                                                                      \
+    X(bool, UseAcrylic, false)                                                                                                                   \
+    X(double, TintOpacity, 0.5)                                                                                                                  \
+    X(hstring, Padding, DEFAULT_PADDING)                                                                                                         \
+    X(hstring, FontFace, DEFAULT_FONT_FACE)                                                                                                      \
+    X(int32_t, FontSize, DEFAULT_FONT_SIZE)                                                                                                      \
+    X(winrt::Windows::UI::Text::FontWeight, FontWeight)                                                                                          \
+    X(IFontAxesMap, FontAxes)                                                                                                                    \
+    X(IFontFeatureMap, FontFeatures)                                                                                                             \
+    X(hstring, BackgroundImage)                                                                                                                  \
+    X(double, BackgroundImageOpacity, 1.0)                                                                                                       \
+    X(winrt::Windows::UI::Xaml::Media::Stretch, BackgroundImageStretchMode, winrt::Windows::UI::Xaml::Media::Stretch::UniformToFill)             \
+    X(winrt::Windows::UI::Xaml::HorizontalAlignment, BackgroundImageHorizontalAlignment, winrt::Windows::UI::Xaml::HorizontalAlignment::Center)  \
+    X(winrt::Windows::UI::Xaml::VerticalAlignment, BackgroundImageVerticalAlignment, winrt::Windows::UI::Xaml::VerticalAlignment::Center)        \
+    X(Microsoft::Terminal::Control::IKeyBindings, KeyBindings, nullptr)                                                                          \
+    X(hstring, Commandline)                                                                                                                      \
+    X(hstring, StartingDirectory)                                                                                                                \
+    X(hstring, StartingTitle)                                                                                                                    \
+    X(bool, SuppressApplicationTitle)                                                                                                            \
+    X(hstring, EnvironmentVariables)                                                                                                             \
+    X(Microsoft::Terminal::Control::ScrollbarState, ScrollState, Microsoft::Terminal::Control::ScrollbarState::Visible)                          \
+    X(Microsoft::Terminal::Control::TextAntialiasingMode, AntialiasingMode, Microsoft::Terminal::Control::TextAntialiasingMode::Grayscale)       \
+    X(bool, RetroTerminalEffect, false)                                                                                                          \
+    X(bool, ForceFullRepaintRendering, false)                                                                                                    \
+    X(bool, SoftwareRendering, false)                                                                                                            \
+    X(bool, GlyphAtlasRendering, false)                                                                                                          \
+    X(bool, BuiltinGlyphRendering, false)                                                                                                        \
+    X(bool, SmoothScrolling, false)                                                                                                              \
+    X(bool, PowerSavingRendering, true)                                                                                                          \
+    X(Microsoft::Terminal::Control::ThreadSchedulingPolicy, ThreadScheduling, Microsoft::Terminal::Control::ThreadSchedulingPolicy::Responsive)  \
+    X(bool, ForceVTInput, false)                                                                                                                 \
+    X(hstring, PixelShaderPath)                                                                                                                  \
+    X(bool, IntenseIsBold)
+
 // fwdecl unittest classes
 namespace SettingsModelLocalTests
 {
@@ -75,6 +145,7 @@ namespace winrt::Microsoft::Terminal::Settings::Model::implementation
         void SetParent(const Model::TerminalSettings& parent);
 
         void ApplyColorScheme(const Model::ColorScheme& scheme);
+        bool IsEquivalentTo(const Model::TerminalSettings& other);
 
         // --------------------------- Core Settings ---------------------------
         //  All of these settings are defined in ICoreSettings.
@@ -85,78 +156,9 @@ namespace winrt::Microsoft::Terminal::Settings::Model::implementation
         void ColorTable(std::array<Microsoft::Terminal::Core::Color, 16> colors);
         std::array<Microsoft::Terminal::Core::Color, 16> ColorTable();
 
-        INHERITABLE_SETTING(Model::TerminalSettings, til::color, DefaultForeground, DEFAULT_FOREGROUND);
-        INHERITABLE_SETTING(Model::TerminalSettings, til::color, DefaultBackground, DEFAULT_BACKGROUND);
-        INHERITABLE_SETTING(Model::TerminalSettings, til::color, SelectionBackground, DEFAULT_FOREGROUND);
-        INHERITABLE_SETTING(Model::TerminalSettings, int32_t, HistorySize, DEFAULT_HISTORY_SIZE);
-        INHERITABLE_SETTING(Model::TerminalSettings, int32_t, InitialRows, 30);
-        INHERITABLE_SETTING(Model::TerminalSettings, int32_t, InitialCols, 80);
-
-        INHERITABLE_SETTING(Model::TerminalSettings, bool, SnapOnInput, true);
-        INHERITABLE_SETTING(Model::TerminalSettings, bool, AltGrAliasing, true);
-        INHERITABLE_SETTING(Model::TerminalSettings, til::color, CursorColor, DEFAULT_CURSOR_COLOR);
-        INHERITABLE_SETTING(Model::TerminalSettings, Microsoft::Terminal::Core::CursorStyle, CursorShape, Core::CursorStyle::Vintage);
-        INHERITABLE_SETTING(Model::TerminalSettings, uint32_t, CursorHeight, DEFAULT_CURSOR_HEIGHT);
-        INHERITABLE_SETTING(Model::TerminalSettings, hstring, WordDelimiters, DEFAULT_WORD_DELIMITERS);
-        INHERITABLE_SETTING(Model::TerminalSettings, bool, CopyOnSelect, false);
-        INHERITABLE_SETTING(Model::TerminalSettings, bool, InputServiceWarning, true);
-        INHERITABLE_SETTING(Model::TerminalSettings, bool, FocusFollowMouse, false);
-        INHERITABLE_SETTING(Model::TerminalSettings, bool, TrimBlockSelection, false);
-        INHERITABLE_SETTING(Model::TerminalSettings, bool, DetectURLs, true);
-
-        INHERITABLE_SETTING(Model::TerminalSettings, Windows::Foundation::IReference<Microsoft::Terminal::Core::Color>, TabColor, nullptr);
-
-        // When set, StartingTabColor allows to create a terminal with a "sticky" tab color.
-        // This color is prioritized above the TabColor (that is usually initialized based on profile settings).
-        // Due to this prioritization, the tab color will be preserved upon settings reload
-        // (even if the profile's tab color gets altered or removed).
-        // This property is expected to be passed only once upon terminal creation.
-        // TODO: to ensure that this property is not populated during settings reload,
-        // we should consider moving this property to a separate interface,
-        // passed to the terminal only upon creation.
-        INHERITABLE_SETTING(Model::TerminalSettings, Windows::Foundation::IReference<Microsoft::Terminal::Core::Color>, StartingTabColor, nullptr);
-
-        INHERITABLE_SETTING(Model::TerminalSettings, bool, IntenseIsBright);
-
-        // ------------------------ End of Core Settings -----------------------
-
-        INHERITABLE_SETTING(Model::TerminalSettings, hstring, ProfileName);
-        INHERITABLE_SETTING(Model::TerminalSettings, bool, UseAcrylic, false);
-        INHERITABLE_SETTING(Model::TerminalSettings, double, TintOpacity, 0.5);
-        INHERITABLE_SETTING(Model::TerminalSettings, hstring, Padding, DEFAULT_PADDING);
-        INHERITABLE_SETTING(Model::TerminalSettings, hstring, FontFace, DEFAULT_FONT_FACE);
-        INHERITABLE_SETTING(Model::TerminalSettings, int32_t, FontSize, DEFAULT_FONT_SIZE);
-
-        INHERITABLE_SETTING(Model::TerminalSettings, winrt::Windows::UI::Text::FontWeight, FontWeight);
-        INHERITABLE_SETTING(Model::TerminalSettings, IFontAxesMap, FontAxes);
-        INHERITABLE_SETTING(Model::TerminalSettings, IFontFeatureMap, FontFeatures);
-
-        INHERITABLE_SETTING(Model::TerminalSettings, hstring, BackgroundImage);
-        INHERITABLE_SETTING(Model::TerminalSettings, double, BackgroundImageOpacity, 1.0);
-
-        INHERITABLE_SETTING(Model::TerminalSettings, winrt::Windows::UI::Xaml::Media::Stretch, BackgroundImageStretchMode, winrt::Windows::UI::Xaml::Media::Stretch::UniformToFill);
-        INHERITABLE_SETTING(Model::TerminalSettings, winrt::Windows::UI::Xaml::HorizontalAlignment, BackgroundImageHorizontalAlignment, winrt::Windows::UI::Xaml::HorizontalAlignment::Center);
-        INHERITABLE_SETTING(Model::TerminalSettings, winrt::Windows::UI::Xaml::VerticalAlignment, BackgroundImageVerticalAlignment, winrt::Windows::UI::Xaml::VerticalAlignment::Center);
-
-        INHERITABLE_SETTING(Model::TerminalSettings, Microsoft::Terminal::Control::IKeyBindings, KeyBindings, nullptr);
-
-        INHERITABLE_SETTING(Model::TerminalSettings, hstring, Commandline);
-        INHERITABLE_SETTING(Model::TerminalSettings, hstring, StartingDirectory);
-        INHERITABLE_SETTING(Model::TerminalSettings, hstring, StartingTitle);
-        INHERITABLE_SETTING(Model::TerminalSettings, bool, SuppressApplicationTitle);
-        INHERITABLE_SETTING(Model::TerminalSettings, hstring, EnvironmentVariables);
-
-        INHERITABLE_SETTING(Model::TerminalSettings, Microsoft::Terminal::Control::ScrollbarState, ScrollState, Microsoft::Terminal::Control::ScrollbarState::Visible);
-
-        INHERITABLE_SETTING(Model::TerminalSettings, Microsoft::Terminal::Control::TextAntialiasingMode, AntialiasingMode, Microsoft::Terminal::Control::TextAntialiasingMode::Grayscale);
-
-        INHERITABLE_SETTING(Model::TerminalSettings, bool, RetroTerminalEffect, false);
-        INHERITABLE_SETTING(Model::TerminalSettings, bool, ForceFullRepaintRendering, false);
-        INHERITABLE_SETTING(Model::TerminalSettings, bool, SoftwareRendering, false);
-        INHERITABLE_SETTING(Model::TerminalSettings, bool, ForceVTInput, false);
-
-        INHERITABLE_SETTING(Model::TerminalSettings, hstring, PixelShaderPath);
-        INHERITABLE_SETTING(Model::TerminalSettings, bool, IntenseIsBold);
+#define MTSM_TERMINAL_SETTINGS_GEN(type, name, ...) INHERITABLE_SETTING(Model::TerminalSettings, type, name, __VA_ARGS__);
+        MTSM_TERMINAL_SETTINGS_FIELDS(MTSM_TERMINAL_SETTINGS_GEN)
+#undef MTSM_TERMINAL_SETTINGS_GEN
 
     private:
         std::optional<std::array<Microsoft::Terminal::Core::Color, COLOR_TABLE_SIZE>> _ColorTable;
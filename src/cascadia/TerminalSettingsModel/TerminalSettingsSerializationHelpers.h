@@ -104,6 +104,15 @@ JSON_ENUM_MAPPER(::winrt::Microsoft::Terminal::Control::TextAntialiasingMode)
     };
 };
 
+JSON_ENUM_MAPPER(::winrt::Microsoft::Terminal::Control::ThreadSchedulingPolicy)
+{
+    static constexpr std::array<pair_type, 3> mappings = {
+        pair_type{ "none", ValueType::None },
+        pair_type{ "efficient", ValueType::Efficient },
+        pair_type{ "responsive", ValueType::Responsive }
+    };
+};
+
 // Type Description:
 // - Helper for converting a user-specified closeOnExit value to its corresponding enum
 JSON_ENUM_MAPPER(::winrt::Microsoft::Terminal::Settings::Model::CloseOnExitMode)
@@ -444,6 +453,23 @@ JSON_ENUM_MAPPER(::winrt::Microsoft::Terminal::Settings::Model::FindMatchDirecti
     };
 };
 
+JSON_ENUM_MAPPER(::winrt::Microsoft::Terminal::Settings::Model::ScrollToMarkDirection)
+{
+    JSON_MAPPINGS(2) = {
+        pair_type{ "next", ValueType::Next },
+        pair_type{ "prev", ValueType::Previous },
+    };
+};
+
+JSON_ENUM_MAPPER(::winrt::Microsoft::Terminal::Control::ExportFormat)
+{
+    JSON_MAPPINGS(3) = {
+        pair_type{ "text", ValueType::Text },
+        pair_type{ "vt", ValueType::Vt },
+        pair_type{ "html", ValueType::Html },
+    };
+};
+
 JSON_ENUM_MAPPER(::winrt::Microsoft::Terminal::Settings::Model::WindowingMode)
 {
     JSON_MAPPINGS(3) = {
@@ -12,8 +12,10 @@
 #include <io.h>
 #include <fcntl.h>
 #include "DefaultProfileUtils.h"
+#include "ApplicationState.h"
 
 static constexpr std::wstring_view DockerDistributionPrefix{ L"docker-desktop" };
+static constexpr std::wstring_view LxssKeyPath{ L"Software\\Microsoft\\Windows\\CurrentVersion\\Lxss" };
 
 using namespace ::Microsoft::Terminal::Settings::Model;
 using namespace winrt::Microsoft::Terminal::Settings::Model;
@@ -29,15 +31,15 @@ std::wstring_view WslDistroGenerator::GetNamespace()
     return WslGeneratorNamespace;
 }
 
-// Method Description:
-// -  Enumerates all the installed WSL distros to create profiles for them.
+// Function Description:
+// - Runs `wsl.exe --list` and collects the names of the installed distros.
 // Arguments:
 // - <none>
 // Return Value:
-// - a vector with all distros for all the installed WSL distros
-std::vector<Profile> WslDistroGenerator::GenerateProfiles()
+// - the names of all user-facing distros, or nullopt if wsl.exe failed or timed out
+static std::optional<std::vector<std::wstring>> _enumerateDistros()
 {
-    std::vector<Profile> profiles;
+    std::vector<std::wstring> names;
 
     wil::unique_handle readPipe;
     wil::unique_handle writePipe;
@@ -70,7 +72,7 @@ std::vector<Profile> WslDistroGenerator::GenerateProfiles()
         break;
     case WAIT_ABANDONED:
     case WAIT_TIMEOUT:
-        return profiles;
+        return std::nullopt;
     case WAIT_FAILED:
         THROW_LAST_ERROR();
     default:
@@ -83,7 +85,7 @@ std::vector<Profile> WslDistroGenerator::GenerateProfiles()
     }
     else if (exitCode != 0)
     {
-        return profiles;
+        return std::nullopt;
     }
     DWORD bytesAvailable;
     THROW_IF_WIN32_BOOL_FALSE(PeekNamedPipe(readPipe.get(), nullptr, NULL, nullptr, &bytesAvailable, nullptr));
@@ -124,15 +126,91 @@ std::vector<Profile> WslDistroGenerator::GenerateProfiles()
             {
                 distName.resize(firstChar);
             }
-            auto WSLDistro{ CreateDefaultProfile(distName) };
+            names.emplace_back(std::move(distName));
+        }
+    }
+
+    return names;
+}
+
+// Function Description:
+// - Builds a string that changes whenever a WSL distro is registered, unregistered or
+//   modified, out of the last write times of the Lxss registry key and its subkeys.
+// Arguments:
+// - <none>
+// Return Value:
+// - the cache key, or an empty string if WSL doesn't appear to be set up for this user
+static std::wstring _getDistrosCacheKey()
+{
+    wil::unique_hkey lxss;
+    if (RegOpenKeyExW(HKEY_CURRENT_USER, LxssKeyPath.data(), 0, KEY_READ, &lxss) != ERROR_SUCCESS)
+    {
+        return {};
+    }
+
+    DWORD subKeyCount = 0;
+    FILETIME lastWriteTime{};
+    if (RegQueryInfoKeyW(lxss.get(), nullptr, nullptr, nullptr, &subKeyCount, nullptr, nullptr, nullptr, nullptr, nullptr, nullptr, &lastWriteTime) != ERROR_SUCCESS)
+    {
+        return {};
+    }
+
+    auto key = fmt::format(L"{:08x}{:08x}", lastWriteTime.dwHighDateTime, lastWriteTime.dwLowDateTime);
+    for (DWORD i = 0; i < subKeyCount; ++i)
+    {
+        wchar_t name[MAX_PATH];
+        DWORD nameLength = ARRAYSIZE(name);
+        if (RegEnumKeyExW(lxss.get(), i, &name[0], &nameLength, nullptr, nullptr, nullptr, &lastWriteTime) != ERROR_SUCCESS)
+        {
+            return {};
+        }
+        key += fmt::format(L"-{:08x}{:08x}", lastWriteTime.dwHighDateTime, lastWriteTime.dwLowDateTime);
+    }
+
+    return key;
+}
+
+// Method Description:
+// -  Enumerates all the installed WSL distros to create profiles for them.
+// - Running wsl.exe takes a significant part of our startup time, so the names
+//   of the distros are cached in the ApplicationState. The cache is only used
+//   as long as the Lxss registry key (see _getDistrosCacheKey) is unchanged.
+// Arguments:
+// - <none>
+// Return Value:
+// - a vector with all distros for all the installed WSL distros
+std::vector<Profile> WslDistroGenerator::GenerateProfiles()
+{
+    const auto state = winrt::get_self<implementation::ApplicationState>(ApplicationState::SharedInstance());
+    const auto cacheKey = _getDistrosCacheKey();
 
-            WSLDistro.Commandline(L"wsl.exe -d " + distName);
-            WSLDistro.DefaultAppearance().ColorSchemeName(L"Campbell");
-            WSLDistro.StartingDirectory(DEFAULT_STARTING_DIRECTORY);
-            WSLDistro.Icon(L"ms-appx:///ProfileIcons/{9acb9455-ca41-5af7-950f-6bca1bc9722f}.png");
-            profiles.emplace_back(WSLDistro);
+    std::vector<std::wstring> names;
+    if (!cacheKey.empty() && state->WslDistributionsCacheKey() == cacheKey)
+    {
+        names = state->WslDistributions();
+    }
+    else if (auto enumerated = _enumerateDistros())
+    {
+        names = std::move(*enumerated);
+        if (!cacheKey.empty())
+        {
+            state->WslDistributions(names);
+            state->WslDistributionsCacheKey(cacheKey);
         }
     }
 
+    std::vector<Profile> profiles;
+    profiles.reserve(names.size());
+    for (const auto& distName : names)
+    {
+        auto WSLDistro{ CreateDefaultProfile(distName) };
+
+        WSLDistro.Commandline(L"wsl.exe -d " + distName);
+        WSLDistro.DefaultAppearance().ColorSchemeName(L"Campbell");
+        WSLDistro.StartingDirectory(DEFAULT_STARTING_DIRECTORY);
+        WSLDistro.Icon(L"ms-appx:///ProfileIcons/{9acb9455-ca41-5af7-950f-6bca1bc9722f}.png");
+        profiles.emplace_back(WSLDistro);
+    }
+
     return profiles;
 }
@@ -32,6 +32,11 @@ namespace ControlUnitTests
 
         TEST_METHOD(TestFontInitializedInCtor);
 
+        TEST_METHOD(TestInputLatencyStages);
+        TEST_METHOD(TestInputLatencyPercentiles);
+        TEST_METHOD(TestStatisticsRates);
+        TEST_METHOD(TestScrollbackBudget);
+
         TEST_CLASS_SETUP(ModuleSetup)
         {
             winrt::init_apartment(winrt::apartment_type::single_threaded);
@@ -202,4 +207,150 @@ namespace ControlUnitTests
         VERIFY_ARE_EQUAL(L"Impact", std::wstring_view{ core->_actualFont.GetFaceName() });
     }
 
+    void ControlCoreTests::TestInputLatencyStages()
+    {
+        using Tracker = Control::implementation::InputLatencyTracker;
+        using Stage = Tracker::Stage;
+        const Tracker::clock::time_point t0{};
+        const auto at = [&](const int ms) { return t0 + std::chrono::milliseconds{ ms }; };
+
+        Tracker tracker;
+        VERIFY_IS_FALSE(tracker.IsPending());
+
+        Log::Comment(L"Stages that are reached out of order are ignored.");
+        tracker.Start(at(1));
+        tracker.Mark(Stage::InputWritten, at(2));
+        tracker.Mark(Stage::InputTranslated, at(3));
+        tracker.Mark(Stage::InputWritten, at(4));
+        tracker.Mark(Stage::InputWritten, at(5));
+        tracker.Mark(Stage::OutputRead, at(6));
+        tracker.Mark(Stage::OutputWritten, at(7));
+        VERIFY_IS_TRUE(tracker.IsPending());
+
+        Log::Comment(L"A frame that started painting before the output was written doesn't contain the echo.");
+        VERIFY_IS_FALSE(tracker.FramePresented(at(6), at(8)).has_value());
+
+        const auto sample = tracker.FramePresented(at(9), at(10));
+        VERIFY_IS_TRUE(sample.has_value());
+        VERIFY_IS_FALSE(tracker.IsPending());
+        const Tracker::Sample expected{ at(1), at(3), at(4), at(6), at(7), at(10) };
+        VERIFY_IS_TRUE(expected == *sample);
+
+        Log::Comment(L"Nothing is measured once the sample is complete.");
+        VERIFY_IS_FALSE(tracker.FramePresented(at(11), at(12)).has_value());
+        VERIFY_ARE_EQUAL(1u, tracker.GetPercentiles().count);
+    }
+
+    void ControlCoreTests::TestInputLatencyPercentiles()
+    {
+        using Tracker = Control::implementation::InputLatencyTracker;
+        using Stage = Tracker::Stage;
+
+        Tracker tracker;
+        VERIFY_ARE_EQUAL(0u, tracker.GetPercentiles().count);
+
+        Log::Comment(L"Record key presses that took 1 to 100ms, in a shuffled order.");
+        for (auto i = 0; i < 100; ++i)
+        {
+            const Tracker::clock::time_point start{ std::chrono::seconds{ i } };
+            const auto latency = std::chrono::milliseconds{ (i * 37) % 100 + 1 };
+            tracker.Start(start);
+            tracker.Mark(Stage::InputTranslated, start);
+            tracker.Mark(Stage::InputWritten, start);
+            tracker.Mark(Stage::OutputRead, start);
+            tracker.Mark(Stage::OutputWritten, start);
+            VERIFY_IS_TRUE(tracker.FramePresented(start, start + latency).has_value());
+        }
+
+        const auto percentiles = tracker.GetPercentiles();
+        VERIFY_ARE_EQUAL(100u, percentiles.count);
+        VERIFY_ARE_EQUAL(50, std::chrono::duration_cast<std::chrono::milliseconds>(percentiles.p50).count());
+        VERIFY_ARE_EQUAL(99, std::chrono::duration_cast<std::chrono::milliseconds>(percentiles.p99).count());
+    }
+
+    void ControlCoreTests::TestStatisticsRates()
+    {
+        using Statistics = Control::implementation::ControlStatistics;
+        const auto t0 = Statistics::clock::now();
+        const auto at = [&](const int ms) { return t0 + std::chrono::milliseconds{ ms }; };
+
+        Statistics statistics;
+        statistics.TakeSnapshot({}, 0, 0, t0);
+
+        statistics.OutputWritten(1000, std::chrono::milliseconds{ 10 }, std::chrono::milliseconds{ 2 }, at(100));
+        statistics.OutputWritten(1000, std::chrono::milliseconds{ 30 }, std::chrono::milliseconds{ 0 }, at(200));
+        VERIFY_ARE_EQUAL(2000u, statistics.OutputLength());
+        VERIFY_IS_TRUE(at(200) == statistics.LastOutputTime());
+
+        VERIFY_IS_FALSE(statistics.IsSnapshotDue(at(500)));
+        VERIFY_IS_TRUE(statistics.IsSnapshotDue(at(2000)));
+
+        Log::Comment(L"The rates are computed from what accumulated since the previous snapshot.");
+        const Render::FrameStatistics frames{ 60, 0, 0.0f, 120'000, 4'000 };
+        const auto snapshot = statistics.TakeSnapshot(frames, 100, 4096, at(2000));
+        VERIFY_ARE_EQUAL(1000.0f, snapshot.outputCharactersPerSecond);
+        VERIFY_ARE_EQUAL(20.0f, snapshot.writeMillisecondsPerSecond);
+        VERIFY_ARE_EQUAL(30.0f, snapshot.framesPerSecond);
+        VERIFY_ARE_EQUAL(2.0f, snapshot.paintMillisecondsPerFrame);
+        VERIFY_ARE_EQUAL(1.0f, snapshot.outputLockWaitMillisecondsPerSecond);
+        VERIFY_ARE_EQUAL(2.0f, snapshot.renderLockWaitMillisecondsPerSecond);
+        VERIFY_ARE_EQUAL(100u, snapshot.scrollbackRows);
+        VERIFY_ARE_EQUAL(4096u, snapshot.bufferBytes);
+        VERIFY_IS_FALSE(snapshot.Format().empty());
+
+        Log::Comment(L"Nothing happened since, so the next snapshot has no activity.");
+        const auto idle = statistics.TakeSnapshot(frames, 100, 4096, at(3000));
+        VERIFY_ARE_EQUAL(0.0f, idle.outputCharactersPerSecond);
+        VERIFY_ARE_EQUAL(0.0f, idle.framesPerSecond);
+        VERIFY_ARE_EQUAL(0.0f, idle.paintMillisecondsPerFrame);
+    }
+
+    void ControlCoreTests::TestScrollbackBudget()
+    {
+        using Budget = Control::implementation::ScrollbackBudget;
+        Budget budget{ 1000 };
+
+        std::vector<std::pair<int, size_t>> trims;
+        const auto trimmer = [&](const int id) {
+            return [&trims, id](const size_t rows) { trims.emplace_back(id, rows); };
+        };
+
+        auto seenFirst = budget.Register(trimmer(1));
+        auto seenLast = budget.Register(trimmer(2));
+        auto visible = budget.Register(trimmer(3));
+        seenFirst->SetVisible(true);
+        seenFirst->SetVisible(false);
+        seenLast->SetVisible(true);
+        seenLast->SetVisible(false);
+        visible->SetVisible(true);
+
+        seenFirst->Update(30, 10, 5);
+        seenLast->Update(30, 10, 5);
+        visible->Update(30, 10, 5);
+        VERIFY_ARE_EQUAL(900u, budget.UsageBytes());
+        VERIFY_IS_TRUE(trims.empty());
+
+        Log::Comment(L"The pane that was seen the longest time ago spills first, down to its minimum.");
+        visible->Update(60, 10, 5);
+        VERIFY_ARE_EQUAL(1u, trims.size());
+        VERIFY_ARE_EQUAL(1, trims[0].first);
+        VERIFY_ARE_EQUAL(10u, trims[0].second);
+        VERIFY_ARE_EQUAL(1000u, budget.UsageBytes());
+
+        Log::Comment(L"Once that one can't spill any more, the next one does.");
+        trims.clear();
+        visible->Update(70, 10, 5);
+        VERIFY_ARE_EQUAL(2u, trims.size());
+        VERIFY_ARE_EQUAL(1, trims[0].first);
+        VERIFY_ARE_EQUAL(5u, trims[0].second);
+        VERIFY_ARE_EQUAL(2, trims[1].first);
+        VERIFY_ARE_EQUAL(25u, trims[1].second);
+        VERIFY_ARE_EQUAL(1000u, budget.UsageBytes());
+
+        Log::Comment(L"Unregistering a pane gives its share back.");
+        trims.clear();
+        seenLast.reset();
+        VERIFY_ARE_EQUAL(750u, budget.UsageBytes());
+        VERIFY_IS_TRUE(trims.empty());
+    }
 }
@@ -31,12 +31,14 @@ namespace ControlUnitTests
         TEST_METHOD(CreateSubsequentSelectionWithDragging);
         TEST_METHOD(ScrollWithSelection);
         TEST_METHOD(TestScrollWithTrackpad);
+        TEST_METHOD(TestSmoothScrollWithTrackpad);
         TEST_METHOD(TestQuickDragOnSelect);
 
         TEST_METHOD(TestDragSelectOutsideBounds);
 
         TEST_METHOD(PointerClickOutsideActiveRegion);
         TEST_METHOD(IncrementCircularBufferWithSelection);
+        TEST_METHOD(CoalesceMouseMoves);
 
         TEST_CLASS_SETUP(ClassSetup)
         {
@@ -518,6 +520,58 @@ namespace ControlUnitTests
         VERIFY_ARE_EQUAL(21, core->ScrollOffset());
     }
 
+    void ControlInteractivityTests::TestSmoothScrollWithTrackpad()
+    {
+        WEX::TestExecution::DisableVerifyExceptions disableVerifyExceptions{};
+
+        auto [settings, conn] = _createSettingsAndConnection();
+        settings->SmoothScrolling(true);
+        auto [core, interactivity] = _createCoreAndInteractivity(*settings, *conn);
+        _standardInit(core, interactivity);
+        // For the sake of this test, scroll one line at a time
+        interactivity->_rowsToScroll = 1;
+
+        for (int i = 0; i < 40; ++i)
+        {
+            conn->WriteInput(L"Foo\r\n");
+        }
+        VERIFY_ARE_EQUAL(21, core->ScrollOffset());
+        VERIFY_ARE_EQUAL(0.0f, core->SubRowScrollOffset());
+
+        const auto modifiers = ControlKeyStates();
+        // A quarter of a row adds up without any rounding errors.
+        const int delta = WHEEL_DELTA / 4;
+        const til::point mousePos{ 0, 0 };
+        Control::MouseButtonState state{};
+        const auto verifyPosition = [&](const int row, const float fraction) {
+            VERIFY_ARE_EQUAL(row, core->ScrollOffset());
+            VERIFY_IS_LESS_THAN(std::abs(fraction - core->SubRowScrollOffset()), 0.001f);
+        };
+
+        Log::Comment(L"Scrolling up by a quarter of a row shows the row above, moved up by the rest");
+        interactivity->MouseWheel(modifiers, delta, mousePos, state); // 1/4
+        verifyPosition(20, 0.75f);
+        interactivity->MouseWheel(modifiers, delta, mousePos, state); // 2/4
+        verifyPosition(20, 0.5f);
+        interactivity->MouseWheel(modifiers, delta, mousePos, state); // 3/4
+        verifyPosition(20, 0.25f);
+
+        Log::Comment(L"Clicks hit the row that's drawn under them");
+        // The font is 21px tall, so the text is moved up by 5px.
+        VERIFY_ARE_EQUAL(til::point(0, 0), interactivity->_getTerminalPosition(til::point{ 0, 15 }));
+        VERIFY_ARE_EQUAL(til::point(0, 1), interactivity->_getTerminalPosition(til::point{ 0, 16 }));
+
+        Log::Comment(L"Scrolling back down past the row boundary moves on to the next row");
+        interactivity->MouseWheel(modifiers, -delta, mousePos, state);
+        interactivity->MouseWheel(modifiers, -delta, mousePos, state);
+        interactivity->MouseWheel(modifiers, -delta, mousePos, state);
+        verifyPosition(21, 0.0f);
+
+        Log::Comment(L"There's nothing below the bottom of the buffer to scroll to");
+        interactivity->MouseWheel(modifiers, -delta, mousePos, state);
+        verifyPosition(21, 0.0f);
+    }
+
     void ControlInteractivityTests::TestQuickDragOnSelect()
     {
         // This is a test for GH#9955.c
@@ -797,4 +851,78 @@ namespace ControlUnitTests
         // Verify that the selection got reset
         VERIFY_IS_FALSE(core->HasSelection());
     }
+
+    void ControlInteractivityTests::CoalesceMouseMoves()
+    {
+        WEX::TestExecution::DisableVerifyExceptions disableVerifyExceptions{};
+
+        auto [settings, conn] = _createSettingsAndConnection();
+        auto [core, interactivity] = _createCoreAndInteractivity(*settings, *conn);
+        _standardInit(core, interactivity);
+
+        // Don't let the frames end on their own, this test decides when they're over.
+        interactivity->_flushPointerUpdates = std::make_shared<ThrottledFuncTrailing<>>(core->Dispatcher(), std::chrono::hours(1), []() {});
+
+        const auto modifiers = ControlKeyStates();
+        const Control::MouseButtonState noMouseDown{};
+        const til::size fontSize{ 9, 21 };
+
+        // Enable VT mouse event tracking
+        conn->WriteInput(L"\x1b[?1003;1006h");
+
+        const auto move = [&](const til::point pixelPosition) {
+            interactivity->PointerMoved(noMouseDown,
+                                        WM_MOUSEMOVE, //pointerUpdateKind
+                                        modifiers,
+                                        true, // focused,
+                                        pixelPosition,
+                                        true);
+        };
+
+        Log::Comment(L"The first move is sent right away");
+        const til::point terminalPosition0{ 4, 4 };
+        move(terminalPosition0 * fontSize);
+        VERIFY_IS_FALSE(interactivity->_pendingMouseMove.has_value());
+        VERIFY_IS_TRUE(interactivity->_lastMouseMove.has_value());
+        VERIFY_ARE_EQUAL(terminalPosition0, interactivity->_lastMouseMove->terminalPosition);
+
+        Log::Comment(L"Moves within the same cell aren't sent at all");
+        interactivity->_lastPointerUpdate = {};
+        move(terminalPosition0 * fontSize + til::point{ 2, 2 });
+        VERIFY_IS_FALSE(interactivity->_pendingMouseMove.has_value());
+        VERIFY_ARE_EQUAL(terminalPosition0, interactivity->_lastMouseMove->terminalPosition);
+
+        Log::Comment(L"Moves within the same frame wait for the end of it, and the latest one wins");
+        interactivity->_lastPointerUpdate = std::chrono::steady_clock::time_point::max();
+        const til::point terminalPosition1{ 10, 4 };
+        const til::point terminalPosition2{ 12, 6 };
+        move(terminalPosition1 * fontSize);
+        move(terminalPosition2 * fontSize);
+        VERIFY_IS_TRUE(interactivity->_pendingMouseMove.has_value());
+        VERIFY_ARE_EQUAL(terminalPosition2, interactivity->_pendingMouseMove->terminalPosition);
+        VERIFY_ARE_EQUAL(terminalPosition0, interactivity->_lastMouseMove->terminalPosition);
+
+        interactivity->_sendPendingPointerUpdates();
+        VERIFY_IS_FALSE(interactivity->_pendingMouseMove.has_value());
+        VERIFY_ARE_EQUAL(terminalPosition2, interactivity->_lastMouseMove->terminalPosition);
+
+        Log::Comment(L"Coming back to the last sent cell before the frame is over cancels the move");
+        interactivity->_lastPointerUpdate = std::chrono::steady_clock::time_point::max();
+        move(terminalPosition1 * fontSize);
+        VERIFY_IS_TRUE(interactivity->_pendingMouseMove.has_value());
+        move(terminalPosition2 * fontSize);
+        VERIFY_IS_FALSE(interactivity->_pendingMouseMove.has_value());
+
+        Log::Comment(L"A click sends the pending move before itself");
+        move(terminalPosition1 * fontSize);
+        VERIFY_IS_TRUE(interactivity->_pendingMouseMove.has_value());
+        const Control::MouseButtonState leftMouseDown{ Control::MouseButtonState::IsLeftButtonDown };
+        interactivity->PointerPressed(leftMouseDown,
+                                      WM_LBUTTONDOWN, //pointerUpdateKind
+                                      0, // timestamp
+                                      modifiers,
+                                      terminalPosition1 * fontSize);
+        VERIFY_IS_FALSE(interactivity->_pendingMouseMove.has_value());
+        VERIFY_IS_FALSE(interactivity->_lastMouseMove.has_value());
+    }
 }
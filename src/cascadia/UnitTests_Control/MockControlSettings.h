@@ -80,6 +80,11 @@ namespace ControlUnitTests
         WINRT_PROPERTY(bool, RetroTerminalEffect, false);
         WINRT_PROPERTY(bool, ForceFullRepaintRendering, false);
         WINRT_PROPERTY(bool, SoftwareRendering, false);
+        WINRT_PROPERTY(bool, GlyphAtlasRendering, false);
+        WINRT_PROPERTY(bool, BuiltinGlyphRendering, false);
+        WINRT_PROPERTY(bool, SmoothScrolling, false);
+        WINRT_PROPERTY(bool, PowerSavingRendering, false);
+        WINRT_PROPERTY(winrt::Microsoft::Terminal::Control::ThreadSchedulingPolicy, ThreadScheduling, winrt::Microsoft::Terminal::Control::ThreadSchedulingPolicy::Responsive);
         WINRT_PROPERTY(bool, ForceVTInput, false);
 
         WINRT_PROPERTY(winrt::hstring, PixelShaderPath);
@@ -81,6 +81,7 @@ namespace RemotingUnitTests
         TYPED_EVENT(SummonRequested, winrt::Windows::Foundation::IInspectable, Remoting::SummonWindowBehavior);
         TYPED_EVENT(ShowTrayIconRequested, winrt::Windows::Foundation::IInspectable, winrt::Windows::Foundation::IInspectable);
         TYPED_EVENT(HideTrayIconRequested, winrt::Windows::Foundation::IInspectable, winrt::Windows::Foundation::IInspectable);
+        TYPED_EVENT(WindowNameChanged, winrt::Windows::Foundation::IInspectable, winrt::Windows::Foundation::IInspectable);
     };
 
     class RemotingTests
@@ -1110,9 +1111,9 @@ namespace RemotingUnitTests
 
     void RemotingTests::LookupNamedPeasantWhenOthersDied()
     {
-        Log::Comment(L"Test that looking for a peasant by name when a different"
-                     L" peasant has died cleans up the corpses of any peasants "
-                     L"we may have tripped over.");
+        Log::Comment(L"Test that once we're told that the process of a peasant"
+                     L" exited, looking for a peasant by name cleans up its "
+                     L"corpse, without tripping over it.");
 
         const auto monarch0PID = 12345u;
         const auto peasant1PID = 23456u;
@@ -1140,17 +1141,15 @@ namespace RemotingUnitTests
         VERIFY_ARE_EQUAL(p2->GetID(), m0->_lookupPeasantIdForName(L"two"));
 
         Log::Comment(L"Kill peasant 1. Make sure that it gets removed from the monarch.");
-        RemotingTests::_killPeasant(m0, p1->GetID());
+        const auto p1ID = p1->GetID();
+        RemotingTests::_killPeasant(m0, p1ID);
+        m0->_peasantExited(p1ID);
 
-        // By killing 1, then looking for "two", we happen to iterate over the
-        // corpse of 1 when looking for the peasant named "two". This causes us
-        // to remove 1 while looking for "two". Technically, we shouldn't be
-        // relying on any sort of ordering for an unordered_map iterator, but
-        // this one just so happens to work.
         VERIFY_ARE_EQUAL(p2->GetID(), m0->_lookupPeasantIdForName(L"two"));
 
-        Log::Comment(L"Peasant 1 should have been pruned");
+        Log::Comment(L"Peasant 1 should have been pruned, and its name is free again");
         VERIFY_ARE_EQUAL(1u, m0->_peasants.size());
+        VERIFY_ARE_EQUAL(0, m0->_lookupPeasantIdForName(L"one"));
     }
 
     void RemotingTests::LookupNamedPeasantWhenItDied()
@@ -1184,8 +1183,12 @@ namespace RemotingUnitTests
         VERIFY_ARE_EQUAL(p2->GetID(), m0->_lookupPeasantIdForName(L"two"));
 
         Log::Comment(L"Kill peasant 1. Make sure that it gets removed from the monarch.");
-        RemotingTests::_killPeasant(m0, p1->GetID());
+        const auto p1ID = p1->GetID();
+        RemotingTests::_killPeasant(m0, p1ID);
 
+        Log::Comment(L"We weren't told that peasant 1 died, so we only find out when we try to use it");
+        VERIFY_ARE_EQUAL(p1ID, m0->_lookupPeasantIdForName(L"one"));
+        VERIFY_IS_TRUE(m0->_getPeasant(p1ID) == nullptr);
         VERIFY_ARE_EQUAL(0, m0->_lookupPeasantIdForName(L"one"));
 
         Log::Comment(L"Peasant 1 should have been pruned");
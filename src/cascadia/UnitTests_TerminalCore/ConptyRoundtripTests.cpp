@@ -218,6 +218,8 @@ class TerminalCoreUnitTests::ConptyRoundtripTests final
 
     TEST_METHOD(ResizeInitializeBufferWithDefaultAttrs);
 
+    TEST_METHOD(AltBufferKeepsTerminalMainBuffer);
+
 private:
     bool _writeCallback(const char* const pch, size_t const cch);
     void _flushFirstFrame();
@@ -2323,7 +2325,6 @@ void ConptyRoundtripTests::BreakLinesOnCursorMovement()
     auto& si = gci.GetActiveOutputBuffer();
     auto& hostSm = si.GetStateMachine();
 
-    auto& termTb = *term->_buffer;
 
     _flushFirstFrame();
 
@@ -2465,7 +2466,8 @@ void ConptyRoundtripTests::BreakLinesOnCursorMovement()
 
     Log::Comment(L"========== Checking the terminal buffer state ==========");
 
-    verifyBuffer(termTb, term->_mutableViewport.ToInclusive());
+    // The Terminal switched to its own alternate buffer too.
+    verifyBuffer(*term->_buffer, term->_mutableViewport.ToInclusive());
 }
 
 void ConptyRoundtripTests::TestCursorInDeferredEOLPositionOnNewLineWithSpaces()
@@ -3675,3 +3677,46 @@ void ConptyRoundtripTests::HyperlinkIdConsistency()
     verifyData(hostTb);
     verifyData(termTb);
 }
+
+void ConptyRoundtripTests::AltBufferKeepsTerminalMainBuffer()
+{
+    Log::Comment(L"Switching to the alt buffer in conpty should switch the Terminal "
+                 L"to its own alt buffer, and leave the contents of its main buffer alone.");
+
+    auto& g = ServiceLocator::LocateGlobals();
+    auto& renderer = *g.pRender;
+    auto& gci = g.getConsoleInformation();
+    auto& si = gci.GetActiveOutputBuffer();
+    auto& hostSm = si.GetStateMachine();
+    auto& termTb = *term->_buffer;
+
+    // We're _not_ checking the conpty output during this test, only the side effects.
+    _checkConptyOutput = false;
+
+    // Lock must be taken to manipulate alt/main buffer state.
+    gci.LockConsole();
+    auto unlock = wil::scope_exit([&] { gci.UnlockConsole(); });
+
+    _flushFirstFrame();
+
+    hostSm.ProcessString(L"AAAAA");
+    VERIFY_SUCCEEDED(renderer.PaintFrame());
+
+    Log::Comment(L"Switching to the alt buffer");
+    hostSm.ProcessString(L"\x1b[?1049h");
+    hostSm.ProcessString(L"BBBBB");
+    VERIFY_SUCCEEDED(renderer.PaintFrame());
+
+    VERIFY_IS_TRUE(term->_InAltBuffer());
+    VERIFY_ARE_NOT_EQUAL(&termTb, term->_buffer.get());
+    TestUtils::VerifyExpectedString(*term->_buffer, L"BBBBB", { 0, 0 });
+    TestUtils::VerifyExpectedString(termTb, L"AAAAA", { 0, 0 });
+
+    Log::Comment(L"Returning to the main buffer.");
+    hostSm.ProcessString(L"\x1b[?1049l");
+    VERIFY_SUCCEEDED(renderer.PaintFrame());
+
+    VERIFY_IS_FALSE(term->_InAltBuffer());
+    VERIFY_ARE_EQUAL(&termTb, term->_buffer.get());
+    TestUtils::VerifyExpectedString(termTb, L"AAAAA", { 0, 0 });
+}
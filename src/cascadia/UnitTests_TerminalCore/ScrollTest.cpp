@@ -45,6 +45,7 @@ namespace
         virtual void TriggerRedraw(const COORD* const){};
         virtual void TriggerRedrawCursor(const COORD* const){};
         virtual void TriggerRedrawAll(){};
+        virtual void TriggerRedrawBlinking(){};
         virtual void TriggerTeardown() noexcept {};
         virtual void TriggerSelection(){};
         virtual void TriggerScroll(){};
@@ -87,18 +88,21 @@ class TerminalCoreUnitTests::ScrollTest final
     TEST_CLASS(ScrollTest);
 
     TEST_METHOD(TestNotifyScrolling);
+    TEST_METHOD(TestWriteNotifiesScrollingOnce);
 
     TEST_METHOD_SETUP(MethodSetup)
     {
         _term = std::make_unique<::Microsoft::Terminal::Core::Terminal>();
 
         _scrollBarNotification = std::make_shared<std::optional<ScrollBarNotification>>();
-        _term->SetScrollPositionChangedCallback([scrollBarNotification = _scrollBarNotification](const int top, const int height, const int bottom) {
+        _scrollBarNotificationCount = std::make_shared<size_t>(0);
+        _term->SetScrollPositionChangedCallback([scrollBarNotification = _scrollBarNotification, count = _scrollBarNotificationCount](const int top, const int height, const int bottom) {
             ScrollBarNotification tmp;
             tmp.ViewportTop = top;
             tmp.ViewportHeight = height;
             tmp.BufferHeight = bottom;
             *scrollBarNotification = { tmp };
+            ++*count;
         });
 
         _renderTarget = std::make_unique<MockScrollRenderTarget>();
@@ -116,6 +120,7 @@ private:
     std::unique_ptr<Terminal> _term;
     std::unique_ptr<MockScrollRenderTarget> _renderTarget;
     std::shared_ptr<std::optional<ScrollBarNotification>> _scrollBarNotification;
+    std::shared_ptr<size_t> _scrollBarNotificationCount;
 };
 
 void ScrollTest::TestNotifyScrolling()
@@ -215,3 +220,30 @@ void ScrollTest::TestNotifyScrolling()
         }
     }
 }
+
+void ScrollTest::TestWriteNotifiesScrollingOnce()
+{
+    Log::Comment(L"Output that scrolls by many lines in a single Write() "
+                 L"should only notify the final scroll position, once.");
+
+    std::wstring output;
+    for (auto i = 0; i < TerminalViewHeight * 3; i++)
+    {
+        output.append(L"X\r\n");
+    }
+
+    _term->Write(output);
+
+    VERIFY_ARE_EQUAL(1u, *_scrollBarNotificationCount);
+    VERIFY_IS_TRUE(_scrollBarNotification->has_value());
+
+    const auto tmp = _scrollBarNotification->value();
+    VERIFY_ARE_EQUAL(TerminalViewHeight * 2 + 1, tmp.ViewportTop);
+    VERIFY_ARE_EQUAL(TerminalViewHeight, tmp.ViewportHeight);
+    VERIFY_ARE_EQUAL(TerminalViewHeight * 3 + 1, tmp.BufferHeight);
+
+    Log::Comment(L"Output that doesn't scroll doesn't notify at all.");
+    *_scrollBarNotificationCount = 0;
+    _term->Write(L"no newline");
+    VERIFY_ARE_EQUAL(0u, *_scrollBarNotificationCount);
+}
@@ -12,6 +12,7 @@
 using namespace winrt::Microsoft::Terminal::Core;
 using namespace Microsoft::Terminal::Core;
 
+using namespace WEX::Common;
 using namespace WEX::Logging;
 using namespace WEX::TestExecution;
 
@@ -34,6 +35,8 @@ namespace TerminalCoreUnitTests
         // PrintString() is called with more code units than the buffer width.
         TEST_METHOD(PrintStringOfSurrogatePairs);
         TEST_METHOD(CheckDoubleWidthCursor);
+        TEST_METHOD(PrintStringWrapsDoubleWidthGlyphs);
+        TEST_METHOD(PrintStringBenchmark);
 
         TEST_METHOD(AddHyperlink);
         TEST_METHOD(AddHyperlinkCustomId);
@@ -259,6 +262,57 @@ void TerminalApiTest::CheckDoubleWidthCursor()
     VERIFY_IS_TRUE(term.IsCursorDoubleWidth());
 }
 
+void TerminalApiTest::PrintStringWrapsDoubleWidthGlyphs()
+{
+    DummyRenderTarget renderTarget;
+    Terminal term;
+    term.Create({ 10, 10 }, 0, renderTarget);
+
+    auto& tbi = *(term._buffer);
+    auto& cursor = tbi.GetCursor();
+
+    // 9 narrow glyphs leave a single cell, which isn't enough for '我'.
+    // It has to go to the next row, followed by the rest of the string.
+    term.PrintString(L"AAAAAAAAA我愛B");
+
+    VERIFY_ARE_EQUAL(L"A", tbi.GetCellDataAt({ 8, 0 })->Chars());
+    VERIFY_IS_TRUE(tbi.GetRowByOffset(0).WasDoubleBytePadded());
+    VERIFY_ARE_EQUAL(L"我", tbi.GetCellDataAt({ 0, 1 })->Chars());
+    VERIFY_ARE_EQUAL(L"愛", tbi.GetCellDataAt({ 2, 1 })->Chars());
+    VERIFY_ARE_EQUAL(L"B", tbi.GetCellDataAt({ 4, 1 })->Chars());
+    VERIFY_ARE_EQUAL(COORD({ 5, 1 }), cursor.GetPosition());
+
+    // Filling a row exactly leaves the cursor past its end, until the next glyph wraps it.
+    cursor.SetPosition({ 0, 2 });
+    term.PrintString(L"0123456789");
+    VERIFY_ARE_EQUAL(COORD({ 10, 2 }), cursor.GetPosition());
+    term.PrintString(L"x");
+    VERIFY_ARE_EQUAL(L"x", tbi.GetCellDataAt({ 0, 3 })->Chars());
+    VERIFY_ARE_EQUAL(COORD({ 1, 3 }), cursor.GetPosition());
+}
+
+void TerminalApiTest::PrintStringBenchmark()
+{
+    // This measures how fast plain text (like the output of `cat`) makes it into the buffer.
+    // The number is logged for comparison only. It isn't verified, as it depends on the machine.
+    DummyRenderTarget renderTarget;
+    Terminal term;
+    term.Create({ 120, 30 }, 9000, renderTarget);
+
+    std::wstring text;
+    while (text.size() < 1024 * 1024)
+    {
+        text.append(L"The quick brown fox jumps over the lazy dog. ");
+    }
+
+    const auto start = std::chrono::steady_clock::now();
+    term.PrintString(text);
+    const auto end = std::chrono::steady_clock::now();
+
+    const auto seconds = std::chrono::duration<double>(end - start).count();
+    Log::Comment(NoThrowString().Format(L"%zu characters in %.1fms (%.1f MB/s)", text.size(), seconds * 1000, text.size() * sizeof(wchar_t) / seconds / 1e6));
+}
+
 void TerminalCoreUnitTests::TerminalApiTest::AddHyperlink()
 {
     // This is a nearly literal copy-paste of ScreenBufferTests::TestAddHyperlink, adapted for the Terminal
@@ -51,6 +51,12 @@ class TerminalCoreUnitTests::TerminalBufferTests final
 
     TEST_METHOD(TestGetReverseTab);
 
+    TEST_METHOD(TestGetPatternIdReusesStorage);
+
+    TEST_METHOD(TestPatternsFollowRowChanges);
+
+    TEST_METHOD(TestPatternSpansSplitWrappedMatches);
+
     TEST_METHOD_SETUP(MethodSetup)
     {
         // STEP 1: Set up the Terminal
@@ -592,3 +598,91 @@ void TerminalBufferTests::TestGetReverseTab()
                          L"Cursor adjusted to last item in the sample list from position beyond end.");
     }
 }
+
+void TerminalBufferTests::TestGetPatternIdReusesStorage()
+{
+    auto& termSm = *term->_stateMachine;
+
+    const auto patternId = term->_buffer->AddPatternRecognizer(LR"(https://[^ ]+)");
+    termSm.ProcessString(L"see https://example.com now");
+    term->UpdatePatternsUnderLock();
+
+    std::vector<size_t> patternIds;
+
+    Log::Comment(L"A cell inside the match should report the pattern");
+    term->GetPatternId({ 10, 0 }, patternIds);
+    VERIFY_ARE_EQUAL(1u, patternIds.size());
+    VERIFY_ARE_EQUAL(patternId, patternIds.front());
+
+    const auto storage = patternIds.data();
+
+    Log::Comment(L"A cell outside of it should clear the previous result");
+    term->GetPatternId({ 0, 0 }, patternIds);
+    VERIFY_IS_TRUE(patternIds.empty());
+
+    Log::Comment(L"Querying again should reuse the vector's storage");
+    term->GetPatternId({ 12, 0 }, patternIds);
+    VERIFY_ARE_EQUAL(1u, patternIds.size());
+    VERIFY_ARE_EQUAL(storage, patternIds.data());
+}
+
+void TerminalBufferTests::TestPatternsFollowRowChanges()
+{
+    auto& termSm = *term->_stateMachine;
+
+    const auto patternId = term->_buffer->AddPatternRecognizer(LR"(https://[^ ]+)");
+    termSm.ProcessString(L"see https://example.com now");
+    term->UpdatePatternsUnderLock();
+
+    std::vector<size_t> patternIds;
+    term->GetPatternId({ 10, 0 }, patternIds);
+    VERIFY_ARE_EQUAL(1u, patternIds.size());
+    VERIFY_ARE_EQUAL(patternId, patternIds.front());
+
+    Log::Comment(L"Updating without any changes to the buffer should find the same patterns");
+    term->UpdatePatternsUnderLock();
+    term->GetPatternId({ 10, 0 }, patternIds);
+    VERIFY_ARE_EQUAL(1u, patternIds.size());
+
+    Log::Comment(L"Overwriting the match should remove it");
+    termSm.ProcessString(L"\x1b[H\x1b[2K");
+    term->UpdatePatternsUnderLock();
+    term->GetPatternId({ 10, 0 }, patternIds);
+    VERIFY_IS_TRUE(patternIds.empty());
+
+    Log::Comment(L"Writing a new match on another row should find it");
+    termSm.ProcessString(L"\r\nhttps://example.org");
+    term->UpdatePatternsUnderLock();
+    term->GetPatternId({ 5, 1 }, patternIds);
+    VERIFY_ARE_EQUAL(1u, patternIds.size());
+    VERIFY_ARE_EQUAL(patternId, patternIds.front());
+}
+
+void TerminalBufferTests::TestPatternSpansSplitWrappedMatches()
+{
+    auto& termSm = *term->_stateMachine;
+
+    const auto patternId = term->_buffer->AddPatternRecognizer(LR"(https://[^ ]+)");
+    termSm.ProcessString(L"\x1b[1;75Hhttps://example.com");
+    term->UpdatePatternsUnderLock();
+
+    Log::Comment(L"A match that wraps is split into a span for every row it's in");
+    const auto first = term->GetPatternSpans(0);
+    VERIFY_ARE_EQUAL(1u, first.size());
+    VERIFY_ARE_EQUAL(74, first[0].start);
+    VERIFY_ARE_EQUAL(TerminalViewWidth, first[0].end);
+    VERIFY_ARE_EQUAL(patternId, first[0].id);
+
+    const auto second = term->GetPatternSpans(1);
+    VERIFY_ARE_EQUAL(1u, second.size());
+    VERIFY_ARE_EQUAL(0, second[0].start);
+    VERIFY_ARE_EQUAL(13, second[0].end);
+
+    Log::Comment(L"Rows without any matches have no spans");
+    VERIFY_IS_TRUE(term->GetPatternSpans(2).empty());
+    VERIFY_IS_TRUE(term->GetPatternSpans(TerminalViewHeight).empty());
+
+    Log::Comment(L"Clearing the patterns clears the spans");
+    term->ClearPatternTree();
+    VERIFY_IS_TRUE(term->GetPatternSpans(0).empty());
+}
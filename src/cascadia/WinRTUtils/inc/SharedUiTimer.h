@@ -0,0 +1,196 @@
+// Copyright (c) Microsoft Corporation.
+// Licensed under the MIT license.
+
+#pragma once
+
+// A SharedUiTimer is a single repeating timer that's shared by all the controls
+// on a UI thread that tick at the same interval, like the cursor and text blink
+// timers of every pane in a window. Instead of one timer per control waking
+// the UI thread independently, all of them are ticked by the same wakeup.
+// The timer only runs while at least one of its clients is running and isn't
+// suspended, for instance because its control can't be seen.
+class SharedUiTimer : public std::enable_shared_from_this<SharedUiTimer>
+{
+public:
+    // One control's use of the timer. Clients are created stopped.
+    class Client
+    {
+    public:
+        using function = std::function<void()>;
+
+        Client(std::shared_ptr<SharedUiTimer> timer, function func) :
+            _timer{ std::move(timer) },
+            _func{ std::move(func) }
+        {
+            _timer->_clients.emplace_back(this);
+        }
+
+        ~Client()
+        {
+            _timer->_Remove(this);
+        }
+
+        Client(const Client&) = delete;
+        Client& operator=(const Client&) = delete;
+        Client(Client&&) = delete;
+        Client& operator=(Client&&) = delete;
+
+        // (Re)starts ticking. Just like restarting a dedicated timer, there's
+        // at least one full interval until the next tick, so that a cursor
+        // that was just shown isn't hidden right away.
+        void Start()
+        {
+            _running = true;
+            _skipNextTick = true;
+            _timer->_Update();
+        }
+
+        void Stop()
+        {
+            _running = false;
+            _timer->_Update();
+        }
+
+        // While a client is suspended, it doesn't tick.
+        void SetSuspended(const bool suspended)
+        {
+            _suspended = suspended;
+            _timer->_Update();
+        }
+
+    private:
+        friend class SharedUiTimer;
+
+        bool _IsActive() const noexcept
+        {
+            return _running && !_suspended;
+        }
+
+        void _Tick()
+        {
+            if (!_IsActive())
+            {
+                return;
+            }
+            if (_skipNextTick)
+            {
+                _skipNextTick = false;
+                return;
+            }
+
+            try
+            {
+                _func();
+            }
+            CATCH_LOG();
+        }
+
+        std::shared_ptr<SharedUiTimer> _timer;
+        function _func;
+        bool _running = false;
+        bool _suspended = false;
+        bool _skipNextTick = false;
+    };
+
+    // Returns the timer with the given interval of the calling UI thread, creating it if needed.
+    static std::shared_ptr<SharedUiTimer> GetForCurrentThread(const std::chrono::milliseconds interval)
+    {
+        thread_local std::vector<std::weak_ptr<SharedUiTimer>> timers;
+
+        for (auto it = timers.begin(); it != timers.end();)
+        {
+            auto timer = it->lock();
+            if (!timer)
+            {
+                it = timers.erase(it);
+                continue;
+            }
+            if (timer->_interval == interval)
+            {
+                return timer;
+            }
+            ++it;
+        }
+
+        auto timer = std::make_shared<SharedUiTimer>(winrt::Windows::System::DispatcherQueue::GetForCurrentThread(), interval);
+        timers.emplace_back(timer);
+        return timer;
+    }
+
+    SharedUiTimer(const winrt::Windows::System::DispatcherQueue& dispatcher, const std::chrono::milliseconds interval) :
+        _timer{ dispatcher.CreateTimer() },
+        _interval{ interval }
+    {
+        _timer.Interval(interval);
+        _timer.IsRepeating(true);
+        _timer.Tick([this](auto&&, auto&&) { _Tick(); });
+    }
+
+    ~SharedUiTimer()
+    {
+        _timer.Stop();
+    }
+
+    SharedUiTimer(const SharedUiTimer&) = delete;
+    SharedUiTimer& operator=(const SharedUiTimer&) = delete;
+    SharedUiTimer(SharedUiTimer&&) = delete;
+    SharedUiTimer& operator=(SharedUiTimer&&) = delete;
+
+private:
+    void _Tick()
+    {
+        // Clients may be removed by the functions they invoke. They're
+        // only nulled out here and dropped once we're done iterating.
+        _ticking = true;
+        for (size_t i = 0; i < _clients.size(); ++i)
+        {
+            if (const auto client = til::at(_clients, i))
+            {
+                client->_Tick();
+            }
+        }
+        _ticking = false;
+
+        _clients.erase(std::remove(_clients.begin(), _clients.end(), nullptr), _clients.end());
+        _Update();
+    }
+
+    void _Remove(Client* client) noexcept
+    {
+        const auto it = std::find(_clients.begin(), _clients.end(), client);
+        if (it != _clients.end())
+        {
+            if (_ticking)
+            {
+                *it = nullptr;
+            }
+            else
+            {
+                _clients.erase(it);
+            }
+        }
+
+        try
+        {
+            _Update();
+        }
+        CATCH_LOG();
+    }
+
+    void _Update()
+    {
+        const auto active = std::any_of(_clients.begin(), _clients.end(), [](const auto client) {
+            return client && client->_IsActive();
+        });
+
+        if (active != _timer.IsRunning())
+        {
+            active ? _timer.Start() : _timer.Stop();
+        }
+    }
+
+    winrt::Windows::System::DispatcherQueueTimer _timer;
+    std::chrono::milliseconds _interval;
+    std::vector<Client*> _clients;
+    bool _ticking = false;
+};
@@ -38,6 +38,7 @@ public:
         }
 
         memcpy(&_delay, &d, sizeof(d));
+        _windowLength = til::details::throttled_func_window_length(delay.count());
     }
 
     // ThrottledFunc uses its `this` pointer when creating _timer.
@@ -90,13 +91,13 @@ private:
                     }
                     CATCH_LOG();
 
-                    SetThreadpoolTimerEx(self->_timer.get(), &self->_delay, 0, 0);
+                    SetThreadpoolTimerEx(self->_timer.get(), &self->_delay, 0, self->_windowLength);
                 }
             });
         }
         else
         {
-            SetThreadpoolTimerEx(_timer.get(), &_delay, 0, 0);
+            SetThreadpoolTimerEx(_timer.get(), &_delay, 0, _windowLength);
         }
     }
 
@@ -129,6 +130,7 @@ private:
     }
 
     FILETIME _delay;
+    DWORD _windowLength;
     winrt::Windows::System::DispatcherQueue _dispatcher;
     function _func;
 
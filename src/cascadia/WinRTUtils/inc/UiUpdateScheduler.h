@@ -0,0 +1,223 @@
+// Copyright (c) Microsoft Corporation.
+// Licensed under the MIT license.
+
+#pragma once
+
+#include "til/throttled_func.h"
+
+// The UiUpdateScheduler batches the UI updates that terminal output triggers,
+// like the scroll bar and TSF updates, for all the controls on a UI thread,
+// and thus in a window. Instead of every control enqueueing dispatcher
+// callbacks of its own, all of their pending updates run in a single callback
+// once per frame. Updates of controls that can't be seen can be suspended.
+// They stay pending and run once the control is visible again.
+class UiUpdateScheduler : public std::enable_shared_from_this<UiUpdateScheduler>
+{
+public:
+    using filetime_duration = std::chrono::duration<int64_t, std::ratio<1, 10000000>>;
+
+    // The same interval that the scroll bar updates used to be throttled to.
+    static constexpr auto FrameInterval = std::chrono::milliseconds(8);
+
+    // One kind of update for one control. See UiUpdate below.
+    class UpdateBase : public std::enable_shared_from_this<UpdateBase>
+    {
+    public:
+        virtual ~UpdateBase() = default;
+
+        UpdateBase(const UpdateBase&) = delete;
+        UpdateBase& operator=(const UpdateBase&) = delete;
+        UpdateBase(UpdateBase&&) = delete;
+        UpdateBase& operator=(UpdateBase&&) = delete;
+
+        // While an update is suspended, Run() only stores the arguments.
+        // The latest ones are used once it's resumed.
+        void SetSuspended(const bool suspended)
+        {
+            _suspended.store(suspended, std::memory_order_relaxed);
+            if (!suspended && _HasPending())
+            {
+                _scheduler->_Enqueue(shared_from_this());
+            }
+        }
+
+    protected:
+        explicit UpdateBase(std::shared_ptr<UiUpdateScheduler> scheduler) :
+            _scheduler{ std::move(scheduler) }
+        {
+        }
+
+        // Called by Run() when the update wasn't pending yet.
+        void _Schedule()
+        {
+            if (!_suspended.load(std::memory_order_relaxed))
+            {
+                _scheduler->_Enqueue(shared_from_this());
+            }
+        }
+
+        virtual bool _HasPending() const = 0;
+        virtual void _Invoke() = 0;
+
+    private:
+        friend class UiUpdateScheduler;
+
+        void _RunIfPending()
+        {
+            if (!_suspended.load(std::memory_order_relaxed) && _HasPending())
+            {
+                try
+                {
+                    _Invoke();
+                }
+                CATCH_LOG();
+            }
+        }
+
+        std::shared_ptr<UiUpdateScheduler> _scheduler;
+        std::atomic<bool> _suspended{ false };
+    };
+
+    // Returns the scheduler of the calling UI thread, creating it if needed.
+    static std::shared_ptr<UiUpdateScheduler> GetForCurrentThread()
+    {
+        thread_local std::weak_ptr<UiUpdateScheduler> current;
+
+        auto scheduler = current.lock();
+        if (!scheduler)
+        {
+            scheduler = std::make_shared<UiUpdateScheduler>(winrt::Windows::System::DispatcherQueue::GetForCurrentThread(), FrameInterval);
+            current = scheduler;
+        }
+        return scheduler;
+    }
+
+    UiUpdateScheduler(winrt::Windows::System::DispatcherQueue dispatcher, filetime_duration delay) :
+        _dispatcher{ std::move(dispatcher) },
+        _timer{ _create_timer() }
+    {
+        const auto d = -delay.count();
+        if (d >= 0)
+        {
+            throw std::invalid_argument("non-positive delay specified");
+        }
+
+        memcpy(&_delay, &d, sizeof(d));
+        _windowLength = til::details::throttled_func_window_length(delay.count());
+    }
+
+    // UiUpdateScheduler uses its `this` pointer when creating _timer.
+    // Since the timer cannot be recreated, instances cannot be moved either.
+    UiUpdateScheduler(const UiUpdateScheduler&) = delete;
+    UiUpdateScheduler& operator=(const UiUpdateScheduler&) = delete;
+    UiUpdateScheduler(UiUpdateScheduler&&) = delete;
+    UiUpdateScheduler& operator=(UiUpdateScheduler&&) = delete;
+
+private:
+    static void __stdcall _timer_callback(PTP_CALLBACK_INSTANCE /*instance*/, PVOID context, PTP_TIMER /*timer*/) noexcept
+    {
+        static_cast<UiUpdateScheduler*>(context)->_EndFrame();
+    }
+
+    void _Enqueue(std::shared_ptr<UpdateBase> update)
+    {
+        std::unique_lock guard{ _lock };
+        _queue.emplace_back(std::move(update));
+        if (!_frameRequested)
+        {
+            _frameRequested = true;
+            SetThreadpoolTimerEx(_timer.get(), &_delay, 0, _windowLength);
+        }
+    }
+
+    void _EndFrame()
+    {
+        _dispatcher.TryEnqueue(winrt::Windows::System::DispatcherQueuePriority::Normal, [weakSelf = weak_from_this()]() {
+            if (auto self{ weakSelf.lock() })
+            {
+                self->_RunFrame();
+            }
+        });
+    }
+
+    void _RunFrame()
+    {
+        {
+            std::unique_lock guard{ _lock };
+            _running.swap(_queue);
+            _frameRequested = false;
+        }
+
+        for (const auto& update : _running)
+        {
+            update->_RunIfPending();
+        }
+        _running.clear();
+    }
+
+    inline wil::unique_threadpool_timer _create_timer()
+    {
+        wil::unique_threadpool_timer timer{ CreateThreadpoolTimer(&_timer_callback, this, nullptr) };
+        THROW_LAST_ERROR_IF(!timer);
+        return timer;
+    }
+
+    FILETIME _delay;
+    DWORD _windowLength;
+    winrt::Windows::System::DispatcherQueue _dispatcher;
+    wil::unique_threadpool_timer _timer;
+
+    std::mutex _lock;
+    std::vector<std::shared_ptr<UpdateBase>> _queue;
+    bool _frameRequested = false;
+
+    // Only touched on the UI thread, and kept around for its capacity.
+    std::vector<std::shared_ptr<UpdateBase>> _running;
+};
+
+// A UiUpdate works like a ThrottledFuncTrailing. The first call to Run()
+// schedules `func` to be invoked at the end of the current frame, and further
+// calls until then only replace the arguments it gets invoked with.
+template<typename... Args>
+class UiUpdate final : public UiUpdateScheduler::UpdateBase
+{
+public:
+    using function = std::function<void(Args...)>;
+
+    UiUpdate(std::shared_ptr<UiUpdateScheduler> scheduler, function func) :
+        UpdateBase{ std::move(scheduler) },
+        _func{ std::move(func) }
+    {
+    }
+
+    template<typename... MakeArgs>
+    void Run(MakeArgs&&... args)
+    {
+        if (!_storage.emplace(std::forward<MakeArgs>(args)...))
+        {
+            _Schedule();
+        }
+    }
+
+    // Modifies the pending arguments for the next function
+    // invocation, if there is one pending currently.
+    template<typename F>
+    void ModifyPending(F func)
+    {
+        _storage.modify_pending(func);
+    }
+
+private:
+    bool _HasPending() const override
+    {
+        return static_cast<bool>(_storage);
+    }
+
+    void _Invoke() override
+    {
+        std::apply(_func, _storage.take());
+    }
+
+    function _func;
+    til::details::throttled_func_storage<Args...> _storage;
+};
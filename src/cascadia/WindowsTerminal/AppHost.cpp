@@ -25,9 +25,9 @@ using namespace ::Microsoft::Console::Types;
 // "If the high-order bit is 1, the key is down; otherwise, it is up."
 static constexpr short KeyPressed{ gsl::narrow_cast<short>(0x8000) };
 
-AppHost::AppHost() noexcept :
+AppHost::AppHost(Remoting::WindowManager windowManager) noexcept :
     _app{},
-    _windowManager{},
+    _windowManager{ std::move(windowManager) },
     _logic{ nullptr }, // don't make one, we're going to take a ref on app's
     _window{ nullptr }
 {
@@ -42,8 +42,10 @@ AppHost::AppHost() noexcept :
     // If there were commandline args to our process, try and process them here.
     // Do this before AppLogic::Create, otherwise this will have no effect.
     //
-    // This will send our commandline to the Monarch, to ask if we should make a
-    // new window or not. If not, exit immediately.
+    // Unless we're the monarch, main already sent our commandline to the
+    // Monarch, to ask if we should make a new window or not. If we're the
+    // monarch, this will send it now. If we shouldn't make a window, exit
+    // immediately.
     _HandleCommandlineArgs();
     if (!_shouldCreateWindow)
     {
@@ -149,8 +151,26 @@ void _buildArgsFromCommandline(std::vector<winrt::hstring>& args)
 }
 
 // Method Description:
-// - Retrieve any commandline args passed on the commandline, and pass them to
-//   the WindowManager, to ask if we should become a window process.
+// - Retrieve the commandline args passed to our process, and the current
+//   directory, as the CommandlineArgs that we hand to the WindowManager.
+// - This doesn't need any of the app, so main can ask the monarch if the
+//   commandline is meant for an existing window, before it loads the app.
+// Arguments:
+// - <none>
+// Return Value:
+// - the commandline args of our process.
+Remoting::CommandlineArgs AppHost::GetCommandlineArgs()
+{
+    std::vector<winrt::hstring> args;
+    _buildArgsFromCommandline(args);
+    std::wstring cwd{ wil::GetCurrentDirectoryW<std::wstring>() };
+
+    return Remoting::CommandlineArgs{ { args }, { cwd } };
+}
+
+// Method Description:
+// - If it wasn't done yet, pass the commandline args to the WindowManager, to
+//   ask if we should become a window process.
 // - If we should create a window, then pass the arguments to the app logic for
 //   processing.
 // - If we shouldn't become a window, set _shouldCreateWindow to false and exit
@@ -167,12 +187,12 @@ void _buildArgsFromCommandline(std::vector<winrt::hstring>& args)
 // - <none>
 void AppHost::_HandleCommandlineArgs()
 {
-    std::vector<winrt::hstring> args;
-    _buildArgsFromCommandline(args);
-    std::wstring cwd{ wil::GetCurrentDirectoryW<std::wstring>() };
-
-    Remoting::CommandlineArgs eventArgs{ { args }, { cwd } };
-    _windowManager.ProposeCommandline(eventArgs);
+    // If we've already got a window, main proposed our commandline before it
+    // created us, and the monarch told us to create a window.
+    if (!_windowManager.CurrentWindow())
+    {
+        _windowManager.ProposeCommandline(GetCommandlineArgs());
+    }
 
     _shouldCreateWindow = _windowManager.ShouldCreateWindow();
     if (!_shouldCreateWindow)
@@ -255,6 +275,10 @@ void AppHost::Initialize()
     // application layer.
     _window->DragRegionClicked([this]() { _logic.TitlebarClicked(); });
 
+    // Let the controls know when the window is being resized interactively,
+    // so they can defer reflowing their buffers until the resize is over.
+    _window->LiveResizeChanged([this](const bool liveResize) { _logic.LiveResizeChanged(liveResize); });
+
     _logic.RequestedThemeChanged({ this, &AppHost::_UpdateTheme });
     _logic.FullscreenChanged({ this, &AppHost::_FullscreenChanged });
     _logic.FocusModeChanged({ this, &AppHost::_FocusModeChanged });
@@ -8,9 +8,11 @@
 class AppHost
 {
 public:
-    AppHost() noexcept;
+    AppHost(winrt::Microsoft::Terminal::Remoting::WindowManager windowManager) noexcept;
     virtual ~AppHost();
 
+    static winrt::Microsoft::Terminal::Remoting::CommandlineArgs GetCommandlineArgs();
+
     void AppTitleChanged(const winrt::Windows::Foundation::IInspectable& sender, winrt::hstring newTitle);
     void LastTabClosed(const winrt::Windows::Foundation::IInspectable& sender, const winrt::TerminalApp::LastTabClosedEventArgs& args);
     void Initialize();
@@ -470,6 +470,18 @@ long IslandWindow::_calculateTotalSize(const bool isWidth, const long clientSize
         _WindowMovedHandlers();
         break;
     }
+    case WM_ENTERSIZEMOVE:
+    {
+        // The user started dragging the window or one of its borders. The
+        // controls hold off resizing their buffers until they let go.
+        _LiveResizeChangedHandlers(true);
+        break;
+    }
+    case WM_EXITSIZEMOVE:
+    {
+        _LiveResizeChangedHandlers(false);
+        break;
+    }
     case WM_CLOSE:
     {
         // If the user wants to close the app by clicking 'X' button,
@@ -63,6 +63,7 @@ public:
     WINRT_CALLBACK(NotifyReAddTrayIcon, winrt::delegate<void()>);
 
     WINRT_CALLBACK(WindowMoved, winrt::delegate<void()>);
+    WINRT_CALLBACK(LiveResizeChanged, winrt::delegate<void(bool)>);
 
 protected:
     void ForceResize()
@@ -133,10 +133,27 @@ int __stdcall wWinMain(HINSTANCE, HINSTANCE, LPWSTR, int)
     // doing that, we can safely init as STA before any WinRT dispatches.
     winrt::init_apartment(winrt::apartment_type::single_threaded);
 
+    // Find out if our commandline is meant for an existing window before we
+    // load any of the app: when `wt` is run with a window that's already open,
+    // all we need is the monarch. If we're the monarch ourselves, we need the
+    // app to parse the commandline, and we'll be creating a window anyways.
+    // The AppHost will propose the commandline then.
+    winrt::Microsoft::Terminal::Remoting::WindowManager windowManager;
+    if (!windowManager.IsMonarch())
+    {
+        windowManager.ProposeCommandline(AppHost::GetCommandlineArgs());
+        if (!windowManager.ShouldCreateWindow())
+        {
+            // The monarch handed our commandline to another window. We didn't
+            // create any Xaml objects yet, so we can just return.
+            return 0;
+        }
+    }
+
     // Create the AppHost object, which will create both the window and the
     // Terminal App. This MUST BE constructed before the Xaml manager as TermApp
     // provides an implementation of Windows.UI.Xaml.Application.
-    AppHost host;
+    AppHost host{ std::move(windowManager) };
     if (!host.HasWindow())
     {
         // If we were told to not have a window, exit early. Make sure to use
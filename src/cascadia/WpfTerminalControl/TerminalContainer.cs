@@ -20,6 +20,7 @@ namespace Microsoft.Terminal.Wpf
     /// </remarks>
     public class TerminalContainer : HwndHost
     {
+        private readonly object terminalLock = new object();
         private ITerminalConnection connection;
         private IntPtr hwnd;
         private IntPtr terminal;
@@ -288,8 +289,13 @@ namespace Microsoft.Terminal.Wpf
         /// <inheritdoc/>
         protected override void DestroyWindowCore(HandleRef hwnd)
         {
-            NativeMethods.DestroyTerminal(this.terminal);
-            this.terminal = IntPtr.Zero;
+            // WriteOutput may be called from other threads, so make sure they're
+            // done with the terminal before it's destroyed.
+            lock (this.terminalLock)
+            {
+                NativeMethods.DestroyTerminal(this.terminal);
+                this.terminal = IntPtr.Zero;
+            }
         }
 
         private static void UnpackKeyMessage(IntPtr wParam, IntPtr lParam, out ushort vkey, out ushort scanCode, out ushort flags)
@@ -431,6 +437,50 @@ namespace Microsoft.Terminal.Wpf
             }
         }
 
+        /// <summary>
+        /// Writes output to the terminal, without going through the connection.
+        /// </summary>
+        /// <param name="buffer">The UTF-16 output.</param>
+        /// <param name="offset">The offset of the output in buffer.</param>
+        /// <param name="count">The number of characters to write.</param>
+        internal void WriteOutput(char[] buffer, int offset, int count)
+        {
+            if (count == 0)
+            {
+                return;
+            }
+
+            lock (this.terminalLock)
+            {
+                if (this.terminal != IntPtr.Zero)
+                {
+                    NativeMethods.TerminalSendOutputUtf16(this.terminal, ref buffer[offset], (uint)count);
+                }
+            }
+        }
+
+        /// <summary>
+        /// Writes UTF-8 output to the terminal, without going through the connection.
+        /// </summary>
+        /// <param name="buffer">The UTF-8 output.</param>
+        /// <param name="offset">The offset of the output in buffer.</param>
+        /// <param name="count">The number of bytes to write.</param>
+        internal void WriteOutputUtf8(byte[] buffer, int offset, int count)
+        {
+            if (count == 0)
+            {
+                return;
+            }
+
+            lock (this.terminalLock)
+            {
+                if (this.terminal != IntPtr.Zero)
+                {
+                    NativeMethods.TerminalSendOutputUtf8(this.terminal, ref buffer[offset], (uint)count);
+                }
+            }
+        }
+
         private void Connection_TerminalOutput(object sender, TerminalOutputEventArgs e)
         {
             if (this.terminal != IntPtr.Zero)
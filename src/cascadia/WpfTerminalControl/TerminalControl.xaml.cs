@@ -101,6 +101,32 @@ namespace Microsoft.Terminal.Wpf
             }
         }
 
+        /// <summary>
+        /// Writes output directly to the terminal. Unlike raising <see cref="ITerminalConnection.TerminalOutput"/>,
+        /// this doesn't need a string for every chunk and may be called from any thread.
+        /// </summary>
+        /// <param name="buffer">The output.</param>
+        /// <param name="offset">The offset of the output in <paramref name="buffer"/>.</param>
+        /// <param name="count">The number of characters to write.</param>
+        public void WriteOutput(char[] buffer, int offset, int count)
+        {
+            ValidateBufferArguments(buffer, offset, count);
+            this.termContainer.WriteOutput(buffer, offset, count);
+        }
+
+        /// <summary>
+        /// Writes UTF-8 output directly to the terminal. Code points may be split across calls.
+        /// This may be called from any thread, but calls must not overlap for their output to stay in order.
+        /// </summary>
+        /// <param name="buffer">The UTF-8 output.</param>
+        /// <param name="offset">The offset of the output in <paramref name="buffer"/>.</param>
+        /// <param name="count">The number of bytes to write.</param>
+        public void WriteOutputUtf8(byte[] buffer, int offset, int count)
+        {
+            ValidateBufferArguments(buffer, offset, count);
+            this.termContainer.WriteOutputUtf8(buffer, offset, count);
+        }
+
         /// <summary>
         /// Gets the selected text in the terminal, clearing the selection. Otherwise returns an empty string.
         /// </summary>
@@ -184,6 +210,19 @@ namespace Microsoft.Terminal.Wpf
         /// </summary>
         /// <param name="controlSize">New size of the control. Uses the control's current size if not provided.</param>
         /// <returns>The new terminal control margin thickness in device independent units.</returns>
+        private static void ValidateBufferArguments<T>(T[] buffer, int offset, int count)
+        {
+            if (buffer == null)
+            {
+                throw new ArgumentNullException(nameof(buffer));
+            }
+
+            if (offset < 0 || count < 0 || offset > buffer.Length - count)
+            {
+                throw new ArgumentOutOfRangeException(nameof(count));
+            }
+        }
+
         private Thickness CalculateMargins(Size controlSize = default)
         {
             var dpiScale = VisualTreeHelper.GetDpi(this);
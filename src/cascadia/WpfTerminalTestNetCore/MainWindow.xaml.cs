@@ -5,6 +5,9 @@
 
 using Microsoft.Terminal.Wpf;
 using System;
+using System.Diagnostics;
+using System.Text;
+using System.Threading.Tasks;
 using System.Windows;
 
 namespace WpfTerminalTestNetCore
@@ -12,6 +15,7 @@ namespace WpfTerminalTestNetCore
     public class EchoConnection : Microsoft.Terminal.Wpf.ITerminalConnection
     {
         public event EventHandler<TerminalOutputEventArgs> TerminalOutput;
+        public event EventHandler BenchmarkRequested;
 
         public void Resize(uint rows, uint columns)
         {
@@ -20,7 +24,7 @@ namespace WpfTerminalTestNetCore
 
         public void Start()
         {
-            TerminalOutput.Invoke(this, new TerminalOutputEventArgs("ECHO CONNECTION\r\n^A: toggle printable ESC\r\n^B: toggle SGR mouse mode\r\n^C: toggle win32 input mode\r\n\r\n"));
+            TerminalOutput.Invoke(this, new TerminalOutputEventArgs("ECHO CONNECTION\r\n^A: toggle printable ESC\r\n^B: toggle SGR mouse mode\r\n^C: toggle win32 input mode\r\n^D: run the output benchmark\r\n\r\n"));
             return;
         }
 
@@ -47,6 +51,10 @@ namespace WpfTerminalTestNetCore
                 TerminalOutput.Invoke(this, new TerminalOutputEventArgs($"\x1b[?1003{decSet}\x1b[?1006{decSet}"));
                 TerminalOutput.Invoke(this, new TerminalOutputEventArgs($"SGR Mouse mode (1003, 1006): {_mouseMode}\r\n"));
             }
+            else if (data[0] == '\x04') // ^D
+            {
+                BenchmarkRequested?.Invoke(this, EventArgs.Empty);
+            }
             else if ((data[0] == '\x03') ||
                      (data == "\x1b[67;46;3;1;8;1_")) // ^C
             {
@@ -78,6 +86,11 @@ namespace WpfTerminalTestNetCore
         {
             return;
         }
+
+        public void WriteOutput(string data)
+        {
+            TerminalOutput.Invoke(this, new TerminalOutputEventArgs(data));
+        }
     }
     /// <summary>
     /// Interaction logic for MainWindow.xaml
@@ -103,9 +116,53 @@ namespace WpfTerminalTestNetCore
                 ColorTable = new uint[] { 0x0C0C0C, 0x1F0FC5, 0x0EA113, 0x009CC1, 0xDA3700, 0x981788, 0xDD963A, 0xCCCCCC, 0x767676, 0x5648E7, 0x0CC616, 0xA5F1F9, 0xFF783B, 0x9E00B4, 0xD6D661, 0xF2F2F2 },
             };
 
-            Terminal.Connection = new EchoConnection();
+            var connection = new EchoConnection();
+            connection.BenchmarkRequested += (_, __) => Task.Run(() => RunOutputBenchmark(connection));
+            Terminal.Connection = connection;
             Terminal.SetTheme(theme, "Cascadia Code", 12);
             Terminal.Focus();
         }
+
+        // Writes the same log-like output through the string based TerminalOutput
+        // event and the WriteOutputUtf8 API from a background thread, the way
+        // a log viewer with high-rate output would, and compares their throughput.
+        private void RunOutputBenchmark(EchoConnection connection)
+        {
+            const int iterations = 50;
+            const int chunkSize = 4096;
+
+            var builder = new StringBuilder();
+            for (var i = 0; i < 1000; i++)
+            {
+                builder.Append($"\x1b[3{i % 8}m2021-06-01T12:00:00.{i:D3}Z [INFO] Line {i}: the quick brown fox jumps over the lazy dog \u00e4\u00f6\u00fc\x1b[m\r\n");
+            }
+
+            var text = builder.ToString();
+            var utf8 = Encoding.UTF8.GetBytes(text);
+
+            var stopwatch = Stopwatch.StartNew();
+            for (var iteration = 0; iteration < iterations; iteration++)
+            {
+                for (var offset = 0; offset < text.Length; offset += chunkSize)
+                {
+                    connection.WriteOutput(text.Substring(offset, Math.Min(chunkSize, text.Length - offset)));
+                }
+            }
+            var stringElapsed = stopwatch.Elapsed;
+
+            stopwatch.Restart();
+            for (var iteration = 0; iteration < iterations; iteration++)
+            {
+                for (var offset = 0; offset < utf8.Length; offset += chunkSize)
+                {
+                    Terminal.WriteOutputUtf8(utf8, offset, Math.Min(chunkSize, utf8.Length - offset));
+                }
+            }
+            var utf8Elapsed = stopwatch.Elapsed;
+
+            var megabytes = (double)utf8.Length * iterations / (1024 * 1024);
+            connection.WriteOutput($"\x1b[m\r\nTerminalOutput:   {stringElapsed.TotalMilliseconds:F0} ms ({megabytes / stringElapsed.TotalSeconds:F1} MB/s)\r\n");
+            connection.WriteOutput($"WriteOutputUtf8:  {utf8Elapsed.TotalMilliseconds:F0} ms ({megabytes / utf8Elapsed.TotalSeconds:F1} MB/s)\r\n");
+        }
     }
 }
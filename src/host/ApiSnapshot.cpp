@@ -0,0 +1,170 @@
+// Copyright (c) Microsoft Corporation.
+// Licensed under the MIT license.
+
+#include "precomp.h"
+
+#include "ApiSnapshot.hpp"
+
+#include "../interactivity/inc/ServiceLocator.hpp"
+
+#pragma hdrstop
+
+using namespace Microsoft::Console;
+using Microsoft::Console::Interactivity::ServiceLocator;
+
+// Routine Description:
+// - Copies the state that the queries return. Must be called with the console
+//   lock held, right before it's released.
+// Arguments:
+// - gci - The console to copy the state of.
+void ApiSnapshot::Publish(const CONSOLE_INFORMATION& gci) noexcept
+try
+{
+    Data data{};
+
+    if (gci.HasActiveOutputBuffer())
+    {
+        const auto& activeBuffer = gci.GetActiveOutputBuffer().GetActiveBuffer();
+        data.activeBuffer = &activeBuffer;
+        data.mainBuffer = &activeBuffer.GetMainBuffer();
+        data.outputMode = activeBuffer.OutputMode;
+
+        if (ServiceLocator::LocateGlobals().IsHeadless())
+        {
+            activeBuffer.GetScreenBufferInformation(&data.size,
+                                                    &data.cursorPosition,
+                                                    &data.window,
+                                                    &data.attributes,
+                                                    &data.maximumWindowSize,
+                                                    &data.popupAttributes,
+                                                    data.colorTable);
+            data.hasScreenBufferInfo = TRUE;
+        }
+    }
+
+    if (const auto inputBuffer = gci.pInputBuffer)
+    {
+        data.inputBuffer = inputBuffer;
+        data.inputMode = inputBuffer->InputMode;
+
+        if (WI_IsFlagSet(gci.Flags, CONSOLE_USE_PRIVATE_FLAGS))
+        {
+            WI_SetFlag(data.inputMode, ENABLE_EXTENDED_FLAGS);
+            WI_SetFlagIf(data.inputMode, ENABLE_INSERT_MODE, gci.GetInsertMode());
+            WI_SetFlagIf(data.inputMode, ENABLE_QUICK_EDIT_MODE, WI_IsFlagSet(gci.Flags, CONSOLE_QUICK_EDIT_MODE));
+            WI_SetFlagIf(data.inputMode, ENABLE_AUTO_POSITION, WI_IsFlagSet(gci.Flags, CONSOLE_AUTO_POSITION));
+        }
+    }
+
+    std::array<uint32_t, WordCount> words;
+    memcpy(words.data(), &data, sizeof(data));
+
+    // We're only ever called under the console lock, so there's only one writer.
+    const auto sequence = _sequence.load(std::memory_order_relaxed);
+    _sequence.store(sequence + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+
+    for (size_t i = 0; i < WordCount; ++i)
+    {
+        til::at(_words, i).store(til::at(words, i), std::memory_order_relaxed);
+    }
+
+    _sequence.store(sequence + 2, std::memory_order_release);
+}
+CATCH_LOG()
+
+// Routine Description:
+// - Retrieves the state GetConsoleScreenBufferInfoEx returns, without the console lock.
+// Arguments:
+// - context - The output buffer concerned
+// - data - Receives the same as ApiRoutines::GetConsoleScreenBufferInfoExImpl would
+// Return Value:
+// - true if the snapshot could answer the query. If false, the caller has to
+//   take the console lock and look it up itself.
+bool ApiSnapshot::TryGetScreenBufferInfo(const SCREEN_INFORMATION& context, CONSOLE_SCREEN_BUFFER_INFOEX& data) const noexcept
+{
+    Data snapshot;
+    if (!_Read(snapshot) || !snapshot.hasScreenBufferInfo || !_Matches(snapshot, context))
+    {
+        return false;
+    }
+
+    data.bFullscreenSupported = FALSE;
+    data.dwSize = snapshot.size;
+    data.dwCursorPosition = snapshot.cursorPosition;
+    data.srWindow = snapshot.window;
+    data.wAttributes = snapshot.attributes;
+    data.dwMaximumWindowSize = snapshot.maximumWindowSize;
+    data.wPopupAttributes = snapshot.popupAttributes;
+    std::copy(std::begin(snapshot.colorTable), std::end(snapshot.colorTable), std::begin(data.ColorTable));
+    return true;
+}
+
+// Routine Description:
+// - Retrieves the output mode of the given buffer, without the console lock.
+// Arguments:
+// - context - The output buffer concerned
+// - mode - Receives the mode flags set
+// Return Value:
+// - true if the snapshot could answer the query.
+bool ApiSnapshot::TryGetOutputMode(const SCREEN_INFORMATION& context, ULONG& mode) const noexcept
+{
+    Data snapshot;
+    if (!_Read(snapshot) || !_Matches(snapshot, context))
+    {
+        return false;
+    }
+
+    mode = snapshot.outputMode;
+    return true;
+}
+
+// Routine Description:
+// - Retrieves the input mode of the given input buffer, without the console lock.
+// Arguments:
+// - context - The input buffer concerned
+// - mode - Receives the mode flags set, including the private ones
+// Return Value:
+// - true if the snapshot could answer the query.
+bool ApiSnapshot::TryGetInputMode(const InputBuffer& context, ULONG& mode) const noexcept
+{
+    Data snapshot;
+    if (!_Read(snapshot) || snapshot.inputBuffer != &context)
+    {
+        return false;
+    }
+
+    mode = snapshot.inputMode;
+    return true;
+}
+
+bool ApiSnapshot::_Read(Data& data) const noexcept
+{
+    const auto before = _sequence.load(std::memory_order_acquire);
+    if (before == 0 || (before & 1) != 0)
+    {
+        return false;
+    }
+
+    std::array<uint32_t, WordCount> words;
+    for (size_t i = 0; i < WordCount; ++i)
+    {
+        til::at(words, i) = til::at(_words, i).load(std::memory_order_relaxed);
+    }
+
+    std::atomic_thread_fence(std::memory_order_acquire);
+    if (_sequence.load(std::memory_order_relaxed) != before)
+    {
+        return false;
+    }
+
+    memcpy(&data, words.data(), sizeof(data));
+    return true;
+}
+
+// The queries answer for the active buffer of their context, which is the
+// context itself or, if it's a main buffer, its alternate buffer.
+bool ApiSnapshot::_Matches(const Data& data, const SCREEN_INFORMATION& context) noexcept
+{
+    return &context == data.activeBuffer || &context == data.mainBuffer;
+}
@@ -0,0 +1,72 @@
+/*++
+Copyright (c) Microsoft Corporation
+Licensed under the MIT license.
+
+Module Name:
+- ApiSnapshot.hpp
+
+Abstract:
+- Holds a copy of the state that clients query most often, so that those
+  queries can be answered without taking the console lock, which renders and
+  writes hold for much longer than a query needs.
+- The copy is published whenever the console lock is released by its
+  outermost owner. Every change to the state is made under the lock, so the
+  copy always matches the state as of the latest unlock. Readers treat it as a
+  seqlock: if it's being published while they read, they don't wait, but
+  take the console lock like before. Callers that already hold the lock
+  mustn't use the copy, since they may be in the middle of changing the state.
+- The screen buffer information is only published while we're headless.
+  Otherwise the maximum window size depends on the monitor the window is on,
+  which is too expensive to look up on every unlock.
+--*/
+
+#pragma once
+
+class SCREEN_INFORMATION;
+class InputBuffer;
+class CONSOLE_INFORMATION;
+
+namespace Microsoft::Console
+{
+    class ApiSnapshot final
+    {
+    public:
+        void Publish(const CONSOLE_INFORMATION& gci) noexcept;
+
+        bool TryGetScreenBufferInfo(const SCREEN_INFORMATION& context, CONSOLE_SCREEN_BUFFER_INFOEX& data) const noexcept;
+        bool TryGetOutputMode(const SCREEN_INFORMATION& context, ULONG& mode) const noexcept;
+        bool TryGetInputMode(const InputBuffer& context, ULONG& mode) const noexcept;
+
+    private:
+        struct Data
+        {
+            // These identify what the state was copied from. They're only
+            // ever compared, never dereferenced.
+            const void* activeBuffer;
+            const void* mainBuffer;
+            const void* inputBuffer;
+
+            COORD size;
+            COORD cursorPosition;
+            SMALL_RECT window;
+            COORD maximumWindowSize;
+            WORD attributes;
+            WORD popupAttributes;
+            COLORREF colorTable[16];
+            ULONG outputMode;
+            ULONG inputMode;
+            ULONG hasScreenBufferInfo;
+        };
+
+        static_assert(sizeof(Data) % sizeof(uint32_t) == 0);
+        static constexpr size_t WordCount{ sizeof(Data) / sizeof(uint32_t) };
+
+        bool _Read(Data& data) const noexcept;
+        static bool _Matches(const Data& data, const SCREEN_INFORMATION& context) noexcept;
+
+        // Even while nobody publishes, odd while a publication is underway,
+        // and 0 until the first one.
+        std::atomic<uint32_t> _sequence{ 0 };
+        std::array<std::atomic<uint32_t>, WordCount> _words{};
+    };
+}
@@ -20,7 +20,9 @@ const std::wstring_view ConsoleArguments::WIDTH_ARG = L"--width";
 const std::wstring_view ConsoleArguments::HEIGHT_ARG = L"--height";
 const std::wstring_view ConsoleArguments::INHERIT_CURSOR_ARG = L"--inheritcursor";
 const std::wstring_view ConsoleArguments::RESIZE_QUIRK = L"--resizeQuirk";
+const std::wstring_view ConsoleArguments::COORDINATED_RESIZE = L"--coordinatedResize";
 const std::wstring_view ConsoleArguments::WIN32_INPUT_MODE = L"--win32input";
+const std::wstring_view ConsoleArguments::PASSTHROUGH_MODE = L"--passthrough";
 const std::wstring_view ConsoleArguments::FEATURE_ARG = L"--feature";
 const std::wstring_view ConsoleArguments::FEATURE_PTY_ARG = L"pty";
 const std::wstring_view ConsoleArguments::COM_SERVER_ARG = L"-Embedding";
@@ -502,12 +504,24 @@ void ConsoleArguments::s_ConsumeArg(_Inout_ std::vector<std::wstring>& args, _In
             s_ConsumeArg(args, i);
             hr = S_OK;
         }
+        else if (arg == COORDINATED_RESIZE)
+        {
+            _coordinatedResize = true;
+            s_ConsumeArg(args, i);
+            hr = S_OK;
+        }
         else if (arg == WIN32_INPUT_MODE)
         {
             _win32InputMode = true;
             s_ConsumeArg(args, i);
             hr = S_OK;
         }
+        else if (arg == PASSTHROUGH_MODE)
+        {
+            _passthroughMode = true;
+            s_ConsumeArg(args, i);
+            hr = S_OK;
+        }
         else if (arg == CLIENT_COMMANDLINE_ARG)
         {
             // Everything after this is the explicit commandline
@@ -659,10 +673,18 @@ bool ConsoleArguments::IsResizeQuirkEnabled() const
 {
     return _resizeQuirk;
 }
+bool ConsoleArguments::IsCoordinatedResizeEnabled() const
+{
+    return _coordinatedResize;
+}
 bool ConsoleArguments::IsWin32InputModeEnabled() const
 {
     return _win32InputMode;
 }
+bool ConsoleArguments::IsPassthroughModeEnabled() const
+{
+    return _passthroughMode;
+}
 
 #ifdef UNIT_TESTING
 // Method Description:
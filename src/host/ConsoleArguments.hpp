@@ -54,7 +54,9 @@ public:
     short GetHeight() const;
     bool GetInheritCursor() const;
     bool IsResizeQuirkEnabled() const;
+    bool IsCoordinatedResizeEnabled() const;
     bool IsWin32InputModeEnabled() const;
+    bool IsPassthroughModeEnabled() const;
 
 #ifdef UNIT_TESTING
     void EnableConptyModeForTests();
@@ -73,7 +75,9 @@ public:
     static const std::wstring_view HEIGHT_ARG;
     static const std::wstring_view INHERIT_CURSOR_ARG;
     static const std::wstring_view RESIZE_QUIRK;
+    static const std::wstring_view COORDINATED_RESIZE;
     static const std::wstring_view WIN32_INPUT_MODE;
+    static const std::wstring_view PASSTHROUGH_MODE;
     static const std::wstring_view FEATURE_ARG;
     static const std::wstring_view FEATURE_PTY_ARG;
     static const std::wstring_view COM_SERVER_ARG;
@@ -139,7 +143,9 @@ private:
     DWORD _signalHandle;
     bool _inheritCursor;
     bool _resizeQuirk{ false };
+    bool _coordinatedResize{ false };
     bool _win32InputMode{ false };
+    bool _passthroughMode{ false };
 
     [[nodiscard]] HRESULT _GetClientCommandline(_Inout_ std::vector<std::wstring>& args,
                                                 const size_t index,
@@ -51,6 +51,16 @@ void ScreenBufferRenderTarget::TriggerRedrawAll()
     }
 }
 
+void ScreenBufferRenderTarget::TriggerRedrawBlinking()
+{
+    auto* pRenderer = ServiceLocator::LocateGlobals().pRender;
+    const auto* pActive = &ServiceLocator::LocateGlobals().getConsoleInformation().GetActiveOutputBuffer().GetActiveBuffer();
+    if (pRenderer != nullptr && pActive == &_owner)
+    {
+        pRenderer->TriggerRedrawBlinking();
+    }
+}
+
 void ScreenBufferRenderTarget::TriggerTeardown() noexcept
 {
     auto* pRenderer = ServiceLocator::LocateGlobals().pRender;
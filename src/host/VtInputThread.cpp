@@ -11,6 +11,7 @@
 #include "outputStream.hpp" // For ConhostInternalGetSet
 #include "../terminal/adapter/InteractDispatch.hpp"
 #include "../types/inc/convert.hpp"
+#include "../types/inc/ThreadScheduling.hpp"
 #include "server.h"
 #include "output.h"
 #include "handle.h"
@@ -18,6 +19,15 @@
 using namespace Microsoft::Console;
 using namespace Microsoft::Console::Interactivity;
 using namespace Microsoft::Console::VirtualTerminal;
+
+// The size of the first read from the pipe. Keystrokes are only a few bytes
+// each, so this is plenty for interactive typing.
+static constexpr size_t InitialReadSize = 4 * 1024;
+// The most input we'll gather before handing it off to the state machine.
+// Large pastes are read in batches of up to this size, to pay for the lock
+// and the conversion once per batch instead of once per tiny read.
+static constexpr size_t MaxReadSize = 256 * 1024;
+
 // Constructor Description:
 // - Creates the VT Input Thread.
 // Arguments:
@@ -29,6 +39,8 @@ VtInputThread::VtInputThread(_In_ wil::unique_hfile hPipe,
     _hFile{ std::move(hPipe) },
     _hThread{},
     _u8State{},
+    _wstr{},
+    _buffer{},
     _dwThreadId{ 0 },
     _exitRequested{ false },
     _exitResult{ S_OK }
@@ -62,24 +74,26 @@ VtInputThread::VtInputThread(_In_ wil::unique_hfile hPipe,
 // - S_OK on success, otherwise an appropriate failure.
 [[nodiscard]] HRESULT VtInputThread::_HandleRunInput(const std::string_view u8Str)
 {
-    // Make sure to call the GLOBAL Lock/Unlock, not the gci's lock/unlock.
-    // Only the global unlock attempts to dispatch ctrl events. If you use the
-    //      gci's unlock, when you press C-c, it won't be dispatched until the
-    //      next console API call. For something like `powershell sleep 60`,
-    //      that won't happen for 60s
-    LockConsole();
-    auto Unlock = wil::scope_exit([&] { UnlockConsole(); });
-
     try
     {
-        std::wstring wstr{};
-        auto hr = til::u8u16(u8Str, wstr, _u8State);
+        // The conversion only touches state owned by this thread, so it's
+        // done before taking the lock, to hold it no longer than we need to.
+        auto hr = til::u8u16(u8Str, _wstr, _u8State);
         // If we hit a parsing error, eat it. It's bad utf-8, we can't do anything with it.
         if (FAILED(hr))
         {
             return S_FALSE;
         }
-        _pInputStateMachine->ProcessString(wstr);
+
+        // Make sure to call the GLOBAL Lock/Unlock, not the gci's lock/unlock.
+        // Only the global unlock attempts to dispatch ctrl events. If you use the
+        //      gci's unlock, when you press C-c, it won't be dispatched until the
+        //      next console API call. For something like `powershell sleep 60`,
+        //      that won't happen for 60s
+        LockConsole();
+        auto Unlock = wil::scope_exit([&] { UnlockConsole(); });
+
+        _pInputStateMachine->ProcessString(_wstr);
     }
     CATCH_RETURN();
 
@@ -99,8 +113,10 @@ DWORD WINAPI VtInputThread::StaticVtInputThreadProc(_In_ LPVOID lpParameter)
 }
 
 // Method Description:
-// - Do a single ReadFile from our pipe, and try and handle it. If handling
-//      failed, throw or log, depending on what the caller wants.
+// - Do a single (blocking) ReadFile from our pipe, followed by reads of
+//      whatever else is already waiting in it, and try and handle all of it
+//      at once. If handling failed, throw or log, depending on what the
+//      caller wants.
 // Arguments:
 // - throwOnFail: If true, throw an exception if there was an error processing
 //      the input received. Otherwise, log the error.
@@ -108,9 +124,13 @@ DWORD WINAPI VtInputThread::StaticVtInputThreadProc(_In_ LPVOID lpParameter)
 // - <none>
 void VtInputThread::DoReadInput(const bool throwOnFail)
 {
-    char buffer[256];
+    if (_buffer.size() < InitialReadSize)
+    {
+        _buffer.resize(InitialReadSize);
+    }
+
     DWORD dwRead = 0;
-    bool fSuccess = !!ReadFile(_hFile.get(), buffer, ARRAYSIZE(buffer), &dwRead, nullptr);
+    bool fSuccess = !!ReadFile(_hFile.get(), _buffer.data(), gsl::narrow_cast<DWORD>(InitialReadSize), &dwRead, nullptr);
 
     // If we failed to read because the terminal broke our pipe (usually due
     //      to dying itself), close gracefully with ERROR_BROKEN_PIPE.
@@ -123,7 +143,32 @@ void VtInputThread::DoReadInput(const bool throwOnFail)
         return;
     }
 
-    HRESULT hr = _HandleRunInput({ buffer, gsl::narrow_cast<size_t>(dwRead) });
+    // Coalesce the rest of a burst of input (like a paste) into this batch.
+    // PeekNamedPipe tells us how much we can read without blocking. It fails
+    // for handles that aren't pipes, and then we just handle what we've got.
+    size_t length = dwRead;
+    DWORD available = 0;
+    while (length < MaxReadSize &&
+           PeekNamedPipe(_hFile.get(), nullptr, 0, nullptr, &available, nullptr) &&
+           available != 0)
+    {
+        const auto toRead = std::min<size_t>(available, MaxReadSize - length);
+        if (_buffer.size() < length + toRead)
+        {
+            _buffer.resize(std::min(std::max(_buffer.size() * 2, length + toRead), MaxReadSize));
+        }
+
+        dwRead = 0;
+        if (!ReadFile(_hFile.get(), _buffer.data() + length, gsl::narrow_cast<DWORD>(toRead), &dwRead, nullptr))
+        {
+            // Handle what we already read. The next read will hit (and
+            //      report) the same error.
+            break;
+        }
+        length += dwRead;
+    }
+
+    HRESULT hr = _HandleRunInput({ _buffer.data(), length });
     if (FAILED(hr))
     {
         if (throwOnFail)
@@ -147,6 +192,11 @@ void VtInputThread::DoReadInput(const bool throwOnFail)
 //      have caused us to exit.
 DWORD VtInputThread::_InputThread()
 {
+    // The user is waiting on the echo of whatever we read, even while
+    // the machine is busy with other work.
+    Microsoft::Console::Types::ThreadScheduling::CurrentThread scheduling;
+    scheduling.Apply(Microsoft::Console::Types::ThreadScheduling::Class::Interactive);
+
     while (!_exitRequested)
     {
         DoReadInput(true);
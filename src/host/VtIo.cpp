@@ -69,7 +69,9 @@ VtIo::VtIo() :
 {
     _lookingForCursorPosition = pArgs->GetInheritCursor();
     _resizeQuirk = pArgs->IsResizeQuirkEnabled();
+    _coordinatedResize = pArgs->IsCoordinatedResizeEnabled();
     _win32InputMode = pArgs->IsWin32InputModeEnabled();
+    _passthroughMode = pArgs->IsPassthroughModeEnabled();
 
     // If we were already given VT handles, set up the VT IO engine to use those.
     if (pArgs->InConptyMode())
@@ -174,6 +176,8 @@ VtIo::VtIo() :
             {
                 _pVtRenderEngine->SetTerminalOwner(this);
                 _pVtRenderEngine->SetResizeQuirk(_resizeQuirk);
+                _pVtRenderEngine->SetCoordinatedResize(_coordinatedResize);
+                _pVtRenderEngine->SetPassthroughMode(_passthroughMode);
             }
         }
     }
@@ -212,7 +216,13 @@ bool VtIo::IsUsingVt() const
         try
         {
             g.pRender->AddRenderEngine(_pVtRenderEngine.get());
-            g.getConsoleInformation().GetActiveOutputBuffer().SetTerminalConnection(_pVtRenderEngine.get());
+            // In passthrough mode, the terminal already receives everything the
+            // client wrote, so the strings the state machine doesn't understand
+            // mustn't be forwarded to it a second time.
+            if (!_passthroughMode)
+            {
+                g.getConsoleInformation().GetActiveOutputBuffer().SetTerminalConnection(_pVtRenderEngine.get());
+            }
             g.getConsoleInformation().GetActiveInputBuffer()->SetTerminalConnection(_pVtRenderEngine.get());
         }
         CATCH_RETURN();
@@ -456,6 +466,37 @@ bool VtIo::IsResizeQuirkEnabled() const
     return _resizeQuirk;
 }
 
+// Method Description:
+// - Returns true if passthrough mode is enabled. In this mode, VT that clients
+//   write is forwarded to the terminal as is, instead of being rendered again
+//   from our buffer, which is still kept up to date for API readers. Output
+//   from the legacy console APIs is not forwarded, so this is only suitable
+//   for VT-aware clients.
+// Arguments:
+// - <none>
+// Return Value:
+// - true iff we were started with the `--passthrough` flag enabled.
+bool VtIo::IsPassthroughModeEnabled() const noexcept
+{
+    return _passthroughMode && _pVtRenderEngine != nullptr;
+}
+
+// Method Description:
+// - Forwards a string a client wrote straight to the terminal. Only used in
+//   passthrough mode, see IsPassthroughModeEnabled.
+// Arguments:
+// - str - the text (and VT sequences) the client wrote
+// Return Value:
+// - S_OK if we wrote the string successfully, otherwise an appropriate HRESULT
+[[nodiscard]] HRESULT VtIo::PassThroughString(const std::wstring_view str) const noexcept
+{
+    if (_pVtRenderEngine)
+    {
+        return _pVtRenderEngine->PassThroughString(str);
+    }
+    return S_OK;
+}
+
 // Method Description:
 // - Manually tell the renderer that it should emit a "Erase Scrollback"
 //   sequence to the connected terminal. We need to do this in certain cases
@@ -474,3 +515,20 @@ bool VtIo::IsResizeQuirkEnabled() const
     }
     return S_OK;
 }
+
+// Method Description:
+// - Tell the renderer that the client switched to or from the alternate screen
+//   buffer, so that the connected terminal can switch its own buffer, instead
+//   of us repainting the whole viewport over its main buffer.
+// Arguments:
+// - useAlternate - true if the alternate screen buffer is now active.
+// Return Value:
+// - S_OK if we wrote the sequences successfully, otherwise an appropriate HRESULT
+[[nodiscard]] HRESULT VtIo::SwitchScreenBuffer(const bool useAlternate) const noexcept
+{
+    if (_pVtRenderEngine)
+    {
+        return _pVtRenderEngine->SwitchScreenBuffer(useAlternate);
+    }
+    return S_OK;
+}
@@ -46,6 +46,10 @@ namespace Microsoft::Console::VirtualTerminal
         bool IsResizeQuirkEnabled() const;
 
         [[nodiscard]] HRESULT ManuallyClearScrollback() const noexcept;
+        [[nodiscard]] HRESULT SwitchScreenBuffer(const bool useAlternate) const noexcept;
+
+        bool IsPassthroughModeEnabled() const noexcept;
+        [[nodiscard]] HRESULT PassThroughString(const std::wstring_view str) const noexcept;
 
     private:
         // After CreateIoHandlers is called, these will be invalid.
@@ -62,7 +66,9 @@ namespace Microsoft::Console::VirtualTerminal
         std::mutex _shutdownLock;
 
         bool _resizeQuirk{ false };
+        bool _coordinatedResize{ false };
         bool _win32InputMode{ false };
+        bool _passthroughMode{ false };
 
         std::unique_ptr<Microsoft::Console::Render::VtEngine> _pVtRenderEngine;
         std::unique_ptr<Microsoft::Console::VtInputThread> _pVtInputThread;
@@ -21,6 +21,10 @@
 
 #include "../interactivity/inc/ServiceLocator.hpp"
 
+#ifdef _M_ARM64
+#include <arm64_neon.h>
+#endif
+
 #pragma hdrstop
 using namespace Microsoft::Console::Types;
 using Microsoft::Console::Interactivity::ServiceLocator;
@@ -28,6 +32,81 @@ using Microsoft::Console::VirtualTerminal::StateMachine;
 // Used by WriteCharsLegacy.
 #define IS_GLYPH_CHAR(wch) (((wch) >= L' ') && ((wch) != 0x007F))
 
+// Used by WriteConsoleAImpl. UTF-8 writes larger than this are converted in pieces of this size.
+constexpr size_t Utf8WriteChunkSize = 64 * 1024;
+
+// Routine Description:
+// - Counts the printable ASCII characters (SPC through ~) at the start of the
+//   given string. They're always a single column wide and never need any of
+//   the special handling in WriteCharsLegacy, so it can copy them in bulk.
+//   Testing for "x <= n" is done with an unsigned saturating subtraction,
+//   since it's equivalent to "sat(x - n) == 0".
+// Arguments:
+// - string - Characters to scan.
+// Return Value:
+// - The number of printable ASCII characters the string starts with.
+static size_t s_CountLeadingPrintableAscii(const std::wstring_view string) noexcept
+{
+#pragma warning(push)
+#pragma warning(disable : 26481) // Don't use pointer arithmetic. Use span instead (bounds.1).
+#pragma warning(disable : 26490) // Don't use reinterpret_cast (type.1).
+    static_assert(sizeof(wchar_t) == sizeof(uint16_t), "The vectorized code below assumes UTF-16 code units.");
+
+    const auto data = string.data();
+    const auto size = string.size();
+    size_t offset = 0;
+
+#ifdef _M_AMD64
+    const auto c0Max = _mm_set1_epi16(L' ' - 1);
+    const auto tilde = _mm_set1_epi16(L'~');
+    const auto zero = _mm_setzero_si128();
+
+    for (; offset + 8 <= size; offset += 8)
+    {
+        const auto chars = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + offset));
+        const auto isC0 = _mm_cmpeq_epi16(_mm_subs_epu16(chars, c0Max), zero);
+        const auto isAtMostTilde = _mm_cmpeq_epi16(_mm_subs_epu16(chars, tilde), zero);
+        const auto printable = static_cast<unsigned long>(_mm_movemask_epi8(_mm_andnot_si128(isC0, isAtMostTilde)));
+        unsigned long index;
+        if (_BitScanForward(&index, ~printable & 0xffff))
+        {
+            // movemask returns 2 bits per 16-bit lane.
+            return offset + index / 2;
+        }
+    }
+#elif _M_ARM64
+    // NEON has no movemask. We only use it to skip over blocks of printable
+    // characters and let the scalar loop below find the exact position.
+    const auto spc = vdupq_n_u16(L' ');
+    const auto tilde = vdupq_n_u16(L'~');
+
+    for (; offset + 8 <= size; offset += 8)
+    {
+        const auto chars = vld1q_u16(reinterpret_cast<const uint16_t*>(data + offset));
+        const auto printable = vandq_u16(vcgeq_u16(chars, spc), vcleq_u16(chars, tilde));
+        if (vminvq_u16(printable) == 0)
+        {
+            break;
+        }
+    }
+#else
+    UNREFERENCED_PARAMETER(data);
+#endif
+
+    // Handles the remaining tail of the string, as well as
+    // the entire string on platforms without vectorized code.
+    for (; offset < size; ++offset)
+    {
+        const auto ch = til::at(string, offset);
+        if (ch < L' ' || ch > L'~')
+        {
+            break;
+        }
+    }
+    return offset;
+#pragma warning(pop)
+}
+
 // Routine Description:
 // - This routine updates the cursor position.  Its input is the non-special
 //   cased new location of the cursor.  For example, if the cursor were being
@@ -390,6 +469,27 @@ using Microsoft::Console::VirtualTerminal::StateMachine;
         wchar_t* LocalBufPtr = LocalBuffer;
         while (*pcb < BufferSize && i < LOCAL_BUFFER_SIZE && XPosition < coordScreenBufferSize.X)
         {
+            // Plain text is by far the most common input. Copy as much printable
+            // ASCII as fits into the buffer and the rest of the row in one go.
+            {
+                const auto charsLeft = (BufferSize - *pcb) / sizeof(WCHAR);
+                const auto columnsLeft = gsl::narrow_cast<size_t>(coordScreenBufferSize.X - XPosition);
+                const auto limit = std::min({ charsLeft, LOCAL_BUFFER_SIZE - i, columnsLeft });
+                const auto run = s_CountLeadingPrintableAscii({ lpString, limit });
+                if (run != 0)
+                {
+                    std::copy_n(lpString, run, LocalBufPtr);
+                    LocalBufPtr += run;
+                    XPosition += gsl::narrow_cast<SHORT>(run);
+                    i += run;
+                    pwchBuffer += run;
+                    lpString += run;
+                    pwchRealUnicode += run;
+                    *pcb += run * sizeof(WCHAR);
+                    continue;
+                }
+            }
+
 #pragma prefast(suppress : 26019, "Buffer is taken in multiples of 2. Validation is ok.")
             const wchar_t Char = *lpString;
             // WCL-NOTE: We believe RealUnicodeChar to be identical to Char, because we believe pwchRealUnicode
@@ -974,6 +1074,16 @@ using Microsoft::Console::VirtualTerminal::StateMachine;
 
                 machine.ProcessString({ pwchRealUnicode, cch });
                 *pcb += BufferSize;
+
+                // In passthrough mode, the terminal gets exactly what the client
+                // wrote, rather than what we'd render for it from our buffer.
+                // Writes to buffers that aren't on screen stay out of it.
+                auto& gci = ServiceLocator::LocateGlobals().getConsoleInformation();
+                if (gci.GetVtIo()->IsPassthroughModeEnabled() &&
+                    &screenInfo.GetActiveBuffer() == &gci.GetActiveOutputBuffer())
+                {
+                    LOG_IF_FAILED(gci.GetVtIo()->PassThroughString({ pwchRealUnicode, cch }));
+                }
             }
         }
 
@@ -1136,9 +1246,56 @@ using Microsoft::Console::VirtualTerminal::StateMachine;
         const auto codepage{ consoleInfo.OutputCP };
         auto leadByteCaptured{ false };
         auto leadByteConsumed{ false };
-        std::wstring wstr{};
         static til::u8state u8State{};
 
+        // Like u8State, the conversion buffer is only ever used under the console lock. Keeping it around
+        // saves us allocating a new one for every write, as long as it doesn't grow beyond a chunk.
+        static std::wstring wstr{};
+        const auto releaseLargeBuffer{ wil::scope_exit([&]() noexcept {
+            if (wstr.capacity() > Utf8WriteChunkSize)
+            {
+                wstr = std::wstring{};
+            }
+        }) };
+
+        // Large UTF-8 writes are converted and written in chunks, so that we never hold
+        // a UTF-16 copy of the entire payload. A write can only be turned into a wait
+        // by these flags and they can't change while we hold the lock. So if we aren't
+        // blocked now we won't be for any chunk, and only the unchunked path below needs
+        // to stow the text in a waiter.
+        if (codepage == CP_UTF8 &&
+            buffer.size() > Utf8WriteChunkSize &&
+            WI_AreAllFlagsClear(consoleInfo.Flags, CONSOLE_SUSPENDED | CONSOLE_SELECTING | CONSOLE_SCROLLBAR_TRACKING))
+        {
+            wstr.reserve(Utf8WriteChunkSize);
+
+            for (size_t offset = 0; offset < buffer.size(); offset += Utf8WriteChunkSize)
+            {
+                const auto chunk{ buffer.substr(offset, Utf8WriteChunkSize) };
+                RETURN_IF_FAILED(til::u8u16(chunk, wstr, u8State));
+
+                std::unique_ptr<WriteData> writeDataWaiter{};
+                size_t wcBufferWritten{};
+                const auto hr{ WriteConsoleWImplHelper(screenInfo, wstr, wcBufferWritten, requiresVtQuirk, writeDataWaiter) };
+
+                // Just like the unchunked path, we report every byte we've converted as read.
+                read = offset + chunk.size();
+
+                if (writeDataWaiter)
+                {
+                    writeDataWaiter->SetUtf8ConsumedCharacters(read);
+                    waiter.reset(writeDataWaiter.release());
+                }
+
+                if (FAILED(hr) || waiter)
+                {
+                    return hr;
+                }
+            }
+
+            return S_OK;
+        }
+
         // Convert our input parameters to Unicode
         if (codepage == CP_UTF8)
         {
@@ -24,14 +24,20 @@
 
 using Microsoft::Console::Interactivity::ServiceLocator;
 
+// Every alias lookup hashes the exe name and the first word of the line, so
+// this folds the case of each character as it goes (FNV-1a) instead of hashing
+// a lowercased copy of the key.
 struct case_insensitive_hash
 {
-    std::size_t operator()(const std::wstring& key) const
+    std::size_t operator()(const std::wstring& key) const noexcept
     {
-        std::wstring lower(key);
-        std::transform(lower.begin(), lower.end(), lower.begin(), ::towlower);
-        std::hash<std::wstring> hash;
-        return hash(lower);
+        uint64_t hash = 0xcbf29ce484222325;
+        for (const auto ch : key)
+        {
+            hash ^= ::towlower(ch);
+            hash *= 0x100000001b3;
+        }
+        return gsl::narrow_cast<std::size_t>(hash);
     }
 };
 
@@ -824,24 +830,24 @@ void Alias::s_ClearCmdExeAliases()
 // - Trims leading spaces off of a string
 // Arguments:
 // - str - String to trim
-void Alias::s_TrimLeadingSpaces(std::wstring& str)
+void Alias::s_TrimLeadingSpaces(std::wstring_view& str)
 {
     // Erase from the beginning of the string up until the first
     // character found that is not a space.
-    str.erase(str.begin(),
-              std::find_if(str.begin(), str.end(), [](wchar_t ch) { return !std::iswspace(ch); }));
+    const auto firstNonSpace = std::find_if(str.begin(), str.end(), [](wchar_t ch) { return !std::iswspace(ch); });
+    str.remove_prefix(firstNonSpace - str.begin());
 }
 
 // Routine Description:
 // - Trims trailing \r\n off of a string
 // Arguments:
 // - str - String to trim
-void Alias::s_TrimTrailingCrLf(std::wstring& str)
+void Alias::s_TrimTrailingCrLf(std::wstring_view& str)
 {
     const auto trailingCrLfPos = str.find_last_of(UNICODE_CARRIAGERETURN);
-    if (std::wstring::npos != trailingCrLfPos)
+    if (std::wstring_view::npos != trailingCrLfPos)
     {
-        str.erase(trailingCrLfPos);
+        str = str.substr(0, trailingCrLfPos);
     }
 }
 
@@ -850,14 +856,14 @@ void Alias::s_TrimTrailingCrLf(std::wstring& str)
 // Arguments:
 // - str - String to tokenize
 // Return Value:
-// - Collection of tokenized strings
-std::deque<std::wstring> Alias::s_Tokenize(const std::wstring& str)
+// - Collection of tokenized strings. They point into str.
+std::vector<std::wstring_view> Alias::s_Tokenize(const std::wstring_view str)
 {
-    std::deque<std::wstring> result;
+    std::vector<std::wstring_view> result;
 
     size_t prevIndex = 0;
     auto spaceIndex = str.find(L' ');
-    while (std::wstring::npos != spaceIndex)
+    while (std::wstring_view::npos != spaceIndex)
     {
         const auto length = spaceIndex - prevIndex;
 
@@ -882,11 +888,11 @@ std::deque<std::wstring> Alias::s_Tokenize(const std::wstring& str)
 // - str - String to split into just args
 // Return Value:
 // - Only the arguments part of the string or empty if there are no arguments.
-std::wstring Alias::s_GetArgString(const std::wstring& str)
+std::wstring_view Alias::s_GetArgString(const std::wstring_view str)
 {
-    std::wstring result;
+    std::wstring_view result;
     auto firstSpace = str.find_first_of(L' ');
-    if (std::wstring::npos != firstSpace)
+    if (std::wstring_view::npos != firstSpace)
     {
         firstSpace++;
         if (firstSpace < str.size())
@@ -910,7 +916,7 @@ std::wstring Alias::s_GetArgString(const std::wstring& str)
 // - False if the given character doesn't match this macro.
 bool Alias::s_TryReplaceNumberedArgMacro(const wchar_t ch,
                                          std::wstring& appendToStr,
-                                         const std::deque<std::wstring>& tokens)
+                                         const std::vector<std::wstring_view>& tokens)
 {
     if (ch >= L'1' && ch <= L'9')
     {
@@ -919,7 +925,7 @@ bool Alias::s_TryReplaceNumberedArgMacro(const wchar_t ch,
 
         if (index < tokens.size() && index > 0)
         {
-            appendToStr.append(tokens[index]);
+            appendToStr.append(til::at(tokens, index));
         }
 
         return true;
@@ -940,7 +946,7 @@ bool Alias::s_TryReplaceNumberedArgMacro(const wchar_t ch,
 // - False if the given character doesn't match this macro.
 bool Alias::s_TryReplaceWildcardArgMacro(const wchar_t ch,
                                          std::wstring& appendToStr,
-                                         const std::wstring fullArgString)
+                                         const std::wstring_view fullArgString)
 {
     if (L'*' == ch)
     {
@@ -1061,11 +1067,12 @@ void Alias::s_AppendCrLf(std::wstring& appendToStr,
 // Return Value:
 // - The number of commands in the final string (line feeds, CRLFs)
 size_t Alias::s_ReplaceMacros(std::wstring& str,
-                              const std::deque<std::wstring>& tokens,
-                              const std::wstring& fullArgString)
+                              const std::vector<std::wstring_view>& tokens,
+                              const std::wstring_view fullArgString)
 {
     size_t lineCount = 0;
     std::wstring finalText;
+    finalText.reserve(str.size() + 2);
 
     // The target text may contain substitution macros indicated by $.
     // Walk through and substitute them as appropriate.
@@ -1141,45 +1148,37 @@ size_t Alias::s_ReplaceMacros(std::wstring& str,
 // - If we found a matching alias, this will be the processed data
 //   and lineCount is updated to the new number of lines.
 // - If we didn't match and process an alias, return an empty string.
-std::wstring Alias::s_MatchAndCopyAlias(const std::wstring& sourceText,
+std::wstring Alias::s_MatchAndCopyAlias(const std::wstring_view sourceText,
                                         const std::wstring& exeName,
                                         size_t& lineCount)
 {
-    // Copy source text into a local for manipulation.
-    std::wstring sourceCopy(sourceText);
-
-    // Trim trailing \r\n off of sourceCopy if it has one.
-    s_TrimTrailingCrLf(sourceCopy);
-
-    // Trim leading spaces off of sourceCopy if it has any.
-    s_TrimLeadingSpaces(sourceCopy);
-
-    // Check if we have an EXE in the list that matches the request first.
-    auto exeIter = g_aliasData.find(exeName);
+    // Most lines are typed into an exe without any aliases, so check for
+    // those first, before we look at the text at all.
+    const auto exeIter = g_aliasData.find(exeName);
     if (exeIter == g_aliasData.end())
     {
         // We found no data for this exe. Give back an empty string.
         return std::wstring();
     }
 
-    auto exeList = exeIter->second;
-    if (exeList.size() == 0)
+    const auto& exeList = exeIter->second;
+    if (exeList.empty())
     {
         // If there's no match, give back an empty string.
         return std::wstring();
     }
 
-    // Tokenize the text by spaces
-    const auto tokens = s_Tokenize(sourceCopy);
+    auto source = sourceText;
 
-    // If there are no tokens, return an empty string
-    if (tokens.size() == 0)
-    {
-        return std::wstring();
-    }
+    // Trim trailing \r\n off of source if it has one.
+    s_TrimTrailingCrLf(source);
 
-    // Find alias. If there isn't one, return an empty string
-    const auto alias = tokens.front();
+    // Trim leading spaces off of source if it has any.
+    s_TrimLeadingSpaces(source);
+
+    // Find alias. If there isn't one, return an empty string.
+    // Only the first word is needed for that, the line is tokenized below once we've got a match.
+    const std::wstring alias{ source.substr(0, source.find(L' ')) };
     const auto aliasIter = exeList.find(alias);
     if (aliasIter == exeList.end())
     {
@@ -1187,14 +1186,17 @@ std::wstring Alias::s_MatchAndCopyAlias(const std::wstring& sourceText,
         return std::wstring();
     }
 
-    const auto target = aliasIter->second;
+    const auto& target = aliasIter->second;
     if (target.size() == 0)
     {
         return std::wstring();
     }
 
+    // Tokenize the text by spaces
+    const auto tokens = s_Tokenize(source);
+
     // Get the string of all parameters as a shorthand for $* later.
-    const auto allParams = s_GetArgString(sourceCopy);
+    const auto allParams = s_GetArgString(source);
 
     // The final text will be the target but with macros replaced.
     std::wstring finalText(target);
@@ -1226,7 +1228,7 @@ void Alias::s_MatchAndCopyAliasLegacy(_In_reads_bytes_(cbSource) PWCHAR pwchSour
 {
     try
     {
-        std::wstring sourceText(pwchSource, cbSource / sizeof(WCHAR));
+        const std::wstring_view sourceText(pwchSource, cbSource / sizeof(WCHAR));
         size_t lineCount = lines;
 
         const auto targetText = s_MatchAndCopyAlias(sourceText, exeName, lineCount);
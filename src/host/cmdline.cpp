@@ -18,6 +18,7 @@
 #include "handle.h"
 #include "misc.h"
 #include "../types/inc/convert.hpp"
+#include "../types/inc/GlyphWidth.hpp"
 #include "srvinit.h"
 
 #include "ApiRoutines.h"
@@ -278,29 +279,164 @@ void RedrawCommandLine(COOKED_READ_DATA& cookedReadData)
     }
 }
 
+// Routine Description:
+// - Updates the command line on the screen after its text changed from the given index onwards.
+//   It looks the same as if the line had been deleted with DeleteCommandLine and written out again.
+// - As long as every character before the index takes up exactly one cell, the position of the
+//   first changed character follows from the index alone. Then only the text from there onwards is
+//   written, followed by the spaces needed to erase what's left of the old line. Otherwise the
+//   whole line is deleted and written again.
+// - The cursor is left at the end of the command line.
+// Arguments:
+// - cookedReadData - The cooked read whose command line changed. Its VisibleCharCount must still
+//                    be the number of cells the old command line takes up on the screen.
+// - firstChangedChar - The index of the first character of the command line that changed.
+// - dwFlags - The flags to pass to WriteCharsLegacy.
+// - pScrollY - If given, the number of rows the screen scrolled by is added to it.
+// Return Value:
+// - The status of WriteCharsLegacy.
+[[nodiscard]] NTSTATUS RewriteCommandLine(COOKED_READ_DATA& cookedReadData,
+                                          const size_t firstChangedChar,
+                                          const DWORD dwFlags,
+                                          _Inout_opt_ SHORT* const pScrollY) noexcept
+{
+    auto& screenInfo = cookedReadData.ScreenInfo();
+    const auto bufferSize = screenInfo.GetBufferSize().Dimensions();
+    const auto origin = cookedReadData.OriginalCursorPosition();
+    const auto oldCellCount = cookedReadData.VisibleCharCount();
+    const auto text = cookedReadData.BufferStartPtr();
+    const auto textLength = cookedReadData.BytesRead() / sizeof(WCHAR);
+
+    const std::wstring_view unchanged{ text, std::min(firstChangedChar, textLength) };
+    const auto start = origin.X + unchanged.size();
+    const auto startRow = origin.Y + start / bufferSize.X;
+
+    // If the unchanged text ends right at the end of a row, the whole line is written again, so that the row
+    // gets marked as wrapped just like it would be if the text had continued past the end of the row before.
+    const auto canSkipUnchanged = origin.Y >= 0 &&
+                                  WI_IsFlagSet(screenInfo.OutputMode, ENABLE_WRAP_AT_EOL_OUTPUT) &&
+                                  unchanged.size() <= oldCellCount &&
+                                  (unchanged.empty() || start % bufferSize.X != 0) &&
+                                  startRow < gsl::narrow_cast<size_t>(bufferSize.Y) &&
+                                  std::none_of(unchanged.begin(), unchanged.end(), [](const wchar_t wch) noexcept {
+                                      return wch == UNICODE_TAB || IS_CONTROL_CHAR(wch) || IsGlyphFullWidth(wch);
+                                  });
+
+    SHORT ScrollY = 0;
+    NTSTATUS Status = STATUS_SUCCESS;
+    if (!canSkipUnchanged)
+    {
+        DeleteCommandLine(cookedReadData, false);
+
+        auto NumToWrite = textLength * sizeof(WCHAR);
+        Status = WriteCharsLegacy(screenInfo,
+                                  text,
+                                  text,
+                                  text,
+                                  &NumToWrite,
+                                  &cookedReadData.VisibleCharCount(),
+                                  origin.X,
+                                  dwFlags,
+                                  &ScrollY);
+    }
+    else
+    {
+        LOG_IF_FAILED(screenInfo.SetCursorPosition({ gsl::narrow_cast<SHORT>(start % bufferSize.X), gsl::narrow_cast<SHORT>(startRow) }, true));
+
+        const auto changed = text + unchanged.size();
+        auto NumToWrite = (textLength - unchanged.size()) * sizeof(WCHAR);
+        size_t changedCellCount = 0;
+        if (NumToWrite != 0)
+        {
+            Status = WriteCharsLegacy(screenInfo,
+                                      text,
+                                      changed,
+                                      changed,
+                                      &NumToWrite,
+                                      &changedCellCount,
+                                      origin.X,
+                                      dwFlags,
+                                      &ScrollY);
+        }
+
+        // Erase the rest of the old line, which DeleteCommandLine would've overwritten with spaces.
+        const auto newCellCount = unchanged.size() + changedCellCount;
+        auto CharsToErase = oldCellCount;
+        if (!CheckBisectStringW(text, CharsToErase, bufferSize.X - origin.X))
+        {
+            CharsToErase++;
+        }
+
+        if (CharsToErase > newCellCount)
+        {
+            const auto end = origin.X + newCellCount;
+            const auto endRow = origin.Y + ScrollY + gsl::narrow_cast<int>(end / bufferSize.X);
+            const COORD endPosition{ gsl::narrow_cast<SHORT>(end % bufferSize.X), gsl::narrow_cast<SHORT>(endRow) };
+            if (endPosition.Y >= 0 && endPosition.Y < bufferSize.Y)
+            {
+                try
+                {
+                    screenInfo.Write(OutputCellIterator(UNICODE_SPACE, CharsToErase - newCellCount), endPosition);
+                }
+                CATCH_LOG();
+            }
+        }
+
+        cookedReadData.VisibleCharCount() = newCellCount;
+    }
+
+    if (pScrollY)
+    {
+        *pScrollY += ScrollY;
+    }
+    return Status;
+}
+
+// Routine Description:
+// - Replaces the command line with a command from the history. Commands recalled from the
+//   history often start like the current one, so only the part that differs is written again.
+// Arguments:
+// - cookedReadData - The cooked read data to operate on
+// - retrieve - Copies the command into the cooked read buffer and stores its size in BytesRead
+// Return Value:
+// - The number of rows the screen scrolled by while the command line was written.
+static SHORT ReplaceCommandLine(COOKED_READ_DATA& cookedReadData, const std::function<void()>& retrieve)
+{
+    if (!cookedReadData.IsEchoInput())
+    {
+        DeleteCommandLine(cookedReadData, true);
+        retrieve();
+        return 0;
+    }
+
+    const std::wstring previous{ cookedReadData.BufferStartPtr(), cookedReadData.BytesRead() / sizeof(WCHAR) };
+    const auto visibleCharCount = cookedReadData.VisibleCharCount();
+    cookedReadData.Erase();
+    cookedReadData.VisibleCharCount() = visibleCharCount;
+    retrieve();
+
+    const std::wstring_view current{ cookedReadData.BufferStartPtr(), cookedReadData.BytesRead() / sizeof(WCHAR) };
+    const auto firstChangedChar = std::mismatch(current.begin(), current.end(), previous.begin(), previous.end()).first - current.begin();
+
+    SHORT ScrollY = 0;
+    FAIL_FAST_IF_NTSTATUS_FAILED(RewriteCommandLine(cookedReadData,
+                                                    gsl::narrow_cast<size_t>(firstChangedChar),
+                                                    WC_DESTRUCTIVE_BACKSPACE | WC_KEEP_CURSOR_VISIBLE | WC_PRINTABLE_CONTROL_CHARS,
+                                                    &ScrollY));
+    cookedReadData.OriginalCursorPosition().Y += ScrollY;
+    return ScrollY;
+}
+
 // Routine Description:
 // - This routine copies the commandline specified by Index into the cooked read buffer
 void SetCurrentCommandLine(COOKED_READ_DATA& cookedReadData, _In_ SHORT Index) // index, not command number
 {
-    DeleteCommandLine(cookedReadData, TRUE);
-    FAIL_FAST_IF_FAILED(cookedReadData.History().RetrieveNth(Index,
-                                                             cookedReadData.SpanWholeBuffer(),
-                                                             cookedReadData.BytesRead()));
+    ReplaceCommandLine(cookedReadData, [&]() {
+        FAIL_FAST_IF_FAILED(cookedReadData.History().RetrieveNth(Index,
+                                                                 cookedReadData.SpanWholeBuffer(),
+                                                                 cookedReadData.BytesRead()));
+    });
     FAIL_FAST_IF(!(cookedReadData.BufferStartPtr() == cookedReadData.BufferCurrentPtr()));
-    if (cookedReadData.IsEchoInput())
-    {
-        SHORT ScrollY = 0;
-        FAIL_FAST_IF_NTSTATUS_FAILED(WriteCharsLegacy(cookedReadData.ScreenInfo(),
-                                                      cookedReadData.BufferStartPtr(),
-                                                      cookedReadData.BufferCurrentPtr(),
-                                                      cookedReadData.BufferCurrentPtr(),
-                                                      &cookedReadData.BytesRead(),
-                                                      &cookedReadData.VisibleCharCount(),
-                                                      cookedReadData.OriginalCursorPosition().X,
-                                                      WC_DESTRUCTIVE_BACKSPACE | WC_KEEP_CURSOR_VISIBLE | WC_PRINTABLE_CONTROL_CHARS,
-                                                      &ScrollY));
-        cookedReadData.OriginalCursorPosition().Y += ScrollY;
-    }
 
     size_t const CharsToWrite = cookedReadData.BytesRead() / sizeof(WCHAR);
     cookedReadData.InsertionPoint() = CharsToWrite;
@@ -446,25 +582,12 @@ void CommandLine::_processHistoryCycling(COOKED_READ_DATA& cookedReadData,
         return;
     }
 
-    DeleteCommandLine(cookedReadData, true);
-    THROW_IF_FAILED(cookedReadData.History().Retrieve(searchDirection,
-                                                      cookedReadData.SpanWholeBuffer(),
-                                                      cookedReadData.BytesRead()));
+    ReplaceCommandLine(cookedReadData, [&]() {
+        THROW_IF_FAILED(cookedReadData.History().Retrieve(searchDirection,
+                                                          cookedReadData.SpanWholeBuffer(),
+                                                          cookedReadData.BytesRead()));
+    });
     FAIL_FAST_IF(!(cookedReadData.BufferStartPtr() == cookedReadData.BufferCurrentPtr()));
-    if (cookedReadData.IsEchoInput())
-    {
-        short ScrollY = 0;
-        FAIL_FAST_IF_NTSTATUS_FAILED(WriteCharsLegacy(cookedReadData.ScreenInfo(),
-                                                      cookedReadData.BufferStartPtr(),
-                                                      cookedReadData.BufferCurrentPtr(),
-                                                      cookedReadData.BufferCurrentPtr(),
-                                                      &cookedReadData.BytesRead(),
-                                                      &cookedReadData.VisibleCharCount(),
-                                                      cookedReadData.OriginalCursorPosition().X,
-                                                      WC_DESTRUCTIVE_BACKSPACE | WC_KEEP_CURSOR_VISIBLE | WC_PRINTABLE_CONTROL_CHARS,
-                                                      &ScrollY));
-        cookedReadData.OriginalCursorPosition().Y += ScrollY;
-    }
     const size_t CharsToWrite = cookedReadData.BytesRead() / sizeof(WCHAR);
     cookedReadData.InsertionPoint() = CharsToWrite;
     cookedReadData.SetBufferCurrentPtr(cookedReadData.BufferStartPtr() + CharsToWrite);
@@ -480,26 +603,13 @@ void CommandLine::_setPromptToOldestCommand(COOKED_READ_DATA& cookedReadData)
 {
     if (cookedReadData.HasHistory() && cookedReadData.History().GetNumberOfCommands())
     {
-        DeleteCommandLine(cookedReadData, true);
         const short commandNumber = 0;
-        THROW_IF_FAILED(cookedReadData.History().RetrieveNth(commandNumber,
-                                                             cookedReadData.SpanWholeBuffer(),
-                                                             cookedReadData.BytesRead()));
+        ReplaceCommandLine(cookedReadData, [&]() {
+            THROW_IF_FAILED(cookedReadData.History().RetrieveNth(commandNumber,
+                                                                 cookedReadData.SpanWholeBuffer(),
+                                                                 cookedReadData.BytesRead()));
+        });
         FAIL_FAST_IF(!(cookedReadData.BufferStartPtr() == cookedReadData.BufferCurrentPtr()));
-        if (cookedReadData.IsEchoInput())
-        {
-            short ScrollY = 0;
-            FAIL_FAST_IF_NTSTATUS_FAILED(WriteCharsLegacy(cookedReadData.ScreenInfo(),
-                                                          cookedReadData.BufferStartPtr(),
-                                                          cookedReadData.BufferCurrentPtr(),
-                                                          cookedReadData.BufferCurrentPtr(),
-                                                          &cookedReadData.BytesRead(),
-                                                          &cookedReadData.VisibleCharCount(),
-                                                          cookedReadData.OriginalCursorPosition().X,
-                                                          WC_DESTRUCTIVE_BACKSPACE | WC_KEEP_CURSOR_VISIBLE | WC_PRINTABLE_CONTROL_CHARS,
-                                                          &ScrollY));
-            cookedReadData.OriginalCursorPosition().Y += ScrollY;
-        }
         size_t CharsToWrite = cookedReadData.BytesRead() / sizeof(WCHAR);
         cookedReadData.InsertionPoint() = CharsToWrite;
         cookedReadData.SetBufferCurrentPtr(cookedReadData.BufferStartPtr() + CharsToWrite);
@@ -514,32 +624,23 @@ void CommandLine::_setPromptToOldestCommand(COOKED_READ_DATA& cookedReadData)
 // - May throw exceptions
 void CommandLine::_setPromptToNewestCommand(COOKED_READ_DATA& cookedReadData)
 {
-    DeleteCommandLine(cookedReadData, true);
     if (cookedReadData.HasHistory() && cookedReadData.History().GetNumberOfCommands())
     {
         const short commandNumber = (SHORT)(cookedReadData.History().GetNumberOfCommands() - 1);
-        THROW_IF_FAILED(cookedReadData.History().RetrieveNth(commandNumber,
-                                                             cookedReadData.SpanWholeBuffer(),
-                                                             cookedReadData.BytesRead()));
+        ReplaceCommandLine(cookedReadData, [&]() {
+            THROW_IF_FAILED(cookedReadData.History().RetrieveNth(commandNumber,
+                                                                 cookedReadData.SpanWholeBuffer(),
+                                                                 cookedReadData.BytesRead()));
+        });
         FAIL_FAST_IF(!(cookedReadData.BufferStartPtr() == cookedReadData.BufferCurrentPtr()));
-        if (cookedReadData.IsEchoInput())
-        {
-            short ScrollY = 0;
-            FAIL_FAST_IF_NTSTATUS_FAILED(WriteCharsLegacy(cookedReadData.ScreenInfo(),
-                                                          cookedReadData.BufferStartPtr(),
-                                                          cookedReadData.BufferCurrentPtr(),
-                                                          cookedReadData.BufferCurrentPtr(),
-                                                          &cookedReadData.BytesRead(),
-                                                          &cookedReadData.VisibleCharCount(),
-                                                          cookedReadData.OriginalCursorPosition().X,
-                                                          WC_DESTRUCTIVE_BACKSPACE | WC_KEEP_CURSOR_VISIBLE | WC_PRINTABLE_CONTROL_CHARS,
-                                                          &ScrollY));
-            cookedReadData.OriginalCursorPosition().Y += ScrollY;
-        }
         size_t CharsToWrite = cookedReadData.BytesRead() / sizeof(WCHAR);
         cookedReadData.InsertionPoint() = CharsToWrite;
         cookedReadData.SetBufferCurrentPtr(cookedReadData.BufferStartPtr() + CharsToWrite);
     }
+    else
+    {
+        DeleteCommandLine(cookedReadData, true);
+    }
 }
 
 // Routine Description:
@@ -1003,26 +1104,12 @@ COORD CommandLine::_cycleMatchingCommandHistoryToPrompt(COOKED_READ_DATA& cooked
             // save cursor position
             CurrentPos = (SHORT)cookedReadData.InsertionPoint();
 
-            DeleteCommandLine(cookedReadData, true);
-            THROW_IF_FAILED(cookedReadData.History().RetrieveNth((SHORT)index,
-                                                                 cookedReadData.SpanWholeBuffer(),
-                                                                 cookedReadData.BytesRead()));
+            cursorPosition.Y += ReplaceCommandLine(cookedReadData, [&]() {
+                THROW_IF_FAILED(cookedReadData.History().RetrieveNth((SHORT)index,
+                                                                     cookedReadData.SpanWholeBuffer(),
+                                                                     cookedReadData.BytesRead()));
+            });
             FAIL_FAST_IF(!(cookedReadData.BufferStartPtr() == cookedReadData.BufferCurrentPtr()));
-            if (cookedReadData.IsEchoInput())
-            {
-                short ScrollY = 0;
-                FAIL_FAST_IF_NTSTATUS_FAILED(WriteCharsLegacy(cookedReadData.ScreenInfo(),
-                                                              cookedReadData.BufferStartPtr(),
-                                                              cookedReadData.BufferCurrentPtr(),
-                                                              cookedReadData.BufferCurrentPtr(),
-                                                              &cookedReadData.BytesRead(),
-                                                              &cookedReadData.VisibleCharCount(),
-                                                              cookedReadData.OriginalCursorPosition().X,
-                                                              WC_DESTRUCTIVE_BACKSPACE | WC_KEEP_CURSOR_VISIBLE | WC_PRINTABLE_CONTROL_CHARS,
-                                                              &ScrollY));
-                cookedReadData.OriginalCursorPosition().Y += ScrollY;
-                cursorPosition.Y += ScrollY;
-            }
 
             // restore cursor position
             cookedReadData.SetBufferCurrentPtr(cookedReadData.BufferStartPtr() + CurrentPos);
@@ -1047,10 +1134,13 @@ COORD CommandLine::DeleteFromRightOfCursor(COOKED_READ_DATA& cookedReadData) noe
     if (!cookedReadData.AtEol())
     {
         // Delete commandline.
-        // clang-format off
+        if (!cookedReadData.IsEchoInput())
+        {
+            // clang-format off
 #pragma prefast(suppress: __WARNING_BUFFER_OVERFLOW, "Not sure why prefast is getting confused here")
-        // clang-format on
-        DeleteCommandLine(cookedReadData, false);
+            // clang-format on
+            DeleteCommandLine(cookedReadData, false);
+        }
 
         // Delete char.
         cookedReadData.BytesRead() -= sizeof(WCHAR);
@@ -1063,18 +1153,13 @@ COORD CommandLine::DeleteFromRightOfCursor(COOKED_READ_DATA& cookedReadData) noe
             *buf = (WCHAR)' ';
         }
 
-        // Write commandline.
+        // Write the commandline from the deleted char onwards.
         if (cookedReadData.IsEchoInput())
         {
-            FAIL_FAST_IF_NTSTATUS_FAILED(WriteCharsLegacy(cookedReadData.ScreenInfo(),
-                                                          cookedReadData.BufferStartPtr(),
-                                                          cookedReadData.BufferStartPtr(),
-                                                          cookedReadData.BufferStartPtr(),
-                                                          &cookedReadData.BytesRead(),
-                                                          &cookedReadData.VisibleCharCount(),
-                                                          cookedReadData.OriginalCursorPosition().X,
-                                                          WC_DESTRUCTIVE_BACKSPACE | WC_KEEP_CURSOR_VISIBLE | WC_PRINTABLE_CONTROL_CHARS,
-                                                          nullptr));
+            FAIL_FAST_IF_NTSTATUS_FAILED(RewriteCommandLine(cookedReadData,
+                                                            cookedReadData.InsertionPoint(),
+                                                            WC_DESTRUCTIVE_BACKSPACE | WC_KEEP_CURSOR_VISIBLE | WC_PRINTABLE_CONTROL_CHARS,
+                                                            nullptr));
         }
 
         // restore cursor position
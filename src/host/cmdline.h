@@ -130,6 +130,11 @@ void DeleteCommandLine(COOKED_READ_DATA& cookedReadData, const bool fUpdateField
 
 void RedrawCommandLine(COOKED_READ_DATA& cookedReadData);
 
+[[nodiscard]] NTSTATUS RewriteCommandLine(COOKED_READ_DATA& cookedReadData,
+                                          const size_t firstChangedChar,
+                                          const DWORD dwFlags,
+                                          _Inout_opt_ SHORT* const pScrollY) noexcept;
+
 // Values for WriteChars(), WriteCharsLegacy() dwFlags
 #define WC_DESTRUCTIVE_BACKSPACE 0x01
 #define WC_KEEP_CURSOR_VISIBLE 0x02
@@ -52,7 +52,8 @@ ConversionAreaInfo::ConversionAreaInfo(const COORD bufferSize,
 ConversionAreaInfo::ConversionAreaInfo(ConversionAreaInfo&& other) :
     _caInfo(other._caInfo),
     _isHidden(other._isHidden),
-    _screenBuffer(nullptr)
+    _screenBuffer(nullptr),
+    _cells(std::move(other._cells))
 {
     std::swap(_screenBuffer, other._screenBuffer);
 }
@@ -109,11 +110,95 @@ void ConversionAreaInfo::SetAttributes(const TextAttribute& attr)
 // Arguments:
 // - text - Text to insert into the conversion area buffer
 // - column - Column to start at (X position)
-void ConversionAreaInfo::WriteText(const std::vector<OutputCell>& text,
+void ConversionAreaInfo::WriteText(const gsl::span<const OutputCell> text,
                                    const SHORT column)
 {
-    gsl::span<const OutputCell> view(text.data(), text.size());
-    _screenBuffer->Write(view, { column, 0 });
+    _screenBuffer->Write(text, { column, 0 });
+}
+
+// Routine Description:
+// - Shows text in the conversion area, which overlays the given column of the
+//   line at the given position within the viewport.
+// - If the area already shows text at that place, only the cells that differ
+//   from it are rewritten and repainted. The IME sends the entire composition
+//   on every keystroke, and this way most of a long one stays as it is.
+// Arguments:
+// - text - Text to show in the conversion area buffer
+// - column - Column to start at (X position)
+// - viewPos - Where to overlay the conversion area, relative to the viewport
+void ConversionAreaInfo::ShowText(const std::vector<OutputCell>& text,
+                                  const SHORT column,
+                                  const COORD viewPos)
+{
+    const SMALL_RECT region{ column, 0, gsl::narrow<SHORT>(column + text.size() - 1), 0 };
+
+    if (IsHidden() || viewPos != _caInfo.coordConView || column != _caInfo.rcViewCaWindow.Left)
+    {
+        WriteText(text, column);
+        SetWindowInfo(region);
+        SetViewPos(viewPos);
+        SetHidden(false);
+        Paint();
+        _cells = text;
+        return;
+    }
+
+    // The cells up to the first one that changed are still the same. If the length didn't change,
+    // the same goes for the ones after the last one that changed. Otherwise, everything after
+    // the first change moved and needs to be rewritten, or uncovered if the text got shorter.
+    const auto firstChange = std::mismatch(text.begin(), text.end(), _cells.begin(), _cells.end(), s_IsSameCell).first;
+    const auto begin = gsl::narrow_cast<size_t>(firstChange - text.begin());
+    auto end = std::max(text.size(), _cells.size());
+    if (text.size() == _cells.size())
+    {
+        const auto lastChange = std::mismatch(text.rbegin(), text.rend() - begin, _cells.rbegin(), s_IsSameCell).first;
+        end = text.size() - gsl::narrow_cast<size_t>(lastChange - text.rbegin());
+    }
+
+    if (begin >= end)
+    {
+        return;
+    }
+
+    if (begin < text.size())
+    {
+        const auto written = std::min(end, text.size()) - begin;
+        WriteText(gsl::span<const OutputCell>{ text }.subspan(begin, written), gsl::narrow<SHORT>(column + begin));
+    }
+
+    // The window only shrinks or grows at its right edge here, which is covered by what we repaint below.
+    _caInfo.rcViewCaWindow = region;
+    _cells = text;
+
+    CONSOLE_INFORMATION& gci = ServiceLocator::LocateGlobals().getConsoleInformation();
+    SCREEN_INFORMATION& screenInfo = gci.GetActiveOutputBuffer();
+    const auto viewport = screenInfo.GetViewport();
+    const auto left = viewport.Left() + _caInfo.coordConView.X + column;
+
+    SMALL_RECT changed;
+    changed.Left = gsl::narrow<SHORT>(left + gsl::narrow_cast<int>(begin));
+    changed.Right = gsl::narrow<SHORT>(left + gsl::narrow_cast<int>(end) - 1);
+    changed.Top = viewport.Top() + _caInfo.coordConView.Y;
+    changed.Bottom = changed.Top;
+
+    // This invalidates both the cells that are still covered by the conversion area
+    // and the ones that it no longer covers and show the screen buffer again.
+    WriteToScreen(screenInfo, Viewport::FromInclusive(changed));
+}
+
+// Routine Description:
+// - Compares two cells of a conversion area.
+// Arguments:
+// - a - A cell
+// - b - Another cell
+// Return Value:
+// - True if both would be shown the same way.
+bool ConversionAreaInfo::s_IsSameCell(const OutputCell& a, const OutputCell& b)
+{
+    return a.Chars() == b.Chars() &&
+           a.DbcsAttr() == b.DbcsAttr() &&
+           a.TextAttrBehavior() == b.TextAttrBehavior() &&
+           (a.TextAttrBehavior() == TextAttributeBehavior::Current || a.TextAttr() == b.TextAttr());
 }
 
 // Routine Description:
@@ -125,6 +210,7 @@ void ConversionAreaInfo::ClearArea() noexcept
     try
     {
         _screenBuffer->ClearTextData();
+        _cells.clear();
     }
     CATCH_LOG();
 
@@ -61,14 +61,20 @@ public:
     void SetWindowInfo(const SMALL_RECT view) noexcept;
     void Paint() const noexcept;
 
-    void WriteText(const std::vector<OutputCell>& text, const SHORT column);
+    void WriteText(const gsl::span<const OutputCell> text, const SHORT column);
+    void ShowText(const std::vector<OutputCell>& text, const SHORT column, const COORD viewPos);
     void SetAttributes(const TextAttribute& attr);
 
     const TextBuffer& GetTextBuffer() const noexcept;
     const ConversionAreaBufferInfo& GetAreaBufferInfo() const noexcept;
 
 private:
+    static bool s_IsSameCell(const OutputCell& a, const OutputCell& b);
+
     ConversionAreaBufferInfo _caInfo;
     std::unique_ptr<SCREEN_INFORMATION> _screenBuffer;
     bool _isHidden;
+
+    // The cells ShowText() last showed, to only rewrite the ones that change.
+    std::vector<OutputCell> _cells;
 };
@@ -60,7 +60,8 @@ void ConsoleImeInfo::WriteCompMessage(const std::wstring_view text,
                                       const gsl::span<const BYTE> attributes,
                                       const gsl::span<const WORD> colorArray)
 {
-    ClearAllAreas();
+    // The conversion areas aren't cleared here. _WriteUndeterminedChars() updates them
+    // in place, so that only what changed since the last message is repainted.
 
     // MSFT:29219348 only hide the cursor after the IME produces a string.
     // See notes in convarea.cpp ImeStartComposition().
@@ -302,6 +303,7 @@ std::vector<OutputCell> ConsoleImeInfo::s_ConvertToCells(const std::wstring_view
 // - pos - Reference to the coordinate position in the viewport that this conversion area will occupy.
 //       - Updated to set up the next conversion area down a line (and to the left viewport edge)
 // - view - The rectangle representing the viewable area of the screen right now to let us know how many cells can fit.
+// - areaIndex - The conversion area to use. It's added if there isn't one yet, and reused otherwise.
 // - screenInfo - A reference to the screen information we will use for accessibility notifications
 // Return Value:
 // - Updated begin position for the next call. It will normally be >begin and <= end.
@@ -312,6 +314,7 @@ std::vector<OutputCell>::const_iterator ConsoleImeInfo::_WriteConversionArea(con
                                                                              const std::vector<OutputCell>::const_iterator end,
                                                                              COORD& pos,
                                                                              const Microsoft::Console::Types::Viewport view,
+                                                                             const size_t areaIndex,
                                                                              SCREEN_INFORMATION& screenInfo)
 {
     // The position in the viewport where we will start inserting cells for this conversion area
@@ -356,24 +359,18 @@ std::vector<OutputCell>::const_iterator ConsoleImeInfo::_WriteConversionArea(con
     // Copy out the substring into a vector.
     const std::vector<OutputCell> lineVec(lineBegin, lineEnd);
 
-    // Add a conversion area to the internal state to hold this line.
-    THROW_IF_FAILED(_AddConversionArea());
-
-    // Get the added conversion area.
-    auto& area = ConvAreaCompStr.back();
-
-    // Write our text into the conversion area.
-    area.WriteText(lineVec, insertionPos.X);
+    // Add a conversion area to the internal state to hold this line, unless we have one from before.
+    // Creating one means creating an entire screen buffer, which we'd rather not do on every keystroke.
+    if (areaIndex >= ConvAreaCompStr.size())
+    {
+        THROW_IF_FAILED(_AddConversionArea());
+    }
 
-    // Set the viewport and positioning parameters for the conversion area to describe to the renderer
-    // the appropriate location to overlay this conversion area on top of the main screen buffer inside the viewport.
-    const SMALL_RECT region{ insertionPos.X, 0, gsl::narrow<SHORT>(insertionPos.X + lineVec.size() - 1), 0 };
-    area.SetWindowInfo(region);
-    area.SetViewPos({ 0 - view.Left(), insertionPos.Y - view.Top() });
+    auto& area = ConvAreaCompStr.at(areaIndex);
 
-    // Make it visible and paint it.
-    area.SetHidden(false);
-    area.Paint();
+    // Write our text into the conversion area and overlay it at the appropriate location on top
+    // of the main screen buffer inside the viewport. This only repaints the cells that changed.
+    area.ShowText(lineVec, insertionPos.X, { 0 - view.Left(), insertionPos.Y - view.Top() });
 
     // Notify accessibility that we have updated the text in this display region within the viewport.
     if (screenInfo.HasAccessibilityEventing())
@@ -405,19 +402,10 @@ void ConsoleImeInfo::_WriteUndeterminedChars(const std::wstring_view text,
     // Ensure cursor is visible for prompt line
     screenInfo.MakeCurrentCursorVisible();
 
-    // Clear out existing conversion areas.
-    ConvAreaCompStr.clear();
-
     // If the text length and attribute length don't match,
     // it's a programming error on our part. We control the sizes here.
     FAIL_FAST_IF(text.size() != attributes.size());
 
-    // If we have no text, return. We've already cleared above.
-    if (text.empty())
-    {
-        return;
-    }
-
     // Convert data-to-be-stored into OutputCells.
     const auto cells = s_ConvertToCells(text, attributes, colorArray);
 
@@ -439,10 +427,23 @@ void ConsoleImeInfo::_WriteUndeterminedChars(const std::wstring_view text,
     const auto end = cells.cend();
 
     // Write over and over updating the beginning iterator until we reach the end.
-    do
+    size_t areaIndex = 0;
+    while (begin < end)
     {
-        begin = _WriteConversionArea(begin, end, pos, view, screenInfo);
-    } while (begin < end);
+        begin = _WriteConversionArea(begin, end, pos, view, areaIndex, screenInfo);
+        areaIndex++;
+    }
+
+    // Hide the conversion areas for the lines the composition no longer takes up.
+    // They're kept around for when it gets longer again.
+    for (; areaIndex < ConvAreaCompStr.size(); areaIndex++)
+    {
+        auto& area = ConvAreaCompStr.at(areaIndex);
+        if (!area.IsHidden())
+        {
+            area.ClearArea();
+        }
+    }
 }
 
 // Routine Description:
@@ -81,6 +81,7 @@ private:
                                                                  const std::vector<OutputCell>::const_iterator end,
                                                                  COORD& pos,
                                                                  const Microsoft::Console::Types::Viewport view,
+                                                                 const size_t areaIndex,
                                                                  SCREEN_INFORMATION& screenInfo);
 
     bool _isSavedCursorVisible;
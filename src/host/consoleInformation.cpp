@@ -74,6 +74,12 @@ bool CONSOLE_INFORMATION::TryLockConsole()
 #pragma prefast(suppress : 26135, "Adding lock annotation spills into entire project. Future work.")
 void CONSOLE_INFORMATION::UnlockConsole()
 {
+    // Once the outermost owner is done, the state is consistent again, and
+    //      queries may be answered from a copy of it. See ApiSnapshot.
+    if (_csConsoleLock.RecursionCount == 1)
+    {
+        _apiSnapshot.Publish(*this);
+    }
     LeaveCriticalSection(&_csConsoleLock);
 }
 
@@ -385,6 +391,17 @@ Microsoft::Console::CursorBlinker& CONSOLE_INFORMATION::GetCursorBlinker() noexc
     return _blinker;
 }
 
+// Method Description:
+// - return a reference to the copy of the state that queries may read without the console lock.
+// Arguments:
+// - <none>
+// Return Value:
+// - a reference to the console's API snapshot.
+const Microsoft::Console::ApiSnapshot& CONSOLE_INFORMATION::GetApiSnapshot() const noexcept
+{
+    return _apiSnapshot;
+}
+
 // Method Description:
 // - return a reference to the console's blinking state.
 // Arguments:
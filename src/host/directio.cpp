@@ -779,6 +779,59 @@ void EventsToUnicode(_Inout_ std::deque<std::unique_ptr<IInputEvent>>& inEvents,
     return result;
 }
 
+// Monitoring tools tend to poll ReadConsoleOutput over the entire viewport many
+// times a second. Converting cells into CHAR_INFOs is the expensive part of that,
+// so the last conversion of each row is kept around together with the row's
+// generation. Reads of rows that didn't change since then are just a copy.
+struct CachedCharInfoRow
+{
+    uint64_t generation = 0;
+    WORD legacyDefaults = 0;
+    std::vector<CHAR_INFO> cells;
+};
+static std::vector<CachedCharInfoRow> s_charInfoRowCache;
+
+// Routine Description:
+// - Returns the CHAR_INFO rendition of an entire row of the given screen buffer.
+// - The console lock must be held when calling this routine, and the returned
+//   span is only valid until the next call.
+// Arguments:
+// - screenInfo - the screen buffer to read from
+// - y - the row to read
+// Return Value:
+// - The row converted into CHAR_INFOs.
+static gsl::span<const CHAR_INFO> _GetCharInfoRow(const SCREEN_INFORMATION& screenInfo, const SHORT y)
+{
+    const auto& gci = ServiceLocator::LocateGlobals().getConsoleInformation();
+    const auto& textBuffer = screenInfo.GetTextBuffer();
+    const auto generation = textBuffer.GetRowByOffset(y).GetGeneration();
+    // Default colors are mapped to the legacy default attributes, which can change without touching any row.
+    const auto legacyDefaults = TextAttribute{}.GetLegacyAttributes();
+
+    if (s_charInfoRowCache.size() < textBuffer.TotalRowCount())
+    {
+        s_charInfoRowCache.resize(textBuffer.TotalRowCount());
+    }
+
+    auto& entry = s_charInfoRowCache.at(y);
+    if (entry.generation != generation || entry.legacyDefaults != legacyDefaults)
+    {
+        const auto width = screenInfo.GetBufferSize().Width();
+        entry.cells.clear();
+        entry.cells.reserve(width);
+
+        for (auto it = screenInfo.GetCellDataAt({ 0, y }, Viewport::FromDimensions({ 0, y }, { width, 1 })); it; ++it)
+        {
+            entry.cells.push_back(gci.AsCharInfo(*it));
+        }
+
+        entry.generation = generation;
+        entry.legacyDefaults = legacyDefaults;
+    }
+
+    return entry.cells;
+}
+
 [[nodiscard]] static HRESULT _ReadConsoleOutputWImplHelper(const SCREEN_INFORMATION& context,
                                                            gsl::span<CHAR_INFO> targetBuffer,
                                                            const Microsoft::Console::Types::Viewport& requestRectangle,
@@ -786,7 +839,6 @@ void EventsToUnicode(_Inout_ std::deque<std::unique_ptr<IInputEvent>>& inEvents,
 {
     try
     {
-        const auto& gci = ServiceLocator::LocateGlobals().getConsoleInformation();
         const auto& storageBuffer = context.GetActiveBuffer();
         const auto storageSize = storageBuffer.GetBufferSize().Dimensions();
 
@@ -825,40 +877,22 @@ void EventsToUnicode(_Inout_ std::deque<std::unique_ptr<IInputEvent>>& inEvents,
         // We will start reading the buffer at the point of the top left corner (origin) of the (potentially adjusted) request
         const auto sourcePoint = clippedRequestRectangle.Origin();
 
-        // Get an iterator to the beginning of the return buffer
-        // We might have to seek this forward or skip around if we clipped the request.
-        auto targetIter = targetBuffer.begin();
-        COORD targetPos = { 0 };
-        const auto targetLimit = Viewport::FromDimensions(targetPoint, clippedRequestRectangle.Dimensions());
-
-        // Get an iterator to the beginning of the request inside the screen buffer
-        // This should walk exactly along every cell of the clipped request.
-        auto sourceIter = storageBuffer.GetCellDataAt(sourcePoint, clippedRequestRectangle);
-
-        // Walk through every cell of the target, advancing the buffer.
-        // Validate that we always still have a valid iterator to the backing store,
-        // that we always are writing inside the user's buffer (before the end)
-        // and we're always targeting the user's buffer inside its original bounds.
-        while (sourceIter && targetIter < targetBuffer.end())
+        // Copy the clipped request out of the buffer one row at a time,
+        // into the user's buffer at the same offset we clipped it by.
+        const auto width = gsl::narrow_cast<size_t>(std::max<SHORT>(0, clippedRequestRectangle.Width()));
+        if (width > 0)
         {
-            // If the point we're trying to write is inside the limited buffer write zone...
-            if (targetLimit.IsInBounds(targetPos))
+            for (SHORT row = 0; row < clippedRequestRectangle.Height(); ++row)
             {
-                // Copy the data into position...
-                *targetIter = gci.AsCharInfo(*sourceIter);
-                // ... and advance the read iterator.
-                sourceIter++;
-            }
-
-            // Always advance the write iterator, we might have skipped it due to clipping.
-            targetIter++;
+                const auto targetOffset = gsl::narrow_cast<size_t>((targetPoint.Y + row) * targetSize.X + targetPoint.X);
+                if (targetOffset + width > gsl::narrow_cast<size_t>(targetBuffer.size()))
+                {
+                    break;
+                }
 
-            // Increment the target
-            targetPos.X++;
-            if (targetPos.X >= targetSize.X)
-            {
-                targetPos.X = 0;
-                targetPos.Y++;
+                const auto sourceRow = _GetCharInfoRow(storageBuffer, gsl::narrow_cast<SHORT>(sourcePoint.Y + row));
+                const auto source = sourceRow.subspan(sourcePoint.X, width);
+                std::copy(source.begin(), source.end(), targetBuffer.begin() + targetOffset);
             }
         }
 
@@ -875,16 +909,20 @@ void EventsToUnicode(_Inout_ std::deque<std::unique_ptr<IInputEvent>>& inEvents,
                                                           const Microsoft::Console::Types::Viewport& sourceRectangle,
                                                           Microsoft::Console::Types::Viewport& readRectangle) noexcept
 {
-    LockConsole();
-    auto Unlock = wil::scope_exit([&] { UnlockConsole(); });
-
     try
     {
-        const auto& gci = ServiceLocator::LocateGlobals().getConsoleInformation();
-        const auto codepage = gci.OutputCP;
+        UINT codepage;
+        {
+            LockConsole();
+            auto Unlock = wil::scope_exit([&] { UnlockConsole(); });
 
-        RETURN_IF_FAILED(_ReadConsoleOutputWImplHelper(context, buffer, sourceRectangle, readRectangle));
+            const auto& gci = ServiceLocator::LocateGlobals().getConsoleInformation();
+            codepage = gci.OutputCP;
+
+            RETURN_IF_FAILED(_ReadConsoleOutputWImplHelper(context, buffer, sourceRectangle, readRectangle));
+        }
 
+        // The conversion only touches the caller's buffer, so it doesn't need to hold up other clients.
         LOG_IF_FAILED(_ConvertCellsToAInplace(codepage, buffer, readRectangle));
 
         return S_OK;
@@ -985,34 +1023,26 @@ void EventsToUnicode(_Inout_ std::deque<std::unique_ptr<IInputEvent>>& inEvents,
 
         const auto writeRectangle = Viewport::FromInclusive(writeRegion);
 
-        auto target = writeRectangle.Origin();
+        const auto target = writeRectangle.Origin();
 
-        // For every row in the request, create a view into the clamped portion of just the one line to write.
-        // This allows us to restrict the width of the call without allocating/copying any memory by just making
-        // a smaller view over the existing big blob of data from the original call.
-        for (; target.Y < writeRectangle.BottomExclusive(); target.Y++)
-        {
-            // We find the offset into the original buffer by the dimensions of the original request rectangle.
-            ptrdiff_t rowOffset = 0;
-            RETURN_IF_FAILED(PtrdiffTSub(target.Y, requestRectangle.Top(), &rowOffset));
-            RETURN_IF_FAILED(PtrdiffTMult(rowOffset, requestRectangle.Width(), &rowOffset));
-
-            ptrdiff_t colOffset = 0;
-            RETURN_IF_FAILED(PtrdiffTSub(target.X, requestRectangle.Left(), &colOffset));
+        // We find the offset of the clamped rectangle into the original buffer by the dimensions of the original
+        // request rectangle. Every row of the clamped rectangle is then a view into the clamped portion of just
+        // the one line to write, one request width further down the buffer. This allows us to restrict the width
+        // of the call without allocating/copying any memory.
+        ptrdiff_t rowOffset = 0;
+        RETURN_IF_FAILED(PtrdiffTSub(target.Y, requestRectangle.Top(), &rowOffset));
+        RETURN_IF_FAILED(PtrdiffTMult(rowOffset, requestRectangle.Width(), &rowOffset));
 
-            ptrdiff_t totalOffset = 0;
-            RETURN_IF_FAILED(PtrdiffTAdd(rowOffset, colOffset, &totalOffset));
+        ptrdiff_t colOffset = 0;
+        RETURN_IF_FAILED(PtrdiffTSub(target.X, requestRectangle.Left(), &colOffset));
 
-            // Now we make a subspan starting from that offset for as much of the original request as would fit
-            const auto subspan = buffer.subspan(totalOffset, writeRectangle.Width());
+        ptrdiff_t totalOffset = 0;
+        RETURN_IF_FAILED(PtrdiffTAdd(rowOffset, colOffset, &totalOffset));
 
-            // Convert to a CHAR_INFO view to fit into the iterator
-            const auto charInfos = gsl::span<const CHAR_INFO>(subspan.data(), subspan.size());
-
-            // Make the iterator and write to the target position.
-            OutputCellIterator it(charInfos);
-            storageBuffer.Write(it, target);
-        }
+        // Convert to a CHAR_INFO view and write it a row at a time, instead of cell by cell through an iterator.
+        const auto subspan = buffer.subspan(totalOffset);
+        const auto charInfos = gsl::span<const CHAR_INFO>(subspan.data(), subspan.size());
+        storageBuffer.GetTextBuffer().WriteCharInfoRect(charInfos, gsl::narrow_cast<size_t>(requestRectangle.Width()), writeRectangle);
 
         // Since we've managed to write part of the request, return the clamped part that we actually used.
         writtenRectangle = writeRectangle;
@@ -43,6 +43,11 @@ void ApiRoutines::GetConsoleInputModeImpl(InputBuffer& context, ULONG& mode) noe
     {
         Telemetry::Instance().LogApiCall(Telemetry::ApiCall::GetConsoleMode);
         const CONSOLE_INFORMATION& gci = ServiceLocator::LocateGlobals().getConsoleInformation();
+        if (!gci.IsConsoleLocked() && gci.GetApiSnapshot().TryGetInputMode(context, mode))
+        {
+            return;
+        }
+
         LockConsole();
         auto Unlock = wil::scope_exit([&] { UnlockConsole(); });
 
@@ -68,6 +73,12 @@ void ApiRoutines::GetConsoleOutputModeImpl(SCREEN_INFORMATION& context, ULONG& m
 {
     try
     {
+        const CONSOLE_INFORMATION& gci = ServiceLocator::LocateGlobals().getConsoleInformation();
+        if (!gci.IsConsoleLocked() && gci.GetApiSnapshot().TryGetOutputMode(context, mode))
+        {
+            return;
+        }
+
         LockConsole();
         auto Unlock = wil::scope_exit([&] { UnlockConsole(); });
 
@@ -108,6 +119,20 @@ void ApiRoutines::GetConsoleScreenBufferInfoExImpl(const SCREEN_INFORMATION& con
 {
     try
     {
+        // Chatty clients like progress bars ask for this all the time. Most
+        //      of the time, we can answer without waiting for the console lock.
+        //      If we're holding it ourselves, the state may be halfway through
+        //      changing, and only the real thing will do.
+        const CONSOLE_INFORMATION& gci = ServiceLocator::LocateGlobals().getConsoleInformation();
+        if (!gci.IsConsoleLocked() && gci.GetApiSnapshot().TryGetScreenBufferInfo(context, data))
+        {
+            // The snapshot holds the inclusive rect, just like
+            //      GetScreenBufferInformation returns it. See below.
+            data.srWindow.Right += 1;
+            data.srWindow.Bottom += 1;
+            return;
+        }
+
         LockConsole();
         auto Unlock = wil::scope_exit([&] { UnlockConsole(); });
 
@@ -1663,6 +1688,67 @@ void DoSrvEndHyperlink(SCREEN_INFORMATION& screenInfo)
     CATCH_RETURN();
 }
 
+// Routine Description:
+// - A private API call for beginning or ending a synchronized update.
+//   While one is in progress, the renderer doesn't paint any frames.
+// Parameters:
+// - enabled - true to begin a synchronized update, false to end it.
+// Return value:
+// - S_OK
+[[nodiscard]] HRESULT DoSrvEnableSynchronizedOutput(const bool enabled) noexcept
+{
+    auto* pRender = ServiceLocator::LocateGlobals().pRender;
+    if (pRender)
+    {
+        if (enabled)
+        {
+            pRender->SynchronizedOutputBegin();
+        }
+        else
+        {
+            pRender->SynchronizedOutputEnd();
+        }
+    }
+    return S_OK;
+}
+
+// Routine Description:
+// - A private API call for displaying an inline image. The image is added to
+//    the buffer's image cache, and the rows it covers, starting at the cursor,
+//    refer to it. The cursor is moved down with every row, without a carriage
+//    return, so it ends up in the last row of the image.
+// Parameters:
+// - screenInfo - The screen buffer to display the image in.
+// - image - The decoded image.
+// Return value:
+// - S_OK or failure code from thrown exception
+[[nodiscard]] HRESULT DoSrvPrivatePlaceImage(SCREEN_INFORMATION& screenInfo, InlineImage&& image) noexcept
+{
+    try
+    {
+        LockConsole();
+        auto Unlock = wil::scope_exit([&] { UnlockConsole(); });
+
+        auto& textBuffer = screenInfo.GetTextBuffer();
+        const auto imageRows = image.CellRows();
+        const auto column = textBuffer.GetCursor().GetPosition().X;
+        const auto imageId = textBuffer.GetImageCache().Add(std::move(image));
+
+        for (size_t imageRow = 0; imageRow < imageRows; imageRow++)
+        {
+            if (imageRow > 0)
+            {
+                RETURN_IF_NTSTATUS_FAILED(DoSrvPrivateLineFeed(screenInfo, false));
+            }
+            const auto row = textBuffer.GetCursor().GetPosition().Y;
+            textBuffer.SetImageSlice(row, { imageId, column, gsl::narrow_cast<SHORT>(imageRow) });
+        }
+
+        return S_OK;
+    }
+    CATCH_RETURN();
+}
+
 // Routine Description:
 // - A private API call for forcing the renderer to repaint the screen. If the
 //      input screen buffer is not the active one, then just do nothing. We only
@@ -2243,6 +2329,59 @@ void DoSrvPrivateMoveToBottom(SCREEN_INFORMATION& screenInfo)
     CATCH_RETURN();
 }
 
+// Routine Description:
+// - A private API call for erasing whole rows of the screen buffer. Unlike
+//    filling a region, the rows are reset in place rather than written cell
+//    by cell, and their line rendition is reset to single width.
+// Arguments:
+// - screenInfo - Reference to screen buffer info.
+// - startRow - The first row to erase.
+// - endRow - The row after the last row to erase. It's clamped to the buffer height.
+// - standardFillAttrs - If true, fill with the standard erase attributes.
+//                       If false, fill with the default attributes.
+// Return value:
+// - S_OK or failure code from thrown exception
+[[nodiscard]] HRESULT DoSrvPrivateEraseRows(SCREEN_INFORMATION& screenInfo,
+                                            const size_t startRow,
+                                            const size_t endRow,
+                                            const bool standardFillAttrs) noexcept
+{
+    try
+    {
+        LockConsole();
+        auto Unlock = wil::scope_exit([&] { UnlockConsole(); });
+
+        const auto bufferSize = screenInfo.GetBufferSize();
+        const auto clampedEnd = std::min(endRow, gsl::narrow_cast<size_t>(bufferSize.Height()));
+        if (startRow >= clampedEnd)
+        {
+            return S_OK;
+        }
+
+        // See DoSrvPrivateFillRegion for how the fill attributes are chosen.
+        auto fillAttrs = TextAttribute{};
+        if (standardFillAttrs)
+        {
+            fillAttrs = screenInfo.GetAttributes();
+            fillAttrs.SetStandardErase();
+        }
+
+        screenInfo.GetTextBuffer().EraseRows(startRow, clampedEnd, fillAttrs);
+
+        // Notify accessibility
+        if (screenInfo.HasAccessibilityEventing())
+        {
+            screenInfo.NotifyAccessibilityEventing(0,
+                                                   gsl::narrow_cast<SHORT>(startRow),
+                                                   bufferSize.RightInclusive(),
+                                                   gsl::narrow_cast<SHORT>(clampedEnd - 1));
+        }
+
+        return S_OK;
+    }
+    CATCH_RETURN();
+}
+
 // Routine Description:
 // - A private API call for moving a block of data in the screen buffer,
 //    optionally limiting the effects of the move to a clipping rectangle.
@@ -2287,3 +2426,93 @@ void DoSrvPrivateMoveToBottom(SCREEN_INFORMATION& screenInfo)
     }
     CATCH_RETURN();
 }
+
+// Routine Description:
+// - A private API call for filling a rectangular region of the screen buffer.
+// Arguments:
+// - screenInfo - Reference to screen buffer info.
+// - fillRect - Region to fill (inclusive). It's clipped to the buffer.
+// - fillChar - Character to fill the region with.
+// - fillAttrs - Attributes to fill the region with.
+// Return value:
+// - S_OK or failure code from thrown exception
+[[nodiscard]] HRESULT DoSrvPrivateFillRectangle(SCREEN_INFORMATION& screenInfo,
+                                                const SMALL_RECT fillRect,
+                                                const wchar_t fillChar,
+                                                const TextAttribute& fillAttrs) noexcept
+{
+    try
+    {
+        LockConsole();
+        auto Unlock = wil::scope_exit([&] { UnlockConsole(); });
+
+        const auto fill = Viewport::Intersect(Viewport::FromInclusive(fillRect), screenInfo.GetBufferSize());
+        if (!fill.IsValid())
+        {
+            return S_OK;
+        }
+
+        screenInfo.GetTextBuffer().FillRect(fill, fillChar, fillAttrs);
+
+        // Notify accessibility
+        if (screenInfo.HasAccessibilityEventing())
+        {
+            screenInfo.NotifyAccessibilityEventing(fill.Left(), fill.Top(), fill.RightInclusive(), fill.BottomInclusive());
+        }
+
+        return S_OK;
+    }
+    CATCH_RETURN();
+}
+
+// Routine Description:
+// - A private API call for copying a rectangular region of the screen buffer
+//    to another position. Unlike scrolling, the source region isn't filled.
+// Arguments:
+// - screenInfo - Reference to screen buffer info.
+// - sourceRect - Region to copy (inclusive). It's clipped to the buffer.
+// - targetOrigin - Upper left corner of the region to copy to.
+//                  Whatever would land outside the buffer is clipped.
+// Return value:
+// - S_OK or failure code from thrown exception
+[[nodiscard]] HRESULT DoSrvPrivateCopyRectangle(SCREEN_INFORMATION& screenInfo,
+                                                const SMALL_RECT sourceRect,
+                                                const COORD targetOrigin) noexcept
+{
+    try
+    {
+        LockConsole();
+        auto Unlock = wil::scope_exit([&] { UnlockConsole(); });
+
+        const auto buffer = screenInfo.GetBufferSize();
+        auto source = Viewport::Intersect(Viewport::FromInclusive(sourceRect), buffer);
+        if (!source.IsValid())
+        {
+            return S_OK;
+        }
+
+        // Move the target along with any part of the source that was clipped off,
+        // then clip the target and shrink the source to match it.
+        const COORD clippedTargetOrigin{ gsl::narrow_cast<SHORT>(targetOrigin.X + source.Left() - sourceRect.Left),
+                                         gsl::narrow_cast<SHORT>(targetOrigin.Y + source.Top() - sourceRect.Top) };
+        const auto target = Viewport::Intersect(Viewport::FromDimensions(clippedTargetOrigin, source.Dimensions()), buffer);
+        if (!target.IsValid())
+        {
+            return S_OK;
+        }
+        source = Viewport::FromDimensions({ gsl::narrow_cast<SHORT>(source.Left() + target.Left() - clippedTargetOrigin.X),
+                                            gsl::narrow_cast<SHORT>(source.Top() + target.Top() - clippedTargetOrigin.Y) },
+                                          target.Dimensions());
+
+        screenInfo.GetTextBuffer().CopyRect(source, target.Origin());
+
+        // Notify accessibility
+        if (screenInfo.HasAccessibilityEventing())
+        {
+            screenInfo.NotifyAccessibilityEventing(target.Left(), target.Top(), target.RightInclusive(), target.BottomInclusive());
+        }
+
+        return S_OK;
+    }
+    CATCH_RETURN();
+}
@@ -59,6 +59,10 @@ void DoSrvEndHyperlink(SCREEN_INFORMATION& screenInfo);
                                           const SIZE cellSize,
                                           const size_t centeringHint) noexcept;
 
+[[nodiscard]] HRESULT DoSrvEnableSynchronizedOutput(const bool enabled) noexcept;
+
+[[nodiscard]] HRESULT DoSrvPrivatePlaceImage(SCREEN_INFORMATION& screenInfo, InlineImage&& image) noexcept;
+
 void DoSrvPrivateRefreshWindow(const SCREEN_INFORMATION& screenInfo);
 
 [[nodiscard]] HRESULT DoSrvSetConsoleOutputCodePage(const unsigned int codepage);
@@ -86,8 +90,22 @@ void DoSrvPrivateMoveToBottom(SCREEN_INFORMATION& screenInfo);
                                              const wchar_t fillChar,
                                              const bool standardFillAttrs) noexcept;
 
+[[nodiscard]] HRESULT DoSrvPrivateEraseRows(SCREEN_INFORMATION& screenInfo,
+                                            const size_t startRow,
+                                            const size_t endRow,
+                                            const bool standardFillAttrs) noexcept;
+
 [[nodiscard]] HRESULT DoSrvPrivateScrollRegion(SCREEN_INFORMATION& screenInfo,
                                                const SMALL_RECT scrollRect,
                                                const std::optional<SMALL_RECT> clipRect,
                                                const COORD destinationOrigin,
                                                const bool standardFillAttrs) noexcept;
+
+[[nodiscard]] HRESULT DoSrvPrivateFillRectangle(SCREEN_INFORMATION& screenInfo,
+                                                const SMALL_RECT fillRect,
+                                                const wchar_t fillChar,
+                                                const TextAttribute& fillAttrs) noexcept;
+
+[[nodiscard]] HRESULT DoSrvPrivateCopyRectangle(SCREEN_INFORMATION& screenInfo,
+                                                const SMALL_RECT sourceRect,
+                                                const COORD targetOrigin) noexcept;
@@ -77,6 +77,19 @@ static bool CaseInsensitiveEquality(wchar_t a, wchar_t b)
     return ::towlower(a) == ::towlower(b);
 }
 
+// Routine Description:
+// - Creates the lowercased form of a command that FindMatchingCommand compares against.
+// Arguments:
+// - command - the command to fold
+// Return Value:
+// - the folded command
+std::wstring CommandHistory::_Fold(const std::wstring_view command)
+{
+    std::wstring folded{ command };
+    std::transform(folded.begin(), folded.end(), folded.begin(), ::towlower);
+    return folded;
+}
+
 bool CommandHistory::IsAppNameMatch(const std::wstring_view other) const
 {
     return std::equal(_appName.cbegin(), _appName.cend(), other.cbegin(), other.cend(), CaseInsensitiveEquality);
@@ -125,12 +138,14 @@ void CommandHistory::_Reset()
             if ((SHORT)_commands.size() == _maxCommands)
             {
                 _commands.erase(_commands.cbegin());
+                _foldedCommands.erase(_foldedCommands.cbegin());
                 // move LastDisplayed back one in order to stay synced with the
                 // command it referred to before erasing the lru one
                 --LastDisplayed;
             }
 
             // add newCommand to array
+            auto foldedCommand = _Fold(newCommand);
             if (!reuse.empty())
             {
                 _commands.emplace_back(reuse);
@@ -139,6 +154,7 @@ void CommandHistory::_Reset()
             {
                 _commands.emplace_back(newCommand);
             }
+            _foldedCommands.emplace_back(std::move(foldedCommand));
 
             if (LastDisplayed == -1 ||
                 _commands.at(LastDisplayed).size() != newCommand.size() ||
@@ -249,6 +265,7 @@ std::wstring_view CommandHistory::GetLastCommand() const
 void CommandHistory::Empty()
 {
     _commands.clear();
+    _foldedCommands.clear();
     LastDisplayed = -1;
     WI_SetFlag(Flags, CLE_RESET);
 }
@@ -290,6 +307,7 @@ void CommandHistory::Realloc(const size_t commands)
     {
         _commands.emplace_back(oldCommands[i]);
     }
+    _foldedCommands.resize(_commands.size());
 
     WI_SetFlag(Flags, CLE_RESET);
     LastDisplayed = gsl::narrow<SHORT>(_commands.size()) - 1;
@@ -392,6 +410,7 @@ CommandHistory* CommandHistory::s_Allocate(const std::wstring_view appName, cons
         if (!SameApp)
         {
             BestCandidate->_commands.clear();
+            BestCandidate->_foldedCommands.clear();
             BestCandidate->LastDisplayed = -1;
             BestCandidate->_appName = appName;
         }
@@ -475,6 +494,7 @@ std::wstring CommandHistory::Remove(const SHORT iDel)
         if (iDel < iLast)
         {
             _commands.erase(_commands.cbegin() + iDel);
+            _foldedCommands.erase(_foldedCommands.cbegin() + iDel);
             if ((iDisp > iDel) && (iDisp <= iLast))
             {
                 _Dec(iDisp);
@@ -484,6 +504,7 @@ std::wstring CommandHistory::Remove(const SHORT iDel)
         else if (iFirst <= iDel)
         {
             _commands.erase(_commands.cbegin() + iDel);
+            _foldedCommands.erase(_foldedCommands.cbegin() + iDel);
             if ((iDisp >= iFirst) && (iDisp < iDel))
             {
                 _Inc(iDisp);
@@ -529,16 +550,14 @@ std::wstring CommandHistory::Remove(const SHORT iDel)
 
     try
     {
-        for (size_t i = 0; i < _commands.size(); i++)
+        // Fold the given command once; the stored commands were folded when they were added.
+        const auto foldedCommand = _Fold(givenCommand);
+        for (size_t i = 0; i < _foldedCommands.size(); i++)
         {
-            const auto& storedCommand = _commands.at(indexFound);
-            if ((WI_IsFlagClear(options, MatchOptions::ExactMatch) && (givenCommand.size() <= storedCommand.size())) || (givenCommand.size() == storedCommand.size()))
+            const std::wstring_view storedCommand{ _foldedCommands.at(indexFound) };
+            if ((WI_IsFlagClear(options, MatchOptions::ExactMatch) && (foldedCommand.size() <= storedCommand.size())) || (foldedCommand.size() == storedCommand.size()))
             {
-                if (std::equal(storedCommand.begin(),
-                               storedCommand.begin() + givenCommand.size(),
-                               givenCommand.begin(),
-                               givenCommand.end(),
-                               CaseInsensitiveEquality))
+                if (storedCommand.substr(0, foldedCommand.size()) == foldedCommand)
                 {
                     return true;
                 }
@@ -567,6 +586,7 @@ void CommandHistory::s_ClearHistoryListStorage()
 void CommandHistory::Swap(const short indexA, const short indexB)
 {
     std::swap(_commands.at(indexA), _commands.at(indexB));
+    std::swap(_foldedCommands.at(indexA), _foldedCommands.at(indexB));
 }
 
 // Routine Description:
@@ -83,7 +83,12 @@ private:
     void _Dec(SHORT& ind) const;
     void _Inc(SHORT& ind) const;
 
+    static std::wstring _Fold(const std::wstring_view command);
+
     std::vector<std::wstring> _commands;
+    // Lowercased copies of _commands (same order), so that FindMatchingCommand
+    // doesn't have to fold every stored character again on each F8 press.
+    std::vector<std::wstring> _foldedCommands;
     SHORT _maxCommands;
 
     std::wstring _appName;
@@ -86,30 +86,16 @@ static void _CopyRectangle(SCREEN_INFORMATION& screenInfo,
         {
             const auto delta = targetOrigin.Y - source.Top();
 
-            screenInfo.GetTextBuffer().ScrollRows(source.Top(), source.Height(), gsl::narrow<SHORT>(delta));
+            screenInfo.GetTextBuffer().ScrollRows(source.Top(), source.Height(), delta);
 
             return;
         }
     }
 
-    // 2. We can move any other scenario in-place without copying. We just have to carefully
-    //    choose which direction we walk through filling up the target so it doesn't accidentally
-    //    erase the source material before it can be copied/moved to the new location.
-    {
-        const auto target = Viewport::FromDimensions(targetOrigin, source.Dimensions());
-        const auto walkDirection = Viewport::DetermineWalkDirection(source, target);
-
-        auto sourcePos = source.GetWalkOrigin(walkDirection);
-        auto targetPos = target.GetWalkOrigin(walkDirection);
-
-        do
-        {
-            const auto data = OutputCell(*screenInfo.GetCellDataAt(sourcePos));
-            screenInfo.Write(OutputCellIterator({ &data, 1 }), targetPos);
-
-            source.WalkInBounds(sourcePos, walkDirection);
-        } while (target.WalkInBounds(targetPos, walkDirection));
-    }
+    // 2. Any other scenario is copied a row at a time. The text buffer takes care of
+    //    walking through the rows in a direction that doesn't overwrite the source
+    //    material before it can be copied/moved to the new location.
+    screenInfo.GetTextBuffer().CopyRect(source, targetOrigin);
 }
 
 // Routine Description:
@@ -382,15 +368,19 @@ void ScrollRegion(SCREEN_INFORMATION& screenInfo,
 
     // Determine the cell we will use to fill in any revealed/uncovered space.
     // We generally use exactly what was given to us.
-    OutputCellIterator fillData(fillCharGiven, fillAttrsGiven);
+    auto fillChar = fillCharGiven;
+    auto fillAttrs = fillAttrsGiven;
 
     // However, if the character is null and we were given a null attribute (represented as legacy 0),
     // then we'll just fill with spaces and whatever the buffer's default colors are.
     if (fillCharGiven == UNICODE_NULL && fillAttrsGiven == TextAttribute{ 0 })
     {
-        fillData = OutputCellIterator(UNICODE_SPACE, screenInfo.GetAttributes());
+        fillChar = UNICODE_SPACE;
+        fillAttrs = screenInfo.GetAttributes();
     }
 
+    const OutputCellIterator fillData(fillChar, fillAttrs);
+
     // ------ 4. PREP TARGET ------
     // Now it's time to think about the target. We're only given the origin of the target
     // because it is assumed that it will have the same relative dimensions as the original source.
@@ -450,14 +440,28 @@ void ScrollRegion(SCREEN_INFORMATION& screenInfo,
     for (size_t i = 0; i < remaining.size(); i++)
     {
         const auto& view = remaining.at(i);
-        screenInfo.WriteRect(fillData, view);
 
         // If we're scrolling an area that encompasses the full buffer width,
         // then the filled rows should also have their line rendition reset.
         if (view.Width() == buffer.Width() && destinationOriginGiven.X == 0)
         {
+            // Blank rows, like the ones that full-width scrolls and VT line
+            // insertions/deletions uncover, can be reset in place, which
+            // takes care of the line rendition too. That saves us writing
+            // every cell of rows that the copy above only moved around.
+            if (fillChar == UNICODE_SPACE)
+            {
+                screenInfo.GetTextBuffer().EraseRows(gsl::narrow_cast<size_t>(view.Top()), gsl::narrow_cast<size_t>(view.BottomExclusive()), fillAttrs);
+                continue;
+            }
+
+            screenInfo.WriteRect(fillData, view);
             screenInfo.GetTextBuffer().ResetLineRenditionRange(view.Top(), view.BottomExclusive());
         }
+        else
+        {
+            screenInfo.WriteRect(fillData, view);
+        }
     }
 }
 
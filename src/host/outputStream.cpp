@@ -762,6 +762,28 @@ bool ConhostInternalGetSet::PrivateFillRegion(const COORD startPosition,
                                             standardFillAttrs));
 }
 
+// Routine Description:
+// - Connects the PrivateEraseRows call directly into our Driver Message servicing
+//    call inside Conhost.exe
+//   PrivateEraseRows is an internal-only "API" call that the vt commands can execute,
+//    but it is not represented as a function call on our public API surface.
+// Arguments:
+// - startRow - The first row to erase.
+// - endRow - The row after the last row to erase.
+// - standardFillAttrs - If true, fill with the standard erase attributes.
+//                       If false, fill with the default attributes.
+// Return value:
+// - true if successful (see DoSrvPrivateEraseRows). false otherwise.
+bool ConhostInternalGetSet::PrivateEraseRows(const size_t startRow,
+                                             const size_t endRow,
+                                             const bool standardFillAttrs) noexcept
+{
+    return SUCCEEDED(DoSrvPrivateEraseRows(_io.GetActiveOutputBuffer(),
+                                           startRow,
+                                           endRow,
+                                           standardFillAttrs));
+}
+
 // Routine Description:
 // - Connects the PrivateScrollRegion call directly into our Driver Message servicing
 //    call inside Conhost.exe
@@ -787,6 +809,45 @@ bool ConhostInternalGetSet::PrivateScrollRegion(const SMALL_RECT scrollRect,
                                               standardFillAttrs));
 }
 
+// Routine Description:
+// - Connects the PrivateFillRectangle call directly into our Driver Message servicing
+//    call inside Conhost.exe
+//   PrivateFillRectangle is an internal-only "API" call that the vt commands can execute,
+//    but it is not represented as a function call on our public API surface.
+// Arguments:
+// - fillRect - Region to fill (inclusive).
+// - fillChar - Character to fill the region with.
+// - fillAttrs - Attributes to fill the region with.
+// Return value:
+// - true if successful (see DoSrvPrivateFillRectangle). false otherwise.
+bool ConhostInternalGetSet::PrivateFillRectangle(const SMALL_RECT fillRect,
+                                                 const wchar_t fillChar,
+                                                 const TextAttribute& fillAttrs) noexcept
+{
+    return SUCCEEDED(DoSrvPrivateFillRectangle(_io.GetActiveOutputBuffer(),
+                                               fillRect,
+                                               fillChar,
+                                               fillAttrs));
+}
+
+// Routine Description:
+// - Connects the PrivateCopyRectangle call directly into our Driver Message servicing
+//    call inside Conhost.exe
+//   PrivateCopyRectangle is an internal-only "API" call that the vt commands can execute,
+//    but it is not represented as a function call on our public API surface.
+// Arguments:
+// - sourceRect - Region to copy (inclusive).
+// - targetOrigin - Upper left corner of the region to copy to.
+// Return value:
+// - true if successful (see DoSrvPrivateCopyRectangle). false otherwise.
+bool ConhostInternalGetSet::PrivateCopyRectangle(const SMALL_RECT sourceRect,
+                                                 const COORD targetOrigin) noexcept
+{
+    return SUCCEEDED(DoSrvPrivateCopyRectangle(_io.GetActiveOutputBuffer(),
+                                               sourceRect,
+                                               targetOrigin));
+}
+
 // Routine Description:
 // - Checks if the InputBuffer is willing to accept VT Input directly
 //   PrivateIsVtInputEnabled is an internal-only "API" call that the vt commands can execute,
@@ -833,3 +894,25 @@ bool ConhostInternalGetSet::PrivateUpdateSoftFont(const gsl::span<const uint16_t
 {
     return SUCCEEDED(DoSrvUpdateSoftFont(bitPattern, cellSize, centeringHint));
 }
+
+// Routine Description:
+// - Begins or ends a synchronized update of the screen.
+// Arguments:
+// - enabled - true to hold off painting, false to paint again.
+// Return Value:
+// - true if successful (see DoSrvEnableSynchronizedOutput). false otherwise.
+bool ConhostInternalGetSet::PrivateEnableSynchronizedOutput(const bool enabled) noexcept
+{
+    return SUCCEEDED(DoSrvEnableSynchronizedOutput(enabled));
+}
+
+// Routine Description:
+// - Displays an inline image at the cursor position.
+// Arguments:
+// - image - The decoded image.
+// Return Value:
+// - true if successful (see DoSrvPrivatePlaceImage). false otherwise.
+bool ConhostInternalGetSet::PrivatePlaceImage(InlineImage&& image) noexcept
+{
+    return SUCCEEDED(DoSrvPrivatePlaceImage(_io.GetActiveOutputBuffer(), std::move(image)));
+}
@@ -137,11 +137,21 @@ public:
                            const wchar_t fillChar,
                            const bool standardFillAttrs) noexcept override;
 
+    bool PrivateEraseRows(const size_t startRow,
+                          const size_t endRow,
+                          const bool standardFillAttrs) noexcept override;
+
     bool PrivateScrollRegion(const SMALL_RECT scrollRect,
                              const std::optional<SMALL_RECT> clipRect,
                              const COORD destinationOrigin,
                              const bool standardFillAttrs) noexcept override;
 
+    bool PrivateFillRectangle(const SMALL_RECT fillRect,
+                              const wchar_t fillChar,
+                              const TextAttribute& fillAttrs) noexcept override;
+    bool PrivateCopyRectangle(const SMALL_RECT sourceRect,
+                              const COORD targetOrigin) noexcept override;
+
     bool PrivateIsVtInputEnabled() const override;
 
     bool PrivateAddHyperlink(const std::wstring_view uri, const std::wstring_view params) const override;
@@ -151,6 +161,10 @@ public:
                                const SIZE cellSize,
                                const size_t centeringHint) noexcept override;
 
+    bool PrivateEnableSynchronizedOutput(const bool enabled) noexcept override;
+
+    bool PrivatePlaceImage(InlineImage&& image) noexcept override;
+
 private:
     Microsoft::Console::IIoProvider& _io;
 };
@@ -577,6 +577,7 @@ bool COOKED_READ_DATA::ProcessInput(const wchar_t wchOrig,
     else
     {
         bool CallWrite = true;
+        size_t firstChangedChar = _currentPosition;
         const SHORT sScreenBufferSizeX = _screenInfo.GetBufferSize().Width();
 
         // processing in the middle of the line is more complex:
@@ -642,6 +643,7 @@ bool COOKED_READ_DATA::ProcessInput(const wchar_t wchOrig,
                         loop = true;
                     }
                 }
+                firstChangedChar = _currentPosition;
             }
             else
             {
@@ -653,6 +655,7 @@ bool COOKED_READ_DATA::ProcessInput(const wchar_t wchOrig,
             // store the char
             if (wch == UNICODE_CARRIAGERETURN)
             {
+                firstChangedChar = _bytesRead / sizeof(WCHAR);
                 _bufPtr = (PWCHAR)((PBYTE)_backupLimit + _bytesRead);
                 *_bufPtr = wch;
                 _bufPtr += 1;
@@ -707,32 +710,16 @@ bool COOKED_READ_DATA::ProcessInput(const wchar_t wchOrig,
             CursorPosition = _screenInfo.GetTextBuffer().GetCursor().GetPosition();
             CursorPosition.X = (SHORT)(CursorPosition.X + NumSpaces);
 
-            // clear the current command line from the screen
-            // clang-format off
-#pragma prefast(suppress: __WARNING_BUFFER_OVERFLOW, "Not sure why prefast doesn't like this call.")
-            // clang-format on
-            DeleteCommandLine(*this, FALSE);
-
-            // write the new command line to the screen
-            NumToWrite = _bytesRead;
-
+            // write the new command line to the screen, from where it changed onwards
             DWORD dwFlags = WC_DESTRUCTIVE_BACKSPACE | WC_PRINTABLE_CONTROL_CHARS;
             if (wch == UNICODE_CARRIAGERETURN)
             {
                 dwFlags |= WC_KEEP_CURSOR_VISIBLE;
             }
-            status = WriteCharsLegacy(_screenInfo,
-                                      _backupLimit,
-                                      _backupLimit,
-                                      _backupLimit,
-                                      &NumToWrite,
-                                      &_visibleCharCount,
-                                      _originalCursorPosition.X,
-                                      dwFlags,
-                                      &ScrollY);
+            status = RewriteCommandLine(*this, firstChangedChar, dwFlags, &ScrollY);
             if (!NT_SUCCESS(status))
             {
-                RIPMSG1(RIP_WARNING, "WriteCharsLegacy failed 0x%x", status);
+                RIPMSG1(RIP_WARNING, "RewriteCommandLine failed 0x%x", status);
                 _bytesRead = 0;
                 return true;
             }
@@ -349,7 +349,7 @@ const std::wstring RenderData::GetHyperlinkCustomId(uint16_t id) const noexcept
 }
 
 // For now, we ignore regex patterns in conhost
-const std::vector<size_t> RenderData::GetPatternId(const COORD /*location*/) const noexcept
+gsl::span<const Microsoft::Console::Render::PatternSpan> RenderData::GetPatternSpans(const SHORT /*row*/) const noexcept
 {
     return {};
 }
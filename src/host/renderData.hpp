@@ -58,7 +58,7 @@ public:
     const std::wstring GetHyperlinkUri(uint16_t id) const noexcept override;
     const std::wstring GetHyperlinkCustomId(uint16_t id) const noexcept override;
 
-    const std::vector<size_t> GetPatternId(const COORD location) const noexcept override;
+    gsl::span<const Microsoft::Console::Render::PatternSpan> GetPatternSpans(const SHORT row) const noexcept override;
 #pragma endregion
 
 #pragma region IUiaData
@@ -89,6 +89,7 @@ SCREEN_INFORMATION::~SCREEN_INFORMATION()
 // - coordWindowSize - the initial size of screen buffer's window (in rows/columns)
 // - nFont - the initial font to generate text with.
 // - dwScreenBufferSize - the initial size of the screen buffer (in rows/columns).
+// - recycledTextBuffer - optionally, a text buffer of coordScreenBufferSize to reuse.
 // Return Value:
 [[nodiscard]] NTSTATUS SCREEN_INFORMATION::CreateInstance(_In_ COORD coordWindowSize,
                                                           const FontInfo fontInfo,
@@ -96,7 +97,8 @@ SCREEN_INFORMATION::~SCREEN_INFORMATION()
                                                           const TextAttribute defaultAttributes,
                                                           const TextAttribute popupAttributes,
                                                           const UINT uiCursorSize,
-                                                          _Outptr_ SCREEN_INFORMATION** const ppScreen)
+                                                          _Outptr_ SCREEN_INFORMATION** const ppScreen,
+                                                          std::unique_ptr<TextBuffer> recycledTextBuffer)
 {
     *ppScreen = nullptr;
 
@@ -117,10 +119,18 @@ SCREEN_INFORMATION::~SCREEN_INFORMATION()
         pScreen->UpdateBottom();
 
         // Set up text buffer
-        pScreen->_textBuffer = std::make_unique<TextBuffer>(coordScreenBufferSize,
-                                                            defaultAttributes,
-                                                            uiCursorSize,
-                                                            pScreen->_renderTarget);
+        if (recycledTextBuffer)
+        {
+            recycledTextBuffer->Recycle(pScreen->_renderTarget, defaultAttributes, uiCursorSize);
+            pScreen->_textBuffer = std::move(recycledTextBuffer);
+        }
+        else
+        {
+            pScreen->_textBuffer = std::make_unique<TextBuffer>(coordScreenBufferSize,
+                                                                defaultAttributes,
+                                                                uiCursorSize,
+                                                                pScreen->_renderTarget);
+        }
 
         const auto& gci = ServiceLocator::LocateGlobals().getConsoleInformation();
         pScreen->_textBuffer->GetCursor().SetColor(gci.GetCursorColor());
@@ -1895,13 +1905,31 @@ const SCREEN_INFORMATION& SCREEN_INFORMATION::GetMainBuffer() const
     auto initAttributes = GetAttributes();
     initAttributes.SetStandardErase();
 
+    // Reuse the text buffer of the last alternate buffer if it has the right size.
+    // Entering the alternate buffer then only has to clear it, instead of allocating all of its rows again.
+    auto& siMain = GetMainBuffer();
+    std::unique_ptr<TextBuffer> recycledTextBuffer;
+    if (siMain._recycledAltTextBuffer)
+    {
+        const auto recycledSize = siMain._recycledAltTextBuffer->GetSize().Dimensions();
+        if (recycledSize.X == WindowSize.X && recycledSize.Y == WindowSize.Y)
+        {
+            recycledTextBuffer = std::move(siMain._recycledAltTextBuffer);
+        }
+        else
+        {
+            siMain._recycledAltTextBuffer.reset();
+        }
+    }
+
     NTSTATUS Status = SCREEN_INFORMATION::CreateInstance(WindowSize,
                                                          existingFont,
                                                          WindowSize,
                                                          initAttributes,
                                                          GetPopupAttributes(),
                                                          Cursor::CURSOR_SMALL_SIZE,
-                                                         ppsiNewScreenBuffer);
+                                                         ppsiNewScreenBuffer,
+                                                         std::move(recycledTextBuffer));
     if (NT_SUCCESS(Status))
     {
         // Update the alt buffer's cursor style, visibility, and position to match our own.
@@ -1966,6 +1994,11 @@ const SCREEN_INFORMATION& SCREEN_INFORMATION::GetMainBuffer() const
 
         ::SetActiveScreenBuffer(*psiNewAltBuffer);
 
+        if (gci.IsInVtIoMode())
+        {
+            LOG_IF_FAILED(gci.GetVtIo()->SwitchScreenBuffer(true));
+        }
+
         // Kind of a hack until we have proper signal channels: If the client app wants window size events, send one for
         // the new alt buffer's size (this is so WSL can update the TTY size when the MainSB.viewportWidth <
         // MainSB.bufferWidth (which can happen with wrap text disabled))
@@ -1997,6 +2030,11 @@ void SCREEN_INFORMATION::UseMainScreenBuffer()
         ::SetActiveScreenBuffer(*psiMain);
         psiMain->UpdateScrollBars(); // The alt had disabled scrollbars, re-enable them
 
+        if (gci.IsInVtIoMode())
+        {
+            LOG_IF_FAILED(gci.GetVtIo()->SwitchScreenBuffer(false));
+        }
+
         // send a _coordScreenBufferSizeChangeEvent for the new Sb viewport
         ScreenBufferSizeChange(psiMain->GetBufferSize().Dimensions());
 
@@ -2010,6 +2048,7 @@ void SCREEN_INFORMATION::UseMainScreenBuffer()
         mainCursor.SetIsVisible(altCursor.IsVisible());
         mainCursor.SetBlinkingAllowed(altCursor.IsBlinkingAllowed());
 
+        psiMain->_recycledAltTextBuffer = std::move(psiAlt->_textBuffer);
         s_RemoveScreenBuffer(psiAlt); // this will also delete the alt buffer
         // deleting the alt buffer will give the GetSet back to its main
 
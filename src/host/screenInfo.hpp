@@ -67,7 +67,8 @@ public:
                                                  const TextAttribute defaultAttributes,
                                                  const TextAttribute popupAttributes,
                                                  const UINT uiCursorSize,
-                                                 _Outptr_ SCREEN_INFORMATION** const ppScreen);
+                                                 _Outptr_ SCREEN_INFORMATION** const ppScreen,
+                                                 std::unique_ptr<TextBuffer> recycledTextBuffer = nullptr);
 
     ~SCREEN_INFORMATION();
 
@@ -287,6 +288,11 @@ private:
     SCREEN_INFORMATION* _psiAlternateBuffer; // The VT "Alternate" screen buffer.
     SCREEN_INFORMATION* _psiMainBuffer; // A pointer to the main buffer, if this is the alternate buffer.
 
+    // The text buffer of the last alternate buffer, kept by the main buffer once
+    // that's gone, so that the next alternate buffer of the same size can reuse it.
+    // Only its memory is reused. Its render target is replaced before it's used again.
+    std::unique_ptr<TextBuffer> _recycledAltTextBuffer;
+
     RECT _rcAltSavedClientNew;
     RECT _rcAltSavedClientOld;
     bool _fAltWindowChanged;
@@ -23,6 +23,7 @@ Revision History:
 #include "conimeinfo.h"
 #include "VtIo.hpp"
 #include "CursorBlinker.hpp"
+#include "ApiSnapshot.hpp"
 
 #include "../server/ProcessList.h"
 #include "../server/WaitQueue.h"
@@ -143,6 +144,7 @@ public:
     friend class SCREEN_INFORMATION;
     friend class CommonState;
     Microsoft::Console::CursorBlinker& GetCursorBlinker() noexcept;
+    const Microsoft::Console::ApiSnapshot& GetApiSnapshot() const noexcept;
     Microsoft::Console::Render::BlinkingState& GetBlinkingState() const noexcept;
 
     CHAR_INFO AsCharInfo(const OutputCellView& cell) const noexcept;
@@ -161,6 +163,7 @@ private:
 
     Microsoft::Console::VirtualTerminal::VtIo _vtIo;
     Microsoft::Console::CursorBlinker _blinker;
+    Microsoft::Console::ApiSnapshot _apiSnapshot;
     mutable Microsoft::Console::Render::BlinkingState _blinkingState;
 };
 
@@ -62,8 +62,10 @@ try
 
     // Check if this conhost is allowed to delegate its activities to another.
     // If so, look up the registered default console handler.
+    // A PTY never hands its clients off (see _shouldAttemptHandoff),
+    // so it doesn't need to dig those out of the registry either.
     bool isEnabled = false;
-    if (SUCCEEDED(Microsoft::Console::Internal::DefaultApp::CheckDefaultAppPolicy(isEnabled)) && isEnabled)
+    if (!args->InConptyMode() && SUCCEEDED(Microsoft::Console::Internal::DefaultApp::CheckDefaultAppPolicy(isEnabled)) && isEnabled)
     {
         IID delegationClsid;
         if (SUCCEEDED(DelegationConfig::s_GetDefaultConsoleId(delegationClsid)))
@@ -769,6 +771,10 @@ PWSTR TranslateConsoleTitle(_In_ PCWSTR pwszConsoleTitle, const BOOL fUnexpand,
         // Allow the renderer to paint.
         g.pRender->EnablePainting();
 
+        // Whether it's painting our window or the output of a pseudoconsole,
+        // rendering is what the user waits on to see their input echoed.
+        g.pRender->SetThreadSchedulingClass(Microsoft::Console::Types::ThreadScheduling::Class::Interactive);
+
         // Set up the renderer to be used to calculate the width of a glyph,
         //      should we be unable to figure out its width another way.
         auto pfn = std::bind(&Renderer::IsGlyphWideByFont, static_cast<Renderer*>(g.pRender), std::placeholders::_1);
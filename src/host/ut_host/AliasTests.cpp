@@ -371,6 +371,24 @@ class AliasTests
         VERIFY_ARE_EQUAL(dwLinesExpected, dwLines, L"Line count be updated to 1.");
     }
 
+    TEST_METHOD(TestMatchAndCopyIgnoresCase)
+    {
+        std::wstring exe(L"exe.exe");
+        std::wstring source(L"Source");
+        std::wstring target(L"someTarget $1 $*");
+        Alias::s_TestAddAlias(exe, source, target);
+
+        size_t lineCount = 0;
+        const auto actual = Alias::s_MatchAndCopyAlias(L"  sOURCE one two\r\n", L"EXE.exe", lineCount);
+
+        VERIFY_ARE_EQUAL(String(L"someTarget one one two\r\n"), String(actual.data()));
+        VERIFY_ARE_EQUAL(1u, lineCount);
+
+        Log::Comment(L"Only the first word of the line is looked up.");
+        VERIFY_IS_TRUE(Alias::s_MatchAndCopyAlias(L"Sourceone two", L"exe.exe", lineCount).empty());
+        VERIFY_IS_TRUE(Alias::s_MatchAndCopyAlias(L"Source", L"other.exe", lineCount).empty());
+    }
+
     TEST_METHOD(TrimTrailing)
     {
         BEGIN_TEST_METHOD_PROPERTIES()
@@ -389,9 +407,10 @@ class AliasTests
         _ReplacePercentWithCRLF(target);
         _ReplacePercentWithCRLF(expected);
 
-        Alias::s_TrimTrailingCrLf(target);
+        std::wstring_view trimmed{ target };
+        Alias::s_TrimTrailingCrLf(trimmed);
 
-        VERIFY_ARE_EQUAL(String(expected.data()), String(target.data()));
+        VERIFY_ARE_EQUAL(String(expected.data()), String(std::wstring{ trimmed }.data()));
     }
 
     TEST_METHOD(Tokenize)
@@ -408,7 +427,7 @@ class AliasTests
 
         for (size_t i = 0; i < tokensExpected.size(); i++)
         {
-            VERIFY_ARE_EQUAL(String(tokensExpected[i].data()), String(tokensActual[i].data()));
+            VERIFY_ARE_EQUAL(String(tokensExpected[i].data()), String(std::wstring{ tokensActual[i] }.data()));
         }
     }
 
@@ -424,7 +443,7 @@ class AliasTests
 
         for (size_t i = 0; i < tokensExpected.size(); i++)
         {
-            VERIFY_ARE_EQUAL(String(tokensExpected[i].data()), String(tokensActual[i].data()));
+            VERIFY_ARE_EQUAL(String(tokensExpected[i].data()), String(std::wstring{ tokensActual[i] }.data()));
         }
     }
 
@@ -442,7 +461,7 @@ class AliasTests
         std::wstring expected;
         _RetrieveTargetExpectedPair(target, expected);
 
-        std::wstring actual = Alias::s_GetArgString(target);
+        std::wstring actual{ Alias::s_GetArgString(target) };
 
         VERIFY_ARE_EQUAL(String(expected.data()), String(actual.data()));
     }
@@ -470,7 +489,7 @@ class AliasTests
         std::wstring expected;
         _RetrieveTargetExpectedPair(target, expected);
 
-        std::deque<std::wstring> tokens;
+        std::vector<std::wstring_view> tokens;
         tokens.emplace_back(L"alias");
         tokens.emplace_back(L"one");
         tokens.emplace_back(L"two");
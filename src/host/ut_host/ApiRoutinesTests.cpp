@@ -202,6 +202,29 @@ class ApiRoutinesTests
         VerifySetConsoleInputModeImpl(E_INVALIDARG, 0x1E4);
     }
 
+    TEST_METHOD(ApiGetConsoleOutputModeSeesChanges)
+    {
+        CONSOLE_INFORMATION& gci = ServiceLocator::LocateGlobals().getConsoleInformation();
+        SCREEN_INFORMATION& si = gci.GetActiveOutputBuffer();
+        ULONG mode = 0;
+
+        Log::Comment(L"Setting the mode publishes it, so it can be queried without the lock.");
+        VERIFY_SUCCEEDED(_pApiRoutines->SetConsoleOutputModeImpl(si, ENABLE_PROCESSED_OUTPUT));
+        VERIFY_IS_TRUE(gci.GetApiSnapshot().TryGetOutputMode(si, mode));
+        VERIFY_ARE_EQUAL(gsl::narrow_cast<ULONG>(ENABLE_PROCESSED_OUTPUT), mode);
+
+        VERIFY_SUCCEEDED(_pApiRoutines->SetConsoleOutputModeImpl(si, ENABLE_PROCESSED_OUTPUT | ENABLE_WRAP_AT_EOL_OUTPUT));
+        _pApiRoutines->GetConsoleOutputModeImpl(si, mode);
+        VERIFY_ARE_EQUAL(gsl::narrow_cast<ULONG>(ENABLE_PROCESSED_OUTPUT | ENABLE_WRAP_AT_EOL_OUTPUT), mode);
+
+        Log::Comment(L"While the lock is held, the mode may be changing, so the query looks at the buffer itself.");
+        gci.LockConsole();
+        auto unlock = wil::scope_exit([&] { gci.UnlockConsole(); });
+        si.OutputMode = ENABLE_WRAP_AT_EOL_OUTPUT;
+        _pApiRoutines->GetConsoleOutputModeImpl(si, mode);
+        VERIFY_ARE_EQUAL(gsl::narrow_cast<ULONG>(ENABLE_WRAP_AT_EOL_OUTPUT), mode);
+    }
+
     TEST_METHOD(ApiGetConsoleTitleA)
     {
         CONSOLE_INFORMATION& gci = ServiceLocator::LocateGlobals().getConsoleInformation();
@@ -429,6 +452,80 @@ class ApiRoutinesTests
         }
     }
 
+    TEST_METHOD(ApiWriteConsoleALargeUtf8)
+    {
+        CONSOLE_INFORMATION& gci = ServiceLocator::LocateGlobals().getConsoleInformation();
+        SCREEN_INFORMATION& si = gci.GetActiveOutputBuffer();
+
+        gci.LockConsole();
+        auto Unlock = wil::scope_exit([&] { gci.UnlockConsole(); });
+
+        gci.OutputCP = CP_UTF8;
+        SetConsoleCPInfo(TRUE);
+
+        Log::Comment(L"Write enough text to be split into several chunks, with a multi-byte character straddling the first boundary.");
+        std::string testText(64 * 1024 - 1, 'a');
+        testText.append("\xe3\x82\xab");
+        testText.append(150 * 1024, 'b');
+        testText.append("\n");
+
+        size_t cchRead = 0;
+        std::unique_ptr<IWaitRoutine> waiter;
+        const HRESULT hr = _pApiRoutines->WriteConsoleAImpl(si, testText, cchRead, false, waiter);
+
+        VERIFY_ARE_EQUAL(S_OK, hr, L"Successful result code from writing.");
+        VERIFY_IS_NULL(waiter.get(), L"We should have no waiter for this case.");
+        VERIFY_ARE_EQUAL(testText.size(), cchRead, L"We should have the same byte count back as 'written' that we gave in.");
+    }
+
+    TEST_METHOD(ApiReadConsoleOutputWSeesChanges)
+    {
+        CONSOLE_INFORMATION& gci = ServiceLocator::LocateGlobals().getConsoleInformation();
+        SCREEN_INFORMATION& si = gci.GetActiveOutputBuffer();
+
+        gci.LockConsole();
+        auto Unlock = wil::scope_exit([&] { gci.UnlockConsole(); });
+
+        si.GetActiveBuffer().ClearTextData();
+
+        const auto region = Viewport::FromDimensions({ 1, 2 }, { 3, 2 });
+        std::array<CHAR_INFO, 6> buffer{};
+        auto read = Viewport::Empty();
+
+        const auto verifyRegion = [&](const std::wstring_view expected, const WORD attributes) {
+            VERIFY_SUCCEEDED(_pApiRoutines->ReadConsoleOutputWImpl(si, buffer, region, read));
+            VERIFY_ARE_EQUAL(region.ToInclusive(), read.ToInclusive());
+            for (size_t i = 0; i < buffer.size(); ++i)
+            {
+                VERIFY_ARE_EQUAL(expected.at(i), buffer.at(i).Char.UnicodeChar, NoThrowString().Format(L"i == %zu", i));
+                VERIFY_ARE_EQUAL(attributes, buffer.at(i).Attributes, NoThrowString().Format(L"i == %zu", i));
+            }
+        };
+
+        CHAR_INFO fill;
+        fill.Char.UnicodeChar = L'A';
+        fill.Attributes = FOREGROUND_RED;
+        si.GetActiveBuffer().Write(OutputCellIterator(fill), { 0, 0 });
+
+        Log::Comment(L"Read the same region twice. The second read must match the first.");
+        verifyRegion(L"AAAAAA", FOREGROUND_RED);
+        verifyRegion(L"AAAAAA", FOREGROUND_RED);
+
+        Log::Comment(L"Change one of the rows and make sure the next read reflects it.");
+        si.GetActiveBuffer().Write(OutputCellIterator(L"xyz"), { 1, 3 });
+        verifyRegion(L"AAAxyz", FOREGROUND_RED);
+
+        Log::Comment(L"Changing the legacy default attributes changes how default colored cells read back.");
+        const wchar_t space = L' ';
+        si.GetActiveBuffer().Write(OutputCellIterator(space, TextAttribute{}), { 0, 0 });
+        const auto legacyDefaults = TextAttribute{}.GetLegacyAttributes();
+        auto restoreDefaults = wil::scope_exit([&] { TextAttribute::SetLegacyDefaultAttributes(legacyDefaults); });
+        TextAttribute::SetLegacyDefaultAttributes(FOREGROUND_BLUE);
+        verifyRegion(L"      ", FOREGROUND_BLUE);
+        TextAttribute::SetLegacyDefaultAttributes(FOREGROUND_GREEN);
+        verifyRegion(L"      ", FOREGROUND_GREEN);
+    }
+
     TEST_METHOD(ApiWriteConsoleW)
     {
         BEGIN_TEST_METHOD_PROPERTIES()
@@ -9,6 +9,7 @@
 #include "globals.h"
 
 #include "../interactivity/win32/Clipboard.hpp"
+#include "../interactivity/inc/EventSynthesis.hpp"
 #include "../interactivity/inc/ServiceLocator.hpp"
 
 #include "dbcs.h"
@@ -186,6 +187,35 @@ class ClipboardTests
         }
     }
 
+    TEST_METHOD(CanConvertRepeatedTextLikeSingleChars)
+    {
+        Log::Comment(L"Converting a whole string must give the same events as converting each character on its own.");
+        std::wstring wstr;
+        for (int i = 0; i < 100; ++i)
+        {
+            wstr.append(L"Hello, World! 123 \x20ac\xbc");
+        }
+
+        const UINT codepage = ServiceLocator::LocateGlobals().getConsoleInformation().OutputCP;
+        std::deque<std::unique_ptr<IInputEvent>> events = Clipboard::Instance().TextToKeyEvents(wstr.c_str(),
+                                                                                                wstr.size());
+
+        std::deque<std::unique_ptr<KeyEvent>> expectedEvents;
+        for (wchar_t wch : wstr)
+        {
+            auto convertedEvents = CharToKeyEvents(wch, codepage);
+            std::move(convertedEvents.begin(), convertedEvents.end(), std::back_inserter(expectedEvents));
+        }
+
+        VERIFY_ARE_EQUAL(expectedEvents.size(), events.size());
+
+        for (size_t i = 0; i < events.size(); ++i)
+        {
+            const KeyEvent currentKeyEvent = *reinterpret_cast<const KeyEvent* const>(events[i].get());
+            VERIFY_ARE_EQUAL(*expectedEvents[i], currentKeyEvent, NoThrowString().Format(L"i == %d", i));
+        }
+    }
+
     TEST_METHOD(CanConvertUppercaseText)
     {
         std::wstring wstr = L"HeLlO WoRlD";
@@ -25,7 +25,13 @@ static const std::vector<std::tuple<unsigned int, std::wstring, CodepointWidth>>
     { 0x30CA, L"\x30CA", CodepointWidth::Wide }, // U+30CA katakana na
     { 0x72D7, L"\x72D7", CodepointWidth::Wide }, // U+72D7
     { 0x1F47E, L"\xD83D\xDC7E", CodepointWidth::Wide }, // U+1F47E alien monster
-    { 0x1F51C, L"\xD83D\xDD1C", CodepointWidth::Wide } // U+1F51C SOON
+    { 0x1F51C, L"\xD83D\xDD1C", CodepointWidth::Wide }, // U+1F51C SOON
+    { 0x2500, L"\x2500", CodepointWidth::Narrow }, // U+2500 box drawings light horizontal (overridden)
+    { 0xE000, L"\xE000", CodepointWidth::Ambiguous }, // U+E000 private use
+    { 0xFF01, L"\xFF01", CodepointWidth::Wide }, // U+FF01 fullwidth exclamation mark
+    { 0xFF61, L"\xFF61", CodepointWidth::Narrow }, // U+FF61 halfwidth ideographic full stop
+    { 0x20000, L"\xD840\xDC00", CodepointWidth::Wide }, // U+20000 CJK unified ideograph extension B
+    { 0x10FFFD, L"\xDBFF\xDFFD", CodepointWidth::Ambiguous } // U+10FFFD plane 16 private use
 };
 
 class CodepointWidthDetectorTests
@@ -62,6 +68,62 @@ class CodepointWidthDetectorTests
         }
     }
 
+    TEST_METHOD(CanDetectAmbiguousChars)
+    {
+        for (const auto& data : testData)
+        {
+            const auto& wstr = std::get<1>(data);
+            if (wstr.size() == 1)
+            {
+                const auto expected = std::get<2>(data) == CodepointWidth::Ambiguous;
+                VERIFY_ARE_EQUAL(expected, CodepointWidthDetector::IsAmbiguous(wstr.front()));
+            }
+        }
+    }
+
+    TEST_METHOD(CanClassifyWidthsOfRun)
+    {
+        CodepointWidthDetector widthDetector;
+        std::pmr::vector<CodepointWidth> widths;
+
+        Log::Comment(L"Printable ASCII doesn't need any widths to be stored.");
+        VERIFY_IS_TRUE(widthDetector.ClassifyWidths(L"Hello, World! ~", widths).empty());
+        VERIFY_IS_TRUE(widths.empty());
+
+        Log::Comment(L"Otherwise every glyph gets the same width as GetWidth would return.");
+        std::wstring text = L"abc";
+        for (const auto& data : testData)
+        {
+            text += std::get<1>(data);
+            text += L"xyz";
+        }
+        // An unpaired surrogate is classified on its own.
+        text += L'\xD83E';
+
+        const auto result = widthDetector.ClassifyWidths(text, widths);
+        VERIFY_ARE_EQUAL(text.size(), result.size());
+
+        size_t pos = 0;
+        VERIFY_ARE_EQUAL(CodepointWidth::Narrow, result[pos++]);
+        VERIFY_ARE_EQUAL(CodepointWidth::Narrow, result[pos++]);
+        VERIFY_ARE_EQUAL(CodepointWidth::Narrow, result[pos++]);
+        for (const auto& data : testData)
+        {
+            const auto& wstr = std::get<1>(data);
+            VERIFY_ARE_EQUAL(widthDetector.GetWidth(wstr), result[pos]);
+            if (wstr.size() == 2)
+            {
+                VERIFY_ARE_EQUAL(CodepointWidth::Invalid, result[pos + 1]);
+            }
+            pos += wstr.size();
+
+            VERIFY_ARE_EQUAL(CodepointWidth::Narrow, result[pos++]);
+            VERIFY_ARE_EQUAL(CodepointWidth::Narrow, result[pos++]);
+            VERIFY_ARE_EQUAL(CodepointWidth::Narrow, result[pos++]);
+        }
+        VERIFY_ARE_EQUAL(widthDetector.GetWidth(L"\xD83E"), result[pos]);
+    }
+
     static bool FallbackMethod(const std::wstring_view glyph)
     {
         if (glyph.size() < 1)
@@ -81,21 +143,43 @@ class CodepointWidthDetectorTests
         widthDetector.SetFallbackMethod(std::bind(&FallbackMethod, std::placeholders::_1));
 
         // Ensure fallback cache is empty.
-        VERIFY_ARE_EQUAL(0u, widthDetector._fallbackCache.size());
+        VERIFY_ARE_EQUAL(0u, widthDetector._fallbackCache.Size());
 
         // Lookup ambiguous width character.
         widthDetector.IsWide(ambiguous);
 
         // Cache should hold it.
-        VERIFY_ARE_EQUAL(1u, widthDetector._fallbackCache.size());
+        VERIFY_ARE_EQUAL(1u, widthDetector._fallbackCache.Size());
 
         // Cached item should match what we expect
-        const auto it = widthDetector._fallbackCache.begin();
-        VERIFY_ARE_EQUAL(ambiguous, it->first);
-        VERIFY_ARE_EQUAL(FallbackMethod(ambiguous), it->second);
+        const auto cached = widthDetector._fallbackCache.Find(0x414);
+        VERIFY_IS_TRUE(cached.has_value());
+        VERIFY_ARE_EQUAL(FallbackMethod(ambiguous), cached.value());
 
         // Cache should empty when font changes.
         widthDetector.NotifyFontChanged();
-        VERIFY_ARE_EQUAL(0u, widthDetector._fallbackCache.size());
+        VERIFY_ARE_EQUAL(0u, widthDetector._fallbackCache.Size());
+        VERIFY_IS_FALSE(widthDetector._fallbackCache.Find(0x414).has_value());
+    }
+
+    TEST_METHOD(FallbackCacheGrows)
+    {
+        CodepointWidthDetector widthDetector;
+
+        // Enough codepoints to make the table grow a few times, including
+        // neighboring ones that land next to each other in the table.
+        for (unsigned int codepoint = 0xE000; codepoint < 0xE400; codepoint++)
+        {
+            widthDetector._fallbackCache.Insert(codepoint, (codepoint % 3) == 0);
+        }
+        VERIFY_ARE_EQUAL(0x400u, widthDetector._fallbackCache.Size());
+
+        for (unsigned int codepoint = 0xE000; codepoint < 0xE400; codepoint++)
+        {
+            const auto cached = widthDetector._fallbackCache.Find(codepoint);
+            VERIFY_IS_TRUE(cached.has_value());
+            VERIFY_ARE_EQUAL((codepoint % 3) == 0, cached.value());
+        }
+        VERIFY_IS_FALSE(widthDetector._fallbackCache.Find(0xE400).has_value());
     }
 };
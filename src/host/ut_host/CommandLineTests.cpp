@@ -147,6 +147,47 @@ class CommandLineTests
         VerifyPromptText(cookedReadData, L"echo 2");
     }
 
+    TEST_METHOD(CycleCommandHistoryRewritesOnlyChangedText)
+    {
+        auto buffer = std::make_unique<wchar_t[]>(PROMPT_SIZE);
+        VERIFY_IS_NOT_NULL(buffer.get());
+
+        auto& consoleInfo = ServiceLocator::LocateGlobals().getConsoleInformation();
+        auto& screenInfo = consoleInfo.GetActiveOutputBuffer();
+        auto& cookedReadData = consoleInfo.CookedReadData();
+        InitCookedReadData(cookedReadData, m_pHistory, buffer.get(), PROMPT_SIZE);
+        VERIFY_IS_TRUE(cookedReadData.IsEchoInput());
+
+        const auto origin = cookedReadData.OriginalCursorPosition();
+        const auto readScreen = [&](const size_t length) {
+            std::wstring text;
+            for (auto it = screenInfo.GetCellDataAt(origin); it && text.size() < length; ++it)
+            {
+                text.append(it->Chars());
+            }
+            return text;
+        };
+
+        VERIFY_SUCCEEDED(m_pHistory->Add(L"echo 12345", false));
+        VERIFY_SUCCEEDED(m_pHistory->Add(L"echo 1", false));
+
+        auto& commandLine = CommandLine::Instance();
+        commandLine._processHistoryCycling(cookedReadData, CommandHistory::SearchDirection::Previous);
+        commandLine._processHistoryCycling(cookedReadData, CommandHistory::SearchDirection::Previous);
+        VerifyPromptText(cookedReadData, L"echo 12345");
+        VERIFY_ARE_EQUAL(L"echo 12345", readScreen(10));
+        VERIFY_ARE_EQUAL(10u, cookedReadData.VisibleCharCount());
+
+        Log::Comment(L"Recalling a shorter command that starts the same must erase what's left of the longer one.");
+        commandLine._processHistoryCycling(cookedReadData, CommandHistory::SearchDirection::Next);
+        VerifyPromptText(cookedReadData, L"echo 1");
+        VERIFY_ARE_EQUAL(L"echo 1    ", readScreen(10));
+        VERIFY_ARE_EQUAL(6u, cookedReadData.VisibleCharCount());
+
+        const COORD expectedCursor{ gsl::narrow<SHORT>(origin.X + 6), origin.Y };
+        VERIFY_ARE_EQUAL(expectedCursor, screenInfo.GetTextBuffer().GetCursor().GetPosition());
+    }
+
     TEST_METHOD(CanSetPromptToOldestHistory)
     {
         auto buffer = std::make_unique<wchar_t[]>(PROMPT_SIZE);
@@ -0,0 +1,93 @@
+// Copyright (c) Microsoft Corporation.
+// Licensed under the MIT license.
+
+#include "precomp.h"
+#include "WexTestClass.h"
+#include "../../inc/consoletaeftemplates.hpp"
+
+#include "../../types/inc/GraphemeSegmenter.hpp"
+
+using namespace WEX::Common;
+using namespace WEX::Logging;
+using namespace WEX::TestExecution;
+
+class GraphemeSegmenterTests
+{
+    TEST_CLASS(GraphemeSegmenterTests);
+
+    TEST_METHOD(EmptyTextHasNoCluster)
+    {
+        VERIFY_ARE_EQUAL(0u, GraphemeSegmenter::GetClusterLength(L""));
+    }
+
+    TEST_METHOD(AsciiIsOneClusterPerCharacter)
+    {
+        VERIFY_ARE_EQUAL(1u, GraphemeSegmenter::GetClusterLength(L"ab"));
+        VERIFY_ARE_EQUAL(1u, GraphemeSegmenter::GetClusterLength(L"a"));
+        VERIFY_ARE_EQUAL(1u, GraphemeSegmenter::GetClusterLength(L"\ra"));
+        VERIFY_ARE_EQUAL(1u, GraphemeSegmenter::GetClusterLength(L"\n\r"));
+    }
+
+    TEST_METHOD(CarriageReturnLineFeedIsOneCluster)
+    {
+        VERIFY_ARE_EQUAL(2u, GraphemeSegmenter::GetClusterLength(L"\r\na"));
+    }
+
+    TEST_METHOD(CombiningMarksJoinTheirBase)
+    {
+        // e, combining acute accent, combining dot below
+        VERIFY_ARE_EQUAL(3u, GraphemeSegmenter::GetClusterLength(L"e\x0301\x0323x"));
+        // A control doesn't take combining marks.
+        VERIFY_ARE_EQUAL(1u, GraphemeSegmenter::GetClusterLength(L"\n\x0301"));
+    }
+
+    TEST_METHOD(RegionalIndicatorsPairUp)
+    {
+        const std::wstring_view flag{ L"\xD83C\xDDFA\xD83C\xDDF8" }; // U+1F1FA U+1F1F8 flag of the united states
+        VERIFY_ARE_EQUAL(4u, GraphemeSegmenter::GetClusterLength(flag));
+
+        std::wstring twoFlags{ flag };
+        twoFlags += flag;
+        VERIFY_ARE_EQUAL(4u, GraphemeSegmenter::GetClusterLength(twoFlags));
+
+        std::wstring threeIndicators{ twoFlags.substr(0, 6) };
+        VERIFY_ARE_EQUAL(4u, GraphemeSegmenter::GetClusterLength(threeIndicators));
+        VERIFY_ARE_EQUAL(2u, GraphemeSegmenter::GetClusterLength(std::wstring_view{ threeIndicators }.substr(4)));
+    }
+
+    TEST_METHOD(EmojiZwjSequenceIsOneCluster)
+    {
+        // U+1F468 U+200D U+1F469 U+200D U+1F467 family: man, woman, girl
+        VERIFY_ARE_EQUAL(8u, GraphemeSegmenter::GetClusterLength(L"\xD83D\xDC68\x200D\xD83D\xDC69\x200D\xD83D\xDC67x"));
+        // A ZWJ only joins an emoji to an emoji.
+        VERIFY_ARE_EQUAL(2u, GraphemeSegmenter::GetClusterLength(L"a\x200D\xD83D\xDC68"));
+    }
+
+    TEST_METHOD(HangulSyllablesAreOneCluster)
+    {
+        // U+1100 choseong kiyeok, U+1161 jungseong a, U+11A8 jongseong kiyeok
+        VERIFY_ARE_EQUAL(3u, GraphemeSegmenter::GetClusterLength(L"\x1100\x1161\x11A8x"));
+        // U+AC00 precomposed syllable ga (LV), U+11A8 jongseong kiyeok
+        VERIFY_ARE_EQUAL(2u, GraphemeSegmenter::GetClusterLength(L"\xAC00\x11A8\x1100"));
+    }
+
+    TEST_METHOD(UnpairedSurrogatesAreClustersOfTheirOwn)
+    {
+        VERIFY_ARE_EQUAL(1u, GraphemeSegmenter::GetClusterLength(L"\xD800x"));
+        VERIFY_ARE_EQUAL(1u, GraphemeSegmenter::GetClusterLength(L"e\xDC00"));
+    }
+
+    TEST_METHOD(GetPropertyClassifiesCodepoints)
+    {
+        VERIFY_ARE_EQUAL(GraphemeBreakProperty::Other, GraphemeSegmenter::GetProperty(U'a'));
+        VERIFY_ARE_EQUAL(GraphemeBreakProperty::CR, GraphemeSegmenter::GetProperty(U'\r'));
+        VERIFY_ARE_EQUAL(GraphemeBreakProperty::LF, GraphemeSegmenter::GetProperty(U'\n'));
+        VERIFY_ARE_EQUAL(GraphemeBreakProperty::Extend, GraphemeSegmenter::GetProperty(0x0301));
+        VERIFY_ARE_EQUAL(GraphemeBreakProperty::ZWJ, GraphemeSegmenter::GetProperty(0x200D));
+        VERIFY_ARE_EQUAL(GraphemeBreakProperty::RegionalIndicator, GraphemeSegmenter::GetProperty(0x1F1FA));
+        VERIFY_ARE_EQUAL(GraphemeBreakProperty::LV, GraphemeSegmenter::GetProperty(0xAC00));
+        VERIFY_ARE_EQUAL(GraphemeBreakProperty::LVT, GraphemeSegmenter::GetProperty(0xAC01));
+        VERIFY_ARE_EQUAL(GraphemeBreakProperty::ExtendedPictographic, GraphemeSegmenter::GetProperty(0x1F468));
+        VERIFY_ARE_EQUAL(GraphemeBreakProperty::Other, GraphemeSegmenter::GetProperty(0x10FFFF));
+    }
+};
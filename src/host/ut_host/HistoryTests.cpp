@@ -242,6 +242,43 @@ class HistoryTests
         VERIFY_ARE_EQUAL(2ul, history->GetNumberOfCommands());
     }
 
+    TEST_METHOD(FindMatchingCommandAfterEdits)
+    {
+        auto history = CommandHistory::s_Allocate(_manyApps[0], _MakeHandle(0));
+        VERIFY_IS_NOT_NULL(history);
+
+        // Overflow the buffer so the oldest commands age out.
+        for (auto& item : _manyHistoryItems)
+        {
+            VERIFY_SUCCEEDED(history->Add(item, false));
+        }
+        VERIFY_ARE_EQUAL(s_BufferSize, history->GetNumberOfCommands());
+
+        SHORT index;
+        Log::Comment(L"Prefix matches are case insensitive and find the most recent command first.");
+        VERIFY_IS_TRUE(history->FindMatchingCommand(L"IPCONFIG", history->LastDisplayed, index, CommandHistory::MatchOptions::JustLooking));
+        VERIFY_ARE_EQUAL(String(L"ipconfig /all"), String(history->GetNth(index).data()));
+
+        Log::Comment(L"Aged out commands can't be found anymore.");
+        VERIFY_IS_FALSE(history->FindMatchingCommand(L"dir /w", history->LastDisplayed, index, CommandHistory::MatchOptions::JustLooking));
+
+        Log::Comment(L"Exact matches don't accept longer commands.");
+        VERIFY_IS_TRUE(history->FindMatchingCommand(L"Ipconfig", history->LastDisplayed, index, CommandHistory::MatchOptions::ExactMatch | CommandHistory::MatchOptions::JustLooking));
+        VERIFY_ARE_EQUAL(String(L"ipconfig"), String(history->GetNth(index).data()));
+
+        Log::Comment(L"Removed and swapped commands are matched at their new location.");
+        const auto removed = history->Remove(index);
+        VERIFY_ARE_EQUAL(String(L"ipconfig"), String(removed.data()));
+        VERIFY_IS_FALSE(history->FindMatchingCommand(L"ipconfig", history->LastDisplayed, index, CommandHistory::MatchOptions::ExactMatch | CommandHistory::MatchOptions::JustLooking));
+
+        history->Swap(0, 1);
+        VERIFY_IS_TRUE(history->FindMatchingCommand(L"TELNET", history->LastDisplayed, index, CommandHistory::MatchOptions::JustLooking));
+        VERIFY_ARE_EQUAL(0i16, index);
+
+        history->Empty();
+        VERIFY_IS_FALSE(history->FindMatchingCommand(L"git", history->LastDisplayed, index, CommandHistory::MatchOptions::JustLooking));
+    }
+
 private:
     const std::array<std::wstring, 5> _manyApps = {
         L"foo.exe",
@@ -305,6 +305,32 @@ class OutputCellIteratorTests
         VERIFY_IS_FALSE(it);
     }
 
+    TEST_METHOD(GraphemeClusterStringData)
+    {
+        SetVerifyOutput settings(VerifyOutputSettings::LogOnlyFailures);
+
+        // e with a combining acute accent, devanagari ki (ka with the vowel sign i), and a plain x
+        const std::wstring testText(L"e\x0301\x0915\x093Fx");
+        const std::wstring_view text{ testText };
+
+        OutputCellIterator it(testText);
+
+        VERIFY_IS_TRUE(it);
+        VERIFY_ARE_EQUAL(text.substr(0, 2), it->Chars());
+        VERIFY_IS_TRUE(it->DbcsAttr().IsSingle());
+        it++;
+
+        VERIFY_IS_TRUE(it);
+        VERIFY_ARE_EQUAL(text.substr(2, 2), it->Chars());
+        it++;
+
+        VERIFY_IS_TRUE(it);
+        VERIFY_ARE_EQUAL(text.substr(4, 1), it->Chars());
+        it++;
+
+        VERIFY_IS_FALSE(it);
+    }
+
     TEST_METHOD(StringDataWithColor)
     {
         SetVerifyOutput settings(VerifyOutputSettings::LogOnlyFailures);
@@ -511,4 +537,72 @@ class OutputCellIteratorTests
         VERIFY_ARE_EQUAL(cellsExpected, it.GetCellDistance(original));
         VERIFY_ARE_EQUAL(inputExpected, it.GetInputDistance(original));
     }
+
+    TEST_METHOD(NarrowRunOfString)
+    {
+        SetVerifyOutput settings(VerifyOutputSettings::LogOnlyFailures);
+
+        const std::wstring testText(L"Hello, world!");
+        const TextAttribute color(FOREGROUND_GREEN | FOREGROUND_INTENSITY);
+
+        OutputCellIterator it(testText, color);
+        const auto original = it;
+
+        VERIFY_IS_FALSE(it.IsFill());
+        VERIFY_ARE_EQUAL(testText.size(), it.GetNarrowRunLength(100));
+        VERIFY_ARE_EQUAL(5u, it.GetNarrowRunLength(5));
+
+        it.AdvanceNarrowRun(5);
+        OutputCellView expected({ &testText.at(5), 1 },
+                                {},
+                                color,
+                                TextAttributeBehavior::Stored);
+        VERIFY_IS_TRUE(it);
+        VERIFY_ARE_EQUAL(expected, *it);
+        VERIFY_ARE_EQUAL(5, it.GetCellDistance(original));
+
+        it.AdvanceNarrowRun(it.GetNarrowRunLength(100));
+        VERIFY_IS_FALSE(it);
+        VERIFY_ARE_EQUAL(0u, it.GetNarrowRunLength(100));
+    }
+
+    TEST_METHOD(NoNarrowRunOfFullWidthString)
+    {
+        SetVerifyOutput settings(VerifyOutputSettings::LogOnlyFailures);
+
+        const std::wstring testText(L"abc\x30a2\x30a3");
+
+        OutputCellIterator it(testText);
+
+        // Once the run contains wide glyphs, it has to be walked cell by cell.
+        VERIFY_ARE_EQUAL(0u, it.GetNarrowRunLength(100));
+    }
+
+    TEST_METHOD(NarrowRunOfFill)
+    {
+        SetVerifyOutput settings(VerifyOutputSettings::LogOnlyFailures);
+
+        const wchar_t wch = L'Q';
+        const size_t limit = 5;
+
+        OutputCellIterator it(wch, limit);
+
+        VERIFY_IS_TRUE(it.IsFill());
+        VERIFY_ARE_EQUAL(limit, it.GetNarrowRunLength(100));
+        VERIFY_ARE_EQUAL(3u, it.GetNarrowRunLength(3));
+
+        it.AdvanceNarrowRun(3);
+        VERIFY_IS_TRUE(it);
+        VERIFY_ARE_EQUAL(2u, it.GetNarrowRunLength(100));
+
+        it.AdvanceNarrowRun(2);
+        VERIFY_IS_FALSE(it);
+
+        OutputCellIterator unlimited(wch);
+        VERIFY_ARE_EQUAL(100u, unlimited.GetNarrowRunLength(100));
+
+        const wchar_t wide = L'\x30a2';
+        OutputCellIterator wideFill(wide, limit);
+        VERIFY_ARE_EQUAL(0u, wideFill.GetNarrowRunLength(100));
+    }
 };
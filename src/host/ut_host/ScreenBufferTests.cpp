@@ -91,6 +91,8 @@ class ScreenBufferTests
 
     TEST_METHOD(AlternateBufferCursorInheritanceTest);
 
+    TEST_METHOD(AlternateBufferTextBufferRecycling);
+
     TEST_METHOD(TestReverseLineFeed);
 
     TEST_METHOD(TestResetClearTabStops);
@@ -411,6 +413,43 @@ void ScreenBufferTests::AlternateBufferCursorInheritanceTest()
     VERIFY_ARE_EQUAL(altCursorBlinking, mainCursor.IsBlinkingAllowed());
 }
 
+void ScreenBufferTests::AlternateBufferTextBufferRecycling()
+{
+    auto& gci = ServiceLocator::LocateGlobals().getConsoleInformation();
+    gci.LockConsole(); // Lock must be taken to manipulate buffer.
+    auto unlock = wil::scope_exit([&] { gci.UnlockConsole(); });
+
+    auto& mainBuffer = gci.GetActiveOutputBuffer();
+    auto& stateMachine = mainBuffer.GetStateMachine();
+
+    Log::Comment(L"Switch to the alternate buffer and fill it with some text.");
+    VERIFY_SUCCEEDED(mainBuffer.UseAlternateScreenBuffer());
+    auto* const firstTextBuffer = &gci.GetActiveOutputBuffer().GetTextBuffer();
+    stateMachine.ProcessString(L"\x1b[H\x1b[31mfoo\x1b#6\x1b]8;;https://example.com\x1b\\bar\x1b]8;;\x1b\\");
+
+    Log::Comment(L"Switch back to the main buffer and to the alternate buffer again.");
+    gci.GetActiveOutputBuffer().UseMainScreenBuffer();
+    VERIFY_ARE_EQUAL(&mainBuffer, &gci.GetActiveOutputBuffer());
+    VERIFY_SUCCEEDED(mainBuffer.UseAlternateScreenBuffer());
+    auto& altBuffer = gci.GetActiveOutputBuffer();
+    auto useMain = wil::scope_exit([&] { altBuffer.UseMainScreenBuffer(); });
+    auto& altTextBuffer = altBuffer.GetTextBuffer();
+
+    Log::Comment(L"Confirm the new alternate buffer reuses the text buffer of the last one.");
+    VERIFY_ARE_EQUAL(firstTextBuffer, &altTextBuffer);
+    VERIFY_ARE_EQUAL(&altBuffer.GetRenderTarget(), &altTextBuffer.GetRenderTarget());
+
+    Log::Comment(L"Confirm nothing of the last alternate buffer's contents remains.");
+    auto initAttributes = mainBuffer.GetAttributes();
+    initAttributes.SetStandardErase();
+    const auto& row = altTextBuffer.GetRowByOffset(0);
+    VERIFY_ARE_EQUAL(L" ", std::wstring{ altTextBuffer.GetCellDataAt({ 0, 0 })->Chars() });
+    VERIFY_ARE_EQUAL(L" ", std::wstring{ altTextBuffer.GetCellDataAt({ 3, 0 })->Chars() });
+    VERIFY_ARE_EQUAL(initAttributes, altTextBuffer.GetCellDataAt({ 0, 0 })->TextAttr());
+    VERIFY_ARE_EQUAL(LineRendition::SingleWidth, row.GetLineRendition());
+    VERIFY_THROWS(altTextBuffer.GetHyperlinkUriFromId(1), std::out_of_range);
+}
+
 void ScreenBufferTests::TestReverseLineFeed()
 {
     CONSOLE_INFORMATION& gci = ServiceLocator::LocateGlobals().getConsoleInformation();
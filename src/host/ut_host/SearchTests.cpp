@@ -156,4 +156,87 @@ class SearchTests
         Search s(gci.renderData, L"\x304b", Search::Direction::Backward, Search::Sensitivity::CaseInsensitive);
         DoFoundChecks(s, coordStartExpected, -1);
     }
+
+    TEST_METHOD(FindAllMatchesFindNext)
+    {
+        auto& gci = ServiceLocator::LocateGlobals().getConsoleInformation();
+
+        for (const auto needle : { L"AB", L"ab", L"\x304b", L"AB\x304b" })
+        {
+            for (const auto sensitivity : { Search::Sensitivity::CaseSensitive, Search::Sensitivity::CaseInsensitive })
+            {
+                Log::Comment(NoThrowString().Format(L"Needle '%s', case %s", needle, sensitivity == Search::Sensitivity::CaseSensitive ? L"sensitive" : L"insensitive"));
+
+                Search s(gci.renderData, needle, Search::Direction::Forward, sensitivity);
+                std::vector<Search::Match> expected;
+                while (s.FindNext())
+                {
+                    expected.push_back(s.GetFoundLocation());
+                }
+
+                const auto actual = s.FindAll();
+                VERIFY_ARE_EQUAL(expected.size(), actual.size());
+                for (size_t i = 0; i < expected.size(); ++i)
+                {
+                    VERIFY_ARE_EQUAL(expected.at(i).first, actual.at(i).first);
+                    VERIFY_ARE_EQUAL(expected.at(i).second, actual.at(i).second);
+                }
+            }
+        }
+    }
+
+    TEST_METHOD(FindNextInWrapsAroundAnchor)
+    {
+        auto& gci = ServiceLocator::LocateGlobals().getConsoleInformation();
+
+        Search forward(gci.renderData, L"AB", Search::Direction::Forward, Search::Sensitivity::CaseSensitive, { 1, 3 });
+        VERIFY_IS_TRUE(forward.FindNextIn(forward.FindAll()));
+        VERIFY_ARE_EQUAL(COORD({ 0, 0 }), forward._coordSelStart);
+
+        Search backward(gci.renderData, L"AB", Search::Direction::Backward, Search::Sensitivity::CaseSensitive, { 1, 0 });
+        VERIFY_IS_TRUE(backward.FindNextIn(backward.FindAll()));
+        VERIFY_ARE_EQUAL(COORD({ 0, 0 }), backward._coordSelStart);
+
+        Search none(gci.renderData, L"not in the buffer", Search::Direction::Forward, Search::Sensitivity::CaseSensitive);
+        VERIFY_IS_FALSE(none.FindNextIn(none.FindAll()));
+    }
+
+    TEST_METHOD(FindAllRegex)
+    {
+        auto& gci = ServiceLocator::LocateGlobals().getConsoleInformation();
+
+        Log::Comment(L"Matches map back onto cells, including both halves of wide glyphs");
+        auto matches = Search::s_FindAllRegex(gci.renderData, L"b\x304b+c", Search::Sensitivity::CaseInsensitive, SIZE_MAX);
+        VERIFY_ARE_EQUAL(4u, matches.size());
+        for (SHORT y = 0; y < 4; ++y)
+        {
+            VERIFY_ARE_EQUAL(COORD({ 1, y }), matches.at(y).first);
+            VERIFY_ARE_EQUAL(COORD({ 4, y }), matches.at(y).second);
+        }
+
+        Log::Comment(L"Case sensitive searches don't match other cases");
+        matches = Search::s_FindAllRegex(gci.renderData, L"b\x304b+c", Search::Sensitivity::CaseSensitive, SIZE_MAX);
+        VERIFY_ARE_EQUAL(0u, matches.size());
+
+        Log::Comment(L"The search stops at the match limit");
+        matches = Search::s_FindAllRegex(gci.renderData, L"AB", Search::Sensitivity::CaseSensitive, 2);
+        VERIFY_ARE_EQUAL(2u, matches.size());
+
+        Log::Comment(L"A cancelled search returns nothing more");
+        matches = Search::s_FindAllRegex(gci.renderData, L"AB", Search::Sensitivity::CaseSensitive, SIZE_MAX, []() { return true; });
+        VERIFY_ARE_EQUAL(0u, matches.size());
+
+        Log::Comment(L"Matches only span rows that were wrapped");
+        matches = Search::s_FindAllRegex(gci.renderData, L"DE +AB", Search::Sensitivity::CaseSensitive, SIZE_MAX);
+        VERIFY_ARE_EQUAL(0u, matches.size());
+
+        gci.GetActiveOutputBuffer().GetTextBuffer().GetRowByOffset(0).SetWrapForced(true);
+        matches = Search::s_FindAllRegex(gci.renderData, L"DE +AB", Search::Sensitivity::CaseSensitive, SIZE_MAX);
+        VERIFY_ARE_EQUAL(1u, matches.size());
+        VERIFY_ARE_EQUAL(COORD({ 7, 0 }), matches.at(0).first);
+        VERIFY_ARE_EQUAL(COORD({ 1, 1 }), matches.at(0).second);
+
+        Log::Comment(L"Invalid patterns throw");
+        VERIFY_THROWS(Search::s_FindAllRegex(gci.renderData, L"(", Search::Sensitivity::CaseSensitive, SIZE_MAX), std::regex_error);
+    }
 };
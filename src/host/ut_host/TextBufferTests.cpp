@@ -134,12 +134,26 @@ class TextBufferTests
     TEST_METHOD(TestBackspaceStrings);
     TEST_METHOD(TestBackspaceStringsAPI);
 
+    TEST_METHOD(TestWriteCharsLegacyPrintableRuns);
+
     TEST_METHOD(TestRepeatCharacter);
 
     TEST_METHOD(ResizeTraditional);
 
     TEST_METHOD(ResizeTraditionalRotationPreservesHighUnicode);
     TEST_METHOD(ScrollBufferRotationPreservesHighUnicode);
+    TEST_METHOD(ScrollRowsAcrossCircularBufferWrap);
+    TEST_METHOD(FillAndCopyRect);
+    TEST_METHOD(WriteCharInfoRect);
+    TEST_METHOD(ImageSlicesAndCache);
+    TEST_METHOD(GenHTMLAndRTFFromColorRuns);
+    TEST_METHOD(GenExportFromColorRuns);
+    TEST_METHOD(RowArenaPreservesRowsAcrossRotation);
+    TEST_METHOD(FrozenRowsThawOnAccess);
+    TEST_METHOD(RowArenaReusesFrozenCells);
+    TEST_METHOD(MeasureRightWithoutThawing);
+    TEST_METHOD(SpilledRowsThawOnAccess);
+    TEST_METHOD(EraseRowsClearsLazily);
 
     TEST_METHOD(ResizeTraditionalHighUnicodeRowRemoval);
     TEST_METHOD(ResizeTraditionalHighUnicodeColumnRemoval);
@@ -148,14 +162,17 @@ class TextBufferTests
 
     void WriteLinesToBuffer(const std::vector<std::wstring>& text, TextBuffer& buffer);
     TEST_METHOD(GetWordBoundaries);
+    TEST_METHOD(GetWordBoundariesWithNonAsciiDelimiters);
     TEST_METHOD(MoveByWord);
     TEST_METHOD(GetGlyphBoundaries);
 
     TEST_METHOD(GetTextRects);
     TEST_METHOD(GetText);
+    TEST_METHOD(GetTextOfLargeSelection);
 
     TEST_METHOD(HyperlinkTrim);
     TEST_METHOD(NoHyperlinkTrim);
+    TEST_METHOD(HyperlinkTrimAfterOverwrite);
 };
 
 void TextBufferTests::TestBufferCreate()
@@ -189,7 +206,7 @@ void TextBufferTests::TestBufferRowByOffset()
     short sId = csBufferHeight / 2 - 5;
 
     const ROW& row = textBuffer.GetRowByOffset(sId);
-    VERIFY_ARE_EQUAL(row.GetId(), sId);
+    VERIFY_ARE_EQUAL(row.GetId(), gsl::narrow_cast<size_t>(sId));
 }
 
 void TextBufferTests::TestWrapFlag()
@@ -1610,6 +1627,36 @@ void TextBufferTests::TestBackspaceStringsAPI()
     VERIFY_ARE_EQUAL(cursor.GetPosition().Y, y0);
 }
 
+void TextBufferTests::TestWriteCharsLegacyPrintableRuns()
+{
+    // Printable ASCII is copied in bulk by WriteCharsLegacy. Make sure that
+    // this still plays along with the control characters around it and with
+    // wrapping at the end of the row.
+    CONSOLE_INFORMATION& gci = ServiceLocator::LocateGlobals().getConsoleInformation();
+    SCREEN_INFORMATION& si = gci.GetActiveOutputBuffer().GetActiveBuffer();
+    const TextBuffer& tbi = si.GetTextBuffer();
+    const Cursor& cursor = tbi.GetCursor();
+
+    gci.SetVirtTermLevel(0);
+    WI_ClearFlag(si.OutputMode, ENABLE_VIRTUAL_TERMINAL_PROCESSING);
+
+    si.GetTextBuffer().GetCursor().SetPosition({ 0, 0 });
+    const auto width = gsl::narrow_cast<size_t>(si.GetBufferSize().Width());
+
+    std::wstring str = L"ab\tcd\r\n";
+    str.append(width + 3, L'x');
+    size_t cb = str.size() * sizeof(wchar_t);
+    VERIFY_SUCCESS_NTSTATUS(WriteCharsLegacy(si, str.data(), str.data(), str.data(), &cb, nullptr, cursor.GetPosition().X, 0, nullptr));
+    VERIFY_ARE_EQUAL(str.size() * sizeof(wchar_t), cb);
+
+    VERIFY_ARE_EQUAL(std::wstring{ L"ab      cd" }, tbi.GetRowByOffset(0).GetText().substr(0, 10));
+    VERIFY_ARE_EQUAL(std::wstring(width, L'x'), tbi.GetRowByOffset(1).GetText());
+    VERIFY_ARE_EQUAL(std::wstring{ L"xxx " }, tbi.GetRowByOffset(2).GetText().substr(0, 4));
+
+    VERIFY_ARE_EQUAL(3, cursor.GetPosition().X);
+    VERIFY_ARE_EQUAL(2, cursor.GetPosition().Y);
+}
+
 void TextBufferTests::TestRepeatCharacter()
 {
     CONSOLE_INFORMATION& gci = ServiceLocator::LocateGlobals().getConsoleInformation();
@@ -1854,7 +1901,7 @@ void TextBufferTests::ResizeTraditionalRotationPreservesHighUnicode()
     VERIFY_ARE_EQUAL(String(bButton), String(readBackText.data(), gsl::narrow<int>(readBackText.size())));
 
     // Make it the first row in the buffer so it will rotate around when we resize and cause renumbering
-    const SHORT delta = _buffer->GetFirstRowIndex() - pos.Y;
+    const SHORT delta = gsl::narrow<SHORT>(_buffer->GetFirstRowIndex()) - pos.Y;
     const COORD newPos{ pos.X, pos.Y + delta };
 
     _buffer->_SetFirstRowIndex(pos.Y);
@@ -1910,6 +1957,415 @@ void TextBufferTests::ScrollBufferRotationPreservesHighUnicode()
     VERIFY_ARE_EQUAL(String(fire), String(shouldBeFireText.data(), gsl::narrow<int>(shouldBeFireText.size())));
 }
 
+// This tests that scrolling a region which wraps around the end of the storage
+// moves only the rows in the region and leaves the circular buffer's first row alone.
+void TextBufferTests::ScrollRowsAcrossCircularBufferWrap()
+{
+    const COORD bufferSize{ 20, 10 };
+    const UINT cursorSize = 12;
+    const TextAttribute attr{ 0x7f };
+    auto _buffer = std::make_unique<TextBuffer>(bufferSize, attr, cursorSize, _renderTarget);
+
+    // Put the first row near the end of the storage, so that logical rows 2 and up wrap around.
+    const size_t firstRow = 8;
+    _buffer->_SetFirstRowIndex(firstRow);
+
+    for (SHORT row = 0; row < bufferSize.Y; ++row)
+    {
+        const auto marker = std::to_wstring(row);
+        _buffer->WriteLine(OutputCellIterator(marker), { 0, row });
+    }
+
+    const auto verifyRows = [&](const std::array<int, 10>& expected) {
+        for (SHORT row = 0; row < bufferSize.Y; ++row)
+        {
+            const auto& r = _buffer->GetRowByOffset(row);
+            VERIFY_ARE_EQUAL((firstRow + row) % bufferSize.Y, r.GetId());
+
+            const auto marker = std::to_wstring(til::at(expected, row));
+            const auto text = *_buffer->GetTextDataAt({ 0, row });
+            VERIFY_ARE_EQUAL(String(marker.c_str()), String(text.data(), gsl::narrow<int>(text.size())));
+        }
+    };
+
+    // Move rows 1 to 4 up by one, like a scroll within margins would.
+    _buffer->ScrollRows(1, 4, -1);
+    VERIFY_ARE_EQUAL(firstRow, _buffer->GetFirstRowIndex());
+    verifyRows({ 1, 2, 3, 4, 0, 5, 6, 7, 8, 9 });
+
+    // And move rows 0 to 2 down by three.
+    _buffer->ScrollRows(0, 3, 3);
+    VERIFY_ARE_EQUAL(firstRow, _buffer->GetFirstRowIndex());
+    verifyRows({ 4, 0, 5, 1, 2, 3, 6, 7, 8, 9 });
+}
+
+// This tests the rectangular fill and copy operations, including
+// wide glyphs that get cut in half by the edges of a rectangle.
+void TextBufferTests::FillAndCopyRect()
+{
+    const COORD bufferSize{ 10, 5 };
+    const UINT cursorSize = 12;
+    const TextAttribute attr{ 0x7f };
+    auto _buffer = std::make_unique<TextBuffer>(bufferSize, attr, cursorSize, _renderTarget);
+
+    const auto rowText = [&](const SHORT row) {
+        std::wstring text;
+        for (auto it = _buffer->GetCellDataAt({ 0, row }, Viewport::FromDimensions({ 0, row }, bufferSize.X, 1)); it; ++it)
+        {
+            // Only count wide glyphs once.
+            if (!it->DbcsAttr().IsTrailing())
+            {
+                text += it->Chars();
+            }
+        }
+        return text;
+    };
+
+    for (SHORT row = 0; row < bufferSize.Y; ++row)
+    {
+        _buffer->WriteLine(OutputCellIterator{ L"0123456789" }, { 0, row });
+    }
+
+    Log::Comment(L"Filling a rectangle replaces the text and the attributes within it.");
+    const TextAttribute fillAttr{ 0x1f };
+    _buffer->FillRect(Viewport::FromInclusive({ 2, 1, 4, 2 }), L'x', fillAttr);
+    VERIFY_ARE_EQUAL(L"0123456789", rowText(0));
+    VERIFY_ARE_EQUAL(L"01xxx56789", rowText(1));
+    VERIFY_ARE_EQUAL(L"01xxx56789", rowText(2));
+    VERIFY_ARE_EQUAL(attr, _buffer->GetRowByOffset(1).GetAttrRow().GetAttrByColumn(1));
+    VERIFY_ARE_EQUAL(fillAttr, _buffer->GetRowByOffset(1).GetAttrRow().GetAttrByColumn(2));
+    VERIFY_ARE_EQUAL(fillAttr, _buffer->GetRowByOffset(1).GetAttrRow().GetAttrByColumn(4));
+    VERIFY_ARE_EQUAL(attr, _buffer->GetRowByOffset(1).GetAttrRow().GetAttrByColumn(5));
+
+    Log::Comment(L"Copying a rectangle onto an overlapping area leaves the rest of the source alone.");
+    _buffer->CopyRect(Viewport::FromInclusive({ 1, 1, 5, 2 }), { 2, 2 });
+    VERIFY_ARE_EQUAL(L"01xxx56789", rowText(1));
+    VERIFY_ARE_EQUAL(L"011xxx5789", rowText(2));
+    VERIFY_ARE_EQUAL(L"011xxx5789", rowText(3));
+    VERIFY_ARE_EQUAL(fillAttr, _buffer->GetRowByOffset(3).GetAttrRow().GetAttrByColumn(3));
+    VERIFY_ARE_EQUAL(attr, _buffer->GetRowByOffset(3).GetAttrRow().GetAttrByColumn(6));
+
+    Log::Comment(L"Wide glyphs that are cut in half by either rectangle are replaced by spaces.");
+    const auto wide = L"\x3044";
+    _buffer->WriteLine(OutputCellIterator{ L"" }, { 0, 4 });
+    _buffer->WriteLine(OutputCellIterator{ std::wstring{ L"ab" } + wide + L"cde" + wide }, { 0, 4 });
+    VERIFY_ARE_EQUAL(std::wstring{ L"ab" } + wide + L"cde" + wide + L"9", rowText(4));
+    _buffer->CopyRect(Viewport::FromInclusive({ 3, 4, 4, 4 }), { 7, 4 });
+    VERIFY_ARE_EQUAL(std::wstring{ L"ab" } + wide + L"cde c9", rowText(4));
+}
+
+// This tests that a rectangle of legacy cells is written row by row,
+// with its attributes merged into runs and its lead/trailing bytes intact.
+void TextBufferTests::WriteCharInfoRect()
+{
+    const COORD bufferSize{ 10, 4 };
+    const UINT cursorSize = 12;
+    const TextAttribute attr{ 0x7f };
+    auto _buffer = std::make_unique<TextBuffer>(bufferSize, attr, cursorSize, _renderTarget);
+
+    for (SHORT row = 0; row < bufferSize.Y; ++row)
+    {
+        _buffer->WriteLine(OutputCellIterator{ L"0123456789" }, { 0, row });
+    }
+
+    // A 4x3 source, of which only the middle 3x2 is written: the stride is wider than the target.
+    const auto wide = L'\x3044';
+    const CHAR_INFO charInfos[] = {
+        { L'a', 0x1f }, { L'b', 0x1f }, { L'c', 0x2f }, { L'-', 0x7 },
+        { L'd', 0x2f }, { wide, 0x2f | COMMON_LVB_LEADING_BYTE }, { wide, 0x2f | COMMON_LVB_TRAILING_BYTE }, { L'-', 0x7 },
+        { L'-', 0x7 }, { L'-', 0x7 }, { L'-', 0x7 }, { L'-', 0x7 },
+    };
+    _buffer->WriteCharInfoRect(gsl::make_span(charInfos), 4, Viewport::FromDimensions({ 2, 1 }, 3, 2));
+
+    VERIFY_ARE_EQUAL(L"0123456789", _buffer->GetRowByOffset(0).GetText());
+    VERIFY_ARE_EQUAL(L"01abc56789", _buffer->GetRowByOffset(1).GetText());
+    VERIFY_ARE_EQUAL(L"0123456789", _buffer->GetRowByOffset(3).GetText());
+
+    const auto& row2 = _buffer->GetRowByOffset(2);
+    VERIFY_ARE_EQUAL(std::wstring{ L"01d" } + wide + L"56789", row2.GetText());
+    VERIFY_IS_TRUE(row2.GetCharRow().DbcsAttrAt(3).IsLeading());
+    VERIFY_IS_TRUE(row2.GetCharRow().DbcsAttrAt(4).IsTrailing());
+
+    Log::Comment(L"Cells with the same colors end up in the same attribute run, even across a wide glyph.");
+    const auto& attrRow1 = _buffer->GetRowByOffset(1).GetAttrRow();
+    VERIFY_ARE_EQUAL(TextAttribute{ 0x1f }, attrRow1.GetAttrByColumn(2));
+    VERIFY_ARE_EQUAL(TextAttribute{ 0x1f }, attrRow1.GetAttrByColumn(3));
+    VERIFY_ARE_EQUAL(TextAttribute{ 0x2f }, attrRow1.GetAttrByColumn(4));
+    VERIFY_ARE_EQUAL(attr, attrRow1.GetAttrByColumn(5));
+    VERIFY_ARE_EQUAL(4u, attrRow1.GetRuns().size());
+
+    const auto& attrRow2 = row2.GetAttrRow();
+    VERIFY_ARE_EQUAL(3u, attrRow2.GetRuns().size());
+    VERIFY_ARE_EQUAL(TextAttribute{ 0x2f }, attrRow2.GetAttrByColumn(4));
+}
+
+// This tests that rows allocated out of the row arena keep their contents
+// when the storage is rotated around during a traditional resize.
+void TextBufferTests::RowArenaPreservesRowsAcrossRotation()
+{
+    // Make the rows wider than the inline capacity so they have to use the arena.
+    const COORD bufferSize{ gsl::narrow<SHORT>(CharRow::InlineCapacity + 80), 10 };
+    const UINT cursorSize = 12;
+    const TextAttribute attr{ 0x7f };
+    auto _buffer = std::make_unique<TextBuffer>(bufferSize, attr, cursorSize, _renderTarget, true);
+    VERIFY_IS_TRUE(_buffer->_rowArena.has_value());
+
+    // Write a marker at the far end of every row.
+    const SHORT column = bufferSize.X - 1;
+    for (SHORT row = 0; row < bufferSize.Y; ++row)
+    {
+        const auto marker = std::to_wstring(row);
+        _buffer->WriteLine(OutputCellIterator(marker), { column, row });
+    }
+
+    // Make row 3 the first row so the resize rotates the storage around.
+    const SHORT firstRow = 3;
+    _buffer->_SetFirstRowIndex(firstRow);
+    VERIFY_NT_SUCCESS(_buffer->ResizeTraditional(bufferSize));
+
+    // Every row should still be as wide as the buffer and
+    // every marker should have moved along with its row.
+    for (SHORT row = 0; row < bufferSize.Y; ++row)
+    {
+        const auto& charRow = _buffer->GetRowByOffset(row).GetCharRow();
+        VERIFY_ARE_EQUAL(static_cast<size_t>(bufferSize.X), charRow.size());
+
+        const auto expected = std::to_wstring((row + firstRow) % bufferSize.Y);
+        const auto text = *_buffer->GetTextDataAt({ column, row });
+        VERIFY_ARE_EQUAL(String(expected.c_str()), String(text.data(), gsl::narrow<int>(text.size())));
+    }
+
+    // A buffer that doesn't ask for it, or whose rows fit inline, shouldn't get an arena.
+    const TextBuffer defaultBuffer{ bufferSize, attr, cursorSize, _renderTarget };
+    VERIFY_IS_FALSE(defaultBuffer._rowArena.has_value());
+    const TextBuffer narrowBuffer{ { 80, 10 }, attr, cursorSize, _renderTarget, true };
+    VERIFY_IS_FALSE(narrowBuffer._rowArena.has_value());
+}
+
+// This tests that rows outside of the hot part of the buffer get frozen,
+// and that reading them back thaws them with their contents intact.
+void TextBufferTests::FrozenRowsThawOnAccess()
+{
+    const COORD bufferSize{ 80, 10 };
+    const UINT cursorSize = 12;
+    const TextAttribute attr{ 0x7f };
+    auto _buffer = std::make_unique<TextBuffer>(bufferSize, attr, cursorSize, _renderTarget);
+
+    const std::wstring text{ L"frozen" };
+    _buffer->WriteLine(OutputCellIterator(text), { 3, 2 });
+
+    Log::Comment(L"Keeping the bottom 5 rows hot should freeze the top 5.");
+    _buffer->SetHotRowCount(5);
+    for (SHORT row = 0; row < bufferSize.Y; ++row)
+    {
+        VERIFY_ARE_EQUAL(row < 5, _buffer->GetRowByOffset(row).IsFrozen());
+    }
+
+    Log::Comment(L"Reading the row should thaw it back to its full width.");
+    const auto& row = _buffer->GetRowByOffset(2);
+    VERIFY_ARE_EQUAL(String((std::wstring(3, L' ') + text + std::wstring(71, L' ')).c_str()), String(row.GetText().c_str()));
+    VERIFY_IS_FALSE(row.IsFrozen());
+    VERIFY_ARE_EQUAL(static_cast<size_t>(bufferSize.X), row.GetCharRow().size());
+
+    Log::Comment(L"Circling the buffer should freeze the row that became cold.");
+    VERIFY_IS_FALSE(_buffer->GetRowByOffset(5).IsFrozen());
+    VERIFY_IS_TRUE(_buffer->IncrementCircularBuffer());
+    VERIFY_IS_TRUE(_buffer->GetRowByOffset(4).IsFrozen());
+    VERIFY_IS_FALSE(_buffer->GetRowByOffset(5).IsFrozen());
+
+    Log::Comment(L"The recycled bottom row must come back blank and hot.");
+    const auto& lastRow = _buffer->GetRowByOffset(bufferSize.Y - 1);
+    VERIFY_IS_FALSE(lastRow.IsFrozen());
+    VERIFY_IS_FALSE(lastRow.GetCharRow().ContainsText());
+}
+
+// This tests that rows allocated out of the row arena give their cells back
+// when they're frozen, so that thawing another row doesn't take new memory.
+void TextBufferTests::RowArenaReusesFrozenCells()
+{
+    const COORD bufferSize{ gsl::narrow<SHORT>(CharRow::InlineCapacity + 80), 10 };
+    const UINT cursorSize = 12;
+    const TextAttribute attr{ 0x7f };
+    auto _buffer = std::make_unique<TextBuffer>(bufferSize, attr, cursorSize, _renderTarget, true);
+    VERIFY_IS_TRUE(_buffer->_rowPool.has_value());
+
+    const SHORT column = bufferSize.X - 1;
+    _buffer->WriteLine(OutputCellIterator(L"2"), { column, 2 });
+    _buffer->WriteLine(OutputCellIterator(L"3"), { column, 3 });
+    _buffer->SetHotRowCount(5);
+    VERIFY_IS_TRUE(_buffer->GetRowByOffset(2).IsFrozen());
+    VERIFY_IS_TRUE(_buffer->GetRowByOffset(3).IsFrozen());
+
+    Log::Comment(L"Thawing a row and freezing it again should hand its cells to the next row that's thawed.");
+    const auto cells = &_buffer->GetRowByOffset(2).GetCharRow().DbcsAttrAt(0);
+    _buffer->GetRowByOffset(2).Freeze();
+    const auto& charRow = _buffer->GetRowByOffset(3).GetCharRow();
+    VERIFY_ARE_EQUAL(cells, &charRow.DbcsAttrAt(0));
+    VERIFY_ARE_EQUAL(static_cast<size_t>(bufferSize.X), charRow.size());
+
+    Log::Comment(L"Both rows should still have their contents.");
+    for (SHORT row = 2; row <= 3; ++row)
+    {
+        const auto expected = std::to_wstring(row);
+        const auto text = *_buffer->GetTextDataAt({ column, row });
+        VERIFY_ARE_EQUAL(String(expected.c_str()), String(text.data(), gsl::narrow<int>(text.size())));
+    }
+}
+
+// This tests that rows remember where their text ends until they're
+// modified, and that measuring frozen rows doesn't thaw them.
+void TextBufferTests::MeasureRightWithoutThawing()
+{
+    const COORD bufferSize{ 80, 10 };
+    const UINT cursorSize = 12;
+    const TextAttribute attr{ 0x7f };
+    auto _buffer = std::make_unique<TextBuffer>(bufferSize, attr, cursorSize, _renderTarget);
+
+    _buffer->WriteLine(OutputCellIterator(L"text"), { 3, 2 });
+    VERIFY_ARE_EQUAL(7u, _buffer->GetRowByOffset(2).MeasureRight());
+
+    Log::Comment(L"Writing to the row has to be reflected in the next measurement.");
+    _buffer->WriteLine(OutputCellIterator(L"more"), { 20, 2 });
+    VERIFY_ARE_EQUAL(24u, _buffer->GetRowByOffset(2).MeasureRight());
+    _buffer->WriteLine(OutputCellIterator(L"    "), { 20, 2 });
+    VERIFY_ARE_EQUAL(7u, _buffer->GetRowByOffset(2).MeasureRight());
+    _buffer->GetRowByOffset(2).ClearColumn(6);
+    VERIFY_ARE_EQUAL(6u, _buffer->GetRowByOffset(2).MeasureRight());
+
+    Log::Comment(L"Frozen rows are measured without thawing them.");
+    _buffer->SetHotRowCount(5);
+    const auto& row = _buffer->GetRowByOffset(2);
+    VERIFY_IS_TRUE(row.IsFrozen());
+    VERIFY_ARE_EQUAL(6u, row.MeasureRight());
+    VERIFY_IS_TRUE(_buffer->GetRowByOffset(1).IsFrozen());
+    VERIFY_ARE_EQUAL(0u, _buffer->GetRowByOffset(1).MeasureRight());
+
+    const auto lastNonSpace = _buffer->GetLastNonSpaceCharacter();
+    VERIFY_ARE_EQUAL(COORD({ 5, 2 }), lastNonSpace);
+    for (SHORT y = 0; y < 5; ++y)
+    {
+        VERIFY_IS_TRUE(_buffer->GetRowByOffset(y).IsFrozen());
+    }
+}
+
+// This tests that rows outside of the resident part of the buffer get moved
+// into the spill file, and that they're read back from there when accessed.
+void TextBufferTests::SpilledRowsThawOnAccess()
+{
+    const COORD bufferSize{ 80, 10 };
+    const UINT cursorSize = 12;
+    const TextAttribute attr{ 0x7f };
+    auto _buffer = std::make_unique<TextBuffer>(bufferSize, attr, cursorSize, _renderTarget);
+
+    for (SHORT row = 0; row < bufferSize.Y; ++row)
+    {
+        const auto text = L"row " + std::to_wstring(row);
+        _buffer->WriteLine(OutputCellIterator(text), { 0, row });
+    }
+
+    Log::Comment(L"Keeping the bottom 4 rows resident should spill the top 6.");
+    _buffer->SetResidentRowCount(4);
+    for (SHORT row = 0; row < bufferSize.Y; ++row)
+    {
+        VERIFY_ARE_EQUAL(row < 6, _buffer->GetRowByOffset(row).IsSpilled());
+    }
+
+    Log::Comment(L"Circling the buffer should spill the row that left the resident part.");
+    VERIFY_IS_TRUE(_buffer->IncrementCircularBuffer());
+    VERIFY_IS_TRUE(_buffer->GetRowByOffset(5).IsSpilled());
+    VERIFY_IS_FALSE(_buffer->GetRowByOffset(6).IsSpilled());
+    VERIFY_IS_FALSE(_buffer->GetRowByOffset(bufferSize.Y - 1).IsSpilled());
+
+    Log::Comment(L"Every spilled row should read back with its contents intact.");
+    for (SHORT row = 0; row < bufferSize.Y - 1; ++row)
+    {
+        const auto expected = L"row " + std::to_wstring(row + 1);
+        const auto text = _buffer->GetRowByOffset(row).GetText();
+        VERIFY_ARE_EQUAL(String(expected.c_str()), String(text.substr(0, expected.size()).c_str()));
+        VERIFY_IS_FALSE(_buffer->GetRowByOffset(row).IsSpilled());
+    }
+
+    Log::Comment(L"Rows spilled again after thawing should still be copyable.");
+    _buffer->SetResidentRowCount(4);
+    VERIFY_IS_TRUE(_buffer->GetRowByOffset(2).IsSpilled());
+    const auto textRects = _buffer->GetTextRects({ 0, 2 }, { 4, 2 }, false, true);
+    const auto data = _buffer->GetText(false, false, textRects);
+    VERIFY_ARE_EQUAL(1u, data.text.size());
+    VERIFY_ARE_EQUAL(String(L"row 3"), String(data.text.at(0).c_str()));
+
+    Log::Comment(L"Refreezing should spill the rows that were read back, but not the resident ones.");
+    (void)_buffer->GetRowByOffset(3).GetText();
+    VERIFY_IS_FALSE(_buffer->GetRowByOffset(3).IsSpilled());
+    _buffer->RefreezeColdRows();
+    for (SHORT row = 0; row < bufferSize.Y; ++row)
+    {
+        VERIFY_ARE_EQUAL(row < 6, _buffer->GetRowByOffset(row).IsSpilled());
+    }
+}
+
+void TextBufferTests::EraseRowsClearsLazily()
+{
+    const COORD bufferSize{ 80, 10 };
+    const UINT cursorSize = 12;
+    const TextAttribute attr{ 0x7f };
+    const TextAttribute eraseAttr{ 0x1e };
+    auto _buffer = std::make_unique<TextBuffer>(bufferSize, attr, cursorSize, _renderTarget);
+
+    const auto writeRows = [&]() {
+        for (SHORT row = 0; row < bufferSize.Y; ++row)
+        {
+            const auto text = L"row " + std::to_wstring(row);
+            _buffer->WriteLine(OutputCellIterator(text), { 0, row });
+        }
+    };
+    const auto verifyRow = [&](const SHORT row, const std::wstring& expected, const TextAttribute& expectedAttr) {
+        const auto& storedRow = _buffer->GetRowByOffset(row);
+        const auto text = storedRow.GetText();
+        VERIFY_ARE_EQUAL(String(expected.c_str()), String(text.substr(0, expected.size()).c_str()));
+        VERIFY_ARE_EQUAL(expectedAttr, storedRow.GetAttrRow().GetAttrByColumn(gsl::narrow_cast<uint16_t>(bufferSize.X - 1)));
+    };
+
+    writeRows();
+    VERIFY_IS_TRUE(_buffer->IncrementCircularBuffer());
+    writeRows();
+
+    Log::Comment(L"Erasing most of the buffer should keep the other rows as they were.");
+    _buffer->EraseRows(0, 7, eraseAttr);
+    for (SHORT row = 0; row < bufferSize.Y; ++row)
+    {
+        if (row < 7)
+        {
+            verifyRow(row, std::wstring(10, L' '), eraseAttr);
+        }
+        else
+        {
+            verifyRow(row, L"row " + std::to_wstring(row), attr);
+        }
+    }
+
+    Log::Comment(L"Rows that were cleared but never accessed should be cleared by the next reset too.");
+    writeRows();
+    _buffer->EraseRows(0, 7, eraseAttr);
+    _buffer->SetCurrentAttributes(attr);
+    _buffer->Reset();
+    for (SHORT row = 0; row < bufferSize.Y; ++row)
+    {
+        verifyRow(row, std::wstring(10, L' '), attr);
+    }
+
+    Log::Comment(L"Rows should be cleared eagerly if any of them link somewhere.");
+    writeRows();
+    auto linkAttr = attr;
+    linkAttr.SetHyperlinkId(_buffer->GetHyperlinkId(L"https://example.com", L""));
+    _buffer->GetRowByOffset(8).GetAttrRow().Replace(0, 4, linkAttr);
+    _buffer->EraseRows(0, 7, eraseAttr);
+    for (SHORT row = 0; row < 7; ++row)
+    {
+        verifyRow(row, std::wstring(10, L' '), eraseAttr);
+    }
+    verifyRow(8, L"row 8", attr);
+}
+
 // This tests that rows removed from the buffer while resizing traditionally will also drop the high unicode
 // characters from the Unicode Storage buffer
 void TextBufferTests::ResizeTraditionalHighUnicodeRowRemoval()
@@ -1935,14 +2391,17 @@ void TextBufferTests::ResizeTraditionalHighUnicodeRowRemoval()
     const auto readBackText = *readBack;
     VERIFY_ARE_EQUAL(String(emoji), String(readBackText.data(), gsl::narrow<int>(readBackText.size())));
 
-    VERIFY_ARE_EQUAL(1u, _buffer->GetUnicodeStorage()._map.size(), L"There should be one item in the map.");
+    VERIFY_ARE_EQUAL(1u, _buffer->_storage[pos.Y].GetUnicodeStorage()._glyphs.size(), L"There should be one item in the row's storage.");
 
     // Perform resize to trim off the row of the buffer that included the emoji
     COORD trimmedBufferSize{ bufferSize.X, bufferSize.Y - 1 };
 
     VERIFY_NT_SUCCESS(_buffer->ResizeTraditional(trimmedBufferSize));
 
-    VERIFY_IS_TRUE(_buffer->GetUnicodeStorage()._map.empty(), L"The map should now be empty.");
+    for (const auto& row : _buffer->_storage)
+    {
+        VERIFY_IS_TRUE(row.GetUnicodeStorage().empty(), L"No row should have anything stored now.");
+    }
 }
 
 // This tests that columns removed from the buffer while resizing traditionally will also drop the high unicode
@@ -1970,14 +2429,14 @@ void TextBufferTests::ResizeTraditionalHighUnicodeColumnRemoval()
     const auto readBackText = *readBack;
     VERIFY_ARE_EQUAL(String(emoji), String(readBackText.data(), gsl::narrow<int>(readBackText.size())));
 
-    VERIFY_ARE_EQUAL(1u, _buffer->GetUnicodeStorage()._map.size(), L"There should be one item in the map.");
+    VERIFY_ARE_EQUAL(1u, _buffer->_storage[pos.Y].GetUnicodeStorage()._glyphs.size(), L"There should be one item in the row's storage.");
 
     // Perform resize to trim off the column of the buffer that included the emoji
     COORD trimmedBufferSize{ bufferSize.X - 1, bufferSize.Y };
 
     VERIFY_NT_SUCCESS(_buffer->ResizeTraditional(trimmedBufferSize));
 
-    VERIFY_IS_TRUE(_buffer->GetUnicodeStorage()._map.empty(), L"The map should now be empty.");
+    VERIFY_IS_TRUE(_buffer->_storage[pos.Y].GetUnicodeStorage().empty(), L"The row's storage should now be empty.");
 }
 
 void TextBufferTests::TestBurrito()
@@ -2133,6 +2592,30 @@ void TextBufferTests::GetWordBoundaries()
     }
 }
 
+void TextBufferTests::GetWordBoundariesWithNonAsciiDelimiters()
+{
+    COORD bufferSize{ 80, 10 };
+    UINT cursorSize = 12;
+    TextAttribute attr{ 0x7f };
+    auto _buffer = std::make_unique<TextBuffer>(bufferSize, attr, cursorSize, _renderTarget);
+
+    const std::vector<std::wstring> text = { L"foo\x2502bar-baz" };
+    WriteLinesToBuffer(text, *_buffer);
+
+    Log::Comment(L"Delimiters outside of ASCII separate words just like ASCII ones.");
+    const std::wstring_view delimiters = L" \x2502";
+    VERIFY_ARE_EQUAL((COORD{ 4, 0 }), _buffer->GetWordStart({ 5, 0 }, delimiters));
+    VERIFY_ARE_EQUAL((COORD{ 2, 0 }), _buffer->GetWordEnd({ 0, 0 }, delimiters));
+    VERIFY_ARE_EQUAL((COORD{ 3, 0 }), _buffer->GetWordStart({ 3, 0 }, delimiters));
+    VERIFY_ARE_EQUAL((COORD{ 3, 0 }), _buffer->GetWordEnd({ 3, 0 }, delimiters));
+    VERIFY_ARE_EQUAL((COORD{ 4, 0 }), _buffer->GetWordEnd({ 0, 0 }, delimiters, true));
+
+    Log::Comment(L"Characters that aren't delimiters are part of the word, whether they're ASCII or not.");
+    VERIFY_ARE_EQUAL((COORD{ 10, 0 }), _buffer->GetWordEnd({ 4, 0 }, delimiters));
+    VERIFY_ARE_EQUAL((COORD{ 4, 0 }), _buffer->GetWordStart({ 10, 0 }, delimiters));
+    VERIFY_ARE_EQUAL((COORD{ 0, 0 }), _buffer->GetWordEnd({ 0, 0 }, L"\x2502o"));
+}
+
 void TextBufferTests::MoveByWord()
 {
     COORD bufferSize{ 80, 9001 };
@@ -2580,6 +3063,49 @@ void TextBufferTests::GetText()
     }
 }
 
+void TextBufferTests::GetTextOfLargeSelection()
+{
+    // Selections spanning many rows are extracted in parallel chunks.
+    // The rows have to come out in order and formatted just like small ones.
+    const SHORT rowCount = 400;
+    COORD bufferSize{ 10, rowCount };
+    UINT cursorSize = 12;
+    TextAttribute attr{ 0x7f };
+    auto _buffer = std::make_unique<TextBuffer>(bufferSize, attr, cursorSize, _renderTarget);
+
+    std::vector<std::wstring> bufferText;
+    for (SHORT row = 0; row < rowCount; ++row)
+    {
+        bufferText.emplace_back(L"row " + std::to_wstring(row) + L"  ");
+    }
+    WriteLinesToBuffer(bufferText, *_buffer);
+
+    const auto textRects = _buffer->GetTextRects({ 0, 0 }, { 9, rowCount - 1 }, false, false);
+    const auto getColors = [](const TextAttribute&) {
+        return std::pair<COLORREF, COLORREF>{ RGB(1, 2, 3), RGB(4, 5, 6) };
+    };
+    const auto textData = _buffer->GetText(true, true, textRects, getColors);
+
+    VERIFY_ARE_EQUAL(textRects.size(), textData.text.size());
+    VERIFY_ARE_EQUAL(textRects.size(), textData.colorRuns.size());
+    for (size_t row = 0; row < textData.text.size(); ++row)
+    {
+        auto expectedText = L"row " + std::to_wstring(row);
+        if (row < textData.text.size() - 1)
+        {
+            expectedText += L"\r\n";
+        }
+        VERIFY_ARE_EQUAL(expectedText, textData.text.at(row));
+
+        size_t coloredLength = 0;
+        for (const auto& run : textData.colorRuns.at(row))
+        {
+            coloredLength += run.length;
+        }
+        VERIFY_ARE_EQUAL(expectedText.size(), coloredLength);
+    }
+}
+
 // This tests that when we increment the circular buffer, obsolete hyperlink references
 // are removed from the hyperlink map
 void TextBufferTests::HyperlinkTrim()
@@ -2660,3 +3186,188 @@ void TextBufferTests::NoHyperlinkTrim()
     VERIFY_ARE_EQUAL(_buffer->GetHyperlinkUriFromId(id), url);
     VERIFY_ARE_EQUAL(_buffer->_hyperlinkCustomIdMap[finalCustomId], id);
 }
+
+// This tests that overwriting a hyperlink releases the row's reference to it,
+// so that it's deleted once the last row that still had it scrolls away
+void TextBufferTests::HyperlinkTrimAfterOverwrite()
+{
+    const COORD bufferSize{ 80, 10 };
+    const UINT cursorSize = 12;
+    const TextAttribute attr{ 0x7f };
+    auto _buffer = std::make_unique<TextBuffer>(bufferSize, attr, cursorSize, _renderTarget);
+
+    const auto url = L"test.url";
+    const auto id = _buffer->GetHyperlinkId(url, L"");
+    TextAttribute newAttr{ 0x7f };
+    newAttr.SetHyperlinkId(id);
+    _buffer->AddHyperlinkToMap(url, id);
+
+    // The hyperlink is in two rows, and in two runs of one of them.
+    _buffer->GetRowByOffset(0).GetAttrRow().SetAttrToEnd(70, newAttr);
+    _buffer->GetRowByOffset(5).GetAttrRow().Replace(10, 20, newAttr);
+    _buffer->GetRowByOffset(5).GetAttrRow().Replace(30, 40, newAttr);
+    VERIFY_ARE_EQUAL(2u, _buffer->_attributeTable.GetHyperlinkReferenceCount(id));
+
+    Log::Comment(L"Overwriting one of the runs keeps the reference of the row.");
+    _buffer->GetRowByOffset(5).GetAttrRow().Replace(10, 20, attr);
+    VERIFY_ARE_EQUAL(2u, _buffer->_attributeTable.GetHyperlinkReferenceCount(id));
+
+    Log::Comment(L"Overwriting the other one releases it.");
+    _buffer->GetRowByOffset(5).GetAttrRow().Replace(30, 40, attr);
+    VERIFY_ARE_EQUAL(1u, _buffer->_attributeTable.GetHyperlinkReferenceCount(id));
+
+    // Scrolling the first row away drops the last reference and the hyperlink with it.
+    _buffer->IncrementCircularBuffer();
+    VERIFY_ARE_EQUAL(0u, _buffer->_attributeTable.GetHyperlinkReferenceCount(id));
+    VERIFY_ARE_EQUAL(_buffer->_hyperlinkMap.find(id), _buffer->_hyperlinkMap.end());
+}
+
+// This tests that image slices move together with their rows, and
+// that the image cache drops the least recently used images first.
+void TextBufferTests::ImageSlicesAndCache()
+{
+    const COORD bufferSize{ 20, 10 };
+    const UINT cursorSize = 12;
+    const TextAttribute attr{ 0x7f };
+    auto _buffer = std::make_unique<TextBuffer>(bufferSize, attr, cursorSize, _renderTarget);
+
+    const auto makeImage = [](const size_t width, const size_t height) {
+        InlineImage image;
+        image.width = width;
+        image.height = height;
+        image.cellWidth = 10;
+        image.cellHeight = 20;
+        image.pixels.resize(width * height);
+        return image;
+    };
+
+    auto& cache = _buffer->GetImageCache();
+    const auto id = cache.Add(makeImage(20, 40));
+    VERIFY_ARE_EQUAL(2u, cache.Get(id)->CellRows());
+    _buffer->SetImageSlice(3, { id, 5, 0 });
+    _buffer->SetImageSlice(4, { id, 5, 1 });
+
+    Log::Comment(L"Scrolling moves the slices along with their rows.");
+    _buffer->ScrollRows(3, 2, -2);
+    VERIFY_ARE_EQUAL(id, _buffer->GetRowByOffset(1).GetImageSlice().imageId);
+    VERIFY_ARE_EQUAL(0, _buffer->GetRowByOffset(1).GetImageSlice().imageRow);
+    VERIFY_ARE_EQUAL(5, _buffer->GetRowByOffset(2).GetImageSlice().column);
+    VERIFY_ARE_EQUAL(1, _buffer->GetRowByOffset(2).GetImageSlice().imageRow);
+    VERIFY_ARE_EQUAL(0u, _buffer->GetRowByOffset(3).GetImageSlice().imageId);
+
+    Log::Comment(L"Resetting a row drops its slice.");
+    _buffer->GetRowByOffset(1).Reset(attr);
+    VERIFY_ARE_EQUAL(0u, _buffer->GetRowByOffset(1).GetImageSlice().imageId);
+
+    Log::Comment(L"The least recently used image is evicted, but never the newest one.");
+    ImageCache smallCache{ 3 * 16 * sizeof(uint32_t) };
+    const auto first = smallCache.Add(makeImage(4, 4));
+    const auto second = smallCache.Add(makeImage(4, 4));
+    const auto third = smallCache.Add(makeImage(4, 4));
+    VERIFY_IS_NOT_NULL(smallCache.Get(first));
+    const auto fourth = smallCache.Add(makeImage(4, 4));
+    VERIFY_IS_NOT_NULL(smallCache.Get(first));
+    VERIFY_IS_NULL(smallCache.Get(second));
+    VERIFY_IS_NOT_NULL(smallCache.Get(third));
+    VERIFY_IS_NOT_NULL(smallCache.Get(fourth));
+    VERIFY_ARE_EQUAL(3 * 16 * sizeof(uint32_t), smallCache.GetMemoryUsage());
+
+    const auto huge = smallCache.Add(makeImage(16, 16));
+    VERIFY_IS_NOT_NULL(smallCache.Get(huge));
+    VERIFY_IS_NULL(smallCache.Get(first));
+    VERIFY_ARE_EQUAL(16 * 16 * sizeof(uint32_t), smallCache.GetMemoryUsage());
+
+    _buffer->Reset();
+    VERIFY_IS_NULL(cache.Get(id));
+}
+
+// This tests that the text is copied with runs of colors,
+// and that HTML and RTF are generated from those runs.
+void TextBufferTests::GenHTMLAndRTFFromColorRuns()
+{
+    const COORD bufferSize{ 10, 3 };
+    const UINT cursorSize = 12;
+    const TextAttribute attr{ 0x07 };
+    auto _buffer = std::make_unique<TextBuffer>(bufferSize, attr, cursorSize, _renderTarget);
+
+    _buffer->WriteLine(OutputCellIterator{ L"a<b", TextAttribute{ 0x0c } }, { 0, 0 });
+    _buffer->WriteLine(OutputCellIterator{ L"c", attr }, { 3, 0 });
+    _buffer->WriteLine(OutputCellIterator{ L"x&{", TextAttribute{ 0x0c } }, { 0, 1 });
+
+    const std::vector<SMALL_RECT> selection{ { 0, 0, 9, 0 }, { 0, 1, 9, 1 } };
+    const auto getColors = [](const TextAttribute& textAttr) {
+        return std::pair<COLORREF, COLORREF>{ textAttr.GetLegacyAttributes(), 0 };
+    };
+    const auto rows = _buffer->GetText(true, true, selection, getColors);
+
+    Log::Comment(L"The trailing spaces are trimmed from the last run, and CR/LF get a run of their own.");
+    VERIFY_ARE_EQUAL(String(L"a<bc\r\n"), String(rows.text.at(0).c_str()));
+    VERIFY_ARE_EQUAL(String(L"x&{"), String(rows.text.at(1).c_str()));
+    VERIFY_ARE_EQUAL(3u, rows.colorRuns.at(0).size());
+    VERIFY_ARE_EQUAL(3u, rows.colorRuns.at(0).at(0).length);
+    VERIFY_ARE_EQUAL(COLORREF{ 0x0c }, rows.colorRuns.at(0).at(0).foreground);
+    VERIFY_ARE_EQUAL(1u, rows.colorRuns.at(0).at(1).length);
+    VERIFY_ARE_EQUAL(COLORREF{ 0x07 }, rows.colorRuns.at(0).at(1).foreground);
+    VERIFY_ARE_EQUAL(2u, rows.colorRuns.at(0).at(2).length);
+    VERIFY_ARE_EQUAL(1u, rows.colorRuns.at(1).size());
+    VERIFY_ARE_EQUAL(3u, rows.colorRuns.at(1).at(0).length);
+
+    Log::Comment(L"The HTML header points at the generated document.");
+    const auto html = TextBuffer::GenHTML(rows, 12, L"Consolas", 0);
+    VERIFY_ARE_EQUAL(0u, html.find("Version:0.9\r\nStartHTML:0000000157\r\n"));
+    const auto endHtmlPos = html.find("EndHTML:");
+    VERIFY_ARE_NOT_EQUAL(std::string::npos, endHtmlPos);
+    VERIFY_ARE_EQUAL(html.size(), static_cast<size_t>(std::stoul(html.substr(endHtmlPos + 8, 10))));
+    VERIFY_ARE_EQUAL(157u, html.find("<!DOCTYPE>"));
+    VERIFY_ARE_NOT_EQUAL(std::string::npos, html.find("\">a&lt;b</SPAN><SPAN"));
+    VERIFY_ARE_NOT_EQUAL(std::string::npos, html.find("\">c<BR></SPAN><SPAN"));
+    VERIFY_ARE_NOT_EQUAL(std::string::npos, html.find("\">x&amp;{</SPAN></DIV>"));
+
+    Log::Comment(L"The RTF color table only contains each color once.");
+    const auto rtf = TextBuffer::GenRTF(rows, 12, L"Consolas", 0);
+    VERIFY_ARE_NOT_EQUAL(std::string::npos, rtf.find("{\\colortbl ;\\red0\\green0\\blue0;\\red12\\green0\\blue0;\\red7\\green0\\blue0;}"));
+    VERIFY_ARE_NOT_EQUAL(std::string::npos, rtf.find("\\highlight1\\cf2 a<b\\highlight1\\cf3 c\\line \\highlight1\\cf2 x&\\{}"));
+}
+
+void TextBufferTests::GenExportFromColorRuns()
+{
+    const COORD bufferSize{ 10, 3 };
+    const UINT cursorSize = 12;
+    const TextAttribute attr{ 0x07 };
+    auto _buffer = std::make_unique<TextBuffer>(bufferSize, attr, cursorSize, _renderTarget);
+
+    _buffer->WriteLine(OutputCellIterator{ L"a<b", TextAttribute{ 0x0c } }, { 0, 0 });
+    _buffer->WriteLine(OutputCellIterator{ L"c", attr }, { 3, 0 });
+    _buffer->WriteLine(OutputCellIterator{ L"x&{", TextAttribute{ 0x0c } }, { 0, 1 });
+
+    const std::vector<SMALL_RECT> selection{ { 0, 0, 9, 0 }, { 0, 1, 9, 1 } };
+    const auto getColors = [](const TextAttribute& textAttr) {
+        return std::pair<COLORREF, COLORREF>{ textAttr.GetLegacyAttributes(), 0 };
+    };
+
+    Log::Comment(L"Plain text is written as is.");
+    std::string text;
+    TextBuffer::AppendExportRows(text, _buffer->GetText(true, true, selection), TextBuffer::ExportFormat::Text);
+    VERIFY_ARE_EQUAL("a<bc\r\nx&{", text);
+    VERIFY_IS_TRUE(TextBuffer::GenExportPrologue(TextBuffer::ExportFormat::Text, 12, L"Consolas", 0).empty());
+    VERIFY_IS_TRUE(TextBuffer::GenExportEpilogue(TextBuffer::ExportFormat::Text).empty());
+
+    const auto rows = _buffer->GetText(true, true, selection, getColors);
+
+    Log::Comment(L"VT only sets the colors when they change, and resets them at the end of every line and chunk.");
+    std::string vt;
+    TextBuffer::AppendExportRows(vt, rows, TextBuffer::ExportFormat::Vt);
+    VERIFY_ARE_EQUAL("\x1b[38;2;12;0;0;48;2;0;0;0ma<b\x1b[38;2;7;0;0;48;2;0;0;0mc\x1b[m\r\n"
+                     "\x1b[38;2;12;0;0;48;2;0;0;0mx&{\x1b[m",
+                     vt);
+
+    Log::Comment(L"HTML is escaped, and every chunk closes the spans it opens.");
+    std::string html;
+    TextBuffer::AppendExportRows(html, rows, TextBuffer::ExportFormat::Html);
+    VERIFY_ARE_EQUAL(0u, html.find("<span style=\""));
+    VERIFY_ARE_NOT_EQUAL(std::string::npos, html.find("\">a&lt;b</span><span"));
+    VERIFY_ARE_NOT_EQUAL(std::string::npos, html.find("\">c</span>\n<span"));
+    VERIFY_ARE_EQUAL(html.size() - 15, html.find("\">x&amp;{</span>"));
+    VERIFY_ARE_EQUAL(0u, TextBuffer::GenExportPrologue(TextBuffer::ExportFormat::Html, 12, L"Consolas", 0).find("<!DOCTYPE html>"));
+    VERIFY_ARE_EQUAL("</pre></body></html>", std::string{ TextBuffer::GenExportEpilogue(TextBuffer::ExportFormat::Html) });
+}
@@ -402,7 +402,7 @@ public:
         return {};
     }
 
-    const std::vector<size_t> GetPatternId(const COORD /*location*/) const noexcept
+    gsl::span<const PatternSpan> GetPatternSpans(const SHORT /*row*/) const noexcept
     {
         return {};
     }
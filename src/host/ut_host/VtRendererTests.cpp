@@ -83,6 +83,12 @@ class Microsoft::Console::Render::VtRendererTest
 
     TEST_METHOD(TestCursorVisibility);
 
+    TEST_METHOD(TestPassthroughMode);
+
+    TEST_METHOD(TestSkipUnchangedCells);
+
+    TEST_METHOD(TestCoordinatedResize);
+
     void Test16Colors(VtEngine* engine);
 
     std::deque<std::string> qExpectedInput;
@@ -416,8 +422,7 @@ void VtRendererTest::Xterm256TestColors()
     Log::Comment(NoThrowString().Format(
         L"Begin by setting some test values - FG,BG = (1,2,3), (4,5,6) to start"
         L"These values were picked for ease of formatting raw COLORREF values."));
-    qExpectedInput.push_back("\x1b[38;2;1;2;3m");
-    qExpectedInput.push_back("\x1b[48;2;5;6;7m");
+    qExpectedInput.push_back("\x1b[38;2;1;2;3;48;2;5;6;7m");
     VERIFY_SUCCEEDED(engine->UpdateDrawingBrushes({ 0x00030201, 0x00070605 },
                                                   &renderData,
                                                   false,
@@ -694,61 +699,80 @@ void VtRendererTest::Xterm256TestExtendedAttributes()
     VERIFY_SUCCEEDED(TestData::TryGetValue(L"crossedOut", crossedOut));
 
     TextAttribute desiredAttrs;
-    std::vector<std::string> onSequences, offSequences;
+    std::vector<std::string> onParameters, offParameters;
 
-    // Collect up a VT sequence to set the state given the method properties
+    // Collect up the SGR parameters to set the state given the method properties
     if (faint)
     {
         desiredAttrs.SetFaint(true);
-        onSequences.push_back("\x1b[2m");
-        offSequences.push_back("\x1b[22m");
+        onParameters.push_back("2");
+        offParameters.push_back("22");
     }
     if (underlined)
     {
         desiredAttrs.SetUnderlined(true);
-        onSequences.push_back("\x1b[4m");
-        offSequences.push_back("\x1b[24m");
+        onParameters.push_back("4");
+        offParameters.push_back("24");
     }
     if (doublyUnderlined)
     {
         desiredAttrs.SetDoublyUnderlined(true);
-        onSequences.push_back("\x1b[21m");
+        onParameters.push_back("21");
         // The two underlines share the same off sequence, so we
         // only add it here if that hasn't already been done.
         if (!underlined)
         {
-            offSequences.push_back("\x1b[24m");
+            offParameters.push_back("24");
         }
     }
     if (italics)
     {
         desiredAttrs.SetItalic(true);
-        onSequences.push_back("\x1b[3m");
-        offSequences.push_back("\x1b[23m");
+        onParameters.push_back("3");
+        offParameters.push_back("23");
     }
     if (blink)
     {
         desiredAttrs.SetBlinking(true);
-        onSequences.push_back("\x1b[5m");
-        offSequences.push_back("\x1b[25m");
+        onParameters.push_back("5");
+        offParameters.push_back("25");
     }
     if (invisible)
     {
         desiredAttrs.SetInvisible(true);
-        onSequences.push_back("\x1b[8m");
-        offSequences.push_back("\x1b[28m");
+        onParameters.push_back("8");
+        offParameters.push_back("28");
     }
     if (crossedOut)
     {
         desiredAttrs.SetCrossedOut(true);
-        onSequences.push_back("\x1b[9m");
-        offSequences.push_back("\x1b[29m");
+        onParameters.push_back("9");
+        offParameters.push_back("29");
     }
 
+    // All the attributes that change at once are combined into a single sequence.
+    const auto toSequence = [](const std::vector<std::string>& parameters) {
+        std::vector<std::string> sequences;
+        if (!parameters.empty())
+        {
+            std::string sequence{ "\x1b[" };
+            for (const auto& parameter : parameters)
+            {
+                sequence.append(parameter).push_back(';');
+            }
+            sequence.back() = 'm';
+            sequences.push_back(sequence);
+        }
+        return sequences;
+    };
+    const auto onSequences = toSequence(onParameters);
+    const auto offSequences = toSequence(offParameters);
+
     wil::unique_hfile hFile = wil::unique_hfile(INVALID_HANDLE_VALUE);
     std::unique_ptr<Xterm256Engine> engine = std::make_unique<Xterm256Engine>(std::move(hFile), SetUpViewport());
     auto pfn = std::bind(&VtRendererTest::WriteCallback, this, std::placeholders::_1, std::placeholders::_2);
     engine->SetTestCallback(pfn);
+    RenderData renderData;
 
     // Verify the first paint emits a clear and go home
     qExpectedInput.push_back("\x1b[2J");
@@ -767,21 +791,21 @@ void VtRendererTest::Xterm256TestExtendedAttributes()
     TestPaint(*engine, [&]() {
         // Merge the "on" sequences into expected input.
         std::copy(onSequences.cbegin(), onSequences.cend(), std::back_inserter(qExpectedInput));
-        VERIFY_SUCCEEDED(engine->_UpdateExtendedAttrs(desiredAttrs));
+        VERIFY_SUCCEEDED(engine->UpdateDrawingBrushes(desiredAttrs, &renderData, false, false));
     });
 
     Log::Comment(NoThrowString().Format(
         L"----Turn the extended attributes off----"));
     TestPaint(*engine, [&]() {
         std::copy(offSequences.cbegin(), offSequences.cend(), std::back_inserter(qExpectedInput));
-        VERIFY_SUCCEEDED(engine->_UpdateExtendedAttrs({}));
+        VERIFY_SUCCEEDED(engine->UpdateDrawingBrushes({}, &renderData, false, false));
     });
 
     Log::Comment(NoThrowString().Format(
         L"----Turn the extended attributes back on----"));
     TestPaint(*engine, [&]() {
         std::copy(onSequences.cbegin(), onSequences.cend(), std::back_inserter(qExpectedInput));
-        VERIFY_SUCCEEDED(engine->_UpdateExtendedAttrs(desiredAttrs));
+        VERIFY_SUCCEEDED(engine->UpdateDrawingBrushes(desiredAttrs, &renderData, false, false));
     });
 
     VerifyExpectedInputsDrained();
@@ -798,6 +822,9 @@ void VtRendererTest::Xterm256TestAttributesAcrossReset()
 
     std::stringstream renditionSequence;
     renditionSequence << "\x1b[" << renditionAttribute << "m";
+    // The reset and the rendition that's reapplied after it are written as one sequence.
+    std::stringstream resetRenditionSequence;
+    resetRenditionSequence << "\x1b[0;" << renditionAttribute << "m";
 
     wil::unique_hfile hFile = wil::unique_hfile(INVALID_HANDLE_VALUE);
     std::unique_ptr<Xterm256Engine> engine = std::make_unique<Xterm256Engine>(std::move(hFile), SetUpViewport());
@@ -865,8 +892,7 @@ void VtRendererTest::Xterm256TestAttributesAcrossReset()
 
     Log::Comment(L"----Reset Default Foreground and Retain Rendition----");
     textAttributes.SetDefaultForeground();
-    qExpectedInput.push_back("\x1b[m");
-    qExpectedInput.push_back(renditionSequence.str());
+    qExpectedInput.push_back(resetRenditionSequence.str());
     VERIFY_SUCCEEDED(engine->UpdateDrawingBrushes(textAttributes, &renderData, false, false));
 
     Log::Comment(L"----Set Green Background----");
@@ -876,8 +902,7 @@ void VtRendererTest::Xterm256TestAttributesAcrossReset()
 
     Log::Comment(L"----Reset Default Background and Retain Rendition----");
     textAttributes.SetDefaultBackground();
-    qExpectedInput.push_back("\x1b[m");
-    qExpectedInput.push_back(renditionSequence.str());
+    qExpectedInput.push_back(resetRenditionSequence.str());
     VERIFY_SUCCEEDED(engine->UpdateDrawingBrushes(textAttributes, &renderData, false, false));
 
     VerifyExpectedInputsDrained();
@@ -1611,3 +1636,134 @@ void VtRendererTest::FormattedString()
     qExpectedInput.push_back("\x1b[28;3;500;500;500m");
     VERIFY_SUCCEEDED(engine->_WriteFormatted(bigFormat, bigValue, bigValue, bigValue));
 }
+
+void VtRendererTest::TestPassthroughMode()
+{
+    Viewport view = SetUpViewport();
+    wil::unique_hfile hFile = wil::unique_hfile(INVALID_HANDLE_VALUE);
+    auto engine = std::make_unique<Xterm256Engine>(std::move(hFile), view);
+    auto pfn = std::bind(&VtRendererTest::WriteCallback, this, std::placeholders::_1, std::placeholders::_2);
+    engine->SetTestCallback(pfn);
+    engine->SetPassthroughMode(true);
+
+    Log::Comment(L"Strings are forwarded as is, encoded as UTF-8");
+    qExpectedInput.push_back("\x1b[31mfoo\xe2\x82\xac\x1b[m\r\n");
+    VERIFY_SUCCEEDED(engine->PassThroughString(L"\x1b[31mfoo\x20ac\x1b[m\r\n"));
+    VerifyExpectedInputsDrained();
+
+    Log::Comment(L"Nothing is rendered from the buffer, however much was invalidated");
+    VERIFY_SUCCEEDED(engine->InvalidateAll());
+    VERIFY_ARE_EQUAL(S_FALSE, engine->StartPaint());
+    VERIFY_IS_FALSE(engine->_invalidMap.any());
+    VerifyExpectedInputsDrained();
+}
+
+void VtRendererTest::TestSkipUnchangedCells()
+{
+    wil::unique_hfile hFile = wil::unique_hfile(INVALID_HANDLE_VALUE);
+    auto engine = std::make_unique<Xterm256Engine>(std::move(hFile), SetUpViewport());
+    auto pfn = std::bind(&VtRendererTest::WriteCallback, this, std::placeholders::_1, std::placeholders::_2);
+    engine->SetTestCallback(pfn);
+
+    qExpectedInput.push_back("\x1b[2J");
+    TestPaint(*engine, [&]() {
+        VERIFY_IS_FALSE(engine->_firstPaint);
+    });
+
+    const auto makeClusters = [](const std::wstring_view text) {
+        std::vector<Cluster> clusters;
+        for (size_t i = 0; i < text.size(); i++)
+        {
+            clusters.emplace_back(text.substr(i, 1), 1u);
+        }
+        return clusters;
+    };
+    const auto line1 = makeClusters(L"asdfghjkl");
+    const auto line2 = makeClusters(L"asdfXhjkl");
+
+    TestPaint(*engine, [&]() {
+        Log::Comment(L"The first time a line is painted, all of it is written.");
+        qExpectedInput.push_back("\x1b[H");
+        VERIFY_SUCCEEDED(engine->_MoveCursor({ 0, 0 }));
+        qExpectedInput.push_back("asdfghjkl");
+        VERIFY_SUCCEEDED(engine->PaintBufferLine({ line1.data(), line1.size() }, { 0, 0 }, false, false));
+    });
+
+    TestPaint(*engine, [&]() {
+        Log::Comment(L"Painting the same line again writes nothing.");
+        qExpectedInput.push_back(EMPTY_CALLBACK_SENTINEL);
+        VERIFY_SUCCEEDED(engine->PaintBufferLine({ line1.data(), line1.size() }, { 0, 0 }, false, false));
+        WriteCallback(EMPTY_CALLBACK_SENTINEL, 1);
+    });
+
+    TestPaint(*engine, [&]() {
+        Log::Comment(L"Only the changed character of the line is written.");
+        qExpectedInput.push_back("\x1b[1;5H");
+        qExpectedInput.push_back("X");
+        VERIFY_SUCCEEDED(engine->PaintBufferLine({ line2.data(), line2.size() }, { 0, 0 }, false, false));
+    });
+
+    TestPaint(*engine, [&]() {
+        Log::Comment(L"After a clear, the line is written in full again.");
+        engine->_ResetShadow();
+        qExpectedInput.push_back("\x1b[H");
+        VERIFY_SUCCEEDED(engine->_MoveCursor({ 0, 0 }));
+        qExpectedInput.push_back("asdfXhjkl");
+        VERIFY_SUCCEEDED(engine->PaintBufferLine({ line2.data(), line2.size() }, { 0, 0 }, false, false));
+    });
+}
+
+void VtRendererTest::TestCoordinatedResize()
+{
+    wil::unique_hfile hFile = wil::unique_hfile(INVALID_HANDLE_VALUE);
+    auto engine = std::make_unique<Xterm256Engine>(std::move(hFile), SetUpViewport());
+    auto pfn = std::bind(&VtRendererTest::WriteCallback, this, std::placeholders::_1, std::placeholders::_2);
+    engine->SetTestCallback(pfn);
+    engine->SetResizeQuirk(true);
+    engine->SetCoordinatedResize(true);
+
+    qExpectedInput.push_back("\x1b[2J");
+    TestPaint(*engine, [&]() {
+        VERIFY_IS_FALSE(engine->_firstPaint);
+    });
+
+    const auto makeClusters = [](const std::wstring_view text) {
+        std::vector<Cluster> clusters;
+        for (size_t i = 0; i < text.size(); i++)
+        {
+            clusters.emplace_back(text.substr(i, 1), 1u);
+        }
+        return clusters;
+    };
+    const auto line = makeClusters(L"asdfghjkl");
+
+    Log::Comment(L"The terminal resizes us. It reflowed its buffer already, so the frame only moves its cursor.");
+    VERIFY_SUCCEEDED(engine->SuppressResizeRepaint());
+    const auto newView = Viewport::FromDimensions({ 0, 0 }, { 120, 30 });
+    VERIFY_SUCCEEDED(engine->UpdateViewport(newView.ToInclusive()));
+    const COORD delta{ 0, -2 };
+    VERIFY_SUCCEEDED(engine->InvalidateScroll(&delta));
+
+    TestPaint(*engine, [&]() {
+        VERIFY_IS_TRUE(engine->_invalidMap.all());
+        VERIFY_ARE_EQUAL(til::point{}, engine->_scrollDelta);
+        VERIFY_SUCCEEDED(engine->PaintBufferLine({ line.data(), line.size() }, { 0, 0 }, false, false));
+        qExpectedInput.push_back("\x1b[1;10H");
+    });
+    VERIFY_IS_FALSE(engine->_resyncAfterResize);
+
+    TestPaint(*engine, [&]() {
+        Log::Comment(L"The shadow was rebuilt silently, so painting the same line again writes nothing.");
+        qExpectedInput.push_back(EMPTY_CALLBACK_SENTINEL);
+        VERIFY_SUCCEEDED(engine->PaintBufferLine({ line.data(), line.size() }, { 0, 0 }, false, false));
+        WriteCallback(EMPTY_CALLBACK_SENTINEL, 1);
+    });
+
+    TestPaint(*engine, [&]() {
+        Log::Comment(L"Once resynced, changes are written again.");
+        const auto changed = makeClusters(L"asdfXhjkl");
+        qExpectedInput.push_back("\x1b[1;5H");
+        qExpectedInput.push_back("X");
+        VERIFY_SUCCEEDED(engine->PaintBufferLine({ changed.data(), changed.size() }, { 0, 0 }, false, false));
+    });
+}
@@ -17,6 +17,7 @@
 #include "til/bitmap.h"
 #include "til/u8u16convert.h"
 #include "til/spsc.h"
+#include "til/mpsc.h"
 #include "til/coalesce.h"
 #include "til/replace.h"
 #include "til/string.h"
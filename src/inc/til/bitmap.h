@@ -46,7 +46,9 @@ namespace til // Terminal Implementation Library. Also: "Today I Learned"
 
             constexpr bool operator==(const _bitmap_const_iterator& other) const noexcept
             {
-                return _pos == other._pos && _values == other._values;
+                // Compare the identity of the bits, not their contents. The latter would
+                // cost a walk over every word of the bitmap each time a loop checks for end().
+                return _pos == other._pos && &_values == &other._values;
             }
 
             constexpr bool operator!=(const _bitmap_const_iterator& other) const noexcept
@@ -148,7 +150,9 @@ namespace til // Terminal Implementation Library. Also: "Today I Learned"
                 _sz{},
                 _rc{},
                 _bits{ _alloc },
-                _runs{ _alloc }
+                _runs{ _alloc },
+                _runsDirtyTop{},
+                _runsDirtyBottom{}
             {
             }
 
@@ -172,7 +176,9 @@ namespace til // Terminal Implementation Library. Also: "Today I Learned"
                 _sz(sz),
                 _rc(sz),
                 _bits(_sz.area(), fill ? std::numeric_limits<unsigned long long>::max() : 0, _alloc),
-                _runs{ _alloc }
+                _runs{ _alloc },
+                _runsDirtyTop{},
+                _runsDirtyBottom{}
             {
             }
 
@@ -186,7 +192,9 @@ namespace til // Terminal Implementation Library. Also: "Today I Learned"
                 _sz{ other._sz },
                 _rc{ other._rc },
                 _bits{ other._bits },
-                _runs{ other._runs }
+                _runs{ other._runs },
+                _runsDirtyTop{ other._runsDirtyTop },
+                _runsDirtyBottom{ other._runsDirtyBottom }
             {
                 // copy constructor is required to call select_on_container_copy
             }
@@ -201,6 +209,8 @@ namespace til // Terminal Implementation Library. Also: "Today I Learned"
                 _rc = other._rc;
                 _bits = other._bits;
                 _runs = other._runs;
+                _runsDirtyTop = other._runsDirtyTop;
+                _runsDirtyBottom = other._runsDirtyBottom;
                 return *this;
             }
 
@@ -209,7 +219,9 @@ namespace til // Terminal Implementation Library. Also: "Today I Learned"
                 _sz{ std::move(other._sz) },
                 _rc{ std::move(other._rc) },
                 _bits{ std::move(other._bits) },
-                _runs{ std::move(other._runs) }
+                _runs{ std::move(other._runs) },
+                _runsDirtyTop{ other._runsDirtyTop },
+                _runsDirtyBottom{ other._runsDirtyBottom }
             {
             }
 
@@ -221,6 +233,8 @@ namespace til // Terminal Implementation Library. Also: "Today I Learned"
                 }
                 _bits = std::move(other._bits);
                 _runs = std::move(other._runs);
+                _runsDirtyTop = other._runsDirtyTop;
+                _runsDirtyBottom = other._runsDirtyBottom;
                 _sz = std::move(other._sz);
                 _rc = std::move(other._rc);
                 return *this;
@@ -236,6 +250,8 @@ namespace til // Terminal Implementation Library. Also: "Today I Learned"
                 }
                 std::swap(_bits, other._bits);
                 std::swap(_runs, other._runs);
+                std::swap(_runsDirtyTop, other._runsDirtyTop);
+                std::swap(_runsDirtyBottom, other._runsDirtyBottom);
                 std::swap(_sz, other._sz);
                 std::swap(_rc, other._rc);
             }
@@ -270,6 +286,15 @@ namespace til // Terminal Implementation Library. Also: "Today I Learned"
                 {
                     _runs.emplace(begin(), end());
                 }
+                // If only some rows changed since the runs were cached, rebuild just those.
+                // Most frames only invalidate a handful of rows (the cursor, a line of output),
+                // which makes this a lot cheaper than walking the entire bitmap again.
+                else if (_runsDirtyTop < _runsDirtyBottom)
+                {
+                    _rebuildDirtyRuns();
+                }
+                _runsDirtyTop = 0;
+                _runsDirtyBottom = 0;
 
                 // Return the runs.
                 return _runs.value();
@@ -278,27 +303,59 @@ namespace til // Terminal Implementation Library. Also: "Today I Learned"
             // optional fill the uncovered area with bits.
             void translate(const til::point delta, bool fill = false)
             {
-                if (delta.x() == 0)
+                if (delta == til::point{})
                 {
-                    // fast path by using bit shifting
-                    translate_y(delta.y(), fill);
                     return;
                 }
 
-                // FUTURE: PERF: GH #4015: This could use in-place walk semantics instead of a temporary.
-                bitmap<allocator_type> other{ _sz, _alloc };
-
-                for (auto run : *this)
+                // If everything slides out of the bitmap, there's nothing to move.
+                if (std::abs(delta.x()) >= _sz.width() || std::abs(delta.y()) >= _sz.height())
                 {
-                    // Offset by the delta
-                    run += delta;
+                    if (fill)
+                    {
+                        set_all();
+                    }
+                    else
+                    {
+                        reset_all();
+                    }
+                    return;
+                }
+
+                _runs.reset(); // reset cached runs on any non-const method
+
+                // The bits are stored row by row, so moving every bit by the same delta
+                // is a single shift of the whole bitset by delta.y rows and delta.x columns.
+                // dynamic_bitset does that a word at a time.
+                const auto bitShift = delta.y() * _sz.width() + delta.x();
 
-                    // Intersect with the bounds of our bitmap area
-                    // as part of it could have slid out of bounds.
-                    run &= _rc;
+#pragma warning(push)
+                // we can't depend on GSL here, so we use static_cast for explicit narrowing
+#pragma warning(disable : 26472)
+                const auto newBits = static_cast<size_t>(std::abs(bitShift));
+                const auto wrappedBits = static_cast<size_t>(std::abs(delta.x()));
+#pragma warning(pop)
 
-                    // Set it into the new bitmap.
-                    other.set(run);
+                if (bitShift > 0)
+                {
+                    // This operator doesn't modify the size of `_bits`: the
+                    // new bits are set to 0.
+                    _bits <<= newBits;
+                }
+                else
+                {
+                    _bits >>= newBits;
+                }
+
+                // A horizontal shift moves the end of every row into the start of the
+                // next one (or vice versa). Those bits slid out of the bitmap's area.
+                if (wrappedBits != 0)
+                {
+                    const auto wrappedColumn = delta.x() > 0 ? 0 : _sz.width() + delta.x();
+                    for (ptrdiff_t row = 0; row < _sz.height(); ++row)
+                    {
+                        _bits.reset(_rc.index_of(til::point{ wrappedColumn, row }), wrappedBits);
+                    }
                 }
 
                 // If we were asked to fill... find the uncovered region.
@@ -340,18 +397,15 @@ namespace til // Terminal Implementation Library. Also: "Today I Learned"
                     const auto fillRects = originalRect - translatedRect;
                     for (const auto& f : fillRects)
                     {
-                        other.set(f);
+                        set(f);
                     }
                 }
-
-                // Swap us with the temporary one.
-                std::swap(other, *this);
             }
 
             void set(const til::point pt)
             {
                 THROW_HR_IF(E_INVALIDARG, !_rc.contains(pt));
-                _runs.reset(); // reset cached runs on any non-const method
+                _invalidateRuns(pt.y(), pt.y() + 1);
 
                 _bits.set(_rc.index_of(pt));
             }
@@ -359,7 +413,14 @@ namespace til // Terminal Implementation Library. Also: "Today I Learned"
             void set(const til::rectangle rc)
             {
                 THROW_HR_IF(E_INVALIDARG, !_rc.contains(rc));
-                _runs.reset(); // reset cached runs on any non-const method
+                _invalidateRuns(rc.top(), rc.bottom());
+
+                // Full rows are contiguous, so they can be set all at once.
+                if (rc.width() == _sz.width())
+                {
+                    _bits.set(_rc.index_of(rc.origin()), rc.size().area(), true);
+                    return;
+                }
 
                 for (auto row = rc.top(); row < rc.bottom(); ++row)
                 {
@@ -375,7 +436,14 @@ namespace til // Terminal Implementation Library. Also: "Today I Learned"
 
             void reset_all() noexcept
             {
-                _runs.reset(); // reset cached runs on any non-const method
+                // An empty bitmap has no runs, so the cache stays valid.
+                // Keeping it around also keeps its memory for the next frame.
+                if (_runs.has_value())
+                {
+                    _runs->clear();
+                }
+                _runsDirtyTop = 0;
+                _runsDirtyBottom = 0;
                 _bits.reset();
             }
 
@@ -473,59 +541,41 @@ namespace til // Terminal Implementation Library. Also: "Today I Learned"
             }
 
         private:
-            void translate_y(ptrdiff_t delta_y, bool fill)
+            // Marks the given rows as changed since the runs were last cached.
+            void _invalidateRuns(const ptrdiff_t top, const ptrdiff_t bottom) noexcept
             {
-                if (delta_y == 0)
-                {
-                    return;
-                }
-
-                const auto bitShift = delta_y * _sz.width();
-
-#pragma warning(push)
-                // we can't depend on GSL here, so we use static_cast for explicit narrowing
-#pragma warning(disable : 26472)
-                const auto newBits = static_cast<size_t>(std::abs(bitShift));
-#pragma warning(pop)
-                const bool isLeftShift = bitShift > 0;
-
-                if (newBits >= _bits.size())
-                {
-                    if (fill)
-                    {
-                        set_all();
-                    }
-                    else
-                    {
-                        reset_all();
-                    }
-                    return;
-                }
-
-                if (isLeftShift)
+                if (_runsDirtyTop < _runsDirtyBottom)
                 {
-                    // This operator doesn't modify the size of `_bits`: the
-                    // new bits are set to 0.
-                    _bits <<= newBits;
+                    _runsDirtyTop = std::min(_runsDirtyTop, top);
+                    _runsDirtyBottom = std::max(_runsDirtyBottom, bottom);
                 }
                 else
                 {
-                    _bits >>= newBits;
+                    _runsDirtyTop = top;
+                    _runsDirtyBottom = bottom;
                 }
+            }
 
-                if (fill)
+            // Replaces the cached runs of the dirty rows with freshly built ones.
+            // Runs never span more than one row and are cached in order, so the
+            // runs of any range of rows are a contiguous slice of the cache.
+            void _rebuildDirtyRuns() const
+            {
+                auto& runs = _runs.value();
+                const auto isAboveRow = [](const til::rectangle& run, const ptrdiff_t row) noexcept {
+                    return run.top() < row;
+                };
+                const auto first = std::lower_bound(runs.begin(), runs.end(), _runsDirtyTop, isAboveRow);
+                const auto last = std::lower_bound(first, runs.end(), _runsDirtyBottom, isAboveRow);
+
+                std::vector<til::rectangle, run_allocator_type> fresh{ runs.get_allocator() };
+                const auto endIt = end();
+                for (auto it = const_iterator(_bits, _sz, _rc.index_of(til::point{ 0, _runsDirtyTop })); it != endIt && it->top() < _runsDirtyBottom; ++it)
                 {
-                    if (isLeftShift)
-                    {
-                        _bits.set(0, newBits, true);
-                    }
-                    else
-                    {
-                        _bits.set(_bits.size() - newBits, newBits, true);
-                    }
+                    fresh.push_back(*it);
                 }
 
-                _runs.reset(); // reset cached runs on any non-const method
+                runs.insert(runs.erase(first, last), fresh.begin(), fresh.end());
             }
 
             allocator_type _alloc;
@@ -534,6 +584,9 @@ namespace til // Terminal Implementation Library. Also: "Today I Learned"
             dynamic_bitset<unsigned long long, allocator_type> _bits;
 
             mutable std::optional<std::vector<til::rectangle, run_allocator_type>> _runs;
+            // The rows [_runsDirtyTop, _runsDirtyBottom) changed since _runs was cached.
+            mutable ptrdiff_t _runsDirtyTop;
+            mutable ptrdiff_t _runsDirtyBottom;
 
 #ifdef UNIT_TESTING
             friend class ::BitmapTests;
@@ -0,0 +1,199 @@
+// Copyright (c) Microsoft Corporation.
+// Licensed under the MIT license.
+
+#pragma once
+
+#include "spsc.h"
+
+// til: Terminal Implementation Library. Also: "Today I Learned".
+// mpsc: Multiple Producer Single Consumer. A MPSC queue sends data from any number of senders to one receiver.
+namespace til::mpsc
+{
+    using size_type = spsc::size_type;
+
+    // queue is a bounded, lock-free FIFO queue that any number of threads may push into concurrently,
+    // while only a single thread at a time may pop from it.
+    //
+    // It's based on Dmitry Vyukov's bounded MPMC queue: Every slot carries a sequence number,
+    // which tells producers and the consumer whose turn it is to access that slot.
+    // * A producer claims position p by advancing _producer with a CAS, once the slot's sequence equals p.
+    // * After it constructed the item, it stores p + 1 into the sequence, which allows the consumer to read it.
+    // * After the consumer moved the item out, it stores p + capacity into the sequence,
+    //   which is the position the slot will have in the next revolution.
+    // Positions wrap around at 2^32, which is fine, since the capacity is a power of 2 and
+    // all comparisons are made on the (signed) difference between a sequence and a position.
+    template<typename T>
+    class queue
+    {
+        // Items are constructed before a slot is claimed and then moved into it, so that a producer
+        // can't fail in between claiming and publishing a slot, which would stall the consumer forever.
+        static_assert(std::is_nothrow_move_constructible_v<T>);
+
+    public:
+        // The capacity will be rounded up to the next power of 2.
+        explicit queue(size_type capacity) :
+            _capacity{ _roundUpCapacity(capacity) },
+            _slots{ spsc::details::alloc_raw_memory<slot>(size_t(_capacity) * sizeof(slot)) }
+        {
+            std::uninitialized_default_construct_n(_slots, _capacity);
+            for (size_type i = 0; i < _capacity; ++i)
+            {
+                _slots[i].sequence.store(i, std::memory_order_relaxed);
+            }
+        }
+
+        queue(const queue&) = delete;
+        queue& operator=(const queue&) = delete;
+        queue(queue&&) = delete;
+        queue& operator=(queue&&) = delete;
+
+        ~queue()
+        {
+            while (try_pop())
+            {
+            }
+
+            std::destroy_n(_slots, _capacity);
+            spsc::details::free_raw_memory(_slots);
+        }
+
+        size_type capacity() const noexcept
+        {
+            return _capacity;
+        }
+
+        // Constructs an item in-place at the end of the queue.
+        // Returns false if the queue is full, in which case nothing was pushed.
+        // May be called from any number of threads concurrently.
+        template<typename... Args>
+        bool try_emplace(Args&&... args)
+        {
+            T item(std::forward<Args>(args)...);
+
+            auto pos = _producer.load(std::memory_order_relaxed);
+            slot* s;
+
+            for (;;)
+            {
+                s = &_slots[pos & (_capacity - 1)];
+                const auto seq = s->sequence.load(std::memory_order_acquire);
+                const auto diff = static_cast<int32_t>(seq - pos);
+
+                if (diff == 0)
+                {
+                    // compare_exchange_weak() updates pos on failure.
+                    if (_producer.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed))
+                    {
+                        break;
+                    }
+                }
+                else if (diff < 0)
+                {
+                    // The slot still holds the item from the previous revolution.
+                    return false;
+                }
+                else
+                {
+                    // Another producer claimed this position before us.
+                    pos = _producer.load(std::memory_order_relaxed);
+                }
+            }
+
+            new (&s->storage[0]) T(std::move(item));
+            s->sequence.store(pos + 1, std::memory_order_release);
+            s->sequence.notify_one();
+            return true;
+        }
+
+        // Moves the first item out of the queue or returns nullopt if it's empty.
+        // Must only be called by one thread at a time.
+        std::optional<T> try_pop()
+        {
+            auto& s = _slots[_consumer & (_capacity - 1)];
+            if (s.sequence.load(std::memory_order_acquire) != _consumer + 1)
+            {
+                return std::nullopt;
+            }
+            return _take(s);
+        }
+
+        // Moves the first item out of the queue and blocks until one is available if it's empty.
+        // Must only be called by one thread at a time.
+        T pop()
+        {
+            auto& s = _slots[_consumer & (_capacity - 1)];
+            for (;;)
+            {
+                const auto seq = s.sequence.load(std::memory_order_acquire);
+                if (seq == _consumer + 1)
+                {
+                    break;
+                }
+                s.sequence.wait(seq, std::memory_order_relaxed);
+            }
+            return _take(s);
+        }
+
+        // Moves up to count items out of the queue into the range starting at first,
+        // without blocking. Returns the number of items that were popped.
+        // Must only be called by one thread at a time.
+        template<typename OutputIt>
+        size_t pop_n(OutputIt first, size_t count)
+        {
+            size_t n = 0;
+            for (; n < count; ++n)
+            {
+                auto& s = _slots[_consumer & (_capacity - 1)];
+                if (s.sequence.load(std::memory_order_acquire) != _consumer + 1)
+                {
+                    break;
+                }
+                *first = _take(s);
+                ++first;
+            }
+            return n;
+        }
+
+    private:
+        struct slot
+        {
+            spsc::details::atomic_size_type sequence;
+            alignas(T) std::byte storage[sizeof(T)];
+        };
+
+        static size_type _roundUpCapacity(size_type capacity)
+        {
+            // The upper bound ensures that the signed difference between a sequence and a position is meaningful.
+            if (capacity == 0 || capacity > (size_type{ 1 } << 30))
+            {
+                throw std::invalid_argument{ "invalid capacity" };
+            }
+
+            size_type result = 1;
+            while (result < capacity)
+            {
+                result <<= 1;
+            }
+            return result;
+        }
+
+        T _take(slot& s) noexcept
+        {
+            const auto ptr = std::launder(reinterpret_cast<T*>(&s.storage[0]));
+            T item{ std::move(*ptr) };
+            std::destroy_at(ptr);
+
+            s.sequence.store(_consumer + _capacity, std::memory_order_release);
+            ++_consumer;
+            return item;
+        }
+
+        size_type _capacity;
+        slot* _slots;
+
+        // Keep the producer and consumer positions on separate cache lines,
+        // so that producers don't slow down the consumer by bouncing its cache line around.
+        alignas(64) std::atomic<size_type> _producer{ 0 };
+        alignas(64) size_type _consumer = 0;
+    };
+}
@@ -70,4 +70,55 @@ namespace til::pmr
         return std::pmr::get_default_resource();
     }
 #endif
+
+    // A memory resource that counts the allocations it passes on to its upstream
+    // resource, so that we can tell how much heap traffic a part of the code causes.
+    // Only allocations are counted, the bytes are those that were requested.
+    class counting_resource final : public std::pmr::memory_resource
+    {
+    public:
+        explicit counting_resource(std::pmr::memory_resource* const upstream = get_default_resource()) noexcept :
+            _upstream{ upstream }
+        {
+        }
+
+        [[nodiscard]] size_t allocations() const noexcept
+        {
+            return _allocations.load(std::memory_order_relaxed);
+        }
+
+        [[nodiscard]] size_t bytes() const noexcept
+        {
+            return _bytes.load(std::memory_order_relaxed);
+        }
+
+        void reset() noexcept
+        {
+            _allocations.store(0, std::memory_order_relaxed);
+            _bytes.store(0, std::memory_order_relaxed);
+        }
+
+    private:
+        bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override
+        {
+            return this == &other;
+        }
+
+        void* do_allocate(const size_t bytes, const size_t align) override
+        {
+            const auto ptr = _upstream->allocate(bytes, align);
+            _allocations.fetch_add(1, std::memory_order_relaxed);
+            _bytes.fetch_add(bytes, std::memory_order_relaxed);
+            return ptr;
+        }
+
+        void do_deallocate(void* const ptr, const size_t bytes, const size_t align) noexcept override
+        {
+            _upstream->deallocate(ptr, bytes, align);
+        }
+
+        std::pmr::memory_resource* _upstream;
+        std::atomic<size_t> _allocations{ 0 };
+        std::atomic<size_t> _bytes{ 0 };
+    };
 }
@@ -29,6 +29,13 @@ namespace til // Terminal Implementation Library. Also: "Today I Learned"
             {
             }
 
+            // pos is the offset within the run it points to.
+            rle_iterator(ParentIt&& it, const size_type pos) noexcept :
+                _it{ std::forward<ParentIt>(it) },
+                _pos{ pos }
+            {
+            }
+
             [[nodiscard]] reference operator*() const noexcept
             {
                 return _it->value;
@@ -317,7 +324,7 @@ namespace til // Terminal Implementation Library. Also: "Today I Learned"
         basic_rle& operator=(const basic_rle& other) = default;
 
         basic_rle(basic_rle&& other) noexcept :
-            _runs(std::move(other._runs)), _total_length(other._total_length)
+            _runs(std::move(other._runs)), _run_ends(std::move(other._run_ends)), _total_length(other._total_length)
         {
             // C++ fun fact:
             // "std::move" actually doesn't actually promise to _really_ move stuff from A to B,
@@ -331,6 +338,7 @@ namespace til // Terminal Implementation Library. Also: "Today I Learned"
             //     We can detect these cases using _runs.empty() and set _total_length accordingly.
             if (other._runs.empty())
             {
+                other._run_ends.clear();
                 other._total_length = 0;
             }
         }
@@ -338,11 +346,13 @@ namespace til // Terminal Implementation Library. Also: "Today I Learned"
         basic_rle& operator=(basic_rle&& other) noexcept
         {
             _runs = std::move(other._runs);
+            _run_ends = std::move(other._run_ends);
             _total_length = other._total_length;
 
             // See basic_rle(basic_rle&&) for why this is necessary.
             if (other._runs.empty())
             {
+                other._run_ends.clear();
                 other._total_length = 0;
             }
 
@@ -356,6 +366,7 @@ namespace til // Terminal Implementation Library. Also: "Today I Learned"
             {
                 _total_length += run.length;
             }
+            _update_index(0);
         }
 
         basic_rle(container&& runs) :
@@ -365,6 +376,7 @@ namespace til // Terminal Implementation Library. Also: "Today I Learned"
             {
                 _total_length += run.length;
             }
+            _update_index(0);
         }
 
         basic_rle(const size_type length, const value_type& value) :
@@ -379,6 +391,7 @@ namespace til // Terminal Implementation Library. Also: "Today I Learned"
         void swap(basic_rle& other) noexcept
         {
             _runs.swap(other._runs);
+            _run_ends.swap(other._run_ends);
             std::swap(_total_length, other._total_length);
         }
 
@@ -403,18 +416,22 @@ namespace til // Terminal Implementation Library. Also: "Today I Learned"
         // Get the value at the position
         const_reference at(size_type position) const
         {
-            const auto begin = _runs.begin();
-            const auto end = _runs.end();
+            const auto run = _find_run(position).first;
 
-            rle_scanner scanner(begin, end);
-            auto it = scanner.scan(position).first;
-
-            if (it == end)
+            if (run == _runs.size())
             {
                 throw std::out_of_range("position out of range");
             }
 
-            return it->value;
+            return _runs[run].value;
+        }
+
+        // Returns an iterator pointing at the position, or end() if it's past the end.
+        // Unlike begin() + position this doesn't walk the runs that come before it.
+        [[nodiscard]] const_iterator iterator_at(size_type position) const noexcept
+        {
+            const auto [run, run_pos] = _find_run(position);
+            return const_iterator(_runs.begin() + run, run_pos);
         }
 
         // Returns the range [start_index, end_index) as a new vector.
@@ -489,6 +506,7 @@ namespace til // Terminal Implementation Library. Also: "Today I Learned"
             }
 
             _compact();
+            _update_index(0);
         }
 
         // Adjust the size of the vector.
@@ -496,18 +514,21 @@ namespace til // Terminal Implementation Library. Also: "Today I Learned"
         // If the size is being decreased, the trailing runs are cut off to fit.
         void resize_trailing_extent(const size_type new_size)
         {
+            size_t first_changed_run = 0;
+
             if (new_size == 0)
             {
                 _runs.clear();
             }
             else if (new_size < _total_length)
             {
-                rle_scanner scanner(_runs.begin(), _runs.end());
-                auto [run, pos] = scanner.scan(new_size - 1);
+                const auto [run_index, pos] = _find_run(new_size - 1);
+                auto run = _runs.begin() + run_index;
 
-                run->length = ++pos;
+                run->length = static_cast<size_type>(pos + 1);
 
                 _runs.erase(++run, _runs.cend());
+                first_changed_run = run_index;
             }
             else if (new_size > _total_length)
             {
@@ -515,9 +536,11 @@ namespace til // Terminal Implementation Library. Also: "Today I Learned"
                 auto& run = _runs.back();
 
                 run.length += new_size - _total_length;
+                first_changed_run = _runs.size() - 1;
             }
 
             _total_length = new_size;
+            _update_index(first_changed_run);
         }
 
         constexpr bool operator==(const basic_rle& other) const noexcept
@@ -639,6 +662,57 @@ namespace til // Terminal Implementation Library. Also: "Today I Learned"
             _runs(std::forward<container>(runs)),
             _total_length(size)
         {
+            _update_index(0);
+        }
+
+        // Returns the index of the run that contains the position and the offset within that run.
+        // If the position is past the end, this returns { _runs.size(), 0 }, just like rle_scanner.
+        std::pair<size_t, size_type> _find_run(size_type position) const noexcept
+        {
+            if (_run_ends.empty())
+            {
+                rle_scanner scanner(_runs.begin(), _runs.end());
+                const auto [it, run_pos] = scanner.scan(position);
+                return { gsl::narrow_cast<size_t>(it - _runs.begin()), run_pos };
+            }
+
+            const auto it = std::upper_bound(_run_ends.begin(), _run_ends.end(), position);
+            const auto run = gsl::narrow_cast<size_t>(it - _run_ends.begin());
+            if (run == _run_ends.size())
+            {
+                return { run, 0 };
+            }
+            const size_type run_start = run ? _run_ends[run - 1] : 0;
+            return { run, static_cast<size_type>(position - run_start) };
+        }
+
+        // Brings _run_ends up to date after the runs starting at first_changed_run were modified.
+        // The runs before it must still have the same lengths.
+        void _update_index(size_t first_changed_run)
+        {
+            if (_runs.size() < index_threshold)
+            {
+                // Rows of text mostly consist of just a few runs, so they don't pay for an index.
+                if (_run_ends.capacity())
+                {
+                    _run_ends = {};
+                }
+                return;
+            }
+
+            if (_run_ends.empty())
+            {
+                first_changed_run = 0;
+            }
+
+            _run_ends.resize(_runs.size());
+
+            size_type total = first_changed_run ? _run_ends[first_changed_run - 1] : 0;
+            for (auto i = first_changed_run; i < _runs.size(); ++i)
+            {
+                total += _runs[i].length;
+                _run_ends[i] = total;
+            }
         }
 
         void _compact()
@@ -852,9 +926,12 @@ namespace til // Terminal Implementation Library. Also: "Today I Learned"
 
             // TODO GH#10135: Ensure replacements contains no runs with .length == 0.
 
-            rle_scanner scanner{ _runs.begin(), _runs.end() };
-            auto [begin, begin_pos] = scanner.scan(start_index);
-            auto [end, end_pos] = scanner.scan(end_index);
+            const auto [begin_run, begin_run_pos] = _find_run(start_index);
+            const auto [end_run, end_run_pos] = _find_run(end_index);
+            auto begin = _runs.begin() + begin_run;
+            auto begin_pos = begin_run_pos;
+            auto end = _runs.begin() + end_run;
+            auto end_pos = end_run_pos;
 
             // This condition handles pure removals, where replacements.size() == 0.
             //
@@ -882,6 +959,8 @@ namespace til // Terminal Implementation Library. Also: "Today I Learned"
                     }
                 }
 
+                const auto first_changed_run = gsl::narrow_cast<size_t>(begin - _runs.begin());
+
                 if (begin_pos)
                 {
                     begin->length = begin_pos;
@@ -894,6 +973,7 @@ namespace til // Terminal Implementation Library. Also: "Today I Learned"
 
                 _runs.erase(begin, end);
                 _total_length -= removed;
+                _update_index(first_changed_run);
                 return;
             }
 
@@ -933,6 +1013,9 @@ namespace til // Terminal Implementation Library. Also: "Today I Learned"
                 end_pos = 0;
             }
 
+            // Every run before this one keeps its length.
+            const auto first_changed_run = gsl::narrow_cast<size_t>(begin - _runs.begin());
+
             // [Step3]
             if (begin_pos)
             {
@@ -1005,9 +1088,18 @@ namespace til // Terminal Implementation Library. Also: "Today I Learned"
             {
                 _total_length += run.length;
             }
+
+            _update_index(first_changed_run);
         }
 
+        // Rows with this many runs and more get an index for looking up positions.
+        static constexpr size_t index_threshold = 16;
+
         container _runs;
+        // If the runs are indexed, this holds the end position of every run, which allows
+        // at(), iterator_at() and replace() to find a position in O(log runs), instead
+        // of walking all the runs before it. It's empty below the index_threshold.
+        std::vector<size_type> _run_ends;
         S _total_length{ 0 };
 
 #ifdef UNIT_TESTING
@@ -28,15 +28,24 @@ namespace til::spsc
         static constexpr size_type revolution_flag = 1u << (std::numeric_limits<size_type>::digits - 2u); // 0b01000....
         static constexpr size_type drop_flag = 1u << (std::numeric_limits<size_type>::digits - 1u); // 0b10000....
 
+        struct block_never_policy
+        {
+            using _spsc_policy = int;
+            static constexpr bool _block_initially = false;
+            static constexpr bool _block_forever = false;
+        };
+
         struct block_initially_policy
         {
             using _spsc_policy = int;
+            static constexpr bool _block_initially = true;
             static constexpr bool _block_forever = false;
         };
 
         struct block_forever_policy
         {
             using _spsc_policy = int;
+            static constexpr bool _block_initially = true;
             static constexpr bool _block_forever = true;
         };
 
@@ -400,6 +409,9 @@ namespace til::spsc
         }
     }
 
+    // Don't block at all. Only write / read as many items as fit into / are in the queue right now.
+    inline constexpr details::block_never_policy block_never{};
+
     // Block until at least one item has been written into the sender / read from the receiver.
     inline constexpr details::block_initially_policy block_initially{};
 
@@ -484,7 +496,7 @@ namespace til::spsc
 
             const auto data = _arc->data();
             auto remaining = static_cast<size_type>(count);
-            auto blocking = true;
+            auto blocking = std::remove_reference_t<WaitPolicy>::_block_initially;
             auto ok = true;
 
             while (remaining != 0)
@@ -587,7 +599,7 @@ namespace til::spsc
 
             const auto data = _arc->data();
             auto remaining = static_cast<size_type>(count);
-            auto blocking = true;
+            auto blocking = std::remove_reference_t<WaitPolicy>::_block_initially;
             auto ok = true;
 
             while (remaining != 0)
@@ -79,6 +79,16 @@ namespace til
         private:
             std::atomic<bool> _isPending;
         };
+
+        // Throttled functions don't need to run at exactly the end of their delay.
+        // Allowing the system to postpone their timers by up to a quarter of it
+        // lets it coalesce them with other timers, which wakes the CPU up less often.
+        // The given delay is in 100ns units, the returned window length in milliseconds.
+        constexpr DWORD throttled_func_window_length(const int64_t delay) noexcept
+        {
+            const auto window = delay / 40000;
+            return window > 1 ? static_cast<DWORD>(window) : 1;
+        }
     } // namespace details
 
     template<bool leading, typename... Args>
@@ -108,6 +118,7 @@ namespace til
             }
 
             memcpy(&_delay, &d, sizeof(d));
+            _windowLength = details::throttled_func_window_length(delay.count());
         }
 
         // throttled_func uses its `this` pointer when creating _timer.
@@ -172,7 +183,7 @@ namespace til
                 _func();
             }
 
-            SetThreadpoolTimerEx(_timer.get(), &_delay, 0, 0);
+            SetThreadpoolTimerEx(_timer.get(), &_delay, 0, _windowLength);
         }
 
         void _trailing_edge()
@@ -195,6 +206,7 @@ namespace til
         }
 
         FILETIME _delay;
+        DWORD _windowLength;
         function _func;
         wil::unique_threadpool_timer _timer;
         details::throttled_func_storage<Args...> _storage;
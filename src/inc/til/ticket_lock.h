@@ -53,4 +53,54 @@ namespace til
         std::atomic<uint32_t> _next_ticket{ 0 };
         std::atomic<uint32_t> _now_serving{ 0 };
     };
+
+    // shared_ticket_lock is a reader/writer variant of ticket_lock that keeps its fairness:
+    // Readers and writers alike line up in a ticket_lock, which readers only pass through,
+    // while writers hold on to it until they're done. Consecutive readers may thus run
+    // concurrently, but can't starve a writer waiting in line (or vice versa).
+    //
+    // The same caveats as for ticket_lock apply. Use std::unique_lock and std::shared_lock.
+    struct shared_ticket_lock
+    {
+        void lock() noexcept
+        {
+            _turnstile.lock();
+
+            // Wait for the readers that got in before us to finish.
+            for (;;)
+            {
+                const auto readers = _readers.load(std::memory_order_acquire);
+                if (readers == 0)
+                {
+                    break;
+                }
+
+                til::atomic_wait(_readers, readers);
+            }
+        }
+
+        void unlock() noexcept
+        {
+            _turnstile.unlock();
+        }
+
+        void lock_shared() noexcept
+        {
+            _turnstile.lock();
+            _readers.fetch_add(1, std::memory_order_relaxed);
+            _turnstile.unlock();
+        }
+
+        void unlock_shared() noexcept
+        {
+            if (_readers.fetch_sub(1, std::memory_order_release) == 1)
+            {
+                til::atomic_notify_all(_readers);
+            }
+        }
+
+    private:
+        ticket_lock _turnstile;
+        std::atomic<uint32_t> _readers{ 0 };
+    };
 }
@@ -14,6 +14,9 @@ could overcome disadvantages of syscalls. Test results can be read up
 in PR #4093 and the test algorithms are available in src\tools\U8U16Test.
 Based on the results the decision was made to keep using the platform
 functions MultiByteToWideChar and WideCharToMultiByte.
+Plain ASCII (which most of the VT traffic consists of) is an exception: the
+leading ASCII part of a string is converted with SSE2/NEON, and only the rest
+is handed to the platform functions.
 
 Author(s):
 - Steffen Illhardt (german-one) 2020
@@ -21,6 +24,10 @@ Author(s):
 
 #pragma once
 
+#ifdef _M_ARM64
+#include <arm64_neon.h>
+#endif
+
 namespace til // Terminal Implementation Library. Also: "Today I Learned"
 {
     template<class charT>
@@ -51,6 +58,14 @@ namespace til // Terminal Implementation Library. Also: "Today I Learned"
         {
             try
             {
+                // Without partials from the previous call, the complete code points are the start of
+                // the input itself. There's nothing to put in front of them, so we don't copy it at all.
+                if (_partialsLen == 0u)
+                {
+                    out = { in.data(), _cachePartials(in) };
+                    return S_OK;
+                }
+
                 size_t capacity{};
                 RETURN_HR_IF(E_ABORT, !base::CheckAdd(in.length(), _partialsLen).AssignIfValid(&capacity));
 
@@ -84,38 +99,9 @@ namespace til // Terminal Implementation Library. Also: "Today I Learned"
                 }
 
                 _buffer.append(in);
-                size_t remainingLength{ _buffer.length() };
-
-                auto backIter = _buffer.end();
-                // If the last byte in the string was a byte belonging to a UTF-8 multi-byte character
-                if ((*(backIter - 1) & _Utf8BitMasks::MaskAsciiByte) > _Utf8BitMasks::IsAsciiByte)
-                {
-                    // Check only up to 3 last bytes, if no Lead Byte was found then the byte before must be the Lead Byte and no partials are in the string
-                    const size_t stopLen{ std::min(_buffer.length(), gsl::narrow_cast<size_t>(3u)) };
-                    for (size_t sequenceLen{ 1u }; sequenceLen <= stopLen; ++sequenceLen)
-                    {
-                        --backIter;
-                        // If Lead Byte found
-                        if ((*backIter & _Utf8BitMasks::MaskContinuationByte) > _Utf8BitMasks::IsContinuationByte)
-                        {
-                            // If the Lead Byte indicates that the last bytes in the string is a partial UTF-8 code point then cache them:
-                            //  Use the bitmask at index `sequenceLen`. Compare the result with the operand having the same index. If they
-                            //  are not equal then the sequence has to be cached because it is a partial code point. Otherwise the
-                            //  sequence is a complete UTF-8 code point and the whole string is ready for the conversion into a UTF-16 string.
-                            if ((*backIter & _cmpMasks.at(sequenceLen)) != _cmpOperands.at(sequenceLen))
-                            {
-                                std::move(backIter, _buffer.end(), _utfPartials.begin());
-                                remainingLength -= sequenceLen;
-                                _partialsLen = sequenceLen;
-                            }
-
-                            break;
-                        }
-                    }
-                }
 
                 // populate the part of the string that contains complete code points only
-                out = { _buffer.data(), remainingLength };
+                out = { _buffer.data(), _cachePartials(_buffer) };
 
                 return S_OK;
             }
@@ -251,6 +237,52 @@ namespace til // Terminal Implementation Library. Also: "Today I Learned"
             _Utf8BitMasks::IsLeadByteThreeByteSequence,
         };
 
+        // Method Description:
+        // - Caches the code units of a partial UTF-8 code point at the end of a string.
+        //   There must not be any partials cached already.
+        // Arguments:
+        // - str - UTF-8 string that doesn't start in the middle of a code point
+        // Return Value:
+        // - the length of the part of the string that contains complete code points only
+        size_t _cachePartials(const std::basic_string_view<charT> str)
+        {
+            size_t remainingLength{ str.length() };
+            if (str.empty())
+            {
+                return remainingLength;
+            }
+
+            auto backIter = str.end();
+            // If the last byte in the string was a byte belonging to a UTF-8 multi-byte character
+            if ((*(backIter - 1) & _Utf8BitMasks::MaskAsciiByte) > _Utf8BitMasks::IsAsciiByte)
+            {
+                // Check only up to 3 last bytes, if no Lead Byte was found then the byte before must be the Lead Byte and no partials are in the string
+                const size_t stopLen{ std::min(str.length(), gsl::narrow_cast<size_t>(3u)) };
+                for (size_t sequenceLen{ 1u }; sequenceLen <= stopLen; ++sequenceLen)
+                {
+                    --backIter;
+                    // If Lead Byte found
+                    if ((*backIter & _Utf8BitMasks::MaskContinuationByte) > _Utf8BitMasks::IsContinuationByte)
+                    {
+                        // If the Lead Byte indicates that the last bytes in the string is a partial UTF-8 code point then cache them:
+                        //  Use the bitmask at index `sequenceLen`. Compare the result with the operand having the same index. If they
+                        //  are not equal then the sequence has to be cached because it is a partial code point. Otherwise the
+                        //  sequence is a complete UTF-8 code point and the whole string is ready for the conversion into a UTF-16 string.
+                        if ((*backIter & _cmpMasks.at(sequenceLen)) != _cmpOperands.at(sequenceLen))
+                        {
+                            std::copy(backIter, str.end(), _utfPartials.begin());
+                            remainingLength -= sequenceLen;
+                            _partialsLen = sequenceLen;
+                        }
+
+                        break;
+                    }
+                }
+            }
+
+            return remainingLength;
+        }
+
         std::basic_string<charT> _buffer; // buffer to which the populated string_view refers
         std::array<charT, 4> _utfPartials; // buffer for code units of a partial code point that have to be cached
         size_t _partialsLen{}; // number of cached code units
@@ -260,6 +292,119 @@ namespace til // Terminal Implementation Library. Also: "Today I Learned"
     typedef u8u16state<char> u8state;
     typedef u8u16state<wchar_t> u16state;
 
+    namespace details
+    {
+#pragma warning(push)
+#pragma warning(disable : 26481) // Don't use pointer arithmetic. Use span instead (bounds.1).
+#pragma warning(disable : 26490) // Don't use reinterpret_cast (type.1).
+
+        // Routine Description:
+        // - Widens the leading ASCII characters of a UTF-8 string into UTF-16, stopping at the first non-ASCII byte.
+        // Arguments:
+        // - in - the UTF-8 code units
+        // - count - the number of code units in `in`
+        // - out - receives the UTF-16 code units, must have space for `count` of them
+        // Return Value:
+        // - the number of code units converted
+        inline size_t u8u16ascii(const char* const in, const size_t count, wchar_t* const out) noexcept
+        {
+            size_t offset = 0;
+
+#ifdef _M_AMD64
+            const auto zero = _mm_setzero_si128();
+            for (; offset + 16 <= count; offset += 16)
+            {
+                const auto chars = _mm_loadu_si128(reinterpret_cast<const __m128i*>(in + offset));
+                if (_mm_movemask_epi8(chars) != 0)
+                {
+                    break;
+                }
+                _mm_storeu_si128(reinterpret_cast<__m128i*>(out + offset), _mm_unpacklo_epi8(chars, zero));
+                _mm_storeu_si128(reinterpret_cast<__m128i*>(out + offset + 8), _mm_unpackhi_epi8(chars, zero));
+            }
+#elif _M_ARM64
+            for (; offset + 16 <= count; offset += 16)
+            {
+                const auto chars = vld1q_u8(reinterpret_cast<const uint8_t*>(in + offset));
+                if (vmaxvq_u8(chars) >= 0x80)
+                {
+                    break;
+                }
+                vst1q_u16(reinterpret_cast<uint16_t*>(out + offset), vmovl_u8(vget_low_u8(chars)));
+                vst1q_u16(reinterpret_cast<uint16_t*>(out + offset + 8), vmovl_u8(vget_high_u8(chars)));
+            }
+#endif
+
+            // Handles the remaining tail of the string, as well as
+            // the entire string on platforms without vectorized code.
+            for (; offset < count; ++offset)
+            {
+                const auto ch = static_cast<unsigned char>(in[offset]);
+                if (ch >= 0x80)
+                {
+                    break;
+                }
+                out[offset] = static_cast<wchar_t>(ch);
+            }
+            return offset;
+        }
+
+        // Routine Description:
+        // - Narrows the leading ASCII characters of a UTF-16 string into UTF-8, stopping at the first non-ASCII code unit.
+        // Arguments:
+        // - in - the UTF-16 code units
+        // - count - the number of code units in `in`
+        // - out - receives the UTF-8 code units, must have space for `count` of them
+        // Return Value:
+        // - the number of code units converted
+        inline size_t u16u8ascii(const wchar_t* const in, const size_t count, char* const out) noexcept
+        {
+            size_t offset = 0;
+
+#ifdef _M_AMD64
+            const auto nonAscii = _mm_set1_epi16(static_cast<short>(0xff80));
+            const auto zero = _mm_setzero_si128();
+            for (; offset + 16 <= count; offset += 16)
+            {
+                const auto lo = _mm_loadu_si128(reinterpret_cast<const __m128i*>(in + offset));
+                const auto hi = _mm_loadu_si128(reinterpret_cast<const __m128i*>(in + offset + 8));
+                const auto isAscii = _mm_cmpeq_epi16(_mm_and_si128(_mm_or_si128(lo, hi), nonAscii), zero);
+                if (_mm_movemask_epi8(isAscii) != 0xffff)
+                {
+                    break;
+                }
+                _mm_storeu_si128(reinterpret_cast<__m128i*>(out + offset), _mm_packus_epi16(lo, hi));
+            }
+#elif _M_ARM64
+            for (; offset + 16 <= count; offset += 16)
+            {
+                const auto lo = vld1q_u16(reinterpret_cast<const uint16_t*>(in + offset));
+                const auto hi = vld1q_u16(reinterpret_cast<const uint16_t*>(in + offset + 8));
+                if (vmaxvq_u16(vorrq_u16(lo, hi)) >= 0x80)
+                {
+                    break;
+                }
+                vst1q_u8(reinterpret_cast<uint8_t*>(out + offset), vcombine_u8(vmovn_u16(lo), vmovn_u16(hi)));
+            }
+#endif
+
+            // Handles the remaining tail of the string, as well as
+            // the entire string on platforms without vectorized code.
+            for (; offset < count; ++offset)
+            {
+                const auto ch = in[offset];
+                if (ch >= 0x80)
+                {
+                    break;
+                }
+                out[offset] = static_cast<char>(ch);
+            }
+            return offset;
+        }
+
+#pragma warning(pop)
+    }
+
     // Routine Description:
     // - Takes a UTF-8 string and performs the conversion to UTF-16. NOTE: The function relies on getting complete UTF-8 characters at the string boundaries.
     // Arguments:
@@ -287,8 +432,18 @@ namespace til // Terminal Implementation Library. Also: "Today I Learned"
             // The worst ratio of UTF-8 code units to UTF-16 code units is 1 to 1 if UTF-8 consists of ASCII only.
             RETURN_HR_IF(E_ABORT, !base::MakeCheckedNum(in.length()).AssignIfValid(&lengthRequired));
             out.resize(in.length()); // avoid to call MultiByteToWideChar twice only to get the required size
-            const int lengthOut = MultiByteToWideChar(gsl::narrow_cast<UINT>(CP_UTF8), 0ul, in.data(), lengthRequired, out.data(), lengthRequired);
-            out.resize(gsl::narrow_cast<size_t>(lengthOut));
+
+            // An ASCII character always terminates a UTF-8 sequence, so the
+            // remainder starts at a code point boundary.
+            const auto lengthAscii = details::u8u16ascii(in.data(), in.length(), out.data());
+            if (lengthAscii == in.length())
+            {
+                return S_OK;
+            }
+
+            const auto lengthRemaining = gsl::narrow_cast<int>(in.length() - lengthAscii);
+            const int lengthOut = MultiByteToWideChar(gsl::narrow_cast<UINT>(CP_UTF8), 0ul, in.data() + lengthAscii, lengthRemaining, out.data() + lengthAscii, lengthRemaining);
+            out.resize(lengthAscii + gsl::narrow_cast<size_t>(lengthOut));
 
             return lengthOut == 0 ? E_UNEXPECTED : S_OK;
         }
@@ -356,8 +511,19 @@ namespace til // Terminal Implementation Library. Also: "Today I Learned"
             // Thus, the worst ratio of UTF-16 code units to UTF-8 code units is 1 to 3.
             RETURN_HR_IF(E_ABORT, !base::MakeCheckedNum(in.length()).AssignIfValid(&lengthIn) || !base::CheckMul(lengthIn, 3).AssignIfValid(&lengthRequired));
             out.resize(gsl::narrow_cast<size_t>(lengthRequired)); // avoid to call WideCharToMultiByte twice only to get the required size
-            const int lengthOut = WideCharToMultiByte(gsl::narrow_cast<UINT>(CP_UTF8), 0ul, in.data(), lengthIn, out.data(), lengthRequired, nullptr, nullptr);
-            out.resize(gsl::narrow_cast<size_t>(lengthOut));
+
+            // Every non-ASCII character is converted by WideCharToMultiByte,
+            // so surrogate pairs are never split.
+            const auto lengthAscii = details::u16u8ascii(in.data(), in.length(), out.data());
+            if (lengthAscii == in.length())
+            {
+                out.resize(lengthAscii);
+                return S_OK;
+            }
+
+            const auto lengthRemaining = gsl::narrow_cast<int>(in.length() - lengthAscii);
+            const int lengthOut = WideCharToMultiByte(gsl::narrow_cast<UINT>(CP_UTF8), 0ul, in.data() + lengthAscii, lengthRemaining, out.data() + lengthAscii, lengthRequired - gsl::narrow_cast<int>(lengthAscii), nullptr, nullptr);
+            out.resize(lengthAscii + gsl::narrow_cast<size_t>(lengthOut));
 
             return lengthOut == 0 ? E_UNEXPECTED : S_OK;
         }
@@ -44,8 +44,22 @@ static CodepointWidth GetQuickCharWidthLegacyForNumpadEventSynthesis(const wchar
     return CodepointWidth::Invalid;
 }
 
-std::deque<std::unique_ptr<KeyEvent>> Microsoft::Console::Interactivity::CharToKeyEvents(const wchar_t wch,
-                                                                                         const unsigned int codepage)
+// How a wchar_t is typed: either on the keyboard, with the keyState
+// returned by VkKeyScanW and its scan code, or through Alt + numpad.
+struct KeyMapping
+{
+    bool numpad;
+    short keyState;
+    WORD virtualScanCode;
+};
+
+// Routine Description:
+// - asks the current keyboard layout how to type the given wchar_t
+// Arguments:
+// - wch - the wchar_t to look up
+// Return Value:
+// - how to type the wchar_t
+static KeyMapping s_MapCharToKey(const wchar_t wch)
 {
     const short invalidKey = -1;
     short keyState = VkKeyScanW(wch);
@@ -65,31 +79,46 @@ std::deque<std::unique_ptr<KeyEvent>> Microsoft::Console::Interactivity::CharToK
                 // It wasn't alphanumeric or determined to be wide by the old algorithm
                 // if VkKeyScanW fails (char is not in kbd layout), we must
                 // emulate the key being input through the numpad
-                return SynthesizeNumpadEvents(wch, codepage);
+                return { true, 0, 0 };
             }
         }
         keyState = 0; // SynthesizeKeyboardEvents would rather get 0 than -1
     }
 
-    return SynthesizeKeyboardEvents(wch, keyState);
+    return { false, keyState, gsl::narrow<WORD>(MapVirtualKeyW(LOBYTE(keyState), MAPVK_VK_TO_VSC)) };
+}
+
+std::deque<std::unique_ptr<KeyEvent>> Microsoft::Console::Interactivity::CharToKeyEvents(const wchar_t wch,
+                                                                                         const unsigned int codepage)
+{
+    const auto mapping = s_MapCharToKey(wch);
+    if (mapping.numpad)
+    {
+        return SynthesizeNumpadEvents(wch, codepage);
+    }
+
+    return SynthesizeKeyboardEvents(wch, mapping.keyState);
 }
 
 // Routine Description:
-// - converts a wchar_t into a series of KeyEvents as if it was typed
-// using the keyboard
+// - appends the KeyEvents for typing the given wchar_t to keyEvents
 // Arguments:
 // - wch - the wchar_t to convert
-// Return Value:
-// - deque of KeyEvents that represent the wchar_t being typed
+// - keyState - the result of VkKeyScanW for wch
+// - virtualScanCode - the scan code for the virtual key in keyState
+// - keyEvents - receives the events
 // Note:
 // - will throw exception on error
-std::deque<std::unique_ptr<KeyEvent>> Microsoft::Console::Interactivity::SynthesizeKeyboardEvents(const wchar_t wch, const short keyState)
+template<typename T>
+static void s_AppendKeyboardEvents(const wchar_t wch,
+                                   const short keyState,
+                                   const WORD virtualScanCode,
+                                   std::deque<std::unique_ptr<T>>& keyEvents)
 {
     const byte modifierState = HIBYTE(keyState);
 
     bool altGrSet = false;
     bool shiftSet = false;
-    std::deque<std::unique_ptr<KeyEvent>> keyEvents;
 
     // add modifier key event if necessary
     if (WI_AreAllFlagsSet(modifierState, VkKeyScanModState::CtrlAndAltPressed))
@@ -113,8 +142,6 @@ std::deque<std::unique_ptr<KeyEvent>> Microsoft::Console::Interactivity::Synthes
                                                        SHIFT_PRESSED));
     }
 
-    const auto vk = LOBYTE(keyState);
-    const WORD virtualScanCode = gsl::narrow<WORD>(MapVirtualKeyW(vk, MAPVK_VK_TO_VSC));
     KeyEvent keyEvent{ true, 1, LOBYTE(keyState), virtualScanCode, wch, 0 };
 
     // add modifier flags if necessary
@@ -155,10 +182,78 @@ std::deque<std::unique_ptr<KeyEvent>> Microsoft::Console::Interactivity::Synthes
                                                        UNICODE_NULL,
                                                        0));
     }
+}
+
+// Routine Description:
+// - converts a wchar_t into a series of KeyEvents as if it was typed
+// using the keyboard
+// Arguments:
+// - wch - the wchar_t to convert
+// Return Value:
+// - deque of KeyEvents that represent the wchar_t being typed
+// Note:
+// - will throw exception on error
+std::deque<std::unique_ptr<KeyEvent>> Microsoft::Console::Interactivity::SynthesizeKeyboardEvents(const wchar_t wch, const short keyState)
+{
+    const WORD virtualScanCode = gsl::narrow<WORD>(MapVirtualKeyW(LOBYTE(keyState), MAPVK_VK_TO_VSC));
 
+    std::deque<std::unique_ptr<KeyEvent>> keyEvents;
+    s_AppendKeyboardEvents(wch, keyState, virtualScanCode, keyEvents);
     return keyEvents;
 }
 
+// Routine Description:
+// - converts a string into a series of KeyEvents as if it was typed
+// from the keyboard, like calling CharToKeyEvents for each character.
+// - Text usually repeats the same few characters over and over, so the
+// keyboard layout is only consulted once per distinct character.
+// That makes large pastes a lot cheaper.
+// Arguments:
+// - string - the text to convert
+// - codepage - the codepage used for numpad events, see CharToKeyEvents
+// - keyEvents - receives the events
+// Note:
+// - will throw exception on error
+void Microsoft::Console::Interactivity::StringToKeyEvents(const std::wstring_view string,
+                                                         const unsigned int codepage,
+                                                         std::deque<std::unique_ptr<IInputEvent>>& keyEvents)
+{
+    // ASCII is looked up in a table, anything else in a map.
+    std::array<std::optional<KeyMapping>, 128> asciiCache{};
+    std::unordered_map<wchar_t, KeyMapping> cache;
+
+    for (const auto wch : string)
+    {
+        const auto& mapping = [&]() -> const KeyMapping& {
+            if (wch < asciiCache.size())
+            {
+                auto& entry = til::at(asciiCache, wch);
+                if (!entry)
+                {
+                    entry = s_MapCharToKey(wch);
+                }
+                return *entry;
+            }
+
+            const auto it = cache.find(wch);
+            if (it != cache.end())
+            {
+                return it->second;
+            }
+            return cache.emplace(wch, s_MapCharToKey(wch)).first->second;
+        }();
+
+        if (mapping.numpad)
+        {
+            auto convertedEvents = SynthesizeNumpadEvents(wch, codepage);
+            std::move(convertedEvents.begin(), convertedEvents.end(), std::back_inserter(keyEvents));
+            continue;
+        }
+
+        s_AppendKeyboardEvents(wch, mapping.keyState, mapping.virtualScanCode, keyEvents);
+    }
+}
+
 // Routine Description:
 // - converts a wchar_t into a series of KeyEvents as if it was typed
 // using Alt + numpad
@@ -26,4 +26,8 @@ namespace Microsoft::Console::Interactivity
                                                                    const short keyState);
 
     std::deque<std::unique_ptr<KeyEvent>> SynthesizeNumpadEvents(const wchar_t wch, const unsigned int codepage);
+
+    void StringToKeyEvents(const std::wstring_view string,
+                           const unsigned int codepage,
+                           std::deque<std::unique_ptr<IInputEvent>>& keyEvents);
 }
@@ -25,6 +25,7 @@ BgfxEngine::BgfxEngine(PVOID SharedViewBase, LONG DisplayHeight, LONG DisplayWid
     _sharedViewBase((ULONG_PTR)SharedViewBase),
     _displayHeight(DisplayHeight),
     _displayWidth(DisplayWidth),
+    _dirtyRows(DisplayHeight > 0 ? static_cast<size_t>(DisplayHeight) : 0, true),
     _currentLegacyColorAttribute(DEFAULT_COLOR_ATTRIBUTE)
 {
     _runLength = sizeof(CD_IO_CHARACTER) * DisplayWidth;
@@ -33,33 +34,68 @@ BgfxEngine::BgfxEngine(PVOID SharedViewBase, LONG DisplayHeight, LONG DisplayWid
     _fontSize.Y = FontHeight > SHORT_MAX ? SHORT_MAX : (SHORT)FontHeight;
 }
 
-[[nodiscard]] HRESULT BgfxEngine::Invalidate(const SMALL_RECT* const /*psrRegion*/) noexcept
+// Routine Description:
+// - Marks the given rows as dirty, clamped to the display.
+// Arguments:
+// - top - the first row.
+// - bottom - the last row, inclusive.
+// Return Value:
+// - <none>
+void BgfxEngine::_InvalidateRows(const SHORT top, const SHORT bottom) noexcept
+{
+    const auto first = std::max<LONG>(top, 0);
+    const auto last = std::min<LONG>(bottom, _displayHeight - 1);
+    for (auto i = first; i <= last; i++)
+    {
+        _dirtyRows[static_cast<size_t>(i)] = true;
+    }
+}
+
+void BgfxEngine::_InvalidateAllRows() noexcept
 {
+    std::fill(_dirtyRows.begin(), _dirtyRows.end(), true);
+}
+
+[[nodiscard]] HRESULT BgfxEngine::Invalidate(const SMALL_RECT* const psrRegion) noexcept
+{
+    _InvalidateRows(psrRegion->Top, psrRegion->Bottom);
     return S_OK;
 }
 
-[[nodiscard]] HRESULT BgfxEngine::InvalidateCursor(const SMALL_RECT* const /*psrRegion*/) noexcept
+[[nodiscard]] HRESULT BgfxEngine::InvalidateCursor(const SMALL_RECT* const psrRegion) noexcept
 {
+    _InvalidateRows(psrRegion->Top, psrRegion->Bottom);
     return S_OK;
 }
 
 [[nodiscard]] HRESULT BgfxEngine::InvalidateSystem(const RECT* const /*prcDirtyClient*/) noexcept
 {
+    _InvalidateAllRows();
     return S_OK;
 }
 
-[[nodiscard]] HRESULT BgfxEngine::InvalidateSelection(const std::vector<SMALL_RECT>& /*rectangles*/) noexcept
+[[nodiscard]] HRESULT BgfxEngine::InvalidateSelection(const std::vector<SMALL_RECT>& rectangles) noexcept
 {
+    for (const auto& rect : rectangles)
+    {
+        _InvalidateRows(rect.Top, rect.Bottom);
+    }
     return S_OK;
 }
 
-[[nodiscard]] HRESULT BgfxEngine::InvalidateScroll(const COORD* const /*pcoordDelta*/) noexcept
+[[nodiscard]] HRESULT BgfxEngine::InvalidateScroll(const COORD* const pcoordDelta) noexcept
 {
+    // We don't scroll the frame (see ScrollFrame), so everything has to be repainted.
+    if (pcoordDelta->X != 0 || pcoordDelta->Y != 0)
+    {
+        _InvalidateAllRows();
+    }
     return S_OK;
 }
 
 [[nodiscard]] HRESULT BgfxEngine::InvalidateAll() noexcept
 {
+    _InvalidateAllRows();
     return S_OK;
 }
 
@@ -87,15 +123,29 @@ BgfxEngine::BgfxEngine(PVOID SharedViewBase, LONG DisplayHeight, LONG DisplayWid
     PVOID OldRunBase;
     PVOID NewRunBase;
 
+    // Nothing changed, so there's nothing to tell the display about.
+    if (std::find(_dirtyRows.begin(), _dirtyRows.end(), true) == _dirtyRows.end())
+    {
+        return S_OK;
+    }
+
     Status = ServiceLocator::LocateInputServices<ConIoSrvComm>()->RequestUpdateDisplay(0);
 
+    // Only the rows we painted can differ from what's on the display. If the
+    // update failed, they stay dirty and are copied with the next frame.
     if (NT_SUCCESS(Status))
     {
         for (SHORT i = 0; i < _displayHeight; i++)
         {
+            if (!_dirtyRows[i])
+            {
+                continue;
+            }
+
             OldRunBase = (PVOID)(_sharedViewBase + (i * 2 * _runLength));
             NewRunBase = (PVOID)(_sharedViewBase + (i * 2 * _runLength) + _runLength);
             memcpy_s(OldRunBase, _runLength, NewRunBase, _runLength);
+            _dirtyRows[i] = false;
         }
     }
 
@@ -129,6 +179,11 @@ BgfxEngine::BgfxEngine(PVOID SharedViewBase, LONG DisplayHeight, LONG DisplayWid
 
     for (SHORT i = 0; i < _displayHeight; i++)
     {
+        if (!_dirtyRows[i])
+        {
+            continue;
+        }
+
         OldRunBase = (PVOID)(_sharedViewBase + (i * 2 * _runLength));
         NewRunBase = (PVOID)(_sharedViewBase + (i * 2 * _runLength) + _runLength);
 
@@ -216,13 +271,14 @@ BgfxEngine::BgfxEngine(PVOID SharedViewBase, LONG DisplayHeight, LONG DisplayWid
 
 // Method Description:
 // - This method will update our internal reference for how big the viewport is.
-//      Does nothing for BGFX.
+//      BGFX only repaints the whole display, since what's in it moved.
 // Arguments:
 // - srNewViewport - The bounds of the new viewport.
 // Return Value:
 // - HRESULT S_OK
 [[nodiscard]] HRESULT BgfxEngine::UpdateViewport(const SMALL_RECT /*srNewViewport*/) noexcept
 {
+    _InvalidateAllRows();
     return S_OK;
 }
 
@@ -231,21 +287,44 @@ BgfxEngine::BgfxEngine(PVOID SharedViewBase, LONG DisplayHeight, LONG DisplayWid
     return S_OK;
 }
 
+// Method Description:
+// - Gets the full width rectangles of the runs of rows that were invalidated.
+// Arguments:
+// - area - receives the rectangles.
+// Return Value:
+// - S_OK or E_OUTOFMEMORY.
 [[nodiscard]] HRESULT BgfxEngine::GetDirtyArea(gsl::span<const til::rectangle>& area) noexcept
+try
 {
-    SMALL_RECT r;
-    r.Bottom = _displayHeight > 0 ? (SHORT)(_displayHeight - 1) : 0;
-    r.Top = 0;
-    r.Left = 0;
-    r.Right = _displayWidth > 0 ? (SHORT)(_displayWidth - 1) : 0;
+    _dirtyArea.clear();
+
+    SHORT i = 0;
+    while (i < _displayHeight)
+    {
+        if (!_dirtyRows[i])
+        {
+            i++;
+            continue;
+        }
 
-    _dirtyArea = r;
+        SMALL_RECT r;
+        r.Top = i;
+        while (i < _displayHeight && _dirtyRows[i])
+        {
+            i++;
+        }
+        r.Bottom = i - 1;
+        r.Left = 0;
+        r.Right = _displayWidth > 0 ? (SHORT)(_displayWidth - 1) : 0;
+
+        _dirtyArea.emplace_back(r);
+    }
 
-    area = { &_dirtyArea,
-             1 };
+    area = { _dirtyArea.data(), _dirtyArea.size() };
 
     return S_OK;
 }
+CATCH_RETURN()
 
 [[nodiscard]] HRESULT BgfxEngine::GetFontSize(_Out_ COORD* const pFontSize) noexcept
 {
@@ -81,7 +81,14 @@ namespace Microsoft::Console::Render
 
         LONG _displayHeight;
         LONG _displayWidth;
-        til::rectangle _dirtyArea;
+
+        // The rows that were invalidated since the last frame. Only those are
+        // painted, and copied over to the display, see EndPaint().
+        std::vector<bool> _dirtyRows;
+        std::vector<til::rectangle> _dirtyArea;
+
+        void _InvalidateRows(const SHORT top, const SHORT bottom) noexcept;
+        void _InvalidateAllRows() noexcept;
 
         COORD _fontSize;
 
@@ -354,9 +354,9 @@ class UiaTextRangeTests
         {
             ROW& row = _pTextBuffer->GetRowByOffset(i);
             auto& charRow = row.GetCharRow();
-            for (auto& cell : charRow)
+            for (size_t column = 0; column < charRow.size(); ++column)
             {
-                cell.Char() = L' ';
+                charRow.GlyphAt(column) = L" ";
             }
         }
 
@@ -1476,6 +1476,26 @@ class UiaTextRangeTests
         VERIFY_ARE_EQUAL(L"M", std::wstring_view{ text });
     }
 
+    TEST_METHOD(GetTextFollowsRowChanges)
+    {
+        // GetText caches the text of each row. Make sure that
+        // changes to the rows are picked up on the next call.
+        _pTextBuffer->Write({ L"Hello" }, origin);
+        _pTextBuffer->Write({ L"World" }, { 0, 1 });
+
+        Microsoft::WRL::ComPtr<UiaTextRange> utr;
+        THROW_IF_FAILED(Microsoft::WRL::MakeAndInitialize<UiaTextRange>(&utr, _pUiaData, &_dummyProvider, origin, COORD{ 5, 1 }));
+
+        BSTR text;
+        THROW_IF_FAILED(utr->GetText(-1, &text));
+        const auto lineFeedAndPadding = std::wstring(gsl::narrow_cast<size_t>(bufferSize.width()) - 5, L' ') + L"\r\n";
+        VERIFY_ARE_EQUAL(L"Hello" + lineFeedAndPadding + L"World", std::wstring_view{ text });
+
+        _pTextBuffer->Write({ L"Howdy" }, { 0, 1 });
+        THROW_IF_FAILED(utr->GetText(-1, &text));
+        VERIFY_ARE_EQUAL(L"Hello" + lineFeedAndPadding + L"Howdy", std::wstring_view{ text });
+    }
+
     TEST_METHOD(ScrollIntoView)
     {
         const auto viewportSize{ _pUiaData->GetViewport() };
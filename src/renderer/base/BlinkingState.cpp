@@ -51,7 +51,7 @@ bool BlinkingState::IsBlinkingFaint() const noexcept
 // Method Description:
 // - Increments the position in the blinking cycle, toggling the blinking
 //   rendition state on every second call, potentially triggering a redraw of
-//   the given render target if there are blinking cells currently in view.
+//   the blinking cells of the given render target if there are any in view.
 // Arguments:
 // - renderTarget: the render target that will be redrawn.
 // Return Value:
@@ -69,12 +69,13 @@ try
         _blinkingShouldBeFaint = _blinkingCycle >= 2;
         // Every two cycles (when the state changes), we need to trigger a
         // redraw, but only if there are actually blinking attributes in use.
+        // Only the blinking cells themselves need to be redrawn.
         if (_blinkingIsInUse && _blinkingCycle % 2 == 0)
         {
             // We reset the _blinkingIsInUse flag before redrawing, so we can
             // get a fresh assessment of the current blinking attribute usage.
             _blinkingIsInUse = false;
-            renderTarget.TriggerRedrawAll();
+            renderTarget.TriggerRedrawBlinking();
         }
     }
 }
@@ -22,8 +22,7 @@ namespace
     static constexpr DWORD DFF_256COLOR = 0x0040;
     static constexpr DWORD DFF_RGBCOLOR = 0x0080;
 
-    // DRCS soft fonts only require 96 characters at most.
-    static constexpr size_t CHAR_COUNT = 96;
+    static constexpr size_t CHAR_COUNT = SoftFontGlyphCache::CharCount;
 
 #pragma pack(push, 1)
     struct GLYPHENTRY
@@ -76,14 +75,10 @@ namespace
 #pragma pack(pop)
 }
 
-FontResource::FontResource(const gsl::span<const uint16_t> bitPattern,
-                           const til::size sourceSize,
-                           const til::size targetSize,
-                           const size_t centeringHint) :
-    _bitPattern{ bitPattern.begin(), bitPattern.end() },
-    _sourceSize{ sourceSize },
-    _targetSize{ targetSize },
-    _centeringHint{ centeringHint }
+FontResource::FontResource(std::shared_ptr<SoftFontGlyphCache> glyphCache,
+                           const til::size targetSize) :
+    _glyphCache{ std::move(glyphCache) },
+    _targetSize{ targetSize }
 {
 }
 
@@ -98,7 +93,7 @@ void FontResource::SetTargetSize(const til::size targetSize)
 
 FontResource::operator HFONT()
 {
-    if (!_fontHandle && !_bitPattern.empty())
+    if (!_fontHandle && _glyphCache)
     {
         _regenerateFont();
     }
@@ -109,7 +104,15 @@ void FontResource::_regenerateFont()
 {
     const auto targetWidth = _targetSize.width<WORD>();
     const auto targetHeight = _targetSize.height<WORD>();
-    const auto charSizeInBytes = (targetWidth + 7) / 8 * targetHeight;
+    const auto charSizeInBytes = gsl::narrow_cast<DWORD>(SoftFontGlyphCache::GlyphSizeInBytes(_targetSize));
+
+    // The glyphs are scaled by the shared cache, which only has to do so
+    // once for each target size, no matter how often the font is recreated.
+    const auto scaledGlyphs = _glyphCache->GetScaledGlyphs(_targetSize);
+    if (!scaledGlyphs)
+    {
+        return;
+    }
 
     const DWORD fontBitmapSize = charSizeInBytes * CHAR_COUNT;
     const DWORD fontResourceSize = sizeof(FONTINFO) + fontBitmapSize;
@@ -146,11 +149,9 @@ void FontResource::_regenerateFont()
         fontResource.dfCharTable[i].geWidth = targetWidth;
     }
 
-    // Raster fonts aren't generally scalable, so we need to resize the bit
-    // patterns for the character glyphs to the requested target size, and
-    // copy the results into the resource structure.
-    auto fontResourceSpan = gsl::span<byte>(fontResourceBuffer);
-    _resizeBitPattern(fontResourceSpan.subspan(fontResource.dfBitsOffset));
+    // Raster fonts aren't generally scalable, so we copy in the bit patterns
+    // of the character glyphs that the cache has resized to the target size.
+    std::copy(scaledGlyphs->begin(), scaledGlyphs->end(), std::next(fontResourceBuffer.begin(), fontResource.dfBitsOffset));
 
     DWORD fontCount = 0;
     _resourceHandle.reset(AddFontMemResourceEx(&fontResource, fontResourceSize, nullptr, &fontCount));
@@ -168,118 +169,3 @@ void FontResource::_regenerateFont()
     _fontHandle.reset(CreateFontIndirectA(&logFont));
     LOG_HR_IF_NULL(E_FAIL, _fontHandle.get());
 }
-
-void FontResource::_resizeBitPattern(gsl::span<byte> targetBuffer)
-{
-    auto sourceWidth = _sourceSize.width<int>();
-    auto targetWidth = _targetSize.width<int>();
-    const auto sourceHeight = _sourceSize.height<int>();
-    const auto targetHeight = _targetSize.height<int>();
-
-    // If the text in the font is not perfectly centered, the _centeringHint
-    // gives us the offset needed to correct that misalignment. So to ensure
-    // that any inserted or deleted columns are evenly spaced around the center
-    // point of the glyphs, we need to adjust the source and target widths by
-    // that amount (proportionally) before calculating the scaling increments.
-    targetWidth -= std::lround((double)_centeringHint * targetWidth / sourceWidth);
-    sourceWidth -= gsl::narrow_cast<int>(_centeringHint);
-
-    // The way the scaling works is by iterating over the target range, and
-    // calculating the source offsets that correspond to each target position.
-    // We achieve that by incrementing the source offset every iteration by an
-    // integer value that is the quotient of the source and target dimensions.
-    // Because this is an integer division, we're going to be off by a certain
-    // fraction on each iteration, so we need to keep track of that accumulated
-    // error using the modulus of the division. Once the error total exceeds
-    // the target dimension (more or less), we add another pixel to compensate
-    // for the error, and reset the error total.
-    const auto createIncrementFunction = [](const auto sourceDimension, const auto targetDimension) {
-        const auto increment = sourceDimension / targetDimension;
-        const auto errorIncrement = sourceDimension % targetDimension * 2;
-        const auto errorThreshold = targetDimension * 2 - std::min(sourceDimension, targetDimension);
-        const auto errorReset = targetDimension * 2;
-
-        return [=](auto& errorTotal) {
-            errorTotal += errorIncrement;
-            if (errorTotal > errorThreshold)
-            {
-                errorTotal -= errorReset;
-                return increment + 1;
-            }
-            return increment;
-        };
-    };
-    const auto columnIncrement = createIncrementFunction(sourceWidth, targetWidth);
-    const auto lineIncrement = createIncrementFunction(sourceHeight, targetHeight);
-
-    // Once we've calculated the scaling increments, taking the centering hint
-    // into account, we reset the target width back to its original value.
-    targetWidth = _targetSize.width<int>();
-
-    auto targetBufferPointer = targetBuffer.begin();
-    for (auto ch = 0; ch < CHAR_COUNT; ch++)
-    {
-        // Bits are read from the source from left to right - MSB to LSB. The source
-        // column is a single bit representing the 1-based position. The reason for
-        // this will become clear in the mask calculation below.
-        auto sourceColumn = 1 << 16;
-        auto sourceColumnError = 0;
-
-        // The target format expects the character bitmaps to be laid out in columns
-        // of 8 bits. So we generate 8 bits from each scanline until we've covered
-        // the full target height. Then we start again from the top with the next 8
-        // bits of the line, until we've covered the full target width.
-        for (auto targetX = 0; targetX < targetWidth; targetX += 8)
-        {
-            auto sourceLine = std::next(_bitPattern.begin(), ch * sourceHeight);
-            auto sourceLineError = 0;
-
-            // Since we're going to be reading from the same horizontal offset for each
-            // target line, we save the state here so we can reset it every iteration.
-            const auto initialSourceColumn = sourceColumn;
-            const auto initialSourceColumnError = sourceColumnError;
-
-            for (auto targetY = 0; targetY < targetHeight; targetY++)
-            {
-                sourceColumn = initialSourceColumn;
-                sourceColumnError = initialSourceColumnError;
-
-                // For a particular target line, we calculate the span of source lines from
-                // which it is derived, then OR those values together. We don't want the
-                // source value to be zero, though, so we must read at least one line.
-                const auto lineSpan = lineIncrement(sourceLineError);
-                auto sourceValue = 0;
-                for (auto i = 0; i < std::max(lineSpan, 1); i++)
-                {
-                    sourceValue |= sourceLine[i];
-                }
-                std::advance(sourceLine, lineSpan);
-
-                // From the combined value of the source lines, we now need to extract eight
-                // bits to make up the next byte in the target at the current X offset.
-                byte targetValue = 0;
-                for (auto targetBit = 0; targetBit < 8; targetBit++)
-                {
-                    targetValue <<= 1;
-                    if (targetX + targetBit < targetWidth)
-                    {
-                        // As with the line iteration, we first need to calculate the span of source
-                        // columns from which the target bit is derived. We shift our source column
-                        // position right by that amount to determine the next column position, then
-                        // subtract those two values to obtain a mask. For example, if we're reading
-                        // from columns 6 to 3 (exclusively), the initial column position is 1<<6,
-                        // the next column position is 1<<3, so the mask is 64-8=56, or 00111000.
-                        // Again we don't want this mask to be zero, so if the span is zero, we need
-                        // to shift an additional bit to make sure we cover at least one column.
-                        const auto columnSpan = columnIncrement(sourceColumnError);
-                        const auto nextSourceColumn = sourceColumn >> columnSpan;
-                        const auto sourceMask = sourceColumn - (nextSourceColumn >> (columnSpan ? 0 : 1));
-                        sourceColumn = nextSourceColumn;
-                        targetValue |= (sourceValue & sourceMask) ? 1 : 0;
-                    }
-                }
-                *(targetBufferPointer++) = targetValue;
-            }
-        }
-    }
-}
@@ -36,9 +36,7 @@ HRESULT RenderEngineBase::UpdateTitle(const std::wstring_view newTitle) noexcept
     return hr;
 }
 
-HRESULT RenderEngineBase::UpdateSoftFont(const gsl::span<const uint16_t> /*bitPattern*/,
-                                         const SIZE /*cellSize*/,
-                                         const size_t /*centeringHint*/) noexcept
+HRESULT RenderEngineBase::UpdateSoftFont(const std::shared_ptr<SoftFontGlyphCache>& /*glyphCache*/) noexcept
 {
     return S_FALSE;
 }
@@ -48,6 +46,16 @@ HRESULT RenderEngineBase::PrepareRenderInfo(const RenderFrameInfo& /*info*/) noe
     return S_FALSE;
 }
 
+// Method Description:
+// - By default, engines don't support inline images, and leave the cells the
+//   image covers as they are.
+HRESULT RenderEngineBase::PaintImageSlice(const InlineImage& /*image*/,
+                                          const size_t /*imageRow*/,
+                                          const COORD /*target*/) noexcept
+{
+    return S_FALSE;
+}
+
 HRESULT RenderEngineBase::ResetLineTransform() noexcept
 {
     return S_FALSE;
@@ -0,0 +1,183 @@
+// Copyright (c) Microsoft Corporation.
+// Licensed under the MIT license.
+
+#include "precomp.h"
+#include "../inc/SoftFontGlyphCache.hpp"
+
+using namespace Microsoft::Console::Render;
+
+SoftFontGlyphCache::SoftFontGlyphCache(const gsl::span<const uint16_t> bitPattern,
+                                       const til::size sourceSize,
+                                       const size_t centeringHint) :
+    _bitPattern{ bitPattern.begin(), bitPattern.end() },
+    _sourceSize{ sourceSize },
+    _centeringHint{ centeringHint }
+{
+}
+
+// Routine Description:
+// - Calculates the size of a single scaled glyph.
+// Arguments:
+// - targetSize - The cell size the glyph is scaled to.
+// Return Value:
+// - The number of bytes taken up by the glyph.
+size_t SoftFontGlyphCache::GlyphSizeInBytes(const til::size targetSize) noexcept
+{
+    return (targetSize.width<size_t>() + 7) / 8 * targetSize.height<size_t>();
+}
+
+// Routine Description:
+// - Returns the glyphs of the font scaled to the given cell size. They're
+//   only scaled on the first request for a particular size.
+// - The glyphs are laid out one after another, each of them in columns of
+//   8 bits from top to bottom, with the MSB as the leftmost pixel. That's the
+//   layout of a Windows raster font, but it's equally suitable for building
+//   a bitmap or atlas from.
+// Arguments:
+// - targetSize - The cell size the glyphs should be scaled to.
+// Return Value:
+// - The scaled glyphs, GlyphSizeInBytes(targetSize) bytes for each character.
+std::shared_ptr<const std::vector<byte>> SoftFontGlyphCache::GetScaledGlyphs(const til::size targetSize)
+{
+    if (targetSize.width() <= 0 || targetSize.height() <= 0 || _sourceSize.width() <= 0 || _sourceSize.height() <= 0)
+    {
+        return nullptr;
+    }
+
+    const std::lock_guard<std::mutex> guard{ _mutex };
+
+    const auto it = std::find_if(_scaledGlyphs.begin(), _scaledGlyphs.end(), [&](const auto& entry) {
+        return entry.first == targetSize;
+    });
+    if (it != _scaledGlyphs.end())
+    {
+        std::rotate(_scaledGlyphs.begin(), it, it + 1);
+        return _scaledGlyphs.front().second;
+    }
+
+    auto glyphs = std::make_shared<const std::vector<byte>>(_scaleBitPattern(targetSize));
+    if (_scaledGlyphs.size() >= MaxCachedSizes)
+    {
+        _scaledGlyphs.pop_back();
+    }
+    _scaledGlyphs.emplace(_scaledGlyphs.begin(), targetSize, glyphs);
+    return glyphs;
+}
+
+std::vector<byte> SoftFontGlyphCache::_scaleBitPattern(const til::size targetSize) const
+{
+    auto sourceWidth = _sourceSize.width<int>();
+    auto targetWidth = targetSize.width<int>();
+    const auto sourceHeight = _sourceSize.height<int>();
+    const auto targetHeight = targetSize.height<int>();
+
+    // If the text in the font is not perfectly centered, the _centeringHint
+    // gives us the offset needed to correct that misalignment. So to ensure
+    // that any inserted or deleted columns are evenly spaced around the center
+    // point of the glyphs, we need to adjust the source and target widths by
+    // that amount (proportionally) before calculating the scaling increments.
+    targetWidth -= std::lround((double)_centeringHint * targetWidth / sourceWidth);
+    sourceWidth -= gsl::narrow_cast<int>(_centeringHint);
+
+    // The way the scaling works is by iterating over the target range, and
+    // calculating the source offsets that correspond to each target position.
+    // We achieve that by incrementing the source offset every iteration by an
+    // integer value that is the quotient of the source and target dimensions.
+    // Because this is an integer division, we're going to be off by a certain
+    // fraction on each iteration, so we need to keep track of that accumulated
+    // error using the modulus of the division. Once the error total exceeds
+    // the target dimension (more or less), we add another pixel to compensate
+    // for the error, and reset the error total.
+    const auto createIncrementFunction = [](const auto sourceDimension, const auto targetDimension) {
+        const auto increment = sourceDimension / targetDimension;
+        const auto errorIncrement = sourceDimension % targetDimension * 2;
+        const auto errorThreshold = targetDimension * 2 - std::min(sourceDimension, targetDimension);
+        const auto errorReset = targetDimension * 2;
+
+        return [=](auto& errorTotal) {
+            errorTotal += errorIncrement;
+            if (errorTotal > errorThreshold)
+            {
+                errorTotal -= errorReset;
+                return increment + 1;
+            }
+            return increment;
+        };
+    };
+    const auto columnIncrement = createIncrementFunction(sourceWidth, targetWidth);
+    const auto lineIncrement = createIncrementFunction(sourceHeight, targetHeight);
+
+    // Once we've calculated the scaling increments, taking the centering hint
+    // into account, we reset the target width back to its original value.
+    targetWidth = targetSize.width<int>();
+
+    auto targetBuffer = std::vector<byte>(GlyphSizeInBytes(targetSize) * CharCount);
+    auto targetBufferPointer = targetBuffer.begin();
+    for (auto ch = 0; ch < CharCount; ch++)
+    {
+        // Bits are read from the source from left to right - MSB to LSB. The source
+        // column is a single bit representing the 1-based position. The reason for
+        // this will become clear in the mask calculation below.
+        auto sourceColumn = 1 << 16;
+        auto sourceColumnError = 0;
+
+        // The target format expects the character bitmaps to be laid out in columns
+        // of 8 bits. So we generate 8 bits from each scanline until we've covered
+        // the full target height. Then we start again from the top with the next 8
+        // bits of the line, until we've covered the full target width.
+        for (auto targetX = 0; targetX < targetWidth; targetX += 8)
+        {
+            auto sourceLine = std::next(_bitPattern.begin(), ch * sourceHeight);
+            auto sourceLineError = 0;
+
+            // Since we're going to be reading from the same horizontal offset for each
+            // target line, we save the state here so we can reset it every iteration.
+            const auto initialSourceColumn = sourceColumn;
+            const auto initialSourceColumnError = sourceColumnError;
+
+            for (auto targetY = 0; targetY < targetHeight; targetY++)
+            {
+                sourceColumn = initialSourceColumn;
+                sourceColumnError = initialSourceColumnError;
+
+                // For a particular target line, we calculate the span of source lines from
+                // which it is derived, then OR those values together. We don't want the
+                // source value to be zero, though, so we must read at least one line.
+                const auto lineSpan = lineIncrement(sourceLineError);
+                auto sourceValue = 0;
+                for (auto i = 0; i < std::max(lineSpan, 1); i++)
+                {
+                    sourceValue |= sourceLine[i];
+                }
+                std::advance(sourceLine, lineSpan);
+
+                // From the combined value of the source lines, we now need to extract eight
+                // bits to make up the next byte in the target at the current X offset.
+                byte targetValue = 0;
+                for (auto targetBit = 0; targetBit < 8; targetBit++)
+                {
+                    targetValue <<= 1;
+                    if (targetX + targetBit < targetWidth)
+                    {
+                        // As with the line iteration, we first need to calculate the span of source
+                        // columns from which the target bit is derived. We shift our source column
+                        // position right by that amount to determine the next column position, then
+                        // subtract those two values to obtain a mask. For example, if we're reading
+                        // from columns 6 to 3 (exclusively), the initial column position is 1<<6,
+                        // the next column position is 1<<3, so the mask is 64-8=56, or 00111000.
+                        // Again we don't want this mask to be zero, so if the span is zero, we need
+                        // to shift an additional bit to make sure we cover at least one column.
+                        const auto columnSpan = columnIncrement(sourceColumnError);
+                        const auto nextSourceColumn = sourceColumn >> columnSpan;
+                        const auto sourceMask = sourceColumn - (nextSourceColumn >> (columnSpan ? 0 : 1));
+                        sourceColumn = nextSourceColumn;
+                        targetValue |= (sourceValue & sourceMask) ? 1 : 0;
+                    }
+                }
+                *(targetBufferPointer++) = targetValue;
+            }
+        }
+    }
+
+    return targetBuffer;
+}
@@ -5,6 +5,10 @@
 
 #include "renderer.hpp"
 
+#include "../../types/inc/GlyphWidth.hpp"
+
+#include <til/atomic.h>
+
 #pragma hdrstop
 
 using namespace Microsoft::Console::Render;
@@ -12,9 +16,26 @@ using namespace Microsoft::Console::Types;
 
 using PointTree = interval_tree::IntervalTree<til::point, size_t>;
 
+std::atomic<size_t> Renderer::_tracelogCount{ 0 };
+#pragma warning(suppress : 26477) // We don't control tracelogging macros
+TRACELOGGING_DEFINE_PROVIDER(g_hRendererProvider,
+                             "Microsoft.Windows.Terminal.Renderer",
+                             // {93d62bf4-821d-5bbd-228b-7ec39d39e9ea}
+                             (0x93d62bf4, 0x821d, 0x5bbd, 0x22, 0x8b, 0x7e, 0xc3, 0x9d, 0x39, 0xe9, 0xea), );
+
+// Microseconds elapsed between two points in time, for the paint phase events.
+static uint64_t s_MicrosecondsBetween(const std::chrono::steady_clock::time_point begin,
+                                      const std::chrono::steady_clock::time_point end) noexcept
+{
+    return gsl::narrow_cast<uint64_t>(std::chrono::duration_cast<std::chrono::microseconds>(end - begin).count());
+}
+
 static constexpr auto maxRetriesForRenderEngine = 3;
 // The renderer will wait this number of milliseconds * how many tries have elapsed before trying again.
 static constexpr auto renderBackoffBaseTimeMilliseconds{ 150 };
+// Applications can't be trusted to always end a synchronized update, nor to end it quickly.
+// We won't hold off painting any longer than this.
+static constexpr std::chrono::milliseconds synchronizedOutputTimeout{ 100 };
 
 // Routine Description:
 // - Creates a new renderer controller for a console.
@@ -31,9 +52,14 @@ Renderer::Renderer(IRenderData* pData,
     _pData(THROW_HR_IF_NULL(E_INVALIDARG, pData)),
     _pThread{ std::move(thread) },
     _destructing{ false },
-    _clusterBuffer{},
     _viewport{ pData->GetViewport() }
 {
+    const auto was = _tracelogCount.fetch_add(1);
+    if (0 == was)
+    {
+        TraceLoggingRegister(g_hRendererProvider);
+    }
+
     for (size_t i = 0; i < cEngines; i++)
     {
         IRenderEngine* engine = rgpEngines[i];
@@ -52,6 +78,16 @@ Renderer::~Renderer()
 {
     _destructing = true;
     _pThread.reset();
+
+    // Make a background probe that's still running stop at its next batch and wait for it.
+    _glyphWidthGeneration.fetch_add(1);
+    _glyphWidthWork.reset();
+
+    const auto was = _tracelogCount.fetch_sub(1);
+    if (1 == was)
+    {
+        TraceLoggingUnregister(g_hRendererProvider);
+    }
 }
 
 // Routine Description:
@@ -67,60 +103,237 @@ Renderer::~Renderer()
         return S_FALSE;
     }
 
-    for (IRenderEngine* const pEngine : _rgpEngines)
+    // A frame may have been requested just before we got occluded.
+    if (_DeferPaintWhileOccluded())
     {
-        auto tries = maxRetriesForRenderEngine;
-        while (tries > 0)
+        return S_FALSE;
+    }
+
+    if (_occluded.load(std::memory_order_acquire))
+    {
+        _lastOccludedPaint.store(std::chrono::steady_clock::now(), std::memory_order_relaxed);
+    }
+
+    // Anything invalidated while we wait keeps accumulating in the engines,
+    // so the whole update ends up in the frame we paint afterwards.
+    _WaitForSynchronizedOutput();
+
+    auto tries = maxRetriesForRenderEngine;
+    while (tries > 0)
+    {
+        if (_destructing)
         {
-            if (_destructing)
-            {
-                return S_FALSE;
-            }
+            return S_FALSE;
+        }
 
-            const auto hr = _PaintFrameForEngine(pEngine);
-            if (E_PENDING == hr)
+        // Engines that painted successfully the first time around won't have
+        // anything left to paint when we retry, so this only really retries
+        // the engines that asked for it.
+        const auto hr = _PaintFrameForEngines();
+        if (E_PENDING == hr)
+        {
+            if (--tries == 0)
             {
-                if (--tries == 0)
+                // Stop trying.
+                _pThread->DisablePainting();
+                if (_pfnRendererEnteredErrorState)
                 {
-                    // Stop trying.
-                    _pThread->DisablePainting();
-                    if (_pfnRendererEnteredErrorState)
-                    {
-                        _pfnRendererEnteredErrorState();
-                    }
-                    // If there's no callback, we still don't want to FAIL_FAST: the renderer going black
-                    // isn't near as bad as the entire application aborting. We're a component. We shouldn't
-                    // abort applications that host us.
-                    return S_FALSE;
+                    _pfnRendererEnteredErrorState();
                 }
-                // Add a bit of backoff.
-                // Sleep 150ms, 300ms, 450ms before failing out and disabling the renderer.
-                Sleep(renderBackoffBaseTimeMilliseconds * (maxRetriesForRenderEngine - tries));
-                continue;
+                // If there's no callback, we still don't want to FAIL_FAST: the renderer going black
+                // isn't near as bad as the entire application aborting. We're a component. We shouldn't
+                // abort applications that host us.
+                return S_FALSE;
             }
-            LOG_IF_FAILED(hr);
-            break;
+            // Add a bit of backoff.
+            // Sleep 150ms, 300ms, 450ms before failing out and disabling the renderer.
+            Sleep(renderBackoffBaseTimeMilliseconds * (maxRetriesForRenderEngine - tries));
+            continue;
         }
+        LOG_IF_FAILED(hr);
+        break;
     }
 
     return S_OK;
 }
 
-[[nodiscard]] HRESULT Renderer::_PaintFrameForEngine(_In_ IRenderEngine* const pEngine) noexcept
+// Routine Description:
+// - Paints a frame for all of our engines while holding the console lock once,
+//   so that they can share the rows we prepare for them, and then presents
+//   them outside of the lock.
+// Arguments:
+// - <none>
+// Return Value:
+// - E_PENDING if any engine asked us to try again, otherwise S_OK.
+[[nodiscard]] HRESULT Renderer::_PaintFrameForEngines() noexcept
 try
 {
-    FAIL_FAST_IF_NULL(pEngine); // This is a programming error. Fail fast.
+    const auto lockStart = std::chrono::steady_clock::now();
+    _pData->LockConsole();
+    auto unlock = wil::scope_exit([&]() {
+        _pData->UnlockConsole();
+    });
+
+    // Everything that was written before we got the lock is part of this frame.
+    const auto frameStart = std::chrono::steady_clock::now();
+    _lockWaitMicroseconds.fetch_add(s_MicrosecondsBetween(lockStart, frameStart), std::memory_order_relaxed);
+
+    _ResetPreparedRows();
+
+    auto hr = S_OK;
+
+    _enginesToPresent.clear();
+    for (IRenderEngine* const pEngine : _rgpEngines)
+    {
+        const auto paintHr = _PaintFrameForEngine(pEngine);
+        if (S_OK == paintHr)
+        {
+            _enginesToPresent.push_back(pEngine);
+        }
+        else if (E_PENDING == paintHr)
+        {
+            hr = E_PENDING;
+        }
+        else
+        {
+            LOG_IF_FAILED(paintHr);
+        }
+    }
+
+    // Force scope exit unlock to let go of global lock so other threads can run
+    unlock.reset();
 
+    // Trigger out-of-lock presentation for renderers that can support it
+    for (IRenderEngine* const pEngine : _enginesToPresent)
+    {
+        const auto tracing = TraceLoggingProviderEnabled(g_hRendererProvider, WINEVENT_LEVEL_VERBOSE, TIL_KEYWORD_TRACE);
+        const auto presentStart = tracing ? std::chrono::steady_clock::now() : std::chrono::steady_clock::time_point{};
+
+        const auto presentHr = pEngine->Present();
+
+        if (tracing)
+        {
+#pragma warning(suppress : 26477 26485 26494 26482 26446 26447) // We don't control TraceLoggingWrite
+            TraceLoggingWrite(g_hRendererProvider,
+                              "Present",
+                              TraceLoggingPointer(pEngine, "engine"),
+                              TraceLoggingUInt64(s_MicrosecondsBetween(presentStart, std::chrono::steady_clock::now()), "durationUs"),
+                              TraceLoggingHResult(presentHr, "hr"),
+                              TraceLoggingLevel(WINEVENT_LEVEL_VERBOSE),
+                              TraceLoggingKeyword(TIL_KEYWORD_TRACE));
+        }
+
+        if (E_PENDING == presentHr)
+        {
+            hr = E_PENDING;
+        }
+        else
+        {
+            LOG_IF_FAILED(presentHr);
+        }
+    }
+
+    if (_pfnFramePresented && !_enginesToPresent.empty())
+    {
+        _pfnFramePresented(frameStart);
+    }
+
+    return hr;
+}
+CATCH_RETURN()
+
+// Routine Description:
+// - Paints and presents a frame for just the given engine, for when it asks
+//   for a paint outside of the render thread.
+// Arguments:
+// - pEngine - the engine to paint
+// Return Value:
+// - S_OK or an error from painting or presenting.
+[[nodiscard]] HRESULT Renderer::_PaintAndPresentFrameForEngine(_In_ IRenderEngine* const pEngine) noexcept
+try
+{
     _pData->LockConsole();
     auto unlock = wil::scope_exit([&]() {
         _pData->UnlockConsole();
     });
 
+    _ResetPreparedRows();
+
+    const auto hr = _PaintFrameForEngine(pEngine);
+
+    // Force scope exit unlock to let go of global lock so other threads can run
+    unlock.reset();
+
+    RETURN_IF_FAILED(hr);
+
+    // Trigger out-of-lock presentation for renderers that can support it
+    return S_OK == hr ? pEngine->Present() : S_OK;
+}
+CATCH_RETURN()
+
+// Routine Description:
+// - Throws away the rows we prepared for painting. They point to text that
+//   may have changed since we last held the console lock.
+// Arguments:
+// - <none>
+// Return Value:
+// - <none>
+void Renderer::_ResetPreparedRows() noexcept
+{
+    _preparedRows.clear();
+    _preparedRuns.clear();
+    _preparedClusters.clear();
+}
+
+// Routine Description:
+// - Paints a frame for the given engine. The console lock must be held.
+// Arguments:
+// - pEngine - the engine to paint
+// Return Value:
+// - S_OK if the engine painted a frame that now needs to be presented,
+//   S_FALSE if there was nothing to paint, or an error.
+[[nodiscard]] HRESULT Renderer::_PaintFrameForEngine(_In_ IRenderEngine* const pEngine) noexcept
+try
+{
+    FAIL_FAST_IF_NULL(pEngine); // This is a programming error. Fail fast.
+
+    // When someone's listening, we note down when each phase of the frame ends
+    // and report the durations in a single event once the frame is done.
+    enum class Phase : size_t
+    {
+        Invalidate,
+        StartPaint,
+        Prepare,
+        Background,
+        Text,
+        Overlays,
+        Selection,
+        Cursor,
+        Title,
+        EndPaint,
+        Count
+    };
+    const auto tracing = TraceLoggingProviderEnabled(g_hRendererProvider, WINEVENT_LEVEL_VERBOSE, TIL_KEYWORD_TRACE);
+    std::array<std::chrono::steady_clock::time_point, static_cast<size_t>(Phase::Count) + 1> phaseEnds{};
+    const auto endPhase = [&](const Phase phase) noexcept {
+        if (tracing)
+        {
+            til::at(phaseEnds, static_cast<size_t>(phase) + 1) = std::chrono::steady_clock::now();
+        }
+    };
+    if (tracing)
+    {
+        phaseEnds.front() = std::chrono::steady_clock::now();
+    }
+
     // Last chance check if anything scrolled without an explicit invalidate notification since the last frame.
     _CheckViewportAndScroll();
+    _FlushCursorInvalidation();
+    endPhase(Phase::Invalidate);
 
     // Try to start painting a frame
     HRESULT const hr = pEngine->StartPaint();
+    endPhase(Phase::StartPaint);
     RETURN_IF_FAILED(hr);
 
     // Return early if there's nothing to paint.
@@ -128,7 +341,7 @@ try
     //      engine won't know that.
     if (S_FALSE == hr)
     {
-        return S_OK;
+        return S_FALSE;
     }
 
     auto endPaint = wil::scope_exit([&]() {
@@ -137,7 +350,7 @@ try
         // If the engine tells us it really wants to redraw immediately,
         // tell the thread so it doesn't go to sleep and ticks again
         // at the next opportunity.
-        if (pEngine->RequiresContinuousRedraw())
+        if (pEngine->RequiresContinuousRedraw() && !_powerSaving.load(std::memory_order_relaxed))
         {
             _NotifyPaintFrame();
         }
@@ -151,41 +364,88 @@ try
 
     // C. Prepare the engine with additional information before we start drawing.
     RETURN_IF_FAILED(_PrepareRenderInfo(pEngine));
+    endPhase(Phase::Prepare);
+
+    // The engine knows what it is going to repaint once it started painting.
+    uint64_t dirtyCells = 0;
+    if (tracing)
+    {
+        gsl::span<const til::rectangle> dirtyAreas;
+        LOG_IF_FAILED(pEngine->GetDirtyArea(dirtyAreas));
+        for (const auto& rect : dirtyAreas)
+        {
+            dirtyCells += gsl::narrow_cast<uint64_t>(rect.size().area());
+        }
+    }
 
     // 1. Paint Background
     RETURN_IF_FAILED(_PaintBackground(pEngine));
+    endPhase(Phase::Background);
 
-    // 2. Paint Rows of Text
+    // 2. Paint Rows of Text (including their gridlines)
     _PaintBufferOutput(pEngine);
+    endPhase(Phase::Text);
 
     // 3. Paint overlays that reside above the text buffer
     _PaintOverlays(pEngine);
+    endPhase(Phase::Overlays);
 
     // 4. Paint Selection
     _PaintSelection(pEngine);
+    endPhase(Phase::Selection);
 
     // 5. Paint Cursor
     _PaintCursor(pEngine);
+    endPhase(Phase::Cursor);
 
     // 6. Paint window title
     RETURN_IF_FAILED(_PaintTitle(pEngine));
+    endPhase(Phase::Title);
 
     // Force scope exit end paint to finish up collecting information and possibly painting
     endPaint.reset();
+    endPhase(Phase::EndPaint);
 
-    // Force scope exit unlock to let go of global lock so other threads can run
-    unlock.reset();
-
-    // Trigger out-of-lock presentation for renderers that can support it
-    RETURN_IF_FAILED(pEngine->Present());
+    if (tracing)
+    {
+        const auto duration = [&](const Phase phase) noexcept {
+            const auto index = static_cast<size_t>(phase);
+            return s_MicrosecondsBetween(til::at(phaseEnds, index), til::at(phaseEnds, index + 1));
+        };
+
+#pragma warning(suppress : 26477 26485 26494 26482 26446 26447) // We don't control TraceLoggingWrite
+        TraceLoggingWrite(g_hRendererProvider,
+                          "PaintFrame",
+                          TraceLoggingPointer(pEngine, "engine"),
+                          TraceLoggingUInt64(dirtyCells, "dirtyCells"),
+                          TraceLoggingUInt64(duration(Phase::Invalidate), "invalidateUs"),
+                          TraceLoggingUInt64(duration(Phase::StartPaint), "startPaintUs"),
+                          TraceLoggingUInt64(duration(Phase::Prepare), "prepareUs"),
+                          TraceLoggingUInt64(duration(Phase::Background), "backgroundUs"),
+                          TraceLoggingUInt64(duration(Phase::Text), "textUs"),
+                          TraceLoggingUInt64(duration(Phase::Overlays), "overlaysUs"),
+                          TraceLoggingUInt64(duration(Phase::Selection), "selectionUs"),
+                          TraceLoggingUInt64(duration(Phase::Cursor), "cursorUs"),
+                          TraceLoggingUInt64(duration(Phase::Title), "titleUs"),
+                          TraceLoggingUInt64(duration(Phase::EndPaint), "endPaintUs"),
+                          TraceLoggingUInt64(s_MicrosecondsBetween(phaseEnds.front(), phaseEnds.back()), "totalUs"),
+                          TraceLoggingLevel(WINEVENT_LEVEL_VERBOSE),
+                          TraceLoggingKeyword(TIL_KEYWORD_TRACE));
+    }
 
-    // As we leave the scope, EndPaint will be called (declared above)
     return S_OK;
 }
 CATCH_RETURN()
 
 void Renderer::_NotifyPaintFrame()
 {
+    // Nobody can see us, so there's no point in waking up the render thread.
+    // Remember that we need to paint once we become visible again.
+    if (_DeferPaintWhileOccluded())
+    {
+        return;
+    }
+
     // If we're running in the unittests, we might not have a render thread.
     if (_pThread)
     {
@@ -217,7 +477,7 @@ void Renderer::TriggerSystemRedraw(const RECT* const prcDirtyClient)
 // - <none>
 void Renderer::TriggerRedraw(const Viewport& region)
 {
-    Viewport view = _viewport;
+    Viewport view = _GetOverscannedViewport(_viewport);
     SMALL_RECT srUpdateRegion = region.ToExclusive();
 
     // If the dirty region has double width lines, we need to double the size of
@@ -235,14 +495,46 @@ void Renderer::TriggerRedraw(const Viewport& region)
     if (view.TrimToViewport(&srUpdateRegion))
     {
         view.ConvertToOrigin(&srUpdateRegion);
-        std::for_each(_rgpEngines.begin(), _rgpEngines.end(), [&](IRenderEngine* const pEngine) {
-            LOG_IF_FAILED(pEngine->Invalidate(&srUpdateRegion));
-        });
+        if (!_invalidations.try_emplace(srUpdateRegion))
+        {
+            _invalidationsOverflowed.store(true, std::memory_order_relaxed);
+        }
 
         _NotifyPaintFrame();
     }
 }
 
+// Routine Description:
+// - Hands the regions queued up by TriggerRedraw() to the engines.
+// - The regions are relative to the viewport they were queued up in, so this must be called
+//   before the engines are told about a new viewport or a scroll. The console lock must be held.
+// Arguments:
+// - <none>
+// Return Value:
+// - <none>
+void Renderer::_FlushInvalidations()
+{
+    std::array<SMALL_RECT, 64> batch;
+    for (size_t count; (count = _invalidations.pop_n(batch.begin(), batch.size())) != 0;)
+    {
+        for (IRenderEngine* const pEngine : _rgpEngines)
+        {
+            for (size_t i = 0; i < count; ++i)
+            {
+                LOG_IF_FAILED(pEngine->Invalidate(&til::at(batch, i)));
+            }
+        }
+    }
+
+    if (_invalidationsOverflowed.exchange(false, std::memory_order_relaxed))
+    {
+        for (IRenderEngine* const pEngine : _rgpEngines)
+        {
+            LOG_IF_FAILED(pEngine->InvalidateAll());
+        }
+    }
+}
+
 // Routine Description:
 // - Called when a particular coordinate within the console buffer has changed.
 // Arguments:
@@ -255,27 +547,65 @@ void Renderer::TriggerRedraw(const COORD* const pcoord)
 }
 
 // Routine Description:
-// - Called when the cursor has moved in the buffer. Allows for RenderEngines to
+// - Called when the cursor has moved in the buffer or changed its appearance.
+// - Applications that move the cursor a lot can get here thousands of times
+//   between two frames, so we only note that the cursor changed. What has to
+//   be redrawn is worked out once per frame by _FlushCursorInvalidation().
+// Arguments:
+// - pcoord: The buffer-space position of the cursor.
+// Return Value:
+// - <none>
+void Renderer::TriggerRedrawCursor(const COORD* const /*pcoord*/)
+{
+    if (!_cursorInvalidated.exchange(true, std::memory_order_relaxed))
+    {
+        _NotifyPaintFrame();
+    }
+}
+
+// Routine Description:
+// - Invalidates the cells the cursor was last invalidated at and the ones it
+//   covers now, if it changed since the last frame. Allows for RenderEngines to
 //      differentiate between cursor movements and other invalidates.
 //   Visual Renderers (ex GDI) should invalidate the position, while the VT
 //      engine ignores this. See MSFT:14711161.
+// - The console lock must be held, and the viewport must be up to date.
 // Arguments:
-// - pcoord: The buffer-space position of the cursor.
+// - <none>
+// Return Value:
+// - <none>
+void Renderer::_FlushCursorInvalidation()
+{
+    if (!_cursorInvalidated.exchange(false, std::memory_order_relaxed))
+    {
+        return;
+    }
+
+    const auto position = _pData->GetCursorPosition();
+    const SHORT cursorWidth = _pData->IsCursorDoubleWidth() ? 2 : 1;
+    const SMALL_RECT cursorRect = { position.X, position.Y, position.X + cursorWidth - 1, position.Y };
+
+    _InvalidateCursorRect(std::exchange(_lastCursorRect, cursorRect));
+    _InvalidateCursorRect(cursorRect);
+}
+
+// Routine Description:
+// - Tells the engines about a region of the buffer that the cursor covers or used to cover.
+// Arguments:
+// - cursorRect: The buffer-space cells of the cursor, inclusive.
 // Return Value:
 // - <none>
-void Renderer::TriggerRedrawCursor(const COORD* const pcoord)
+void Renderer::_InvalidateCursorRect(const SMALL_RECT& cursorRect)
 {
     // We first need to make sure the cursor position is within the buffer,
     // otherwise testing for a double width character can throw an exception.
     const auto& buffer = _pData->GetTextBuffer();
-    if (buffer.GetSize().IsInBounds(*pcoord))
+    if (buffer.GetSize().IsInBounds(COORD{ cursorRect.Left, cursorRect.Top }))
     {
         // We then calculate the region covered by the cursor. This requires
         // converting the buffer coordinates to an equivalent range of screen
         // cells for the cursor, taking line rendition into account.
-        const LineRendition lineRendition = buffer.GetLineRendition(pcoord->Y);
-        const SHORT cursorWidth = _pData->IsCursorDoubleWidth() ? 2 : 1;
-        const SMALL_RECT cursorRect = { pcoord->X, pcoord->Y, pcoord->X + cursorWidth - 1, pcoord->Y };
+        const LineRendition lineRendition = buffer.GetLineRendition(cursorRect.Top);
         Viewport cursorView = Viewport::FromInclusive(BufferToScreenLine(cursorRect, lineRendition));
 
         // The region is clamped within the viewport boundaries and we only
@@ -290,8 +620,6 @@ void Renderer::TriggerRedrawCursor(const COORD* const pcoord)
             {
                 LOG_IF_FAILED(pEngine->InvalidateCursor(&updateRect));
             }
-
-            _NotifyPaintFrame();
         }
     }
 }
@@ -312,6 +640,29 @@ void Renderer::TriggerRedrawAll()
     _NotifyPaintFrame();
 }
 
+// Routine Description:
+// - Called when the blinking rendition has changed. Only the cells with blinking
+//   attributes need to be redrawn, which we recorded when we last painted them.
+// Arguments:
+// - <none>
+// Return Value:
+// - <none>
+void Renderer::TriggerRedrawBlinking()
+{
+    // Cells that were scrolled out of view will be painted
+    // (and recorded again) once they're scrolled back in.
+    const auto view = _GetOverscannedViewport(_viewport);
+    _blinkingCells.erase(std::remove_if(_blinkingCells.begin(), _blinkingCells.end(), [&](const auto& rect) {
+                             return rect.Top < view.Top() || rect.Top >= view.BottomExclusive();
+                         }),
+                         _blinkingCells.end());
+
+    for (const auto& rect : _blinkingCells)
+    {
+        TriggerRedraw(Viewport::FromExclusive(rect));
+    }
+}
+
 // Method Description:
 // - Called when the host is about to die, to give the renderer one last chance
 //      to paint before the host exits.
@@ -333,7 +684,7 @@ void Renderer::TriggerTeardown() noexcept
 
         if (SUCCEEDED(hr) && fEngineRequestsRepaint)
         {
-            LOG_IF_FAILED(_PaintFrameForEngine(pEngine));
+            LOG_IF_FAILED(_PaintAndPresentFrameForEngine(pEngine));
         }
     }
 }
@@ -349,7 +700,7 @@ void Renderer::TriggerSelection()
     try
     {
         // Get selection rectangles
-        const auto rects = _GetSelectionRects();
+        auto rects = _GetSelectionRects();
 
         // Restrict all previous selection rectangles to inside the current viewport bounds
         for (auto& sr : _previousSelection)
@@ -367,12 +718,17 @@ void Renderer::TriggerSelection()
             sr = Viewport::FromInclusive(rc).ToExclusive();
         }
 
-        std::for_each(_rgpEngines.begin(), _rgpEngines.end(), [&](IRenderEngine* const pEngine) {
-            LOG_IF_FAILED(pEngine->InvalidateSelection(_previousSelection));
-            LOG_IF_FAILED(pEngine->InvalidateSelection(rects));
-        });
+        // While dragging, the selection typically only grows or shrinks by a few
+        // cells per row, so we only invalidate the cells whose state changed.
+        s_GetSelectionDelta(_previousSelection, rects, _selectionDelta);
+        if (!_selectionDelta.empty())
+        {
+            std::for_each(_rgpEngines.begin(), _rgpEngines.end(), [&](IRenderEngine* const pEngine) {
+                LOG_IF_FAILED(pEngine->InvalidateSelection(_selectionDelta));
+            });
+        }
 
-        _previousSelection = rects;
+        _previousSelection = std::move(rects);
 
         _NotifyPaintFrame();
     }
@@ -387,6 +743,8 @@ void Renderer::TriggerSelection()
 // - True if something changed and we scrolled. False otherwise.
 bool Renderer::_CheckViewportAndScroll()
 {
+    _FlushInvalidations();
+
     SMALL_RECT const srOldViewport = _viewport.ToInclusive();
     SMALL_RECT const srNewViewport = _pData->GetViewport().ToInclusive();
 
@@ -404,8 +762,8 @@ bool Renderer::_CheckViewportAndScroll()
     // If we're keeping some buffers between calls, let them know about the viewport size
     // so they can prepare the buffers for changes to either preallocate memory at once
     // (instead of growing naturally) or shrink down to reduce usage as appropriate.
-    const size_t lineLength = gsl::narrow_cast<size_t>(til::rectangle{ srNewViewport }.width());
-    til::manage_vector(_clusterBuffer, lineLength, _shrinkThreshold);
+    const size_t cellCount = gsl::narrow_cast<size_t>(til::rectangle{ srNewViewport }.size().area());
+    til::manage_vector(_preparedClusters, cellCount, _shrinkThreshold);
 
     if (coordDelta.X != 0 || coordDelta.Y != 0)
     {
@@ -448,12 +806,21 @@ void Renderer::TriggerScroll()
 // - <none>
 void Renderer::TriggerScroll(const COORD* const pcoordDelta)
 {
+    _FlushInvalidations();
+
     std::for_each(_rgpEngines.begin(), _rgpEngines.end(), [&](IRenderEngine* const pEngine) {
         LOG_IF_FAILED(pEngine->InvalidateScroll(pcoordDelta));
     });
 
     _ScrollPreviousSelection(*pcoordDelta);
 
+    // The contents of the buffer moved, and the blinking cells with them.
+    for (auto& rect : _blinkingCells)
+    {
+        rect.Top += pcoordDelta->Y;
+        rect.Bottom += pcoordDelta->Y;
+    }
+
     _NotifyPaintFrame();
 }
 
@@ -466,6 +833,8 @@ void Renderer::TriggerScroll(const COORD* const pcoordDelta)
 // - <none>
 void Renderer::TriggerCircling()
 {
+    _FlushInvalidations();
+
     const auto rects = _GetSelectionRects();
 
     for (IRenderEngine* const pEngine : _rgpEngines)
@@ -478,7 +847,7 @@ void Renderer::TriggerCircling()
 
         if (SUCCEEDED(hr) && fEngineRequestsRepaint)
         {
-            LOG_IF_FAILED(_PaintFrameForEngine(pEngine));
+            LOG_IF_FAILED(_PaintAndPresentFrameForEngine(pEngine));
         }
     }
 }
@@ -527,6 +896,7 @@ void Renderer::TriggerFontChange(const int iDpi, const FontInfoDesired& FontInfo
         LOG_IF_FAILED(pEngine->UpdateFont(FontInfoDesired, FontInfo));
     });
 
+    _StartProbingGlyphWidths();
     _NotifyPaintFrame();
 }
 
@@ -547,9 +917,17 @@ void Renderer::UpdateSoftFont(const gsl::span<const uint16_t> bitPattern, const
     const auto softFontCharCount = cellSize.cy ? bitPattern.size() / cellSize.cy : 0;
     _lastSoftFontChar = _firstSoftFontChar + softFontCharCount - 1;
 
+    // The glyphs are scaled by a cache that's shared by all the engines, so
+    // they're only scaled once for every cell size that the engines ask for.
+    _softFontGlyphCache.reset();
+    if (softFontCharCount)
+    {
+        _softFontGlyphCache = std::make_shared<SoftFontGlyphCache>(bitPattern, til::size{ cellSize }, centeringHint);
+    }
+
     for (const auto pEngine : _rgpEngines)
     {
-        LOG_IF_FAILED(pEngine->UpdateSoftFont(bitPattern, cellSize, centeringHint));
+        LOG_IF_FAILED(pEngine->UpdateSoftFont(_softFontGlyphCache));
     }
     TriggerRedrawAll();
 }
@@ -608,6 +986,35 @@ bool Renderer::s_IsSoftFontChar(const std::wstring_view& v, const size_t firstSo
 // Return Value:
 // - True if the codepoint is full-width (two wide), false if it is half-width (one wide).
 bool Renderer::IsGlyphWideByFont(const std::wstring_view glyph)
+{
+    // Most ambiguous glyphs have been measured in the background already.
+    if (glyph.size() == 1)
+    {
+        const auto state = til::at(_glyphWidths, glyph.front()).load();
+        if (state != GlyphWidthState::Unknown)
+        {
+            return state == GlyphWidthState::Wide;
+        }
+    }
+
+    // Otherwise we measure it right away, and remember the result in case
+    // the background probe hasn't gotten to it yet or doesn't cover it.
+    const auto isWide = _ProbeGlyphWidth(glyph);
+    if (glyph.size() == 1)
+    {
+        til::at(_glyphWidths, glyph.front()).store(isWide ? GlyphWidthState::Wide : GlyphWidthState::Narrow);
+    }
+    return isWide;
+}
+
+// Routine Description:
+// - Asks the engines whether the glyph is full-width in the current font.
+//   This can be very slow, since the engines may have to lay out the glyph.
+// Arguments:
+// - glyph - the utf16 encoded codepoint to test
+// Return Value:
+// - True if the codepoint is full-width (two wide), false if it is half-width (one wide).
+bool Renderer::_ProbeGlyphWidth(const std::wstring_view glyph)
 {
     bool fIsFullWidth = false;
 
@@ -629,6 +1036,98 @@ bool Renderer::IsGlyphWideByFont(const std::wstring_view glyph)
     return fIsFullWidth;
 }
 
+// Routine Description:
+// - Forgets the glyph widths of the previous font and starts measuring the
+//   ambiguous glyphs in the current one in the background.
+// - Must be called with the console locked, just like the probing itself
+//   happens, so that no result can be stored in the table of a different font.
+// Arguments:
+// - <none>
+// Return Value:
+// - <none>
+void Renderer::_StartProbingGlyphWidths() noexcept
+{
+    // A probe that's still running notices the new generation and stops.
+    _glyphWidthGeneration.fetch_add(1);
+    for (auto& width : _glyphWidths)
+    {
+        width.store(GlyphWidthState::Unknown, std::memory_order_relaxed);
+    }
+
+    if (!_glyphWidthWork)
+    {
+        _glyphWidthWork.reset(CreateThreadpoolWork(&s_ProbeGlyphWidthsCallback, this, nullptr));
+        if (!_glyphWidthWork)
+        {
+            // Glyphs are still measured the moment they're written, only slower.
+            LOG_LAST_ERROR();
+            return;
+        }
+    }
+    SubmitThreadpoolWork(_glyphWidthWork.get());
+}
+
+// Routine Description:
+// - Measures all the ambiguous glyphs of the BMP in the current font. The console
+//   is only locked for small batches at a time, so writing text can go on
+//   in between and the writers will find more and more glyphs measured.
+// Arguments:
+// - <none>
+// Return Value:
+// - <none>
+void Renderer::_ProbeGlyphWidthsInBackground() noexcept
+try
+{
+    const auto generation = _glyphWidthGeneration.load();
+
+    size_t codepoint = 0;
+    while (codepoint < _glyphWidths.size())
+    {
+        _pData->LockConsole();
+        auto unlock = wil::scope_exit([&]() {
+            _pData->UnlockConsole();
+        });
+
+        // We hold the lock, so the font can't change under us until the batch is done.
+        if (_glyphWidthGeneration.load() != generation)
+        {
+            return;
+        }
+
+        for (size_t probed = 0; probed < _glyphWidthBatchSize && codepoint < _glyphWidths.size(); codepoint++)
+        {
+            const auto wch = gsl::narrow_cast<wchar_t>(codepoint);
+            auto& width = til::at(_glyphWidths, codepoint);
+            if (s_IsGlyphWidthProbeCandidate(wch) && width.load() == GlyphWidthState::Unknown)
+            {
+                width.store(_ProbeGlyphWidth({ &wch, 1 }) ? GlyphWidthState::Wide : GlyphWidthState::Narrow);
+                probed++;
+            }
+        }
+    }
+}
+CATCH_LOG()
+
+// Routine Description:
+// - Determines which glyphs are worth measuring ahead of time. Those are
+//   the ambiguous ones, except for surrogates, which aren't glyphs on their
+//   own, and the private use area, which is too large to be worth it.
+// Arguments:
+// - wch - the glyph to check
+// Return Value:
+// - True if the glyph should be measured by the background probe.
+bool Renderer::s_IsGlyphWidthProbeCandidate(const wchar_t wch) noexcept
+{
+    const auto isSurrogate = wch >= 0xD800 && wch <= 0xDFFF;
+    const auto isPrivateUse = wch >= 0xE000 && wch <= 0xF8FF;
+    return !isSurrogate && !isPrivateUse && IsGlyphWidthAmbiguous(wch);
+}
+
+void CALLBACK Renderer::s_ProbeGlyphWidthsCallback(PTP_CALLBACK_INSTANCE /*instance*/, PVOID context, PTP_WORK /*work*/) noexcept
+{
+    static_cast<Renderer*>(context)->_ProbeGlyphWidthsInBackground();
+}
+
 // Routine Description:
 // - Sets an event in the render thread that allows it to proceed, thus enabling painting.
 // Arguments:
@@ -653,6 +1152,165 @@ void Renderer::WaitForPaintCompletionAndDisable(const DWORD dwTimeoutMs)
     _pThread->WaitForPaintCompletionAndDisable(dwTimeoutMs);
 }
 
+// Routine Description:
+// - Returns the frame rate and frame drops our render thread has achieved,
+//   and how long we waited for the console lock, for diagnostics.
+// Arguments:
+// - <none>
+// Return Value:
+// - The render thread's frame statistics, or all zeroes if we don't have one.
+FrameStatistics Renderer::GetFrameStatistics() const noexcept
+{
+    auto statistics = _pThread ? _pThread->GetFrameStatistics() : FrameStatistics{};
+    statistics.lockWaitMicroseconds = _lockWaitMicroseconds.load(std::memory_order_relaxed);
+    return statistics;
+}
+
+// Routine Description:
+// - Sets how the OS should schedule our render thread.
+// Arguments:
+// - schedulingClass: the scheduling class of the render thread.
+// Return Value:
+// - <none>
+void Renderer::SetThreadSchedulingClass(const Microsoft::Console::Types::ThreadScheduling::Class schedulingClass) noexcept
+{
+    if (_pThread)
+    {
+        _pThread->SetSchedulingClass(schedulingClass);
+    }
+}
+
+// Routine Description:
+// - Begins a synchronized update (DECSET 2026). Until it ends, PaintFrame
+//   waits instead of painting a frame the application is still drawing.
+// Arguments:
+// - <none>
+// Return Value:
+// - <none>
+void Renderer::SynchronizedOutputBegin() noexcept
+{
+    _synchronizingOutput.store(true, std::memory_order_release);
+}
+
+// Routine Description:
+// - Ends a synchronized update and lets a waiting PaintFrame continue.
+// Arguments:
+// - <none>
+// Return Value:
+// - <none>
+void Renderer::SynchronizedOutputEnd() noexcept
+{
+    if (_synchronizingOutput.exchange(false, std::memory_order_acq_rel))
+    {
+        til::atomic_notify_all(_synchronizingOutput);
+    }
+}
+
+// Routine Description:
+// - Blocks the render thread while a synchronized update is in progress,
+//   but for no longer than synchronizedOutputTimeout. Must be called
+//   without holding the console lock, or the update could never end.
+// Arguments:
+// - <none>
+// Return Value:
+// - <none>
+void Renderer::_WaitForSynchronizedOutput() noexcept
+{
+    const auto start = std::chrono::steady_clock::now();
+    while (_synchronizingOutput.load(std::memory_order_acquire))
+    {
+        const auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start);
+        if (_destructing || elapsed >= synchronizedOutputTimeout)
+        {
+            // Paint what we've got. The application may begin another update and we'll wait again next frame.
+            _synchronizingOutput.store(false, std::memory_order_release);
+            break;
+        }
+        til::atomic_wait(_synchronizingOutput, true, gsl::narrow_cast<DWORD>((synchronizedOutputTimeout - elapsed).count()));
+    }
+}
+
+// Routine Description:
+// - Tells us whether the surface we're painting is visible at all, like when
+//   our control is in a background tab or its window is minimized.
+// - While occluded we don't paint. Invalidations still reach the engines and
+//   accumulate there, so that we can catch up with a single frame once we're
+//   visible again.
+// Arguments:
+// - occluded - true if nothing we paint could currently be seen.
+// Return Value:
+// - <none>
+void Renderer::SetOccluded(const bool occluded)
+{
+    _occluded.store(occluded, std::memory_order_release);
+
+    if (!occluded && _paintDeferred.exchange(false, std::memory_order_acq_rel))
+    {
+        _NotifyPaintFrame();
+    }
+}
+
+// Routine Description:
+// - Keeps us painting, at a low rate, while we're occluded. The frame we owe
+//   once we're visible again then only contains what changed since the last
+//   of those, and the swap chain doesn't go stale while nobody looks at it.
+//   This is for surfaces that need to be up to date the moment they're shown,
+//   like the ones in the quake window.
+// Arguments:
+// - interval - the least time between two frames while occluded, or zero to
+//   not paint at all while occluded.
+// Return Value:
+// - <none>
+void Renderer::SetOccludedPaintInterval(const std::chrono::milliseconds interval) noexcept
+{
+    _occludedPaintInterval.store(interval, std::memory_order_relaxed);
+}
+
+// Routine Description:
+// - Saves power, for instance while the device runs on battery:
+//   * frames are painted at most PowerSavingFrameInterval apart
+//   * engines that ask to be redrawn continuously (for their shader
+//     effects) are only redrawn when something changed
+//   * nothing is painted while we're occluded, even with an occluded paint interval
+// Arguments:
+// - powerSaving - whether to save power.
+// Return Value:
+// - <none>
+void Renderer::SetPowerSaving(const bool powerSaving) noexcept
+{
+    _powerSaving.store(powerSaving, std::memory_order_relaxed);
+    if (_pThread)
+    {
+        _pThread->SetMinimumFrameInterval(powerSaving ? PowerSavingFrameInterval : std::chrono::microseconds::zero());
+    }
+}
+
+// Routine Description:
+// - Checks whether we should skip painting right now, because we're occluded.
+//   If so, it remembers that we owe a frame once we're visible again.
+// - With an occluded paint interval set, a frame is let through whenever that
+//   interval passed since the last frame we painted while occluded.
+// Arguments:
+// - <none>
+// Return Value:
+// - true if painting should be skipped.
+bool Renderer::_DeferPaintWhileOccluded() noexcept
+{
+    if (!_occluded.load(std::memory_order_acquire))
+    {
+        return false;
+    }
+
+    const auto interval = _occludedPaintInterval.load(std::memory_order_relaxed);
+    if (interval.count() > 0 && !_powerSaving.load(std::memory_order_relaxed) && std::chrono::steady_clock::now() - _lastOccludedPaint.load(std::memory_order_relaxed) >= interval)
+    {
+        return false;
+    }
+
+    _paintDeferred.store(true, std::memory_order_release);
+    return true;
+}
+
 // Routine Description:
 // - Paint helper to fill in the background color of the invalid area within the frame.
 // Arguments:
@@ -676,8 +1334,8 @@ void Renderer::_PaintBufferOutput(_In_ IRenderEngine* const pEngine)
 {
     // This is the subsection of the entire screen buffer that is currently being presented.
     // It can move left/right or top/bottom depending on how the viewport is scrolled
-    // relative to the entire buffer.
-    const auto view = _pData->GetViewport();
+    // relative to the entire buffer. The engines may show a few overscan rows below it.
+    const auto view = _GetOverscannedViewport(_pData->GetViewport());
 
     // This is effectively the number of cells on the visible screen that need to be redrawn.
     // The origin is always 0, 0 because it represents the screen itself, not the underlying buffer.
@@ -727,9 +1385,6 @@ void Renderer::_PaintBufferOutput(_In_ IRenderEngine* const pEngine)
                 // of the backing buffer to fill in line 1 of the screen.
                 const auto screenPosition = bufferLine.Origin() - COORD{ 0, view.Top() };
 
-                // Retrieve the cell information iterator limited to just this line we want to redraw.
-                auto it = buffer.GetCellDataAt(bufferLine.Origin(), bufferLine);
-
                 // Calculate if two things are true:
                 // 1. this row wrapped
                 // 2. We're painting the last col of the row.
@@ -741,7 +1396,19 @@ void Renderer::_PaintBufferOutput(_In_ IRenderEngine* const pEngine)
                 LOG_IF_FAILED(pEngine->PrepareLineTransform(lineRendition, screenPosition.Y, view.Left()));
 
                 // Ask the helper to paint through this specific line.
-                _PaintBufferOutputHelper(pEngine, it, screenPosition, lineWrapped);
+                _PaintBufferOutputHelper(pEngine, buffer, bufferLine, screenPosition, lineWrapped);
+
+                // Paint the part of an inline image this line displays on top of its text.
+                // The image may have been evicted from the cache, in which case there's nothing to paint.
+                const auto& imageSlice = buffer.GetRowByOffset(bufferLine.Origin().Y).GetImageSlice();
+                if (imageSlice.imageId != 0)
+                {
+                    if (const auto image = buffer.GetImageCache().Get(imageSlice.imageId))
+                    {
+                        const COORD imageTarget{ imageSlice.column - view.Left(), screenPosition.Y };
+                        LOG_IF_FAILED(pEngine->PaintImageSlice(*image, imageSlice.imageRow, imageTarget));
+                    }
+                }
             }
         }
     }
@@ -753,26 +1420,60 @@ static bool _IsAllSpaces(const std::wstring_view v)
     return v.find_first_not_of(L" ") == decltype(v)::npos;
 }
 
-void Renderer::_PaintBufferOutputHelper(_In_ IRenderEngine* const pEngine,
-                                        TextBufferCellIterator it,
-                                        const COORD target,
-                                        const bool lineWrapped)
+// Routine Description:
+// - Splits one line of the buffer into runs of clusters that share their color,
+//   pattern ids and font, so that each run can be painted with a single call.
+// - A line is only split once per frame. If another engine needs to paint the
+//   same line, it gets the runs we already prepared for the first one.
+// Arguments:
+// - bufferLine - the buffer cells to split, exactly one row tall
+// - target - the screen position of the first cell of the line
+// Return Value:
+// - Where the runs of the line are in _preparedRuns. Like the runs themselves,
+//   that's only valid until we let go of the console lock.
+Renderer::PreparedRow Renderer::_PrepareRow(const TextBuffer& buffer, const Viewport& bufferLine, const COORD target)
 {
-    auto globalInvert{ _pData->IsScreenReversed() };
+    for (const auto& row : _preparedRows)
+    {
+        if (row.buffer == &buffer && row.origin == bufferLine.Origin() && row.width == bufferLine.Width() && row.target == target)
+        {
+            return row;
+        }
+    }
+
+    PreparedRow row{ &buffer, bufferLine.Origin(), bufferLine.Width(), target, _preparedRuns.size(), 0 };
+
+    const auto globalInvert{ _pData->IsScreenReversed() };
+
+    // Retrieve the cell information iterator limited to just this line.
+    auto it = buffer.GetCellDataAt(bufferLine.Origin(), bufferLine);
 
     // If we have valid data, let's figure out how to draw it.
     if (it)
     {
-        // TODO: MSFT: 20961091 -  This is a perf issue. Instead of rebuilding this and allocing memory to hold the reinterpretation,
-        // we should have an iterator/view adapter for the rendering.
-        // That would probably also eliminate the RenderData needing to give us the entire TextBuffer as well...
-        // Retrieve the iterator for one line of information.
+        // Clusters are views into the row's own text and _preparedClusters and the pattern
+        // boundaries are kept around between frames, so walking a line doesn't allocate.
         size_t cols = 0;
 
-        // Retrieve the first color.
+        // Retrieve the first color. Its id lets us compare it with
+        // the color of each cell without comparing all of its fields.
         auto color = it->TextAttr();
-        // Retrieve the first pattern id
-        auto patternIds = _pData->GetPatternId(target);
+        auto colorId = it.GetAttributeId();
+        // Runs are split wherever a pattern starts or ends. The boundaries are
+        // walked in lockstep with the cells, skipping the ones we start past.
+        // Overlays like the IME composition don't have any patterns.
+        auto& patternBoundaries = _patternBoundaries;
+        patternBoundaries.clear();
+        if (&buffer == &_pData->GetTextBuffer())
+        {
+            for (const auto& span : _pData->GetPatternSpans(target.Y))
+            {
+                patternBoundaries.push_back(span.start);
+                patternBoundaries.push_back(span.end);
+            }
+        }
+        std::sort(patternBoundaries.begin(), patternBoundaries.end());
+        auto nextPatternBoundary = std::upper_bound(patternBoundaries.begin(), patternBoundaries.end(), target.X);
         // Determine whether we're using a soft font.
         auto usingSoftFont = s_IsSoftFontChar(it->Chars(), _firstSoftFontChar, _lastSoftFontChar);
 
@@ -782,17 +1483,11 @@ void Renderer::_PaintBufferOutputHelper(_In_ IRenderEngine* const pEngine,
         // This outer loop will continue until we reach the end of the text we are trying to draw.
         while (it)
         {
-            // Hold onto the current run color right here for the length of the outer loop.
-            // We'll be changing the persistent one as we run through the inner loops to detect
-            // when a run changes, but we will still need to know this color at the bottom
-            // when we go to draw gridlines for the length of the run.
+            // Hold onto the current run color and font right here for the length of the outer loop.
+            // We'll be changing the persistent ones as we run through the inner loops to detect
+            // when a run changes, but we will still need to know them when we go to draw the run.
             const auto currentRunColor = color;
-
-            // Hold onto the current pattern id as well
-            const auto currentPatternId = patternIds;
-
-            // Update the drawing brushes with our color and font usage.
-            THROW_IF_FAILED(_UpdateDrawingBrushes(pEngine, currentRunColor, usingSoftFont, false));
+            const auto currentRunUsingSoftFont = usingSoftFont;
 
             // Advance the point by however many columns we've just outputted and reset the accumulator.
             screenPoint.X += gsl::narrow<SHORT>(cols);
@@ -803,8 +1498,8 @@ void Renderer::_PaintBufferOutputHelper(_In_ IRenderEngine* const pEngine,
             const auto currentRunItStart = it;
             const auto currentRunTargetStart = screenPoint;
 
-            // Ensure that our cluster vector is clear.
-            _clusterBuffer.clear();
+            // This run's clusters follow the ones of all runs before it.
+            const auto clusterOffset = _preparedClusters.size();
 
             // Reset our flag to know when we're in the special circumstance
             // of attempting to draw only the right-half of a two-column character
@@ -819,11 +1514,11 @@ void Renderer::_PaintBufferOutputHelper(_In_ IRenderEngine* const pEngine,
             // We also accumulate clusters according to regex patterns
             do
             {
-                COORD thisPoint{ screenPoint.X + gsl::narrow<SHORT>(cols), screenPoint.Y };
-                const auto thisPointPatterns = _pData->GetPatternId(thisPoint);
+                const auto thisPointX = gsl::narrow<SHORT>(screenPoint.X + cols);
                 const auto thisUsingSoftFont = s_IsSoftFontChar(it->Chars(), _firstSoftFontChar, _lastSoftFontChar);
-                const auto changedPatternOrFont = patternIds != thisPointPatterns || usingSoftFont != thisUsingSoftFont;
-                if (color != it->TextAttr() || changedPatternOrFont)
+                const auto changedPattern = nextPatternBoundary != patternBoundaries.end() && *nextPatternBoundary <= thisPointX;
+                const auto changedPatternOrFont = changedPattern || usingSoftFont != thisUsingSoftFont;
+                if (colorId != it.GetAttributeId() || changedPatternOrFont)
                 {
                     auto newAttr{ it->TextAttr() };
                     // foreground doesn't matter for runs of spaces (!)
@@ -831,7 +1526,8 @@ void Renderer::_PaintBufferOutputHelper(_In_ IRenderEngine* const pEngine,
                     if (!_IsAllSpaces(it->Chars()) || !newAttr.HasIdenticalVisualRepresentationForBlankSpace(color, globalInvert) || changedPatternOrFont)
                     {
                         color = newAttr;
-                        patternIds = thisPointPatterns;
+                        colorId = it.GetAttributeId();
+                        nextPatternBoundary = std::upper_bound(nextPatternBoundary, patternBoundaries.end(), thisPointX);
                         usingSoftFont = thisUsingSoftFont;
                         break; // vend this run
                     }
@@ -843,7 +1539,7 @@ void Renderer::_PaintBufferOutputHelper(_In_ IRenderEngine* const pEngine,
 
                 // If we're on the first cluster to be added and it's marked as "trailing"
                 // (a.k.a. the right half of a two column character), then we need some special handling.
-                if (_clusterBuffer.empty() && it->DbcsAttr().IsTrailing())
+                if (_preparedClusters.size() == clusterOffset && it->DbcsAttr().IsTrailing())
                 {
                     // Move left to the one so the whole character can be struck correctly.
                     --screenPoint.X;
@@ -851,13 +1547,13 @@ void Renderer::_PaintBufferOutputHelper(_In_ IRenderEngine* const pEngine,
                     trimLeft = true;
                     // And add one to the number of columns we expect it to take as we insert it.
                     columnCount = it->Columns() + 1;
-                    _clusterBuffer.emplace_back(it->Chars(), columnCount);
+                    _preparedClusters.emplace_back(it->Chars(), columnCount);
                 }
                 // Otherwise if it's not a special case, just insert it as is.
                 else
                 {
                     columnCount = it->Columns();
-                    _clusterBuffer.emplace_back(it->Chars(), columnCount);
+                    _preparedClusters.emplace_back(it->Chars(), columnCount);
                 }
 
                 if (columnCount > 1)
@@ -871,46 +1567,107 @@ void Renderer::_PaintBufferOutputHelper(_In_ IRenderEngine* const pEngine,
 
             } while (it);
 
-            // Do the painting.
-            THROW_IF_FAILED(pEngine->PaintBufferLine({ _clusterBuffer.data(), _clusterBuffer.size() }, screenPoint, trimLeft, lineWrapped));
+            _preparedRuns.push_back(PreparedRun{ currentRunItStart,
+                                                 currentRunColor,
+                                                 screenPoint,
+                                                 currentRunTargetStart,
+                                                 clusterOffset,
+                                                 _preparedClusters.size() - clusterOffset,
+                                                 cols,
+                                                 currentRunUsingSoftFont,
+                                                 trimLeft,
+                                                 containsWideCharacter });
+        }
+    }
+
+    row.runCount = _preparedRuns.size() - row.runOffset;
+    _preparedRows.push_back(row);
+    return row;
+}
+
+void Renderer::_PaintBufferOutputHelper(_In_ IRenderEngine* const pEngine,
+                                        const TextBuffer& buffer,
+                                        const Viewport& bufferLine,
+                                        const COORD target,
+                                        const bool lineWrapped)
+{
+    const auto row = _PrepareRow(buffer, bufferLine, target);
+
+    // Replace the blinking cells we recorded for this line with the ones it has now.
+    // Blinking cells of overlays aren't recorded, as they aren't part of the main buffer.
+    const auto isMainBuffer = &buffer == &_pData->GetTextBuffer();
+    if (isMainBuffer)
+    {
+        _ForgetBlinkingCells(bufferLine);
+    }
+
+    for (auto i = row.runOffset; i < row.runOffset + row.runCount; ++i)
+    {
+        const auto& run = til::at(_preparedRuns, i);
 
-            // If we're allowed to do grid drawing, draw that now too (since it will be coupled with the color data)
-            // We're only allowed to draw the grid lines under certain circumstances.
-            if (_pData->IsGridLineDrawingAllowed())
+        if (isMainBuffer && run.color.IsBlinking())
+        {
+            // The target of this line is at the same column as its buffer cells.
+            const auto left = run.itStartTarget.X;
+            _blinkingCells.push_back(SMALL_RECT{ left, bufferLine.Top(), gsl::narrow_cast<SHORT>(left + run.cols), bufferLine.BottomExclusive() });
+        }
+
+        // Update the drawing brushes with our color and font usage.
+        THROW_IF_FAILED(_UpdateDrawingBrushes(pEngine, run.color, run.usingSoftFont, false));
+
+        // Do the painting.
+        THROW_IF_FAILED(pEngine->PaintBufferLine({ _preparedClusters.data() + run.clusterOffset, run.clusterCount }, run.target, run.trimLeft, lineWrapped));
+
+        // If we're allowed to do grid drawing, draw that now too (since it will be coupled with the color data)
+        // We're only allowed to draw the grid lines under certain circumstances.
+        if (_pData->IsGridLineDrawingAllowed())
+        {
+            // See GH: 803
+            // If we found a wide character while we looped above, it's possible we skipped over the right half
+            // attribute that could have contained different line information than the left half.
+            if (run.containsWideCharacter)
             {
-                // See GH: 803
-                // If we found a wide character while we looped above, it's possible we skipped over the right half
-                // attribute that could have contained different line information than the left half.
-                if (containsWideCharacter)
-                {
-                    // Start from the original position in this run.
-                    auto lineIt = currentRunItStart;
-                    // Start from the original target in this run.
-                    auto lineTarget = currentRunTargetStart;
-
-                    // We need to go through the iterators again to ensure we get the lines associated with each
-                    // exact column. The code above will condense two-column characters into one, but it is possible
-                    // (like with the IME) that the line drawing characters will vary from the left to right half
-                    // of a wider character.
-                    // We could theoretically pre-pass for this in the loop above to be more efficient about walking
-                    // the iterator, but I fear it would make the code even more confusing than it already is.
-                    // Do that in the future if some WPR trace points you to this spot as super bad.
-                    for (auto colsPainted = 0u; colsPainted < cols; ++colsPainted, ++lineIt, ++lineTarget.X)
-                    {
-                        auto lines = lineIt->TextAttr();
-                        _PaintBufferOutputGridLineHelper(pEngine, lines, 1, lineTarget);
-                    }
-                }
-                else
+                // Start from the original position in this run.
+                auto lineIt = run.itStart;
+                // Start from the original target in this run.
+                auto lineTarget = run.itStartTarget;
+
+                // We need to go through the iterators again to ensure we get the lines associated with each
+                // exact column. The code above will condense two-column characters into one, but it is possible
+                // (like with the IME) that the line drawing characters will vary from the left to right half
+                // of a wider character.
+                // We could theoretically pre-pass for this in the loop above to be more efficient about walking
+                // the iterator, but I fear it would make the code even more confusing than it already is.
+                // Do that in the future if some WPR trace points you to this spot as super bad.
+                for (auto colsPainted = 0u; colsPainted < run.cols; ++colsPainted, ++lineIt, ++lineTarget.X)
                 {
-                    // If nothing exciting is going on, draw the lines in bulk.
-                    _PaintBufferOutputGridLineHelper(pEngine, currentRunColor, cols, screenPoint);
+                    auto lines = lineIt->TextAttr();
+                    _PaintBufferOutputGridLineHelper(pEngine, lines, 1, lineTarget);
                 }
             }
+            else
+            {
+                // If nothing exciting is going on, draw the lines in bulk.
+                _PaintBufferOutputGridLineHelper(pEngine, run.color, run.cols, run.target);
+            }
         }
     }
 }
 
+// Routine Description:
+// - Forgets the blinking cells recorded for the part of the line that's about to be painted.
+// Arguments:
+// - bufferLine - the buffer cells of a single line
+// Return Value:
+// - <none>
+void Renderer::_ForgetBlinkingCells(const Viewport& bufferLine) noexcept
+{
+    _blinkingCells.erase(std::remove_if(_blinkingCells.begin(), _blinkingCells.end(), [&](const auto& rect) {
+                             return rect.Top == bufferLine.Top() && rect.Left >= bufferLine.Left() && rect.Right <= bufferLine.RightExclusive();
+                         }),
+                         _blinkingCells.end());
+}
+
 // Method Description:
 // - Generates a IRenderEngine::GridLines structure from the values in the
 //      provided textAttribute
@@ -992,7 +1749,8 @@ void Renderer::_PaintBufferOutputGridLineHelper(_In_ IRenderEngine* const pEngin
         if (_hoveredInterval->start <= coordTargetTil &&
             coordTargetTil <= _hoveredInterval->stop)
         {
-            if (_pData->GetPatternId(coordTarget).size() > 0)
+            const auto spans = _pData->GetPatternSpans(coordTarget.Y);
+            if (std::any_of(spans.begin(), spans.end(), [&](const auto& span) { return span.start <= coordTarget.X && coordTarget.X < span.end; }))
             {
                 lines |= IRenderEngine::GridLines::Underline;
             }
@@ -1151,9 +1909,10 @@ void Renderer::_PaintOverlay(IRenderEngine& engine,
                     const COORD target{ viewDirty.Left(), iRow };
                     const auto source = target - overlay.origin;
 
-                    auto it = overlay.buffer.GetCellLineDataAt(source);
+                    // Paint from the source column to the end of the overlay's line.
+                    const auto sourceLine = Viewport::FromDimensions(source, gsl::narrow<SHORT>(overlay.buffer.GetSize().Width() - source.X), 1);
 
-                    _PaintBufferOutputHelper(&engine, it, target, false);
+                    _PaintBufferOutputHelper(&engine, overlay.buffer, sourceLine, target, false);
                 }
             }
         }
@@ -1283,6 +2042,65 @@ std::vector<SMALL_RECT> Renderer::_GetSelectionRects() const
     return result;
 }
 
+// Routine Description:
+// - Determines the cells that changed their selection state between two
+//   selections, each of which has at most one rectangle per row.
+// Arguments:
+// - previous - The rectangles that were selected before, ordered by row.
+// - current - The rectangles that are selected now, ordered by row.
+// - delta - Receives the rectangles that need to be redrawn.
+// Return Value:
+// - <none>
+void Renderer::s_GetSelectionDelta(const std::vector<SMALL_RECT>& previous,
+                                   const std::vector<SMALL_RECT>& current,
+                                   std::vector<SMALL_RECT>& delta)
+{
+    delta.clear();
+
+    const auto append = [&](const SMALL_RECT& rect, const SHORT left, const SHORT right) {
+        if (left < right && rect.Top < rect.Bottom)
+        {
+            delta.push_back({ left, rect.Top, right, rect.Bottom });
+        }
+    };
+
+    auto prev = previous.begin();
+    auto curr = current.begin();
+    while (prev != previous.end() || curr != current.end())
+    {
+        if (curr == current.end() || (prev != previous.end() && prev->Top < curr->Top))
+        {
+            // This row isn't selected anymore.
+            append(*prev, prev->Left, prev->Right);
+            ++prev;
+        }
+        else if (prev == previous.end() || curr->Top < prev->Top)
+        {
+            // This row wasn't selected before.
+            append(*curr, curr->Left, curr->Right);
+            ++curr;
+        }
+        else
+        {
+            // The row is selected in both, so only the cells between their
+            // left and right edges change, unless the spans don't overlap.
+            const auto overlapping = prev->Bottom == curr->Bottom && prev->Left < curr->Right && curr->Left < prev->Right;
+            if (overlapping)
+            {
+                append(*curr, std::min(prev->Left, curr->Left), std::max(prev->Left, curr->Left));
+                append(*curr, std::min(prev->Right, curr->Right), std::max(prev->Right, curr->Right));
+            }
+            else if (*prev != *curr)
+            {
+                append(*prev, prev->Left, prev->Right);
+                append(*curr, curr->Left, curr->Right);
+            }
+            ++prev;
+            ++curr;
+        }
+    }
+}
+
 // Method Description:
 // - Offsets all of the selection rectangles we might be holding onto
 //   as the previously selected area. If the whole viewport scrolls,
@@ -1323,6 +2141,13 @@ void Renderer::AddRenderEngine(_In_ IRenderEngine* const pEngine)
 {
     THROW_HR_IF_NULL(E_INVALIDARG, pEngine);
     _rgpEngines.push_back(pEngine);
+
+    // An engine that's attached later (e.g. the VT engine for conpty) is
+    // handed the soft font that's already active, and its scaled glyphs.
+    if (_softFontGlyphCache)
+    {
+        LOG_IF_FAILED(pEngine->UpdateSoftFont(_softFontGlyphCache));
+    }
 }
 
 // Method Description:
@@ -1337,6 +2162,52 @@ void Renderer::SetRendererEnteredErrorStateCallback(std::function<void()> pfn)
     _pfnRendererEnteredErrorState = std::move(pfn);
 }
 
+// Method Description:
+// - Registers a callback that will be called after the render thread presented a frame.
+//   It receives the time the frame started painting, with the console locked.
+//   It must be registered before painting is enabled.
+// Arguments:
+// - pfn: the callback
+// Return Value:
+// - <none>
+void Renderer::SetFramePresentedCallback(std::function<void(std::chrono::steady_clock::time_point)> pfn)
+{
+    _pfnFramePresented = std::move(pfn);
+}
+
+// Method Description:
+// - Sets the number of rows below the viewport that are painted along with it.
+//   This is for engines that are sized taller than the viewport, so that they
+//   can be scrolled by a fraction of a row without showing a gap at the bottom.
+// Arguments:
+// - rows: the number of rows to paint below the viewport
+// Return Value:
+// - <none>
+void Renderer::SetOverscanRows(const SHORT rows) noexcept
+{
+    _overscanRows.store(rows, std::memory_order_relaxed);
+}
+
+// Routine Description:
+// - Extends the given viewport by the overscan rows, as far as the buffer goes.
+// Arguments:
+// - view: the viewport to extend
+// Return Value:
+// - The rows of the buffer that the engines display.
+Viewport Renderer::_GetOverscannedViewport(const Viewport& view) const
+{
+    const auto rows = _overscanRows.load(std::memory_order_relaxed);
+    if (rows <= 0)
+    {
+        return view;
+    }
+
+    const auto bufferHeight = _pData->GetTextBuffer().GetSize().Height();
+    const auto bottom = std::min<int>(view.BottomExclusive() + rows, bufferHeight);
+    const auto height = gsl::narrow_cast<SHORT>(std::max<int>(view.Height(), bottom - view.Top()));
+    return Viewport::FromDimensions(view.Origin(), view.Width(), height);
+}
+
 // Method Description:
 // - Attempts to restart the renderer.
 void Renderer::ResetErrorStateAndResume()
@@ -25,11 +25,18 @@ Author(s):
 #include "../../buffer/out/textBuffer.hpp"
 #include "../../buffer/out/CharRow.hpp"
 
+#include <TraceLoggingProvider.h>
+
+TRACELOGGING_DECLARE_PROVIDER(g_hRendererProvider);
+
 namespace Microsoft::Console::Render
 {
     class Renderer sealed : public IRenderer
     {
     public:
+        // About 30 frames per second.
+        static constexpr std::chrono::microseconds PowerSavingFrameInterval{ 33'333 };
+
         Renderer(IRenderData* pData,
                  _In_reads_(cEngines) IRenderEngine** const pEngine,
                  const size_t cEngines,
@@ -52,6 +59,7 @@ namespace Microsoft::Console::Render
         void TriggerRedraw(const COORD* const pcoord) override;
         void TriggerRedrawCursor(const COORD* const pcoord) override;
         void TriggerRedrawAll() override;
+        void TriggerRedrawBlinking() override;
         void TriggerTeardown() noexcept override;
 
         void TriggerSelection() override;
@@ -79,14 +87,28 @@ namespace Microsoft::Console::Render
         void WaitForPaintCompletionAndDisable(const DWORD dwTimeoutMs) override;
         void WaitUntilCanRender() override;
 
+        void SynchronizedOutputBegin() noexcept override;
+        void SynchronizedOutputEnd() noexcept override;
+
+        FrameStatistics GetFrameStatistics() const noexcept;
+        void SetThreadSchedulingClass(const Microsoft::Console::Types::ThreadScheduling::Class schedulingClass) noexcept;
+
+        void SetOccluded(const bool occluded);
+        void SetOccludedPaintInterval(const std::chrono::milliseconds interval) noexcept;
+        void SetPowerSaving(const bool powerSaving) noexcept;
+
         void AddRenderEngine(_In_ IRenderEngine* const pEngine) override;
 
         void SetRendererEnteredErrorStateCallback(std::function<void()> pfn);
+        void SetFramePresentedCallback(std::function<void(std::chrono::steady_clock::time_point)> pfn);
+        void SetOverscanRows(const SHORT rows) noexcept;
         void ResetErrorStateAndResume();
 
         void UpdateLastHoveredInterval(const std::optional<interval_tree::IntervalTree<til::point, size_t>::interval>& newInterval);
 
     private:
+        static std::atomic<size_t> _tracelogCount;
+
         std::deque<IRenderEngine*> _rgpEngines;
 
         IRenderData* _pData; // Non-ownership pointer
@@ -94,20 +116,113 @@ namespace Microsoft::Console::Render
         std::unique_ptr<IRenderThread> _pThread;
         bool _destructing = false;
 
+        // While occluded, invalidation keeps accumulating in the engines, but
+        // we don't paint. _paintDeferred remembers that we owe a frame.
+        std::atomic<bool> _occluded{ false };
+        std::atomic<bool> _paintDeferred{ false };
+        // If non-zero, we still paint at most once per interval while occluded.
+        std::atomic<std::chrono::milliseconds> _occludedPaintInterval{};
+        std::atomic<std::chrono::steady_clock::time_point> _lastOccludedPaint{};
+        // While saving power, we paint at a lower frame rate, only when something
+        // changed, and not at all while occluded.
+        std::atomic<bool> _powerSaving{ false };
+
+        // The total time _PaintFrameForEngines waited for the console lock.
+        std::atomic<uint64_t> _lockWaitMicroseconds{ 0 };
+
+        // While an application is in the middle of a synchronized update (DECSET 2026)
+        // we hold off painting, but never longer than _WaitForSynchronizedOutput() allows.
+        std::atomic<bool> _synchronizingOutput{ false };
+
         std::optional<interval_tree::IntervalTree<til::point, size_t>::interval> _hoveredInterval;
 
-        void _NotifyPaintFrame();
+        // Regions passed to TriggerRedraw() are queued up and handed to the engines in
+        // batches by _FlushInvalidations(), right before anything that depends on their
+        // order relative to other invalidations (scrolling, viewport changes) and painting.
+        // If the queue ever runs full, we just invalidate everything on the next flush.
+        til::mpsc::queue<SMALL_RECT> _invalidations{ 1024 };
+        std::atomic<bool> _invalidationsOverflowed{ false };
+
+        // Set by TriggerRedrawCursor() and resolved once per frame by _FlushCursorInvalidation().
+        // _lastCursorRect holds the buffer cells the cursor was last invalidated at, so
+        // that it can be erased from there once it moved. It starts out at the origin.
+        std::atomic<bool> _cursorInvalidated{ false };
+        SMALL_RECT _lastCursorRect{};
+
+        // Engines may be sized a few rows taller than the viewport, so that they can
+        // show what's below it while they're scrolled by a fraction of a row.
+        std::atomic<SHORT> _overscanRows{ 0 };
+
+        // The widths of the ambiguous glyphs in the BMP when drawn in the current font.
+        // They're probed by a threadpool work item whenever the font changes, so that
+        // writing text rarely has to wait for an engine to measure a glyph.
+        enum class GlyphWidthState : uint8_t
+        {
+            Unknown,
+            Narrow,
+            Wide
+        };
+        static constexpr size_t _glyphWidthBatchSize = 32;
+        std::array<std::atomic<GlyphWidthState>, 0x10000> _glyphWidths{};
+        std::atomic<uint32_t> _glyphWidthGeneration{ 0 };
+        wil::unique_threadpool_work _glyphWidthWork;
+
+        bool _ProbeGlyphWidth(const std::wstring_view glyph);
+        void _StartProbingGlyphWidths() noexcept;
+        void _ProbeGlyphWidthsInBackground() noexcept;
+        static bool s_IsGlyphWidthProbeCandidate(const wchar_t wch) noexcept;
+        static void CALLBACK s_ProbeGlyphWidthsCallback(PTP_CALLBACK_INSTANCE instance, PVOID context, PTP_WORK work) noexcept;
 
+        void _NotifyPaintFrame();
+        bool _DeferPaintWhileOccluded() noexcept;
+        void _WaitForSynchronizedOutput() noexcept;
+        void _FlushInvalidations();
+        void _FlushCursorInvalidation();
+        void _InvalidateCursorRect(const SMALL_RECT& cursorRect);
+
+        [[nodiscard]] HRESULT _PaintFrameForEngines() noexcept;
+        [[nodiscard]] HRESULT _PaintAndPresentFrameForEngine(_In_ IRenderEngine* const pEngine) noexcept;
+        void _ResetPreparedRows() noexcept;
         [[nodiscard]] HRESULT _PaintFrameForEngine(_In_ IRenderEngine* const pEngine) noexcept;
 
         bool _CheckViewportAndScroll();
+        Microsoft::Console::Types::Viewport _GetOverscannedViewport(const Microsoft::Console::Types::Viewport& view) const;
 
         [[nodiscard]] HRESULT _PaintBackground(_In_ IRenderEngine* const pEngine);
 
         void _PaintBufferOutput(_In_ IRenderEngine* const pEngine);
 
+        // A run of clusters that can be painted with a single PaintBufferLine call.
+        struct PreparedRun
+        {
+            TextBufferCellIterator itStart;
+            TextAttribute color;
+            COORD target; // where the clusters are painted
+            COORD itStartTarget; // where itStart is, which trimLeft moves target away from
+            size_t clusterOffset;
+            size_t clusterCount;
+            size_t cols;
+            bool usingSoftFont;
+            bool trimLeft;
+            bool containsWideCharacter;
+        };
+
+        // A line of the buffer, split into _preparedRuns.
+        struct PreparedRow
+        {
+            const TextBuffer* buffer;
+            COORD origin;
+            SHORT width;
+            COORD target;
+            size_t runOffset;
+            size_t runCount;
+        };
+
+        PreparedRow _PrepareRow(const TextBuffer& buffer, const Microsoft::Console::Types::Viewport& bufferLine, const COORD target);
+
         void _PaintBufferOutputHelper(_In_ IRenderEngine* const pEngine,
-                                      TextBufferCellIterator it,
+                                      const TextBuffer& buffer,
+                                      const Microsoft::Console::Types::Viewport& bufferLine,
                                       const COORD target,
                                       const bool lineWrapped);
 
@@ -134,11 +249,29 @@ namespace Microsoft::Console::Render
         Microsoft::Console::Types::Viewport _viewport;
 
         static constexpr float _shrinkThreshold = 0.8f;
-        std::vector<Cluster> _clusterBuffer;
+        // The columns of the row being prepared at which a pattern starts or ends.
+        std::vector<SHORT> _patternBoundaries;
+
+        // Rows are prepared once per frame and shared by all engines. They
+        // point into the text buffer, so they're reset whenever we take the lock.
+        std::vector<PreparedRow> _preparedRows;
+        std::vector<PreparedRun> _preparedRuns;
+        std::vector<Cluster> _preparedClusters;
+
+        // The buffer cells with blinking attributes that were painted, as
+        // exclusive rectangles that are one row tall. See TriggerRedrawBlinking().
+        std::vector<SMALL_RECT> _blinkingCells;
+        void _ForgetBlinkingCells(const Microsoft::Console::Types::Viewport& bufferLine) noexcept;
+
+        std::vector<IRenderEngine*> _enginesToPresent;
 
         std::vector<SMALL_RECT> _GetSelectionRects() const;
         void _ScrollPreviousSelection(const til::point delta);
         std::vector<SMALL_RECT> _previousSelection;
+        std::vector<SMALL_RECT> _selectionDelta;
+        static void s_GetSelectionDelta(const std::vector<SMALL_RECT>& previous,
+                                        const std::vector<SMALL_RECT>& current,
+                                        std::vector<SMALL_RECT>& delta);
 
         [[nodiscard]] HRESULT _PaintTitle(IRenderEngine* const pEngine);
 
@@ -147,6 +280,7 @@ namespace Microsoft::Console::Render
 
         const size_t _firstSoftFontChar = 0xEF20;
         size_t _lastSoftFontChar = 0;
+        std::shared_ptr<SoftFontGlyphCache> _softFontGlyphCache;
         static bool s_IsSoftFontChar(const std::wstring_view& v, const size_t firstSoftFontChar, const size_t lastSoftFontChar);
 
         // Helper functions to diagnose issues with painting and layout.
@@ -154,6 +288,7 @@ namespace Microsoft::Console::Render
         bool _fDebug = false;
 
         std::function<void()> _pfnRendererEnteredErrorState;
+        std::function<void(std::chrono::steady_clock::time_point)> _pfnFramePresented;
 
 #ifdef UNIT_TESTING
         friend class ConptyOutputTests;
@@ -5,6 +5,8 @@
 
 #include "thread.hpp"
 
+#include <dwmapi.h>
+
 #pragma hdrstop
 
 using namespace Microsoft::Console::Render;
@@ -17,7 +19,16 @@ RenderThread::RenderThread() :
     _fKeepRunning(true),
     _hPaintEnabledEvent(nullptr),
     _fNextFrameRequested(false),
-    _fWaiting(false)
+    _fWaiting(false),
+    _refreshInterval(std::chrono::milliseconds(s_FrameLimitMilliseconds)),
+    _statisticsWindowStart(),
+    _statisticsWindowFrames(0),
+    _framesPainted(0),
+    _framesDropped(0),
+    _paintMicroseconds(0),
+    _framesPerSecond(0),
+    _schedulingClass(Microsoft::Console::Types::ThreadScheduling::Class::Default),
+    _minimumFrameInterval(std::chrono::microseconds::zero())
 {
 }
 
@@ -53,8 +64,10 @@ RenderThread::~RenderThread()
 }
 
 // Method Description:
-// - Create all of the Events we'll need, and the actual thread we'll be doing
-//      work on.
+// - Create all of the Events we'll need. The actual thread we'll be doing work
+//      on is only created once painting is enabled for the first time, so that
+//      renderers that are never shown (like those of background tabs) don't
+//      cost a thread.
 // Arguments:
 // - pRendererParent: the IRenderer that owns this thread, and which we should
 //      trigger frames for.
@@ -119,7 +132,22 @@ RenderThread::~RenderThread()
         }
     }
 
-    if (SUCCEEDED(hr))
+    return hr;
+}
+
+// Method Description:
+// - Creates the thread we'll be doing work on, unless it already exists.
+// Arguments:
+// - <none>
+// Return Value:
+// - S_OK if we succeeded, else an HRESULT corresponding to a failure to create
+//      the Thread.
+[[nodiscard]] HRESULT RenderThread::_EnsureThread() noexcept
+{
+    const std::lock_guard guard{ _threadLock };
+
+    HRESULT hr = S_OK;
+    if (!_hThread)
     {
         HANDLE hThread = CreateThread(nullptr, // non-inheritable security attributes
                                       0, // use default stack size
@@ -166,6 +194,8 @@ DWORD WINAPI RenderThread::s_ThreadProc(_In_ LPVOID lpParameter)
 
 DWORD WINAPI RenderThread::_ThreadProc()
 {
+    Microsoft::Console::Types::ThreadScheduling::CurrentThread scheduling;
+
     while (_fKeepRunning)
     {
         WaitForSingleObject(_hPaintEnabledEvent, INFINITE);
@@ -184,6 +214,10 @@ DWORD WINAPI RenderThread::_ThreadProc()
             {
                 // Wait until a next frame is requested.
                 WaitForSingleObject(_hEvent, INFINITE);
+
+                // We've been idle, so the window may have moved to another
+                // display in the meantime. Pick up its refresh rate.
+                _refreshInterval = s_GetRefreshInterval();
             }
 
             // <--
@@ -209,21 +243,145 @@ DWORD WINAPI RenderThread::_ThreadProc()
 
         ResetEvent(_hPaintCompletedEvent);
 
+        scheduling.Apply(_schedulingClass.load(std::memory_order_relaxed));
+
+        // The swap chain's frame latency waitable object lines us up with vsync,
+        // so the frame (for pacing purposes) begins once we're allowed to render.
         _pRenderer->WaitUntilCanRender();
+        const auto frameStart = std::chrono::steady_clock::now();
         LOG_IF_FAILED(_pRenderer->PaintFrame());
+        const auto frameEnd = std::chrono::steady_clock::now();
 
         SetEvent(_hPaintCompletedEvent);
 
+        _UpdateFrameStatistics(frameStart, frameEnd);
+
         // extra check before we sleep since it's a "long" activity, relatively speaking.
         if (_fKeepRunning)
         {
-            Sleep(s_FrameLimitMilliseconds);
+            // Sleep out the rest of the refresh interval, so that a burst of
+            // NotifyPaint calls is coalesced into one frame per display refresh
+            // (or per minimum frame interval, if we were given a longer one).
+            const auto frameInterval = std::max(_refreshInterval, _minimumFrameInterval.load(std::memory_order_relaxed));
+            const auto remaining = std::chrono::duration_cast<std::chrono::milliseconds>(frameInterval - (frameEnd - frameStart));
+            if (remaining.count() > 0)
+            {
+                Sleep(gsl::narrow_cast<DWORD>(remaining.count()));
+            }
         }
     }
 
     return S_OK;
 }
 
+// Routine Description:
+// - Asks DWM for the refresh rate of the display we're composed onto.
+// Arguments:
+// - <none>
+// Return Value:
+// - The duration of one display refresh, or s_FrameLimitMilliseconds if DWM
+//   isn't available (like on OneCore) or couldn't tell us.
+std::chrono::microseconds RenderThread::s_GetRefreshInterval() noexcept
+{
+    // dwmapi.dll doesn't exist everywhere we run, so don't take a hard dependency on it.
+    static const auto getCompositionTimingInfo = []() noexcept {
+        const auto dwmapi = LoadLibraryExW(L"dwmapi.dll", nullptr, LOAD_LIBRARY_SEARCH_SYSTEM32);
+        return dwmapi ? GetProcAddressByFunctionDeclaration(dwmapi, DwmGetCompositionTimingInfo) : nullptr;
+    }();
+
+    if (getCompositionTimingInfo)
+    {
+        DWM_TIMING_INFO info{};
+        info.cbSize = sizeof(info);
+        if (SUCCEEDED(getCompositionTimingInfo(nullptr, &info)) && info.rateRefresh.uiNumerator != 0)
+        {
+            const auto interval = std::chrono::microseconds(1'000'000ull * info.rateRefresh.uiDenominator / info.rateRefresh.uiNumerator);
+            if (interval.count() > 0)
+            {
+                return interval;
+            }
+        }
+    }
+
+    return std::chrono::milliseconds(s_FrameLimitMilliseconds);
+}
+
+// Routine Description:
+// - Accounts for a frame that was just painted. The frame rate is averaged
+//   over (roughly) one second windows.
+// Arguments:
+// - frameStart - when we started painting the frame
+// - frameEnd - when we finished painting the frame
+// Return Value:
+// - <none>
+void RenderThread::_UpdateFrameStatistics(const std::chrono::steady_clock::time_point frameStart,
+                                          const std::chrono::steady_clock::time_point frameEnd) noexcept
+{
+    _framesPainted.fetch_add(1, std::memory_order_relaxed);
+    _paintMicroseconds.fetch_add(gsl::narrow_cast<uint64_t>(std::chrono::duration_cast<std::chrono::microseconds>(frameEnd - frameStart).count()), std::memory_order_relaxed);
+
+    // Every full refresh interval we spent painting is a refresh the display
+    // went without a new frame.
+    if (const auto overruns = (frameEnd - frameStart) / _refreshInterval; overruns > 0)
+    {
+        _framesDropped.fetch_add(gsl::narrow_cast<uint64_t>(overruns), std::memory_order_relaxed);
+    }
+
+    ++_statisticsWindowFrames;
+
+    const auto elapsed = frameEnd - _statisticsWindowStart;
+    if (elapsed >= std::chrono::seconds(1))
+    {
+        const auto seconds = std::chrono::duration<float>(elapsed).count();
+        _framesPerSecond.store(_statisticsWindowFrames / seconds, std::memory_order_relaxed);
+        _statisticsWindowStart = frameEnd;
+        _statisticsWindowFrames = 0;
+    }
+}
+
+// Routine Description:
+// - Returns how many frames this thread has painted and dropped so far,
+//   how long painting them took, and the frame rate it achieved recently.
+// - Can be called from any thread.
+// Arguments:
+// - <none>
+// Return Value:
+// - The current frame statistics.
+FrameStatistics RenderThread::GetFrameStatistics() const noexcept
+{
+    return {
+        _framesPainted.load(std::memory_order_relaxed),
+        _framesDropped.load(std::memory_order_relaxed),
+        _framesPerSecond.load(std::memory_order_relaxed),
+        _paintMicroseconds.load(std::memory_order_relaxed),
+        0,
+    };
+}
+
+// Method Description:
+// - Sets how the OS should schedule this thread, e.g. as an interactive thread
+//   while its surface can be seen. Takes effect with the next frame.
+// Arguments:
+// - schedulingClass: the scheduling class of the thread.
+// Return Value:
+// - <none>
+void RenderThread::SetSchedulingClass(const Microsoft::Console::Types::ThreadScheduling::Class schedulingClass) noexcept
+{
+    _schedulingClass.store(schedulingClass, std::memory_order_relaxed);
+}
+
+// Method Description:
+// - Caps our frame rate below the display's refresh rate, to save power.
+// Arguments:
+// - interval: the least time between the start of two frames, or zero to
+//   paint once per display refresh.
+// Return Value:
+// - <none>
+void RenderThread::SetMinimumFrameInterval(const std::chrono::microseconds interval) noexcept
+{
+    _minimumFrameInterval.store(interval, std::memory_order_relaxed);
+}
+
 void RenderThread::NotifyPaint()
 {
     if (_fWaiting.load(std::memory_order_acquire))
@@ -238,6 +396,7 @@ void RenderThread::NotifyPaint()
 
 void RenderThread::EnablePainting()
 {
+    LOG_IF_FAILED(_EnsureThread());
     SetEvent(_hPaintEnabledEvent);
 }
 
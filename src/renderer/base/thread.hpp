@@ -32,13 +32,23 @@ namespace Microsoft::Console::Render
         void EnablePainting() override;
         void DisablePainting() override;
         void WaitForPaintCompletionAndDisable(const DWORD dwTimeoutMs) override;
+        FrameStatistics GetFrameStatistics() const noexcept override;
+        void SetSchedulingClass(const Microsoft::Console::Types::ThreadScheduling::Class schedulingClass) noexcept override;
+        void SetMinimumFrameInterval(const std::chrono::microseconds interval) noexcept override;
 
     private:
+        [[nodiscard]] HRESULT _EnsureThread() noexcept;
+
         static DWORD WINAPI s_ThreadProc(_In_ LPVOID lpParameter);
         DWORD WINAPI _ThreadProc();
 
+        static std::chrono::microseconds s_GetRefreshInterval() noexcept;
+        void _UpdateFrameStatistics(const std::chrono::steady_clock::time_point frameStart,
+                                    const std::chrono::steady_clock::time_point frameEnd) noexcept;
+
         static DWORD const s_FrameLimitMilliseconds = 8;
 
+        std::mutex _threadLock;
         HANDLE _hThread;
         HANDLE _hEvent;
 
@@ -50,5 +60,18 @@ namespace Microsoft::Console::Render
         bool _fKeepRunning;
         std::atomic<bool> _fNextFrameRequested;
         std::atomic<bool> _fWaiting;
+
+        std::chrono::microseconds _refreshInterval;
+        std::chrono::steady_clock::time_point _statisticsWindowStart;
+        uint64_t _statisticsWindowFrames;
+        std::atomic<uint64_t> _framesPainted;
+        std::atomic<uint64_t> _framesDropped;
+        std::atomic<uint64_t> _paintMicroseconds;
+        std::atomic<float> _framesPerSecond;
+
+        // Applied by the thread itself, before it paints the next frame.
+        std::atomic<Microsoft::Console::Types::ThreadScheduling::Class> _schedulingClass;
+        // If longer than the display's refresh interval, frames are paced to this instead.
+        std::atomic<std::chrono::microseconds> _minimumFrameInterval;
     };
 }
@@ -0,0 +1,575 @@
+// Copyright (c) Microsoft Corporation.
+// Licensed under the MIT license.
+
+#include "precomp.h"
+
+#include "BuiltinGlyphs.h"
+
+using namespace Microsoft::Console::Render;
+using namespace Microsoft::WRL;
+
+namespace
+{
+    // The weight of each of the four lines that can leave the center of a box drawing cell.
+    enum Weight : uint8_t
+    {
+        None = 0,
+        Light = 1,
+        Heavy = 2,
+        Double = 3,
+    };
+
+    constexpr uint8_t Lines(const Weight up, const Weight right, const Weight down, const Weight left) noexcept
+    {
+        return gsl::narrow_cast<uint8_t>(up << 6 | right << 4 | down << 2 | left);
+    }
+
+    constexpr Weight Up(const uint8_t lines) noexcept { return static_cast<Weight>((lines >> 6) & 3); }
+    constexpr Weight Right(const uint8_t lines) noexcept { return static_cast<Weight>((lines >> 4) & 3); }
+    constexpr Weight Down(const uint8_t lines) noexcept { return static_cast<Weight>((lines >> 2) & 3); }
+    constexpr Weight Left(const uint8_t lines) noexcept { return static_cast<Weight>(lines & 3); }
+
+    constexpr auto L = Light;
+    constexpr auto H = Heavy;
+    constexpr auto D = Double;
+    constexpr auto _ = None;
+
+    // The lines making up U+2500 to U+257F. Dashed lines, arcs and diagonals
+    // are 0 and are left to the font.
+    constexpr std::array<uint8_t, 0x80> BoxDrawingLines{
+        // U+2500
+        Lines(_, L, _, L), // ─
+        Lines(_, H, _, H), // ━
+        Lines(L, _, L, _), // │
+        Lines(H, _, H, _), // ┃
+        0, // ┄
+        0, // ┅
+        0, // ┆
+        0, // ┇
+        0, // ┈
+        0, // ┉
+        0, // ┊
+        0, // ┋
+        Lines(_, L, L, _), // ┌
+        Lines(_, H, L, _), // ┍
+        Lines(_, L, H, _), // ┎
+        Lines(_, H, H, _), // ┏
+        // U+2510
+        Lines(_, _, L, L), // ┐
+        Lines(_, _, L, H), // ┑
+        Lines(_, _, H, L), // ┒
+        Lines(_, _, H, H), // ┓
+        Lines(L, L, _, _), // └
+        Lines(L, H, _, _), // ┕
+        Lines(H, L, _, _), // ┖
+        Lines(H, H, _, _), // ┗
+        Lines(L, _, _, L), // ┘
+        Lines(L, _, _, H), // ┙
+        Lines(H, _, _, L), // ┚
+        Lines(H, _, _, H), // ┛
+        Lines(L, L, L, _), // ├
+        Lines(L, H, L, _), // ┝
+        Lines(H, L, L, _), // ┞
+        Lines(L, L, H, _), // ┟
+        // U+2520
+        Lines(H, L, H, _), // ┠
+        Lines(H, H, L, _), // ┡
+        Lines(L, H, H, _), // ┢
+        Lines(H, H, H, _), // ┣
+        Lines(L, _, L, L), // ┤
+        Lines(L, _, L, H), // ┥
+        Lines(H, _, L, L), // ┦
+        Lines(L, _, H, L), // ┧
+        Lines(H, _, H, L), // ┨
+        Lines(H, _, L, H), // ┩
+        Lines(L, _, H, H), // ┪
+        Lines(H, _, H, H), // ┫
+        Lines(_, L, L, L), // ┬
+        Lines(_, L, L, H), // ┭
+        Lines(_, H, L, L), // ┮
+        Lines(_, H, L, H), // ┯
+        // U+2530
+        Lines(_, L, H, L), // ┰
+        Lines(_, L, H, H), // ┱
+        Lines(_, H, H, L), // ┲
+        Lines(_, H, H, H), // ┳
+        Lines(L, L, _, L), // ┴
+        Lines(L, L, _, H), // ┵
+        Lines(L, H, _, L), // ┶
+        Lines(L, H, _, H), // ┷
+        Lines(H, L, _, L), // ┸
+        Lines(H, L, _, H), // ┹
+        Lines(H, H, _, L), // ┺
+        Lines(H, H, _, H), // ┻
+        Lines(L, L, L, L), // ┼
+        Lines(L, L, L, H), // ┽
+        Lines(L, H, L, L), // ┾
+        Lines(L, H, L, H), // ┿
+        // U+2540
+        Lines(H, L, L, L), // ╀
+        Lines(L, L, H, L), // ╁
+        Lines(H, L, H, L), // ╂
+        Lines(H, L, L, H), // ╃
+        Lines(H, H, L, L), // ╄
+        Lines(L, L, H, H), // ╅
+        Lines(L, H, H, L), // ╆
+        Lines(H, H, L, H), // ╇
+        Lines(L, H, H, H), // ╈
+        Lines(H, L, H, H), // ╉
+        Lines(H, H, H, L), // ╊
+        Lines(H, H, H, H), // ╋
+        0, // ╌
+        0, // ╍
+        0, // ╎
+        0, // ╏
+        // U+2550
+        Lines(_, D, _, D), // ═
+        Lines(D, _, D, _), // ║
+        Lines(_, D, L, _), // ╒
+        Lines(_, L, D, _), // ╓
+        Lines(_, D, D, _), // ╔
+        Lines(_, _, L, D), // ╕
+        Lines(_, _, D, L), // ╖
+        Lines(_, _, D, D), // ╗
+        Lines(L, D, _, _), // ╘
+        Lines(D, L, _, _), // ╙
+        Lines(D, D, _, _), // ╚
+        Lines(L, _, _, D), // ╛
+        Lines(D, _, _, L), // ╜
+        Lines(D, _, _, D), // ╝
+        Lines(L, D, L, _), // ╞
+        Lines(D, L, D, _), // ╟
+        // U+2560
+        Lines(D, D, D, _), // ╠
+        Lines(L, _, L, D), // ╡
+        Lines(D, _, D, L), // ╢
+        Lines(D, _, D, D), // ╣
+        Lines(_, D, L, D), // ╤
+        Lines(_, L, D, L), // ╥
+        Lines(_, D, D, D), // ╦
+        Lines(L, D, _, D), // ╧
+        Lines(D, L, _, L), // ╨
+        Lines(D, D, _, D), // ╩
+        Lines(L, D, L, D), // ╪
+        Lines(D, L, D, L), // ╫
+        Lines(D, D, D, D), // ╬
+        0, // ╭
+        0, // ╮
+        0, // ╯
+        // U+2570
+        0, // ╰
+        0, // ╱
+        0, // ╲
+        0, // ╳
+        Lines(_, _, _, L), // ╴
+        Lines(L, _, _, _), // ╵
+        Lines(_, L, _, _), // ╶
+        Lines(_, _, L, _), // ╷
+        Lines(_, _, _, H), // ╸
+        Lines(H, _, _, _), // ╹
+        Lines(_, H, _, _), // ╺
+        Lines(_, _, H, _), // ╻
+        Lines(_, H, _, L), // ╼
+        Lines(L, _, H, _), // ╽
+        Lines(_, L, _, H), // ╾
+        Lines(H, _, L, _), // ╿
+    };
+
+    constexpr wchar_t BoxDrawingFirst = 0x2500;
+    constexpr wchar_t BlockElementsFirst = 0x2580;
+    constexpr wchar_t BlockElementsLast = 0x259F;
+    constexpr wchar_t PowerlineFirst = 0xE0B0;
+    constexpr wchar_t PowerlineLast = 0xE0B3;
+
+    // The quadrants of U+2596 to U+259F: upper left, upper right, lower left and lower right.
+    constexpr uint8_t UL = 1;
+    constexpr uint8_t UR = 2;
+    constexpr uint8_t LL = 4;
+    constexpr uint8_t LR = 8;
+    constexpr std::array<uint8_t, 10> Quadrants{
+        LL, // ▖
+        LR, // ▗
+        UL, // ▘
+        UL | LL | LR, // ▙
+        UL | LR, // ▚
+        UL | UR | LL, // ▛
+        UL | UR | LR, // ▜
+        UR, // ▝
+        UR | LL, // ▞
+        UR | LL | LR, // ▟
+    };
+}
+
+// Routine Description:
+// - Checks whether we draw the given character ourselves.
+// Arguments:
+// - ch - the character
+// Return Value:
+// - true if Draw() can draw it
+bool BuiltinGlyphs::IsBuiltinGlyph(const wchar_t ch) noexcept
+{
+    if (ch >= BoxDrawingFirst && ch < BlockElementsFirst)
+    {
+        return til::at(BoxDrawingLines, ch - BoxDrawingFirst) != 0;
+    }
+    return (ch >= BlockElementsFirst && ch <= BlockElementsLast) ||
+           (ch >= PowerlineFirst && ch <= PowerlineLast);
+}
+
+// Routine Description:
+// - Sets the size of the cells we draw into. Drops all cached glyphs if it changed.
+// Arguments:
+// - cellSize - the size of a cell in the coordinate space we're drawn in
+// Return Value:
+// - <none>
+void BuiltinGlyphs::SetCellSize(const D2D1_SIZE_F cellSize) noexcept
+{
+    if (cellSize.width != _cellSize.width || cellSize.height != _cellSize.height)
+    {
+        _cellSize = cellSize;
+        // An eighth of the cell width is about what fonts use for their light lines.
+        _lightWeight = std::max(1.0f, std::round(cellSize.width / 8.0f));
+        _glyphs.clear();
+    }
+}
+
+// Routine Description:
+// - Drops all cached glyphs, for instance because the device they were built for went away.
+// Arguments:
+// - <none>
+// Return Value:
+// - <none>
+void BuiltinGlyphs::Reset() noexcept
+{
+    _glyphs.clear();
+}
+
+// Routine Description:
+// - Draws the given character into the cell at the given origin.
+// Arguments:
+// - deviceContext - the device context to draw with
+// - ch - the character. IsBuiltinGlyph() must be true for it.
+// - origin - the top left corner of the cell
+// - brush - the brush to draw with
+// Return Value:
+// - S_OK or relevant DirectX error
+[[nodiscard]] HRESULT BuiltinGlyphs::Draw(ID2D1DeviceContext* const deviceContext,
+                                          const wchar_t ch,
+                                          const D2D1_POINT_2F origin,
+                                          ID2D1SolidColorBrush* const brush) noexcept
+try
+{
+    auto it = _glyphs.find(ch);
+    if (it == _glyphs.end())
+    {
+        ComPtr<ID2D1Factory> factory;
+        deviceContext->GetFactory(&factory);
+
+        Glyph glyph;
+        RETURN_IF_FAILED(_BuildGlyph(factory.Get(), ch, glyph));
+        it = _glyphs.emplace(ch, std::move(glyph)).first;
+    }
+
+    const auto& glyph = it->second;
+
+    const auto opacity = brush->GetOpacity();
+    const auto restoreOpacity = wil::scope_exit([&]() noexcept { brush->SetOpacity(opacity); });
+    brush->SetOpacity(opacity * glyph.opacity);
+
+    for (const auto& rect : glyph.rectangles)
+    {
+        deviceContext->FillRectangle({ origin.x + rect.left, origin.y + rect.top, origin.x + rect.right, origin.y + rect.bottom }, brush);
+    }
+
+    if (glyph.geometry)
+    {
+        D2D1_MATRIX_3X2_F transform;
+        deviceContext->GetTransform(&transform);
+        const auto restoreTransform = wil::scope_exit([&]() noexcept { deviceContext->SetTransform(transform); });
+        deviceContext->SetTransform(D2D1::Matrix3x2F::Translation(origin.x, origin.y) * *D2D1::Matrix3x2F::ReinterpretBaseType(&transform));
+
+        if (glyph.strokeWidth > 0)
+        {
+            deviceContext->DrawGeometry(glyph.geometry.Get(), brush, glyph.strokeWidth);
+        }
+        else
+        {
+            deviceContext->FillGeometry(glyph.geometry.Get(), brush);
+        }
+    }
+
+    return S_OK;
+}
+CATCH_RETURN()
+
+// Routine Description:
+// - Builds the shape of the given character for the current cell size.
+// Arguments:
+// - factory - used to create the geometry of the Powerline arrows. Everything
+//   else is made of rectangles and doesn't need it.
+// - ch - the character
+// - glyph - receives the shape
+// Return Value:
+// - S_OK or relevant DirectX error
+[[nodiscard]] HRESULT BuiltinGlyphs::_BuildGlyph(ID2D1Factory* const factory, const wchar_t ch, Glyph& glyph) const
+{
+    if (ch >= BoxDrawingFirst && ch < BlockElementsFirst)
+    {
+        _AddLines(glyph.rectangles, til::at(BoxDrawingLines, ch - BoxDrawingFirst));
+    }
+    else if (ch >= 0x2591 && ch <= 0x2593)
+    {
+        // ░▒▓ are the whole cell at a quarter, half and three quarters of the intensity.
+        glyph.rectangles.push_back({ 0, 0, _cellSize.width, _cellSize.height });
+        glyph.opacity = (ch - 0x2590) / 4.0f;
+    }
+    else if (ch >= BlockElementsFirst && ch <= BlockElementsLast)
+    {
+        _AddBlock(glyph.rectangles, ch);
+    }
+    else if (ch >= PowerlineFirst && ch <= PowerlineLast)
+    {
+        RETURN_IF_FAILED(_AddTriangle(factory, ch, glyph));
+    }
+    return S_OK;
+}
+
+// Routine Description:
+// - Adds the rectangles for a box drawing character.
+// - Each line runs from the edge of the cell to its middle, where it overlaps
+//   with the lines crossing it, so that neighboring cells connect seamlessly.
+//   Double lines are two light lines with a light line's worth of space between
+//   them, and need to stop at the right one of the lines they meet.
+// Arguments:
+// - rectangles - receives the rectangles
+// - lines - the lines of the character, as packed by Lines()
+// Return Value:
+// - <none>
+void BuiltinGlyphs::_AddLines(std::vector<D2D1_RECT_F>& rectangles, const uint8_t lines) const
+{
+    const auto w = _cellSize.width;
+    const auto h = _cellSize.height;
+    const auto l = _lightWeight;
+
+    const auto up = Up(lines);
+    const auto right = Right(lines);
+    const auto down = Down(lines);
+    const auto left = Left(lines);
+
+    // Double is the largest weight, so these are Double if either side is.
+    const auto vertical = std::max(up, down);
+    const auto horizontal = std::max(left, right);
+
+    const auto thickness = [l](const Weight weight) noexcept { return weight == Heavy ? 2 * l : l; };
+    const auto centered = [](const float length, const float size) noexcept { return std::floor((length - size) / 2); };
+
+    // The middle of the cell, and where double lines start.
+    const auto cx = std::floor(w / 2);
+    const auto cy = std::floor(h / 2);
+    const auto sx = centered(w, 3 * l);
+    const auto sy = centered(h, 3 * l);
+
+    const auto add = [&](const float left, const float top, const float right, const float bottom) {
+        rectangles.push_back({ left, top, right, bottom });
+    };
+
+    if (right == Double)
+    {
+        const auto topStart = up == Double ? sx + 2 * l : (down == Double ? sx : cx);
+        const auto bottomStart = down == Double ? sx + 2 * l : (up == Double ? sx : cx);
+        add(topStart, sy, w, sy + l);
+        add(bottomStart, sy + 2 * l, w, sy + 3 * l);
+    }
+    else if (right != None)
+    {
+        const auto t = thickness(right);
+        const auto y = centered(h, t);
+        auto start = cx;
+        if (vertical == Double && left == None)
+        {
+            start = up == Double && down == Double ? sx + 2 * l : sx;
+        }
+        else if (vertical != None && vertical != Double)
+        {
+            start = centered(w, thickness(vertical));
+        }
+        add(start, y, w, y + t);
+    }
+
+    if (left == Double)
+    {
+        const auto topEnd = up == Double ? sx + l : (down == Double ? sx + 3 * l : cx);
+        const auto bottomEnd = down == Double ? sx + l : (up == Double ? sx + 3 * l : cx);
+        add(0, sy, topEnd, sy + l);
+        add(0, sy + 2 * l, bottomEnd, sy + 3 * l);
+    }
+    else if (left != None)
+    {
+        const auto t = thickness(left);
+        const auto y = centered(h, t);
+        auto end = cx;
+        if (vertical == Double && right == None)
+        {
+            end = up == Double && down == Double ? sx + l : sx + 3 * l;
+        }
+        else if (vertical != None && vertical != Double)
+        {
+            end = centered(w, thickness(vertical)) + thickness(vertical);
+        }
+        add(0, y, end, y + t);
+    }
+
+    if (up == Double)
+    {
+        const auto leftEnd = left == Double ? sy + l : (right == Double ? sy + 3 * l : cy);
+        const auto rightEnd = right == Double ? sy + l : (left == Double ? sy + 3 * l : cy);
+        add(sx, 0, sx + l, leftEnd);
+        add(sx + 2 * l, 0, sx + 3 * l, rightEnd);
+    }
+    else if (up != None)
+    {
+        const auto t = thickness(up);
+        const auto x = centered(w, t);
+        auto end = cy;
+        if (horizontal == Double && down == None)
+        {
+            end = left == Double && right == Double ? sy + l : sy + 3 * l;
+        }
+        else if (horizontal != None && horizontal != Double)
+        {
+            end = centered(h, thickness(horizontal)) + thickness(horizontal);
+        }
+        add(x, 0, x + t, end);
+    }
+
+    if (down == Double)
+    {
+        const auto leftStart = left == Double ? sy + 2 * l : (right == Double ? sy : cy);
+        const auto rightStart = right == Double ? sy + 2 * l : (left == Double ? sy : cy);
+        add(sx, leftStart, sx + l, h);
+        add(sx + 2 * l, rightStart, sx + 3 * l, h);
+    }
+    else if (down != None)
+    {
+        const auto t = thickness(down);
+        const auto x = centered(w, t);
+        auto start = cy;
+        if (horizontal == Double && up == None)
+        {
+            start = left == Double && right == Double ? sy + 2 * l : sy;
+        }
+        else if (horizontal != None && horizontal != Double)
+        {
+            start = centered(h, thickness(horizontal));
+        }
+        add(x, start, x + t, h);
+    }
+}
+
+// Routine Description:
+// - Adds the rectangles for a block element (U+2580 to U+259F), except for the shades.
+// Arguments:
+// - rectangles - receives the rectangles
+// - ch - the character
+// Return Value:
+// - <none>
+void BuiltinGlyphs::_AddBlock(std::vector<D2D1_RECT_F>& rectangles, const wchar_t ch) const
+{
+    const auto w = _cellSize.width;
+    const auto h = _cellSize.height;
+    const auto eighthsOfWidth = [w](const int eighths) noexcept { return std::round(w * eighths / 8.0f); };
+    const auto eighthsOfHeight = [h](const int eighths) noexcept { return std::round(h * eighths / 8.0f); };
+
+    if (ch == 0x2580)
+    {
+        // ▀
+        rectangles.push_back({ 0, 0, w, eighthsOfHeight(4) });
+    }
+    else if (ch <= 0x2588)
+    {
+        // ▁▂▃▄▅▆▇█ fill the lower 1 to 8 eighths.
+        rectangles.push_back({ 0, eighthsOfHeight(8 - (ch - 0x2580)), w, h });
+    }
+    else if (ch <= 0x258F)
+    {
+        // ▉▊▋▌▍▎▏ fill the left 7 to 1 eighths.
+        rectangles.push_back({ 0, 0, eighthsOfWidth(8 - (ch - 0x2588)), h });
+    }
+    else if (ch == 0x2590)
+    {
+        // ▐
+        rectangles.push_back({ eighthsOfWidth(4), 0, w, h });
+    }
+    else if (ch == 0x2594)
+    {
+        // ▔
+        rectangles.push_back({ 0, 0, w, eighthsOfHeight(1) });
+    }
+    else if (ch == 0x2595)
+    {
+        // ▕
+        rectangles.push_back({ eighthsOfWidth(7), 0, w, h });
+    }
+    else if (ch >= 0x2596)
+    {
+        const auto quadrants = til::at(Quadrants, ch - 0x2596);
+        const auto cx = eighthsOfWidth(4);
+        const auto cy = eighthsOfHeight(4);
+        if (quadrants & UL)
+        {
+            rectangles.push_back({ 0, 0, cx, cy });
+        }
+        if (quadrants & UR)
+        {
+            rectangles.push_back({ cx, 0, w, cy });
+        }
+        if (quadrants & LL)
+        {
+            rectangles.push_back({ 0, cy, cx, h });
+        }
+        if (quadrants & LR)
+        {
+            rectangles.push_back({ cx, cy, w, h });
+        }
+    }
+}
+
+// Routine Description:
+// - Builds the geometry for one of the Powerline arrows. U+E0B0 and U+E0B2 are
+//   solid triangles pointing right and left, U+E0B1 and U+E0B3 their outlines.
+// Arguments:
+// - factory - the factory to create the geometry with
+// - ch - the character
+// - glyph - receives the geometry
+// Return Value:
+// - S_OK or relevant DirectX error
+[[nodiscard]] HRESULT BuiltinGlyphs::_AddTriangle(ID2D1Factory* const factory, const wchar_t ch, Glyph& glyph) const
+{
+    RETURN_HR_IF_NULL(E_INVALIDARG, factory);
+
+    const auto w = _cellSize.width;
+    const auto h = _cellSize.height;
+    const auto pointsRight = ch == 0xE0B0 || ch == 0xE0B1;
+    const auto filled = ch == 0xE0B0 || ch == 0xE0B2;
+
+    // The outlines are stroked along their center, so pull them in by half a line
+    // to keep them inside the cell.
+    const auto inset = filled ? 0.0f : _lightWeight / 2;
+    const auto baseX = pointsRight ? inset : w - inset;
+    const auto tipX = pointsRight ? w - inset : inset;
+
+    ComPtr<ID2D1PathGeometry> geometry;
+    RETURN_IF_FAILED(factory->CreatePathGeometry(&geometry));
+
+    ComPtr<ID2D1GeometrySink> sink;
+    RETURN_IF_FAILED(geometry->Open(&sink));
+    sink->BeginFigure({ baseX, 0 }, filled ? D2D1_FIGURE_BEGIN_FILLED : D2D1_FIGURE_BEGIN_HOLLOW);
+    sink->AddLine({ tipX, h / 2 });
+    sink->AddLine({ baseX, h });
+    sink->EndFigure(filled ? D2D1_FIGURE_END_CLOSED : D2D1_FIGURE_END_OPEN);
+    RETURN_IF_FAILED(sink->Close());
+
+    glyph.geometry = std::move(geometry);
+    glyph.strokeWidth = filled ? 0.0f : _lightWeight;
+    return S_OK;
+}
@@ -0,0 +1,53 @@
+// Copyright (c) Microsoft Corporation.
+// Licensed under the MIT license.
+
+#pragma once
+
+#include <d2d1_1.h>
+
+#include <wrl.h>
+
+namespace Microsoft::Console::Render
+{
+    // BuiltinGlyphs draws box drawing characters, block elements and the
+    // Powerline arrows as plain geometry instead of asking the font for them.
+    // Those characters are meant to connect seamlessly with their neighbors,
+    // which fonts rarely manage at every cell size, and TUIs draw a lot of them.
+    //
+    // The geometry of each character is built for the current cell size the
+    // first time it's drawn and cached until the cell size changes.
+    class BuiltinGlyphs
+    {
+    public:
+        static bool IsBuiltinGlyph(const wchar_t ch) noexcept;
+
+        void SetCellSize(const D2D1_SIZE_F cellSize) noexcept;
+        void Reset() noexcept;
+
+        [[nodiscard]] HRESULT Draw(ID2D1DeviceContext* const deviceContext,
+                                   const wchar_t ch,
+                                   const D2D1_POINT_2F origin,
+                                   ID2D1SolidColorBrush* const brush) noexcept;
+
+    private:
+        // The shape of a character, relative to the top left corner of its cell.
+        struct Glyph
+        {
+            std::vector<D2D1_RECT_F> rectangles;
+            float opacity{ 1.0f };
+            ::Microsoft::WRL::ComPtr<ID2D1PathGeometry> geometry;
+            float strokeWidth{ 0.0f }; // the geometry is filled if this is 0
+        };
+
+        [[nodiscard]] HRESULT _BuildGlyph(ID2D1Factory* const factory, const wchar_t ch, Glyph& glyph) const;
+        void _AddLines(std::vector<D2D1_RECT_F>& rectangles, const uint8_t lines) const;
+        void _AddBlock(std::vector<D2D1_RECT_F>& rectangles, const wchar_t ch) const;
+        [[nodiscard]] HRESULT _AddTriangle(ID2D1Factory* const factory, const wchar_t ch, Glyph& glyph) const;
+
+        D2D1_SIZE_F _cellSize{};
+        float _lightWeight{ 1.0f };
+        std::unordered_map<wchar_t, Glyph> _glyphs;
+
+        friend class BuiltinGlyphsTests;
+    };
+}
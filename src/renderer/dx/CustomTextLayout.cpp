@@ -155,14 +155,20 @@ try
     _formatInUse = _fontRenderData->TextFormatWithAttribute(weight, style, stretch).Get();
     _fontInUse = _fontRenderData->FontFaceWithAttribute(weight, style, stretch).Get();
 
-    RETURN_IF_FAILED(_AnalyzeTextComplexity());
-    RETURN_IF_FAILED(_AnalyzeRuns());
-    RETURN_IF_FAILED(_ShapeGlyphRuns());
-    RETURN_IF_FAILED(_CorrectGlyphRuns());
-    // Correcting box drawing has to come after both font fallback and
-    // the glyph run advance correction (which will apply a font size scaling factor).
-    // We need to know all the proposed X and Y dimension metrics to get this right.
-    RETURN_IF_FAILED(_CorrectBoxDrawing());
+    _BuildShapingCacheKey(drawingContext->useBoldFont, drawingContext->useItalicFont);
+    if (!_LoadShapedText())
+    {
+        RETURN_IF_FAILED(_AnalyzeTextComplexity());
+        RETURN_IF_FAILED(_AnalyzeRuns());
+        RETURN_IF_FAILED(_ShapeGlyphRuns());
+        RETURN_IF_FAILED(_CorrectGlyphRuns());
+        // Correcting box drawing has to come after both font fallback and
+        // the glyph run advance correction (which will apply a font size scaling factor).
+        // We need to know all the proposed X and Y dimension metrics to get this right.
+        RETURN_IF_FAILED(_CorrectBoxDrawing());
+
+        _StoreShapedText();
+    }
 
     RETURN_IF_FAILED(_DrawGlyphRuns(clientDrawingContext, renderer, { originX, originY }));
 
@@ -170,6 +176,69 @@ try
 }
 CATCH_RETURN()
 
+// Routine Description:
+// - Builds the key under which the shaping results of the current text are cached.
+// Arguments:
+// - useBoldFont - whether the text is drawn with the bold font face
+// - useItalicFont - whether the text is drawn with the italic font face
+// Return Value:
+// - <none>, fills _shapingCacheKey
+void CustomTextLayout::_BuildShapingCacheKey(const bool useBoldFont, const bool useItalicFont)
+{
+    // The first character holds the attributes, followed by the columns of each
+    // character (there's one per character) and then the text itself.
+    _shapingCacheKey.clear();
+    _shapingCacheKey.push_back(gsl::narrow_cast<wchar_t>((useBoldFont ? 1 : 0) | (useItalicFont ? 2 : 0)));
+    _shapingCacheKey.append(_textClusterColumns.cbegin(), _textClusterColumns.cend());
+    _shapingCacheKey.append(_text);
+}
+
+// Routine Description:
+// - Looks up the shaping results for _shapingCacheKey and, if they're cached,
+//   copies them into the layout, so that it's ready to be drawn.
+// Arguments:
+// - <none>
+// Return Value:
+// - true if the shaping results were cached
+[[nodiscard]] bool CustomTextLayout::_LoadShapedText()
+{
+    const auto it = _shapingCacheMap.find(_shapingCacheKey);
+    if (it == _shapingCacheMap.end())
+    {
+        return false;
+    }
+
+    // Mark the entry as the most recently used one.
+    _shapingCache.splice(_shapingCache.begin(), _shapingCache, it->second);
+
+    const auto& shaped = it->second->second;
+    _runs = shaped.runs;
+    _glyphOffsets = shaped.glyphOffsets;
+    _glyphClusters = shaped.glyphClusters;
+    _glyphIndices = shaped.glyphIndices;
+    _glyphAdvances = shaped.glyphAdvances;
+    return true;
+}
+
+// Routine Description:
+// - Caches the shaping results of the current text under _shapingCacheKey,
+//   evicting the least recently used entry if the cache is full.
+// Arguments:
+// - <none>
+// Return Value:
+// - <none>
+void CustomTextLayout::_StoreShapedText()
+{
+    if (_shapingCache.size() >= _shapingCacheCapacity)
+    {
+        _shapingCacheMap.erase(_shapingCache.back().first);
+        _shapingCache.pop_back();
+    }
+
+    _shapingCache.emplace_front(_shapingCacheKey, ShapedText{ _runs, _glyphOffsets, _glyphClusters, _glyphIndices, _glyphAdvances });
+    _shapingCacheMap.emplace(_shapingCache.front().first, _shapingCache.begin());
+}
+
 // Routine Description:
 // - Uses the internal text information and the analyzers/font information from construction
 //   to determine the complexity of the text. If the text is determined to be entirely simple,
@@ -1274,69 +1343,83 @@ CATCH_RETURN();
 
         ::Microsoft::WRL::ComPtr<IDWriteFontFallback1> fallback1;
         ::Microsoft::WRL::ComPtr<IDWriteTextFormat3> format3;
+        std::vector<DWRITE_FONT_AXIS_VALUE> axesVector;
 
         // If the OS supports IDWriteFontFallback1 and IDWriteTextFormat3, we can use the
         // newer MapCharacters to apply axes of variation to the font
         if (!FAILED(_formatInUse->QueryInterface(IID_PPV_ARGS(&format3))) && !FAILED(fallback->QueryInterface(IID_PPV_ARGS(&fallback1))))
         {
-            const auto axesVector = _fontRenderData->GetAxisVector(weight, stretch, style, format3.Get());
-            // Walk through and analyze the entire string
-            while (textLength > 0)
-            {
-                UINT32 mappedLength = 0;
-                ::Microsoft::WRL::ComPtr<IDWriteFontFace5> mappedFont;
-                FLOAT scale = 0.0f;
-
-                fallback1->MapCharacters(source,
-                                         textPosition,
-                                         textLength,
-                                         collection.Get(),
-                                         familyName.data(),
-                                         axesVector.data(),
-                                         gsl::narrow<uint32_t>(axesVector.size()),
-                                         &mappedLength,
-                                         &scale,
-                                         &mappedFont);
-
-                RETURN_IF_FAILED(_SetMappedFontFace(textPosition, mappedLength, mappedFont, scale));
-
-                textPosition += mappedLength;
-                textLength -= mappedLength;
-            }
+            axesVector = _fontRenderData->GetAxisVector(weight, stretch, style, format3.Get());
         }
         else
         {
-            // The chunk of code below is very similar to the one above, unfortunately this needs
-            // to stay for Win7 compatibility reasons. It is also not possible to combine the two
-            // because they call different versions of MapCharacters
+            // Without IDWriteTextFormat3 there are no axes to apply, so we use the older version.
+            fallback1.Reset();
+        }
 
-            // Walk through and analyze the entire string
-            while (textLength > 0)
+        // Maps the longest run at the given position that can be drawn with a single font.
+        // The two versions of MapCharacters can't be combined, and the older one needs
+        // to stay for Win7 compatibility reasons.
+        const auto mapCharacters = [&](const UINT32 position, const UINT32 length, FallbackMapping& mapping) -> UINT32 {
+            UINT32 mappedLength = 0;
+            if (fallback1)
+            {
+                ::Microsoft::WRL::ComPtr<IDWriteFontFace5> mappedFont;
+                THROW_IF_FAILED(fallback1->MapCharacters(source,
+                                                         position,
+                                                         length,
+                                                         collection.Get(),
+                                                         familyName.data(),
+                                                         axesVector.data(),
+                                                         gsl::narrow<uint32_t>(axesVector.size()),
+                                                         &mappedLength,
+                                                         &mapping.scale,
+                                                         &mappedFont));
+                mapping.fontFace = std::move(mappedFont);
+            }
+            else
             {
-                UINT32 mappedLength = 0;
                 ::Microsoft::WRL::ComPtr<IDWriteFont> mappedFont;
-                FLOAT scale = 0.0f;
-
-                fallback->MapCharacters(source,
-                                        textPosition,
-                                        textLength,
-                                        collection.Get(),
-                                        familyName.data(),
-                                        weight,
-                                        style,
-                                        stretch,
-                                        &mappedLength,
-                                        &mappedFont,
-                                        &scale);
-
-                RETURN_LAST_ERROR_IF(!mappedFont);
-                ::Microsoft::WRL::ComPtr<IDWriteFontFace> face;
-                RETURN_IF_FAILED(mappedFont->CreateFontFace(&face));
-                RETURN_IF_FAILED(_SetMappedFontFace(textPosition, mappedLength, face, scale));
-
-                textPosition += mappedLength;
-                textLength -= mappedLength;
+                THROW_IF_FAILED(fallback->MapCharacters(source,
+                                                        position,
+                                                        length,
+                                                        collection.Get(),
+                                                        familyName.data(),
+                                                        weight,
+                                                        style,
+                                                        stretch,
+                                                        &mappedLength,
+                                                        &mappedFont,
+                                                        &mapping.scale));
+                THROW_LAST_ERROR_IF(!mappedFont);
+                THROW_IF_FAILED(mappedFont->CreateFontFace(&mapping.fontFace));
+            }
+            return mappedLength;
+        };
+
+        const auto attributes = _ToFallbackAttributes(weight, style, stretch);
+
+        // Walk through and analyze the entire string
+        while (textLength > 0)
+        {
+            // Whatever was mapped before doesn't have to be mapped again.
+            const auto cachedLength = _MapCharactersFromCache(attributes, textPosition, textLength);
+            textPosition += cachedLength;
+            textLength -= cachedLength;
+            if (textLength == 0)
+            {
+                break;
             }
+
+            FallbackMapping mapping;
+            const auto mappedLength = mapCharacters(textPosition, textLength, mapping);
+            RETURN_HR_IF(E_UNEXPECTED, mappedLength == 0 || mappedLength > textLength);
+
+            RETURN_IF_FAILED(_SetMappedFontFace(textPosition, mappedLength, mapping.fontFace, mapping.scale));
+            _StoreFallbackMapping(attributes, textPosition, mappedLength, mapping);
+
+            textPosition += mappedLength;
+            textLength -= mappedLength;
         }
     }
     CATCH_RETURN();
@@ -1384,6 +1467,125 @@ CATCH_RETURN();
 
     return S_OK;
 }
+
+// Routine Description:
+// - Reads the code point at the given position of the text.
+// Arguments:
+// - text - the text
+// - position - the index of the first code unit of the code point
+// Return Value:
+// - The code point and the number of code units it takes up.
+static std::pair<UINT32, UINT32> s_ReadCodepoint(const std::wstring_view text, const size_t position) noexcept
+{
+    const auto ch = til::at(text, position);
+    if (IS_HIGH_SURROGATE(ch) && position + 1 < text.size() && IS_LOW_SURROGATE(til::at(text, position + 1)))
+    {
+        const auto low = til::at(text, position + 1);
+        return { 0x10000u + ((static_cast<UINT32>(ch) - 0xD800u) << 10) + (static_cast<UINT32>(low) - 0xDC00u), 2u };
+    }
+    return { ch, 1u };
+}
+
+// Routine Description:
+// - Tells whether the code point only ever extends the cluster of the one before it,
+//   like combining marks, joiners, variation selectors and emoji modifiers. Those
+//   have to be drawn with the font of their base, whatever font they were mapped to before.
+// Arguments:
+// - codepoint - the code point
+// Return Value:
+// - true if it extends the cluster before it
+static constexpr bool s_IsClusterExtender(const UINT32 codepoint) noexcept
+{
+    return (codepoint >= 0x0300 && codepoint <= 0x036F) || // Combining Diacritical Marks
+           (codepoint >= 0x1AB0 && codepoint <= 0x1AFF) || // Combining Diacritical Marks Extended
+           (codepoint >= 0x1DC0 && codepoint <= 0x1DFF) || // Combining Diacritical Marks Supplement
+           (codepoint >= 0x200C && codepoint <= 0x200D) || // ZWNJ and ZWJ
+           (codepoint >= 0x20D0 && codepoint <= 0x20FF) || // Combining Diacritical Marks for Symbols
+           (codepoint >= 0xFE00 && codepoint <= 0xFE0F) || // Variation Selectors
+           (codepoint >= 0xFE20 && codepoint <= 0xFE2F) || // Combining Half Marks
+           (codepoint >= 0x1F3FB && codepoint <= 0x1F3FF) || // Emoji Modifiers
+           (codepoint >= 0xE0020 && codepoint <= 0xE007F) || // Tags
+           (codepoint >= 0xE0100 && codepoint <= 0xE01EF); // Variation Selectors Supplement
+}
+
+// Routine Description:
+// - Applies the cached font fallback results to as much of the given range as possible.
+// - It stops at the first code point that wasn't mapped before, so that DirectWrite
+//   can map the rest. Cluster extenders are drawn with the font of their base.
+// Arguments:
+// - attributes - the font attributes the text is drawn with, from _ToFallbackAttributes
+// - textPosition - the index to start at
+// - textLength - the length of the range
+// Return Value:
+// - The length of the part at the start of the range that was mapped from the cache.
+[[nodiscard]] UINT32 CustomTextLayout::_MapCharactersFromCache(const UINT32 attributes, const UINT32 textPosition, const UINT32 textLength)
+{
+    const std::wstring_view text{ _text };
+    const auto end = textPosition + textLength;
+    const FallbackMapping* current = nullptr;
+    auto runStart = textPosition;
+    auto position = textPosition;
+
+    while (position < end)
+    {
+        const auto [codepoint, length] = s_ReadCodepoint(text, position);
+        if (!current || !s_IsClusterExtender(codepoint))
+        {
+            const auto it = _fallbackCache.find(_ToFallbackCacheKey(attributes, codepoint));
+            if (it == _fallbackCache.end())
+            {
+                break;
+            }
+
+            const auto& mapping = it->second;
+            if (current && (mapping.fontFace != current->fontFace || mapping.scale != current->scale))
+            {
+                THROW_IF_FAILED(_SetMappedFontFace(runStart, position - runStart, current->fontFace, current->scale));
+                runStart = position;
+            }
+            current = &mapping;
+        }
+        position += std::min(length, end - position);
+    }
+
+    if (current)
+    {
+        THROW_IF_FAILED(_SetMappedFontFace(runStart, position - runStart, current->fontFace, current->scale));
+    }
+    return position - textPosition;
+}
+
+// Routine Description:
+// - Remembers the font that DirectWrite mapped the given range to, for each of its
+//   code points, so that they don't have to be mapped again the next time they're drawn.
+// Arguments:
+// - attributes - the font attributes the text is drawn with, from _ToFallbackAttributes
+// - textPosition - the index of the range
+// - textLength - the length of the range
+// - mapping - the font face (or null for the font in use) and scale of the range
+// Return Value:
+// - <none>
+void CustomTextLayout::_StoreFallbackMapping(const UINT32 attributes, const UINT32 textPosition, const UINT32 textLength, const FallbackMapping& mapping)
+{
+    // Text isn't made up of that many distinct code points, but mixed-script
+    // output could still grow this without bounds. Starting over is simplest.
+    if (_fallbackCache.size() >= _fallbackCacheCapacity)
+    {
+        _fallbackCache.clear();
+    }
+
+    const std::wstring_view text{ _text };
+    const auto end = textPosition + textLength;
+    for (auto position = textPosition; position < end;)
+    {
+        const auto [codepoint, length] = s_ReadCodepoint(text, position);
+        if (!s_IsClusterExtender(codepoint))
+        {
+            _fallbackCache.insert_or_assign(_ToFallbackCacheKey(attributes, codepoint), mapping);
+        }
+        position += length;
+    }
+}
 #pragma endregion
 
 #pragma region internal methods for mimicking text analyzer to identify and split box drawing regions
@@ -128,6 +128,24 @@ namespace Microsoft::Console::Render
         [[nodiscard]] HRESULT STDMETHODCALLTYPE _AnalyzeFontFallback(IDWriteTextAnalysisSource* const source, UINT32 textPosition, UINT32 textLength);
         [[nodiscard]] HRESULT STDMETHODCALLTYPE _SetMappedFontFace(UINT32 textPosition, UINT32 textLength, const ::Microsoft::WRL::ComPtr<IDWriteFontFace>& fontFace, FLOAT const scale);
 
+        // What font fallback mapped a code point to: the font face, or null for the font in use, and its scale.
+        struct FallbackMapping
+        {
+            ::Microsoft::WRL::ComPtr<IDWriteFontFace> fontFace;
+            FLOAT scale = 1.0f;
+        };
+
+        static constexpr UINT32 _ToFallbackAttributes(DWRITE_FONT_WEIGHT weight, DWRITE_FONT_STYLE style, DWRITE_FONT_STRETCH stretch) noexcept
+        {
+            return (weight << 16) | (style << 8) | stretch;
+        }
+        static constexpr uint64_t _ToFallbackCacheKey(const UINT32 attributes, const UINT32 codepoint) noexcept
+        {
+            return (static_cast<uint64_t>(attributes) << 32) | codepoint;
+        }
+        [[nodiscard]] UINT32 _MapCharactersFromCache(const UINT32 attributes, const UINT32 textPosition, const UINT32 textLength);
+        void _StoreFallbackMapping(const UINT32 attributes, const UINT32 textPosition, const UINT32 textLength, const FallbackMapping& mapping);
+
         [[nodiscard]] HRESULT STDMETHODCALLTYPE _AnalyzeBoxDrawing(gsl::not_null<IDWriteTextAnalysisSource*> const source, UINT32 textPosition, UINT32 textLength);
         [[nodiscard]] HRESULT STDMETHODCALLTYPE _SetBoxEffect(UINT32 textPosition, UINT32 textLength);
 
@@ -148,6 +166,10 @@ namespace Microsoft::Console::Render
 
         [[nodiscard]] static constexpr UINT32 _EstimateGlyphCount(const UINT32 textLength) noexcept;
 
+        void _BuildShapingCacheKey(const bool useBoldFont, const bool useItalicFont);
+        [[nodiscard]] bool _LoadShapedText();
+        void _StoreShapedText();
+
     private:
         // DirectWrite font render data
         DxFontRenderData* _fontRenderData;
@@ -206,6 +228,31 @@ namespace Microsoft::Console::Render
         // These are used to further break the runs apart and adjust the font size so glyphs fit inside the cells.
         std::vector<ScaleCorrection> _glyphScaleCorrections;
 
+        // The results of analyzing, shaping and correcting a text, which is all that's needed to draw it.
+        struct ShapedText
+        {
+            std::vector<LinkedRun> runs;
+            std::vector<DWRITE_GLYPH_OFFSET> glyphOffsets;
+            std::vector<UINT16> glyphClusters;
+            std::vector<UINT16> glyphIndices;
+            std::vector<float> glyphAdvances;
+        };
+
+        // A least recently used cache of the texts drawn lately, so that we can skip straight to drawing
+        // rows that only got invalidated because the cursor blinked or the selection moved across them.
+        // Each layout only ever uses a single font, so the text, its columns and the font attributes
+        // make up the key. The map's keys point into the strings stored in the list.
+        static constexpr size_t _shapingCacheCapacity = 256;
+        std::list<std::pair<std::wstring, ShapedText>> _shapingCache;
+        std::unordered_map<std::wstring_view, decltype(_shapingCache)::iterator> _shapingCacheMap;
+        std::wstring _shapingCacheKey;
+
+        // The fonts that font fallback mapped the code points drawn lately to, for each of the
+        // font's attributes. Font fallback depends on the text around a code point only in
+        // that clusters aren't split, which _MapCharactersFromCache takes care of itself.
+        static constexpr size_t _fallbackCacheCapacity = 4096;
+        std::unordered_map<uint64_t, FallbackMapping> _fallbackCache;
+
 #ifdef UNIT_TESTING
     public:
         CustomTextLayout() = default;
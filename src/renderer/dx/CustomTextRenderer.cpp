@@ -458,6 +458,22 @@ try
 }
 CATCH_RETURN()
 
+// Routine Description:
+// - Draws the cursor on top of whatever the target holds already, instead of
+//   as part of a glyph run. This is only meant for colored cursors that don't
+//   need to go behind the text, which _drawCursor draws in its second pass.
+// Arguments:
+// - d2dContext - Pointer to the current D2D drawing context
+// - drawingContext - Structure of information required to draw, including the cursor
+// Return Value:
+// - S_FALSE if we did nothing, S_OK if we successfully painted, otherwise an appropriate HRESULT
+[[nodiscard]] HRESULT CustomTextRenderer::DrawOverlayCursor(gsl::not_null<ID2D1DeviceContext*> d2dContext,
+                                                            const DrawingContext& drawingContext) noexcept
+{
+    const D2D1_RECT_F bounds{ 0.0f, 0.0f, drawingContext.targetSize.width, drawingContext.targetSize.height };
+    return _drawCursor(d2dContext, bounds, drawingContext, false);
+}
+
 // Routine Description:
 // - Implementation of IDWriteTextRenderer::DrawInlineObject
 // - Passes drawing control from the outer layout down into the context of an embedded object
@@ -108,6 +108,9 @@ namespace Microsoft::Console::Render
 
         [[nodiscard]] HRESULT STDMETHODCALLTYPE EndClip(void* clientDrawingContext) noexcept;
 
+        [[nodiscard]] static HRESULT DrawOverlayCursor(gsl::not_null<ID2D1DeviceContext*> d2dContext,
+                                                       const DrawingContext& drawingContext) noexcept;
+
     private:
         [[nodiscard]] HRESULT _FillRectangle(void* clientDrawingContext,
                                              IUnknown* clientDrawingEffect,
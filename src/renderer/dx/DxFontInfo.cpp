@@ -13,6 +13,38 @@ static constexpr std::wstring_view FALLBACK_FONT_FACES[] = { L"Consolas", L"Luci
 
 using namespace Microsoft::Console::Render;
 
+namespace
+{
+    // Every pane has its own DxFontRenderData, which resolves the same few fonts over and over.
+    // Font faces are immutable and can be used from any thread, so we share them across the process.
+    // Neither the faces nor their design metrics depend on the font size or the DPI, so zooming
+    // and moving a window to another monitor only have to scale the cached metrics.
+    struct ResolvedFontFace
+    {
+        DxFontInfo fontInfo;
+        std::wstring localeName;
+        Microsoft::WRL::ComPtr<IDWriteFontFace1> fontFace;
+        DxFontDesignMetrics metrics;
+    };
+
+    // The requested family name, weight, style, stretch and locale.
+    using ResolvedFontFaceKey = std::tuple<std::wstring, DWRITE_FONT_WEIGHT, DWRITE_FONT_STYLE, DWRITE_FONT_STRETCH, std::wstring>;
+
+    struct ResolvedFontFaceCache
+    {
+        std::mutex lock;
+        std::map<ResolvedFontFaceKey, ResolvedFontFace> map;
+    };
+
+    ResolvedFontFaceCache& s_GetResolvedFontFaceCache()
+    {
+        // This is intentionally leaked, because releasing DirectWrite
+        // objects while our module is being unloaded isn't safe.
+        static auto cache = new ResolvedFontFaceCache{};
+        return *cache;
+    }
+}
+
 DxFontInfo::DxFontInfo() noexcept :
     _familyName(),
     _weight(DWRITE_FONT_WEIGHT_NORMAL),
@@ -107,6 +139,81 @@ void DxFontInfo::SetFromEngine(const std::wstring_view familyName,
     _stretch = stretch;
 }
 
+// Routine Description:
+// - Attempts to locate the font given, but then begins falling back if we cannot find it.
+// - The result is shared with all other instances in this process that ask for the same font.
+//   Results for which we had to fall back aren't kept, in case the requested font gets installed.
+// - NOTE: The cache assumes that every caller passes the shared DirectWrite factory.
+// Arguments:
+// - dwriteFactory - The DWrite factory to use
+// - localeName - Locale to search for appropriate fonts
+// Return Value:
+// - Smart pointer holding interface reference for queryable font data.
+[[nodiscard]] Microsoft::WRL::ComPtr<IDWriteFontFace1> DxFontInfo::ResolveFontFaceWithFallback(gsl::not_null<IDWriteFactory1*> dwriteFactory,
+                                                                                               std::wstring& localeName)
+{
+    DxFontDesignMetrics metrics;
+    return ResolveFontFaceWithFallback(dwriteFactory, localeName, metrics);
+}
+
+// Routine Description:
+// - Same as above, but also gets the design metrics of the resolved font face,
+//   which are shared across the process along with the face.
+// Arguments:
+// - dwriteFactory - The DWrite factory to use
+// - localeName - Locale to search for appropriate fonts
+// - metrics - Receives the design metrics of the font face
+// Return Value:
+// - Smart pointer holding interface reference for queryable font data.
+[[nodiscard]] Microsoft::WRL::ComPtr<IDWriteFontFace1> DxFontInfo::ResolveFontFaceWithFallback(gsl::not_null<IDWriteFactory1*> dwriteFactory,
+                                                                                               std::wstring& localeName,
+                                                                                               DxFontDesignMetrics& metrics)
+{
+    auto key = std::make_tuple(_familyName, _weight, _style, _stretch, localeName);
+    auto& cache = s_GetResolvedFontFaceCache();
+
+    {
+        const std::lock_guard guard{ cache.lock };
+        if (const auto it = cache.map.find(key); it != cache.map.end())
+        {
+            *this = it->second.fontInfo;
+            localeName = it->second.localeName;
+            metrics = it->second.metrics;
+            return it->second.fontFace;
+        }
+    }
+
+    auto face = _ResolveFontFaceWithFallback(dwriteFactory, localeName);
+    metrics = s_GetDesignMetrics(face.Get());
+
+    if (!_didFallback)
+    {
+        const std::lock_guard guard{ cache.lock };
+        cache.map.insert_or_assign(std::move(key), ResolvedFontFace{ *this, localeName, face, metrics });
+    }
+
+    return face;
+}
+
+// Routine Description:
+// - Gets the metrics of the given font face that don't depend on its size.
+// Arguments:
+// - fontFace - The font face to measure
+// Return Value:
+// - The design metrics.
+[[nodiscard]] DxFontDesignMetrics DxFontInfo::s_GetDesignMetrics(gsl::not_null<IDWriteFontFace1*> fontFace)
+{
+    DxFontDesignMetrics metrics{};
+    fontFace->GetMetrics(&metrics.fontMetrics);
+
+    const UINT32 codePoint = L'M';
+    UINT16 glyphIndex;
+    THROW_IF_FAILED(fontFace->GetGlyphIndicesW(&codePoint, 1, &glyphIndex));
+    THROW_IF_FAILED(fontFace->GetDesignGlyphAdvances(1, &glyphIndex, &metrics.advanceInDesignUnits));
+
+    return metrics;
+}
+
 // Routine Description:
 // - Attempts to locate the font given, but then begins falling back if we cannot find it.
 // - We'll try to fall back to Consolas with the given weight/stretch/style first,
@@ -117,8 +224,8 @@ void DxFontInfo::SetFromEngine(const std::wstring_view familyName,
 // - localeName - Locale to search for appropriate fonts
 // Return Value:
 // - Smart pointer holding interface reference for queryable font data.
-[[nodiscard]] Microsoft::WRL::ComPtr<IDWriteFontFace1> DxFontInfo::ResolveFontFaceWithFallback(gsl::not_null<IDWriteFactory1*> dwriteFactory,
-                                                                                               std::wstring& localeName)
+[[nodiscard]] Microsoft::WRL::ComPtr<IDWriteFontFace1> DxFontInfo::_ResolveFontFaceWithFallback(gsl::not_null<IDWriteFactory1*> dwriteFactory,
+                                                                                                std::wstring& localeName)
 {
     // First attempt to find exactly what the user asked for.
     _didFallback = false;
@@ -332,7 +439,7 @@ void DxFontInfo::SetFromEngine(const std::wstring_view familyName,
 // - dwriteFactory - The DWrite factory to use
 // Return Value:
 // - DirectWrite font collection. May be null if one cannot be created.
-[[nodiscard]] const Microsoft::WRL::ComPtr<IDWriteFontCollection1>& DxFontInfo::_NearbyCollection(gsl::not_null<IDWriteFactory1*> dwriteFactory) const
+[[nodiscard]] const Microsoft::WRL::ComPtr<IDWriteFontCollection1>& DxFontInfo::_NearbyCollection(gsl::not_null<IDWriteFactory1*> dwriteFactory)
 {
     // Magic static so we only attempt to grovel the hard disk once no matter how many instances
     // of the font collection itself we require.
@@ -343,7 +450,14 @@ void DxFontInfo::SetFromEngine(const std::wstring_view familyName,
     // Don't try to look up if below that OS version.
     static const bool s_isWindows10OrGreater = IsWindows10OrGreater();
 
-    if (s_isWindows10OrGreater && !_nearbyCollection)
+    // DxFontInfo gets copied for every font variant of every pane, so we build the collection
+    // once per process instead of once per instance. This is fine, because the factory is the shared one.
+    // Just like the font face cache above, this is intentionally leaked.
+    static auto& nearbyCollection = *new Microsoft::WRL::ComPtr<IDWriteFontCollection1>{};
+    static std::mutex nearbyCollectionLock;
+
+    const std::lock_guard guard{ nearbyCollectionLock };
+    if (s_isWindows10OrGreater && !nearbyCollection)
     {
         // Factory3 has a convenience to get us a font set builder.
         ::Microsoft::WRL::ComPtr<IDWriteFactory3> factory3;
@@ -364,10 +478,10 @@ void DxFontInfo::SetFromEngine(const std::wstring_view familyName,
         ::Microsoft::WRL::ComPtr<IDWriteFontSet> fontSet;
         THROW_IF_FAILED(fontSetBuilder2->CreateFontSet(&fontSet));
 
-        THROW_IF_FAILED(factory3->CreateFontCollectionFromFontSet(fontSet.Get(), &_nearbyCollection));
+        THROW_IF_FAILED(factory3->CreateFontCollectionFromFontSet(fontSet.Get(), &nearbyCollection));
     }
 
-    return _nearbyCollection;
+    return nearbyCollection;
 }
 
 // Routine Description:
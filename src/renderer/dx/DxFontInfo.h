@@ -10,6 +10,15 @@
 
 namespace Microsoft::Console::Render
 {
+    // The metrics of a font face that don't depend on its size or the DPI.
+    // DxFontRenderData derives the cell size and line metrics from them.
+    struct DxFontDesignMetrics
+    {
+        DWRITE_FONT_METRICS1 fontMetrics;
+        // The advance of 'M', which determines the width of a cell.
+        INT32 advanceInDesignUnits;
+    };
+
     class DxFontInfo
     {
     public:
@@ -48,8 +57,16 @@ namespace Microsoft::Console::Render
 
         [[nodiscard]] ::Microsoft::WRL::ComPtr<IDWriteFontFace1> ResolveFontFaceWithFallback(gsl::not_null<IDWriteFactory1*> dwriteFactory,
                                                                                              std::wstring& localeName);
+        [[nodiscard]] ::Microsoft::WRL::ComPtr<IDWriteFontFace1> ResolveFontFaceWithFallback(gsl::not_null<IDWriteFactory1*> dwriteFactory,
+                                                                                             std::wstring& localeName,
+                                                                                             DxFontDesignMetrics& metrics);
 
     private:
+        [[nodiscard]] static DxFontDesignMetrics s_GetDesignMetrics(gsl::not_null<IDWriteFontFace1*> fontFace);
+
+        [[nodiscard]] ::Microsoft::WRL::ComPtr<IDWriteFontFace1> _ResolveFontFaceWithFallback(gsl::not_null<IDWriteFactory1*> dwriteFactory,
+                                                                                              std::wstring& localeName);
+
         [[nodiscard]] ::Microsoft::WRL::ComPtr<IDWriteFontFace1> _FindFontFace(gsl::not_null<IDWriteFactory1*> dwriteFactory,
                                                                                std::wstring& localeName,
                                                                                const bool withNearbyLookup);
@@ -57,12 +74,10 @@ namespace Microsoft::Console::Render
         [[nodiscard]] std::wstring _GetFontFamilyName(gsl::not_null<IDWriteFontFamily*> const fontFamily,
                                                       std::wstring& localeName);
 
-        [[nodiscard]] const Microsoft::WRL::ComPtr<IDWriteFontCollection1>& _NearbyCollection(gsl::not_null<IDWriteFactory1*> dwriteFactory) const;
+        [[nodiscard]] static const Microsoft::WRL::ComPtr<IDWriteFontCollection1>& _NearbyCollection(gsl::not_null<IDWriteFactory1*> dwriteFactory);
 
         [[nodiscard]] static std::vector<std::filesystem::path> s_GetNearbyFonts();
 
-        mutable ::Microsoft::WRL::ComPtr<IDWriteFontCollection1> _nearbyCollection;
-
         // The font name we should be looking for
         std::wstring _familyName;
 
@@ -188,6 +188,31 @@ DxFontRenderData::DxFontRenderData(::Microsoft::WRL::ComPtr<IDWriteFactory1> dwr
 {
     try
     {
+        const auto previousFeatures = _featureVector;
+        const auto previousAxes = _axesVector;
+
+        _SetFeatures(features);
+        _SetAxes(axes);
+
+        // Resolving the font and its fallback is expensive. If nothing changed since
+        // the last call (for instance because the font was already resolved ahead of
+        // time for a new control), we can reuse what we have. We don't do this if we had
+        // to fall back to another font, in case the user just installed the one they asked for.
+        if (_lastDesired && *_lastDesired == desired && _lastDpi == dpi && _lastActual && !_lastActual->GetFallback() &&
+            std::equal(_featureVector.begin(), _featureVector.end(), previousFeatures.begin(), previousFeatures.end(), [](const auto& a, const auto& b) {
+                return a.nameTag == b.nameTag && a.parameter == b.parameter;
+            }) &&
+            std::equal(_axesVector.begin(), _axesVector.end(), previousAxes.begin(), previousAxes.end(), [](const auto& a, const auto& b) {
+                return a.axisTag == b.axisTag && a.value == b.value;
+            }))
+        {
+            actual = *_lastActual;
+            return S_OK;
+        }
+
+        _lastDesired.reset();
+        _lastActual.reset();
+
         _userLocaleName.clear();
         _textFormatMap.clear();
         _fontFaceMap.clear();
@@ -199,10 +224,11 @@ DxFontRenderData::DxFontRenderData(::Microsoft::WRL::ComPtr<IDWriteFactory1> dwr
                                       DWRITE_FONT_STYLE_NORMAL,
                                       DWRITE_FONT_STRETCH_NORMAL);
 
-        _SetFeatures(features);
-        _SetAxes(axes);
-
         _BuildFontRenderData(desired, actual, dpi);
+
+        _lastDesired.emplace(desired);
+        _lastActual.emplace(actual);
+        _lastDpi = dpi;
     }
     CATCH_RETURN();
 
@@ -646,20 +672,12 @@ void DxFontRenderData::_BuildFontRenderData(const FontInfoDesired& desired, Font
     // This is the first attempt to resolve font face after `UpdateFont`.
     // Note that the following line may cause property changes _inside_ `_defaultFontInfo` because the desired font may not exist.
     // See the implementation of `ResolveFontFaceWithFallback` for details.
-    const Microsoft::WRL::ComPtr<IDWriteFontFace1> face = _defaultFontInfo.ResolveFontFaceWithFallback(_dwriteFactory.Get(), fontLocaleName);
-
-    DWRITE_FONT_METRICS1 fontMetrics;
-    face->GetMetrics(&fontMetrics);
-
-    const UINT32 spaceCodePoint = L'M';
-    UINT16 spaceGlyphIndex;
-    THROW_IF_FAILED(face->GetGlyphIndicesW(&spaceCodePoint, 1, &spaceGlyphIndex));
-
-    INT32 advanceInDesignUnits;
-    THROW_IF_FAILED(face->GetDesignGlyphAdvances(1, &spaceGlyphIndex, &advanceInDesignUnits));
-
-    DWRITE_GLYPH_METRICS spaceMetrics = { 0 };
-    THROW_IF_FAILED(face->GetDesignGlyphMetrics(&spaceGlyphIndex, 1, &spaceMetrics));
+    // The face and its design metrics are usually cached already, since they don't depend on the size or the DPI.
+    DxFontDesignMetrics designMetrics;
+    const Microsoft::WRL::ComPtr<IDWriteFontFace1> face = _defaultFontInfo.ResolveFontFaceWithFallback(_dwriteFactory.Get(), fontLocaleName, designMetrics);
+    const auto& fontMetrics = designMetrics.fontMetrics;
+    const auto advanceInDesignUnits = designMetrics.advanceInDesignUnits;
+    _fontFaceMap.emplace(_ToMapKey(_defaultFontInfo.GetWeight(), _defaultFontInfo.GetStyle(), _defaultFontInfo.GetStretch()), face);
 
     // The math here is actually:
     // Requested Size in Points * DPI scaling factor * Points to Pixels scaling factor.
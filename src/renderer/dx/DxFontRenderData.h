@@ -127,6 +127,12 @@ namespace Microsoft::Console::Render
 
         std::wstring _userLocaleName;
         DxFontInfo _defaultFontInfo;
+
+        // The arguments and the result of the last successful UpdateFont() call.
+        std::optional<FontInfoDesired> _lastDesired;
+        std::optional<FontInfo> _lastActual;
+        int _lastDpi{ 0 };
+
         til::size _glyphCell;
         DWRITE_LINE_SPACING _lineSpacing;
         LineMetrics _lineMetrics;
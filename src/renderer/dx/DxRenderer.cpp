@@ -65,6 +65,7 @@ DxEngine::DxEngine() :
     _invalidMap{ &_pool },
     _invalidScroll{},
     _allInvalid{ false },
+    _textInvalidMap{ &_pool },
     _firstFrame{ true },
     _presentParams{ 0 },
     _presentReady{ false },
@@ -87,6 +88,18 @@ DxEngine::DxEngine() :
     _pixelShaderPath{},
     _forceFullRepaintRendering{ false },
     _softwareRendering{ false },
+    _glyphAtlasEnabled{ false },
+    _builtinGlyphsEnabled{ false },
+    _attributeBrushesHits{ 0 },
+    _attributeBrushesMisses{ 0 },
+    _frameStatisticsOverlay{ false },
+    _frameStart{},
+    _frameTimes{},
+    _frameTimesCount{ 0 },
+    _frameTimesNext{ 0 },
+    _inputLatencyP50{ 0 },
+    _inputLatencyP99{ 0 },
+    _inputLatencyCount{ 0 },
     _antialiasingMode{ D2D1_TEXT_ANTIALIAS_MODE_GRAYSCALE },
     _defaultTextBackgroundOpacity{ 1.0f },
     _hwndTarget{ static_cast<HWND>(INVALID_HANDLE_VALUE) },
@@ -229,6 +242,154 @@ _CompileShader(
 #endif
 }
 
+// Routine Description:
+// - Compiles a shader source into binary blob, unless it was compiled before.
+//   Compiled shaders are kept in memory for the other engines (panes) of this
+//   process and in the temp directory for later runs, keyed by a hash of the
+//   source and target. Failing to use the disk cache isn't an error.
+// Arguments:
+// - source - Shader source
+// - target - What kind of shader this is
+// Return Value:
+// - Compiled binary. Errors are thrown and logged.
+static Microsoft::WRL::ComPtr<ID3DBlob> _CompileShaderCached(const std::string& source, const std::string& target)
+{
+#if !TIL_FEATURE_DXENGINESHADERSUPPORT_ENABLED
+    return _CompileShader(source, target);
+#else
+    static std::mutex cacheLock;
+    static std::unordered_map<std::wstring, Microsoft::WRL::ComPtr<ID3DBlob>> cache;
+
+    const auto hash = std::hash<std::string_view>{}(source);
+    const auto name = fmt::format(L"{:016x}-{}-{}.cso", hash, source.size(), std::wstring{ target.begin(), target.end() });
+
+    {
+        const std::lock_guard guard{ cacheLock };
+        if (const auto it = cache.find(name); it != cache.end())
+        {
+            return it->second;
+        }
+    }
+
+    std::wstring path;
+    Microsoft::WRL::ComPtr<ID3DBlob> code;
+    try
+    {
+        wchar_t tempPath[MAX_PATH + 1];
+        const auto length = GetTempPathW(ARRAYSIZE(tempPath), tempPath);
+        THROW_LAST_ERROR_IF(length == 0 || length > MAX_PATH);
+        path = std::wstring{ tempPath, length } + L"TerminalShaderCache";
+        if (!CreateDirectoryW(path.c_str(), nullptr))
+        {
+            THROW_LAST_ERROR_IF(GetLastError() != ERROR_ALREADY_EXISTS);
+        }
+        path += L'\\';
+        path += name;
+
+        wil::unique_hfile file{ CreateFileW(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr) };
+        if (file)
+        {
+            const auto fileSize = GetFileSize(file.get(), nullptr);
+            THROW_LAST_ERROR_IF(fileSize == INVALID_FILE_SIZE);
+            THROW_HR_IF(E_UNEXPECTED, fileSize == 0);
+
+            Microsoft::WRL::ComPtr<ID3DBlob> blob;
+            THROW_IF_FAILED(D3DCreateBlob(fileSize, &blob));
+            DWORD bytesRead = 0;
+            THROW_IF_WIN32_BOOL_FALSE(ReadFile(file.get(), blob->GetBufferPointer(), fileSize, &bytesRead, nullptr));
+            THROW_HR_IF(E_UNEXPECTED, bytesRead != fileSize);
+            code = std::move(blob);
+        }
+    }
+    catch (...)
+    {
+        LOG_CAUGHT_EXCEPTION();
+    }
+
+    if (!code)
+    {
+        code = _CompileShader(source, target);
+
+        if (!path.empty())
+        {
+            try
+            {
+                wil::unique_hfile file{ CreateFileW(path.c_str(), GENERIC_WRITE, 0, nullptr, CREATE_ALWAYS, FILE_ATTRIBUTE_NORMAL, nullptr) };
+                THROW_LAST_ERROR_IF(!file);
+                DWORD bytesWritten = 0;
+                THROW_IF_WIN32_BOOL_FALSE(WriteFile(file.get(), code->GetBufferPointer(), gsl::narrow<DWORD>(code->GetBufferSize()), &bytesWritten, nullptr));
+            }
+            catch (...)
+            {
+                LOG_CAUGHT_EXCEPTION();
+                DeleteFileW(path.c_str());
+            }
+        }
+    }
+
+    const std::lock_guard guard{ cacheLock };
+    cache.emplace(name, code);
+    return code;
+#endif
+}
+
+// Routine Description:
+// - Checks whether a compiled pixel shader reads the Time value of the
+//   PixelShaderSettings constant buffer, which is the first value of the
+//   buffer bound to register b0. Shaders that don't use it only need to be
+//   redrawn when the content changed.
+// Arguments:
+// - blob - The compiled pixel shader
+// Return Value:
+// - false if the shader doesn't use the Time value. true if it does or
+//   if it couldn't be determined.
+static bool _ShaderUsesTime(ID3DBlob* const blob) noexcept
+try
+{
+#if !TIL_FEATURE_DXENGINESHADERSUPPORT_ENABLED
+    UNREFERENCED_PARAMETER(blob);
+    return true;
+#else
+    Microsoft::WRL::ComPtr<ID3D11ShaderReflection> reflection;
+    THROW_IF_FAILED(D3DReflect(blob->GetBufferPointer(), blob->GetBufferSize(), IID_PPV_ARGS(&reflection)));
+
+    D3D11_SHADER_DESC shaderDesc{};
+    THROW_IF_FAILED(reflection->GetDesc(&shaderDesc));
+
+    for (UINT i = 0; i < shaderDesc.ConstantBuffers; i++)
+    {
+        const auto buffer = reflection->GetConstantBufferByIndex(i);
+        D3D11_SHADER_BUFFER_DESC bufferDesc{};
+        THROW_IF_FAILED(buffer->GetDesc(&bufferDesc));
+
+        D3D11_SHADER_INPUT_BIND_DESC bindDesc{};
+        if (bufferDesc.Type != D3D_CT_CBUFFER ||
+            FAILED(reflection->GetResourceBindingDescByName(bufferDesc.Name, &bindDesc)) ||
+            bindDesc.BindPoint != 0)
+        {
+            continue;
+        }
+
+        for (UINT j = 0; j < bufferDesc.Variables; j++)
+        {
+            D3D11_SHADER_VARIABLE_DESC variableDesc{};
+            THROW_IF_FAILED(buffer->GetVariableByIndex(j)->GetDesc(&variableDesc));
+            if (variableDesc.StartOffset < sizeof(float) && WI_IsFlagSet(variableDesc.uFlags, D3D_SVF_USED))
+            {
+                return true;
+            }
+        }
+    }
+
+    return false;
+#endif
+}
+catch (...)
+{
+    LOG_CAUGHT_EXCEPTION();
+    return true;
+}
+
 // Routine Description:
 // - Checks if terminal effects are enabled.
 // Arguments:
@@ -250,6 +411,46 @@ void DxEngine::ToggleShaderEffects()
     LOG_IF_FAILED(InvalidateAll());
 }
 
+// Routine Description:
+// - Toggles the overlay showing a histogram of the recent frame times.
+// Arguments:
+// - <none>
+// Return Value:
+// - <none>
+void DxEngine::ToggleFrameStatisticsOverlay() noexcept
+{
+    _frameStatisticsOverlay = !_frameStatisticsOverlay;
+    LOG_IF_FAILED(InvalidateAll());
+}
+
+// Routine Description:
+// - Sets the input latency shown by the statistics overlay. Must be called on
+//   the render thread, since the overlay reads it while painting.
+// Arguments:
+// - p50 - the median latency in milliseconds
+// - p99 - the 99th percentile of the latency in milliseconds
+// - count - the number of key presses they were computed from
+// Return Value:
+// - <none>
+void DxEngine::SetInputLatencyStatistics(const float p50, const float p99, const size_t count) noexcept
+{
+    _inputLatencyP50 = p50;
+    _inputLatencyP99 = p99;
+    _inputLatencyCount = count;
+}
+
+// Routine Description:
+// - Sets the lines shown by the statistics overlay below the input latency.
+//   Must be called on the render thread, since the overlay reads them while painting.
+// Arguments:
+// - lines - the lines, each of which should fit into the overlay's width
+// Return Value:
+// - <none>
+void DxEngine::SetPaneStatistics(std::vector<std::wstring> lines) noexcept
+{
+    _paneStatistics = std::move(lines);
+}
+
 // Routine Description:
 // - Loads pixel shader source depending on _retroTerminalEffect and _pixelShaderPath
 // Arguments:
@@ -351,14 +552,14 @@ HRESULT DxEngine::_SetupTerminalEffects()
     _d3dDeviceContext->RSSetViewports(1, &vp);
 
     // Prepare shaders.
-    auto vertexBlob = _CompileShader(screenVertexShaderString, "vs_5_0");
+    auto vertexBlob = _CompileShaderCached(screenVertexShaderString, "vs_5_0");
     Microsoft::WRL::ComPtr<ID3DBlob> pixelBlob;
     // As the pixel shader source is user provided it's possible there's a problem with it
     //  so load it inside a try catch, on any error log and fallback on the error pixel shader
     //  If even the error pixel shader fails to load rely on standard exception handling
     try
     {
-        pixelBlob = _CompileShader(pixelShaderSource, "ps_5_0");
+        pixelBlob = _CompileShaderCached(pixelShaderSource, "ps_5_0");
     }
     catch (...)
     {
@@ -385,6 +586,8 @@ HRESULT DxEngine::_SetupTerminalEffects()
         nullptr,
         &_pixelShader));
 
+    _pixelShaderUsesTime = _ShaderUsesTime(pixelBlob.Get());
+
     RETURN_IF_FAILED(_d3dDevice->CreateInputLayout(
         static_cast<const D3D11_INPUT_ELEMENT_DESC*>(_shaderInputLayout),
         ARRAYSIZE(_shaderInputLayout),
@@ -760,6 +963,13 @@ static constexpr D2D1_ALPHA_MODE _dxgiAlphaToD2d1Alpha(DXGI_ALPHA_MODE mode) noe
 
         RETURN_IF_FAILED(_d2dDeviceContext->CreateBitmapFromDxgiSurface(_dxgiSurface.Get(), bitmapProperties, &_d2dBitmap));
 
+        // The text is drawn into a layer of the same size and format, which is then
+        // composed into the bitmap above. The second one is only needed for scrolling.
+        const auto layerProperties = D2D1::BitmapProperties1(D2D1_BITMAP_OPTIONS_TARGET, bitmapProperties.pixelFormat);
+        const auto layerSize = _d2dBitmap->GetPixelSize();
+        RETURN_IF_FAILED(_d2dDeviceContext->CreateBitmap(layerSize, nullptr, 0, layerProperties, &_textLayer));
+        RETURN_IF_FAILED(_d2dDeviceContext->CreateBitmap(layerSize, nullptr, 0, layerProperties, &_textLayerScratch));
+
         // Assign that bitmap as the target of the D2D device context. Draw commands hit the context
         // and are backed by the bitmap which is bound to the swap chain which goes on to be presented.
         // (The foot bone connected to the leg bone,
@@ -809,17 +1019,10 @@ static constexpr D2D1_ALPHA_MODE _dxgiAlphaToD2d1Alpha(DXGI_ALPHA_MODE mode) noe
         RETURN_IF_FAILED(_d2dFactory->CreateStrokeStyle(&_dashStrokeStyleProperties, hyperlinkDashes.data(), gsl::narrow_cast<UINT32>(hyperlinkDashes.size()), &_dashStrokeStyle));
         _hyperlinkStrokeStyle = _dashStrokeStyle;
 
-        // If in composition mode, apply scaling factor matrix
-        if (_chainMode == SwapChainMode::ForComposition)
-        {
-            DXGI_MATRIX_3X2_F inverseScale = { 0 };
-            inverseScale._11 = 1.0f / _scale;
-            inverseScale._22 = inverseScale._11;
+        RETURN_IF_FAILED(_UpdateSwapChainTransform());
 
-            ::Microsoft::WRL::ComPtr<IDXGISwapChain2> sc2;
-            RETURN_IF_FAILED(_dxgiSwapChain.As(&sc2));
-            RETURN_IF_FAILED(sc2->SetMatrixTransform(&inverseScale));
-        }
+        // The new text layer is empty, so all of the text has to be drawn into it.
+        RETURN_IF_FAILED(InvalidateAll());
 
         _prevScale = _scale;
         return S_OK;
@@ -827,6 +1030,33 @@ static constexpr D2D1_ALPHA_MODE _dxgiAlphaToD2d1Alpha(DXGI_ALPHA_MODE mode) noe
     CATCH_RETURN();
 }
 
+// Routine Description:
+// - In composition mode, applies the scaling factor matrix to the swap chain,
+//   and moves it up by the fraction of a row we're scrolled by.
+// Arguments:
+// - <none>
+// Return Value:
+// - S_OK or relevant DirectX error
+[[nodiscard]] HRESULT DxEngine::_UpdateSwapChainTransform() noexcept
+try
+{
+    if (_chainMode == SwapChainMode::ForComposition)
+    {
+        DXGI_MATRIX_3X2_F transform = { 0 };
+        transform._11 = 1.0f / _scale;
+        transform._22 = transform._11;
+        transform._32 = -_subRowScrollOffset * _fontRenderData->GlyphCell().height<float>() / _scale;
+
+        ::Microsoft::WRL::ComPtr<IDXGISwapChain2> sc2;
+        RETURN_IF_FAILED(_dxgiSwapChain.As(&sc2));
+        RETURN_IF_FAILED(sc2->SetMatrixTransform(&transform));
+    }
+
+    _appliedSubRowScrollOffset = _subRowScrollOffset;
+    return S_OK;
+}
+CATCH_RETURN();
+
 // Routine Description:
 // - Releases device-specific resources (typically held on the GPU)
 // Arguments:
@@ -852,7 +1082,13 @@ void DxEngine::_ReleaseDeviceResources() noexcept
         _d2dBrushForeground.Reset();
         _d2dBrushBackground.Reset();
 
+        _glyphAtlas.Reset();
+        _builtinGlyphs.Reset();
+        _imageBitmaps.clear();
+
         _d2dBitmap.Reset();
+        _textLayer.Reset();
+        _textLayerScratch.Reset();
 
         if (nullptr != _d2dDeviceContext.Get() && _isPainting)
         {
@@ -921,6 +1157,51 @@ void DxEngine::_ReleaseDeviceResources() noexcept
     return forceGrayscaleAA;
 }
 
+// Routine Description:
+// - Checks whether the glyph atlas may draw the text of the line at the given position.
+// Arguments:
+// - coord - Character coordinate position in the cell grid
+// Return Value:
+// - True if the glyph atlas is enabled and the current attributes don't need anything it can't do.
+[[nodiscard]] bool DxEngine::_CanUseGlyphAtlas(const COORD coord) const noexcept
+{
+    if (!_glyphAtlasEnabled || !_drawingContext)
+    {
+        return false;
+    }
+
+    // The atlas only holds the regular face of the font, rasterized without ClearType.
+    if (_drawingContext->useBoldFont ||
+        _drawingContext->useItalicFont ||
+        (_antialiasingMode == D2D1_TEXT_ANTIALIAS_MODE_CLEARTYPE && !_drawingContext->forceGrayscaleAA))
+    {
+        return false;
+    }
+
+    // The cursor is drawn by CustomTextRenderer as part of the glyph run it's in.
+    const auto& cursorInfo = _drawingContext->cursorInfo;
+    return !cursorInfo.has_value() || cursorInfo->coordCursor.Y != coord.Y;
+}
+
+// Routine Description:
+// - Checks whether box drawing and block characters on the line at the given
+//   position may be drawn as geometry instead of through the font.
+// Arguments:
+// - coord - Character coordinate position in the cell grid
+// Return Value:
+// - True if the builtin glyphs are enabled and the line doesn't hold the cursor.
+[[nodiscard]] bool DxEngine::_CanUseBuiltinGlyphs(const COORD coord) const noexcept
+{
+    if (!_builtinGlyphsEnabled || !_drawingContext)
+    {
+        return false;
+    }
+
+    // The cursor is drawn by CustomTextRenderer as part of the glyph run it's in.
+    const auto& cursorInfo = _drawingContext->cursorInfo;
+    return !cursorInfo.has_value() || cursorInfo->coordCursor.Y != coord.Y;
+}
+
 // Routine Description:
 // - Helper to create a DirectWrite text layout object
 //   out of a string.
@@ -1004,6 +1285,7 @@ try
         // Enable shader effects if the path isn't empty. Otherwise leave it untouched.
         _terminalEffectsEnabled = value.empty() ? _terminalEffectsEnabled : true;
         _pixelShaderPath = { value };
+        _pixelShaderUsesTime = true;
         _recreateDeviceRequested = true;
         LOG_IF_FAILED(InvalidateAll());
     }
@@ -1033,6 +1315,88 @@ try
 }
 CATCH_LOG()
 
+void DxEngine::SetGlyphAtlasEnabled(bool enable) noexcept
+try
+{
+    if (_glyphAtlasEnabled != enable)
+    {
+        _glyphAtlasEnabled = enable;
+        LOG_IF_FAILED(InvalidateAll());
+    }
+}
+CATCH_LOG()
+
+void DxEngine::SetBuiltinGlyphsEnabled(bool enable) noexcept
+try
+{
+    if (_builtinGlyphsEnabled != enable)
+    {
+        _builtinGlyphsEnabled = enable;
+        LOG_IF_FAILED(InvalidateAll());
+    }
+}
+CATCH_LOG()
+
+// Routine Description:
+// - Gives back all of our device resources: the swap chain, the glyph caches,
+//   the shaders and the device itself, and asks the driver to trim whatever
+//   it still holds on our behalf. They're recreated by the next StartPaint,
+//   the same way as after a lost device.
+// - Must not be called while painting or presenting. The caller has to
+//   disable painting first.
+// Arguments:
+// - <none>
+// Return Value:
+// - <none>
+void DxEngine::Hibernate() noexcept
+{
+    if (!_haveDeviceResources)
+    {
+        return;
+    }
+
+    if (_d3dDeviceContext)
+    {
+        _d3dDeviceContext->ClearState();
+        _d3dDeviceContext->Flush();
+    }
+
+    ::Microsoft::WRL::ComPtr<IDXGIDevice3> dxgiDevice3;
+    if (_dxgiDevice && SUCCEEDED(_dxgiDevice.As(&dxgiDevice3)))
+    {
+        dxgiDevice3->Trim();
+    }
+
+    _ReleaseDeviceResources();
+    LOG_IF_FAILED(InvalidateAll());
+}
+
+void DxEngine::SetSmoothScrolling(bool enable) noexcept
+try
+{
+    if (_smoothScrolling != enable)
+    {
+        // The swap chain is resized to match on the next frame.
+        _smoothScrolling = enable;
+        _subRowScrollOffset = 0.0f;
+        LOG_IF_FAILED(InvalidateAll());
+    }
+}
+CATCH_LOG()
+
+// Routine Description:
+// - Sets the fraction of a row that the viewport is scrolled down by, between 0 and 1.
+//   It's applied to the swap chain's transform on the next frame. The caller
+//   has to invalidate the row below the viewport, which the offset reveals.
+// Arguments:
+// - offset: the fraction of a row
+// Return Value:
+// - <none>
+void DxEngine::SetSubRowScrollOffset(const float offset) noexcept
+{
+    _subRowScrollOffset = _smoothScrolling ? offset : 0.0f;
+}
+
 void DxEngine::SetIntenseIsBold(bool enable) noexcept
 try
 {
@@ -1055,6 +1419,22 @@ HANDLE DxEngine::GetSwapChainHandle()
 }
 
 void DxEngine::_InvalidateRectangle(const til::rectangle& rc)
+{
+    const auto size = _invalidMap.size();
+    const auto topLeft = til::point{ 0, std::min(size.height(), rc.top()) };
+    const auto bottomRight = til::point{ size.width(), std::min(size.height(), rc.bottom()) };
+    _invalidMap.set({ topLeft, bottomRight });
+    _textInvalidMap.set({ topLeft, bottomRight });
+}
+
+// Routine Description:
+// - Invalidates the rows of the given rectangle for the composition only.
+//   The text in them stays the way it is in the text layer.
+// Arguments:
+// - rc - Character rectangle
+// Return Value:
+// - <none>
+void DxEngine::_InvalidateOverlayRectangle(const til::rectangle& rc)
 {
     const auto size = _invalidMap.size();
     const auto topLeft = til::point{ 0, std::min(size.height(), rc.top()) };
@@ -1067,6 +1447,40 @@ bool DxEngine::_IsAllInvalid() const noexcept
     return std::llabs(_invalidScroll.y()) >= _invalidMap.size().height();
 }
 
+// Routine Description:
+// - Checks whether the text at the given position has to be drawn again,
+//   as opposed to only being composed again with the cursor and the selection.
+// Arguments:
+// - coord - Character coordinate position in the cell grid
+// Return Value:
+// - True if the text at the given position is invalid.
+bool DxEngine::_IsTextInvalid(const COORD coord) const
+{
+    if (_textInvalidMap.all())
+    {
+        return true;
+    }
+
+    const til::point point{ coord };
+    const auto runs = _textInvalidMap.runs();
+    return std::any_of(runs.begin(), runs.end(), [&](const til::rectangle& rc) {
+        return rc.contains(point);
+    });
+}
+
+// Routine Description:
+// - Checks whether the cursor can be drawn on top of the composed text. A
+//   colored box is drawn behind the text, and an inverted cursor needs a
+//   backplate behind it, so those still have to be drawn along with the text.
+// Arguments:
+// - options - The cursor of this frame
+// Return Value:
+// - True if the cursor is drawn in _ComposeFrame.
+bool DxEngine::_IsOverlayCursor(const CursorOptions& options) noexcept
+{
+    return options.fUseColor && options.cursorType != CursorType::FullBox;
+}
+
 // Routine Description:
 // - Invalidates a rectangle described in characters
 // Arguments:
@@ -1088,15 +1502,30 @@ try
 CATCH_RETURN()
 
 // Routine Description:
-// - Invalidates the cells of the cursor
+// - Invalidates the cells of the cursor. Unless the cursor is drawn along
+//   with the text, the text under it only has to be composed again.
 // Arguments:
 // - psrRegion - the region covered by the cursor
 // Return Value:
 // - S_OK
 [[nodiscard]] HRESULT DxEngine::InvalidateCursor(const SMALL_RECT* const psrRegion) noexcept
+try
 {
-    return Invalidate(psrRegion);
+    if (_cursorInTextLayer)
+    {
+        return Invalidate(psrRegion);
+    }
+
+    RETURN_HR_IF_NULL(E_INVALIDARG, psrRegion);
+
+    if (!_allInvalid)
+    {
+        _InvalidateOverlayRectangle(Viewport::FromExclusive(*psrRegion).ToInclusive());
+    }
+
+    return S_OK;
 }
+CATCH_RETURN()
 
 // Routine Description:
 // - Invalidates a rectangle describing a pixel area on the display
@@ -1121,22 +1550,25 @@ try
 CATCH_RETURN();
 
 // Routine Description:
-// - Invalidates a series of character rectangles
+// - Invalidates a series of character rectangles. The selection is drawn on
+//   top of the text, so the text under it only has to be composed again.
 // Arguments:
 // - rectangles - One or more rectangles describing character positions on the grid
 // Return Value:
 // - S_OK
 [[nodiscard]] HRESULT DxEngine::InvalidateSelection(const std::vector<SMALL_RECT>& rectangles) noexcept
+try
 {
     if (!_allInvalid)
     {
         for (const auto& rect : rectangles)
         {
-            RETURN_IF_FAILED(Invalidate(&rect));
+            _InvalidateOverlayRectangle(Viewport::FromExclusive(rect).ToInclusive());
         }
     }
     return S_OK;
 }
+CATCH_RETURN()
 
 // Routine Description:
 // - Scrolls the existing dirty region (if it exists) and
@@ -1159,6 +1591,7 @@ try
         {
             // Shift the contents of the map and fill in revealed area.
             _invalidMap.translate(deltaCells, true);
+            _textInvalidMap.translate(deltaCells, true);
             _invalidScroll += deltaCells;
             _allInvalid = _IsAllInvalid();
         }
@@ -1178,6 +1611,7 @@ CATCH_RETURN();
 try
 {
     _invalidMap.set_all();
+    _textInvalidMap.set_all();
     _allInvalid = true;
 
     // Since everything is invalidated here, mark this as a "first frame", so
@@ -1226,6 +1660,10 @@ CATCH_RETURN();
     }
     case SwapChainMode::ForComposition:
     {
+        if (_smoothScrolling)
+        {
+            return { _sizeTarget.width(), _sizeTarget.height() + _fontRenderData->GlyphCell().height() };
+        }
         return _sizeTarget;
     }
     default:
@@ -1332,11 +1770,36 @@ try
         if (const auto size = clientSize / glyphCellSize; size != _invalidMap.size())
         {
             _invalidMap.resize(size);
+            _textInvalidMap.resize(size);
             RETURN_IF_FAILED(InvalidateAll());
         }
 
+        if (_appliedSubRowScrollOffset != _subRowScrollOffset)
+        {
+            RETURN_IF_FAILED(_UpdateSwapChainTransform());
+        }
+
+        RETURN_IF_FAILED(_ScrollTextLayer());
+
+        _d2dDeviceContext->SetTarget(_textLayer.Get());
         _d2dDeviceContext->BeginDraw();
         _isPainting = true;
+        _imageFrame++;
+        _selectionRects.clear();
+        _gridLines.clear();
+
+        _attributeBrushes.clear();
+        _attributeBrushesHits = 0;
+        _attributeBrushesMisses = 0;
+
+        _frameStart = std::chrono::steady_clock::now();
+
+        // The overlay is drawn on top of the text, so the text under it has
+        // to be composed again each frame for it not to pile up on itself.
+        if (_frameStatisticsOverlay)
+        {
+            _InvalidateOverlayRectangle(_GetFrameStatisticsOverlayCells());
+        }
 
         {
             // Get the baseline for this font as that's where we draw from
@@ -1378,23 +1841,43 @@ try
     {
         _isPainting = false;
 
+        LOG_IF_FAILED(_glyphAtlas.Flush());
+        LOG_IF_FAILED(_FlushGridLines());
+
         // If there's still a clip hanging around, remove it. We're all done.
         LOG_IF_FAILED(_customRenderer->EndClip(_drawingContext.get()));
 
+        LOG_IF_FAILED(_ComposeFrame());
+
+        if (_frameStatisticsOverlay)
+        {
+            LOG_IF_FAILED(_PaintFrameStatisticsOverlay());
+        }
+
         hr = _d2dDeviceContext->EndDraw();
 
         if (SUCCEEDED(hr))
         {
-            if (_invalidScroll != til::point{ 0, 0 })
+            // If everything is invalid we leave _presentParams empty, which presents
+            // the whole swap chain. Otherwise only the invalid regions get composed,
+            // so a cursor blink or a single changed line costs just those pixels.
+            if (!_allInvalid && !_FullRepaintNeeded())
             {
                 // Copy `til::rectangles` into RECT map.
-                _presentDirty.assign(_invalidMap.begin(), _invalidMap.end());
+                const auto runs = _invalidMap.runs();
+                _presentDirty.assign(runs.begin(), runs.end());
 
                 // Scale all dirty rectangles into pixels
                 std::transform(_presentDirty.begin(), _presentDirty.end(), _presentDirty.begin(), [&](til::rectangle rc) {
                     return rc.scale_up(_fontRenderData->GlyphCell());
                 });
 
+                _presentParams.DirtyRectsCount = gsl::narrow<UINT>(_presentDirty.size());
+                _presentParams.pDirtyRects = _presentDirty.data();
+            }
+
+            if (_invalidScroll != til::point{ 0, 0 } && _presentParams.DirtyRectsCount != 0)
+            {
                 // Invalid scroll is in characters, convert it to pixels.
                 const auto scrollPixels = (_invalidScroll * _fontRenderData->GlyphCell());
 
@@ -1411,9 +1894,6 @@ try
                 _presentOffset = scrollPixels;
 
                 // Now fill up the parameters structure from the member variables.
-                _presentParams.DirtyRectsCount = gsl::narrow<UINT>(_presentDirty.size());
-                _presentParams.pDirtyRects = _presentDirty.data();
-
                 _presentParams.pScrollOffset = &_presentOffset;
                 _presentParams.pScrollRect = &_presentScroll;
 
@@ -1435,15 +1915,115 @@ try
         }
     }
 
-    _invalidMap.reset_all();
-    _allInvalid = false;
-
-    _invalidScroll = {};
-
+    if (TraceLoggingProviderEnabled(g_hDxRenderProvider, WINEVENT_LEVEL_VERBOSE, TIL_KEYWORD_TRACE))
+    {
+#pragma warning(suppress : 26477 26485 26494 26482 26446 26447) // We don't control TraceLoggingWrite
+        TraceLoggingWrite(g_hDxRenderProvider,
+                          "AttributeBrushes",
+                          TraceLoggingUInt64(_attributeBrushesHits, "hits"),
+                          TraceLoggingUInt64(_attributeBrushesMisses, "misses"),
+                          TraceLoggingLevel(WINEVENT_LEVEL_VERBOSE),
+                          TraceLoggingKeyword(TIL_KEYWORD_TRACE));
+    }
+
+    _invalidMap.reset_all();
+    _textInvalidMap.reset_all();
+    _allInvalid = false;
+
+    _invalidScroll = {};
+
     return hr;
 }
 CATCH_RETURN()
 
+// Routine Description:
+// - Moves the contents of the text layer along with the scrolled invalid map,
+//   so that only the rows that were scrolled into view have to be drawn.
+// Arguments:
+// - <none>
+// Return Value:
+// - S_OK or relevant DirectX error
+[[nodiscard]] HRESULT DxEngine::_ScrollTextLayer() noexcept
+try
+{
+    if (_allInvalid || _invalidScroll == til::point{ 0, 0 } || !_textLayer)
+    {
+        return S_OK;
+    }
+
+    // A bitmap can't be copied onto itself, so the scrolled
+    // contents go into the scratch layer, which then takes over.
+    const auto size = _textLayer->GetPixelSize();
+    const auto offset = _invalidScroll * _fontRenderData->GlyphCell();
+    const auto width = gsl::narrow_cast<ptrdiff_t>(size.width);
+    const auto height = gsl::narrow_cast<ptrdiff_t>(size.height);
+    const auto dx = offset.x();
+    const auto dy = offset.y();
+    RETURN_HR_IF(S_FALSE, std::abs(dx) >= width || std::abs(dy) >= height);
+
+    const D2D1_POINT_2U destination{ gsl::narrow_cast<UINT32>(std::max<ptrdiff_t>(dx, 0)),
+                                     gsl::narrow_cast<UINT32>(std::max<ptrdiff_t>(dy, 0)) };
+    const D2D1_RECT_U source{ gsl::narrow_cast<UINT32>(std::max<ptrdiff_t>(-dx, 0)),
+                              gsl::narrow_cast<UINT32>(std::max<ptrdiff_t>(-dy, 0)),
+                              gsl::narrow_cast<UINT32>(width - std::max<ptrdiff_t>(dx, 0)),
+                              gsl::narrow_cast<UINT32>(height - std::max<ptrdiff_t>(dy, 0)) };
+    RETURN_IF_FAILED(_textLayerScratch->CopyFromBitmap(&destination, _textLayer.Get(), &source));
+    _textLayer.Swap(_textLayerScratch);
+
+    return S_OK;
+}
+CATCH_RETURN()
+
+// Routine Description:
+// - Copies the invalid rows of the text layer into the back buffer,
+//   and draws the selection and the cursor on top of them.
+// Arguments:
+// - <none>
+// Return Value:
+// - S_OK or relevant DirectX error
+[[nodiscard]] HRESULT DxEngine::_ComposeFrame() noexcept
+try
+{
+    _d2dDeviceContext->SetTarget(_d2dBitmap.Get());
+
+    if (_invalidMap.all())
+    {
+        _d2dDeviceContext->DrawImage(_textLayer.Get(), D2D1_INTERPOLATION_MODE_NEAREST_NEIGHBOR, D2D1_COMPOSITE_MODE_SOURCE_COPY);
+    }
+    else
+    {
+        for (const auto& rect : _invalidMap.runs())
+        {
+            const D2D1_RECT_F pixels = rect.scale_up(_fontRenderData->GlyphCell());
+            const D2D1_POINT_2F offset{ pixels.left, pixels.top };
+            _d2dDeviceContext->DrawImage(_textLayer.Get(), &offset, &pixels, D2D1_INTERPOLATION_MODE_NEAREST_NEIGHBOR, D2D1_COMPOSITE_MODE_SOURCE_COPY);
+        }
+    }
+
+    if (!_selectionRects.empty())
+    {
+        const auto existingColor = _d2dBrushForeground->GetColor();
+
+        _d2dBrushForeground->SetColor(_selectionBackground);
+        const auto resetColorOnExit = wil::scope_exit([&]() noexcept { _d2dBrushForeground->SetColor(existingColor); });
+
+        for (const auto& rect : _selectionRects)
+        {
+            _d2dDeviceContext->FillRectangle(rect, _d2dBrushForeground.Get());
+        }
+    }
+
+    if (_overlayCursor.has_value())
+    {
+        auto context = *_drawingContext;
+        context.cursorInfo = _overlayCursor;
+        RETURN_IF_FAILED(CustomTextRenderer::DrawOverlayCursor(_d2dDeviceContext.Get(), context));
+    }
+
+    return S_OK;
+}
+CATCH_RETURN()
+
 // Routine Description:
 // - Copies the front surface of the swap chain (the one being displayed)
 //   to the back surface of the swap chain (the one we draw on next)
@@ -1478,9 +2058,9 @@ CATCH_RETURN()
 [[nodiscard]] bool DxEngine::RequiresContinuousRedraw() noexcept
 {
     // We're only going to request continuous redraw if someone is using
-    // a pixel shader from a path because we cannot tell if those are using the
-    // time parameter or not.
-    // And if they are using time, they probably need it to tick continuously.
+    // a pixel shader from a path that uses the time parameter, because
+    // then it probably needs to tick continuously. Until the shader is
+    // compiled and reflected upon, we presume that it does.
     //
     // By contrast, the in-built retro effect does NOT need it,
     // so let's not tick for it and save some amount of performance.
@@ -1488,7 +2068,7 @@ CATCH_RETURN()
     // Finally... if we're not using effects at all... let the render thread
     // go to sleep. It deserves it. That thread works hard. Also it sleeping
     // saves battery power and all sorts of related perf things.
-    return _terminalEffectsEnabled && !_pixelShaderPath.empty();
+    return _terminalEffectsEnabled && !_pixelShaderPath.empty() && _pixelShaderUsesTime;
 }
 
 // Method Description:
@@ -1599,6 +2179,8 @@ void DxEngine::WaitUntilCanRender() noexcept
 
             _presentReady = false;
 
+            _RecordFrameTime();
+
             _presentDirty.clear();
             _presentOffset = { 0 };
             _presentScroll = { 0 };
@@ -1610,6 +2192,119 @@ void DxEngine::WaitUntilCanRender() noexcept
     return S_OK;
 }
 
+// Routine Description:
+// - Remembers how long the frame that was just presented took, for the statistics overlay.
+// Arguments:
+// - <none>
+// Return Value:
+// - <none>
+void DxEngine::_RecordFrameTime() noexcept
+{
+    const std::chrono::duration<float, std::milli> frameTime = std::chrono::steady_clock::now() - _frameStart;
+    til::at(_frameTimes, _frameTimesNext) = frameTime.count();
+    _frameTimesNext = (_frameTimesNext + 1) % _frameTimes.size();
+    _frameTimesCount = std::min(_frameTimesCount + 1, _frameTimes.size());
+}
+
+// Routine Description:
+// - Gets the cells covered by the statistics overlay in the top right corner.
+// Arguments:
+// - <none>
+// Return Value:
+// - The rectangle of cells, clamped to the invalid map.
+til::rectangle DxEngine::_GetFrameStatisticsOverlayCells() const
+{
+    // A line for the summary, one per histogram bucket, wide enough for the bars,
+    // one for the input latency, and those for the pane statistics.
+    const auto size = _invalidMap.size();
+    const auto width = std::min<ptrdiff_t>(32, size.width());
+    const auto height = std::min<ptrdiff_t>(8 + gsl::narrow_cast<ptrdiff_t>(_paneStatistics.size()), size.height());
+    return { til::point{ size.width() - width, 0 }, til::size{ width, height } };
+}
+
+// Routine Description:
+// - Draws a histogram of the recent frame times over the top right corner of the frame.
+// Arguments:
+// - <none>
+// Return Value:
+// - S_OK or relevant DirectX error
+[[nodiscard]] HRESULT DxEngine::_PaintFrameStatisticsOverlay() noexcept
+try
+{
+    // The upper bounds of the buckets in milliseconds: 240, 120, 60, 30 and 15 fps.
+    static constexpr std::array<float, 5> bucketLimits{ 4.2f, 8.4f, 16.7f, 33.4f, 66.7f };
+    static constexpr std::array<std::wstring_view, bucketLimits.size() + 1> bucketLabels{
+        L" <4ms", L" <8ms", L"<17ms", L"<33ms", L"<67ms", L"67ms+"
+    };
+
+    std::array<size_t, bucketLimits.size() + 1> buckets{};
+    float total = 0;
+    float worst = 0;
+    for (size_t i = 0; i < _frameTimesCount; ++i)
+    {
+        const auto frameTime = til::at(_frameTimes, i);
+        const auto bucket = gsl::narrow_cast<size_t>(std::upper_bound(bucketLimits.begin(), bucketLimits.end(), frameTime) - bucketLimits.begin());
+        ++til::at(buckets, bucket);
+        total += frameTime;
+        worst = std::max(worst, frameTime);
+    }
+
+    const D2D1_SIZE_F cellSize = _fontRenderData->GlyphCell();
+    const auto overlayCells = _GetFrameStatisticsOverlayCells();
+    const D2D1_RECT_F overlay = overlayCells.scale_up(_fontRenderData->GlyphCell());
+    const auto countColumns = std::max<size_t>(overlayCells.width<size_t>(), 6) - 6;
+    const auto format = _fontRenderData->DefaultTextFormat().Get();
+
+    ::Microsoft::WRL::ComPtr<ID2D1SolidColorBrush> brush;
+    RETURN_IF_FAILED(_d2dDeviceContext->CreateSolidColorBrush(D2D1::ColorF(D2D1::ColorF::Black, 0.75f), &brush));
+    _d2dDeviceContext->FillRectangle(overlay, brush.Get());
+    brush->SetColor(D2D1::ColorF(D2D1::ColorF::White));
+
+    const auto drawLine = [&](const size_t line, const std::wstring_view text) {
+        const auto top = overlay.top + line * cellSize.height;
+        const D2D1_RECT_F rect{ overlay.left, top, overlay.right, top + cellSize.height };
+        _d2dDeviceContext->DrawText(text.data(), gsl::narrow<UINT32>(text.size()), format, rect, brush.Get(), D2D1_DRAW_TEXT_OPTIONS_CLIP);
+    };
+
+    const auto average = _frameTimesCount ? total / _frameTimesCount : 0.0f;
+    drawLine(0, fmt::format(L"avg {:.1f}ms max {:.1f}ms", average, worst));
+
+    // The bars start after the label and leave room for the count.
+    const auto barsLeft = overlay.left + 6 * cellSize.width;
+    const auto barsWidth = std::max(0.0f, overlay.right - barsLeft - 4 * cellSize.width);
+    for (size_t i = 0; i < buckets.size(); ++i)
+    {
+        const auto count = til::at(buckets, i);
+        const auto line = i + 1;
+        const auto top = overlay.top + line * cellSize.height;
+
+        drawLine(line, fmt::format(L"{} {:>{}}", til::at(bucketLabels, i), count, countColumns));
+
+        if (_frameTimesCount)
+        {
+            const auto width = barsWidth * count / _frameTimesCount;
+            _d2dDeviceContext->FillRectangle({ barsLeft, top + cellSize.height / 4, barsLeft + width, top + cellSize.height * 3 / 4 }, brush.Get());
+        }
+    }
+
+    if (_inputLatencyCount)
+    {
+        drawLine(buckets.size() + 1, fmt::format(L"key p50 {:.1f}ms p99 {:.1f}ms", _inputLatencyP50, _inputLatencyP99));
+    }
+    else
+    {
+        drawLine(buckets.size() + 1, L"key latency: type to measure");
+    }
+
+    for (size_t i = 0; i < _paneStatistics.size(); ++i)
+    {
+        drawLine(buckets.size() + 2 + i, til::at(_paneStatistics, i));
+    }
+
+    return S_OK;
+}
+CATCH_RETURN()
+
 // Routine Description:
 // - This is currently unused.
 // Arguments:
@@ -1638,7 +2333,7 @@ try
     }
 
     // If the entire thing is invalid, just use one big clear operation.
-    if (_invalidMap.all())
+    if (_textInvalidMap.all())
     {
         _d2dDeviceContext->Clear(nothing);
     }
@@ -1648,7 +2343,7 @@ try
         // Use a transform by the size of one cell to convert cells-to-pixels
         // as we clear.
         _d2dDeviceContext->SetTransform(D2D1::Matrix3x2F::Scale(_fontRenderData->GlyphCell()));
-        for (const auto& rect : _invalidMap.runs())
+        for (const auto& rect : _textInvalidMap.runs())
         {
             // Use aliased.
             // For graphics reasons, it'll look better because it will ensure that
@@ -1679,10 +2374,86 @@ CATCH_RETURN()
                                                 const bool /*trimLeft*/,
                                                 const bool /*lineWrapped*/) noexcept
 try
+{
+    // Only the cursor or the selection changed on this line. The text layer still holds its text.
+    RETURN_HR_IF(S_FALSE, !_IsTextInvalid(coord));
+
+    if (!_CanUseBuiltinGlyphs(coord))
+    {
+        return _PaintBufferLineText(clusters, coord);
+    }
+
+    // A cluster is drawn by us if it's a single, narrow box drawing or block
+    // character. Split the line into stretches of those and everything else,
+    // so that the font still gets to shape the rest in one go.
+    const auto isBuiltin = [](const Cluster& cluster) noexcept {
+        const auto& text = cluster.GetText();
+        return text.size() == 1 && cluster.GetColumns() == 1 && BuiltinGlyphs::IsBuiltinGlyph(til::at(text, 0));
+    };
+
+    auto position = coord;
+    size_t begin = 0;
+    while (begin < clusters.size())
+    {
+        const auto builtin = isBuiltin(til::at(clusters, begin));
+        size_t end = begin + 1;
+        size_t columns = til::at(clusters, begin).GetColumns();
+        for (; end < clusters.size() && isBuiltin(til::at(clusters, end)) == builtin; ++end)
+        {
+            columns += til::at(clusters, end).GetColumns();
+        }
+
+        const auto stretch = clusters.subspan(begin, end - begin);
+        RETURN_IF_FAILED(builtin ? _PaintBuiltinGlyphs(stretch, position) : _PaintBufferLineText(stretch, position));
+
+        position.X = base::ClampAdd(position.X, columns);
+        begin = end;
+    }
+
+    return S_OK;
+}
+CATCH_RETURN()
+
+// Routine Description:
+// - Draws a run of clusters with the font, either from the glyph atlas or through the custom text layout.
+// Arguments:
+// - clusters - Iterable collection of cluster information (text and columns it should consume)
+// - coord - Character coordinate position in the cell grid
+// Return Value:
+// - S_OK or relevant DirectX error
+[[nodiscard]] HRESULT DxEngine::_PaintBufferLineText(gsl::span<const Cluster> const clusters,
+                                                     COORD const coord) noexcept
+try
 {
     // Calculate positioning of our origin.
     const D2D1_POINT_2F origin = til::point{ coord } * _fontRenderData->GlyphCell();
 
+    if (_CanUseGlyphAtlas(coord))
+    {
+        // The glyph atlas only draws the text once it's flushed,
+        // so the background has to be painted beforehand.
+        LOG_IF_FAILED(_customRenderer->EndClip(_drawingContext.get()));
+
+        const auto columns = std::accumulate(clusters.begin(), clusters.end(), size_t{ 0 }, [](const size_t sum, const Cluster& cluster) {
+            return sum + cluster.GetColumns();
+        });
+        const D2D1_SIZE_F cellSize = _fontRenderData->GlyphCell();
+        const D2D1_RECT_F rect{ origin.x, origin.y, origin.x + cellSize.width * columns, origin.y + cellSize.height };
+        _d2dDeviceContext->FillRectangle(rect, _d2dBrushBackground.Get());
+
+        _glyphAtlas.SetTextAntialiasMode(_antialiasingMode == D2D1_TEXT_ANTIALIAS_MODE_ALIASED ? D2D1_TEXT_ANTIALIAS_MODE_ALIASED : D2D1_TEXT_ANTIALIAS_MODE_GRAYSCALE);
+
+        const auto hr = _glyphAtlas.AppendClusters(_d2dDeviceContext.Get(), clusters, origin, _foregroundColor);
+        RETURN_IF_FAILED(hr);
+        if (hr == S_OK)
+        {
+            return S_OK;
+        }
+    }
+
+    // Whatever we draw now has to go on top of what the glyph atlas queued so far.
+    RETURN_IF_FAILED(_glyphAtlas.Flush());
+
     // Create the text layout
     RETURN_IF_FAILED(_customLayout->Reset());
     RETURN_IF_FAILED(_customLayout->AppendClusters(clusters));
@@ -1694,6 +2465,40 @@ try
 }
 CATCH_RETURN()
 
+// Routine Description:
+// - Draws a run of box drawing and block characters as geometry.
+//   Every cluster in it must be a single character that BuiltinGlyphs can draw.
+// Arguments:
+// - clusters - Iterable collection of cluster information (text and columns it should consume)
+// - coord - Character coordinate position in the cell grid
+// Return Value:
+// - S_OK or relevant DirectX error
+[[nodiscard]] HRESULT DxEngine::_PaintBuiltinGlyphs(gsl::span<const Cluster> const clusters,
+                                                    COORD const coord) noexcept
+try
+{
+    // We draw straight onto the device context, so whatever was queued so far
+    // has to be drawn first, including the background of the previous run.
+    RETURN_IF_FAILED(_glyphAtlas.Flush());
+    LOG_IF_FAILED(_customRenderer->EndClip(_drawingContext.get()));
+
+    const D2D1_SIZE_F cellSize = _fontRenderData->GlyphCell();
+    _builtinGlyphs.SetCellSize(cellSize);
+
+    D2D1_POINT_2F origin = til::point{ coord } * _fontRenderData->GlyphCell();
+    const D2D1_RECT_F rect{ origin.x, origin.y, origin.x + cellSize.width * clusters.size(), origin.y + cellSize.height };
+    _d2dDeviceContext->FillRectangle(rect, _d2dBrushBackground.Get());
+
+    for (const auto& cluster : clusters)
+    {
+        RETURN_IF_FAILED(_builtinGlyphs.Draw(_d2dDeviceContext.Get(), cluster.GetTextAsSingle(), origin, _d2dBrushForeground.Get()));
+        origin.x += cellSize.width;
+    }
+
+    return S_OK;
+}
+CATCH_RETURN()
+
 // Routine Description:
 // - Paints lines around cells (draws in pieces of the grid)
 // Arguments:
@@ -1704,27 +2509,32 @@ CATCH_RETURN()
 //               - We will draw rightward (+X) from here
 // Return Value:
 // - S_OK or relevant DirectX error
+// Notes:
+// - The lines are only collected here, and drawn all at once by _FlushGridLines.
 [[nodiscard]] HRESULT DxEngine::PaintBufferGridLines(GridLines const lines,
                                                      COLORREF const color,
                                                      size_t const cchLine,
                                                      COORD const coordTarget) noexcept
 try
 {
-    const auto existingColor = _d2dBrushForeground->GetColor();
-    const auto restoreBrushOnExit = wil::scope_exit([&]() noexcept { _d2dBrushForeground->SetColor(existingColor); });
-
-    _d2dBrushForeground->SetColor(_ColorFFromColorRef(color));
+    RETURN_HR_IF(S_FALSE, !_IsTextInvalid(coordTarget));
 
     const D2D1_SIZE_F font = _fontRenderData->GlyphCell();
     const D2D_POINT_2F target = { coordTarget.X * font.width, coordTarget.Y * font.height };
     const auto fullRunWidth = font.width * gsl::narrow_cast<unsigned>(cchLine);
 
-    const auto DrawLine = [=](const auto x0, const auto y0, const auto x1, const auto y1, const auto strokeWidth) noexcept {
-        _d2dDeviceContext->DrawLine({ x0, y0 }, { x1, y1 }, _d2dBrushForeground.Get(), strokeWidth, _strokeStyle.Get());
+    // A line with square caps covers the rectangle around it, half the stroke width wide.
+    const auto AppendLine = [&](const float x0, const float y0, const float x1, const float y1, const float strokeWidth, const bool dashed) {
+        const auto halfWidth = strokeWidth / 2.0f;
+        _gridLines.push_back({ color, dashed, D2D1_RECT_F{ std::min(x0, x1) - halfWidth, std::min(y0, y1) - halfWidth, std::max(x0, x1) + halfWidth, std::max(y0, y1) + halfWidth } });
     };
 
-    const auto DrawHyperlinkLine = [=](const auto x0, const auto y0, const auto x1, const auto y1, const auto strokeWidth) noexcept {
-        _d2dDeviceContext->DrawLine({ x0, y0 }, { x1, y1 }, _d2dBrushForeground.Get(), strokeWidth, _hyperlinkStrokeStyle.Get());
+    const auto DrawLine = [&](const auto x0, const auto y0, const auto x1, const auto y1, const auto strokeWidth) {
+        AppendLine(x0, y0, x1, y1, strokeWidth, false);
+    };
+
+    const auto DrawHyperlinkLine = [&](const auto x0, const auto y0, const auto x1, const auto y1, const auto strokeWidth) {
+        AppendLine(x0, y0, x1, y1, strokeWidth, _hyperlinkStrokeStyle == _dashStrokeStyle);
     };
 
     // NOTE: Line coordinates are centered within the line, so they need to be
@@ -1817,26 +2627,180 @@ try
 }
 CATCH_RETURN()
 
+// Routine Description:
+// - Draws the gridlines collected by PaintBufferGridLines. Lines of the same
+//   color that touch are merged, and the solid ones of each color are filled
+//   as a single geometry, instead of with a draw call per run and line type.
+// Arguments:
+// - <none>
+// Return Value:
+// - S_OK or relevant DirectX error
+[[nodiscard]] HRESULT DxEngine::_FlushGridLines() noexcept
+try
+{
+    if (_gridLines.empty())
+    {
+        return S_OK;
+    }
+
+    const auto clearOnExit = wil::scope_exit([&]() noexcept { _gridLines.clear(); });
+
+    RETURN_IF_FAILED(_glyphAtlas.Flush());
+    LOG_IF_FAILED(_customRenderer->EndClip(_drawingContext.get()));
+
+    const auto key = [](const GridLine& line) noexcept {
+        return std::tie(line.color, line.dashed, line.rect.top, line.rect.bottom, line.rect.left);
+    };
+    std::sort(_gridLines.begin(), _gridLines.end(), [&](const GridLine& lhs, const GridLine& rhs) noexcept {
+        return key(lhs) < key(rhs);
+    });
+
+    // Merge the lines that continue each other, like the underlines of consecutive runs.
+    auto merged = _gridLines.begin();
+    for (auto it = std::next(merged); it != _gridLines.end(); ++it)
+    {
+        if (it->color == merged->color && it->dashed == merged->dashed &&
+            it->rect.top == merged->rect.top && it->rect.bottom == merged->rect.bottom &&
+            it->rect.left <= merged->rect.right)
+        {
+            merged->rect.right = std::max(merged->rect.right, it->rect.right);
+        }
+        else
+        {
+            *++merged = *it;
+        }
+    }
+    _gridLines.erase(std::next(merged), _gridLines.end());
+
+    const auto existingColor = _d2dBrushForeground->GetColor();
+    const auto restoreBrushOnExit = wil::scope_exit([&]() noexcept { _d2dBrushForeground->SetColor(existingColor); });
+
+    for (auto begin = _gridLines.begin(); begin != _gridLines.end();)
+    {
+        const auto end = std::find_if(begin, _gridLines.end(), [&](const GridLine& line) noexcept {
+            return line.color != begin->color || line.dashed != begin->dashed;
+        });
+
+        _d2dBrushForeground->SetColor(_ColorFFromColorRef(begin->color));
+
+        if (begin->dashed)
+        {
+            // The dashes have to be stroked. Every line still is a single draw call.
+            for (auto it = begin; it != end; ++it)
+            {
+                const auto strokeWidth = it->rect.bottom - it->rect.top;
+                const auto halfWidth = strokeWidth / 2.0f;
+                const auto y = it->rect.top + halfWidth;
+                _d2dDeviceContext->DrawLine({ it->rect.left + halfWidth, y }, { it->rect.right - halfWidth, y }, _d2dBrushForeground.Get(), strokeWidth, _dashStrokeStyle.Get());
+            }
+        }
+        else
+        {
+            ::Microsoft::WRL::ComPtr<ID2D1PathGeometry> geometry;
+            ::Microsoft::WRL::ComPtr<ID2D1GeometrySink> sink;
+            RETURN_IF_FAILED(_d2dFactory->CreatePathGeometry(&geometry));
+            RETURN_IF_FAILED(geometry->Open(&sink));
+
+            // Crossing lines, like an underline below a left gridline, must not cancel each other out.
+            sink->SetFillMode(D2D1_FILL_MODE_WINDING);
+            for (auto it = begin; it != end; ++it)
+            {
+                const auto& rect = it->rect;
+                const std::array<D2D1_POINT_2F, 3> corners{ D2D1_POINT_2F{ rect.right, rect.top }, D2D1_POINT_2F{ rect.right, rect.bottom }, D2D1_POINT_2F{ rect.left, rect.bottom } };
+                sink->BeginFigure({ rect.left, rect.top }, D2D1_FIGURE_BEGIN_FILLED);
+                sink->AddLines(corners.data(), gsl::narrow_cast<UINT32>(corners.size()));
+                sink->EndFigure(D2D1_FIGURE_END_CLOSED);
+            }
+            RETURN_IF_FAILED(sink->Close());
+
+            _d2dDeviceContext->FillGeometry(geometry.Get(), _d2dBrushForeground.Get());
+        }
+
+        begin = end;
+    }
+
+    return S_OK;
+}
+CATCH_RETURN()
+
 // Routine Description:
 // - Paints an overlay highlight on a portion of the frame to represent selected text
 // Arguments:
 //  - rect - Rectangle to invert or highlight to make the selection area
 // Return Value:
 // - S_OK or relevant DirectX error.
-[[nodiscard]] HRESULT DxEngine::PaintSelection(const SMALL_RECT rect) noexcept
+// Routine Description:
+// - Draws one row of cells of an inline image. The image is scaled so that
+//   each of its cells covers exactly one glyph cell. It's uploaded to the GPU
+//   the first time it's painted, and kept there for as long as it's visible.
+// Arguments:
+// - image - The image to draw from
+// - imageRow - The row of image cells to draw
+// - target - The character cell the left edge of the image row is drawn at
+// Return Value:
+// - S_OK or relevant DirectX error.
+[[nodiscard]] HRESULT DxEngine::PaintImageSlice(const InlineImage& image, const size_t imageRow, const COORD target) noexcept
 try
 {
+    const auto sourceTop = imageRow * image.cellHeight;
+    const auto sourceBottom = std::min(sourceTop + image.cellHeight, image.height);
+    RETURN_HR_IF(S_FALSE, sourceTop >= sourceBottom || image.width == 0 || !_IsTextInvalid(target));
+
+    RETURN_IF_FAILED(_glyphAtlas.Flush());
+
     // If a clip rectangle is in place from drawing the text layer, remove it here.
     LOG_IF_FAILED(_customRenderer->EndClip(_drawingContext.get()));
 
-    const auto existingColor = _d2dBrushForeground->GetColor();
+    auto it = _imageBitmaps.find(image.id);
+    if (it == _imageBitmaps.end())
+    {
+        if (_imageBitmaps.size() >= _maxImageBitmaps)
+        {
+            for (auto bitmap = _imageBitmaps.begin(); bitmap != _imageBitmaps.end();)
+            {
+                bitmap = bitmap->second.lastFrame != _imageFrame ? _imageBitmaps.erase(bitmap) : std::next(bitmap);
+            }
+        }
 
-    _d2dBrushForeground->SetColor(_selectionBackground);
-    const auto resetColorOnExit = wil::scope_exit([&]() noexcept { _d2dBrushForeground->SetColor(existingColor); });
+        ImageBitmap imageBitmap;
+        const auto properties = D2D1::BitmapProperties1(D2D1_BITMAP_OPTIONS_NONE,
+                                                        D2D1::PixelFormat(DXGI_FORMAT_B8G8R8A8_UNORM, D2D1_ALPHA_MODE_PREMULTIPLIED));
+        RETURN_IF_FAILED(_d2dDeviceContext->CreateBitmap(D2D1::SizeU(gsl::narrow<UINT32>(image.width), gsl::narrow<UINT32>(image.height)),
+                                                         image.pixels.data(),
+                                                         gsl::narrow<UINT32>(image.width * sizeof(uint32_t)),
+                                                         properties,
+                                                         &imageBitmap.bitmap));
+        it = _imageBitmaps.emplace(image.id, std::move(imageBitmap)).first;
+    }
+    it->second.lastFrame = _imageFrame;
 
-    const D2D1_RECT_F draw = til::rectangle{ Viewport::FromExclusive(rect).ToInclusive() }.scale_up(_fontRenderData->GlyphCell());
+    const auto glyphCell = _fontRenderData->GlyphCell();
+    const auto scaleX = glyphCell.width<float>() / image.cellWidth;
+    const auto scaleY = glyphCell.height<float>() / image.cellHeight;
+
+    const D2D1_RECT_F source{ 0.0f,
+                              static_cast<float>(sourceTop),
+                              static_cast<float>(image.width),
+                              static_cast<float>(sourceBottom) };
+    const auto left = target.X * glyphCell.width<float>();
+    const auto top = target.Y * glyphCell.height<float>();
+    const D2D1_RECT_F destination{ left,
+                                   top,
+                                   left + image.width * scaleX,
+                                   top + (sourceBottom - sourceTop) * scaleY };
+
+    _d2dDeviceContext->DrawBitmap(it->second.bitmap.Get(), &destination, 1.0f, D2D1_INTERPOLATION_MODE_LINEAR, &source);
 
-    _d2dDeviceContext->FillRectangle(draw, _d2dBrushForeground.Get());
+    return S_OK;
+}
+CATCH_RETURN()
+
+[[nodiscard]] HRESULT DxEngine::PaintSelection(const SMALL_RECT rect) noexcept
+try
+{
+    // The selection is drawn on top of the text layer, once it's composed into the frame.
+    const D2D1_RECT_F draw = til::rectangle{ Viewport::FromExclusive(rect).ToInclusive() }.scale_up(_fontRenderData->GlyphCell());
+    _selectionRects.emplace_back(draw);
 
     return S_OK;
 }
@@ -1844,7 +2808,8 @@ CATCH_RETURN()
 
 // Routine Description:
 // - Does nothing. Our cursor is drawn in CustomTextRenderer::DrawGlyphRun,
-//   either above or below the text.
+//   either above or below the text, or on top of the composed frame,
+//   depending on what PrepareRenderInfo found it to be.
 // Arguments:
 // - options - unused
 // Return Value:
@@ -1935,14 +2900,29 @@ CATCH_RETURN()
     // COLORREF to 0xff so we draw as cleartype. In any other case, leave the
     // opacity bits unchanged. PaintBufferLine will later do some logic to
     // determine if we should paint the text as grayscale or not.
-    const bool usingCleartype = _antialiasingMode == D2D1_TEXT_ANTIALIAS_MODE_CLEARTYPE;
-    const bool usingTransparency = _defaultTextBackgroundOpacity != 1.0f;
-    const bool forceOpaqueBG = usingCleartype && !usingTransparency;
+    //
+    // Syntax highlighting and the like hand us the same few attributes over and
+    // over again, so the result is remembered for the rest of the frame.
+    const auto cached = _isPainting ? _attributeBrushes.find(textAttributes) : _attributeBrushes.end();
+    const auto hit = cached != _attributeBrushes.end();
 
-    const auto [colorForeground, colorBackground] = pData->GetAttributeColors(textAttributes);
+    if (hit)
+    {
+        ++_attributeBrushesHits;
+        _foregroundColor = cached->second.foreground;
+        _backgroundColor = cached->second.background;
+    }
+    else
+    {
+        const bool usingCleartype = _antialiasingMode == D2D1_TEXT_ANTIALIAS_MODE_CLEARTYPE;
+        const bool usingTransparency = _defaultTextBackgroundOpacity != 1.0f;
+        const bool forceOpaqueBG = usingCleartype && !usingTransparency;
 
-    _foregroundColor = _ColorFFromColorRef(OPACITY_OPAQUE | colorForeground);
-    _backgroundColor = _ColorFFromColorRef((forceOpaqueBG ? OPACITY_OPAQUE : 0) | colorBackground);
+        const auto [colorForeground, colorBackground] = pData->GetAttributeColors(textAttributes);
+
+        _foregroundColor = _ColorFFromColorRef(OPACITY_OPAQUE | colorForeground);
+        _backgroundColor = _ColorFFromColorRef((forceOpaqueBG ? OPACITY_OPAQUE : 0) | colorBackground);
+    }
 
     _d2dBrushForeground->SetColor(_foregroundColor);
     _d2dBrushBackground->SetColor(_backgroundColor);
@@ -1971,7 +2951,7 @@ CATCH_RETURN()
     // need to update this in those locations.
     if (_drawingContext)
     {
-        _drawingContext->forceGrayscaleAA = _ShouldForceGrayscaleAA();
+        _drawingContext->forceGrayscaleAA = hit ? cached->second.forceGrayscaleAA : _ShouldForceGrayscaleAA();
         _drawingContext->useBoldFont = _intenseIsBold && textAttributes.IsBold();
         _drawingContext->useItalicFont = textAttributes.IsItalic();
     }
@@ -1981,12 +2961,45 @@ CATCH_RETURN()
         _hyperlinkStrokeStyle = (textAttributes.GetHyperlinkId() == _hyperlinkHoveredId) ? _strokeStyle : _dashStrokeStyle;
     }
 
+    if (!hit && _isPainting)
+    {
+        ++_attributeBrushesMisses;
+        try
+        {
+            _attributeBrushes.emplace(textAttributes, AttributeBrushes{ _foregroundColor, _backgroundColor, _ShouldForceGrayscaleAA() });
+        }
+        CATCH_LOG();
+    }
+
     // Update pixel shader settings as background color might have changed
     _ComputePixelShaderSettings();
 
     return S_OK;
 }
 
+// Routine Description:
+// - Hashes the parts of an attribute that pick its colors, for the brush cache.
+//   Attributes that only differ in their other flags end up in the same bucket,
+//   which is fine as the map compares them in full.
+// Arguments:
+// - attr - the attribute to hash
+// Return Value:
+// - the hash
+size_t DxEngine::AttributeHash::operator()(const TextAttribute& attr) const noexcept
+{
+    static_assert(sizeof(TextColor) == sizeof(uint32_t));
+
+    uint32_t foreground;
+    uint32_t background;
+    const auto fg = attr.GetForeground();
+    const auto bg = attr.GetBackground();
+    memcpy(&foreground, &fg, sizeof(foreground));
+    memcpy(&background, &bg, sizeof(background));
+
+    const uint64_t colors = uint64_t{ foreground } << 32 | background;
+    return std::hash<uint64_t>{}(colors) ^ (size_t{ attr.GetLegacyAttributes() } << 1);
+}
+
 // Routine Description:
 // - Updates the font used for drawing
 // - This is the version that complies with the IRenderEngine interface
@@ -2017,6 +3030,8 @@ try
     // Prepare the text layout.
     _customLayout = WRL::Make<CustomTextLayout>(_fontRenderData.get());
 
+    _glyphAtlas.SetFont(*_fontRenderData);
+
     return S_OK;
 }
 CATCH_RETURN();
@@ -2276,7 +3291,29 @@ void DxEngine::UpdateHyperlinkHoveredId(const uint16_t hoveredId) noexcept
 // Return Value:
 // - S_OK
 [[nodiscard]] HRESULT DxEngine::PrepareRenderInfo(const RenderFrameInfo& info) noexcept
+try
 {
+    if (info.cursorInfo.has_value() && _IsOverlayCursor(*info.cursorInfo))
+    {
+        // Drawn on top of the composed frame, so the text layer never contains it.
+        _overlayCursor = info.cursorInfo;
+        _drawingContext->cursorInfo = std::nullopt;
+        _cursorInTextLayer = false;
+        return S_OK;
+    }
+
+    _overlayCursor = std::nullopt;
     _drawingContext->cursorInfo = info.cursorInfo;
+
+    // If the cursor wasn't drawn along with the text so far, its line was
+    // only invalidated for the composition, and has to be drawn again.
+    if (info.cursorInfo.has_value() && !_cursorInTextLayer && !_allInvalid)
+    {
+        const til::point cursor{ info.cursorInfo->coordCursor };
+        _InvalidateRectangle({ cursor, til::size{ 1, 1 } });
+    }
+    _cursorInTextLayer = info.cursorInfo.has_value();
+
     return S_OK;
 }
+CATCH_RETURN()
@@ -27,6 +27,8 @@
 #include "CustomTextLayout.h"
 #include "CustomTextRenderer.h"
 #include "DxFontRenderData.h"
+#include "BuiltinGlyphs.h"
+#include "GlyphAtlas.h"
 
 #include "../../types/inc/Viewport.hpp"
 
@@ -61,6 +63,10 @@ namespace Microsoft::Console::Render
 
         void ToggleShaderEffects();
 
+        void ToggleFrameStatisticsOverlay() noexcept;
+        void SetInputLatencyStatistics(const float p50, const float p99, const size_t count) noexcept;
+        void SetPaneStatistics(std::vector<std::wstring> lines) noexcept;
+
         bool GetRetroTerminalEffect() const noexcept;
         void SetRetroTerminalEffect(bool enable) noexcept;
 
@@ -70,6 +76,15 @@ namespace Microsoft::Console::Render
 
         void SetSoftwareRendering(bool enable) noexcept;
 
+        void SetGlyphAtlasEnabled(bool enable) noexcept;
+
+        void SetBuiltinGlyphsEnabled(bool enable) noexcept;
+
+        void SetSmoothScrolling(bool enable) noexcept;
+        void SetSubRowScrollOffset(const float offset) noexcept;
+
+        void Hibernate() noexcept;
+
         HANDLE GetSwapChainHandle();
 
         // IRenderEngine Members
@@ -101,6 +116,7 @@ namespace Microsoft::Console::Render
                                               const bool lineWrapped) noexcept override;
 
         [[nodiscard]] HRESULT PaintBufferGridLines(GridLines const lines, COLORREF const color, size_t const cchLine, COORD const coordTarget) noexcept override;
+        [[nodiscard]] HRESULT PaintImageSlice(const InlineImage& image, const size_t imageRow, const COORD target) noexcept override;
         [[nodiscard]] HRESULT PaintSelection(const SMALL_RECT rect) noexcept override;
 
         [[nodiscard]] HRESULT PaintCursor(const CursorOptions& options) noexcept override;
@@ -168,6 +184,44 @@ namespace Microsoft::Console::Render
         D2D1_COLOR_F _backgroundColor;
         D2D1_COLOR_F _selectionBackground;
 
+        // What UpdateDrawingBrushes derived from an attribute. The colors depend
+        // on state owned by IRenderData (palette, blinking, reverse screen), which
+        // can only be trusted not to change while we're painting a frame,
+        // so the cache is emptied in StartPaint.
+        struct AttributeBrushes
+        {
+            D2D1_COLOR_F foreground;
+            D2D1_COLOR_F background;
+            bool forceGrayscaleAA;
+        };
+
+        struct AttributeHash
+        {
+            size_t operator()(const TextAttribute& attr) const noexcept;
+        };
+
+        std::unordered_map<TextAttribute, AttributeBrushes, AttributeHash> _attributeBrushes;
+        size_t _attributeBrushesHits;
+        size_t _attributeBrushesMisses;
+
+        // The time from StartPaint to the end of Present for the most recent
+        // frames, in milliseconds. Shown as a histogram by the statistics overlay.
+        static constexpr size_t FrameTimesCapacity = 120;
+        bool _frameStatisticsOverlay;
+        std::chrono::steady_clock::time_point _frameStart;
+        std::array<float, FrameTimesCapacity> _frameTimes;
+        size_t _frameTimesCount;
+        size_t _frameTimesNext;
+
+        // The percentiles of the time from a key press to the frame with its echo,
+        // in milliseconds, as measured by the owner of this engine.
+        float _inputLatencyP50;
+        float _inputLatencyP99;
+        size_t _inputLatencyCount;
+
+        // Further lines for the statistics overlay, formatted by the owner of this engine.
+        std::vector<std::wstring> _paneStatistics;
+
         uint16_t _hyperlinkHoveredId;
 
         bool _firstFrame;
@@ -176,6 +230,25 @@ namespace Microsoft::Console::Render
         til::point _invalidScroll;
         bool _allInvalid;
 
+        // The text is drawn into a layer of its own, which is then composed
+        // into the back buffer, with the selection and the cursor on top.
+        // _invalidMap holds every cell that has to be composed again, while
+        // _textInvalidMap only holds those whose text has to be redrawn. A
+        // cursor blink or a selection change thus only costs the composition.
+        til::pmr::bitmap _textInvalidMap;
+        std::vector<D2D1_RECT_F> _selectionRects;
+        std::optional<CursorOptions> _overlayCursor;
+        bool _cursorInTextLayer{ false };
+
+        // The gridlines of the frame, in the pixels they cover, see _FlushGridLines.
+        struct GridLine
+        {
+            COLORREF color;
+            bool dashed;
+            D2D1_RECT_F rect;
+        };
+        std::vector<GridLine> _gridLines;
+
         bool _presentReady;
         std::vector<RECT> _presentDirty;
         RECT _presentScroll;
@@ -210,6 +283,8 @@ namespace Microsoft::Console::Render
         ::Microsoft::WRL::ComPtr<ID2D1Device> _d2dDevice;
         ::Microsoft::WRL::ComPtr<ID2D1DeviceContext> _d2dDeviceContext;
         ::Microsoft::WRL::ComPtr<ID2D1Bitmap1> _d2dBitmap;
+        ::Microsoft::WRL::ComPtr<ID2D1Bitmap1> _textLayer;
+        ::Microsoft::WRL::ComPtr<ID2D1Bitmap1> _textLayerScratch;
         ::Microsoft::WRL::ComPtr<ID2D1SolidColorBrush> _d2dBrushForeground;
         ::Microsoft::WRL::ComPtr<ID2D1SolidColorBrush> _d2dBrushBackground;
 
@@ -238,6 +313,7 @@ namespace Microsoft::Console::Render
         //  Allows user to load a pixel shader from a few presets or from a file path
         std::wstring _pixelShaderPath;
         bool _pixelShaderLoaded{ false };
+        bool _pixelShaderUsesTime{ true };
 
         std::chrono::steady_clock::time_point _shaderStartTime;
 
@@ -254,6 +330,31 @@ namespace Microsoft::Console::Render
         // Preferences and overrides
         bool _softwareRendering;
         bool _forceFullRepaintRendering;
+        bool _glyphAtlasEnabled;
+        bool _builtinGlyphsEnabled;
+
+        // In smooth scrolling mode the swap chain is a row taller than the
+        // control, and the swap chain's transform moves it up by the fraction
+        // of a row we're scrolled by. That happens on the GPU, without
+        // repainting anything but the extra row it reveals.
+        bool _smoothScrolling{ false };
+        float _subRowScrollOffset{ 0.0f };
+        float _appliedSubRowScrollOffset{ 0.0f };
+
+        GlyphAtlas _glyphAtlas;
+        BuiltinGlyphs _builtinGlyphs;
+
+        // Inline images that were uploaded to the GPU, by image id. Once there
+        // are more than _maxImageBitmaps, the ones that weren't painted in the
+        // current frame are released whenever another one needs to be uploaded.
+        struct ImageBitmap
+        {
+            ::Microsoft::WRL::ComPtr<ID2D1Bitmap1> bitmap;
+            uint64_t lastFrame = 0;
+        };
+        static constexpr size_t _maxImageBitmaps = 32;
+        std::unordered_map<uint64_t, ImageBitmap> _imageBitmaps;
+        uint64_t _imageFrame = 0;
 
         D2D1_TEXT_ANTIALIAS_MODE _antialiasingMode;
 
@@ -282,10 +383,22 @@ namespace Microsoft::Console::Render
         void _ComputePixelShaderSettings() noexcept;
 
         [[nodiscard]] HRESULT _PrepareRenderTarget() noexcept;
+        [[nodiscard]] HRESULT _UpdateSwapChainTransform() noexcept;
 
         void _ReleaseDeviceResources() noexcept;
 
         bool _ShouldForceGrayscaleAA() noexcept;
+        bool _CanUseGlyphAtlas(const COORD coord) const noexcept;
+        bool _CanUseBuiltinGlyphs(const COORD coord) const noexcept;
+
+        void _RecordFrameTime() noexcept;
+        til::rectangle _GetFrameStatisticsOverlayCells() const;
+        [[nodiscard]] HRESULT _PaintFrameStatisticsOverlay() noexcept;
+
+        [[nodiscard]] HRESULT _PaintBufferLineText(gsl::span<const Cluster> const clusters,
+                                                   COORD const coord) noexcept;
+        [[nodiscard]] HRESULT _PaintBuiltinGlyphs(gsl::span<const Cluster> const clusters,
+                                                  COORD const coord) noexcept;
 
         [[nodiscard]] HRESULT _CreateTextLayout(
             _In_reads_(StringLength) PCWCHAR String,
@@ -299,7 +412,14 @@ namespace Microsoft::Console::Render
         [[nodiscard]] til::size _GetClientSize() const;
 
         void _InvalidateRectangle(const til::rectangle& rc);
+        void _InvalidateOverlayRectangle(const til::rectangle& rc);
         bool _IsAllInvalid() const noexcept;
+        bool _IsTextInvalid(const COORD coord) const;
+        static bool _IsOverlayCursor(const CursorOptions& options) noexcept;
+
+        [[nodiscard]] HRESULT _ScrollTextLayer() noexcept;
+        [[nodiscard]] HRESULT _ComposeFrame() noexcept;
+        [[nodiscard]] HRESULT _FlushGridLines() noexcept;
 
         [[nodiscard]] D2D1_COLOR_F _ColorFFromColorRef(const COLORREF color) noexcept;
 
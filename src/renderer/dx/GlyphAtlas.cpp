@@ -0,0 +1,429 @@
+// Copyright (c) Microsoft Corporation.
+// Licensed under the MIT license.
+
+#include "precomp.h"
+
+#include "GlyphAtlas.h"
+
+using namespace Microsoft::Console::Render;
+using namespace Microsoft::WRL;
+
+// The atlas doesn't need to be larger than this to hold every glyph a
+// terminal is likely to show at once, even at small font sizes.
+static constexpr UINT32 MaxAtlasSize = 2048;
+
+// Routine Description:
+// - Picks up the primary font from the given font render data and drops all
+//   glyphs rasterized with the previous one.
+// Arguments:
+// - fontRenderData - the font DxEngine draws with
+// Return Value:
+// - <none>
+void GlyphAtlas::SetFont(DxFontRenderData& fontRenderData)
+{
+    const auto format = fontRenderData.DefaultTextFormat();
+    DWRITE_LINE_SPACING_METHOD method;
+    float height;
+    THROW_IF_FAILED(format->GetLineSpacing(&method, &height, &_baseline));
+
+    _fontFace = fontRenderData.DefaultFontFace();
+    _fontEmSize = format->GetFontSize();
+
+    DWRITE_FONT_METRICS1 metrics;
+    _fontFace->GetMetrics(&metrics);
+    _designUnitsToPixels = _fontEmSize / metrics.designUnitsPerEm;
+
+    const auto cell = fontRenderData.GlyphCell();
+    _cellSize = { cell.width<UINT32>(), cell.height<UINT32>() };
+
+    // Features the user picked (like stylistic sets) change which glyph a character
+    // maps to, and ligatures change it depending on the neighboring characters.
+    // Neither can be looked up from a single character, so leave those fonts to DxEngine.
+    _fontSupported = _cellSize.width != 0 &&
+                     _cellSize.height != 0 &&
+                     _cellSize.width <= MaxAtlasSize &&
+                     _cellSize.height <= MaxAtlasSize &&
+                     !fontRenderData.DidUserSetFeatures() &&
+                     !s_HasLigatures(_fontFace.Get(), fontRenderData.DefaultFontFeatures());
+
+    // The slots are sized to the cells, so the atlas has to be created anew.
+    _atlas.Reset();
+    _ClearGlyphs();
+}
+
+// Routine Description:
+// - Sets the antialiasing mode glyphs are rasterized with.
+// - ClearType isn't supported, as the atlas is transparent.
+// Arguments:
+// - mode - grayscale or aliased
+// Return Value:
+// - <none>
+void GlyphAtlas::SetTextAntialiasMode(const D2D1_TEXT_ANTIALIAS_MODE mode) noexcept
+{
+    if (_textAntialiasMode != mode)
+    {
+        // The queued sprites refer to glyphs rasterized with the old mode.
+        LOG_IF_FAILED(Flush());
+        _textAntialiasMode = mode;
+        _ClearGlyphs();
+    }
+}
+
+// Routine Description:
+// - Releases all device resources. They're recreated on the next AppendClusters().
+// Arguments:
+// - <none>
+// Return Value:
+// - <none>
+void GlyphAtlas::Reset() noexcept
+{
+    _deviceContext.Reset();
+    _spriteBatch.Reset();
+    _atlas.Reset();
+    _whiteBrush.Reset();
+    _deviceSupported = true;
+    _ClearGlyphs();
+
+    _destinations.clear();
+    _sources.clear();
+    _colors.clear();
+}
+
+// Routine Description:
+// - Queues the given clusters to be drawn from the atlas at the next Flush(),
+//   rasterizing any glyphs that aren't in the atlas yet.
+// - The clusters are only queued if the atlas can draw all of them.
+// Arguments:
+// - deviceContext - the device context DxEngine draws into
+// - clusters - the text to draw
+// - origin - the top left corner of the first cluster in pixels
+// - color - the color to draw the text in
+// Return Value:
+// - S_OK if the clusters were queued, S_FALSE if they have to be drawn by DxEngine,
+//   or a relevant DirectX error
+[[nodiscard]] HRESULT GlyphAtlas::AppendClusters(ID2D1DeviceContext* const deviceContext,
+                                                 const gsl::span<const Cluster> clusters,
+                                                 const D2D1_POINT_2F origin,
+                                                 const D2D1_COLOR_F color) noexcept
+try
+{
+    if (!_fontSupported)
+    {
+        return S_FALSE;
+    }
+
+    RETURN_IF_FAILED(_EnsureDeviceResources(deviceContext));
+    if (!_deviceSupported)
+    {
+        return S_FALSE;
+    }
+
+    // Should the atlas run full, _GetGlyph() flushes the sprites queued so far,
+    // including those of the clusters before the current one. That's fine, since
+    // DxEngine paints the background of the line before calling us.
+    const auto firstSprite = _destinations.size();
+    const auto decline = [&]() noexcept {
+        const auto count = std::min(firstSprite, _destinations.size());
+        _destinations.resize(count);
+        _sources.resize(count);
+        _colors.resize(count);
+        return S_FALSE;
+    };
+
+    auto left = origin.x;
+    for (const auto& cluster : clusters)
+    {
+        const auto text = cluster.GetText();
+        if (text.size() != 1 || cluster.GetColumns() != 1)
+        {
+            return decline();
+        }
+
+        const auto ch = til::at(text, 0);
+        if (ch != L' ')
+        {
+            GlyphEntry entry;
+            RETURN_IF_FAILED(_GetGlyph(ch, entry));
+            if (!entry)
+            {
+                return decline();
+            }
+
+            _destinations.push_back({ left, origin.y, left + _cellSize.width, origin.y + _cellSize.height });
+            _sources.push_back(*entry);
+            _colors.push_back(color);
+        }
+
+        left += _cellSize.width;
+    }
+
+    return S_OK;
+}
+CATCH_RETURN()
+
+// Routine Description:
+// - Draws all the clusters queued by AppendClusters() in one go.
+// - This has to be called before anything else is drawn on top of them.
+// Arguments:
+// - <none>
+// Return Value:
+// - S_OK or relevant DirectX error
+[[nodiscard]] HRESULT GlyphAtlas::Flush() noexcept
+{
+    if (_destinations.empty())
+    {
+        return S_OK;
+    }
+
+    const auto clearSprites = wil::scope_exit([&]() noexcept {
+        _destinations.clear();
+        _sources.clear();
+        _colors.clear();
+    });
+
+    RETURN_IF_FAILED(_spriteBatch->AddSprites(gsl::narrow_cast<UINT32>(_destinations.size()),
+                                              _destinations.data(),
+                                              _sources.data(),
+                                              _colors.data(),
+                                              nullptr,
+                                              sizeof(D2D1_RECT_F),
+                                              sizeof(D2D1_RECT_U),
+                                              sizeof(D2D1_COLOR_F),
+                                              0));
+
+    // Sprite batches can only be drawn aliased, which is what DxEngine uses anyways.
+    const auto antialiasMode = _deviceContext->GetAntialiasMode();
+    _deviceContext->SetAntialiasMode(D2D1_ANTIALIAS_MODE_ALIASED);
+    _deviceContext->DrawSpriteBatch(_spriteBatch.Get(), _atlas.Get(), D2D1_BITMAP_INTERPOLATION_MODE_NEAREST_NEIGHBOR, D2D1_SPRITE_OPTIONS_NONE);
+    _deviceContext->SetAntialiasMode(antialiasMode);
+
+    _spriteBatch->Clear();
+    return S_OK;
+}
+
+// Routine Description:
+// - Creates the sprite batch and the atlas bitmap, if they don't exist yet.
+// - Sprite batches need Windows 10 1607. If they're unavailable, _deviceSupported
+//   is cleared and the atlas declines to draw anything.
+// Arguments:
+// - deviceContext - the device context DxEngine draws into
+// Return Value:
+// - S_OK or relevant DirectX error
+[[nodiscard]] HRESULT GlyphAtlas::_EnsureDeviceResources(ID2D1DeviceContext* const deviceContext) noexcept
+try
+{
+    if (!_deviceSupported)
+    {
+        return S_OK;
+    }
+
+    if (!_deviceContext)
+    {
+        if (FAILED(deviceContext->QueryInterface(IID_PPV_ARGS(&_deviceContext))))
+        {
+            _deviceSupported = false;
+            return S_OK;
+        }
+
+        RETURN_IF_FAILED(_deviceContext->CreateSpriteBatch(&_spriteBatch));
+        RETURN_IF_FAILED(_deviceContext->CreateSolidColorBrush(D2D1::ColorF(D2D1::ColorF::White), &_whiteBrush));
+    }
+
+    if (!_atlas)
+    {
+        const auto size = std::min(MaxAtlasSize, _deviceContext->GetMaximumBitmapSize());
+        _slotsPerRow = size / _cellSize.width;
+        _slotCount = _slotsPerRow * (size / _cellSize.height);
+
+        const auto properties = D2D1::BitmapProperties1(D2D1_BITMAP_OPTIONS_TARGET,
+                                                        D2D1::PixelFormat(DXGI_FORMAT_B8G8R8A8_UNORM, D2D1_ALPHA_MODE_PREMULTIPLIED));
+        RETURN_IF_FAILED(_deviceContext->CreateBitmap(D2D1::SizeU(_slotsPerRow * _cellSize.width, (_slotCount / _slotsPerRow) * _cellSize.height),
+                                                      nullptr,
+                                                      0,
+                                                      properties,
+                                                      &_atlas));
+        _ClearGlyphs();
+    }
+
+    return S_OK;
+}
+CATCH_RETURN()
+
+// Routine Description:
+// - Looks up the atlas slot of the given character, rasterizing it if it isn't in the atlas yet.
+// - If the atlas is full, everything queued so far is flushed and the atlas starts over.
+// Arguments:
+// - ch - the character to look up
+// - entry - receives the slot, or nullopt if the character can't be drawn from the atlas
+// Return Value:
+// - S_OK or relevant DirectX error
+[[nodiscard]] HRESULT GlyphAtlas::_GetGlyph(const wchar_t ch, GlyphEntry& entry)
+{
+    if (const auto it = _glyphs.find(ch); it != _glyphs.end())
+    {
+        entry = it->second;
+        return S_OK;
+    }
+
+    entry = std::nullopt;
+
+    // Surrogates and box drawing characters (which DxEngine stretches to fill the cell) are left to DxEngine.
+    const auto codepoint = gsl::narrow_cast<UINT32>(ch);
+    if (IS_HIGH_SURROGATE(ch) || IS_LOW_SURROGATE(ch) || (ch >= 0x2500 && ch <= 0x259F))
+    {
+        _glyphs.emplace(ch, entry);
+        return S_OK;
+    }
+
+    // Characters missing from the primary font need font fallback.
+    UINT16 glyphIndex = 0;
+    RETURN_IF_FAILED(_fontFace->GetGlyphIndicesW(&codepoint, 1, &glyphIndex));
+
+    DWRITE_GLYPH_METRICS metrics{};
+    if (glyphIndex != 0)
+    {
+        RETURN_IF_FAILED(_fontFace->GetDesignGlyphMetrics(&glyphIndex, 1, &metrics, FALSE));
+    }
+
+    // Glyphs wider than a cell would have to be scaled down, which is what DxEngine does.
+    const auto advance = metrics.advanceWidth * _designUnitsToPixels;
+    if (glyphIndex == 0 || advance > _cellSize.width + 0.5f)
+    {
+        _glyphs.emplace(ch, entry);
+        return S_OK;
+    }
+
+    if (_nextSlot == _slotCount)
+    {
+        RETURN_IF_FAILED(Flush());
+        _ClearGlyphs();
+    }
+
+    const auto slot = _nextSlot++;
+    const auto left = (slot % _slotsPerRow) * _cellSize.width;
+    const auto top = (slot / _slotsPerRow) * _cellSize.height;
+    const D2D1_RECT_U source{ left, top, left + _cellSize.width, top + _cellSize.height };
+
+    RETURN_IF_FAILED(_RasterizeGlyph(glyphIndex, advance, source));
+
+    entry = source;
+    _glyphs.emplace(ch, entry);
+    return S_OK;
+}
+
+// Routine Description:
+// - Draws the given glyph in white into the given slot of the atlas.
+// Arguments:
+// - glyphIndex - the glyph to draw
+// - advance - the width of the glyph in pixels, used to center it in the cell
+// - slot - where to draw the glyph
+// Return Value:
+// - S_OK or relevant DirectX error
+[[nodiscard]] HRESULT GlyphAtlas::_RasterizeGlyph(const UINT16 glyphIndex, const float advance, const D2D1_RECT_U& slot) noexcept
+{
+    ComPtr<ID2D1Image> target;
+    _deviceContext->GetTarget(&target);
+    D2D1_MATRIX_3X2_F transform;
+    _deviceContext->GetTransform(&transform);
+    const auto textAntialiasMode = _deviceContext->GetTextAntialiasMode();
+
+    const auto restoreState = wil::scope_exit([&]() noexcept {
+        _deviceContext->SetTarget(target.Get());
+        _deviceContext->SetTransform(transform);
+        _deviceContext->SetTextAntialiasMode(textAntialiasMode);
+    });
+
+    _deviceContext->SetTarget(_atlas.Get());
+    _deviceContext->SetTransform(D2D1::Matrix3x2F::Identity());
+    _deviceContext->SetTextAntialiasMode(_textAntialiasMode);
+
+    const D2D1_RECT_F rect{
+        gsl::narrow_cast<float>(slot.left),
+        gsl::narrow_cast<float>(slot.top),
+        gsl::narrow_cast<float>(slot.right),
+        gsl::narrow_cast<float>(slot.bottom),
+    };
+    _deviceContext->PushAxisAlignedClip(rect, D2D1_ANTIALIAS_MODE_ALIASED);
+    _deviceContext->Clear(D2D1::ColorF(0, 0));
+
+    DWRITE_GLYPH_RUN glyphRun{};
+    glyphRun.fontFace = _fontFace.Get();
+    glyphRun.fontEmSize = _fontEmSize;
+    glyphRun.glyphCount = 1;
+    glyphRun.glyphIndices = &glyphIndex;
+
+    const D2D1_POINT_2F baselineOrigin{ rect.left + (_cellSize.width - advance) / 2.0f, rect.top + _baseline };
+    _deviceContext->DrawGlyphRun(baselineOrigin, &glyphRun, _whiteBrush.Get(), DWRITE_MEASURING_MODE_NATURAL);
+
+    _deviceContext->PopAxisAlignedClip();
+    return S_OK;
+}
+
+void GlyphAtlas::_ClearGlyphs() noexcept
+{
+    _glyphs.clear();
+    _nextSlot = 0;
+}
+
+// Routine Description:
+// - Checks whether any of the enabled ligature features exists in the font's GSUB table.
+// Arguments:
+// - fontFace - the font to check
+// - features - the font features DxEngine shapes text with
+// Return Value:
+// - true if the font might substitute ligatures for sequences of characters
+bool GlyphAtlas::s_HasLigatures(IDWriteFontFace* const fontFace, const std::vector<DWRITE_FONT_FEATURE>& features)
+{
+    static constexpr std::array ligatureTags{
+        DWRITE_FONT_FEATURE_TAG_STANDARD_LIGATURES,
+        DWRITE_FONT_FEATURE_TAG_CONTEXTUAL_LIGATURES,
+        DWRITE_FONT_FEATURE_TAG_CONTEXTUAL_ALTERNATES,
+        DWRITE_FONT_FEATURE_TAG_REQUIRED_LIGATURES,
+        DWRITE_FONT_FEATURE_TAG_DISCRETIONARY_LIGATURES,
+    };
+
+    const void* data = nullptr;
+    UINT32 size = 0;
+    void* context = nullptr;
+    BOOL exists = FALSE;
+    THROW_IF_FAILED(fontFace->TryGetFontTable(DWRITE_MAKE_OPENTYPE_TAG('G', 'S', 'U', 'B'), &data, &size, &context, &exists));
+    if (!exists)
+    {
+        return false;
+    }
+    const auto releaseTable = wil::scope_exit([&]() noexcept { fontFace->ReleaseFontTable(context); });
+
+    // OpenType tables are big-endian. The GSUB header stores the offset of the
+    // FeatureList at byte 6, which starts with a count of 6 byte FeatureRecords,
+    // each consisting of a 4 byte tag followed by a 2 byte offset.
+    const auto table = gsl::make_span(static_cast<const uint8_t*>(data), size);
+    const auto readU16 = [&](const size_t offset) -> size_t {
+        return offset + 2 <= table.size() ? (size_t{ til::at(table, offset) } << 8) | til::at(table, offset + 1) : 0;
+    };
+
+    const auto featureList = readU16(6);
+    const auto featureCount = readU16(featureList);
+    for (size_t i = 0; i < featureCount; ++i)
+    {
+        const auto record = featureList + 2 + i * 6;
+        if (record + 4 > table.size())
+        {
+            break;
+        }
+
+        const auto tag = static_cast<DWRITE_FONT_FEATURE_TAG>(DWRITE_MAKE_OPENTYPE_TAG(til::at(table, record), til::at(table, record + 1), til::at(table, record + 2), til::at(table, record + 3)));
+        if (std::find(ligatureTags.begin(), ligatureTags.end(), tag) == ligatureTags.end())
+        {
+            continue;
+        }
+
+        // Required ligatures are always applied, the others only if they're enabled.
+        const auto feature = std::find_if(features.begin(), features.end(), [&](const auto& f) { return f.nameTag == tag; });
+        if (tag == DWRITE_FONT_FEATURE_TAG_REQUIRED_LIGATURES || (feature != features.end() && feature->parameter != 0))
+        {
+            return true;
+        }
+    }
+
+    return false;
+}
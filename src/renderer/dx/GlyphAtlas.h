@@ -0,0 +1,71 @@
+// Copyright (c) Microsoft Corporation.
+// Licensed under the MIT license.
+
+#pragma once
+
+#include <dwrite_1.h>
+#include <d2d1_3.h>
+
+#include <wrl.h>
+
+#include "DxFontRenderData.h"
+#include "../inc/Cluster.hpp"
+
+namespace Microsoft::Console::Render
+{
+    // GlyphAtlas is a fast path for DxEngine::PaintBufferLine. It rasterizes each
+    // glyph it's asked for into a cell sized slot of a bitmap once, and then draws
+    // all the text it was handed during a frame with a single sprite batch.
+    //
+    // It only handles the simple case: one UTF-16 code unit per cell, drawn with
+    // the regular face of the primary font, which must not use any ligatures.
+    // Everything else is declined, so that DxEngine can lay it out as usual.
+    class GlyphAtlas
+    {
+    public:
+        void SetFont(DxFontRenderData& fontRenderData);
+        void SetTextAntialiasMode(const D2D1_TEXT_ANTIALIAS_MODE mode) noexcept;
+        void Reset() noexcept;
+
+        [[nodiscard]] HRESULT AppendClusters(ID2D1DeviceContext* const deviceContext,
+                                             const gsl::span<const Cluster> clusters,
+                                             const D2D1_POINT_2F origin,
+                                             const D2D1_COLOR_F color) noexcept;
+        [[nodiscard]] HRESULT Flush() noexcept;
+
+    private:
+        // The source rectangle of a glyph in _atlas, or nullopt if it can't be drawn from the atlas.
+        using GlyphEntry = std::optional<D2D1_RECT_U>;
+
+        [[nodiscard]] HRESULT _EnsureDeviceResources(ID2D1DeviceContext* const deviceContext) noexcept;
+        [[nodiscard]] HRESULT _GetGlyph(const wchar_t ch, GlyphEntry& entry);
+        [[nodiscard]] HRESULT _RasterizeGlyph(const UINT16 glyphIndex, const float advance, const D2D1_RECT_U& slot) noexcept;
+        void _ClearGlyphs() noexcept;
+
+        static bool s_HasLigatures(IDWriteFontFace* const fontFace, const std::vector<DWRITE_FONT_FEATURE>& features);
+
+        ::Microsoft::WRL::ComPtr<IDWriteFontFace1> _fontFace;
+        float _fontEmSize{ 0 };
+        float _baseline{ 0 };
+        float _designUnitsToPixels{ 0 };
+        D2D1_SIZE_U _cellSize{};
+        bool _fontSupported{ false };
+        D2D1_TEXT_ANTIALIAS_MODE _textAntialiasMode{ D2D1_TEXT_ANTIALIAS_MODE_GRAYSCALE };
+
+        ::Microsoft::WRL::ComPtr<ID2D1DeviceContext3> _deviceContext;
+        ::Microsoft::WRL::ComPtr<ID2D1SpriteBatch> _spriteBatch;
+        ::Microsoft::WRL::ComPtr<ID2D1Bitmap1> _atlas;
+        ::Microsoft::WRL::ComPtr<ID2D1SolidColorBrush> _whiteBrush;
+        bool _deviceSupported{ true };
+        UINT32 _slotsPerRow{ 0 };
+        UINT32 _slotCount{ 0 };
+        UINT32 _nextSlot{ 0 };
+
+        std::unordered_map<wchar_t, GlyphEntry> _glyphs;
+
+        // The sprites appended since the last Flush().
+        std::vector<D2D1_RECT_F> _destinations;
+        std::vector<D2D1_RECT_U> _sources;
+        std::vector<D2D1_COLOR_F> _colors;
+    };
+}
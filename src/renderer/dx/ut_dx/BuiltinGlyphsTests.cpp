@@ -0,0 +1,78 @@
+﻿// Copyright (c) Microsoft Corporation.
+// Licensed under the MIT license.
+
+#include "precomp.h"
+#include "WexTestClass.h"
+#include "../../inc/consoletaeftemplates.hpp"
+
+#include "../BuiltinGlyphs.h"
+
+using namespace WEX::Common;
+using namespace WEX::Logging;
+using namespace WEX::TestExecution;
+
+using namespace Microsoft::Console::Render;
+
+class Microsoft::Console::Render::BuiltinGlyphsTests
+{
+    TEST_CLASS(BuiltinGlyphsTests);
+
+    static void VerifyRectangle(const D2D1_RECT_F& expected, const D2D1_RECT_F& actual)
+    {
+        VERIFY_ARE_EQUAL(expected.left, actual.left);
+        VERIFY_ARE_EQUAL(expected.top, actual.top);
+        VERIFY_ARE_EQUAL(expected.right, actual.right);
+        VERIFY_ARE_EQUAL(expected.bottom, actual.bottom);
+    }
+
+    TEST_METHOD(IsBuiltinGlyph)
+    {
+        VERIFY_IS_TRUE(BuiltinGlyphs::IsBuiltinGlyph(L'─'));
+        VERIFY_IS_TRUE(BuiltinGlyphs::IsBuiltinGlyph(L'╬'));
+        VERIFY_IS_TRUE(BuiltinGlyphs::IsBuiltinGlyph(L'█'));
+        VERIFY_IS_TRUE(BuiltinGlyphs::IsBuiltinGlyph(L'\xE0B0'));
+
+        Log::Comment(L"Dashed lines, arcs and diagonals are left to the font.");
+        VERIFY_IS_FALSE(BuiltinGlyphs::IsBuiltinGlyph(L'┄'));
+        VERIFY_IS_FALSE(BuiltinGlyphs::IsBuiltinGlyph(L'╭'));
+        VERIFY_IS_FALSE(BuiltinGlyphs::IsBuiltinGlyph(L'╳'));
+        VERIFY_IS_FALSE(BuiltinGlyphs::IsBuiltinGlyph(L'A'));
+    }
+
+    TEST_METHOD(LinesMeetInTheMiddle)
+    {
+        BuiltinGlyphs glyphs;
+        glyphs.SetCellSize({ 8.0f, 16.0f });
+
+        Log::Comment(L"A horizontal line is made of a left and a right half.");
+        BuiltinGlyphs::Glyph horizontal;
+        VERIFY_SUCCEEDED(glyphs._BuildGlyph(nullptr, L'─', horizontal));
+        VERIFY_ARE_EQUAL(2u, horizontal.rectangles.size());
+        VerifyRectangle({ 4, 7, 8, 8 }, horizontal.rectangles.at(0));
+        VerifyRectangle({ 0, 7, 4, 8 }, horizontal.rectangles.at(1));
+
+        Log::Comment(L"A corner's lines overlap where they meet.");
+        BuiltinGlyphs::Glyph corner;
+        VERIFY_SUCCEEDED(glyphs._BuildGlyph(nullptr, L'┌', corner));
+        VERIFY_ARE_EQUAL(2u, corner.rectangles.size());
+        VerifyRectangle({ 3, 7, 8, 8 }, corner.rectangles.at(0));
+        VerifyRectangle({ 3, 7, 4, 16 }, corner.rectangles.at(1));
+    }
+
+    TEST_METHOD(BlockElements)
+    {
+        BuiltinGlyphs glyphs;
+        glyphs.SetCellSize({ 8.0f, 16.0f });
+
+        BuiltinGlyphs::Glyph upperHalf;
+        VERIFY_SUCCEEDED(glyphs._BuildGlyph(nullptr, L'▀', upperHalf));
+        VERIFY_ARE_EQUAL(1u, upperHalf.rectangles.size());
+        VerifyRectangle({ 0, 0, 8, 8 }, upperHalf.rectangles.at(0));
+
+        BuiltinGlyphs::Glyph shade;
+        VERIFY_SUCCEEDED(glyphs._BuildGlyph(nullptr, L'▒', shade));
+        VERIFY_ARE_EQUAL(1u, shade.rectangles.size());
+        VerifyRectangle({ 0, 0, 8, 16 }, shade.rectangles.at(0));
+        VERIFY_ARE_EQUAL(0.5f, shade.opacity);
+    }
+};
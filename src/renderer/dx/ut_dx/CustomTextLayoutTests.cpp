@@ -97,4 +97,117 @@ class Microsoft::Console::Render::CustomTextLayoutTests
         VERIFY_ARE_EQUAL(1u, layout._runs.at(1).glyphStart);
         VERIFY_ARE_EQUAL(3u, layout._runs.at(1).glyphCount);
     }
+
+    TEST_METHOD(ShapingCacheRestoresGlyphs)
+    {
+        CustomTextLayout layout;
+
+        layout._text = L"ab";
+        layout._textClusterColumns = { 1, 1 };
+        layout._glyphIndices = { 68, 69 };
+        layout._glyphAdvances = { 8.0f, 8.0f };
+        layout._glyphClusters = { 0, 1 };
+        layout._glyphOffsets.resize(2);
+        layout._runs.resize(1);
+
+        Log::Comment(L"Cache the shaped text as if it was just drawn.");
+        layout._BuildShapingCacheKey(false, false);
+        VERIFY_IS_FALSE(layout._LoadShapedText());
+        layout._StoreShapedText();
+
+        layout._glyphIndices.clear();
+        layout._glyphAdvances.clear();
+        layout._runs.clear();
+
+        Log::Comment(L"The same text with other attributes must not hit the cache.");
+        layout._BuildShapingCacheKey(true, false);
+        VERIFY_IS_FALSE(layout._LoadShapedText());
+
+        Log::Comment(L"The same text with the same attributes restores the glyphs.");
+        layout._BuildShapingCacheKey(false, false);
+        VERIFY_IS_TRUE(layout._LoadShapedText());
+        VERIFY_ARE_EQUAL(2u, layout._glyphIndices.size());
+        VERIFY_ARE_EQUAL(69u, layout._glyphIndices.at(1));
+        VERIFY_ARE_EQUAL(8.0f, layout._glyphAdvances.at(0));
+        VERIFY_ARE_EQUAL(1u, layout._runs.size());
+
+        Log::Comment(L"The same text spread over other columns must not hit the cache.");
+        layout._textClusterColumns = { 2, 1 };
+        layout._BuildShapingCacheKey(false, false);
+        VERIFY_IS_FALSE(layout._LoadShapedText());
+    }
+
+    TEST_METHOD(ShapingCacheEvictsLeastRecentlyUsed)
+    {
+        CustomTextLayout layout;
+        layout._textClusterColumns = { 1 };
+
+        const auto store = [&](const wchar_t ch) {
+            layout._text = std::wstring(1, ch);
+            layout._BuildShapingCacheKey(false, false);
+            layout._StoreShapedText();
+        };
+        const auto load = [&](const wchar_t ch) {
+            layout._text = std::wstring(1, ch);
+            layout._BuildShapingCacheKey(false, false);
+            return layout._LoadShapedText();
+        };
+
+        for (size_t i = 0; i < CustomTextLayout::_shapingCacheCapacity; ++i)
+        {
+            store(gsl::narrow_cast<wchar_t>(L'A' + i));
+        }
+
+        Log::Comment(L"Touch the oldest entry, so that the second oldest one is evicted instead.");
+        VERIFY_IS_TRUE(load(L'A'));
+        store(L'!');
+
+        VERIFY_IS_TRUE(load(L'A'));
+        VERIFY_IS_FALSE(load(L'B'));
+        VERIFY_IS_TRUE(load(L'!'));
+        VERIFY_ARE_EQUAL(CustomTextLayout::_shapingCacheCapacity, layout._shapingCache.size());
+        VERIFY_ARE_EQUAL(CustomTextLayout::_shapingCacheCapacity, layout._shapingCacheMap.size());
+    }
+
+    TEST_METHOD(FallbackCacheKeepsClustersTogether)
+    {
+        CustomTextLayout layout;
+        layout._fontInUse = nullptr;
+
+        const auto attributes = CustomTextLayout::_ToFallbackAttributes(DWRITE_FONT_WEIGHT_NORMAL, DWRITE_FONT_STYLE_NORMAL, DWRITE_FONT_STRETCH_NORMAL);
+        const auto reset = [&](const std::wstring_view text) {
+            layout._text = text;
+            layout._runs.resize(1);
+            layout._runs.front() = {};
+            layout._runs.front().textLength = gsl::narrow<UINT32>(text.size());
+            layout._runIndex = 0;
+        };
+
+        Log::Comment(L"Map the ideograph to a scaled fallback font, and the latin letters to the font in use.");
+        reset(L"a\u4E00b");
+        layout._StoreFallbackMapping(attributes, 0, 1, { nullptr, 1.0f });
+        layout._StoreFallbackMapping(attributes, 1, 1, { nullptr, 0.5f });
+        layout._StoreFallbackMapping(attributes, 2, 1, { nullptr, 1.0f });
+
+        Log::Comment(L"A combining mark is drawn with the font of its base, even though it was never mapped.");
+        reset(L"a\u4E00\u0301b");
+        VERIFY_ARE_EQUAL(4u, layout._MapCharactersFromCache(attributes, 0, 4));
+        layout._OrderRuns();
+        VERIFY_ARE_EQUAL(3u, layout._runs.size());
+        VERIFY_ARE_EQUAL(1u, layout._runs.at(0).textLength);
+        VERIFY_ARE_EQUAL(1.0f, layout._runs.at(0).fontScale);
+        VERIFY_ARE_EQUAL(1u, layout._runs.at(1).textStart);
+        VERIFY_ARE_EQUAL(2u, layout._runs.at(1).textLength);
+        VERIFY_ARE_EQUAL(0.5f, layout._runs.at(1).fontScale);
+        VERIFY_ARE_EQUAL(1.0f, layout._runs.at(2).fontScale);
+
+        Log::Comment(L"The cache stops at the first code point that wasn't mapped yet.");
+        reset(L"ab\u4E8C");
+        VERIFY_ARE_EQUAL(2u, layout._MapCharactersFromCache(attributes, 0, 3));
+
+        Log::Comment(L"Other font attributes don't share the mappings.");
+        reset(L"a");
+        const auto bold = CustomTextLayout::_ToFallbackAttributes(DWRITE_FONT_WEIGHT_BOLD, DWRITE_FONT_STYLE_NORMAL, DWRITE_FONT_STRETCH_NORMAL);
+        VERIFY_ARE_EQUAL(0u, layout._MapCharactersFromCache(bold, 0, 1));
+    }
 };
@@ -66,9 +66,7 @@ namespace Microsoft::Console::Render
                                                    const bool isSettingDefaultBrushes) noexcept override;
         [[nodiscard]] HRESULT UpdateFont(const FontInfoDesired& FontInfoDesired,
                                          _Out_ FontInfo& FontInfo) noexcept override;
-        [[nodiscard]] HRESULT UpdateSoftFont(const gsl::span<const uint16_t> bitPattern,
-                                             const SIZE cellSize,
-                                             const size_t centeringHint) noexcept override;
+        [[nodiscard]] HRESULT UpdateSoftFont(const std::shared_ptr<SoftFontGlyphCache>& glyphCache) noexcept override;
         [[nodiscard]] HRESULT UpdateDpi(const int iDpi) noexcept override;
         [[nodiscard]] HRESULT UpdateViewport(const SMALL_RECT srNewViewport) noexcept override;
 
@@ -92,7 +90,6 @@ namespace Microsoft::Console::Render
 
         bool _fPaintStarted;
 
-        til::rectangle _invalidCharacters;
         PAINTSTRUCT _psInvalidData;
         HDC _hdcMemoryContext;
         bool _isTrueTypeFont;
@@ -102,9 +99,6 @@ namespace Microsoft::Console::Render
         TEXTMETRICW _tmFontMetrics;
         FontResource _softFont;
 
-        static const size_t s_cPolyTextCache = 80;
-        POLYTEXTW _pPolyText[s_cPolyTextCache];
-        size_t _cPolyText;
         [[nodiscard]] HRESULT _FlushBufferLines() noexcept;
 
         std::vector<RECT> cursorInvertRects;
@@ -145,6 +139,12 @@ namespace Microsoft::Console::Render
         };
         FontType _lastFontType;
 
+        // The attributes that the next text runs are drawn with. They're only
+        // selected into the DC once the runs are flushed.
+        COLORREF _runFg;
+        COLORREF _runBg;
+        FontType _runFontType;
+
         XFORM _currentLineTransform;
         LineRendition _currentLineRendition;
 
@@ -155,9 +155,32 @@ namespace Microsoft::Console::Render
         std::pmr::vector<std::pmr::wstring> _polyStrings;
         std::pmr::vector<std::pmr::basic_string<int>> _polyWidths;
 
+        // The text runs of the current frame that haven't been drawn yet.
+        // Every run remembers the colors and font it needs, so that the runs of
+        // all lines can be drawn grouped by their attributes, instead of
+        // flushing them every time the brushes change. The text and widths of
+        // a run are found at its index in _polyStrings and _polyWidths.
+        struct PolyTextRun
+        {
+            POLYTEXTW text;
+            size_t index;
+            COLORREF foreground;
+            COLORREF background;
+            FontType fontType;
+        };
+        std::pmr::vector<PolyTextRun> _polyTextRuns;
+        [[nodiscard]] HRESULT _SelectRunAttributes(const PolyTextRun& run) noexcept;
+
+        // The cells that need to be repainted, including the partial cells of
+        // the gutters. Unlike _rcInvalid, which only bounds the invalid area
+        // for the final BitBlt, this is what the renderer actually repaints.
+        til::pmr::bitmap _invalidMap;
+
         [[nodiscard]] HRESULT _InvalidCombine(const RECT* const prc) noexcept;
         [[nodiscard]] HRESULT _InvalidOffset(const POINT* const ppt) noexcept;
         [[nodiscard]] HRESULT _InvalidRestrict() noexcept;
+        [[nodiscard]] HRESULT _InvalidCombineCells(const RECT* const prc) noexcept;
+        [[nodiscard]] HRESULT _InvalidUpdateMapSize() noexcept;
 
         [[nodiscard]] HRESULT _InvalidateRect(const RECT* const prc) noexcept;
 
@@ -37,6 +37,13 @@ HRESULT GdiEngine::InvalidateScroll(const COORD* const pcoordDelta) noexcept
 
         RETURN_IF_FAILED(_InvalidOffset(&ptDelta));
 
+        // The invalid cells move along with the contents. Only the strip that the scroll exposes needs to be painted anew.
+        try
+        {
+            _invalidMap.translate(til::point{ *pcoordDelta }, true);
+        }
+        CATCH_RETURN();
+
         SIZE szInvalidScrollNew;
         RETURN_IF_FAILED(LongAdd(_szInvalidScroll.cx, ptDelta.x, &szInvalidScrollNew.cx));
         RETURN_IF_FAILED(LongAdd(_szInvalidScroll.cy, ptDelta.y, &szInvalidScrollNew.cy));
@@ -160,8 +167,71 @@ HRESULT GdiEngine::_InvalidCombine(const RECT* const prc) noexcept
     // Ensure invalid areas remain within bounds of window.
     RETURN_IF_FAILED(_InvalidRestrict());
 
+    RETURN_IF_FAILED(_InvalidCombineCells(prc));
+
+    return S_OK;
+}
+
+// Routine Description:
+// - Helper to mark the cells covered by the given rectangle in the invalid map.
+//   Cells that are only partially covered are marked as well.
+// Arguments:
+// - prc - Pixel region (RECT) that should be repainted on the next frame
+// Return Value:
+// - S_OK, S_FALSE if there's no font yet, GDI related failure, or safemath failure.
+HRESULT GdiEngine::_InvalidCombineCells(const RECT* const prc) noexcept
+try
+{
+    RETURN_IF_FAILED(_InvalidUpdateMapSize());
+
+    const COORD coordFontSize = _GetFontSize();
+    RETURN_HR_IF(S_FALSE, coordFontSize.X == 0 || coordFontSize.Y == 0);
+
+    const int fontWidth = coordFontSize.X;
+    const int fontHeight = coordFontSize.Y;
+    const til::rectangle cells{ gsl::narrow_cast<int>(prc->left) / fontWidth,
+                                gsl::narrow_cast<int>(prc->top) / fontHeight,
+                                (gsl::narrow_cast<int>(prc->right) + fontWidth - 1) / fontWidth,
+                                (gsl::narrow_cast<int>(prc->bottom) + fontHeight - 1) / fontHeight };
+
+    const auto clipped = cells & til::rectangle{ _invalidMap.size() };
+    if (!clipped.empty())
+    {
+        _invalidMap.set(clipped);
+    }
+
+    return S_OK;
+}
+CATCH_RETURN();
+
+// Routine Description:
+// - Helper to keep the invalid map the size of the client area in cells,
+//   rounded up to include the gutters. If the size changes, the whole map is
+//   marked as invalid, since the old cells don't line up with the new ones.
+// Arguments:
+// - <none>
+// Return Value:
+// - S_OK, S_FALSE if there's no font yet, GDI related failure, or safemath failure.
+HRESULT GdiEngine::_InvalidUpdateMapSize() noexcept
+try
+{
+    RECT rcClient;
+    RETURN_HR_IF(E_FAIL, !(GetClientRect(_hwndTargetWindow, &rcClient)));
+
+    const COORD coordFontSize = _GetFontSize();
+    RETURN_HR_IF(S_FALSE, coordFontSize.X == 0 || coordFontSize.Y == 0);
+
+    const til::size size{ (gsl::narrow_cast<int>(rcClient.right) + coordFontSize.X - 1) / coordFontSize.X,
+                          (gsl::narrow_cast<int>(rcClient.bottom) + coordFontSize.Y - 1) / coordFontSize.Y };
+    if (size != _invalidMap.size())
+    {
+        _invalidMap.resize(size);
+        _invalidMap.set_all();
+    }
+
     return S_OK;
 }
+CATCH_RETURN();
 
 // Routine Description:
 // - Helper to adjust the invalid region by the given offset such as when a scroll operation occurs.
@@ -31,10 +31,13 @@ using namespace Microsoft::Console::Render;
     RETURN_HR_IF(S_FALSE, (!IsWindowVisible(_hwndTargetWindow) && !_titleChanged));
 
     // At the beginning of a new frame, we have 0 lines ready for painting in PolyTextOut
-    _cPolyText = 0;
+    _polyTextRuns.clear();
+    _polyStrings.clear();
+    _polyWidths.clear();
 
     // Prepare our in-memory bitmap for double-buffered composition.
     RETURN_IF_FAILED(_PrepareMemoryBitmap(_hwndTargetWindow));
+    RETURN_IF_FAILED(_InvalidUpdateMapSize());
 
     // We must use Get and Release DC because BeginPaint/EndPaint can only be called in response to a WM_PAINT message (and may hang otherwise)
     // We'll still use the PAINTSTRUCT for information because it's convenient.
@@ -223,6 +226,7 @@ using namespace Microsoft::Console::Render;
     _rcInvalid = { 0 };
     _fInvalidRectUsed = false;
     _szInvalidScroll = { 0 };
+    _invalidMap.reset_all();
 
     LOG_HR_IF(E_FAIL, !(GdiFlush()));
     LOG_HR_IF(E_FAIL, !(ReleaseDC(_hwndTargetWindow, _psInvalidData.hdc)));
@@ -287,7 +291,29 @@ using namespace Microsoft::Console::Render;
 
     if (_psInvalidData.fErase)
     {
-        RETURN_IF_FAILED(_PaintBackgroundColor(&_psInvalidData.rcPaint));
+        // Only the invalid cells are going to be repainted, so only those may be erased.
+        // Anything else in the bounding rectangle still holds valid contents.
+        const COORD coordFontSize = _GetFontSize();
+        const RECT rcSurface{ 0, 0, _szMemorySurface.cx, _szMemorySurface.cy };
+        try
+        {
+            for (const auto& run : _invalidMap.runs())
+            {
+                RECT rc;
+                rc.left = gsl::narrow_cast<LONG>(run.left() * coordFontSize.X);
+                rc.top = gsl::narrow_cast<LONG>(run.top() * coordFontSize.Y);
+                rc.right = gsl::narrow_cast<LONG>(run.right() * coordFontSize.X);
+                rc.bottom = gsl::narrow_cast<LONG>(run.bottom() * coordFontSize.Y);
+                if (IntersectRect(&rc, &rc, &rcSurface))
+                {
+                    RETURN_IF_FAILED(_PaintBackgroundColor(&rc));
+
+                    // Make sure the final BitBlt copies everything we paint.
+                    UnionRect(&_psInvalidData.rcPaint, &_psInvalidData.rcPaint, &rc);
+                }
+            }
+        }
+        CATCH_RETURN();
     }
 
     return S_OK;
@@ -295,7 +321,8 @@ using namespace Microsoft::Console::Render;
 
 // Routine Description:
 // - Draws one line of the buffer to the screen.
-// - This will now be cached in a PolyText buffer and flushed periodically instead of drawing every individual segment. Note this means that the PolyText buffer must be flushed before some operations (changing the brush color, drawing lines on top of the characters, inverting for cursor/selection, etc.)
+// - This will now be cached in a PolyText buffer and flushed periodically instead of drawing every individual segment. Note this means that the PolyText buffer must be flushed before some operations (drawing lines on top of the characters, inverting for cursor/selection, changing the line transform, etc.)
+// - Changing the brush color doesn't flush the buffer. Every run remembers its colors and font instead, see _FlushBufferLines.
 // Arguments:
 // - clusters - text to be written and columns expected per cluster
 // - coord - character coordinate target to render within viewport
@@ -326,7 +353,9 @@ using namespace Microsoft::Console::Render;
         POINT ptDraw = { 0 };
         RETURN_IF_FAILED(_ScaleByFont(&coord, &ptDraw));
 
-        const auto pPolyTextLine = &_pPolyText[_cPolyText];
+        POLYTEXTW polyText{};
+        const auto pPolyTextLine = &polyText;
+        const auto index = _polyStrings.size();
 
         auto& polyString = _polyStrings.emplace_back();
         polyString.reserve(cchLine);
@@ -337,7 +366,7 @@ using namespace Microsoft::Console::Render;
         polyWidth.reserve(cchLine);
 
         // If we have a soft font, we only use the character's lower 7 bits.
-        const auto softFontCharMask = _lastFontType == FontType::Soft ? L'\x7F' : ~0;
+        const auto softFontCharMask = _runFontType == FontType::Soft ? L'\x7F' : ~0;
 
         // Sum up the total widths the entire line/run is expected to take while
         // copying the pixel widths into a structure to direct GDI how many pixels to use per character.
@@ -401,7 +430,8 @@ using namespace Microsoft::Console::Render;
         const auto topOffset = _currentLineRendition == LineRendition::DoubleHeightBottom ? halfHeight : 0;
         const auto bottomOffset = _currentLineRendition == LineRendition::DoubleHeightTop ? halfHeight : 0;
 
-        pPolyTextLine->lpstr = polyString.data();
+        // lpstr and pdx are filled in by _FlushBufferLines, because the strings
+        // may still move around while _polyStrings and _polyWidths grow.
         pPolyTextLine->n = gsl::narrow<UINT>(polyString.size());
         pPolyTextLine->x = ptDraw.x;
         pPolyTextLine->y = ptDraw.y;
@@ -410,19 +440,13 @@ using namespace Microsoft::Console::Render;
         pPolyTextLine->rcl.top = pPolyTextLine->y + topOffset;
         pPolyTextLine->rcl.right = pPolyTextLine->rcl.left + (SHORT)cchCharWidths;
         pPolyTextLine->rcl.bottom = pPolyTextLine->y + coordFontSize.Y - bottomOffset;
-        pPolyTextLine->pdx = polyWidth.data();
 
         if (trimLeft)
         {
             pPolyTextLine->rcl.left += coordFontSize.X;
         }
 
-        _cPolyText++;
-
-        if (_cPolyText >= s_cPolyTextCache)
-        {
-            LOG_IF_FAILED(_FlushBufferLines());
-        }
+        _polyTextRuns.push_back({ polyText, index, _runFg, _runBg, _runFontType });
 
         return S_OK;
     }
@@ -431,6 +455,10 @@ using namespace Microsoft::Console::Render;
 
 // Routine Description:
 // - Flushes any buffer lines in the PolyTextOut cache by drawing them and freeing the strings.
+// - The runs are drawn grouped by their colors and font, so that each of those
+//   is only selected into the DC once per flush, no matter how many lines
+//   alternate between them. Runs never overlap, since they're clipped to their
+//   own cells, so the order they're drawn in doesn't matter.
 // - See also: PaintBufferLine
 // Arguments:
 // - <none>
@@ -440,12 +468,26 @@ using namespace Microsoft::Console::Render;
 {
     HRESULT hr = S_OK;
 
-    if (_cPolyText > 0)
+    if (!_polyTextRuns.empty())
     {
-        for (size_t i = 0; i != _cPolyText; ++i)
+        // The index keeps the runs of each group in the order they were painted.
+        std::sort(_polyTextRuns.begin(), _polyTextRuns.end(), [](const PolyTextRun& lhs, const PolyTextRun& rhs) {
+            return std::tie(lhs.fontType, lhs.background, lhs.foreground, lhs.index) <
+                   std::tie(rhs.fontType, rhs.background, rhs.foreground, rhs.index);
+        });
+
+        for (const auto& run : _polyTextRuns)
         {
-            const auto& t = _pPolyText[i];
-            if (!ExtTextOutW(_hdcMemoryContext, t.x, t.y, t.uiFlags, &t.rcl, t.lpstr, t.n, t.pdx))
+            hr = _SelectRunAttributes(run);
+            if (FAILED(hr))
+            {
+                break;
+            }
+
+            const auto& t = run.text;
+            const auto& polyString = til::at(_polyStrings, run.index);
+            const auto& polyWidth = til::at(_polyWidths, run.index);
+            if (!ExtTextOutW(_hdcMemoryContext, t.x, t.y, t.uiFlags, &t.rcl, polyString.data(), t.n, polyWidth.data()))
             {
                 hr = E_FAIL;
                 break;
@@ -454,10 +496,7 @@ using namespace Microsoft::Console::Render;
 
         _polyStrings.clear();
         _polyWidths.clear();
-
-        ZeroMemory(_pPolyText, sizeof(_pPolyText));
-
-        _cPolyText = 0;
+        _polyTextRuns.clear();
     }
 
     RETURN_HR(hr);
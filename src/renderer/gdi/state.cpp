@@ -25,22 +25,24 @@ GdiEngine::GdiEngine() :
 #endif
     _iCurrentDpi(s_iBaseDpi),
     _hbitmapMemorySurface(nullptr),
-    _cPolyText(0),
     _fInvalidRectUsed(false),
     _lastFg(INVALID_COLOR),
     _lastBg(INVALID_COLOR),
     _lastFontType(FontType::Default),
+    _runFg(INVALID_COLOR),
+    _runBg(INVALID_COLOR),
+    _runFontType(FontType::Default),
     _currentLineTransform(IDENTITY_XFORM),
     _currentLineRendition(LineRendition::SingleWidth),
     _fPaintStarted(false),
-    _invalidCharacters{},
     _hfont(nullptr),
     _hfontItalic(nullptr),
     _pool{ til::pmr::get_default_resource() }, // It's important the pool is first so it can be given to the others on construction.
     _polyStrings{ &_pool },
-    _polyWidths{ &_pool }
+    _polyWidths{ &_pool },
+    _polyTextRuns{ &_pool },
+    _invalidMap{ &_pool }
 {
-    ZeroMemory(_pPolyText, sizeof(POLYTEXTW) * s_cPolyTextCache);
     _rcInvalid = { 0 };
     _szInvalidScroll = { 0 };
     _szMemorySurface = { 0 };
@@ -79,14 +81,6 @@ GdiEngine::GdiEngine() :
 // - <none>
 GdiEngine::~GdiEngine()
 {
-    for (size_t iPoly = 0; iPoly < _cPolyText; iPoly++)
-    {
-        if (_pPolyText[iPoly].lpstr != nullptr)
-        {
-            delete[] _pPolyText[iPoly].lpstr;
-        }
-    }
-
     if (_hbitmapMemorySurface != nullptr)
     {
         LOG_HR_IF(E_FAIL, !(DeleteObject(_hbitmapMemorySurface)));
@@ -279,23 +273,13 @@ GdiEngine::~GdiEngine()
                                                       const bool usingSoftFont,
                                                       const bool isSettingDefaultBrushes) noexcept
 {
-    RETURN_IF_FAILED(_FlushBufferLines());
-
     RETURN_HR_IF_NULL(HRESULT_FROM_WIN32(ERROR_INVALID_STATE), _hdcMemoryContext);
 
-    // Set the colors for painting text
+    // Remember the colors for painting text. They're applied to the DC
+    // by _FlushBufferLines, for all the runs that use them at once.
     const auto [colorForeground, colorBackground] = pData->GetAttributeColors(textAttributes);
-
-    if (colorForeground != _lastFg)
-    {
-        RETURN_HR_IF(E_FAIL, CLR_INVALID == SetTextColor(_hdcMemoryContext, colorForeground));
-        _lastFg = colorForeground;
-    }
-    if (colorBackground != _lastBg)
-    {
-        RETURN_HR_IF(E_FAIL, CLR_INVALID == SetBkColor(_hdcMemoryContext, colorBackground));
-        _lastBg = colorBackground;
-    }
+    _runFg = colorForeground;
+    _runBg = colorBackground;
 
     if (isSettingDefaultBrushes)
     {
@@ -306,9 +290,35 @@ GdiEngine::~GdiEngine()
         RETURN_IF_FAILED(s_SetWindowLongWHelper(_hwndTargetWindow, GWL_CONSOLE_BKCOLOR, colorBackground));
     }
 
-    // If the font type has changed, select an appropriate font variant or soft font.
+    // Remember the appropriate font variant or soft font as well.
     const auto usingItalicFont = textAttributes.IsItalic();
-    const auto fontType = usingSoftFont ? FontType::Soft : usingItalicFont ? FontType::Italic : FontType::Default;
+    _runFontType = usingSoftFont ? FontType::Soft : usingItalicFont ? FontType::Italic : FontType::Default;
+
+    return S_OK;
+}
+
+// Routine Description:
+// - Selects the colors and font of the given text run into the drawing context,
+//   unless they're already selected.
+// Arguments:
+// - run - The text run that's going to be drawn next.
+// Return Value:
+// - S_OK if set successfully or relevant GDI error via HRESULT.
+[[nodiscard]] HRESULT GdiEngine::_SelectRunAttributes(const PolyTextRun& run) noexcept
+{
+    if (run.foreground != _lastFg)
+    {
+        RETURN_HR_IF(E_FAIL, CLR_INVALID == SetTextColor(_hdcMemoryContext, run.foreground));
+        _lastFg = run.foreground;
+    }
+    if (run.background != _lastBg)
+    {
+        RETURN_HR_IF(E_FAIL, CLR_INVALID == SetBkColor(_hdcMemoryContext, run.background));
+        _lastBg = run.background;
+    }
+
+    // If the font type has changed, select an appropriate font variant or soft font.
+    const auto fontType = run.fontType;
     if (fontType != _lastFontType)
     {
         switch (fontType)
@@ -443,16 +453,12 @@ GdiEngine::~GdiEngine()
 }
 
 // Routine Description:
-// - This method will replace the active soft font with the given bit pattern.
+// - This method will replace the active soft font with the given glyphs.
 // Arguments:
-// - bitPattern - An array of scanlines representing all the glyphs in the font.
-// - cellSize - The cell size for an individual glyph.
-// - centeringHint - The horizontal extent that glyphs are offset from center.
+// - glyphCache - The shared glyphs of the soft font, or nullptr if there's none.
 // Return Value:
 // - S_OK if successful. E_FAIL if there was an error.
-[[nodiscard]] HRESULT GdiEngine::UpdateSoftFont(const gsl::span<const uint16_t> bitPattern,
-                                                const SIZE cellSize,
-                                                const size_t centeringHint) noexcept
+[[nodiscard]] HRESULT GdiEngine::UpdateSoftFont(const std::shared_ptr<SoftFontGlyphCache>& glyphCache) noexcept
 {
     // If the soft font is currently selected, replace it with the default font.
     if (_lastFontType == FontType::Soft)
@@ -461,8 +467,8 @@ GdiEngine::~GdiEngine()
         _lastFontType = FontType::Default;
     }
 
-    // Create a new font resource with the updated pattern, or delete if empty.
-    _softFont = { bitPattern, cellSize, _GetFontSize(), centeringHint };
+    // Create a new font resource with the updated glyphs, or delete if empty.
+    _softFont = { glyphCache, _GetFontSize() };
 
     return S_OK;
 }
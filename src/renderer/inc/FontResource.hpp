@@ -11,6 +11,8 @@ Abstract:
 
 #pragma once
 
+#include "SoftFontGlyphCache.hpp"
+
 namespace wil
 {
     typedef unique_any<HANDLE, decltype(&::RemoveFontMemResourceEx), ::RemoveFontMemResourceEx> unique_hfontresource;
@@ -21,10 +23,8 @@ namespace Microsoft::Console::Render
     class FontResource
     {
     public:
-        FontResource(const gsl::span<const uint16_t> bitPattern,
-                     const til::size sourceSize,
-                     const til::size targetSize,
-                     const size_t centeringHint);
+        FontResource(std::shared_ptr<SoftFontGlyphCache> glyphCache,
+                     const til::size targetSize);
         FontResource() = default;
         ~FontResource() = default;
         FontResource& operator=(FontResource&&) = default;
@@ -33,12 +33,9 @@ namespace Microsoft::Console::Render
 
     private:
         void _regenerateFont();
-        void _resizeBitPattern(gsl::span<byte> targetBuffer);
 
-        std::vector<uint16_t> _bitPattern;
-        til::size _sourceSize;
+        std::shared_ptr<SoftFontGlyphCache> _glyphCache;
         til::size _targetSize;
-        size_t _centeringHint{ 0 };
         wil::unique_hfontresource _resourceHandle;
         wil::unique_hfont _fontHandle;
     };
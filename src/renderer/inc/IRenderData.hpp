@@ -37,6 +37,14 @@ namespace Microsoft::Console::Render
         const Microsoft::Console::Types::Viewport region;
     };
 
+    // The columns [start, end) of a viewport row that a regex pattern was found in.
+    struct PatternSpan final
+    {
+        SHORT start;
+        SHORT end;
+        size_t id;
+    };
+
     class IRenderData : public Microsoft::Console::Types::IBaseData
     {
     public:
@@ -67,7 +75,8 @@ namespace Microsoft::Console::Render
         virtual const std::wstring GetHyperlinkUri(uint16_t id) const noexcept = 0;
         virtual const std::wstring GetHyperlinkCustomId(uint16_t id) const noexcept = 0;
 
-        virtual const std::vector<size_t> GetPatternId(const COORD location) const noexcept = 0;
+        // Returns the patterns found in the given viewport row, sorted by their start.
+        virtual gsl::span<const PatternSpan> GetPatternSpans(const SHORT row) const noexcept = 0;
 
     protected:
         IRenderData() = default;
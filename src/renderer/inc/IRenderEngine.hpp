@@ -18,6 +18,8 @@ Author(s):
 #include "Cluster.hpp"
 #include "FontInfoDesired.hpp"
 #include "IRenderData.hpp"
+#include "SoftFontGlyphCache.hpp"
+#include "../../buffer/out/ImageCache.hpp"
 #include "../../buffer/out/LineRendition.hpp"
 
 namespace Microsoft::Console::Render
@@ -90,6 +92,9 @@ namespace Microsoft::Console::Render
                                                            const COLORREF color,
                                                            const size_t cchLine,
                                                            const COORD coordTarget) noexcept = 0;
+        [[nodiscard]] virtual HRESULT PaintImageSlice(const InlineImage& image,
+                                                      const size_t imageRow,
+                                                      const COORD target) noexcept = 0;
         [[nodiscard]] virtual HRESULT PaintSelection(const SMALL_RECT rect) noexcept = 0;
 
         [[nodiscard]] virtual HRESULT PaintCursor(const CursorOptions& options) noexcept = 0;
@@ -100,9 +105,7 @@ namespace Microsoft::Console::Render
                                                            const bool isSettingDefaultBrushes) noexcept = 0;
         [[nodiscard]] virtual HRESULT UpdateFont(const FontInfoDesired& FontInfoDesired,
                                                  _Out_ FontInfo& FontInfo) noexcept = 0;
-        [[nodiscard]] virtual HRESULT UpdateSoftFont(const gsl::span<const uint16_t> bitPattern,
-                                                     const SIZE cellSize,
-                                                     const size_t centeringHint) noexcept = 0;
+        [[nodiscard]] virtual HRESULT UpdateSoftFont(const std::shared_ptr<SoftFontGlyphCache>& glyphCache) noexcept = 0;
         [[nodiscard]] virtual HRESULT UpdateDpi(const int iDpi) noexcept = 0;
         [[nodiscard]] virtual HRESULT UpdateViewport(const SMALL_RECT srNewViewport) noexcept = 0;
 
@@ -38,6 +38,7 @@ namespace Microsoft::Console::Render
         virtual void TriggerRedrawCursor(const COORD* const pcoord) = 0;
 
         virtual void TriggerRedrawAll() = 0;
+        virtual void TriggerRedrawBlinking() = 0;
         virtual void TriggerTeardown() noexcept = 0;
 
         virtual void TriggerSelection() = 0;
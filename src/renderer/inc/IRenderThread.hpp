@@ -13,8 +13,24 @@ Author(s):
 --*/
 
 #pragma once
+
+#include "../../types/inc/ThreadScheduling.hpp"
+
 namespace Microsoft::Console::Render
 {
+    struct FrameStatistics
+    {
+        uint64_t framesPainted;
+        // Frames that took longer than a refresh interval to paint, counted
+        // once for every display refresh they overran.
+        uint64_t framesDropped;
+        float framesPerSecond;
+        // The total time spent painting frames, and the part of it the renderer
+        // spent waiting for the console lock before it could start.
+        uint64_t paintMicroseconds;
+        uint64_t lockWaitMicroseconds;
+    };
+
     class IRenderThread
     {
     public:
@@ -28,6 +44,9 @@ namespace Microsoft::Console::Render
         virtual void EnablePainting() = 0;
         virtual void DisablePainting() = 0;
         virtual void WaitForPaintCompletionAndDisable(const DWORD dwTimeoutMs) = 0;
+        virtual FrameStatistics GetFrameStatistics() const noexcept = 0;
+        virtual void SetSchedulingClass(const Microsoft::Console::Types::ThreadScheduling::Class schedulingClass) noexcept = 0;
+        virtual void SetMinimumFrameInterval(const std::chrono::microseconds interval) noexcept = 0;
 
     protected:
         IRenderThread() = default;
@@ -39,6 +39,7 @@ namespace Microsoft::Console::Render
         virtual void TriggerRedrawCursor(const COORD* const pcoord) = 0;
 
         virtual void TriggerRedrawAll() = 0;
+        virtual void TriggerRedrawBlinking() = 0;
         virtual void TriggerTeardown() noexcept = 0;
 
         virtual void TriggerSelection() = 0;
@@ -64,6 +65,9 @@ namespace Microsoft::Console::Render
         virtual void WaitForPaintCompletionAndDisable(const DWORD dwTimeoutMs) = 0;
         virtual void WaitUntilCanRender() = 0;
 
+        virtual void SynchronizedOutputBegin() noexcept = 0;
+        virtual void SynchronizedOutputEnd() noexcept = 0;
+
         virtual void AddRenderEngine(_In_ IRenderEngine* const pEngine) = 0;
 
     protected:
@@ -0,0 +1,49 @@
+/*++
+Copyright (c) Microsoft Corporation
+Licensed under the MIT license.
+
+Module Name:
+- SoftFontGlyphCache.hpp
+
+Abstract:
+- This holds the glyphs of a VT soft font (DECDLD), pre-scaled to the cell
+  sizes that the render engines have asked for.
+- A single instance is created by the Renderer whenever the soft font changes
+  and is shared by all of its engines. The scaled glyphs for a cell size are
+  only generated once, so switching back and forth between DPIs or fonts, or
+  attaching another engine, doesn't need to scale the bit patterns again.
+--*/
+
+#pragma once
+
+namespace Microsoft::Console::Render
+{
+    class SoftFontGlyphCache
+    {
+    public:
+        // DRCS soft fonts only require 96 characters at most.
+        static constexpr size_t CharCount = 96;
+
+        SoftFontGlyphCache(const gsl::span<const uint16_t> bitPattern,
+                           const til::size sourceSize,
+                           const size_t centeringHint);
+
+        static size_t GlyphSizeInBytes(const til::size targetSize) noexcept;
+        std::shared_ptr<const std::vector<byte>> GetScaledGlyphs(const til::size targetSize);
+
+    private:
+        // Engines typically only alternate between a couple of sizes (e.g. when
+        // the window is moved between monitors), so only a few are retained.
+        static constexpr size_t MaxCachedSizes = 4;
+
+        std::vector<byte> _scaleBitPattern(const til::size targetSize) const;
+
+        const std::vector<uint16_t> _bitPattern;
+        const til::size _sourceSize;
+        const size_t _centeringHint;
+
+        // The most recently used size is at the front.
+        std::mutex _mutex;
+        std::vector<std::pair<til::size, std::shared_ptr<const std::vector<byte>>>> _scaledGlyphs;
+    };
+}
@@ -20,8 +20,33 @@ UiaEngine::UiaEngine(IUiaEventDispatcher* dispatcher) :
     _textBufferChanged{ false },
     _cursorChanged{ false },
     _isEnabled{ true },
-    _prevSelection{},
     _prevCursorRegion{},
+    _viewport{},
+    _dirtyArea{},
+    _outputStart{},
+    _newOutputRowStart{ 0 },
+    _paintedRow{ -1 },
+    _paintedRowWrapped{ false },
+    _signalTextChanged{ TextChangedDelay, [this]() {
+                           std::wstring output;
+                           {
+                               const std::lock_guard guard{ _pendingOutputLock };
+                               output = std::move(_pendingOutput);
+                               _pendingOutput.clear();
+                           }
+                           if (_isEnabled)
+                           {
+                               try
+                               {
+                                   _dispatcher->SignalTextChanged();
+                                   if (!output.empty())
+                                   {
+                                       _dispatcher->SignalNewOutput(output);
+                                   }
+                               }
+                               CATCH_LOG();
+                           }
+                       } },
     RenderEngineBase()
 {
 }
@@ -57,12 +82,29 @@ UiaEngine::UiaEngine(IUiaEventDispatcher* dispatcher) :
 // - psrRegion - Character region (SMALL_RECT) that has been changed
 // Return Value:
 // - S_OK, else an appropriate HRESULT for failing to allocate or write.
-[[nodiscard]] HRESULT UiaEngine::Invalidate(const SMALL_RECT* const /*psrRegion*/) noexcept
+[[nodiscard]] HRESULT UiaEngine::Invalidate(const SMALL_RECT* const psrRegion) noexcept
 {
-    _textBufferChanged = true;
+    RETURN_HR_IF_NULL(E_INVALIDARG, psrRegion);
+
+    _InvalidateRows(psrRegion->Top, psrRegion->Bottom);
     return S_OK;
 }
 
+// Routine Description:
+// - Marks the given rows of the viewport as changed. We always take whole rows,
+//   so that the new output we collect from them has no holes. They're clamped
+//   to the viewport once we paint, since it may still change until then.
+// Arguments:
+// - top - The first row that changed.
+// - bottom - The row after the last one that changed.
+// Return Value:
+// - <none>
+void UiaEngine::_InvalidateRows(const ptrdiff_t top, const ptrdiff_t bottom) noexcept
+{
+    _dirtyArea |= til::rectangle{ til::point{ ptrdiff_t{ 0 }, top }, til::point{ ptrdiff_t{ SHRT_MAX }, bottom } };
+    _textBufferChanged = true;
+}
+
 // Routine Description:
 // - Notifies us that the console has changed the position of the cursor.
 //  For UIA, this doesn't mean anything. So do nothing.
@@ -101,43 +143,15 @@ CATCH_RETURN();
 // - Notifies us that the console has changed the selection region and would
 //      like it updated
 // Arguments:
-// - rectangles - One or more rectangles describing character positions on the grid
+// - rectangles - The character positions on the grid whose selection state
+//      changed. The renderer only sends these when something actually changed.
 // Return Value:
 // - S_OK
 [[nodiscard]] HRESULT UiaEngine::InvalidateSelection(const std::vector<SMALL_RECT>& rectangles) noexcept
 {
-    // early exit: different number of rows
-    if (_prevSelection.size() != rectangles.size())
-    {
-        try
-        {
-            _selectionChanged = true;
-            _prevSelection = rectangles;
-        }
-        CATCH_LOG_RETURN_HR(E_FAIL);
-        return S_OK;
-    }
-
-    for (size_t i = 0; i < rectangles.size(); i++)
-    {
-        try
-        {
-            const auto prevRect = _prevSelection.at(i);
-            const auto newRect = rectangles.at(i);
-
-            // if any value is different, selection has changed
-            if (prevRect.Top != newRect.Top || prevRect.Right != newRect.Right || prevRect.Left != newRect.Left || prevRect.Bottom != newRect.Bottom)
-            {
-                _selectionChanged = true;
-                _prevSelection = rectangles;
-                return S_OK;
-            }
-        }
-        CATCH_LOG_RETURN_HR(E_FAIL);
-    }
-
-    // assume selection has not changed
-    _selectionChanged = false;
+    // The selection changed if any cell was (de)selected. A pending change
+    // must not be cleared before it has been signaled in the next frame.
+    _selectionChanged = _selectionChanged || !rectangles.empty();
     return S_OK;
 }
 
@@ -149,10 +163,36 @@ CATCH_RETURN();
 //               - -Y is up, Y is down, -X is left, X is right.
 // Return Value:
 // - S_OK
-[[nodiscard]] HRESULT UiaEngine::InvalidateScroll(const COORD* const /*pcoordDelta*/) noexcept
+[[nodiscard]] HRESULT UiaEngine::InvalidateScroll(const COORD* const pcoordDelta) noexcept
+try
 {
-    return S_FALSE;
+    RETURN_HR_IF_NULL(E_INVALIDARG, pcoordDelta);
+
+    const ptrdiff_t delta = pcoordDelta->Y;
+    if (delta == 0)
+    {
+        return S_FALSE;
+    }
+
+    // The text that hasn't been read yet moved along with the viewport. If it
+    // moved out at the top, whatever is left of it starts at the first row.
+    _outputStart = _outputStart.y() + delta < 0 ? til::point{} : til::point{ _outputStart.x(), _outputStart.y() + delta };
+
+    if (!_dirtyArea.empty())
+    {
+        _dirtyArea += til::point{ 0, delta };
+    }
+    if (delta < 0)
+    {
+        _InvalidateRows(_viewport.Height() + delta, _viewport.Height());
+    }
+    else
+    {
+        _InvalidateRows(0, delta);
+    }
+    return S_OK;
 }
+CATCH_RETURN();
 
 // Routine Description:
 // - Notifies to repaint everything.
@@ -164,7 +204,7 @@ CATCH_RETURN();
 // - S_OK, else an appropriate HRESULT for failing to allocate or write.
 [[nodiscard]] HRESULT UiaEngine::InvalidateAll() noexcept
 {
-    _textBufferChanged = true;
+    _InvalidateRows(0, SHRT_MAX);
     return S_OK;
 }
 
@@ -240,7 +280,19 @@ CATCH_RETURN();
     {
         try
         {
-            _dispatcher->SignalTextChanged();
+            _EndOutputRow();
+            if (!_newOutput.empty())
+            {
+                const std::lock_guard guard{ _pendingOutputLock };
+                _pendingOutput.append(_newOutput);
+                if (_pendingOutput.size() > MaxNewOutputLength)
+                {
+                    _pendingOutput.erase(0, _pendingOutput.size() - MaxNewOutputLength);
+                }
+            }
+
+            // Coalesced and signaled later from the threadpool.
+            _signalTextChanged();
         }
         CATCH_LOG();
     }
@@ -253,6 +305,14 @@ CATCH_RETURN();
         CATCH_LOG();
     }
 
+    // Whatever is written from now on starts where the cursor is.
+    _outputStart = { _prevCursorRegion.Left, _prevCursorRegion.Top };
+    _dirtyArea = {};
+    _newOutput.clear();
+    _newOutputRowStart = 0;
+    _paintedRow = -1;
+    _paintedRowWrapped = false;
+
     _selectionChanged = false;
     _textBufferChanged = false;
     _cursorChanged = false;
@@ -298,20 +358,68 @@ CATCH_RETURN();
 }
 
 // Routine Description:
-// - Places one line of text onto the screen at the given position
-//  For UIA, this doesn't mean anything. So do nothing.
+// - Collects the text of the given run of a changed row, if it was written
+//   after where the cursor was at the end of the last frame.
+// - The runs of a row are painted left to right and rows top to bottom, so the
+//   text collected this way reads like it was written.
 // Arguments:
 // - clusters - Iterable collection of cluster information (text and columns it should consume)
 // - coord - Character coordinate position in the cell grid
 // - fTrimLeft - Whether or not to trim off the left half of a double wide character
+// - lineWrapped - Whether the row wraps onto the next one
 // Return Value:
-// - S_FALSE
-[[nodiscard]] HRESULT UiaEngine::PaintBufferLine(gsl::span<const Cluster> const /*clusters*/,
-                                                 COORD const /*coord*/,
+// - S_OK, or S_FALSE if none of the text is new.
+[[nodiscard]] HRESULT UiaEngine::PaintBufferLine(gsl::span<const Cluster> const clusters,
+                                                 COORD const coord,
                                                  const bool /*trimLeft*/,
-                                                 const bool /*lineWrapped*/) noexcept
+                                                 const bool lineWrapped) noexcept
+try
 {
-    return S_FALSE;
+    const ptrdiff_t row = coord.Y;
+    if (row < _outputStart.y())
+    {
+        return S_FALSE;
+    }
+
+    if (row != _paintedRow)
+    {
+        _EndOutputRow();
+        if (!_paintedRowWrapped && !_newOutput.empty())
+        {
+            _newOutput.append(L"\r\n");
+        }
+        _newOutputRowStart = _newOutput.size();
+        _paintedRow = row;
+    }
+
+    ptrdiff_t column = coord.X;
+    for (const auto& cluster : clusters)
+    {
+        if (row > _outputStart.y() || column >= _outputStart.x())
+        {
+            _newOutput.append(cluster.GetText());
+        }
+        column += gsl::narrow_cast<ptrdiff_t>(cluster.GetColumns());
+    }
+    _paintedRowWrapped = lineWrapped;
+    return S_OK;
+}
+CATCH_RETURN();
+
+// Routine Description:
+// - Finishes the row of new output that was being collected, by trimming the
+//   blanks that pad it to the width of the viewport.
+// Arguments:
+// - <none>
+// Return Value:
+// - <none>
+void UiaEngine::_EndOutputRow() noexcept
+{
+    if (!_paintedRowWrapped)
+    {
+        const auto end = _newOutput.find_last_not_of(L' ');
+        _newOutput.resize(end == std::wstring::npos || end < _newOutputRowStart ? _newOutputRowStart : end + 1);
+    }
 }
 
 // Routine Description:
@@ -406,9 +514,10 @@ CATCH_RETURN();
 // - srNewViewport - The bounds of the new viewport.
 // Return Value:
 // - HRESULT S_OK
-[[nodiscard]] HRESULT UiaEngine::UpdateViewport(const SMALL_RECT /*srNewViewport*/) noexcept
+[[nodiscard]] HRESULT UiaEngine::UpdateViewport(const SMALL_RECT srNewViewport) noexcept
 {
-    return S_FALSE;
+    _viewport = Viewport::FromInclusive(srNewViewport);
+    return S_OK;
 }
 
 // Routine Description:
@@ -428,17 +537,16 @@ CATCH_RETURN();
 
 // Routine Description:
 // - Gets the area that we currently believe is dirty within the character cell grid
-// - Not currently used by UiaEngine.
+// - These are the rows that changed since the last frame. Only they are painted
+//   into this engine, for us to collect the new output from.
 // Arguments:
 // - area - Rectangle describing dirty area in characters.
 // Return Value:
 // - S_OK.
 [[nodiscard]] HRESULT UiaEngine::GetDirtyArea(gsl::span<const til::rectangle>& area) noexcept
 {
-    // Magic static is only valid because any instance of this object has the same behavior.
-    // Use member variable instead if this ever changes.
-    const static til::rectangle empty;
-    area = { &empty, 1 };
+    _dirtyArea &= til::rectangle{ til::size{ _viewport.Dimensions() } };
+    area = { &_dirtyArea, 1 };
     return S_OK;
 }
 
@@ -17,6 +17,8 @@ Author(s):
 
 #include "../../renderer/inc/RenderEngineBase.hpp"
 
+#include <til/throttled_func.h>
+
 #include "../../types/IUiaEventDispatcher.h"
 #include "../../types/inc/Viewport.hpp"
 
@@ -78,6 +80,9 @@ namespace Microsoft::Console::Render
         [[nodiscard]] HRESULT _DoUpdateTitle(const std::wstring_view newTitle) noexcept override;
 
     private:
+        void _InvalidateRows(const ptrdiff_t top, const ptrdiff_t bottom) noexcept;
+        void _EndOutputRow() noexcept;
+
         bool _isEnabled;
         bool _isPainting;
         bool _selectionChanged;
@@ -86,7 +91,28 @@ namespace Microsoft::Console::Render
 
         Microsoft::Console::Types::IUiaEventDispatcher* _dispatcher;
 
-        std::vector<SMALL_RECT> _prevSelection;
         SMALL_RECT _prevCursorRegion;
+
+        // Only the rows that changed are painted into this engine, and from those
+        // we collect the text that was written since the last frame: everything
+        // from where the cursor was at the end of the last frame onwards.
+        Microsoft::Console::Types::Viewport _viewport;
+        til::rectangle _dirtyArea;
+        til::point _outputStart;
+        std::wstring _newOutput;
+        size_t _newOutputRowStart;
+        ptrdiff_t _paintedRow;
+        bool _paintedRowWrapped;
+
+        // Text changes are signaled at most once per TextChangedDelay.
+        // Every signal makes automation clients re-read the text, which
+        // under heavy output would otherwise happen on every frame.
+        static constexpr auto TextChangedDelay = std::chrono::milliseconds(100);
+        // The new output is accumulated until then, keeping only the most recent
+        // MaxNewOutputLength characters of it, since nobody will listen to more.
+        static constexpr size_t MaxNewOutputLength = 16 * 1024;
+        til::throttled_func_trailing<> _signalTextChanged;
+        std::mutex _pendingOutputLock;
+        std::wstring _pendingOutput;
     };
 }
@@ -14,9 +14,25 @@ Xterm256Engine::Xterm256Engine(_In_ wil::unique_hfile hPipe,
 {
 }
 
+namespace
+{
+    // The SGR parameters of the 16 indexed colors, in the order of the Windows
+    // color table. Its red and blue bits are swapped compared to the VT order.
+    constexpr std::array<std::string_view, 16> s_foreground16Parameters{
+        "30", "34", "32", "36", "31", "35", "33", "37",
+        "90", "94", "92", "96", "91", "95", "93", "97"
+    };
+    constexpr std::array<std::string_view, 16> s_background16Parameters{
+        "40", "44", "42", "46", "41", "45", "43", "47",
+        "100", "104", "102", "106", "101", "105", "103", "107"
+    };
+}
+
 // Routine Description:
 // - Write a VT sequence to change the current colors of text. Writes true RGB
 //      color sequences.
+// - All the colors and renditions that changed since the last call are
+//      collected into a single SGR sequence, instead of one sequence each.
 // Arguments:
 // - textAttributes - Text attributes to use for the colors and character rendition
 // - pData - The interface to console data structures required for rendering
@@ -29,22 +45,109 @@ Xterm256Engine::Xterm256Engine(_In_ wil::unique_hfile hPipe,
                                                            const gsl::not_null<IRenderData*> pData,
                                                            const bool /*usingSoftFont*/,
                                                            const bool /*isSettingDefaultBrushes*/) noexcept
+try
 {
-    RETURN_IF_FAILED(VtEngine::_RgbUpdateDrawingBrushes(textAttributes));
-
     RETURN_IF_FAILED(_UpdateHyperlinkAttr(textAttributes, pData));
 
+    SgrParameters parameters;
+    _AppendColorParameters(textAttributes, parameters);
+
     // Only do extended attributes in xterm-256color, as to not break telnet.exe.
-    return _UpdateExtendedAttrs(textAttributes);
+    _AppendExtendedAttrParameters(textAttributes, parameters);
+
+    return _WriteSgr(parameters);
+}
+CATCH_RETURN()
+
+// Routine Description:
+// - Appends a single parameter to an SGR sequence that's being built.
+// Arguments:
+// - parameters - the parameters of the sequence so far.
+// - parameter - the parameter to append.
+void Xterm256Engine::_AppendSgrParameter(SgrParameters& parameters, const std::string_view parameter)
+{
+    if (parameters.size() != 0)
+    {
+        parameters.push_back(';');
+    }
+    parameters.append(parameter.data(), parameter.data() + parameter.size());
+}
+
+// Routine Description:
+// - Appends the SGR parameters that select the given color.
+// Arguments:
+// - color - the color to select.
+// - isForeground - true if it's the foreground color, false for the background.
+// - parameters - the parameters of the sequence so far.
+void Xterm256Engine::_AppendColorParameter(const TextColor color, const bool isForeground, SgrParameters& parameters)
+{
+    if (color.IsDefault())
+    {
+        _AppendSgrParameter(parameters, isForeground ? "39" : "49");
+    }
+    else if (color.IsIndex16())
+    {
+        const auto& table = isForeground ? s_foreground16Parameters : s_background16Parameters;
+        _AppendSgrParameter(parameters, til::at(table, color.GetIndex() & 0xfu));
+    }
+    else if (color.IsIndex256())
+    {
+        _AppendSgrParameter(parameters, isForeground ? "38;5" : "48;5");
+        fmt::format_to(std::back_inserter(parameters), FMT_COMPILE(";{}"), ::Xterm256ToWindowsIndex(color.GetIndex()));
+    }
+    else if (color.IsRgb())
+    {
+        const auto rgb = color.GetRGB();
+        _AppendSgrParameter(parameters, isForeground ? "38;2" : "48;2");
+        fmt::format_to(std::back_inserter(parameters), FMT_COMPILE(";{};{};{}"), GetRValue(rgb), GetGValue(rgb), GetBValue(rgb));
+    }
+}
+
+// Routine Description:
+// - Appends the SGR parameters for the colors that changed.
+// Arguments:
+// - textAttributes - Text attributes to use for the colors.
+// - parameters - the parameters of the sequence so far.
+void Xterm256Engine::_AppendColorParameters(const TextAttribute& textAttributes, SgrParameters& parameters)
+{
+    const auto fg = textAttributes.GetForeground();
+    const auto bg = textAttributes.GetBackground();
+    const auto lastFg = _lastTextAttributes.GetForeground();
+    const auto lastBg = _lastTextAttributes.GetBackground();
+
+    // If both the FG and BG should be the defaults, emit a SGR reset.
+    if (fg.IsDefault() && bg.IsDefault() && !(lastFg.IsDefault() && lastBg.IsDefault()))
+    {
+        // SGR Reset will clear all attributes (except hyperlink ID) - which means
+        // we cannot reset _lastTextAttributes by simply doing
+        // _lastTextAttributes = {};
+        // because we want to retain the last hyperlink ID
+        _AppendSgrParameter(parameters, "0");
+        _lastTextAttributes.SetDefaultBackground();
+        _lastTextAttributes.SetDefaultForeground();
+        _lastTextAttributes.SetDefaultMetaAttrs();
+        return;
+    }
+
+    if (fg != lastFg)
+    {
+        _AppendColorParameter(fg, true, parameters);
+        _lastTextAttributes.SetForeground(fg);
+    }
+
+    if (bg != lastBg)
+    {
+        _AppendColorParameter(bg, false, parameters);
+        _lastTextAttributes.SetBackground(bg);
+    }
 }
 
 // Routine Description:
-// - Write a VT sequence to update the character rendition attributes.
+// - Appends the SGR parameters for the character rendition attributes that changed.
 // Arguments:
 // - textAttributes - text attributes (bold, italic, underline, etc.) to use.
-// Return Value:
-// - S_OK if we succeeded, else an appropriate HRESULT for failing to allocate or write.
-[[nodiscard]] HRESULT Xterm256Engine::_UpdateExtendedAttrs(const TextAttribute& textAttributes) noexcept
+// - parameters - the parameters of the sequence so far.
+void Xterm256Engine::_AppendExtendedAttrParameters(const TextAttribute& textAttributes, SgrParameters& parameters)
 {
     // Turning off Bold and Faint must be handled at the same time,
     // since there is only one sequence that resets both of them.
@@ -52,7 +155,7 @@ Xterm256Engine::Xterm256Engine(_In_ wil::unique_hfile hPipe,
     const auto faintTurnedOff = !textAttributes.IsFaint() && _lastTextAttributes.IsFaint();
     if (boldTurnedOff || faintTurnedOff)
     {
-        RETURN_IF_FAILED(_SetBold(false));
+        _AppendSgrParameter(parameters, "22");
         _lastTextAttributes.SetBold(false);
         _lastTextAttributes.SetFaint(false);
     }
@@ -61,12 +164,12 @@ Xterm256Engine::Xterm256Engine(_In_ wil::unique_hfile hPipe,
     // we can then check if either should be turned back on again.
     if (textAttributes.IsBold() && !_lastTextAttributes.IsBold())
     {
-        RETURN_IF_FAILED(_SetBold(true));
+        _AppendSgrParameter(parameters, "1");
         _lastTextAttributes.SetBold(true);
     }
     if (textAttributes.IsFaint() && !_lastTextAttributes.IsFaint())
     {
-        RETURN_IF_FAILED(_SetFaint(true));
+        _AppendSgrParameter(parameters, "2");
         _lastTextAttributes.SetFaint(true);
     }
 
@@ -76,7 +179,7 @@ Xterm256Engine::Xterm256Engine(_In_ wil::unique_hfile hPipe,
     const auto doubleTurnedOff = !textAttributes.IsDoublyUnderlined() && _lastTextAttributes.IsDoublyUnderlined();
     if (singleTurnedOff || doubleTurnedOff)
     {
-        RETURN_IF_FAILED(_SetUnderlined(false));
+        _AppendSgrParameter(parameters, "24");
         _lastTextAttributes.SetUnderlined(false);
         _lastTextAttributes.SetDoublyUnderlined(false);
     }
@@ -85,52 +188,71 @@ Xterm256Engine::Xterm256Engine(_In_ wil::unique_hfile hPipe,
     // we can then check if either should be turned back on again.
     if (textAttributes.IsUnderlined() && !_lastTextAttributes.IsUnderlined())
     {
-        RETURN_IF_FAILED(_SetUnderlined(true));
+        _AppendSgrParameter(parameters, "4");
         _lastTextAttributes.SetUnderlined(true);
     }
     if (textAttributes.IsDoublyUnderlined() && !_lastTextAttributes.IsDoublyUnderlined())
     {
-        RETURN_IF_FAILED(_SetDoublyUnderlined(true));
+        _AppendSgrParameter(parameters, "21");
         _lastTextAttributes.SetDoublyUnderlined(true);
     }
 
     if (textAttributes.IsOverlined() != _lastTextAttributes.IsOverlined())
     {
-        RETURN_IF_FAILED(_SetOverlined(textAttributes.IsOverlined()));
+        _AppendSgrParameter(parameters, textAttributes.IsOverlined() ? "53" : "55");
         _lastTextAttributes.SetOverlined(textAttributes.IsOverlined());
     }
 
     if (textAttributes.IsItalic() != _lastTextAttributes.IsItalic())
     {
-        RETURN_IF_FAILED(_SetItalic(textAttributes.IsItalic()));
+        _AppendSgrParameter(parameters, textAttributes.IsItalic() ? "3" : "23");
         _lastTextAttributes.SetItalic(textAttributes.IsItalic());
     }
 
     if (textAttributes.IsBlinking() != _lastTextAttributes.IsBlinking())
     {
-        RETURN_IF_FAILED(_SetBlinking(textAttributes.IsBlinking()));
+        _AppendSgrParameter(parameters, textAttributes.IsBlinking() ? "5" : "25");
         _lastTextAttributes.SetBlinking(textAttributes.IsBlinking());
     }
 
     if (textAttributes.IsInvisible() != _lastTextAttributes.IsInvisible())
     {
-        RETURN_IF_FAILED(_SetInvisible(textAttributes.IsInvisible()));
+        _AppendSgrParameter(parameters, textAttributes.IsInvisible() ? "8" : "28");
         _lastTextAttributes.SetInvisible(textAttributes.IsInvisible());
     }
 
     if (textAttributes.IsCrossedOut() != _lastTextAttributes.IsCrossedOut())
     {
-        RETURN_IF_FAILED(_SetCrossedOut(textAttributes.IsCrossedOut()));
+        _AppendSgrParameter(parameters, textAttributes.IsCrossedOut() ? "9" : "29");
         _lastTextAttributes.SetCrossedOut(textAttributes.IsCrossedOut());
     }
 
     if (textAttributes.IsReverseVideo() != _lastTextAttributes.IsReverseVideo())
     {
-        RETURN_IF_FAILED(_SetReverseVideo(textAttributes.IsReverseVideo()));
+        _AppendSgrParameter(parameters, textAttributes.IsReverseVideo() ? "7" : "27");
         _lastTextAttributes.SetReverseVideo(textAttributes.IsReverseVideo());
     }
+}
 
-    return S_OK;
+// Routine Description:
+// - Writes a single SGR sequence with the given parameters, if there are any.
+// Arguments:
+// - parameters - the parameters of the sequence.
+// Return Value:
+// - S_OK if we succeeded, else an appropriate HRESULT for failing to allocate or write.
+[[nodiscard]] HRESULT Xterm256Engine::_WriteSgr(const SgrParameters& parameters) noexcept
+{
+    const std::string_view view{ parameters.data(), parameters.size() };
+    if (view.empty())
+    {
+        return S_OK;
+    }
+    // A reset on its own is written the short way, like _SetGraphicsDefault() does.
+    if (view == "0")
+    {
+        return _Write("\x1b[m");
+    }
+    return _WriteFormatted(FMT_COMPILE("\x1b[{}m"), view);
 }
 
 // Routine Description:
@@ -174,3 +296,63 @@ HRESULT Microsoft::Console::Render::Xterm256Engine::_UpdateHyperlinkAttr(const T
 {
     return _ClearScrollback();
 }
+
+// Method Description:
+// - Emit a DECSET/DECRST 1049 to switch the connected terminal to or from its
+//   own alternate screen buffer. The terminal keeps the contents of its main
+//   buffer, so we keep our shadow of it too. When the client switches back, the
+//   repaint that follows only needs to emit the cells that actually differ.
+// - The graphics rendition is reset around the switch, and the cursor position
+//   has to be sent again, because terminals disagree on whether they're saved
+//   and restored along with the buffer.
+// Arguments:
+// - useAlternate - true if the alternate screen buffer is now active.
+// Return Value:
+// - S_OK if we wrote the sequences successfully, otherwise an appropriate HRESULT
+[[nodiscard]] HRESULT Xterm256Engine::SwitchScreenBuffer(const bool useAlternate) noexcept
+try
+{
+    if (useAlternate == _usingAltBuffer)
+    {
+        // A nested switch to the alternate buffer clears it.
+        if (useAlternate)
+        {
+            _ResetShadow();
+        }
+        return S_OK;
+    }
+
+    // Anything that was scrolled until now happened in the other buffer.
+    _scrollDelta = { 0, 0 };
+
+    RETURN_IF_FAILED(_Write(useAlternate ? "\x1b[m\x1b[?1049h" : "\x1b[?1049l\x1b[m"));
+    _lastTextAttributes.SetDefaultBackground();
+    _lastTextAttributes.SetDefaultForeground();
+    _lastTextAttributes.SetDefaultMetaAttrs();
+    _lastText = INVALID_COORDS;
+    _wrappedRow = std::nullopt;
+    _delayedEolWrap = false;
+    _newBottomLine = false;
+
+    const auto cellCount = gsl::narrow_cast<size_t>(_lastViewport.Width()) * _lastViewport.Height();
+    if (useAlternate)
+    {
+        // The terminal clears its alternate buffer when it switches to it.
+        _mainShadow = std::move(_shadow);
+        _shadow.assign(cellCount, ShadowCell{ L' ', false, _lastTextAttributes });
+    }
+    else
+    {
+        _shadow = std::move(_mainShadow);
+        _mainShadow.clear();
+        if (_shadow.size() != cellCount)
+        {
+            _shadow.clear();
+            _shadow.resize(cellCount);
+        }
+    }
+    _usingAltBuffer = useAlternate;
+
+    return _Flush();
+}
+CATCH_RETURN();
@@ -34,9 +34,16 @@ namespace Microsoft::Console::Render
                                                    const bool isSettingDefaultBrushes) noexcept override;
 
         [[nodiscard]] HRESULT ManuallyClearScrollback() noexcept override;
+        [[nodiscard]] HRESULT SwitchScreenBuffer(const bool useAlternate) noexcept override;
 
     private:
-        [[nodiscard]] HRESULT _UpdateExtendedAttrs(const TextAttribute& textAttributes) noexcept;
+        using SgrParameters = fmt::basic_memory_buffer<char, 64>;
+
+        static void _AppendSgrParameter(SgrParameters& parameters, const std::string_view parameter);
+        static void _AppendColorParameter(const TextColor color, const bool isForeground, SgrParameters& parameters);
+        void _AppendColorParameters(const TextAttribute& textAttributes, SgrParameters& parameters);
+        void _AppendExtendedAttrParameters(const TextAttribute& textAttributes, SgrParameters& parameters);
+        [[nodiscard]] HRESULT _WriteSgr(const SgrParameters& parameters) noexcept;
         [[nodiscard]] HRESULT _UpdateHyperlinkAttr(const TextAttribute& textAttributes,
                                                    const gsl::not_null<IRenderData*> pData) noexcept;
 
@@ -53,6 +53,7 @@ XtermEngine::XtermEngine(_In_ wil::unique_hfile hPipe,
         //      terminal's state is consistent with what we'll be rendering.
         RETURN_IF_FAILED(_ClearScreen());
         _clearedAllThisFrame = true;
+        _ResetShadow();
         _firstPaint = false;
     }
     else
@@ -79,6 +80,15 @@ XtermEngine::XtermEngine(_In_ wil::unique_hfile hPipe,
         }
     }
 
+    // After a coordinated resize, paint this frame into the shadow only. The
+    //      attributes we'd set while doing so never reach the terminal, so
+    //      remember the ones it really has.
+    if (_resyncAfterResize && !_quickReturn)
+    {
+        _resyncAttributes = _lastTextAttributes;
+        _suppressOutput = true;
+    }
+
     return S_OK;
 }
 
@@ -91,6 +101,18 @@ XtermEngine::XtermEngine(_In_ wil::unique_hfile hPipe,
 // - S_OK if we succeeded, else an appropriate HRESULT for failing to allocate or write.
 [[nodiscard]] HRESULT XtermEngine::EndPaint() noexcept
 {
+    if (_suppressOutput)
+    {
+        // The shadow now holds the reflowed buffer, which the terminal shows
+        //      as well. All that's left is to put its cursor where we left ours.
+        _suppressOutput = false;
+        _resyncAfterResize = false;
+        _lastTextAttributes = _resyncAttributes;
+        _wrappedRow = std::nullopt;
+        _delayedEolWrap = false;
+        RETURN_IF_FAILED(_CursorPosition(_lastText));
+    }
+
     // If during the frame we determined that the cursor needed to be disabled,
     //      then insert a cursor off at the start of the buffer, and re-enable
     //      the cursor here.
@@ -395,6 +417,9 @@ try
         RETURN_IF_FAILED(_InsertLine(absDy));
     }
 
+    // The terminal moved its contents by the same amount.
+    _ScrollShadow(dy);
+
     // Restore our wrap state.
     _wrappedRow = oldWrappedRow;
     _delayedEolWrap = oldDelayedEolWrap;
@@ -472,6 +497,12 @@ try
 {
     const til::point delta{ *pcoordDelta };
 
+    // The terminal moved its viewport along with its reflow, just like we did.
+    if (_resyncAfterResize)
+    {
+        return S_OK;
+    }
+
     if (delta != til::point{ 0, 0 })
     {
         _trace.TraceInvalidateScroll(delta);
@@ -520,6 +551,8 @@ CATCH_RETURN();
 // - S_OK or suitable HRESULT error from either conversion or writing pipe.
 [[nodiscard]] HRESULT XtermEngine::WriteTerminalW(const std::wstring_view wstr) noexcept
 {
+    // We have no idea what this string does to the terminal's contents.
+    _ResetShadow();
     RETURN_IF_FAILED(_fUseAsciiOnly ?
                          VtEngine::_WriteTerminalAscii(wstr) :
                          VtEngine::_WriteTerminalUtf8(wstr));
@@ -137,5 +137,10 @@ CATCH_RETURN();
 [[nodiscard]] HRESULT VtEngine::PrepareForTeardown(_Out_ bool* const pForcePaint) noexcept
 {
     *pForcePaint = true;
+
+    // The process may exit right after this last frame, so it has to be
+    //      written by the time _Flush returns, not just queued.
+    std::lock_guard<std::mutex> lock{ _flushMutex };
+    _flushSynchronously = true;
     return S_OK;
 }
@@ -25,6 +25,18 @@ using namespace Microsoft::Console::Types;
         return S_FALSE;
     }
 
+    // In passthrough mode the terminal already got everything clients wrote,
+    //      so there's never anything to render for it. Drop what was
+    //      invalidated, so it doesn't pile up for when we'd paint next.
+    if (_passthroughMode)
+    {
+        _invalidMap.reset_all();
+        _scrollDelta = { 0, 0 };
+        _cursorMoved = false;
+        _titleChanged = false;
+        return S_FALSE;
+    }
+
     // If there's nothing to do, quick return
     bool somethingToDo = _invalidMap.any() ||
                          _scrollDelta != til::point{ 0, 0 } ||
@@ -181,80 +193,6 @@ using namespace Microsoft::Console::Types;
     return S_OK;
 }
 
-// Routine Description:
-// - Write a VT sequence to change the current colors of text. Writes true RGB
-//      color sequences.
-// Arguments:
-// - textAttributes: Text attributes to use for the colors.
-// Return Value:
-// - S_OK if we succeeded, else an appropriate HRESULT for failing to allocate or write.
-[[nodiscard]] HRESULT VtEngine::_RgbUpdateDrawingBrushes(const TextAttribute& textAttributes) noexcept
-{
-    const auto fg = textAttributes.GetForeground();
-    const auto bg = textAttributes.GetBackground();
-    auto lastFg = _lastTextAttributes.GetForeground();
-    auto lastBg = _lastTextAttributes.GetBackground();
-
-    // If both the FG and BG should be the defaults, emit a SGR reset.
-    if (fg.IsDefault() && bg.IsDefault() && !(lastFg.IsDefault() && lastBg.IsDefault()))
-    {
-        // SGR Reset will clear all attributes (except hyperlink ID) - which means
-        // we cannot reset _lastTextAttributes by simply doing
-        // _lastTextAttributes = {};
-        // because we want to retain the last hyperlink ID
-        RETURN_IF_FAILED(_SetGraphicsDefault());
-        _lastTextAttributes.SetDefaultBackground();
-        _lastTextAttributes.SetDefaultForeground();
-        _lastTextAttributes.SetDefaultMetaAttrs();
-        lastFg = {};
-        lastBg = {};
-    }
-
-    if (fg != lastFg)
-    {
-        if (fg.IsDefault())
-        {
-            RETURN_IF_FAILED(_SetGraphicsRenditionDefaultColor(true));
-        }
-        else if (fg.IsIndex16())
-        {
-            RETURN_IF_FAILED(_SetGraphicsRendition16Color(fg.GetIndex(), true));
-        }
-        else if (fg.IsIndex256())
-        {
-            RETURN_IF_FAILED(_SetGraphicsRendition256Color(fg.GetIndex(), true));
-        }
-        else if (fg.IsRgb())
-        {
-            RETURN_IF_FAILED(_SetGraphicsRenditionRGBColor(fg.GetRGB(), true));
-        }
-        _lastTextAttributes.SetForeground(fg);
-    }
-
-    if (bg != lastBg)
-    {
-        if (bg.IsDefault())
-        {
-            RETURN_IF_FAILED(_SetGraphicsRenditionDefaultColor(false));
-        }
-        else if (bg.IsIndex16())
-        {
-            RETURN_IF_FAILED(_SetGraphicsRendition16Color(bg.GetIndex(), false));
-        }
-        else if (bg.IsIndex256())
-        {
-            RETURN_IF_FAILED(_SetGraphicsRendition256Color(bg.GetIndex(), false));
-        }
-        else if (bg.IsRgb())
-        {
-            RETURN_IF_FAILED(_SetGraphicsRenditionRGBColor(bg.GetRGB(), false));
-        }
-        _lastTextAttributes.SetBackground(bg);
-    }
-
-    return S_OK;
-}
-
 // Routine Description:
 // - Write a VT sequence to change the current colors of text. It will try to
 //      find ANSI colors that are nearest to the input colors, and write those
@@ -372,8 +310,8 @@ using namespace Microsoft::Console::Types;
 // - coord - character coordinate target to render within viewport
 // Return Value:
 // - S_OK or suitable HRESULT error from writing pipe.
-[[nodiscard]] HRESULT VtEngine::_PaintUtf8BufferLine(gsl::span<const Cluster> const clusters,
-                                                     const COORD coord,
+[[nodiscard]] HRESULT VtEngine::_PaintUtf8BufferLine(gsl::span<const Cluster> clusters,
+                                                     COORD coord,
                                                      const bool lineWrapped) noexcept
 {
     if (coord.Y < _virtualTop)
@@ -381,6 +319,46 @@ using namespace Microsoft::Console::Types;
         return S_OK;
     }
 
+    // Skip over the cells at either end of the run that the terminal already
+    // displays. The renderer invalidates whole runs of text, even if only a
+    // single character in them changed, so this can save a lot of output.
+    // Wrapped lines are always painted in full, because we need to write the
+    // last character of the row to get the terminal to wrap the line. For the
+    // same reason, we need to write the first character of the row that
+    // continues a wrapped row.
+    const bool continuesWrappedRow = _wrappedRow.has_value() &&
+                                     coord.X == 0 &&
+                                     coord.Y == _wrappedRow.value() + 1;
+    if (!lineWrapped && !continuesWrappedRow)
+    {
+        while (!clusters.empty() && _ShadowMatches(clusters.front(), coord))
+        {
+            coord.X += gsl::narrow_cast<short>(clusters.front().GetColumns());
+            clusters = clusters.subspan(1);
+        }
+
+        size_t trailingColumns = 0;
+        for (const auto& cluster : clusters)
+        {
+            trailingColumns += cluster.GetColumns();
+        }
+        while (!clusters.empty())
+        {
+            const auto& last = clusters.back();
+            trailingColumns -= last.GetColumns();
+            if (!_ShadowMatches(last, { gsl::narrow_cast<short>(coord.X + trailingColumns), coord.Y }))
+            {
+                break;
+            }
+            clusters = clusters.first(clusters.size() - 1);
+        }
+
+        if (clusters.empty())
+        {
+            return S_OK;
+        }
+    }
+
     _bufferLine.clear();
     _bufferLine.reserve(clusters.size());
     short totalWidth = 0;
@@ -490,6 +468,7 @@ using namespace Microsoft::Console::Types;
 
     // Write the actual text string
     RETURN_IF_FAILED(VtEngine::_WriteTerminalUtf8({ _bufferLine.data(), cchActual }));
+    _UpdateShadow(clusters, coord, columnsActual);
 
     // GH#4415, GH#5181
     // If the renderer told us that this was a wrapped line, then mark
@@ -602,3 +581,128 @@ using namespace Microsoft::Console::Types;
 {
     return S_OK;
 }
+
+// Routine Description:
+// - Gets the shadow cell for the given position in the viewport.
+// Arguments:
+// - coord - character coordinate within the viewport
+// Return Value:
+// - The cell, or nullptr if the position is outside of the shadow.
+VtEngine::ShadowCell* VtEngine::_GetShadowCell(const COORD coord) noexcept
+{
+    const auto width = _lastViewport.Width();
+    if (coord.X < 0 || coord.Y < 0 || coord.X >= width)
+    {
+        return nullptr;
+    }
+
+    const auto index = gsl::narrow_cast<size_t>(coord.Y) * width + coord.X;
+    return index < _shadow.size() ? &_shadow.at(index) : nullptr;
+}
+
+// Routine Description:
+// - Checks whether the terminal is already displaying the given cluster at
+//   the given position, in the attributes we'd paint it with.
+// Arguments:
+// - cluster - the cluster we're about to paint
+// - coord - character coordinate within the viewport of the cluster
+// Return Value:
+// - true if painting the cluster wouldn't change anything.
+bool VtEngine::_ShadowMatches(const Cluster& cluster, const COORD coord) noexcept
+{
+    // We only remember single code unit clusters. Surrogate pairs and
+    // combining characters are always painted.
+    const auto text = cluster.GetText();
+    if (text.size() != 1 || cluster.GetColumns() == 0)
+    {
+        return false;
+    }
+
+    for (size_t i = 0; i < cluster.GetColumns(); i++)
+    {
+        const auto cell = _GetShadowCell({ gsl::narrow_cast<short>(coord.X + i), coord.Y });
+        if (!cell ||
+            cell->wch != text.front() ||
+            cell->trailing != (i != 0) ||
+            !(cell->attr == _lastTextAttributes))
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+// Routine Description:
+// - Records that the terminal now displays the given run of clusters. Columns
+//   at the end of the run that we didn't actually write (because we erased
+//   them, or left them blank) are marked as unknown.
+// Arguments:
+// - clusters - the run that was just painted
+// - coord - character coordinate within the viewport of the start of the run
+// - columnsWritten - the number of columns of the run that were written
+// Return Value:
+// - <none>
+void VtEngine::_UpdateShadow(gsl::span<const Cluster> const clusters, const COORD coord, const size_t columnsWritten) noexcept
+{
+    size_t column = 0;
+    for (const auto& cluster : clusters)
+    {
+        const auto text = cluster.GetText();
+        const bool known = text.size() == 1 && column + cluster.GetColumns() <= columnsWritten;
+        for (size_t i = 0; i < cluster.GetColumns(); i++)
+        {
+            if (const auto cell = _GetShadowCell({ gsl::narrow_cast<short>(coord.X + column + i), coord.Y }))
+            {
+                cell->wch = known ? text.front() : 0;
+                cell->trailing = i != 0;
+                cell->attr = _lastTextAttributes;
+            }
+        }
+        column += cluster.GetColumns();
+    }
+}
+
+// Routine Description:
+// - Moves the contents of the shadow by the given number of rows, the same
+//   way ScrollFrame moves the contents of the terminal. The rows that scroll
+//   into view are unknown.
+// Arguments:
+// - dy - the number of rows to move the contents down by. Negative to move
+//   them up.
+// Return Value:
+// - <none>
+void VtEngine::_ScrollShadow(const short dy) noexcept
+{
+    const auto width = gsl::narrow_cast<size_t>(_lastViewport.Width());
+    const auto rows = width ? _shadow.size() / width : 0;
+    const auto absDy = gsl::narrow_cast<size_t>(std::abs(dy));
+    if (absDy >= rows)
+    {
+        _ResetShadow();
+        return;
+    }
+
+    const auto distance = absDy * width;
+    if (dy < 0)
+    {
+        std::move(_shadow.begin() + distance, _shadow.end(), _shadow.begin());
+        std::fill(_shadow.end() - distance, _shadow.end(), ShadowCell{});
+    }
+    else
+    {
+        std::move_backward(_shadow.begin(), _shadow.end() - distance, _shadow.end());
+        std::fill(_shadow.begin(), _shadow.begin() + distance, ShadowCell{});
+    }
+}
+
+// Routine Description:
+// - Forgets everything we know about what the terminal is displaying, so that
+//   the next frame paints every invalid cell again.
+// Arguments:
+// - <none>
+// Return Value:
+// - <none>
+void VtEngine::_ResetShadow() noexcept
+{
+    std::fill(_shadow.begin(), _shadow.end(), ShadowCell{});
+}
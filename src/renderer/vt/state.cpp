@@ -63,6 +63,23 @@ VtEngine::VtEngine(_In_ wil::unique_hfile pipe,
     // member is only defined when UNIT_TESTING is.
     _usingTestCallback = false;
 #endif
+
+    _shadow.resize(gsl::narrow_cast<size_t>(initialViewport.Width()) * initialViewport.Height());
+}
+
+// Routine Description:
+// - Destroys the engine, after the writer thread wrote everything it was given.
+VtEngine::~VtEngine()
+{
+    if (_writerThread.joinable())
+    {
+        {
+            std::lock_guard<std::mutex> lock{ _flushMutex };
+            _writerExit = true;
+        }
+        _flushCV.notify_all();
+        _writerThread.join();
+    }
 }
 
 // Method Description:
@@ -75,6 +92,13 @@ VtEngine::VtEngine(_In_ wil::unique_hfile pipe,
 // - S_OK or suitable HRESULT error from writing pipe.
 [[nodiscard]] HRESULT VtEngine::_Write(std::string_view const str) noexcept
 {
+    // While we resync the shadow after a coordinated resize, the terminal
+    //      already shows what we paint.
+    if (_suppressOutput)
+    {
+        return S_OK;
+    }
+
     _trace.TraceString(str);
 #ifdef UNIT_TESTING
     if (_usingTestCallback)
@@ -113,25 +137,110 @@ VtEngine::VtEngine(_In_ wil::unique_hfile pipe,
     }
 #endif
 
-    if (!_pipeBroken)
+    if (_pipeBroken)
     {
-        bool fSuccess = !!WriteFile(_hFile.get(), _buffer.data(), gsl::narrow_cast<DWORD>(_buffer.size()), nullptr, nullptr);
-        _buffer.clear();
-        if (!fSuccess)
+        return S_OK;
+    }
+
+    auto hr = S_OK;
+    try
+    {
+        std::unique_lock<std::mutex> lock{ _flushMutex };
+        if (!_writerThread.joinable())
         {
-            _exitResult = HRESULT_FROM_WIN32(GetLastError());
-            _pipeBroken = true;
-            if (_terminalOwner)
+            _writerThread = std::thread{ [this]() { _WriterThread(); } };
+        }
+
+        if (SUCCEEDED(_writerResult) && !_buffer.empty())
+        {
+            // If the writer hasn't picked up the previous frames yet, this one
+            // is coalesced into them. Only wait for it once too much piled up.
+            if (_pendingBuffer.size() + _buffer.size() > FlushHighWaterMark)
+            {
+                _flushCV.wait(lock, [&]() { return _pendingBuffer.empty() || FAILED(_writerResult); });
+            }
+
+            if (_pendingBuffer.empty())
+            {
+                _pendingBuffer.swap(_buffer);
+            }
+            else
+            {
+                _pendingBuffer.append(_buffer);
+                _buffer.clear();
+            }
+            _flushCV.notify_all();
+
+            if (_flushSynchronously)
             {
-                _terminalOwner->CloseOutput();
+                _flushCV.wait(lock, [&]() { return (_pendingBuffer.empty() && !_writerBusy) || FAILED(_writerResult); });
             }
-            return _exitResult;
         }
+
+        hr = _writerResult;
+    }
+    CATCH_RETURN();
+
+    // The writer failed (usually because the terminal broke our pipe by
+    //      dying itself). Report it from here, so that CloseOutput is still
+    //      called from the thread that's rendering.
+    if (FAILED(hr))
+    {
+        _buffer.clear();
+        _exitResult = hr;
+        _pipeBroken = true;
+        if (_terminalOwner)
+        {
+            _terminalOwner->CloseOutput();
+        }
+        return _exitResult;
     }
 
     return S_OK;
 }
 
+// Method Description:
+// - The writer thread. Writes whatever _Flush handed it to our file handle,
+//      until the engine is destroyed or a write fails.
+// Arguments:
+// - <none>
+// Return Value:
+// - <none>
+void VtEngine::_WriterThread() noexcept
+{
+    std::string writing;
+    std::unique_lock<std::mutex> lock{ _flushMutex };
+    for (;;)
+    {
+        _flushCV.wait(lock, [&]() { return !_pendingBuffer.empty() || _writerExit; });
+        if (_pendingBuffer.empty())
+        {
+            // We were asked to exit and everything was written.
+            break;
+        }
+
+        // Take the pending frames and leave our (empty) buffer in their place,
+        // so _Flush can keep queueing more while we write these.
+        writing.swap(_pendingBuffer);
+        _writerBusy = true;
+        lock.unlock();
+
+        const auto fSuccess = !!WriteFile(_hFile.get(), writing.data(), gsl::narrow_cast<DWORD>(writing.size()), nullptr, nullptr);
+        const auto hr = fSuccess ? S_OK : HRESULT_FROM_WIN32(GetLastError());
+        writing.clear();
+
+        lock.lock();
+        _writerBusy = false;
+        _flushCV.notify_all();
+        if (FAILED(hr))
+        {
+            _writerResult = hr;
+            _pendingBuffer.clear();
+            break;
+        }
+    }
+}
+
 // Method Description:
 // - Wrapper for ITerminalOutputConnection. See _Write.
 [[nodiscard]] HRESULT VtEngine::WriteTerminalUtf8(const std::string_view str) noexcept
@@ -227,6 +336,24 @@ VtEngine::VtEngine(_In_ wil::unique_hfile pipe,
             hr = _ResizeWindow(newView.Width(), newView.Height());
         }
         _resized = true;
+
+        // If the terminal asked for this size itself, it already reflowed its
+        //      buffer, just like we reflowed ours. Repaint everything, but only
+        //      to find out again what the terminal shows. See StartPaint.
+        if (_coordinatedResize && _suppressResizeRepaint && !_firstPaint)
+        {
+            _resyncAfterResize = true;
+        }
+
+        // The terminal may reflow its contents however it likes, so we can't
+        // know what any cell holds anymore.
+        try
+        {
+            _shadow.clear();
+            _shadow.resize(gsl::narrow_cast<size_t>(newView.Width()) * newView.Height());
+            _mainShadow.clear();
+        }
+        CATCH_LOG();
     }
 
     // See MSFT:19408543
@@ -246,6 +373,10 @@ VtEngine::VtEngine(_In_ wil::unique_hfile pipe,
         // invalid. Previously, we'd invalidate everything if the width changed,
         // because we couldn't be sure if lines were reflowed.
         _invalidMap.resize(newView.Dimensions());
+        if (_resyncAfterResize)
+        {
+            hr = InvalidateAll();
+        }
     }
     else
     {
@@ -423,6 +554,46 @@ void VtEngine::SetResizeQuirk(const bool resizeQuirk)
     _resizeQuirk = resizeQuirk;
 }
 
+// Method Description:
+// - Configure the renderer for coordinated resizes. When the terminal resizes
+//   us, it reflows its own buffer the same way we reflow ours, so instead of
+//   repainting the viewport, the next frame only rebuilds what we believe the
+//   terminal displays, and moves the terminal's cursor to where ours is.
+// Arguments:
+// - coordinatedResize - true iff we were started with `--coordinatedResize`.
+// Return Value:
+// - <none>
+void VtEngine::SetCoordinatedResize(const bool coordinatedResize) noexcept
+{
+    _coordinatedResize = coordinatedResize;
+}
+
+// Method Description:
+// - Enables passthrough mode, where the VT that clients write is forwarded to
+//   the terminal by PassThroughString, and we stop rendering frames from the
+//   buffer. See VtIo::IsPassthroughModeEnabled.
+// Arguments:
+// - passthroughMode - true to enable passthrough mode
+// Return Value:
+// - <none>
+void VtEngine::SetPassthroughMode(const bool passthroughMode) noexcept
+{
+    _passthroughMode = passthroughMode;
+}
+
+// Method Description:
+// - Writes a string a client wrote to the terminal as is, and flushes it.
+// Arguments:
+// - str - the text (and VT sequences) the client wrote
+// Return Value:
+// - S_OK or suitable HRESULT error from either conversion or writing pipe.
+[[nodiscard]] HRESULT VtEngine::PassThroughString(const std::wstring_view str) noexcept
+{
+    _ResetShadow();
+    RETURN_IF_FAILED(_WriteTerminalUtf8(str));
+    return _Flush();
+}
+
 // Method Description:
 // - Manually emit a "Erase Scrollback" sequence to the connected terminal. We
 //   need to do this in certain cases that we've identified where we believe the
@@ -440,6 +611,21 @@ void VtEngine::SetResizeQuirk(const bool resizeQuirk)
     return S_OK;
 }
 
+// Method Description:
+// - Tell the connected terminal that the client switched to or from the
+//   alternate screen buffer.
+// - This is unimplemented in the win-telnet, xterm-ascii renderers - they
+//   repaint the whole viewport instead, like they always did. This _is_
+//   implemented in the Xterm256Engine.
+// Arguments:
+// - useAlternate - true if the alternate screen buffer is now active.
+// Return Value:
+// - S_OK if we wrote the sequences successfully, otherwise an appropriate HRESULT
+[[nodiscard]] HRESULT VtEngine::SwitchScreenBuffer(const bool /*useAlternate*/) noexcept
+{
+    return S_OK;
+}
+
 // Method Description:
 // - Send a sequence to the connected terminal to request win32-input-mode from
 //   them. This will enable the connected terminal to send us full INPUT_RECORDs
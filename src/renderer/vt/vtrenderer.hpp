@@ -22,6 +22,7 @@ Author(s):
 #include "tracing.hpp"
 #include <string>
 #include <functional>
+#include <condition_variable>
 
 // fwdecl unittest classes
 #ifdef UNIT_TESTING
@@ -43,7 +44,7 @@ namespace Microsoft::Console::Render
         VtEngine(_In_ wil::unique_hfile hPipe,
                  const Microsoft::Console::Types::Viewport initialViewport);
 
-        virtual ~VtEngine() override = default;
+        virtual ~VtEngine() override;
 
         [[nodiscard]] HRESULT InvalidateSelection(const std::vector<SMALL_RECT>& rectangles) noexcept override;
         [[nodiscard]] virtual HRESULT InvalidateScroll(const COORD* const pcoordDelta) noexcept = 0;
@@ -104,8 +105,12 @@ namespace Microsoft::Console::Render
         void EndResizeRequest();
 
         void SetResizeQuirk(const bool resizeQuirk);
+        void SetCoordinatedResize(const bool coordinatedResize) noexcept;
+        void SetPassthroughMode(const bool passthroughMode) noexcept;
+        [[nodiscard]] HRESULT PassThroughString(const std::wstring_view str) noexcept;
 
         [[nodiscard]] virtual HRESULT ManuallyClearScrollback() noexcept;
+        [[nodiscard]] virtual HRESULT SwitchScreenBuffer(const bool useAlternate) noexcept;
 
         [[nodiscard]] HRESULT RequestWin32Input() noexcept;
 
@@ -142,6 +147,21 @@ namespace Microsoft::Console::Render
 
         bool _pipeBroken;
         HRESULT _exitResult;
+
+        // _Flush hands _buffer off to a writer thread, so that rendering can
+        // continue while the terminal is slow to read from the pipe. Frames
+        // flushed while the writer is still busy are coalesced into
+        // _pendingBuffer, up to FlushHighWaterMark bytes. Everything below is
+        // guarded by _flushMutex.
+        static constexpr size_t FlushHighWaterMark = 1024 * 1024;
+        std::mutex _flushMutex;
+        std::condition_variable _flushCV;
+        std::thread _writerThread;
+        std::string _pendingBuffer;
+        bool _writerBusy{ false };
+        bool _writerExit{ false };
+        bool _flushSynchronously{ false };
+        HRESULT _writerResult{ S_OK };
         Microsoft::Console::ITerminalOwner* _terminalOwner;
 
         Microsoft::Console::VirtualTerminal::RenderTracing _trace;
@@ -152,10 +172,43 @@ namespace Microsoft::Console::Render
         bool _delayedEolWrap{ false };
 
         bool _resizeQuirk{ false };
+        bool _passthroughMode{ false };
+
+        // With a coordinated resize, the terminal reflows its own buffer the
+        // same way we reflow ours. The frame after it asked us for a new size
+        // is then only painted into the shadow, without writing anything, and
+        // only our cursor position is sent to reconcile the two.
+        bool _coordinatedResize{ false };
+        bool _resyncAfterResize{ false };
+        bool _suppressOutput{ false };
+        TextAttribute _resyncAttributes;
         std::optional<TextColor> _newBottomLineBG{ std::nullopt };
 
+        // What we believe the terminal is currently displaying in the
+        // viewport, one entry per cell. _PaintUtf8BufferLine uses this to skip
+        // the parts of a run that the terminal already shows. A cell with a
+        // wch of 0 is unknown and will always be painted.
+        struct ShadowCell
+        {
+            wchar_t wch{ 0 };
+            bool trailing{ false };
+            TextAttribute attr;
+        };
+        std::vector<ShadowCell> _shadow;
+        // The shadow of the main buffer, kept while the terminal shows its
+        // alternate buffer, so that switching back only repaints what changed.
+        std::vector<ShadowCell> _mainShadow;
+        bool _usingAltBuffer{ false };
+
+        ShadowCell* _GetShadowCell(const COORD coord) noexcept;
+        bool _ShadowMatches(const Cluster& cluster, const COORD coord) noexcept;
+        void _UpdateShadow(gsl::span<const Cluster> const clusters, const COORD coord, const size_t columnsWritten) noexcept;
+        void _ScrollShadow(const short dy) noexcept;
+        void _ResetShadow() noexcept;
+
         [[nodiscard]] HRESULT _Write(std::string_view const str) noexcept;
         [[nodiscard]] HRESULT _Flush() noexcept;
+        void _WriterThread() noexcept;
 
         template<typename S, typename... Args>
         [[nodiscard]] HRESULT _WriteFormatted(S&& format, Args&&... args)
@@ -216,7 +269,6 @@ namespace Microsoft::Console::Render
         [[nodiscard]] HRESULT _RequestWin32Input() noexcept;
 
         [[nodiscard]] virtual HRESULT _MoveCursor(const COORD coord) noexcept = 0;
-        [[nodiscard]] HRESULT _RgbUpdateDrawingBrushes(const TextAttribute& textAttributes) noexcept;
         [[nodiscard]] HRESULT _16ColorUpdateDrawingBrushes(const TextAttribute& textAttributes) noexcept;
 
         bool _WillWriteSingleChar() const;
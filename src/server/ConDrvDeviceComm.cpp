@@ -34,7 +34,8 @@ ConDrvDeviceComm::~ConDrvDeviceComm()
 // Routine Description:
 // - Retrieves a packet message from the driver representing the next action/activity that should be performed.
 // Arguments:
-// - pCompletion - Optional completion structure from the previous activity (can be used in lieu of calling CompleteIo separately.)
+// - pReplyMsg - Optional reply to the previous activity. Its completion is sent to the driver in the same
+//               IOCTL that receives the next message, saving a round-trip over calling CompleteIo separately.
 // - pMessage - A structure to hold the message data retrieved from the driver.
 // Return Value:
 // - HRESULT S_OK or suitable error.
@@ -12,6 +12,26 @@
 
 #include "../interactivity/inc/ServiceLocator.hpp"
 
+// Handles are mostly created and closed on the IO thread, but they're also
+// freed when a process or screen buffer goes away, so the pool is synchronized.
+// It's deliberately leaked, like the input event pool, so that handles
+// which are freed during process teardown stay safe.
+static std::pmr::synchronized_pool_resource& s_HandlePool()
+{
+    static auto pool = new std::pmr::synchronized_pool_resource{ til::pmr::get_default_resource() };
+    return *pool;
+}
+
+void* ConsoleHandleData::operator new(const size_t size)
+{
+    return s_HandlePool().allocate(size, alignof(ConsoleHandleData));
+}
+
+void ConsoleHandleData::operator delete(void* const p, const size_t size) noexcept
+{
+    s_HandlePool().deallocate(p, size, alignof(ConsoleHandleData));
+}
+
 ConsoleHandleData::ConsoleHandleData(const ACCESS_MASK amAccess,
                                      const ULONG ulShareAccess) :
     _ulHandleType(HandleType::NotReady),
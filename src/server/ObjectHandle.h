@@ -41,6 +41,11 @@ public:
     ConsoleHandleData& operator=(const ConsoleHandleData&) & = delete;
     ConsoleHandleData& operator=(ConsoleHandleData&&) & = delete;
 
+    // Every client that connects gets an input and an output handle, and
+    // closes them again when it disconnects, so they come from a pool.
+    static void* operator new(const size_t size);
+    static void operator delete(void* const p, const size_t size) noexcept;
+
     [[nodiscard]] HRESULT GetInputBuffer(const ACCESS_MASK amRequested,
                                          _Outptr_ InputBuffer** const ppInputBuffer) const;
     [[nodiscard]] HRESULT GetScreenBuffer(const ACCESS_MASK amRequested,
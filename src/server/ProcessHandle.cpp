@@ -8,6 +8,25 @@
 #include "../host/globals.h"
 #include "../host/telemetry.hpp"
 
+// Process records are only created and freed by the ConsoleProcessList while
+// the console is locked, but, just like the handle pool, it's synchronized and
+// leaked, so that it doesn't matter who frees the last records during teardown.
+static std::pmr::synchronized_pool_resource& s_ProcessPool()
+{
+    static auto pool = new std::pmr::synchronized_pool_resource{ til::pmr::get_default_resource() };
+    return *pool;
+}
+
+void* ConsoleProcessHandle::operator new(const size_t size)
+{
+    return s_ProcessPool().allocate(size, alignof(ConsoleProcessHandle));
+}
+
+void ConsoleProcessHandle::operator delete(void* const p, const size_t size) noexcept
+{
+    s_ProcessPool().deallocate(p, size, alignof(ConsoleProcessHandle));
+}
+
 // Routine Description:
 // - Constructs an instance of the ConsoleProcessHandle Class
 // - NOTE: Can throw if allocation fails or if there is a console policy we do not understand.
@@ -52,6 +52,11 @@ private:
     ConsoleProcessHandle& operator=(const ConsoleProcessHandle&) & = delete;
     ConsoleProcessHandle& operator=(ConsoleProcessHandle&&) & = delete;
 
+    // Clients can connect and disconnect at a high rate (think parallel
+    // builds spawning compilers), so their records come from a pool.
+    static void* operator new(const size_t size);
+    static void operator delete(void* const p, const size_t size) noexcept;
+
     ULONG _ulTerminateCount;
     ULONG const _ulProcessGroupId;
     wil::unique_handle const _hProcess;
@@ -61,11 +61,18 @@ using namespace Microsoft::Console::Interactivity;
         pProcessData = new ConsoleProcessHandle(dwProcessId,
                                                 dwThreadId,
                                                 ulProcessGroupId);
+        auto cleanup = wil::scope_exit([&]() noexcept {
+            _processesById.erase(dwProcessId);
+            delete pProcessData;
+        });
+
+        _processesById.emplace(dwProcessId, pProcessData);
 
         // Some applications, when reading the process list through the GetConsoleProcessList API, are expecting
         // the returned list of attached process IDs to be from newest to oldest.
         // As such, we have to put the newest process into the head of the list.
         _processes.push_front(pProcessData);
+        cleanup.release();
 
         if (nullptr != ppProcessData)
         {
@@ -91,6 +98,7 @@ void ConsoleProcessList::FreeProcessData(_In_ ConsoleProcessHandle* const pProce
     FAIL_FAST_IF(!(_processes.cend() != std::find(_processes.cbegin(), _processes.cend(), pProcessData)));
 
     _processes.remove(pProcessData);
+    _processesById.erase(pProcessData->dwProcessId);
 
     delete pProcessData;
 }
@@ -98,31 +106,29 @@ void ConsoleProcessList::FreeProcessData(_In_ ConsoleProcessHandle* const pProce
 // Routine Description:
 // - Locates a process handle in this list.
 // - NOTE: Calling FindProcessInList(0) means you want the root process.
+// - Every connecting client is looked up before it's added, so the list
+//   is indexed by process ID. Only the root process needs a scan.
 // Arguments:
 // - dwProcessId - ID of the process to search for or ROOT_PROCESS_ID to find the root process.
 // Return Value:
 // - Pointer to the process handle information or nullptr if no match was found.
 ConsoleProcessHandle* ConsoleProcessList::FindProcessInList(const DWORD dwProcessId) const
 {
+    if (ROOT_PROCESS_ID != dwProcessId)
+    {
+        const auto it = _processesById.find(dwProcessId);
+        return it != _processesById.cend() ? it->second : nullptr;
+    }
+
     auto it = _processes.cbegin();
 
     while (it != _processes.cend())
     {
         ConsoleProcessHandle* const pProcessHandleRecord = *it;
 
-        if (ROOT_PROCESS_ID != dwProcessId)
-        {
-            if (pProcessHandleRecord->dwProcessId == dwProcessId)
-            {
-                return pProcessHandleRecord;
-            }
-        }
-        else
+        if (pProcessHandleRecord->fRootProcess)
         {
-            if (pProcessHandleRecord->fRootProcess)
-            {
-                return pProcessHandleRecord;
-            }
+            return pProcessHandleRecord;
         }
 
         it = std::next(it);
@@ -60,6 +60,8 @@ public:
 
 private:
     std::list<ConsoleProcessHandle*> _processes;
+    // The same processes as in _processes, by their ID.
+    std::unordered_map<DWORD, ConsoleProcessHandle*> _processesById;
 
     void _ModifyProcessForegroundRights(const HANDLE hProcess, const bool fForeground) const;
 };
@@ -16,7 +16,7 @@
 // Routine Description:
 // - Initializes a ConsoleWaitBlock
 // - ConsoleWaitBlocks will mostly self-manage their position in their two queues.
-// - They will be pushed into the tail and the resulting iterator stored for constant deletion time later.
+// - They will be pushed into the tail of both, and remember their neighbors in each for constant deletion time later.
 // Arguments:
 // - pProcessQueue - The queue attached to the client process ID that requested this action
 // - pObjectQueue - The queue attached to the console object that will service the action when data arrives
@@ -67,14 +67,25 @@ ConsoleWaitBlock::ConsoleWaitBlock(_In_ ConsoleWaitQueue* const pProcessQueue,
 // Routine Description:
 // - Destroys a ConsolewaitBlock
 // - On deletion, ConsoleWaitBlocks will erase themselves from the process and object queues in
-//   constant time with the iterator acquired on construction.
+//   constant time through the links they keep for each.
 ConsoleWaitBlock::~ConsoleWaitBlock()
 {
-    _pProcessQueue->_blocks.erase(_itProcessQueue);
-    _pObjectQueue->_blocks.erase(_itObjectQueue);
+    _pProcessQueue->_Remove(this);
+    _pObjectQueue->_Remove(this);
     delete _pWaiter;
 }
 
+// Routine Description:
+// - Returns the links of this block within one of its two queues.
+// Arguments:
+// - pQueue - Either the process or the object queue of this block.
+// Return Value:
+// - The neighbors of this block in the given queue.
+ConsoleWaitBlock::QueueLink& ConsoleWaitBlock::_GetQueueLink(const ConsoleWaitQueue* const pQueue) noexcept
+{
+    return pQueue == _pProcessQueue ? _processQueueLink : _objectQueueLink;
+}
+
 // Routine Description:
 // - Creates and enqueues a new wait for later callback when a routine cannot be serviced at this time.
 // - Will extract the process ID and the target object, enqueuing in both to know when to callback
@@ -105,10 +116,6 @@ ConsoleWaitBlock::~ConsoleWaitBlock()
                                           pObjectQueue,
                                           pWaitReplyMessage,
                                           pWaiter);
-
-        // Set the iterators on the wait block so that it can remove itself later.
-        pWaitBlock->_itProcessQueue = pProcessQueue->_blocks.insert(pProcessQueue->_blocks.end(), pWaitBlock);
-        pWaitBlock->_itObjectQueue = pObjectQueue->_blocks.insert(pObjectQueue->_blocks.end(), pWaitBlock);
     }
     catch (...)
     {
@@ -117,6 +124,10 @@ ConsoleWaitBlock::~ConsoleWaitBlock()
         return hr;
     }
 
+    // Link the wait block into both queues so that it can remove itself later.
+    pProcessQueue->_PushBack(pWaitBlock);
+    pObjectQueue->_PushBack(pWaitBlock);
+
     return S_OK;
 }
 
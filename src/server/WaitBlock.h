@@ -21,8 +21,6 @@ Revision History:
 #include "IWaitRoutine.h"
 #include "WaitTerminationReason.h"
 
-#include <list>
-
 class ConsoleWaitQueue;
 
 class ConsoleWaitBlock
@@ -41,13 +39,24 @@ private:
                      const CONSOLE_API_MSG* const pWaitReplyMessage,
                      _In_ IWaitRoutine* const pWaiter);
 
+    // The neighbors of this block in one of the two queues it's in.
+    struct QueueLink
+    {
+        ConsoleWaitBlock* pPrev = nullptr;
+        ConsoleWaitBlock* pNext = nullptr;
+    };
+
+    QueueLink& _GetQueueLink(const ConsoleWaitQueue* const pQueue) noexcept;
+
     ConsoleWaitQueue* const _pProcessQueue;
-    std::_List_const_iterator<std::_List_val<std::_List_simple_types<ConsoleWaitBlock*>>> _itProcessQueue;
+    QueueLink _processQueueLink;
 
     ConsoleWaitQueue* const _pObjectQueue;
-    std::_List_const_iterator<std::_List_val<std::_List_simple_types<ConsoleWaitBlock*>>> _itObjectQueue;
+    QueueLink _objectQueueLink;
 
     CONSOLE_API_MSG _WaitReplyMessage;
 
     IWaitRoutine* const _pWaiter;
+
+    friend class ConsoleWaitQueue; // The queues are linked through the blocks' QueueLinks.
 };
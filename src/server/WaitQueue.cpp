@@ -12,7 +12,8 @@
 // Routine Description:
 // - Instantiates a new ConsoleWaitQueue
 ConsoleWaitQueue::ConsoleWaitQueue() :
-    _blocks()
+    _head(nullptr),
+    _tail(nullptr)
 {
 }
 
@@ -76,16 +77,10 @@ bool ConsoleWaitQueue::NotifyWaiters(const bool fNotifyAll,
 {
     bool fResult = false;
 
-    auto it = _blocks.cbegin();
-    while (!_blocks.empty() && it != _blocks.cend())
+    ConsoleWaitBlock* WaitBlock = _head;
+    while (nullptr != WaitBlock)
     {
-        ConsoleWaitBlock* const WaitBlock = (*it);
-        if (nullptr == WaitBlock)
-        {
-            break;
-        }
-
-        auto const nextIt = std::next(it); // we have to capture next before it is potentially erased
+        ConsoleWaitBlock* const NextBlock = WaitBlock->_GetQueueLink(this).pNext; // we have to capture next before it is potentially deleted
 
         if (_NotifyBlock(WaitBlock, TerminationReason))
         {
@@ -97,12 +92,66 @@ bool ConsoleWaitQueue::NotifyWaiters(const bool fNotifyAll,
             break;
         }
 
-        it = nextIt;
+        WaitBlock = NextBlock;
     }
 
     return fResult;
 }
 
+// Routine Description:
+// - Appends a block to the end of this queue.
+// Arguments:
+// - pWaitBlock - A block that isn't in this queue yet.
+// Return Value:
+// - <none>
+void ConsoleWaitQueue::_PushBack(_In_ ConsoleWaitBlock* const pWaitBlock) noexcept
+{
+    auto& link = pWaitBlock->_GetQueueLink(this);
+    link.pPrev = _tail;
+    link.pNext = nullptr;
+
+    if (nullptr != _tail)
+    {
+        _tail->_GetQueueLink(this).pNext = pWaitBlock;
+    }
+    else
+    {
+        _head = pWaitBlock;
+    }
+    _tail = pWaitBlock;
+}
+
+// Routine Description:
+// - Unlinks a block from this queue.
+// Arguments:
+// - pWaitBlock - A block in this queue.
+// Return Value:
+// - <none>
+void ConsoleWaitQueue::_Remove(_In_ ConsoleWaitBlock* const pWaitBlock) noexcept
+{
+    auto& link = pWaitBlock->_GetQueueLink(this);
+
+    if (nullptr != link.pPrev)
+    {
+        link.pPrev->_GetQueueLink(this).pNext = link.pNext;
+    }
+    else
+    {
+        _head = link.pNext;
+    }
+
+    if (nullptr != link.pNext)
+    {
+        link.pNext->_GetQueueLink(this).pPrev = link.pPrev;
+    }
+    else
+    {
+        _tail = link.pPrev;
+    }
+
+    link = {};
+}
+
 // Routine Description:
 // - A helper to delete successfully notified callbacks
 // Arguments:
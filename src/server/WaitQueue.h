@@ -17,8 +17,6 @@ Revision History:
 
 #pragma once
 
-#include <list>
-
 #include "../host/conapi.h"
 
 #include "IWaitRoutine.h"
@@ -44,7 +42,14 @@ private:
     bool _NotifyBlock(_In_ ConsoleWaitBlock* pWaitBlock,
                       const WaitTerminationReason TerminationReason);
 
-    std::list<ConsoleWaitBlock*> _blocks;
+    void _PushBack(_In_ ConsoleWaitBlock* const pWaitBlock) noexcept;
+    void _Remove(_In_ ConsoleWaitBlock* const pWaitBlock) noexcept;
+
+    // The blocks are linked through themselves, one link per queue they're in.
+    // Waiting thus doesn't allocate any list nodes, and a block removes itself
+    // from both of its queues in constant time.
+    ConsoleWaitBlock* _head;
+    ConsoleWaitBlock* _tail;
 
     friend class ConsoleWaitBlock; // Blocks live in multiple queues so we let them manage the lifetime.
 };
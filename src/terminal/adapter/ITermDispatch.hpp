@@ -82,6 +82,7 @@ public:
     virtual bool EnableAnyEventMouseMode(const bool enabled) = 0; // ?1003
     virtual bool EnableAlternateScroll(const bool enabled) = 0; // ?1007
     virtual bool EnableXtermBracketedPasteMode(const bool enabled) = 0; // ?2004
+    virtual bool EnableSynchronizedOutput(const bool enabled) = 0; // ?2026
     virtual bool SetColorTableEntry(const size_t tableIndex, const DWORD color) = 0; // OSCColorTable
     virtual bool SetDefaultForeground(const DWORD color) = 0; // OSCDefaultForeground
     virtual bool SetDefaultBackground(const DWORD color) = 0; // OSCDefaultBackground
@@ -90,6 +91,10 @@ public:
     virtual bool EraseInLine(const DispatchTypes::EraseType eraseType) = 0; // EL
     virtual bool EraseCharacters(const size_t numChars) = 0; // ECH
 
+    virtual bool CopyRectangularArea(const size_t top, const size_t left, const size_t bottom, const size_t right, const size_t dstTop, const size_t dstLeft) = 0; // DECCRA
+    virtual bool FillRectangularArea(const size_t ch, const size_t top, const size_t left, const size_t bottom, const size_t right) = 0; // DECFRA
+    virtual bool EraseRectangularArea(const size_t top, const size_t left, const size_t bottom, const size_t right) = 0; // DECERA
+
     virtual bool SetGraphicsRendition(const VTParameters options) = 0; // SGR
     virtual bool SetLineRendition(const LineRendition rendition) = 0; // DECSWL, DECDWL, DECDHL
 
@@ -132,6 +137,7 @@ public:
     virtual bool EndHyperlink() = 0;
 
     virtual bool DoConEmuAction(const std::wstring_view string) = 0;
+    virtual bool DoFinalTermAction(const std::wstring_view string) = 0;
 
     virtual StringHandler DownloadDRCS(const size_t fontNumber,
                                        const VTParameter startChar,
@@ -141,6 +147,10 @@ public:
                                        const DispatchTypes::DrcsFontUsage fontUsage,
                                        const VTParameter cellHeight,
                                        const DispatchTypes::DrcsCharsetSize charsetSize) = 0; // DECDLD
+
+    virtual StringHandler DefineSixelImage(const VTParameter macroParameter,
+                                           const VTParameter backgroundSelect,
+                                           const VTParameter gridSize) = 0; // DECSIXEL
 };
 inline Microsoft::Console::VirtualTerminal::ITermDispatch::~ITermDispatch() {}
 #pragma warning(pop)
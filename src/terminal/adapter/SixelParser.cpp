@@ -0,0 +1,366 @@
+// Copyright (c) Microsoft Corporation.
+// Licensed under the MIT license.
+
+#include "precomp.h"
+
+#include "SixelParser.hpp"
+
+using namespace Microsoft::Console::VirtualTerminal;
+
+// The default color table of the VT340, as RGB percentages.
+static constexpr std::array<std::array<uint8_t, 3>, 16> s_defaultColors = { {
+    { 0, 0, 0 }, // Black
+    { 20, 20, 80 }, // Blue
+    { 80, 13, 13 }, // Red
+    { 20, 80, 20 }, // Green
+    { 80, 20, 80 }, // Magenta
+    { 20, 80, 80 }, // Cyan
+    { 80, 80, 20 }, // Yellow
+    { 53, 53, 53 }, // Gray 50%
+    { 26, 26, 26 }, // Gray 25%
+    { 33, 33, 60 }, // Blue*
+    { 60, 26, 26 }, // Red*
+    { 33, 60, 33 }, // Green*
+    { 60, 33, 60 }, // Magenta*
+    { 33, 60, 60 }, // Cyan*
+    { 60, 60, 33 }, // Yellow*
+    { 80, 80, 80 }, // Gray 75%
+} };
+
+SixelParser::SixelParser(const VTParameter aspectRatio, const VTParameter backgroundSelect) noexcept
+{
+    // The macro parameter selects the vertical size of a pixel, as a multiple of its width.
+    switch (aspectRatio.value_or(0))
+    {
+    case 2:
+        _aspectRatio = 5;
+        break;
+    case 3:
+    case 4:
+        _aspectRatio = 3;
+        break;
+    case 7:
+    case 8:
+    case 9:
+        _aspectRatio = 1;
+        break;
+    default:
+        _aspectRatio = 2;
+        break;
+    }
+
+    for (size_t i = 0; i < _colorTable.size(); i++)
+    {
+        const auto& rgb = i < s_defaultColors.size() ? til::at(s_defaultColors, i) : s_defaultColors.front();
+        til::at(_colorTable, i) = _makeColor(rgb[0], rgb[1], rgb[2]);
+    }
+    _foregroundColor = til::at(_colorTable, 7);
+
+    // If the background select is 1, the pixels that aren't drawn remain
+    // transparent. Otherwise they're filled with the color of register 0.
+    _backgroundColor = backgroundSelect.value_or(0) == 1 ? 0 : _colorTable.front();
+}
+
+// Routine Description:
+// - Decodes the next character of the data string.
+// Arguments:
+// - ch - the character to decode
+// Return Value:
+// - <none>
+void SixelParser::AddData(const wchar_t ch)
+{
+    // The commands with parameters are only executed once all of their
+    // parameters have been received, i.e. on the first character following them.
+    if (_state != State::Data)
+    {
+        if ((ch >= L'0' && ch <= L'9') || ch == L';')
+        {
+            _addParameter(ch);
+            return;
+        }
+        _executeCommand();
+    }
+
+    switch (ch)
+    {
+    case L'"':
+        _state = State::RasterAttributes;
+        break;
+    case L'!':
+        _state = State::RepeatIntroducer;
+        break;
+    case L'#':
+        _state = State::ColorIntroducer;
+        break;
+    case L'$':
+        _carriageReturn();
+        break;
+    case L'-':
+        _lineFeed();
+        break;
+    default:
+        if (ch >= L'?' && ch <= L'~')
+        {
+            _addSixelValue(ch - L'?');
+        }
+        // Anything else, like control characters, is ignored.
+        break;
+    }
+
+    if (_state != State::Data)
+    {
+        _parameters = {};
+        _parameterCount = 1;
+    }
+}
+
+// Routine Description:
+// - Completes the image once the end of the data string has been reached.
+//   The image is at least as large as what the raster attributes declared.
+// Arguments:
+// - <none>
+// Return Value:
+// - The decoded image. It has a width and height of 0 if nothing was drawn.
+InlineImage SixelParser::Finalize()
+{
+    if (_state != State::Data)
+    {
+        _executeCommand();
+    }
+
+    InlineImage image;
+    const auto width = std::max(_declaredWidth, _usedWidth);
+    const auto height = std::max(_declaredHeight, _usedHeight);
+    if (width == 0 || height == 0)
+    {
+        return image;
+    }
+
+    _reserve(width, height);
+
+    image.width = width;
+    image.height = height;
+    image.cellWidth = CELL_WIDTH;
+    image.cellHeight = CELL_HEIGHT;
+    if (_stride == width)
+    {
+        _pixels.resize(width * height);
+        image.pixels = std::move(_pixels);
+    }
+    else
+    {
+        image.pixels.resize(width * height);
+        for (size_t row = 0; row < height; row++)
+        {
+            const auto source = _pixels.begin() + row * _stride;
+            std::copy(source, source + width, image.pixels.begin() + row * width);
+        }
+    }
+
+    _pixels = {};
+    _stride = 0;
+    _rows = 0;
+    return image;
+}
+
+void SixelParser::_executeCommand()
+{
+    switch (_state)
+    {
+    case State::RasterAttributes:
+        _applyRasterAttributes();
+        break;
+    case State::RepeatIntroducer:
+        _repeatCount = std::max<size_t>(_parameters.front(), 1);
+        break;
+    case State::ColorIntroducer:
+        _defineColor();
+        break;
+    default:
+        break;
+    }
+    _state = State::Data;
+}
+
+void SixelParser::_addParameter(const wchar_t ch) noexcept
+{
+    if (ch == L';')
+    {
+        // Any parameters beyond the ones we support are ignored.
+        _parameterCount = std::min(_parameterCount + 1, MAX_PARAMETERS + 1);
+    }
+    else if (_parameterCount <= MAX_PARAMETERS)
+    {
+        auto& parameter = til::at(_parameters, _parameterCount - 1);
+        // Large values are saturated. None of the parameters can usefully exceed this.
+        parameter = std::min<size_t>(parameter * 10 + (ch - L'0'), 65535);
+    }
+}
+
+void SixelParser::_applyRasterAttributes()
+{
+    // The raster attributes have no effect once the sixel data has started.
+    if (_sawSixelData)
+    {
+        return;
+    }
+
+    // The first two parameters define the pixel aspect ratio as a fraction.
+    const auto numerator = _parameters.at(0);
+    const auto denominator = _parameters.at(1);
+    if (numerator > 0 && denominator > 0)
+    {
+        _aspectRatio = std::clamp<size_t>((numerator + denominator / 2) / denominator, 1, 10);
+    }
+
+    // The other two define the size of the image.
+    if (_parameterCount >= 4)
+    {
+        _declaredWidth = std::min(_parameters.at(2), MAX_WIDTH);
+        _declaredHeight = std::min(_parameters.at(3), MAX_HEIGHT);
+        _reserve(_declaredWidth, _declaredHeight);
+    }
+}
+
+void SixelParser::_defineColor() noexcept
+{
+    auto& color = til::at(_colorTable, _parameters.at(0) % MAX_COLORS);
+
+    // With a single parameter, the color is only selected. With all of
+    // them, the color is defined in either the HLS or the RGB color space.
+    if (_parameterCount >= 5)
+    {
+        const auto x = _parameters.at(2);
+        const auto y = _parameters.at(3);
+        const auto z = _parameters.at(4);
+        switch (_parameters.at(1))
+        {
+        case 1:
+            color = _makeColorFromHls(x, y, z);
+            break;
+        case 2:
+            color = _makeColor(x, y, z);
+            break;
+        default:
+            break;
+        }
+    }
+
+    _foregroundColor = color;
+}
+
+void SixelParser::_addSixelValue(const size_t value)
+{
+    _sawSixelData = true;
+
+    // A sixel describes a column of 6 pixels, each of which is as tall as the aspect ratio.
+    const auto count = std::exchange(_repeatCount, 1);
+    const auto left = _x;
+    const auto right = std::min(_x + count, MAX_WIDTH);
+    const auto top = _y;
+    const auto bottom = std::min(_y + 6 * _aspectRatio, MAX_HEIGHT);
+    _x = right;
+
+    if (left >= right || top >= bottom)
+    {
+        return;
+    }
+
+    _usedWidth = std::max(_usedWidth, right);
+    _usedHeight = std::max(_usedHeight, bottom);
+
+    if (value == 0)
+    {
+        return;
+    }
+
+    _reserve(right, bottom);
+    for (size_t bit = 0; bit < 6; bit++)
+    {
+        if ((value & (size_t{ 1 } << bit)) != 0)
+        {
+            const auto firstRow = top + bit * _aspectRatio;
+            const auto lastRow = std::min(firstRow + _aspectRatio, bottom);
+            for (auto row = firstRow; row < lastRow; row++)
+            {
+                const auto begin = _pixels.begin() + row * _stride;
+                std::fill(begin + left, begin + right, _foregroundColor);
+            }
+        }
+    }
+}
+
+void SixelParser::_carriageReturn() noexcept
+{
+    _x = 0;
+}
+
+void SixelParser::_lineFeed() noexcept
+{
+    _x = 0;
+    _y = std::min(_y + 6 * _aspectRatio, MAX_HEIGHT);
+}
+
+void SixelParser::_reserve(const size_t width, const size_t height)
+{
+    // Rows are grown to at least twice their width, so that images without
+    // raster attributes don't have to be relaid when every sixel is added.
+    if (width > _stride)
+    {
+        const auto stride = std::max(width, std::min(_stride * 2, MAX_WIDTH));
+        std::vector<uint32_t> pixels(stride * _rows, _backgroundColor);
+        for (size_t row = 0; row < _rows; row++)
+        {
+            const auto source = _pixels.begin() + row * _stride;
+            std::copy(source, source + _stride, pixels.begin() + row * stride);
+        }
+        _pixels = std::move(pixels);
+        _stride = stride;
+    }
+
+    if (height > _rows)
+    {
+        _pixels.resize(_stride * height, _backgroundColor);
+        _rows = height;
+    }
+}
+
+uint32_t SixelParser::_makeColor(const size_t red, const size_t green, const size_t blue) noexcept
+{
+    // The components are percentages, which are converted to the 0-255 range.
+    const auto scale = [](const size_t percent) noexcept {
+        return gsl::narrow_cast<uint32_t>((std::min<size_t>(percent, 100) * 255 + 50) / 100);
+    };
+    return 0xFF000000 | (scale(red) << 16) | (scale(green) << 8) | scale(blue);
+}
+
+uint32_t SixelParser::_makeColorFromHls(const size_t hue, const size_t lightness, const size_t saturation) noexcept
+{
+    // The VT340 places blue at 0 degrees, red at 120 and green at 240,
+    // so the hue is rotated to the more common red at 0 degrees first.
+    const auto h = static_cast<float>((hue + 240) % 360) / 360.0f;
+    const auto l = static_cast<float>(std::min<size_t>(lightness, 100)) / 100.0f;
+    const auto s = static_cast<float>(std::min<size_t>(saturation, 100)) / 100.0f;
+
+    const auto q = l < 0.5f ? l * (1.0f + s) : l + s - l * s;
+    const auto p = 2.0f * l - q;
+    const auto component = [=](float t) noexcept {
+        t = t < 0.0f ? t + 1.0f : (t > 1.0f ? t - 1.0f : t);
+        auto value = p;
+        if (t < 1.0f / 6.0f)
+        {
+            value = p + (q - p) * 6.0f * t;
+        }
+        else if (t < 1.0f / 2.0f)
+        {
+            value = q;
+        }
+        else if (t < 2.0f / 3.0f)
+        {
+            value = p + (q - p) * (2.0f / 3.0f - t) * 6.0f;
+        }
+        return gsl::narrow_cast<uint32_t>(lroundf(value * 255.0f));
+    };
+
+    return 0xFF000000 | (component(h + 1.0f / 3.0f) << 16) | (component(h) << 8) | component(h - 1.0f / 3.0f);
+}
@@ -0,0 +1,81 @@
+/*++
+Copyright (c) Microsoft Corporation
+Licensed under the MIT license.
+
+Module Name:
+- SixelParser.hpp
+
+Abstract:
+- This decodes the data string of a Sixel graphics sequence into an image.
+- The data is decoded as it streams in, one character at a time, so at the
+  end of the sequence the image is ready to be placed into the buffer.
+--*/
+
+#pragma once
+
+#include "DispatchTypes.hpp"
+#include "../../buffer/out/ImageCache.hpp"
+
+namespace Microsoft::Console::VirtualTerminal
+{
+    class SixelParser
+    {
+    public:
+        // Sixel images are laid out on the character grid of a VT340,
+        // which has a cell size of 10 by 20 pixels.
+        static constexpr size_t CELL_WIDTH = 10;
+        static constexpr size_t CELL_HEIGHT = 20;
+
+        SixelParser(const VTParameter aspectRatio, const VTParameter backgroundSelect) noexcept;
+        void AddData(const wchar_t ch);
+        InlineImage Finalize();
+
+    private:
+        static constexpr size_t MAX_WIDTH = 2048;
+        static constexpr size_t MAX_HEIGHT = 2048;
+        static constexpr size_t MAX_PARAMETERS = 5;
+        static constexpr size_t MAX_COLORS = 256;
+
+        enum class State
+        {
+            Data,
+            RasterAttributes,
+            RepeatIntroducer,
+            ColorIntroducer
+        };
+
+        void _executeCommand();
+        void _addParameter(const wchar_t ch) noexcept;
+        void _applyRasterAttributes();
+        void _defineColor() noexcept;
+        void _addSixelValue(const size_t value);
+        void _carriageReturn() noexcept;
+        void _lineFeed() noexcept;
+        void _reserve(const size_t width, const size_t height);
+
+        static uint32_t _makeColor(const size_t red, const size_t green, const size_t blue) noexcept;
+        static uint32_t _makeColorFromHls(const size_t hue, const size_t lightness, const size_t saturation) noexcept;
+
+        State _state = State::Data;
+        std::array<size_t, MAX_PARAMETERS> _parameters{};
+        size_t _parameterCount = 0;
+
+        std::array<uint32_t, MAX_COLORS> _colorTable;
+        uint32_t _foregroundColor;
+        uint32_t _backgroundColor;
+        size_t _repeatCount = 1;
+        size_t _aspectRatio;
+
+        bool _sawSixelData = false;
+        size_t _declaredWidth = 0;
+        size_t _declaredHeight = 0;
+        size_t _usedWidth = 0;
+        size_t _usedHeight = 0;
+        size_t _x = 0;
+        size_t _y = 0;
+
+        size_t _stride = 0;
+        size_t _rows = 0;
+        std::vector<uint32_t> _pixels;
+    };
+}
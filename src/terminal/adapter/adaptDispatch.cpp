@@ -72,11 +72,7 @@ void AdaptDispatch::PrintString(const std::wstring_view string)
         if (_termOutput.NeedToTranslate())
         {
             std::wstring buffer;
-            buffer.reserve(string.size());
-            for (auto& wch : string)
-            {
-                buffer.push_back(_termOutput.TranslateKey(wch));
-            }
+            _termOutput.TranslateString(string, buffer);
             _pDefaults->PrintString(buffer);
         }
         else
@@ -571,6 +567,136 @@ bool AdaptDispatch::EraseCharacters(const size_t numChars)
     return success;
 }
 
+// Routine Description:
+// - Converts the coordinates of a rectangular area operation into an inclusive
+//     buffer rectangle. The coordinates are 1-based and relative to the top of
+//     the viewport, or the top margin when the origin mode is relative. A bottom
+//     or right of 0 extends the area to the edge of the page. The result is
+//     clamped to the page, as are the operations.
+// Arguments:
+// - csbiex - The screen buffer information, for the viewport and buffer size.
+// - top, left - The top left corner of the area. 0 is treated as 1.
+// - bottom, right - The bottom right corner of the area (inclusive).
+// - area - Receives the rectangle in buffer coordinates.
+// Return Value:
+// - True if the area isn't empty. False otherwise.
+bool AdaptDispatch::_CalculateRectArea(const CONSOLE_SCREEN_BUFFER_INFOEX& csbiex,
+                                       const size_t top,
+                                       const size_t left,
+                                       const size_t bottom,
+                                       const size_t right,
+                                       SMALL_RECT& area) const
+{
+    // srWindow is exclusive so we need to subtract 1 from the bottom.
+    int pageTop = csbiex.srWindow.Top;
+    int pageBottom = csbiex.srWindow.Bottom - 1;
+    const int pageRight = csbiex.dwSize.X - 1;
+
+    const bool marginsSet = _scrollMargins.Top < _scrollMargins.Bottom;
+    if (_isOriginModeRelative && marginsSet)
+    {
+        pageBottom = pageTop + _scrollMargins.Bottom;
+        pageTop += _scrollMargins.Top;
+    }
+
+    // Anything past the page is clamped anyway, so there's no need to look at huge values.
+    const auto toOffset = [](const size_t value) {
+        return gsl::narrow_cast<int>(std::min<size_t>(std::max<size_t>(value, 1), SHRT_MAX)) - 1;
+    };
+
+    area.Top = gsl::narrow_cast<SHORT>(std::clamp(pageTop + toOffset(top), pageTop, pageBottom));
+    area.Left = gsl::narrow_cast<SHORT>(std::clamp(toOffset(left), 0, pageRight));
+    area.Bottom = gsl::narrow_cast<SHORT>(bottom ? std::clamp(pageTop + toOffset(bottom), pageTop, pageBottom) : pageBottom);
+    area.Right = gsl::narrow_cast<SHORT>(right ? std::clamp(toOffset(right), 0, pageRight) : pageRight);
+    return area.Top <= area.Bottom && area.Left <= area.Right;
+}
+
+// Routine Description:
+// - DECCRA - Copies a rectangular area of the page, including its attributes,
+//     to another position on it. The source area is left as it was, unless the
+//     two overlap. Whatever doesn't fit on the page is clipped.
+// Arguments:
+// - top, left, bottom, right - The source area (see _CalculateRectArea).
+// - dstTop, dstLeft - The top left corner of the destination.
+// Return Value:
+// - True if handled successfully. False otherwise.
+bool AdaptDispatch::CopyRectangularArea(const size_t top, const size_t left, const size_t bottom, const size_t right, const size_t dstTop, const size_t dstLeft)
+{
+    CONSOLE_SCREEN_BUFFER_INFOEX csbiex = { 0 };
+    csbiex.cbSize = sizeof(CONSOLE_SCREEN_BUFFER_INFOEX);
+    bool success = _pConApi->GetConsoleScreenBufferInfoEx(csbiex);
+
+    SMALL_RECT source;
+    if (success && _CalculateRectArea(csbiex, top, left, bottom, right, source))
+    {
+        // The destination is as large as the source, unless it's clipped at the edges of the page.
+        const auto height = gsl::narrow_cast<size_t>(source.Bottom - source.Top);
+        const auto width = gsl::narrow_cast<size_t>(source.Right - source.Left);
+        SMALL_RECT target;
+        if (_CalculateRectArea(csbiex, dstTop, dstLeft, std::max<size_t>(dstTop, 1) + height, std::max<size_t>(dstLeft, 1) + width, target))
+        {
+            source.Bottom = gsl::narrow_cast<SHORT>(source.Top + target.Bottom - target.Top);
+            source.Right = gsl::narrow_cast<SHORT>(source.Left + target.Right - target.Left);
+            success = _pConApi->PrivateCopyRectangle(source, { target.Left, target.Top });
+        }
+    }
+    return success;
+}
+
+// Routine Description:
+// - DECFRA - Fills a rectangular area of the page with the given character,
+//     using the currently selected attributes.
+// Arguments:
+// - ch - The decimal value of the character to fill with. Values that aren't
+//        printable (outside 32-126 and 160-255) cause the sequence to be ignored.
+// - top, left, bottom, right - The area to fill (see _CalculateRectArea).
+// Return Value:
+// - True if handled successfully. False otherwise.
+bool AdaptDispatch::FillRectangularArea(const size_t ch, const size_t top, const size_t left, const size_t bottom, const size_t right)
+{
+    const bool printable = (ch >= 32 && ch <= 126) || (ch >= 160 && ch <= 255);
+    if (!printable)
+    {
+        return true;
+    }
+
+    CONSOLE_SCREEN_BUFFER_INFOEX csbiex = { 0 };
+    csbiex.cbSize = sizeof(CONSOLE_SCREEN_BUFFER_INFOEX);
+    TextAttribute attrs;
+    bool success = _pConApi->GetConsoleScreenBufferInfoEx(csbiex) && _pConApi->PrivateGetTextAttributes(attrs);
+
+    SMALL_RECT area;
+    if (success && _CalculateRectArea(csbiex, top, left, bottom, right, area))
+    {
+        success = _pConApi->PrivateFillRectangle(area, gsl::narrow_cast<wchar_t>(ch), attrs);
+    }
+    return success;
+}
+
+// Routine Description:
+// - DECERA - Erases a rectangular area of the page by replacing it with spaces.
+//     Like the other erase operations, the area receives the current background
+//     color, but no other attributes.
+// Arguments:
+// - top, left, bottom, right - The area to erase (see _CalculateRectArea).
+// Return Value:
+// - True if handled successfully. False otherwise.
+bool AdaptDispatch::EraseRectangularArea(const size_t top, const size_t left, const size_t bottom, const size_t right)
+{
+    CONSOLE_SCREEN_BUFFER_INFOEX csbiex = { 0 };
+    csbiex.cbSize = sizeof(CONSOLE_SCREEN_BUFFER_INFOEX);
+    TextAttribute attrs;
+    bool success = _pConApi->GetConsoleScreenBufferInfoEx(csbiex) && _pConApi->PrivateGetTextAttributes(attrs);
+
+    SMALL_RECT area;
+    if (success && _CalculateRectArea(csbiex, top, left, bottom, right, area))
+    {
+        attrs.SetStandardErase();
+        success = _pConApi->PrivateFillRectangle(area, L' ', attrs);
+    }
+    return success;
+}
+
 // Routine Description:
 // - ED - Erases a portion of the current viewable area (viewport) of the console.
 // Arguments:
@@ -621,23 +747,6 @@ bool AdaptDispatch::EraseInDisplay(const DispatchTypes::EraseType eraseType)
 
     if (success)
     {
-        // When erasing the display, every line that is erased in full should be
-        // reset to single width. When erasing to the end, this could include
-        // the current line, if the cursor is in the first column. When erasing
-        // from the beginning, though, the current line would never be included,
-        // because the cursor could never be in the rightmost column (assuming
-        // the line is double width).
-        if (eraseType == DispatchTypes::EraseType::FromBeginning)
-        {
-            const auto endRow = csbiex.dwCursorPosition.Y;
-            _pConApi->PrivateResetLineRenditionRange(csbiex.srWindow.Top, endRow);
-        }
-        if (eraseType == DispatchTypes::EraseType::ToEnd)
-        {
-            const auto startRow = csbiex.dwCursorPosition.Y + (csbiex.dwCursorPosition.X > 0 ? 1 : 0);
-            _pConApi->PrivateResetLineRenditionRange(startRow, csbiex.srWindow.Bottom);
-        }
-
         // What we need to erase is grouped into 3 types:
         // 1. Lines before cursor
         // 2. Cursor Line
@@ -646,44 +755,40 @@ bool AdaptDispatch::EraseInDisplay(const DispatchTypes::EraseType eraseType)
         // A. FromBeginning - Erase 1 and Some of 2.
         // B. ToEnd - Erase some of 2 and 3.
         // C. All - Erase 1, 2, and 3.
+        //
+        // Lines that are erased in full are reset as a whole, which also resets
+        // them to single width. When erasing to the end, this includes the
+        // current line if the cursor is in the first column. When erasing from
+        // the beginning, though, the current line is never included, because
+        // the cursor could never be in the rightmost column (assuming the line
+        // is double width).
 
         // 1. Lines before cursor line
         if (eraseType == DispatchTypes::EraseType::FromBeginning)
         {
-            // For beginning and all, erase all complete lines before (above vertically) from the cursor position.
-            for (SHORT startLine = csbiex.srWindow.Top; startLine < csbiex.dwCursorPosition.Y; startLine++)
+            success = _pConApi->PrivateEraseRows(csbiex.srWindow.Top, csbiex.dwCursorPosition.Y, true);
+            if (success)
             {
-                success = _EraseSingleLineHelper(csbiex, DispatchTypes::EraseType::All, startLine);
-
-                if (!success)
-                {
-                    break;
-                }
+                // 2. Cursor Line
+                success = _EraseSingleLineHelper(csbiex, eraseType, csbiex.dwCursorPosition.Y);
             }
         }
 
-        if (success)
+        if (eraseType == DispatchTypes::EraseType::ToEnd)
         {
             // 2. Cursor Line
-            success = _EraseSingleLineHelper(csbiex, eraseType, csbiex.dwCursorPosition.Y);
-        }
+            const bool cursorLineInFull = csbiex.dwCursorPosition.X == 0;
+            if (!cursorLineInFull)
+            {
+                success = _EraseSingleLineHelper(csbiex, eraseType, csbiex.dwCursorPosition.Y);
+            }
 
-        if (success)
-        {
-            // 3. Lines after cursor line
-            if (eraseType == DispatchTypes::EraseType::ToEnd)
+            if (success)
             {
-                // For beginning and all, erase all complete lines after (below vertically) the cursor position.
+                // 3. Lines after cursor line
                 // Remember that the viewport bottom value is 1 beyond the viewable area of the viewport.
-                for (SHORT startLine = csbiex.dwCursorPosition.Y + 1; startLine < csbiex.srWindow.Bottom; startLine++)
-                {
-                    success = _EraseSingleLineHelper(csbiex, DispatchTypes::EraseType::All, startLine);
-
-                    if (!success)
-                    {
-                        break;
-                    }
-                }
+                const auto startRow = csbiex.dwCursorPosition.Y + (cursorLineInFull ? 0 : 1);
+                success = _pConApi->PrivateEraseRows(startRow, csbiex.srWindow.Bottom, true);
             }
         }
     }
@@ -1127,6 +1232,9 @@ bool AdaptDispatch::_ModeParamsHelper(const DispatchTypes::ModeParams param, con
     case DispatchTypes::ModeParams::ASB_AlternateScreenBuffer:
         success = enable ? UseAlternateScreenBuffer() : UseMainScreenBuffer();
         break;
+    case DispatchTypes::ModeParams::SO_SynchronizedOutput:
+        success = EnableSynchronizedOutput(enable);
+        break;
     case DispatchTypes::ModeParams::W32IM_Win32InputMode:
         success = EnableWin32InputMode(enable);
         break;
@@ -1927,6 +2035,9 @@ bool AdaptDispatch::HardReset()
     success = EnableSGRExtendedMouseMode(false) && success;
     success = EnableAnyEventMouseMode(false) && success;
 
+    // Don't leave the renderer waiting on an update that will never finish.
+    success = EnableSynchronizedOutput(false) && success;
+
     // Delete all current tab stops and reapply
     _ResetTabStops();
 
@@ -2029,13 +2140,9 @@ bool AdaptDispatch::_EraseScrollback()
         success = _pConApi->PrivateScrollRegion(scroll, std::nullopt, destination, false);
         if (success)
         {
-            // Clear everything after the viewport.
-            const DWORD totalAreaBelow = csbiex.dwSize.X * (csbiex.dwSize.Y - height);
-            const COORD coordBelowStartPosition = { 0, height };
+            // Clear everything after the viewport. This also resets the line rendition of the cleared rows.
             // Again we need to use the default attributes, hence standardFillAttrs is false.
-            success = _pConApi->PrivateFillRegion(coordBelowStartPosition, totalAreaBelow, L' ', false);
-            // Also reset the line rendition for all of the cleared rows.
-            success = success && _pConApi->PrivateResetLineRenditionRange(height, csbiex.dwSize.Y);
+            success = _pConApi->PrivateEraseRows(height, csbiex.dwSize.Y, false);
 
             if (success)
             {
@@ -2217,6 +2324,20 @@ bool AdaptDispatch::EnableXtermBracketedPasteMode(const bool /*enabled*/) noexce
     return NoOp();
 }
 
+//Routine Description:
+// Enable "synchronized output". While it's enabled, the renderer holds off
+//      painting, so that an application's redraw is presented as a single frame.
+//      In conpty this holds back the VT renderer as well, so the connected
+//      terminal receives the frame in one piece, and the sequence isn't passed on.
+//Arguments:
+// - enabled - true to begin a synchronized update, false to end it.
+// Return value:
+// True if handled successfully. False otherwise.
+bool AdaptDispatch::EnableSynchronizedOutput(const bool enabled)
+{
+    return _pConApi->PrivateEnableSynchronizedOutput(enabled);
+}
+
 //Routine Description:
 // Set Cursor Style - Changes the cursor's style to match the given Dispatch
 //      cursor style. Unix styles are a combination of the shape and the blinking state.
@@ -2445,6 +2566,16 @@ bool AdaptDispatch::DoConEmuAction(const std::wstring_view /*string*/) noexcept
     return false;
 }
 
+// Method Description:
+// - Ascribes to the ITermDispatch interface
+// - Not actually used in conhost
+// Return Value:
+// - false (so that the command gets flushed to terminal)
+bool AdaptDispatch::DoFinalTermAction(const std::wstring_view /*string*/) noexcept
+{
+    return false;
+}
+
 // Method Description:
 // - DECDLD - Downloads one or more characters of a dynamically redefinable
 //   character set (DRCS) with a specified pixel pattern. The pixel array is
@@ -2527,6 +2658,46 @@ ITermDispatch::StringHandler AdaptDispatch::DownloadDRCS(const size_t fontNumber
     };
 }
 
+// Routine Description:
+// - DECSIXEL - Displays an image defined in the Sixel graphics format. The
+//   image is placed at the cursor position, and the cursor moves down with
+//   each row of cells that the image covers, scrolling if necessary.
+// Arguments:
+// - macroParameter - Selects the pixel aspect ratio.
+// - backgroundSelect - 1 leaves the pixels that aren't drawn transparent.
+// - gridSize - The horizontal grid size. Ignored, as it's obsolete.
+// Return value:
+// - a function to receive the data or nullptr if the sequence isn't supported
+ITermDispatch::StringHandler AdaptDispatch::DefineSixelImage(const VTParameter macroParameter,
+                                                             const VTParameter backgroundSelect,
+                                                             const VTParameter /*gridSize*/)
+{
+    // If we're a conpty, we're just going to ignore the operation for now,
+    // just like the soft fonts.
+    if (_pConApi->IsConsolePty())
+    {
+        return nullptr;
+    }
+
+    // The data is decoded as it arrives, so the parser has to outlive the call.
+    const auto sixelParser = std::make_shared<SixelParser>(macroParameter, backgroundSelect);
+    return [=](const auto ch) {
+        if (ch != AsciiChars::ESC)
+        {
+            sixelParser->AddData(ch);
+        }
+        else
+        {
+            auto image = sixelParser->Finalize();
+            if (image.width > 0 && image.height > 0)
+            {
+                _pConApi->PrivatePlaceImage(std::move(image));
+            }
+        }
+        return true;
+    };
+}
+
 // Routine Description:
 // - Determines whether we should pass any sequence that manipulates
 //   TerminalInput's input generator through the PTY. It encapsulates
@@ -19,6 +19,7 @@ Author(s):
 #include "conGetSet.hpp"
 #include "adaptDefaults.hpp"
 #include "FontBuffer.hpp"
+#include "SixelParser.hpp"
 #include "terminalOutput.hpp"
 #include "..\..\types\inc\sgrStack.hpp"
 
@@ -55,6 +56,9 @@ namespace Microsoft::Console::VirtualTerminal
         bool EraseInDisplay(const DispatchTypes::EraseType eraseType) override; // ED
         bool EraseInLine(const DispatchTypes::EraseType eraseType) override; // EL
         bool EraseCharacters(const size_t numChars) override; // ECH
+        bool CopyRectangularArea(const size_t top, const size_t left, const size_t bottom, const size_t right, const size_t dstTop, const size_t dstLeft) override; // DECCRA
+        bool FillRectangularArea(const size_t ch, const size_t top, const size_t left, const size_t bottom, const size_t right) override; // DECFRA
+        bool EraseRectangularArea(const size_t top, const size_t left, const size_t bottom, const size_t right) override; // DECERA
         bool InsertCharacter(const size_t count) override; // ICH
         bool DeleteCharacter(const size_t count) override; // DCH
         bool SetGraphicsRendition(const VTParameters options) override; // SGR
@@ -112,6 +116,7 @@ namespace Microsoft::Console::VirtualTerminal
         bool EnableAnyEventMouseMode(const bool enabled) override; // ?1003
         bool EnableAlternateScroll(const bool enabled) override; // ?1007
         bool EnableXtermBracketedPasteMode(const bool enabled) noexcept override; // ?2004
+        bool EnableSynchronizedOutput(const bool enabled) override; // ?2026
         bool SetCursorStyle(const DispatchTypes::CursorStyle cursorStyle) override; // DECSCUSR
         bool SetCursorColor(const COLORREF cursorColor) override;
 
@@ -130,6 +135,7 @@ namespace Microsoft::Console::VirtualTerminal
         bool EndHyperlink() override;
 
         bool DoConEmuAction(const std::wstring_view string) noexcept override;
+        bool DoFinalTermAction(const std::wstring_view string) noexcept override;
 
         StringHandler DownloadDRCS(const size_t fontNumber,
                                    const VTParameter startChar,
@@ -140,6 +146,10 @@ namespace Microsoft::Console::VirtualTerminal
                                    const VTParameter cellHeight,
                                    const DispatchTypes::DrcsCharsetSize charsetSize) override; // DECDLD
 
+        StringHandler DefineSixelImage(const VTParameter macroParameter,
+                                       const VTParameter backgroundSelect,
+                                       const VTParameter gridSize) override; // DECSIXEL
+
     private:
         enum class ScrollDirection
         {
@@ -171,6 +181,12 @@ namespace Microsoft::Console::VirtualTerminal
                                     const DispatchTypes::EraseType eraseType,
                                     const size_t lineId) const;
         bool _EraseScrollback();
+        bool _CalculateRectArea(const CONSOLE_SCREEN_BUFFER_INFOEX& csbiex,
+                                const size_t top,
+                                const size_t left,
+                                const size_t bottom,
+                                const size_t right,
+                                SMALL_RECT& area) const;
         bool _EraseAll();
         bool _InsertDeleteHelper(const size_t count, const bool isInsert) const;
         bool _ScrollMovement(const ScrollDirection dir, const size_t distance) const;
@@ -16,6 +16,7 @@ Author(s):
 #pragma once
 
 #include "../../types/inc/IInputEvent.hpp"
+#include "../../buffer/out/ImageCache.hpp"
 #include "../../buffer/out/LineRendition.hpp"
 #include "../../buffer/out/TextAttribute.hpp"
 #include "../../inc/conattrs.hpp"
@@ -100,16 +101,30 @@ namespace Microsoft::Console::VirtualTerminal
                                        const wchar_t fillChar,
                                        const bool standardFillAttrs) = 0;
 
+        virtual bool PrivateEraseRows(const size_t startRow,
+                                      const size_t endRow,
+                                      const bool standardFillAttrs) = 0;
+
         virtual bool PrivateScrollRegion(const SMALL_RECT scrollRect,
                                          const std::optional<SMALL_RECT> clipRect,
                                          const COORD destinationOrigin,
                                          const bool standardFillAttrs) = 0;
 
+        virtual bool PrivateFillRectangle(const SMALL_RECT fillRect,
+                                          const wchar_t fillChar,
+                                          const TextAttribute& fillAttrs) = 0;
+        virtual bool PrivateCopyRectangle(const SMALL_RECT sourceRect,
+                                          const COORD targetOrigin) = 0;
+
         virtual bool PrivateAddHyperlink(const std::wstring_view uri, const std::wstring_view params) const = 0;
         virtual bool PrivateEndHyperlink() const = 0;
 
         virtual bool PrivateUpdateSoftFont(const gsl::span<const uint16_t> bitPattern,
                                            const SIZE cellSize,
                                            const size_t centeringHint) = 0;
+
+        virtual bool PrivateEnableSynchronizedOutput(const bool enabled) = 0;
+
+        virtual bool PrivatePlaceImage(InlineImage&& image) = 0;
     };
 }
@@ -73,6 +73,7 @@ public:
     bool EnableAnyEventMouseMode(const bool /*enabled*/) noexcept override { return false; } // ?1003
     bool EnableAlternateScroll(const bool /*enabled*/) noexcept override { return false; } // ?1007
     bool EnableXtermBracketedPasteMode(const bool /*enabled*/) noexcept override { return false; } // ?2004
+    bool EnableSynchronizedOutput(const bool /*enabled*/) noexcept override { return false; } // ?2026
     bool SetColorTableEntry(const size_t /*tableIndex*/, const DWORD /*color*/) noexcept override { return false; } // OSCColorTable
     bool SetDefaultForeground(const DWORD /*color*/) noexcept override { return false; } // OSCDefaultForeground
     bool SetDefaultBackground(const DWORD /*color*/) noexcept override { return false; } // OSCDefaultBackground
@@ -81,6 +82,10 @@ public:
     bool EraseInLine(const DispatchTypes::EraseType /* eraseType*/) noexcept override { return false; } // EL
     bool EraseCharacters(const size_t /*numChars*/) noexcept override { return false; } // ECH
 
+    bool CopyRectangularArea(const size_t /*top*/, const size_t /*left*/, const size_t /*bottom*/, const size_t /*right*/, const size_t /*dstTop*/, const size_t /*dstLeft*/) noexcept override { return false; } // DECCRA
+    bool FillRectangularArea(const size_t /*ch*/, const size_t /*top*/, const size_t /*left*/, const size_t /*bottom*/, const size_t /*right*/) noexcept override { return false; } // DECFRA
+    bool EraseRectangularArea(const size_t /*top*/, const size_t /*left*/, const size_t /*bottom*/, const size_t /*right*/) noexcept override { return false; } // DECERA
+
     bool SetGraphicsRendition(const VTParameters /*options*/) noexcept override { return false; } // SGR
     bool SetLineRendition(const LineRendition /*rendition*/) noexcept override { return false; } // DECSWL, DECDWL, DECDHL
 
@@ -123,6 +128,7 @@ public:
     bool EndHyperlink() noexcept override { return false; }
 
     bool DoConEmuAction(const std::wstring_view /*string*/) noexcept override { return false; }
+    bool DoFinalTermAction(const std::wstring_view /*string*/) noexcept override { return false; }
 
     StringHandler DownloadDRCS(const size_t /*fontNumber*/,
                                const VTParameter /*startChar*/,
@@ -132,4 +138,8 @@ public:
                                const DispatchTypes::DrcsFontUsage /*fontUsage*/,
                                const VTParameter /*cellHeight*/,
                                const DispatchTypes::DrcsCharsetSize /*charsetSize*/) noexcept override { return nullptr; }
+
+    StringHandler DefineSixelImage(const VTParameter /*macroParameter*/,
+                                   const VTParameter /*backgroundSelect*/,
+                                   const VTParameter /*gridSize*/) noexcept override { return nullptr; } // DECSIXEL
 };
@@ -14,6 +14,7 @@ TerminalOutput::TerminalOutput() noexcept
     _gsetTranslationTables.at(1) = Ascii;
     _gsetTranslationTables.at(2) = Latin1;
     _gsetTranslationTables.at(3) = Latin1;
+    _UpdateTranslationTable();
 }
 
 bool TerminalOutput::Designate94Charset(size_t gsetNumber, const VTID charset)
@@ -54,6 +55,7 @@ bool TerminalOutput::LockingShift(const size_t gsetNumber)
     {
         _glTranslationTable = {};
     }
+    _UpdateTranslationTable();
     return true;
 }
 
@@ -67,6 +69,7 @@ bool TerminalOutput::LockingShiftRight(const size_t gsetNumber)
     {
         _grTranslationTable = {};
     }
+    _UpdateTranslationTable();
     return true;
 }
 
@@ -110,20 +113,44 @@ wchar_t TerminalOutput::TranslateKey(const wchar_t wch) const noexcept
         }
         _ssTranslationTable = {};
     }
-    else
+    else if (wch < _translationTable.size())
     {
-        if (wch - 0x20u < _glTranslationTable.size())
-        {
-            wchFound = _glTranslationTable.at(wch - 0x20u);
-        }
-        else if (wch - 0xA0u < _grTranslationTable.size())
-        {
-            wchFound = _grTranslationTable.at(wch - 0xA0u);
-        }
+        wchFound = til::at(_translationTable, wch);
     }
     return wchFound;
 }
 
+// Routine Description:
+// - Translates a whole string at once. Apart from a pending single shift,
+//   which only applies to the first character, this is a plain table lookup
+//   for every character, without any of the per-character checks.
+// Arguments:
+// - string - The text to translate
+// - translated - Receives the translated text
+// Return Value:
+// - <none>
+void TerminalOutput::TranslateString(const std::wstring_view string, std::wstring& translated) const
+{
+    translated.resize(string.size());
+    if (string.empty())
+    {
+        return;
+    }
+
+    size_t i = 0;
+    if (!_ssTranslationTable.empty())
+    {
+        translated.at(0) = TranslateKey(string.front());
+        i = 1;
+    }
+
+    for (; i < string.size(); i++)
+    {
+        const auto wch = til::at(string, i);
+        til::at(translated, i) = wch < _translationTable.size() ? til::at(_translationTable, wch) : wch;
+    }
+}
+
 const std::wstring_view TerminalOutput::_LookupTranslationTable94(const VTID charset) const
 {
     // Note that the DRCS set can be designated with either a 94 or 96 sequence,
@@ -234,6 +261,23 @@ bool TerminalOutput::_SetTranslationTable(const size_t gsetNumber, const std::ws
     return LockingShift(_glSetNumber) && LockingShiftRight(_grSetNumber);
 }
 
+void TerminalOutput::_UpdateTranslationTable() noexcept
+{
+    for (size_t i = 0; i < _translationTable.size(); i++)
+    {
+        auto wch = gsl::narrow_cast<wchar_t>(i);
+        if (i - 0x20u < _glTranslationTable.size())
+        {
+            wch = til::at(_glTranslationTable, i - 0x20u);
+        }
+        else if (i - 0xA0u < _grTranslationTable.size())
+        {
+            wch = til::at(_grTranslationTable, i - 0xA0u);
+        }
+        til::at(_translationTable, i) = wch;
+    }
+}
+
 void TerminalOutput::_ReplaceDrcsTable(const std::wstring_view oldTable, const std::wstring_view newTable)
 {
     if (newTable.data() != oldTable.data())
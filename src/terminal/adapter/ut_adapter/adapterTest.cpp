@@ -557,6 +557,16 @@ public:
         return TRUE;
     }
 
+    bool PrivateEraseRows(const size_t startRow,
+                          const size_t endRow,
+                          const bool standardFillAttrs) noexcept override
+    {
+        Log::Comment(L"PrivateEraseRows MOCK called...");
+
+        _eraseRows.emplace_back(startRow, endRow, standardFillAttrs);
+        return TRUE;
+    }
+
     bool PrivateScrollRegion(const SMALL_RECT /*scrollRect*/,
                              const std::optional<SMALL_RECT> /*clipRect*/,
                              const COORD /*destinationOrigin*/,
@@ -567,6 +577,28 @@ public:
         return TRUE;
     }
 
+    bool PrivateFillRectangle(const SMALL_RECT fillRect,
+                              const wchar_t fillChar,
+                              const TextAttribute& fillAttrs) noexcept override
+    {
+        Log::Comment(L"PrivateFillRectangle MOCK called...");
+
+        _fillRect = fillRect;
+        _fillChar = fillChar;
+        _fillAttrs = fillAttrs;
+        return TRUE;
+    }
+
+    bool PrivateCopyRectangle(const SMALL_RECT sourceRect,
+                              const COORD targetOrigin) noexcept override
+    {
+        Log::Comment(L"PrivateCopyRectangle MOCK called...");
+
+        _copySourceRect = sourceRect;
+        _copyTargetOrigin = targetOrigin;
+        return TRUE;
+    }
+
     bool PrivateUpdateSoftFont(const gsl::span<const uint16_t> /*bitPattern*/,
                                const SIZE cellSize,
                                const size_t /*centeringHint*/) noexcept override
@@ -580,6 +612,22 @@ public:
         return TRUE;
     }
 
+    bool PrivateEnableSynchronizedOutput(const bool enabled) noexcept override
+    {
+        Log::Comment(L"PrivateEnableSynchronizedOutput MOCK called...");
+
+        _synchronizedOutput = enabled;
+        return TRUE;
+    }
+
+    bool PrivatePlaceImage(InlineImage&& image) noexcept override
+    {
+        Log::Comment(L"PrivatePlaceImage MOCK called...");
+
+        _placedImage = std::move(image);
+        return TRUE;
+    }
+
     void PrepData()
     {
         PrepData(CursorDirection::UP); // if called like this, the cursor direction doesn't matter.
@@ -755,6 +803,13 @@ public:
     SMALL_RECT _expectedConsoleWindow = { 0, 0, 0, 0 };
     COORD _cursorPos = { 0, 0 };
     SMALL_RECT _expectedScrollRegion = { 0, 0, 0, 0 };
+    std::vector<std::tuple<size_t, size_t, bool>> _eraseRows;
+    std::optional<InlineImage> _placedImage;
+    SMALL_RECT _fillRect = { 0, 0, 0, 0 };
+    wchar_t _fillChar = 0;
+    TextAttribute _fillAttrs;
+    SMALL_RECT _copySourceRect = { 0, 0, 0, 0 };
+    COORD _copyTargetOrigin = { 0, 0 };
 
     bool _cursorVisible = false;
 
@@ -794,6 +849,7 @@ public:
     bool _privateLineFeedResult = false;
     bool _expectedLineFeedWithReturn = false;
     bool _privateReverseLineFeedResult = false;
+    bool _synchronizedOutput = false;
 
     bool _setConsoleTitleWResult = false;
     std::wstring_view _expectedWindowTitle{};
@@ -2064,6 +2120,121 @@ public:
         VERIFY_IS_TRUE(_pDispatch.get()->EnableCursorBlinking(false));
     }
 
+    TEST_METHOD(TranslateStringTest)
+    {
+        Log::Comment(L"Starting test...");
+
+        TerminalOutput termOutput;
+        std::wstring translated;
+
+        Log::Comment(L"Test 1: Nothing is translated with the default character sets");
+        VERIFY_IS_FALSE(termOutput.NeedToTranslate());
+        termOutput.TranslateString(L"lqk\xe9", translated);
+        VERIFY_ARE_EQUAL(L"lqk\xe9", translated);
+
+        Log::Comment(L"Test 2: DEC Special Graphics in GL translates line drawing characters");
+        VERIFY_IS_TRUE(termOutput.Designate94Charset(0, VTID("0")));
+        VERIFY_IS_TRUE(termOutput.NeedToTranslate());
+        termOutput.TranslateString(L"lqk\xe9\x2500", translated);
+        VERIFY_ARE_EQUAL(L"\x250c\x2500\x2510\xe9\x2500", translated);
+        VERIFY_ARE_EQUAL(L'\x2518', termOutput.TranslateKey(L'j'));
+
+        Log::Comment(L"Test 3: A single shift only applies to the first character");
+        VERIFY_IS_TRUE(termOutput.Designate94Charset(2, VTID("A")));
+        VERIFY_IS_TRUE(termOutput.SingleShift(2));
+        termOutput.TranslateString(L"#q", translated);
+        VERIFY_ARE_EQUAL(L"\xa3\x2500", translated);
+
+        Log::Comment(L"Test 4: Shifting back to ASCII turns the translation off again");
+        VERIFY_IS_TRUE(termOutput.LockingShift(1));
+        VERIFY_IS_FALSE(termOutput.NeedToTranslate());
+        termOutput.TranslateString(L"lqk", translated);
+        VERIFY_ARE_EQUAL(L"lqk", translated);
+    }
+
+    TEST_METHOD(EraseInDisplayRowsTest)
+    {
+        Log::Comment(L"Starting test...");
+
+        using EraseRows = std::tuple<size_t, size_t, bool>;
+
+        Log::Comment(L"Test 1: ED to the end from the left edge erases the cursor line in full");
+        // The viewport covers rows 20 to 48, and the cursor is in the middle of it.
+        _testGetSet->PrepData(CursorX::LEFT, CursorY::YCENTER);
+        _testGetSet->_eraseRows.clear();
+        VERIFY_IS_TRUE(_pDispatch.get()->EraseInDisplay(DispatchTypes::EraseType::ToEnd));
+        VERIFY_ARE_EQUAL(1u, _testGetSet->_eraseRows.size());
+        VERIFY_IS_TRUE((EraseRows{ 34, 49, true }) == _testGetSet->_eraseRows.at(0));
+
+        Log::Comment(L"Test 2: ED to the end from the middle of a line leaves out the cursor line");
+        _testGetSet->PrepData(CursorX::XCENTER, CursorY::YCENTER);
+        _testGetSet->_eraseRows.clear();
+        VERIFY_IS_TRUE(_pDispatch.get()->EraseInDisplay(DispatchTypes::EraseType::ToEnd));
+        VERIFY_ARE_EQUAL(1u, _testGetSet->_eraseRows.size());
+        VERIFY_IS_TRUE((EraseRows{ 35, 49, true }) == _testGetSet->_eraseRows.at(0));
+
+        Log::Comment(L"Test 3: ED from the beginning erases the lines above the cursor line");
+        _testGetSet->PrepData(CursorX::RIGHT, CursorY::YCENTER);
+        _testGetSet->_eraseRows.clear();
+        VERIFY_IS_TRUE(_pDispatch.get()->EraseInDisplay(DispatchTypes::EraseType::FromBeginning));
+        VERIFY_ARE_EQUAL(1u, _testGetSet->_eraseRows.size());
+        VERIFY_IS_TRUE((EraseRows{ 20, 34, true }) == _testGetSet->_eraseRows.at(0));
+    }
+
+    TEST_METHOD(RectangularAreaTest)
+    {
+        Log::Comment(L"Starting test...");
+
+        // The viewport covers rows 20 to 48 of a buffer that's 100 columns wide.
+        _testGetSet->PrepData();
+
+        Log::Comment(L"Test 1: DECERA erases with the standard erase attributes");
+        auto expectedAttrs = _testGetSet->_attribute;
+        expectedAttrs.SetStandardErase();
+        VERIFY_IS_TRUE(_pDispatch.get()->EraseRectangularArea(2, 3, 4, 5));
+        VERIFY_ARE_EQUAL((SMALL_RECT{ 2, 21, 4, 23 }), _testGetSet->_fillRect);
+        VERIFY_ARE_EQUAL(L' ', _testGetSet->_fillChar);
+        VERIFY_ARE_EQUAL(expectedAttrs, _testGetSet->_fillAttrs);
+
+        Log::Comment(L"Test 2: DECFRA with default coordinates fills the whole page with the current attributes");
+        VERIFY_IS_TRUE(_pDispatch.get()->FillRectangularArea(L'A', 0, 0, 0, 0));
+        VERIFY_ARE_EQUAL((SMALL_RECT{ 0, 20, 99, 48 }), _testGetSet->_fillRect);
+        VERIFY_ARE_EQUAL(L'A', _testGetSet->_fillChar);
+        VERIFY_ARE_EQUAL(_testGetSet->_attribute, _testGetSet->_fillAttrs);
+
+        Log::Comment(L"Test 3: DECFRA ignores characters that aren't printable");
+        _testGetSet->_fillRect = {};
+        VERIFY_IS_TRUE(_pDispatch.get()->FillRectangularArea(7, 1, 1, 1, 1));
+        VERIFY_ARE_EQUAL((SMALL_RECT{ 0, 0, 0, 0 }), _testGetSet->_fillRect);
+
+        Log::Comment(L"Test 4: DECERA ignores areas whose edges are reversed");
+        VERIFY_IS_TRUE(_pDispatch.get()->EraseRectangularArea(5, 1, 4, 1));
+        VERIFY_ARE_EQUAL((SMALL_RECT{ 0, 0, 0, 0 }), _testGetSet->_fillRect);
+
+        Log::Comment(L"Test 5: DECCRA copies the source area to the destination");
+        VERIFY_IS_TRUE(_pDispatch.get()->CopyRectangularArea(1, 1, 2, 3, 10, 5));
+        VERIFY_ARE_EQUAL((SMALL_RECT{ 0, 20, 2, 21 }), _testGetSet->_copySourceRect);
+        VERIFY_ARE_EQUAL((COORD{ 4, 29 }), _testGetSet->_copyTargetOrigin);
+
+        Log::Comment(L"Test 6: DECCRA clips whatever doesn't fit on the page at the destination");
+        VERIFY_IS_TRUE(_pDispatch.get()->CopyRectangularArea(1, 1, 5, 5, 29, 98));
+        VERIFY_ARE_EQUAL((SMALL_RECT{ 0, 20, 2, 20 }), _testGetSet->_copySourceRect);
+        VERIFY_ARE_EQUAL((COORD{ 97, 48 }), _testGetSet->_copyTargetOrigin);
+    }
+
+    TEST_METHOD(SynchronizedOutputTest)
+    {
+        Log::Comment(L"Starting test...");
+
+        Log::Comment(L"Test 1: DECSET 2026 begins a synchronized update");
+        VERIFY_IS_TRUE(_pDispatch.get()->SetMode(DispatchTypes::ModeParams::SO_SynchronizedOutput));
+        VERIFY_IS_TRUE(_testGetSet->_synchronizedOutput);
+
+        Log::Comment(L"Test 2: DECRST 2026 ends it");
+        VERIFY_IS_TRUE(_pDispatch.get()->ResetMode(DispatchTypes::ModeParams::SO_SynchronizedOutput));
+        VERIFY_IS_FALSE(_testGetSet->_synchronizedOutput);
+    }
+
     TEST_METHOD(ScrollMarginsTest)
     {
         Log::Comment(L"Starting test...");
@@ -2591,6 +2762,59 @@ public:
         VERIFY_IS_TRUE(decdld(CellMatrix::Default, 0, FontSet::Size132x24, FontUsage::FullCell, bitmapOf6x18));
     }
 
+    TEST_METHOD(SixelGraphicsDecoding)
+    {
+        const auto sixel = [=](const VTParameter backgroundSelect, const std::wstring_view data) {
+            const auto stringHandler = _pDispatch.get()->DefineSixelImage({}, backgroundSelect, {});
+            if (stringHandler)
+            {
+                for (auto ch : data)
+                {
+                    stringHandler(ch);
+                }
+                stringHandler(L'\033'); // String terminator
+            }
+            return stringHandler != nullptr;
+        };
+
+        Log::Comment(L"Two bands of sixels with a 1:1 aspect ratio and a transparent background");
+        _testGetSet->_placedImage.reset();
+        VERIFY_IS_TRUE(sixel(1, L"\"1;1;4;12#1;2;100;0;0#1~~$-#2;2;0;100;0!4~"));
+        VERIFY_IS_TRUE(_testGetSet->_placedImage.has_value());
+        const auto& image = _testGetSet->_placedImage.value();
+        VERIFY_ARE_EQUAL(4u, image.width);
+        VERIFY_ARE_EQUAL(12u, image.height);
+        VERIFY_ARE_EQUAL(1u, image.CellColumns());
+        VERIFY_ARE_EQUAL(1u, image.CellRows());
+        VERIFY_ARE_EQUAL(0xFFFF0000u, image.pixels.at(0));
+        VERIFY_ARE_EQUAL(0xFFFF0000u, image.pixels.at(5 * 4 + 1));
+        VERIFY_ARE_EQUAL(0u, image.pixels.at(2));
+        VERIFY_ARE_EQUAL(0u, image.pixels.at(5 * 4 + 3));
+        for (size_t i = 6 * 4; i < 12 * 4; i++)
+        {
+            VERIFY_ARE_EQUAL(0xFF00FF00u, image.pixels.at(i));
+        }
+
+        Log::Comment(L"Without raster attributes, the image is as large as the sixels that were drawn");
+        _testGetSet->_placedImage.reset();
+        VERIFY_IS_TRUE(sixel(0, L"!15?@"));
+        VERIFY_IS_TRUE(_testGetSet->_placedImage.has_value());
+        VERIFY_ARE_EQUAL(16u, _testGetSet->_placedImage->width);
+        VERIFY_ARE_EQUAL(12u, _testGetSet->_placedImage->height);
+        VERIFY_ARE_EQUAL(2u, _testGetSet->_placedImage->CellColumns());
+        // The background is filled with color register 0, and the last column with register 7.
+        VERIFY_ARE_EQUAL(0xFF000000u, _testGetSet->_placedImage->pixels.at(0));
+        VERIFY_ARE_EQUAL(0xFF878787u, _testGetSet->_placedImage->pixels.at(15));
+        VERIFY_ARE_EQUAL(0xFF878787u, _testGetSet->_placedImage->pixels.at(16 + 15));
+        VERIFY_ARE_EQUAL(0xFF000000u, _testGetSet->_placedImage->pixels.at(2 * 16 + 15));
+
+        Log::Comment(L"Nothing is placed in pty mode");
+        _testGetSet->_isPty = true;
+        _testGetSet->_placedImage.reset();
+        VERIFY_IS_FALSE(sixel(0, L"~~"));
+        VERIFY_IS_FALSE(_testGetSet->_placedImage.has_value());
+    }
+
 private:
     TestGetSet* _testGetSet; // non-ownership pointer
     std::unique_ptr<AdaptDispatch> _pDispatch;
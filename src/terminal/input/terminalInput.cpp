@@ -245,6 +245,92 @@ static constexpr std::array<TermKeyMap, 14> s_simpleModifiedKeyMapping{
     // TermKeyMap{ VK_ESCAPE, ALT_PRESSED, L""}, This is another Windows system shortcut for switching windows.
 };
 
+// Maps every combination of a virtual key and the Shift, Alt and Ctrl modifiers
+// to the first entry of a key mapping table that matches it. This way translating
+// a key is a single lookup instead of a search through the table.
+class TermKeyMapIndex
+{
+public:
+    template<size_t N>
+    constexpr TermKeyMapIndex(const std::array<TermKeyMap, N>& keyMapping) noexcept :
+        _keyMapping{ keyMapping.data() },
+        _indices{}
+    {
+        static_assert(N < UINT8_MAX, "the indices are stored in bytes");
+
+        // Go backwards, so that the first matching entry is the one that ends up in the index.
+        for (auto i = N; i-- > 0;)
+        {
+            const auto& map = keyMapping[i];
+            for (size_t modifiers = 0; modifiers < ModifierCombinations; ++modifiers)
+            {
+                if (_modifiersMatch(map.modifiers, modifiers))
+                {
+                    _indices[map.vkey * ModifierCombinations + modifiers] = gsl::narrow_cast<uint8_t>(i + 1);
+                }
+            }
+        }
+    }
+
+    // Routine Description:
+    // - Finds the entry of the key mapping table corresponding to this key event.
+    // Arguments:
+    // - keyEvent - Key event to translate
+    // Return Value:
+    // - The matching entry, or nullptr if there is none.
+    const TermKeyMap* Find(const KeyEvent& keyEvent) const noexcept
+    {
+        const auto vkey = keyEvent.GetVirtualKeyCode();
+        if (vkey >= VirtualKeyCount)
+        {
+            return nullptr;
+        }
+
+        const auto modifiers = (keyEvent.IsShiftPressed() ? ShiftBit : 0) |
+                               (keyEvent.IsAltPressed() ? AltBit : 0) |
+                               (keyEvent.IsCtrlPressed() ? CtrlBit : 0);
+        const auto index = til::at(_indices, vkey * ModifierCombinations + modifiers);
+#pragma warning(suppress : 26481) // The index was computed from the table this points to.
+        return index ? _keyMapping + index - 1 : nullptr;
+    }
+
+private:
+    static constexpr size_t VirtualKeyCount = 256;
+    static constexpr size_t ShiftBit = 1;
+    static constexpr size_t AltBit = 2;
+    static constexpr size_t CtrlBit = 4;
+    static constexpr size_t ModifierCombinations = 8;
+
+    // If the mapping has no modifiers set, then it doesn't really care
+    //      what the modifiers are on the key. The caller will likely do
+    //      something with them.
+    // However, if there are modifiers set, then we only want to match
+    //      if the key's modifiers are the same as the modifiers in the
+    //      mapping.
+    static constexpr bool _modifiersMatch(const DWORD mapModifiers, const size_t modifiers) noexcept
+    {
+        if ((mapModifiers & MOD_PRESSED) == 0)
+        {
+            return true;
+        }
+        return ((mapModifiers & SHIFT_PRESSED) != 0) == ((modifiers & ShiftBit) != 0) &&
+               ((mapModifiers & ALT_PRESSED) != 0) == ((modifiers & AltBit) != 0) &&
+               ((mapModifiers & CTRL_PRESSED) != 0) == ((modifiers & CtrlBit) != 0);
+    }
+
+    const TermKeyMap* _keyMapping;
+    std::array<uint8_t, VirtualKeyCount * ModifierCombinations> _indices;
+};
+
+static constexpr TermKeyMapIndex s_cursorKeysNormalIndex{ s_cursorKeysNormalMapping };
+static constexpr TermKeyMapIndex s_cursorKeysApplicationIndex{ s_cursorKeysApplicationMapping };
+static constexpr TermKeyMapIndex s_cursorKeysVt52Index{ s_cursorKeysVt52Mapping };
+static constexpr TermKeyMapIndex s_keypadNumericIndex{ s_keypadNumericMapping };
+static constexpr TermKeyMapIndex s_keypadApplicationIndex{ s_keypadApplicationMapping };
+static constexpr TermKeyMapIndex s_keypadVt52Index{ s_keypadVt52Mapping };
+static constexpr TermKeyMapIndex s_modifierKeyIndex{ s_modifierKeyMapping };
+static constexpr TermKeyMapIndex s_simpleModifiedKeyIndex{ s_simpleModifiedKeyMapping };
+
 const wchar_t* const CTRL_SLASH_SEQUENCE = L"\x1f";
 const wchar_t* const CTRL_QUESTIONMARK_SEQUENCE = L"\x7F";
 const wchar_t* const CTRL_ALT_SLASH_SEQUENCE = L"\x1b\x1f";
@@ -274,10 +360,10 @@ void TerminalInput::ForceDisableWin32InputMode(const bool win32InputMode) noexce
     _forceDisableWin32InputMode = win32InputMode;
 }
 
-static const gsl::span<const TermKeyMap> _getKeyMapping(const KeyEvent& keyEvent,
-                                                        const bool ansiMode,
-                                                        const bool cursorApplicationMode,
-                                                        const bool keypadApplicationMode) noexcept
+static const TermKeyMapIndex& _getKeyMapping(const KeyEvent& keyEvent,
+                                             const bool ansiMode,
+                                             const bool cursorApplicationMode,
+                                             const bool keypadApplicationMode) noexcept
 {
     if (ansiMode)
     {
@@ -285,22 +371,22 @@ static const gsl::span<const TermKeyMap> _getKeyMapping(const KeyEvent& keyEvent
         {
             if (cursorApplicationMode)
             {
-                return { s_cursorKeysApplicationMapping.data(), s_cursorKeysApplicationMapping.size() };
+                return s_cursorKeysApplicationIndex;
             }
             else
             {
-                return { s_cursorKeysNormalMapping.data(), s_cursorKeysNormalMapping.size() };
+                return s_cursorKeysNormalIndex;
             }
         }
         else
         {
             if (keypadApplicationMode)
             {
-                return { s_keypadApplicationMapping.data(), s_keypadApplicationMapping.size() };
+                return s_keypadApplicationIndex;
             }
             else
             {
-                return { s_keypadNumericMapping.data(), s_keypadNumericMapping.size() };
+                return s_keypadNumericIndex;
             }
         }
     }
@@ -308,55 +394,15 @@ static const gsl::span<const TermKeyMap> _getKeyMapping(const KeyEvent& keyEvent
     {
         if (keyEvent.IsCursorKey())
         {
-            return { s_cursorKeysVt52Mapping.data(), s_cursorKeysVt52Mapping.size() };
+            return s_cursorKeysVt52Index;
         }
         else
         {
-            return { s_keypadVt52Mapping.data(), s_keypadVt52Mapping.size() };
+            return s_keypadVt52Index;
         }
     }
 }
 
-// Routine Description:
-// - Searches the keyMapping for a entry corresponding to this key event, and returns it.
-// Arguments:
-// - keyEvent - Key event to translate
-// - keyMapping - Array of key mappings to search
-// Return Value:
-// - Has value if there was a match to a key translation.
-static std::optional<const TermKeyMap> _searchKeyMapping(const KeyEvent& keyEvent,
-                                                         gsl::span<const TermKeyMap> keyMapping) noexcept
-{
-    for (auto& map : keyMapping)
-    {
-        if (map.vkey == keyEvent.GetVirtualKeyCode())
-        {
-            // If the mapping has no modifiers set, then it doesn't really care
-            //      what the modifiers are on the key. The caller will likely do
-            //      something with them.
-            // However, if there are modifiers set, then we only want to match
-            //      if the key's modifiers are the same as the modifiers in the
-            //      mapping.
-            bool modifiersMatch = WI_AreAllFlagsClear(map.modifiers, MOD_PRESSED);
-            if (!modifiersMatch)
-            {
-                // The modifier mapping expects certain modifier keys to be
-                //      pressed. Check those as well.
-                modifiersMatch =
-                    (WI_IsFlagSet(map.modifiers, SHIFT_PRESSED) == keyEvent.IsShiftPressed()) &&
-                    (WI_IsAnyFlagSet(map.modifiers, ALT_PRESSED) == keyEvent.IsAltPressed()) &&
-                    (WI_IsAnyFlagSet(map.modifiers, CTRL_PRESSED) == keyEvent.IsCtrlPressed());
-            }
-
-            if (modifiersMatch)
-            {
-                return map;
-            }
-        }
-    }
-    return std::nullopt;
-}
-
 typedef std::function<void(const std::wstring_view)> InputSender;
 
 // Routine Description:
@@ -365,18 +411,22 @@ typedef std::function<void(const std::wstring_view)> InputSender;
 //      before sending to the input.
 // Arguments:
 // - keyEvent - Key event to translate
+// - slashKeyScan - The VkKeyScan result for '/' on the current keyboard layout
+// - questionMarkKeyScan - The VkKeyScan result for '?' on the current keyboard layout
 // - sender - Function to use to dispatch translated event
 // Return Value:
 // - True if there was a match to a key translation, and we successfully modified and sent it to the input
-static bool _searchWithModifier(const KeyEvent& keyEvent, InputSender sender)
+static bool _searchWithModifier(const KeyEvent& keyEvent,
+                                const SHORT slashKeyScan,
+                                const SHORT questionMarkKeyScan,
+                                InputSender sender)
 {
     bool success = false;
 
-    const auto match = _searchKeyMapping(keyEvent,
-                                         { s_modifierKeyMapping.data(), s_modifierKeyMapping.size() });
+    const auto match = s_modifierKeyIndex.Find(keyEvent);
     if (match)
     {
-        const auto& v = match.value();
+        const auto& v = *match;
         if (!v.sequence.empty())
         {
             std::wstring modified{ v.sequence }; // Make a copy so we can modify it.
@@ -393,12 +443,11 @@ static bool _searchWithModifier(const KeyEvent& keyEvent, InputSender sender)
         // We didn't find the key in the map of modified keys that need editing,
         //      maybe it's in the other map of modified keys with sequences that
         //      don't need editing before sending.
-        const auto match2 = _searchKeyMapping(keyEvent,
-                                              { s_simpleModifiedKeyMapping.data(), s_simpleModifiedKeyMapping.size() });
+        const auto match2 = s_simpleModifiedKeyIndex.Find(keyEvent);
         if (match2)
         {
             // This mapping doesn't need to be changed at all.
-            sender(match2.value().sequence);
+            sender(match2->sequence);
             success = true;
         }
         else
@@ -422,12 +471,9 @@ static bool _searchWithModifier(const KeyEvent& keyEvent, InputSender sender)
             // See GH#3079 for details.
             // Also see https://github.com/microsoft/terminal/pull/4947#issuecomment-600382856
 
-            // VkKeyScan will give us both the Vkey of the key needed for this
+            // VkKeyScan gives us both the Vkey of the key needed for this
             // character, and the modifiers the user might need to press to get
-            // this character.
-            const auto slashKeyScan = VkKeyScan(L'/'); // On USASCII: 0x00bf
-            const auto questionMarkKeyScan = VkKeyScan(L'?'); //On USASCII: 0x01bf
-
+            // this character. (On USASCII: 0x00bf for '/' and 0x01bf for '?'.)
             const auto slashVkey = LOBYTE(slashKeyScan);
             const auto questionMarkVkey = LOBYTE(questionMarkKeyScan);
 
@@ -483,20 +529,51 @@ static bool _searchWithModifier(const KeyEvent& keyEvent, InputSender sender)
 // - Searches the input array of mappings, and sends it to the input if a match was found.
 // Arguments:
 // - keyEvent - Key event to translate
-// - keyMapping - Array of key mappings to search
+// - keyMapping - Index of the key mappings to search
 // - sender - Function to use to dispatch translated event
 // Return Value:
 // - True if there was a match to a key translation, and we successfully sent it to the input
 static bool _translateDefaultMapping(const KeyEvent& keyEvent,
-                                     const gsl::span<const TermKeyMap> keyMapping,
+                                     const TermKeyMapIndex& keyMapping,
                                      InputSender sender)
 {
-    const auto match = _searchKeyMapping(keyEvent, keyMapping);
+    const auto match = keyMapping.Find(keyEvent);
     if (match)
     {
         sender(match->sequence);
     }
-    return match.has_value();
+    return match != nullptr;
+}
+
+// Routine Description:
+// - Gets the keys that produce the characters HandleKey needs to know about
+//   on the current keyboard layout. They're looked up once per layout, since
+//   VkKeyScan has to search the whole layout for them.
+// Arguments:
+// - <none>
+// Return Value:
+// - The keys for the current keyboard layout.
+const TerminalInput::KeyboardLayoutKeys& TerminalInput::_GetKeyboardLayoutKeys()
+{
+#ifdef BUILD_ONECORE_INTERACTIVITY
+    // The layout can't be queried through the input services, so the keys
+    // are looked up each time, like they've always been.
+    const HKL layout = nullptr;
+    _keyboardLayoutKeys.reset();
+#else
+    const auto layout = GetKeyboardLayout(0);
+#endif
+
+    if (!_keyboardLayoutKeys || _keyboardLayoutKeys->layout != layout)
+    {
+        _keyboardLayoutKeys = KeyboardLayoutKeys{
+            layout,
+            LOBYTE(VkKeyScanW(0)),
+            VkKeyScanW(L'/'),
+            VkKeyScanW(L'?'),
+        };
+    }
+    return *_keyboardLayoutKeys;
 }
 
 // Routine Description:
@@ -587,7 +664,7 @@ bool TerminalInput::HandleKey(const IInputEvent* const pInEvent)
         // Currently, when we're called with Alt+Ctrl+@, ch will be 0, since Ctrl+@ equals a null byte.
         // VkKeyScanW(0) in turn returns the vkey for the null character (ASCII @).
         // -> Use the vkey to determine if Ctrl+@ is being pressed and produce ^[^@.
-        if (ch == UNICODE_NULL && vkey == LOBYTE(VkKeyScanW(0)))
+        if (ch == UNICODE_NULL && vkey == _GetKeyboardLayoutKeys().nullVkey)
         {
             _SendEscapedInputSequence(L'\0');
             return true;
@@ -599,9 +676,13 @@ bool TerminalInput::HandleKey(const IInputEvent* const pInEvent)
     };
 
     // If a modifier key was pressed, then we need to try and send the modified sequence.
-    if (keyEvent.IsModifierPressed() && _searchWithModifier(keyEvent, senderFunc))
+    if (keyEvent.IsModifierPressed())
     {
-        return true;
+        const auto& layoutKeys = _GetKeyboardLayoutKeys();
+        if (_searchWithModifier(keyEvent, layoutKeys.slashKeyScan, layoutKeys.questionMarkKeyScan, senderFunc))
+        {
+            return true;
+        }
     }
 
     // This section is similar to the Alt modifier section above,
@@ -628,9 +709,10 @@ bool TerminalInput::HandleKey(const IInputEvent* const pInEvent)
         // Currently, when we're called with Ctrl+@, ch will be 0, since Ctrl+@ equals a null byte.
         // VkKeyScanW(0) in turn returns the vkey for the null character (ASCII @).
         // -> Use the vkey to alternatively determine if Ctrl+@ is being pressed.
-        if (ch == UNICODE_SPACE || (ch == UNICODE_NULL && vkey == LOBYTE(VkKeyScanW(0))))
+        const auto nullVkey = _GetKeyboardLayoutKeys().nullVkey;
+        if (ch == UNICODE_SPACE || (ch == UNICODE_NULL && vkey == nullVkey))
         {
-            _SendNullInputSequence(keyEvent.GetActiveModifierKeys());
+            _SendNullInputSequence(keyEvent.GetActiveModifierKeys(), nullVkey);
             return true;
         }
 
@@ -724,14 +806,14 @@ void TerminalInput::_SendEscapedInputSequence(const wchar_t wch) const
     }
 }
 
-void TerminalInput::_SendNullInputSequence(const DWORD controlKeyState) const
+void TerminalInput::_SendNullInputSequence(const DWORD controlKeyState, const WORD nullVkey) const
 {
     try
     {
         std::deque<std::unique_ptr<IInputEvent>> inputEvents;
         inputEvents.push_back(std::make_unique<KeyEvent>(true,
                                                          1ui16,
-                                                         LOBYTE(VkKeyScanW(0)),
+                                                         nullVkey,
                                                          0ui16,
                                                          L'\x0',
                                                          controlKeyState));
@@ -86,8 +86,20 @@ namespace Microsoft::Console::VirtualTerminal
         bool _win32InputMode{ false };
         bool _forceDisableWin32InputMode{ false };
 
+        // The keys that produce some of the characters we translate differ
+        // between keyboard layouts, so they're looked up once per layout.
+        struct KeyboardLayoutKeys
+        {
+            HKL layout;
+            WORD nullVkey;
+            SHORT slashKeyScan;
+            SHORT questionMarkKeyScan;
+        };
+        std::optional<KeyboardLayoutKeys> _keyboardLayoutKeys;
+
+        const KeyboardLayoutKeys& _GetKeyboardLayoutKeys();
         void _SendChar(const wchar_t ch);
-        void _SendNullInputSequence(const DWORD dwControlKeyState) const;
+        void _SendNullInputSequence(const DWORD dwControlKeyState, const WORD nullVkey) const;
         void _SendInputSequence(const std::wstring_view sequence) const noexcept;
         void _SendEscapedInputSequence(const wchar_t wch) const;
         static std::wstring _GenerateWin32KeySequence(const KeyEvent& key);
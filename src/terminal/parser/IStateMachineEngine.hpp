@@ -48,12 +48,22 @@ namespace Microsoft::Console::VirtualTerminal
                                        const size_t parameter,
                                        const std::wstring_view string) = 0;
 
+        // Engines can take the string of an OSC sequence one character at a
+        // time, instead of getting it buffered in ActionOscDispatch. If the
+        // returned handler is null, the string is buffered as usual.
+        virtual StringHandler ActionOscStringHandler(const size_t parameter) = 0;
+
         virtual bool ActionSs3Dispatch(const wchar_t wch, const VTParameters parameters) = 0;
 
+        // Called once the state machine has processed all the characters
+        // it was given, so that engines can dispatch any deferred actions.
+        virtual bool ActionFlushPending() = 0;
+
         virtual bool ParseControlSequenceAfterSs3() const = 0;
         virtual bool FlushAtEndOfString() const = 0;
         virtual bool DispatchControlCharsFromEscape() const = 0;
         virtual bool DispatchIntermediatesFromEscape() const = 0;
+        virtual bool DispatchWin32InputSequencesDirectly() const = 0;
 
     protected:
         IStateMachineEngine() = default;
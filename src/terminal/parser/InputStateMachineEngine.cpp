@@ -131,7 +131,7 @@ bool InputStateMachineEngine::_DoControlCharacter(const wchar_t wch, const bool
     {
         // This is Ctrl+C, which is handled specially by the host.
         const auto [keyDown, keyUp] = KeyEvent::MakePair(1, 'C', 0, UNICODE_ETX, LEFT_CTRL_PRESSED);
-        success = _pDispatch->WriteCtrlKey(keyDown) && _pDispatch->WriteCtrlKey(keyUp);
+        success = _FlushPendingInput() && _pDispatch->WriteCtrlKey(keyDown) && _pDispatch->WriteCtrlKey(keyUp);
     }
     else if (wch >= '\x0' && wch < '\x20')
     {
@@ -184,7 +184,7 @@ bool InputStateMachineEngine::_DoControlCharacter(const wchar_t wch, const bool
                 WI_SetFlag(modifierState, LEFT_ALT_PRESSED);
             }
 
-            success = _WriteSingleKey(actualChar, vkey, modifierState);
+            _GenerateWrappedSequence(actualChar, vkey, modifierState, _pendingInput);
         }
     }
     else if (wch == '\x7f')
@@ -196,7 +196,8 @@ bool InputStateMachineEngine::_DoControlCharacter(const wchar_t wch, const bool
         //      "delete" any input at all, only backspace.
         //  Because of this, we're treating x7f as backspace, like most
         //      terminals do.
-        success = _WriteSingleKey('\x8', VK_BACK, writeAlt ? LEFT_ALT_PRESSED : 0);
+        _GenerateWrappedSequence('\x8', VK_BACK, writeAlt ? LEFT_ALT_PRESSED : 0, _pendingInput);
+        success = true;
     }
     else
     {
@@ -220,7 +221,7 @@ bool InputStateMachineEngine::ActionExecuteFromEscape(const wchar_t wch)
 {
     if (_pDispatch->IsVtInputEnabled() && _pfnFlushToInputQueue)
     {
-        return _pfnFlushToInputQueue();
+        return _FlushPendingInput() && _pfnFlushToInputQueue();
     }
 
     return _DoControlCharacter(wch, true);
@@ -228,7 +229,7 @@ bool InputStateMachineEngine::ActionExecuteFromEscape(const wchar_t wch)
 
 // Method Description:
 // - Triggers the Print action to indicate that the listener should render the
-//      character given.
+//      character given. The keypress is queued up, see ActionFlushPending.
 // Arguments:
 // - wch - Character to dispatch.
 // Return Value:
@@ -240,7 +241,7 @@ bool InputStateMachineEngine::ActionPrint(const wchar_t wch)
     bool success = _GenerateKeyFromChar(wch, vkey, modifierState);
     if (success)
     {
-        success = _WriteSingleKey(wch, vkey, modifierState);
+        _GenerateWrappedSequence(wch, vkey, modifierState, _pendingInput);
     }
     return success;
 }
@@ -248,17 +249,46 @@ bool InputStateMachineEngine::ActionPrint(const wchar_t wch)
 // Method Description:
 // - Triggers the Print action to indicate that the listener should render the
 //      string of characters given.
+// - Pasted text arrives here in long runs. The characters that can be typed on
+//      the keyboard layout as they are, or with shift, are queued up together
+//      with the control characters around them and written in one go, see
+//      ActionFlushPending. Anything else goes through WriteString, which
+//      knows how to synthesize characters that aren't on the keyboard.
 // Arguments:
 // - string - string to dispatch.
 // Return Value:
 // - true iff we successfully dispatched the sequence.
 bool InputStateMachineEngine::ActionPrintString(const std::wstring_view string)
+try
 {
-    if (string.empty())
+    bool success = true;
+    size_t current = 0;
+    while (current < string.size())
     {
-        return true;
+        short vkey = 0;
+        DWORD modifierState = 0;
+        if (_GenerateTypedKeyFromChar(til::at(string, current), vkey, modifierState))
+        {
+            _GenerateWrappedSequence(til::at(string, current), vkey, modifierState, _pendingInput);
+            ++current;
+            continue;
+        }
+
+        const auto start = current;
+        do
+        {
+            ++current;
+        } while (current < string.size() && !_GenerateTypedKeyFromChar(til::at(string, current), vkey, modifierState));
+
+        success = _FlushPendingInput() && success;
+        success = _pDispatch->WriteString(string.substr(start, current - start)) && success;
     }
-    return _pDispatch->WriteString(string);
+    return success;
+}
+catch (...)
+{
+    LOG_CAUGHT_EXCEPTION();
+    return false;
 }
 
 // Method Description:
@@ -270,6 +300,11 @@ bool InputStateMachineEngine::ActionPrintString(const std::wstring_view string)
 // - true iff we successfully dispatched the sequence.
 bool InputStateMachineEngine::ActionPassThroughString(const std::wstring_view string)
 {
+    if (!_FlushPendingInput())
+    {
+        return false;
+    }
+
     if (_pDispatch->IsVtInputEnabled())
     {
         // Synthesize string into key events that we'll write to the buffer
@@ -306,7 +341,7 @@ bool InputStateMachineEngine::ActionEscDispatch(const VTID id)
 {
     if (_pDispatch->IsVtInputEnabled() && _pfnFlushToInputQueue)
     {
-        return _pfnFlushToInputQueue();
+        return _FlushPendingInput() && _pfnFlushToInputQueue();
     }
 
     bool success = false;
@@ -372,7 +407,7 @@ bool InputStateMachineEngine::ActionCsiDispatch(const VTID id, const VTParameter
         _pfnFlushToInputQueue &&
         id != CsiActionCodes::Win32KeyboardInput)
     {
-        return _pfnFlushToInputQueue();
+        return _FlushPendingInput() && _pfnFlushToInputQueue();
     }
 
     DWORD modifierState = 0;
@@ -401,7 +436,7 @@ bool InputStateMachineEngine::ActionCsiDispatch(const VTID id, const VTParameter
         // Else, fall though to the _GetCursorKeysModifierState handler.
         if (_lookingForDSR)
         {
-            success = _pDispatch->MoveCursor(parameters.at(0), parameters.at(1));
+            success = _FlushPendingInput() && _pDispatch->MoveCursor(parameters.at(0), parameters.at(1));
             // Right now we're only looking for on initial cursor
             //      position response. After that, only look for F3.
             _lookingForDSR = false;
@@ -430,7 +465,7 @@ bool InputStateMachineEngine::ActionCsiDispatch(const VTID id, const VTParameter
         success = _WriteSingleKey(VK_TAB, SHIFT_PRESSED);
         break;
     case CsiActionCodes::DTTERM_WindowManipulation:
-        success = _pDispatch->WindowManipulation(parameters.at(0), parameters.at(1), parameters.at(2));
+        success = _FlushPendingInput() && _pDispatch->WindowManipulation(parameters.at(0), parameters.at(1), parameters.at(2));
         break;
     case CsiActionCodes::Win32KeyboardInput:
     {
@@ -438,7 +473,7 @@ bool InputStateMachineEngine::ActionCsiDispatch(const VTID id, const VTParameter
         // because that will take extra steps to make sure things like
         // Ctrl+C, Ctrl+Break are handled correctly.
         const auto key = _GenerateWin32Key(parameters);
-        success = _pDispatch->WriteCtrlKey(key);
+        success = _FlushPendingInput() && _pDispatch->WriteCtrlKey(key);
         break;
     }
     default:
@@ -477,7 +512,7 @@ bool InputStateMachineEngine::ActionSs3Dispatch(const wchar_t wch, const VTParam
 {
     if (_pDispatch->IsVtInputEnabled() && _pfnFlushToInputQueue)
     {
-        return _pfnFlushToInputQueue();
+        return _FlushPendingInput() && _pfnFlushToInputQueue();
     }
 
     // Ss3 sequence keys aren't modified.
@@ -519,6 +554,28 @@ bool InputStateMachineEngine::ActionIgnore() noexcept
     return true;
 }
 
+// Routine Description:
+// - Triggers the FlushPending action to indicate that the state machine has
+//      processed all of its input. Writes the keypresses that were queued up
+//      for text and control characters.
+// Arguments:
+// - <none>
+// Return Value:
+// - true iff we successfully wrote the queued up keypresses.
+bool InputStateMachineEngine::ActionFlushPending() noexcept
+try
+{
+    // The keyboard layout may have changed by the time the next input arrives.
+    _keyScanCache.fill(0);
+    return _FlushPendingInput();
+}
+catch (...)
+{
+    LOG_CAUGHT_EXCEPTION();
+    _pendingInput.clear();
+    return false;
+}
+
 // Method Description:
 // - Triggers the OscDispatch action to indicate that the listener should handle a control sequence.
 //   These sequences perform various API-type commands that can include many parameters.
@@ -535,6 +592,18 @@ bool InputStateMachineEngine::ActionOscDispatch(const wchar_t /*wch*/,
     return false;
 }
 
+// Method Description:
+// - Returns the handler for the string of an OSC sequence. OSC sequences
+//      aren't supported in input, so their strings are simply buffered.
+// Arguments:
+// - parameter - identifier of the OSC action to perform
+// Return Value:
+// - nullptr
+IStateMachineEngine::StringHandler InputStateMachineEngine::ActionOscStringHandler(const size_t /*parameter*/) noexcept
+{
+    return nullptr;
+}
+
 // Method Description:
 // - Writes a sequence of keypresses to the buffer based on the wch,
 //      vkey and modifiers passed in. Will create both the appropriate key downs
@@ -554,8 +623,6 @@ void InputStateMachineEngine::_GenerateWrappedSequence(const wchar_t wch,
                                                        const DWORD modifierState,
                                                        std::vector<INPUT_RECORD>& input)
 {
-    input.reserve(input.size() + 8);
-
     // TODO: Reuse the clipboard functions for generating input for characters
     //       that aren't on the current keyboard.
     // MSFT:13994942
@@ -664,8 +731,6 @@ void InputStateMachineEngine::_GetSingleKeypress(const wchar_t wch,
                                                  const DWORD modifierState,
                                                  std::vector<INPUT_RECORD>& input)
 {
-    input.reserve(input.size() + 2);
-
     INPUT_RECORD rec;
 
     rec.EventType = KEY_EVENT;
@@ -694,11 +759,29 @@ void InputStateMachineEngine::_GetSingleKeypress(const wchar_t wch,
 // - true iff we successfully wrote the keypress to the input callback.
 bool InputStateMachineEngine::_WriteSingleKey(const wchar_t wch, const short vkey, const DWORD modifierState)
 {
-    // At most 8 records - 2 for each of shift,ctrl,alt up and down, and 2 for the actual key up and down.
-    std::vector<INPUT_RECORD> input;
-    _GenerateWrappedSequence(wch, vkey, modifierState, input);
-    std::deque<std::unique_ptr<IInputEvent>> inputEvents = IInputEvent::Create(gsl::make_span(input));
+    // The keypress is written together with the text that was queued up before it.
+    _GenerateWrappedSequence(wch, vkey, modifierState, _pendingInput);
+    return _FlushPendingInput();
+}
 
+// Method Description:
+// - Writes the keypresses that were queued up for text and control characters
+//      to the input, all in one go. This has to happen before anything else
+//      is written to the input, so that it stays in order.
+// Arguments:
+// - <none>
+// Return Value:
+// - true iff we successfully wrote the keypresses, or there weren't any.
+bool InputStateMachineEngine::_FlushPendingInput()
+{
+    if (_pendingInput.empty())
+    {
+        return true;
+    }
+
+    auto inputEvents = IInputEvent::Create(gsl::make_span(_pendingInput));
+    // The records are kept around for their capacity.
+    _pendingInput.clear();
     return _pDispatch->WriteInput(inputEvents);
 }
 
@@ -738,7 +821,7 @@ bool InputStateMachineEngine::_WriteMouseEvent(const til::point uiPos, const DWO
     // pack and write input record
     // 1 record - the modifiers don't get their own events
     std::deque<std::unique_ptr<IInputEvent>> inputEvents = IInputEvent::Create(gsl::make_span(&rgInput, 1));
-    return _pDispatch->WriteInput(inputEvents);
+    return _FlushPendingInput() && _pDispatch->WriteInput(inputEvents);
 }
 
 // Method Description:
@@ -1039,7 +1122,22 @@ bool InputStateMachineEngine::_GenerateKeyFromChar(const wchar_t wch,
                                                    DWORD& modifierState) noexcept
 {
     // Low order byte is key, high order is modifiers
-    const short keyscan = VkKeyScanW(wch);
+    short keyscan = 0;
+    if (wch < _keyScanCache.size())
+    {
+        // 0 would be a key without a virtual key code, so it marks the
+        // characters that haven't been looked up yet.
+        auto& cached = til::at(_keyScanCache, wch);
+        if (cached == 0)
+        {
+            cached = VkKeyScanW(wch);
+        }
+        keyscan = cached;
+    }
+    else
+    {
+        keyscan = VkKeyScanW(wch);
+    }
 
     short key = LOBYTE(keyscan);
 
@@ -1062,6 +1160,24 @@ bool InputStateMachineEngine::_GenerateKeyFromChar(const wchar_t wch,
     return true;
 }
 
+// Method Description:
+// - Like _GenerateKeyFromChar, but only succeeds for characters that can be
+//      typed on the keyboard layout without Ctrl or Alt. Those are the ones
+//      that ActionPrintString can queue up itself.
+// Arguments:
+// - wch: the wchar_t to get the vkey and modifier state of.
+// - vkey: Receives the vkey
+// - modifierState: Receives the modifier state
+// Return Value:
+// - true if the character can be typed with at most Shift pressed.
+bool InputStateMachineEngine::_GenerateTypedKeyFromChar(const wchar_t wch,
+                                                        short& vkey,
+                                                        DWORD& modifierState) noexcept
+{
+    return _GenerateKeyFromChar(wch, vkey, modifierState) &&
+           WI_AreAllFlagsClear(modifierState, LEFT_CTRL_PRESSED | LEFT_ALT_PRESSED);
+}
+
 // Method Description:
 // - Returns true if the engine should attempt to parse a control sequence
 //      following an SS3 escape prefix.
@@ -1114,6 +1230,18 @@ bool InputStateMachineEngine::DispatchIntermediatesFromEscape() const noexcept
     return true;
 }
 
+// Routine Description:
+// - Returns true if the state machine should recognize complete
+//   win32-input-mode sequences itself and dispatch them right away. The
+//   terminal sends every key event as one of those, so this is the bulk of
+//   our input.
+// Return Value:
+// - True iff win32-input-mode sequences should be dispatched directly.
+bool InputStateMachineEngine::DispatchWin32InputSequencesDirectly() const noexcept
+{
+    return true;
+}
+
 // Method Description:
 // - Sets us up for vt input passthrough.
 //      We'll set a couple members, and if they aren't null, when we get a
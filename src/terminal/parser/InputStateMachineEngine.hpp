@@ -152,16 +152,21 @@ namespace Microsoft::Console::VirtualTerminal
 
         bool ActionIgnore() noexcept override;
 
+        bool ActionFlushPending() noexcept override;
+
         bool ActionOscDispatch(const wchar_t wch,
                                const size_t parameter,
                                const std::wstring_view string) noexcept override;
 
+        StringHandler ActionOscStringHandler(const size_t parameter) noexcept override;
+
         bool ActionSs3Dispatch(const wchar_t wch, const VTParameters parameters) override;
 
         bool ParseControlSequenceAfterSs3() const noexcept override;
         bool FlushAtEndOfString() const noexcept override;
         bool DispatchControlCharsFromEscape() const noexcept override;
         bool DispatchIntermediatesFromEscape() const noexcept override;
+        bool DispatchWin32InputSequencesDirectly() const noexcept override;
 
         void SetFlushToInputQueueCallback(std::function<bool()> pfnFlushToInputQueue);
 
@@ -175,10 +180,18 @@ namespace Microsoft::Console::VirtualTerminal
         std::optional<std::chrono::steady_clock::time_point> _lastMouseClickTime{};
         std::optional<size_t> _lastMouseClickButton{};
 
+        // Keypresses for text and control characters are queued up here and
+        // written all at once, instead of one write per character.
+        std::vector<INPUT_RECORD> _pendingInput;
+        // The results of VkKeyScanW for ASCII, for as long as the current input
+        // is being processed. 0 marks the characters that weren't looked up yet.
+        std::array<short, 128> _keyScanCache{};
+
         DWORD _GetCursorKeysModifierState(const VTParameters parameters, const VTID id) noexcept;
         DWORD _GetGenericKeysModifierState(const VTParameters parameters) noexcept;
         DWORD _GetSGRMouseModifierState(const size_t modifierParam) noexcept;
         bool _GenerateKeyFromChar(const wchar_t wch, short& vkey, DWORD& modifierState) noexcept;
+        bool _GenerateTypedKeyFromChar(const wchar_t wch, short& vkey, DWORD& modifierState) noexcept;
 
         DWORD _GetModifier(const size_t parameter) noexcept;
 
@@ -193,6 +206,7 @@ namespace Microsoft::Console::VirtualTerminal
 
         bool _WriteSingleKey(const short vkey, const DWORD modifierState);
         bool _WriteSingleKey(const wchar_t wch, const short vkey, const DWORD modifierState);
+        bool _FlushPendingInput();
 
         bool _WriteMouseEvent(const til::point uiPos, const DWORD buttonState, const DWORD controlKeyState, const DWORD eventFlags);
 
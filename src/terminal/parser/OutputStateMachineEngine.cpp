@@ -21,9 +21,14 @@ OutputStateMachineEngine::OutputStateMachineEngine(std::unique_ptr<ITermDispatch
     _dispatch(std::move(pDispatch)),
     _pfnFlushToTerminal(nullptr),
     _pTtyConnection(nullptr),
-    _lastPrintedChar(AsciiChars::NUL)
+    _lastPrintedChar(AsciiChars::NUL),
+    _clipboardDataLength(0),
+    _clipboardStreamed(false),
+    _clipboardDataStarted(false),
+    _clipboardQuery(false)
 {
     THROW_HR_IF_NULL(E_INVALIDARG, _dispatch.get());
+    _clipboardDecoder.SetMaxLength(DefaultClipboardLimit);
 }
 
 const ITermDispatch& OutputStateMachineEngine::Dispatch() const noexcept
@@ -45,6 +50,8 @@ ITermDispatch& OutputStateMachineEngine::Dispatch() noexcept
 // - true iff we successfully dispatched the sequence.
 bool OutputStateMachineEngine::ActionExecute(const wchar_t wch)
 {
+    _FlushGraphicsRendition();
+
     switch (wch)
     {
     case AsciiChars::NUL:
@@ -116,6 +123,8 @@ bool OutputStateMachineEngine::ActionExecuteFromEscape(const wchar_t wch)
 // - true iff we successfully dispatched the sequence.
 bool OutputStateMachineEngine::ActionPrint(const wchar_t wch)
 {
+    _FlushGraphicsRendition();
+
     // Stash the last character of the string, if it's a graphical character
     if (wch >= AsciiChars::SPC)
     {
@@ -141,6 +150,8 @@ bool OutputStateMachineEngine::ActionPrintString(const std::wstring_view string)
         return true;
     }
 
+    _FlushGraphicsRendition();
+
     // Stash the last character of the string, if it's a graphical character
     const wchar_t wch = string.back();
     if (wch >= AsciiChars::SPC)
@@ -167,6 +178,8 @@ bool OutputStateMachineEngine::ActionPrintString(const std::wstring_view string)
 // - true iff we successfully dispatched the sequence.
 bool OutputStateMachineEngine::ActionPassThroughString(const std::wstring_view string)
 {
+    _FlushGraphicsRendition();
+
     bool success = true;
     if (_pTtyConnection != nullptr)
     {
@@ -189,6 +202,8 @@ bool OutputStateMachineEngine::ActionPassThroughString(const std::wstring_view s
 // - true iff we successfully dispatched the sequence.
 bool OutputStateMachineEngine::ActionEscDispatch(const VTID id)
 {
+    _FlushGraphicsRendition();
+
     bool success = false;
 
     switch (id)
@@ -199,91 +214,91 @@ bool OutputStateMachineEngine::ActionEscDispatch(const VTID id)
         break;
     case EscActionCodes::DECSC_CursorSave:
         success = _dispatch->CursorSaveState();
-        TermTelemetry::Instance().Log(TermTelemetry::Codes::DECSC);
+        _telemetry.Log(TermTelemetry::Codes::DECSC);
         break;
     case EscActionCodes::DECRC_CursorRestore:
         success = _dispatch->CursorRestoreState();
-        TermTelemetry::Instance().Log(TermTelemetry::Codes::DECRC);
+        _telemetry.Log(TermTelemetry::Codes::DECRC);
         break;
     case EscActionCodes::DECKPAM_KeypadApplicationMode:
         success = _dispatch->SetKeypadMode(true);
-        TermTelemetry::Instance().Log(TermTelemetry::Codes::DECKPAM);
+        _telemetry.Log(TermTelemetry::Codes::DECKPAM);
         break;
     case EscActionCodes::DECKPNM_KeypadNumericMode:
         success = _dispatch->SetKeypadMode(false);
-        TermTelemetry::Instance().Log(TermTelemetry::Codes::DECKPNM);
+        _telemetry.Log(TermTelemetry::Codes::DECKPNM);
         break;
     case EscActionCodes::NEL_NextLine:
         success = _dispatch->LineFeed(DispatchTypes::LineFeedType::WithReturn);
-        TermTelemetry::Instance().Log(TermTelemetry::Codes::NEL);
+        _telemetry.Log(TermTelemetry::Codes::NEL);
         break;
     case EscActionCodes::IND_Index:
         success = _dispatch->LineFeed(DispatchTypes::LineFeedType::WithoutReturn);
-        TermTelemetry::Instance().Log(TermTelemetry::Codes::IND);
+        _telemetry.Log(TermTelemetry::Codes::IND);
         break;
     case EscActionCodes::RI_ReverseLineFeed:
         success = _dispatch->ReverseLineFeed();
-        TermTelemetry::Instance().Log(TermTelemetry::Codes::RI);
+        _telemetry.Log(TermTelemetry::Codes::RI);
         break;
     case EscActionCodes::HTS_HorizontalTabSet:
         success = _dispatch->HorizontalTabSet();
-        TermTelemetry::Instance().Log(TermTelemetry::Codes::HTS);
+        _telemetry.Log(TermTelemetry::Codes::HTS);
         break;
     case EscActionCodes::DECID_IdentifyDevice:
         success = _dispatch->DeviceAttributes();
-        TermTelemetry::Instance().Log(TermTelemetry::Codes::DA);
+        _telemetry.Log(TermTelemetry::Codes::DA);
         break;
     case EscActionCodes::RIS_ResetToInitialState:
         success = _dispatch->HardReset();
-        TermTelemetry::Instance().Log(TermTelemetry::Codes::RIS);
+        _telemetry.Log(TermTelemetry::Codes::RIS);
         break;
     case EscActionCodes::SS2_SingleShift:
         success = _dispatch->SingleShift(2);
-        TermTelemetry::Instance().Log(TermTelemetry::Codes::SS2);
+        _telemetry.Log(TermTelemetry::Codes::SS2);
         break;
     case EscActionCodes::SS3_SingleShift:
         success = _dispatch->SingleShift(3);
-        TermTelemetry::Instance().Log(TermTelemetry::Codes::SS3);
+        _telemetry.Log(TermTelemetry::Codes::SS3);
         break;
     case EscActionCodes::LS2_LockingShift:
         success = _dispatch->LockingShift(2);
-        TermTelemetry::Instance().Log(TermTelemetry::Codes::LS2);
+        _telemetry.Log(TermTelemetry::Codes::LS2);
         break;
     case EscActionCodes::LS3_LockingShift:
         success = _dispatch->LockingShift(3);
-        TermTelemetry::Instance().Log(TermTelemetry::Codes::LS3);
+        _telemetry.Log(TermTelemetry::Codes::LS3);
         break;
     case EscActionCodes::LS1R_LockingShift:
         success = _dispatch->LockingShiftRight(1);
-        TermTelemetry::Instance().Log(TermTelemetry::Codes::LS1R);
+        _telemetry.Log(TermTelemetry::Codes::LS1R);
         break;
     case EscActionCodes::LS2R_LockingShift:
         success = _dispatch->LockingShiftRight(2);
-        TermTelemetry::Instance().Log(TermTelemetry::Codes::LS2R);
+        _telemetry.Log(TermTelemetry::Codes::LS2R);
         break;
     case EscActionCodes::LS3R_LockingShift:
         success = _dispatch->LockingShiftRight(3);
-        TermTelemetry::Instance().Log(TermTelemetry::Codes::LS3R);
+        _telemetry.Log(TermTelemetry::Codes::LS3R);
         break;
     case EscActionCodes::DECDHL_DoubleHeightLineTop:
         _dispatch->SetLineRendition(LineRendition::DoubleHeightTop);
-        TermTelemetry::Instance().Log(TermTelemetry::Codes::DECDHL);
+        _telemetry.Log(TermTelemetry::Codes::DECDHL);
         break;
     case EscActionCodes::DECDHL_DoubleHeightLineBottom:
         _dispatch->SetLineRendition(LineRendition::DoubleHeightBottom);
-        TermTelemetry::Instance().Log(TermTelemetry::Codes::DECDHL);
+        _telemetry.Log(TermTelemetry::Codes::DECDHL);
         break;
     case EscActionCodes::DECSWL_SingleWidthLine:
         _dispatch->SetLineRendition(LineRendition::SingleWidth);
-        TermTelemetry::Instance().Log(TermTelemetry::Codes::DECSWL);
+        _telemetry.Log(TermTelemetry::Codes::DECSWL);
         break;
     case EscActionCodes::DECDWL_DoubleWidthLine:
         _dispatch->SetLineRendition(LineRendition::DoubleWidth);
-        TermTelemetry::Instance().Log(TermTelemetry::Codes::DECDWL);
+        _telemetry.Log(TermTelemetry::Codes::DECDWL);
         break;
     case EscActionCodes::DECALN_ScreenAlignmentPattern:
         success = _dispatch->ScreenAlignmentPattern();
-        TermTelemetry::Instance().Log(TermTelemetry::Codes::DECALN);
+        _telemetry.Log(TermTelemetry::Codes::DECALN);
         break;
     default:
         const auto commandChar = id[0];
@@ -292,35 +307,35 @@ bool OutputStateMachineEngine::ActionEscDispatch(const VTID id)
         {
         case '%':
             success = _dispatch->DesignateCodingSystem(commandParameter);
-            TermTelemetry::Instance().Log(TermTelemetry::Codes::DOCS);
+            _telemetry.Log(TermTelemetry::Codes::DOCS);
             break;
         case '(':
             success = _dispatch->Designate94Charset(0, commandParameter);
-            TermTelemetry::Instance().Log(TermTelemetry::Codes::DesignateG0);
+            _telemetry.Log(TermTelemetry::Codes::DesignateG0);
             break;
         case ')':
             success = _dispatch->Designate94Charset(1, commandParameter);
-            TermTelemetry::Instance().Log(TermTelemetry::Codes::DesignateG1);
+            _telemetry.Log(TermTelemetry::Codes::DesignateG1);
             break;
         case '*':
             success = _dispatch->Designate94Charset(2, commandParameter);
-            TermTelemetry::Instance().Log(TermTelemetry::Codes::DesignateG2);
+            _telemetry.Log(TermTelemetry::Codes::DesignateG2);
             break;
         case '+':
             success = _dispatch->Designate94Charset(3, commandParameter);
-            TermTelemetry::Instance().Log(TermTelemetry::Codes::DesignateG3);
+            _telemetry.Log(TermTelemetry::Codes::DesignateG3);
             break;
         case '-':
             success = _dispatch->Designate96Charset(1, commandParameter);
-            TermTelemetry::Instance().Log(TermTelemetry::Codes::DesignateG1);
+            _telemetry.Log(TermTelemetry::Codes::DesignateG1);
             break;
         case '.':
             success = _dispatch->Designate96Charset(2, commandParameter);
-            TermTelemetry::Instance().Log(TermTelemetry::Codes::DesignateG2);
+            _telemetry.Log(TermTelemetry::Codes::DesignateG2);
             break;
         case '/':
             success = _dispatch->Designate96Charset(3, commandParameter);
-            TermTelemetry::Instance().Log(TermTelemetry::Codes::DesignateG3);
+            _telemetry.Log(TermTelemetry::Codes::DesignateG3);
             break;
         default:
             // If no functions to call, overall dispatch was a failure.
@@ -352,6 +367,8 @@ bool OutputStateMachineEngine::ActionEscDispatch(const VTID id)
 // - true iff we successfully dispatched the sequence.
 bool OutputStateMachineEngine::ActionVt52EscDispatch(const VTID id, const VTParameters parameters)
 {
+    _FlushGraphicsRendition();
+
     bool success = false;
 
     switch (id)
@@ -425,162 +442,169 @@ bool OutputStateMachineEngine::ActionVt52EscDispatch(const VTID id, const VTPara
 // - true iff we successfully dispatched the sequence.
 bool OutputStateMachineEngine::ActionCsiDispatch(const VTID id, const VTParameters parameters)
 {
+    // Consecutive SGR sequences are coalesced into a single dispatch,
+    // everything else has to see the attributes they've set up.
+    if (id == CsiActionCodes::SGR_SetGraphicsRendition)
+    {
+        _telemetry.Log(TermTelemetry::Codes::SGR);
+        _ClearLastChar();
+        return _QueueGraphicsRendition(parameters);
+    }
+
+    _FlushGraphicsRendition();
+
     bool success = false;
 
     switch (id)
     {
     case CsiActionCodes::CUU_CursorUp:
         success = _dispatch->CursorUp(parameters.at(0));
-        TermTelemetry::Instance().Log(TermTelemetry::Codes::CUU);
+        _telemetry.Log(TermTelemetry::Codes::CUU);
         break;
     case CsiActionCodes::CUD_CursorDown:
         success = _dispatch->CursorDown(parameters.at(0));
-        TermTelemetry::Instance().Log(TermTelemetry::Codes::CUD);
+        _telemetry.Log(TermTelemetry::Codes::CUD);
         break;
     case CsiActionCodes::CUF_CursorForward:
         success = _dispatch->CursorForward(parameters.at(0));
-        TermTelemetry::Instance().Log(TermTelemetry::Codes::CUF);
+        _telemetry.Log(TermTelemetry::Codes::CUF);
         break;
     case CsiActionCodes::CUB_CursorBackward:
         success = _dispatch->CursorBackward(parameters.at(0));
-        TermTelemetry::Instance().Log(TermTelemetry::Codes::CUB);
+        _telemetry.Log(TermTelemetry::Codes::CUB);
         break;
     case CsiActionCodes::CNL_CursorNextLine:
         success = _dispatch->CursorNextLine(parameters.at(0));
-        TermTelemetry::Instance().Log(TermTelemetry::Codes::CNL);
+        _telemetry.Log(TermTelemetry::Codes::CNL);
         break;
     case CsiActionCodes::CPL_CursorPrevLine:
         success = _dispatch->CursorPrevLine(parameters.at(0));
-        TermTelemetry::Instance().Log(TermTelemetry::Codes::CPL);
+        _telemetry.Log(TermTelemetry::Codes::CPL);
         break;
     case CsiActionCodes::CHA_CursorHorizontalAbsolute:
     case CsiActionCodes::HPA_HorizontalPositionAbsolute:
         success = _dispatch->CursorHorizontalPositionAbsolute(parameters.at(0));
-        TermTelemetry::Instance().Log(TermTelemetry::Codes::CHA);
+        _telemetry.Log(TermTelemetry::Codes::CHA);
         break;
     case CsiActionCodes::VPA_VerticalLinePositionAbsolute:
         success = _dispatch->VerticalLinePositionAbsolute(parameters.at(0));
-        TermTelemetry::Instance().Log(TermTelemetry::Codes::VPA);
+        _telemetry.Log(TermTelemetry::Codes::VPA);
         break;
     case CsiActionCodes::HPR_HorizontalPositionRelative:
         success = _dispatch->HorizontalPositionRelative(parameters.at(0));
-        TermTelemetry::Instance().Log(TermTelemetry::Codes::HPR);
+        _telemetry.Log(TermTelemetry::Codes::HPR);
         break;
     case CsiActionCodes::VPR_VerticalPositionRelative:
         success = _dispatch->VerticalPositionRelative(parameters.at(0));
-        TermTelemetry::Instance().Log(TermTelemetry::Codes::VPR);
+        _telemetry.Log(TermTelemetry::Codes::VPR);
         break;
     case CsiActionCodes::CUP_CursorPosition:
     case CsiActionCodes::HVP_HorizontalVerticalPosition:
         success = _dispatch->CursorPosition(parameters.at(0), parameters.at(1));
-        TermTelemetry::Instance().Log(TermTelemetry::Codes::CUP);
+        _telemetry.Log(TermTelemetry::Codes::CUP);
         break;
     case CsiActionCodes::DECSTBM_SetScrollingRegion:
         success = _dispatch->SetTopBottomScrollingMargins(parameters.at(0).value_or(0), parameters.at(1).value_or(0));
-        TermTelemetry::Instance().Log(TermTelemetry::Codes::DECSTBM);
+        _telemetry.Log(TermTelemetry::Codes::DECSTBM);
         break;
     case CsiActionCodes::ICH_InsertCharacter:
         success = _dispatch->InsertCharacter(parameters.at(0));
-        TermTelemetry::Instance().Log(TermTelemetry::Codes::ICH);
+        _telemetry.Log(TermTelemetry::Codes::ICH);
         break;
     case CsiActionCodes::DCH_DeleteCharacter:
         success = _dispatch->DeleteCharacter(parameters.at(0));
-        TermTelemetry::Instance().Log(TermTelemetry::Codes::DCH);
+        _telemetry.Log(TermTelemetry::Codes::DCH);
         break;
     case CsiActionCodes::ED_EraseDisplay:
         success = parameters.for_each([&](const auto eraseType) {
             return _dispatch->EraseInDisplay(eraseType);
         });
-        TermTelemetry::Instance().Log(TermTelemetry::Codes::ED);
+        _telemetry.Log(TermTelemetry::Codes::ED);
         break;
     case CsiActionCodes::EL_EraseLine:
         success = parameters.for_each([&](const auto eraseType) {
             return _dispatch->EraseInLine(eraseType);
         });
-        TermTelemetry::Instance().Log(TermTelemetry::Codes::EL);
+        _telemetry.Log(TermTelemetry::Codes::EL);
         break;
     case CsiActionCodes::DECSET_PrivateModeSet:
         success = parameters.for_each([&](const auto mode) {
             return _dispatch->SetMode(DispatchTypes::DECPrivateMode(mode));
         });
         //TODO: MSFT:6367459 Add specific logging for each of the DECSET/DECRST codes
-        TermTelemetry::Instance().Log(TermTelemetry::Codes::DECSET);
+        _telemetry.Log(TermTelemetry::Codes::DECSET);
         break;
     case CsiActionCodes::DECRST_PrivateModeReset:
         success = parameters.for_each([&](const auto mode) {
             return _dispatch->ResetMode(DispatchTypes::DECPrivateMode(mode));
         });
-        TermTelemetry::Instance().Log(TermTelemetry::Codes::DECRST);
-        break;
-    case CsiActionCodes::SGR_SetGraphicsRendition:
-        success = _dispatch->SetGraphicsRendition(parameters);
-        TermTelemetry::Instance().Log(TermTelemetry::Codes::SGR);
+        _telemetry.Log(TermTelemetry::Codes::DECRST);
         break;
     case CsiActionCodes::DSR_DeviceStatusReport:
         success = _dispatch->DeviceStatusReport(parameters.at(0));
-        TermTelemetry::Instance().Log(TermTelemetry::Codes::DSR);
+        _telemetry.Log(TermTelemetry::Codes::DSR);
         break;
     case CsiActionCodes::DA_DeviceAttributes:
         success = parameters.at(0).value_or(0) == 0 && _dispatch->DeviceAttributes();
-        TermTelemetry::Instance().Log(TermTelemetry::Codes::DA);
+        _telemetry.Log(TermTelemetry::Codes::DA);
         break;
     case CsiActionCodes::DA2_SecondaryDeviceAttributes:
         success = parameters.at(0).value_or(0) == 0 && _dispatch->SecondaryDeviceAttributes();
-        TermTelemetry::Instance().Log(TermTelemetry::Codes::DA2);
+        _telemetry.Log(TermTelemetry::Codes::DA2);
         break;
     case CsiActionCodes::DA3_TertiaryDeviceAttributes:
         success = parameters.at(0).value_or(0) == 0 && _dispatch->TertiaryDeviceAttributes();
-        TermTelemetry::Instance().Log(TermTelemetry::Codes::DA3);
+        _telemetry.Log(TermTelemetry::Codes::DA3);
         break;
     case CsiActionCodes::DECREQTPARM_RequestTerminalParameters:
         success = _dispatch->RequestTerminalParameters(parameters.at(0));
-        TermTelemetry::Instance().Log(TermTelemetry::Codes::DECREQTPARM);
+        _telemetry.Log(TermTelemetry::Codes::DECREQTPARM);
         break;
     case CsiActionCodes::SU_ScrollUp:
         success = _dispatch->ScrollUp(parameters.at(0));
-        TermTelemetry::Instance().Log(TermTelemetry::Codes::SU);
+        _telemetry.Log(TermTelemetry::Codes::SU);
         break;
     case CsiActionCodes::SD_ScrollDown:
         success = _dispatch->ScrollDown(parameters.at(0));
-        TermTelemetry::Instance().Log(TermTelemetry::Codes::SD);
+        _telemetry.Log(TermTelemetry::Codes::SD);
         break;
     case CsiActionCodes::ANSISYSSC_CursorSave:
         success = parameters.empty() && _dispatch->CursorSaveState();
-        TermTelemetry::Instance().Log(TermTelemetry::Codes::ANSISYSSC);
+        _telemetry.Log(TermTelemetry::Codes::ANSISYSSC);
         break;
     case CsiActionCodes::ANSISYSRC_CursorRestore:
         success = parameters.empty() && _dispatch->CursorRestoreState();
-        TermTelemetry::Instance().Log(TermTelemetry::Codes::ANSISYSRC);
+        _telemetry.Log(TermTelemetry::Codes::ANSISYSRC);
         break;
     case CsiActionCodes::IL_InsertLine:
         success = _dispatch->InsertLine(parameters.at(0));
-        TermTelemetry::Instance().Log(TermTelemetry::Codes::IL);
+        _telemetry.Log(TermTelemetry::Codes::IL);
         break;
     case CsiActionCodes::DL_DeleteLine:
         success = _dispatch->DeleteLine(parameters.at(0));
-        TermTelemetry::Instance().Log(TermTelemetry::Codes::DL);
+        _telemetry.Log(TermTelemetry::Codes::DL);
         break;
     case CsiActionCodes::CHT_CursorForwardTab:
         success = _dispatch->ForwardTab(parameters.at(0));
-        TermTelemetry::Instance().Log(TermTelemetry::Codes::CHT);
+        _telemetry.Log(TermTelemetry::Codes::CHT);
         break;
     case CsiActionCodes::CBT_CursorBackTab:
         success = _dispatch->BackwardsTab(parameters.at(0));
-        TermTelemetry::Instance().Log(TermTelemetry::Codes::CBT);
+        _telemetry.Log(TermTelemetry::Codes::CBT);
         break;
     case CsiActionCodes::TBC_TabClear:
         success = parameters.for_each([&](const auto clearType) {
             return _dispatch->TabClear(clearType);
         });
-        TermTelemetry::Instance().Log(TermTelemetry::Codes::TBC);
+        _telemetry.Log(TermTelemetry::Codes::TBC);
         break;
     case CsiActionCodes::ECH_EraseCharacters:
         success = _dispatch->EraseCharacters(parameters.at(0));
-        TermTelemetry::Instance().Log(TermTelemetry::Codes::ECH);
+        _telemetry.Log(TermTelemetry::Codes::ECH);
         break;
     case CsiActionCodes::DTTERM_WindowManipulation:
         success = _dispatch->WindowManipulation(parameters.at(0), parameters.at(1), parameters.at(2));
-        TermTelemetry::Instance().Log(TermTelemetry::Codes::DTTERM_WM);
+        _telemetry.Log(TermTelemetry::Codes::DTTERM_WM);
         break;
     case CsiActionCodes::REP_RepeatCharacter:
         // Handled w/o the dispatch. This function is unique in that way
@@ -595,27 +619,37 @@ bool OutputStateMachineEngine::ActionCsiDispatch(const VTID id, const VTParamete
             _dispatch->PrintString(wstr);
         }
         success = true;
-        TermTelemetry::Instance().Log(TermTelemetry::Codes::REP);
+        _telemetry.Log(TermTelemetry::Codes::REP);
         break;
     case CsiActionCodes::DECSCUSR_SetCursorStyle:
         success = _dispatch->SetCursorStyle(parameters.at(0));
-        TermTelemetry::Instance().Log(TermTelemetry::Codes::DECSCUSR);
+        _telemetry.Log(TermTelemetry::Codes::DECSCUSR);
         break;
     case CsiActionCodes::DECSTR_SoftReset:
         success = _dispatch->SoftReset();
-        TermTelemetry::Instance().Log(TermTelemetry::Codes::DECSTR);
+        _telemetry.Log(TermTelemetry::Codes::DECSTR);
+        break;
+    case CsiActionCodes::DECCRA_CopyRectangularArea:
+        // The page parameters (4 and 7) are ignored, since we only have the one page.
+        success = _dispatch->CopyRectangularArea(parameters.at(0), parameters.at(1), parameters.at(2).value_or(0), parameters.at(3).value_or(0), parameters.at(5), parameters.at(6));
+        break;
+    case CsiActionCodes::DECFRA_FillRectangularArea:
+        success = _dispatch->FillRectangularArea(parameters.at(0).value_or(0), parameters.at(1), parameters.at(2), parameters.at(3).value_or(0), parameters.at(4).value_or(0));
+        break;
+    case CsiActionCodes::DECERA_EraseRectangularArea:
+        success = _dispatch->EraseRectangularArea(parameters.at(0), parameters.at(1), parameters.at(2).value_or(0), parameters.at(3).value_or(0));
         break;
 
     case CsiActionCodes::XT_PushSgr:
     case CsiActionCodes::XT_PushSgrAlias:
         success = _dispatch->PushGraphicsRendition(parameters);
-        TermTelemetry::Instance().Log(TermTelemetry::Codes::XTPUSHSGR);
+        _telemetry.Log(TermTelemetry::Codes::XTPUSHSGR);
         break;
 
     case CsiActionCodes::XT_PopSgr:
     case CsiActionCodes::XT_PopSgrAlias:
         success = _dispatch->PopGraphicsRendition();
-        TermTelemetry::Instance().Log(TermTelemetry::Codes::XTPOPSGR);
+        _telemetry.Log(TermTelemetry::Codes::XTPOPSGR);
         break;
 
     default:
@@ -647,6 +681,8 @@ bool OutputStateMachineEngine::ActionCsiDispatch(const VTID id, const VTParamete
 // - the data string handler function or nullptr if the sequence is not supported
 IStateMachineEngine::StringHandler OutputStateMachineEngine::ActionDcsDispatch(const VTID id, const VTParameters parameters)
 {
+    _FlushGraphicsRendition();
+
     StringHandler handler = nullptr;
 
     switch (id)
@@ -661,6 +697,11 @@ IStateMachineEngine::StringHandler OutputStateMachineEngine::ActionDcsDispatch(c
                                           parameters.at(6),
                                           parameters.at(7));
         break;
+    case DcsActionCodes::DECSIXEL_SixelGraphics:
+        handler = _dispatch->DefineSixelImage(parameters.at(0),
+                                              parameters.at(1),
+                                              parameters.at(2));
+        break;
     default:
         handler = nullptr;
         break;
@@ -680,7 +721,9 @@ IStateMachineEngine::StringHandler OutputStateMachineEngine::ActionDcsDispatch(c
 // - <none>
 bool OutputStateMachineEngine::ActionClear() noexcept
 {
-    // do nothing.
+    // A clipboard payload that was decoded for an aborted sequence
+    // mustn't be mistaken for the one of the next sequence.
+    _clipboardStreamed = false;
     return true;
 }
 
@@ -697,6 +740,23 @@ bool OutputStateMachineEngine::ActionIgnore() noexcept
     return true;
 }
 
+// Routine Description:
+// - Triggers the FlushPending action to indicate that the state machine has
+//      processed all of its input. Any SGR sequences that are still queued
+//      up are dispatched now, so that the attributes are in effect before
+//      the caller regains control. The sequences we counted for telemetry
+//      are handed to TermTelemetry as well.
+// Arguments:
+// - <none>
+// Return Value:
+// - true iff we successfully dispatched the queued up SGR sequences.
+bool OutputStateMachineEngine::ActionFlushPending()
+{
+    const auto success = _FlushGraphicsRendition();
+    _telemetry.Flush();
+    return success;
+}
+
 // Routine Description:
 // - Triggers the OscDispatch action to indicate that the listener should handle a control sequence.
 //   These sequences perform various API-type commands that can include many parameters.
@@ -710,6 +770,8 @@ bool OutputStateMachineEngine::ActionOscDispatch(const wchar_t /*wch*/,
                                                  const size_t parameter,
                                                  const std::wstring_view string)
 {
+    _FlushGraphicsRendition();
+
     bool success = false;
 
     switch (parameter)
@@ -721,7 +783,7 @@ bool OutputStateMachineEngine::ActionOscDispatch(const wchar_t /*wch*/,
         std::wstring title;
         success = _GetOscTitle(string, title);
         success = success && _dispatch->SetWindowTitle(title);
-        TermTelemetry::Instance().Log(TermTelemetry::Codes::OSCWT);
+        _telemetry.Log(TermTelemetry::Codes::OSCWT);
         break;
     }
     case OscActionCodes::SetColor:
@@ -735,7 +797,7 @@ bool OutputStateMachineEngine::ActionOscDispatch(const wchar_t /*wch*/,
             const auto rgb = til::at(colors, i);
             success = success && _dispatch->SetColorTableEntry(tableIndex, rgb);
         }
-        TermTelemetry::Instance().Log(TermTelemetry::Codes::OSCCT);
+        _telemetry.Log(TermTelemetry::Codes::OSCCT);
         break;
     }
     case OscActionCodes::SetForegroundColor:
@@ -756,7 +818,7 @@ bool OutputStateMachineEngine::ActionOscDispatch(const wchar_t /*wch*/,
                 {
                     success = success && _dispatch->SetDefaultForeground(color);
                 }
-                TermTelemetry::Instance().Log(TermTelemetry::Codes::OSCFG);
+                _telemetry.Log(TermTelemetry::Codes::OSCFG);
                 commandIndex++;
                 colorIndex++;
             }
@@ -768,7 +830,7 @@ bool OutputStateMachineEngine::ActionOscDispatch(const wchar_t /*wch*/,
                 {
                     success = success && _dispatch->SetDefaultBackground(color);
                 }
-                TermTelemetry::Instance().Log(TermTelemetry::Codes::OSCBG);
+                _telemetry.Log(TermTelemetry::Codes::OSCBG);
                 commandIndex++;
                 colorIndex++;
             }
@@ -780,7 +842,7 @@ bool OutputStateMachineEngine::ActionOscDispatch(const wchar_t /*wch*/,
                 {
                     success = success && _dispatch->SetCursorColor(color);
                 }
-                TermTelemetry::Instance().Log(TermTelemetry::Codes::OSCSCC);
+                _telemetry.Log(TermTelemetry::Codes::OSCSCC);
                 commandIndex++;
                 colorIndex++;
             }
@@ -791,18 +853,25 @@ bool OutputStateMachineEngine::ActionOscDispatch(const wchar_t /*wch*/,
     {
         std::wstring setClipboardContent;
         bool queryClipboard = false;
-        success = _GetOscSetClipboard(string, setClipboardContent, queryClipboard);
+        if (_clipboardStreamed)
+        {
+            success = _FinishOscSetClipboard(setClipboardContent, queryClipboard);
+        }
+        else
+        {
+            success = _GetOscSetClipboard(string, setClipboardContent, queryClipboard);
+        }
         if (success && !queryClipboard)
         {
             success = _dispatch->SetClipboard(setClipboardContent);
         }
-        TermTelemetry::Instance().Log(TermTelemetry::Codes::OSCSCB);
+        _telemetry.Log(TermTelemetry::Codes::OSCSCB);
         break;
     }
     case OscActionCodes::ResetCursorColor:
     {
         success = _dispatch->SetCursorColor(INVALID_COLOR);
-        TermTelemetry::Instance().Log(TermTelemetry::Codes::OSCRCC);
+        _telemetry.Log(TermTelemetry::Codes::OSCRCC);
         break;
     }
     case OscActionCodes::Hyperlink:
@@ -825,6 +894,11 @@ bool OutputStateMachineEngine::ActionOscDispatch(const wchar_t /*wch*/,
         success = _dispatch->DoConEmuAction(string);
         break;
     }
+    case OscActionCodes::FinalTermAction:
+    {
+        success = _dispatch->DoFinalTermAction(string);
+        break;
+    }
     default:
         // If no functions to call, overall dispatch was a failure.
         success = false;
@@ -925,6 +999,17 @@ bool OutputStateMachineEngine::DispatchIntermediatesFromEscape() const noexcept
     return false;
 }
 
+// Routine Description:
+// - Returns true if the state machine should recognize complete
+//   win32-input-mode sequences itself and dispatch them right away.
+//   Those are only ever sent as input.
+// Return Value:
+// - False.
+bool OutputStateMachineEngine::DispatchWin32InputSequencesDirectly() const noexcept
+{
+    return false;
+}
+
 // Routine Description:
 // - OSC 4 ; c ; spec ST
 //      c: the index of the ansi color table
@@ -1085,6 +1170,19 @@ void OutputStateMachineEngine::SetTerminalConnection(ITerminalOutputConnection*
     this->_pfnFlushToTerminal = pfnFlushToTerminal;
 }
 
+// Routine Description:
+// - Sets the maximum number of bytes an OscSetClipboard payload may decode
+//      into. Larger payloads are dropped as soon as they exceed the limit,
+//      instead of being buffered in full.
+// Arguments:
+// - limit - The maximum size of the decoded payload in bytes.
+// Return Value:
+// - <none>
+void OutputStateMachineEngine::SetClipboardLimit(const size_t limit) noexcept
+{
+    _clipboardDecoder.SetMaxLength(limit);
+}
+
 // Routine Description:
 // - Parse OscSetClipboard parameters with the format `Pc;Pd`. Currently the first parameter `Pc` is
 // ignored. The second parameter `Pd` should be a valid base64 string or character `?`.
@@ -1116,6 +1214,76 @@ bool OutputStateMachineEngine::_GetOscSetClipboard(const std::wstring_view strin
     return false;
 }
 
+// Routine Description:
+// - Returns the handler for the string of an OSC sequence. The payload of
+//      OscSetClipboard can be megabytes of base64, so instead of buffering
+//      it, it's decoded as it's parsed. All other strings are buffered.
+// Arguments:
+// - parameter - identifier of the OSC action to perform
+// Return Value:
+// - The handler for the OSC string, or nullptr to have it buffered.
+IStateMachineEngine::StringHandler OutputStateMachineEngine::ActionOscStringHandler(const size_t parameter)
+{
+    if (parameter != OscActionCodes::SetClipboard)
+    {
+        return nullptr;
+    }
+
+    _clipboardDecoder.Reset();
+    _clipboardDataLength = 0;
+    _clipboardStreamed = true;
+    _clipboardDataStarted = false;
+    _clipboardQuery = false;
+    return [this](const auto wch) { return _PutOscSetClipboard(wch); };
+}
+
+// Routine Description:
+// - Takes the next character of an OscSetClipboard string `Pc;Pd`. Just like
+//      in _GetOscSetClipboard, `Pc` is ignored and `Pd` is base64 decoded.
+// Arguments:
+// - wch - The next character of the OSC string.
+// Return Value:
+// - true
+bool OutputStateMachineEngine::_PutOscSetClipboard(const wchar_t wch) noexcept
+{
+    if (!_clipboardDataStarted)
+    {
+        _clipboardDataStarted = wch == L';';
+        return true;
+    }
+
+    _clipboardDataLength++;
+    _clipboardQuery = _clipboardDataLength == 1 && wch == L'?';
+    _clipboardDecoder.Feed(wch);
+    return true;
+}
+
+// Routine Description:
+// - Completes an OscSetClipboard string that was given to _PutOscSetClipboard.
+// Arguments:
+// - content - Content to set to clipboard.
+// - queryClipboard - Whether to get clipboard content and return it to terminal with base64 encoded.
+// Return Value:
+// - True if there was a valid base64 string or the passed parameter was `?`.
+bool OutputStateMachineEngine::_FinishOscSetClipboard(std::wstring& content,
+                                                      bool& queryClipboard) noexcept
+{
+    _clipboardStreamed = false;
+
+    if (!_clipboardDataStarted)
+    {
+        return false;
+    }
+
+    if (_clipboardQuery)
+    {
+        queryClipboard = true;
+        return true;
+    }
+
+    return _clipboardDecoder.Finish(content);
+}
+
 // Method Description:
 // - Clears our last stored character. The last stored character is the last
 //      graphical character we printed, which is reset if any other action is
@@ -1128,3 +1296,62 @@ void OutputStateMachineEngine::_ClearLastChar() noexcept
 {
     _lastPrintedChar = AsciiChars::NUL;
 }
+
+// Method Description:
+// - Queues up the options of an SGR sequence, so that consecutive SGR
+//      sequences like "\x1b[1m\x1b[31m\x1b[4m" only result in a single
+//      SetGraphicsRendition call - and thus in a single round-trip to get
+//      and set the attributes of the buffer.
+//   Since the options of a single sequence are applied in order anyway,
+//      appending them is equivalent to dispatching them one by one. The only
+//      exception are the extended color options, which consume the options
+//      following them. A truncated "\x1b[38;5m" would then swallow the
+//      options of the next sequence, which is why the queue is dispatched
+//      right away once it contains any of them.
+//   Only consecutive SGR sequences are coalesced. Printable text that follows
+//      them still has to be dispatched on its own, after the attributes are set,
+//      because the dispatch has no way to print a string with given attributes.
+// Arguments:
+// - parameters - The options of the SGR sequence.
+// Return Value:
+// - true iff the sequence was queued up or successfully dispatched.
+bool OutputStateMachineEngine::_QueueGraphicsRendition(const VTParameters parameters)
+{
+    auto flushNow = false;
+
+    // An empty parameter list is the equivalent of a single "default" parameter,
+    // which is why we iterate up to size() instead of copying the parameter span.
+    for (size_t i = 0; i < parameters.size(); i++)
+    {
+        const auto option = parameters.at(i);
+        const DispatchTypes::GraphicsOptions opt = option;
+        flushNow = flushNow || opt == DispatchTypes::GraphicsOptions::ForegroundExtended || opt == DispatchTypes::GraphicsOptions::BackgroundExtended;
+        _pendingGraphicsRendition.push_back(option);
+    }
+
+    return flushNow ? _FlushGraphicsRendition() : true;
+}
+
+// Method Description:
+// - Dispatches all the SGR options queued up by _QueueGraphicsRendition.
+//   The sequences have already been reported as dispatched to the state machine,
+//      so a failure is logged here, the way the state machine would have for them.
+// Arguments:
+// - <none>
+// Return Value:
+// - true iff there was nothing to dispatch or we successfully dispatched it.
+bool OutputStateMachineEngine::_FlushGraphicsRendition()
+{
+    if (_pendingGraphicsRendition.empty())
+    {
+        return true;
+    }
+
+    const auto success = _dispatch->SetGraphicsRendition({ _pendingGraphicsRendition.data(), _pendingGraphicsRendition.size() });
+    _pendingGraphicsRendition.clear();
+    if (!success)
+    {
+        TermTelemetry::Instance().LogFailed(L'm');
+    }
+    return success;
+}
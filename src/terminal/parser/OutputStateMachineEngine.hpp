@@ -15,6 +15,7 @@ Abstract:
 #include "../adapter/termDispatch.hpp"
 #include "telemetry.hpp"
 #include "IStateMachineEngine.hpp"
+#include "base64.hpp"
 #include "../../inc/ITerminalOutputConnection.hpp"
 
 namespace Microsoft::Console::VirtualTerminal
@@ -45,20 +46,29 @@ namespace Microsoft::Console::VirtualTerminal
 
         bool ActionIgnore() noexcept override;
 
+        bool ActionFlushPending() override;
+
         bool ActionOscDispatch(const wchar_t wch,
                                const size_t parameter,
                                const std::wstring_view string) override;
 
+        StringHandler ActionOscStringHandler(const size_t parameter) override;
+
         bool ActionSs3Dispatch(const wchar_t wch, const VTParameters parameters) noexcept override;
 
         bool ParseControlSequenceAfterSs3() const noexcept override;
         bool FlushAtEndOfString() const noexcept override;
         bool DispatchControlCharsFromEscape() const noexcept override;
         bool DispatchIntermediatesFromEscape() const noexcept override;
+        bool DispatchWin32InputSequencesDirectly() const noexcept override;
 
         void SetTerminalConnection(Microsoft::Console::ITerminalOutputConnection* const pTtyConnection,
                                    std::function<bool()> pfnFlushToTerminal);
 
+        // OSC 52 payloads that decode into more bytes than this are ignored.
+        static constexpr size_t DefaultClipboardLimit = 16 * 1024 * 1024;
+        void SetClipboardLimit(const size_t limit) noexcept;
+
         const ITermDispatch& Dispatch() const noexcept;
         ITermDispatch& Dispatch() noexcept;
 
@@ -67,6 +77,17 @@ namespace Microsoft::Console::VirtualTerminal
         Microsoft::Console::ITerminalOutputConnection* _pTtyConnection;
         std::function<bool()> _pfnFlushToTerminal;
         wchar_t _lastPrintedChar;
+        std::vector<VTParameter> _pendingGraphicsRendition;
+
+        // The OSC 52 payload is decoded while it's parsed, see _PutOscSetClipboard.
+        Base64::Decoder _clipboardDecoder;
+        size_t _clipboardDataLength;
+        bool _clipboardStreamed;
+        bool _clipboardDataStarted;
+        bool _clipboardQuery;
+
+        // The codes we dispatched, added to TermTelemetry in ActionFlushPending.
+        TermTelemetryBatch _telemetry;
 
         enum EscActionCodes : uint64_t
         {
@@ -137,6 +158,9 @@ namespace Microsoft::Console::VirtualTerminal
             DECREQTPARM_RequestTerminalParameters = VTID("x"),
             DECSCUSR_SetCursorStyle = VTID(" q"),
             DECSTR_SoftReset = VTID("!p"),
+            DECCRA_CopyRectangularArea = VTID("$v"),
+            DECFRA_FillRectangularArea = VTID("$x"),
+            DECERA_EraseRectangularArea = VTID("$z"),
             XT_PushSgrAlias = VTID("#p"),
             XT_PopSgrAlias = VTID("#q"),
             XT_PushSgr = VTID("#{"),
@@ -147,6 +171,7 @@ namespace Microsoft::Console::VirtualTerminal
         enum DcsActionCodes : uint64_t
         {
             DECDLD_DownloadDRCS = VTID("{"),
+            DECSIXEL_SixelGraphics = VTID("q"),
         };
 
         enum Vt52ActionCodes : uint64_t
@@ -181,6 +206,7 @@ namespace Microsoft::Console::VirtualTerminal
             SetBackgroundColor = 11,
             SetCursorColor = 12,
             SetClipboard = 52,
+            FinalTermAction = 133,
             ResetForegroundColor = 110, // Not implemented
             ResetBackgroundColor = 111, // Not implemented
             ResetCursorColor = 112
@@ -199,6 +225,9 @@ namespace Microsoft::Console::VirtualTerminal
         bool _GetOscSetClipboard(const std::wstring_view string,
                                  std::wstring& content,
                                  bool& queryClipboard) const noexcept;
+        bool _PutOscSetClipboard(const wchar_t wch) noexcept;
+        bool _FinishOscSetClipboard(std::wstring& content,
+                                    bool& queryClipboard) noexcept;
 
         static constexpr std::wstring_view hyperlinkIDParameter{ L"id=" };
         bool _ParseHyperlink(const std::wstring_view string,
@@ -206,5 +235,8 @@ namespace Microsoft::Console::VirtualTerminal
                              std::wstring& uri) const;
 
         void _ClearLastChar() noexcept;
+
+        bool _QueueGraphicsRendition(const VTParameters parameters);
+        bool _FlushGraphicsRendition();
     };
 }
@@ -6,11 +6,26 @@
 
 using namespace Microsoft::Console::VirtualTerminal;
 
-static const char base64Chars[] = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
-static const char padChar = '=';
+static constexpr char base64Chars[] = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+static constexpr char padChar = '=';
 
 #pragma warning(disable : 26446 26447 26482 26485 26493 26494)
 
+// Maps ASCII characters to their index in base64Chars, or -1 if they aren't in it.
+static constexpr auto base64Values = []() {
+    std::array<int8_t, 128> values{};
+    for (auto& value : values)
+    {
+        value = -1;
+    }
+    for (int8_t i = 0; i < 64; i++)
+    {
+        values[base64Chars[i]] = i;
+    }
+    return values;
+}();
+
+
 // Routine Description:
 // - Encode a string using base64. When there are not enough characters
 //      for one quantum, paddings are added.
@@ -75,109 +90,167 @@ std::wstring Base64::s_Encode(const std::wstring_view src) noexcept
 // - true if decoding successfully, otherwise false.
 bool Base64::s_Decode(const std::wstring_view src, std::wstring& dst) noexcept
 {
-    std::string mbStr;
-    int state = 0;
-    char tmp;
+    Decoder decoder;
+    decoder.Reserve(src.size() / 4 * 3);
+    for (const auto ch : src)
+    {
+        if (!decoder.Feed(ch))
+        {
+            return false;
+        }
+    }
+    return decoder.Finish(dst);
+}
 
-    const auto len = src.size() / 4 * 3;
-    if (len == 0)
+// Routine Description:
+// - Decode the next character of a base64 string. Once the string is known
+//      to be invalid, all further characters are ignored.
+// Arguments:
+// - ch - Character to decode.
+// Return Value:
+// - false if the string is invalid, otherwise true.
+bool Base64::Decoder::Feed(const wchar_t ch) noexcept
+{
+    _length++;
+
+    if (_failed)
     {
         return false;
     }
-    mbStr.reserve(len);
 
-    auto iter = src.cbegin();
-    while (iter < src.cend())
+    if (s_IsSpace(ch)) // Skip whitespace anywhere.
     {
-        if (s_IsSpace(*iter)) // Skip whitespace anywhere.
-        {
-            iter++;
-            continue;
-        }
+        return true;
+    }
 
-        if (*iter == padChar)
-        {
-            break;
-        }
+    switch (_padding)
+    {
+    case 0:
+        break;
+    case 1:
+        // A padding character in state 2 must be followed by another one.
+        _failed = ch != padChar;
+        _padding = 2;
+        return !_failed;
+    default:
+        // Only whitespace may follow the trailing padding characters.
+        _failed = true;
+        return false;
+    }
 
-        auto pos = strchr(base64Chars, *iter);
-        if (!pos) // A non-base64 character found.
-        {
-            return false;
-        }
+    if (ch == padChar)
+    {
+        // Invalid when state is 0 or 1.
+        _failed = _state < 2;
+        _padding = _state == 2 ? 1 : 2;
+        return !_failed;
+    }
 
-        switch (state)
-        {
-        case 0:
-            tmp = (char)(pos - base64Chars) << 2;
-            state = 1;
-            break;
-        case 1:
-            tmp |= (char)(pos - base64Chars) >> 4;
-            mbStr += tmp;
-            tmp = (char)((pos - base64Chars) & 0x0f) << 4;
-            state = 2;
-            break;
-        case 2:
-            tmp |= (char)(pos - base64Chars) >> 2;
-            mbStr += tmp;
-            tmp = (char)((pos - base64Chars) & 0x03) << 6;
-            state = 3;
-            break;
-        case 3:
-            tmp |= pos - base64Chars;
-            mbStr += tmp;
-            state = 0;
-            break;
-        default:
-            break;
-        }
+    const auto value = ch < base64Values.size() ? til::at(base64Values, ch) : -1;
+    if (value < 0) // A non-base64 character found.
+    {
+        _failed = true;
+        return false;
+    }
 
-        iter++;
+    // Every state but the first one completes a byte.
+    if (_state != 0 && _decoded.size() >= _maxLength)
+    {
+        _failed = true;
+        return false;
     }
 
-    if (iter < src.cend()) // Padding char is met.
+    switch (_state)
     {
-        iter++;
-        switch (state)
-        {
-        // Invalid when state is 0 or 1.
-        case 0:
-        case 1:
-            return false;
-        case 2:
-            // Skip any number of spaces.
-            while (iter < src.cend() && s_IsSpace(*iter))
-            {
-                iter++;
-            }
-            // Make sure there is another trailing padding character.
-            if (iter == src.cend() || *iter != padChar)
-            {
-                return false;
-            }
-            iter++; // Skip the padding character and fallthrough to "single trailing padding character" case.
-            [[fallthrough]];
-        case 3:
-            while (iter < src.cend())
-            {
-                if (!s_IsSpace(*iter))
-                {
-                    return false;
-                }
-                iter++;
-            }
-            break;
-        default:
-            break;
-        }
+    case 0:
+        _tmp = (char)(value << 2);
+        _state = 1;
+        break;
+    case 1:
+        _tmp |= (char)(value >> 4);
+        _decoded += _tmp;
+        _tmp = (char)((value & 0x0f) << 4);
+        _state = 2;
+        break;
+    case 2:
+        _tmp |= (char)(value >> 2);
+        _decoded += _tmp;
+        _tmp = (char)((value & 0x03) << 6);
+        _state = 3;
+        break;
+    case 3:
+        _tmp |= (char)value;
+        _decoded += _tmp;
+        _state = 0;
+        break;
+    default:
+        break;
     }
-    else if (state != 0) // When no padding, we must be in state 0.
+
+    return true;
+}
+
+// Routine Description:
+// - Complete the decoding of the characters given to Feed(). This requires
+//      the base64 string to be properly padded.
+// Arguments:
+// - dst - Destination to decode into.
+// Return Value:
+// - true if decoding successfully, otherwise false.
+bool Base64::Decoder::Finish(std::wstring& dst) noexcept
+{
+    if (_failed || _length / 4 * 3 == 0)
+    {
+        return false;
+    }
+
+    // When no padding, we must be in state 0. After a padding
+    // character in state 2, there must be another trailing one.
+    if ((_padding == 0 && _state != 0) || _padding == 1)
     {
         return false;
     }
 
-    return SUCCEEDED(til::u8u16(mbStr, dst));
+    return SUCCEEDED(til::u8u16(_decoded, dst));
+}
+
+// Routine Description:
+// - Limit the number of bytes the string may decode into. Longer strings
+//      are rejected as soon as they exceed the limit.
+// Arguments:
+// - maxLength - The maximum number of decoded bytes.
+// Return Value:
+// - <none>
+void Base64::Decoder::SetMaxLength(const size_t maxLength) noexcept
+{
+    _maxLength = maxLength;
+}
+
+// Routine Description:
+// - Preallocate the buffer for the given number of decoded bytes.
+// Arguments:
+// - length - The expected number of decoded bytes.
+// Return Value:
+// - <none>
+void Base64::Decoder::Reserve(const size_t length) noexcept
+{
+    _decoded.reserve(std::min(length, _maxLength));
+}
+
+// Routine Description:
+// - Prepare the decoder for the next string, keeping its buffer around.
+// Arguments:
+// - <none>
+// Return Value:
+// - <none>
+void Base64::Decoder::Reset() noexcept
+{
+    _decoded.clear();
+    _length = 0;
+    _state = 0;
+    _padding = 0;
+    _tmp = 0;
+    _failed = false;
 }
 
 // Routine Description:
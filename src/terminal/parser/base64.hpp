@@ -19,6 +19,27 @@ namespace Microsoft::Console::VirtualTerminal
         static std::wstring s_Encode(const std::wstring_view src) noexcept;
         static bool s_Decode(const std::wstring_view src, std::wstring& dst) noexcept;
 
+        // Decodes a base64 string one character at a time, so that strings
+        // can be decoded while they're received instead of being buffered.
+        class Decoder
+        {
+        public:
+            bool Feed(const wchar_t ch) noexcept;
+            bool Finish(std::wstring& dst) noexcept;
+            void SetMaxLength(const size_t maxLength) noexcept;
+            void Reserve(const size_t length) noexcept;
+            void Reset() noexcept;
+
+        private:
+            std::string _decoded;
+            size_t _maxLength = SIZE_MAX;
+            size_t _length = 0;
+            int _state = 0;
+            int _padding = 0;
+            char _tmp = 0;
+            bool _failed = false;
+        };
+
     private:
         static constexpr bool s_IsSpace(const wchar_t ch) noexcept;
     };
@@ -6,6 +6,11 @@
 #include "stateMachine.hpp"
 
 #include "ascii.hpp"
+#include "../../types/inc/AllocationAccounting.hpp"
+
+#ifdef _M_ARM64
+#include <arm64_neon.h>
+#endif
 
 using namespace Microsoft::Console::VirtualTerminal;
 
@@ -15,10 +20,18 @@ StateMachine::StateMachine(std::unique_ptr<IStateMachineEngine> engine) :
     _state(VTStates::Ground),
     _trace(Microsoft::Console::VirtualTerminal::ParserTracing()),
     _isInAnsiMode(true),
+    _transitionMode(TransitionMode::Branching),
+    _pool{ Microsoft::Console::Types::AllocationAccounting::GetResource(Microsoft::Console::Types::AllocationAccounting::Subsystem::Parser) },
     _parameters{},
+    _parameterCount(0),
     _parameterLimitReached(false),
-    _oscString{},
+    _oscInline{},
+    _oscArena{ _oscInline.data(), sizeof(_oscInline), &_pool },
+    _oscString{ &_oscArena },
+    _oscParameter(0),
+    _oscStringHandlerRequested(false),
     _cachedSequence{ std::nullopt },
+    _utf8Buffer{ &_pool },
     _processingIndividually(false)
 {
     _ActionClear();
@@ -29,6 +42,11 @@ void StateMachine::SetAnsiMode(bool ansiMode) noexcept
     _isInAnsiMode = ansiMode;
 }
 
+void StateMachine::SetTransitionMode(const TransitionMode mode) noexcept
+{
+    _transitionMode = mode;
+}
+
 const IStateMachineEngine& StateMachine::Engine() const noexcept
 {
     return *_engine;
@@ -374,6 +392,116 @@ static constexpr bool _isActionableFromGround(const wchar_t wch) noexcept
 
 #pragma warning(pop)
 
+// Routine Description:
+// - Finds the next character at or after the given offset that is actionable
+//   from the ground state, testing one character at a time. This is the
+//   reference implementation for _FindNextActionableFromGround.
+// Arguments:
+// - string - Characters to scan.
+// - offset - Index of the first character to test.
+// Return Value:
+// - The index of the next actionable character or string.size() if there isn't any.
+size_t StateMachine::_FindNextActionableFromGroundScalar(const std::wstring_view string, size_t offset) noexcept
+{
+    for (; offset < string.size(); ++offset)
+    {
+        if (_isActionableFromGround(til::at(string, offset)))
+        {
+            break;
+        }
+    }
+    return offset;
+}
+
+// Routine Description:
+// - Finds the next character at or after the given offset that is actionable
+//   from the ground state. Plain text is by far the most common input we
+//   receive, which is why we test multiple characters at once where possible.
+//   The actionable set is everything <= US (0x1F) and DEL through the end of
+//   the C1 range (0x7F - 0x9F). Both ranges can be tested with an unsigned
+//   saturating subtraction, since "x <= n" is equivalent to "sat(x - n) == 0".
+// Arguments:
+// - string - Characters to scan.
+// - offset - Index of the first character to test.
+// Return Value:
+// - The index of the next actionable character or string.size() if there isn't any.
+size_t StateMachine::_FindNextActionableFromGround(const std::wstring_view string, size_t offset) noexcept
+{
+#pragma warning(push)
+#pragma warning(disable : 26481) // Don't use pointer arithmetic. Use span instead (bounds.1).
+#pragma warning(disable : 26490) // Don't use reinterpret_cast (type.1).
+    static_assert(sizeof(wchar_t) == sizeof(uint16_t), "The vectorized code below assumes UTF-16 code units.");
+
+    const auto data = string.data();
+    const auto size = string.size();
+
+#ifdef __AVX2__
+    const auto c0Max = _mm256_set1_epi16(AsciiChars::US);
+    const auto delBase = _mm256_set1_epi16(AsciiChars::DEL);
+    const auto c1Span = _mm256_set1_epi16(0x9F - AsciiChars::DEL);
+    const auto zero = _mm256_setzero_si256();
+
+    for (; offset + 16 <= size; offset += 16)
+    {
+        const auto chars = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(data + offset));
+        const auto isC0 = _mm256_cmpeq_epi16(_mm256_subs_epu16(chars, c0Max), zero);
+        const auto isC1 = _mm256_cmpeq_epi16(_mm256_subs_epu16(_mm256_sub_epi16(chars, delBase), c1Span), zero);
+        const auto mask = static_cast<unsigned long>(_mm256_movemask_epi8(_mm256_or_si256(isC0, isC1)));
+        unsigned long index;
+        if (_BitScanForward(&index, mask))
+        {
+            // movemask returns 2 bits per 16-bit lane.
+            return offset + index / 2;
+        }
+    }
+#elif _M_AMD64
+    // Identical to the AVX2 variant above, but limited to 8 characters at a time.
+    const auto c0Max = _mm_set1_epi16(AsciiChars::US);
+    const auto delBase = _mm_set1_epi16(AsciiChars::DEL);
+    const auto c1Span = _mm_set1_epi16(0x9F - AsciiChars::DEL);
+    const auto zero = _mm_setzero_si128();
+
+    for (; offset + 8 <= size; offset += 8)
+    {
+        const auto chars = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + offset));
+        const auto isC0 = _mm_cmpeq_epi16(_mm_subs_epu16(chars, c0Max), zero);
+        const auto isC1 = _mm_cmpeq_epi16(_mm_subs_epu16(_mm_sub_epi16(chars, delBase), c1Span), zero);
+        const auto mask = static_cast<unsigned long>(_mm_movemask_epi8(_mm_or_si128(isC0, isC1)));
+        unsigned long index;
+        if (_BitScanForward(&index, mask))
+        {
+            return offset + index / 2;
+        }
+    }
+#elif _M_ARM64
+    // NEON has proper unsigned 16-bit comparisons, but no movemask.
+    // We only use it to skip over blocks without any actionable characters
+    // and let the scalar loop below find the exact position in the block.
+    const auto c0End = vdupq_n_u16(AsciiChars::SPC);
+    const auto delBase = vdupq_n_u16(AsciiChars::DEL);
+    const auto c1Span = vdupq_n_u16(0x9F - AsciiChars::DEL);
+
+    for (; offset + 8 <= size; offset += 8)
+    {
+        const auto chars = vld1q_u16(reinterpret_cast<const uint16_t*>(data + offset));
+        const auto isC0 = vcltq_u16(chars, c0End);
+        const auto isC1 = vcleq_u16(vsubq_u16(chars, delBase), c1Span);
+        if (vmaxvq_u16(vorrq_u16(isC0, isC1)) != 0)
+        {
+            break;
+        }
+    }
+#else
+    UNREFERENCED_PARAMETER(data);
+    UNREFERENCED_PARAMETER(size);
+#endif
+
+    // Handles the remaining tail of the string, as well as
+    // the entire string on platforms without vectorized code.
+    return _FindNextActionableFromGroundScalar(string, offset);
+#pragma warning(pop)
+}
+
 // Routine Description:
 // - Triggers the Execute action to indicate that the listener should immediately respond to a C0 control character.
 // Arguments:
@@ -458,7 +586,7 @@ void StateMachine::_ActionVt52EscDispatch(const wchar_t wch)
     _trace.TraceOnAction(L"Vt52EscDispatch");
 
     const bool success = _engine->ActionVt52EscDispatch(_identifier.Finalize(wch),
-                                                        { _parameters.data(), _parameters.size() });
+                                                        { _parameters.data(), _parameterCount });
 
     // Trace the result.
     _trace.DispatchSequenceTrace(success);
@@ -482,7 +610,7 @@ void StateMachine::_ActionCsiDispatch(const wchar_t wch)
     _trace.TraceOnAction(L"CsiDispatch");
 
     const bool success = _engine->ActionCsiDispatch(_identifier.Finalize(wch),
-                                                    { _parameters.data(), _parameters.size() });
+                                                    { _parameters.data(), _parameterCount });
 
     // Trace the result.
     _trace.DispatchSequenceTrace(success);
@@ -523,9 +651,9 @@ void StateMachine::_ActionParam(const wchar_t wch)
     if (!_parameterLimitReached)
     {
         // If we have no parameters and we're about to add one, get the next value ready here.
-        if (_parameters.empty())
+        if (_parameterCount == 0)
         {
-            _parameters.push_back({});
+            til::at(_parameters, _parameterCount++) = {};
         }
 
         // On a delimiter, increase the number of params we've seen.
@@ -536,23 +664,24 @@ void StateMachine::_ActionParam(const wchar_t wch)
             // If we receive a delimiter after we've already accumulated the
             // maximum allowed parameters, then we need to set a flag to
             // indicate that further parameter characters should be ignored.
-            if (_parameters.size() >= MAX_PARAMETER_COUNT)
+            if (_parameterCount >= MAX_PARAMETER_COUNT)
             {
                 _parameterLimitReached = true;
             }
             else
             {
                 // Otherwise move to next param.
-                _parameters.push_back({});
+                til::at(_parameters, _parameterCount++) = {};
             }
         }
         else
         {
             // Accumulate the character given into the last (current) parameter.
             // If the value hasn't been initialized yet, it'll start as 0.
-            auto currentParameter = _parameters.back().value_or(0);
+            auto& parameter = til::at(_parameters, _parameterCount - 1);
+            auto currentParameter = parameter.value_or(0);
             _AccumulateTo(wch, currentParameter);
-            _parameters.back() = currentParameter;
+            parameter = currentParameter;
         }
     }
 }
@@ -570,11 +699,17 @@ void StateMachine::_ActionClear()
     // clear all internal stored state.
     _identifier.Clear();
 
-    _parameters.clear();
+    _parameterCount = 0;
     _parameterLimitReached = false;
 
     _oscString.clear();
+    if (_oscString.capacity() < OSC_INLINE_CAPACITY)
+    {
+        _oscString.reserve(OSC_INLINE_CAPACITY);
+    }
     _oscParameter = 0;
+    _oscStringHandler = nullptr;
+    _oscStringHandlerRequested = false;
 
     _dcsStringHandler = nullptr;
 
@@ -634,7 +769,22 @@ void StateMachine::_ActionOscPut(const wchar_t wch)
 {
     _trace.TraceOnAction(L"OscPut");
 
-    _oscString.push_back(wch);
+    // The parameter is complete once the string starts, so that's
+    // when the engine gets to choose whether it takes the string.
+    if (!_oscStringHandlerRequested)
+    {
+        _oscStringHandler = _engine->ActionOscStringHandler(_oscParameter);
+        _oscStringHandlerRequested = true;
+    }
+
+    if (_oscStringHandler)
+    {
+        _oscStringHandler(wch);
+    }
+    else
+    {
+        _oscString.push_back(wch);
+    }
 }
 
 // Routine Description:
@@ -671,7 +821,7 @@ void StateMachine::_ActionSs3Dispatch(const wchar_t wch)
 {
     _trace.TraceOnAction(L"Ss3Dispatch");
 
-    const bool success = _engine->ActionSs3Dispatch(wch, { _parameters.data(), _parameters.size() });
+    const bool success = _engine->ActionSs3Dispatch(wch, { _parameters.data(), _parameterCount });
 
     // Trace the result.
     _trace.DispatchSequenceTrace(success);
@@ -695,7 +845,7 @@ void StateMachine::_ActionDcsDispatch(const wchar_t wch)
     _trace.TraceOnAction(L"DcsDispatch");
 
     _dcsStringHandler = _engine->ActionDcsDispatch(_identifier.Finalize(wch),
-                                                   { _parameters.data(), _parameters.size() });
+                                                   { _parameters.data(), _parameterCount });
 
     // If the returned handler is null, the sequence is not supported.
     const bool success = _dcsStringHandler != nullptr;
@@ -729,6 +879,14 @@ void StateMachine::_EnterGround() noexcept
 {
     _state = VTStates::Ground;
     _cachedSequence.reset(); // entering ground means we've completed the pending sequence
+
+    // Give back whatever an unusually long OSC string took from the pool.
+    if (_oscString.capacity() > OSC_INLINE_CAPACITY)
+    {
+        _oscString.clear();
+        _oscString.shrink_to_fit();
+        _oscArena.release();
+    }
     _trace.TraceStateChange(L"Ground");
 }
 
@@ -1511,8 +1669,8 @@ void StateMachine::_EventVt52Param(const wchar_t wch)
     }
     else
     {
-        _parameters.push_back(wch);
-        if (_parameters.size() == 2)
+        til::at(_parameters, _parameterCount++) = wch;
+        if (_parameterCount == 2)
         {
             // The command character is processed before the parameter values,
             // but it will always be 'Y', the Direct Cursor Address command.
@@ -1710,6 +1868,20 @@ void StateMachine::_EventSosPmApcString(const wchar_t /*wch*/) noexcept
 // Return Value:
 // - <none>
 void StateMachine::ProcessCharacter(const wchar_t wch)
+{
+    _trace.UpdateEnabled();
+    _ProcessCharacter(wch);
+    _engine->ActionFlushPending();
+}
+
+// Routine Description:
+// - Processes a single character according to the state machine rules, without
+//   giving the engine the chance to flush deferred actions afterwards.
+// Arguments:
+// - wch - New character to operate upon
+// Return Value:
+// - <none>
+void StateMachine::_ProcessCharacter(const wchar_t wch)
 {
     _trace.TraceCharInput(wch);
 
@@ -1729,8 +1901,8 @@ void StateMachine::ProcessCharacter(const wchar_t wch)
     // Preprocess C1 control characters and treat them as ESC + their 7-bit equivalent.
     else if (_isC1ControlCharacter(wch))
     {
-        ProcessCharacter(AsciiChars::ESC);
-        ProcessCharacter(_c1To7Bit(wch));
+        _ProcessCharacter(AsciiChars::ESC);
+        _ProcessCharacter(_c1To7Bit(wch));
     }
     // Don't go to escape from the OSC string state - ESC can be used to terminate OSC strings.
     else if (_isEscape(wch) && _state != VTStates::OscString)
@@ -1738,54 +1910,529 @@ void StateMachine::ProcessCharacter(const wchar_t wch)
         _ActionInterrupt();
         _EnterEscape();
     }
+    // VT52 mode is rare enough that it isn't covered by the transition table.
+    else if (_transitionMode == TransitionMode::TableDriven && _isInAnsiMode)
+    {
+        _EventFromTable(wch);
+    }
     else
     {
-        // Then pass to the current state as an event
-        switch (_state)
-        {
-        case VTStates::Ground:
-            return _EventGround(wch);
-        case VTStates::Escape:
-            return _EventEscape(wch);
-        case VTStates::EscapeIntermediate:
-            return _EventEscapeIntermediate(wch);
-        case VTStates::CsiEntry:
-            return _EventCsiEntry(wch);
-        case VTStates::CsiIntermediate:
-            return _EventCsiIntermediate(wch);
-        case VTStates::CsiIgnore:
-            return _EventCsiIgnore(wch);
-        case VTStates::CsiParam:
-            return _EventCsiParam(wch);
-        case VTStates::OscParam:
-            return _EventOscParam(wch);
-        case VTStates::OscString:
-            return _EventOscString(wch);
-        case VTStates::OscTermination:
-            return _EventOscTermination(wch);
-        case VTStates::Ss3Entry:
-            return _EventSs3Entry(wch);
-        case VTStates::Ss3Param:
-            return _EventSs3Param(wch);
-        case VTStates::Vt52Param:
-            return _EventVt52Param(wch);
-        case VTStates::DcsEntry:
-            return _EventDcsEntry(wch);
-        case VTStates::DcsIgnore:
-            return _EventDcsIgnore();
-        case VTStates::DcsIntermediate:
-            return _EventDcsIntermediate(wch);
-        case VTStates::DcsParam:
-            return _EventDcsParam(wch);
-        case VTStates::DcsPassThrough:
-            return _EventDcsPassThrough(wch);
-        case VTStates::SosPmApcString:
-            return _EventSosPmApcString(wch);
+        _EventFromState(wch);
+    }
+}
+
+// Routine Description:
+// - Passes the character to the _Event* handler of the current state.
+// Arguments:
+// - wch - Character that triggered the event
+// Return Value:
+// - <none>
+void StateMachine::_EventFromState(const wchar_t wch)
+{
+    // Then pass to the current state as an event
+    switch (_state)
+    {
+    case VTStates::Ground:
+        return _EventGround(wch);
+    case VTStates::Escape:
+        return _EventEscape(wch);
+    case VTStates::EscapeIntermediate:
+        return _EventEscapeIntermediate(wch);
+    case VTStates::CsiEntry:
+        return _EventCsiEntry(wch);
+    case VTStates::CsiIntermediate:
+        return _EventCsiIntermediate(wch);
+    case VTStates::CsiIgnore:
+        return _EventCsiIgnore(wch);
+    case VTStates::CsiParam:
+        return _EventCsiParam(wch);
+    case VTStates::OscParam:
+        return _EventOscParam(wch);
+    case VTStates::OscString:
+        return _EventOscString(wch);
+    case VTStates::OscTermination:
+        return _EventOscTermination(wch);
+    case VTStates::Ss3Entry:
+        return _EventSs3Entry(wch);
+    case VTStates::Ss3Param:
+        return _EventSs3Param(wch);
+    case VTStates::Vt52Param:
+        return _EventVt52Param(wch);
+    case VTStates::DcsEntry:
+        return _EventDcsEntry(wch);
+    case VTStates::DcsIgnore:
+        return _EventDcsIgnore();
+    case VTStates::DcsIntermediate:
+        return _EventDcsIntermediate(wch);
+    case VTStates::DcsParam:
+        return _EventDcsParam(wch);
+    case VTStates::DcsPassThrough:
+        return _EventDcsPassThrough(wch);
+    case VTStates::SosPmApcString:
+        return _EventSosPmApcString(wch);
+    default:
+        return;
+    }
+}
+
+// Routine Description:
+// - Determines the class of a character for the purpose of looking up its
+//   transition in the table generated by _BuildTransitionTable.
+// Arguments:
+// - wch - Character to classify.
+// Return Value:
+// - The class of the character.
+constexpr StateMachine::VTCharClasses StateMachine::_ClassifyCharacter(const wchar_t wch) noexcept
+{
+    if (_isOscTerminator(wch))
+    {
+        return VTCharClasses::Bell;
+    }
+    if (_isEscape(wch))
+    {
+        return VTCharClasses::Escape;
+    }
+    if (_isC0Code(wch))
+    {
+        return VTCharClasses::C0;
+    }
+    if (_isDelete(wch))
+    {
+        return VTCharClasses::Delete;
+    }
+    if (_isIntermediate(wch))
+    {
+        return VTCharClasses::Intermediate;
+    }
+    if (_isNumericParamValue(wch))
+    {
+        return VTCharClasses::Digit;
+    }
+    if (_isCsiInvalid(wch))
+    {
+        return VTCharClasses::Colon;
+    }
+    if (_isParameterDelimiter(wch))
+    {
+        return VTCharClasses::Semicolon;
+    }
+    if (_isCsiPrivateMarker(wch))
+    {
+        return VTCharClasses::PrivateMarker;
+    }
+    if (_isCsiIndicator(wch))
+    {
+        return VTCharClasses::CsiIndicator;
+    }
+    if (_isOscIndicator(wch))
+    {
+        return VTCharClasses::OscIndicator;
+    }
+    if (_isSs3Indicator(wch))
+    {
+        return VTCharClasses::Ss3Indicator;
+    }
+    if (_isDcsIndicator(wch))
+    {
+        return VTCharClasses::DcsIndicator;
+    }
+    if (_isSosIndicator(wch) || _isPmIndicator(wch) || _isApcIndicator(wch))
+    {
+        return VTCharClasses::SosPmApcIndicator;
+    }
+    return VTCharClasses::Other;
+}
+
+// Routine Description:
+// - Computes the transition for a character class in the given state in
+//   ANSI mode. This mirrors the logic in the _Event* handlers. Transitions
+//   that depend on the engine, as well as the few states that need more
+//   than the character class to decide, are marked as Fallback.
+// Arguments:
+// - state - The current state.
+// - charClass - The class of the character that triggered the event.
+// Return Value:
+// - The action to perform and the state to enter afterwards.
+constexpr StateMachine::VTTransition StateMachine::_ComputeTransition(const VTStates state, const VTCharClasses charClass) noexcept
+{
+    using C = VTCharClasses;
+    using A = VTActions;
+
+    constexpr auto stay = [](const A action) { return VTTransition{ action, VTStates::Ground, false }; };
+    constexpr auto enter = [](const A action, const VTStates nextState) { return VTTransition{ action, nextState, true }; };
+
+    const auto isC0 = charClass == C::C0 || charClass == C::Bell;
+    const auto isParam = charClass == C::Digit || charClass == C::Semicolon;
+    const auto isIntermediateInvalid = isParam || charClass == C::Colon || charClass == C::PrivateMarker;
+
+    switch (state)
+    {
+    case VTStates::Ground:
+        return stay(isC0 || charClass == C::Delete ? A::Execute : A::Print);
+    case VTStates::Escape:
+        switch (charClass)
+        {
+        case C::C0:
+        case C::Bell:
+        case C::Intermediate:
+        case C::Ss3Indicator:
+            return stay(A::Fallback);
+        case C::Delete:
+            return stay(A::Ignore);
+        case C::CsiIndicator:
+            return enter(A::None, VTStates::CsiEntry);
+        case C::OscIndicator:
+            return enter(A::None, VTStates::OscParam);
+        case C::DcsIndicator:
+            return enter(A::None, VTStates::DcsEntry);
+        case C::SosPmApcIndicator:
+            return enter(A::None, VTStates::SosPmApcString);
         default:
-            return;
+            return enter(A::EscDispatch, VTStates::Ground);
+        }
+    case VTStates::EscapeIntermediate:
+        if (isC0)
+        {
+            return stay(A::Execute);
+        }
+        if (charClass == C::Intermediate)
+        {
+            return stay(A::Collect);
+        }
+        if (charClass == C::Delete)
+        {
+            return stay(A::Ignore);
+        }
+        return enter(A::EscDispatch, VTStates::Ground);
+    case VTStates::CsiEntry:
+        if (isC0)
+        {
+            return stay(A::Execute);
+        }
+        if (charClass == C::Delete)
+        {
+            return stay(A::Ignore);
+        }
+        if (charClass == C::Intermediate)
+        {
+            return enter(A::Collect, VTStates::CsiIntermediate);
+        }
+        if (charClass == C::Colon)
+        {
+            return enter(A::None, VTStates::CsiIgnore);
+        }
+        if (isParam)
+        {
+            return enter(A::Param, VTStates::CsiParam);
+        }
+        if (charClass == C::PrivateMarker)
+        {
+            return enter(A::Collect, VTStates::CsiParam);
+        }
+        return enter(A::CsiDispatch, VTStates::Ground);
+    case VTStates::CsiIntermediate:
+        if (isC0)
+        {
+            return stay(A::Execute);
+        }
+        if (charClass == C::Intermediate)
+        {
+            return stay(A::Collect);
+        }
+        if (charClass == C::Delete)
+        {
+            return stay(A::Ignore);
+        }
+        if (isIntermediateInvalid)
+        {
+            return enter(A::None, VTStates::CsiIgnore);
+        }
+        return enter(A::CsiDispatch, VTStates::Ground);
+    case VTStates::CsiIgnore:
+        if (isC0)
+        {
+            return stay(A::Execute);
+        }
+        if (charClass == C::Delete || charClass == C::Intermediate || isIntermediateInvalid)
+        {
+            return stay(A::Ignore);
+        }
+        return enter(A::None, VTStates::Ground);
+    case VTStates::CsiParam:
+        if (isC0)
+        {
+            return stay(A::Execute);
+        }
+        if (charClass == C::Delete)
+        {
+            return stay(A::Ignore);
+        }
+        if (isParam)
+        {
+            return stay(A::Param);
+        }
+        if (charClass == C::Intermediate)
+        {
+            return enter(A::Collect, VTStates::CsiIntermediate);
+        }
+        if (charClass == C::Colon || charClass == C::PrivateMarker)
+        {
+            return enter(A::None, VTStates::CsiIgnore);
+        }
+        return enter(A::CsiDispatch, VTStates::Ground);
+    case VTStates::OscParam:
+        if (charClass == C::Bell)
+        {
+            return enter(A::None, VTStates::Ground);
+        }
+        if (charClass == C::Digit)
+        {
+            return stay(A::OscParam);
+        }
+        if (charClass == C::Semicolon)
+        {
+            return enter(A::None, VTStates::OscString);
+        }
+        return stay(A::Ignore);
+    case VTStates::OscString:
+        if (charClass == C::Bell)
+        {
+            return enter(A::OscDispatch, VTStates::Ground);
+        }
+        if (charClass == C::Escape)
+        {
+            return enter(A::None, VTStates::OscTermination);
+        }
+        if (charClass == C::C0)
+        {
+            return stay(A::Ignore);
+        }
+        return stay(A::OscPut);
+    case VTStates::Ss3Entry:
+        if (isC0)
+        {
+            return stay(A::Execute);
+        }
+        if (charClass == C::Delete)
+        {
+            return stay(A::Ignore);
+        }
+        if (charClass == C::Colon)
+        {
+            return enter(A::None, VTStates::CsiIgnore);
+        }
+        if (isParam)
+        {
+            return enter(A::Param, VTStates::Ss3Param);
+        }
+        return enter(A::Ss3Dispatch, VTStates::Ground);
+    case VTStates::Ss3Param:
+        if (isC0)
+        {
+            return stay(A::Execute);
+        }
+        if (charClass == C::Delete)
+        {
+            return stay(A::Ignore);
+        }
+        if (isParam)
+        {
+            return stay(A::Param);
+        }
+        if (charClass == C::Colon || charClass == C::PrivateMarker)
+        {
+            return enter(A::None, VTStates::CsiIgnore);
+        }
+        return enter(A::Ss3Dispatch, VTStates::Ground);
+    case VTStates::DcsEntry:
+        if (isC0 || charClass == C::Delete)
+        {
+            return stay(A::Ignore);
+        }
+        if (charClass == C::Colon)
+        {
+            return enter(A::None, VTStates::DcsIgnore);
+        }
+        if (isParam)
+        {
+            return enter(A::Param, VTStates::DcsParam);
+        }
+        if (charClass == C::Intermediate)
+        {
+            return enter(A::Collect, VTStates::DcsIntermediate);
+        }
+        // DcsDispatch enters either DcsPassThrough or DcsIgnore by itself.
+        return stay(A::DcsDispatch);
+    case VTStates::DcsIgnore:
+    case VTStates::SosPmApcString:
+        return stay(A::Ignore);
+    case VTStates::DcsIntermediate:
+        if (isC0 || charClass == C::Delete)
+        {
+            return stay(A::Ignore);
+        }
+        if (charClass == C::Intermediate)
+        {
+            return stay(A::Collect);
+        }
+        if (isIntermediateInvalid)
+        {
+            return enter(A::None, VTStates::DcsIgnore);
+        }
+        return stay(A::DcsDispatch);
+    default:
+        // OscTermination re-dispatches into the Escape state, Vt52Param
+        // counts its parameters, DcsParam dispatches C0 characters and
+        // DcsPassThrough hands everything to the string handler.
+        return stay(A::Fallback);
+    }
+}
+
+// Routine Description:
+// - Generates the transition table for all states and character classes.
+// Arguments:
+// - <none>
+// Return Value:
+// - The transition table.
+constexpr StateMachine::VTTransitionTable StateMachine::_BuildTransitionTable() noexcept
+{
+    VTTransitionTable table{};
+    for (size_t state = 0; state < table.size(); ++state)
+    {
+        for (size_t charClass = 0; charClass < table[state].size(); ++charClass)
+        {
+            table[state][charClass] = _ComputeTransition(static_cast<VTStates>(state), static_cast<VTCharClasses>(charClass));
         }
     }
+    return table;
+}
+
+// Routine Description:
+// - Moves the state machine into the given state, by calling its _Enter* method.
+// Arguments:
+// - state - The state to enter.
+// Return Value:
+// - <none>
+void StateMachine::_EnterState(const VTStates state)
+{
+    switch (state)
+    {
+    case VTStates::Ground:
+        return _EnterGround();
+    case VTStates::Escape:
+        return _EnterEscape();
+    case VTStates::EscapeIntermediate:
+        return _EnterEscapeIntermediate();
+    case VTStates::CsiEntry:
+        return _EnterCsiEntry();
+    case VTStates::CsiIntermediate:
+        return _EnterCsiIntermediate();
+    case VTStates::CsiIgnore:
+        return _EnterCsiIgnore();
+    case VTStates::CsiParam:
+        return _EnterCsiParam();
+    case VTStates::OscParam:
+        return _EnterOscParam();
+    case VTStates::OscString:
+        return _EnterOscString();
+    case VTStates::OscTermination:
+        return _EnterOscTermination();
+    case VTStates::Ss3Entry:
+        return _EnterSs3Entry();
+    case VTStates::Ss3Param:
+        return _EnterSs3Param();
+    case VTStates::Vt52Param:
+        return _EnterVt52Param();
+    case VTStates::DcsEntry:
+        return _EnterDcsEntry();
+    case VTStates::DcsIgnore:
+        return _EnterDcsIgnore();
+    case VTStates::DcsIntermediate:
+        return _EnterDcsIntermediate();
+    case VTStates::DcsParam:
+        return _EnterDcsParam();
+    case VTStates::DcsPassThrough:
+        return _EnterDcsPassThrough();
+    case VTStates::SosPmApcString:
+        return _EnterSosPmApcString();
+    default:
+        return;
+    }
+}
+
+// Routine Description:
+// - Processes a character event by looking up the action and the next state
+//   in the transition table, instead of walking the _Event* handlers.
+//   Only valid in ANSI mode and after "from anywhere" events have been handled.
+// Arguments:
+// - wch - Character that triggered the event
+// Return Value:
+// - <none>
+void StateMachine::_EventFromTable(const wchar_t wch)
+{
+    static constexpr auto transitions = _BuildTransitionTable();
+    static constexpr auto asciiClasses = []() {
+        std::array<VTCharClasses, 128> classes{};
+        for (size_t i = 0; i < classes.size(); ++i)
+        {
+            classes[i] = _ClassifyCharacter(static_cast<wchar_t>(i));
+        }
+        return classes;
+    }();
+
+    const auto charClass = wch < asciiClasses.size() ? til::at(asciiClasses, wch) : VTCharClasses::Other;
+    const auto& transition = til::at(til::at(transitions, static_cast<size_t>(_state)), static_cast<size_t>(charClass));
+
+    switch (transition.action)
+    {
+    case VTActions::Fallback:
+        return _EventFromState(wch);
+    case VTActions::None:
+        break;
+    case VTActions::Ignore:
+        _ActionIgnore();
+        break;
+    case VTActions::Execute:
+        _ActionExecute(wch);
+        break;
+    case VTActions::Print:
+        _ActionPrint(wch);
+        break;
+    case VTActions::Collect:
+        _ActionCollect(wch);
+        break;
+    case VTActions::Param:
+        _ActionParam(wch);
+        break;
+    case VTActions::EscDispatch:
+        _ActionEscDispatch(wch);
+        break;
+    case VTActions::CsiDispatch:
+        _ActionCsiDispatch(wch);
+        break;
+    case VTActions::OscParam:
+        _ActionOscParam(wch);
+        break;
+    case VTActions::OscPut:
+        _ActionOscPut(wch);
+        break;
+    case VTActions::OscDispatch:
+        _ActionOscDispatch(wch);
+        break;
+    case VTActions::Ss3Dispatch:
+        _ActionSs3Dispatch(wch);
+        break;
+    case VTActions::DcsDispatch:
+        _ActionDcsDispatch(wch);
+        break;
+    }
+
+    if (transition.changesState)
+    {
+        _EnterState(transition.nextState);
+    }
 }
+
 // Method Description:
 // - Pass the current string we're processing through to the engine. It may eat
 //      the string, it may write it straight to the input unmodified, it might
@@ -1835,6 +2482,8 @@ bool StateMachine::FlushToTerminal()
 // - <none>
 void StateMachine::ProcessString(const std::wstring_view string)
 {
+    _trace.UpdateEnabled();
+
     size_t start = 0;
     size_t current = start;
 
@@ -1853,7 +2502,7 @@ void StateMachine::ProcessString(const std::wstring_view string)
         if (_processingIndividually)
         {
             // If we're processing characters individually, send it to the state machine.
-            ProcessCharacter(til::at(string, current));
+            _ProcessCharacter(til::at(string, current));
             ++current;
             if (_state == VTStates::Ground) // Then check if we're back at ground. If we are, the next character (pwchCurr)
             { //   is the start of the next run of characters that might be printable.
@@ -1863,27 +2512,35 @@ void StateMachine::ProcessString(const std::wstring_view string)
         }
         else
         {
-            if (_isActionableFromGround(til::at(string, current))) // If the current char is the start of an escape sequence, or should be executed in ground state...
+            // Add all printable chars to the current run at once and stop at
+            // the first one that is the start of an escape sequence, or should
+            // be executed in ground state...
+            current = _FindNextActionableFromGround(string, current);
+            if (current < string.size())
             {
+                // The run ends right before the actionable char, which we
+                // don't want to pass through as part of the printed run.
+                _runOffset = start;
+                _runSize = current - start;
+
+                // The actionable char may well be the first one, e.g. for back-to-back sequences.
                 if (_runSize > 0)
                 {
-                    // Because the run above is composed INCLUDING current, we must
-                    // trim it off here since we just determined it's actionable
-                    // and only pass through everything before it.
-                    _runSize -= 1;
                     const auto allLeadingUpTo = _CurrentRun();
-
                     _engine->ActionPrintString(allLeadingUpTo); // ... print all the chars leading up to it as part of the run...
                     _trace.DispatchPrintRunTrace(allLeadingUpTo);
                 }
 
+                // ... unless it's a complete win32-input-mode sequence, which is dispatched right away.
+                if (const auto length = _DispatchWin32InputSequence(string.substr(current)))
+                {
+                    current += length;
+                    start = current;
+                    continue;
+                }
+
                 _processingIndividually = true; // begin processing future characters individually...
                 start = current;
-                continue;
-            }
-            else
-            {
-                ++current; // Otherwise, add this char to the current run to be printed.
             }
         }
     }
@@ -1938,7 +2595,7 @@ void StateMachine::ProcessString(const std::wstring_view string)
             auto wchIter = run.cbegin();
             while (wchIter < run.cend() - 1)
             {
-                ProcessCharacter(*wchIter);
+                _ProcessCharacter(*wchIter);
                 wchIter++;
             }
             // Manually execute the last char [pwchCurr]
@@ -1978,13 +2635,85 @@ void StateMachine::ProcessString(const std::wstring_view string)
             // thing to the terminal later.
             if (!_cachedSequence)
             {
-                _cachedSequence.emplace(std::wstring{});
+                _cachedSequence.emplace(&_pool);
             }
 
             auto& cachedSequence = *_cachedSequence;
             cachedSequence.append(run);
         }
     }
+
+    _engine->ActionFlushPending();
+}
+
+// Routine Description:
+// - In win32-input-mode, every key event arrives as a sequence of the form
+//   "CSI Vk ; Sc ; Uc ; Kd ; Cs ; Rc _", and they make up nearly all of the
+//   input conpty receives. If the string starts with a complete one of those,
+//   this parses its parameters in a single pass and dispatches it, without
+//   going through the states of the state machine for every character.
+// - Anything else, including sequences that are cut off at the end of the
+//   string, is left to the state machine.
+// - Must only be called in the ground state.
+// Arguments:
+// - string - the characters starting with the potential sequence.
+// Return Value:
+// - the length of the sequence that was dispatched, or 0 if there wasn't one.
+size_t StateMachine::_DispatchWin32InputSequence(const std::wstring_view string)
+{
+    if (string.size() < 3 || !_isEscape(til::at(string, 0)) || til::at(string, 1) != L'[' || !_engine->DispatchWin32InputSequencesDirectly())
+    {
+        return 0;
+    }
+
+    size_t parameterCount = 1;
+    til::at(_parameters, 0) = {};
+    for (size_t i = 2; i < string.size(); ++i)
+    {
+        const auto wch = til::at(string, i);
+        if (_isNumericParamValue(wch))
+        {
+            auto& parameter = til::at(_parameters, parameterCount - 1);
+            auto value = parameter.value_or(0);
+            _AccumulateTo(wch, value);
+            parameter = value;
+        }
+        else if (_isParameterDelimiter(wch) && parameterCount < MAX_PARAMETER_COUNT)
+        {
+            til::at(_parameters, parameterCount++) = {};
+        }
+        else if (wch == L'_')
+        {
+            _trace.TraceOnEvent(L"Win32Input");
+            _identifier.Clear();
+            _parameterCount = parameterCount;
+            _ActionCsiDispatch(wch);
+            _parameterCount = 0;
+            return i + 1;
+        }
+        else
+        {
+            break;
+        }
+    }
+
+    return 0;
+}
+
+// Routine Description:
+// - Helper for entry to the state machine with UTF-8 text. A code point that's
+//     split across two calls is cached until the call that completes it.
+// - Invalid sequences are replaced with U+FFFD, like til::u8u16 does.
+// Arguments:
+// - string - UTF-8 code units to operate upon
+// Return Value:
+// - <none>
+void StateMachine::ProcessString(const std::string_view string)
+{
+    // The conversion buffer is kept across calls, so that we don't allocate
+    // a new one for every chunk of text that's written.
+    THROW_IF_FAILED(til::u8u16(string, _utf8Buffer, _utf8State));
+    ProcessString(std::wstring_view{ _utf8Buffer });
 }
 
 // Routine Description:
@@ -17,6 +17,7 @@ Abstract:
 #include "IStateMachineEngine.hpp"
 #include "telemetry.hpp"
 #include "tracing.hpp"
+#include <array>
 #include <memory>
 
 namespace Microsoft::Console::VirtualTerminal
@@ -32,20 +33,36 @@ namespace Microsoft::Console::VirtualTerminal
     // that number.
     constexpr size_t MAX_PARAMETER_COUNT = 32;
 
+    // OSC strings up to this length are stored inline in the state machine.
+    constexpr size_t OSC_INLINE_CAPACITY = 255;
+
     class StateMachine final
     {
 #ifdef UNIT_TESTING
         friend class OutputEngineTest;
         friend class InputEngineTest;
+        friend class StateMachineTest;
 #endif
 
     public:
+        // Selects how characters outside the ground state are dispatched.
+        // Branching walks the _Event* handlers for the current state, while
+        // TableDriven looks up the action and the next state in a table that
+        // is generated at compile-time from the same DEC ANSI parser rules.
+        enum class TransitionMode
+        {
+            Branching,
+            TableDriven
+        };
+
         StateMachine(std::unique_ptr<IStateMachineEngine> engine);
 
         void SetAnsiMode(bool ansiMode) noexcept;
+        void SetTransitionMode(const TransitionMode mode) noexcept;
 
         void ProcessCharacter(const wchar_t wch);
         void ProcessString(const std::wstring_view string);
+        void ProcessString(const std::string_view string);
 
         void ResetState() noexcept;
 
@@ -55,6 +72,8 @@ namespace Microsoft::Console::VirtualTerminal
         IStateMachineEngine& Engine() noexcept;
 
     private:
+        void _ProcessCharacter(const wchar_t wch);
+
         void _ActionExecute(const wchar_t wch);
         void _ActionExecuteFromEscape(const wchar_t wch);
         void _ActionPrint(const wchar_t wch);
@@ -113,8 +132,15 @@ namespace Microsoft::Console::VirtualTerminal
         void _EventDcsPassThrough(const wchar_t wch);
         void _EventSosPmApcString(const wchar_t wch) noexcept;
 
+        void _EventFromState(const wchar_t wch);
+        void _EventFromTable(const wchar_t wch);
+
         void _AccumulateTo(const wchar_t wch, size_t& value) noexcept;
 
+        static size_t _FindNextActionableFromGround(const std::wstring_view string, size_t offset) noexcept;
+        size_t _DispatchWin32InputSequence(const std::wstring_view string);
+        static size_t _FindNextActionableFromGroundScalar(const std::wstring_view string, size_t offset) noexcept;
+
         enum class VTStates
         {
             Ground,
@@ -135,9 +161,65 @@ namespace Microsoft::Console::VirtualTerminal
             DcsIntermediate,
             DcsParam,
             DcsPassThrough,
-            SosPmApcString
+            SosPmApcString,
+            Count
+        };
+
+        // The character classes the transition table is indexed by. C1, CAN,
+        // SUB and (outside of OscString) ESC are handled before any lookup.
+        enum class VTCharClasses : uint8_t
+        {
+            C0,
+            Bell,
+            Escape,
+            Intermediate,
+            Digit,
+            Colon,
+            Semicolon,
+            PrivateMarker,
+            CsiIndicator,
+            OscIndicator,
+            Ss3Indicator,
+            DcsIndicator,
+            SosPmApcIndicator,
+            Delete,
+            Other,
+            Count
         };
 
+        enum class VTActions : uint8_t
+        {
+            // Calls the _Event* handler, for transitions which depend on the engine.
+            Fallback,
+            None,
+            Ignore,
+            Execute,
+            Print,
+            Collect,
+            Param,
+            EscDispatch,
+            CsiDispatch,
+            OscParam,
+            OscPut,
+            OscDispatch,
+            Ss3Dispatch,
+            DcsDispatch
+        };
+
+        struct VTTransition
+        {
+            VTActions action;
+            VTStates nextState;
+            bool changesState;
+        };
+
+        using VTTransitionTable = std::array<std::array<VTTransition, static_cast<size_t>(VTCharClasses::Count)>, static_cast<size_t>(VTStates::Count)>;
+
+        static constexpr VTCharClasses _ClassifyCharacter(const wchar_t wch) noexcept;
+        static constexpr VTTransition _ComputeTransition(const VTStates state, const VTCharClasses charClass) noexcept;
+        static constexpr VTTransitionTable _BuildTransitionTable() noexcept;
+        void _EnterState(const VTStates state);
+
         Microsoft::Console::VirtualTerminal::ParserTracing _trace;
 
         std::unique_ptr<IStateMachineEngine> _engine;
@@ -145,6 +227,7 @@ namespace Microsoft::Console::VirtualTerminal
         VTStates _state;
 
         bool _isInAnsiMode;
+        TransitionMode _transitionMode;
 
         std::wstring_view _currentString;
         size_t _runOffset;
@@ -159,16 +242,32 @@ namespace Microsoft::Console::VirtualTerminal
             return _currentString.substr(_runOffset, _runSize);
         }
 
+        // The storage for the sequences that are being parsed. Partial sequences
+        // are cached for every chunk of output they span, so the pool keeps them
+        // off the heap. Its upstream is subject to allocation accounting.
+        std::pmr::unsynchronized_pool_resource _pool;
+
         VTIDBuilder _identifier;
-        std::vector<VTParameter> _parameters;
+        std::array<VTParameter, MAX_PARAMETER_COUNT> _parameters;
+        size_t _parameterCount;
         bool _parameterLimitReached;
 
-        std::wstring _oscString;
+        // Titles and the like fit into the inline buffer. Longer strings spill
+        // into the pool and the arena is reset once we return to the ground state.
+        std::array<wchar_t, OSC_INLINE_CAPACITY + 1> _oscInline;
+        std::pmr::monotonic_buffer_resource _oscArena;
+        std::pmr::wstring _oscString;
         size_t _oscParameter;
+        IStateMachineEngine::StringHandler _oscStringHandler;
+        bool _oscStringHandlerRequested;
 
         IStateMachineEngine::StringHandler _dcsStringHandler;
 
-        std::optional<std::wstring> _cachedSequence;
+        std::optional<std::pmr::wstring> _cachedSequence;
+
+        // The partials and conversion buffer used by the UTF-8 ProcessString.
+        til::u8state _utf8State;
+        std::pmr::wstring _utf8Buffer;
 
         // This is tracked per state machine instance so that separate calls to Process*
         //   can start and finish a sequence.
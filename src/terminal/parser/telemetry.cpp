@@ -67,6 +67,40 @@ void TermTelemetry::Log(const Codes code) noexcept
     _uiTimesUsedCurrent++;
 }
 
+// Routine Description:
+// - Logs the usage of VT100 codes counted by a TermTelemetryBatch.
+//
+// Arguments:
+// - timesUsed - The number of times each code was used.
+// - timesUsedTotal - The sum of timesUsed.
+// Return Value:
+// - <none>
+void TermTelemetry::Log(const std::array<unsigned int, NUMBER_OF_CODES>& timesUsed, const unsigned int timesUsedTotal) noexcept
+{
+    for (size_t i = 0; i < timesUsed.size(); i++)
+    {
+        _uiTimesUsed[i] += til::at(timesUsed, i);
+    }
+    _uiTimesUsedCurrent += timesUsedTotal;
+}
+
+// Routine Description:
+// - Adds the codes counted since the last call to TermTelemetry.
+//
+// Arguments:
+// - <none>
+// Return Value:
+// - <none>
+void TermTelemetryBatch::Flush() noexcept
+{
+    if (_timesUsedTotal != 0)
+    {
+        TermTelemetry::Instance().Log(_timesUsed, _timesUsedTotal);
+        _timesUsed.fill(0);
+        _timesUsedTotal = 0;
+    }
+}
+
 // Routine Description:
 // - Logs a particular VT100 escape code failed or was unsupported.
 //
@@ -110,6 +110,7 @@ namespace Microsoft::Console::VirtualTerminal
             NUMBER_OF_CODES
         };
         void Log(const Codes code) noexcept;
+        void Log(const std::array<unsigned int, NUMBER_OF_CODES>& timesUsed, const unsigned int timesUsedTotal) noexcept;
         void LogFailed(const wchar_t wch) noexcept;
         void SetShouldWriteFinalLog(const bool writeLog) noexcept;
         void SetActivityId(const GUID* activityId) noexcept;
@@ -138,4 +139,23 @@ namespace Microsoft::Console::VirtualTerminal
 
         bool _fShouldWriteFinalLog;
     };
+
+    // Counts the codes that an engine dispatched, until Flush() adds them to
+    // TermTelemetry all at once. Engines flush once per string they're given,
+    // instead of going through the singleton for every sequence.
+    class TermTelemetryBatch sealed
+    {
+    public:
+        void Log(const TermTelemetry::Codes code) noexcept
+        {
+            til::at(_timesUsed, code)++;
+            _timesUsedTotal++;
+        }
+
+        void Flush() noexcept;
+
+    private:
+        std::array<unsigned int, TermTelemetry::NUMBER_OF_CODES> _timesUsed{};
+        unsigned int _timesUsedTotal = 0;
+    };
 }
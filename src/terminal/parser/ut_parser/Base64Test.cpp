@@ -98,4 +98,46 @@ class Microsoft::Console::VirtualTerminal::Base64Test
         VERIFY_ARE_EQUAL(true, success);
         VERIFY_ARE_EQUAL(L"👍👍🏻👍🏼👍🏽👍🏾👍🏿", result);
     }
+
+    TEST_METHOD(TestBase64Decoder)
+    {
+        const auto decode = [](Base64::Decoder& decoder, const std::wstring_view src, std::wstring& result) {
+            for (const auto ch : src)
+            {
+                decoder.Feed(ch);
+            }
+            return decoder.Finish(result);
+        };
+
+        std::wstring result;
+        Base64::Decoder decoder;
+
+        VERIFY_ARE_EQUAL(true, decode(decoder, L"Zm9v\r\nYmE=", result));
+        VERIFY_ARE_EQUAL(L"fooba", result);
+
+        Log::Comment(L"Once the string is invalid, the rest of it is ignored.");
+        decoder.Reset();
+        VERIFY_ARE_EQUAL(true, decoder.Feed(L'Z'));
+        VERIFY_ARE_EQUAL(false, decoder.Feed(L'?'));
+        VERIFY_ARE_EQUAL(false, decoder.Feed(L'm'));
+        VERIFY_ARE_EQUAL(false, decoder.Finish(result));
+
+        Log::Comment(L"Only whitespace may follow the padding.");
+        decoder.Reset();
+        VERIFY_ARE_EQUAL(false, decode(decoder, L"Zm9vYg==Zm9v", result));
+
+        Log::Comment(L"Strings that decode into more than the maximum length are rejected.");
+        decoder.Reset();
+        decoder.SetMaxLength(3);
+        VERIFY_ARE_EQUAL(true, decode(decoder, L"Zm9v", result));
+        decoder.Reset();
+        VERIFY_ARE_EQUAL(false, decode(decoder, L"Zm9vYg==", result));
+        decoder.SetMaxLength(SIZE_MAX);
+
+        Log::Comment(L"A reset decoder can be reused.");
+        decoder.Reset();
+        result = L"";
+        VERIFY_ARE_EQUAL(true, decode(decoder, L"Zm9vYmFy", result));
+        VERIFY_ARE_EQUAL(L"foobar", result);
+    }
 };
@@ -257,6 +257,7 @@ class Microsoft::Console::VirtualTerminal::InputEngineTest
 
     TEST_METHOD(C0Test);
     TEST_METHOD(AlphanumericTest);
+    TEST_METHOD(PastedTextTest);
     TEST_METHOD(RoundTripTest);
     TEST_METHOD(WindowManipulationTest);
     TEST_METHOD(NonAsciiTest);
@@ -281,6 +282,7 @@ class Microsoft::Console::VirtualTerminal::InputEngineTest
 
     TEST_METHOD(TestWin32InputParsing);
     TEST_METHOD(TestWin32InputOptionals);
+    TEST_METHOD(TestWin32InputSequencesDispatchedDirectly);
 
     friend class TestInteractDispatch;
 };
@@ -550,6 +552,46 @@ void InputEngineTest::AlphanumericTest()
     VerifyExpectedInputDrained();
 }
 
+void InputEngineTest::PastedTextTest()
+{
+    size_t writes = 0;
+    std::vector<INPUT_RECORD> records;
+    auto pfn = [&](std::deque<std::unique_ptr<IInputEvent>>& inEvents) {
+        ++writes;
+        const auto written = IInputEvent::ToInputRecords(inEvents);
+        records.insert(records.end(), written.begin(), written.end());
+    };
+    auto dispatch = std::make_unique<TestInteractDispatch>(pfn, &testState);
+    auto inputEngine = std::make_unique<InputStateMachineEngine>(std::move(dispatch));
+    auto _stateMachine = std::make_unique<StateMachine>(std::move(inputEngine));
+    VERIFY_IS_NOT_NULL(_stateMachine);
+    testState._stateMachine = _stateMachine.get();
+
+    Log::Comment(L"Text and the control characters in between are written with a single write");
+    const std::wstring_view text{ L"ab\rc\td" };
+    _stateMachine->ProcessString(text);
+    VERIFY_ARE_EQUAL(1u, writes);
+
+    std::wstring typed;
+    for (const auto& record : records)
+    {
+        if (record.EventType == KEY_EVENT && record.Event.KeyEvent.bKeyDown && record.Event.KeyEvent.uChar.UnicodeChar)
+        {
+            typed.push_back(record.Event.KeyEvent.uChar.UnicodeChar);
+        }
+    }
+    VERIFY_ARE_EQUAL(text, typed);
+
+    Log::Comment(L"A sequence that follows the text is written after it");
+    writes = 0;
+    records.clear();
+    _stateMachine->ProcessString(L"x\x1b[A");
+    VERIFY_ARE_EQUAL(1u, writes);
+    VERIFY_IS_TRUE(records.size() >= 4);
+    VERIFY_ARE_EQUAL(L'x', records.front().Event.KeyEvent.uChar.UnicodeChar);
+    VERIFY_ARE_EQUAL(VK_UP, records.back().Event.KeyEvent.wVirtualKeyCode);
+}
+
 void InputEngineTest::RoundTripTest()
 {
     // TODO GH #4405: This test fails.
@@ -1611,3 +1653,47 @@ void InputEngineTest::TestWin32InputOptionals()
         }
     }
 }
+
+void InputEngineTest::TestWin32InputSequencesDispatchedDirectly()
+{
+    std::vector<KeyEvent> keys;
+    auto pfn = [&](std::deque<std::unique_ptr<IInputEvent>>& inEvents) {
+        for (const auto& event : inEvents)
+        {
+            keys.push_back(*static_cast<const KeyEvent*>(event.get()));
+        }
+    };
+    auto dispatch = std::make_unique<TestInteractDispatch>(pfn, &testState);
+    auto inputEngine = std::make_unique<InputStateMachineEngine>(std::move(dispatch));
+    auto _stateMachine = std::make_unique<StateMachine>(std::move(inputEngine));
+    VERIFY_IS_NOT_NULL(_stateMachine);
+    testState._stateMachine = _stateMachine.get();
+
+    // Win32-input-mode keys are written with WriteCtrlKey.
+    testState._expectSendCtrlC = true;
+    auto resetExpectSendCtrlC = wil::scope_exit([&]() { testState._expectSendCtrlC = false; });
+
+    const auto verifyKey = [](const KeyEvent& key, const bool keyDown) {
+        VERIFY_ARE_EQUAL(0x41, key.GetVirtualKeyCode());
+        VERIFY_ARE_EQUAL(0x1e, key.GetVirtualScanCode());
+        VERIFY_ARE_EQUAL(L'a', key.GetCharData());
+        VERIFY_ARE_EQUAL(keyDown, key.IsKeyDown());
+        VERIFY_ARE_EQUAL(0u, key.GetActiveModifierKeys());
+        VERIFY_ARE_EQUAL(1, key.GetRepeatCount());
+    };
+
+    Log::Comment(L"Complete sequences, with text in between, are dispatched in order");
+    _stateMachine->ProcessString(L"\x1b[65;30;97;1;0;1_b\x1b[65;30;97;0;0;1_");
+    VERIFY_ARE_EQUAL(4u, keys.size());
+    verifyKey(keys.at(0), true);
+    VERIFY_ARE_EQUAL(L'b', keys.at(1).GetCharData());
+    verifyKey(keys.at(3), false);
+
+    Log::Comment(L"Other sequences that follow are still handled by the state machine");
+    keys.clear();
+    _stateMachine->ProcessString(L"\x1b[65;30;97;1;0;1_\x1b[A");
+    VERIFY_ARE_EQUAL(3u, keys.size());
+    verifyKey(keys.at(0), true);
+    VERIFY_ARE_EQUAL(VK_UP, keys.at(1).GetVirtualKeyCode());
+    VERIFY_ARE_EQUAL(VK_UP, keys.at(2).GetVirtualKeyCode());
+}
@@ -325,7 +325,7 @@ class Microsoft::Console::VirtualTerminal::OutputEngineTest final
         mach.ProcessCharacter(L'J');
         VERIFY_ARE_EQUAL(mach._state, StateMachine::VTStates::Ground);
 
-        VERIFY_ARE_EQUAL(mach._parameters.size(), 4u);
+        VERIFY_ARE_EQUAL(mach._parameterCount, 4u);
         VERIFY_IS_FALSE(mach._parameters.at(0).has_value());
         VERIFY_ARE_EQUAL(mach._parameters.at(1), 324u);
         VERIFY_IS_FALSE(mach._parameters.at(2).has_value());
@@ -358,7 +358,7 @@ class Microsoft::Console::VirtualTerminal::OutputEngineTest final
         VERIFY_ARE_EQUAL(mach._state, StateMachine::VTStates::Ground);
 
         Log::Comment(L"Only MAX_PARAMETER_COUNT (32) parameters should be stored");
-        VERIFY_ARE_EQUAL(mach._parameters.size(), MAX_PARAMETER_COUNT);
+        VERIFY_ARE_EQUAL(mach._parameterCount, MAX_PARAMETER_COUNT);
         for (size_t i = 0; i < MAX_PARAMETER_COUNT; i++)
         {
             VERIFY_IS_TRUE(mach._parameters.at(i).has_value());
@@ -387,7 +387,7 @@ class Microsoft::Console::VirtualTerminal::OutputEngineTest final
             mach.ProcessCharacter((wchar_t)(L'1' + i));
             VERIFY_ARE_EQUAL(mach._state, StateMachine::VTStates::CsiParam);
         }
-        VERIFY_ARE_EQUAL(mach._parameters.back(), 12345u);
+        VERIFY_ARE_EQUAL(mach._parameters.at(mach._parameterCount - 1), 12345u);
         mach.ProcessCharacter(L'J');
         VERIFY_ARE_EQUAL(mach._state, StateMachine::VTStates::Ground);
     }
@@ -544,6 +544,8 @@ class Microsoft::Console::VirtualTerminal::OutputEngineTest final
         VERIFY_ARE_EQUAL(mach._oscString.size(), 260u);
         mach.ProcessCharacter(AsciiChars::BEL);
         VERIFY_ARE_EQUAL(mach._state, StateMachine::VTStates::Ground);
+        // The string has spilled out of the inline buffer, which is given back on ground.
+        VERIFY_IS_LESS_THAN_OR_EQUAL(mach._oscString.capacity(), OSC_INLINE_CAPACITY);
     }
 
     TEST_METHOD(NormalTestOscParam)
@@ -770,7 +772,7 @@ class Microsoft::Console::VirtualTerminal::OutputEngineTest final
         mach.ProcessCharacter(L'8');
         VERIFY_ARE_EQUAL(mach._state, StateMachine::VTStates::DcsParam);
 
-        VERIFY_ARE_EQUAL(mach._parameters.size(), 4u);
+        VERIFY_ARE_EQUAL(mach._parameterCount, 4u);
         VERIFY_IS_FALSE(mach._parameters.at(0).has_value());
         VERIFY_ARE_EQUAL(mach._parameters.at(1), 324u);
         VERIFY_IS_FALSE(mach._parameters.at(2).has_value());
@@ -2317,6 +2319,59 @@ class StateMachineExternalTest final
         pDispatch->ClearState();
     }
 
+    TEST_METHOD(TestSetGraphicsRenditionCoalescing)
+    {
+        auto dispatch = std::make_unique<StatefulDispatch>();
+        auto pDispatch = dispatch.get();
+        auto engine = std::make_unique<OutputStateMachineEngine>(std::move(dispatch));
+        StateMachine mach(std::move(engine));
+
+        DispatchTypes::GraphicsOptions rgExpected[4];
+
+        Log::Comment(L"Test 1: Consecutive sequences are dispatched at once.");
+        mach.ProcessString(L"\x1b[1m\x1b[31m\x1b[m");
+        VERIFY_IS_TRUE(pDispatch->_setGraphics);
+
+        rgExpected[0] = DispatchTypes::GraphicsOptions::BoldBright;
+        rgExpected[1] = DispatchTypes::GraphicsOptions::ForegroundRed;
+        rgExpected[2] = DispatchTypes::GraphicsOptions::Off;
+        VerifyDispatchTypes({ rgExpected, 3 }, *pDispatch);
+
+        pDispatch->ClearState();
+
+        Log::Comment(L"Test 2: Anything else in between dispatches the queue first.");
+        mach.ProcessString(L"\x1b[1m\x1b[2J\x1b[4m");
+        VERIFY_IS_TRUE(pDispatch->_eraseDisplay);
+
+        rgExpected[0] = DispatchTypes::GraphicsOptions::Underline;
+        VerifyDispatchTypes({ rgExpected, 1 }, *pDispatch);
+
+        pDispatch->ClearState();
+
+        Log::Comment(L"Test 3: Extended colors don't consume the options of the next sequence.");
+        mach.ProcessString(L"\x1b[1;38;5m\x1b[4m");
+
+        rgExpected[0] = DispatchTypes::GraphicsOptions::Underline;
+        VerifyDispatchTypes({ rgExpected, 1 }, *pDispatch);
+
+        pDispatch->ClearState();
+
+        Log::Comment(L"Test 4: The queue is dispatched when a sequence is split across writes.");
+        mach.ProcessString(L"\x1b[1m\x1b[");
+        VERIFY_IS_TRUE(pDispatch->_setGraphics);
+
+        rgExpected[0] = DispatchTypes::GraphicsOptions::BoldBright;
+        VerifyDispatchTypes({ rgExpected, 1 }, *pDispatch);
+
+        pDispatch->ClearState();
+
+        mach.ProcessString(L"4m");
+        rgExpected[0] = DispatchTypes::GraphicsOptions::Underline;
+        VerifyDispatchTypes({ rgExpected, 1 }, *pDispatch);
+
+        pDispatch->ClearState();
+    }
+
     TEST_METHOD(TestDeviceStatusReport)
     {
         auto dispatch = std::make_unique<StatefulDispatch>();
@@ -3287,6 +3342,16 @@ class StateMachineExternalTest final
         VERIFY_ARE_EQUAL(L"UNCHANGED", pDispatch->_copyContent);
 
         pDispatch->ClearState();
+
+        pDispatch->_copyContent = L"UNCHANGED";
+        // Passing a payload larger than the clipboard limit won't change the content.
+        static_cast<OutputStateMachineEngine&>(mach.Engine()).SetClipboardLimit(3);
+        mach.ProcessString(L"\x1b]52;;Zm9vYg==\x07");
+        VERIFY_ARE_EQUAL(L"UNCHANGED", pDispatch->_copyContent);
+        mach.ProcessString(L"\x1b]52;;Zm9v\x07");
+        VERIFY_ARE_EQUAL(L"foo", pDispatch->_copyContent);
+
+        pDispatch->ClearState();
     }
 
     TEST_METHOD(TestAddHyperlink)
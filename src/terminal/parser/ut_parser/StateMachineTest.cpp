@@ -7,6 +7,9 @@
 
 #include "stateMachine.hpp"
 
+#include <chrono>
+#include <random>
+
 using namespace WEX::Common;
 using namespace WEX::Logging;
 using namespace WEX::TestExecution;
@@ -19,6 +22,7 @@ namespace Microsoft
         {
             class StateMachineTest;
             class TestStateMachineEngine;
+            class LoggingStateMachineEngine;
         };
     };
 };
@@ -80,12 +84,17 @@ public:
         return true;
     };
 
+    StringHandler ActionOscStringHandler(const size_t /* parameter */) override { return nullptr; };
+
     bool ActionSs3Dispatch(const wchar_t /* wch */, const VTParameters /* parameters */) override { return true; };
 
+    bool ActionFlushPending() override { return true; };
+
     bool ParseControlSequenceAfterSs3() const override { return false; }
     bool FlushAtEndOfString() const override { return false; };
     bool DispatchControlCharsFromEscape() const override { return false; };
     bool DispatchIntermediatesFromEscape() const override { return false; };
+    bool DispatchWin32InputSequencesDirectly() const override { return false; };
 
     // ActionCsiDispatch is the only method that's actually implemented.
     bool ActionCsiDispatch(const VTID id, const VTParameters parameters) override
@@ -140,6 +149,85 @@ public:
     std::wstring dcsDataString;
 };
 
+// Records every call made by the state machine, so that the output of
+// two state machines can be compared with each other.
+class Microsoft::Console::VirtualTerminal::LoggingStateMachineEngine : public IStateMachineEngine
+{
+public:
+    LoggingStateMachineEngine(const bool inputEngine) :
+        _inputEngine{ inputEngine }
+    {
+    }
+
+    bool ActionExecute(const wchar_t wch) override { return _Log(L"Execute", wch); }
+    bool ActionExecuteFromEscape(const wchar_t wch) override { return _Log(L"ExecuteFromEscape", wch); }
+    bool ActionPrint(const wchar_t wch) override { return _Log(L"Print", wch); }
+    bool ActionPrintString(const std::wstring_view string) override { return _Log(L"PrintString", string); }
+    bool ActionPassThroughString(const std::wstring_view string) override { return _Log(L"PassThroughString", string); }
+    bool ActionEscDispatch(const VTID id) override { return _Log(L"EscDispatch", id); }
+    bool ActionVt52EscDispatch(const VTID id, const VTParameters parameters) override { return _Log(L"Vt52EscDispatch", id, parameters); }
+    bool ActionCsiDispatch(const VTID id, const VTParameters parameters) override { return _Log(L"CsiDispatch", id, parameters); }
+    bool ActionClear() override { return _Log(L"Clear"); }
+    bool ActionIgnore() override { return _Log(L"Ignore"); }
+    bool ActionSs3Dispatch(const wchar_t wch, const VTParameters parameters) override { return _Log(L"Ss3Dispatch", wch, parameters); }
+    bool ActionFlushPending() override { return true; }
+
+    bool ActionOscDispatch(const wchar_t wch, const size_t parameter, const std::wstring_view string) override
+    {
+        return _Log(L"OscDispatch", wch, parameter, string);
+    }
+
+    IStateMachineEngine::StringHandler ActionOscStringHandler(const size_t /* parameter */) override
+    {
+        return nullptr;
+    }
+
+    IStateMachineEngine::StringHandler ActionDcsDispatch(const VTID id, const VTParameters parameters) override
+    {
+        _Log(L"DcsDispatch", id, parameters);
+        // Reject some of the sequences to exercise the DcsIgnore state.
+        if (id == VTID("q"))
+        {
+            return nullptr;
+        }
+        return [=](const auto ch) { return _Log(L"DcsData", ch); };
+    }
+
+    bool ParseControlSequenceAfterSs3() const override { return _inputEngine; }
+    bool FlushAtEndOfString() const override { return false; };
+    bool DispatchControlCharsFromEscape() const override { return _inputEngine; };
+    bool DispatchIntermediatesFromEscape() const override { return _inputEngine; };
+    bool DispatchWin32InputSequencesDirectly() const override { return false; };
+
+    std::wstring log;
+
+private:
+    template<typename... Args>
+    bool _Log(const wchar_t* name, Args&&... args)
+    {
+        log += name;
+        ((log += L' ', _Append(args)), ...);
+        log += L'\n';
+        // Fail some calls to exercise the error paths.
+        return log.size() % 7 != 0;
+    }
+
+    void _Append(const wchar_t wch) { log += std::to_wstring(wch); }
+    void _Append(const size_t value) { log += std::to_wstring(value); }
+    void _Append(const std::wstring_view string) { log += string; }
+    void _Append(const VTID id) { log += std::to_wstring(static_cast<uint64_t>(id)); }
+    void _Append(const VTParameters parameters)
+    {
+        for (size_t i = 0; i < parameters.size(); i++)
+        {
+            log += std::to_wstring(parameters.at(i).value_or(9999));
+            log += L';';
+        }
+    }
+
+    bool _inputEngine;
+};
+
 class Microsoft::Console::VirtualTerminal::StateMachineTest
 {
     TEST_CLASS(StateMachineTest);
@@ -159,9 +247,16 @@ class Microsoft::Console::VirtualTerminal::StateMachineTest
     TEST_METHOD(PassThroughUnhandled);
     TEST_METHOD(RunStorageBeforeEscape);
     TEST_METHOD(BulkTextPrint);
+    TEST_METHOD(Utf8TextSplitAcrossWrites);
     TEST_METHOD(PassThroughUnhandledSplitAcrossWrites);
 
     TEST_METHOD(DcsDataStringsReceivedByHandler);
+
+    TEST_METHOD(GroundScannerMatchesScalar);
+    TEST_METHOD(GroundScannerBenchmark);
+
+    TEST_METHOD(TableDrivenMatchesBranching);
+    TEST_METHOD(TableDrivenBenchmark);
 };
 
 void StateMachineTest::TwoStateMachinesDoNotInterfereWithEachother()
@@ -234,6 +329,21 @@ void StateMachineTest::BulkTextPrint()
     VERIFY_ARE_EQUAL(String(L"12345 Hello World"), String(engine.printed.c_str()));
 }
 
+void StateMachineTest::Utf8TextSplitAcrossWrites()
+{
+    auto enginePtr{ std::make_unique<TestStateMachineEngine>() };
+    // this dance is required because StateMachine presumes to take ownership of its engine.
+    auto& engine{ *enginePtr.get() };
+    StateMachine machine{ std::move(enginePtr) };
+
+    // The EURO SIGN (E2 82 AC) is split across the two writes.
+    machine.ProcessString(std::string_view{ "Hello \xE2\x82" });
+    VERIFY_ARE_EQUAL(String(L"Hello "), String(engine.printed.c_str()));
+
+    machine.ProcessString(std::string_view{ "\xAC World" });
+    VERIFY_ARE_EQUAL(String(L"Hello \x20ac World"), String(engine.printed.c_str()));
+}
+
 void StateMachineTest::PassThroughUnhandledSplitAcrossWrites()
 {
     auto enginePtr{ std::make_unique<TestStateMachineEngine>() };
@@ -342,3 +452,161 @@ void StateMachineTest::DcsDataStringsReceivedByHandler()
     // Verify the control characters were executed (if expected).
     VERIFY_ARE_EQUAL(expectedExecuted, engine.executed);
 }
+
+void StateMachineTest::GroundScannerMatchesScalar()
+{
+    // Place every possible code unit at every position of a block that's
+    // larger than the widest vector we use, so that we exercise the vectorized
+    // part, the transition into the scalar tail, as well as the tail itself.
+    std::wstring text(37, L'A');
+
+    for (size_t position = 0; position < text.size(); ++position)
+    {
+        for (unsigned int ch = 0; ch <= 0xFFFF; ++ch)
+        {
+            text[position] = static_cast<wchar_t>(ch);
+
+            for (const size_t offset : { size_t{ 0 }, position })
+            {
+                const auto expected = StateMachine::_FindNextActionableFromGroundScalar(text, offset);
+                const auto actual = StateMachine::_FindNextActionableFromGround(text, offset);
+                if (expected != actual)
+                {
+                    VERIFY_ARE_EQUAL(expected, actual, NoThrowString().Format(L"ch=%04x position=%zu offset=%zu", ch, position, offset));
+                }
+            }
+        }
+
+        text[position] = L'A';
+    }
+
+    VERIFY_ARE_EQUAL(text.size(), StateMachine::_FindNextActionableFromGround(text, 0));
+    VERIFY_ARE_EQUAL(size_t{ 0 }, StateMachine::_FindNextActionableFromGround({}, 0));
+}
+
+void StateMachineTest::GroundScannerBenchmark()
+{
+    // Resembles typical build output: long lines of plain text terminated by CRLF.
+    std::wstring text;
+    for (size_t i = 0; i < 4096; ++i)
+    {
+        text.append(L"C:\\src\\terminal\\src\\terminal\\parser\\stateMachine.cpp(42): note: compiling source file\r\n");
+    }
+
+    const auto measure = [&](auto&& scan) {
+        size_t lines = 0;
+        const auto beg = std::chrono::steady_clock::now();
+        for (size_t iteration = 0; iteration < 16; ++iteration)
+        {
+            for (size_t offset = scan(text, 0); offset < text.size(); offset = scan(text, offset + 1))
+            {
+                ++lines;
+            }
+        }
+        const auto end = std::chrono::steady_clock::now();
+        return std::make_pair(lines, std::chrono::duration<double, std::micro>(end - beg).count());
+    };
+
+    const auto [scalarCount, scalarTime] = measure(&StateMachine::_FindNextActionableFromGroundScalar);
+    const auto [vectorCount, vectorTime] = measure(&StateMachine::_FindNextActionableFromGround);
+
+    VERIFY_ARE_EQUAL(scalarCount, vectorCount);
+    Log::Comment(NoThrowString().Format(L"scalar: %.0fus, vectorized: %.0fus for %zu chars", scalarTime, vectorTime, text.size() * 16));
+}
+
+void StateMachineTest::TableDrivenMatchesBranching()
+{
+    const std::wstring_view samples[] = {
+        L"plain text\r\n\x7f\a",
+        L"\x1b[1;31mred\x1b[0m \x1b[?25l\x1b[?1049h\x1b[38;2;1;2;3m\x1b[ q",
+        L"\x1b[12:3m\x1b[1;<m\x1b[1 ;m\x1b[\x7f" L"1\x05;2m\x1b[\x1a" L"1m",
+        L"\x1b]0;title\a\x1b]2;title\x1b\\\x1b]8;;https://example.com\x1b\\link\x1b]8;;\x1b\\",
+        L"\x1b]\x7f" L"12\x03x;a\x01" L"b\x7f\x1b[",
+        L"\x1bP1;2|data\x1b\\\x1bPq#0;2;0;0;0\x1b\\\x1bP1$r\x7f\x03" L"abc\x9c\x1bP:x\x1b\\",
+        L"\x1bX sos \x1b\\\x1b^pm\x1b\\\x1b_apc\x1b\\",
+        L"\x1b(0\x1b)B\x1b#8\x1b 7\x1b\x05\x1b\x7f" L"D\x1b" L"c\x1bOA\x1bO1;2P\x1bO:x",
+        L"\x9b" L"2J\x9d" L"0;x\x9c\x90q\x9c\x98\x9c\x9e\x9c\x9f\x9c\x8f" L"A",
+    };
+
+    // Besides the handcrafted samples we also compare random
+    // strings made up of the characters the parser cares about.
+    const std::wstring_view alphabet = L"\x1b\x1b\x1b[[];;:?<0123456789 !/\aAmqOPX^_Y\\\x7f\x05\x18\x1a\x9b\x9c\x9d\x90z\u00e9";
+    std::vector<std::wstring> strings{ std::begin(samples), std::end(samples) };
+    std::minstd_rand rng{ 1234 };
+    for (size_t i = 0; i < 512; ++i)
+    {
+        auto& string = strings.emplace_back();
+        for (size_t length = rng() % 64; length > 0; --length)
+        {
+            string += alphabet[rng() % alphabet.size()];
+        }
+    }
+
+    for (const auto inputEngine : { false, true })
+    {
+        for (const auto ansiMode : { true, false })
+        {
+            auto branchingEnginePtr{ std::make_unique<LoggingStateMachineEngine>(inputEngine) };
+            const auto& branchingEngine{ *branchingEnginePtr.get() };
+            StateMachine branching{ std::move(branchingEnginePtr) };
+            branching.SetAnsiMode(ansiMode);
+
+            auto tableEnginePtr{ std::make_unique<LoggingStateMachineEngine>(inputEngine) };
+            const auto& tableEngine{ *tableEnginePtr.get() };
+            StateMachine table{ std::move(tableEnginePtr) };
+            table.SetAnsiMode(ansiMode);
+            table.SetTransitionMode(StateMachine::TransitionMode::TableDriven);
+
+            for (const auto& string : strings)
+            {
+                // Alternate between the whole string and characters one by one.
+                if (string.size() % 2)
+                {
+                    branching.ProcessString(string);
+                    table.ProcessString(string);
+                }
+                else
+                {
+                    for (const auto wch : string)
+                    {
+                        branching.ProcessCharacter(wch);
+                        table.ProcessCharacter(wch);
+                    }
+                }
+
+                VERIFY_IS_TRUE(branching._state == table._state);
+            }
+
+            VERIFY_ARE_EQUAL(String(branchingEngine.log.c_str()), String(tableEngine.log.c_str()));
+        }
+    }
+}
+
+void StateMachineTest::TableDrivenBenchmark()
+{
+    // Resembles a colored "ls" or a TUI redrawing the screen.
+    std::wstring text;
+    for (size_t i = 0; i < 4096; ++i)
+    {
+        text.append(L"\x1b[38;5;33mdir\x1b[0m \x1b[01;32mexe\x1b[0m\x1b[12;40H\x1b[K\x1b]0;t\a\r\n");
+    }
+
+    const auto measure = [&](const StateMachine::TransitionMode mode) {
+        auto enginePtr{ std::make_unique<TestStateMachineEngine>() };
+        StateMachine machine{ std::move(enginePtr) };
+        machine.SetTransitionMode(mode);
+
+        const auto beg = std::chrono::steady_clock::now();
+        for (size_t iteration = 0; iteration < 16; ++iteration)
+        {
+            machine.ProcessString(text);
+        }
+        const auto end = std::chrono::steady_clock::now();
+        return std::chrono::duration<double, std::micro>(end - beg).count();
+    };
+
+    const auto branchingTime = measure(StateMachine::TransitionMode::Branching);
+    const auto tableTime = measure(StateMachine::TransitionMode::TableDriven);
+
+    Log::Comment(NoThrowString().Format(L"branching: %.0fus, table-driven: %.0fus for %zu chars", branchingTime, tableTime, text.size() * 16));
+}
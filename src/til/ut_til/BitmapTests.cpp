@@ -1103,4 +1103,77 @@ class BitmapTests
         }
         VERIFY_ARE_EQUAL(expected, actual);
     }
+
+    TEST_METHOD(RunsAreRebuiltIncrementally)
+    {
+        const til::size mapSize{ 10, 6 };
+        til::bitmap map{ mapSize };
+        map.set(til::rectangle{ til::point{ 1, 0 }, til::size{ 3, 1 } });
+        map.set(til::rectangle{ til::point{ 2, 2 }, til::size{ 4, 3 } });
+        map.set(til::point{ 9, 5 });
+
+        const auto runsOf = [](const til::bitmap& bitmap) {
+            const auto runs = bitmap.runs();
+            return std::vector<til::rectangle>{ runs.begin(), runs.end() };
+        };
+
+        Log::Comment(L"Cache the runs, then change some rows in the middle.");
+        runsOf(map);
+        map.set(til::point{ 0, 3 });
+        map.set(til::point{ 7, 3 });
+        map.set(til::rectangle{ til::point{ 0, 1 }, til::size{ 10, 1 } });
+
+        Log::Comment(L"The incrementally rebuilt runs match the ones of an uncached copy.");
+        til::bitmap uncached{ mapSize };
+        for (const auto& run : map)
+        {
+            uncached.set(run);
+        }
+        VERIFY_IS_TRUE(runsOf(uncached) == runsOf(map));
+
+        Log::Comment(L"After a reset the runs are built from scratch again.");
+        map.reset_all();
+        VERIFY_ARE_EQUAL(0u, map.runs().size());
+        map.set(til::point{ 4, 4 });
+        VERIFY_IS_TRUE(std::vector<til::rectangle>{ til::rectangle{ til::point{ 4, 4 } } } == runsOf(map));
+    }
+
+    TEST_METHOD(TranslateMatchesMovingEveryBit)
+    {
+        // Translating shifts the whole bitset at once. Every bit that ends up
+        // in the map has to be the one that would be there after moving each
+        // bit on its own, including the ones that slid past the end of a row.
+        const til::size mapSize{ 70, 5 };
+        til::bitmap map{ mapSize };
+        map.set(til::rectangle{ til::point{ 0, 0 }, til::size{ 70, 1 } });
+        map.set(til::rectangle{ til::point{ 60, 1 }, til::size{ 10, 3 } });
+        map.set(til::rectangle{ til::point{ 0, 2 }, til::size{ 5, 3 } });
+        map.set(til::point{ 33, 4 });
+
+        for (const auto delta : { til::point{ 3, 0 }, til::point{ -3, 0 }, til::point{ 65, 1 }, til::point{ -7, 2 }, til::point{ 9, -3 } })
+        {
+            for (const auto fill : { false, true })
+            {
+                Log::Comment(NoThrowString().Format(L"Delta (%td, %td), fill %d", delta.x(), delta.y(), fill));
+
+                til::bitmap expected{ mapSize };
+                for (const auto pt : map._rc)
+                {
+                    const auto moved = pt + delta;
+                    if (map._rc.contains(moved) && map._bits[map._rc.index_of(pt)])
+                    {
+                        expected.set(moved);
+                    }
+                    if (fill && !map._rc.contains(pt - delta))
+                    {
+                        expected.set(pt);
+                    }
+                }
+
+                auto actual = map;
+                actual.translate(delta, fill);
+                VERIFY_ARE_EQUAL(expected, actual);
+            }
+        }
+    }
 };
@@ -0,0 +1,203 @@
+// Copyright (c) Microsoft Corporation.
+// Licensed under the MIT license.
+
+#include "precomp.h"
+#include "WexTestClass.h"
+
+using namespace WEX::Common;
+using namespace WEX::Logging;
+using namespace WEX::TestExecution;
+
+class MPSCTests
+{
+    BEGIN_TEST_CLASS(MPSCTests)
+        TEST_CLASS_PROPERTY(L"TestTimeout", L"0:0:10") // 10s timeout
+    END_TEST_CLASS()
+
+    TEST_METHOD(SmokeTest);
+    TEST_METHOD(FullTest);
+    TEST_METHOD(PopNTest);
+    TEST_METHOD(IntegrationTest);
+    TEST_METHOD(Benchmark);
+};
+
+void MPSCTests::SmokeTest()
+{
+    til::mpsc::queue<int> q{ 5 };
+    VERIFY_ARE_EQUAL(8u, q.capacity());
+
+    VERIFY_IS_FALSE(q.try_pop().has_value());
+
+    VERIFY_IS_TRUE(q.try_emplace(1));
+    VERIFY_IS_TRUE(q.try_emplace(2));
+    VERIFY_ARE_EQUAL(1, q.pop());
+    VERIFY_ARE_EQUAL(2, q.try_pop().value());
+    VERIFY_IS_FALSE(q.try_pop().has_value());
+}
+
+void MPSCTests::FullTest()
+{
+    til::mpsc::queue<std::unique_ptr<int>> q{ 4 };
+
+    // Push and pop more than the capacity a few times, so that the positions wrap around the buffer.
+    for (int round = 0; round < 3; ++round)
+    {
+        for (int i = 0; i < 4; ++i)
+        {
+            VERIFY_IS_TRUE(q.try_emplace(std::make_unique<int>(i)));
+        }
+        VERIFY_IS_FALSE(q.try_emplace(std::make_unique<int>(4)));
+
+        for (int i = 0; i < 4; ++i)
+        {
+            VERIFY_ARE_EQUAL(i, *q.pop());
+        }
+        VERIFY_IS_FALSE(q.try_pop().has_value());
+    }
+
+    // The destructor must release items that were never popped.
+    VERIFY_IS_TRUE(q.try_emplace(std::make_unique<int>(0)));
+}
+
+void MPSCTests::PopNTest()
+{
+    til::mpsc::queue<int> q{ 16 };
+    std::array<int, 8> buffer{};
+
+    VERIFY_ARE_EQUAL(0u, q.pop_n(buffer.begin(), buffer.size()));
+
+    for (int i = 0; i < 10; ++i)
+    {
+        VERIFY_IS_TRUE(q.try_emplace(i));
+    }
+
+    VERIFY_ARE_EQUAL(8u, q.pop_n(buffer.begin(), buffer.size()));
+    for (int i = 0; i < 8; ++i)
+    {
+        VERIFY_ARE_EQUAL(i, til::at(buffer, i));
+    }
+
+    VERIFY_ARE_EQUAL(2u, q.pop_n(buffer.begin(), buffer.size()));
+    VERIFY_ARE_EQUAL(8, buffer[0]);
+    VERIFY_ARE_EQUAL(9, buffer[1]);
+}
+
+void MPSCTests::IntegrationTest()
+{
+    static constexpr int producerCount = 4;
+    static constexpr int itemsPerProducer = 10000;
+
+    til::mpsc::queue<int> q{ 64 };
+
+    std::vector<std::thread> producers;
+    for (int p = 0; p < producerCount; ++p)
+    {
+        producers.emplace_back([&q, p]() {
+            for (int i = 0; i < itemsPerProducer; ++i)
+            {
+                while (!q.try_emplace(p * itemsPerProducer + i))
+                {
+                    std::this_thread::yield();
+                }
+            }
+        });
+    }
+
+    // Items of each producer must arrive in the order they were pushed in.
+    std::array<int, producerCount> next{};
+    for (int i = 0; i < producerCount * itemsPerProducer; ++i)
+    {
+        const auto value = q.pop();
+        const auto p = value / itemsPerProducer;
+        VERIFY_ARE_EQUAL(til::at(next, p), value % itemsPerProducer);
+        ++til::at(next, p);
+    }
+
+    for (auto& t : producers)
+    {
+        t.join();
+    }
+
+    VERIFY_IS_FALSE(q.try_pop().has_value());
+}
+
+void MPSCTests::Benchmark()
+{
+    // This compares the queue against the std::mutex + std::deque combination it's meant to replace.
+    // The numbers are logged for comparison only. They aren't verified, as they depend on the machine.
+    static constexpr int producerCount = 4;
+    static constexpr int itemsPerProducer = 250000;
+    static constexpr int totalItems = producerCount * itemsPerProducer;
+
+    const auto measure = [](auto&& push, auto&& popBatch) {
+        const auto start = std::chrono::steady_clock::now();
+
+        std::vector<std::thread> producers;
+        for (int p = 0; p < producerCount; ++p)
+        {
+            producers.emplace_back([&]() {
+                for (int i = 0; i < itemsPerProducer; ++i)
+                {
+                    push(i);
+                }
+            });
+        }
+
+        std::array<int, 64> batch{};
+        int64_t sum = 0;
+        for (int received = 0; received < totalItems;)
+        {
+            const auto n = popBatch(batch);
+            for (size_t i = 0; i < n; ++i)
+            {
+                sum += til::at(batch, i);
+            }
+            received += gsl::narrow_cast<int>(n);
+        }
+
+        for (auto& t : producers)
+        {
+            t.join();
+        }
+
+        const auto end = std::chrono::steady_clock::now();
+        VERIFY_ARE_EQUAL(int64_t{ producerCount } * itemsPerProducer * (itemsPerProducer - 1) / 2, sum);
+        return std::chrono::duration<double, std::milli>(end - start).count();
+    };
+
+    {
+        til::mpsc::queue<int> q{ 4096 };
+        const auto ms = measure(
+            [&](int i) {
+                while (!q.try_emplace(i))
+                {
+                    std::this_thread::yield();
+                }
+            },
+            [&](auto& batch) {
+                return q.pop_n(batch.begin(), batch.size());
+            });
+        Log::Comment(NoThrowString().Format(L"til::mpsc::queue: %.1fms for %d items", ms, totalItems));
+    }
+
+    {
+        std::mutex m;
+        std::deque<int> q;
+        const auto ms = measure(
+            [&](int i) {
+                const std::lock_guard<std::mutex> guard{ m };
+                q.push_back(i);
+            },
+            [&](auto& batch) {
+                const std::lock_guard<std::mutex> guard{ m };
+                size_t n = 0;
+                for (; n < batch.size() && !q.empty(); ++n)
+                {
+                    til::at(batch, n) = q.front();
+                    q.pop_front();
+                }
+                return n;
+            });
+        Log::Comment(NoThrowString().Format(L"std::mutex + std::deque: %.1fms for %d items", ms, totalItems));
+    }
+}
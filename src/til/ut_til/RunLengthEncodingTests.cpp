@@ -601,4 +601,121 @@ class RunLengthEncodingTests
             VERIFY_ARE_EQUAL(-static_cast<difference_type>(1), lower - upper);
         }
     }
+
+    TEST_METHOD(IteratorAt)
+    {
+        constexpr std::string_view expected{ "133211155" };
+        rle_vector rle{ rle_encode(expected) };
+
+        for (size_type i = 0; i < rle.size(); ++i)
+        {
+            VERIFY_ARE_EQUAL(rle.begin() + i, rle.iterator_at(i));
+            VERIFY_ARE_EQUAL(static_cast<value_type>(expected[i] - '0'), *rle.iterator_at(i));
+        }
+
+        VERIFY_ARE_EQUAL(rle.end(), rle.iterator_at(rle.size()));
+        VERIFY_ARE_EQUAL(rle.end(), rle.iterator_at(1000));
+    }
+
+    TEST_METHOD(IndexedRuns)
+    {
+        // Rows with many runs are indexed. Every position must
+        // still be found, before and after modifying the runs.
+        basic_container expected;
+        for (value_type i = 0; i < 100; ++i)
+        {
+            expected.append(static_cast<size_t>(i % 3 + 1), static_cast<value_type>(i % 10));
+        }
+
+        rle_vector rle{ rle_encode(expected) };
+        VERIFY_IS_TRUE(rle.runs().size() > 16);
+
+        const auto verify = [&]() {
+            VERIFY_ARE_EQUAL(expected.size(), rle.size());
+            VERIFY_IS_TRUE(expected == rle_decode(rle.runs()));
+            for (size_type i = 0; i < rle.size(); ++i)
+            {
+                VERIFY_ARE_EQUAL(expected[i], rle.at(i));
+                VERIFY_ARE_EQUAL(expected[i], *rle.iterator_at(i));
+            }
+            VERIFY_ARE_EQUAL(rle.end(), rle.iterator_at(rle.size()));
+        };
+
+        const std::array<rle_type, 3> replacements{ { { 7, 2 }, { 8, 5 }, { 9, 1 } } };
+        const auto replace = [&](size_type begin, size_type end) {
+            rle.replace(begin, end, replacements);
+            expected.replace(begin, end - begin, basic_container{ 7, 7, 8, 8, 8, 8, 8, 9 });
+        };
+
+        verify();
+
+        // within a run, across many runs, at the beginning and at the end
+        replace(51, 51);
+        verify();
+        replace(10, 120);
+        verify();
+        replace(0, 3);
+        verify();
+        replace(rle.size(), rle.size());
+        verify();
+
+        // removal
+        rle.replace(5, 30, gsl::span<const rle_type>{});
+        expected.erase(5, 25);
+        verify();
+
+        rle.resize_trailing_extent(40);
+        expected.resize(40);
+        verify();
+
+        rle.resize_trailing_extent(50);
+        expected.resize(50, expected.back());
+        verify();
+
+        rle.replace_values(9, 8);
+        std::replace(expected.begin(), expected.end(), value_type{ 9 }, value_type{ 8 });
+        verify();
+
+        // dropping below the number of runs that are indexed
+        rle.replace(0, rle.size(), { 1, 10 });
+        expected.assign(10, 1);
+        verify();
+    }
+
+    TEST_METHOD(Benchmark)
+    {
+        // This compares looking up every position of a row with many runs through
+        // the index against walking the runs from the beginning, like at() used to.
+        // The numbers are logged for comparison only. They aren't verified, as they depend on the machine.
+        static constexpr size_type runCount = 1000;
+        static constexpr int rounds = 20;
+
+        rle_container runs;
+        for (size_type i = 0; i < runCount; ++i)
+        {
+            runs.emplace_back(static_cast<value_type>(i % 16), static_cast<size_type>(i % 3 + 1));
+        }
+        const rle_vector rle{ rle_container{ runs } };
+
+        const auto measure = [&](auto&& lookup) {
+            const auto start = std::chrono::steady_clock::now();
+            size_t sum = 0;
+            for (int round = 0; round < rounds; ++round)
+            {
+                for (size_type i = 0; i < rle.size(); ++i)
+                {
+                    sum += lookup(i);
+                }
+            }
+            const auto end = std::chrono::steady_clock::now();
+            return std::make_pair(std::chrono::duration<double, std::milli>(end - start).count(), sum);
+        };
+
+        const auto [indexedMs, indexedSum] = measure([&](size_type i) { return *rle.iterator_at(i); });
+        const auto [linearMs, linearSum] = measure([&](size_type i) { return *(rle.begin() + i); });
+        VERIFY_ARE_EQUAL(indexedSum, linearSum);
+
+        Log::Comment(NoThrowString().Format(L"iterator_at(): %.1fms for %d lookups", indexedMs, rounds * rle.size()));
+        Log::Comment(NoThrowString().Format(L"begin() + position: %.1fms for %d lookups", linearMs, rounds * rle.size()));
+    }
 };
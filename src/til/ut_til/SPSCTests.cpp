@@ -54,6 +54,7 @@ class SPSCTests
     TEST_METHOD(DropEmptyTest);
     TEST_METHOD(DropSameRevolutionTest);
     TEST_METHOD(DropDifferentRevolutionTest);
+    TEST_METHOD(BlockNeverTest);
     TEST_METHOD(IntegrationTest);
 };
 
@@ -76,14 +77,17 @@ void SPSCTests::SmokeTest()
     // push
     tx.emplace(0);
     tx.push(data.begin(), data.end());
+    tx.push(til::spsc::block_never, data.begin(), data.end());
     tx.push(til::spsc::block_initially, data.begin(), data.end());
     tx.push(til::spsc::block_forever, data.begin(), data.end());
     tx.push_n(data.begin(), data.size());
+    tx.push_n(til::spsc::block_never, data.begin(), data.size());
     tx.push_n(til::spsc::block_initially, data.begin(), data.size());
     tx.push_n(til::spsc::block_forever, data.begin(), data.size());
 
     // pop
     std::optional<int> x = rx.pop();
+    rx.pop_n(til::spsc::block_never, data.begin(), data.size());
     rx.pop_n(til::spsc::block_initially, data.begin(), data.size());
     rx.pop_n(til::spsc::block_forever, data.begin(), data.size());
 }
@@ -183,6 +187,37 @@ void SPSCTests::DropDifferentRevolutionTest()
     VERIFY_ARE_EQUAL(counter, 8);
 }
 
+void SPSCTests::BlockNeverTest()
+{
+    auto [tx, rx] = til::spsc::channel<int>(4);
+    std::array<int, 6> data{ 1, 2, 3, 4, 5, 6 };
+
+    // Only as many items as there's room for are written, without blocking.
+    auto [written, txOk] = tx.push_n(til::spsc::block_never, data.begin(), data.size());
+    VERIFY_ARE_EQUAL(4u, written);
+    VERIFY_IS_TRUE(txOk);
+
+    std::tie(written, txOk) = tx.push_n(til::spsc::block_never, data.begin(), data.size());
+    VERIFY_ARE_EQUAL(0u, written);
+    VERIFY_IS_TRUE(txOk);
+
+    // Likewise, only the items that are there are read.
+    std::array<int, 6> out{};
+    auto [read, rxOk] = rx.pop_n(til::spsc::block_never, out.begin(), out.size());
+    VERIFY_ARE_EQUAL(4u, read);
+    VERIFY_IS_TRUE(rxOk);
+    VERIFY_ARE_EQUAL(4, out[3]);
+
+    std::tie(read, rxOk) = rx.pop_n(til::spsc::block_never, out.begin(), out.size());
+    VERIFY_ARE_EQUAL(0u, read);
+    VERIFY_IS_TRUE(rxOk);
+
+    drop(rx);
+    std::tie(written, txOk) = tx.push_n(til::spsc::block_never, data.begin(), data.size());
+    VERIFY_ARE_EQUAL(0u, written);
+    VERIFY_IS_FALSE(txOk);
+}
+
 void SPSCTests::IntegrationTest()
 {
     auto [tx, rx] = til::spsc::channel<int>(7);
@@ -0,0 +1,73 @@
+// Copyright (c) Microsoft Corporation.
+// Licensed under the MIT license.
+
+#include "precomp.h"
+
+#include "til/ticket_lock.h"
+
+using namespace WEX::Common;
+using namespace WEX::Logging;
+using namespace WEX::TestExecution;
+
+class TicketLockTests
+{
+    BEGIN_TEST_CLASS(TicketLockTests)
+        TEST_CLASS_PROPERTY(L"TestTimeout", L"0:0:10") // 10s timeout
+    END_TEST_CLASS()
+
+    TEST_METHOD(SharedBasic)
+    {
+        til::shared_ticket_lock lock;
+
+        {
+            std::unique_lock writer{ lock };
+        }
+
+        {
+            std::shared_lock reader1{ lock };
+            std::shared_lock reader2{ lock };
+        }
+
+        // This is here just to ensure that the prior
+        // readers properly unlocked the lock.
+        std::unique_lock writer{ lock };
+    }
+
+    TEST_METHOD(SharedReadersExcludeWriters)
+    {
+        static constexpr int iterations = 10000;
+
+        til::shared_ticket_lock lock;
+        int a = 0;
+        int b = 0;
+        std::atomic<bool> torn{ false };
+
+        const auto reader = [&]() {
+            for (auto i = 0; i < iterations; ++i)
+            {
+                std::shared_lock guard{ lock };
+                if (a != b)
+                {
+                    torn.store(true, std::memory_order_relaxed);
+                }
+            }
+        };
+
+        std::thread reader1{ reader };
+        std::thread reader2{ reader };
+
+        for (auto i = 0; i < iterations; ++i)
+        {
+            std::unique_lock guard{ lock };
+            ++a;
+            ++b;
+        }
+
+        reader1.join();
+        reader2.join();
+
+        VERIFY_IS_FALSE(torn.load());
+        VERIFY_ARE_EQUAL(iterations, a);
+        VERIFY_ARE_EQUAL(iterations, b);
+    }
+};
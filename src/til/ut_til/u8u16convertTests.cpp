@@ -17,6 +17,7 @@ class Utf8Utf16ConvertTests
     TEST_METHOD(TestU8ToU16Partials);
     TEST_METHOD(TestU16ToU8Partials);
     TEST_METHOD(TestU8ToU16OneByOne);
+    TEST_METHOD(TestAsciiFastPath);
 };
 
 void Utf8Utf16ConvertTests::TestU8ToU16()
@@ -191,3 +192,39 @@ void Utf8Utf16ConvertTests::TestU8ToU16OneByOne()
     VERIFY_SUCCEEDED(til::u8u16(u8String1_4, u16Out1, state));
     VERIFY_ARE_EQUAL(u16StringComp1, u16Out1);
 }
+
+void Utf8Utf16ConvertTests::TestAsciiFastPath()
+{
+    // The leading ASCII part of a string is converted by vectorized code,
+    // 16 characters at a time. Make sure that a non-ASCII character is
+    // handled correctly at any position relative to those blocks.
+    for (size_t length = 0; length < 40; ++length)
+    {
+        for (size_t position = 0; position <= length; ++position)
+        {
+            std::string u8String;
+            std::wstring u16String;
+            for (size_t i = 0; i < length; ++i)
+            {
+                if (i == position)
+                {
+                    u8String.append("\xE2\x82\xAC"); // EURO SIGN
+                    u16String.push_back(gsl::narrow_cast<wchar_t>(0x20acU));
+                }
+                else
+                {
+                    u8String.push_back(gsl::narrow_cast<char>('a' + i % 26));
+                    u16String.push_back(gsl::narrow_cast<wchar_t>(L'a' + i % 26));
+                }
+            }
+
+            std::wstring u16Out{};
+            VERIFY_ARE_EQUAL(S_OK, til::u8u16(u8String, u16Out));
+            VERIFY_ARE_EQUAL(u16String, u16Out, NoThrowString().Format(L"length %zu, position %zu", length, position));
+
+            std::string u8Out{};
+            VERIFY_ARE_EQUAL(S_OK, til::u16u8(u16String, u8Out));
+            VERIFY_ARE_EQUAL(u8String, u8Out, NoThrowString().Format(L"length %zu, position %zu", length, position));
+        }
+    }
+}
@@ -3,6 +3,7 @@
 // NOTE The functions u8u16 and u16u8 contain own algorithms. Tests have shown that they perform
 // worse than the platform API functions.
 // Thus, these functions are *unrelated* to the til::u8u16 and til::u16u8 implementation.
+// The Til_Throughput tests at the end measure til::u8u16 and til::u16u8 themselves.
 
 #include <iostream>
 #include <memory>
@@ -13,6 +14,11 @@
 
 #include "U8U16Test.hpp"
 
+#include <wil/result.h>
+#include <gsl/gsl_util>
+#include <base/numerics/safe_math.h>
+#include <til/u8u16convert.h>
+
 typedef NTSTATUS(WINAPI* t_RtlUTF8ToUnicodeN)(PWSTR, ULONG, PULONG, PCCH, ULONG);
 typedef NTSTATUS(WINAPI* t_RtlUnicodeToUTF8N)(PCHAR, ULONG, PULONG, PCWSTR, ULONG);
 NTSTATUS(WINAPI* p_RtlUTF8ToUnicodeN)
@@ -442,6 +448,60 @@ void CompNaturalLang_Chunks(const std::string& fileName)
     std::cout << " u16u8_ptr           length " << lenTotalU16U8 << " elapsed " << durTotalU16U8 << std::endl;
 }
 
+// measures the throughput of til::u8u16 and til::u16u8 against the platform functions, in GB/s of UTF-8
+void Til_Throughput(const char* const corpusName, const std::string& u8Str)
+{
+    std::string head{ __func__ };
+    head += " - ";
+    head += corpusName;
+    PrintHeader(head.c_str());
+
+    constexpr const int rounds{ 20 };
+    const double gigabytes{ static_cast<double>(u8Str.length()) * rounds / 1e9 };
+    std::wstring u16Str{};
+    std::string u8StrOut{};
+    std::unique_ptr<wchar_t[]> u16Buffer{ std::make_unique<wchar_t[]>(u8Str.length()) };
+    double durMB2WC{};
+    double durU8U16{};
+    double durU16U8{};
+    HRESULT hRes{};
+
+    for (int i{}; i < rounds; ++i)
+    {
+        GetDuration();
+        MultiByteToWideChar(65001, 0, u8Str.data(), static_cast<int>(u8Str.length()), u16Buffer.get(), static_cast<int>(u8Str.length()));
+        durMB2WC += GetDuration();
+
+        GetDuration();
+        hRes = til::u8u16(u8Str, u16Str);
+        durU8U16 += GetDuration();
+
+        GetDuration();
+        hRes = til::u16u8(u16Str, u8StrOut);
+        durU16U8 += GetDuration();
+    }
+
+    std::cout << " HRESULT " << hRes << " round trip " << (u8StrOut == u8Str ? "ok" : "FAILED") << std::endl;
+    std::cout << " MultiByteToWideChar " << gigabytes / durMB2WC << " GB/s" << std::endl;
+    std::cout << " til::u8u16          " << gigabytes / durU8U16 << " GB/s" << std::endl;
+    std::cout << " til::u16u8          " << gigabytes / durU16U8 << " GB/s" << std::endl;
+}
+
+// returns the content of the file repeated until the string is at least 100 MB long
+std::string RepeatFile(const std::string& fileName)
+{
+    std::ostringstream buf{};
+    buf << std::ifstream{ fileName }.rdbuf();
+    const std::string content{ buf.str() };
+    std::string u8Str{};
+    u8Str.reserve(100000000u + content.length());
+    while (!content.empty() && u8Str.length() < 100000000u)
+    {
+        u8Str += content;
+    }
+    return u8Str;
+}
+
 int main()
 {
     // UTF-16 string length
@@ -519,6 +579,19 @@ int main()
     CompNaturalLang_Chunks("ru.txt");
     CompNaturalLang_Chunks("zh.txt");
 
+    std::cout << "\n\n### til::u8u16 and til::u16u8 ###" << std::endl;
+
+    Til_Throughput("ASCII (en.txt)", RepeatFile("en.txt"));
+    Til_Throughput("mixed CJK (zh.txt)", RepeatFile("zh.txt"));
+
+    // GRINNING FACE (4 bytes in UTF-8, surrogate pair in UTF-16) followed by a space
+    std::string emoji{};
+    for (size_t i{}; i < 20000000u; ++i)
+    {
+        emoji += "\xF0\x9F\x98\x80 ";
+    }
+    Til_Throughput("emoji", emoji);
+
     FreeLibrary(ntdll);
     return 0;
 }
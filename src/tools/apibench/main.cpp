@@ -0,0 +1,94 @@
+// Copyright (c) Microsoft Corporation.
+// Licensed under the MIT license.
+
+#include <windows.h>
+#include <wil/result.h>
+
+#include <cstdio>
+#include <cwchar>
+
+// This application measures how many console API messages per second the
+// attached console server can service. Every call below is a full round trip
+// through the driver (read, dispatch and complete), so the numbers are a
+// direct measure of the per-message overhead in the server's IO loop.
+//
+// Usage: apibench.exe [iterations]
+
+static double s_TicksToMicroseconds(const LONGLONG ticks, const LONGLONG frequency) noexcept
+{
+    return static_cast<double>(ticks) * 1000000.0 / static_cast<double>(frequency);
+}
+
+template<typename T>
+static void s_Measure(const wchar_t* const name, const DWORD iterations, const LONGLONG frequency, T&& call)
+{
+    LARGE_INTEGER start;
+    LARGE_INTEGER end;
+
+    // Warm up, so that the first few calls don't skew the results.
+    for (DWORD i = 0; i < 100; ++i)
+    {
+        call();
+    }
+
+    QueryPerformanceCounter(&start);
+    for (DWORD i = 0; i < iterations; ++i)
+    {
+        call();
+    }
+    QueryPerformanceCounter(&end);
+
+    const auto elapsed = s_TicksToMicroseconds(end.QuadPart - start.QuadPart, frequency);
+    wprintf(L"%-32s %10.0f msgs/s %8.2f us/msg\n",
+            name,
+            iterations * 1000000.0 / elapsed,
+            elapsed / iterations);
+}
+
+int __cdecl wmain(int argc, WCHAR* argv[])
+{
+    DWORD iterations = 100000;
+    if (argc > 1)
+    {
+        iterations = wcstoul(argv[1], nullptr, 10);
+        if (iterations == 0)
+        {
+            wprintf(L"Usage: %s [iterations]\n", argv[0]);
+            return 1;
+        }
+    }
+
+    const auto hOut = GetStdHandle(STD_OUTPUT_HANDLE);
+    const auto hIn = GetStdHandle(STD_INPUT_HANDLE);
+
+    DWORD mode = 0;
+    THROW_LAST_ERROR_IF(!GetConsoleMode(hOut, &mode));
+
+    LARGE_INTEGER frequency;
+    QueryPerformanceFrequency(&frequency);
+
+    wprintf(L"%lu iterations per API\n", iterations);
+
+    s_Measure(L"GetConsoleScreenBufferInfo", iterations, frequency.QuadPart, [&]() {
+        CONSOLE_SCREEN_BUFFER_INFO csbi;
+        GetConsoleScreenBufferInfo(hOut, &csbi);
+    });
+
+    s_Measure(L"GetConsoleScreenBufferInfoEx", iterations, frequency.QuadPart, [&]() {
+        CONSOLE_SCREEN_BUFFER_INFOEX csbiex{};
+        csbiex.cbSize = sizeof(csbiex);
+        GetConsoleScreenBufferInfoEx(hOut, &csbiex);
+    });
+
+    s_Measure(L"GetConsoleMode", iterations, frequency.QuadPart, [&]() {
+        DWORD m;
+        GetConsoleMode(hOut, &m);
+    });
+
+    s_Measure(L"GetNumberOfConsoleInputEvents", iterations, frequency.QuadPart, [&]() {
+        DWORD count;
+        GetNumberOfConsoleInputEvents(hIn, &count);
+    });
+
+    return 0;
+}
@@ -0,0 +1,167 @@
+// Copyright (c) Microsoft Corporation.
+// Licensed under the MIT license.
+
+#include <windows.h>
+#include <wil/resource.h>
+#include <wil/result.h>
+
+#include <cstdio>
+#include <cwchar>
+#include <string>
+#include <vector>
+
+// This application measures how many clients per second the attached console
+// server can connect and disconnect. That's what parallel builds do all day:
+// every compiler and linker they spawn connects to the console (allocating a
+// process record and an input and an output handle) and disconnects again.
+//
+// It measures two things:
+// - spawning short-lived child processes that attach to our console, with up
+//   to [parallel] of them alive at the same time,
+// - detaching from and reattaching to the console with FreeConsole and
+//   AttachConsole, which is the bare connect/disconnect without process creation.
+//
+// Usage: attachbench.exe [clients] [parallel]
+
+static constexpr auto ClientArgument = L"--client";
+static constexpr auto IdleArgument = L"--idle";
+
+static double s_TicksToMicroseconds(const LONGLONG ticks, const LONGLONG frequency) noexcept
+{
+    return static_cast<double>(ticks) * 1000000.0 / static_cast<double>(frequency);
+}
+
+static LONGLONG s_Now() noexcept
+{
+    LARGE_INTEGER now;
+    QueryPerformanceCounter(&now);
+    return now.QuadPart;
+}
+
+static wil::unique_process_information s_Spawn(const std::wstring& commandline)
+{
+    // CreateProcessW may write into the commandline.
+    auto mutableCommandline = commandline;
+    STARTUPINFOW si{};
+    si.cb = sizeof(si);
+    wil::unique_process_information pi;
+    THROW_IF_WIN32_BOOL_FALSE(CreateProcessW(nullptr, mutableCommandline.data(), nullptr, nullptr, FALSE, 0, nullptr, nullptr, &si, &pi));
+    return pi;
+}
+
+static void s_MeasureSpawn(const std::wstring& self, const DWORD clients, const DWORD parallel, const LONGLONG frequency)
+{
+    const auto commandline = L'"' + self + L"\" " + ClientArgument;
+    std::vector<wil::unique_process_information> alive;
+    std::vector<HANDLE> handles;
+    alive.reserve(parallel);
+    handles.reserve(parallel);
+
+    const auto start = s_Now();
+    DWORD spawned = 0;
+    while (spawned < clients || !alive.empty())
+    {
+        while (spawned < clients && alive.size() < parallel)
+        {
+            alive.emplace_back(s_Spawn(commandline));
+            ++spawned;
+        }
+
+        handles.clear();
+        for (const auto& pi : alive)
+        {
+            handles.emplace_back(pi.hProcess);
+        }
+        const auto result = WaitForMultipleObjects(static_cast<DWORD>(handles.size()), handles.data(), FALSE, INFINITE);
+        THROW_LAST_ERROR_IF(result >= WAIT_OBJECT_0 + handles.size());
+        alive.erase(alive.begin() + (result - WAIT_OBJECT_0));
+    }
+    const auto elapsed = s_TicksToMicroseconds(s_Now() - start, frequency);
+
+    wprintf(L"%-32s %10.0f clients/s %8.2f us/client\n",
+            L"CreateProcess (x parallel)",
+            clients * 1000000.0 / elapsed,
+            elapsed / clients);
+}
+
+static void s_MeasureAttach(const std::wstring& self, const DWORD clients, const LONGLONG frequency)
+{
+    // FreeConsole leaves us without a console, so we need another process,
+    // which stays attached, to reattach to. We also can't write to the console
+    // until we're done, because the CRT's handles die with the first FreeConsole.
+    const auto idle = s_Spawn(L'"' + self + L"\" " + IdleArgument);
+    auto terminateIdle = wil::scope_exit([&]() noexcept {
+        TerminateProcess(idle.hProcess, 0);
+    });
+
+    const auto start = s_Now();
+    DWORD attached = 0;
+    for (; attached < clients; ++attached)
+    {
+        if (!FreeConsole() || !AttachConsole(idle.dwProcessId))
+        {
+            break;
+        }
+    }
+    const auto elapsed = s_TicksToMicroseconds(s_Now() - start, frequency);
+    const auto error = attached == clients ? ERROR_SUCCESS : GetLastError();
+
+    // Make sure we've got a console to report back to, even if we failed halfway.
+    AttachConsole(idle.dwProcessId);
+    wil::unique_hfile out{ CreateFileW(L"CONOUT$", GENERIC_READ | GENERIC_WRITE, FILE_SHARE_READ | FILE_SHARE_WRITE, nullptr, OPEN_EXISTING, 0, nullptr) };
+    THROW_LAST_ERROR_IF(!out);
+
+    wchar_t buffer[128];
+    const auto length = error == ERROR_SUCCESS ?
+                            swprintf_s(buffer, L"%-32s %10.0f clients/s %8.2f us/client\r\n", L"FreeConsole + AttachConsole", clients * 1000000.0 / elapsed, elapsed / clients) :
+                            swprintf_s(buffer, L"%-32s failed after %lu clients: %lu\r\n", L"FreeConsole + AttachConsole", attached, error);
+    DWORD written;
+    WriteConsoleW(out.get(), buffer, static_cast<DWORD>(length > 0 ? length : 0), &written, nullptr);
+}
+
+int __cdecl wmain(int argc, WCHAR* argv[])
+{
+    if (argc > 1 && wcscmp(argv[1], ClientArgument) == 0)
+    {
+        // Make sure we actually talk to the console once, like any real tool would.
+        DWORD mode;
+        GetConsoleMode(GetStdHandle(STD_OUTPUT_HANDLE), &mode);
+        return 0;
+    }
+    if (argc > 1 && wcscmp(argv[1], IdleArgument) == 0)
+    {
+        Sleep(INFINITE);
+        return 0;
+    }
+
+    DWORD clients = 1000;
+    DWORD parallel = 8;
+    if (argc > 1)
+    {
+        clients = wcstoul(argv[1], nullptr, 10);
+    }
+    if (argc > 2)
+    {
+        parallel = wcstoul(argv[2], nullptr, 10);
+    }
+    if (clients == 0 || parallel == 0 || parallel > MAXIMUM_WAIT_OBJECTS)
+    {
+        wprintf(L"Usage: %s [clients] [parallel (1-%d)]\n", argv[0], MAXIMUM_WAIT_OBJECTS);
+        return 1;
+    }
+
+    std::wstring self(MAX_PATH, L'\0');
+    self.resize(GetModuleFileNameW(nullptr, self.data(), static_cast<DWORD>(self.size())));
+    THROW_LAST_ERROR_IF(self.empty());
+
+    LARGE_INTEGER frequency;
+    QueryPerformanceFrequency(&frequency);
+
+    wprintf(L"%lu clients, %lu in parallel\n", clients, parallel);
+
+    s_MeasureSpawn(self, clients, parallel, frequency.QuadPart);
+    fflush(stdout);
+    s_MeasureAttach(self, clients, frequency.QuadPart);
+
+    return 0;
+}
@@ -0,0 +1,192 @@
+// Copyright (c) Microsoft Corporation.
+// Licensed under the MIT license.
+
+#include "pch.h"
+#include "BenchEngine.hpp"
+
+using namespace Microsoft::Console::Render;
+
+[[nodiscard]] HRESULT BenchEngine::StartPaint() noexcept
+{
+    if (_invalidMap.none())
+    {
+        return S_FALSE;
+    }
+
+    _paintStart = std::chrono::steady_clock::now();
+    frames++;
+    return S_OK;
+}
+
+[[nodiscard]] HRESULT BenchEngine::EndPaint() noexcept
+{
+    _invalidMap.reset_all();
+    paints.Add(std::chrono::steady_clock::now() - _paintStart);
+    return S_OK;
+}
+
+[[nodiscard]] HRESULT BenchEngine::Present() noexcept
+{
+    return S_OK;
+}
+
+[[nodiscard]] HRESULT BenchEngine::PrepareForTeardown(_Out_ bool* const pForcePaint) noexcept
+{
+    *pForcePaint = false;
+    return S_OK;
+}
+
+[[nodiscard]] HRESULT BenchEngine::ScrollFrame() noexcept
+{
+    return S_OK;
+}
+
+[[nodiscard]] HRESULT BenchEngine::Invalidate(const SMALL_RECT* const psrRegion) noexcept
+try
+{
+    _invalidMap.set(Microsoft::Console::Types::Viewport::FromExclusive(*psrRegion).ToInclusive());
+    return S_OK;
+}
+CATCH_RETURN();
+
+[[nodiscard]] HRESULT BenchEngine::InvalidateCursor(const SMALL_RECT* const psrRegion) noexcept
+{
+    return Invalidate(psrRegion);
+}
+
+[[nodiscard]] HRESULT BenchEngine::InvalidateSystem(const RECT* const /*prcDirtyClient*/) noexcept
+{
+    return InvalidateAll();
+}
+
+[[nodiscard]] HRESULT BenchEngine::InvalidateSelection(const std::vector<SMALL_RECT>& rectangles) noexcept
+{
+    for (const auto& rect : rectangles)
+    {
+        RETURN_IF_FAILED(Invalidate(&rect));
+    }
+    return S_OK;
+}
+
+[[nodiscard]] HRESULT BenchEngine::InvalidateScroll(const COORD* const pcoordDelta) noexcept
+try
+{
+    _invalidMap.translate(til::point{ *pcoordDelta }, true);
+    return S_OK;
+}
+CATCH_RETURN();
+
+[[nodiscard]] HRESULT BenchEngine::InvalidateAll() noexcept
+{
+    _invalidMap.set_all();
+    return S_OK;
+}
+
+[[nodiscard]] HRESULT BenchEngine::InvalidateCircling(_Out_ bool* const pForcePaint) noexcept
+{
+    *pForcePaint = false;
+    return S_OK;
+}
+
+[[nodiscard]] HRESULT BenchEngine::PaintBackground() noexcept
+{
+    return S_OK;
+}
+
+[[nodiscard]] HRESULT BenchEngine::PaintBufferLine(gsl::span<const Cluster> const clusters,
+                                                   const COORD /*coord*/,
+                                                   const bool /*fTrimLeft*/,
+                                                   const bool /*lineWrapped*/) noexcept
+{
+    lines++;
+    for (const auto& cluster : clusters)
+    {
+        cells += cluster.GetColumns();
+    }
+    return S_OK;
+}
+
+[[nodiscard]] HRESULT BenchEngine::PaintBufferGridLines(const GridLines /*lines*/,
+                                                        const COLORREF /*color*/,
+                                                        const size_t /*cchLine*/,
+                                                        const COORD /*coordTarget*/) noexcept
+{
+    return S_OK;
+}
+
+[[nodiscard]] HRESULT BenchEngine::PaintSelection(const SMALL_RECT /*rect*/) noexcept
+{
+    return S_OK;
+}
+
+[[nodiscard]] HRESULT BenchEngine::PaintCursor(const CursorOptions& /*options*/) noexcept
+{
+    return S_OK;
+}
+
+[[nodiscard]] HRESULT BenchEngine::UpdateDrawingBrushes(const TextAttribute& /*textAttributes*/,
+                                                        const gsl::not_null<IRenderData*> /*pData*/,
+                                                        const bool /*usingSoftFont*/,
+                                                        const bool /*isSettingDefaultBrushes*/) noexcept
+{
+    brushChanges++;
+    return S_OK;
+}
+
+[[nodiscard]] HRESULT BenchEngine::UpdateFont(const FontInfoDesired& /*FontInfoDesired*/,
+                                              _Out_ FontInfo& /*FontInfo*/) noexcept
+{
+    return S_OK;
+}
+
+[[nodiscard]] HRESULT BenchEngine::UpdateDpi(const int /*iDpi*/) noexcept
+{
+    return S_OK;
+}
+
+// Routine Description:
+// - Resizes the invalid map to the new viewport. The Renderer doesn't invalidate
+//   anything when the viewport changes size, so everything gets repainted.
+[[nodiscard]] HRESULT BenchEngine::UpdateViewport(const SMALL_RECT srNewViewport) noexcept
+try
+{
+    const auto newSize = til::size{ Microsoft::Console::Types::Viewport::FromInclusive(srNewViewport).Dimensions() };
+    if (newSize != _invalidMap.size())
+    {
+        _invalidMap.resize(newSize, true);
+    }
+    return S_OK;
+}
+CATCH_RETURN();
+
+[[nodiscard]] HRESULT BenchEngine::GetProposedFont(const FontInfoDesired& /*FontInfoDesired*/,
+                                                   _Out_ FontInfo& /*FontInfo*/,
+                                                   const int /*iDpi*/) noexcept
+{
+    return S_FALSE;
+}
+
+[[nodiscard]] HRESULT BenchEngine::GetDirtyArea(gsl::span<const til::rectangle>& area) noexcept
+try
+{
+    area = _invalidMap.runs();
+    return S_OK;
+}
+CATCH_RETURN();
+
+[[nodiscard]] HRESULT BenchEngine::GetFontSize(_Out_ COORD* const pFontSize) noexcept
+{
+    *pFontSize = { 1, 1 };
+    return S_OK;
+}
+
+[[nodiscard]] HRESULT BenchEngine::IsGlyphWideByFont(const std::wstring_view /*glyph*/, _Out_ bool* const pResult) noexcept
+{
+    *pResult = false;
+    return S_OK;
+}
+
+[[nodiscard]] HRESULT BenchEngine::_DoUpdateTitle(const std::wstring_view /*newTitle*/) noexcept
+{
+    return S_OK;
+}
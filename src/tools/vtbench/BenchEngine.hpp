@@ -0,0 +1,110 @@
+/*++
+Copyright (c) Microsoft Corporation
+Licensed under the MIT license.
+
+Module Name:
+- BenchEngine.hpp
+
+Abstract:
+- A render engine that doesn't draw anything. It keeps track of what's invalid
+  the same way the real engines do, so that the Renderer walks the same code
+  paths, and records how many frames, lines and cells it was asked to paint
+  and how long every frame took.
+--*/
+
+#pragma once
+
+#include "../../renderer/inc/RenderEngineBase.hpp"
+
+// Collects the count, sum and maximum of a series of durations.
+struct DurationStats
+{
+    using duration = std::chrono::steady_clock::duration;
+
+    void Add(const duration value) noexcept
+    {
+        count++;
+        total += value;
+        max = std::max(max, value);
+    }
+
+    double AverageMicroseconds() const noexcept
+    {
+        return count ? std::chrono::duration<double, std::micro>(total).count() / count : 0.0;
+    }
+
+    double MaxMicroseconds() const noexcept
+    {
+        return std::chrono::duration<double, std::micro>(max).count();
+    }
+
+    uint64_t count{ 0 };
+    duration total{};
+    duration max{};
+};
+
+class BenchEngine final : public Microsoft::Console::Render::RenderEngineBase
+{
+public:
+    BenchEngine() = default;
+
+    [[nodiscard]] HRESULT StartPaint() noexcept override;
+    [[nodiscard]] HRESULT EndPaint() noexcept override;
+    [[nodiscard]] HRESULT Present() noexcept override;
+
+    [[nodiscard]] HRESULT PrepareForTeardown(_Out_ bool* const pForcePaint) noexcept override;
+
+    [[nodiscard]] HRESULT ScrollFrame() noexcept override;
+
+    [[nodiscard]] HRESULT Invalidate(const SMALL_RECT* const psrRegion) noexcept override;
+    [[nodiscard]] HRESULT InvalidateCursor(const SMALL_RECT* const psrRegion) noexcept override;
+    [[nodiscard]] HRESULT InvalidateSystem(const RECT* const prcDirtyClient) noexcept override;
+    [[nodiscard]] HRESULT InvalidateSelection(const std::vector<SMALL_RECT>& rectangles) noexcept override;
+    [[nodiscard]] HRESULT InvalidateScroll(const COORD* const pcoordDelta) noexcept override;
+    [[nodiscard]] HRESULT InvalidateAll() noexcept override;
+    [[nodiscard]] HRESULT InvalidateCircling(_Out_ bool* const pForcePaint) noexcept override;
+
+    [[nodiscard]] HRESULT PaintBackground() noexcept override;
+    [[nodiscard]] HRESULT PaintBufferLine(gsl::span<const Microsoft::Console::Render::Cluster> const clusters,
+                                          const COORD coord,
+                                          const bool fTrimLeft,
+                                          const bool lineWrapped) noexcept override;
+    [[nodiscard]] HRESULT PaintBufferGridLines(const GridLines lines,
+                                               const COLORREF color,
+                                               const size_t cchLine,
+                                               const COORD coordTarget) noexcept override;
+    [[nodiscard]] HRESULT PaintSelection(const SMALL_RECT rect) noexcept override;
+
+    [[nodiscard]] HRESULT PaintCursor(const Microsoft::Console::Render::CursorOptions& options) noexcept override;
+
+    [[nodiscard]] HRESULT UpdateDrawingBrushes(const TextAttribute& textAttributes,
+                                               const gsl::not_null<Microsoft::Console::Render::IRenderData*> pData,
+                                               const bool usingSoftFont,
+                                               const bool isSettingDefaultBrushes) noexcept override;
+    [[nodiscard]] HRESULT UpdateFont(const FontInfoDesired& FontInfoDesired,
+                                     _Out_ FontInfo& FontInfo) noexcept override;
+    [[nodiscard]] HRESULT UpdateDpi(const int iDpi) noexcept override;
+    [[nodiscard]] HRESULT UpdateViewport(const SMALL_RECT srNewViewport) noexcept override;
+
+    [[nodiscard]] HRESULT GetProposedFont(const FontInfoDesired& FontInfoDesired,
+                                          _Out_ FontInfo& FontInfo,
+                                          const int iDpi) noexcept override;
+
+    [[nodiscard]] HRESULT GetDirtyArea(gsl::span<const til::rectangle>& area) noexcept override;
+    [[nodiscard]] HRESULT GetFontSize(_Out_ COORD* const pFontSize) noexcept override;
+    [[nodiscard]] HRESULT IsGlyphWideByFont(const std::wstring_view glyph, _Out_ bool* const pResult) noexcept override;
+
+    // The statistics are only read once the render thread is done.
+    uint64_t frames{ 0 };
+    uint64_t lines{ 0 };
+    uint64_t cells{ 0 };
+    uint64_t brushChanges{ 0 };
+    DurationStats paints;
+
+protected:
+    [[nodiscard]] HRESULT _DoUpdateTitle(const std::wstring_view newTitle) noexcept override;
+
+private:
+    til::bitmap _invalidMap;
+    std::chrono::steady_clock::time_point _paintStart;
+};
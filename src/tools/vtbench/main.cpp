@@ -0,0 +1,234 @@
+// Copyright (c) Microsoft Corporation.
+// Licensed under the MIT license.
+
+#include "pch.h"
+
+#include "BenchEngine.hpp"
+#include "../../cascadia/TerminalCore/Terminal.hpp"
+#include "../../renderer/base/renderer.hpp"
+#include "../../renderer/base/thread.hpp"
+#include "../../types/inc/AllocationAccounting.hpp"
+
+#include <fstream>
+
+// This application replays VT captures through the whole Terminal pipeline:
+// the state machine, the TerminalDispatch, the text buffer and the Renderer,
+// painting into a BenchEngine instead of a real one. The captures are read
+// up front and handed to Terminal::Write in chunks, converted from UTF-8 the
+// same way the connections do, so that only the pipeline itself is measured.
+//
+// For every run it reports the throughput, the number of frames the Renderer
+// painted, the number of allocations and how long the terminal lock was held,
+// both by the writes and by the render thread. The allocations are also
+// broken down by the subsystems that take part in allocation accounting.
+//
+// Usage: vtbench.exe [--size CxR] [--chunk bytes] [--repeat n] [--no-render] capture...
+
+using namespace Microsoft::Console::Render;
+using namespace Microsoft::Terminal::Core;
+using namespace Microsoft::Console::Types;
+
+using Subsystem = AllocationAccounting::Subsystem;
+static constexpr auto s_subsystemCount = static_cast<size_t>(Subsystem::Count);
+
+static std::atomic<uint64_t> s_allocations{ 0 };
+static std::atomic<uint64_t> s_allocatedBytes{ 0 };
+
+void* __cdecl operator new(size_t size)
+{
+    s_allocations.fetch_add(1, std::memory_order_relaxed);
+    s_allocatedBytes.fetch_add(size, std::memory_order_relaxed);
+    if (const auto p = malloc(size ? size : 1))
+    {
+        return p;
+    }
+    throw std::bad_alloc{};
+}
+
+void __cdecl operator delete(void* p) noexcept
+{
+    free(p);
+}
+
+void __cdecl operator delete(void* p, size_t) noexcept
+{
+    free(p);
+}
+
+struct Options
+{
+    COORD size{ 120, 30 };
+    size_t chunkSize = 4096;
+    int repeat = 1;
+    bool render = true;
+    std::vector<std::wstring> captures;
+};
+
+static bool s_ParseOptions(const int argc, const wchar_t* const argv[], Options& options)
+{
+    for (int i = 1; i < argc; ++i)
+    {
+        const std::wstring_view arg{ argv[i] };
+        const auto hasValue = i + 1 < argc;
+
+        if (arg == L"--size" && hasValue)
+        {
+            unsigned int columns = 0;
+            unsigned int rows = 0;
+            if (swscanf_s(argv[++i], L"%ux%u", &columns, &rows) != 2 || !columns || !rows || columns > SHRT_MAX || rows > SHRT_MAX)
+            {
+                return false;
+            }
+            options.size = { gsl::narrow_cast<SHORT>(columns), gsl::narrow_cast<SHORT>(rows) };
+        }
+        else if (arg == L"--chunk" && hasValue)
+        {
+            options.chunkSize = wcstoul(argv[++i], nullptr, 10);
+            if (!options.chunkSize)
+            {
+                return false;
+            }
+        }
+        else if (arg == L"--repeat" && hasValue)
+        {
+            options.repeat = _wtoi(argv[++i]);
+            if (options.repeat <= 0)
+            {
+                return false;
+            }
+        }
+        else if (arg == L"--no-render")
+        {
+            options.render = false;
+        }
+        else if (til::starts_with(arg, L"--"))
+        {
+            return false;
+        }
+        else
+        {
+            options.captures.emplace_back(arg);
+        }
+    }
+    return !options.captures.empty();
+}
+
+static std::string s_ReadCapture(const std::wstring& path)
+{
+    std::ifstream file{ path, std::ios::binary };
+    THROW_HR_IF_MSG(E_INVALIDARG, !file, "failed to open %ls", path.c_str());
+    return { std::istreambuf_iterator<char>{ file }, std::istreambuf_iterator<char>{} };
+}
+
+// Splits the capture into chunks of the given size and converts each of them
+// to UTF-16 on its own. Chunks may end in the middle of a character, just
+// like the reads from a pipe do, which the u8state takes care of.
+static std::vector<std::wstring> s_SplitCapture(const std::string_view capture, const size_t chunkSize)
+{
+    std::vector<std::wstring> chunks;
+    til::u8state state;
+    for (size_t offset = 0; offset < capture.size(); offset += chunkSize)
+    {
+        std::wstring chunk;
+        THROW_IF_FAILED(til::u8u16(capture.substr(offset, chunkSize), chunk, state));
+        if (!chunk.empty())
+        {
+            chunks.emplace_back(std::move(chunk));
+        }
+    }
+    return chunks;
+}
+
+static void s_Run(const Options& options, const std::wstring& name, const std::vector<std::wstring>& chunks, const size_t bytes)
+{
+    BenchEngine engine;
+    Terminal terminal;
+
+    auto renderThread = std::make_unique<RenderThread>();
+    auto* const localPointerToThread = renderThread.get();
+    Renderer renderer{ &terminal, nullptr, 0, std::move(renderThread) };
+    renderer.AddRenderEngine(&engine);
+    THROW_IF_FAILED(localPointerToThread->Initialize(&renderer));
+
+    terminal.Create(options.size, 9001, renderer);
+    terminal.SetWriteInputCallback([](std::wstring&) {});
+
+    if (options.render)
+    {
+        renderer.EnablePainting();
+    }
+
+    DurationStats writes;
+    const auto allocationsBefore = s_allocations.load(std::memory_order_relaxed);
+    const auto bytesBefore = s_allocatedBytes.load(std::memory_order_relaxed);
+    std::array<size_t, s_subsystemCount> subsystemAllocationsBefore{};
+    for (size_t i = 0; i < s_subsystemCount; ++i)
+    {
+        subsystemAllocationsBefore[i] = AllocationAccounting::GetCounters(static_cast<Subsystem>(i)).allocations();
+    }
+    const auto start = std::chrono::steady_clock::now();
+
+    for (int i = 0; i < options.repeat; ++i)
+    {
+        for (const auto& chunk : chunks)
+        {
+            auto lock = terminal.LockForWriting();
+            const auto writeStart = std::chrono::steady_clock::now();
+            terminal.Write(chunk);
+            writes.Add(std::chrono::steady_clock::now() - writeStart);
+        }
+    }
+
+    // Wait for the frame that's in flight, then paint whatever is still
+    // pending, so that every run ends up with the same final frame.
+    renderer.WaitForPaintCompletionAndDisable(INFINITE);
+    LOG_IF_FAILED(renderer.PaintFrame());
+
+    const auto elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    const auto allocations = s_allocations.load(std::memory_order_relaxed) - allocationsBefore;
+    const auto allocatedBytes = s_allocatedBytes.load(std::memory_order_relaxed) - bytesBefore;
+    const auto megabytes = static_cast<double>(bytes) * options.repeat / (1024.0 * 1024.0);
+
+    wprintf(L"%s\n", name.c_str());
+    wprintf(L"  throughput   %10.2f MB/s (%.2f MB in %.3f s)\n", megabytes / elapsed, megabytes, elapsed);
+    wprintf(L"  frames       %10llu (%llu lines, %llu cells, %llu brush changes)\n", engine.frames, engine.lines, engine.cells, engine.brushChanges);
+    wprintf(L"  write lock   %10.2f us avg %10.2f us max (%llu writes)\n", writes.AverageMicroseconds(), writes.MaxMicroseconds(), writes.count);
+    wprintf(L"  paint lock   %10.2f us avg %10.2f us max\n", engine.paints.AverageMicroseconds(), engine.paints.MaxMicroseconds());
+    wprintf(L"  allocations  %10llu (%.0f per MB, %llu bytes)\n", allocations, allocations / megabytes, allocatedBytes);
+    for (size_t i = 0; i < s_subsystemCount; ++i)
+    {
+        const auto subsystem = static_cast<Subsystem>(i);
+        const auto subsystemAllocations = AllocationAccounting::GetCounters(subsystem).allocations() - subsystemAllocationsBefore[i];
+        const auto name = AllocationAccounting::GetName(subsystem);
+        wprintf(L"    %-10.*s %10zu (%.0f per MB)\n", gsl::narrow_cast<int>(name.size()), name.data(), subsystemAllocations, subsystemAllocations / megabytes);
+    }
+
+    renderer.TriggerTeardown();
+}
+
+int __cdecl wmain(int argc, const wchar_t* argv[])
+try
+{
+    // This has to happen before any of the subsystems allocate anything.
+    AllocationAccounting::Enable();
+
+    Options options;
+    if (!s_ParseOptions(argc, argv, options))
+    {
+        wprintf(L"Usage: %s [--size CxR] [--chunk bytes] [--repeat n] [--no-render] capture...\n", argv[0]);
+        return 1;
+    }
+
+    for (const auto& path : options.captures)
+    {
+        const auto capture = s_ReadCapture(path);
+        const auto chunks = s_SplitCapture(capture, options.chunkSize);
+        s_Run(options, path, chunks, capture.size());
+    }
+    return 0;
+}
+catch (...)
+{
+    LOG_CAUGHT_EXCEPTION();
+    return 1;
+}
@@ -0,0 +1,501 @@
+// Copyright (c) Microsoft Corporation.
+// Licensed under the MIT license.
+
+#define NOMINMAX
+#include "Benchmark.hpp"
+#include "VtConsole.hpp"
+
+#include <algorithm>
+#include <memory>
+#include <mutex>
+#include <sstream>
+#include <thread>
+#include <vector>
+
+// The writers report their progress by setting the title to
+// "vtpt-<kind>:<performance counter>", which the conpty emits as "\x1b]0;<title>\x7".
+static constexpr std::string_view s_titlePrefix{ "\x1b]0;vtpt-" };
+static constexpr wchar_t s_startStamp[] = L"start";
+static constexpr wchar_t s_markStamp[] = L"mark";
+static constexpr wchar_t s_doneStamp[] = L"done";
+
+// The writers stamp the title after this many bytes of plain output.
+static constexpr unsigned long long s_markInterval = 64 * 1024;
+
+static LONGLONG s_Now() noexcept
+{
+    LARGE_INTEGER now;
+    QueryPerformanceCounter(&now);
+    return now.QuadPart;
+}
+
+static double s_TicksToMicroseconds(const LONGLONG ticks) noexcept
+{
+    static const auto frequency = [] {
+        LARGE_INTEGER f;
+        QueryPerformanceFrequency(&f);
+        return static_cast<double>(f.QuadPart);
+    }();
+    return static_cast<double>(ticks) * 1000000.0 / frequency;
+}
+
+// Cycles through the printable ASCII characters.
+template<typename T>
+static T s_NextPrintable(const T ch) noexcept
+{
+    return ch == T{ '~' } ? T{ '!' } : static_cast<T>(ch + 1);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// Writer side, running inside the conpty.
+
+static void s_Stamp(const wchar_t* const kind)
+{
+    std::wstringstream ss;
+    ss << L"vtpt-" << kind << L":" << s_Now();
+    SetConsoleTitleW(ss.str().c_str());
+}
+
+static void s_Write(const HANDLE out, const std::wstring& text)
+{
+    THROW_IF_WIN32_BOOL_FALSE(WriteConsoleW(out, text.data(), static_cast<DWORD>(text.size()), nullptr, nullptr));
+}
+
+// Plain lines of text, written in blocks the size of a typical pipe read.
+static void s_WriteLines(const HANDLE out, const unsigned long long bytes)
+{
+    std::wstring block;
+    for (wchar_t first = L'!'; block.size() < 4096; first = s_NextPrintable(first))
+    {
+        for (wchar_t ch = first; block.size() % 80 < 78; ch = s_NextPrintable(ch))
+        {
+            block.push_back(ch);
+        }
+        block += L"\r\n";
+    }
+
+    unsigned long long written = 0;
+    unsigned long long nextMark = s_markInterval;
+    while (written < bytes)
+    {
+        s_Write(out, block);
+        written += block.size();
+        if (written >= nextMark)
+        {
+            s_Stamp(s_markStamp);
+            nextMark += s_markInterval;
+        }
+    }
+}
+
+// Full screen redraws the way TUI applications do them: every row is
+// positioned, colored and cleared to its end, and every frame differs.
+static void s_WriteFrames(const HANDLE out, const unsigned long long bytes)
+{
+    CONSOLE_SCREEN_BUFFER_INFO csbi{};
+    THROW_IF_WIN32_BOOL_FALSE(GetConsoleScreenBufferInfo(out, &csbi));
+    const auto width = csbi.srWindow.Right - csbi.srWindow.Left + 1;
+    const auto height = csbi.srWindow.Bottom - csbi.srWindow.Top + 1;
+
+    unsigned long long written = 0;
+    for (unsigned int frame = 0; written < bytes; frame++)
+    {
+        std::wstringstream ss;
+        ss << L"\x1b[?25l";
+        for (int row = 0; row < height; row++)
+        {
+            const auto color = (frame + row) % 216 + 16;
+            ss << L"\x1b[" << row + 1 << L";1H\x1b[38;5;" << color << L";48;5;" << 231 - (color - 16) << L"m";
+            for (int col = 0; col < width / 2; col++)
+            {
+                ss << static_cast<wchar_t>(L'!' + (frame + row + col) % 94);
+            }
+            ss << L"\x1b[m\x1b[K";
+        }
+        ss << L"\x1b[" << height << L";1H\x1b[?25h";
+
+        const auto text = ss.str();
+        s_Write(out, text);
+        written += text.size();
+        s_Stamp(s_markStamp);
+    }
+}
+
+// Echoes everything the reader pastes into the input back to the output.
+static void s_EchoPaste(const HANDLE in, const HANDLE out, const unsigned long long bytes)
+{
+    THROW_IF_WIN32_BOOL_FALSE(SetConsoleMode(in, 0));
+
+    std::wstring buffer(4096, L'\0');
+    std::wstring echo;
+    unsigned long long read = 0;
+    unsigned long long nextMark = s_markInterval;
+    while (read < bytes)
+    {
+        DWORD count = 0;
+        THROW_IF_WIN32_BOOL_FALSE(ReadConsoleW(in, buffer.data(), static_cast<DWORD>(buffer.size()), &count, nullptr));
+
+        echo.clear();
+        for (DWORD i = 0; i < count; i++)
+        {
+            echo.push_back(buffer[i]);
+            if (buffer[i] == L'\r')
+            {
+                echo.push_back(L'\n');
+            }
+        }
+        s_Write(out, echo);
+
+        read += count;
+        if (read >= nextMark)
+        {
+            s_Stamp(s_markStamp);
+            nextMark += s_markInterval;
+        }
+    }
+}
+
+int RunBenchmarkWriter(const std::wstring& workload, const unsigned long long bytes)
+try
+{
+    const auto in = GetStdHandle(STD_INPUT_HANDLE);
+    const auto out = GetStdHandle(STD_OUTPUT_HANDLE);
+
+    DWORD mode = 0;
+    THROW_IF_WIN32_BOOL_FALSE(GetConsoleMode(out, &mode));
+    THROW_IF_WIN32_BOOL_FALSE(SetConsoleMode(out, mode | ENABLE_VIRTUAL_TERMINAL_PROCESSING | DISABLE_NEWLINE_AUTO_RETURN));
+
+    s_Stamp(s_startStamp);
+    if (workload == L"write")
+    {
+        s_WriteLines(out, bytes);
+    }
+    else if (workload == L"tui")
+    {
+        s_WriteFrames(out, bytes);
+    }
+    else if (workload == L"paste")
+    {
+        s_EchoPaste(in, out, bytes);
+    }
+    else
+    {
+        THROW_HR(E_INVALIDARG);
+    }
+    s_Stamp(s_doneStamp);
+
+    // Stay attached until the conpty goes away, so that it doesn't exit
+    // before the reader has received everything.
+    INPUT_RECORD record;
+    DWORD count;
+    while (ReadConsoleInputW(in, &record, 1, &count))
+    {
+    }
+    return 0;
+}
+catch (...)
+{
+    LOG_CAUGHT_EXCEPTION();
+    return 1;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// Reader side.
+
+namespace
+{
+    struct Instance
+    {
+        std::unique_ptr<VtConsole> console;
+        wil::unique_event started{ wil::EventOptions::ManualReset };
+        wil::unique_event done{ wil::EventOptions::ManualReset };
+
+        // Only touched by the output thread of the console until done is set.
+        unsigned long long outputBytes = 0;
+        LONGLONG start = 0;
+        LONGLONG end = 0;
+        std::vector<double> latencies;
+        std::string pending;
+
+        void OnOutput(const BYTE* const buffer, const DWORD read);
+
+    private:
+        void _OnStamp(const std::string_view title, const LONGLONG now);
+    };
+
+    struct Summary
+    {
+        double p50 = 0;
+        double p99 = 0;
+        double max = 0;
+    };
+}
+
+void Instance::OnOutput(const BYTE* const buffer, const DWORD read)
+{
+    const auto now = s_Now();
+    outputBytes += read;
+
+    // Titles may be split across reads, so the unfinished
+    // end of the last read is kept around in pending.
+    pending.append(reinterpret_cast<const char*>(buffer), read);
+
+    size_t keepFrom = pending.size() > s_titlePrefix.size() ? pending.size() - s_titlePrefix.size() : 0;
+    for (size_t pos = 0;;)
+    {
+        const auto begin = pending.find(s_titlePrefix, pos);
+        if (begin == std::string::npos)
+        {
+            break;
+        }
+
+        const auto terminator = pending.find('\x7', begin);
+        if (terminator == std::string::npos)
+        {
+            keepFrom = begin;
+            break;
+        }
+
+        _OnStamp(std::string_view{ pending }.substr(begin + s_titlePrefix.size(), terminator - begin - s_titlePrefix.size()), now);
+        pos = terminator + 1;
+        keepFrom = std::max(keepFrom, pos);
+    }
+    pending.erase(0, std::min(keepFrom, pending.size()));
+}
+
+void Instance::_OnStamp(const std::string_view title, const LONGLONG now)
+{
+    const auto colon = title.find(':');
+    if (colon == std::string_view::npos)
+    {
+        return;
+    }
+
+    const auto kind = title.substr(0, colon);
+    const auto stamp = _atoi64(std::string{ title.substr(colon + 1) }.c_str());
+    if (kind == "start")
+    {
+        start = stamp;
+        outputBytes = 0;
+        started.SetEvent();
+    }
+    else if (start)
+    {
+        latencies.push_back(s_TicksToMicroseconds(now - stamp));
+        if (kind == "done")
+        {
+            end = now;
+            done.SetEvent();
+        }
+    }
+}
+
+static Summary s_Summarize(std::vector<double> values)
+{
+    Summary summary;
+    if (!values.empty())
+    {
+        std::sort(values.begin(), values.end());
+        summary.p50 = values[values.size() / 2];
+        summary.p99 = values[std::min(values.size() - 1, values.size() * 99 / 100)];
+        summary.max = values.back();
+    }
+    return summary;
+}
+
+static void s_WriteSummary(std::ostream& os, const Summary& summary)
+{
+    os << "{\"p50\":" << summary.p50 << ",\"p99\":" << summary.p99 << ",\"max\":" << summary.max << "}";
+}
+
+static std::wstring s_GetWriterCommandline(const BenchmarkOptions& options)
+{
+    std::wstring path(MAX_PATH, L'\0');
+    for (;;)
+    {
+        const auto length = GetModuleFileNameW(nullptr, path.data(), static_cast<DWORD>(path.size()));
+        THROW_LAST_ERROR_IF(length == 0);
+        if (length < path.size())
+        {
+            path.resize(length);
+            break;
+        }
+        path.resize(path.size() * 2);
+    }
+
+    std::wstringstream ss;
+    ss << L"\"" << path << L"\" --bench-writer " << options.workload << L" " << options.bytes;
+    return ss.str();
+}
+
+// Pastes the input of the "paste" workload in chunks, like a terminal would.
+static void s_Paste(Instance& instance, const unsigned long long bytes)
+{
+    std::string chunk;
+    for (char first = '!'; chunk.size() < 4096; first = s_NextPrintable(first))
+    {
+        for (char ch = first; chunk.size() % 80 < 79; ch = s_NextPrintable(ch))
+        {
+            chunk.push_back(ch);
+        }
+        chunk.push_back('\r');
+    }
+
+    for (unsigned long long written = 0; written < bytes; written += chunk.size())
+    {
+        if (bytes - written < chunk.size())
+        {
+            chunk.resize(static_cast<size_t>(bytes - written));
+        }
+        instance.console->WriteInput(chunk);
+    }
+}
+
+int RunBenchmark(const BenchmarkOptions& options)
+try
+{
+    if (options.workload != L"write" && options.workload != L"tui" && options.workload != L"paste")
+    {
+        wprintf(L"Unknown workload \"%s\". Expected write, tui or paste.\n", options.workload.c_str());
+        return 1;
+    }
+
+    const auto commandline = s_GetWriterCommandline(options);
+
+    // Like the interactive consoles, the instances are never freed.
+    // Their output threads keep running until the process exits.
+    std::vector<Instance*> instances;
+    for (unsigned int i = 0; i < options.instances; i++)
+    {
+        auto instance = new Instance();
+        instance->console = std::make_unique<VtConsole>([instance](BYTE* buffer, DWORD dwRead) { instance->OnOutput(buffer, dwRead); },
+                                                        !options.useConpty,
+                                                        options.useConpty,
+                                                        options.size);
+        instance->console->activate();
+        instances.push_back(instance);
+    }
+
+    // Spawn all of them before any starts writing,
+    // so that they actually compete with each other.
+    for (const auto instance : instances)
+    {
+        instance->console->spawn(commandline);
+    }
+
+    std::vector<std::thread> pasters;
+    const auto deadline = GetTickCount64() + options.timeoutMs;
+    const auto remaining = [&]() {
+        const auto now = GetTickCount64();
+        return static_cast<DWORD>(now < deadline ? deadline - now : 0);
+    };
+
+    bool timedOut = false;
+    for (const auto instance : instances)
+    {
+        if (!instance->started.wait(remaining()))
+        {
+            timedOut = true;
+            break;
+        }
+        if (options.workload == L"paste")
+        {
+            pasters.emplace_back(s_Paste, std::ref(*instance), options.bytes);
+        }
+    }
+
+    for (const auto instance : instances)
+    {
+        if (timedOut || !instance->done.wait(remaining()))
+        {
+            timedOut = true;
+            break;
+        }
+    }
+
+    for (auto& paster : pasters)
+    {
+        // The pasters are done once the writers are, but if they timed
+        // out, they may be blocked on a full pipe forever.
+        if (timedOut)
+        {
+            paster.detach();
+        }
+        else
+        {
+            paster.join();
+        }
+    }
+
+    std::ostringstream json;
+    json << "{\"workload\":\"";
+    for (const auto ch : options.workload)
+    {
+        json << static_cast<char>(ch);
+    }
+    json << "\",\"conpty\":" << (options.useConpty ? "true" : "false")
+         << ",\"instances\":" << options.instances
+         << ",\"bytes\":" << options.bytes
+         << ",\"columns\":" << options.size.X
+         << ",\"rows\":" << options.size.Y
+         << ",\"timedOut\":" << (timedOut ? "true" : "false");
+
+    if (!timedOut)
+    {
+        LONGLONG first = instances.front()->start;
+        LONGLONG last = instances.front()->end;
+        unsigned long long outputBytes = 0;
+        std::vector<double> latencies;
+        for (const auto instance : instances)
+        {
+            first = std::min(first, instance->start);
+            last = std::max(last, instance->end);
+            outputBytes += instance->outputBytes;
+            latencies.insert(latencies.end(), instance->latencies.begin(), instance->latencies.end());
+        }
+
+        const auto elapsed = s_TicksToMicroseconds(last - first) / 1000000.0;
+        json << ",\"seconds\":" << elapsed
+             << ",\"bytesPerSecond\":" << options.bytes * options.instances / elapsed
+             << ",\"outputBytes\":" << outputBytes
+             << ",\"outputBytesPerSecond\":" << outputBytes / elapsed
+             << ",\"latencyUs\":";
+        s_WriteSummary(json, s_Summarize(std::move(latencies)));
+
+        json << ",\"perInstance\":[";
+        for (size_t i = 0; i < instances.size(); i++)
+        {
+            const auto& instance = *instances[i];
+            const auto seconds = s_TicksToMicroseconds(instance.end - instance.start) / 1000000.0;
+            json << (i ? "," : "")
+                 << "{\"seconds\":" << seconds
+                 << ",\"bytesPerSecond\":" << options.bytes / seconds
+                 << ",\"outputBytes\":" << instance.outputBytes
+                 << ",\"latencyUs\":";
+            s_WriteSummary(json, s_Summarize(instance.latencies));
+            json << "}";
+        }
+        json << "]";
+    }
+    json << "}\n";
+
+    const auto results = json.str();
+    if (options.resultsPath.empty())
+    {
+        fwrite(results.data(), 1, results.size(), stdout);
+        fflush(stdout);
+    }
+    else
+    {
+        wil::unique_hfile file{ CreateFileW(options.resultsPath.c_str(), GENERIC_WRITE, FILE_SHARE_READ, nullptr, CREATE_ALWAYS, FILE_ATTRIBUTE_NORMAL, nullptr) };
+        THROW_LAST_ERROR_IF(!file);
+        THROW_IF_WIN32_BOOL_FALSE(WriteFile(file.get(), results.data(), static_cast<DWORD>(results.size()), nullptr, nullptr));
+    }
+
+    return timedOut ? 1 : 0;
+}
+catch (...)
+{
+    LOG_CAUGHT_EXCEPTION();
+    return 1;
+}
@@ -0,0 +1,38 @@
+/*++
+Copyright (c) Microsoft Corporation.
+Licensed under the MIT license.
+
+Module Name:
+- Benchmark.hpp
+
+Abstract:
+- The benchmark mode of vtpipeterm. It spawns a number of conpty instances,
+  each running a synthetic writer, and measures how fast their output makes it
+  through VtIo and the XtermEngine, and how long it takes to get there.
+- The writers are vtpipeterm itself, launched with --bench-writer. They stamp
+  the console title with the current performance counter as they go. The
+  conpty forwards the title as an OSC sequence, so the reader can tell how
+  long the output took to arrive, since the counter is the same across processes.
+--*/
+
+#pragma once
+
+#include <windows.h>
+
+#include <string>
+
+struct BenchmarkOptions
+{
+    // One of "write", "tui" or "paste".
+    std::wstring workload = L"write";
+    unsigned int instances = 1;
+    unsigned long long bytes = 16 * 1024 * 1024;
+    COORD size = { 120, 30 };
+    DWORD timeoutMs = 120000;
+    bool useConpty = false;
+    // Empty to write the results to stdout.
+    std::wstring resultsPath;
+};
+
+int RunBenchmark(const BenchmarkOptions& options);
+int RunBenchmarkWriter(const std::wstring& workload, const unsigned long long bytes);
@@ -337,7 +337,7 @@ DWORD WINAPI VtConsole::StaticOutputThreadProc(LPVOID lpParameter)
 
 DWORD VtConsole::_OutputThread()
 {
-    BYTE buffer[256];
+    BYTE buffer[4096];
     DWORD dwRead;
     while (true)
     {
@@ -18,9 +18,10 @@ Author(s):
 #include <wil/result.h>
 #include <wil/resource.h>
 
+#include <functional>
 #include <string>
 
-typedef void (*PipeReadCallback)(BYTE* buffer, DWORD dwRead);
+typedef std::function<void(BYTE* buffer, DWORD dwRead)> PipeReadCallback;
 
 class VtConsole
 {
@@ -7,6 +7,7 @@
 #include <wil/resource.h>
 #include <wil/wistd_functional.h>
 #include <wil/wistd_memory.h>
+#include <climits>
 #include <cstdlib> /* srand, rand */
 #include <ctime> /* time */
 
@@ -18,6 +19,7 @@
 #include <cassert>
 
 #include "VtConsole.hpp"
+#include "Benchmark.hpp"
 
 using namespace std;
 ////////////////////////////////////////////////////////////////////////////////
@@ -532,6 +534,8 @@ int __cdecl wmain(int argc, WCHAR* argv[])
     hIn = GetStdHandle(STD_INPUT_HANDLE);
 
     bool fUseDebug = false;
+    bool fBenchmark = false;
+    BenchmarkOptions benchmarkOptions;
 
     if (argc > 1)
     {
@@ -556,9 +560,64 @@ int __cdecl wmain(int argc, WCHAR* argv[])
                 outfile = argv[i + 1];
                 i++;
             }
+            else if (arg == std::wstring(L"--bench") && i + 1 < argc)
+            {
+                fBenchmark = true;
+                benchmarkOptions.workload = argv[i + 1];
+                i++;
+            }
+            else if (arg == std::wstring(L"--instances") && i + 1 < argc)
+            {
+                benchmarkOptions.instances = wcstoul(argv[i + 1], nullptr, 10);
+                if (benchmarkOptions.instances == 0)
+                {
+                    benchmarkOptions.instances = 1;
+                }
+                i++;
+            }
+            else if (arg == std::wstring(L"--megabytes") && i + 1 < argc)
+            {
+                const auto megabytes = wcstoull(argv[i + 1], nullptr, 10);
+                benchmarkOptions.bytes = (megabytes ? megabytes : 1) * 1024 * 1024;
+                i++;
+            }
+            else if (arg == std::wstring(L"--size") && i + 1 < argc)
+            {
+                unsigned int columns = 0;
+                unsigned int rows = 0;
+                if (swscanf_s(argv[i + 1], L"%ux%u", &columns, &rows) == 2 && columns > 0 && rows > 0 && columns <= SHRT_MAX && rows <= SHRT_MAX)
+                {
+                    benchmarkOptions.size = { (SHORT)columns, (SHORT)rows };
+                }
+                i++;
+            }
+            else if (arg == std::wstring(L"--timeout") && i + 1 < argc)
+            {
+                benchmarkOptions.timeoutMs = wcstoul(argv[i + 1], nullptr, 10) * 1000;
+                i++;
+            }
+            else if (arg == std::wstring(L"--results") && i + 1 < argc)
+            {
+                benchmarkOptions.resultsPath = argv[i + 1];
+                i++;
+            }
+            else if (arg == std::wstring(L"--bench-writer") && i + 2 < argc)
+            {
+                // This is the synthetic writer of a benchmark, running inside a conpty.
+                return RunBenchmarkWriter(argv[i + 1], wcstoull(argv[i + 2], nullptr, 10));
+            }
         }
     }
 
+    if (fBenchmark)
+    {
+        // Usage: vtpipeterm --bench write|tui|paste [--conpty] [--instances n]
+        //          [--megabytes n] [--size CxR] [--timeout seconds] [--results path]
+        // Without --conpty, the instances are headless conhosts launched as conhost.exe.
+        benchmarkOptions.useConpty = g_useConpty;
+        return RunBenchmark(benchmarkOptions);
+    }
+
     if (g_useConpty)
     {
         printf("Launching vtpipeterm with conpty API...\n");
@@ -0,0 +1,55 @@
+// Copyright (c) Microsoft Corporation.
+// Licensed under the MIT license.
+
+#include "precomp.h"
+#include "inc/AllocationAccounting.hpp"
+
+using namespace Microsoft::Console::Types;
+
+static std::atomic<bool> s_enabled{ false };
+
+static til::pmr::counting_resource& s_GetCountingResource(const AllocationAccounting::Subsystem subsystem) noexcept
+{
+    static std::array<til::pmr::counting_resource, static_cast<size_t>(AllocationAccounting::Subsystem::Count)> resources;
+    return til::at(resources, static_cast<size_t>(subsystem));
+}
+
+void AllocationAccounting::Enable() noexcept
+{
+    s_enabled.store(true, std::memory_order_relaxed);
+}
+
+bool AllocationAccounting::IsEnabled() noexcept
+{
+    return s_enabled.load(std::memory_order_relaxed);
+}
+
+// Routine Description:
+// - Returns the resource the given subsystem should allocate its storage from.
+//   Unless accounting is enabled, that's simply the default resource.
+std::pmr::memory_resource* AllocationAccounting::GetResource(const Subsystem subsystem) noexcept
+{
+    if (!IsEnabled())
+    {
+        return til::pmr::get_default_resource();
+    }
+    return &s_GetCountingResource(subsystem);
+}
+
+const til::pmr::counting_resource& AllocationAccounting::GetCounters(const Subsystem subsystem) noexcept
+{
+    return s_GetCountingResource(subsystem);
+}
+
+std::wstring_view AllocationAccounting::GetName(const Subsystem subsystem) noexcept
+{
+    switch (subsystem)
+    {
+    case Subsystem::Parser:
+        return L"parser";
+    case Subsystem::Buffer:
+        return L"buffer";
+    default:
+        return L"unknown";
+    }
+}
@@ -25,6 +25,22 @@ bool IsGlyphFullWidth(const wchar_t wch) noexcept
     return widthDetector.IsWide(wch);
 }
 
+// Function Description:
+// - determines if the width of the single character depends on the font.
+//      See CodepointWidthDetector::IsAmbiguous
+bool IsGlyphWidthAmbiguous(const wchar_t wch) noexcept
+{
+    return CodepointWidthDetector::IsAmbiguous(wch);
+}
+
+// Function Description:
+// - determines the width of every glyph in a run of text at once.
+//      See CodepointWidthDetector::ClassifyWidths
+gsl::span<const CodepointWidth> ClassifyGlyphWidths(const std::wstring_view text, std::pmr::vector<CodepointWidth>& widths)
+{
+    return widthDetector.ClassifyWidths(text, widths);
+}
+
 // Function Description:
 // - Sets a function that should be used by the global CodepointWidthDetector
 //      as the fallback mechanism for determining a particular glyph's width,
@@ -6,6 +6,26 @@
 
 #include <unordered_map>
 
+// Input events are created on the window thread, the VT input thread and the IO
+// thread, and are destroyed wherever they're read, so the pool must be synchronized.
+// It's deliberately leaked: events held by other globals may still be freed
+// during process teardown, after a function-local static would've been destroyed.
+static std::pmr::synchronized_pool_resource& s_EventPool()
+{
+    static auto pool = new std::pmr::synchronized_pool_resource{ til::pmr::get_default_resource() };
+    return *pool;
+}
+
+void* IInputEvent::_PoolAllocate(const size_t size)
+{
+    return s_EventPool().allocate(size, alignof(std::max_align_t));
+}
+
+void IInputEvent::_PoolDeallocate(void* const p, const size_t size) noexcept
+{
+    s_EventPool().deallocate(p, size, alignof(std::max_align_t));
+}
+
 std::unique_ptr<IInputEvent> IInputEvent::Create(const INPUT_RECORD& record)
 {
     switch (record.EventType)
@@ -23,5 +23,9 @@ namespace Microsoft::Console::Types
         virtual void SignalSelectionChanged() = 0;
         virtual void SignalTextChanged() = 0;
         virtual void SignalCursorChanged() = 0;
+
+        // Called with the text that was written since the last time, along
+        // with (or shortly after) the SignalTextChanged() it caused.
+        virtual void SignalNewOutput(const std::wstring_view text) = 0;
     };
 }
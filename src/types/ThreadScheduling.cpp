@@ -0,0 +1,107 @@
+// Copyright (c) Microsoft Corporation.
+// Licensed under the MIT license.
+
+#include "precomp.h"
+#include "inc/ThreadScheduling.hpp"
+
+#include <avrt.h>
+
+using namespace Microsoft::Console::Types;
+
+namespace
+{
+    // avrt.dll isn't loaded into every process that uses us, and power
+    // throttling only exists since Windows 10 1709, so both are looked up at runtime.
+    struct Functions
+    {
+        decltype(&AvSetMmThreadCharacteristicsW) avSetMmThreadCharacteristics{ nullptr };
+        decltype(&AvRevertMmThreadCharacteristics) avRevertMmThreadCharacteristics{ nullptr };
+        decltype(&SetThreadInformation) setThreadInformation{ nullptr };
+    };
+
+    const Functions& s_GetFunctions() noexcept
+    {
+        static const auto functions = []() noexcept {
+            Functions f;
+            // The module is intentionally never freed: the registrations it hands out live as long as their threads.
+            if (const auto avrt = LoadLibraryExW(L"avrt.dll", nullptr, LOAD_LIBRARY_SEARCH_SYSTEM32))
+            {
+                f.avSetMmThreadCharacteristics = GetProcAddressByFunctionDeclaration(avrt, AvSetMmThreadCharacteristicsW);
+                f.avRevertMmThreadCharacteristics = GetProcAddressByFunctionDeclaration(avrt, AvRevertMmThreadCharacteristics);
+            }
+            f.setThreadInformation = GetProcAddressByFunctionDeclaration(GetModuleHandleW(L"kernel32.dll"), SetThreadInformation);
+            return f;
+        }();
+        return functions;
+    }
+}
+
+ThreadScheduling::CurrentThread::~CurrentThread()
+{
+    Apply(Class::Default);
+}
+
+// Routine Description:
+// - Changes the scheduling class of the calling thread. Failures are logged
+//   and otherwise ignored: the thread then just keeps running as it did.
+// Arguments:
+// - schedulingClass: how the thread should be scheduled from now on.
+// Return Value:
+// - <none>
+void ThreadScheduling::CurrentThread::Apply(const Class schedulingClass) noexcept
+{
+    if (schedulingClass == _class)
+    {
+        return;
+    }
+    _class = schedulingClass;
+
+    const auto& functions = s_GetFunctions();
+    const auto thread = GetCurrentThread();
+
+    if (_mmcssTask)
+    {
+        LOG_IF_WIN32_BOOL_FALSE(functions.avRevertMmThreadCharacteristics(_mmcssTask));
+        _mmcssTask = nullptr;
+    }
+
+    auto priority = THREAD_PRIORITY_NORMAL;
+    THREAD_POWER_THROTTLING_STATE throttling{};
+    throttling.Version = THREAD_POWER_THROTTLING_CURRENT_VERSION;
+
+    switch (schedulingClass)
+    {
+    case Class::Interactive:
+        if (functions.avSetMmThreadCharacteristics)
+        {
+            DWORD taskIndex = 0;
+            _mmcssTask = functions.avSetMmThreadCharacteristics(L"Games", &taskIndex);
+            LOG_LAST_ERROR_IF_NULL(_mmcssTask);
+        }
+        priority = _mmcssTask ? THREAD_PRIORITY_NORMAL : THREAD_PRIORITY_ABOVE_NORMAL;
+        // HighQoS: controlling the execution speed, but not throttling it.
+        throttling.ControlMask = THREAD_POWER_THROTTLING_EXECUTION_SPEED;
+        throttling.StateMask = 0;
+        break;
+    case Class::Background:
+        priority = THREAD_PRIORITY_BELOW_NORMAL;
+        // EcoQoS
+        throttling.ControlMask = THREAD_POWER_THROTTLING_EXECUTION_SPEED;
+        throttling.StateMask = THREAD_POWER_THROTTLING_EXECUTION_SPEED;
+        break;
+    case Class::Default:
+    default:
+        // A control mask of 0 hands the decision back to the OS.
+        break;
+    }
+
+    // MMCSS manages the priority of the threads registered with it.
+    if (!_mmcssTask)
+    {
+        LOG_IF_WIN32_BOOL_FALSE(SetThreadPriority(thread, priority));
+    }
+    if (functions.setThreadInformation)
+    {
+        LOG_IF_WIN32_BOOL_FALSE(functions.setThreadInformation(thread, ThreadPowerThrottling, &throttling, sizeof(throttling)));
+    }
+}
@@ -982,15 +982,20 @@ std::wstring UiaTextRangeBase::_getTextValue(std::optional<unsigned int> maxLeng
         bufferSize.DecrementInBounds(inclusiveEnd, true);
 
         const auto textRects = buffer.GetTextRects(_start, inclusiveEnd, _blockRange, true);
-        const auto bufferData = buffer.GetText(true,
-                                               false,
-                                               textRects);
 
-        const size_t textDataSize = base::ClampMul(bufferData.text.size(), bufferSize.Width());
+        const size_t textDataSize = base::ClampMul(textRects.size(), bufferSize.Width());
         textData.reserve(textDataSize);
-        for (const auto& text : bufferData.text)
+        for (size_t i = 0; i < textRects.size(); ++i)
         {
-            textData += text;
+            const auto& rect = til::at(textRects, i);
+            textData += _getRowTextValue(buffer, rect);
+
+            // Same as TextBuffer::GetText: every row but the last
+            // one ends in a CR/LF, unless the row was wrapped.
+            if (i + 1 < textRects.size() && !buffer.GetRowByOffset(rect.Top).WasWrapForced())
+            {
+                textData += L"\r\n";
+            }
         }
     }
 
@@ -1003,6 +1008,40 @@ std::wstring UiaTextRangeBase::_getTextValue(std::optional<unsigned int> maxLeng
 }
 #pragma warning(pop)
 
+// Method Description:
+// - Helper method for _getTextValue(). Retrieves the text of a single row of
+//   the given rectangle. Screen readers ask for the same rows over and over,
+//   and most of them don't change in between, so the text is cached per
+//   thread, keyed by the row's generation (see ROW::GetGeneration).
+// Arguments:
+// - buffer - the buffer to read from
+// - rect - the part of the row to read, in buffer coordinates
+// Return Value:
+// - the text of the row, without a trailing CR/LF. Only valid until the next call.
+const std::wstring& UiaTextRangeBase::_getRowTextValue(const TextBuffer& buffer, const SMALL_RECT& rect)
+{
+    struct CachedRow
+    {
+        uint64_t generation;
+        SHORT left;
+        SHORT right;
+        std::wstring text;
+    };
+
+    // A direct mapped cache is plenty: clients mostly re-read the visible rows.
+    static constexpr size_t cacheSize = 256;
+    static thread_local std::array<std::optional<CachedRow>, cacheSize> cache;
+
+    const auto generation = buffer.GetRowByOffset(rect.Top).GetGeneration();
+    auto& entry = til::at(cache, gsl::narrow_cast<size_t>(generation % cacheSize));
+    if (!entry || entry->generation != generation || entry->left != rect.Left || entry->right != rect.Right)
+    {
+        auto bufferData = buffer.GetText(false, false, { rect });
+        entry = CachedRow{ generation, rect.Left, rect.Right, std::move(bufferData.text.front()) };
+    }
+    return entry->text;
+}
+
 IFACEMETHODIMP UiaTextRangeBase::Move(_In_ TextUnit unit,
                                       _In_ int count,
                                       _Out_ int* pRetVal) noexcept
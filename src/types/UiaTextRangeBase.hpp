@@ -143,6 +143,7 @@ namespace Microsoft::Console::Types
         // that the UiaTextRange currently encompasses.
         // GetText() cannot be used as it's not const
         std::wstring _getTextValue(std::optional<unsigned int> maxLength = std::nullopt) const;
+        static const std::wstring& _getRowTextValue(const TextBuffer& buffer, const SMALL_RECT& rect);
 
         RECT _getTerminalRect() const;
 
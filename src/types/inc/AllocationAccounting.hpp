@@ -0,0 +1,35 @@
+/*++
+Copyright (c) Microsoft Corporation
+Licensed under the MIT license.
+
+Module Name:
+- AllocationAccounting.hpp
+
+Abstract:
+- Opt-in accounting of the heap allocations made by the VT hot path. The
+  subsystems below allocate their storage from the resource that GetResource
+  returns for them. By default that's the default resource, but once Enable
+  has been called it's a counting_resource per subsystem, so tools like vtbench
+  can tell which part of the pipeline allocates how much.
+--*/
+
+#pragma once
+
+namespace Microsoft::Console::Types::AllocationAccounting
+{
+    enum class Subsystem : size_t
+    {
+        Parser,
+        Buffer,
+        Count
+    };
+
+    // Has to be called before any of the subsystems are used.
+    // Resources that were handed out before stay uncounted.
+    void Enable() noexcept;
+    bool IsEnabled() noexcept;
+
+    std::pmr::memory_resource* GetResource(const Subsystem subsystem) noexcept;
+    const til::pmr::counting_resource& GetCounters(const Subsystem subsystem) noexcept;
+    std::wstring_view GetName(const Subsystem subsystem) noexcept;
+}
@@ -17,7 +17,7 @@ Author:
 #include <functional>
 
 static_assert(sizeof(unsigned int) == sizeof(wchar_t) * 2,
-              "UnicodeRange expects to be able to store a unicode codepoint in an unsigned int");
+              "CodepointWidthDetector expects to be able to store a unicode codepoint in an unsigned int");
 
 // use to measure the width of a codepoint
 class CodepointWidthDetector final
@@ -33,6 +33,8 @@ public:
     CodepointWidth GetWidth(const std::wstring_view glyph) const;
     bool IsWide(const std::wstring_view glyph) const;
     bool IsWide(const wchar_t wch) const noexcept;
+    static bool IsAmbiguous(const wchar_t wch) noexcept;
+    gsl::span<const CodepointWidth> ClassifyWidths(const std::wstring_view text, std::pmr::vector<CodepointWidth>& widths) const;
     void SetFallbackMethod(std::function<bool(const std::wstring_view)> pfnFallback);
     void NotifyFontChanged() const noexcept;
 
@@ -41,11 +43,38 @@ public:
 #endif
 
 private:
-    CodepointWidth _lookupGlyphWidth(const std::wstring_view glyph) const;
+    // Caches the results of the fallback method. It's an open addressing hash
+    // table keyed by codepoint, since it's consulted for every ambiguous glyph.
+    class FallbackCache
+    {
+    public:
+        std::optional<bool> Find(const unsigned int codepoint) const noexcept;
+        void Insert(const unsigned int codepoint, const bool isWide);
+        void Clear() noexcept;
+        size_t Size() const noexcept { return _size; }
+
+    private:
+        // Not a valid codepoint, so it can mark the slots that are unused.
+        static constexpr unsigned int EmptySlot = UINT_MAX;
+
+        struct Entry
+        {
+            unsigned int codepoint;
+            bool isWide;
+        };
+
+        size_t _Slot(const unsigned int codepoint) const noexcept;
+
+        std::vector<Entry> _entries;
+        size_t _size = 0;
+    };
+
+    CodepointWidth _lookupGlyphWidth(const std::wstring_view glyph) const noexcept;
     CodepointWidth _lookupGlyphWidthWithCache(const std::wstring_view glyph) const noexcept;
     bool _checkFallbackViaCache(const std::wstring_view glyph) const;
     static unsigned int _extractCodepoint(const std::wstring_view glyph) noexcept;
+    static size_t _countPrintableAscii(const std::wstring_view text) noexcept;
 
-    mutable std::unordered_map<std::wstring, bool> _fallbackCache;
+    mutable FallbackCache _fallbackCache;
     std::function<bool(std::wstring_view)> _pfnFallbackMethod;
 };
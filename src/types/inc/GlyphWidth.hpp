@@ -12,7 +12,11 @@ Abstract:
 #include <functional>
 #include <string_view>
 
+#include "convert.hpp"
+
 bool IsGlyphFullWidth(const std::wstring_view glyph);
 bool IsGlyphFullWidth(const wchar_t wch) noexcept;
+bool IsGlyphWidthAmbiguous(const wchar_t wch) noexcept;
+gsl::span<const CodepointWidth> ClassifyGlyphWidths(const std::wstring_view text, std::pmr::vector<CodepointWidth>& widths);
 void SetGlyphWidthFallback(std::function<bool(std::wstring_view)> pfnFallback);
 void NotifyGlyphWidthFontChanged() noexcept;
@@ -0,0 +1,58 @@
+/*++
+Copyright (c) Microsoft Corporation
+Licensed under the MIT license.
+
+Module Name:
+- GraphemeSegmenter.hpp
+
+Abstract:
+- Splits UTF-16 text into grapheme clusters, following the extended grapheme
+  cluster boundary rules of UAX #29. A cluster is what's written into a single
+  cell (or a pair of cells, if it's wide), so that combining marks, emoji ZWJ
+  sequences and flags end up together in one cell.
+- The Grapheme_Cluster_Break property of every codepoint is looked up in a
+  two-stage table generated by tools/Generate-GraphemeBreakTableFromUCD.ps1.
+- The segmenter is fed one codepoint at a time and only keeps the little state
+  the rules need, so it can segment text as it streams by.
+--*/
+
+#pragma once
+
+enum class GraphemeBreakProperty : uint8_t
+{
+    Other,
+    CR,
+    LF,
+    Control,
+    Extend,
+    ZWJ,
+    RegionalIndicator,
+    Prepend,
+    SpacingMark,
+    L,
+    V,
+    T,
+    LV,
+    LVT,
+    ExtendedPictographic,
+};
+
+class GraphemeSegmenter final
+{
+public:
+    static GraphemeBreakProperty GetProperty(const char32_t codepoint) noexcept;
+    static size_t GetClusterLength(const std::wstring_view text) noexcept;
+
+    bool IsBoundaryBefore(const GraphemeBreakProperty property) noexcept;
+    void Reset() noexcept;
+
+private:
+    bool _started{ false };
+    GraphemeBreakProperty _previous{ GraphemeBreakProperty::Other };
+    // Whether the previous codepoints are Extended_Pictographic Extend*.
+    bool _inPictographic{ false };
+    // Whether the previous codepoints are Extended_Pictographic Extend* ZWJ.
+    bool _afterPictographicZwj{ false };
+    // Whether an odd number of Regional_Indicators precede the next codepoint.
+    bool _oddRegionalIndicators{ false };
+};
@@ -60,6 +60,13 @@ public:
 #ifdef UNIT_TESTING
     friend std::wostream& operator<<(std::wostream& stream, const IInputEvent* const pEvent);
 #endif
+
+protected:
+    // Key and mouse events are created and destroyed at a very high rate (two for
+    // every character of a paste, one for every mouse move), so they're allocated
+    // from a shared pool instead of going to the heap each time.
+    static void* _PoolAllocate(const size_t size);
+    static void _PoolDeallocate(void* const p, const size_t size) noexcept;
 };
 
 inline IInputEvent::~IInputEvent()
@@ -200,6 +207,17 @@ public:
     }
 
     ~KeyEvent();
+
+    static void* operator new(const size_t size)
+    {
+        return _PoolAllocate(size);
+    }
+
+    static void operator delete(void* const p, const size_t size) noexcept
+    {
+        _PoolDeallocate(p, size);
+    }
+
     KeyEvent(const KeyEvent&) = default;
     KeyEvent(KeyEvent&&) = default;
 // For these two operators, there seems to be a bug in the compiler:
@@ -375,6 +393,17 @@ public:
     }
 
     ~MouseEvent();
+
+    static void* operator new(const size_t size)
+    {
+        return _PoolAllocate(size);
+    }
+
+    static void operator delete(void* const p, const size_t size) noexcept
+    {
+        _PoolDeallocate(p, size);
+    }
+
     MouseEvent(const MouseEvent&) = default;
     MouseEvent(MouseEvent&&) = default;
     MouseEvent& operator=(const MouseEvent&) & = default;
@@ -0,0 +1,51 @@
+/*++
+Copyright (c) Microsoft Corporation
+Licensed under the MIT license.
+
+Module Name:
+- ThreadScheduling.hpp
+
+Abstract:
+- Tells the OS how to schedule the threads the user waits on (rendering and
+  input), and the ones of content the user can't see right now.
+- Interactive threads register with MMCSS, which keeps them running when the
+  machine is busy with other work, like a build that pegs all cores. If MMCSS
+  isn't available, they run at a higher priority instead. Either way they
+  opt out of power throttling.
+- Background threads run at a lower priority with EcoQoS, so they're the ones
+  that yield when the machine is busy.
+--*/
+
+#pragma once
+
+namespace Microsoft::Console::Types::ThreadScheduling
+{
+    enum class Class : uint8_t
+    {
+        // Leave it up to the OS, as if we never said anything.
+        Default,
+        Interactive,
+        Background,
+    };
+
+    // The scheduling class of the calling thread. MMCSS registrations belong
+    // to the thread that made them, so this must only be used on the thread
+    // that created it. Destroying it returns the thread to the default class.
+    class CurrentThread
+    {
+    public:
+        CurrentThread() = default;
+        ~CurrentThread();
+
+        CurrentThread(const CurrentThread&) = delete;
+        CurrentThread& operator=(const CurrentThread&) = delete;
+        CurrentThread(CurrentThread&&) = delete;
+        CurrentThread& operator=(CurrentThread&&) = delete;
+
+        void Apply(const Class schedulingClass) noexcept;
+
+    private:
+        HANDLE _mmcssTask{ nullptr };
+        Class _class{ Class::Default };
+    };
+}
@@ -5,9 +5,9 @@
 # (we use the null coalescing operator)
 
 ################################################################################
-# This script generates the an array suitable for replacing the body of
-# src/types/CodepointWidthDetector.cpp from a Unicode UCD XML document[1]
-# compliant with UAX#42[2].
+# This script generates the two-stage lookup table suitable for replacing the
+# body of src/types/CodepointWidthDetector.cpp from a Unicode UCD XML
+# document[1] compliant with UAX#42[2].
 #
 # This script supports a quasi-mandatory "overrides" file, overrides.xml.
 # If you do not have overrides, supply the -NoOverrides parameter. This was
@@ -268,13 +268,42 @@ If (-not $NoOverrides) {
 "    // {0} (0x{0:X}) codepoints overridden." -f $overrideCount
 "    // Override path: {0}" -f $OverridePath
 }
-"    static constexpr std::array<UnicodeRange, {0}> s_wideAndAmbiguousTable{{" -f $ranges.Count
+
+# The first stage maps each block of 256 codepoints to one of the distinct
+# blocks in the second stage, which holds the width of each codepoint in 2 bits.
+$widths = [byte[]]::new(0x110000)
 ForEach($_ in $ranges) {
-    $comment = ""
-    if ($null -ne $_.Comment) {
-        # We only vend comments when we aren't packing tightly
-        $comment = " // {0}" -f $_.Comment
+    For($cp = $_.Start; $cp -le $_.End; $cp++) {
+        $widths[$cp] = [byte]$_.Width
+    }
+}
+
+$blockIndices = [System.Collections.Generic.Dictionary[string,int]]::new()
+$stage1 = [System.Collections.Generic.List[int]]::new(0x1100)
+$stage2 = [System.Collections.Generic.List[byte]]::new()
+For($block = 0; $block -lt 0x1100; $block++) {
+    $packed = [byte[]]::new(64)
+    For($i = 0; $i -lt 256; $i++) {
+        $packed[$i -shr 2] = $packed[$i -shr 2] -bor ($widths[$block * 256 + $i] -shl (($i -band 3) * 2))
+    }
+
+    $key = [Convert]::ToBase64String($packed)
+    $index = 0
+    If (-not $blockIndices.TryGetValue($key, [ref]$index)) {
+        $index = $blockIndices.Count
+        $blockIndices.Add($key, $index)
+        $stage2.AddRange($packed)
     }
-"        UnicodeRange{{ 0x{0:x}, 0x{1:x}, CodepointWidth::{2} }},{3}" -f $_.Start, $_.End, $_.Width, $comment
+    $stage1.Add($index)
 }
+
+Function Write-Table([string]$name, $values) {
+"    static constexpr std::array<uint8_t, {0}> {1}{{" -f $values.Count, $name
+    For($i = 0; $i -lt $values.Count; $i += 16) {
+"        {0}," -f (($values.GetRange($i, 16) | ForEach-Object { "0x{0:x2}" -f $_ }) -join ", ")
+    }
 "    };"
+}
+
+Write-Table "s_widthStage1" $stage1
+Write-Table "s_widthStage2" $stage2
@@ -0,0 +1,147 @@
+# Copyright (c) Microsoft Corporation.
+# Licensed under the MIT license.
+
+#Requires -Version 7
+
+################################################################################
+# This script generates the two-stage lookup table suitable for replacing the
+# table in src/types/GraphemeSegmenter.cpp from a Unicode UCD XML document[1]
+# compliant with UAX#42[2]. It holds the Grapheme_Cluster_Break property of
+# every codepoint, together with Extended_Pictographic, as they're used by the
+# grapheme cluster boundary rules of UAX#29[3].
+#
+# This script was developed against the flat "no han unification" UCD
+# "ucd.nounihan.flat.xml".
+# It does not support the grouped database format.
+#
+# Invoke as ./Generate-xxx ucd.nounihan.flat.xml | Out-File -Encoding
+#           UTF-8 Temporary.cpp
+#
+# [1]: https://www.unicode.org/Public/UCD/latest/ucdxml/
+# [2]: https://www.unicode.org/reports/tr42/
+# [3]: https://www.unicode.org/reports/tr29/
+
+[Diagnostics.CodeAnalysis.SuppressMessageAttribute('PSAvoidUsingPositionalParameters', '')]
+[CmdletBinding()]
+Param(
+    [Parameter(Position=0, ValueFromPipeline=$true, ParameterSetName="Parsed")]
+    [System.Xml.XmlDocument]$InputObject,
+
+    [Parameter(Position=0, ValueFromPipelineByPropertyName=$true, ParameterSetName="Unparsed")]
+    [string]$Path = "ucd.nounihan.flat.xml"
+)
+
+# The values must match the GraphemeBreakProperty enum in GraphemeSegmenter.hpp.
+Enum GraphemeBreakProperty {
+    Other;
+    CR;
+    LF;
+    Control;
+    Extend;
+    ZWJ;
+    RegionalIndicator;
+    Prepend;
+    SpacingMark;
+    L;
+    V;
+    T;
+    LV;
+    LVT;
+    ExtendedPictographic;
+}
+
+Function Get-UCDEntryRange($entry) {
+    $s = $e = 0
+    if ($null -ne $entry.cp) {
+        # Individual Codepoint
+        $s = $e = [int]("0x"+$entry.cp)
+    } ElseIf ($null -ne $entry."first-cp") {
+        # Range of Codepoints
+        $s = [int]("0x"+$entry."first-cp")
+        $e = [int]("0x"+$entry."last-cp")
+    }
+    $s
+    $e
+}
+
+Function Get-UCDEntryProperty($entry) {
+    Switch($entry.GCB) {
+        "CR"  { [GraphemeBreakProperty]::CR; Return }
+        "LF"  { [GraphemeBreakProperty]::LF; Return }
+        "CN"  { [GraphemeBreakProperty]::Control; Return }
+        "EX"  { [GraphemeBreakProperty]::Extend; Return }
+        "ZWJ" { [GraphemeBreakProperty]::ZWJ; Return }
+        "RI"  { [GraphemeBreakProperty]::RegionalIndicator; Return }
+        "PP"  { [GraphemeBreakProperty]::Prepend; Return }
+        "SM"  { [GraphemeBreakProperty]::SpacingMark; Return }
+        "L"   { [GraphemeBreakProperty]::L; Return }
+        "V"   { [GraphemeBreakProperty]::V; Return }
+        "T"   { [GraphemeBreakProperty]::T; Return }
+        "LV"  { [GraphemeBreakProperty]::LV; Return }
+        "LVT" { [GraphemeBreakProperty]::LVT; Return }
+    }
+
+    # Extended_Pictographic codepoints all have Grapheme_Cluster_Break=Other.
+    If ($entry.ExtPict -eq "Y") {
+        [GraphemeBreakProperty]::ExtendedPictographic
+        Return
+    }
+    [GraphemeBreakProperty]::Other
+}
+
+# Ingest UCD
+If ($null -eq $InputObject) {
+    $InputObject = [xml](Get-Content $Path)
+}
+
+$properties = [byte[]]::new(0x110000)
+$c = 0
+ForEach($v in $InputObject.ucd.repertoire.ChildNodes) {
+    $property = Get-UCDEntryProperty $v
+    If ($property -eq [GraphemeBreakProperty]::Other) {
+        Continue
+    }
+
+    $start, $end = Get-UCDEntryRange $v
+    For($cp = $start; $cp -le $end; $cp++) {
+        $properties[$cp] = [byte]$property
+    }
+    $c += $end - $start + 1
+}
+
+# Emit Code
+"    // Generated by {0}" -f $MyInvocation.MyCommand.Name
+"    // on {0} (UTC) from {1}." -f (Get-Date -AsUTC), $InputObject.ucd.description
+"    // {0} (0x{0:X}) codepoints covered." -f $c
+
+# The first stage maps each block of 256 codepoints to one of the distinct
+# blocks in the second stage, which holds the property of each codepoint in 4 bits.
+$blockIndices = [System.Collections.Generic.Dictionary[string,int]]::new()
+$stage1 = [System.Collections.Generic.List[int]]::new(0x1100)
+$stage2 = [System.Collections.Generic.List[byte]]::new()
+For($block = 0; $block -lt 0x1100; $block++) {
+    $packed = [byte[]]::new(128)
+    For($i = 0; $i -lt 256; $i++) {
+        $packed[$i -shr 1] = $packed[$i -shr 1] -bor ($properties[$block * 256 + $i] -shl (($i -band 1) * 4))
+    }
+
+    $key = [Convert]::ToBase64String($packed)
+    $index = 0
+    If (-not $blockIndices.TryGetValue($key, [ref]$index)) {
+        $index = $blockIndices.Count
+        $blockIndices.Add($key, $index)
+        $stage2.AddRange($packed)
+    }
+    $stage1.Add($index)
+}
+
+Function Write-Table([string]$name, $values) {
+"    static constexpr std::array<uint8_t, {0}> {1}{{" -f $values.Count, $name
+    For($i = 0; $i -lt $values.Count; $i += 16) {
+"        {0}," -f (($values.GetRange($i, 16) | ForEach-Object { "0x{0:x2}" -f $_ }) -join ", ")
+    }
+"    };"
+}
+
+Write-Table "s_graphemeBreakStage1" $stage1
+Write-Table "s_graphemeBreakStage2" $stage2